@@ -18,12 +18,14 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "cinn/ir/buffer.h"
 #include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/lowered_func.h"
@@ -91,6 +93,10 @@ std::unordered_set<std::string> GetOutputNamesFromLoweredFunc(const std::vector<
 
 bool NeedsMultiLevelTiling(const ir::ScheduleBlockRealize& sche_block_realize) {
   const ir::ScheduleBlock* sche_block = sche_block_realize.schedule_block.As<ir::ScheduleBlock>();
+  // the tensorized block is computed by an intrinsic on its fragments, which can't be tiled any more
+  if (sche_block->attrs.count(ir::attr::tensorize_intrin)) {
+    return false;
+  }
   if (sche_block->write_buffers.size() != 1 || sche_block->read_buffers.empty()) {
     return false;
   }
@@ -172,5 +178,331 @@ ir::LoweredFunc UpdateFuncWithNewBody(const common::Target& target, const ir::Lo
   return new_func;
 }
 
+namespace {
+
+// The closed range of the value of an integer expression
+struct IndexRange {
+  int64_t min;
+  int64_t max;
+};
+
+int64_t FloorDiv(int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+// The value of an integer constant, or default_value if it isn't
+int64_t ConstInt(const Expr& expr, int64_t default_value) {
+  const auto* imm = expr.As<ir::IntImm>();
+  return imm ? imm->value : default_value;
+}
+
+// Collect the loops, the iter values of the schedule blocks and the tensor accesses of a kernel
+class GpuResourceAnalyzer : public ir::IRMutator<> {
+ public:
+  explicit GpuResourceAnalyzer(GpuResourceUsage* usage) : usage_(usage) {}
+
+  void operator()(Expr* expr) {
+    ir::IRMutator<>::Visit(expr, expr);
+    usage_->shared_memory_bytes = std::max(usage_->shared_memory_bytes, SharedMemoryBytes());
+
+    int64_t threads = 1;
+    for (int64_t extent : thread_extents_) {
+      threads *= extent;
+    }
+    usage_->threads_per_block = std::max(usage_->threads_per_block, threads);
+  }
+
+  int num_global_accesses    = 0;
+  int num_coalesced_accesses = 0;
+
+ private:
+  struct SharedAccess {
+    std::vector<const ir::For*> loops;
+    // the indices of a store, empty for a load
+    std::vector<Expr> indices;
+    const ir::_Tensor_* tensor;
+  };
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    const auto& bind_info = op->bind_info();
+    if (op->is_gpu_thread_binded() && bind_info.valid()) {
+      thread_extents_[bind_info.offset] = std::max(thread_extents_[bind_info.offset], ConstInt(op->extent, 1));
+    }
+    if (op->is_vectorized()) {
+      CheckVectorizedLoop(op);
+    }
+    loops_.push_back(op);
+    ir::IRMutator<>::Visit(op, expr);
+    loops_.pop_back();
+  }
+
+  void Visit(const ir::ScheduleBlockRealize* op, Expr* expr) override {
+    const auto* block = op->schedule_block.As<ir::ScheduleBlock>();
+    std::vector<std::pair<std::string, Expr>> saved;
+    for (size_t i = 0; i < block->iter_vars.size() && i < op->iter_values.size(); ++i) {
+      const std::string& name = block->iter_vars[i]->name;
+      auto it                 = iter_values_.find(name);
+      saved.emplace_back(name, it == iter_values_.end() ? Expr() : it->second);
+      iter_values_[name] = op->iter_values[i];
+    }
+    ir::IRMutator<>::Visit(op, expr);
+    for (auto&& item : saved) {
+      if (item.second.defined()) {
+        iter_values_[item.first] = item.second;
+      } else {
+        iter_values_.erase(item.first);
+      }
+    }
+  }
+
+  void Visit(const ir::Load* op, Expr* expr) override {
+    AddAccess(op->tensor.as_tensor(), op->indices, false);
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  void Visit(const ir::Store* op, Expr* expr) override {
+    AddAccess(op->tensor.as_tensor(), op->indices, true);
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  static bool IsPowerOfTwo(int64_t value) { return value > 0 && (value & (value - 1)) == 0; }
+
+  static int64_t VectorizeFactor(const ir::For* loop) {
+    return loop->vectorize_info().valid() ? loop->vectorize_info().factor : ConstInt(loop->extent, 1);
+  }
+
+  void CheckVectorizedLoop(const ir::For* op) {
+    int64_t extent = ConstInt(op->extent, -1);
+    int64_t factor = VectorizeFactor(op);
+    if (!IsPowerOfTwo(factor) || (extent > 0 && extent % factor != 0)) {
+      VLOG(6) << "Misaligned vectorized loop " << op->loop_var->name << ", factor = " << factor;
+      ++usage_->num_misaligned_vectors;
+    }
+  }
+
+  void AddAccess(const ir::_Tensor_* tensor, const std::vector<Expr>& indices, bool is_store) {
+    if (!tensor || indices.empty()) {
+      return;
+    }
+    ir::MemoryType memory_type = tensor->buffer.defined() ? tensor->buffer->memory_type : ir::MemoryType::Heap;
+    if (memory_type == ir::MemoryType::GPUShared) {
+      shared_accesses_.push_back({loops_, is_store ? indices : std::vector<Expr>(), tensor});
+    }
+    // the vectorized loops that the innermost index goes through
+    for (const ir::For* loop : loops_) {
+      if (!loop->is_vectorized()) {
+        continue;
+      }
+      int64_t stride;
+      if (!Stride(indices, loop->loop_var->name, &stride) || stride == 0) {
+        continue;
+      }
+      int64_t factor           = VectorizeFactor(loop);
+      int64_t inner_dim        = ConstInt(tensor->shape.back(), -1);
+      usage_->max_vector_bytes = std::max(usage_->max_vector_bytes, factor * tensor->type().bytes());
+      if (stride != 1 || (inner_dim > 0 && inner_dim % factor != 0)) {
+        VLOG(6) << "Misaligned vectorized access of " << tensor->name << " in loop " << loop->loop_var->name;
+        ++usage_->num_misaligned_vectors;
+      }
+    }
+    if (memory_type != ir::MemoryType::Heap) {
+      return;
+    }
+    // the adjacent threads in x access the same or the adjacent elements of a global tensor
+    for (const ir::For* loop : loops_) {
+      if (loop->is_gpu_thread_binded() && loop->bind_info().offset == 0) {
+        int64_t stride;
+        ++num_global_accesses;
+        if (Stride(indices, loop->loop_var->name, &stride) && (stride == 0 || stride == 1)) {
+          ++num_coalesced_accesses;
+        }
+        break;
+      }
+    }
+  }
+
+  // The difference of the innermost index when the var steps by one with the other vars fixed, it is -1 if the var
+  // changes the outer indices too, fails if an index can't be evaluated
+  bool Stride(const std::vector<Expr>& indices, const std::string& var, int64_t* stride) const {
+    for (size_t i = 0; i < indices.size(); ++i) {
+      IndexRange at0, at1;
+      if (!Evaluate(indices[i], {{var, {0, 0}}}, &at0, 0) || !Evaluate(indices[i], {{var, {1, 1}}}, &at1, 0)) {
+        return false;
+      }
+      int64_t diff = at1.min - at0.min;
+      if (i + 1 < indices.size() && diff != 0) {
+        *stride = -1;
+        return true;
+      }
+      *stride = diff;
+    }
+    return true;
+  }
+
+  // Evaluate the range of an index, the vars of the block iters are replaced by their values, and the loop vars not
+  // in var_ranges are fixed at 0
+  bool Evaluate(const Expr& expr,
+                const std::unordered_map<std::string, IndexRange>& var_ranges,
+                IndexRange* range,
+                int depth) const {
+    if (depth > 16) {
+      return false;
+    }
+    if (const auto* imm = expr.As<ir::IntImm>()) {
+      *range = {imm->value, imm->value};
+      return true;
+    }
+    if (const auto* var = expr.As<ir::_Var_>()) {
+      auto rit = var_ranges.find(var->name);
+      if (rit != var_ranges.end()) {
+        *range = rit->second;
+        return true;
+      }
+      auto it = iter_values_.find(var->name);
+      if (it != iter_values_.end() && !(it->second.As<ir::_Var_>() && it->second.as_var()->name == var->name)) {
+        return Evaluate(it->second, var_ranges, range, depth + 1);
+      }
+      *range = {0, 0};
+      return true;
+    }
+    if (const auto* cast = expr.As<ir::Cast>()) {
+      return Evaluate(cast->v(), var_ranges, range, depth + 1);
+    }
+    IndexRange a, b;
+    auto binary = [&](const Expr& lhs, const Expr& rhs) {
+      return Evaluate(lhs, var_ranges, &a, depth + 1) && Evaluate(rhs, var_ranges, &b, depth + 1);
+    };
+    if (const auto* add = expr.As<ir::Add>()) {
+      if (!binary(add->a(), add->b())) return false;
+      *range = {a.min + b.min, a.max + b.max};
+    } else if (const auto* sub = expr.As<ir::Sub>()) {
+      if (!binary(sub->a(), sub->b())) return false;
+      *range = {a.min - b.max, a.max - b.min};
+    } else if (const auto* mul = expr.As<ir::Mul>()) {
+      if (!binary(mul->a(), mul->b())) return false;
+      int64_t products[] = {a.min * b.min, a.min * b.max, a.max * b.min, a.max * b.max};
+      *range             = {*std::min_element(products, products + 4), *std::max_element(products, products + 4)};
+    } else if (const auto* div = expr.As<ir::Div>()) {
+      if (!binary(div->a(), div->b()) || b.min != b.max || b.min <= 0) return false;
+      *range = {FloorDiv(a.min, b.min), FloorDiv(a.max, b.min)};
+    } else if (const auto* mod = expr.As<ir::Mod>()) {
+      if (!binary(mod->a(), mod->b()) || b.min != b.max || b.min <= 0 || a.min < 0) return false;
+      if (a.min / b.min == a.max / b.min) {
+        *range = {a.min % b.min, a.max % b.min};
+      } else {
+        *range = {0, b.min - 1};
+      }
+    } else if (const auto* min = expr.As<ir::Min>()) {
+      if (!binary(min->a(), min->b())) return false;
+      *range = {std::min(a.min, b.min), std::min(a.max, b.max)};
+    } else if (const auto* max = expr.As<ir::Max>()) {
+      if (!binary(max->a(), max->b())) return false;
+      *range = {std::max(a.min, b.min), std::max(a.max, b.max)};
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // The bytes of the shared tensors of the kernel. The loops enclosing all the accesses of a tensor run its stores and
+  // loads in turn, so only the ones bound to threads, whose threads share the tensor, and the loops under them extend
+  // the range of the indices stored.
+  int64_t SharedMemoryBytes() const {
+    std::unordered_map<const ir::_Tensor_*, std::vector<const SharedAccess*>> tensor2accesses;
+    for (auto&& access : shared_accesses_) {
+      tensor2accesses[access.tensor].push_back(&access);
+    }
+    int64_t total_bytes = 0;
+    for (auto&& item : tensor2accesses) {
+      const ir::_Tensor_* tensor = item.first;
+      size_t num_common_loops    = item.second.front()->loops.size();
+      for (const SharedAccess* access : item.second) {
+        size_t n = 0;
+        while (n < num_common_loops && n < access->loops.size() && access->loops[n] == item.second.front()->loops[n]) {
+          ++n;
+        }
+        num_common_loops = n;
+      }
+      int64_t tensor_bytes = 0;
+      for (const SharedAccess* access : item.second) {
+        if (access->indices.empty()) {
+          continue;
+        }
+        std::unordered_map<std::string, IndexRange> var_ranges;
+        for (size_t i = 0; i < access->loops.size(); ++i) {
+          const ir::For* loop = access->loops[i];
+          if (i >= num_common_loops || loop->is_gpu_thread_binded()) {
+            var_ranges[loop->loop_var->name] = {0, ConstInt(loop->extent, 1) - 1};
+          }
+        }
+        int64_t numel = 1;
+        for (size_t d = 0; d < access->indices.size(); ++d) {
+          int64_t dim = d < tensor->shape.size() ? ConstInt(tensor->shape[d], -1) : -1;
+          IndexRange range;
+          int64_t extent = Evaluate(access->indices[d], var_ranges, &range, 0) ? range.max - range.min + 1 : dim;
+          numel *= (dim > 0 && (extent <= 0 || extent > dim)) ? dim : std::max<int64_t>(extent, 1);
+        }
+        tensor_bytes = std::max(tensor_bytes, numel * tensor->type().bytes());
+      }
+      total_bytes += tensor_bytes;
+    }
+    return total_bytes;
+  }
+
+  GpuResourceUsage* usage_;
+  std::vector<const ir::For*> loops_;
+  std::unordered_map<std::string, Expr> iter_values_;
+  std::vector<SharedAccess> shared_accesses_;
+  int64_t thread_extents_[3] = {1, 1, 1};
+};
+
+}  // namespace
+
+GpuResourceLimits GpuResourceLimits::FromTarget(const common::Target& target) {
+  GpuResourceLimits limits;
+  if (target.arch == common::Target::Arch::NVGPU) {
+    limits.max_shared_memory_bytes = target.get_max_shared_memory_per_block();
+    limits.max_threads_per_block   = target.max_num_threads();
+  }
+  return limits;
+}
+
+GpuResourceUsage AnalyzeGpuResourceUsage(const ir::ModuleExpr& mod_expr) {
+  GpuResourceUsage usage;
+  int num_global_accesses    = 0;
+  int num_coalesced_accesses = 0;
+  for (Expr expr : mod_expr.GetExprs()) {
+    GpuResourceAnalyzer analyzer(&usage);
+    analyzer(&expr);
+    num_global_accesses += analyzer.num_global_accesses;
+    num_coalesced_accesses += analyzer.num_coalesced_accesses;
+  }
+  if (num_global_accesses > 0) {
+    usage.coalescing_ratio = static_cast<double>(num_coalesced_accesses) / num_global_accesses;
+  }
+  return usage;
+}
+
+std::string CheckGpuResourceUsage(const GpuResourceUsage& usage, const GpuResourceLimits& limits) {
+  if (usage.shared_memory_bytes > limits.max_shared_memory_bytes) {
+    return "shared memory " + std::to_string(usage.shared_memory_bytes) + " bytes exceeds the limit " +
+           std::to_string(limits.max_shared_memory_bytes);
+  }
+  if (usage.threads_per_block > limits.max_threads_per_block) {
+    return "threads per block " + std::to_string(usage.threads_per_block) + " exceeds the limit " +
+           std::to_string(limits.max_threads_per_block);
+  }
+  if (usage.max_vector_bytes > limits.max_vector_bytes) {
+    return "vector of " + std::to_string(usage.max_vector_bytes) + " bytes exceeds the limit " +
+           std::to_string(limits.max_vector_bytes);
+  }
+  if (usage.num_misaligned_vectors > 0) {
+    return std::to_string(usage.num_misaligned_vectors) + " misaligned vectorized loops or accesses";
+  }
+  if (usage.coalescing_ratio < limits.min_coalescing_ratio) {
+    return "coalescing ratio " + std::to_string(usage.coalescing_ratio) + " is below " +
+           std::to_string(limits.min_coalescing_ratio);
+  }
+  return "";
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
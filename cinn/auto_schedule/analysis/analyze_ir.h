@@ -44,5 +44,47 @@ bool NeedsMultiLevelTiling(const ir::ScheduleBlockRealize& sche_block_realize);
  */
 ir::LoweredFunc UpdateFuncWithNewBody(const common::Target& target, const ir::LoweredFunc& old_func, ir::Expr& body);
 
+/**
+ * The GPU resources used by the kernels of a scheduled ModuleExpr, they are estimated statically from the loops and
+ * the tensor accesses without lowering, and each field is the worst of the kernels.
+ */
+struct GpuResourceUsage {
+  // the bytes of the tensors in shared memory, each is sized by the range of its indices stored in a block
+  int64_t shared_memory_bytes = 0;
+  // the product of the extents of the loops bound to threadIdx.x/y/z
+  int64_t threads_per_block = 1;
+  // the bytes of the widest access in a vectorized loop
+  int64_t max_vector_bytes = 0;
+  // the vectorized loops whose factor isn't a power of 2 or doesn't divide the extent of the loop, and the accesses in
+  // them that are strided or whose innermost dimension isn't a multiple of the factor
+  int num_misaligned_vectors = 0;
+  // the ratio of the global accesses under threadIdx.x in which the adjacent threads access the same or adjacent
+  // elements, 1 if there is no such access
+  double coalescing_ratio = 1.0;
+};
+
+// The limits that a valid candidate must satisfy, see CheckGpuResourceUsage
+struct GpuResourceLimits {
+  int64_t max_shared_memory_bytes = 48 * 1024;
+  int64_t max_threads_per_block   = 1024;
+  // the widest vector load/store of CUDA, such as float4
+  int64_t max_vector_bytes = 16;
+  // the candidates less coalesced than this are invalid, 0 to accept any
+  double min_coalescing_ratio = 0.0;
+
+  // The limits of the current device
+  static GpuResourceLimits FromTarget(const common::Target& target);
+};
+
+/**
+ * Estimate the GPU resources used by the kernels of a scheduled ModuleExpr
+ */
+GpuResourceUsage AnalyzeGpuResourceUsage(const ir::ModuleExpr& mod_expr);
+
+/**
+ * Check the GPU resources used by a candidate, return the reason why it is invalid, or an empty string if it is valid
+ */
+std::string CheckGpuResourceUsage(const GpuResourceUsage& usage, const GpuResourceLimits& limits);
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -177,5 +177,62 @@ TEST(AnalyzeIr, ContainsNodeType) {
   ASSERT_FALSE(ContainsNodeType(ast_expr, {ir::IrNodeTy::IfThenElse, ir::IrNodeTy::Sum}));
 }
 
+// Lower B[i, j] = A[j, i] on a 32x64 domain
+ir::IRSchedule MakeTransposeSchedule() {
+  Context::Global().ResetNameId();
+  ir::Expr M(32);
+  ir::Expr N(64);
+  lang::Placeholder<float> A("A", {N, M});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(j, i); }, "B");
+
+  poly::StageMap stages = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("Transpose", stages, {A, B}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+  return ir::IRSchedule(ir::ModuleExpr({funcs[0]->body}));
+}
+
+TEST(AnalyzeIr, AnalyzeGpuResourceUsage) {
+  ir::IRSchedule ir_sch = MakeTransposeSchedule();
+  auto loops            = ir_sch.GetLoops("B");
+  ir_sch.Bind(loops[0], "blockIdx.x");
+  ir_sch.Bind(loops[1], "threadIdx.x");
+
+  // the store of B is coalesced but the load of A isn't
+  GpuResourceUsage usage = AnalyzeGpuResourceUsage(ir_sch.GetModule());
+  EXPECT_EQ(usage.threads_per_block, 64);
+  EXPECT_EQ(usage.shared_memory_bytes, 0);
+  EXPECT_EQ(usage.num_misaligned_vectors, 0);
+  EXPECT_DOUBLE_EQ(usage.coalescing_ratio, 0.5);
+
+  GpuResourceLimits limits;
+  EXPECT_EQ(CheckGpuResourceUsage(usage, limits), "");
+  limits.max_threads_per_block = 32;
+  EXPECT_NE(CheckGpuResourceUsage(usage, limits), "");
+  limits.max_threads_per_block = 1024;
+  limits.min_coalescing_ratio  = 0.8;
+  EXPECT_NE(CheckGpuResourceUsage(usage, limits), "");
+}
+
+TEST(AnalyzeIr, AnalyzeGpuResourceUsage_SharedAndVectorize) {
+  ir::IRSchedule ir_sch = MakeTransposeSchedule();
+  ir_sch.CacheRead(ir_sch.GetBlock("B"), 0, "shared");
+  // the cache is not computed at any loop of B, so it holds the whole A
+  GpuResourceUsage usage = AnalyzeGpuResourceUsage(ir_sch.GetModule());
+  EXPECT_EQ(usage.shared_memory_bytes, 32 * 64 * 4);
+
+  GpuResourceLimits limits;
+  limits.max_shared_memory_bytes = 4096;
+  EXPECT_NE(CheckGpuResourceUsage(usage, limits), "");
+
+  ir_sch     = MakeTransposeSchedule();
+  auto loops = ir_sch.GetLoops("B");
+  ir_sch.Vectorize(loops[1], 4);
+  usage = AnalyzeGpuResourceUsage(ir_sch.GetModule());
+  EXPECT_EQ(usage.max_vector_bytes, 16);
+  // the load of A is strided in the vectorized loop
+  EXPECT_EQ(usage.num_misaligned_vectors, 1);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
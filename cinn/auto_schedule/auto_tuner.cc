@@ -15,12 +15,22 @@
 #include "cinn/auto_schedule/auto_tuner.h"
 
 #include <glog/logging.h>
+#include <google/protobuf/util/json_util.h>
 #include <pybind11/embed.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/database/jsonfile_database.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
@@ -29,6 +39,7 @@
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
+#include "cinn/auto_schedule/tuning_pack.h"
 #include "cinn/common/context.h"
 #include "cinn/common/type.h"
 #include "cinn/hlir/framework/op.h"
@@ -43,15 +54,20 @@ AutoTuner::AutoTuner(const common::Target& target, hlir::framework::Graph* graph
 void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler) {
   // create builder, runner, and schedule measurer
   builder_           = std::make_unique<SimpleBuilder>(graph_compiler);
-  runner_            = std::make_unique<SimpleRunner>(config.runner_repeat_times);
-  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get());
+  runner_            = std::make_unique<SimpleRunner>(config.runner_repeat_times, config.runner_adaptive_config);
+  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get(), config.measure_num_threads);
 
   // initialize database
   database_ = std::move(Database::Make(config.database_config));
 
   // create tasks
   TaskCreator task_creator;
-  tasks_ = task_creator.CreateTuneTaskOpLevel(graph_);
+  tasks_           = task_creator.CreateTuneTaskOpLevel(graph_);
+  num_group_tasks_ = tasks_.size();
+  split_candidates_.clear();
+  if (config.tune_fusion_plan) {
+    split_candidates_ = task_creator.CreateSplitCandidates(graph_, &tasks_);
+  }
 
   const auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
   const auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
@@ -67,15 +83,143 @@ void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler*
   }
 
   // create task optimizers
-  utils::LinearRandomEngine::StateType initial_seed = utils::LinearRandomEngine::GetDeviceRandomValue();
+  utils::LinearRandomEngine::StateType initial_seed =
+      config.random_seed == -1 ? utils::LinearRandomEngine::GetDeviceRandomValue() : config.random_seed;
+  // some search rules sample by std::rand, seed it as well for a reproducible session
+  if (config.random_seed != -1) {
+    std::srand(static_cast<unsigned int>(config.random_seed));
+  }
   task_optimizers_.resize(tasks_.size());
   std::transform(tasks_.begin(), tasks_.end(), task_optimizers_.begin(), [&](TuneTask& task) {
     return std::make_unique<TaskOptimizer>(
         &task, schedule_measurer_.get(), database_.get(), utils::ForkRandomState(&initial_seed));
   });
 
+  // start from the pretrained cost model, the checkpoint below overrides it if it holds a trained one
+  if (!config.pretrained_cost_model_dir.empty()) {
+    std::string path = ExprCostModel::PretrainedModelPath(config.pretrained_cost_model_dir, target_);
+    if (std::ifstream(path).good()) {
+      for (auto& optimizer : task_optimizers_) {
+        optimizer->LoadCostModel(path);
+      }
+      VLOG(3) << "Start tuning from the pretrained cost model: " << path;
+    } else {
+      LOG(WARNING) << "No pretrained cost model for the target: " << path;
+    }
+  }
+
   // create task scheduler
   task_scheduler_ = TaskScheduler::Make(tasks_, config.task_schedule_config, config.task_schedule_strategy);
+
+  // resume from the checkpoint, the measured records are restored by the database
+  checkpoint_dir_      = config.checkpoint_dir;
+  checkpoint_interval_ = config.checkpoint_interval;
+  if (!checkpoint_dir_.empty()) {
+    CHECK_GT(checkpoint_interval_, 0) << "Invalid checkpoint interval";
+    CHECK(hlir::framework::MakeDirectory(checkpoint_dir_ + "/", 0755))
+        << "Failed to create the checkpoint directory: " << checkpoint_dir_;
+    LoadCheckpoint();
+  }
+}
+
+std::string AutoTuner::CheckpointFilePath() const { return checkpoint_dir_ + "/checkpoint.json"; }
+
+void AutoTuner::SaveCheckpoint(int num_finished_rounds) {
+  proto::TuningCheckpoint checkpoint;
+  checkpoint.set_num_finished_rounds(num_finished_rounds);
+  task_scheduler_->SaveState(checkpoint.mutable_scheduler_state());
+  // all files are written to temporary ones and renamed, so a crash never leaves a broken checkpoint
+  for (auto i = 0; i < task_optimizers_.size(); ++i) {
+    std::string cost_model_path = checkpoint_dir_ + "/cost_model_" + std::to_string(i);
+    auto* state                 = checkpoint.add_optimizer_states();
+    task_optimizers_[i]->SaveState(cost_model_path + ".tmp", state);
+    if (!state->cost_model_path().empty()) {
+      CHECK_EQ(std::rename(state->cost_model_path().c_str(), cost_model_path.c_str()), 0)
+          << "Failed to save the cost model: " << cost_model_path;
+      state->set_cost_model_path(cost_model_path);
+    }
+  }
+
+  std::string json_string;
+  auto status = google::protobuf::util::MessageToJsonString(checkpoint, &json_string);
+  CHECK(status.ok()) << "Failed to serialize the checkpoint";
+  std::string path     = CheckpointFilePath();
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream os(tmp_path, std::ofstream::trunc);
+    CHECK(os.good()) << "Cannot open the file to write: " << tmp_path;
+    os << json_string;
+  }
+  CHECK_EQ(std::rename(tmp_path.c_str(), path.c_str()), 0) << "Failed to save the checkpoint: " << path;
+  VLOG(3) << "Save the checkpoint to " << path << ", finished rounds=" << num_finished_rounds;
+}
+
+void AutoTuner::ExportTuningPack(const std::string& file_path) const {
+  TuningPack pack;
+  for (const auto& task : tasks_) {
+    auto records = database_->GetTopK(task.serialized_key, 1);
+    if (!records.empty()) {
+      pack.Add(task.serialized_key, records.front().trace);
+    }
+  }
+  pack.Save(file_path);
+}
+
+int AutoTuner::PretrainCostModel(const std::string& output_dir) const {
+  // the schedules are replayed and kept alive until the features are extracted
+  std::vector<ir::IRSchedule> schedules;
+  std::vector<float> labels;
+  for (const auto& task : tasks_) {
+    auto* replay_cache = InitialTaskRegistry::Global()->Get(task.serialized_key)->replay_cache.get();
+    for (const auto& record : database_->LookUp(task.serialized_key)) {
+      schedules.emplace_back(replay_cache->Replay(record.trace));
+      labels.push_back(record.execution_cost);
+    }
+  }
+  if (schedules.empty()) {
+    LOG(WARNING) << "No record to pretrain the cost model";
+    return 0;
+  }
+  std::vector<const ir::ModuleExpr*> samples;
+  for (const auto& schedule : schedules) {
+    samples.push_back(&schedule.GetModule());
+  }
+
+  // boost more rounds than an online update, half of the max trees are left for fine-tuning
+  GbdtCostModel::Config model_config;
+  model_config.num_rounds = model_config.max_trees / 2;
+  ExprCostModel cost_model(model_config);
+  cost_model.Train(samples, labels, target_);
+  CHECK(hlir::framework::MakeDirectory(output_dir + "/", 0755))
+      << "Failed to create the cost model directory: " << output_dir;
+  std::string path = ExprCostModel::PretrainedModelPath(output_dir, target_);
+  cost_model.Save(path);
+  VLOG(3) << "Pretrain the cost model on " << samples.size() << " records, saved to " << path;
+  return samples.size();
+}
+
+bool AutoTuner::LoadCheckpoint() {
+  std::string path = CheckpointFilePath();
+  std::ifstream is(path);
+  if (!is.good()) {
+    return false;
+  }
+  std::stringstream json_string;
+  json_string << is.rdbuf();
+  proto::TuningCheckpoint checkpoint;
+  auto status = google::protobuf::util::JsonStringToMessage(json_string.str(), &checkpoint);
+  CHECK(status.ok()) << "Failed to parse the checkpoint: " << path;
+  CHECK_EQ(checkpoint.optimizer_states_size(), task_optimizers_.size())
+      << "The checkpoint doesn't match the tasks to tune: " << path;
+
+  task_scheduler_->LoadState(checkpoint.scheduler_state());
+  for (auto i = 0; i < task_optimizers_.size(); ++i) {
+    task_optimizers_[i]->LoadState(checkpoint.optimizer_states(i));
+  }
+  resumed_round_ = checkpoint.num_finished_rounds();
+  resumed_       = true;
+  LOG(INFO) << "Resume tuning from the checkpoint " << path << ", finished rounds=" << resumed_round_;
+  return true;
 }
 
 void PrintResult(std::shared_ptr<hlir::framework::Graph::Group> group) {
@@ -132,18 +276,47 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
   TuningResult result;
   result.subgraphs.resize(tasks_.size());
   result.function_groups.resize(tasks_.size());
-  // A task only tunes schedule now, so we populate its sub_graph
-  // as default result of graph tuning, and that should be updated
-  // once we support graph tuning.
+  // A task tunes the schedule of its sub_graph, and the sub_graphs
+  // to compile are selected by SelectFusionPlan after tuning.
   for (auto i = 0; i < tasks_.size(); ++i) {
     auto&& task         = tasks_.at(i);
     result.subgraphs[i] = task.subgraph;
   }
 
-  for (int r = 0; r < options.num_tuning_rounds; ++r) {
+  // record the best cost of every task after each measured batch, the curve tells how fast the tuning converges
+  auto start_time = std::chrono::steady_clock::now();
+  std::unordered_map<std::string, double> task_best_costs;
+  int num_trials = 0;
+  auto record_curve = [&](const std::vector<MeasureInput>& inputs, const std::vector<MeasureResult>& results) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (!results[i].error_msg.empty()) {
+        continue;
+      }
+      auto it = task_best_costs.emplace(inputs[i].task->serialized_key, results[i].execution_cost).first;
+      it->second = std::min(it->second, results[i].execution_cost);
+    }
+    num_trials += inputs.size();
+    TuningCurvePoint point;
+    point.num_trials = num_trials;
+    point.elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    for (auto& task_cost : task_best_costs) {
+      point.best_cost += task_cost.second;
+    }
+    point.num_measured_tasks = task_best_costs.size();
+    result.curve.push_back(point);
+  };
+  schedule_measurer_->SetCallback(record_curve);
+
+  int num_tuned = 0;
+  for (int r = resumed_round_; r < options.num_tuning_rounds; ++r) {
     VLOG(3) << "<<<<<< Round " << r << " >>>>>>";
     int run_id = -1;
-    task_scheduler_->Reset();
+    // the scheduler restored from a checkpoint continues the unfinished round
+    if (!resumed_) {
+      task_scheduler_->Reset();
+    }
+    resumed_ = false;
     while ((run_id = task_scheduler_->NextTaskId()) != -1) {
       VLOG(3) << "Start tuning Task-" << run_id;
       auto* opt           = task_optimizers_.at(run_id).get();
@@ -152,12 +325,72 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
       PrintResult(function_group);
       // update the best schedules searched so far.
       result.function_groups.at(run_id) = std::move(function_group);
+      // feed the best measured cost back to the scheduler
+      auto records = database_->GetTopK(tasks_.at(run_id).serialized_key, 1);
+      if (!records.empty()) {
+        task_scheduler_->UpdateTaskCost(run_id, records.front().execution_cost);
+      }
+      if (!checkpoint_dir_.empty() && ++num_tuned % checkpoint_interval_ == 0) {
+        SaveCheckpoint(r);
+      }
+    }
+    if (!checkpoint_dir_.empty()) {
+      // the scheduler is reset so that resuming from this checkpoint starts the next round
+      task_scheduler_->Reset();
+      SaveCheckpoint(r + 1);
+    }
+  }
+  resumed_round_ = 0;
+  schedule_measurer_->SetCallback(nullptr);
+
+  // the tasks not tuned in this session, such as the ones finished before resuming, take their best records
+  for (auto i = 0; i < tasks_.size(); ++i) {
+    if (result.function_groups[i].empty()) {
+      result.function_groups[i] = task_optimizers_.at(i)->LowerBestRecorded();
     }
   }
+  SelectFusionPlan(&result);
 
   PrintResult(result);
   return result;
 }
 
+void AutoTuner::SelectFusionPlan(TuningResult* result) const {
+  auto best_cost = [this](int task_id) {
+    auto records = database_->GetTopK(tasks_.at(task_id).serialized_key, 1);
+    return records.empty() ? std::numeric_limits<double>::infinity() : records.front().execution_cost;
+  };
+  std::unordered_map<int, const SplitCandidate*> split_groups;
+  for (auto& candidate : split_candidates_) {
+    double group_cost = best_cost(candidate.task_id);
+    double split_cost = 0.0;
+    for (int sub_task_id : candidate.sub_task_ids) {
+      split_cost += best_cost(sub_task_id);
+    }
+    // the groups without measured records are kept
+    if (split_cost < group_cost) {
+      VLOG(3) << "Split Task-" << candidate.task_id << " into " << candidate.sub_task_ids.size()
+              << " tasks, cost: " << group_cost << " -> " << split_cost;
+      split_groups.emplace(candidate.task_id, &candidate);
+    }
+  }
+
+  TuningResult plan;
+  for (int i = 0; i < num_group_tasks_; ++i) {
+    auto it = split_groups.find(i);
+    if (it == split_groups.end()) {
+      plan.subgraphs.push_back(result->subgraphs[i]);
+      plan.function_groups.push_back(std::move(result->function_groups[i]));
+      continue;
+    }
+    for (int sub_task_id : it->second->sub_task_ids) {
+      plan.subgraphs.push_back(result->subgraphs[sub_task_id]);
+      plan.function_groups.push_back(std::move(result->function_groups[sub_task_id]));
+    }
+  }
+  plan.curve = std::move(result->curve);
+  *result    = std::move(plan);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
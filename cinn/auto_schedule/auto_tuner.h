@@ -19,6 +19,8 @@
 #include <vector>
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
+#include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/auto_schedule/task/task_creator.h"
 #include "cinn/auto_schedule/task/task_optimizer.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
@@ -32,7 +34,7 @@ namespace cinn {
 namespace auto_schedule {
 
 // This class is entrance of auto-tune, users can use it
-// to tune graph (not supported yet) and search a series of schedules
+// to tune graph and search a series of schedules
 // that maybe more likely to obtain better performance.
 // Internally, it creates necessary components and use them to perform tuning.
 class AutoTuner {
@@ -43,24 +45,64 @@ class AutoTuner {
     std::string task_schedule_strategy = "round_robin";
     TaskScheduler::Config task_schedule_config;
     int runner_repeat_times = 1;
+    // How to stop repeating a candidate in advance
+    AdaptiveRepeatConfig runner_adaptive_config;
+    // The number of threads to build the candidates in parallel
+    int measure_num_threads = 1;
     DatabaseConfig database_config;
+    // The directory to save the checkpoints of tuning, a session is resumed from the checkpoint in it
+    // if exists, empty means no checkpoint
+    std::string checkpoint_dir = "";
+    // The number of tasks tuned between two checkpoints
+    int checkpoint_interval = 1;
+    // Whether to tune the fusion plan of the graph, the sub groups of the fused groups are tuned as extra tasks, and
+    // a fused group is split into them if they run faster
+    bool tune_fusion_plan = false;
+    // The directory of the cost models pretrained by PretrainCostModel, the tasks start from the one of the target
+    // arch if found and fine-tune it by the measurements, empty means starting from an untrained cost model
+    std::string pretrained_cost_model_dir = "";
+    // The seed of the random search, -1 means a random one from the device, fix it to reproduce a tuning session
+    utils::LinearRandomEngine::StateType random_seed = -1;
   };
 
   AutoTuner(const common::Target& target, hlir::framework::Graph* graph);
 
-  // Initialize tuner with specific config and auxiliary objects.
+  // Initialize tuner with specific config and auxiliary objects,
+  // the tuning states are restored if a checkpoint is found in config.checkpoint_dir.
   void Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler);
 
   // Perform the tuning process and return the final result
   TuningResult Tune(const TuningOptions& options);
 
+  // Save the best measured schedule of each task to a TuningPack file, which deploys the tuned kernels
+  void ExportTuningPack(const std::string& file_path) const;
+
+  // Train a cost model offline on the records of the tasks in the database, and save it to output_dir for the later
+  // tuning jobs on the same arch, return the number of the records trained on. The database should be configured
+  // with a large capacity_per_task to keep the slow candidates as well as the fast ones.
+  int PretrainCostModel(const std::string& output_dir) const;
+
  private:
+  // Save the states of the task scheduler, task optimizers and cost models to the checkpoint directory
+  void SaveCheckpoint(int num_finished_rounds);
+
+  // Restore the states from the checkpoint directory, return false if no checkpoint found
+  bool LoadCheckpoint();
+
+  std::string CheckpointFilePath() const;
+
+  // Split the fused groups whose sub groups run faster by the best measured records, and replace the results of the
+  // tasks with the ones of the groups to compile in order
+  void SelectFusionPlan(TuningResult* result) const;
+
   const common::Target& target_;
   hlir::framework::Graph* graph_;
   std::unique_ptr<hlir::framework::OpLowerer> op_lowerer_;
 
-  // Tasks to tune
+  // Tasks to tune, the ones of the fusion groups of the graph are followed by the ones of the split candidates
   std::vector<TuneTask> tasks_;
+  int num_group_tasks_ = 0;
+  std::vector<SplitCandidate> split_candidates_;
   // Scheduler that select a task to tune at every turn.
   std::unique_ptr<TaskScheduler> task_scheduler_;
   // The actor to perform auto-tune, each optimizer take a task.
@@ -73,6 +115,13 @@ class AutoTuner {
 
   // The database to store tuning record
   std::unique_ptr<Database> database_;
+
+  std::string checkpoint_dir_;
+  int checkpoint_interval_ = 1;
+  // The round to start tuning from, non-zero if resumed from a checkpoint
+  int resumed_round_ = 0;
+  // Whether the scheduler is restored in the middle of a round
+  bool resumed_ = false;
 };
 
 }  // namespace auto_schedule
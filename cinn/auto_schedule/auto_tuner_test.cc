@@ -125,10 +125,11 @@ class TestAutoTuner : public ::testing::Test {
     ApplyTunedAndRun(result);
   }
 
-  void NonZeroMeasure() {
+  void NonZeroMeasure(bool tune_fusion_plan = false) {
     // set config and options
     AutoTuner::Config tuning_config;
     tuning_config.task_schedule_strategy = "round_robin";
+    tuning_config.tune_fusion_plan       = tune_fusion_plan;
 
     TuningOptions tuning_options;
     tuning_options.num_measure_trials        = 4;
@@ -160,5 +161,11 @@ TEST_F(TestAutoTuner, NonZeroMeasure_EnableCostModel) {
   NonZeroMeasure();
 }
 
+TEST_F(TestAutoTuner, NonZeroMeasure_TuneFusionPlan) {
+  FLAGS_auto_schedule_use_cost_model = false;
+  // the group is compiled as a whole or split into the sub groups measured faster
+  NonZeroMeasure(/* tune_fusion_plan = */ true);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <atomic>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/feature.h"
@@ -32,45 +33,62 @@ float ExprCostModel::Predict(const ir::ModuleExpr& sample, const common::Target&
   if (trained_times_.load() == 0) {
     return SearchState::NOT_INIT_COST;
   }
-  FeatureExtractor extractor;
+  FeatureExtractor extractor(&feature_cache_);
   Feature feature                    = extractor.Extract(sample, target);
   std::vector<float> feature_numbers = feature.ToFixedSizeVector();
-  std::vector<float> pred            = XgbCostModel::Predict({feature_numbers});
+  std::vector<float> pred            = GbdtCostModel::Predict({feature_numbers});
   return pred[0];
 }
 
+std::vector<float> ExprCostModel::Predict(const std::vector<const ir::ModuleExpr*>& samples,
+                                          const common::Target& target) const {
+  if (trained_times_.load() == 0) {
+    return std::vector<float>(samples.size(), SearchState::NOT_INIT_COST);
+  }
+  std::vector<float> feature_matrix = ExtractFeatureMatrix(samples, target, &feature_cache_);
+  return GbdtCostModel::Predict(feature_matrix.data(), samples.size());
+}
+
 void ExprCostModel::Train(const std::vector<const ir::ModuleExpr*>& samples,
                           const std::vector<float>& labels,
                           const common::Target& target) {
   trained_times_.store(1);
-  size_t total_size = samples.size();
-  CHECK_EQ(total_size, labels.size()) << "Samples must have same size as labels";
-  std::vector<std::vector<float>> train_feature_numbers(total_size);
-  FeatureExtractor extractor;
-  for (size_t i = 0; i < total_size; ++i) {
-    CHECK(samples[i] != nullptr) << "Train samples cannot be nullptr";
-    Feature feature          = extractor.Extract(*samples[i], target);
-    train_feature_numbers[i] = feature.ToFixedSizeVector();
-  }
-
-  XgbCostModel::Train(train_feature_numbers, labels);
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  GbdtCostModel::Train(ExtractFeatures(samples, target), labels);
 }
 
 void ExprCostModel::Update(const std::vector<const ir::ModuleExpr*>& samples,
                            const std::vector<float>& labels,
                            const common::Target& target) {
   ++trained_times_;
-  size_t total_size = samples.size();
-  CHECK_EQ(total_size, labels.size()) << "Samples must have same size as labels";
-  std::vector<std::vector<float>> train_feature_numbers(total_size);
-  FeatureExtractor extractor;
-  for (size_t i = 0; i < total_size; ++i) {
-    CHECK(samples[i] != nullptr) << "Train samples cannot be nullptr";
-    Feature feature          = extractor.Extract(*samples[i], target);
-    train_feature_numbers[i] = feature.ToFixedSizeVector();
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  GbdtCostModel::Update(ExtractFeatures(samples, target), labels);
+}
+
+std::string ExprCostModel::PretrainedModelPath(const std::string& dir, const common::Target& target) {
+  std::string arch = target.arch_str();
+  if (target.arch == common::Target::Arch::NVGPU) {
+    arch += "_sm" + std::to_string(target.get_compute_capability());
+  } else if (target.is_cpu()) {
+    arch += "_vec" + std::to_string(target.cpu_vector_bits());
   }
+  return dir + "/expr_cost_model_" + arch + "_f" + std::to_string(Feature::kFixedSize) + ".bin";
+}
+
+void ExprCostModel::Load(const std::string& path) {
+  GbdtCostModel::Load(path);
+  trained_times_.store(1);
+}
 
-  XgbCostModel::Update(train_feature_numbers, labels);
+std::vector<std::vector<float>> ExprCostModel::ExtractFeatures(const std::vector<const ir::ModuleExpr*>& samples,
+                                                               const common::Target& target) const {
+  std::vector<float> feature_matrix = ExtractFeatureMatrix(samples, target, &feature_cache_);
+  std::vector<std::vector<float>> feature_numbers(samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    auto row_begin     = feature_matrix.begin() + i * Feature::kFixedSize;
+    feature_numbers[i] = std::vector<float>(row_begin, row_begin + Feature::kFixedSize);
+  }
+  return feature_numbers;
 }
 
 }  // namespace auto_schedule
@@ -15,9 +15,12 @@
 #pragma once
 
 #include <atomic>
+#include <string>
 #include <vector>
 
-#include "cinn/auto_schedule/cost_model/xgb_cost_model.h"
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+#include "cinn/common/target.h"
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
@@ -27,9 +30,18 @@ namespace auto_schedule {
  * A C++ cost model which trains and predicts on ir::Expr
  *
  */
-class ExprCostModel : public XgbCostModel {
+class ExprCostModel : public GbdtCostModel {
  public:
+  ExprCostModel() = default;
+  explicit ExprCostModel(const Config& config) : GbdtCostModel(config) {}
+
+  // The file of the model pretrained for target in dir, it is versioned by the arch, such as the compute capability
+  // of a GPU, and by the features, so a model never predicts on the features or the device it was not trained for
+  static std::string PretrainedModelPath(const std::string& dir, const common::Target& target);
+
   virtual float Predict(const ir::ModuleExpr& sample, const common::Target& target) const;
+  // Predict a batch of samples, the features are extracted in parallel
+  std::vector<float> Predict(const std::vector<const ir::ModuleExpr*>& samples, const common::Target& target) const;
   void Train(const std::vector<const ir::ModuleExpr*>& samples,
              const std::vector<float>& labels,
              const common::Target& target);
@@ -37,8 +49,20 @@ class ExprCostModel : public XgbCostModel {
               const std::vector<float>& labels,
               const common::Target& target);
 
+  // Load a model saved by Save, the loaded model predicts and is updated as a trained one
+  void Load(const std::string& path) override;
+
+  bool IsTrained() const { return trained_times_.load() > 0; }
+
  private:
+  // Extract the features of samples in parallel
+  std::vector<std::vector<float>> ExtractFeatures(const std::vector<const ir::ModuleExpr*>& samples,
+                                                  const common::Target& target) const;
+
   std::atomic<int> trained_times_{0};
+  // The features of loop subtrees shared by the samples, most candidates
+  // differ from their parents in a few loop nests only
+  mutable LoopFeatureCache feature_cache_;
 };
 
 }  // namespace auto_schedule
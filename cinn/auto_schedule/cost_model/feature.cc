@@ -29,6 +29,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -49,7 +50,7 @@ Feature::Feature(const common::Target& target)
       parent_indices_(1, -1) {}
 
 std::vector<float> Feature::ToFixedSizeVector() {
-  std::vector<float> ret(LoopBlockFeature::kTotalSize + 1, 0);  // LoopBlockFeature::kTotalSize plus 1 for target
+  std::vector<float> ret(kFixedSize, 0);
 
   if (target_ == common::DefaultNVGPUTarget()) {
     ret[0] = 1;
@@ -149,6 +150,18 @@ std::vector<float> Feature::ToFixedSizeVector() {
     ++j;
     ret[j] += (loop_feature.vectorize_factor * parent_prod);
     ++j;
+
+    ret[j] += loop_feature.unroll_body_ops;
+    ++j;
+    ret[j] += loop_feature.unroll_live_values;
+    ++j;
+
+    ret[j] += (loop_feature.parallel_waves * parent_prod);
+    ++j;
+    ret[j] += (loop_feature.parallel_idle_cores * parent_prod);
+    ++j;
+    ret[j] += (loop_feature.vector_register_lanes * parent_prod);
+    ++j;
   }
 
   for (size_t i = 0; i < ret.size(); ++i) {
@@ -158,6 +171,25 @@ std::vector<float> Feature::ToFixedSizeVector() {
   return ret;
 }
 
+double Feature::TotalFloatOps() const {
+  double total = 0.;
+  std::vector<double> iter_multi_num;
+  for (size_t i = 0; i < stack_encoded_feature_.size(); ++i) {
+    const LoopBlockFeature& loop_feature = stack_encoded_feature_[i];
+    double loop_prod                     = 1.;
+    if (i != 0) {
+      loop_prod = iter_multi_num[parent_indices_[i]] * std::max(loop_feature.loop_length, 1);
+    }
+    iter_multi_num.push_back(loop_prod);
+
+    int ops = loop_feature.float_add_or_sub + loop_feature.float_mul + loop_feature.float_div_or_mod +
+              loop_feature.float_math_func + loop_feature.float_reduce_sum_or_sub + loop_feature.float_reduce_mul +
+              loop_feature.float_reduce_div + loop_feature.float_reduce_max_or_min;
+    total += ops * loop_prod;
+  }
+  return total;
+}
+
 void Feature::IntoLoopBlock() {
   stack_encoded_feature_.emplace_back(LoopBlockFeature());
   stack_encoded_feature_[current_loop_block_index_].num_sub_loops += 1;
@@ -167,6 +199,30 @@ void Feature::IntoLoopBlock() {
 
 void Feature::ExitLoopBlock() { current_loop_block_index_ = parent_indices_[current_loop_block_index_]; }
 
+LoopBlockFeatures Feature::ExportLoopBlocks(int begin) const {
+  CHECK(begin > 0 && begin <= stack_encoded_feature_.size()) << "Invalid begin index of loop blocks: " << begin;
+  LoopBlockFeatures features;
+  features.blocks.assign(stack_encoded_feature_.begin() + begin, stack_encoded_feature_.end());
+  features.parent_indices.reserve(features.blocks.size());
+  for (int i = begin; i < stack_encoded_feature_.size(); ++i) {
+    features.parent_indices.push_back(i == begin ? -1 : parent_indices_[i] - begin);
+  }
+  return features;
+}
+
+void Feature::ImportLoopBlocks(const LoopBlockFeatures& features) {
+  CHECK_EQ(features.blocks.size(), features.parent_indices.size());
+  if (features.blocks.empty()) {
+    return;
+  }
+  int begin = stack_encoded_feature_.size();
+  stack_encoded_feature_[current_loop_block_index_].num_sub_loops += 1;
+  stack_encoded_feature_.insert(stack_encoded_feature_.end(), features.blocks.begin(), features.blocks.end());
+  for (int parent : features.parent_indices) {
+    parent_indices_.push_back(parent == -1 ? current_loop_block_index_ : parent + begin);
+  }
+}
+
 LoopBlockFeature& Feature::CurrentLoopBlock() { return stack_encoded_feature_[current_loop_block_index_]; }
 
 const LoopBlockFeature& Feature::CurrentLoopBlock() const { return stack_encoded_feature_[current_loop_block_index_]; }
@@ -106,7 +106,27 @@ class LoopBlockFeature {
 
   static constexpr int kThreadFeatureSize = 8;
 
-  static constexpr int kTotalSize = kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize;
+  /* Unroll features of a serial or unrolled loop estimated by optim::EstimateUnroll, of the body unrolled by the
+   * extent if the loop is tagged unrolled, or of one iteration otherwise.
+   * Useless in other cases.
+   */
+  int unroll_body_ops    = 0;  // the operations of the unrolled body
+  int unroll_live_values = 0;  // the values live in registers through the unrolled body
+
+  static constexpr int kUnrollFeatureSize = 2;
+
+  /* CPU features of the loops optimized on x86, relative to the host CPU described by Target::cpu_info().
+   * Useless in other cases.
+   */
+  int parallel_waves        = 0;  // the rounds of iterations each core runs for a parallel loop
+  int parallel_idle_cores   = 0;  // the cores left idle in the last round of a parallel loop
+  int vector_register_lanes = 0;  // the float lanes of the vector register for a vectorized loop
+
+  static constexpr int kCpuFeatureSize = 3;
+
+  static constexpr int kTotalSize =
+      kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize + kUnrollFeatureSize +
+      kCpuFeatureSize;
 
   /* Non-feature attributes, used to maintain during feature_extractor */
 
@@ -117,11 +137,24 @@ class LoopBlockFeature {
   int loop_length = 1;
 };
 
+/**
+ * The loop block features of a loop subtree, it is encoded in the
+ * same way as Feature, and parent_indices are relative to the subtree,
+ * the root loop block has no parent in the subtree so its index is -1.
+ */
+struct LoopBlockFeatures {
+  std::vector<LoopBlockFeature> blocks;
+  std::vector<int> parent_indices;
+};
+
 /**
  * Feature of Expr. It is used in CostModel
  */
 class Feature {
  public:
+  // The size of the vector returned by ToFixedSizeVector, LoopBlockFeature::kTotalSize plus 1 for target
+  static constexpr int kFixedSize = LoopBlockFeature::kTotalSize + 1;
+
   Feature();
 
   Feature(const common::Target& target);
@@ -129,6 +162,10 @@ class Feature {
   // Convert the various-length loop block features to fixed-size vector
   std::vector<float> ToFixedSizeVector();
 
+  // The floating point arithmetic operations, excluding the comparisons and the casts, of all the loop blocks, each
+  // multiplied by the lengths of its enclosing loops, where a loop of unknown length is counted as running once
+  double TotalFloatOps() const;
+
   // Call when visit into a loop block to collect LoopBlockFeature
   void IntoLoopBlock();
   // Call when exit a loop block to collect LoopBlockFeature
@@ -138,6 +175,13 @@ class Feature {
   // The current loop block which we should collect feature on
   const LoopBlockFeature& CurrentLoopBlock() const;
 
+  // The number of loop blocks collected so far
+  int NumLoopBlocks() const { return stack_encoded_feature_.size(); }
+  // Export the loop blocks since the index begin, they must be a loop subtree visited just now
+  LoopBlockFeatures ExportLoopBlocks(int begin) const;
+  // Import the loop blocks of a subtree as a sub loop of the current loop block
+  void ImportLoopBlocks(const LoopBlockFeatures& features);
+
  private:
   // We treat a computation feature to be encoded as variable-length vector.
   // The root compute block is not a loop, but we treat it as a size-1 loop.
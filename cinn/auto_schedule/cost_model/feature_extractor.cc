@@ -27,6 +27,7 @@
 
 #include "cinn/auto_schedule/cost_model/feature_extractor.h"
 
+#include <utility>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -37,24 +38,143 @@
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/transform_polyfor_to_for.h"
+#include "cinn/optim/unroll_loops.h"
+#include "cinn/utils/multi_threading.h"
 
 namespace cinn {
 namespace auto_schedule {
 
 using namespace ::cinn::ir;
 
-FeatureExtractor::FeatureExtractor() {}
+bool LoopFeatureCache::Find(uint64_t key, LoopBlockFeatures *features) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  *features = it->second;
+  return true;
+}
+
+void LoopFeatureCache::Insert(uint64_t key, LoopBlockFeatures features) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (entries_.size() >= capacity_) {
+    entries_.clear();
+  }
+  entries_.emplace(key, std::move(features));
+}
+
+size_t LoopFeatureCache::Size() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return entries_.size();
+}
+
+static void HashCombine(uint64_t *seed, uint64_t value) {
+  *seed ^= value + 0x9e3779b97f4a7c15ULL + (*seed << 6) + (*seed >> 2);
+}
+
+// Compute the structural hash of an Expr over the information that FeatureExtractor uses:
+// node types, data types, loop annotations, reduce types and the shape of the tree,
+// and record the hash of every For node in it.
+static uint64_t HashLoops(const Expr &expr, absl::flat_hash_map<const For *, uint64_t> *loop_hashes) {
+  if (!expr.defined()) {
+    return 0;
+  }
+  uint64_t hash = static_cast<uint64_t>(expr->node_type());
+  HashCombine(&hash, static_cast<uint64_t>(expr.type().type()));
+  HashCombine(&hash, expr.type().bits());
+  HashCombine(&hash, expr.type().lanes());
+  if (const For *loop = expr.As<For>()) {
+    HashCombine(&hash, static_cast<uint64_t>(loop->for_type()));
+    HashCombine(&hash, loop->vectorize_info().factor);
+    HashCombine(&hash, static_cast<uint64_t>(loop->bind_info().for_type));
+    HashCombine(&hash, loop->bind_info().offset);
+  } else if (const Reduce *reduce = expr.As<Reduce>()) {
+    HashCombine(&hash, static_cast<uint64_t>(reduce->reduce_type));
+  } else if (const IntrinsicOp *intrinsic = expr.As<IntrinsicOp>()) {
+    HashCombine(&hash, static_cast<uint64_t>(intrinsic->getKind()));
+  } else if (const IntImm *imm = expr.As<IntImm>()) {
+    // the constant extents decide the loop lengths
+    HashCombine(&hash, imm->value);
+  }
+
+  // the fields of tensors are not visited by FeatureExtractor
+  if (expr->node_type() != IrNodeTy::_Tensor_) {
+    std::vector<const Expr *> sub_exprs = static_cast<const IrNode *>(expr.ptr())->expr_fields();
+    HashCombine(&hash, sub_exprs.size());
+    for (const Expr *e : sub_exprs) {
+      HashCombine(&hash, HashLoops(*e, loop_hashes));
+    }
+  }
+  if (const For *loop = expr.As<For>()) {
+    loop_hashes->emplace(loop, hash);
+  }
+  return hash;
+}
+
+FeatureExtractor::FeatureExtractor() : cache_(nullptr) {}
+
+FeatureExtractor::FeatureExtractor(LoopFeatureCache *cache) : cache_(cache) {}
 
 void FeatureExtractor::Visit(const Expr *x) { IRVisitor::Visit(x); }
 
 Feature FeatureExtractor::Extract(const ir::ModuleExpr &mod_expr, const common::Target &target) {
   feature_ = Feature(target);
+  target_  = target;
+  loop_hashes_.clear();
+  if (cache_ != nullptr) {
+    for (const ir::Expr &e : mod_expr.GetExprs()) {
+      HashLoops(e, &loop_hashes_);
+    }
+    // the CPU features depend on the target too
+    for (auto &item : loop_hashes_) {
+      HashCombine(&item.second, static_cast<uint64_t>(target.arch));
+    }
+  }
   for (const ir::Expr &e : mod_expr.GetExprs()) {
     Visit(&e);
   }
   return feature_;
 }
 
+std::vector<float> ExtractFeatureMatrix(const std::vector<const ir::ModuleExpr *> &samples,
+                                        const common::Target &target,
+                                        LoopFeatureCache *cache) {
+  std::vector<float> matrix(samples.size() * Feature::kFixedSize);
+  if (samples.empty()) {
+    return matrix;
+  }
+  auto extract_fn = [&samples, &target, cache, &matrix](int index) {
+    CHECK(samples[index] != nullptr) << "Samples of cost model cannot be nullptr";
+    FeatureExtractor extractor(cache);
+    std::vector<float> row = extractor.Extract(*samples[index], target).ToFixedSizeVector();
+    std::copy(row.begin(), row.end(), matrix.begin() + static_cast<size_t>(index) * Feature::kFixedSize);
+  };
+  utils::parallel_run(extract_fn, utils::SequenceDispatcher(0, samples.size()), samples.size());
+  return matrix;
+}
+
+double KernelWork::arithmetic_intensity() const {
+  double bytes = bytes_read + bytes_written;
+  return bytes > 0. ? flops / bytes : 0.;
+}
+
+KernelWork AnalyzeKernelWork(const ir::LoweredFunc &func, const common::Target &target) {
+  KernelWork work;
+  FeatureExtractor extractor;
+  work.flops = extractor.Extract(ir::ModuleExpr({func->body}), target).TotalFloatOps();
+  for (auto &arg : func->args) {
+    if (!arg.is_buffer()) continue;
+    auto buffer  = arg.buffer_arg();
+    double bytes = buffer->dtype.bytes();
+    for (auto &dim : buffer->shape) {
+      bytes = dim.is_constant() ? bytes * dim.get_constant() : 0.;
+    }
+    (arg.is_output() ? work.bytes_written : work.bytes_read) += bytes;
+  }
+  return work;
+}
+
 #define VisitDoNothing(NodeType)                            \
   void FeatureExtractor::Visit(const NodeType *x) {         \
     std::vector<const Expr *> sub_exprs = x->expr_fields(); \
@@ -162,6 +282,17 @@ VisitCountMemberPattern(Store, mem_write);
 /* Visit for loops */
 
 void FeatureExtractor::Visit(const For *x) {
+  // reuse the features of the same loop subtree extracted before
+  auto hash_it = loop_hashes_.find(x);
+  if (hash_it != loop_hashes_.end()) {
+    LoopBlockFeatures cached;
+    if (cache_->Find(hash_it->second, &cached)) {
+      feature_.ImportLoopBlocks(cached);
+      return;
+    }
+  }
+
+  int begin = feature_.NumLoopBlocks();
   feature_.IntoLoopBlock();
 
   LoopBlockFeature &loop_feature = feature_.CurrentLoopBlock();
@@ -171,14 +302,23 @@ void FeatureExtractor::Visit(const For *x) {
     loop_feature.loop_length = -1;  // -1 represents unknown
   }
 
+  bool is_cpu = target_.is_cpu();
   if (x->is_parallel()) {
     loop_feature.loop_opt_type = ForOptimizeFeatureEnum::kParallel;
     loop_feature.len_vthread   = loop_feature.loop_length;
+    if (is_cpu && loop_feature.loop_length > 0) {
+      int num_cores                    = target_.cpu_info().num_cores;
+      loop_feature.parallel_waves      = (loop_feature.loop_length + num_cores - 1) / num_cores;
+      loop_feature.parallel_idle_cores = loop_feature.parallel_waves * num_cores - loop_feature.loop_length;
+    }
   } else if (x->is_unrolled()) {
     loop_feature.loop_opt_type = ForOptimizeFeatureEnum::kUnroll;
   } else if (x->is_vectorized()) {
     loop_feature.loop_opt_type    = ForOptimizeFeatureEnum::kVectorize;
     loop_feature.vectorize_factor = x->vectorize_info().factor;
+    if (is_cpu) {
+      loop_feature.vector_register_lanes = target_.cpu_vector_bits() / 32;
+    }
   } else if (x->is_binded()) {
     loop_feature.loop_opt_type = ForOptimizeFeatureEnum::kGpuBind;
     const BindInfo &bind_info  = x->bind_info();
@@ -202,12 +342,22 @@ void FeatureExtractor::Visit(const For *x) {
     }
   }
 
+  if ((x->is_serial() || x->is_unrolled()) && loop_feature.loop_length > 0) {
+    optim::UnrollEstimate estimate  = optim::EstimateUnroll(x);
+    int copies                      = x->is_unrolled() ? loop_feature.loop_length : 1;
+    loop_feature.unroll_body_ops    = copies * estimate.body_ops;
+    loop_feature.unroll_live_values = estimate.invariant_values + copies * estimate.live_values;
+  }
+
   std::vector<const Expr *> sub_exprs = x->expr_fields();
   for (const Expr *e : sub_exprs) {
     Visit(e);
   }
 
   feature_.ExitLoopBlock();
+  if (hash_it != loop_hashes_.end()) {
+    cache_->Insert(hash_it->second, feature_.ExportLoopBlocks(begin));
+  }
 }
 
 void FeatureExtractor::Visit(const PolyFor *x) {
@@ -27,19 +27,50 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 #include "cinn/auto_schedule/cost_model/feature.h"
 #include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/ir_visitor.h"
+#include "cinn/ir/lowered_func.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+/**
+ * The cache of the features of loop subtrees, keyed by the structural hash of the
+ * information that the features are extracted from, so a loop nest unchanged by
+ * the mutation of a schedule needn't be extracted again. It can be shared by threads.
+ */
+class LoopFeatureCache {
+ public:
+  // All entries are dropped once the number of them exceeds the capacity
+  explicit LoopFeatureCache(size_t capacity = 65536) : capacity_(capacity) {}
+
+  bool Find(uint64_t key, LoopBlockFeatures* features) const;
+
+  void Insert(uint64_t key, LoopBlockFeatures features);
+
+  size_t Size() const;
+
+ private:
+  size_t capacity_;
+  mutable std::mutex mtx_;
+  absl::flat_hash_map<uint64_t, LoopBlockFeatures> entries_;
+};
+
 class FeatureExtractor : public ir::IRVisitor {
  public:
   FeatureExtractor();
+  // The features of loop subtrees are looked up in and saved to the cache if it isn't nullptr
+  explicit FeatureExtractor(LoopFeatureCache* cache);
   Feature Extract(const ir::ModuleExpr& mod_expr, const common::Target& target);
 
   void Visit(const Expr* x) override;
@@ -54,7 +85,33 @@ class FeatureExtractor : public ir::IRVisitor {
 
  private:
   Feature feature_;
+  common::Target target_;
+  LoopFeatureCache* cache_;
+  // The structural hashes of loops in the ModuleExpr being extracted
+  absl::flat_hash_map<const ir::For*, uint64_t> loop_hashes_;
 };
 
+// Extract the fixed-size features of samples in parallel, and return them as a row-major
+// matrix of samples.size() rows and Feature::kFixedSize columns, ready for the cost model
+std::vector<float> ExtractFeatureMatrix(const std::vector<const ir::ModuleExpr*>& samples,
+                                        const common::Target& target,
+                                        LoopFeatureCache* cache = nullptr);
+
+/**
+ * The static work of a lowered function for the roofline analysis: the floating point operations counted by
+ * FeatureExtractor, and the bytes of the buffer arguments read and written, which is the memory traffic of the kernel
+ * if no element is loaded twice from the memory. The buffers of non-constant shapes are not counted.
+ */
+struct KernelWork {
+  double flops{0.};
+  double bytes_read{0.};
+  double bytes_written{0.};
+
+  // The flops per byte of the memory traffic, 0 if no byte is counted
+  double arithmetic_intensity() const;
+};
+
+KernelWork AnalyzeKernelWork(const ir::LoweredFunc& func, const common::Target& target);
+
 }  // namespace auto_schedule
 }  // namespace cinn
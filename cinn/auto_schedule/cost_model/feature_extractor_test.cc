@@ -29,6 +29,7 @@
 #include "cinn/lang/compute.h"
 #include "cinn/lang/lower.h"
 #include "cinn/lang/placeholder.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/poly/stage.h"
 
 namespace cinn {
@@ -63,10 +64,12 @@ TEST(FeatureExtractor, SimpleAssign) {
   std::vector<float> to_check = feature.ToFixedSizeVector();
 
   ASSERT_EQ(to_check.size(), static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
+  size_t unroll_begin = LoopBlockFeature::kTotalSize + 1 - LoopBlockFeature::kCpuFeatureSize -
+                        LoopBlockFeature::kUnrollFeatureSize;
   VLOG(6) << "Feature data before slog:";
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
-    if (i != 0 && i != 17 && i != 18 && i != 29) {
+    if (i != 0 && i != 17 && i != 18 && i != 29 && i != unroll_begin && i != unroll_begin + 1) {
       ASSERT_EQ(to_check[i], 0);
     }
   }
@@ -82,6 +85,43 @@ TEST(FeatureExtractor, SimpleAssign) {
   ASSERT_EQ(to_check[18], slog(M.get_constant() * N.get_constant()));  // mem_write
   // non-opt loops, including root block
   ASSERT_EQ(to_check[29], slog(3));
+  // one iteration of the outer loop runs the inner loop, a load and a store, and that of the inner one runs the
+  // load and the store, each loading one value
+  ASSERT_EQ(to_check[unroll_begin], slog(3 + 2));
+  ASSERT_EQ(to_check[unroll_begin + 1], slog(1 + 1));
+}
+
+TEST(FeatureExtractor, CpuFeatures) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+  int num_cores = target.cpu_info().num_cores;
+  ir::Expr M(num_cores * 2 + 1);
+  ir::Expr N(32);
+
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j); }, "B");
+
+  poly::StageMap stages              = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec("CpuFeatures", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::IRSchedule ir_sch(ir::ModuleExpr({funcs[0]->body}));
+  ir_sch.Parallel(ir_sch.GetLoops("B")[0]);
+  ir_sch.Vectorize(ir_sch.GetLoops("B")[1], 8);
+
+  std::vector<float> to_check = FeatureExtractor().Extract(ir_sch.GetModule(), target).ToFixedSizeVector();
+  ASSERT_EQ(to_check.size(), static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
+  int cpu_begin = LoopBlockFeature::kTotalSize + 1 - LoopBlockFeature::kCpuFeatureSize;
+  // the parallel loop runs 3 rounds on the cores, and all but one core are idle in the last round
+  ASSERT_EQ(to_check[cpu_begin], slog(3));
+  ASSERT_EQ(to_check[cpu_begin + 1], slog(num_cores - 1));
+  // the vectorized loop runs once in every iteration of the parallel loop
+  ASSERT_EQ(to_check[cpu_begin + 2], slog(M.as_int32() * (target.x86_vector_bits() / 32)));
+
+  // the CPU features are only extracted on x86
+  to_check = FeatureExtractor().Extract(ir_sch.GetModule(), common::UnkTarget()).ToFixedSizeVector();
+  for (int i = cpu_begin; i < to_check.size(); ++i) {
+    ASSERT_EQ(to_check[i], 0);
+  }
 }
 
 TEST(FeatureExtractor, MatrixMultiply) {
@@ -122,7 +162,9 @@ TEST(FeatureExtractor, MatrixMultiply) {
   std::vector<float> to_check = feature.ToFixedSizeVector();
 
   ASSERT_EQ(to_check.size(), static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
-  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37};
+  size_t unroll_begin = LoopBlockFeature::kTotalSize + 1 - LoopBlockFeature::kCpuFeatureSize -
+                        LoopBlockFeature::kUnrollFeatureSize;
+  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37, unroll_begin, unroll_begin + 1};
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
     if (!non_zero_indice.count(i)) {
@@ -154,5 +196,68 @@ TEST(FeatureExtractor, MatrixMultiply) {
   ASSERT_EQ(to_check[37], slog(out_loop));
 }
 
+TEST(FeatureExtractor, CachedLoopFeatures) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+  ir::Expr M(32);
+  ir::Expr N(32);
+
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * ir::Expr(2.f); }, "B");
+  ir::Tensor C = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + ir::Expr(1.f); }, "C");
+
+  poly::StageMap stages = poly::CreateStages({A, B, C});
+  auto funcs_b          = lang::LowerVec("CachedB", stages, {A, B}, {}, {}, nullptr, target, true);
+  auto funcs_c          = lang::LowerVec("CachedC", stages, {A, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs_b[0]->body, funcs_c[0]->body});
+
+  std::vector<float> expected = FeatureExtractor().Extract(mod_expr, target).ToFixedSizeVector();
+  LoopFeatureCache cache;
+  ASSERT_EQ(FeatureExtractor(&cache).Extract(mod_expr, target).ToFixedSizeVector(), expected);
+  size_t cache_size = cache.Size();
+  ASSERT_GT(cache_size, 0UL);
+  // all loops hit the cache at the second time
+  ASSERT_EQ(FeatureExtractor(&cache).Extract(mod_expr, target).ToFixedSizeVector(), expected);
+  ASSERT_EQ(cache.Size(), cache_size);
+
+  // only the changed loops are extracted again
+  ir::IRSchedule ir_sch(optim::IRCopy(mod_expr));
+  auto loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[1], {4, 8});
+  expected                    = FeatureExtractor().Extract(ir_sch.GetModule(), target).ToFixedSizeVector();
+  std::vector<float> to_check = FeatureExtractor(&cache).Extract(ir_sch.GetModule(), target).ToFixedSizeVector();
+  ASSERT_EQ(to_check, expected);
+  ASSERT_GT(cache.Size(), cache_size);
+
+  // the batched features are the same as extracted one by one
+  std::vector<float> matrix = ExtractFeatureMatrix({&mod_expr, &ir_sch.GetModule()}, target, &cache);
+  ASSERT_EQ(matrix.size(), 2UL * Feature::kFixedSize);
+  ASSERT_EQ(std::vector<float>(matrix.begin() + Feature::kFixedSize, matrix.end()), expected);
+}
+
+TEST(FeatureExtractor, AnalyzeKernelWork) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+  ir::Expr M(32);
+  ir::Expr N(16);
+
+  lang::Placeholder<float> A("A", {M, N});
+  lang::Placeholder<float> B("B", {M, N});
+  ir::Tensor C = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * B(i, j) + B(i, j); }, "C");
+
+  poly::StageMap stages              = poly::CreateStages({A, B, C});
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec("KernelWork", stages, {A, B, C}, {}, {}, nullptr, target, true);
+
+  KernelWork work = AnalyzeKernelWork(funcs[0], target);
+  // a multiplication and an addition of each element, and the index arithmetic is not counted
+  ASSERT_EQ(work.flops, 2. * 32 * 16);
+  ASSERT_EQ(work.bytes_read, 2. * 32 * 16 * 4);
+  ASSERT_EQ(work.bytes_written, 32. * 16 * 4);
+  ASSERT_DOUBLE_EQ(work.arithmetic_intensity(), 2. / 12);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -0,0 +1,353 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+constexpr uint32_t kGbdtMagic   = 0x54424743;  // "CGBT"
+constexpr uint32_t kGbdtVersion = 1;
+
+// the minimum gain to split a node
+constexpr double kMinSplitGain = 1e-6;
+
+// The cut points to quantize the values of a feature, a value falls in the bin of the number of cuts <= it.
+std::vector<float> BuildCuts(std::vector<float> values, int num_bins) {
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  std::vector<float> cuts;
+  if (values.size() <= 1) {
+    return cuts;
+  }
+  if (values.size() <= static_cast<size_t>(num_bins)) {
+    // exact, split between every two distinct values
+    for (size_t i = 1; i < values.size(); ++i) {
+      cuts.push_back(values[i - 1] + (values[i] - values[i - 1]) / 2);
+    }
+    return cuts;
+  }
+  for (int i = 1; i < num_bins; ++i) {
+    size_t pos = values.size() * i / num_bins;
+    float cut  = values[pos - 1] + (values[pos] - values[pos - 1]) / 2;
+    if (cuts.empty() || cut > cuts.back()) {
+      cuts.push_back(cut);
+    }
+  }
+  return cuts;
+}
+
+template <typename T>
+void WritePod(std::ofstream* ofs, const T& value) {
+  ofs->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void ReadPod(std::ifstream* ifs, T* value) {
+  ifs->read(reinterpret_cast<char*>(value), sizeof(T));
+}
+
+}  // namespace
+
+GbdtCostModel::GbdtCostModel() : GbdtCostModel(Config()) {}
+
+GbdtCostModel::GbdtCostModel(const Config& config) : config_(config) {
+  CHECK_GT(config_.num_rounds, 0);
+  CHECK_GT(config_.max_depth, 0);
+  CHECK_GT(config_.num_bins, 1);
+  CHECK_LE(config_.num_bins, 65536) << "The bins are indexed by uint16_t";
+  CHECK_GE(config_.min_samples_leaf, 1);
+}
+
+void GbdtCostModel::Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  nodes_.clear();
+  tree_roots_.clear();
+  samples_.clear();
+  labels_.clear();
+  preds_.clear();
+  num_base_trees_ = 0;
+  num_base_nodes_ = 0;
+  num_features_   = samples.empty() ? 0 : samples[0].size();
+  AppendSamples(samples, labels);
+  Boost(config_.num_rounds);
+}
+
+void GbdtCostModel::Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  if (tree_roots_.empty() && samples_.empty()) {
+    Train(samples, labels);
+    return;
+  }
+  AppendSamples(samples, labels);
+  if (NumTrees() + config_.num_rounds > config_.max_trees) {
+    // keep the loaded trees if there is room to boost after them, the predictions are recomputed by them
+    bool keep_base = num_base_trees_ > 0 && num_base_trees_ + config_.num_rounds <= config_.max_trees;
+    VLOG(4) << "GbdtCostModel retrains " << (keep_base ? "after the loaded trees" : "from scratch") << " with "
+            << labels_.size() << " samples";
+    tree_roots_.resize(keep_base ? num_base_trees_ : 0);
+    nodes_.resize(keep_base ? num_base_nodes_ : 0);
+    preds_.clear();
+    if (keep_base) {
+      for (size_t i = 0; i < labels_.size(); ++i) {
+        float pred = base_score_;
+        for (int root : tree_roots_) {
+          pred += PredictTree(root, &samples_[i * num_features_]);
+        }
+        preds_.push_back(pred);
+      }
+    } else {
+      num_base_trees_ = 0;
+      num_base_nodes_ = 0;
+    }
+  }
+  Boost(config_.num_rounds);
+}
+
+void GbdtCostModel::AppendSamples(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  for (auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "All the samples must have the same number of features";
+    samples_.insert(samples_.end(), sample.begin(), sample.end());
+    float pred = base_score_;
+    for (int root : tree_roots_) {
+      pred += PredictTree(root, sample.data());
+    }
+    preds_.push_back(pred);
+  }
+  labels_.insert(labels_.end(), labels.begin(), labels.end());
+}
+
+void GbdtCostModel::Boost(int num_rounds) {
+  int num_samples = labels_.size();
+  if (num_samples == 0) {
+    return;
+  }
+  if (tree_roots_.empty()) {
+    base_score_ = std::accumulate(labels_.begin(), labels_.end(), 0.0) / num_samples;
+    preds_.assign(num_samples, base_score_);
+  }
+
+  // quantize the features, bins are stored by feature so that a histogram scans contiguous memory
+  std::vector<std::vector<float>> cuts(num_features_);
+  std::vector<uint16_t> bins(static_cast<size_t>(num_features_) * num_samples);
+  std::vector<float> values(num_samples);
+  for (int f = 0; f < num_features_; ++f) {
+    for (int i = 0; i < num_samples; ++i) {
+      values[i] = samples_[static_cast<size_t>(i) * num_features_ + f];
+    }
+    cuts[f] = BuildCuts(values, config_.num_bins);
+    for (int i = 0; i < num_samples; ++i) {
+      bins[static_cast<size_t>(f) * num_samples + i] =
+          std::upper_bound(cuts[f].begin(), cuts[f].end(), values[i]) - cuts[f].begin();
+    }
+  }
+
+  std::vector<float> grads(num_samples);
+  std::vector<int> index(num_samples);
+  for (int round = 0; round < num_rounds; ++round) {
+    // the gradient of the squared error, the hessian is 1 for all the samples
+    for (int i = 0; i < num_samples; ++i) {
+      grads[i] = preds_[i] - labels_[i];
+    }
+    std::iota(index.begin(), index.end(), 0);
+    int root = BuildNode(bins, cuts, grads, &index, 0, num_samples, 0);
+    tree_roots_.push_back(root);
+    for (int i = 0; i < num_samples; ++i) {
+      preds_[i] += PredictTree(root, &samples_[static_cast<size_t>(i) * num_features_]);
+    }
+  }
+  VLOG(4) << "GbdtCostModel holds " << NumTrees() << " trees and " << nodes_.size() << " nodes after boosting on "
+          << num_samples << " samples";
+}
+
+int GbdtCostModel::BuildNode(const std::vector<uint16_t>& bins,
+                             const std::vector<std::vector<float>>& cuts,
+                             const std::vector<float>& grads,
+                             std::vector<int>* index,
+                             int begin,
+                             int end,
+                             int depth) {
+  int num_samples = labels_.size();
+  int count       = end - begin;
+  double sum_grad = 0.0;
+  for (int k = begin; k < end; ++k) {
+    sum_grad += grads[(*index)[k]];
+  }
+  double parent_score = sum_grad * sum_grad / (count + config_.l2_reg);
+
+  int node_idx = nodes_.size();
+  nodes_.emplace_back();
+  nodes_[node_idx].value = -sum_grad / (count + config_.l2_reg) * config_.learning_rate;
+  if (depth >= config_.max_depth || count < 2 * config_.min_samples_leaf) {
+    return node_idx;
+  }
+
+  // find the split with the largest gain on the histograms of the gradients
+  int best_feature = -1;
+  int best_cut     = -1;
+  double best_gain = kMinSplitGain;
+  std::vector<double> hist_grad;
+  std::vector<int> hist_count;
+  for (int f = 0; f < num_features_; ++f) {
+    int num_cuts = cuts[f].size();
+    if (num_cuts == 0) continue;
+    hist_grad.assign(num_cuts + 1, 0.0);
+    hist_count.assign(num_cuts + 1, 0);
+    const uint16_t* feature_bins = &bins[static_cast<size_t>(f) * num_samples];
+    for (int k = begin; k < end; ++k) {
+      int i = (*index)[k];
+      hist_grad[feature_bins[i]] += grads[i];
+      hist_count[feature_bins[i]] += 1;
+    }
+    double left_grad = 0.0;
+    int left_count   = 0;
+    for (int j = 0; j < num_cuts; ++j) {
+      left_grad += hist_grad[j];
+      left_count += hist_count[j];
+      int right_count = count - left_count;
+      if (left_count < config_.min_samples_leaf) continue;
+      if (right_count < config_.min_samples_leaf) break;
+      double right_grad  = sum_grad - left_grad;
+      double left_score  = left_grad * left_grad / (left_count + config_.l2_reg);
+      double right_score = right_grad * right_grad / (right_count + config_.l2_reg);
+      double gain        = left_score + right_score - parent_score;
+      if (gain > best_gain) {
+        best_gain    = gain;
+        best_feature = f;
+        best_cut     = j;
+      }
+    }
+  }
+  if (best_feature < 0) {
+    return node_idx;
+  }
+
+  const uint16_t* feature_bins = &bins[static_cast<size_t>(best_feature) * num_samples];
+  auto go_left                 = [&](int i) { return feature_bins[i] <= best_cut; };
+  int mid = std::partition(index->begin() + begin, index->begin() + end, go_left) - index->begin();
+  int left  = BuildNode(bins, cuts, grads, index, begin, mid, depth + 1);
+  int right = BuildNode(bins, cuts, grads, index, mid, end, depth + 1);
+  // the children may grow the nodes, so the node is referred by index
+  nodes_[node_idx].feature   = best_feature;
+  nodes_[node_idx].threshold = cuts[best_feature][best_cut];
+  nodes_[node_idx].left      = left;
+  nodes_[node_idx].right     = right;
+  return node_idx;
+}
+
+float GbdtCostModel::PredictTree(int root, const float* sample) const {
+  const Node* node = &nodes_[root];
+  while (node->feature >= 0) {
+    node = &nodes_[sample[node->feature] < node->threshold ? node->left : node->right];
+  }
+  return node->value;
+}
+
+std::vector<float> GbdtCostModel::Predict(const std::vector<std::vector<float>>& samples) const {
+  std::vector<float> result(samples.size(), base_score_);
+  for (auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "The number of features doesn't match the trained model";
+  }
+  // walk a tree for all the samples before the next one, to keep the nodes in cache
+  for (int root : tree_roots_) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+      result[i] += PredictTree(root, samples[i].data());
+    }
+  }
+  return result;
+}
+
+std::vector<float> GbdtCostModel::Predict(const float* samples, int num_samples) const {
+  std::vector<float> result(num_samples, base_score_);
+  for (int root : tree_roots_) {
+    for (int i = 0; i < num_samples; ++i) {
+      result[i] += PredictTree(root, samples + static_cast<size_t>(i) * num_features_);
+    }
+  }
+  return result;
+}
+
+void GbdtCostModel::Save(const std::string& path) {
+  std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK(ofs.is_open()) << "Failed to open [" << path << "] to save the cost model";
+  WritePod(&ofs, kGbdtMagic);
+  WritePod(&ofs, kGbdtVersion);
+  WritePod(&ofs, static_cast<int32_t>(num_features_));
+  WritePod(&ofs, base_score_);
+  WritePod(&ofs, static_cast<int32_t>(tree_roots_.size()));
+  ofs.write(reinterpret_cast<const char*>(tree_roots_.data()), tree_roots_.size() * sizeof(int32_t));
+  WritePod(&ofs, static_cast<int32_t>(nodes_.size()));
+  for (auto& node : nodes_) {
+    WritePod(&ofs, node.feature);
+    WritePod(&ofs, node.threshold);
+    WritePod(&ofs, node.left);
+    WritePod(&ofs, node.right);
+    WritePod(&ofs, node.value);
+  }
+  CHECK(ofs.good()) << "Failed to save the cost model to [" << path << "]";
+}
+
+void GbdtCostModel::Load(const std::string& path) {
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  CHECK(ifs.is_open()) << "Failed to open the cost model [" << path << "]";
+  uint32_t magic = 0, version = 0;
+  ReadPod(&ifs, &magic);
+  ReadPod(&ifs, &version);
+  CHECK(ifs.good() && magic == kGbdtMagic) << "[" << path << "] is not a cost model saved by GbdtCostModel";
+  CHECK_EQ(version, kGbdtVersion) << "The version of the cost model is not supported";
+
+  int32_t num_features = 0, num_trees = 0, num_nodes = 0;
+  ReadPod(&ifs, &num_features);
+  ReadPod(&ifs, &base_score_);
+  ReadPod(&ifs, &num_trees);
+  CHECK(ifs.good() && num_features >= 0 && num_trees >= 0) << "The cost model [" << path << "] is broken";
+  tree_roots_.resize(num_trees);
+  ifs.read(reinterpret_cast<char*>(tree_roots_.data()), num_trees * sizeof(int32_t));
+  ReadPod(&ifs, &num_nodes);
+  CHECK(ifs.good() && num_nodes >= 0) << "The cost model [" << path << "] is broken";
+  nodes_.resize(num_nodes);
+  for (auto& node : nodes_) {
+    ReadPod(&ifs, &node.feature);
+    ReadPod(&ifs, &node.threshold);
+    ReadPod(&ifs, &node.left);
+    ReadPod(&ifs, &node.right);
+    ReadPod(&ifs, &node.value);
+  }
+  CHECK(ifs.good()) << "The cost model [" << path << "] is broken";
+  auto valid_node = [num_nodes](int32_t idx) { return idx >= 0 && idx < num_nodes; };
+  for (int32_t root : tree_roots_) {
+    CHECK(valid_node(root)) << "The cost model [" << path << "] is broken";
+  }
+  for (auto& node : nodes_) {
+    CHECK(node.feature < num_features && (node.feature < 0 || (valid_node(node.left) && valid_node(node.right))))
+        << "The cost model [" << path << "] is broken";
+  }
+  num_features_   = num_features;
+  num_base_trees_ = num_trees;
+  num_base_nodes_ = num_nodes;
+  // the training samples are not saved, Update continues on the new samples only
+  samples_.clear();
+  labels_.clear();
+  preds_.clear();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
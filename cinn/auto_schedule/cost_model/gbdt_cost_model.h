@@ -0,0 +1,113 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cinn/common/cost_model.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * A native gradient boosted decision tree cost model, which runs in process without Python.
+ *
+ * The trees fit the squared error on the histograms of the quantized features. Train fits the model from scratch,
+ * and Update keeps the trees and boosts more rounds on all the samples seen so far, so the model is refined
+ * incrementally as the tuning goes. The nodes of all the trees are kept in one flat array, Predict walks each tree
+ * for the whole batch before the next one, so a tree stays in cache while scoring thousands of samples.
+ */
+class GbdtCostModel : public CostModel {
+ public:
+  struct Config {
+    // the trees added by each Train or Update
+    int num_rounds = 10;
+    int max_depth  = 6;
+    // the shrinkage of each tree
+    float learning_rate = 0.3f;
+    // the L2 regularization on the leaf values
+    float l2_reg         = 1.0f;
+    int min_samples_leaf = 1;
+    // the max number of the bins to quantize a feature into
+    int num_bins = 64;
+    // Update retrains the model from scratch once it holds more trees than this, the trees of a loaded model are
+    // kept as the base and only the ones boosted after loading are retrained
+    int max_trees = 200;
+  };
+
+  GbdtCostModel();
+  explicit GbdtCostModel(const Config& config);
+
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const override;
+
+  // Predict the samples given in a row-major matrix of num_samples rows, each has the features as many as trained
+  std::vector<float> Predict(const float* samples, int num_samples) const;
+
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  void Save(const std::string& path) override;
+
+  void Load(const std::string& path) override;
+
+  int NumTrees() const { return tree_roots_.size(); }
+
+ private:
+  struct Node {
+    // the index of the feature to split on, -1 for a leaf
+    int32_t feature{-1};
+    // a sample goes to the left child if its feature is less than the threshold
+    float threshold{0.0f};
+    int32_t left{-1};
+    int32_t right{-1};
+    // the output of a leaf
+    float value{0.0f};
+  };
+
+  // Add \p samples to the training set, their current predictions are computed by the existing trees.
+  void AppendSamples(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+  void Boost(int num_rounds);
+  // Build the subtree of the samples indexed by index[begin, end), and return the index of its root.
+  int BuildNode(const std::vector<uint16_t>& bins,
+                const std::vector<std::vector<float>>& cuts,
+                const std::vector<float>& grads,
+                std::vector<int>* index,
+                int begin,
+                int end,
+                int depth);
+  float PredictTree(int root, const float* sample) const;
+
+  Config config_;
+  int num_features_{0};
+  // the initial prediction of all the samples
+  float base_score_{0.0f};
+  std::vector<Node> nodes_;
+  std::vector<int32_t> tree_roots_;
+  // the trees and nodes loaded by Load, they are kept when Update retrains, so a pretrained model is fine-tuned
+  // rather than forgotten
+  int num_base_trees_{0};
+  int num_base_nodes_{0};
+
+  // the samples seen so far in row-major, with their labels and predictions
+  std::vector<float> samples_;
+  std::vector<float> labels_;
+  std::vector<float> preds_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
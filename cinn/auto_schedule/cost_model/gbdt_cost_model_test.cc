@@ -0,0 +1,141 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+// y = 2 * x0 + (x1 > 5 ? 3 : 0), the other features are noise
+static void GenerateSamples(int num_samples, std::vector<std::vector<float>>* samples, std::vector<float>* labels) {
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<float> dist(0.0f, 10.0f);
+  for (int i = 0; i < num_samples; ++i) {
+    std::vector<float> sample(8);
+    for (auto& value : sample) {
+      value = dist(engine);
+    }
+    samples->push_back(sample);
+    labels->push_back(2 * sample[0] + (sample[1] > 5 ? 3 : 0));
+  }
+}
+
+static float MeanSquaredError(const std::vector<float>& preds, const std::vector<float>& labels) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < preds.size(); ++i) {
+    sum += (preds[i] - labels[i]) * (preds[i] - labels[i]);
+  }
+  return sum / preds.size();
+}
+
+TEST(GbdtCostModel, TrainAndPredict) {
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(512, &samples, &labels);
+
+  GbdtCostModel cost_model;
+  cost_model.Train(samples, labels);
+  ASSERT_EQ(cost_model.NumTrees(), 10);
+  std::vector<float> pred = cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), samples.size());
+  // the variance of the labels is about 35
+  ASSERT_LT(MeanSquaredError(pred, labels), 1.0f);
+}
+
+TEST(GbdtCostModel, Update) {
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(256, &samples, &labels);
+
+  GbdtCostModel::Config config;
+  config.num_rounds = 2;
+  config.max_trees  = 6;
+  GbdtCostModel cost_model(config);
+  cost_model.Train(samples, labels);
+  float error = MeanSquaredError(cost_model.Predict(samples), labels);
+
+  // the new trees fit the residuals of all the samples seen so far
+  cost_model.Update(samples, labels);
+  ASSERT_EQ(cost_model.NumTrees(), 4);
+  float updated_error = MeanSquaredError(cost_model.Predict(samples), labels);
+  ASSERT_LT(updated_error, error);
+
+  cost_model.Update(samples, labels);
+  ASSERT_EQ(cost_model.NumTrees(), 6);
+  // retrain from scratch once there would be too many trees
+  cost_model.Update(samples, labels);
+  ASSERT_EQ(cost_model.NumTrees(), 2);
+}
+
+TEST(GbdtCostModel, SaveAndLoad) {
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(128, &samples, &labels);
+
+  GbdtCostModel cost_model;
+  cost_model.Train(samples, labels);
+  std::vector<float> pred = cost_model.Predict(samples);
+
+  std::string path = "./test_gbdt_cost_model.bin";
+  cost_model.Save(path);
+  GbdtCostModel load_cost_model;
+  load_cost_model.Load(path);
+  std::remove(path.c_str());
+
+  ASSERT_EQ(load_cost_model.NumTrees(), cost_model.NumTrees());
+  std::vector<float> load_pred = load_cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), load_pred.size());
+  for (size_t i = 0; i < pred.size(); ++i) {
+    ASSERT_FLOAT_EQ(pred[i], load_pred[i]);
+  }
+
+  // the loaded model keeps boosting on the new samples
+  load_cost_model.Update(samples, labels);
+  ASSERT_EQ(load_cost_model.NumTrees(), cost_model.NumTrees() + 10);
+}
+
+TEST(GbdtCostModel, FineTuneLoaded) {
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(256, &samples, &labels);
+
+  GbdtCostModel::Config config;
+  config.num_rounds = 2;
+  config.max_trees  = 5;
+  GbdtCostModel cost_model(config);
+  cost_model.Train(samples, labels);
+  std::string path = "./test_gbdt_cost_model_fine_tune.bin";
+  cost_model.Save(path);
+
+  GbdtCostModel load_cost_model(config);
+  load_cost_model.Load(path);
+  std::remove(path.c_str());
+  load_cost_model.Update(samples, labels);
+  ASSERT_EQ(load_cost_model.NumTrees(), 4);
+  // only the trees boosted after loading are retrained once there would be too many trees
+  load_cost_model.Update(samples, labels);
+  ASSERT_EQ(load_cost_model.NumTrees(), 4);
+  float error = MeanSquaredError(cost_model.Predict(samples), labels);
+  ASSERT_LT(MeanSquaredError(load_cost_model.Predict(samples), labels), error);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
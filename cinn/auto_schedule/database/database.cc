@@ -18,10 +18,16 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 
+#include <algorithm>
+#include <cmath>
+
+#include "cinn/auto_schedule/database/indexed_file_database.h"
 #include "cinn/auto_schedule/database/jsonfile_database.h"
+#include "cinn/auto_schedule/database/remote_database.h"
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/schedule_desc.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -39,6 +45,55 @@ proto::TuningRecord TuningRecord::ToProto() const {
   return record_proto;
 }
 
+TaskSignature TaskSignature::FromTaskKey(const std::string& task_key) {
+  // a variable is printed as `id->dtype[d0,d1,...]` in the task_key, see TuneTask::SerializeToString
+  TaskSignature signature;
+  size_t pos = 0;
+  while (pos < task_key.size()) {
+    size_t arrow = task_key.find("->", pos);
+    size_t left  = arrow == std::string::npos ? std::string::npos : task_key.find('[', arrow);
+    size_t right = left == std::string::npos ? std::string::npos : task_key.find(']', left);
+    if (right == std::string::npos) {
+      break;
+    }
+    size_t begin = task_key.find_last_of("( ", arrow);
+    begin        = (begin == std::string::npos || begin < pos) ? pos : begin + 1;
+    signature.structure.append(task_key, pos, begin - pos);
+    signature.dtypes.emplace_back(task_key.substr(arrow + 2, left - arrow - 2));
+
+    std::vector<int> shape;
+    for (auto&& dim : utils::Split(task_key.substr(left + 1, right - left - 1), ",")) {
+      if (!dim.empty()) {
+        shape.push_back(std::stoi(dim));
+      }
+    }
+    signature.structure.append("<" + std::to_string(shape.size()) + ">");
+    signature.shapes.emplace_back(std::move(shape));
+    pos = right + 1;
+  }
+  if (pos < task_key.size()) {
+    signature.structure.append(task_key, pos, std::string::npos);
+  }
+  return signature;
+}
+
+double TaskSignature::Distance(const TaskSignature& other) const {
+  if (structure != other.structure) {
+    return -1.0;
+  }
+  double distance = 0.0;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    // a different dtype costs as much as doubling a dimension
+    if (dtypes[i] != other.dtypes[i]) {
+      distance += 1.0;
+    }
+    for (size_t j = 0; j < shapes[i].size(); ++j) {
+      distance += std::abs(std::log2(std::max(shapes[i][j], 1)) - std::log2(std::max(other.shapes[i][j], 1)));
+    }
+  }
+  return distance;
+}
+
 Database::Database(int capacity_per_task) : capacity_per_task_(capacity_per_task) {
   CHECK_GT(capacity_per_task_, 0) << "capacity_per_task_ should be greater than 0";
 }
@@ -48,6 +103,10 @@ std::unique_ptr<Database> Database::Make(const DatabaseConfig& config) {
     return std::make_unique<Database>(config.capacity_per_task);
   } else if (config.type == DatabaseType::kJSONFile) {
     return std::make_unique<JSONFileDatabase>(config.capacity_per_task, config.record_file_path, true);
+  } else if (config.type == DatabaseType::kIndexedFile) {
+    return std::make_unique<IndexedFileDatabase>(config.capacity_per_task, config.record_file_path, true);
+  } else if (config.type == DatabaseType::kRemote) {
+    return std::make_unique<RemoteDatabase>(config.capacity_per_task, config.server_address);
   }
 
   LOG(FATAL) << "Unimplemented database type.";
@@ -70,6 +129,7 @@ bool Database::AddRecord(const TuningRecord& record) {
 }
 
 std::vector<TuningRecord> Database::LookUp(const std::string& task_key) {
+  Fetch(task_key);
   auto fit = key2record_.find(task_key);
   if (fit == key2record_.end()) {
     return {};
@@ -82,6 +142,7 @@ std::vector<TuningRecord> Database::LookUp(const std::string& task_key) {
 }
 
 std::vector<TuningRecord> Database::GetTopK(const std::string& task_key, int k) {
+  Fetch(task_key);
   auto fit = key2record_.find(task_key);
   if (fit == key2record_.end() || k <= 0) {
     return {};
@@ -102,6 +163,43 @@ std::vector<TuningRecord> Database::GetTopK(const std::string& task_key, int k)
   return results;
 }
 
+std::vector<TuningRecord> Database::LookUpSimilar(const std::string& task_key, int k) {
+  TaskSignature signature = TaskSignature::FromTaskKey(task_key);
+  FetchSimilar(signature);
+
+  std::vector<std::pair<double, const TuningRecord*>> candidates;
+  auto add_candidate_fn = [&](const std::string& key, const TuningRecord& record) {
+    // the records without schedule steps, such as the measured manual schedule, can't be transferred
+    if (key == task_key || record.trace.steps().empty()) {
+      return;
+    }
+    double distance = signature.Distance(TaskSignature::FromTaskKey(key));
+    if (distance >= 0) {
+      candidates.emplace_back(distance, &record);
+    }
+  };
+  for (auto&& key2records : key2record_) {
+    if (!key2records.second.empty()) {
+      add_candidate_fn(key2records.first, *key2records.second.begin());
+    }
+  }
+  for (auto&& key2record : similar_records_) {
+    add_candidate_fn(key2record.first, key2record.second);
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second->execution_cost < rhs.second->execution_cost;
+  });
+
+  std::vector<TuningRecord> results;
+  for (auto&& candidate : candidates) {
+    if (results.size() >= k) {
+      break;
+    }
+    results.emplace_back(*candidate.second);
+  }
+  return results;
+}
+
 size_t Database::Size() {
   auto res =
       std::accumulate(key2record_.begin(), key2record_.end(), size_t(0), [](size_t res, const auto& kv) -> size_t {
@@ -111,6 +209,7 @@ size_t Database::Size() {
 }
 
 size_t Database::Count(const std::string& task_key) {
+  Fetch(task_key);
   auto fit = key2record_.find(task_key);
   if (fit == key2record_.end()) {
     return 0;
@@ -118,5 +217,39 @@ size_t Database::Count(const std::string& task_key) {
   return fit->second.size();
 }
 
+SamplingPrior Database::GetSamplingPrior(const std::string& task_key) {
+  auto fit = key2prior_.find(task_key);
+  if (fit == key2prior_.end()) {
+    return SamplingPrior();
+  }
+  return fit->second;
+}
+
+bool Database::UpdateSamplingPrior(const std::string& task_key, const SamplingPrior& rewards) {
+  CHECK(!task_key.empty()) << "task_key of SamplingPrior can't be empty";
+  auto& prior = key2prior_[task_key];
+  prior.Merge(rewards);
+  return CommitSamplingPrior(task_key, prior);
+}
+
+void Database::LoadSamplingPriors(const std::string& file_path) {
+  for (auto&& json_line : ReadLinesFromFile(file_path, true)) {
+    proto::SamplingPrior prior_proto;
+    auto status = google::protobuf::util::JsonStringToMessage(json_line, &prior_proto);
+    CHECK(status.ok()) << "Failed to parse JSON: " << json_line;
+    key2prior_[prior_proto.task_key()] = SamplingPrior::FromProto(prior_proto);
+  }
+  VLOG(3) << "Loaded the sampling priors of " << key2prior_.size() << " tasks from file: " << file_path;
+}
+
+void Database::SaveSamplingPrior(const std::string& file_path,
+                                 const std::string& task_key,
+                                 const SamplingPrior& prior) {
+  std::string json_string;
+  auto status = google::protobuf::util::MessageToJsonString(prior.ToProto(task_key), &json_string);
+  CHECK(status.ok()) << "Failed to serialize sampling prior to JSON, task key = " << task_key;
+  AppendLineToFile(file_path, json_string);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -16,6 +16,7 @@
 #include <unordered_map>
 
 #include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/ir/schedule_desc.pb.h"
 
@@ -55,12 +56,28 @@ struct TuningRecord {
   };
 };
 
-enum class DatabaseType : int { kMemory, kJSONFile };
+// The shape-independent part of a task_key, with the dtypes and shapes of its variables, used to match the tasks
+// that have the same op structure but different shapes/dtypes
+struct TaskSignature {
+  // the task_key with the variables replaced by their ranks
+  std::string structure;
+  std::vector<std::string> dtypes;
+  std::vector<std::vector<int>> shapes;
+
+  static TaskSignature FromTaskKey(const std::string& task_key);
+
+  // the difference of the shapes and dtypes between two tasks, it is negative if their structures are different
+  double Distance(const TaskSignature& other) const;
+};
+
+enum class DatabaseType : int { kMemory, kJSONFile, kIndexedFile, kRemote };
 
 struct DatabaseConfig {
   DatabaseType type            = DatabaseType::kMemory;
   int capacity_per_task        = 2;
   std::string record_file_path = "/tmp/tuning_record.json";
+  // the address ("host:port") of the DatabaseServer shared by the tuning jobs, used by kRemote
+  std::string server_address = "";
 };
 
 // A database supports insert or lookup historial tuning result with specified traits.
@@ -70,7 +87,7 @@ struct DatabaseConfig {
 class Database {
  public:
   explicit Database(int capacity_per_task);
-  ~Database() = default;
+  virtual ~Database() = default;
 
   // Create a Database with the specific config
   static std::unique_ptr<Database> Make(const DatabaseConfig& config);
@@ -81,19 +98,42 @@ class Database {
   std::vector<TuningRecord> LookUp(const std::string& task_key);
   // return the states of the top k in sorted candidates
   std::vector<TuningRecord> GetTopK(const std::string& task_key, int k);
+  // return the best records of the tasks having the same op structure with task_key but different shapes or dtypes,
+  // one for each task and at most k tasks, sorted from the nearest
+  std::vector<TuningRecord> LookUpSimilar(const std::string& task_key, int k);
   // return the total number of stored candidates
-  size_t Size();
+  virtual size_t Size();
   // return the number of stored candidates with specified key
   size_t Count(const std::string& task_key);
+  // return the rewards learned for the sketch rules and the blocks of a task, empty if no round of it is rewarded yet
+  SamplingPrior GetSamplingPrior(const std::string& task_key);
+  // merge the rewards of a measured round into the sampling prior of a task
+  bool UpdateSamplingPrior(const std::string& task_key, const SamplingPrior& rewards);
 
  protected:
   // commit the newly added record into underlying storage
   virtual bool Commit(const TuningRecord& record) { return true; }
+  // load the records of task_key from underlying storage into memory if they are not loaded yet,
+  // called before reading the records of a task
+  virtual void Fetch(const std::string& task_key) {}
+  // load the best record of the tasks matching the signature into memory if they are not loaded yet,
+  // called before searching the similar tasks
+  virtual void FetchSimilar(const TaskSignature& signature) {}
   // insert a newly added record into memory storage
   void Insert(const TuningRecord& record);
+  // commit the updated sampling prior of a task into underlying storage
+  virtual bool CommitSamplingPrior(const std::string& task_key, const SamplingPrior& prior) { return true; }
+  // load the sampling priors from a file of JSON lines, the last line of a task holds its latest prior
+  void LoadSamplingPriors(const std::string& file_path);
+  // append the sampling prior of a task to a file of JSON lines
+  void SaveSamplingPrior(const std::string& file_path, const std::string& task_key, const SamplingPrior& prior);
 
   // map task_key to its records
   std::unordered_map<std::string, std::multiset<TuningRecord, TuningRecord::Compare>> key2record_;
+  // the best record of the tasks not registered in InitialTaskRegistry, only used by LookUpSimilar
+  std::unordered_map<std::string, TuningRecord> similar_records_;
+  // map task_key to its sampling prior
+  std::unordered_map<std::string, SamplingPrior> key2prior_;
   // the max number of candidates stored
   const int capacity_per_task_;
 };
@@ -66,5 +66,52 @@ TEST_F(TestDatabase, GetTopK) {
   EXPECT_FLOAT_EQ(records[1].predicted_cost, 1.0);
 }
 
+TEST(TaskSignature, FromTaskKey) {
+  std::string task_key    = "Target<linux,x86,64>\n\nGroup {\n  (var_1->float32[32,64]) = relu(x->float32[32,64])\n}\n";
+  TaskSignature signature = TaskSignature::FromTaskKey(task_key);
+  EXPECT_EQ(signature.structure, "Target<linux,x86,64>\n\nGroup {\n  (<2>) = relu(<2>)\n}\n");
+  ASSERT_EQ(signature.shapes.size(), 2);
+  EXPECT_EQ(signature.shapes[1], std::vector<int>({32, 64}));
+  EXPECT_EQ(signature.dtypes[1], "float32");
+
+  // the names of variables are ignored, and the distance grows with the difference of shapes
+  auto other = TaskSignature::FromTaskKey(
+      "Target<linux,x86,64>\n\nGroup {\n  (var_9->float32[64,64]) = relu(y->float32[64,64])\n}\n");
+  EXPECT_DOUBLE_EQ(signature.Distance(other), 2.0);
+  EXPECT_DOUBLE_EQ(signature.Distance(signature), 0.0);
+  auto different =
+      TaskSignature::FromTaskKey("Target<linux,x86,64>\n\nGroup {\n  (var_1->float32[32]) = relu(x->float32[32])\n}\n");
+  EXPECT_LT(signature.Distance(different), 0.0);
+}
+
+TEST(Database, LookUpSimilar) {
+  auto make_key = [](int batch) {
+    return "Group {\n  (out->float32[" + std::to_string(batch) + ",64]) = relu(x->float32[" + std::to_string(batch) +
+           ",64])\n}\n";
+  };
+  ir::proto::ScheduleDesc trace;
+  trace.add_steps()->set_type("TagPostSchedule");
+  TuningRecord record;
+  record.trace = trace;
+
+  Database db(2);
+  for (int batch : {8, 32, 128}) {
+    record.task_key       = make_key(batch);
+    record.execution_cost = batch;
+    db.AddRecord(record);
+  }
+  // a task with variables in different ranks is not similar
+  record.task_key       = "Group {\n  (out->float32[32]) = relu(x->float32[32])\n}\n";
+  record.execution_cost = 1.0;
+  db.AddRecord(record);
+
+  // the exact task itself is excluded and the nearest comes first
+  auto records = db.LookUpSimilar(make_key(64), 2);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].task_key, make_key(32));
+  EXPECT_EQ(records[1].task_key, make_key(128));
+  ASSERT_EQ(db.LookUpSimilar(make_key(8), 3).size(), 2);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
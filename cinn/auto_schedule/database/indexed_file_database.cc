@@ -0,0 +1,387 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/indexed_file_database.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/task/task_registry.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// the files start with a magic number and the id of the log, the integers are stored in host byte order
+constexpr uint64_t kLogMagic    = 0x314c52544e4e4943;  // "CINNTRL1"
+constexpr uint64_t kIndexMagic  = 0x314952544e4e4943;  // "CINNTRI1"
+constexpr uint64_t kHeaderBytes = 2 * sizeof(uint64_t);
+// the log is compacted at construction once it holds more records than this and twice the kept ones
+constexpr size_t kMinRecordsToCompact = 1024;
+
+bool FileExists(const std::string& path) {
+  struct stat st;
+  return ::stat(path.c_str(), &st) == 0;
+}
+
+uint64_t FileSize(const std::string& path) {
+  struct stat st;
+  return ::stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream is(path, std::ios::in | std::ios::binary);
+  CHECK(is.good()) << "Cannot open the file to read: " << path;
+  return std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+}
+
+// A log gets a new id whenever it is created or compacted, an index with another id is rebuilt.
+uint64_t NewLogId() {
+  std::random_device device;
+  return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+void CreateFile(const std::string& path, uint64_t magic, uint64_t log_id) {
+  std::ofstream os(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK(os.good()) << "Cannot create new file: " << path;
+  os.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  os.write(reinterpret_cast<const char*>(&log_id), sizeof(log_id));
+}
+
+// Read the id in the header of the file, and check its magic number.
+uint64_t ReadLogId(const std::string& path, uint64_t magic) {
+  std::ifstream is(path, std::ios::in | std::ios::binary);
+  uint64_t header[2] = {0, 0};
+  is.read(reinterpret_cast<char*>(header), sizeof(header));
+  CHECK(is.good() && header[0] == magic) << path << " is not a file of IndexedFileDatabase";
+  return header[1];
+}
+
+void TruncateFile(const std::string& path, uint64_t size) {
+  LOG(WARNING) << "Drop the broken tail of " << path << " after " << size << " bytes";
+  CHECK_EQ(::truncate(path.c_str(), size), 0) << "Failed to truncate " << path;
+}
+
+template <typename T>
+bool ReadPod(const std::string& data, size_t* pos, T* value) {
+  if (*pos + sizeof(T) > data.size()) return false;
+  std::memcpy(value, data.data() + *pos, sizeof(T));
+  *pos += sizeof(T);
+  return true;
+}
+
+template <typename T>
+void WritePod(std::ofstream* os, const T& value) {
+  os->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+IndexedFileDatabase::IndexedFileDatabase(int capacity_per_task,
+                                         const std::string& record_file_path,
+                                         bool allow_new_file)
+    : Database(capacity_per_task),
+      record_file_path_(record_file_path),
+      index_file_path_(record_file_path + ".idx"),
+      prior_file_path_(record_file_path + ".prior") {
+  VLOG(3) << "Auto schedule will save/load tuning records on file:" << record_file_path_;
+  if (!FileExists(record_file_path_)) {
+    CHECK(allow_new_file) << "File doesn't exist: " << record_file_path_;
+    uint64_t log_id = NewLogId();
+    CreateFile(record_file_path_, kLogMagic, log_id);
+    CreateFile(index_file_path_, kIndexMagic, log_id);
+  }
+  uint64_t log_id = ReadLogId(record_file_path_, kLogMagic);
+  // the index is missing, or left by an interrupted compaction
+  if (!FileExists(index_file_path_) || ReadLogId(index_file_path_, kIndexMagic) != log_id) {
+    LOG(WARNING) << "Rebuild the index of " << record_file_path_;
+    CreateFile(index_file_path_, kIndexMagic, log_id);
+  }
+
+  uint64_t indexed_end = LoadIndex();
+  RecoverIndex(indexed_end);
+  MapLog();
+  OpenForAppend();
+
+  size_t num_kept = 0;
+  for (auto& item : index_) {
+    num_kept += item.second.size();
+  }
+  VLOG(3) << "The tuning record log holds " << num_logged_records_ << " records, " << num_kept << " of them are kept";
+  if (num_logged_records_ > kMinRecordsToCompact && num_logged_records_ > 2 * num_kept) {
+    Compact();
+  }
+  LoadSamplingPriors(prior_file_path_);
+}
+
+IndexedFileDatabase::~IndexedFileDatabase() { UnmapLog(); }
+
+uint64_t IndexedFileDatabase::LoadIndex() {
+  std::string data     = ReadFile(index_file_path_);
+  size_t pos           = kHeaderBytes;
+  uint64_t indexed_end = kHeaderBytes;
+  size_t valid_end     = pos;
+  while (pos < data.size()) {
+    uint32_t key_len = 0;
+    IndexEntry entry;
+    if (!ReadPod(data, &pos, &key_len) || pos + key_len > data.size()) break;
+    std::string task_key = data.substr(pos, key_len);
+    pos += key_len;
+    if (!ReadPod(data, &pos, &entry.offset) || !ReadPod(data, &pos, &entry.length) ||
+        !ReadPod(data, &pos, &entry.execution_cost)) {
+      break;
+    }
+    valid_end   = pos;
+    indexed_end = std::max(indexed_end, entry.offset + entry.length);
+    AddEntry(task_key, entry);
+    ++num_logged_records_;
+  }
+  if (valid_end < data.size()) {
+    TruncateFile(index_file_path_, valid_end);
+  }
+  return indexed_end;
+}
+
+void IndexedFileDatabase::RecoverIndex(uint64_t indexed_end) {
+  uint64_t log_file_size = FileSize(record_file_path_);
+  CHECK_LE(indexed_end, log_file_size) << "The index " << index_file_path_ << " doesn't match the log";
+  if (indexed_end == log_file_size) {
+    return;
+  }
+  std::string data = ReadFile(record_file_path_);
+  size_t pos       = indexed_end;
+
+  std::ofstream index_os(index_file_path_, std::ios::out | std::ios::binary | std::ios::app);
+  CHECK(index_os.good()) << "Cannot open the file to write: " << index_file_path_;
+  size_t num_recovered = 0;
+  size_t valid_end     = pos;
+  while (pos < data.size()) {
+    uint32_t length = 0;
+    if (!ReadPod(data, &pos, &length) || pos + length > data.size()) break;
+    proto::TuningRecord record_proto;
+    if (!record_proto.ParseFromArray(data.data() + pos, length)) break;
+    IndexEntry entry{pos, length, record_proto.execution_cost()};
+    pos += length;
+    valid_end = pos;
+
+    WritePod(&index_os, static_cast<uint32_t>(record_proto.task_key().size()));
+    index_os.write(record_proto.task_key().data(), record_proto.task_key().size());
+    WritePod(&index_os, entry.offset);
+    WritePod(&index_os, entry.length);
+    WritePod(&index_os, entry.execution_cost);
+    AddEntry(record_proto.task_key(), entry);
+    ++num_logged_records_;
+    ++num_recovered;
+  }
+  index_os.close();
+  if (valid_end < data.size()) {
+    TruncateFile(record_file_path_, valid_end);
+  }
+  LOG(INFO) << "Recover the index of " << num_recovered << " records from " << record_file_path_;
+}
+
+void IndexedFileDatabase::AddEntry(const std::string& task_key, const IndexEntry& entry) {
+  auto& entries = index_[task_key];
+  auto it       = std::upper_bound(entries.begin(), entries.end(), entry, [](const IndexEntry& a, const IndexEntry& b) {
+    return a.execution_cost < b.execution_cost;
+  });
+  if (it - entries.begin() >= capacity_per_task_) {
+    return;
+  }
+  entries.insert(it, entry);
+  if (entries.size() > capacity_per_task_) {
+    entries.pop_back();
+  }
+}
+
+void IndexedFileDatabase::MapLog() {
+  log_size_ = FileSize(record_file_path_);
+  log_end_  = log_size_;
+  int fd    = ::open(record_file_path_.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Cannot open the file to read: " << record_file_path_;
+  void* data = ::mmap(nullptr, log_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping is kept after the file is closed
+  ::close(fd);
+  CHECK(data != MAP_FAILED) << "Failed to map " << record_file_path_ << " into memory";
+  log_data_ = static_cast<const char*>(data);
+}
+
+void IndexedFileDatabase::UnmapLog() {
+  if (log_data_) {
+    ::munmap(const_cast<char*>(log_data_), log_size_);
+    log_data_ = nullptr;
+  }
+}
+
+void IndexedFileDatabase::OpenForAppend() {
+  log_os_.open(record_file_path_, std::ios::out | std::ios::binary | std::ios::app);
+  CHECK(log_os_.good()) << "Cannot open the file to write: " << record_file_path_;
+  index_os_.open(index_file_path_, std::ios::out | std::ios::binary | std::ios::app);
+  CHECK(index_os_.good()) << "Cannot open the file to write: " << index_file_path_;
+}
+
+void IndexedFileDatabase::Fetch(const std::string& task_key) {
+  if (fetched_keys_.count(task_key)) {
+    return;
+  }
+  // the records of the tasks not registered are skipped as they are expired, they are kept in the index
+  // in case the task is registered later
+  if (!InitialTaskRegistry::Global()->Has(task_key)) {
+    return;
+  }
+  fetched_keys_.insert(task_key);
+  auto it = index_.find(task_key);
+  if (it == index_.end()) {
+    return;
+  }
+  for (const IndexEntry& entry : it->second) {
+    proto::TuningRecord record_proto;
+    CHECK(record_proto.ParseFromArray(log_data_ + entry.offset, entry.length))
+        << "Failed to parse the record at " << entry.offset << " of " << record_file_path_;
+    VLOG(4) << "Add a measured TuningRecord with task_key=" << task_key;
+    Insert(TuningRecord(record_proto));
+  }
+  index_.erase(it);
+}
+
+void IndexedFileDatabase::FetchSimilar(const TaskSignature& signature) {
+  std::vector<std::string> registered_keys;
+  for (auto&& key2entries : index_) {
+    const std::string& task_key = key2entries.first;
+    if (key2entries.second.empty() || similar_records_.count(task_key) ||
+        TaskSignature::FromTaskKey(task_key).structure != signature.structure) {
+      continue;
+    }
+    if (InitialTaskRegistry::Global()->Has(task_key)) {
+      registered_keys.push_back(task_key);
+      continue;
+    }
+    // only the best record of a task not registered is parsed, the entries are sorted by the cost
+    const IndexEntry& entry = key2entries.second.front();
+    proto::TuningRecord record_proto;
+    CHECK(record_proto.ParseFromArray(log_data_ + entry.offset, entry.length))
+        << "Failed to parse the record at " << entry.offset << " of " << record_file_path_;
+    similar_records_.emplace(task_key, TuningRecord(record_proto));
+  }
+  for (auto&& task_key : registered_keys) {
+    Fetch(task_key);
+  }
+}
+
+bool IndexedFileDatabase::Commit(const TuningRecord& record) {
+  std::string data = record.ToProto().SerializeAsString();
+  IndexEntry entry{log_end_ + sizeof(uint32_t), static_cast<uint32_t>(data.size()), record.execution_cost};
+  WritePod(&log_os_, entry.length);
+  log_os_.write(data.data(), data.size());
+  log_os_.flush();
+  // the index is written after the record, so an entry always refers to a complete record
+  WritePod(&index_os_, static_cast<uint32_t>(record.task_key.size()));
+  index_os_.write(record.task_key.data(), record.task_key.size());
+  WritePod(&index_os_, entry.offset);
+  WritePod(&index_os_, entry.length);
+  WritePod(&index_os_, entry.execution_cost);
+  index_os_.flush();
+  log_end_ = entry.offset + entry.length;
+  ++num_logged_records_;
+
+  // merge the records logged before, the new record is already in memory
+  Fetch(record.task_key);
+  return log_os_.good() && index_os_.good();
+}
+
+bool IndexedFileDatabase::CommitSamplingPrior(const std::string& task_key, const SamplingPrior& prior) {
+  SaveSamplingPrior(prior_file_path_, task_key, prior);
+  return true;
+}
+
+size_t IndexedFileDatabase::Size() {
+  size_t res = Database::Size();
+  for (auto& item : index_) {
+    if (InitialTaskRegistry::Global()->Has(item.first)) {
+      res += item.second.size();
+    }
+  }
+  return res;
+}
+
+void IndexedFileDatabase::Compact() {
+  std::string tmp_log_path   = record_file_path_ + ".compact";
+  std::string tmp_index_path = index_file_path_ + ".compact";
+  uint64_t log_id            = NewLogId();
+  CreateFile(tmp_log_path, kLogMagic, log_id);
+  CreateFile(tmp_index_path, kIndexMagic, log_id);
+  std::ofstream log_os(tmp_log_path, std::ios::out | std::ios::binary | std::ios::app);
+  std::ofstream index_os(tmp_index_path, std::ios::out | std::ios::binary | std::ios::app);
+  CHECK(log_os.good() && index_os.good()) << "Cannot open the files to compact " << record_file_path_;
+
+  uint64_t end = kHeaderBytes;
+  std::unordered_map<std::string, std::vector<IndexEntry>> new_index;
+  auto write_record = [&](const std::string& task_key, const char* data, uint32_t length, double cost) {
+    IndexEntry entry{end + sizeof(uint32_t), length, cost};
+    WritePod(&log_os, length);
+    log_os.write(data, length);
+    WritePod(&index_os, static_cast<uint32_t>(task_key.size()));
+    index_os.write(task_key.data(), task_key.size());
+    WritePod(&index_os, entry.offset);
+    WritePod(&index_os, entry.length);
+    WritePod(&index_os, entry.execution_cost);
+    end = entry.offset + entry.length;
+    return entry;
+  };
+  size_t num_records = 0;
+  // the fetched tasks are held in memory
+  for (auto& item : key2record_) {
+    for (const TuningRecord& record : item.second) {
+      std::string data = record.ToProto().SerializeAsString();
+      write_record(record.task_key, data.data(), data.size(), record.execution_cost);
+      ++num_records;
+    }
+  }
+  // the others are copied from the log without parsing
+  for (auto& item : index_) {
+    auto& entries = new_index[item.first];
+    for (const IndexEntry& entry : item.second) {
+      entries.push_back(write_record(item.first, log_data_ + entry.offset, entry.length, entry.execution_cost));
+      ++num_records;
+    }
+  }
+  log_os.close();
+  index_os.close();
+  CHECK(log_os.good() && index_os.good()) << "Failed to write the files to compact " << record_file_path_;
+
+  log_os_.close();
+  index_os_.close();
+  UnmapLog();
+  // if interrupted between, the id of the old index doesn't match the new log, so it is rebuilt
+  CHECK_EQ(std::rename(tmp_log_path.c_str(), record_file_path_.c_str()), 0) << "Failed to replace the log";
+  CHECK_EQ(std::rename(tmp_index_path.c_str(), index_file_path_.c_str()), 0) << "Failed to replace the index";
+  LOG(INFO) << "Compact " << record_file_path_ << " from " << num_logged_records_ << " to " << num_records
+            << " records";
+  index_.swap(new_index);
+  num_logged_records_ = num_records;
+  MapLog();
+  OpenForAppend();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
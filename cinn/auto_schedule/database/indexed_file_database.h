@@ -0,0 +1,108 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/auto_schedule/database/database.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * IndexedFileDatabase saves the records in a binary log file, and the task_key, position and cost of every record in
+ * an index file next to it (record_file_path + ".idx"). Only the index is read at construction, keeping the best
+ * capacity_per_task entries of each task. The log is memory-mapped and the records of a task are parsed on the
+ * first LookUp/GetTopK/Count of the task.
+ *
+ * The log is append-only, Compact rewrites it with only the records kept. It is called at construction once most of
+ * the log is useless. A record or an index entry cut off by a crash is dropped, and the index entries missing for
+ * the tail of the log are rebuilt from it.
+ */
+class IndexedFileDatabase : public Database {
+ public:
+  /*!
+   * \brief Open or create an IndexedFileDatabase.
+   * \param capacity_per_task The max number of candidates stored.
+   * \param record_file_path The path of the log file, the index is at record_file_path + ".idx" and the sampling
+   * priors are at record_file_path + ".prior".
+   * \param allow_new_file Whether to create new files when the given path is not found.
+   */
+  IndexedFileDatabase(int capacity_per_task, const std::string& record_file_path, bool allow_new_file);
+  ~IndexedFileDatabase();
+
+  size_t Size() override;
+
+  // Rewrite the log and the index with the kept records only.
+  void Compact();
+
+  // The number of records in the log file, including the ones not kept.
+  size_t NumLoggedRecords() const { return num_logged_records_; }
+
+ protected:
+  // append the newly added record to the log and the index
+  bool Commit(const TuningRecord& record) override;
+
+  // append the updated sampling prior to the prior file
+  bool CommitSamplingPrior(const std::string& task_key, const SamplingPrior& prior) override;
+
+  // parse the indexed records of task_key from the log
+  void Fetch(const std::string& task_key) override;
+
+  // parse the best record of the tasks not registered that match the signature
+  void FetchSimilar(const TaskSignature& signature) override;
+
+ private:
+  struct IndexEntry {
+    // the position of the serialized proto::TuningRecord in the log
+    uint64_t offset;
+    uint32_t length;
+    double execution_cost;
+  };
+
+  // Read the index and return the end of the log covered by it
+  uint64_t LoadIndex();
+  // Index the records in the log after \p indexed_end
+  void RecoverIndex(uint64_t indexed_end);
+  // Keep the entry if it is among the best capacity_per_task ones of the task
+  void AddEntry(const std::string& task_key, const IndexEntry& entry);
+  void MapLog();
+  void UnmapLog();
+  void OpenForAppend();
+
+  std::string record_file_path_;
+  std::string index_file_path_;
+  std::string prior_file_path_;
+
+  // the best indexed entries of the tasks not fetched yet, sorted by the cost
+  std::unordered_map<std::string, std::vector<IndexEntry>> index_;
+  std::unordered_set<std::string> fetched_keys_;
+  size_t num_logged_records_{0};
+
+  // the log mapped into memory and its size
+  const char* log_data_{nullptr};
+  uint64_t log_size_{0};
+  // the end of the log, including the records appended after mapped
+  uint64_t log_end_{0};
+  std::ofstream log_os_;
+  std::ofstream index_os_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
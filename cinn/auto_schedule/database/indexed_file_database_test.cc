@@ -0,0 +1,132 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/indexed_file_database.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "cinn/auto_schedule/task/task_registry.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+class TestIndexedFileDatabase : public ::testing::Test {
+ public:
+  void SetUp() override {
+    for (const std::string& key : {"k1", "k2"}) {
+      InitialTaskRegistry::Global()->Regist(key, ir::ModuleExpr(std::vector<ir::Expr>{}));
+    }
+    RemoveFiles();
+  }
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    std::remove(record_file_path.c_str());
+    std::remove((record_file_path + ".idx").c_str());
+  }
+
+  static TuningRecord MakeRecord(const std::string& task_key, double execution_cost) {
+    proto::TuningRecord record_proto;
+    record_proto.set_task_key(task_key);
+    record_proto.set_execution_cost(execution_cost);
+    record_proto.set_predicted_cost(execution_cost * 2);
+    return TuningRecord(record_proto);
+  }
+
+  std::string record_file_path = "/tmp/test_indexed_record.log";
+};
+
+TEST_F(TestIndexedFileDatabase, SaveAndLoad) {
+  {
+    IndexedFileDatabase test_db(2, record_file_path, true);
+    test_db.AddRecord(MakeRecord("k1", 3.0));
+    test_db.AddRecord(MakeRecord("k1", 1.0));
+    test_db.AddRecord(MakeRecord("k1", 2.0));
+    test_db.AddRecord(MakeRecord("k2", 4.0));
+    ASSERT_EQ(test_db.Size(), 3);
+  }
+
+  IndexedFileDatabase loaded_db(2, record_file_path, false);
+  ASSERT_EQ(loaded_db.NumLoggedRecords(), 4);
+  ASSERT_EQ(loaded_db.Size(), 3);
+  std::vector<TuningRecord> records = loaded_db.GetTopK("k1", 2);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  EXPECT_EQ(records[1].execution_cost, 2.0);
+  EXPECT_FLOAT_EQ(records[1].predicted_cost, 4.0);
+  ASSERT_EQ(loaded_db.Count("k2"), 1);
+  ASSERT_EQ(loaded_db.Count("k3"), 0);
+
+  // a new record merges with the logged ones
+  loaded_db.AddRecord(MakeRecord("k2", 0.5));
+  records = loaded_db.LookUp("k2");
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].execution_cost, 0.5);
+}
+
+TEST_F(TestIndexedFileDatabase, Recover) {
+  {
+    IndexedFileDatabase test_db(2, record_file_path, true);
+    test_db.AddRecord(MakeRecord("k1", 1.0));
+    test_db.AddRecord(MakeRecord("k2", 2.0));
+  }
+  // a record cut off by a crash is dropped
+  {
+    std::ofstream os(record_file_path, std::ios::out | std::ios::binary | std::ios::app);
+    uint32_t length = 100;
+    os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    os.write("broken", 6);
+  }
+  // the index is rebuilt from the log
+  std::remove((record_file_path + ".idx").c_str());
+
+  IndexedFileDatabase loaded_db(2, record_file_path, false);
+  ASSERT_EQ(loaded_db.NumLoggedRecords(), 2);
+  ASSERT_EQ(loaded_db.Count("k1"), 1);
+  ASSERT_EQ(loaded_db.Count("k2"), 1);
+  loaded_db.AddRecord(MakeRecord("k1", 0.5));
+  ASSERT_EQ(loaded_db.Count("k1"), 2);
+}
+
+TEST_F(TestIndexedFileDatabase, Compact) {
+  {
+    IndexedFileDatabase test_db(2, record_file_path, true);
+    for (int i = 0; i < 10; ++i) {
+      test_db.AddRecord(MakeRecord("k1", 10.0 - i));
+      test_db.AddRecord(MakeRecord("k2", 10.0 + i));
+    }
+  }
+  IndexedFileDatabase loaded_db(2, record_file_path, false);
+  ASSERT_EQ(loaded_db.NumLoggedRecords(), 20);
+  // the fetched task is written from memory, the other one is copied from the log
+  ASSERT_EQ(loaded_db.Count("k1"), 2);
+  loaded_db.Compact();
+  ASSERT_EQ(loaded_db.NumLoggedRecords(), 4);
+
+  IndexedFileDatabase compacted_db(2, record_file_path, false);
+  ASSERT_EQ(compacted_db.NumLoggedRecords(), 4);
+  std::vector<TuningRecord> records = compacted_db.GetTopK("k1", 2);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  records = compacted_db.GetTopK("k2", 2);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[1].execution_cost, 11.0);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -52,7 +52,7 @@ std::vector<std::string> ReadLinesFromFile(const std::string& file_path, bool al
 }
 
 JSONFileDatabase::JSONFileDatabase(int capacity_per_task, const std::string& record_file_path, bool allow_new_file)
-    : Database(capacity_per_task), record_file_path_(record_file_path) {
+    : Database(capacity_per_task), record_file_path_(record_file_path), prior_file_path_(record_file_path + ".prior") {
   VLOG(3) << "Auto schedule will save/load tuning records on file:" << record_file_path;
   auto json_lines = ReadLinesFromFile(record_file_path_, allow_new_file);
   std::vector<cinn::auto_schedule::proto::TuningRecord> all_records_proto(json_lines.size());
@@ -73,8 +73,15 @@ JSONFileDatabase::JSONFileDatabase(int capacity_per_task, const std::string& rec
     if (task_registry->Has(task_key)) {
       VLOG(4) << "Add a measured TuningRecord with task_key=" << task_key;
       Insert(TuningRecord(record_proto));
+    } else {
+      // keep the best record of the tasks not registered as the source to transfer to similar tasks
+      auto it = similar_records_.find(task_key);
+      if (it == similar_records_.end() || record_proto.execution_cost() < it->second.execution_cost) {
+        similar_records_[task_key] = TuningRecord(record_proto);
+      }
     }
   }
+  LoadSamplingPriors(prior_file_path_);
 }
 
 // convert a TuningRecord object to string in JSON format
@@ -95,5 +102,10 @@ bool JSONFileDatabase::Commit(const TuningRecord& record) {
   return true;
 }
 
+bool JSONFileDatabase::CommitSamplingPrior(const std::string& task_key, const SamplingPrior& prior) {
+  SaveSamplingPrior(prior_file_path_, task_key, prior);
+  return true;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
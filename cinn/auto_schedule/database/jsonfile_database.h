@@ -25,7 +25,7 @@ class JSONFileDatabase : public Database {
   /*!
    * \brief Build a JSONFileDatabase object from a json file.
    * \param capacity_per_task The max number of candidates stored.
-   * \param record_file_path The path of the json file.
+   * \param record_file_path The path of the json file, the sampling priors are at record_file_path + ".prior".
    * \param allow_new_file Whether to create new file when the given path is not found.
    */
   JSONFileDatabase(int capacity_per_task, const std::string& record_file_path, bool allow_new_file);
@@ -38,8 +38,13 @@ class JSONFileDatabase : public Database {
   // commit the newly added record into json file
   bool Commit(const TuningRecord& record) override;
 
+  // append the updated sampling prior into the prior file
+  bool CommitSamplingPrior(const std::string& task_key, const SamplingPrior& prior) override;
+
   // the name of the json file to save tuning records.
   std::string record_file_path_;
+  // the name of the json file to save sampling priors.
+  std::string prior_file_path_;
 };
 
 // append a line to file
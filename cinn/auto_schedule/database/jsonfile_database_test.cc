@@ -81,6 +81,7 @@ class TestJSONFileDatabase : public ::testing::Test {
     } else {
       LOG(INFO) << "file: " << record_file_path << "does not exist.";
     }
+    remove((record_file_path + ".prior").c_str());
   }
 
   std::string record_file_path;
@@ -210,5 +211,22 @@ TEST_F(TestJSONFileDatabase, Reload) {
   }
 }
 
+TEST_F(TestJSONFileDatabase, ReloadSamplingPrior) {
+  SamplingPrior rewards;
+  rewards.Update(SamplingPrior::RuleArm("AutoUnroll"), 1.0);
+  rewards.Update(SamplingPrior::BlockArm("B"), 0.5);
+  test_db.UpdateSamplingPrior("k1", rewards);
+  test_db.UpdateSamplingPrior("k1", rewards);
+  ASSERT_TRUE(test_db.GetSamplingPrior("k2").empty());
+
+  JSONFileDatabase new_db(2, record_file_path, false);
+  auto arms = new_db.GetSamplingPrior("k1").arms();
+  ASSERT_EQ(arms.size(), 2);
+  EXPECT_EQ(arms.at("rule:AutoUnroll").num_samples, 2);
+  EXPECT_DOUBLE_EQ(arms.at("rule:AutoUnroll").total_reward, 2.0);
+  EXPECT_EQ(arms.at("block:B").num_samples, 2);
+  EXPECT_DOUBLE_EQ(arms.at("block:B").total_reward, 1.0);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -0,0 +1,165 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/remote_database.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <string>
+
+namespace cinn {
+namespace auto_schedule {
+
+DatabaseServer::DatabaseServer(Database* database, int port)
+    : database_(database), server_(port, [this](const std::string& data) {
+        proto::DatabaseRequest request;
+        proto::DatabaseResponse response;
+        if (request.ParseFromString(data)) {
+          response = Handle(request);
+        } else {
+          response.set_error_msg("Failed to parse the request of the database");
+        }
+        return response.SerializeAsString();
+      }) {
+  CHECK(database_ != nullptr) << "The database to serve can't be null";
+}
+
+proto::DatabaseResponse DatabaseServer::Handle(const proto::DatabaseRequest& request) {
+  proto::DatabaseResponse response;
+  std::lock_guard<std::mutex> lock(mtx_);
+  switch (request.kind()) {
+    case proto::DatabaseRequest::PUT:
+      for (const auto& record : request.records()) {
+        if (record.task_key().empty()) {
+          response.set_error_msg("task_key of TuningRecord can't be empty");
+          return response;
+        }
+        database_->AddRecord(TuningRecord(record));
+      }
+      VLOG(4) << "Put " << request.records_size() << " records into the database";
+      break;
+    case proto::DatabaseRequest::TOP_K: {
+      // LookUp returns the stored records in order, so k larger than the capacity is not warned by GetTopK
+      auto records = database_->LookUp(request.task_key());
+      int k        = std::min<int>(request.k(), records.size());
+      for (int i = 0; i < k; ++i) {
+        *response.add_records() = records[i].ToProto();
+      }
+      break;
+    }
+    default:
+      response.set_error_msg("Unknown kind of the request: " + std::to_string(request.kind()));
+      return response;
+  }
+  response.set_ok(true);
+  return response;
+}
+
+RemoteDatabase::RemoteDatabase(int capacity_per_task,
+                               const std::string& server_address,
+                               int batch_size,
+                               int cache_ttl_ms,
+                               int timeout_ms)
+    : Database(capacity_per_task),
+      server_address_(server_address),
+      batch_size_(batch_size),
+      cache_ttl_(cache_ttl_ms),
+      timeout_ms_(timeout_ms) {
+  CHECK(!server_address_.empty()) << "The address of the database server can't be empty";
+  CHECK_GT(batch_size_, 0) << "batch_size should be greater than 0";
+}
+
+RemoteDatabase::~RemoteDatabase() {
+  if (!Flush()) {
+    LOG(WARNING) << pending_records_.size() << " records are lost since the database server is unreachable";
+  }
+}
+
+bool RemoteDatabase::Call(const proto::DatabaseRequest& request,
+                          proto::DatabaseResponse* response,
+                          std::string* error_msg) {
+  std::string data;
+  if (!RpcCall(server_address_, request.SerializeAsString(), timeout_ms_, &data, error_msg)) {
+    return false;
+  }
+  if (!response->ParseFromString(data)) {
+    *error_msg = "Failed to parse the response of the database server";
+    return false;
+  }
+  if (!response->ok()) {
+    *error_msg = response->error_msg();
+    return false;
+  }
+  return true;
+}
+
+bool RemoteDatabase::Flush() {
+  if (pending_records_.empty()) {
+    return true;
+  }
+  proto::DatabaseRequest request;
+  request.set_kind(proto::DatabaseRequest::PUT);
+  for (auto& record : pending_records_) {
+    *request.add_records() = record;
+  }
+  proto::DatabaseResponse response;
+  std::string error_msg;
+  if (!Call(request, &response, &error_msg)) {
+    LOG(WARNING) << "Failed to send " << pending_records_.size() << " records to the database server "
+                 << server_address_ << ": " << error_msg;
+    return false;
+  }
+  pending_records_.clear();
+  return true;
+}
+
+bool RemoteDatabase::Commit(const TuningRecord& record) {
+  pending_records_.emplace_back(record.ToProto());
+  if (pending_records_.size() >= batch_size_) {
+    return Flush();
+  }
+  return true;
+}
+
+void RemoteDatabase::Fetch(const std::string& task_key) {
+  auto now = std::chrono::steady_clock::now();
+  auto it  = fetch_time_.find(task_key);
+  if (it != fetch_time_.end() && now - it->second < cache_ttl_) {
+    return;
+  }
+  // the cached records are kept if the pending ones can't be sent, otherwise they would be lost from the answer
+  if (!Flush()) {
+    return;
+  }
+  proto::DatabaseRequest request;
+  request.set_kind(proto::DatabaseRequest::TOP_K);
+  request.set_task_key(task_key);
+  request.set_k(capacity_per_task_);
+  proto::DatabaseResponse response;
+  std::string error_msg;
+  if (!Call(request, &response, &error_msg)) {
+    LOG(WARNING) << "Failed to fetch the records from the database server " << server_address_ << ": " << error_msg;
+    return;
+  }
+  key2record_.erase(task_key);
+  for (const auto& record : response.records()) {
+    Insert(TuningRecord(record));
+  }
+  fetch_time_[task_key] = now;
+  VLOG(4) << "Fetch " << response.records_size() << " records of the task from the database server";
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/database/database.h"
+#include "cinn/auto_schedule/measure/rpc_channel.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * DatabaseServer shares a database among the tuning jobs on different machines, usually an IndexedFileDatabase
+ * holding the records of the whole fleet. The jobs access it by RemoteDatabase.
+ */
+class DatabaseServer {
+ public:
+  //! @param database The database to serve, it is not owned and must outlive the server.
+  //! @param port The port to listen on, 0 means any free port.
+  explicit DatabaseServer(Database* database, int port = 0);
+
+  void Start() { server_.Start(); }
+  void Stop() { server_.Stop(); }
+  int Port() const { return server_.Port(); }
+
+  proto::DatabaseResponse Handle(const proto::DatabaseRequest& request);
+
+ private:
+  Database* database_;
+  RpcServer server_;
+  // the connections are served in parallel, but the database is not thread-safe
+  std::mutex mtx_;
+};
+
+/**
+ * RemoteDatabase is the client of a DatabaseServer, so the tuning jobs see the best records measured by each other.
+ *
+ * The added records are sent in batches of batch_size, and the top-K query is answered by the server. The best
+ * records of a task are cached locally and fetched again once they are older than cache_ttl_ms, the pending records
+ * are sent before that so the server's answer covers them. An unreachable server doesn't stop the tuning: the
+ * records are kept to send later and the cached ones are used meanwhile. The sampling priors are not shared.
+ */
+class RemoteDatabase : public Database {
+ public:
+  RemoteDatabase(int capacity_per_task,
+                 const std::string& server_address,
+                 int batch_size   = 16,
+                 int cache_ttl_ms = 60000,
+                 int timeout_ms   = 10000);
+  ~RemoteDatabase();
+
+  // Send the pending records to the server, return false if failed and they are kept to send later
+  bool Flush();
+
+ protected:
+  // add the record to the pending batch, and send the batch once it is full
+  bool Commit(const TuningRecord& record) override;
+
+  // replace the cached records of task_key by the best ones on the server if they are expired
+  void Fetch(const std::string& task_key) override;
+
+ private:
+  bool Call(const proto::DatabaseRequest& request, proto::DatabaseResponse* response, std::string* error_msg);
+
+  const std::string server_address_;
+  const int batch_size_;
+  const std::chrono::milliseconds cache_ttl_;
+  const int timeout_ms_;
+
+  std::vector<proto::TuningRecord> pending_records_;
+  // the time when the records of a task are fetched from the server
+  std::unordered_map<std::string, std::chrono::steady_clock::time_point> fetch_time_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/remote_database.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/search_state.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+static std::string LocalAddress(int port) { return "127.0.0.1:" + std::to_string(port); }
+
+TEST(RemoteDatabase, ShareRecords) {
+  Database shared_db(4);
+  DatabaseServer server(&shared_db, 0);
+  server.Start();
+  auto state = SearchState(ir::IRSchedule());
+
+  // the records are sent once a batch is full or flushed
+  RemoteDatabase job1(2, LocalAddress(server.Port()), /*batch_size=*/2, /*cache_ttl_ms=*/0);
+  job1.AddRecord(TuningRecord("k1", state, 3.0));
+  ASSERT_EQ(shared_db.Count("k1"), 0);
+  job1.AddRecord(TuningRecord("k1", state, 2.0));
+  ASSERT_EQ(shared_db.Count("k1"), 2);
+  job1.AddRecord(TuningRecord("k2", state, 5.0));
+  ASSERT_TRUE(job1.Flush());
+  ASSERT_EQ(shared_db.Count("k2"), 1);
+
+  // another job sees the best records of the first one, at most its capacity
+  RemoteDatabase job2(1, LocalAddress(server.Port()), /*batch_size=*/4, /*cache_ttl_ms=*/0);
+  auto records = job2.GetTopK("k1", 1);
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].execution_cost, 2.0);
+
+  // the pending records are sent before fetching, so the top-K covers the local ones
+  job2.AddRecord(TuningRecord("k1", state, 1.0));
+  job1.AddRecord(TuningRecord("k1", state, 1.5));
+  ASSERT_TRUE(job1.Flush());
+  ASSERT_EQ(job2.GetTopK("k1", 1)[0].execution_cost, 1.0);
+  ASSERT_EQ(job1.GetTopK("k1", 2)[0].execution_cost, 1.0);
+  ASSERT_EQ(job1.GetTopK("k1", 2)[1].execution_cost, 1.5);
+  server.Stop();
+}
+
+TEST(RemoteDatabase, CacheAndServerDown) {
+  Database shared_db(2);
+  DatabaseServer server(&shared_db, 0);
+  server.Start();
+  auto state = SearchState(ir::IRSchedule());
+  shared_db.AddRecord(TuningRecord("k1", state, 2.0));
+
+  RemoteDatabase job(2, LocalAddress(server.Port()), /*batch_size=*/1, /*cache_ttl_ms=*/600000, /*timeout_ms=*/1000);
+  ASSERT_EQ(job.Count("k1"), 1);
+  // the cached records are not fetched again before expired
+  shared_db.AddRecord(TuningRecord("k1", state, 1.0));
+  ASSERT_EQ(job.GetTopK("k1", 1)[0].execution_cost, 2.0);
+
+  // the records are kept to send later and the cached ones are still available if the server is down
+  server.Stop();
+  job.AddRecord(TuningRecord("k1", state, 0.5));
+  ASSERT_FALSE(job.Flush());
+  ASSERT_EQ(job.GetTopK("k1", 1)[0].execution_cost, 0.5);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,197 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/measure/device_tracker.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace cinn {
+namespace auto_schedule {
+
+DeviceTracker::DeviceTracker(int port, int max_failures)
+    : max_failures_(max_failures), server_(port, [this](const std::string& data) {
+        proto::TrackerRequest request;
+        proto::TrackerResponse response;
+        if (request.ParseFromString(data)) {
+          response = Handle(request);
+        } else {
+          response.set_error_msg("Failed to parse the request of the tracker");
+        }
+        return response.SerializeAsString();
+      }) {
+  CHECK_GT(max_failures_, 0);
+}
+
+proto::TrackerResponse DeviceTracker::Handle(const proto::TrackerRequest& request) {
+  switch (request.kind()) {
+    case proto::TrackerRequest::REGISTER:
+      return Register(request);
+    case proto::TrackerRequest::ACQUIRE:
+      return Acquire(request);
+    case proto::TrackerRequest::RELEASE:
+      return Release(request);
+    default:
+      proto::TrackerResponse response;
+      response.set_error_msg("Unknown kind of the request: " + std::to_string(request.kind()));
+      return response;
+  }
+}
+
+int DeviceTracker::NumDevices(const std::string& device_key) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = devices_.find(device_key);
+  return it == devices_.end() ? 0 : it->second.size();
+}
+
+proto::TrackerResponse DeviceTracker::Register(const proto::TrackerRequest& request) {
+  proto::TrackerResponse response;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto& devices = devices_[request.device_key()];
+    auto it       = std::find_if(
+        devices.begin(), devices.end(), [&](const Device& device) { return device.address == request.address(); });
+    // a registered server comes back, such as after restarted, so its states are reset
+    if (it != devices.end()) {
+      *it          = Device();
+      it->address = request.address();
+    } else {
+      devices.emplace_back();
+      devices.back().address = request.address();
+    }
+  }
+  cv_.notify_all();
+  LOG(INFO) << "Register the device [" << request.device_key() << "] at " << request.address();
+  response.set_ok(true);
+  return response;
+}
+
+proto::TrackerResponse DeviceTracker::Acquire(const proto::TrackerRequest& request) {
+  proto::TrackerResponse response;
+  Device* acquired = nullptr;
+  auto find_free   = [&]() {
+    auto it = devices_.find(request.device_key());
+    if (it == devices_.end()) return false;
+    for (auto& device : it->second) {
+      if (!device.busy) {
+        acquired = &device;
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (request.timeout_ms() > 0) {
+    cv_.wait_for(lock, std::chrono::milliseconds(request.timeout_ms()), find_free);
+  } else {
+    cv_.wait(lock, find_free);
+  }
+  if (!acquired) {
+    response.set_error_msg("No free device [" + request.device_key() + "] in " +
+                           std::to_string(request.timeout_ms()) + " ms");
+    return response;
+  }
+  acquired->busy = true;
+  response.set_ok(true);
+  response.set_address(acquired->address);
+  return response;
+}
+
+proto::TrackerResponse DeviceTracker::Release(const proto::TrackerRequest& request) {
+  proto::TrackerResponse response;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto& devices = devices_[request.device_key()];
+    auto it       = std::find_if(
+        devices.begin(), devices.end(), [&](const Device& device) { return device.address == request.address(); });
+    if (it == devices.end()) {
+      response.set_error_msg("The device at " + request.address() + " is not registered");
+      return response;
+    }
+    it->busy     = false;
+    it->failures = request.failed() ? it->failures + 1 : 0;
+    if (it->failures >= max_failures_) {
+      LOG(WARNING) << "Drop the device [" << request.device_key() << "] at " << request.address() << " after "
+                   << it->failures << " failures in a row";
+      devices.erase(it);
+    }
+  }
+  cv_.notify_all();
+  response.set_ok(true);
+  return response;
+}
+
+DeviceTrackerClient::DeviceTrackerClient(const std::string& tracker_address, int timeout_ms)
+    : tracker_address_(tracker_address), timeout_ms_(timeout_ms) {}
+
+bool DeviceTrackerClient::Call(const proto::TrackerRequest& request,
+                               int timeout_ms,
+                               proto::TrackerResponse* response,
+                               std::string* error_msg) {
+  std::string data;
+  if (!RpcCall(tracker_address_, request.SerializeAsString(), timeout_ms, &data, error_msg)) {
+    return false;
+  }
+  if (!response->ParseFromString(data)) {
+    *error_msg = "Failed to parse the response of the tracker";
+    return false;
+  }
+  if (!response->ok()) {
+    *error_msg = response->error_msg();
+    return false;
+  }
+  return true;
+}
+
+bool DeviceTrackerClient::Register(const std::string& device_key, const std::string& address, std::string* error_msg) {
+  proto::TrackerRequest request;
+  request.set_kind(proto::TrackerRequest::REGISTER);
+  request.set_device_key(device_key);
+  request.set_address(address);
+  proto::TrackerResponse response;
+  return Call(request, timeout_ms_, &response, error_msg);
+}
+
+std::string DeviceTrackerClient::Acquire(const std::string& device_key, int timeout_ms, std::string* error_msg) {
+  proto::TrackerRequest request;
+  request.set_kind(proto::TrackerRequest::ACQUIRE);
+  request.set_device_key(device_key);
+  request.set_timeout_ms(timeout_ms);
+  proto::TrackerResponse response;
+  // the tracker waits timeout_ms for a free device, so give it more time to respond
+  int call_timeout_ms = timeout_ms > 0 ? timeout_ms + timeout_ms_ : 0;
+  if (!Call(request, call_timeout_ms, &response, error_msg)) {
+    return "";
+  }
+  return response.address();
+}
+
+void DeviceTrackerClient::Release(const std::string& device_key, const std::string& address, bool failed) {
+  proto::TrackerRequest request;
+  request.set_kind(proto::TrackerRequest::RELEASE);
+  request.set_device_key(device_key);
+  request.set_address(address);
+  request.set_failed(failed);
+  proto::TrackerResponse response;
+  std::string error_msg;
+  if (!Call(request, timeout_ms_, &response, &error_msg)) {
+    LOG(WARNING) << "Failed to release the device at " << address << ": " << error_msg;
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
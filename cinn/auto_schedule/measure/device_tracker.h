@@ -0,0 +1,98 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/auto_schedule/measure/rpc_channel.h"
+#include "cinn/auto_schedule/measure/rpc_measure.pb.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * DeviceTracker keeps the pool of runner servers, each of which measures on one device. A runner server registers
+ * itself with a device key, a client acquires a free server of the key to measure a candidate and releases it after.
+ *
+ * A server failing max_failures times in a row, such as unreachable or timed out, is dropped from the pool, so a
+ * broken device doesn't fail the following measurements. It can register again after recovered.
+ */
+class DeviceTracker {
+ public:
+  //! @param port The port to listen on, 0 means any free port.
+  explicit DeviceTracker(int port = 0, int max_failures = 3);
+
+  void Start() { server_.Start(); }
+  void Stop() { server_.Stop(); }
+  int Port() const { return server_.Port(); }
+
+  proto::TrackerResponse Handle(const proto::TrackerRequest& request);
+
+  //! The number of devices of \p device_key in the pool.
+  int NumDevices(const std::string& device_key) const;
+
+ private:
+  struct Device {
+    std::string address;
+    bool busy{false};
+    // the number of failures in a row
+    int failures{0};
+  };
+
+  proto::TrackerResponse Register(const proto::TrackerRequest& request);
+  proto::TrackerResponse Acquire(const proto::TrackerRequest& request);
+  proto::TrackerResponse Release(const proto::TrackerRequest& request);
+
+  const int max_failures_;
+  RpcServer server_;
+
+  // device key -> the runner servers
+  std::unordered_map<std::string, std::vector<Device>> devices_;
+  mutable std::mutex mtx_;
+  // notified when a device becomes free
+  std::condition_variable cv_;
+};
+
+// The client to call a DeviceTracker.
+class DeviceTrackerClient {
+ public:
+  //! @param timeout_ms The timeout of the calls except Acquire, which waits as long as it is asked.
+  DeviceTrackerClient(const std::string& tracker_address, int timeout_ms = 10000);
+
+  //! Add the runner server at \p address to the pool of \p device_key.
+  bool Register(const std::string& device_key, const std::string& address, std::string* error_msg);
+
+  //! Get the address of a free runner server of \p device_key, empty if none becomes free in timeout_ms.
+  std::string Acquire(const std::string& device_key, int timeout_ms, std::string* error_msg);
+
+  //! Give the server back to the pool, \p failed tells whether it failed to serve the last request.
+  void Release(const std::string& device_key, const std::string& address, bool failed);
+
+ private:
+  bool Call(const proto::TrackerRequest& request,
+            int timeout_ms,
+            proto::TrackerResponse* response,
+            std::string* error_msg);
+
+  const std::string tracker_address_;
+  const int timeout_ms_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -36,6 +37,9 @@ struct MeasureInput {
   // It is used to pass for some arguments that maybe
   // specified value in advance. default is null
   const std::map<std::string, cinn_pod_value_t>* execution_args = nullptr;
+  // The best execution cost of the task measured so far, a runner
+  // may stop running a candidate once it is clearly slower than this
+  double best_cost = std::numeric_limits<double>::max();  // unit: us
 };
 
 // The result of a measurement
@@ -43,9 +47,21 @@ struct MeasureResult {
   // The time cost of execution in average of running
   // with a specific repeated times.
   double execution_cost = 0.0;  // unit: us
+  // The standard deviation of the execution cost among the repeated runs
+  double execution_cost_stddev = 0.0;  // unit: us
+  // The times of running actually taken into account
+  int num_repeats = 0;
   // The time cost of the whole measurement process including
   // building and running
   double elapsed_time = 0.0;  // unit: us
+  // The time cost of each phase in the measurement
+  double build_time    = 0.0;  // unit: us
+  double run_wait_time = 0.0;  // unit: us, waiting for the runner to be free
+  double run_time      = 0.0;  // unit: us
+  // The max local memory per thread and the min occupancy among the CUDA
+  // kernels of the candidate, see utils::CompileStats::KernelStats
+  int local_bytes  = 0;
+  double occupancy = 1.0;
   // used to return detail messages once an error occurred during measurement,
   // empty if nothing goes wrong
   std::string error_msg;
@@ -57,6 +73,12 @@ struct BuildResult {
   const hlir::framework::Scope* compiled_scope;
   // The executable program
   std::unique_ptr<hlir::framework::Program> runtime_program;
+  // The max local memory per thread and the min occupancy among the CUDA kernels
+  int local_bytes  = 0;
+  double occupancy = 1.0;
+  // Not empty if the built program is rejected without running, such as
+  // its kernels spilling the registers
+  std::string error_msg;
 };
 
 // This interface defines how to generate executable objects
@@ -73,6 +95,10 @@ class ScheduleBuilder {
 class ScheduleRunner {
  public:
   virtual MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) = 0;
+
+  // The number of runs allowed at the same time, 0 means no limit. A runner measuring
+  // on a single device should run one by one, otherwise the runs disturb each other.
+  virtual int MaxConcurrentRuns() const { return 1; }
 };
 
 }  // namespace auto_schedule
@@ -14,7 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
@@ -25,6 +28,7 @@
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/runtime/flags.h"
 
 DECLARE_bool(cinn_ir_schedule);
@@ -116,12 +120,81 @@ TEST_F(TestMeasurer, CatchException) {
   ASSERT_EQ(inputs.size(), results.size());
   EXPECT_EQ(results[0].error_msg, "Build failed, error: BuildError\n");
 
-  // TODO(CtfGo): test parallel build after we support thread-safe compilation
   auto measurer_with_run_error = std::make_unique<ScheduleMeasurer>(builder.get(), throw_runner.get(), 1);
   results                      = measurer_with_run_error->Measure(inputs);
   ASSERT_EQ(inputs.size(), results.size());
   EXPECT_EQ(results[0].error_msg, "Run failed, error: RunError\n");
 }
 
+// A runner records the max number of runs at the same time
+class CountingRunner : public ScheduleRunner {
+ public:
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override {
+    int running = ++num_running_;
+    int expect  = max_running_.load();
+    while (running > expect && !max_running_.compare_exchange_weak(expect, running)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    --num_running_;
+    MeasureResult result;
+    result.execution_cost = 1.0;
+    return result;
+  }
+
+  int MaxRunning() const { return max_running_; }
+
+ private:
+  std::atomic<int> num_running_{0};
+  std::atomic<int> max_running_{0};
+};
+
+TEST_F(TestMeasurer, ParallelBuild) {
+  auto builder  = std::make_unique<SimpleBuilder>(graph_compiler.get());
+  auto runner   = std::make_unique<CountingRunner>();
+  auto measurer = std::make_unique<ScheduleMeasurer>(builder.get(), runner.get(), 4);
+  std::vector<MeasureInput> repeated_inputs;
+  for (int i = 0; i < 4; ++i) {
+    for (auto& input : inputs) {
+      // each candidate owns its functions as the ones in tuning
+      repeated_inputs.push_back(input);
+      repeated_inputs.back().lowered_funcs = optim::IRCopy(input.lowered_funcs);
+    }
+  }
+  std::vector<MeasureResult> results = measurer->Measure(repeated_inputs);
+  ASSERT_EQ(repeated_inputs.size(), results.size());
+  for (auto& result : results) {
+    EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+    EXPECT_EQ(result.execution_cost, 1.0);
+    EXPECT_GT(result.build_time, 0.0);
+    EXPECT_GE(result.elapsed_time, result.build_time + result.run_time);
+  }
+  // the builds go in parallel, but the runs on the device are serialized
+  EXPECT_EQ(runner->MaxRunning(), 1);
+}
+
+// A builder rejects all the candidates as spilling the registers
+class SpillingBuilder : public ScheduleBuilder {
+  BuildResult Build(const MeasureInput& input) override {
+    BuildResult result;
+    result.local_bytes = 64;
+    result.occupancy   = 0.25;
+    result.error_msg   = "Build rejected\n";
+    return result;
+  }
+};
+
+TEST_F(TestMeasurer, SkipRejectedBuild) {
+  auto builder                       = std::make_unique<SpillingBuilder>();
+  auto runner                        = std::make_unique<CountingRunner>();
+  auto measurer                      = std::make_unique<ScheduleMeasurer>(builder.get(), runner.get());
+  std::vector<MeasureResult> results = measurer->Measure(inputs);
+  ASSERT_EQ(inputs.size(), results.size());
+  EXPECT_EQ(results[0].error_msg, "Build rejected\n");
+  EXPECT_EQ(results[0].local_bytes, 64);
+  EXPECT_DOUBLE_EQ(results[0].occupancy, 0.25);
+  // the rejected candidates are not run
+  EXPECT_EQ(runner->MaxRunning(), 0);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -0,0 +1,253 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/measure/rpc_channel.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// the largest message accepted, to not allocate for a broken length
+constexpr uint64_t kMaxMessageBytes = 1UL << 32;
+// the time to wait for the request after a connection is accepted
+constexpr int kRequestTimeoutMs = 60000;
+// the interval to check whether the server is stopped
+constexpr int kAcceptPollMs = 100;
+
+Clock::time_point Deadline(int timeout_ms) {
+  return timeout_ms > 0 ? Clock::now() + std::chrono::milliseconds(timeout_ms) : Clock::time_point::max();
+}
+
+// Wait until \p fd is ready for \p events, return false if the deadline is reached.
+bool WaitFd(int fd, short events, Clock::time_point deadline) {
+  while (true) {
+    int wait_ms = -1;
+    if (deadline != Clock::time_point::max()) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+      if (left <= 0) return false;
+      wait_ms = static_cast<int>(left);
+    }
+    pollfd pfd{fd, events, 0};
+    int ret = ::poll(&pfd, 1, wait_ms);
+    if (ret > 0) return true;
+    if (ret == 0 || errno != EINTR) return false;
+  }
+}
+
+bool SendAll(int fd, const char* data, size_t size, Clock::time_point deadline) {
+  while (size > 0) {
+    if (!WaitFd(fd, POLLOUT, deadline)) return false;
+    ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      // MSG_NOSIGNAL avoids SIGPIPE on a closed socket, and a pipe is written directly
+      if (errno == ENOTSOCK) n = ::write(fd, data, size);
+      if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+      if (n < 0) return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool RecvAll(int fd, char* data, size_t size, Clock::time_point deadline) {
+  while (size > 0) {
+    if (!WaitFd(fd, POLLIN, deadline)) return false;
+    ssize_t n = ::read(fd, data, size);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+    // n == 0 means the peer is closed
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool WriteFramed(int fd, const std::string& message, Clock::time_point deadline) {
+  uint64_t size = message.size();
+  unsigned char header[8];
+  for (int i = 0; i < 8; ++i) {
+    header[i] = static_cast<unsigned char>(size >> (8 * i));
+  }
+  return SendAll(fd, reinterpret_cast<const char*>(header), sizeof(header), deadline) &&
+         SendAll(fd, message.data(), message.size(), deadline);
+}
+
+bool ReadFramed(int fd, std::string* message, Clock::time_point deadline) {
+  unsigned char header[8];
+  if (!RecvAll(fd, reinterpret_cast<char*>(header), sizeof(header), deadline)) return false;
+  uint64_t size = 0;
+  for (int i = 0; i < 8; ++i) {
+    size |= static_cast<uint64_t>(header[i]) << (8 * i);
+  }
+  if (size > kMaxMessageBytes) return false;
+  message->resize(size);
+  return RecvAll(fd, &(*message)[0], size, deadline);
+}
+
+// Connect to \p address("host:port") before the deadline, return the fd or -1.
+int Connect(const std::string& address, Clock::time_point deadline, std::string* error_msg) {
+  auto pos = address.rfind(':');
+  if (pos == std::string::npos) {
+    *error_msg = "Invalid address [" + address + "], it should be host:port";
+    return -1;
+  }
+  std::string host = address.substr(0, pos);
+  std::string port = address.substr(pos + 1);
+
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family   = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addrs   = nullptr;
+  int ret           = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs);
+  if (ret != 0) {
+    *error_msg = "Failed to resolve [" + address + "]: " + gai_strerror(ret);
+    return -1;
+  }
+
+  int fd = -1;
+  for (addrinfo* addr = addrs; addr; addr = addr->ai_next) {
+    fd = ::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (fd < 0) continue;
+    // connect in non-blocking mode to apply the deadline
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    if (::connect(fd, addr->ai_addr, addr->ai_addrlen) == 0) break;
+    if (errno == EINPROGRESS && WaitFd(fd, POLLOUT, deadline)) {
+      int err       = 0;
+      socklen_t len = sizeof(err);
+      if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) break;
+    }
+    ::close(fd);
+    fd = -1;
+  }
+  ::freeaddrinfo(addrs);
+  if (fd < 0) {
+    *error_msg = "Failed to connect to [" + address + "]";
+  }
+  return fd;
+}
+
+}  // namespace
+
+bool WriteMessage(int fd, const std::string& message, int timeout_ms) {
+  return WriteFramed(fd, message, Deadline(timeout_ms));
+}
+
+bool ReadMessage(int fd, std::string* message, int timeout_ms) {
+  return ReadFramed(fd, message, Deadline(timeout_ms));
+}
+
+bool RpcCall(const std::string& address,
+             const std::string& request,
+             int timeout_ms,
+             std::string* response,
+             std::string* error_msg) {
+  auto deadline = Deadline(timeout_ms);
+  int fd        = Connect(address, deadline, error_msg);
+  if (fd < 0) return false;
+  bool ok = WriteFramed(fd, request, deadline);
+  if (!ok) {
+    *error_msg = "Failed to send the request to [" + address + "]";
+  } else if (!(ok = ReadFramed(fd, response, deadline))) {
+    *error_msg = "No response from [" + address + "] in " + std::to_string(timeout_ms) + " ms";
+  }
+  ::close(fd);
+  return ok;
+}
+
+RpcServer::RpcServer(int port, Handler handler) : port_(port), handler_(std::move(handler)) {}
+
+RpcServer::~RpcServer() { Stop(); }
+
+void RpcServer::Start() {
+  CHECK(stopped_) << "The server is already started";
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  CHECK_GE(listen_fd_, 0) << "Failed to create the socket: " << std::strerror(errno);
+  int reuse = 1;
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port        = htons(port_);
+  CHECK_EQ(::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0)
+      << "Failed to bind the port " << port_ << ": " << std::strerror(errno);
+  CHECK_EQ(::listen(listen_fd_, SOMAXCONN), 0) << "Failed to listen: " << std::strerror(errno);
+  socklen_t len = sizeof(addr);
+  ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+  port_ = ntohs(addr.sin_port);
+
+  stopped_       = false;
+  accept_thread_ = std::thread(&RpcServer::AcceptLoop, this);
+  VLOG(3) << "RpcServer listens on port " << port_;
+}
+
+void RpcServer::Stop() {
+  if (stopped_.exchange(true)) return;
+  if (accept_thread_.joinable()) {
+    accept_thread_.join();
+  }
+  ::close(listen_fd_);
+  listen_fd_ = -1;
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_.wait(lock, [this] { return num_active_ == 0; });
+}
+
+void RpcServer::AcceptLoop() {
+  while (!stopped_) {
+    if (!WaitFd(listen_fd_, POLLIN, Deadline(kAcceptPollMs))) continue;
+    int conn_fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (conn_fd < 0) continue;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ++num_active_;
+    }
+    std::thread(&RpcServer::Serve, this, conn_fd).detach();
+  }
+}
+
+void RpcServer::Serve(int conn_fd) {
+  std::string request;
+  if (ReadFramed(conn_fd, &request, Deadline(kRequestTimeoutMs))) {
+    std::string response = handler_(request);
+    if (!WriteFramed(conn_fd, response, Deadline(kRequestTimeoutMs))) {
+      LOG(WARNING) << "Failed to send the response, the client may be timed out";
+    }
+  }
+  ::close(conn_fd);
+  std::lock_guard<std::mutex> lock(mtx_);
+  --num_active_;
+  cv_.notify_all();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace cinn {
+namespace auto_schedule {
+
+// Write a message framed by its length to \p fd, return false if failed or not done in timeout_ms(<= 0 means no limit).
+bool WriteMessage(int fd, const std::string& message, int timeout_ms);
+
+// Read a message written by WriteMessage from \p fd, return false if failed or not done in timeout_ms.
+bool ReadMessage(int fd, std::string* message, int timeout_ms);
+
+/**
+ * Send \p request to the server listening on \p address ("host:port") and wait for the response, one connection
+ * serves only one call.
+ * @return false and set \p error_msg if failed to connect, or there is no response in timeout_ms(<= 0 means no limit).
+ */
+bool RpcCall(const std::string& address,
+             const std::string& request,
+             int timeout_ms,
+             std::string* response,
+             std::string* error_msg);
+
+/**
+ * A TCP server which answers each request by the handler. Every connection is served in its own thread, so the
+ * handler may block, such as to wait for a resource, without delaying the other requests.
+ */
+class RpcServer {
+ public:
+  using Handler = std::function<std::string(const std::string& request)>;
+
+  //! @param port The port to listen on, 0 means any free port, get the chosen one by Port() after Start().
+  RpcServer(int port, Handler handler);
+  ~RpcServer();
+
+  void Start();
+
+  //! Stop accepting connections and wait for the ones being served.
+  void Stop();
+
+  int Port() const { return port_; }
+
+ private:
+  void AcceptLoop();
+  void Serve(int conn_fd);
+
+  int port_;
+  int listen_fd_{-1};
+  Handler handler_;
+
+  std::atomic<bool> stopped_{true};
+  std::thread accept_thread_;
+  // the number of connections being served
+  int num_active_{0};
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
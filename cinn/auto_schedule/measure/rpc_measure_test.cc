@@ -0,0 +1,158 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "cinn/auto_schedule/measure/device_tracker.h"
+#include "cinn/auto_schedule/measure/rpc_channel.h"
+#include "cinn/auto_schedule/measure/rpc_runner.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+static std::string LocalAddress(int port) { return "127.0.0.1:" + std::to_string(port); }
+
+TEST(RpcChannel, CallAndTimeout) {
+  RpcServer echo_server(0, [](const std::string& request) { return "echo:" + request; });
+  echo_server.Start();
+  std::string response, error_msg;
+  ASSERT_TRUE(RpcCall(LocalAddress(echo_server.Port()), "hello", 1000, &response, &error_msg)) << error_msg;
+  ASSERT_EQ(response, "echo:hello");
+
+  RpcServer slow_server(0, [](const std::string& request) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    return request;
+  });
+  slow_server.Start();
+  ASSERT_FALSE(RpcCall(LocalAddress(slow_server.Port()), "hello", 100, &response, &error_msg));
+  ASSERT_FALSE(error_msg.empty());
+
+  int closed_port = echo_server.Port();
+  echo_server.Stop();
+  ASSERT_FALSE(RpcCall(LocalAddress(closed_port), "hello", 1000, &response, &error_msg));
+}
+
+TEST(DeviceTracker, AcquireAndRelease) {
+  DeviceTracker tracker(0, /*max_failures=*/2);
+  tracker.Start();
+  DeviceTrackerClient client(LocalAddress(tracker.Port()));
+  std::string error_msg;
+  ASSERT_TRUE(client.Register("test_device", "host0:9000", &error_msg)) << error_msg;
+  ASSERT_EQ(tracker.NumDevices("test_device"), 1);
+
+  ASSERT_EQ(client.Acquire("test_device", 100, &error_msg), "host0:9000");
+  // the only device is busy
+  ASSERT_TRUE(client.Acquire("test_device", 100, &error_msg).empty());
+  ASSERT_TRUE(client.Acquire("other_device", 100, &error_msg).empty());
+
+  // a waiting request gets the device once it is released
+  std::thread release_thread([&client] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    client.Release("test_device", "host0:9000", false);
+  });
+  ASSERT_EQ(client.Acquire("test_device", 5000, &error_msg), "host0:9000");
+  release_thread.join();
+
+  // the device failing twice in a row is dropped
+  client.Release("test_device", "host0:9000", true);
+  ASSERT_EQ(tracker.NumDevices("test_device"), 1);
+  ASSERT_EQ(client.Acquire("test_device", 100, &error_msg), "host0:9000");
+  client.Release("test_device", "host0:9000", true);
+  ASSERT_EQ(tracker.NumDevices("test_device"), 0);
+  tracker.Stop();
+}
+
+class TestRpcRunner : public ::testing::Test {
+ public:
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
+  std::unique_ptr<TuneTask> task;
+
+  MeasureInput input;
+  BuildResult build_result;
+
+  void SetUp() override {
+    frontend::NetBuilder builder("test");
+    auto a       = builder.CreateInput(Float(32), {32, 24}, "A");
+    auto b       = builder.CreateInput(Float(32), {32, 24}, "B");
+    auto c       = builder.Relu(builder.Add(a, b));
+    auto program = builder.Build();
+
+    std::unordered_set<std::string> fetch_ids;
+    auto graph          = frontend::Optimize(&program, fetch_ids, target);
+    auto compiled_scope = hlir::framework::BuildScope(target, graph);
+    graph_compiler      = std::make_unique<hlir::framework::GraphCompiler>(target, compiled_scope, graph);
+
+    build_result.compiled_scope  = compiled_scope.get();
+    build_result.runtime_program = graph_compiler->Build();
+
+    task           = std::make_unique<TuneTask>();
+    task->target   = target;
+    task->subgraph = graph->fusion_groups.front();
+    input.task     = task.get();
+  }
+};
+
+TEST_F(TestRpcRunner, MeasureOnRunnerServer) {
+  DeviceTracker tracker;
+  tracker.Start();
+  RunnerServer runner_server(target);
+  runner_server.Start();
+  std::string error_msg;
+  ASSERT_TRUE(runner_server.RegisterTo(
+      LocalAddress(tracker.Port()), "test_device", LocalAddress(runner_server.Port()), &error_msg))
+      << error_msg;
+
+  RpcRunner runner(LocalAddress(tracker.Port()), "test_device", 2, 10000);
+  MeasureResult result = runner.Run(input, build_result);
+  ASSERT_TRUE(result.error_msg.empty()) << result.error_msg;
+  ASSERT_GE(result.execution_cost, 0);
+  ASSERT_GE(result.elapsed_time, result.execution_cost);
+  runner_server.Stop();
+  tracker.Stop();
+}
+
+TEST(RunnerServer, IsolateCrash) {
+  RunnerServer runner_server(common::DefaultHostTarget());
+  runner_server.Start();
+  proto::RunRequest request;
+  // the broken artifact aborts the measurement process
+  request.set_program("not a program");
+  request.set_timeout_ms(10000);
+  for (int i = 0; i < 2; ++i) {
+    std::string response_data, error_msg;
+    ASSERT_TRUE(RpcCall(
+        LocalAddress(runner_server.Port()), request.SerializeAsString(), 20000, &response_data, &error_msg))
+        << error_msg;
+    proto::RunResponse response;
+    ASSERT_TRUE(response.ParseFromString(response_data));
+    // the server survives and keeps serving
+    ASSERT_FALSE(response.error_msg().empty());
+  }
+  runner_server.Stop();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,224 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/measure/rpc_runner.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <unordered_set>
+
+#include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+#ifdef CINN_WITH_CUDA
+#include "cinn/backends/cuda_util.h"
+#endif
+
+namespace cinn {
+namespace auto_schedule {
+
+// the time to transfer the request and the response, besides the time limit of the measurement
+constexpr int kTransferTimeoutMs = 10000;
+
+RpcRunner::RpcRunner(const std::string& tracker_address,
+                     const std::string& device_key,
+                     int repeat_times,
+                     int timeout_ms,
+                     int max_retries)
+    : tracker_(tracker_address),
+      device_key_(device_key),
+      repeat_times_(repeat_times),
+      timeout_ms_(timeout_ms),
+      max_retries_(max_retries) {
+  CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
+  CHECK_GT(timeout_ms_, 0) << "timeout_ms should be positive";
+}
+
+MeasureResult RpcRunner::Run(const MeasureInput& input, const BuildResult& build_result) {
+  MeasureResult result;
+  auto t_start = std::chrono::steady_clock::now();
+  CHECK(build_result.runtime_program) << "There is no program to run";
+  if (input.execution_args) {
+    VLOG(4) << "RpcRunner ignores the preset execution args, they are allocated on the remote device";
+  }
+
+  proto::RunRequest request;
+  request.set_program(build_result.runtime_program->Serialize());
+  request.set_repeat_times(repeat_times_);
+  request.set_timeout_ms(timeout_ms_);
+  for (auto& name : ParamsNeedInitWithZero(input)) {
+    request.add_zero_init_args(name);
+  }
+  std::string request_data = request.SerializeAsString();
+
+  for (int attempt = 0; attempt <= max_retries_; ++attempt) {
+    std::string error_msg;
+    std::string address = tracker_.Acquire(device_key_, timeout_ms_, &error_msg);
+    if (address.empty()) {
+      result.error_msg = error_msg;
+      break;
+    }
+    VLOG(4) << "RpcRunner measures on " << address;
+    std::string response_data;
+    proto::RunResponse response;
+    bool ok = RpcCall(address, request_data, timeout_ms_ + kTransferTimeoutMs, &response_data, &error_msg);
+    if (ok && !response.ParseFromString(response_data)) {
+      ok        = false;
+      error_msg = "Failed to parse the response of " + address;
+    }
+    tracker_.Release(device_key_, address, !ok);
+    if (ok) {
+      result.execution_cost = response.execution_cost();
+      result.error_msg      = response.error_msg();
+      break;
+    }
+    // the device failed rather than the candidate, so try another one
+    LOG(WARNING) << "Measure on " << address << " failed: " << error_msg << ", attempt " << attempt + 1 << "/"
+                 << max_retries_ + 1;
+    result.error_msg = error_msg;
+  }
+
+  auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start);
+  result.elapsed_time = static_cast<double>(time_span.count());
+  VLOG(4) << "A remote measurement done:repeat_times[" << repeat_times_ << "]total_elapsed_time["
+          << result.elapsed_time << "]us,execution_cost[" << result.execution_cost << "]us";
+  return result;
+}
+
+RunnerServer::RunnerServer(const common::Target& target, int port, bool isolate)
+    : target_(target), isolate_(isolate), server_(port, [this](const std::string& data) { return Handle(data); }) {}
+
+bool RunnerServer::RegisterTo(const std::string& tracker_address,
+                              const std::string& device_key,
+                              const std::string& address,
+                              std::string* error_msg) {
+  return DeviceTrackerClient(tracker_address).Register(device_key, address, error_msg);
+}
+
+std::string RunnerServer::Handle(const std::string& data) {
+  proto::RunRequest request;
+  proto::RunResponse response;
+  if (!request.ParseFromString(data)) {
+    response.set_error_msg("Failed to parse the request of the runner");
+    return response.SerializeAsString();
+  }
+  std::lock_guard<std::mutex> lock(measure_mtx_);
+  response = isolate_ ? MeasureInChild(request) : Measure(request, target_);
+  return response.SerializeAsString();
+}
+
+proto::RunResponse RunnerServer::MeasureInChild(const proto::RunRequest& request) {
+  proto::RunResponse response;
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    response.set_error_msg("Failed to create the pipe to the measurement process");
+    return response;
+  }
+  pid_t pid = ::fork();
+  if (pid < 0) {
+    ::close(fds[0]);
+    ::close(fds[1]);
+    response.set_error_msg("Failed to fork the measurement process");
+    return response;
+  }
+  if (pid == 0) {
+    ::close(fds[0]);
+    WriteMessage(fds[1], Measure(request, target_).SerializeAsString(), 0);
+    ::_exit(0);
+  }
+
+  ::close(fds[1]);
+  std::string data;
+  bool done = ReadMessage(fds[0], &data, request.timeout_ms());
+  ::close(fds[0]);
+  int status = 0;
+  // the pipe is closed without the response if the child crashed, otherwise it is still running
+  bool exited = ::waitpid(pid, &status, done ? 0 : WNOHANG) == pid;
+  if (!exited) {
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, &status, 0);
+  }
+  if (done && response.ParseFromString(data)) {
+    return response;
+  }
+  if (!exited) {
+    response.set_error_msg("The measurement is killed after timed out in " + std::to_string(request.timeout_ms()) +
+                           " ms");
+  } else if (WIFSIGNALED(status)) {
+    response.set_error_msg("The measurement crashed with signal " + std::to_string(WTERMSIG(status)) +
+                           ", see the log of the runner server for details");
+  } else {
+    response.set_error_msg("The measurement exited without the result, exit code: " +
+                           std::to_string(WEXITSTATUS(status)));
+  }
+  return response;
+}
+
+proto::RunResponse RunnerServer::Measure(const proto::RunRequest& request, const common::Target& target) {
+  proto::RunResponse response;
+  try {
+    auto program = hlir::framework::Program::Deserialize(request.program(), target);
+    auto scope   = program->GetScope();
+    std::unordered_set<std::string> zero_init_args(request.zero_init_args().begin(), request.zero_init_args().end());
+
+    // all the arguments are taken from the scope of the artifact, initialized with random values
+    std::map<std::string, cinn_pod_value_t> execution_args;
+    auto fill_arg_fn = [&](const std::string& param) {
+      if (execution_args.count(param)) return;
+      auto tensor = scope->GetTensor(param);
+      InitTensorData(tensor, target, zero_init_args.count(param) != 0);
+      execution_args.emplace(param, tensor->buffer());
+    };
+    const auto& instructions = program->GetRunInstructions();
+    for (auto&& instr : instructions) {
+      for (auto&& args : instr->GetInArgs()) {
+        std::for_each(args.begin(), args.end(), fill_arg_fn);
+      }
+      for (auto&& args : instr->GetOutArgs()) {
+        std::for_each(args.begin(), args.end(), fill_arg_fn);
+      }
+    }
+
+    // Execute each instruction repeatedly and take the average as cost.
+    int repeat_times    = std::max(1, request.repeat_times());
+    double cost_summary = 0;
+    for (auto&& instr : instructions) {
+      auto run_start = std::chrono::steady_clock::now();
+      for (int i = 0; i < repeat_times; ++i) {
+        instr->Run(&execution_args);
+      }
+#ifdef CINN_WITH_CUDA
+      if (target == common::DefaultNVGPUTarget()) {
+        CUDA_CALL(cudaDeviceSynchronize());
+      }
+#endif
+      auto time_span =
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - run_start);
+      cost_summary += static_cast<double>(time_span.count()) / repeat_times;
+    }
+    response.set_execution_cost(cost_summary);
+  } catch (std::exception& e) {
+    response.set_error_msg(std::string("Run failed, error: ") + e.what());
+  }
+  return response;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include "cinn/auto_schedule/measure/device_tracker.h"
+#include "cinn/auto_schedule/measure/measure.h"
+#include "cinn/auto_schedule/measure/rpc_channel.h"
+#include "cinn/auto_schedule/measure/rpc_measure.pb.h"
+#include "cinn/common/target.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * RpcRunner measures the built candidates on the runner servers registered in a DeviceTracker. The program is sent
+ * as the artifact of hlir::framework::Program::Serialize, so a ScheduleMeasurer with multiple threads keeps all the
+ * devices in the pool busy while building the following candidates.
+ *
+ * A candidate failed on a server (unreachable or no response in time) is retried on another one, the failure is
+ * reported to the tracker which drops the servers failing in a row. The preset execution_args of MeasureInput
+ * can't be sent and are ignored, the remote side allocates all the arguments by itself.
+ */
+class RpcRunner : public ScheduleRunner {
+ public:
+  /**
+   * @param tracker_address The address("host:port") of the DeviceTracker.
+   * @param device_key The kind of the devices to measure on.
+   * @param repeat_times The repeat times of running instructions, the average time is returned.
+   * @param timeout_ms The time limit of waiting for a free device, and of a measurement.
+   * @param max_retries The times to retry on another device if a device fails.
+   */
+  RpcRunner(const std::string& tracker_address,
+            const std::string& device_key,
+            int repeat_times,
+            int timeout_ms  = 60000,
+            int max_retries = 2);
+
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
+
+  // each run takes a device of its own from the tracker
+  int MaxConcurrentRuns() const override { return 0; }
+
+ private:
+  DeviceTrackerClient tracker_;
+  const std::string device_key_;
+  const int repeat_times_;
+  const int timeout_ms_;
+  const int max_retries_;
+};
+
+/**
+ * RunnerServer measures the candidates sent by RpcRunner on the local device. With isolate = true every measurement
+ * runs in a forked child process, so a crashed or hung candidate is killed and reported as an error instead of
+ * bringing the server down. The server process doesn't touch the device in that case, so a child is always forked
+ * from a process without the device context.
+ */
+class RunnerServer {
+ public:
+  //! @param port The port to listen on, 0 means any free port.
+  explicit RunnerServer(const common::Target& target, int port = 0, bool isolate = true);
+
+  void Start() { server_.Start(); }
+  void Stop() { server_.Stop(); }
+  int Port() const { return server_.Port(); }
+
+  //! Add this server to the pool of a DeviceTracker, \p address is how the clients of the tracker reach this server.
+  bool RegisterTo(const std::string& tracker_address,
+                  const std::string& device_key,
+                  const std::string& address,
+                  std::string* error_msg);
+
+  //! Measure in the current process.
+  static proto::RunResponse Measure(const proto::RunRequest& request, const common::Target& target);
+
+ private:
+  std::string Handle(const std::string& data);
+  proto::RunResponse MeasureInChild(const proto::RunRequest& request);
+
+  const common::Target target_;
+  const bool isolate_;
+  // the measurements on the device are serialized
+  std::mutex measure_mtx_;
+  RpcServer server_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
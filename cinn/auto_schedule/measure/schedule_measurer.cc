@@ -14,13 +14,53 @@
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <exception>
+#include <mutex>
 
 #include "cinn/utils/multi_threading.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// Limit the number of runs at the same time, no limit if the capacity is 0.
+class RunSlots {
+ public:
+  explicit RunSlots(int capacity) : limited_(capacity > 0), free_(capacity) {}
+
+  void Acquire() {
+    if (!limited_) return;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return free_ > 0; });
+    --free_;
+  }
+
+  void Release() {
+    if (!limited_) return;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ++free_;
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  const bool limited_;
+  int free_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+double ElapsedUs(const std::chrono::steady_clock::time_point& start) {
+  auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(time_span.count());
+}
+
+}  // namespace
+
 ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads)
     : builder_(builder), runner_(runner), num_threads_(num_threads) {}
 
@@ -31,45 +71,64 @@ std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureIn
   }
   std::vector<BuildResult> build_results(inputs.size());
   std::vector<MeasureResult> results(inputs.size());
+  RunSlots run_slots(runner_->MaxConcurrentRuns());
 
   // define how to build a candidate with the specified index
   auto build_fn = [builder = builder_, &inputs, &build_results, &results](int index) {
     VLOG(6) << "Build candidate index: " << index;
     auto m_start = std::chrono::steady_clock::now();
     try {
-      build_results[index] = builder->Build(inputs[index]);
+      build_results[index]       = builder->Build(inputs[index]);
+      results[index].local_bytes = build_results[index].local_bytes;
+      results[index].occupancy   = build_results[index].occupancy;
+      results[index].error_msg   = build_results[index].error_msg;
     } catch (std::exception& e) {
       results[index].error_msg = utils::StringFormat("Build failed, error: %s\n", e.what());
     }
-    auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
-    results[index].elapsed_time += static_cast<double>(time_span.count());
+    results[index].build_time = ElapsedUs(m_start);
   };
 
   // define how to run a candidate with the specified index
-  auto run_fn = [runner = runner_, &inputs, &build_results, &results](int index) {
+  auto run_fn = [runner = runner_, &inputs, &build_results, &results, &run_slots](int index) {
+    // if error occurred in building, then skip running
+    if (!results[index].error_msg.empty()) {
+      return;
+    }
     VLOG(6) << "Run candidate index: " << index;
-    auto m_start = std::chrono::steady_clock::now();
+    auto wait_start = std::chrono::steady_clock::now();
+    run_slots.Acquire();
+    results[index].run_wait_time = ElapsedUs(wait_start);
+    auto m_start                 = std::chrono::steady_clock::now();
     try {
-      // if error occurred in building, then skip running
-      if (results[index].error_msg.empty()) {
-        results[index] = runner->Run(inputs[index], build_results[index]);
-      }
+      MeasureResult run_result      = runner->Run(inputs[index], build_results[index]);
+      results[index].execution_cost        = run_result.execution_cost;
+      results[index].execution_cost_stddev = run_result.execution_cost_stddev;
+      results[index].num_repeats           = run_result.num_repeats;
+      results[index].error_msg             = run_result.error_msg;
     } catch (std::exception& e) {
       results[index].error_msg = utils::StringFormat("Run failed, error: %s\n", e.what());
     }
-    auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
-    results[index].elapsed_time += static_cast<double>(time_span.count());
+    run_slots.Release();
+    results[index].run_time = ElapsedUs(m_start);
   };
 
-  // measure a candidate by calling build and run successively
-  auto measure_fn = [&build_fn, &run_fn](int index) {
+  // measure a candidate by calling build and run successively, the builds of different candidates
+  // go in parallel while the runs are limited by the runner
+  auto measure_fn = [&build_fn, &run_fn, &build_results, &results](int index) {
+    auto m_start = std::chrono::steady_clock::now();
     build_fn(index);
     run_fn(index);
+    // release the built program early, the other candidates may be still building
+    build_results[index]        = BuildResult();
+    results[index].elapsed_time = ElapsedUs(m_start);
   };
   // default num_threads_ is 1 and in that case it will perform all measurements sequentially inplace.
   utils::parallel_run(measure_fn, utils::SequenceDispatcher(0, inputs.size()), num_threads_);
 
   VLOG(4) << "Measure " << inputs.size() << " candidates";
+  if (callback_) {
+    callback_(inputs, results);
+  }
   return results;
 }
 
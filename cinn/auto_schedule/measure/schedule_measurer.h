@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include "cinn/auto_schedule/measure/measure.h"
@@ -25,19 +27,26 @@ namespace auto_schedule {
 // which are building the input schedules and running the generated codes.
 class ScheduleMeasurer {
  public:
+  // Called with every measured batch and its results, such as to record the progress of tuning
+  using Callback = std::function<void(const std::vector<MeasureInput>&, const std::vector<MeasureResult>&)>;
+
   ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads = 1);
 
   // Measure a batch of inputs and return all results once.
   std::vector<MeasureResult> Measure(const std::vector<MeasureInput>& inputs);
 
+  // Set the callback of the measured batches, an empty one removes it
+  void SetCallback(Callback callback) { callback_ = std::move(callback); }
+
  private:
   // The handle to implemented ScheduleBuilder
   ScheduleBuilder* builder_;
   // The handle to implemented ScheduleRunner
   ScheduleRunner* runner_;
-  // The number of threads used to perform measurement,
-  // if it is greater than 1 that means parallel measurement.
+  // The number of threads used to perform measurement, if it is greater than 1, the candidates
+  // are built in parallel, and run as many at the same time as the runner allows.
   const int num_threads_;
+  Callback callback_;
 };
 
 }  // namespace auto_schedule
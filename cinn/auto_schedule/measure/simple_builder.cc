@@ -14,6 +14,12 @@
 
 #include "cinn/auto_schedule/measure/simple_builder.h"
 
+#include <algorithm>
+
+#include "cinn/utils/string.h"
+
+DECLARE_bool(auto_schedule_reject_spilling);
+
 namespace cinn {
 namespace auto_schedule {
 
@@ -34,6 +40,22 @@ BuildResult SimpleBuilder::Build(const MeasureInput& input) {
   BuildResult build_result;
   build_result.compiled_scope  = graph_compiler_->GetScope().get();
   build_result.runtime_program = std::move(compiled_result.runtime_program);
+
+  // the kernels spilling the registers or unable to launch are rejected early before running
+  for (auto& kernel : compiled_result.stats->Kernels()) {
+    build_result.local_bytes = std::max(build_result.local_bytes, kernel.local_bytes);
+    build_result.occupancy   = std::min(build_result.occupancy, kernel.occupancy);
+    if (FLAGS_auto_schedule_reject_spilling && build_result.error_msg.empty() &&
+        (kernel.local_bytes > 0 || kernel.occupancy <= 0.0)) {
+      build_result.error_msg = utils::StringFormat(
+          "Build rejected, kernel %s of %d threads takes %d registers and %d bytes of local memory, occupancy: %f\n",
+          kernel.kernel_name.c_str(),
+          kernel.block_threads,
+          kernel.num_regs,
+          kernel.local_bytes,
+          kernel.occupancy);
+    }
+  }
   return build_result;
 }
 
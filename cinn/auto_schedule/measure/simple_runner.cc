@@ -14,12 +14,18 @@
 
 #include "cinn/auto_schedule/measure/simple_runner.h"
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <random>
+#include <vector>
 
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/buffer.h"
@@ -74,8 +80,49 @@ static void PopulateRandomValue(const common::Type& type, const int numel, void*
   }
 }
 
+// Evict the data of the former run from the caches of the host CPU by writing a buffer twice as large as the last
+// level cache, one byte per cache line
+static void FlushCpuCache(const common::Target& target) {
+  static std::vector<char> flush_buffer(2 * static_cast<size_t>(target.cpu_info().llc_bytes));
+  static char value = 0;
+  ++value;
+  for (size_t i = 0; i < flush_buffer.size(); i += 64) {
+    flush_buffer[i] = value;
+  }
+}
+
+// Pin the calling thread to the core it is running on during the life time of this object, so that the measurement
+// isn't disturbed by the migrations between cores
+class ScopedCpuPinning {
+ public:
+  ScopedCpuPinning() {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && sched_getaffinity(0, sizeof(prev_set_), &prev_set_) == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      pinned_ = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+#endif
+  }
+  ~ScopedCpuPinning() {
+#ifdef __linux__
+    if (pinned_) {
+      sched_setaffinity(0, sizeof(prev_set_), &prev_set_);
+    }
+#endif
+  }
+
+ private:
+  bool pinned_ = false;
+#ifdef __linux__
+  cpu_set_t prev_set_;
+#endif
+};
+
 // Initialize a tensor with 0 if init_with_zero == true, otherwise initialize the tensor with random value.
-static void InitTensorData(Tensor tensor, const common::Target& target, bool init_with_zero) {
+void InitTensorData(Tensor tensor, const common::Target& target, bool init_with_zero) {
   int mem_size      = tensor->shape().numel() * tensor->type().bytes();
   auto* tensor_data = tensor->mutable_data(target, tensor->type());
 #ifdef CINN_WITH_CUDA
@@ -101,7 +148,7 @@ static void InitTensorData(Tensor tensor, const common::Target& target, bool ini
 
 // Find all parameter names in the task corresponding to the MeasureInput
 // that need to be initialized to 0 when measuring.
-static std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput& input) {
+std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput& input) {
   std::unordered_set<std::string> res;
   std::vector<hlir::framework::Node*> nodes = input.task->subgraph->CollectNodes();
   for (auto* node : nodes) {
@@ -121,8 +168,10 @@ static std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput
   return res;
 }
 
-SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
+SimpleRunner::SimpleRunner(int repeat_times, const AdaptiveRepeatConfig& config)
+    : repeat_times_(repeat_times), config_(config) {
   CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
+  CHECK_GE(config_.warmup_times, 0) << "warmup_times can't less than 0";
 }
 
 // Prepare execution arguments of all instructions to run, a argument
@@ -194,32 +243,72 @@ MeasureResult SimpleRunner::Run(const MeasureInput& input, const BuildResult& bu
   hlir::framework::Scope temp_scope;  // used for store temporary allocated data
   auto execution_args = PrepareArgs(input, build_result, &temp_scope);
 
-  // Execute each instruction repeatedly and take the average as cost.
-  result.execution_cost    = 0;
+  // Execute all instructions in order as a run, and return its time cost, the cache flushing is excluded
+  const auto& target       = input.task->target;
+  bool flush_cpu_cache     = config_.flush_cpu_cache && target.is_cpu();
   const auto& instructions = build_result.runtime_program->GetRunInstructions();
-  for (auto ct = 0; ct < instructions.size(); ++ct) {
-    auto&& instr = instructions.at(ct);
-    VLOG(5) << "Start running instruction-" << ct;
+  auto run_once_fn         = [&instructions, &execution_args, &target, flush_cpu_cache]() {
+    if (flush_cpu_cache) {
+      FlushCpuCache(target);
+    }
     auto run_start = std::chrono::steady_clock::now();
-    for (int i = 0; i < repeat_times_; ++i) {
+    for (auto ct = 0; ct < instructions.size(); ++ct) {
+      auto&& instr = instructions.at(ct);
+      VLOG(6) << "Start running instruction-" << ct;
       instr->Run(&execution_args);
-    }
 #ifdef CINN_WITH_CUDA
-    if (instr->target_ == common::DefaultNVGPUTarget()) {
-      CUDA_CALL(cudaDeviceSynchronize());
-    }
+      if (instr->target_ == common::DefaultNVGPUTarget()) {
+        CUDA_CALL(cudaDeviceSynchronize());
+      }
 #endif
-    auto time_span =
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - run_start);
-    auto cost_avg = static_cast<double>(time_span.count()) / repeat_times_;
-    result.execution_cost += cost_avg;
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - run_start).count();
+  };
+
+  std::unique_ptr<ScopedCpuPinning> cpu_pinning;
+  if (config_.pin_cpu_thread && target.is_cpu()) {
+    cpu_pinning = std::make_unique<ScopedCpuPinning>();
+  }
+  for (int i = 0; i < config_.warmup_times; ++i) {
+    run_once_fn();
+  }
+
+  // Run repeatedly and take the average as cost, stop early once the cost is
+  // stable enough or the candidate is clearly slower than the best one
+  int min_repeat_times = std::min(std::max(config_.min_repeat_times, 1), repeat_times_);
+  double sum = 0.0, square_sum = 0.0, mean = 0.0, stddev = 0.0;
+  int n = 0;
+  while (n < repeat_times_) {
+    double cost = run_once_fn();
+    sum += cost;
+    square_sum += cost * cost;
+    ++n;
+    mean   = sum / n;
+    stddev = n > 1 ? std::sqrt(std::max(square_sum - n * mean * mean, 0.0) / (n - 1)) : 0.0;
+    if (n < min_repeat_times) {
+      continue;
+    }
+    double half_ci = 1.96 * stddev / std::sqrt(n);
+    if (config_.max_relative_ci > 0 && half_ci <= config_.max_relative_ci * mean) {
+      VLOG(5) << "Stop measuring as the cost is stable after " << n << " runs";
+      break;
+    }
+    if (config_.slow_cutoff_ratio > 0 && input.best_cost < std::numeric_limits<double>::max() &&
+        mean - half_ci > config_.slow_cutoff_ratio * input.best_cost) {
+      VLOG(5) << "Stop measuring as the cost is clearly larger than the best " << input.best_cost << " after " << n
+              << " runs";
+      break;
+    }
   }
+  result.execution_cost        = mean;
+  result.execution_cost_stddev = stddev;
+  result.num_repeats           = n;
 
   auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start);
   result.elapsed_time = static_cast<double>(time_span.count());
 
-  VLOG(4) << "A measurement done:repeat_times[" << repeat_times_ << "]total_elapsed_time[" << result.elapsed_time
-          << "]us,execution_cost[" << result.execution_cost << "]us";
+  VLOG(4) << "A measurement done:repeat_times[" << result.num_repeats << "]total_elapsed_time[" << result.elapsed_time
+          << "]us,execution_cost[" << result.execution_cost << "]us,stddev[" << result.execution_cost_stddev << "]us";
   return result;
 }
 
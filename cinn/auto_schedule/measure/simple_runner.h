@@ -14,17 +14,41 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_set>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/instruction.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+// The config to decide how many times a candidate should be run
+struct AdaptiveRepeatConfig {
+  // The times of running before measurement to warm up caches and lazy initialization
+  int warmup_times = 1;
+  // The minimum times of running before checking whether to stop early
+  int min_repeat_times = 3;
+  // Stop once the half width of the 95% confidence interval of the mean cost
+  // is smaller than this ratio of the mean, 0 means never
+  double max_relative_ci = 0.05;
+  // Stop once the lower bound of the confidence interval is larger than
+  // the best cost of the task multiplied by this ratio, 0 means never
+  double slow_cutoff_ratio = 1.2;
+  // Flush the caches of the host CPU before every run on x86, so that a candidate
+  // isn't favored by the data its former runs left in the caches
+  bool flush_cpu_cache = true;
+  // Pin the measuring thread to the core it runs on during the measurement on x86,
+  // the workers of the host thread pool are pinned by CINN_THREAD_AFFINITY
+  bool pin_cpu_thread = true;
+};
+
 // This class utilize the built instructions to execute the generated
 // kernels and count the elapsed time as the measurement of performance
 class SimpleRunner : public ScheduleRunner {
  public:
-  SimpleRunner(int repeat_times);
+  // Run a candidate at most repeat_times times
+  SimpleRunner(int repeat_times, const AdaptiveRepeatConfig& config = AdaptiveRepeatConfig());
 
   MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
 
@@ -34,10 +58,18 @@ class SimpleRunner : public ScheduleRunner {
                                                       hlir::framework::Scope* temp_scope);
 
  private:
-  // The repeat times of running instructions,
+  // The max repeat times of running instructions,
   // this runner will return the average time
   const int repeat_times_;
+  const AdaptiveRepeatConfig config_;
 };
 
+// Initialize a tensor with 0 if init_with_zero == true, otherwise initialize the tensor with random value.
+void InitTensorData(hlir::framework::Tensor tensor, const common::Target& target, bool init_with_zero);
+
+// Find all parameter names in the task corresponding to the MeasureInput
+// that need to be initialized to 0 when measuring.
+std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput& input);
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -135,5 +135,38 @@ TEST_F(TestSimpleRunner, TimeMeasured) {
   ASSERT_GE(measure_result.elapsed_time, 200);
 }
 
+TEST_F(TestSimpleRunner, AdaptiveRepeat) {
+  void (*sleep_fn)(void*, int32_t) = [](void*, int32_t) -> void {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  };
+  BuildResult build_result;
+  build_result.compiled_scope = nullptr;
+  std::vector<std::unique_ptr<Instruction>> instructions;
+  instructions.emplace_back(
+      new Instruction(common::DefaultHostTarget(), nullptr, {}, {"empty_placeholder"}, "sleep_fn"));
+  instructions.back()->SetLoweredFunc(reinterpret_cast<void*>(sleep_fn));
+  instructions.back()->Finalize();
+  build_result.runtime_program.reset(new hlir::framework::Program(nullptr, std::move(instructions)));
+
+  std::map<std::string, cinn_pod_value_t> preset_args;
+  preset_args.emplace("empty_placeholder", cinn_pod_value_t());
+  input.execution_args = &preset_args;
+
+  // never stop in advance without a best cost and a confidence threshold
+  AdaptiveRepeatConfig config;
+  config.max_relative_ci       = 0.0;
+  auto runner                  = std::make_unique<SimpleRunner>(10, config);
+  MeasureResult measure_result = runner->Run(input, build_result);
+  ASSERT_EQ(measure_result.num_repeats, 10);
+  ASSERT_GE(measure_result.execution_cost, 100);
+  ASSERT_GE(measure_result.execution_cost_stddev, 0);
+
+  // the candidate is far slower than the best, so it is stopped after the minimum runs
+  input.best_cost = 1.0;
+  measure_result  = runner->Run(input, build_result);
+  ASSERT_EQ(measure_result.num_repeats, config.min_repeat_times);
+  ASSERT_GE(measure_result.execution_cost, 100);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
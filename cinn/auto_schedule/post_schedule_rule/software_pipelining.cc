@@ -0,0 +1,95 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/post_schedule_rule/software_pipelining.h"
+
+#include <glog/logging.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+std::set<std::string> FindCacheReadBlocks(const ir::ScheduleDesc& trace,
+                                          const std::string& memory_type,
+                                          const std::string& block_name) {
+  auto get_name = [](const ir::Expr& block) {
+    return block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+  };
+  std::set<std::string> block_names;
+  for (auto&& step : trace.Steps()) {
+    if (step.type != "CacheRead" || absl::get<std::string>(step.attrs.at("memory_type")) != memory_type) {
+      continue;
+    }
+    if (block_name.empty() || get_name(step.inputs.at("block").at(0)) == block_name) {
+      block_names.insert(get_name(step.outputs.at(0)));
+    }
+  }
+  return block_names;
+}
+
+bool PipelineCacheBlocks(ir::IRSchedule* schedule, const std::set<std::string>& cache_block_names, int num_stages) {
+  bool applied = false;
+  for (auto&& cache_block_name : cache_block_names) {
+    if (!schedule->HasBlock(cache_block_name)) {
+      continue;
+    }
+    auto* cache_block =
+        schedule->GetBlock(cache_block_name).As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+    if (cache_block->attrs.count(ir::attr::software_pipeline_stages)) {
+      continue;
+    }
+
+    // the loop to pipeline is the innermost one containing the blocks computing on the cache
+    ir::Expr target_loop;
+    std::vector<ir::Expr> loops = schedule->GetLoops(cache_block_name);
+    for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+      auto consumers = ir::CollectIRNodesWithoutTensor(*it, [&](const Expr* x) {
+        return x->As<ir::ScheduleBlockRealize>() &&
+               !cache_block_names.count(
+                   x->As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+      });
+      if (!consumers.empty()) {
+        target_loop = *it;
+        break;
+      }
+    }
+    if (!target_loop.defined()) {
+      continue;
+    }
+    auto* for_node = target_loop.As<ir::For>();
+    if (!for_node->is_serial() || !for_node->extent.is_constant() || for_node->extent.as_int32() < num_stages) {
+      VLOG(6) << "Can't pipeline the loop of " << cache_block_name << ":\n" << target_loop;
+      continue;
+    }
+    schedule->SoftwarePipeline(target_loop, num_stages);
+    applied = true;
+  }
+  return applied;
+}
+
+bool SoftwarePipelining::Apply(ir::IRSchedule* schedule) {
+  return PipelineCacheBlocks(schedule, FindCacheReadBlocks(schedule->GetTraceDesc(), "shared"), num_stages_);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
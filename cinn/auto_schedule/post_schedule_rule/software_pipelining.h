@@ -0,0 +1,52 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "cinn/auto_schedule/post_schedule_rule/post_schedule_rule.h"
+#include "cinn/ir/schedule_desc.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// The names of the cache blocks created by CacheRead into the memory_type in the trace, only those reading for the
+// block_name if it is not empty.
+std::set<std::string> FindCacheReadBlocks(const ir::ScheduleDesc& trace,
+                                          const std::string& memory_type,
+                                          const std::string& block_name = "");
+
+// Pipeline the loads of the cache blocks with the computation in the innermost loop containing their consumers, the
+// blocks already pipelined or whose loop can't be pipelined are skipped. Returns whether any loop is pipelined.
+bool PipelineCacheBlocks(ir::IRSchedule* schedule, const std::set<std::string>& cache_block_names, int num_stages);
+
+/*
+ * @brief Pipeline the loads of the shared cache blocks with the computation in their loop.
+ * The shared buffers are rotated in num_stages copies, so that the global memory latency of the following iterations
+ * overlaps with the computation of the current one. It should be applied after CooperativeProcess.
+ */
+class SoftwarePipelining : public PostScheduleRule {
+ public:
+  explicit SoftwarePipelining(int num_stages = 2) : num_stages_(num_stages) {}
+
+  bool Apply(ir::IRSchedule* schedule) final;
+
+ private:
+  int num_stages_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/post_schedule_rule/software_pipelining.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/auto_schedule/post_schedule_rule/cooperative_process.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/test_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "tests/program_builder.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+class TestSoftwarePipelining : public TestAutoGenRuleBase {
+ public:
+  int fixed_rand_seed = 1;
+  std::vector<std::string> default_input_names;
+  std::vector<std::string> default_output_names;
+};
+
+TEST_F(TestSoftwarePipelining, Matmul) {
+  default_input_names            = {"X", "Y"};
+  default_output_names           = {"temp_matmul_out"};
+  std::vector<int32_t> X_shape   = {32, 32};
+  std::vector<int32_t> Y_shape   = {32, 32};
+  std::vector<int32_t> out_shape = {32, 32};
+
+  Initialize(common::DefaultNVGPUTarget());
+  frontend::Program matmul_op = tests::OpBuilder("matmul").Build({{"X", X_shape}, {"Y", Y_shape}});
+  ir::IRSchedule ir_schedule  = MakeIRSchedule(matmul_op, fixed_rand_seed);
+
+  // tile as "SSRRS" and bind: i0_j0 -> blockIdx.x, i1_j1 -> threadIdx.x, then k0, k1, j2, i2
+  std::vector<ir::Expr> loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Split(loops[2], {8, -1});
+  ir_schedule.Split(loops[1], {2, 2, -1});
+  ir_schedule.Split(loops[0], {2, 8, -1});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Reorder({loops[0], loops[3], loops[1], loops[4], loops[6], loops[7], loops[2], loops[5]});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Fuse({loops[2], loops[3]});
+  ir_schedule.Fuse({loops[0], loops[1]});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Bind(loops[1], "threadIdx.x");
+  ir_schedule.Bind(loops[0], "blockIdx.x");
+
+  // cache both inputs in shared memory under the loop k0
+  std::vector<std::string> cache_block_names;
+  for (int read_buffer_index : {1, 2}) {
+    ir::Expr cache_block = ir_schedule.CacheRead(ir_schedule.GetBlock("temp_matmul_out"), read_buffer_index, "shared");
+    cache_block_names.push_back(
+        cache_block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+    loops = ir_schedule.GetLoops("temp_matmul_out");
+    ir_schedule.ComputeAt(cache_block, loops[2]);
+    std::vector<ir::Expr> cache_loops = ir_schedule.GetLoops(cache_block_names.back());
+    ir_schedule.Fuse({cache_loops[3], cache_loops[4]});
+    ir_schedule.Annotate(ir_schedule.GetBlock(cache_block_names.back()), ir::attr::cooperative_process, 0);
+  }
+
+  CooperativeProcess cooperative_process;
+  cooperative_process.Apply(&ir_schedule);
+  SoftwarePipelining software_pipelining(2);
+  ASSERT_TRUE(software_pipelining.Apply(&ir_schedule));
+  VLOG(6) << "after SoftwarePipelining, ir: \n" << GetIR(ir_schedule);
+
+  // the cache blocks are annotated, and the loop is pipelined when lowering
+  for (auto&& name : cache_block_names) {
+    ir::Expr cache_block = ir_schedule.GetBlock(name);
+    auto& attrs          = cache_block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->attrs;
+    ASSERT_EQ(absl::get<int>(attrs.at(ir::attr::software_pipeline_stages)), 2);
+  }
+  // the rule is not applied twice
+  ASSERT_FALSE(software_pipelining.Apply(&ir_schedule));
+
+  auto ir_module   = BuildIRModule(ir_schedule);
+  auto source_code = GenSourceCode(ir_module);
+  VLOG(6) << "scheduled source code:\n" << source_code;
+  ASSERT_NE(source_code.find("cinn_cp_async_4"), std::string::npos);
+  ASSERT_NE(source_code.find("cinn_cp_async_wait"), std::string::npos);
+
+  // execute and check precision
+  CheckResult(
+      GenExecutableKernel(ir_module),
+      GenExecutableKernel(BuildIRModule(MakeIRSchedule(matmul_op, fixed_rand_seed, /* apply_manual_schedule*/ true))),
+      default_input_names,
+      default_output_names,
+      {X_shape, Y_shape},
+      {out_shape},
+      target_);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
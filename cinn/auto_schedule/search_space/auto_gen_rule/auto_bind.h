@@ -24,6 +24,12 @@
 namespace cinn {
 namespace auto_schedule {
 
+// Whether the serial loop isn't used by any reduce axis of the blocks in it
+bool IsSpatialLoop(const ir::For* for_node);
+
+// Count the number of perfectly nested spatial loops that can be binded from the input for_node to bottom
+int CountLoopCanBinded(const ir::For* for_node);
+
 // Auto bind GPU index(BlockIdx, ThreadIdx) to the loops around the block
 class AutoBind : public AutoGenRule {
  public:
@@ -0,0 +1,110 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_bind.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+const std::vector<int> AutoParallel::kVectorizeFactors = {1, 4, 8, 16};
+
+// the parallel loop is split into several tasks per core, so that the cores finishing early balance the others
+static constexpr int kTasksPerCore = 4;
+
+bool AutoParallel::MeetCondition(const ir::IRSchedule& ir_schedule, const Expr& block_expr) const {
+  if (!target_->is_cpu()) return false;
+  auto all_loops = ir_schedule.GetLoops(block_expr);
+  for (auto& loop : all_loops) {
+    // the nested parallel loops are not supported by the host runtime
+    if (loop.As<ir::For>()->is_parallel()) return false;
+  }
+  return !all_loops.empty() && CountLoopCanBinded(all_loops[0].As<ir::For>()) > 0;
+}
+
+void AutoParallel::ParallelizeAndVectorize(ir::IRSchedule* ir_schedule, const std::string& block_name) const {
+  auto all_loops    = ir_schedule->GetLoops(block_name);
+  int vector_factor = kVectorizeFactors[std::rand() % kVectorizeFactors.size()];
+  auto* inner_loop  = all_loops.back().As<ir::For>();
+  int inner_extent  = inner_loop->extent.as_int32();
+  if (vector_factor > 1 && IsSpatialLoop(inner_loop) && inner_extent > vector_factor &&
+      inner_extent % vector_factor == 0) {
+    auto splits = ir_schedule->Split(all_loops.back(), {-1, vector_factor});
+    ir_schedule->Vectorize(splits[1], vector_factor);
+    all_loops = ir_schedule->GetLoops(block_name);
+  }
+
+  // fuse the outer spatial loops until all the cores are busy, the runtime gives each core a contiguous range of the
+  // fused loop
+  int num_loops_can_fuse = CountLoopCanBinded(all_loops[0].As<ir::For>());
+  int min_tasks          = target_->cpu_info().num_cores * kTasksPerCore;
+  int num_loops_to_fuse  = 0;
+  int64_t extent         = 1;
+  while (num_loops_to_fuse < num_loops_can_fuse && extent < min_tasks) {
+    extent *= all_loops[num_loops_to_fuse].As<ir::For>()->extent.as_int32();
+    ++num_loops_to_fuse;
+  }
+  Expr fused_loop = num_loops_to_fuse > 1
+                        ? ir_schedule->Fuse({all_loops.begin(), all_loops.begin() + num_loops_to_fuse})
+                        : all_loops[0];
+  ir_schedule->Parallel(fused_loop);
+  VLOG(6) << "AutoParallel fuses " << num_loops_to_fuse << " loops of " << block_name << " into a parallel loop of "
+          << extent << " iterations, and vectorizes the innermost loop by " << vector_factor;
+}
+
+RuleApplyType AutoParallel::Init(ir::IRSchedule* ir_schedule) {
+  ir_schedule_ = ir_schedule;
+  applicable_block_names_.clear();
+  for (auto&& block_realize : ir_schedule->GetAllBlocks()) {
+    if (MeetCondition(*ir_schedule, block_realize)) {
+      applicable_block_names_.emplace_back(
+          block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+    }
+  }
+  num_applicable_ = applicable_block_names_.size();
+  VLOG(6) << "Collect applicable_block_names_:" << num_applicable_;
+  return num_applicable_ > 0 ? RuleApplyType::kApplyAndPruneOtherRules : RuleApplyType::kCannotApply;
+}
+
+void AutoParallel::Apply(int index) {
+  CHECK_LT(index, applicable_block_names_.size()) << "invalid apply index:" << index;
+  const auto& block_name = applicable_block_names_.at(index);
+  // the blocks sharing the loops parallelized by a former one are skipped
+  if (MeetCondition(*ir_schedule_, ir_schedule_->GetBlock(block_name))) {
+    ParallelizeAndVectorize(ir_schedule_, block_name);
+  }
+}
+
+RuleApplyType AutoParallel::AnalyseApplyType(SearchState state, const std::string& block_name) const {
+  Expr block_expr = state->ir_schedule.GetBlock(block_name);
+  return MeetCondition(state->ir_schedule, block_expr) ? RuleApplyType::kApplyAndPruneOtherRules
+                                                       : RuleApplyType::kCannotApply;
+}
+
+std::vector<SearchState> AutoParallel::ApplyOnBlock(SearchState state, const std::string& block_name) {
+  SearchState new_state = state.Copy();
+  ParallelizeAndVectorize(&new_state->ir_schedule, block_name);
+  return {new_state};
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// The CPU counterpart of AutoBind. It fuses the outer spatial loops around the block until there are a few
+// iterations for each core of the host CPU and marks the fused loop parallel, and vectorizes the innermost spatial
+// loop by a factor sampled from kVectorizeFactors, 1 means not to vectorize.
+class AutoParallel : public AutoGenRule {
+ public:
+  static const std::vector<int> kVectorizeFactors;
+
+  AutoParallel(const common::Target& target) : AutoGenRule(target) {}
+  ~AutoParallel() = default;
+
+  RuleApplyType Init(ir::IRSchedule* init_schedule) override;
+
+  void Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AutoParallel"; }
+
+  RuleApplyType AnalyseApplyType(SearchState state, const std::string& block_name) const override;
+
+  std::vector<SearchState> ApplyOnBlock(SearchState state, const std::string& block_name) override;
+
+ private:
+  bool MeetCondition(const ir::IRSchedule& ir_schedule, const Expr& block_expr) const;
+
+  void ParallelizeAndVectorize(ir::IRSchedule* ir_schedule, const std::string& block_name) const;
+
+ private:
+  std::vector<std::string> applicable_block_names_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoParallel, ApplyOnMatmul) {
+  using namespace ir;
+  srand(0);
+  Context::Global().ResetNameId();
+
+  Expr M(256);
+  Expr N(64);
+  Expr K(32);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  Target target = common::DefaultHostTarget();
+  auto stages   = CreateStages({C});
+  auto funcs    = cinn::lang::LowerVec("test_auto_parallel", stages, {A, B, C}, {}, {}, nullptr, target, true);
+
+  ir::IRSchedule ir_schedule(ir::ModuleExpr({funcs[0]->body}));
+  SearchState state(ir_schedule, 0, {});
+  AutoParallel test_rule(target);
+  ASSERT_EQ(test_rule.AnalyseApplyType(state, "C"), RuleApplyType::kApplyAndPruneOtherRules);
+  auto new_states = test_rule.ApplyOnBlock(state, "C");
+  ASSERT_EQ(new_states.size(), 1UL);
+  VLOG(6) << "After AutoParallel:\n" << new_states[0]->ir_schedule.GetModule().GetExprs().front();
+
+  // only the spatial loops are parallelized, the reduce loop stays serial
+  auto loops = new_states[0]->ir_schedule.GetLoops("C");
+  ASSERT_TRUE(loops.front().As<ir::For>()->is_parallel());
+  for (size_t i = 1; i < loops.size(); ++i) {
+    ASSERT_FALSE(loops[i].As<ir::For>()->is_parallel());
+    if (loops[i].As<ir::For>()->loop_var->name.find("k0") != std::string::npos) {
+      ASSERT_TRUE(loops[i].As<ir::For>()->is_serial());
+    }
+  }
+  // no loop is parallelized twice
+  ASSERT_EQ(test_rule.AnalyseApplyType(new_states[0], "C"), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoParallel, OnlyOnX86) {
+  using namespace ir;
+  Context::Global().ResetNameId();
+
+  Expr M(64);
+  Expr N(64);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + 1.f; }, "B");
+
+  Target target = common::DefaultHostTarget();
+  auto stages   = CreateStages({B});
+  auto funcs    = cinn::lang::LowerVec("test_auto_parallel_target", stages, {A, B}, {}, {}, nullptr, target, true);
+
+  ir::IRSchedule ir_schedule(ir::ModuleExpr({funcs[0]->body}));
+  ASSERT_EQ(AutoParallel(target).Init(&ir_schedule), RuleApplyType::kApplyAndPruneOtherRules);
+  ASSERT_EQ(AutoParallel(common::DefaultNVGPUTarget()).Init(&ir_schedule), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
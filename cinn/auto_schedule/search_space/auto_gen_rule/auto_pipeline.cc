@@ -0,0 +1,89 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_pipeline.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+#include "cinn/auto_schedule/post_schedule_rule/software_pipelining.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+const std::vector<int> AutoPipeline::kNumStagesOptions = {2, 3};
+
+std::set<std::string> AutoPipeline::GetCacheBlocks(const ir::IRSchedule& ir_schedule,
+                                                   const std::string& block_name) const {
+  std::set<std::string> cache_block_names;
+  if (target_->arch != common::Target::Arch::NVGPU) {
+    return cache_block_names;
+  }
+  for (auto&& memory_type : {"shared", "local"}) {
+    for (auto&& name : FindCacheReadBlocks(ir_schedule.GetTraceDesc(), memory_type, block_name)) {
+      if (!ir_schedule.HasBlock(name)) {
+        continue;
+      }
+      auto* cache_block =
+          ir_schedule.GetBlock(name).As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+      if (!cache_block->attrs.count(ir::attr::software_pipeline_stages)) {
+        cache_block_names.insert(name);
+      }
+    }
+  }
+  return cache_block_names;
+}
+
+void AutoPipeline::ApplyPipeline(ir::IRSchedule* ir_schedule, const std::string& block_name) const {
+  int num_stages = kNumStagesOptions[std::rand() % kNumStagesOptions.size()];
+  bool applied   = PipelineCacheBlocks(ir_schedule, GetCacheBlocks(*ir_schedule, block_name), num_stages);
+  VLOG(6) << "Pipeline the cache blocks of " << block_name << " with " << num_stages << " stages: " << applied;
+}
+
+RuleApplyType AutoPipeline::Init(ir::IRSchedule* ir_schedule) {
+  ir_schedule_ = ir_schedule;
+  applicable_block_names_.clear();
+  for (auto&& block_realize : ir_schedule_->GetAllBlocks()) {
+    const std::string& block_name =
+        block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+    if (!GetCacheBlocks(*ir_schedule_, block_name).empty()) {
+      applicable_block_names_.push_back(block_name);
+    }
+  }
+  num_applicable_ = applicable_block_names_.size();
+  VLOG(6) << "Collect applicable blocks of AutoPipeline:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+void AutoPipeline::Apply(int index) {
+  CHECK_LT(index, applicable_block_names_.size()) << "invalid apply index:" << index;
+  ApplyPipeline(ir_schedule_, applicable_block_names_.at(index));
+}
+
+RuleApplyType AutoPipeline::AnalyseApplyType(SearchState state, const std::string& block_name) const {
+  return GetCacheBlocks(state->ir_schedule, block_name).empty() ? RuleApplyType::kCannotApply : RuleApplyType::kApply;
+}
+
+std::vector<SearchState> AutoPipeline::ApplyOnBlock(SearchState state, const std::string& block_name) {
+  SearchState new_state = state.Copy();
+  ApplyPipeline(&new_state->ir_schedule, block_name);
+  return {new_state};
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Pipeline the loads of the cache blocks read by a block with the computation on them by IRSchedule::SoftwarePipeline.
+ *
+ * The shared cache blocks are pipelined in the loop over the reduce axis containing their consumer, and the local
+ * ones, which load the register fragments from the shared buffers, in the inner loop. The number of stages is sampled
+ * from kNumStagesOptions, and the original state is kept since the extra buffers may lower the occupancy. It is only
+ * applied on NVGPU to the blocks whose cache reads are not pipelined yet.
+ */
+class AutoPipeline : public AutoGenRule {
+ public:
+  // the candidates of the number of stages, 2 for double buffering and 3 for triple buffering
+  static const std::vector<int> kNumStagesOptions;
+
+  AutoPipeline(const common::Target& target) : AutoGenRule(target) {}
+  ~AutoPipeline() = default;
+
+  RuleApplyType Init(ir::IRSchedule* init_schedule) override;
+
+  void Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AutoPipeline"; }
+
+  RuleApplyType AnalyseApplyType(SearchState state, const std::string& block_name) const override;
+
+  std::vector<SearchState> ApplyOnBlock(SearchState state, const std::string& block_name) override;
+
+ private:
+  // The cache blocks read by the block and not pipelined yet
+  std::set<std::string> GetCacheBlocks(const ir::IRSchedule& ir_schedule, const std::string& block_name) const;
+
+  void ApplyPipeline(ir::IRSchedule* ir_schedule, const std::string& block_name) const;
+
+ private:
+  std::vector<std::string> applicable_block_names_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_pipeline.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/test_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "tests/program_builder.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+class TestAutoPipeline : public TestAutoGenRuleBase {
+ public:
+  int fixed_rand_seed = 1;
+  std::vector<std::string> default_input_names;
+  std::vector<std::string> default_output_names;
+};
+
+TEST_F(TestAutoPipeline, Matmul) {
+  default_input_names          = {"X", "Y"};
+  default_output_names         = {"temp_matmul_out"};
+  std::vector<int32_t> X_shape = {32, 32};
+  std::vector<int32_t> Y_shape = {32, 32};
+
+  Initialize(common::DefaultNVGPUTarget());
+  frontend::Program matmul_op = tests::OpBuilder("matmul").Build({{"X", X_shape}, {"Y", Y_shape}});
+  ir::IRSchedule ir_schedule  = MakeIRSchedule(matmul_op, fixed_rand_seed);
+
+  // tile as "SSRRS" and bind: i0_j0 -> blockIdx.x, i1_j1 -> threadIdx.x, then k0, k1, j2, i2
+  std::vector<ir::Expr> loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Split(loops[2], {8, -1});
+  ir_schedule.Split(loops[1], {2, 2, -1});
+  ir_schedule.Split(loops[0], {2, 8, -1});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Reorder({loops[0], loops[3], loops[1], loops[4], loops[6], loops[7], loops[2], loops[5]});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Fuse({loops[2], loops[3]});
+  ir_schedule.Fuse({loops[0], loops[1]});
+  loops = ir_schedule.GetLoops("temp_matmul_out");
+  ir_schedule.Bind(loops[1], "threadIdx.x");
+  ir_schedule.Bind(loops[0], "blockIdx.x");
+
+  SearchState state(ir_schedule);
+  AutoPipeline auto_pipeline(target_);
+  // no cache block to pipeline
+  EXPECT_EQ(auto_pipeline.AnalyseApplyType(state, default_output_names[0]), RuleApplyType::kCannotApply);
+
+  // cache both inputs in shared memory under the loop k0
+  std::vector<std::string> cache_block_names;
+  for (int read_buffer_index : {1, 2}) {
+    ir::Expr cache_block =
+        state->ir_schedule.CacheRead(state->ir_schedule.GetBlock("temp_matmul_out"), read_buffer_index, "shared");
+    cache_block_names.push_back(
+        cache_block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+    loops = state->ir_schedule.GetLoops("temp_matmul_out");
+    state->ir_schedule.ComputeAt(cache_block, loops[2]);
+  }
+  EXPECT_EQ(auto_pipeline.AnalyseApplyType(state, default_output_names[0]), RuleApplyType::kApply);
+  auto new_states = auto_pipeline.ApplyOnBlock(state, default_output_names[0]);
+  ASSERT_EQ(new_states.size(), 1UL);
+  VLOG(6) << "After AutoPipeline, state:\n" << new_states[0]->DebugString();
+
+  // the cache blocks are annotated with the sampled number of stages, and the original state is kept
+  int num_stages = -1;
+  for (auto&& name : cache_block_names) {
+    auto& attrs = new_states[0]
+                      ->ir_schedule.GetBlock(name)
+                      .As<ir::ScheduleBlockRealize>()
+                      ->schedule_block.As<ir::ScheduleBlock>()
+                      ->attrs;
+    ASSERT_TRUE(attrs.count(ir::attr::software_pipeline_stages));
+    num_stages = absl::get<int>(attrs.at(ir::attr::software_pipeline_stages));
+    ASSERT_NE(std::find(AutoPipeline::kNumStagesOptions.begin(), AutoPipeline::kNumStagesOptions.end(), num_stages),
+              AutoPipeline::kNumStagesOptions.end());
+    auto& origin_attrs =
+        state->ir_schedule.GetBlock(name).As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->attrs;
+    ASSERT_FALSE(origin_attrs.count(ir::attr::software_pipeline_stages));
+  }
+  // the pipelined blocks are not applied twice
+  EXPECT_EQ(auto_pipeline.AnalyseApplyType(new_states[0], default_output_names[0]), RuleApplyType::kCannotApply);
+
+  // the pipelining is recorded in the trace
+  ASSERT_EQ(new_states[0]->ir_schedule.GetTraceDesc().Steps().back().type, "SoftwarePipeline");
+}
+
+TEST_F(TestAutoPipeline, NotApplyOnHost) {
+  default_input_names          = {"X", "Y"};
+  default_output_names         = {"temp_matmul_out"};
+  std::vector<int32_t> X_shape = {32, 32};
+  std::vector<int32_t> Y_shape = {32, 32};
+
+  Initialize(common::DefaultHostTarget());
+  frontend::Program matmul_op = tests::OpBuilder("matmul").Build({{"X", X_shape}, {"Y", Y_shape}});
+  ir::IRSchedule ir_schedule  = MakeIRSchedule(matmul_op, fixed_rand_seed);
+  ir_schedule.CacheRead(ir_schedule.GetBlock("temp_matmul_out"), 1, "local");
+
+  AutoPipeline auto_pipeline(target_);
+  EXPECT_EQ(auto_pipeline.Init(&ir_schedule), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -26,7 +26,7 @@
 namespace cinn {
 namespace auto_schedule {
 
-static std::vector<int> auto_unroll_options = {0, 8, 32, 128};
+const std::vector<int> AutoUnroll::kMaxStepOptions = {0, 8, 32, 128};
 
 bool AutoUnroll::MeetCondition(const ir::ScheduleBlock* schedule_block) const {
   // whether any block has reduce iter
@@ -90,7 +90,7 @@ RuleApplyType AutoUnroll::Init(ir::IRSchedule* ir_schedule) {
 void AutoUnroll::Apply(int index) {
   CHECK_LT(index, applicable_schedule_blocks_.size()) << "invalid apply index:" << index;
   auto applied_block = applicable_schedule_blocks_.at(index);
-  int max_step       = auto_unroll_options[std::rand() % auto_unroll_options.size()];
+  int max_step       = kMaxStepOptions[std::rand() % kMaxStepOptions.size()];
   ir_schedule_->Annotate(applied_block, ir::attr::auto_unroll_max_step, max_step);
   return;
 }
@@ -110,7 +110,7 @@ std::vector<SearchState> AutoUnroll::ApplyOnBlock(SearchState state, const std::
   SearchState new_state = state.Copy();
   Expr block_expr       = new_state->ir_schedule.GetBlock(block_name);
   Expr applied_block    = new_state->ir_schedule.GetRootBlock(block_expr);
-  int max_step          = auto_unroll_options[std::rand() % auto_unroll_options.size()];
+  int max_step          = kMaxStepOptions[std::rand() % kMaxStepOptions.size()];
   new_state->ir_schedule.Annotate(applied_block, ir::attr::auto_unroll_max_step, max_step);
 
   return {new_state};
@@ -30,6 +30,9 @@ namespace auto_schedule {
 // will do unroll based on actual situation.
 class AutoUnroll : public AutoGenRule {
  public:
+  // the candidates of the max permitted unrolled step
+  static const std::vector<int> kMaxStepOptions;
+
   AutoUnroll(const common::Target& target) : AutoGenRule(target) {}
   ~AutoUnroll() = default;
 
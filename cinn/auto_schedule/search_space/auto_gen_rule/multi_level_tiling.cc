@@ -345,6 +345,9 @@ void MultiLevelTiling::ApplyCacheRead(ir::IRSchedule* ir_schedule, ir::Expr& blo
 }
 
 void MultiLevelTiling::ApplyCacheWrite(ir::IRSchedule* ir_schedule, ir::Expr& block_expr) {
+  if (config_.write_cache_levels.empty()) {
+    return;
+  }
   ir::Expr cache_block = ir_schedule->CacheWrite(block_expr, 0, config_.write_cache_memory_type);
 
   for (int level : config_.write_cache_levels) {
@@ -387,14 +390,26 @@ const std::unordered_map<common::Target::Arch, MultiLevelTiling::Config> MultiLe
          /*write_cache_memory_type*/ std::string("local"),
          /*write_cache_levels*/ std::vector<int>{3},
      }},
+    // the local buffers are allocated once for a host function, which the tasks of the parallel loops can't share,
+    // so the tiles on x86 are computed in place and the outer spatial tiles are parallelized by AutoParallel
     {common::Target::Arch::X86,
      MultiLevelTiling::Config{
          /*bind_axis*/ std::vector<std::string>{},
          /*tile_struct*/ std::string("SSRSRS"),
          /*read_cache_memory_type*/ std::string("local"),
-         /*read_cache_levels*/ std::vector<int>{3},
+         /*read_cache_levels*/ std::vector<int>{},
+         /*write_cache_memory_type*/ std::string("local"),
+         /*write_cache_levels*/ std::vector<int>{},
+     }},
+    // the same as x86, the ARM cores share the host runtime
+    {common::Target::Arch::ARM,
+     MultiLevelTiling::Config{
+         /*bind_axis*/ std::vector<std::string>{},
+         /*tile_struct*/ std::string("SSRSRS"),
+         /*read_cache_memory_type*/ std::string("local"),
+         /*read_cache_levels*/ std::vector<int>{},
          /*write_cache_memory_type*/ std::string("local"),
-         /*write_cache_levels*/ std::vector<int>{2},
+         /*write_cache_levels*/ std::vector<int>{},
      }}};
 
 }  // namespace auto_schedule
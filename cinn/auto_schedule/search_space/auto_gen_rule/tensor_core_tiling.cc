@@ -0,0 +1,127 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/tensor_core_tiling.h"
+
+#include <glog/logging.h>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/ir_schedule_util.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+bool TensorCoreTiling::MeetCondition(const ir::IRSchedule& ir_schedule, const Expr& block_realize) const {
+  if (target_->arch != common::Target::Arch::NVGPU) return false;
+  auto* schedule_block = block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+  CHECK(schedule_block) << "schedule_block field is not a ScheduleBlock";
+  if (schedule_block->attrs.count(ir::attr::tensorize_intrin)) return false;
+  // the K dimension is the only reduction
+  int num_reduce_axes = 0;
+  for (auto&& iter_var : schedule_block->iter_vars) {
+    if (iter_var->is_reduce_axis) ++num_reduce_axes;
+  }
+  if (num_reduce_axes != 1) return false;
+
+  ir::MatmulBlockPattern pattern;
+  if (!ir::MatchMatmulBlock(block_realize, &pattern) || ir::GetMatmulTensorizeIntrin(pattern).empty()) {
+    return false;
+  }
+  // the M, N and K loops should be the innermost loops in order, and all the loops are serial and start from 0
+  auto all_loops = ir_schedule.GetLoops(block_realize);
+  if (all_loops.size() < 3U) return false;
+  std::vector<Var> pattern_vars = {pattern.m_var, pattern.n_var, pattern.k_var};
+  int num_batch_loops           = all_loops.size() - 3;
+  for (int i = 0; i < all_loops.size(); ++i) {
+    auto* for_node = all_loops[i].As<ir::For>();
+    if (!for_node->is_serial() || !common::is_zero(for_node->min) || !for_node->extent.is_constant()) return false;
+    if (i < num_batch_loops) continue;
+    if (for_node->loop_var->name != pattern_vars[i - num_batch_loops]->name ||
+        for_node->extent.as_int32() % ir::kTensorCoreFragmentSize != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TensorCoreTiling::ApplyTiling(ir::IRSchedule* ir_schedule, const std::string& block_name) const {
+  ir::MatmulBlockPattern pattern;
+  CHECK(ir::MatchMatmulBlock(ir_schedule->GetBlock(block_name), &pattern));
+  std::string intrin_name = ir::GetMatmulTensorizeIntrin(pattern);
+
+  auto all_loops      = ir_schedule->GetLoops(block_name);
+  int num_batch_loops = all_loops.size() - 3;
+  // split from the K loop to the M loop, so the indices of the loops to split keep unchanged
+  for (int i = 2; i >= 0; --i) {
+    all_loops = ir_schedule->GetLoops(block_name);
+    ir_schedule->Split(all_loops[num_batch_loops + i], {-1, ir::kTensorCoreFragmentSize});
+  }
+  // reorder the loops from (mo, mi, no, ni, ko, ki) to (mo, no, ko, mi, ni, ki)
+  all_loops = ir_schedule->GetLoops(block_name);
+  std::vector<Expr> reordered_loops;
+  for (int i : {0, 2, 4, 1, 3, 5}) {
+    reordered_loops.emplace_back(all_loops[num_batch_loops + i]);
+  }
+  ir_schedule->Reorder(reordered_loops);
+
+  all_loops = ir_schedule->GetLoops(block_name);
+  ir_schedule->Tensorize(all_loops[num_batch_loops + 3], intrin_name);
+  VLOG(6) << "After Tensorize in TensorCoreTiling, block " << block_name << " is computed by " << intrin_name;
+
+  // each thread block computes a tile of the output
+  all_loops = ir_schedule->GetLoops(block_name);
+  ir_schedule->Bind(all_loops[num_batch_loops + 1], "blockIdx.y");
+  all_loops         = ir_schedule->GetLoops(block_name);
+  Expr block_x_loop = all_loops[num_batch_loops];
+  if (num_batch_loops > 0) {
+    block_x_loop = ir_schedule->Fuse({all_loops.begin(), all_loops.begin() + num_batch_loops + 1});
+  }
+  ir_schedule->Bind(block_x_loop, "blockIdx.x");
+}
+
+RuleApplyType TensorCoreTiling::Init(ir::IRSchedule* ir_schedule) {
+  ir_schedule_ = ir_schedule;
+  applicable_schedule_blocks_.clear();
+  for (auto&& block_realize : ir_schedule->GetAllBlocks()) {
+    if (MeetCondition(*ir_schedule, block_realize)) {
+      applicable_schedule_blocks_.emplace_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_schedule_blocks_.size();
+  VLOG(6) << "Collect applicable_schedule_blocks_:" << num_applicable_;
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+void TensorCoreTiling::Apply(int index) {
+  CHECK_LT(index, applicable_schedule_blocks_.size()) << "invalid apply index:" << index;
+  auto applied_block = applicable_schedule_blocks_.at(index);
+  ApplyTiling(ir_schedule_,
+              applied_block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+}
+
+RuleApplyType TensorCoreTiling::AnalyseApplyType(SearchState state, const std::string& block_name) const {
+  Expr block_expr = state->ir_schedule.GetBlock(block_name);
+  return MeetCondition(state->ir_schedule, block_expr) ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+std::vector<SearchState> TensorCoreTiling::ApplyOnBlock(SearchState state, const std::string& block_name) {
+  SearchState new_state = state.Copy();
+  ApplyTiling(&new_state->ir_schedule, block_name);
+  return {new_state};
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
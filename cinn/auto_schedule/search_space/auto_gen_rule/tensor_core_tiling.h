@@ -0,0 +1,60 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Tile a matmul-like block to the fragments of tensor core and compute each fragment by a tensor core intrinsic.
+ *
+ * The M, N and K loops of the block are split by the fragment size, the outer M and N loops are bound to
+ * blockIdx.x and blockIdx.y, and the inner loop nest is tensorized, so each thread block computes a tile of
+ * the output by a warp. It is only applied on NVGPU to the blocks whose inputs are float16 and whose M, N, K
+ * extents are divisible by the fragment size.
+ */
+class TensorCoreTiling : public AutoGenRule {
+ public:
+  TensorCoreTiling(const common::Target& target) : AutoGenRule(target) {}
+  ~TensorCoreTiling() = default;
+
+  RuleApplyType Init(ir::IRSchedule* init_schedule) override;
+
+  void Apply(int index) override;
+
+  std::string GetRuleName() const override { return "TensorCoreTiling"; }
+
+  // Returns true if the block can be computed by tensor core intrinsics
+  bool MeetCondition(const ir::IRSchedule& ir_schedule, const Expr& block_realize) const;
+
+  RuleApplyType AnalyseApplyType(SearchState state, const std::string& block_name) const override;
+
+  std::vector<SearchState> ApplyOnBlock(SearchState state, const std::string& block_name) override;
+
+ private:
+  void ApplyTiling(ir::IRSchedule* ir_schedule, const std::string& block_name) const;
+
+  std::vector<Expr> applicable_schedule_blocks_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,84 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/tensor_core_tiling.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/test_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "tests/program_builder.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+class TestTensorCoreTiling : public TestAutoGenRuleBase {
+ public:
+  std::string applied_block_name = "temp_matmul_out";
+};
+
+TEST_F(TestTensorCoreTiling, AnalyseApplyType) {
+  Initialize(common::DefaultNVGPUTarget());
+  TensorCoreTiling tensor_core_tiling(target_);
+  // float32 is not supported by the tensor core intrinsics
+  ir::IRSchedule fp32_schedule = MakeIRSchedule(
+      tests::OpBuilder("matmul").Build({{"X", {32, 64}, common::Float(32)}, {"Y", {64, 32}, common::Float(32)}}));
+  SearchState fp32_state(fp32_schedule, 0, {});
+  EXPECT_EQ(tensor_core_tiling.AnalyseApplyType(fp32_state, applied_block_name), RuleApplyType::kCannotApply);
+
+  // the extents should be divisible by the fragment size
+  ir::IRSchedule unaligned_schedule = MakeIRSchedule(
+      tests::OpBuilder("matmul").Build({{"X", {30, 64}, common::Float16()}, {"Y", {64, 32}, common::Float16()}}));
+  SearchState unaligned_state(unaligned_schedule, 0, {});
+  EXPECT_EQ(tensor_core_tiling.AnalyseApplyType(unaligned_state, applied_block_name), RuleApplyType::kCannotApply);
+
+  ir::IRSchedule fp16_schedule = MakeIRSchedule(
+      tests::OpBuilder("matmul").Build({{"X", {32, 64}, common::Float16()}, {"Y", {64, 32}, common::Float16()}}));
+  SearchState fp16_state(fp16_schedule, 0, {});
+  EXPECT_EQ(tensor_core_tiling.AnalyseApplyType(fp16_state, applied_block_name), RuleApplyType::kApply);
+}
+
+TEST_F(TestTensorCoreTiling, ApplyOnBlock) {
+  Initialize(common::DefaultNVGPUTarget());
+  ir::IRSchedule ir_schedule = MakeIRSchedule(
+      tests::OpBuilder("matmul").Build({{"X", {32, 64}, common::Float16()}, {"Y", {64, 48}, common::Float16()}}));
+  SearchState state(ir_schedule, 0, {});
+  VLOG(6) << "Original Expr:\n" << state->ir_schedule.GetModule().GetExprs()[0];
+
+  TensorCoreTiling tensor_core_tiling(target_);
+  auto new_states = tensor_core_tiling.ApplyOnBlock(state, applied_block_name);
+  ASSERT_EQ(new_states.size(), 1UL);
+  auto& result = new_states[0]->ir_schedule;
+  VLOG(6) << "TensorCoreTiling applied Expr:\n" << result.GetModule().GetExprs()[0];
+
+  // (mo, no, ko, lane), where the outer M and N loops are bound to blocks and the lane loop to threads
+  auto all_loops = result.GetLoops(applied_block_name);
+  ASSERT_EQ(all_loops.size(), 4UL);
+  EXPECT_TRUE(all_loops[0].As<ir::For>()->is_gpu_block_binded());
+  EXPECT_EQ(all_loops[0].As<ir::For>()->extent.as_int32(), 2);
+  EXPECT_TRUE(all_loops[1].As<ir::For>()->is_gpu_block_binded());
+  EXPECT_EQ(all_loops[1].As<ir::For>()->extent.as_int32(), 3);
+  EXPECT_EQ(all_loops[2].As<ir::For>()->extent.as_int32(), 4);
+  EXPECT_TRUE(all_loops[3].As<ir::For>()->is_gpu_thread_binded());
+  // the tensorized block can't be tiled again
+  EXPECT_EQ(tensor_core_tiling.AnalyseApplyType(new_states[0], applied_block_name), RuleApplyType::kCannotApply);
+
+  auto source_code = GenSourceCode(BuildIRModule(result));
+  VLOG(6) << "Optimized source code:\n" << source_code;
+  EXPECT_NE(source_code.find("cinn_wmma_m16n16k16_f16f16("), std::string::npos);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
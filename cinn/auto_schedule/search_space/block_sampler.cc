@@ -25,7 +25,8 @@ std::unique_ptr<BlockSampler> BlockSampler::Make(const std::vector<ir::Expr>& al
                                                  bool default_remove_policy,
                                                  const std::string& strategy,
                                                  utils::LinearRandomEngine::StateType rand_seed,
-                                                 const std::vector<int>& weights) {
+                                                 const std::vector<int>& weights,
+                                                 const SamplingPrior* prior) {
   CHECK_GT(all_blocks.size(), 0) << "Empty block list";
   if (strategy == "traversal") {
     VLOG(6) << "Init TraversalBlockSampler with block num = " << all_blocks.size();
@@ -33,6 +34,9 @@ std::unique_ptr<BlockSampler> BlockSampler::Make(const std::vector<ir::Expr>& al
   } else if (strategy == "probabilistic") {
     VLOG(6) << "Init ProbabilisticBlockSampler with block num = " << all_blocks.size();
     return std::make_unique<ProbabilisticBlockSampler>(all_blocks, default_remove_policy, rand_seed, weights);
+  } else if (strategy == "bandit") {
+    VLOG(6) << "Init BanditBlockSampler with block num = " << all_blocks.size();
+    return std::make_unique<BanditBlockSampler>(all_blocks, default_remove_policy, rand_seed, prior);
   }
 
   LOG(FATAL) << "Unimplemented strategy:" << strategy;
@@ -88,5 +92,40 @@ std::string ProbabilisticBlockSampler::NextBlock(bool remove) {
   return all_blocks_.at(block_idx);
 }
 
+BanditBlockSampler::BanditBlockSampler(const std::vector<ir::Expr>& all_blocks,
+                                       bool default_remove_policy,
+                                       utils::LinearRandomEngine::StateType rand_seed,
+                                       const SamplingPrior* prior)
+    : BlockSampler(all_blocks, default_remove_policy),
+      prior_(prior),
+      rand_seed_(utils::LinearRandomEngine::NormalizeState(rand_seed)),
+      removed_(all_blocks.size(), false) {
+  CHECK(prior_) << "BanditBlockSampler needs a SamplingPrior";
+}
+
+std::string BanditBlockSampler::NextBlock(bool remove) {
+  int block_idx     = -1;
+  double best_score = 0.0;
+  for (int i = 0; i < all_blocks_.size(); ++i) {
+    if (removed_[i]) {
+      continue;
+    }
+    double score = prior_->SampleScore(SamplingPrior::BlockArm(all_blocks_[i]), &rand_seed_);
+    if (block_idx < 0 || score > best_score) {
+      block_idx  = i;
+      best_score = score;
+    }
+  }
+  if (block_idx < 0) {
+    VLOG(6) << "[BanditBlockSampler] next block: empty";
+    return "";
+  }
+  if (remove) {
+    removed_[block_idx] = true;
+  }
+  VLOG(6) << "[BanditBlockSampler] next block: " << all_blocks_.at(block_idx);
+  return all_blocks_.at(block_idx);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include <random>
 #include <vector>
 
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/utils/random_engine.h"
 
@@ -34,16 +35,19 @@ class BlockSampler {
    * @param all_blocks All possible blocks to be sampled.
    * @param default_remove_policy The default option to determine whether to delete the next block after selecting it.
    * @param strategy The block sampling strategy.
-   *                 Currently, the available strategies are "traversal" and "probabilistic",
+   *                 Currently, the available strategies are "traversal", "probabilistic" and "bandit",
    *                 where "traversal" means to select blocks one by one until all blocks are traversed,
-   *                 and "probabilistic" means randomly picking blocks according to the given distribution.
+   *                 "probabilistic" means randomly picking blocks according to the given distribution,
+   *                 and "bandit" means picking the block of the best score drawn from the learned prior.
    * @param weights Used for the probabilistic policy, giving each candidate a weight.
+   * @param prior Used for the bandit policy, the rewards learned for the blocks, not owned.
    */
   static std::unique_ptr<BlockSampler> Make(const std::vector<ir::Expr>& all_blocks,
                                             bool default_remove_policy                     = true,
                                             const std::string& strategy                    = "traversal",
                                             utils::LinearRandomEngine::StateType rand_seed = 0,
-                                            const std::vector<int>& weights                = {});
+                                            const std::vector<int>& weights                = {},
+                                            const SamplingPrior* prior                     = nullptr);
 
   // Return the name of sample strategy
   virtual const char* Name() const = 0;
@@ -111,5 +115,27 @@ class ProbabilisticBlockSampler : public BlockSampler {
   int remains_;
 };
 
+// Sample blocks with bandit strategy,
+// which means picking the block of the best score drawn from the rewards learned in the previous rounds.
+class BanditBlockSampler : public BlockSampler {
+ public:
+  BanditBlockSampler(const std::vector<ir::Expr>& all_blocks,
+                     bool default_remove_policy,
+                     utils::LinearRandomEngine::StateType rand_seed,
+                     const SamplingPrior* prior);
+
+  const char* Name() const override { return "bandit"; }
+
+  void Reset() override { removed_.assign(all_blocks_.size(), false); }
+
+ private:
+  std::string NextBlock(bool remove) override;
+
+ private:
+  const SamplingPrior* prior_;
+  utils::LinearRandomEngine::StateType rand_seed_;
+  std::vector<bool> removed_;
+};
+
 }  // namespace auto_schedule
 }  // namespace cinn
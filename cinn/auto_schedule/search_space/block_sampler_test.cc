@@ -69,5 +69,23 @@ TEST(ProbabilisticBlockSampler, NextBlock) {
   ASSERT_EQ("", probabilistic_block_sampler->NextBlock());
 }
 
+TEST(BanditBlockSampler, NextBlock) {
+  std::vector<ir::Expr> blocks = CreateTestBlocks();
+  SamplingPrior prior;
+  for (int i = 0; i < 1000; ++i) {
+    prior.Update(SamplingPrior::BlockArm("block_0"), 0.0);
+    prior.Update(SamplingPrior::BlockArm("block_1"), 1.0);
+    prior.Update(SamplingPrior::BlockArm("block_2"), 0.5);
+  }
+  auto bandit_block_sampler = BlockSampler::Make(blocks, true, "bandit", 0, {}, &prior);
+  ASSERT_STREQ(bandit_block_sampler->Name(), "bandit");
+  ASSERT_EQ("block_1", bandit_block_sampler->NextBlock());
+  ASSERT_EQ("block_2", bandit_block_sampler->NextBlock());
+  ASSERT_EQ("block_0", bandit_block_sampler->NextBlock());
+  ASSERT_EQ("", bandit_block_sampler->NextBlock());
+  bandit_block_sampler->Reset();
+  ASSERT_EQ("block_1", bandit_block_sampler->NextBlock());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
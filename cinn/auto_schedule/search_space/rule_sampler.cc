@@ -24,12 +24,15 @@ std::unique_ptr<RuleSampler> RuleSampler::Make(const std::vector<AutoGenRule*>&
                                                bool default_remove_policy,
                                                const std::string& strategy,
                                                utils::LinearRandomEngine::StateType rand_seed,
-                                               const std::vector<int>& weights) {
+                                               const std::vector<int>& weights,
+                                               const SamplingPrior* prior) {
   CHECK_GT(potential_rules.size(), 0) << "Empty rule list";
   if (strategy == "traversal") {
     return std::make_unique<TraversalRuleSampler>(potential_rules, default_remove_policy);
   } else if (strategy == "probabilistic") {
     return std::make_unique<ProbabilisticRuleSampler>(potential_rules, default_remove_policy, rand_seed, weights);
+  } else if (strategy == "bandit") {
+    return std::make_unique<BanditRuleSampler>(potential_rules, default_remove_policy, rand_seed, prior);
   }
 
   LOG(FATAL) << "Unimplemented strategy:" << strategy;
@@ -76,5 +79,39 @@ AutoGenRule* ProbabilisticRuleSampler::NextRule(bool remove) {
   return potential_rules_->at(rule_idx);
 }
 
+BanditRuleSampler::BanditRuleSampler(const std::vector<AutoGenRule*>& potential_rules,
+                                     bool default_remove_policy,
+                                     utils::LinearRandomEngine::StateType rand_seed,
+                                     const SamplingPrior* prior)
+    : RuleSampler(potential_rules, default_remove_policy),
+      prior_(prior),
+      rand_seed_(utils::LinearRandomEngine::NormalizeState(rand_seed)),
+      removed_(potential_rules.size(), false) {
+  CHECK(prior_) << "BanditRuleSampler needs a SamplingPrior";
+}
+
+AutoGenRule* BanditRuleSampler::NextRule(bool remove) {
+  int rule_idx      = -1;
+  double best_score = 0.0;
+  for (int i = 0; i < potential_rules_->size(); ++i) {
+    if (removed_[i]) {
+      continue;
+    }
+    double score = prior_->SampleScore(SamplingPrior::RuleArm(potential_rules_->at(i)->GetRuleName()), &rand_seed_);
+    if (rule_idx < 0 || score > best_score) {
+      rule_idx   = i;
+      best_score = score;
+    }
+  }
+  if (rule_idx < 0) {
+    return nullptr;
+  }
+  if (remove) {
+    removed_[rule_idx] = true;
+  }
+
+  return potential_rules_->at(rule_idx);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
 #include "cinn/utils/random_engine.h"
 
 namespace cinn {
@@ -34,16 +35,19 @@ class RuleSampler {
    * @param potential_rules All possible rules to be sampled.
    * @param default_remove_policy The default option to determine whether to delete the next block after selecting it.
    * @param strategy The rule sampling strategy.
-   *                 Currently, the available strategies are "traversal" and "probabilistic",
+   *                 Currently, the available strategies are "traversal", "probabilistic" and "bandit",
    *                 where "traversal" means to select rules one by one until all rules are traversed,
-   *                 and "probabilistic" means randomly picking rules according to the given distribution.
+   *                 "probabilistic" means randomly picking rules according to the given distribution,
+   *                 and "bandit" means picking the rule of the best score drawn from the learned prior.
    * @param weights Used for the probabilistic policy, giving each candidate a weight.
+   * @param prior Used for the bandit policy, the rewards learned for the rules, not owned.
    */
   static std::unique_ptr<RuleSampler> Make(const std::vector<AutoGenRule*>& potential_rules,
                                            bool default_remove_policy                     = true,
                                            const std::string& strategy                    = "traversal",
                                            utils::LinearRandomEngine::StateType rand_seed = 0,
-                                           const std::vector<int>& weights                = {});
+                                           const std::vector<int>& weights                = {},
+                                           const SamplingPrior* prior                     = nullptr);
   // Return the name of sample strategy
   virtual const char* Name() const = 0;
 
@@ -110,5 +114,27 @@ class ProbabilisticRuleSampler : public RuleSampler {
   int remains_;
 };
 
+// Sample rules with bandit strategy,
+// which means picking the rule of the best score drawn from the rewards learned in the previous rounds.
+class BanditRuleSampler : public RuleSampler {
+ public:
+  BanditRuleSampler(const std::vector<AutoGenRule*>& potential_rules,
+                    bool default_remove_policy,
+                    utils::LinearRandomEngine::StateType rand_seed,
+                    const SamplingPrior* prior);
+
+  const char* Name() const override { return "bandit"; }
+
+  void Reset() override { removed_.assign(potential_rules_->size(), false); }
+
+ private:
+  AutoGenRule* NextRule(bool remove) override;
+
+ private:
+  const SamplingPrior* prior_;
+  utils::LinearRandomEngine::StateType rand_seed_;
+  std::vector<bool> removed_;
+};
+
 }  // namespace auto_schedule
 }  // namespace cinn
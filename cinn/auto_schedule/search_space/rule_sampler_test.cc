@@ -71,5 +71,19 @@ TEST(ProbabilisticRuleSampler, NextRule) {
   ASSERT_EQ(nullptr, probabilistic_rule_sampler->NextRule());
 }
 
+TEST(BanditRuleSampler, NextRule) {
+  std::vector<AutoGenRule*> rules = GenerateTestRules();
+  SamplingPrior prior;
+  for (int i = 0; i < 1000; ++i) {
+    prior.Update(SamplingPrior::RuleArm("AutoUnroll"), 0.1);
+    prior.Update(SamplingPrior::RuleArm("SkipRule"), 0.9);
+  }
+  auto bandit_rule_sampler = RuleSampler::Make(rules, true, "bandit", 0, {}, &prior);
+  ASSERT_STREQ(bandit_rule_sampler->Name(), "bandit");
+  ASSERT_EQ("SkipRule", bandit_rule_sampler->NextRule()->GetRuleName());
+  ASSERT_EQ("AutoUnroll", bandit_rule_sampler->NextRule()->GetRuleName());
+  ASSERT_EQ(nullptr, bandit_rule_sampler->NextRule());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
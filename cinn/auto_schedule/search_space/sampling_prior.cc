@@ -0,0 +1,82 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
+
+#include <glog/logging.h>
+
+#include <cmath>
+
+namespace cinn {
+namespace auto_schedule {
+
+// the mean reward assumed for an arm never sampled, it counts as one sample in the posterior
+static constexpr double kInitialReward = 0.5;
+
+void SamplingPrior::Update(const std::string& arm, double reward) {
+  CHECK(reward >= 0.0 && reward <= 1.0) << "The reward of arm " << arm << " should be in [0, 1], but got " << reward;
+  auto& stat = arms_[arm];
+  ++stat.num_samples;
+  stat.total_reward += reward;
+}
+
+void SamplingPrior::Merge(const SamplingPrior& other) {
+  for (auto&& name2arm : other.arms_) {
+    auto& stat = arms_[name2arm.first];
+    stat.num_samples += name2arm.second.num_samples;
+    stat.total_reward += name2arm.second.total_reward;
+  }
+}
+
+double SamplingPrior::SampleScore(const std::string& arm, utils::LinearRandomEngine::StateType* rand_seed) const {
+  Arm stat;
+  auto it = arms_.find(arm);
+  if (it != arms_.end()) {
+    stat = it->second;
+  }
+  double count = stat.num_samples + 1;
+  double mean  = (stat.total_reward + kInitialReward) / count;
+  // the reward is bounded in [0, 1], so its variance is at most 1/4
+  double stddev = 0.5 / std::sqrt(count);
+  // draw a standard normal value by the Box-Muller transform
+  double u1 = utils::SampleUniformDouble(0, 1, rand_seed);
+  double u2 = utils::SampleUniformDouble(0, 1, rand_seed);
+  double z  = std::sqrt(-2.0 * std::log(1.0 - u1)) * std::cos(2.0 * M_PI * u2);
+  return mean + stddev * z;
+}
+
+proto::SamplingPrior SamplingPrior::ToProto(const std::string& task_key) const {
+  proto::SamplingPrior prior_proto;
+  prior_proto.set_task_key(task_key);
+  for (auto&& name2arm : arms_) {
+    auto* arm_proto = prior_proto.add_arms();
+    arm_proto->set_name(name2arm.first);
+    arm_proto->set_num_samples(name2arm.second.num_samples);
+    arm_proto->set_total_reward(name2arm.second.total_reward);
+  }
+  return prior_proto;
+}
+
+SamplingPrior SamplingPrior::FromProto(const proto::SamplingPrior& prior_proto) {
+  SamplingPrior prior;
+  for (auto&& arm_proto : prior_proto.arms()) {
+    auto& stat = prior.arms_[arm_proto.name()];
+    stat.num_samples += arm_proto.num_samples();
+    stat.total_reward += arm_proto.total_reward();
+  }
+  return prior;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/utils/random_engine.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * The rewards learned for the arms of the bandit samplers, which are the sketch rules and the blocks of a task.
+ * A reward is in [0, 1], it is the measured speed of a candidate relative to the best one known before, and every
+ * arm sampled to generate the candidate is rewarded with it. The arms are scored by Thompson sampling, that is a
+ * score is drawn from the gaussian posterior of the mean reward of the arm, so the arms that led to fast candidates
+ * are preferred while the arms rarely tried are still explored.
+ */
+class SamplingPrior {
+ public:
+  struct Arm {
+    int64_t num_samples = 0;
+    double total_reward = 0.0;
+  };
+
+  // The arm name of a sketch rule
+  static std::string RuleArm(const std::string& rule_name) { return "rule:" + rule_name; }
+  // The arm name of a block
+  static std::string BlockArm(const std::string& block_name) { return "block:" + block_name; }
+
+  // Add a sampled reward of the arm
+  void Update(const std::string& arm, double reward);
+
+  // Add all the rewards of another prior
+  void Merge(const SamplingPrior& other);
+
+  // Draw a score of the arm from the posterior of its mean reward
+  double SampleScore(const std::string& arm, utils::LinearRandomEngine::StateType* rand_seed) const;
+
+  bool empty() const { return arms_.empty(); }
+
+  const std::map<std::string, Arm>& arms() const { return arms_; }
+
+  proto::SamplingPrior ToProto(const std::string& task_key) const;
+
+  static SamplingPrior FromProto(const proto::SamplingPrior& prior_proto);
+
+ private:
+  std::map<std::string, Arm> arms_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
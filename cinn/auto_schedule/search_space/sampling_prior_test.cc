@@ -0,0 +1,63 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
+
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(SamplingPrior, UpdateAndMerge) {
+  SamplingPrior prior;
+  ASSERT_TRUE(prior.empty());
+  prior.Update(SamplingPrior::RuleArm("AutoInline"), 0.5);
+  prior.Update(SamplingPrior::RuleArm("AutoInline"), 1.0);
+
+  SamplingPrior other;
+  other.Update(SamplingPrior::RuleArm("AutoInline"), 0.25);
+  other.Update(SamplingPrior::BlockArm("B"), 1.0);
+  prior.Merge(other);
+
+  auto restored = SamplingPrior::FromProto(prior.ToProto("task"));
+  ASSERT_EQ(restored.arms().size(), 2);
+  EXPECT_EQ(restored.arms().at("rule:AutoInline").num_samples, 3);
+  EXPECT_DOUBLE_EQ(restored.arms().at("rule:AutoInline").total_reward, 1.75);
+  EXPECT_EQ(restored.arms().at("block:B").num_samples, 1);
+  EXPECT_DOUBLE_EQ(restored.arms().at("block:B").total_reward, 1.0);
+}
+
+TEST(SamplingPrior, SampleScore) {
+  SamplingPrior prior;
+  for (int i = 0; i < 100; ++i) {
+    prior.Update("good", 0.9);
+    prior.Update("bad", 0.1);
+  }
+  utils::LinearRandomEngine::StateType rand_seed = 1;
+  int num_good_wins                              = 0;
+  int num_unseen_wins                            = 0;
+  for (int i = 0; i < 100; ++i) {
+    double good_score   = prior.SampleScore("good", &rand_seed);
+    double bad_score    = prior.SampleScore("bad", &rand_seed);
+    double unseen_score = prior.SampleScore("unseen", &rand_seed);
+    num_good_wins += good_score > bad_score;
+    num_unseen_wins += unseen_score > bad_score;
+  }
+  // the well rewarded arm almost always wins, and the arm never sampled is still explored
+  EXPECT_GE(num_good_wins, 99);
+  EXPECT_GT(num_unseen_wins, 50);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
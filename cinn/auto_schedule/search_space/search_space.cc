@@ -23,9 +23,12 @@
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_inline.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_pipeline.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/multi_level_tiling.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/skip_rule.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/tensor_core_tiling.h"
 #include "cinn/auto_schedule/search_space/block_sampler.h"
 #include "cinn/auto_schedule/search_space/rule_sampler.h"
 #include "cinn/auto_schedule/task/tune_task.h"
@@ -33,6 +36,7 @@
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/runtime/flags.h"
+#include "cinn/utils/multi_threading.h"
 
 DECLARE_bool(auto_schedule_use_cost_model);
 
@@ -41,13 +45,30 @@ namespace auto_schedule {
 
 SearchSpace::SearchSpace(const TuneTask& tune_task, utils::LinearRandomEngine::StateType rand_seed)
     : tune_task_(tune_task), rand_seed_(utils::LinearRandomEngine::NormalizeState(rand_seed)) {
-  const auto& target = tune_task_.target;
   // initialize a set of rules and they are commonly used by all states
+  sketch_rules_ = CreateSketchRules();
+}
+
+std::vector<std::unique_ptr<AutoGenRule>> SearchSpace::CreateSketchRules() const {
+  const auto& target = tune_task_.target;
+  std::vector<std::unique_ptr<AutoGenRule>> rules;
   // TODO(zhhsplendid): pass correct output names to AutoInline
-  // sketch_rules_.emplace_back(new AutoInline(target, tune_task_.output_names));
-  sketch_rules_.emplace_back(new MultiLevelTiling(target, MultiLevelTiling::kConfigs.at(target.arch)));
-  sketch_rules_.emplace_back(new AutoUnroll(target));
-  sketch_rules_.emplace_back(new SkipRule(target));
+  // rules.emplace_back(new AutoInline(target, tune_task_.output_names));
+  if (target.arch == common::Target::Arch::NVGPU) {
+    // keep both the tensorized and the original states, the latter is tiled by MultiLevelTiling
+    rules.emplace_back(new TensorCoreTiling(target));
+  }
+  rules.emplace_back(new MultiLevelTiling(target, MultiLevelTiling::kConfigs.at(target.arch)));
+  if (target.arch == common::Target::Arch::NVGPU) {
+    // pipeline the cache reads of MultiLevelTiling, the state without pipelining is kept
+    rules.emplace_back(new AutoPipeline(target));
+  } else if (target.is_cpu()) {
+    // parallelize the outer spatial tiles over the cores and vectorize the innermost ones
+    rules.emplace_back(new AutoParallel(target));
+  }
+  rules.emplace_back(new AutoUnroll(target));
+  rules.emplace_back(new SkipRule(target));
+  return rules;
 }
 
 SearchState SearchSpace::GetScheduleMutate(const SearchState& state, const ExprCostModel& cost_model) {
@@ -140,15 +161,17 @@ std::vector<SearchState> SearchSpace::InitSketchWithRandomStrategy(int num) {
   return result;
 }
 
-std::vector<SearchState> SearchSpace::InitSketchWithRandomPrunedStrategy() {
+std::vector<SearchState> SearchSpace::InitSketchWithRandomPrunedStrategy(
+    const std::vector<std::unique_ptr<AutoGenRule>>& rules, utils::LinearRandomEngine::StateType* rand_seed) {
   VLOG(5) << "SearchSpace::InitSketchWithRandomPrunedStrategy";
-  ir::IRSchedule init_schedule(ir::ModuleExpr(tune_task_.GetLoweredFuncBodyExprs()),
-                               utils::ForkRandomState(&rand_seed_));
-  auto all_blocks    = init_schedule.GetAllBlocks();
-  auto block_sampler = BlockSampler::Make(all_blocks, true, "probabilistic", utils::ForkRandomState(&rand_seed_));
+  ir::IRSchedule init_schedule(ir::ModuleExpr(tune_task_.GetLoweredFuncBodyExprs()), utils::ForkRandomState(rand_seed));
+  auto all_blocks             = init_schedule.GetAllBlocks();
+  const char* sample_strategy = sampling_prior_ ? "bandit" : "probabilistic";
+  auto block_sampler          = BlockSampler::Make(
+      all_blocks, true, sample_strategy, utils::ForkRandomState(rand_seed), {}, sampling_prior_.get());
 
   std::vector<AutoGenRule*> init_rules;
-  std::transform(sketch_rules_.begin(), sketch_rules_.end() - 1, std::back_inserter(init_rules), [](const auto& rule) {
+  std::transform(rules.begin(), rules.end() - 1, std::back_inserter(init_rules), [](const auto& rule) {
     return rule.get();
   });
   CHECK(init_rules.size() > 0) << "number of init rules cannot be 0";
@@ -160,15 +183,16 @@ std::vector<SearchState> SearchSpace::InitSketchWithRandomPrunedStrategy() {
   int total_steps                         = 0, steps;
   std::string block_name;
   while ("" != (block_name = block_sampler->NextBlock()) && total_steps < init_sketch_random_depth_) {
-    steps = utils::SampleUniformInt(1, init_rules.size() + 1, &rand_seed_);
+    steps = utils::SampleUniformInt(1, init_rules.size() + 1, rand_seed);
     if (total_steps + steps > init_sketch_random_depth_) {
       steps = init_sketch_random_depth_ - total_steps;
     }
     total_steps += steps;
     p_states_next->clear();
     for (const auto& state : *p_states_cur) {
-      auto rule_sampler = RuleSampler::Make(init_rules, true, "probabilistic", utils::ForkRandomState(&rand_seed_));
-      auto new_states   = ApplySketchRule(state, block_name, rule_sampler.get(), steps, false, 1);
+      auto rule_sampler = RuleSampler::Make(
+          init_rules, true, sample_strategy, utils::ForkRandomState(rand_seed), {}, sampling_prior_.get());
+      auto new_states   = ApplySketchRule(state, block_name, rule_sampler.get(), rand_seed, steps, false, 1);
       p_states_next->insert(p_states_next->end(), new_states.begin(), new_states.end());
     }
     std::swap(p_states_cur, p_states_next);
@@ -178,16 +202,16 @@ std::vector<SearchState> SearchSpace::InitSketchWithRandomPrunedStrategy() {
   return *p_states_cur;
 }
 
-std::vector<SearchState> SearchSpace::InitSketchWithRulePrunedStrategy() {
+std::vector<SearchState> SearchSpace::InitSketchWithRulePrunedStrategy(
+    const std::vector<std::unique_ptr<AutoGenRule>>& rules, utils::LinearRandomEngine::StateType* rand_seed) {
   VLOG(5) << "SearchSpace::InitSketchWithRulePrunedStrategy";
-  ir::IRSchedule init_schedule(ir::ModuleExpr(tune_task_.GetLoweredFuncBodyExprs()),
-                               utils::ForkRandomState(&rand_seed_));
+  ir::IRSchedule init_schedule(ir::ModuleExpr(tune_task_.GetLoweredFuncBodyExprs()), utils::ForkRandomState(rand_seed));
   auto all_blocks = init_schedule.GetAllBlocks();
   std::reverse(all_blocks.begin(), all_blocks.end());
   auto block_sampler = BlockSampler::Make(all_blocks, true, "traversal");
 
   std::vector<AutoGenRule*> init_rules;
-  std::transform(sketch_rules_.begin(), sketch_rules_.end() - 1, std::back_inserter(init_rules), [](const auto& rule) {
+  std::transform(rules.begin(), rules.end() - 1, std::back_inserter(init_rules), [](const auto& rule) {
     return rule.get();
   });
   CHECK(init_rules.size() > 0) << "number of init rules cannot be 0";
@@ -201,7 +225,7 @@ std::vector<SearchState> SearchSpace::InitSketchWithRulePrunedStrategy() {
     p_states_next->clear();
     for (const auto& state : *p_states_cur) {
       auto rule_sampler = RuleSampler::Make(init_rules, true, "traversal");
-      auto new_states   = ApplySketchRule(state, block_name, rule_sampler.get(), 0, true);
+      auto new_states   = ApplySketchRule(state, block_name, rule_sampler.get(), rand_seed, 0, true);
       p_states_next->insert(p_states_next->end(), new_states.begin(), new_states.end());
     }
     std::swap(p_states_cur, p_states_next);
@@ -218,26 +242,41 @@ std::vector<SearchState> SearchSpace::GenerateSketches(int num, const std::strin
     return InitSketchWithRandomStrategy(num);
   }
 
+  CHECK(strategy == "rule_prune" || strategy == "random_prune") << "Unimplemented init sketch strategy";
+
   std::vector<SearchState> result;
+  int num_rounds = 1;
   while (result.size() < num) {
-    std::vector<SearchState> sketchs;
-    if (strategy == "rule_prune") {
-      sketchs = InitSketchWithRulePrunedStrategy();
-    } else if (strategy == "random_prune") {
-      sketchs = InitSketchWithRandomPrunedStrategy();
-    } else {
-      LOG(FATAL) << "Unimplemented init sketch strategy";
+    // every round generates sketches with its own rules and random seed, so the rounds run in parallel,
+    // the seeds are forked in order and the results are collected in order to keep them deterministic
+    std::vector<utils::LinearRandomEngine::StateType> round_seeds(num_rounds);
+    for (auto& seed : round_seeds) {
+      seed = utils::ForkRandomState(&rand_seed_);
     }
+    std::vector<std::vector<SearchState>> round_sketchs(num_rounds);
+    auto round_fn = [this, &strategy, &round_seeds, &round_sketchs](int index) {
+      auto rules = CreateSketchRules();
+      if (strategy == "rule_prune") {
+        round_sketchs[index] = InitSketchWithRulePrunedStrategy(rules, &round_seeds[index]);
+      } else {
+        round_sketchs[index] = InitSketchWithRandomPrunedStrategy(rules, &round_seeds[index]);
+      }
+    };
+    utils::parallel_run(round_fn, utils::SequenceDispatcher(0, num_rounds), num_rounds);
 
     // the more rules are applied, the greater the possibility of good results,
     // the more rules are applied, the more they are saved behind the queue,
     // so we give priority to the results in the rear
-    for (auto iter = sketchs.rbegin(); iter != sketchs.rend(); ++iter) {
-      result.push_back(*iter);
-      if (result.size() == num) {
-        break;
+    size_t num_generated = 0;
+    for (auto&& sketchs : round_sketchs) {
+      num_generated += sketchs.size();
+      for (auto iter = sketchs.rbegin(); iter != sketchs.rend() && result.size() < num; ++iter) {
+        result.push_back(*iter);
       }
     }
+    // estimate the rounds needed by the rest with the average number of sketches generated in a round,
+    // a round generates at least the initial state
+    num_rounds = ((num - result.size()) * num_rounds + num_generated - 1) / num_generated;
   }
   VLOG(4) << JoinStatesDebugString("SearchSpace::GenerateSketches", result, /*verbose=*/VLOG_IS_ON(5));
   return result;
@@ -246,6 +285,7 @@ std::vector<SearchState> SearchSpace::GenerateSketches(int num, const std::strin
 std::vector<SearchState> SearchSpace::ApplySketchRule(const SearchState& state,
                                                       const std::string& block_name,
                                                       RuleSampler* rule_sampler,
+                                                      utils::LinearRandomEngine::StateType* rand_seed,
                                                       int steps,
                                                       bool prune_by_rule,
                                                       double prune_probability) {
@@ -277,12 +317,16 @@ std::vector<SearchState> SearchSpace::ApplySketchRule(const SearchState& state,
       }
       // if can apply the rule, apply it and determine whether to prune the branch that do not apply
       std::vector<SearchState> tmp_states = rule->ApplyOnBlock(*iter, block_name);
+      for (auto& new_state : tmp_states) {
+        new_state->sampled_arms.push_back(SamplingPrior::BlockArm(block_name));
+        new_state->sampled_arms.push_back(SamplingPrior::RuleArm(rule->GetRuleName()));
+      }
       new_states.insert(new_states.end(), tmp_states.begin(), tmp_states.end());
       bool need_prune = false;
       if (prune_by_rule) {
         need_prune = (type == RuleApplyType::kApplyAndPruneOtherRules);
       } else {
-        need_prune = (utils::SampleUniformDouble(0, 1, &rand_seed_) < prune_probability);
+        need_prune = (utils::SampleUniformDouble(0, 1, rand_seed) < prune_probability);
       }
       if (need_prune) {
         iter = layer.erase(iter);
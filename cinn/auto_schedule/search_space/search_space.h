@@ -21,6 +21,7 @@
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/search_space/rule_sampler.h"
+#include "cinn/auto_schedule/search_space/sampling_prior.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/ir/ir_base.h"
@@ -59,6 +60,10 @@ class SearchSpace {
    */
   virtual std::vector<SearchState> GenerateSketches(int num, const std::string& strategy);
 
+  // Set the rewards learned for the sketch rules and the blocks, then the "random_prune" strategy samples them by the
+  // bandit samplers instead of uniformly
+  void SetSamplingPrior(const SamplingPrior& prior) { sampling_prior_ = std::make_unique<SamplingPrior>(prior); }
+
  private:
   // TODO(zhhsplendid): mutate by manual schedule.
   SearchState ManualScheduleMutate(const SearchState& state);
@@ -69,11 +74,16 @@ class SearchSpace {
   // Generate num sketchs, each with several rounds of SketchMutate
   std::vector<SearchState> InitSketchWithRandomStrategy(int num);
 
+  // Create a new set of the sketch rules, the rules keep states in applying so each thread uses its own set
+  std::vector<std::unique_ptr<AutoGenRule>> CreateSketchRules() const;
+
   // Generate sketch pruned randomly as initial population of evolutionary search
-  std::vector<SearchState> InitSketchWithRandomPrunedStrategy();
+  std::vector<SearchState> InitSketchWithRandomPrunedStrategy(const std::vector<std::unique_ptr<AutoGenRule>>& rules,
+                                                              utils::LinearRandomEngine::StateType* rand_seed);
 
   // Generate sketch pruned by rules as initial population of evolutionary search
-  std::vector<SearchState> InitSketchWithRulePrunedStrategy();
+  std::vector<SearchState> InitSketchWithRulePrunedStrategy(const std::vector<std::unique_ptr<AutoGenRule>>& rules,
+                                                            utils::LinearRandomEngine::StateType* rand_seed);
 
   /**
    * @brief Collect the new states that may be transferred to after applying several rules on a block from a certain
@@ -81,6 +91,7 @@ class SearchSpace {
    * @param state Starting point of state transition.
    * @param block_name Name of the block to apply the rules to.
    * @param rule_sampler Sampler that samples the new rule to apply on the block.
+   * @param rand_seed The random seed used in random pruning.
    * @param steps Number of steps to apply the rule.
    * @param prune_by_rule If true, prune the state transition tree by rule, otherwise prune randomly.
    * @param prune_probability Pruning probability of random pruning.
@@ -88,6 +99,7 @@ class SearchSpace {
   std::vector<SearchState> ApplySketchRule(const SearchState& state,
                                            const std::string& block_name,
                                            RuleSampler* rule_sampler,
+                                           utils::LinearRandomEngine::StateType* rand_seed,
                                            int steps,
                                            bool prune_by_rule,
                                            double prune_probability = 1);
@@ -98,6 +110,8 @@ class SearchSpace {
   // supported AutoGenRules, every task holds a set
   std::vector<std::unique_ptr<AutoGenRule>> sketch_rules_;
   utils::LinearRandomEngine::StateType rand_seed_;
+  // the prior used by the bandit samplers, nullptr if the rules and blocks are sampled uniformly
+  std::unique_ptr<SamplingPrior> sampling_prior_;
 };
 
 }  // namespace auto_schedule
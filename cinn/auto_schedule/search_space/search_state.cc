@@ -37,7 +37,11 @@ SearchState::SearchState(ir::IRSchedule ir_sch, float cost, const std::vector<Au
   state->predicted_cost   = cost;
 }
 
-SearchState SearchState::Copy() const { return SearchState((*this)->ir_schedule, (*this)->predicted_cost, {}); }
+SearchState SearchState::Copy() const {
+  SearchState copied((*this)->ir_schedule, (*this)->predicted_cost, {});
+  copied->sampled_arms = (*this)->sampled_arms;
+  return copied;
+}
 
 std::string _SearchState_::DebugString() const {
   const auto& exprs = ir_schedule.GetModule().GetExprs();
@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include "cinn/common/object.h"
@@ -54,6 +55,9 @@ struct _SearchState_ : public common::Object {
   float predicted_cost;
   // The rules that can be applied to the IRSchedule at this state.
   std::vector<AutoGenRule*> applicable_rules;
+  // The arms of SamplingPrior, i.e. the sketch rules and the blocks, applied to generate the state, they are rewarded
+  // with its measured cost
+  std::vector<std::string> sampled_arms;
 
   // return detail string of content for debug;
   std::string DebugString() const;
@@ -25,18 +25,24 @@
 
 #include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/post_schedule_rule/cooperative_process.h"
+#include "cinn/auto_schedule/post_schedule_rule/software_pipelining.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_tile_size.h"
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/ir/ir_schedule_util.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/multi_threading.h"
 #include "cinn/utils/sized_multi_set.h"
 #include "cinn/utils/string.h"
 
 DECLARE_bool(auto_schedule_use_cost_model);
+DECLARE_int32(auto_schedule_pipeline_stages);
+DECLARE_bool(auto_schedule_use_bandit_sampler);
+DECLARE_bool(auto_schedule_static_prune);
+DECLARE_double(auto_schedule_min_coalescing_ratio);
 
 namespace cinn {
 namespace auto_schedule {
@@ -53,7 +59,11 @@ EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task,
       mutators_(mutate_rules) {
   search_space_ = std::make_unique<SearchSpace>(tune_task, utils::ForkRandomState(&rand_seed_));
   if (mutators_.empty()) {
-    mutators_.push_back(std::make_tuple("mutate_tile_size", 1.0));
+    mutators_.push_back(std::make_tuple("mutate_tile_size", 0.6));
+    mutators_.push_back(std::make_tuple("mutate_auto_unroll", 0.15));
+    mutators_.push_back(std::make_tuple("mutate_compute_location", 0.1));
+    mutators_.push_back(std::make_tuple("mutate_thread_binding", 0.1));
+    mutators_.push_back(std::make_tuple("mutate_vectorize", 0.05));
   }
   double accum_weight = 0.0;
   for (const auto& mutator : mutators_) {
@@ -64,6 +74,14 @@ EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task,
   }
 
   post_schedule_rules_.emplace_back(new CooperativeProcess);
+  if (FLAGS_auto_schedule_pipeline_stages >= 2) {
+    post_schedule_rules_.emplace_back(new SoftwarePipelining(FLAGS_auto_schedule_pipeline_stages));
+  }
+  if (FLAGS_auto_schedule_static_prune && tune_task.target == common::DefaultNVGPUTarget()) {
+    GpuResourceLimits limits    = GpuResourceLimits::FromTarget(tune_task.target);
+    limits.min_coalescing_ratio = FLAGS_auto_schedule_min_coalescing_ratio;
+    gpu_limits_                 = std::make_unique<GpuResourceLimits>(limits);
+  }
 }
 
 EvolutionarySearch::~EvolutionarySearch() {}
@@ -79,12 +97,17 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningO
   std::vector<SearchState> topk_from_database = GetTopKCandidatesFromDatabase(options.evolution_pick_database_topk);
   VLOG(4) << JoinStatesDebugString(
       "EvolutionarySearch::GetTopKCandidatesFromDatabase", topk_from_database, /*verbose=*/VLOG_IS_ON(5));
-  int init_num = options.evolution_init_population_num - topk_from_database.size();
+  int init_num = options.evolution_init_population_num - topk_from_database.size() - extra_population_.size();
 
-  std::vector<SearchState> init_sketch = InitSketch(init_num, "rule_prune");
+  std::vector<SearchState> init_sketch;
+  if (init_num > 0) {
+    init_sketch = InitSketch(init_num, "rule_prune");
+  }
   VLOG(4) << JoinStatesDebugString("EvolutionarySearch::InitSketch", init_sketch, /*verbose=*/VLOG_IS_ON(5));
 
   init_population.insert(init_population.end(), topk_from_database.begin(), topk_from_database.end());
+  init_population.insert(init_population.end(), extra_population_.begin(), extra_population_.end());
+  extra_population_.clear();
   init_population.insert(init_population.end(), init_sketch.begin(), init_sketch.end());
 
   std::vector<SearchState> picked_bests =
@@ -93,38 +116,100 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningO
   return picked_bests;
 }
 
+void EvolutionarySearch::AddInitialPopulation(const std::vector<SearchState>& states) {
+  extra_population_.insert(extra_population_.end(), states.begin(), states.end());
+}
+
 std::vector<SearchState> EvolutionarySearch::SearchModuleExprEpsGreedy(const TuningOptions& options) {
   std::vector<SearchState> picked_bests = SearchModuleExprBests(options);
-  int random_num                        = options.evolution_init_population_num - options.evolution_pick_database_topk;
-  auto results                          = PickNextGenerationEpsGreedy(picked_bests,
-                                             InitSketch(random_num, "random_prune"),
-                                             options.num_samples_per_iteration,
-                                             options.evolution_eps_greedy);
+  if (FLAGS_auto_schedule_use_bandit_sampler) {
+    // the random sketches sample the rules and blocks by the rewards learned from the rounds measured so far
+    search_space_->SetSamplingPrior(database_->GetSamplingPrior(tune_task_.serialized_key));
+  }
+  int random_num   = options.evolution_init_population_num - options.evolution_pick_database_topk;
+  auto random_init = InitSketch(random_num, "random_prune");
+  PruneByGpuResources(&random_init);
+  auto results = PickNextGenerationEpsGreedy(
+      picked_bests, random_init, options.num_samples_per_iteration, options.evolution_eps_greedy);
   VLOG(4) << JoinStatesDebugString(
       "EvolutionarySearch::PickNextGenerationEpsGreedy", results, /*verbose=*/VLOG_IS_ON(5));
   return results;
 }
 
+void ApplyPostScheduleRules(ir::IRSchedule* schedule,
+                            const std::vector<std::unique_ptr<PostScheduleRule>>& post_schedule_rules) {
+  schedule->TagPostSchedule();
+  for (const auto& post_rule : post_schedule_rules) {
+    post_rule->Apply(schedule);
+  }
+}
+
 std::vector<SearchState> EvolutionarySearch::GetTopKCandidatesFromDatabase(int topk) {
   std::vector<SearchState> results;
   const auto& task_key               = tune_task_.serialized_key;
   auto records                       = database_->GetTopK(task_key, topk);
   InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
   for (auto&& record : records) {
-    ir::IRSchedule ir_sch(optim::IRCopy(task_registry->Get(task_key)->module_expr),
-                          utils::ForkRandomState(&rand_seed_));
-    ir::ScheduleDesc::ReplayWithProto(record.trace, &ir_sch);
+    auto ir_sch = task_registry->Get(task_key)->replay_cache->Replay(
+        record.trace, /*without_post_schedule=*/false, utils::ForkRandomState(&rand_seed_));
     results.emplace_back(SearchState(std::move(ir_sch), record.predicted_cost));
   }
+
+  // fill the rest with the records of the tasks in the same structure but different shapes
+  if (results.size() < topk) {
+    for (auto&& record : database_->LookUpSimilar(task_key, topk - results.size())) {
+      ir::IRSchedule ir_sch(optim::IRCopy(task_registry->Get(task_key)->module_expr),
+                            utils::ForkRandomState(&rand_seed_));
+      if (ReplayTransferredTrace(record.trace, &ir_sch)) {
+        ApplyPostScheduleRules(&ir_sch, post_schedule_rules_);
+        VLOG(4) << "Transfer the record of task:\n" << record.task_key << "to task:\n" << task_key;
+        results.emplace_back(SearchState(std::move(ir_sch), record.predicted_cost));
+      }
+    }
+  }
   return results;
 }
 
-void ApplyPostScheduleRules(ir::IRSchedule* schedule,
-                            const std::vector<std::unique_ptr<PostScheduleRule>>& post_schedule_rules) {
-  schedule->TagPostSchedule();
-  for (const auto& post_rule : post_schedule_rules) {
-    post_rule->Apply(schedule);
+std::vector<int> RescaleTileFactors(const std::vector<int>& factors, int extent) {
+  // the factor taking the rest of the extent, it is the one given as -1 or the outermost
+  auto free_it      = std::find(factors.begin(), factors.end(), -1);
+  bool has_negative = free_it != factors.end();
+  int free_idx      = has_negative ? free_it - factors.begin() : 0;
+
+  std::vector<int> results(factors.size());
+  int rest = extent;
+  for (int i = static_cast<int>(factors.size()) - 1; i >= 0; --i) {
+    if (i == free_idx) {
+      continue;
+    }
+    // the largest divisor of the rest not greater than the original factor
+    int factor = std::max(std::min(factors[i], rest), 1);
+    while (rest % factor != 0) {
+      --factor;
+    }
+    results[i] = factor;
+    rest /= factor;
   }
+  results[free_idx] = has_negative ? -1 : rest;
+  return results;
+}
+
+bool ReplayTransferredTrace(const ir::proto::ScheduleDesc& trace, ir::IRSchedule* schedule) {
+  auto rescale_fn = [](ir::ScheduleDesc::Step* step) {
+    if (step->type != "SamplePerfectTile") {
+      return;
+    }
+    auto& decision = absl::get<std::vector<int>>(step->attrs.at("decision"));
+    decision       = RescaleTileFactors(decision, ir::GetLoopExtent(step->inputs.at("loop").front()));
+  };
+  try {
+    // the post schedules are dropped, as they are made for the original shapes
+    ir::ScheduleDesc::ReplayWithProto(trace, schedule, /*without_post_schedule=*/true, rescale_fn);
+  } catch (std::exception& e) {
+    VLOG(4) << "Failed to replay a transferred trace, error: " << e.what();
+    return false;
+  }
+  return true;
 }
 
 std::vector<SearchState> EvolutionarySearch::InitSketch(int num, const std::string& strategy) {
@@ -138,26 +223,93 @@ std::vector<SearchState> EvolutionarySearch::InitSketch(int num, const std::stri
   return states;
 }
 
-SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2) {
-  // TODO(CtfGo): tracing CrossOver with IRSchedule
-  std::vector<ir::Expr> cross_over_exprs;
-  std::vector<ir::Expr> father_exprs = state1->ir_schedule.GetModule().GetExprs();
-  std::vector<ir::Expr> mother_exprs = state2->ir_schedule.GetModule().GetExprs();
+// Whether the attribute is a tunable choice of a step, which can be exchanged between two traces of the same structure
+static bool IsTunableAttr(const ir::proto::ScheduleDesc_Step& step, const std::string& attr_name) {
+  if (attr_name == "decision") {
+    return true;
+  }
+  return (step.type() == "AnnotateIntAttr" && attr_name == "value") ||
+         (step.type() == "Vectorize" && attr_name == "factor");
+}
+
+// Cross over two traces step by step, each tunable attribute of the child is taken from either parent randomly.
+// The parents must apply the same primitives on the same inputs before post schedule, otherwise false is returned.
+static bool CrossOverTraces(const ir::proto::ScheduleDesc& father,
+                            const ir::proto::ScheduleDesc& mother,
+                            ir::proto::ScheduleDesc* child,
+                            utils::LinearRandomEngine::StateType* rand_seed) {
+  auto count_steps = [](const ir::proto::ScheduleDesc& trace) {
+    int num = 0;
+    while (num < trace.steps_size() && trace.steps(num).type() != "TagPostSchedule") {
+      ++num;
+    }
+    return num;
+  };
+  int num_steps = count_steps(father);
+  if (num_steps != count_steps(mother)) {
+    return false;
+  }
 
-  CHECK_EQ(father_exprs.size(), mother_exprs.size())
-      << "CrossOver ModuleExpr in EvolutionarySearch must have same number of AST";
+  for (int i = 0; i < num_steps; ++i) {
+    const auto& father_step = father.steps(i);
+    const auto& mother_step = mother.steps(i);
+    if (father_step.type() != mother_step.type() || father_step.inputs_size() != mother_step.inputs_size() ||
+        father_step.outputs_size() != mother_step.outputs_size() ||
+        father_step.attrs_size() != mother_step.attrs_size()) {
+      return false;
+    }
+    for (int j = 0; j < father_step.inputs_size(); ++j) {
+      if (father_step.inputs(j).SerializeAsString() != mother_step.inputs(j).SerializeAsString()) {
+        return false;
+      }
+    }
 
-  for (size_t i = 0; i < father_exprs.size(); ++i) {
-    if (utils::SampleUniformInt(0, 2, &rand_seed_) == 0) {
-      cross_over_exprs.push_back(optim::IRCopy(father_exprs[i]));
-    } else {
-      cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
+    auto* new_step = child->add_steps();
+    *new_step      = father_step;
+    for (auto& attr : *new_step->mutable_attrs()) {
+      if (!IsTunableAttr(father_step, attr.name()) || utils::SampleUniformInt(0, 2, rand_seed) == 0) {
+        continue;
+      }
+      auto it = std::find_if(mother_step.attrs().begin(), mother_step.attrs().end(), [&attr](const auto& other) {
+        return other.name() == attr.name();
+      });
+      if (it == mother_step.attrs().end()) {
+        return false;
+      }
+      attr = *it;
     }
   }
-  auto res = SearchState(ir::IRSchedule(ir::ModuleExpr(cross_over_exprs), utils::ForkRandomState(&rand_seed_)));
-  if (FLAGS_auto_schedule_use_cost_model) {
-    res->predicted_cost = cost_model_.Predict(res->ir_schedule.GetModule(), tune_task_.target);
+  return true;
+}
+
+SearchState EvolutionarySearch::CrossOver(const SearchState& state1,
+                                          const SearchState& state2,
+                                          utils::LinearRandomEngine::StateType* rand_seed) {
+  ir::proto::ScheduleDesc child_trace;
+  if (!CrossOverTraces(state1->ir_schedule.GetTraceDesc().ToProto(),
+                       state2->ir_schedule.GetTraceDesc().ToProto(),
+                       &child_trace,
+                       rand_seed)) {
+    VLOG(6) << "The traces of the two states can't be crossed over, keep the first one";
+    return state1;
   }
+
+  // replay the child trace on original ModuleExpr to generate a new ir_schedule, the prefix shared with the traces
+  // replayed before is resumed from the cache
+  const auto& task_key               = tune_task_.serialized_key;
+  InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
+  ir::IRSchedule new_ir_sch;
+  try {
+    new_ir_sch = task_registry->Get(task_key)->replay_cache->Replay(
+        child_trace, /*without_post_schedule=*/true, utils::ForkRandomState(rand_seed));
+  } catch (std::exception& e) {
+    VLOG(6) << "Failed to replay the crossed trace, error: " << e.what();
+    return state1;
+  }
+  ApplyPostScheduleRules(&new_ir_sch, post_schedule_rules_);
+  auto res = SearchState(std::move(new_ir_sch));
+  // the child keeps the sketch of the first parent
+  res->sampled_arms = state1->sampled_arms;
   VLOG(5) << JoinStatesDebugString("EvolutionarySearch::CrossOver", {state1, state2, res}, /*verbose=*/VLOG_IS_ON(6));
   return res;
 }
@@ -174,14 +326,21 @@ SearchState EvolutionarySearch::Mutate(const SearchState& state, utils::LinearRa
   // apply mutation on the trace of SearchState
   auto trace     = state->ir_schedule.GetTraceDesc();
   auto new_trace = mutator->Apply(trace, rand_seed);
-  // replay the mutated trace on original ModuleExpr to generate a new ir_schedule
+  // replay the mutated trace on original ModuleExpr to generate a new ir_schedule, the steps before the mutated one
+  // are resumed from the cache
   const auto& task_key               = tune_task_.serialized_key;
   InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
-  ir::IRSchedule new_ir_sch(optim::IRCopy(task_registry->Get(task_key)->module_expr),
-                            utils::ForkRandomState(rand_seed));
-  new_trace.Replay(&new_ir_sch, true);
+  ir::IRSchedule new_ir_sch;
+  try {
+    new_ir_sch = task_registry->Get(task_key)->replay_cache->Replay(
+        new_trace.ToProto(), /*without_post_schedule=*/true, utils::ForkRandomState(rand_seed));
+  } catch (std::exception& e) {
+    VLOG(6) << "Failed to replay the mutated trace, error: " << e.what();
+    return state;
+  }
   ApplyPostScheduleRules(&new_ir_sch, post_schedule_rules_);
-  auto res = SearchState(std::move(new_ir_sch));
+  auto res          = SearchState(std::move(new_ir_sch));
+  res->sampled_arms = state->sampled_arms;
 
   VLOG(5) << JoinStatesDebugString("EvolutionarySearch::Mutate", {state, res}, /*verbose=*/VLOG_IS_ON(6));
   return res;
@@ -198,20 +357,32 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
   }
   // init evolution
   std::vector<SearchState> evolution(population);
-  for (SearchState& search_state : evolution) {
-    if (search_state->predicted_cost == SearchState::NOT_INIT_COST && FLAGS_auto_schedule_use_cost_model) {
-      search_state->predicted_cost = cost_model_.Predict(search_state->ir_schedule.GetModule(), tune_task_.target);
-    }
-  }
+  PruneByGpuResources(&evolution);
+  PredictCosts(&evolution);
   VLOG(4) << JoinStatesDebugString("EvolutionarySearch::Evolve: Init evolution:", evolution, /*verbose=*/VLOG_IS_ON(5));
-  // cross over
-  for (int i = 0; i < cross_over_num; ++i) {
-    int first_rand_idx  = utils::SampleUniformInt(0, generation_num, &rand_seed_);
-    int second_rand_idx = utils::SampleUniformInt(0, generation_num, &rand_seed_);
-    while (first_rand_idx == second_rand_idx) {
-      second_rand_idx = utils::SampleUniformInt(0, generation_num, &rand_seed_);
+  // cross over, the parents and random seeds are sampled in order ahead, so the results are
+  // deterministic though the children are generated in parallel
+  if (cross_over_num > 0) {
+    std::vector<std::pair<int, int>> parents(cross_over_num);
+    std::vector<utils::LinearRandomEngine::StateType> cross_over_seeds(cross_over_num);
+    for (int i = 0; i < cross_over_num; ++i) {
+      int first_rand_idx  = utils::SampleUniformInt(0, generation_num, &rand_seed_);
+      int second_rand_idx = utils::SampleUniformInt(0, generation_num, &rand_seed_);
+      while (first_rand_idx == second_rand_idx) {
+        second_rand_idx = utils::SampleUniformInt(0, generation_num, &rand_seed_);
+      }
+      parents[i]          = std::make_pair(first_rand_idx, second_rand_idx);
+      cross_over_seeds[i] = utils::ForkRandomState(&rand_seed_);
     }
-    evolution.push_back(CrossOver(population[first_rand_idx], population[second_rand_idx]));
+    std::vector<SearchState> children(cross_over_num);
+    auto cross_over_fn = [this, &population, &parents, &cross_over_seeds, &children](int index) {
+      children[index] =
+          CrossOver(population[parents[index].first], population[parents[index].second], &cross_over_seeds[index]);
+    };
+    utils::parallel_run(cross_over_fn, utils::SequenceDispatcher(0, cross_over_num), cross_over_num);
+    PruneByGpuResources(&children);
+    PredictCosts(&children);
+    evolution.insert(evolution.end(), children.begin(), children.end());
   }
   VLOG(4) << JoinStatesDebugString(
       "EvolutionarySearch::Evolve: after CrossOver evolution:", evolution, /*verbose=*/VLOG_IS_ON(5));
@@ -225,12 +396,8 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
     mutated_individuals[index] = Mutate(evolution[index], &rand_seeds[index]);
   };
   utils::parallel_run(mutate_fn, utils::SequenceDispatcher(0, evolution.size()), evolution.size());
-  if (FLAGS_auto_schedule_use_cost_model) {
-    for (size_t i = 0; i < mutated_individuals.size(); ++i) {
-      mutated_individuals[i]->predicted_cost =
-          cost_model_.Predict(mutated_individuals[i]->ir_schedule.GetModule(), tune_task_.target);
-    }
-  }
+  PruneByGpuResources(&mutated_individuals);
+  PredictCosts(&mutated_individuals);
   VLOG(4) << JoinStatesDebugString(
       "EvolutionarySearch::Evolve: mutated individuals:", mutated_individuals, /*verbose=*/VLOG_IS_ON(5));
   // select top ret_num with predicted cost
@@ -248,6 +415,47 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
   return selected_individuals;
 }
 
+void EvolutionarySearch::PruneByGpuResources(std::vector<SearchState>* states) const {
+  if (!gpu_limits_) {
+    return;
+  }
+  std::vector<std::string> reasons(states->size());
+  auto check_fn = [this, states, &reasons](int index) {
+    reasons[index] =
+        CheckGpuResourceUsage(AnalyzeGpuResourceUsage(states->at(index)->ir_schedule.GetModule()), *gpu_limits_);
+  };
+  utils::parallel_run(check_fn, utils::SequenceDispatcher(0, states->size()), states->size());
+
+  size_t num_valid = 0;
+  for (size_t i = 0; i < states->size(); ++i) {
+    if (reasons[i].empty()) {
+      states->at(num_valid++) = states->at(i);
+    } else {
+      VLOG(6) << "Prune state-" << i << " statically: " << reasons[i];
+    }
+  }
+  VLOG(4) << "PruneByGpuResources keeps " << num_valid << " of " << states->size() << " states";
+  states->resize(num_valid);
+}
+
+void EvolutionarySearch::PredictCosts(std::vector<SearchState>* states) const {
+  if (!FLAGS_auto_schedule_use_cost_model) {
+    return;
+  }
+  std::vector<size_t> indices;
+  std::vector<const ir::ModuleExpr*> samples;
+  for (size_t i = 0; i < states->size(); ++i) {
+    if (states->at(i)->predicted_cost == SearchState::NOT_INIT_COST) {
+      indices.push_back(i);
+      samples.push_back(&states->at(i)->ir_schedule.GetModule());
+    }
+  }
+  std::vector<float> costs = cost_model_.Predict(samples, tune_task_.target);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    states->at(indices[i])->predicted_cost = costs[i];
+  }
+}
+
 std::vector<SearchState> EvolutionarySearch::PickNextGenerationEpsGreedy(const std::vector<SearchState>& picked_bests,
                                                                          const std::vector<SearchState>& random_init,
                                                                          int num,
@@ -17,6 +17,7 @@
 #include <memory>
 #include <vector>
 
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/post_schedule_rule/post_schedule_rule.h"
@@ -79,6 +80,12 @@ class EvolutionarySearch {
    */
   std::vector<SearchState> SearchModuleExprEpsGreedy(const TuningOptions& options);
 
+  /**
+   * Add the states to the initial population of the next search, such as the population restored from a checkpoint.
+   * They are used once and take the place of the sketches.
+   */
+  void AddInitialPopulation(const std::vector<SearchState>& states);
+
 #ifdef CINN_WITH_TEST
   /**
    * Method only be called during testing. It is used to set mock search
@@ -117,7 +124,16 @@ class EvolutionarySearch {
 
   SearchState Mutate(const SearchState& state, utils::LinearRandomEngine::StateType* rand_seed);
 
-  SearchState CrossOver(const SearchState& state1, const SearchState& state2);
+  SearchState CrossOver(const SearchState& state1,
+                        const SearchState& state2,
+                        utils::LinearRandomEngine::StateType* rand_seed);
+
+  // Drop the states whose kernels statically exceed the GPU resources or are misaligned to vectorize, so that the
+  // cost model doesn't pick the candidates failing to build or launch
+  void PruneByGpuResources(std::vector<SearchState>* states) const;
+
+  // Predict the costs of the states whose predicted_cost is not initialized with the cost model in a batch
+  void PredictCosts(std::vector<SearchState>* states) const;
 
   std::vector<SearchState> Evolve(const std::vector<SearchState>& population, int cross_over_num, int ret_num);
 
@@ -139,8 +155,24 @@ class EvolutionarySearch {
   std::map<double, std::unique_ptr<MutateRule>> weighted_mutators_;
   // schedule rules used after mutation
   std::vector<std::unique_ptr<PostScheduleRule>> post_schedule_rules_;
+  // the states added by AddInitialPopulation to be used in the next search
+  std::vector<SearchState> extra_population_;
+  // the limits used by PruneByGpuResources, only set on NVGPU
+  std::unique_ptr<GpuResourceLimits> gpu_limits_;
   utils::LinearRandomEngine::StateType rand_seed_;
 };
 
+/**
+ * Adjust the tile factors sampled on a loop to a loop with the new extent, the innermost factors are kept as much as
+ * possible and the product of the results equals to the extent.
+ */
+std::vector<int> RescaleTileFactors(const std::vector<int>& factors, int extent);
+
+/**
+ * Replay the trace tuned on a task with the same structure but different shapes, the tile factors are rescaled to
+ * the new loops. Return false if the trace can't be applied.
+ */
+bool ReplayTransferredTrace(const ir::proto::ScheduleDesc& trace, ir::IRSchedule* schedule);
+
 }  // namespace auto_schedule
 }  // namespace cinn
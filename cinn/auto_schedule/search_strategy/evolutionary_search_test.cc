@@ -192,5 +192,15 @@ TEST(EvolutionarySearch, Evolve) {
   }
 }
 
+TEST(EvolutionarySearch, RescaleTileFactors) {
+  // the innermost factors are kept if they divide the new extent
+  EXPECT_EQ(RescaleTileFactors({4, 8, 4}, 256), std::vector<int>({8, 8, 4}));
+  // otherwise they are shrunk to the largest divisors
+  EXPECT_EQ(RescaleTileFactors({2, 8, 4}, 24), std::vector<int>({1, 6, 4}));
+  EXPECT_EQ(RescaleTileFactors({1, 32}, 7), std::vector<int>({1, 7}));
+  // the factor given as -1 takes the rest
+  EXPECT_EQ(RescaleTileFactors({-1, 16}, 40), std::vector<int>({-1, 10}));
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -0,0 +1,55 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_auto_unroll.h"
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::ir::ScheduleDesc;
+using ::cinn::utils::LinearRandomEngine;
+
+ScheduleDesc MutateAutoUnroll::Apply(const ScheduleDesc& trace, LinearRandomEngine::StateType* rand_seed) {
+  std::vector<ScheduleDesc::Step> steps = trace.Steps();
+  std::vector<int> unroll_step_indices;
+  for (int i = 0; i < steps.size() && steps[i].type != "TagPostSchedule"; ++i) {
+    if (steps[i].type == "AnnotateIntAttr" &&
+        absl::get<std::string>(steps[i].attrs.at("key")) == ir::attr::auto_unroll_max_step) {
+      unroll_step_indices.push_back(i);
+    }
+  }
+  if (unroll_step_indices.empty()) {
+    VLOG(6) << "MutateAutoUnroll failed, try other mutate rules.";
+    return trace;
+  }
+
+  int step_idx            = unroll_step_indices.at(utils::SampleUniformInt(0, unroll_step_indices.size(), rand_seed));
+  ScheduleDesc::Step step = steps.at(step_idx);
+  int max_step            = absl::get<int>(step.attrs.at("value"));
+  std::vector<int> candidates;
+  for (int option : AutoUnroll::kMaxStepOptions) {
+    if (option != max_step) {
+      candidates.push_back(option);
+    }
+  }
+  step.attrs["value"] = candidates.at(utils::SampleUniformInt(0, candidates.size(), rand_seed));
+  VLOG(6) << "MutateAutoUnroll: max unrolled step " << max_step << " -> " << absl::get<int>(step.attrs.at("value"));
+  return trace.ForkAndUpdate(step_idx, step, true);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_auto_unroll.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(MutateAutoUnroll, Basic) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  poly::StageMap stages = CreateStages({A, B, C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestMutateAutoUnroll_Basic", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr module_expr({funcs[0]->body});
+  // We need to fix the seed as a constant to ensure that the result can be repeated.
+  utils::LinearRandomEngine::StateType rand_seed = 123;
+  ir::IRSchedule ir_schedule(module_expr, rand_seed);
+
+  // apply schedule
+  Expr root_block = ir_schedule.GetRootBlock(ir_schedule.GetBlock("C"));
+  ir_schedule.Annotate(root_block, ir::attr::auto_unroll_max_step, 32);
+
+  // apply mutate
+  MutateAutoUnroll mutator;
+  ir::ScheduleDesc sch_desc = ir_schedule.GetTraceDesc();
+  int last_max_step         = 32;
+  for (int i = 0; i < 10; ++i) {
+    sch_desc = mutator.Apply(sch_desc, &rand_seed);
+    for (auto&& step : sch_desc.Steps()) {
+      if (step.type == "AnnotateIntAttr") {
+        int max_step = absl::get<int>(step.attrs.at("value"));
+        ASSERT_NE(max_step, last_max_step);
+        ASSERT_NE(std::find(AutoUnroll::kMaxStepOptions.begin(), AutoUnroll::kMaxStepOptions.end(), max_step),
+                  AutoUnroll::kMaxStepOptions.end());
+        last_max_step = max_step;
+      }
+    }
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
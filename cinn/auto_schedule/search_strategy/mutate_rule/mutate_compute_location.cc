@@ -0,0 +1,66 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_compute_location.h"
+
+#include <unordered_set>
+
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::ir::ScheduleDesc;
+using ::cinn::utils::LinearRandomEngine;
+
+ScheduleDesc MutateComputeLocation::Apply(const ScheduleDesc& trace, LinearRandomEngine::StateType* rand_seed) {
+  static const std::unordered_set<std::string> kComputeAtSteps = {"ComputeAt", "ReverseComputeAt", "SimpleComputeAt"};
+  std::vector<ScheduleDesc::Step> steps = trace.Steps();
+  // the indices of the compute-at steps with the other loops they can be moved to
+  std::vector<std::pair<int, std::vector<Expr>>> candidates;
+  for (int i = 0; i < steps.size() && steps[i].type != "TagPostSchedule"; ++i) {
+    if (!kComputeAtSteps.count(steps[i].type)) {
+      continue;
+    }
+    const Expr& loop = steps[i].inputs.at("loop").front();
+    int output_idx   = -1;
+    int producer_idx = FindProducerStep(steps, i, loop, &output_idx);
+    if (producer_idx < 0) {
+      continue;
+    }
+    std::vector<Expr> other_loops;
+    for (auto&& output : steps[producer_idx].outputs) {
+      if (output.As<ir::For>() && !(output == loop)) {
+        other_loops.push_back(output);
+      }
+    }
+    if (!other_loops.empty()) {
+      candidates.emplace_back(i, std::move(other_loops));
+    }
+  }
+  if (candidates.empty()) {
+    VLOG(6) << "MutateComputeLocation failed, try other mutate rules.";
+    return trace;
+  }
+
+  const auto& candidate   = candidates.at(utils::SampleUniformInt(0, candidates.size(), rand_seed));
+  const Expr& new_loop    = candidate.second.at(utils::SampleUniformInt(0, candidate.second.size(), rand_seed));
+  ScheduleDesc::Step step = steps.at(candidate.first);
+  step.inputs["loop"]     = {new_loop};
+  VLOG(6) << "MutateComputeLocation: move step " << candidate.first << " to loop:\n" << new_loop;
+  return trace.ForkAndUpdate(candidate.first, step, true);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
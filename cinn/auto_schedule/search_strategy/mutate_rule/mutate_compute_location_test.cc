@@ -0,0 +1,75 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_compute_location.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(MutateComputeLocation, Basic) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  ir::Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + Expr(1.f); }, "B");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return B(i, j) * Expr(2.f); }, "C");
+
+  poly::StageMap stages = CreateStages({A, B, C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestMutateComputeLocation_Basic", stages, {A, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr module_expr({funcs[0]->body});
+  // We need to fix the seed as a constant to ensure that the result can be repeated.
+  utils::LinearRandomEngine::StateType rand_seed = 123;
+  ir::IRSchedule ir_schedule(module_expr, rand_seed);
+  ir::IRSchedule new_ir_schedule(ir_schedule);
+
+  // apply schedule
+  auto loops = ir_schedule.GetLoops("C");
+  ir_schedule.ComputeAt(ir_schedule.GetBlock("B"), loops[1]);
+  VLOG(6) << "Expr before mutate compute location: \n" << ir_schedule.GetModule().GetExprs()[0];
+
+  // apply mutate, the only other location is the outer loop
+  MutateComputeLocation mutator;
+  ir::ScheduleDesc sch_desc = mutator.Apply(ir_schedule.GetTraceDesc(), &rand_seed);
+  for (auto&& step : sch_desc.Steps()) {
+    if (step.type == "ComputeAt") {
+      ASSERT_EQ(step.inputs.at("loop").front(), loops[0]);
+    }
+  }
+  sch_desc.Replay(&new_ir_schedule, true);
+  VLOG(6) << "Expr after mutate compute location: \n" << new_ir_schedule.GetModule().GetExprs()[0];
+
+  auto get_ir_str = [](const ir::IRSchedule* ir_sch) -> std::string {
+    std::vector<ir::Expr> exprs = ir_sch->GetModule().GetExprs();
+    EXPECT_EQ(exprs.size(), 1UL);
+    std::stringstream ss;
+    ss << exprs[0];
+    return ss.str();
+  };
+  ASSERT_NE(get_ir_str(&new_ir_schedule), get_ir_str(&ir_schedule));
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -14,7 +14,11 @@
 
 #include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_rule.h"
 
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_auto_unroll.h"
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_compute_location.h"
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_thread_binding.h"
 #include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_tile_size.h"
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_vectorize.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -22,11 +26,35 @@ namespace auto_schedule {
 std::unique_ptr<MutateRule> MutateRule::Make(const std::string& name) {
   if (name == "mutate_tile_size") {
     return std::make_unique<MutateTileSize>();
+  } else if (name == "mutate_auto_unroll") {
+    return std::make_unique<MutateAutoUnroll>();
+  } else if (name == "mutate_vectorize") {
+    return std::make_unique<MutateVectorize>();
+  } else if (name == "mutate_compute_location") {
+    return std::make_unique<MutateComputeLocation>();
+  } else if (name == "mutate_thread_binding") {
+    return std::make_unique<MutateThreadBinding>();
   } else {
     LOG(FATAL) << "MutateRule " << name << " is not supported.";
   }
   return nullptr;
 }
 
+int MutateRule::FindProducerStep(const std::vector<ir::ScheduleDesc::Step>& steps,
+                                 int end,
+                                 const Expr& expr,
+                                 int* output_idx) {
+  for (int i = end - 1; i >= 0; --i) {
+    const auto& outputs = steps[i].outputs;
+    for (int j = 0; j < outputs.size(); ++j) {
+      if (outputs[j] == expr) {
+        *output_idx = j;
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -42,6 +42,20 @@ class MutateRule {
    * @return The created MutateRule.
    */
   static std::unique_ptr<MutateRule> Make(const std::string& name);
+
+ protected:
+  /**
+   * @brief Find the step producing an Expr, which is referred as the input of a succeeding step.
+   * @param steps The steps of a trace.
+   * @param end The index of the step referring the Expr, only the steps before it are searched.
+   * @param expr The Expr to find.
+   * @param output_idx Return the index of the Expr in the outputs of the found step.
+   * @return The index of the found step, or -1 if not found.
+   */
+  static int FindProducerStep(const std::vector<ir::ScheduleDesc::Step>& steps,
+                              int end,
+                              const Expr& expr,
+                              int* output_idx);
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,126 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_thread_binding.h"
+
+#include <algorithm>
+
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule_util.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::ir::ScheduleDesc;
+using ::cinn::utils::LinearRandomEngine;
+
+// the new decisions of a SamplePerfectTile step, which change the factor at pos
+static std::vector<std::vector<int>> CollectNewDecisions(const std::vector<int>& decision,
+                                                         int pos,
+                                                         int extent,
+                                                         int max_threads) {
+  std::vector<std::vector<int>> results;
+  int free_pos = std::find(decision.begin(), decision.end(), -1) - decision.begin();
+  if (free_pos == pos) {
+    return results;
+  }
+
+  if (free_pos < decision.size()) {
+    // the factor given as -1 takes the rest, so the bound factor can be any number of threads within the extent
+    int others = 1;
+    for (int i = 0; i < decision.size(); ++i) {
+      if (i != pos && i != free_pos) {
+        others *= decision[i];
+      }
+    }
+    for (int threads = 32; threads <= max_threads && threads * others <= extent; threads *= 2) {
+      if (threads != decision[pos]) {
+        results.push_back(decision);
+        results.back()[pos] = threads;
+      }
+    }
+    return results;
+  }
+
+  // otherwise move a divisor between the bound factor and another one to keep the product
+  for (int other = 0; other < decision.size(); ++other) {
+    if (other == pos) {
+      continue;
+    }
+    for (int d = 2; d <= decision[other]; ++d) {
+      if (decision[other] % d == 0 && decision[pos] * d <= max_threads) {
+        results.push_back(decision);
+        results.back()[pos] *= d;
+        results.back()[other] /= d;
+      }
+    }
+    for (int d = 2; d <= decision[pos]; ++d) {
+      if (decision[pos] % d == 0) {
+        results.push_back(decision);
+        results.back()[pos] /= d;
+        results.back()[other] *= d;
+      }
+    }
+  }
+  return results;
+}
+
+ScheduleDesc MutateThreadBinding::Apply(const ScheduleDesc& trace, LinearRandomEngine::StateType* rand_seed) {
+  std::vector<ScheduleDesc::Step> steps = trace.Steps();
+  // the index of the SamplePerfectTile step with the position of the factor that determines a bound loop,
+  // the loop is bound by Bind(Split(loop, SamplePerfectTile(loop))[pos], "threadIdx.*")
+  std::vector<std::pair<int, int>> bound_tiles;
+  for (int i = 0; i < steps.size() && steps[i].type != "TagPostSchedule"; ++i) {
+    if (steps[i].type != "Bind") {
+      continue;
+    }
+    const auto& thread_axis = absl::get<std::string>(steps[i].attrs.at("thread_axis"));
+    if (thread_axis.rfind("threadIdx", 0) != 0) {
+      continue;
+    }
+    int loop_pos  = -1;
+    int split_idx = FindProducerStep(steps, i, steps[i].inputs.at("loop").front(), &loop_pos);
+    if (split_idx < 0 || steps[split_idx].type != "Split") {
+      continue;
+    }
+    const Expr& factor = steps[split_idx].inputs.at("factors").at(loop_pos);
+    int factor_pos     = -1;
+    int tile_idx       = FindProducerStep(steps, split_idx, factor, &factor_pos);
+    if (tile_idx >= 0 && steps[tile_idx].type == "SamplePerfectTile") {
+      bound_tiles.emplace_back(tile_idx, factor_pos);
+    }
+  }
+  if (bound_tiles.empty()) {
+    VLOG(6) << "MutateThreadBinding failed, try other mutate rules.";
+    return trace;
+  }
+
+  const auto& bound_tile         = bound_tiles.at(utils::SampleUniformInt(0, bound_tiles.size(), rand_seed));
+  const ScheduleDesc::Step& step = steps.at(bound_tile.first);
+  std::vector<int> decision      = absl::get<std::vector<int>>(step.attrs.at("decision"));
+  int extent                     = ir::GetLoopExtent(step.inputs.at("loop").front());
+  auto new_decisions             = CollectNewDecisions(decision, bound_tile.second, extent, kMaxThreads);
+  if (new_decisions.empty()) {
+    VLOG(6) << "Unable to mutate, return the original trace";
+    return trace;
+  }
+  auto&& new_decision = new_decisions.at(utils::SampleUniformInt(0, new_decisions.size(), rand_seed));
+  VLOG(6) << "MutateThreadBinding: decision of step " << bound_tile.first << " [" << utils::Join(decision, ", ")
+          << "] -> [" << utils::Join(new_decision, ", ") << "]";
+  return trace.ForkAndUpdate(bound_tile.first, new_decision, true);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_thread_binding.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(MutateThreadBinding, Basic) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  const int kSize = 256;
+  Expr M(32);
+  Expr N(kSize);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  poly::StageMap stages = CreateStages({A, B, C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestMutateThreadBinding_Basic", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr module_expr({funcs[0]->body});
+  // We need to fix the seed as a constant to ensure that the result can be repeated.
+  utils::LinearRandomEngine::StateType rand_seed = 123;
+  ir::IRSchedule ir_schedule(module_expr, rand_seed);
+
+  // apply schedule
+  auto loops   = ir_schedule.GetLoops("C");
+  auto factors = ir_schedule.SamplePerfectTile(loops[1], 2, kSize);
+  auto splited = ir_schedule.Split(loops[1], factors);
+  ir_schedule.Bind(splited[1], "threadIdx.x");
+
+  // apply mutate, the extent of the bound loop changes while the product of factors is kept
+  MutateThreadBinding mutator;
+  ir::ScheduleDesc sch_desc = ir_schedule.GetTraceDesc();
+  std::vector<int> last_tile_factors;
+  for (auto&& step : sch_desc.Steps()) {
+    if (step.type == "SamplePerfectTile") {
+      last_tile_factors = absl::get<std::vector<int>>(step.attrs.at("decision"));
+    }
+  }
+  for (int i = 0; i < 10; ++i) {
+    sch_desc = mutator.Apply(sch_desc, &rand_seed);
+    for (auto&& step : sch_desc.Steps()) {
+      if (step.type == "SamplePerfectTile") {
+        std::vector<int> tile_factors = absl::get<std::vector<int>>(step.attrs.at("decision"));
+        ASSERT_EQ(tile_factors.size(), 2UL);
+        ASSERT_NE(tile_factors[1], last_tile_factors[1]);
+        ASSERT_LE(tile_factors[1], MutateThreadBinding::kMaxThreads);
+        ASSERT_EQ(tile_factors[0] * tile_factors[1], kSize);
+        last_tile_factors = tile_factors;
+      }
+    }
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,60 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_vectorize.h"
+
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule_util.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::ir::ScheduleDesc;
+using ::cinn::utils::LinearRandomEngine;
+
+ScheduleDesc MutateVectorize::Apply(const ScheduleDesc& trace, LinearRandomEngine::StateType* rand_seed) {
+  std::vector<ScheduleDesc::Step> steps = trace.Steps();
+  // the indices of the Vectorize steps with their optional new factors
+  std::vector<std::pair<int, std::vector<int>>> candidates;
+  for (int i = 0; i < steps.size() && steps[i].type != "TagPostSchedule"; ++i) {
+    if (steps[i].type != "Vectorize") {
+      continue;
+    }
+    int extent = ir::GetLoopExtent(steps[i].inputs.at("loop").front());
+    int factor = absl::get<int>(steps[i].attrs.at("factor"));
+    std::vector<int> new_factors;
+    for (int f = 2; f <= kMaxFactor && f <= extent; f *= 2) {
+      if (extent % f == 0 && f != factor) {
+        new_factors.push_back(f);
+      }
+    }
+    if (!new_factors.empty()) {
+      candidates.emplace_back(i, std::move(new_factors));
+    }
+  }
+  if (candidates.empty()) {
+    VLOG(6) << "MutateVectorize failed, try other mutate rules.";
+    return trace;
+  }
+
+  const auto& candidate   = candidates.at(utils::SampleUniformInt(0, candidates.size(), rand_seed));
+  ScheduleDesc::Step step = steps.at(candidate.first);
+  step.attrs["factor"]    = candidate.second.at(utils::SampleUniformInt(0, candidate.second.size(), rand_seed));
+  VLOG(6) << "MutateVectorize: new factor of step " << candidate.first << " is "
+          << absl::get<int>(step.attrs.at("factor"));
+  return trace.ForkAndUpdate(candidate.first, step, true);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_strategy/mutate_rule/mutate_vectorize.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(MutateVectorize, Basic) {
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(32);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  poly::StageMap stages = CreateStages({A, B, C});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestMutateVectorize_Basic", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr module_expr({funcs[0]->body});
+  // We need to fix the seed as a constant to ensure that the result can be repeated.
+  utils::LinearRandomEngine::StateType rand_seed = 123;
+  ir::IRSchedule ir_schedule(module_expr, rand_seed);
+  ir::IRSchedule new_ir_schedule(ir_schedule);
+
+  // apply schedule
+  auto loops = ir_schedule.GetLoops("C");
+  ir_schedule.Vectorize(loops[1], 4);
+
+  // apply mutate
+  MutateVectorize mutator;
+  ir::ScheduleDesc sch_desc = mutator.Apply(ir_schedule.GetTraceDesc(), &rand_seed);
+  sch_desc.Replay(&new_ir_schedule, true);
+  VLOG(6) << "Expr after mutate vectorize: \n" << new_ir_schedule.GetModule().GetExprs()[0];
+
+  int last_factor = 4;
+  for (int i = 0; i < 10; ++i) {
+    for (auto&& step : sch_desc.Steps()) {
+      if (step.type == "Vectorize") {
+        int factor = absl::get<int>(step.attrs.at("factor"));
+        ASSERT_NE(factor, last_factor);
+        ASSERT_LE(factor, MutateVectorize::kMaxFactor);
+        ASSERT_EQ(32 % factor, 0);
+        last_factor = factor;
+      }
+    }
+    sch_desc = mutator.Apply(sch_desc, &rand_seed);
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -16,8 +16,11 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/hlir/framework/graph.h"
@@ -53,5 +56,72 @@ std::vector<TuneTask> TaskCreator::CreateTuneTaskOpLevel(Graph* graph) {
   return ret_tasks;
 }
 
+namespace {
+// Sort the sub groups so that each one follows the sub groups producing its inputs.
+std::vector<std::shared_ptr<Graph::Group>> SortSubGroups(const std::vector<std::shared_ptr<Graph::Group>>& sub_groups) {
+  std::unordered_map<Node*, int> node2sub_group;
+  for (int i = 0; i < sub_groups.size(); ++i) {
+    for (auto* node : sub_groups[i]->CollectNodes()) {
+      node2sub_group[node] = i;
+    }
+  }
+  std::vector<std::unordered_set<int>> producers(sub_groups.size());
+  for (int i = 0; i < sub_groups.size(); ++i) {
+    for (auto* node : sub_groups[i]->CollectNodes()) {
+      for (auto& edge : node->inlinks()) {
+        auto* source = edge->source()->safe_as<NodeData>()->source_node.get();
+        auto it      = node2sub_group.find(source);
+        if (source && it != node2sub_group.end() && it->second != i) {
+          producers[i].insert(it->second);
+        }
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<Graph::Group>> sorted;
+  std::vector<bool> visited(sub_groups.size(), false);
+  while (sorted.size() < sub_groups.size()) {
+    bool found = false;
+    for (int i = 0; i < sub_groups.size(); ++i) {
+      if (visited[i] || std::any_of(producers[i].begin(), producers[i].end(), [&](int p) { return !visited[p]; })) {
+        continue;
+      }
+      visited[i] = true;
+      sorted.push_back(sub_groups[i]);
+      found = true;
+    }
+    CHECK(found) << "The sub groups depend on each other in a cycle!";
+  }
+  return sorted;
+}
+}  // namespace
+
+std::vector<SplitCandidate> TaskCreator::CreateSplitCandidates(Graph* graph, std::vector<TuneTask>* tasks) {
+  const auto& groups = graph->fusion_groups;
+  CHECK_GE(tasks->size(), groups.size()) << "The tasks of the fusion groups should be created first";
+  std::vector<SplitCandidate> candidates;
+  for (int i = 0; i < groups.size(); ++i) {
+    const auto& group = groups[i];
+    CHECK(tasks->at(i).subgraph == group) << "The task " << i << " isn't created from the fusion group " << i;
+    const auto& sub_groups = group->fused_sub_groups;
+    auto is_shared         = [](const std::shared_ptr<Graph::Group>& sub) { return sub->belong_groups.size() != 1; };
+    if (sub_groups.size() <= 1 || std::any_of(sub_groups.begin(), sub_groups.end(), is_shared)) {
+      continue;
+    }
+
+    SplitCandidate candidate;
+    candidate.task_id = i;
+    for (auto& sub_group : SortSubGroups(sub_groups)) {
+      candidate.sub_task_ids.push_back(tasks->size());
+      tasks->emplace_back(TuneTask());
+      tasks->back().subgraph = sub_group;
+      tasks->back().target   = graph->target_;
+    }
+    VLOG(3) << "Group " << group->group_id << " can be split into " << sub_groups.size() << " sub groups";
+    candidates.push_back(std::move(candidate));
+  }
+  return candidates;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
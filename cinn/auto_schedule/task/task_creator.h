@@ -24,12 +24,30 @@
 namespace cinn {
 namespace auto_schedule {
 
+/**
+ * A candidate of graph tuning: a fused group of the graph is either compiled as a whole, or split into its sub groups
+ * compiled one by one, whichever of them runs faster after their schedules are tuned.
+ */
+struct SplitCandidate {
+  // The index of the task of the fused group
+  int task_id;
+  // The indices of the tasks of the sub groups, in the topological order
+  std::vector<int> sub_task_ids;
+};
+
 /**
  * Class to create auto tune task.
  */
 class TaskCreator {
  public:
   std::vector<TuneTask> CreateTuneTaskOpLevel(hlir::framework::Graph* graph);
+
+  /**
+   * Append the tasks of the sub groups of the fused groups to tasks, and return the split candidates of them. The first
+   * tasks should be the ones created by CreateTuneTaskOpLevel, in the order of the fusion groups of the graph. A fused
+   * group whose sub groups are shared by the other groups can't be split.
+   */
+  std::vector<SplitCandidate> CreateSplitCandidates(hlir::framework::Graph* graph, std::vector<TuneTask>* tasks);
 };
 
 }  // namespace auto_schedule
@@ -25,6 +25,8 @@
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -68,5 +70,39 @@ TEST(TaskCreator, Basic) {
   }
 }
 
+TEST(TaskCreator, SplitCandidates) {
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  NetBuilder builder("net_builder");
+  auto a = builder.CreateInput(Float(32), {32, 32}, "A");
+  auto b = builder.CreateInput(Float(32), {32, 32}, "B");
+  auto c = builder.CreateInput(Float(32), {32, 32}, "C");
+  auto d = builder.CreateInput(Float(32), {32, 32}, "D");
+  auto e = builder.Add(a, b);
+  auto f = builder.Add(e, c);
+  auto g = builder.Add(e, d);
+
+  Program prog = builder.Build();
+  auto graph   = std::make_shared<hlir::framework::Graph>(prog, target);
+  hlir::framework::ApplyPasses(graph.get(), {"OpFusionPass", "FusionMergePass"});
+  ASSERT_EQ(graph->fusion_groups.size(), 1UL);
+
+  TaskCreator task_creator;
+  std::vector<TuneTask> tasks            = task_creator.CreateTuneTaskOpLevel(graph.get());
+  std::vector<SplitCandidate> candidates = task_creator.CreateSplitCandidates(graph.get(), &tasks);
+
+  // the fused group can be split into the groups of the three adds, and the one of e is the first
+  ASSERT_EQ(candidates.size(), 1UL);
+  ASSERT_EQ(candidates[0].task_id, 0);
+  ASSERT_EQ(candidates[0].sub_task_ids, std::vector<int>({1, 2, 3}));
+  ASSERT_EQ(tasks.size(), 4UL);
+  auto first_nodes = tasks[1].subgraph->CollectNodes();
+  ASSERT_EQ(first_nodes.size(), 1UL);
+  ASSERT_EQ(first_nodes[0]->outlinks_in_order()[0]->sink()->id(), e->id);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
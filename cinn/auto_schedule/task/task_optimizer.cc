@@ -16,13 +16,16 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <functional>
 #include <limits>
+#include <set>
 
 #include "cinn/auto_schedule/analysis/analyze_ir.h"
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
+#include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/hlir/op/external_api_registry.h"
@@ -30,6 +33,7 @@
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/runtime/flags.h"
@@ -41,6 +45,7 @@
 #endif
 
 DECLARE_bool(auto_schedule_use_cost_model);
+DECLARE_bool(auto_schedule_use_bandit_sampler);
 
 namespace cinn {
 namespace auto_schedule {
@@ -97,6 +102,63 @@ FunctionGroup TaskOptimizer::Optimize(const TuningOptions& options) {
   return best.functions;
 }
 
+FunctionGroup TaskOptimizer::LowerBestRecorded() {
+  CHECK(task_->subgraph != nullptr) << "subgraph can't be empty";
+  auto records = database_->GetTopK(task_->serialized_key, 1);
+  if (records.empty() || IsForbiddenToTune(task_) || IsWrappedByCustomCall(task_)) {
+    auto initial_input_names      = task_->subgraph->input_names;
+    auto initial_output_names     = task_->subgraph->output_names;
+    FunctionGroup functions       = task_->op_lowerer->Lower(task_->subgraph);
+    task_->subgraph->input_names  = initial_input_names;
+    task_->subgraph->output_names = initial_output_names;
+    return functions;
+  }
+
+  // the states replayed in tuning are cached, so only the steps after the last cached state are replayed
+  auto ir_sch = InitialTaskRegistry::Global()->Get(task_->serialized_key)->replay_cache->Replay(records.front().trace);
+  std::vector<ir::Expr> best_exprs = ir_sch.GetModule().GetExprs();
+  FunctionGroup functions          = optim::IRCopy(task_->lowered_funcs);
+  CHECK_EQ(best_exprs.size(), functions.size()) << "The record doesn't match the task:\n" << task_->serialized_key;
+  for (size_t i = 0; i < functions.size(); ++i) {
+    functions[i] = UpdateFuncWithNewBody(task_->target, functions[i], best_exprs[i]);
+  }
+  VLOG(4) << "Lower with the best record of cost=" << records.front().execution_cost;
+  return functions;
+}
+
+void TaskOptimizer::SaveState(const std::string& cost_model_path, proto::TaskOptimizerState* state) {
+  state->set_task_key(task_->serialized_key);
+  state->set_rand_seed(rand_seed_);
+  // the population restored but not searched yet is kept for the next resuming
+  const auto& population = resumed_population_.empty() ? last_population_ : resumed_population_;
+  for (const auto& search_state : population) {
+    *state->add_population() = TuningRecord(task_->serialized_key, search_state, 0.0).ToProto();
+  }
+  if (cost_model_.IsTrained()) {
+    cost_model_.Save(cost_model_path);
+    state->set_cost_model_path(cost_model_path);
+  }
+}
+
+void TaskOptimizer::LoadState(const proto::TaskOptimizerState& state) {
+  CHECK_EQ(state.task_key(), task_->serialized_key) << "The checkpoint doesn't match the task";
+  rand_seed_ = utils::LinearRandomEngine::NormalizeState(state.rand_seed());
+  resumed_population_.clear();
+  auto* replay_cache = InitialTaskRegistry::Global()->Get(task_->serialized_key)->replay_cache.get();
+  for (const auto& record : state.population()) {
+    auto ir_sch =
+        replay_cache->Replay(record.trace(), /*without_post_schedule=*/false, utils::ForkRandomState(&rand_seed_));
+    resumed_population_.emplace_back(SearchState(std::move(ir_sch), record.predicted_cost()));
+  }
+  if (!state.cost_model_path().empty()) {
+    cost_model_.Load(state.cost_model_path());
+  }
+  VLOG(4) << "Resume the task with population size=" << resumed_population_.size()
+          << ", cost model trained=" << cost_model_.IsTrained();
+}
+
+void TaskOptimizer::LoadCostModel(const std::string& path) { cost_model_.Load(path); }
+
 TaskOptimizer::Result TaskOptimizer::OptimizeByManual(bool need_measured) {
   static constexpr char* kManualMeasuredKeyPrefix = "@ManualMeasured:\n";
   TaskOptimizer::Result result("Manual");
@@ -180,7 +242,10 @@ bool IsForbiddenToTune(const TuneTask* task) {
 bool HasExternalApi(const TuneTask* task) {
   auto nodes       = task->subgraph->CollectNodes();
   auto* first_node = nodes.front();
-  if (nodes.size() == 1 && ExternalApiRegistry::Global()->Has(first_node->op()->name, task->target)) {
+  // the filter of the external api checks the graph, which is not kept by the task, so these ops are skipped
+  const auto& op_name = first_node->op()->name;
+  if (nodes.size() == 1 && ExternalApiRegistry::Global()->Has(op_name, task->target) &&
+      !ExternalApiRegistry::Global()->HasFilter(op_name, task->target)) {
     return true;
   }
   return false;
@@ -216,6 +281,10 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(const TuningOptions& op
     evolutionary_search_ =
         std::make_unique<EvolutionarySearch>(*task_, cost_model_, database_, utils::ForkRandomState(&rand_seed_));
   }
+  if (!resumed_population_.empty()) {
+    evolutionary_search_->AddInitialPopulation(resumed_population_);
+    resumed_population_.clear();
+  }
 
   TaskOptimizer::Result result("Evolution");
   auto& optimized_funcs = result.functions;
@@ -225,6 +294,7 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(const TuningOptions& op
   if (options.num_measure_trials == 0) {  // no need to measure and simply return the best searched
     std::vector<MeasureInput> measure_candidates;
     std::vector<SearchState> states = SearchOneRound(options, &measure_candidates);
+    last_population_                = states;
     if (!states.empty()) {
       if (FLAGS_auto_schedule_use_cost_model) {
         best_cost = cost_model_.Predict(states.front()->ir_schedule.GetModule(), task_->target);
@@ -255,34 +325,58 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(const TuningOptions& op
       }
     }
     continuous_empty_cnt = 0;  // reset if get valid candidates
+    last_population_     = states;
 
+    // the candidates clearly slower than the best, including the ones of previous rounds, can be stopped in advance
+    auto best_records    = database_->GetTopK(task_->serialized_key, 1);
+    double previous_best = best_records.empty() ? best_cost : std::min(best_cost, best_records.front().execution_cost);
+    for (auto&& input : measure_inputs) {
+      input.best_cost = previous_best;
+    }
     VLOG(4) << "ScheduleMeasurer start with input size=" << measure_inputs.size();
     std::vector<MeasureResult> measure_outputs = schedule_measurer_->Measure(measure_inputs);
     CHECK_EQ(measure_outputs.size(), states.size())
         << "ScheduleMeasurer didn't output same number of MeasureOutput of states in TaskOptimizer";
-    // record to database
+    // record to database, the failed candidates, such as the ones rejected for spilling the registers, have no cost
+    double worst_cost = 0.0;
     for (size_t i = 0; i < states.size(); ++i) {
+      if (!measure_outputs[i].error_msg.empty()) {
+        VLOG(4) << "Candidate " << i << " failed: " << measure_outputs[i].error_msg;
+        continue;
+      }
+      worst_cost = std::max(worst_cost, measure_outputs[i].execution_cost);
       database_->AddRecord(
           TuningRecord(measure_inputs[i].task->serialized_key, states[i], measure_outputs[i].execution_cost));
     }
 
-    // update cost model
+    // update cost model, the failed candidates are labeled as the slowest of this round so that the cost model learns
+    // to avoid the spilling schedules
     if (FLAGS_auto_schedule_use_cost_model) {
-      std::vector<const ir::ModuleExpr*> cost_model_samples(states.size());
-      std::vector<float> cost_model_labels(states.size());
+      std::vector<const ir::ModuleExpr*> cost_model_samples;
+      std::vector<float> cost_model_labels;
       for (size_t i = 0; i < states.size(); ++i) {
-        cost_model_samples[i] = &(states[i]->ir_schedule.GetModule());
-        cost_model_labels[i]  = measure_outputs[i].execution_cost;
+        bool failed = !measure_outputs[i].error_msg.empty();
+        if (failed && worst_cost <= 0.0) {
+          continue;
+        }
+        cost_model_samples.push_back(&(states[i]->ir_schedule.GetModule()));
+        cost_model_labels.push_back(failed ? worst_cost : measure_outputs[i].execution_cost);
       }
       VLOG(4) << utils::StringFormat("Update CostModel with samples size=%lu,labels size=%lu",
                                      cost_model_samples.size(),
                                      cost_model_labels.size());
-      cost_model_.Update(cost_model_samples, cost_model_labels, task_->target);
+      if (!cost_model_samples.empty()) {
+        cost_model_.Update(cost_model_samples, cost_model_labels, task_->target);
+      }
+    }
+
+    if (FLAGS_auto_schedule_use_bandit_sampler) {
+      UpdateSamplingPrior(states, measure_outputs, previous_best);
     }
 
     // update the best
     for (size_t i = 0; i < measure_outputs.size(); ++i) {
-      if (measure_outputs[i].execution_cost < best_cost) {
+      if (measure_outputs[i].error_msg.empty() && measure_outputs[i].execution_cost < best_cost) {
         VLOG(4) << "Update best candidate with execution_cost:" << measure_outputs[i].execution_cost << "us";
         best_cost       = measure_outputs[i].execution_cost;
         optimized_funcs = measure_inputs[i].lowered_funcs;
@@ -295,6 +389,26 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(const TuningOptions& op
   return result;
 }
 
+void TaskOptimizer::UpdateSamplingPrior(const std::vector<SearchState>& states,
+                                        const std::vector<MeasureResult>& measure_outputs,
+                                        double previous_best) {
+  // a candidate as fast as the best one before this round earns the full reward, a failed one earns nothing
+  SamplingPrior rewards;
+  for (size_t i = 0; i < states.size(); ++i) {
+    double reward = 0.0;
+    if (measure_outputs[i].error_msg.empty()) {
+      reward = std::min(1.0, previous_best / measure_outputs[i].execution_cost);
+    }
+    std::set<std::string> arms(states[i]->sampled_arms.begin(), states[i]->sampled_arms.end());
+    for (auto&& arm : arms) {
+      rewards.Update(arm, reward);
+    }
+  }
+  if (!rewards.empty()) {
+    database_->UpdateSamplingPrior(task_->serialized_key, rewards);
+  }
+}
+
 std::vector<SearchState> TaskOptimizer::SearchOneRound(const TuningOptions& options,
                                                        std::vector<MeasureInput>* measure_candidates) {
   std::vector<SearchState> states = evolutionary_search_->SearchModuleExprEpsGreedy(options);
@@ -15,7 +15,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "cinn/auto_schedule/auto_schedule.pb.h"
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
@@ -40,6 +43,19 @@ class TaskOptimizer {
 
   FunctionGroup Optimize(const TuningOptions& options);
 
+  // Lower the task with the best schedule recorded in the database, or the default schedule if no record,
+  // used for the tasks not tuned again after resuming from a checkpoint
+  FunctionGroup LowerBestRecorded();
+
+  // Save the search states, the cost model is saved to the file of cost_model_path if trained
+  void SaveState(const std::string& cost_model_path, proto::TaskOptimizerState* state);
+
+  // Restore the search states saved by SaveState, the population is used to initialize the next search
+  void LoadState(const proto::TaskOptimizerState& state);
+
+  // Start the cost model from the one saved in path, such as a pretrained one, it is fine-tuned by the measurements
+  void LoadCostModel(const std::string& path);
+
  private:
   struct Result {
     std::string from;
@@ -55,6 +71,12 @@ class TaskOptimizer {
   // call search candidates once by EvolutionarySearch and prune invalid ones
   std::vector<SearchState> SearchOneRound(const TuningOptions& options, std::vector<MeasureInput>* measure_candidates);
 
+  // reward the sketch rules and the blocks sampled to generate the measured states with their speed relative to the
+  // best cost before this round, and merge the rewards into the sampling prior of the task in the database
+  void UpdateSamplingPrior(const std::vector<SearchState>& states,
+                           const std::vector<MeasureResult>& measure_outputs,
+                           double previous_best);
+
  private:
   // the max retry times if continuously get empty result
   static constexpr uint32_t kMaxRetryContinuousEmpty_ = 3;
@@ -64,6 +86,10 @@ class TaskOptimizer {
   ExprCostModel cost_model_;
   Database* database_;
   utils::LinearRandomEngine::StateType rand_seed_;
+  // the candidates searched in the last round
+  std::vector<SearchState> last_population_;
+  // the population restored by LoadState, passed to the next search
+  std::vector<SearchState> resumed_population_;
 };
 
 }  // namespace auto_schedule
@@ -16,6 +16,7 @@
 
 #include <gflags/gflags.h>
 
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -30,9 +31,13 @@ namespace auto_schedule {
 struct InitialTaskInfo {
   std::string task_key;
   ir::ModuleExpr module_expr;
+  // replay the traces of the task on copies of module_expr, reusing the states of the prefixes replayed before
+  std::unique_ptr<ir::ScheduleReplayCache> replay_cache;
 
   InitialTaskInfo(const std::string& task_key, const ir::ModuleExpr& module_expr)
-      : task_key(task_key), module_expr(module_expr) {}
+      : task_key(task_key),
+        module_expr(module_expr),
+        replay_cache(std::make_unique<ir::ScheduleReplayCache>(module_expr)) {}
 };
 
 // Global task registry, used to save the initial ModuleExpr of each task.
@@ -0,0 +1,129 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/task_scheduler/gradient_based.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace cinn {
+namespace auto_schedule {
+
+GradientBased::GradientBased(const std::vector<TuneTask>& tasks, const Config& config)
+    : TaskScheduler(tasks, config), task_to_group_(tasks.size()) {
+  std::unordered_map<std::string, int> key_to_group;
+  for (int i = 0; i < tasks.size(); ++i) {
+    auto it = key_to_group.emplace(tasks[i].serialized_key, groups_.size()).first;
+    if (it->second == groups_.size()) {
+      groups_.emplace_back();
+    }
+    groups_[it->second].task_ids.push_back(i);
+    task_to_group_[i] = it->second;
+  }
+}
+
+double GradientBased::EstimateGain(const TaskGroup& group) const {
+  const auto& costs = group.best_costs;
+  int n             = costs.size();
+  int window        = std::min(config_.gradient_backward_window, n - 1);
+  double backward   = window > 0 ? (costs[n - 1 - window] - costs[n - 1]) / window : 0.0;
+  double forward    = costs[n - 1] / n;
+  double alpha      = config_.gradient_backward_weight;
+  return group.task_ids.size() * (alpha * backward + (1 - alpha) * forward);
+}
+
+int GradientBased::NextTaskId() {
+  if (!timer_started_) {
+    timer_.Start();
+    timer_started_ = true;
+  }
+  // each round makes the same number of selections as tuning every task once
+  if (cur_task_id_ >= tasks_->size()) {
+    return -1;
+  }
+  if (config_.time_limit_seconds > 0 && ElapsedMs() > config_.time_limit_seconds * 1000) {
+    VLOG(3) << "GradientBased: the tuning deadline of " << config_.time_limit_seconds << " seconds is reached";
+    return -1;
+  }
+  ++cur_task_id_;
+
+  // tune every group once at first
+  auto untuned = std::find_if(groups_.begin(), groups_.end(), [](const auto& group) { return group.num_tuned == 0; });
+  int selected = untuned != groups_.end() ? untuned - groups_.begin() : -1;
+  if (selected == -1) {
+    double max_gain      = std::numeric_limits<double>::lowest();
+    double total_latency = 0.0;
+    for (int i = 0; i < groups_.size(); ++i) {
+      // the groups without any cost reported(not measured or not tunable) are skipped
+      if (groups_[i].best_costs.empty()) {
+        continue;
+      }
+      double gain = EstimateGain(groups_[i]);
+      total_latency += groups_[i].task_ids.size() * groups_[i].best_costs.back();
+      if (gain > max_gain) {
+        max_gain = gain;
+        selected = i;
+      }
+    }
+    VLOG(4) << "GradientBased: estimated end-to-end latency=" << total_latency << ", select group-" << selected
+            << " with gain=" << max_gain;
+  }
+  // fall back to the least tuned group if no cost can be compared
+  if (selected == -1) {
+    selected = std::min_element(groups_.begin(),
+                                groups_.end(),
+                                [](const auto& lhs, const auto& rhs) { return lhs.num_tuned < rhs.num_tuned; }) -
+               groups_.begin();
+  }
+
+  // the occurrences of a group are tuned in turn
+  auto& group = groups_[selected];
+  return group.task_ids[group.num_tuned++ % group.task_ids.size()];
+}
+
+double GradientBased::ElapsedMs() const {
+  return timer_started_ ? resumed_elapsed_ms_ + timer_.Stop() : resumed_elapsed_ms_;
+}
+
+void GradientBased::SaveState(proto::TaskSchedulerState* state) const {
+  TaskScheduler::SaveState(state);
+  for (const auto& group : groups_) {
+    auto* group_state = state->add_groups();
+    group_state->set_num_tuned(group.num_tuned);
+    *group_state->mutable_best_costs() = {group.best_costs.begin(), group.best_costs.end()};
+  }
+  state->set_elapsed_seconds(ElapsedMs() / 1000);
+}
+
+void GradientBased::LoadState(const proto::TaskSchedulerState& state) {
+  TaskScheduler::LoadState(state);
+  CHECK_EQ(state.groups_size(), groups_.size()) << "The checkpoint doesn't match the tasks to schedule";
+  for (int i = 0; i < groups_.size(); ++i) {
+    groups_[i].num_tuned = state.groups(i).num_tuned();
+    groups_[i].best_costs.assign(state.groups(i).best_costs().begin(), state.groups(i).best_costs().end());
+  }
+  resumed_elapsed_ms_ = state.elapsed_seconds() * 1000;
+  timer_started_      = false;
+}
+
+void GradientBased::UpdateTaskCost(int task_id, double cost) {
+  auto& costs = groups_.at(task_to_group_.at(task_id)).best_costs;
+  costs.push_back(costs.empty() ? cost : std::min(cost, costs.back()));
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
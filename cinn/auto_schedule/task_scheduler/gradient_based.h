@@ -0,0 +1,76 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Schedule tasks with gradient_based strategy, that is picking the task
+// expected to reduce the end-to-end latency most in the next tuning.
+//
+// Tasks with the same serialized_key are regarded as occurrences of one task,
+// the end-to-end latency is estimated as the sum of occurrence count multiplied
+// by the best latency of each task. The gain of tuning a task once more is the
+// occurrence count multiplied by a mix of the latency reduction in the recent
+// tunings(backward) and an optimistic guess that the latency keeps decreasing
+// as 1/t(forward), as the task allocation in Ansor.
+class GradientBased : public TaskScheduler {
+ public:
+  GradientBased(const std::vector<TuneTask>& tasks, const Config& config);
+
+  const char* Name() const override { return "gradient_based"; };
+
+  int NextTaskId() override;
+
+  void UpdateTaskCost(int task_id, double cost) override;
+
+  void SaveState(proto::TaskSchedulerState* state) const override;
+
+  void LoadState(const proto::TaskSchedulerState& state) override;
+
+ private:
+  // The tasks of the same serialized_key
+  struct TaskGroup {
+    std::vector<int> task_ids;
+    // The number of times tuned
+    int num_tuned = 0;
+    // The best cost after each tuning, empty if no cost is reported
+    std::vector<double> best_costs;
+  };
+
+  // The expected reduction of end-to-end latency by tuning the group once more
+  double EstimateGain(const TaskGroup& group) const;
+
+  // The tuning time spent so far including the time before resuming, in milliseconds
+  double ElapsedMs() const;
+
+  std::vector<TaskGroup> groups_;
+  // The index of the group that each task belongs to
+  std::vector<int> task_to_group_;
+  // The timer started at the first selection, used to check the deadline
+  mutable utils::Timer timer_;
+  bool timer_started_ = false;
+  // The tuning time spent before resuming from a checkpoint, in milliseconds
+  double resumed_elapsed_ms_ = 0.0;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -18,6 +18,7 @@
 
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
+#include "cinn/auto_schedule/task_scheduler/gradient_based.h"
 #include "cinn/auto_schedule/task_scheduler/round_robin.h"
 
 namespace cinn {
@@ -31,6 +32,8 @@ std::unique_ptr<TaskScheduler> TaskScheduler::Make(const std::vector<TuneTask>&
     return std::make_unique<RoundRobin>(tasks, config);
   } else if (strategy == "efficiency_priority") {
     return std::make_unique<EfficiencyPriority>(tasks, config);
+  } else if (strategy == "gradient_based") {
+    return std::make_unique<GradientBased>(tasks, config);
   }
 
   LOG(FATAL) << "Unimplemented strategy:" << strategy;
@@ -42,5 +45,9 @@ TaskScheduler::TaskScheduler(const std::vector<TuneTask>& tasks, const Config& c
 
 void TaskScheduler::Reset() { cur_task_id_ = 0; }
 
+void TaskScheduler::SaveState(proto::TaskSchedulerState* state) const { state->set_cur_task_id(cur_task_id_); }
+
+void TaskScheduler::LoadState(const proto::TaskSchedulerState& state) { cur_task_id_ = state.cur_task_id(); }
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 
+#include "cinn/auto_schedule/auto_schedule.pb.h"
 #include "cinn/auto_schedule/task/task_optimizer.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
@@ -34,6 +35,13 @@ class TaskScheduler {
   struct Config {
     // The minimum threshold of earnings ratio, used by EfficiencyPriority
     float minimum_gain_threshold = 0.0;
+    // The weight of the latency reduction in recent tunings when estimating
+    // the gain of a task, the rest is given to the optimistic guess, used by GradientBased
+    float gradient_backward_weight = 0.2;
+    // The number of recent tunings to compute the latency reduction, used by GradientBased
+    int gradient_backward_window = 3;
+    // The wall-clock deadline of tuning in seconds, 0 means no limit, used by GradientBased
+    double time_limit_seconds = 0.0;
   };
 
   // Create a TaskScheduler with the specific strategy name
@@ -42,6 +50,8 @@ class TaskScheduler {
                                              const Config& config,
                                              const std::string& strategy = "round_robin");
 
+  virtual ~TaskScheduler() = default;
+
   // Reset associated states to schedule at the beginning
   void Reset();
 
@@ -51,6 +61,15 @@ class TaskScheduler {
   // Select a task to tune
   virtual int NextTaskId() = 0;
 
+  // Report the best cost of a task searched so far after it is tuned
+  virtual void UpdateTaskCost(int task_id, double cost) {}
+
+  // Save the scheduling states to resume from a checkpoint
+  virtual void SaveState(proto::TaskSchedulerState* state) const;
+
+  // Restore the scheduling states saved by SaveState
+  virtual void LoadState(const proto::TaskSchedulerState& state);
+
  protected:
   // A taskScheduler object should be created with the static function Make
   TaskScheduler(const std::vector<TuneTask>& tasks, const Config& config);
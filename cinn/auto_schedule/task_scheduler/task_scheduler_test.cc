@@ -16,9 +16,12 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
 #include <type_traits>
 
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
+#include "cinn/auto_schedule/task_scheduler/gradient_based.h"
 #include "cinn/auto_schedule/task_scheduler/round_robin.h"
 
 namespace cinn {
@@ -32,6 +35,8 @@ TEST(TaskScheduler, Make) {
   ASSERT_STREQ(round_robin->Name(), "round_robin");
   auto efficiency_priority = TaskScheduler::Make(tasks, config, "efficiency_priority");
   ASSERT_STREQ(efficiency_priority->Name(), "efficiency_priority");
+  auto gradient_based = TaskScheduler::Make(tasks, config, "gradient_based");
+  ASSERT_STREQ(gradient_based->Name(), "gradient_based");
 }
 
 TEST(RoundRobinScheduler, NextTaskId) {
@@ -52,5 +57,66 @@ TEST(EfficiencyPriorityScheduler, NextTaskId) {
   ASSERT_EQ(-1, efficiency_priority->NextTaskId());
 }
 
+TEST(GradientBasedScheduler, NextTaskId) {
+  // task 0 and task 2 are two occurrences of the same task
+  std::vector<TuneTask> tasks(3);
+  tasks[0].serialized_key = "a";
+  tasks[1].serialized_key = "b";
+  tasks[2].serialized_key = "a";
+  TaskScheduler::Config config;
+  auto gradient_based = TaskScheduler::Make(tasks, config, "gradient_based");
+  // every task is tuned once at first, and the least tuned one is picked when no cost is reported
+  ASSERT_EQ(0, gradient_based->NextTaskId());
+  ASSERT_EQ(1, gradient_based->NextTaskId());
+  ASSERT_EQ(2, gradient_based->NextTaskId());
+  ASSERT_EQ(-1, gradient_based->NextTaskId());
+
+  gradient_based->UpdateTaskCost(0, 10.0);
+  gradient_based->UpdateTaskCost(1, 10.0);
+  gradient_based->UpdateTaskCost(2, 8.0);
+  gradient_based->Reset();
+  // gain of "a": 2 * (0.2 * (10 - 8) + 0.8 * 8 / 2) = 7.2, gain of "b": 1 * (0.8 * 10 / 1) = 8
+  ASSERT_EQ(1, gradient_based->NextTaskId());
+  gradient_based->UpdateTaskCost(1, 9.0);
+  // gain of "b": 1 * (0.2 * (10 - 9) + 0.8 * 9 / 2) = 3.8
+  ASSERT_EQ(0, gradient_based->NextTaskId());
+}
+
+TEST(GradientBasedScheduler, Deadline) {
+  std::vector<TuneTask> tasks(3);
+  TaskScheduler::Config config;
+  config.time_limit_seconds = 0.001;
+  auto gradient_based       = TaskScheduler::Make(tasks, config, "gradient_based");
+  ASSERT_EQ(0, gradient_based->NextTaskId());
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(-1, gradient_based->NextTaskId());
+}
+
+TEST(GradientBasedScheduler, SaveAndLoadState) {
+  std::vector<TuneTask> tasks(3);
+  tasks[0].serialized_key = "a";
+  tasks[1].serialized_key = "b";
+  tasks[2].serialized_key = "a";
+  TaskScheduler::Config config;
+  auto gradient_based = TaskScheduler::Make(tasks, config, "gradient_based");
+  ASSERT_EQ(0, gradient_based->NextTaskId());
+  gradient_based->UpdateTaskCost(0, 10.0);
+  ASSERT_EQ(1, gradient_based->NextTaskId());
+  gradient_based->UpdateTaskCost(1, 10.0);
+  proto::TaskSchedulerState state;
+  gradient_based->SaveState(&state);
+  ASSERT_EQ(state.cur_task_id(), 2);
+  ASSERT_EQ(state.groups_size(), 2);
+
+  // the resumed scheduler continues the round as the original one
+  auto resumed = TaskScheduler::Make(tasks, config, "gradient_based");
+  resumed->LoadState(state);
+  ASSERT_EQ(2, resumed->NextTaskId());
+  resumed->UpdateTaskCost(2, 8.0);
+  ASSERT_EQ(-1, resumed->NextTaskId());
+  resumed->Reset();
+  ASSERT_EQ(1, resumed->NextTaskId());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
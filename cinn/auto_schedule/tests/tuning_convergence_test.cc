@@ -0,0 +1,165 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/auto_tuner.h"
+#include "cinn/common/context.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/utils/string.h"
+
+/* This test is a benchmark of how fast the auto-tuning converges. It tunes a fixed set of tasks with a fixed seed
+ * and budget, and exports the best cost against the measured trials and the wall-clock time of each task as a CSV
+ * file, so that the changes of the search strategy, the cost model and the measurer can be compared by the curves.
+ * The default budget is small enough for CI, a real evaluation runs with a larger one, for example
+ * `--tuning_convergence_rounds=4 --tuning_convergence_trials=64 --tuning_convergence_output=curves.csv`.
+ */
+
+DEFINE_string(tuning_convergence_tasks,
+              "matmul,elementwise,reduce,softmax",
+              "the comma separated tasks to tune, from matmul, elementwise, reduce and softmax.");
+DEFINE_int64(tuning_convergence_seed, 2023, "the seed of the random search, fixed to make the curves comparable.");
+DEFINE_int32(tuning_convergence_rounds, 1, "the number of tuning rounds of each task.");
+DEFINE_int32(tuning_convergence_trials, 8, "the number of measurement trials of each task per round.");
+DEFINE_int32(tuning_convergence_samples, 4, "the number of candidates measured per search iteration.");
+DEFINE_string(tuning_convergence_output, "", "the CSV file to export the curves to, empty means not to export.");
+DECLARE_int32(cinn_parallel_compile_size);
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::frontend::NetBuilder;
+using ::cinn::hlir::framework::BuildScope;
+using ::cinn::hlir::framework::Graph;
+using ::cinn::hlir::framework::GraphCompiler;
+
+namespace {
+
+frontend::Program BuildTaskProgram(const std::string& task_name) {
+  NetBuilder builder(task_name);
+  if (task_name == "matmul") {
+    auto x = builder.CreateInput(Float(32), {128, 256}, "X");
+    auto y = builder.CreateInput(Float(32), {256, 128}, "Y");
+    builder.Matmul(x, y);
+  } else if (task_name == "elementwise") {
+    auto x = builder.CreateInput(Float(32), {64, 1024}, "X");
+    auto y = builder.CreateInput(Float(32), {64, 1024}, "Y");
+    builder.Relu(builder.Add(x, y));
+  } else if (task_name == "reduce") {
+    auto x = builder.CreateInput(Float(32), {128, 1024}, "X");
+    builder.ReduceSum(x, {1});
+  } else if (task_name == "softmax") {
+    auto x = builder.CreateInput(Float(32), {128, 1024}, "X");
+    builder.Softmax(x, {-1});
+  } else {
+    LOG(FATAL) << "Unknown tuning convergence task: " << task_name;
+  }
+  return builder.Build();
+}
+
+// Log the number of trials and the time taken to reach the final best cost within the tolerance
+void LogConvergence(const std::string& task_name, const std::vector<TuningCurvePoint>& curve, double tolerance) {
+  if (curve.empty()) {
+    LOG(WARNING) << "Task " << task_name << " has no measured trial";
+    return;
+  }
+  const auto& last = curve.back();
+  for (const auto& point : curve) {
+    if (point.num_measured_tasks == last.num_measured_tasks && point.best_cost <= last.best_cost * (1 + tolerance)) {
+      LOG(INFO) << utils::StringFormat(
+          "Task %s: best cost %.2f us after %d trials in %.1f ms, within %.0f%% of it after %d trials in %.1f ms",
+          task_name.c_str(),
+          last.best_cost,
+          last.num_trials,
+          last.elapsed_ms,
+          tolerance * 100,
+          point.num_trials,
+          point.elapsed_ms);
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+class TuningConvergenceTest : public ::testing::Test {
+ public:
+  void SetUp() override { FLAGS_cinn_parallel_compile_size = 0; }
+
+  std::vector<TuningCurvePoint> Tune(const std::string& task_name) {
+    Context::Global().ResetNameId();
+    auto graph = std::make_shared<Graph>(BuildTaskProgram(task_name), target_);
+    hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+    auto scope          = BuildScope(target_, graph);
+    auto graph_compiler = std::make_unique<GraphCompiler>(target_, scope, graph);
+
+    AutoTuner tuner(target_, graph.get());
+    AutoTuner::Config tuning_config;
+    tuning_config.random_seed = FLAGS_tuning_convergence_seed;
+    tuner.Initialize(tuning_config, graph_compiler.get());
+
+    TuningOptions tuning_options;
+    tuning_options.num_tuning_rounds         = FLAGS_tuning_convergence_rounds;
+    tuning_options.num_measure_trials        = FLAGS_tuning_convergence_trials;
+    tuning_options.num_samples_per_iteration = FLAGS_tuning_convergence_samples;
+    return tuner.Tune(tuning_options).curve;
+  }
+
+ protected:
+#ifdef CINN_WITH_CUDA
+  Target target_ = common::DefaultNVGPUTarget();
+#else
+  Target target_ = common::DefaultHostTarget();
+#endif
+};
+
+TEST_F(TuningConvergenceTest, Run) {
+  std::ofstream ofs;
+  if (!FLAGS_tuning_convergence_output.empty()) {
+    ofs.open(FLAGS_tuning_convergence_output, std::ofstream::trunc);
+    ASSERT_TRUE(ofs.good()) << "Cannot open the file to write: " << FLAGS_tuning_convergence_output;
+    ofs << "task,num_trials,elapsed_ms,best_cost_us,num_measured_tasks\n";
+  }
+  for (const auto& task_name : utils::Split(FLAGS_tuning_convergence_tasks, ",")) {
+    auto curve = Tune(task_name);
+    ASSERT_FALSE(curve.empty()) << "No candidate measured for task " << task_name;
+    for (size_t i = 1; i < curve.size(); ++i) {
+      ASSERT_GT(curve[i].num_trials, curve[i - 1].num_trials);
+      // the best cost never goes up while no new task is measured
+      if (curve[i].num_measured_tasks == curve[i - 1].num_measured_tasks) {
+        ASSERT_LE(curve[i].best_cost, curve[i - 1].best_cost);
+      }
+    }
+    LogConvergence(task_name, curve, 0.05);
+    if (ofs.is_open()) {
+      for (const auto& point : curve) {
+        ofs << task_name << "," << point.num_trials << "," << point.elapsed_ms << "," << point.best_cost << ","
+            << point.num_measured_tasks << "\n";
+      }
+    }
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
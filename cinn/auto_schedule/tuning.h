@@ -79,12 +79,26 @@ struct TuningOptions {
   float evolution_eps_greedy = 0.1f;
 };
 
+// The progress of tuning after a measured batch of candidates
+struct TuningCurvePoint {
+  // The number of candidates measured so far, including the failed ones
+  int num_trials = 0;
+  // The wall-clock time since the tuning started
+  double elapsed_ms = 0.0;
+  // The sum of the best execution costs of the measured tasks, an estimation of the graph latency
+  double best_cost = 0.0;  // unit: us
+  // The number of tasks with at least one successfully measured candidate
+  int num_measured_tasks = 0;
+};
+
 // Result of the tuning process
 struct TuningResult {
   // Result of graph tuning
   std::vector<SubGraphPtr> subgraphs;
   // Result of schedule tuning
   std::vector<FunctionGroup> function_groups;
+  // The best cost against the trials and time of this tuning session, a point per measured batch
+  std::vector<TuningCurvePoint> curve;
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,124 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/tuning_pack.h"
+
+#include <glog/logging.h>
+#include <google/protobuf/util/json_util.h>
+
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/auto_schedule/task/tune_task.h"
+#include "cinn/hlir/framework/op_lowering.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+void TuningPack::Add(const std::string& task_key, const ir::proto::ScheduleDesc& trace) {
+  (*pack_.mutable_schedules())[task_key] = trace;
+}
+
+const ir::proto::ScheduleDesc* TuningPack::Find(const std::string& task_key) const {
+  auto it = pack_.schedules().find(task_key);
+  return it != pack_.schedules().end() ? &it->second : nullptr;
+}
+
+void TuningPack::Save(const std::string& file_path) const {
+  std::string json_string;
+  auto status = google::protobuf::util::MessageToJsonString(pack_, &json_string);
+  CHECK(status.ok()) << "Failed to serialize the tuning pack";
+  std::ofstream os(file_path, std::ofstream::trunc);
+  CHECK(os.good()) << "Cannot open the file to write: " << file_path;
+  os << json_string;
+  VLOG(3) << "Save " << Size() << " schedules to the tuning pack " << file_path;
+}
+
+bool TuningPack::Load(const std::string& file_path) {
+  pack_.Clear();
+  pack_.set_version(kVersion);
+  std::ifstream is(file_path);
+  if (!is.good()) {
+    LOG(WARNING) << "The tuning pack is not found: " << file_path;
+    return false;
+  }
+  std::stringstream json_string;
+  json_string << is.rdbuf();
+  proto::TuningPack loaded;
+  auto status = google::protobuf::util::JsonStringToMessage(json_string.str(), &loaded);
+  CHECK(status.ok()) << "Failed to parse the tuning pack: " << file_path;
+  if (loaded.version() != kVersion) {
+    LOG(WARNING) << "Ignore the tuning pack of version " << loaded.version() << ", expected " << kVersion << ": "
+                 << file_path;
+    return false;
+  }
+  pack_ = std::move(loaded);
+  LOG(INFO) << "Load " << Size() << " schedules from the tuning pack " << file_path;
+  return true;
+}
+
+TuningResult TuningPack::Lower(hlir::framework::Graph* graph) const {
+  CHECK(!graph->fusion_groups.empty()) << "The graph should be applied the fusion passes before lowering";
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  hlir::framework::OpLowerer op_lowerer(dtype_dict, shape_dict, graph->target_);
+
+  TuningResult result;
+  int num_tuned = 0;
+  for (auto& group : graph->fusion_groups) {
+    // the key is serialized from the task the same as the one tuned
+    TuneTask task(group);
+    task.target = graph->target_;
+    task.Initialize(shape_dict, dtype_dict, &op_lowerer);
+    result.subgraphs.push_back(group);
+
+    const auto* trace = Find(task.serialized_key);
+    if (trace) {
+      try {
+        ir::IRSchedule ir_sch(optim::IRCopy(ir::ModuleExpr(task.GetLoweredFuncBodyExprs())));
+        ir::ScheduleDesc::ReplayWithProto(*trace, &ir_sch);
+        std::vector<ir::Expr> best_exprs = ir_sch.GetModule().GetExprs();
+        FunctionGroup functions          = optim::IRCopy(task.lowered_funcs);
+        CHECK_EQ(best_exprs.size(), functions.size())
+            << "The schedule doesn't match the task:\n" << task.serialized_key;
+        for (size_t i = 0; i < functions.size(); ++i) {
+          functions[i] = UpdateFuncWithNewBody(task.target, functions[i], best_exprs[i]);
+        }
+        result.function_groups.emplace_back(std::move(functions));
+        ++num_tuned;
+        continue;
+      } catch (std::exception& e) {
+        LOG(WARNING) << "Failed to apply the tuned schedule, lower with the default one, error: " << e.what();
+      }
+    }
+
+    auto initial_input_names  = group->input_names;
+    auto initial_output_names = group->output_names;
+    result.function_groups.emplace_back(op_lowerer.Lower(group));
+    group->input_names  = initial_input_names;
+    group->output_names = initial_output_names;
+  }
+  VLOG(3) << "Lower " << num_tuned << " of " << graph->fusion_groups.size() << " groups with the tuning pack";
+  return result;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/tuning.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/ir/schedule_desc.pb.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// A TuningPack keeps the best schedule of each tuned task in a small versioned file, looked up by the serialized key
+// of the task. It is made by AutoTuner::ExportTuningPack, and applied at deployment without the tuning components,
+// such as the database, the cost model and the measurer.
+class TuningPack {
+ public:
+  // The version of the file format, the files of other versions are ignored
+  static constexpr int kVersion = 1;
+
+  TuningPack() { pack_.set_version(kVersion); }
+
+  // Add the schedule of a task, the existing one with the same key is replaced
+  void Add(const std::string& task_key, const ir::proto::ScheduleDesc& trace);
+
+  // Return the schedule of a task, or nullptr if not found
+  const ir::proto::ScheduleDesc* Find(const std::string& task_key) const;
+
+  size_t Size() const { return pack_.schedules_size(); }
+
+  // Save the pack to a JSON file
+  void Save(const std::string& file_path) const;
+
+  // Load the pack from a JSON file, return false and keep the pack empty if the file is not found or of another version
+  bool Load(const std::string& file_path);
+
+  /**
+   * \brief Lower the fusion groups of a graph by the schedules in the pack, the groups not found are lowered with
+   * the default schedules.
+   * @param graph The graph after the fusion passes.
+   * @return The groups and their functions, applied by GraphCompiler::CompileOptions::Apply.
+   */
+  TuningResult Lower(hlir::framework::Graph* graph) const;
+
+ private:
+  proto::TuningPack pack_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/auto_schedule/tuning_pack.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/task/task_creator.h"
+#include "cinn/auto_schedule/task/tune_task.h"
+#include "cinn/common/context.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/op_lowering.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(TuningPack, SaveAndLoad) {
+  ir::proto::ScheduleDesc trace;
+  trace.add_steps()->set_type("GetAllBlocks");
+  TuningPack pack;
+  pack.Add("task_0", trace);
+  ASSERT_EQ(pack.Size(), 1UL);
+
+  std::string file_path = "./tuning_pack_test.json";
+  pack.Save(file_path);
+  TuningPack loaded;
+  ASSERT_TRUE(loaded.Load(file_path));
+  ASSERT_EQ(loaded.Size(), 1UL);
+  ASSERT_NE(loaded.Find("task_0"), nullptr);
+  ASSERT_EQ(loaded.Find("task_0")->DebugString(), trace.DebugString());
+  ASSERT_EQ(loaded.Find("task_1"), nullptr);
+  std::remove(file_path.c_str());
+
+  // the pack is kept empty if the file is missing
+  ASSERT_FALSE(loaded.Load(file_path));
+  ASSERT_EQ(loaded.Size(), 0UL);
+}
+
+TEST(TuningPack, LowerGraph) {
+  FLAGS_cinn_ir_schedule = true;
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+  frontend::NetBuilder builder("net_builder");
+  auto x = builder.CreateInput(Float(32), {4, 33}, "X");
+  builder.Relu(x);
+  auto graph = std::make_shared<hlir::framework::Graph>(builder.Build(), target);
+  auto tasks = TaskCreator().CreateTuneTaskOpLevel(graph.get());
+  ASSERT_EQ(tasks.size(), 1UL);
+
+  // nothing matches, the groups are lowered with the default schedules
+  TuningPack pack;
+  auto default_result = pack.Lower(graph.get());
+  ASSERT_EQ(default_result.subgraphs.size(), 1UL);
+  ASSERT_EQ(default_result.function_groups.size(), 1UL);
+
+  // tune the task by fusing the loops and splitting the fused one by 3
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  const auto& dtype_dict = graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  hlir::framework::OpLowerer op_lowerer(dtype_dict, shape_dict, target);
+  tasks[0].Initialize(shape_dict, dtype_dict, &op_lowerer);
+  ir::IRSchedule ir_sch(optim::IRCopy(ir::ModuleExpr(tasks[0].GetLoweredFuncBodyExprs())));
+  auto block = ir_sch.GetAllBlocks().back();
+  ir_sch.Split(ir_sch.Fuse(ir_sch.GetLoops(block)), {3, -1});
+  pack.Add(tasks[0].serialized_key, ir_sch.GetTraceDesc().ToProto());
+
+  auto tuned_result = pack.Lower(graph.get());
+  ASSERT_EQ(tuned_result.function_groups.size(), 1UL);
+  ASSERT_EQ(tuned_result.function_groups[0].size(), 1UL);
+  std::string tuned_body = utils::GetStreamCnt(tuned_result.function_groups[0][0]->body);
+  // the fused loop of extent 132 is split into 3 x 44
+  ASSERT_NE(tuned_body.find(", 0, 44)"), std::string::npos) << tuned_body;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -149,13 +149,22 @@ struct ExternalVec {
 
 // AVX256 load
 //@{
-inline __m256 cinn_avx256_load(const float* dst) { return _mm256_load_ps(dst); }
-inline __m256d cinn_avx256_load(const double* dst) { return _mm256_load_pd(dst); }
+inline __m256 cinn_avx256_load(const float* dst) { return _mm256_loadu_ps(dst); }
+inline __m256d cinn_avx256_load(const double* dst) { return _mm256_loadu_pd(dst); }
 //@}
 // AVX512 load
 //@{
-inline __m512 cinn_avx512_load(const float* dst) { return _mm512_load_ps(dst); }
-inline __m512d cinn_avx512_load(const double* dst) { return _mm512_load_pd(dst); }
+inline __m512 cinn_avx512_load(const float* dst) { return _mm512_loadu_ps(dst); }
+inline __m512d cinn_avx512_load(const double* dst) { return _mm512_loadu_pd(dst); }
+//@}
+// AVX512 load of the tail, the lanes not loaded are set to zero
+//@{
+inline __m512 cinn_avx512_maskz_load(const float* dst, int lanes) {
+  return _mm512_maskz_loadu_ps(static_cast<__mmask16>((1U << lanes) - 1), dst);
+}
+inline __m512d cinn_avx512_maskz_load(const double* dst, int lanes) {
+  return _mm512_maskz_loadu_pd(static_cast<__mmask8>((1U << lanes) - 1), dst);
+}
 //@}
 
 // FP32x8 * FP32x8
@@ -335,10 +344,63 @@ inline __m512d cinn_avx512_set1(double value) { return _mm512_set1_pd(value); }
 
 //! store
 // @{
-inline void cinn_avx512_store(float* dst, const __m512& x) { _mm512_store_ps(dst, x); }
-inline void cinn_avx512_store(double* dst, const __m512d& x) { _mm512_store_pd(dst, x); }
-inline void cinn_avx256_store(float* dst, const __m256& x) { _mm256_store_ps(dst, x); }
-inline void cinn_avx256_store(double* dst, const __m256d& x) { _mm256_store_pd(dst, x); }
+inline void cinn_avx512_store(float* dst, const __m512& x) { _mm512_storeu_ps(dst, x); }
+inline void cinn_avx512_store(double* dst, const __m512d& x) { _mm512_storeu_pd(dst, x); }
+inline void cinn_avx256_store(float* dst, const __m256& x) { _mm256_storeu_ps(dst, x); }
+inline void cinn_avx256_store(double* dst, const __m256d& x) { _mm256_storeu_pd(dst, x); }
+inline void cinn_avx512_mask_store(float* dst, const __m512& x, int lanes) {
+  _mm512_mask_storeu_ps(dst, static_cast<__mmask16>((1U << lanes) - 1), x);
+}
+inline void cinn_avx512_mask_store(double* dst, const __m512d& x, int lanes) {
+  _mm512_mask_storeu_pd(dst, static_cast<__mmask8>((1U << lanes) - 1), x);
+}
+// @}
+
+//! load float16/bfloat16 and convert to float32
+// @{
+inline __m512 cinn_avx512_load_fp16(const void* src) {
+  return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+}
+inline __m256 cinn_avx256_load_fp16(const void* src) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+inline __m512 cinn_avx512_load_bf16(const void* src) {
+  __m512i x = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(x, 16));
+}
+inline __m256 cinn_avx256_load_bf16(const void* src) {
+  __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(x, 16));
+}
+// @}
+
+//! convert float32 to float16/bfloat16 and store, rounding to nearest even
+// @{
+inline void cinn_avx512_store_fp16(void* dst, const __m512& x) {
+  __m256i res = _mm512_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), res);
+}
+inline void cinn_avx256_store_fp16(void* dst, const __m256& x) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+inline void cinn_avx512_store_bf16(void* dst, const __m512& x) {
+#ifdef __AVX512BF16__
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), (__m256i)_mm512_cvtneps_pbh(x));  // NOLINT
+#else
+  __m512i bits    = _mm512_castps_si512(x);
+  __m512i lsb     = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16)));
+#endif
+}
+inline void cinn_avx256_store_bf16(void* dst, const __m256& x) {
+  __m256i bits    = _mm256_castps_si256(x);
+  __m256i lsb     = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff))), 16);
+  // pack the 32-bit lanes to 16 bits, then gather the low halves of the two 128-bit lanes.
+  __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0x8);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(packed));
+}
 // @}
 
 //! add
@@ -349,6 +411,22 @@ inline __m512 cinn_avx512_add(const __m512& a, const __m512& b) { return _mm512_
 inline __m512d cinn_avx512_add(const __m512d& a, const __m512d& b) { return _mm512_add_pd(a, b); }
 // @}
 
+//! sub
+// @{
+inline __m256 cinn_avx256_sub(const __m256& a, const __m256& b) { return _mm256_sub_ps(a, b); }
+inline __m256d cinn_avx256_sub(const __m256d& a, const __m256d& b) { return _mm256_sub_pd(a, b); }
+inline __m512 cinn_avx512_sub(const __m512& a, const __m512& b) { return _mm512_sub_ps(a, b); }
+inline __m512d cinn_avx512_sub(const __m512d& a, const __m512d& b) { return _mm512_sub_pd(a, b); }
+// @}
+
+//! div
+// @{
+inline __m256 cinn_avx256_div(const __m256& a, const __m256& b) { return _mm256_div_ps(a, b); }
+inline __m256d cinn_avx256_div(const __m256d& a, const __m256d& b) { return _mm256_div_pd(a, b); }
+inline __m512 cinn_avx512_div(const __m512& a, const __m512& b) { return _mm512_div_ps(a, b); }
+inline __m512d cinn_avx512_div(const __m512d& a, const __m512d& b) { return _mm512_div_pd(a, b); }
+// @}
+
 //! mul
 // @{
 inline __m256 cinn_avx256_mul(const __m256& a, const __m256& b) { return _mm256_mul_ps(a, b); }
@@ -371,6 +449,53 @@ inline __m512d cinn_avx512_fma(const __m512d& a, const __m512d& b, const __m512d
 }
 // @}
 
+//! horizontal reduction of all the lanes
+// @{
+inline float cinn_avx512_reduce_add(const __m512& x) { return _mm512_reduce_add_ps(x); }
+inline float cinn_avx512_reduce_max(const __m512& x) { return _mm512_reduce_max_ps(x); }
+inline float cinn_avx512_reduce_min(const __m512& x) { return _mm512_reduce_min_ps(x); }
+inline double cinn_avx512_reduce_add(const __m512d& x) { return _mm512_reduce_add_pd(x); }
+inline double cinn_avx512_reduce_max(const __m512d& x) { return _mm512_reduce_max_pd(x); }
+inline double cinn_avx512_reduce_min(const __m512d& x) { return _mm512_reduce_min_pd(x); }
+
+#define CINN_AVX256_REDUCE(op__)                                                      \
+  inline float cinn_avx256_reduce_##op__(const __m256& x) {                           \
+    __m128 v = _mm_##op__##_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1)); \
+    v        = _mm_##op__##_ps(v, _mm_movehl_ps(v, v));                               \
+    v        = _mm_##op__##_ss(v, _mm_movehdup_ps(v));                                \
+    return _mm_cvtss_f32(v);                                                          \
+  }                                                                                   \
+  inline double cinn_avx256_reduce_##op__(const __m256d& x) {                         \
+    __m128d v = _mm_##op__##_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1)); \
+    v         = _mm_##op__##_sd(v, _mm_unpackhi_pd(v, v));                            \
+    return _mm_cvtsd_f64(v);                                                          \
+  }
+CINN_AVX256_REDUCE(add)
+CINN_AVX256_REDUCE(max)
+CINN_AVX256_REDUCE(min)
+#undef CINN_AVX256_REDUCE
+
+//! the fallback to reduce the lanes stored in memory when they are not held by a vector register
+template <typename T>
+inline T cinn_lanes_reduce_add(const T* x, int lanes) {
+  T res = x[0];
+  for (int i = 1; i < lanes; i++) res += x[i];
+  return res;
+}
+template <typename T>
+inline T cinn_lanes_reduce_max(const T* x, int lanes) {
+  T res = x[0];
+  for (int i = 1; i < lanes; i++) res = x[i] > res ? x[i] : res;
+  return res;
+}
+template <typename T>
+inline T cinn_lanes_reduce_min(const T* x, int lanes) {
+  T res = x[0];
+  for (int i = 1; i < lanes; i++) res = x[i] < res ? x[i] : res;
+  return res;
+}
+// @}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///                     )END Predefined utilities in CINN
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
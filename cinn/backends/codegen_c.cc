@@ -112,6 +112,8 @@ std::string CodeGenC::GetTypeName(Type type) {
 
   GET_SCALAR_TYPE(type.is_bfloat16(), "bfloat16");
   GET_SCALAR_TYPE(type.is_float16(), "float16");
+  GET_SCALAR_TYPE(type.is_float8_e4m3(), "float8_e4m3");
+  GET_SCALAR_TYPE(type.is_float8_e5m2(), "float8_e5m2");
   GET_SCALAR_TYPE(type.is_float(32), "float")
   GET_SCALAR_TYPE(type.is_float(64), "double")
 #undef GET_SCALAR_TYPE
@@ -186,7 +188,15 @@ void CodeGenC::Visit(const ir::Not *op) {
   IrPrinter::Print(op->v());
   os() << ")";
 }
-void CodeGenC::Visit(const ir::Cast *op) { PrintCastExpr(op->type(), op->v()); }
+void CodeGenC::Visit(const ir::Cast *op) {
+  // the fp8 types are only converted from and to float, the other types are cast through float
+  const auto &from_type = op->v().type();
+  if ((op->type().is_float8() || from_type.is_float8()) && !op->type().is_float(32) && !from_type.is_float(32)) {
+    PrintCastExpr(op->type(), ir::Cast::Make(common::Float(32, op->type().lanes()), op->v()));
+    return;
+  }
+  PrintCastExpr(op->type(), op->v());
+}
 void CodeGenC::Visit(const ir::For *op) {
   Expr extent  = op->extent;
   Expr min     = op->min;
@@ -695,6 +705,10 @@ void CodeGenC::PrintRuntimeType(const cinn_type_t &type) {
     os() << "cinn_bfloat16_t()";
   } else if (type == cinn_float16_t()) {
     os() << "cinn_float16_t()";
+  } else if (type == cinn_float8_e4m3_t()) {
+    os() << "cinn_float8_e4m3_t()";
+  } else if (type == cinn_float8_e5m2_t()) {
+    os() << "cinn_float8_e5m2_t()";
   } else if (type == cinn_float32_t()) {
     os() << "cinn_float32_t()";
   } else if (type == cinn_float64_t()) {
@@ -725,16 +739,18 @@ void CodeGenC::Visit(const ir::IntrinsicOp *op) {
   }
 }
 
-void CodeGenC::Visit(const ir::intrinsics::BufferGetDataHandle *op) {
-  os() << op->buffer.as_buffer()->name;
-  os() << "->";
-  os() << "memory";
-}
+void CodeGenC::Visit(const ir::intrinsics::BufferGetDataHandle *op) { PrintBufferMemory(op->buffer); }
 
-void CodeGenC::Visit(const ir::intrinsics::BufferGetDataConstHandle *op) {
-  os() << op->buffer.as_buffer()->name;
-  os() << "->";
-  os() << "memory";
+void CodeGenC::Visit(const ir::intrinsics::BufferGetDataConstHandle *op) { PrintBufferMemory(op->buffer); }
+
+void CodeGenC::PrintBufferMemory(const Expr &buffer) {
+  if (buffer_alignment_ > 0) {
+    os() << "__builtin_assume_aligned(" << buffer.as_buffer()->name << "->memory, " << buffer_alignment_ << ")";
+  } else {
+    os() << buffer.as_buffer()->name;
+    os() << "->";
+    os() << "memory";
+  }
 }
 
 void CodeGenC::Visit(const ir::intrinsics::PodValueToX *op) {
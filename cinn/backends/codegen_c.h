@@ -55,6 +55,9 @@ class CodeGenC : public ir::IrPrinter {
   //! Disable inline the builtin codes(too large) for simpler string comparison.
   void SetInlineBuiltinCodes(bool x = true) { inline_builtin_codes_ = x; }
 
+  //! Assume the memory of the buffers is aligned to \p alignment bytes, 0 assumes nothing.
+  void SetBufferAlignment(int alignment) { buffer_alignment_ = alignment; }
+
  protected:
   std::string Compile(const ir::LoweredFunc& function);
   std::string Compile(const ir::Buffer& buffer);
@@ -87,6 +90,8 @@ class CodeGenC : public ir::IrPrinter {
   void PrintBufferCreation(const std::vector<ir::Buffer>& buffers);
   void PrintBufferDestroy(const std::vector<ir::Buffer>& buffers);
   void PrintRuntimeType(const cinn_type_t& type);
+  //! Print the memory of the \p buffer, with the alignment assumed if it is set.
+  void PrintBufferMemory(const Expr& buffer);
 
   //! Print different kinds of Calls.
   // @{
@@ -115,6 +120,7 @@ class CodeGenC : public ir::IrPrinter {
   Target target_;
   std::stringstream ss_;
   bool inline_builtin_codes_{true};
+  int buffer_alignment_{0};
 };
 
 namespace detail {
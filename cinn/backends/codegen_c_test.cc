@@ -432,5 +432,27 @@ TEST(CodeGenC, call_extern) {
   std::cout << "codegen C:" << std::endl << out << std::endl;
 }
 
+TEST(CodeGenC, buffer_alignment) {
+  ir::Tensor A, B, C;
+  lang::Buffer C_buf(Float(32));
+  std::tie(A, B, C, C_buf) = CreateTensor1();
+
+  Module::Builder builder("module1", common::DefaultHostTarget());
+  auto stages = CreateStages({A, B, C});
+  builder.AddFunction(Lower("add1", stages, {A, B, C}));
+
+  CodeGenC codegen(common::DefaultHostTarget());
+  codegen.SetInlineBuiltinCodes(false);
+  codegen.SetBufferAlignment(16);
+  auto out = codegen.Compile(builder.Build(), CodeGenC::OutputKind::CImpl);
+  std::cout << "codegen C:" << std::endl << out << std::endl;
+
+  EXPECT_NE(out.find("const float* A = ((const float*)(__builtin_assume_aligned(_A->memory, 16)));"),
+            std::string::npos);
+  EXPECT_NE(out.find("const float* B = ((const float*)(__builtin_assume_aligned(_B->memory, 16)));"),
+            std::string::npos);
+  EXPECT_NE(out.find("float* C = ((float*)(__builtin_assume_aligned(_C->memory, 16)));"), std::string::npos);
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -17,7 +17,31 @@
 namespace cinn {
 namespace backends {
 
-void CodeGenCX86::Visit(const ir::Add *op) { VisitBinaryOp(op, op->a(), op->b(), "add"); }
+CodeGenCX86::Feature CodeGenCX86::GetFeature(const Target &target) {
+  using X86Feature = Target::X86Feature;
+  int res          = static_cast<int>(Feature::SSE);
+  if (target.x86_supports(X86Feature::AVX2)) res |= static_cast<int>(Feature::AVX256);
+  if (target.x86_supports(X86Feature::AVX512F)) res |= static_cast<int>(Feature::AVX512);
+  if (target.x86_supports(X86Feature::FMA)) res |= static_cast<int>(Feature::FMA);
+  if (target.x86_supports(X86Feature::F16C)) res |= static_cast<int>(Feature::F16C);
+  if (target.x86_supports(X86Feature::AVX512_BF16)) res |= static_cast<int>(Feature::BF16);
+  return static_cast<Feature>(res);
+}
+
+int CodeGenCX86::VectorBits(Type type) {
+  if (type.lanes() <= 1) return 0;
+  int bits = type.bits() * type.lanes();
+  if (SupportsAVX512() && bits == 512) return 512;
+  if (SupportsAVX256() && bits == 256) return 256;
+  // the tail of a float vector is computed in a 512-bit register, and only the valid lanes are loaded and stored.
+  if (SupportsAVX512() && (type.is_float(32) || type.is_float(64)) && bits > 256 && bits < 512) return 512;
+  return 0;
+}
+
+void CodeGenCX86::Visit(const ir::Add *op) {
+  if (PrintFMA(op)) return;
+  VisitBinaryOp(op, op->a(), op->b(), "add");
+}
 void CodeGenCX86::Visit(const ir::Sub *op) { VisitBinaryOp(op, op->a(), op->b(), "sub"); }
 void CodeGenCX86::Visit(const ir::Mul *op) { VisitBinaryOp(op, op->a(), op->b(), "mul"); }
 void CodeGenCX86::Visit(const ir::Div *op) { VisitBinaryOp(op, op->a(), op->b(), "div"); }
@@ -27,12 +51,16 @@ void CodeGenCX86::Visit(const ir::Load *op) {
   if (dense_strided_ramp.defined()) {  // Loading a continuous Ramp address.
     CHECK(op->type().is_vector());
 
-    int bits = op->type().bits() * op->type().lanes();
-    if (SupportsAVX512() && bits == 512) {
+    int bits = VectorBits(op->type());
+    if (IsMaskedVector(op->type())) {
+      os() << "cinn_avx512_maskz_load(";
+      PrintAbsAddr(op);
+      os() << ", " << op->type().lanes() << ")";
+    } else if (bits == 512) {
       os() << "cinn_avx512_load(";
       PrintAbsAddr(op);
       os() << ")";
-    } else if (SupportsAVX256() && bits == 256) {
+    } else if (bits == 256) {
       os() << "cinn_avx256_load(";
       PrintAbsAddr(op);
       os() << ")";
@@ -46,13 +74,13 @@ void CodeGenCX86::Visit(const ir::Load *op) {
 
 void CodeGenCX86::Visit(const ir::Broadcast *op) {
   CHECK_GT(op->type().lanes(), 1);
-  int bits = op->type().bits() * op->type().lanes();
+  int bits = VectorBits(op->type());
 
-  if (SupportsAVX512() && bits == 512) {
+  if (bits == 512) {
     os() << "cinn_avx512_set1(";
     PrintCastExpr(op->value.type().ElementOf(), op->value);
     os() << ")";
-  } else if (SupportsAVX256() && bits == 256) {
+  } else if (bits == 256) {
     os() << "cinn_avx256_set1(";
     PrintCastExpr(op->value.type().ElementOf(), op->value);
     os() << ")";
@@ -61,20 +89,125 @@ void CodeGenCX86::Visit(const ir::Broadcast *op) {
   }
 }
 
+// Converting between float32 and float16/bfloat16 is fused with the dense Load and Store, since the 16-bit vector
+// is not held by the registers alone.
+static std::string GetConvertSuffix(Type type, bool support_f16c, int bits) {
+  if (type.is_float16() && (bits == 512 || support_f16c)) return "fp16";
+  if (type.is_bfloat16()) return "bf16";
+  return "";
+}
+
+void CodeGenCX86::Visit(const ir::Cast *op) {
+  auto *load_n = op->v().As<ir::Load>();
+  int bits     = VectorBits(op->type());
+  if (op->type().is_float(32) && load_n && !IsMaskedVector(op->type()) && (bits == 512 || bits == 256) &&
+      detail::StridedRampBase(load_n->index(), 1).defined()) {
+    std::string suffix = GetConvertSuffix(op->v().type(), SupportsF16C(), bits);
+    if (!suffix.empty()) {
+      os() << "cinn_avx" << bits << "_load_" << suffix << "(";
+      PrintAbsAddr(load_n);
+      os() << ")";
+      return;
+    }
+  }
+  CodeGenC::Visit(op);
+}
+
+void CodeGenCX86::Visit(const ir::Call *op) {
+  if (PrintVectorReduce(op)) return;
+  CodeGenC::Visit(op);
+}
+
+bool CodeGenCX86::PrintVectorReduce(const ir::Call *op) {
+  std::string reduce_op;
+  if (op->name == runtime::intrinsic::vector_reduce_add) {
+    reduce_op = "add";
+  } else if (op->name == runtime::intrinsic::vector_reduce_max) {
+    reduce_op = "max";
+  } else if (op->name == runtime::intrinsic::vector_reduce_min) {
+    reduce_op = "min";
+  } else {
+    return false;
+  }
+  CHECK_EQ(op->read_args.size(), 1UL);
+  Expr vec = op->read_args.front();
+  int bits = VectorBits(vec.type());
+  if (!IsMaskedVector(vec.type()) && (bits == 512 || bits == 256)) {
+    os() << "cinn_avx" << bits << "_reduce_" << reduce_op << "(";
+    Print(vec);
+    os() << ")";
+    return true;
+  }
+  // the lanes are not held by a vector register, reduce them from the memory
+  auto *load_n = vec.As<ir::Load>();
+  CHECK(load_n && detail::StridedRampBase(load_n->index(), 1).defined())
+      << "The vector to reduce should be loaded from a dense address, but get " << vec;
+  os() << "cinn_lanes_reduce_" << reduce_op << "(";
+  PrintAbsAddr(load_n);
+  os() << ", " << vec.type().lanes() << ")";
+  return true;
+}
+
+bool CodeGenCX86::PrintConvertedStore(const ir::Store *op) {
+  auto *cast_n = op->value.As<ir::Cast>();
+  if (!cast_n || !detail::StridedRampBase(op->index(), 1).defined()) return false;
+  Type src_type = cast_n->v().type();
+  int bits      = VectorBits(src_type);
+  if (!src_type.is_float(32) || IsMaskedVector(src_type) || (bits != 512 && bits != 256)) return false;
+  std::string suffix = GetConvertSuffix(op->value.type(), SupportsF16C(), bits);
+  if (suffix.empty()) return false;
+
+  os() << "cinn_avx" << bits << "_store_" << suffix << "(";
+  PrintAbsAddr(op);
+  os() << ", ";
+  PrintVecInputArgument(&cast_n->v());
+  os() << ")";
+  return true;
+}
+
+bool CodeGenCX86::PrintFMA(const ir::Add *op) {
+  Type type = op->type();
+  int bits  = VectorBits(type);
+  if (!SupportsFMA() || bits == 0 || !(type.is_float(32) || type.is_float(64))) return false;
+  auto *mul_n = op->a().As<ir::Mul>();
+  Expr addend = op->b();
+  if (!mul_n) {
+    mul_n  = op->b().As<ir::Mul>();
+    addend = op->a();
+  }
+  if (!mul_n) return false;
+
+  os() << "cinn_avx" << bits << "_fma(";
+  PrintVecInputArgument(&mul_n->a());
+  os() << ", ";
+  PrintVecInputArgument(&mul_n->b());
+  os() << ", ";
+  PrintVecInputArgument(&addend);
+  os() << ")";
+  return true;
+}
+
 void CodeGenCX86::Visit(const ir::Store *op) {
   if (op->type().lanes() == 1) {
     CodeGenC::Visit(op);
     return;
   }
+  if (PrintConvertedStore(op)) return;
 
-  int bits = op->type().bits() * op->type().lanes();
-  if (SupportsAVX512() && bits == 512) {
+  int bits = VectorBits(op->type());
+  if (IsMaskedVector(op->type())) {
+    os() << "cinn_avx512_mask_store(";
+    PrintAbsAddr(op);
+    os() << ", ";
+    Print(op->value);
+    os() << ", " << op->type().lanes() << ")";
+  } else if (bits == 512) {
     os() << "cinn_avx512_store(";
     PrintAbsAddr(op);
     os() << ", ";
     Print(op->value);
     os() << ")";
-  } else if (SupportsAVX256() && bits == 256) {
+  } else if (bits == 256) {
     os() << "cinn_avx256_store(";
     PrintAbsAddr(op);
     os() << ", ";
@@ -113,8 +246,8 @@ void CodeGenCX86::Visit(const ir::intrinsics::BuiltinIntrin *op) {
     CodeGenC::Visit(op);
     return;
   }
-  int bits = op->type().bits() * op->type().lanes();
-  if (SupportsAVX512() && bits == 512) {
+  int bits = VectorBits(op->type());
+  if (bits == 512) {
     os() << "cinn_avx512_" << op->name << "(";
     if (!op->args.empty()) {
       for (int i = 0; i < op->args.size() - 1; i++) {
@@ -124,7 +257,7 @@ void CodeGenCX86::Visit(const ir::intrinsics::BuiltinIntrin *op) {
       Print(op->args.back());
     }
     os() << ")";
-  } else if (SupportsAVX256() && bits == 256) {
+  } else if (bits == 256) {
     os() << "cinn_avx256_" << op->name << "(";
     if (!op->args.empty()) {
       for (int i = 0; i < op->args.size() - 1; i++) {
@@ -18,6 +18,7 @@
 
 #include "cinn/backends/codegen_c.h"
 #include "cinn/ir/intrinsic_ops.h"
+#include "cinn/runtime/intrinsic.h"
 
 namespace cinn {
 namespace backends {
@@ -35,6 +36,9 @@ class CodeGenCX86 : public CodeGenC {
     AVX256 = 1 << 1,  // ! support AVX256 instruction set.
     AVX512 = 1 << 2,  // ! support AVX512 instruction set.
     BLAS   = 1 << 3,  // ! support BLAS library.
+    FMA    = 1 << 4,  // ! support FMA instruction set.
+    F16C   = 1 << 5,  // ! support the conversion between float16 and float32.
+    BF16   = 1 << 6,  // ! support AVX512_BF16 instruction set.
   };
 
   Feature feature{Feature::None};
@@ -46,6 +50,9 @@ class CodeGenCX86 : public CodeGenC {
    */
   CodeGenCX86(Target target, Feature feature) : CodeGenC(target), feature(feature) {}
 
+  //! Get the features supported by the X86 CPU of \p target.
+  static Feature GetFeature(const Target &target);
+
  protected:
   void Visit(const ir::Add *op) override;
   void Visit(const ir::Sub *op) override;
@@ -63,6 +70,8 @@ class CodeGenCX86 : public CodeGenC {
   void Visit(const ir::Load *op) override;
   void Visit(const ir::Store *op) override;
   void Visit(const ir::Broadcast *op) override;
+  void Visit(const ir::Cast *op) override;
+  void Visit(const ir::Call *op) override;
   void Visit(const ir::intrinsics::BuiltinIntrin *op);
 
   //! Check the features.
@@ -71,8 +80,25 @@ class CodeGenCX86 : public CodeGenC {
   bool SupportsAVX256() { return static_cast<int>(feature) & static_cast<int>(Feature::AVX256); }
   bool SupportsAVX512() { return static_cast<int>(feature) & static_cast<int>(Feature::AVX512); }
   bool SupportsBLAS() { return static_cast<int>(feature) & static_cast<int>(Feature::BLAS); }
+  bool SupportsFMA() { return static_cast<int>(feature) & static_cast<int>(Feature::FMA); }
+  bool SupportsF16C() { return static_cast<int>(feature) & static_cast<int>(Feature::F16C); }
+  bool SupportsBF16() { return static_cast<int>(feature) & static_cast<int>(Feature::BF16); }
   // @}
 
+  //! The width of the vector register to hold a value of \p type, 0 if it is not held by the vector registers.
+  //! A float vector between 256 and 512 bits is held by a 512-bit register with a mask on AVX-512.
+  int VectorBits(Type type);
+  //! Whether the value of \p type is held by a masked 512-bit register, that is the tail of a vectorized loop.
+  bool IsMaskedVector(Type type) { return VectorBits(type) == 512 && type.bits() * type.lanes() != 512; }
+
+  //! Print the fused multiply-add if \p op is `a * b + c` on a vector, return false if not matched.
+  bool PrintFMA(const ir::Add *op);
+  //! Print the float32 vector store of \p op converted to float16 or bfloat16, return false if not matched.
+  bool PrintConvertedStore(const ir::Store *op);
+
+  //! Print the horizontal reduction of the vector reduce intrinsic \p op, return false if it is not such a call.
+  bool PrintVectorReduce(const ir::Call *op);
+
   //! Print (and prepare) a argument in vectorize type, for example:
   // 3. -> set1(3.)
   // a[i:j] -> load_ps(a+i)
@@ -109,14 +135,14 @@ void CodeGenCX86::VisitBinaryOp(const Op *op, Expr a, Expr b, const std::string
   }
 
   // TODO(Superjomn) Consider support BLAS.
-  int bits = a.type().bits() * a.type().lanes();
-  if (SupportsAVX512() && bits == 512) {
+  int bits = VectorBits(a.type());
+  if (bits == 512) {
     os() << "cinn_avx512_" << op_repr << "(";
     PrintVecInputArgument(&a);
     os() << ", ";
     PrintVecInputArgument(&b);
     os() << ")";
-  } else if (SupportsAVX256() && bits == 256) {
+  } else if (bits == 256) {
     os() << "cinn_avx256_" << op_repr << "(";
     PrintVecInputArgument(&a);
     os() << ", ";
@@ -73,5 +73,40 @@ TEST(CodeGenCX86, basic) {
   std::cout << "out:\n" << out;
 }
 
+TEST(CodeGenCX86, fma_and_masked_tail) {
+  Context::info_rgt().Clear();
+
+  const int M = 100;
+  const int N = 200;
+
+  Target target;
+  target.arch = Target::Arch ::X86;
+  target.bits = Target::Bit ::k64;
+  target.os   = Target::OS ::Linux;
+
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+
+  // C = A * B + A, the 200 columns are split into 12 full vectors of 16 lanes and a tail of 8 lanes.
+  Tensor C = Compute(
+      {Expr(M), Expr(N)}, [&](Var i, Var j) { return A(i, j) * B(i, j) + A(i, j); }, "C");
+
+  auto stages = CreateStages({C});
+  stages[C]->Vectorize(1, 16);
+
+  auto func = Lower("fma", stages, {A, B, C});
+
+  ir::Module::Builder builder("module1", target);
+  builder.AddFunction(func);
+
+  auto feature = static_cast<CodeGenCX86::Feature>(static_cast<int>(CodeGenCX86::Feature::AVX512) |
+                                                   static_cast<int>(CodeGenCX86::Feature::FMA));
+  CodeGenCX86 codegen(target, feature);
+  codegen.SetInlineBuiltinCodes(false);
+  auto out = codegen.Compile(builder.Build(), CodeGenC::OutputKind::CImpl);
+  std::cout << "out:\n" << out;
+  EXPECT_NE(out.find("cinn_avx512_fma("), std::string::npos);
+}
+
 }  // namespace backends
 }  // namespace cinn
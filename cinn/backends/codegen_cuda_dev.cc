@@ -25,28 +25,35 @@
 #include "cinn/ir/ir_verify.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/remove_nested_block.h"
+#include "cinn/runtime/flags.h"
+#include "cinn/runtime/intrinsic.h"
 
 namespace cinn {
 namespace backends {
 
-const std::string CodeGenCUDA_Dev::source_header_ =
+// the source starts with the preprocessor directives only, so that NVRTC can precompile all of them as a header
+const std::string CodeGenCUDA_Dev::source_prelude_ =
     R"(#include <cstdint>
+#include <mma.h>
 
 #define CINN_WITH_CUDA
 #include "bfloat16.h"
 #include "float16.h"
-using cinn::common::bfloat16;
-using cinn::common::float16;
-using cinn::common::half4;
-using cinn::common::half8;
-using cinn::common::float8;
-
-#include "cinn_cuda_runtime_source.cuh"
+#if __CUDACC_VER_MAJOR__ > 11 || (__CUDACC_VER_MAJOR__ == 11 && __CUDACC_VER_MINOR__ >= 8)
+#include <cuda_fp8.h>
+#endif
+#define CINN_ASSUME_ALIGNED(ptr, alignment) ptr = static_cast<decltype(ptr)>(__builtin_assume_aligned(ptr, alignment))
 )";
 
+const std::string CodeGenCUDA_Dev::source_header_ = source_prelude_ + "#include \"cinn_cuda_runtime_source.cuh\"\n";
+
+constexpr const char *CodeGenCUDA_Dev::kLinkRuntimeLibraryMacro;
+
 const std::string &CodeGenCUDA_Dev::GetSourceHeader() { return source_header_; }
 
-CodeGenCUDA_Dev::CodeGenCUDA_Dev(Target target) : CodeGenC(target) {}
+const std::string &CodeGenCUDA_Dev::GetSourcePrelude() { return source_prelude_; }
+
+CodeGenCUDA_Dev::CodeGenCUDA_Dev(Target target) : CodeGenC(target), target_(target) {}
 
 std::string CodeGenCUDA_Dev::Compile(const ir::Module &module, bool for_nvrtc) {
   for_nvrtc_  = for_nvrtc;
@@ -111,9 +118,33 @@ std::vector<Expr> CodeGenCUDA_Dev::GenerateBufferAliasExprs(const ir::_LoweredFu
   return buffer_alias;
 }
 
+std::vector<Expr> CodeGenCUDA_Dev::GenerateBufferAlignmentExprs(const ir::_LoweredFunc_ *op) {
+  // the pointers of the buffer arguments are assumed aligned, so that NVRTC can vectorize the accesses of them
+  std::vector<Expr> alignment_exprs;
+  if (buffer_alignment_ <= 0) {
+    return alignment_exprs;
+  }
+  for (auto &arg : op->args) {
+    if (!arg.is_buffer()) continue;
+    auto ptr_type = arg.buffer_arg()->dtype;
+    ptr_type.set_cpp_handle();
+    Var ptr(ir::BufferGetTensorName(arg.buffer_arg().As<ir::_Buffer_>()), ptr_type);
+    alignment_exprs.push_back(
+        ir::Call::Make(Void(), "CINN_ASSUME_ALIGNED", {ptr, Expr(buffer_alignment_)}, {}, ir::CallType::Extern));
+  }
+  return alignment_exprs;
+}
+
 void CodeGenCUDA_Dev::Visit(const ir::_LoweredFunc_ *op) {
   // clear names valid within scope when enter a new function
   vectorized_tensor_names_.clear();
+  // the shared memory buffers beyond the static limit are placed in the dynamic shared memory sized at launch
+  dynamic_shared_mem_offsets_.clear();
+  dynamic_shared_mem_name_.clear();
+  if (op->CudaDynamicSharedMemBytes(&dynamic_shared_mem_offsets_) > 0) {
+    dynamic_shared_mem_name_ = op->name + "_dynamic_shared_mem";
+    os() << "extern __shared__ __align__(16) char " << dynamic_shared_mem_name_ << "[];\n";
+  }
   os() << "__global__\n";
 
   PrintFunctionDeclaration(op);
@@ -123,11 +154,13 @@ void CodeGenCUDA_Dev::Visit(const ir::_LoweredFunc_ *op) {
 
   std::vector<Expr> new_body;
 
+  auto alignment_exprs     = GenerateBufferAlignmentExprs(op);
   auto alloca_temp_buffers = op->PrepareAllocTempBufferExprs();
   auto temp_buffer_alias   = GenerateBufferAliasExprs(op, op->temp_bufs);
   auto alis_var_exprs      = op->CudaAliasVarExprs();
 
 #define APPEND_TO_NEW_BODY(field__) new_body.insert(std::end(new_body), std::begin(field__), std::end(field__));
+  APPEND_TO_NEW_BODY(alignment_exprs)
   APPEND_TO_NEW_BODY(alloca_temp_buffers)
   APPEND_TO_NEW_BODY(temp_buffer_alias)
   APPEND_TO_NEW_BODY(alis_var_exprs)
@@ -220,17 +253,41 @@ std::string CodeGenCUDA_Dev::Compile(const ir::Module &module, CodeGenC::OutputK
   if (output_kind == OutputKind::CHeader) {
     GenerateHeaderFile(module);
   } else if (output_kind == OutputKind::CImpl) {
-    PrintIncludes();
+    // the runtime device library is built by nvcc, the HIP kernels include the runtime source instead
+    link_runtime_library_ = for_nvrtc_ && target_.arch == Target::Arch::NVGPU && runtime::CanLinkNvgpuRuntimeLibrary();
+    runtime_func_decls_.clear();
+    if (link_runtime_library_) {
+      os() << GetSourcePrelude() << "#define " << kLinkRuntimeLibraryMacro << "\n";
+    } else {
+      PrintIncludes();
+    }
+    PrintGridSyncCodes(module);
 
     if (for_nvrtc_) {
       os() << "\nextern \"C\" {\n\n";
     }
+    // the called runtime functions are declared before the kernels, which are known after printing the kernels
+    std::string source_head;
+    if (link_runtime_library_) {
+      source_head = ss_.str();
+      ss_.str("");
+    }
 
     PrintBuiltinCodes();
 
     for (auto &func : module.functions()) {
       Compile(func);
     }
+
+    if (link_runtime_library_) {
+      std::string kernels = ss_.str();
+      ss_.str("");
+      os() << source_head;
+      for (auto &decl : runtime_func_decls_) {
+        os() << decl.second << "\n";
+      }
+      os() << "\n" << kernels;
+    }
   } else {
     LOG(FATAL) << "Not supported OutputKind";
   }
@@ -244,6 +301,19 @@ std::string CodeGenCUDA_Dev::Compile(const ir::Module &module, CodeGenC::OutputK
 
 void CodeGenCUDA_Dev::PrintIncludes() { os() << GetSourceHeader(); }
 
+void CodeGenCUDA_Dev::PrintGridSyncCodes(const ir::Module &module) {
+  // the grid-wide barrier is only defined for the modules of the cooperative kernels, as cooperative_groups.h takes
+  // notable time of NVRTC
+  for (auto &func : module.functions()) {
+    if (func->cuda_axis_info.cooperative()) {
+      os() << "#include <cooperative_groups.h>\n\n";
+      os() << "__device__ inline void " << runtime::intrinsic::cuda_grid_sync
+           << "() { cooperative_groups::this_grid().sync(); }\n";
+      return;
+    }
+  }
+}
+
 void CodeGenCUDA_Dev::PrintTempBufferCreation(const ir::Buffer &buffer) {
   CHECK_NE(buffer->type(), Void());
   auto print_gpu_memory = [&](const std::string &mark) {
@@ -260,7 +330,14 @@ void CodeGenCUDA_Dev::PrintTempBufferCreation(const ir::Buffer &buffer) {
   };
   switch (buffer->memory_type) {
     case ir::MemoryType::GPUShared:
-      print_gpu_memory("__shared__ ");
+      if (dynamic_shared_mem_offsets_.count(buffer->name)) {
+        // something like: float* A_shared = reinterpret_cast<float*>(fn_dynamic_shared_mem + 1024)
+        auto type_repr = GetTypeRepr(buffer->dtype);
+        os() << type_repr << "* " << buffer->name << " = reinterpret_cast<" << type_repr << "*>("
+             << dynamic_shared_mem_name_ << " + " << dynamic_shared_mem_offsets_.at(buffer->name) << ")";
+      } else {
+        print_gpu_memory("__shared__ ");
+      }
       break;
 
     case ir::MemoryType::GPULocal:
@@ -272,7 +349,24 @@ void CodeGenCUDA_Dev::PrintTempBufferCreation(const ir::Buffer &buffer) {
   }
 }
 
+std::string CodeGenCUDA_Dev::GetRuntimeFunctionDeclaration(const ir::Call *op) {
+  std::vector<std::string> arg_types;
+  auto append_arg_types = [&](const std::vector<Expr> &args) {
+    for (auto &arg : args) {
+      // the tensors are passed by the pointers to their buffers
+      arg_types.push_back(arg.as_tensor() ? GetTypeRepr(arg.as_tensor()->type()) + "*" : GetTypeRepr(arg.type()));
+    }
+  };
+  append_arg_types(op->read_args);
+  append_arg_types(op->write_args);
+  return "__device__ " + GetTypeRepr(op->type()) + " " + op->name + "(" + utils::Join(arg_types, ", ") + ");";
+}
+
 void CodeGenCUDA_Dev::Visit(const ir::Call *op) {
+  if (link_runtime_library_ && op->is_extern_call() && utils::Startswith(op->name, "cinn_") &&
+      op->name != runtime::intrinsic::cuda_grid_sync && !runtime_func_decls_.count(op->name)) {
+    runtime_func_decls_[op->name] = GetRuntimeFunctionDeclaration(op);
+  }
   os() << op->name + "(";
 
   if (!op->read_args.empty()) {
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -67,6 +69,13 @@ class CodeGenCUDA_Dev : public CodeGenC {
 
   static const std::string& GetSourceHeader();
 
+  //! The leading headers of the sources linked with the CUDA runtime device library, which are those of
+  //! GetSourceHeader() except the runtime source.
+  static const std::string& GetSourcePrelude();
+
+  //! The macro defined by the sources linked with the CUDA runtime device library instead of including its source.
+  static constexpr const char* kLinkRuntimeLibraryMacro = "CINN_NVGPU_LINK_RUNTIME_LIBRARY";
+
  protected:
   void Visit(const ir::_Var_* op) override;
   void Visit(const ir::_LoweredFunc_* op) override;
@@ -85,24 +94,45 @@ class CodeGenCUDA_Dev : public CodeGenC {
 
   void PrintIncludes() override;
 
+  //! Define the grid-wide barrier of the cooperative kernels if the module has any.
+  void PrintGridSyncCodes(const ir::Module& module);
+
   void PrintTempBufferCreation(const ir::Buffer& buffer);
 
   void PrintTempBufferAliasDefinition(const ir::Buffer& buffer);
 
   std::vector<Expr> GenerateBufferAliasExprs(const ir::_LoweredFunc_* op, const std::vector<ir::Buffer>& temp_buffers);
 
+  //! Assume the alignment of the buffer arguments of \p op at the beginning of the kernel, see SetBufferAlignment.
+  std::vector<Expr> GenerateBufferAlignmentExprs(const ir::_LoweredFunc_* op);
+
   /**
    * Print the function declaration, this is different from C, we expand the arguments and get something like
    * `__global__ void myadd(float* __restrict__ A, float* __restrict__ B, int n);`
    */
   void PrintFunctionDeclaration(const ir::_LoweredFunc_* op);
 
+  /**
+   * Get the declaration of the runtime function called by \p op from the types of its arguments, which is printed
+   * before the kernels linked with the CUDA runtime device library.
+   */
+  std::string GetRuntimeFunctionDeclaration(const ir::Call* op);
+
  private:
   Target target_;
   bool for_nvrtc_{false};
   // names of vectorized tensors from `Let` statments where dtypes of the tensors
   // are customized_type with customized_type::kcuda_builtin_vector_t prefix
   std::unordered_set<std::string> vectorized_tensor_names_;
+  // the offsets of the shared memory buffers in the dynamic shared memory of the current function, which is empty if
+  // all of them are static `__shared__` arrays
+  std::unordered_map<std::string, int> dynamic_shared_mem_offsets_;
+  std::string dynamic_shared_mem_name_;
+  // whether the source is linked with the CUDA runtime device library, see runtime::CanLinkNvgpuRuntimeLibrary
+  bool link_runtime_library_{false};
+  // the declarations of the runtime functions called by the kernels, keyed by the function names
+  std::map<std::string, std::string> runtime_func_decls_;
+  static const std::string source_prelude_;
   static const std::string source_header_;
 };
 
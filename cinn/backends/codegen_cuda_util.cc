@@ -20,8 +20,8 @@
 namespace cinn {
 namespace backends {
 
-std::tuple<ir::Module, ir::Module> SplitCudaAndHostModule(ir::Module module) {
-  detail::CollectHostFunctionVisitor visitor(module->name);
+std::tuple<ir::Module, ir::Module> SplitCudaAndHostModule(ir::Module module, const Target& target) {
+  detail::CollectHostFunctionVisitor visitor(module->name, target);
   Expr expr(module);
   return visitor(&expr);
 }
@@ -40,15 +40,20 @@ namespace backends {
  *
  * - replace the original kernel function with a Call node and add it to the first module, add a device kernel function
  * to the second module.
+ *
+ * The device module is of \p target, whose kernels are launched by cinn_call_hip_kernel on the AMD GPUs.
  */
-std::tuple<ir::Module, ir::Module> SplitCudaAndHostModule(ir::Module module);
+std::tuple<ir::Module, ir::Module> SplitCudaAndHostModule(ir::Module module,
+                                                          const Target& target = common::DefaultNVGPUTarget());
 
 namespace detail {
 
 struct CollectHostFunctionVisitor : public ir::IRMutator<> {
-  explicit CollectHostFunctionVisitor(const std::string& module_name)
+  explicit CollectHostFunctionVisitor(const std::string& module_name,
+                                      const Target& target = common::DefaultNVGPUTarget())
       : host_module_builder(module_name + "_host", common::DefaultHostTarget()),
-        device_module_builder(module_name + "_gpu_device", common::DefaultNVGPUTarget()) {}
+        device_module_builder(module_name + "_gpu_device", target),
+        target_(target) {}
 
   std::tuple<ir::Module, ir::Module> operator()(Expr* expr) {
     ir::IRMutator<>::Visit(expr, expr);
@@ -97,8 +102,15 @@ struct CollectHostFunctionVisitor : public ir::IRMutator<> {
     ir::Var kernel_args_num(KERNEL_ARGS_NUM, type_of<int>());
     ir::Var kernel_stream(KERNEL_STREAM, type_of<void*>());
 
+    // the stitched kernels synchronizing their blocks by the grid-wide barriers are launched cooperatively
+    CHECK(!func->cuda_axis_info.cooperative() || target_.arch == Target::Arch::NVGPU)
+        << "The cooperative kernels are only supported on the NVIDIA GPUs";
+    auto launch_api                     = target_.arch == Target::Arch::AMDGPU ? runtime::intrinsic::call_hip_kernel
+                                          : func->cuda_axis_info.cooperative()
+                                              ? runtime::intrinsic::call_cuda_cooperative_kernel
+                                              : runtime::intrinsic::call_cuda_kernel;
     auto call_extern_api                = ir::Call::Make(Void(),
-                                          runtime::intrinsic::call_cuda_kernel,
+                                          launch_api,
                                           {kernel_ptr,
                                            kernel_args,
                                            kernel_args_num,
@@ -108,6 +120,7 @@ struct CollectHostFunctionVisitor : public ir::IRMutator<> {
                                            Expr(func->cuda_axis_info.block_dim(0)),  // block_x
                                            Expr(func->cuda_axis_info.block_dim(1)),  // block_y
                                            Expr(func->cuda_axis_info.block_dim(2)),  // block_z
+                                           Expr(func->CudaDynamicSharedMemBytes()),   // shared_mem_bytes
                                            kernel_stream},
                                           {},
                                           ir::CallType::Extern,
@@ -132,6 +145,7 @@ struct CollectHostFunctionVisitor : public ir::IRMutator<> {
  private:
   ir::Module::Builder host_module_builder;
   ir::Module::Builder device_module_builder;
+  Target target_;
 };
 
 }  // namespace detail
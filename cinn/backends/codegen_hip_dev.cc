@@ -0,0 +1,39 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/codegen_hip_dev.h"
+
+#include <glog/logging.h>
+
+namespace cinn {
+namespace backends {
+
+// the float16 and bfloat16 types of the runtime source are only defined with CINN_WITH_CUDA
+const std::string CodeGenHIP_Dev::source_header_ =
+    R"(#include <cstdint>
+#include <hip/hip_runtime.h>
+
+#include "cinn_cuda_runtime_source.cuh"
+)";
+
+const std::string &CodeGenHIP_Dev::GetSourceHeader() { return source_header_; }
+
+CodeGenHIP_Dev::CodeGenHIP_Dev(Target target) : CodeGenCUDA_Dev(target) {
+  CHECK(target.arch == Target::Arch::AMDGPU) << "The HIP code generator only works on the AMD GPUs";
+}
+
+void CodeGenHIP_Dev::PrintIncludes() { os() << GetSourceHeader(); }
+
+}  // namespace backends
+}  // namespace cinn
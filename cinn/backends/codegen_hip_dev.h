@@ -0,0 +1,45 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/common/target.h"
+
+namespace cinn {
+namespace backends {
+
+/**
+ * HIP device code generator of the AMD GPUs.
+ *
+ * HIP shares the kernel syntax of CUDA, so the code generator is that of CUDA except the headers, and the kernels call
+ * the same functions of the runtime source, whose warp intrinsics switch to the wavefronts of 64 threads on HIP.
+ */
+class CodeGenHIP_Dev : public CodeGenCUDA_Dev {
+ public:
+  explicit CodeGenHIP_Dev(Target target);
+
+  static const std::string& GetSourceHeader();
+
+ protected:
+  void PrintIncludes() override;
+
+ private:
+  static const std::string source_header_;
+};
+
+}  // namespace backends
+}  // namespace cinn
@@ -18,6 +18,8 @@
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/context.h"
+#include "cinn/utils/compile_stats.h"
+#include "cinn/utils/profiler.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -27,6 +29,14 @@
 #include "cinn/runtime/cuda/cuda_util.h"
 #include "cinn/runtime/flags.h"
 #endif
+#ifdef CINN_WITH_ROCM
+#include "cinn/backends/codegen_cuda_host.h"
+#include "cinn/backends/codegen_cuda_util.h"
+#include "cinn/backends/codegen_hip_dev.h"
+#include "cinn/backends/hiprtc/hiprtc_util.h"
+#include "cinn/runtime/hip/hip_module.h"
+#include "cinn/runtime/hip/hip_util.h"
+#endif
 
 DECLARE_string(cinn_source_code_save_path);
 
@@ -70,8 +80,12 @@ void SourceCodePrint::write(const std::string& source_code) {
 void Compiler::Build(const Module& module, const std::string& code) {
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module, code);
+  } else if (target_.arch == Target::Arch::AMDGPU) {
+    CompileHipModule(module, code);
   } else if (target_.arch == Target::Arch::X86) {
     CompileX86Module(module);
+  } else if (target_.arch == Target::Arch::ARM) {
+    CompileARMModule(module);
   } else {
     CINN_NOT_IMPLEMENTED
   }
@@ -84,10 +98,20 @@ std::string Compiler::GetSourceCode(const ir::Module& module) {
     auto& host_module                = std::get<0>(_host_module_device_module_);
     auto& device_module              = std::get<1>(_host_module_device_module_);
     CodeGenCUDA_Dev codegen(target_);
+    codegen.SetBufferAlignment(buffer_alignment_);
     auto source_code = codegen.Compile(device_module);
     return source_code;
 #else
     CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target_.arch == Target::Arch::AMDGPU) {
+#ifdef CINN_WITH_ROCM
+    auto _host_module_device_module_ = SplitCudaAndHostModule(module, target_);  // NOLINT
+    auto& device_module              = std::get<1>(_host_module_device_module_);
+    CodeGenHIP_Dev codegen(target_);
+    return codegen.Compile(device_module);
+#else
+    CINN_NOT_IMPLEMENTED
 #endif
   } else {
     CINN_NOT_IMPLEMENTED
@@ -97,8 +121,12 @@ std::string Compiler::GetSourceCode(const ir::Module& module) {
 void Compiler::BuildDefault(const Module& module) {
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module);
+  } else if (target_.arch == Target::Arch::AMDGPU) {
+    CompileHipModule(module);
   } else if (target_.arch == Target::Arch::X86) {
     CompileX86Module(module);
+  } else if (target_.arch == Target::Arch::ARM) {
+    CompileARMModule(module);
   } else {
     CINN_NOT_IMPLEMENTED
   }
@@ -114,7 +142,10 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
   VLOG(3) << "[CUDA] device module:\n" << device_module;
   std::string source_code;
   if (code.empty()) {
+    utils::RecordEvent record_codegen("CodeGenCUDA_Dev", utils::EventType::kCodeGen);
+    utils::CompileStats::PhaseTimer stats_timer("CodeGenCUDA_Dev");
     CodeGenCUDA_Dev codegen(target_);
+    codegen.SetBufferAlignment(buffer_alignment_);
     source_code = codegen.Compile(device_module);
   } else {
     source_code = code;
@@ -124,22 +155,31 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
   SourceCodePrint::GetInstance()->write(source_code);
   using runtime::cuda::CUDAModule;
 
-  nvrtc::Compiler compiler;
-  auto ptx = compiler(source_code);
-  CHECK(!ptx.empty()) << "Compile PTX failed from source code:\n" << source_code;
-  cuda_module_.reset(
-      new CUDAModule(ptx, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX));
+  {
+    utils::RecordEvent record_nvrtc("NVRTC Compile", utils::EventType::kCompile);
+    utils::CompileStats::PhaseTimer stats_timer("NVRTC Compile");
+    nvrtc::Compiler compiler;
+    auto ptx = compiler(source_code);
+    CHECK(!ptx.empty()) << "Compile PTX failed from source code:\n" << source_code;
+    cuda_module_ =
+        CUDAModule::GetShared(ptx, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  }
 
+  // the kernels are bound on the current device, and remapped to the other devices on launching by the replicas
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
   RuntimeSymbols symbols;
   for (auto& fn : device_module.functions()) {
     std::string kernel_fn_name = fn->name;
-    auto fn_kernel             = cuda_module_->GetFunction(0, kernel_fn_name);
+    auto fn_kernel             = cuda_module_->GetFunction(device_id, kernel_fn_name);
     CHECK(fn_kernel);
 
     symbols.RegisterVar(kernel_fn_name + "_ptr_", reinterpret_cast<void*>(fn_kernel));
   }
 
-  engine_ = ExecutionEngine::Create(ExecutionOptions(), std::move(symbols));
+  utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+  utils::CompileStats::PhaseTimer stats_timer("LLVM JIT");
+  engine_ = ExecutionEngine::Create(GetExecutionOptions(), std::move(symbols));
   engine_->Link<CodeGenCUDA_Host>(host_module);
 
 #else
@@ -147,7 +187,74 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 #endif
 }
 
-void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86>(module); }
+void Compiler::CompileHipModule(const Module& module, const std::string& code) {
+#ifdef CINN_WITH_ROCM
+  auto _host_module_device_module_ = SplitCudaAndHostModule(module, target_);  // NOLINT
+  auto& host_module                = std::get<0>(_host_module_device_module_);
+  auto& device_module              = std::get<1>(_host_module_device_module_);
+  VLOG(3) << "[HIP] host module:\n" << host_module;
+
+  VLOG(3) << "[HIP] device module:\n" << device_module;
+  std::string source_code;
+  if (code.empty()) {
+    utils::RecordEvent record_codegen("CodeGenHIP_Dev", utils::EventType::kCodeGen);
+    utils::CompileStats::PhaseTimer stats_timer("CodeGenHIP_Dev");
+    CodeGenHIP_Dev codegen(target_);
+    source_code = codegen.Compile(device_module);
+  } else {
+    source_code = code;
+  }
+  CHECK(!source_code.empty()) << "Compile HIP C code failed from device module:\n" << device_module;
+  VLOG(3) << "[HIP] C:\n" << source_code;
+  SourceCodePrint::GetInstance()->write(source_code);
+
+  {
+    utils::RecordEvent record_hiprtc("hipRTC Compile", utils::EventType::kCompile);
+    utils::CompileStats::PhaseTimer stats_timer("hipRTC Compile");
+    hiprtc::Compiler compiler;
+    auto code_object = compiler(source_code);
+    CHECK(!code_object.empty()) << "Compile code object failed from source code:\n" << source_code;
+    hip_module_ = runtime::hip::HIPModule::GetShared(code_object);
+  }
+
+  int device_id = 0;
+  HIP_CALL(hipGetDevice(&device_id));
+  RuntimeSymbols symbols;
+  for (auto& fn : device_module.functions()) {
+    std::string kernel_fn_name = fn->name;
+    auto fn_kernel             = hip_module_->GetFunction(device_id, kernel_fn_name);
+    CHECK(fn_kernel);
+
+    symbols.RegisterVar(kernel_fn_name + "_ptr_", reinterpret_cast<void*>(fn_kernel));
+  }
+
+  utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+  utils::CompileStats::PhaseTimer stats_timer("LLVM JIT");
+  engine_ = ExecutionEngine::Create(GetExecutionOptions(), std::move(symbols));
+  engine_->Link<CodeGenCUDA_Host>(host_module);
+
+#else
+  CINN_NOT_IMPLEMENTED
+#endif
+}
+
+void Compiler::CompileX86Module(const Module& module) {
+  utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+  utils::CompileStats::PhaseTimer stats_timer("LLVM JIT");
+  engine_->Link<CodeGenX86>(module);
+}
+
+void Compiler::CompileARMModule(const Module& module) {
+  utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+  utils::CompileStats::PhaseTimer stats_timer("LLVM JIT");
+  engine_->Link<CodeGenARM>(module);
+}
+
+ExecutionOptions Compiler::GetExecutionOptions() const {
+  ExecutionOptions options;
+  options.buffer_alignment = buffer_alignment_;
+  return options;
+}
 
 void Compiler::ExportObject(const std::string& path) { engine_->ExportObject(path); }
 
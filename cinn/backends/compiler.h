@@ -28,6 +28,9 @@
 #ifdef CINN_WITH_CUDA
 #include "cinn/runtime/cuda/cuda_module.h"
 #endif
+#ifdef CINN_WITH_ROCM
+#include "cinn/runtime/hip/hip_module.h"
+#endif
 
 namespace cinn {
 namespace backends {
@@ -51,8 +54,9 @@ class SourceCodePrint {
 
 class Compiler final {
  public:
-  static std::unique_ptr<Compiler> Create(const Target& target) {
-    return std::unique_ptr<Compiler>(new Compiler(target));
+  //! The generated code assumes the memory of the buffers is aligned to \p buffer_alignment bytes unless it is 0.
+  static std::unique_ptr<Compiler> Create(const Target& target, int buffer_alignment = 0) {
+    return std::unique_ptr<Compiler>(new Compiler(target, buffer_alignment));
   }
 
   /**
@@ -75,18 +79,29 @@ class Compiler final {
  private:
   void CompileCudaModule(const ir::Module& module, const std::string& code = "");
 
+  void CompileHipModule(const ir::Module& module, const std::string& code = "");
+
   void CompileX86Module(const ir::Module& module);
 
-  explicit Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(ExecutionOptions())) {}
+  void CompileARMModule(const ir::Module& module);
+
+  Compiler(const Target& target, int buffer_alignment)
+      : target_(target), buffer_alignment_(buffer_alignment), engine_(ExecutionEngine::Create(GetExecutionOptions())) {}
+
+  ExecutionOptions GetExecutionOptions() const;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Compiler);
 
  private:
   Target target_;
+  int buffer_alignment_{0};
   std::unique_ptr<ExecutionEngine> engine_;
 
 #ifdef CINN_WITH_CUDA
-  std::unique_ptr<runtime::cuda::CUDAModule> cuda_module_;
+  std::shared_ptr<runtime::cuda::CUDAModule> cuda_module_;
+#endif
+#ifdef CINN_WITH_ROCM
+  std::shared_ptr<runtime::hip::HIPModule> hip_module_;
 #endif
 };
 
@@ -19,6 +19,10 @@
 #include <cuda_runtime.h>
 #include <cudnn.h>
 #include <curand.h>
+#include <cusparse.h>
+#ifdef CINN_WITH_NVJITLINK
+#include <nvJitLink.h>
+#endif
 #include <glog/logging.h>
 
 #include <string>
@@ -61,6 +65,14 @@
     }                                             \
   }
 
+#define CUSPARSE_CALL(func)                                                \
+  {                                                                        \
+    auto status = func;                                                    \
+    if (status != CUSPARSE_STATUS_SUCCESS) {                               \
+      LOG(FATAL) << "CUSPARSE Error : " << cusparseGetErrorString(status); \
+    }                                                                      \
+  }
+
 #define CUBLAS_CALL(func)                  \
   {                                        \
     auto status = func;                    \
@@ -85,6 +97,16 @@
     }                                                                \
   }
 
+#ifdef CINN_WITH_NVJITLINK
+#define NVJITLINK_CALL(func)                                          \
+  {                                                                   \
+    auto status = func;                                               \
+    if (status != NVJITLINK_SUCCESS) {                                \
+      LOG(FATAL) << "nvJitLink Error : " << static_cast<int>(status); \
+    }                                                                 \
+  }
+#endif
+
 namespace cinn {
 namespace backends {
 
@@ -80,8 +80,10 @@ namespace backends {
 static const char* TargetToBackendRepr(Target target) {
   switch (target.arch) {
     case Target::Arch::X86:
+    case Target::Arch::ARM:
       return backend_llvm_host;
     case Target::Arch::NVGPU:
+    case Target::Arch::AMDGPU:
       return backend_nvgpu;
     default:
       CINN_NOT_IMPLEMENTED
@@ -0,0 +1,138 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/hiprtc/hiprtc_util.h"
+
+#include <glog/logging.h>
+#include <hip/hip_runtime.h>
+#include <hip/hiprtc.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "cinn/backends/kernel_disk_cache.h"
+#include "cinn/common/common.h"
+#include "cinn/runtime/flags.h"
+#include "cinn/runtime/hip/hip_util.h"
+#include "cinn/utils/string.h"
+
+DECLARE_string(cinn_nvgpu_math_precision);
+DECLARE_string(cinn_nvrtc_cache_dir);
+DECLARE_int64(cinn_nvrtc_cache_max_bytes);
+
+namespace cinn {
+namespace backends {
+namespace hiprtc {
+
+namespace {
+// The disk cache configured by FLAGS_cinn_nvrtc_cache_dir, which is shared with NVRTC as the keys never collide.
+KernelDiskCache* HiprtcDiskCache() {
+  if (FLAGS_cinn_nvrtc_cache_dir.empty()) return nullptr;
+  static KernelDiskCache cache(FLAGS_cinn_nvrtc_cache_dir, FLAGS_cinn_nvrtc_cache_max_bytes);
+  return &cache;
+}
+
+// The runtime source included by the kernels, which takes part in the key of the disk cache.
+std::string RuntimeSourceContent() {
+  std::stringstream ss;
+  for (auto& dir : Context::Global().runtime_include_dir()) {
+    std::ifstream file(dir + "/cinn_cuda_runtime_source.cuh");
+    if (file.is_open()) ss << file.rdbuf();
+  }
+  return ss.str();
+}
+}  // namespace
+
+std::string Compiler::operator()(const std::string& code, bool include_headers) {
+  std::vector<std::string> compile_options;
+  compile_options.push_back("--offload-arch=" + GetOffloadArch());
+  compile_options.push_back("-O3");
+  compile_options.push_back("-std=c++14");
+  if (FLAGS_cinn_nvgpu_math_precision == "fast") {
+    compile_options.push_back("-ffast-math");
+  }
+  if (include_headers) {
+    for (auto& dir : FindROCmIncludePaths()) {
+      compile_options.push_back("-I" + dir);
+    }
+    for (auto& dir : Context::Global().runtime_include_dir()) {
+      compile_options.push_back("-I" + dir);
+    }
+  }
+
+  auto* disk_cache = HiprtcDiskCache();
+  std::string cache_key;
+  if (disk_cache) {
+    std::vector<std::string> key_parts = {code, utils::Join(compile_options, " "), std::to_string(HIP_VERSION)};
+    if (include_headers) {
+      key_parts.push_back(RuntimeSourceContent());
+    }
+    cache_key = KernelDiskCache::HashKey(key_parts);
+    std::string data;
+    if (disk_cache->Lookup(cache_key, &data)) {
+      return data;
+    }
+  }
+
+  std::vector<const char*> param_cstrings;
+  for (auto& option : compile_options) {
+    param_cstrings.push_back(option.c_str());
+  }
+  VLOG(3) << "hiprtc compile options: " << utils::Join(compile_options, " ");
+
+  hiprtcProgram prog;
+  HIPRTC_CALL(hiprtcCreateProgram(&prog, code.c_str(), nullptr, 0, nullptr, nullptr));
+  hiprtcResult compile_res = hiprtcCompileProgram(prog, param_cstrings.size(), param_cstrings.data());
+
+  {  // get log
+    size_t log_size;
+    HIPRTC_CALL(hiprtcGetProgramLogSize(prog, &log_size));
+    std::string log;
+    log.resize(log_size);
+    HIPRTC_CALL(hiprtcGetProgramLog(prog, &log[0]));
+    CHECK_EQ(compile_res, HIPRTC_SUCCESS) << log;
+  }
+
+  size_t size;
+  std::string data;
+  HIPRTC_CALL(hiprtcGetCodeSize(prog, &size));
+  data.resize(size);
+  HIPRTC_CALL(hiprtcGetCode(prog, &data[0]));
+
+  HIPRTC_CALL(hiprtcDestroyProgram(&prog));
+  if (disk_cache) {
+    disk_cache->Insert(cache_key, data);
+  }
+  return data;
+}
+
+std::vector<std::string> Compiler::FindROCmIncludePaths() {
+  const char* rocm_path = std::getenv("ROCM_PATH");
+  std::string root      = rocm_path ? rocm_path : CINN_ROCM_PATH;
+  return {root + "/include"};
+}
+
+std::string Compiler::GetOffloadArch() {
+  int device_id = 0;
+  HIP_CALL(hipGetDevice(&device_id));
+  hipDeviceProp_t prop;
+  HIP_CALL(hipGetDeviceProperties(&prop, device_id));
+  // the gcnArchName carries the target features, such as gfx90a:sramecc+:xnack-, which hipRTC accepts as is
+  return prop.gcnArchName;
+}
+
+}  // namespace hiprtc
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,56 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef CINN_WITH_ROCM
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace backends {
+namespace hiprtc {
+
+/**
+ * An helper class to call hipRTC. Input HIP device source code, get the code object of the current AMD GPU.
+ */
+class Compiler {
+ public:
+  /**
+   * Compile the \p code and get the code object.
+   * @param code The HIP source code.
+   * @param include_headers Whether to include the headers of ROCm and CINN runtime modules.
+   * @return Compiled code object.
+   */
+  std::string operator()(const std::string& code, bool include_headers = true);
+
+ private:
+  /**
+   * Get the directories of ROCm's header files.
+   * @return list of header file directories.
+   */
+  std::vector<std::string> FindROCmIncludePaths();
+
+  /**
+   * Get the gfx arch name of the current device, such as gfx90a.
+   * @return the arch name.
+   */
+  std::string GetOffloadArch();
+};
+
+}  // namespace hiprtc
+}  // namespace backends
+}  // namespace cinn
+
+#endif  // CINN_WITH_ROCM
@@ -25,7 +25,10 @@
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/cinn.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule_util.h"
+#include "cinn/ir/tensorize_intrin.h"
 #include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/unroll_loops.h"
@@ -81,8 +84,10 @@ void test_split_and_fuse1(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i_j_fused_i_j_fused_0_fused = 0; i_j_fused_i_j_fused_0_fused < 256; i_j_fused_i_j_fused_0_fused += 1) {
+    int32_t i_j_fused_i_j_fused_0_fused_0_inv0 = ((i_j_fused_i_j_fused_0_fused / 8) * 32);
     for (int32_t i_j_fused_i_j_fused_0_fused_0 = 0; i_j_fused_i_j_fused_0_fused_0 < 4; i_j_fused_i_j_fused_0_fused_0 += 1) {
-      B[(((i_j_fused_i_j_fused_0_fused / 8) * 32) + (((4 * i_j_fused_i_j_fused_0_fused) + i_j_fused_i_j_fused_0_fused_0) & 31))] = A[(((i_j_fused_i_j_fused_0_fused / 8) * 32) + (((4 * i_j_fused_i_j_fused_0_fused) + i_j_fused_i_j_fused_0_fused_0) & 31))];
+      int32_t B_cse0 = (i_j_fused_i_j_fused_0_fused_0_inv0 + (((4 * i_j_fused_i_j_fused_0_fused) + i_j_fused_i_j_fused_0_fused_0) & 31));
+      B[B_cse0] = A[B_cse0];
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -2112,8 +2117,13 @@ TEST(IrSchedule, rfactor2) {
   Placeholder<float> A("A", {M, K});
   Placeholder<float> B("B", {K, N});
   Var k(16, "k0");
+  // the product of float16 is accumulated to float32
   auto C = Compute(
-      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+      {M, N},
+      [&](Var i, Var j) {
+        return lang::ReduceSum(ir::Cast::Make(Float(32), A(i, k)) * ir::Cast::Make(Float(32), B(k, j)), {k});
+      },
+      "C");
 
   auto stages = CreateStages({A, B, C});
   auto func   = cinn::lang::LowerVec("test_rfactor", stages, {A, B, C}, {}, {}, nullptr, target, true);
@@ -2997,6 +3007,107 @@ TEST(IrSchedule, GetChildBlocks) {
   ASSERT_EQ(utils::GetStreamCnt(ir_sch.GetChildBlocks(root_block)), expected_expr);
 }
 
+TEST(IrSchedule, Tensorize) {
+  Context::Global().ResetNameId();
+  Expr M(32);
+  Expr N(32);
+  Expr K(32);
+  Placeholder<common::float16> A("A", {M, K});
+  Placeholder<common::float16> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  // the product of float16 is accumulated to float32
+  auto C = Compute(
+      {M, N},
+      [&](Var i, Var j) {
+        return lang::ReduceSum(ir::Cast::Make(Float(32), A(i, k)) * ir::Cast::Make(Float(32), B(k, j)), {k});
+      },
+      "C");
+  auto funcs = cinn::lang::LowerVec(
+      "test_tensorize", CreateStages({A, B, C}), {A, B, C}, {}, {}, nullptr, common::DefaultNVGPUTarget(), true);
+  ir::IRSchedule ir_sch(ir::ModuleExpr({funcs[0]->body}));
+
+  ir::MatmulBlockPattern pattern;
+  ASSERT_TRUE(ir::MatchMatmulBlock(ir_sch.GetBlock("C"), &pattern));
+  ASSERT_EQ(ir::GetMatmulTensorizeIntrin(pattern), "wmma_m16n16k16_f16f32");
+
+  auto loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 3U);
+  ir_sch.Split(loops[2], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[1], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[0], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Reorder({loops[0], loops[2], loops[4], loops[1], loops[3], loops[5]});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Tensorize(loops[3], "wmma_m16n16k16_f16f32");
+
+  // the nest is replaced by a loop of warp size, and the initialization of C is removed
+  loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 4U);
+  EXPECT_TRUE(loops[3].As<ir::For>()->is_gpu_thread_binded());
+  EXPECT_EQ(loops[3].As<ir::For>()->extent.as_int32(), 32);
+  EXPECT_FALSE(ir_sch.HasBlock("C__reduce_init"));
+  std::string ir_str = utils::GetStreamCnt(ir_sch.GetModule().GetExprs().front());
+  VLOG(6) << "After Tensorize, ir is:\n" << ir_str;
+  EXPECT_NE(ir_str.find("cinn_wmma_m16n16k16_f16f32("), std::string::npos);
+  EXPECT_NE(ir_str.find("tensorize_intrin:wmma_m16n16k16_f16f32"), std::string::npos);
+}
+
+TEST(IrSchedule, TensorizeVNNI) {
+  Context::Global().ResetNameId();
+  Expr M(32);
+  Expr N(32);
+  Expr K(32);
+  Placeholder<int8_t> A("A", {M, K});
+  Placeholder<int8_t> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  // the product of int8 is accumulated to int32
+  auto C = Compute(
+      {M, N},
+      [&](Var i, Var j) {
+        return lang::ReduceSum(ir::Cast::Make(Int(32), A(i, k)) * ir::Cast::Make(Int(32), B(k, j)), {k});
+      },
+      "C");
+  auto funcs = cinn::lang::LowerVec(
+      "test_tensorize_vnni", CreateStages({A, B, C}), {A, B, C}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+  ir::IRSchedule ir_sch(ir::ModuleExpr({funcs[0]->body}));
+
+  ir::MatmulBlockPattern pattern;
+  ASSERT_TRUE(ir::MatchMatmulBlock(ir_sch.GetBlock("C"), &pattern));
+  auto* intrin = ir::TensorizeIntrinRegistry::Global()->Find(pattern, common::Target::Arch::X86);
+  ASSERT_TRUE(intrin);
+  ASSERT_EQ(intrin->name, "vnni_m16n16k16_s8s8s32");
+  // no tensor core intrinsic computes int8
+  ASSERT_TRUE(ir::GetMatmulTensorizeIntrin(pattern).empty());
+
+  auto loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[2], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[1], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[0], {-1, 16});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Reorder({loops[0], loops[2], loops[4], loops[1], loops[3], loops[5]});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Tensorize(loops[3], intrin->name);
+
+  // the intrinsic is called by a single thread, so the nest is replaced by the call only
+  loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 3U);
+  EXPECT_FALSE(ir_sch.HasBlock("C__reduce_init"));
+  std::string ir_str = utils::GetStreamCnt(ir_sch.GetModule().GetExprs().front());
+  VLOG(6) << "After Tensorize, ir is:\n" << ir_str;
+  EXPECT_NE(ir_str.find("cinn_host_vnni_m16n16k16_s8s8s32("), std::string::npos);
+
+  // the step is replayed by the ScheduleDesc
+  ir::IRSchedule replayed(ir::ModuleExpr({optim::IRCopy(funcs[0]->body)}));
+  ir_sch.GetTraceDesc().Replay(&replayed);
+  EXPECT_EQ(replayed.GetLoops("C").size(), 3U);
+  std::string replayed_str = utils::GetStreamCnt(replayed.GetModule().GetExprs().front());
+  EXPECT_NE(replayed_str.find("cinn_host_vnni_m16n16k16_s8s8s32("), std::string::npos);
+}
+
 TEST(IrSchedule, SampleCategorical) {
   Context::Global().ResetNameId();
   Expr M(32);
@@ -3015,5 +3126,33 @@ TEST(IrSchedule, SampleCategorical) {
   ASSERT_EQ(result.type(), Int(32));
 }
 
+TEST(IrSchedule, copy_on_access) {
+  Expr M(32);
+  Expr N(32);
+
+  Target target = common::DefaultHostTarget();
+
+  Placeholder<float> A("A", {M, N});
+  auto B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j); }, "B");
+
+  auto stages = CreateStages({A, B});
+  auto func   = cinn::lang::LowerVec("test_copy_on_access", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::IRSchedule ir_sch(ir::ModuleExpr({func[0]->body}));
+  auto loops = ir_sch.GetLoops("B");
+
+  // the copy shares the AST until it is accessed
+  ir::IRSchedule copied(ir_sch);
+  // the source keeps its AST, so the loops got before are still valid
+  ir_sch.Fuse(loops);
+  EXPECT_EQ(ir_sch.GetLoops("B").size(), 1UL);
+  EXPECT_TRUE(ir_sch.GetModule().GetExprs()[0].same_as(func[0]->body));
+  // the copy sees the AST at the time it is copied
+  EXPECT_EQ(copied.GetLoops("B").size(), 2UL);
+  copied.Split(copied.GetLoops("B")[0], {4, -1});
+  EXPECT_EQ(copied.GetLoops("B").size(), 3UL);
+  EXPECT_EQ(ir_sch.GetLoops("B").size(), 1UL);
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -0,0 +1,185 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/kernel_disk_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+constexpr char kEntrySuffix[] = ".kernel";
+
+struct EntryInfo {
+  std::string path;
+  int64_t size;
+  // the last access time in nanoseconds
+  int64_t mtime_ns;
+};
+
+bool HasSuffix(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void MakeDirs(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos; pos = dir.find('/', pos + 1)) {
+    mkdir(dir.substr(0, pos).c_str(), 0755);
+  }
+  mkdir(dir.c_str(), 0755);
+}
+
+std::vector<EntryInfo> ListEntries(const std::string& dir) {
+  std::vector<EntryInfo> entries;
+  DIR* dp = opendir(dir.c_str());
+  if (dp == nullptr) return entries;
+  while (struct dirent* ent = readdir(dp)) {
+    std::string name = ent->d_name;
+    if (!HasSuffix(name, kEntrySuffix)) continue;
+    std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    entries.push_back({path, static_cast<int64_t>(st.st_size), st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec});
+  }
+  closedir(dp);
+  return entries;
+}
+
+}  // namespace
+
+KernelDiskCache::KernelDiskCache(const std::string& cache_dir, int64_t max_bytes)
+    : cache_dir_(cache_dir), max_bytes_(max_bytes) {
+  CHECK(!cache_dir_.empty()) << "The directory of KernelDiskCache can't be empty";
+  MakeDirs(cache_dir_);
+  struct stat st;
+  CHECK(stat(cache_dir_.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) << "Fail to create the directory " << cache_dir_;
+}
+
+std::string KernelDiskCache::HashKey(const std::vector<std::string>& parts) {
+  // two 64-bit FNV-1a with different offset basis, which is enough to address the kernels
+  uint64_t h1 = 14695981039346656037ULL;
+  uint64_t h2 = 0x84222325cbf29ce4ULL;
+  auto update = [&](unsigned char c) {
+    h1 = (h1 ^ c) * 1099511628211ULL;
+    h2 = (h2 ^ c) * 0x100000001b3ULL + 0x9e3779b97f4a7c15ULL;
+  };
+  for (auto& part : parts) {
+    uint64_t len = part.size();
+    for (int i = 0; i < 8; ++i) update((len >> (i * 8)) & 0xff);
+    for (unsigned char c : part) update(c);
+  }
+  char buf[33];
+  snprintf(buf, sizeof(buf), "%016llx%016llx", static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+  return buf;
+}
+
+std::string KernelDiskCache::EntryPath(const std::string& key) const { return cache_dir_ + "/" + key + kEntrySuffix; }
+
+bool KernelDiskCache::Lookup(const std::string& key, std::string* value) {
+  std::string path = EntryPath(key);
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!ifs.is_open()) {
+    ++stats_.num_misses;
+    return false;
+  }
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  *value = ss.str();
+  if (value->empty()) {
+    ++stats_.num_misses;
+    return false;
+  }
+  // refresh the modification time for LRU
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  ++stats_.num_hits;
+  VLOG(4) << "Hit the kernel cache " << path;
+  return true;
+}
+
+void KernelDiskCache::Insert(const std::string& key, const std::string& value) {
+  if (value.empty()) return;
+  std::lock_guard<std::mutex> lock(mtx_);
+  Evict(value.size());
+
+  std::stringstream tmp_path;
+  tmp_path << EntryPath(key) << ".tmp." << getpid() << "." << std::this_thread::get_id();
+  {
+    std::ofstream ofs(tmp_path.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+      LOG(WARNING) << "Fail to write the kernel cache " << tmp_path.str();
+      return;
+    }
+    ofs.write(value.data(), value.size());
+    if (!ofs.good()) {
+      ofs.close();
+      std::remove(tmp_path.str().c_str());
+      LOG(WARNING) << "Fail to write the kernel cache " << tmp_path.str();
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), EntryPath(key).c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+    LOG(WARNING) << "Fail to rename the kernel cache " << tmp_path.str();
+  }
+}
+
+void KernelDiskCache::Evict(int64_t incoming_bytes) {
+  if (max_bytes_ <= 0) return;
+  auto entries        = ListEntries(cache_dir_);
+  int64_t total_bytes = incoming_bytes;
+  for (auto& entry : entries) {
+    total_bytes += entry.size;
+  }
+  if (total_bytes <= max_bytes_) return;
+
+  std::sort(entries.begin(), entries.end(), [](const EntryInfo& a, const EntryInfo& b) {
+    return a.mtime_ns < b.mtime_ns;
+  });
+  for (auto& entry : entries) {
+    if (total_bytes <= max_bytes_) break;
+    if (std::remove(entry.path.c_str()) == 0) {
+      total_bytes -= entry.size;
+      ++stats_.num_evictions;
+      VLOG(4) << "Evict the kernel cache " << entry.path;
+    }
+  }
+}
+
+KernelDiskCache::Stats KernelDiskCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+int64_t KernelDiskCache::TotalBytes() const {
+  int64_t total_bytes = 0;
+  for (auto& entry : ListEntries(cache_dir_)) {
+    total_bytes += entry.size;
+  }
+  return total_bytes;
+}
+
+}  // namespace backends
+}  // namespace cinn
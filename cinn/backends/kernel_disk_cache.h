@@ -0,0 +1,75 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace backends {
+
+/**
+ * KernelDiskCache keeps the compiled kernels(PTX/CUBIN of NVRTC or objects of LLVM) on disk and addresses them by the
+ * hash of everything that affects the compilation result, so a process can skip the compilation of the kernels
+ * compiled by the previous runs.
+ *
+ * An entry is written into a temporary file and renamed into place, so the concurrent readers and writers, even from
+ * different processes, never see a partial entry. When the total size exceeds the limit, the least recently used
+ * entries are removed, the access time is tracked by the modification time of the files.
+ */
+class KernelDiskCache {
+ public:
+  struct Stats {
+    size_t num_hits{0};
+    size_t num_misses{0};
+    size_t num_evictions{0};
+  };
+
+  /**
+   * @param cache_dir The directory to hold the entries, it is created if not exists.
+   * @param max_bytes The limit of the total size of the entries, 0 means unlimited.
+   */
+  KernelDiskCache(const std::string& cache_dir, int64_t max_bytes);
+
+  //! The hex string of a 128-bit hash over \p parts, the boundaries of the parts are hashed too.
+  static std::string HashKey(const std::vector<std::string>& parts);
+
+  //! Read the entry of \p key into \p value, return false if it is not cached.
+  bool Lookup(const std::string& key, std::string* value);
+
+  void Insert(const std::string& key, const std::string& value);
+
+  Stats GetStats() const;
+
+  //! The total size in bytes of all the entries in the directory.
+  int64_t TotalBytes() const;
+
+ private:
+  std::string EntryPath(const std::string& key) const;
+
+  // remove the oldest entries until \p incoming_bytes more can be held
+  void Evict(int64_t incoming_bytes);
+
+  std::string cache_dir_;
+  int64_t max_bytes_;
+
+  mutable std::mutex mtx_;
+  Stats stats_;
+};
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/kernel_disk_cache.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdlib>
+
+namespace cinn {
+namespace backends {
+
+std::string MakeTempDir() {
+  char path[] = "/tmp/cinn_kernel_cache_XXXXXX";
+  CHECK(mkdtemp(path) != nullptr);
+  return std::string(path) + "/cache";
+}
+
+TEST(KernelDiskCache, HashKey) {
+  auto key = KernelDiskCache::HashKey({"code", "-arch=sm_70"});
+  ASSERT_EQ(key.size(), 32UL);
+  ASSERT_EQ(key, KernelDiskCache::HashKey({"code", "-arch=sm_70"}));
+  ASSERT_NE(key, KernelDiskCache::HashKey({"code", "-arch=sm_80"}));
+  // the boundaries of the parts matter
+  ASSERT_NE(KernelDiskCache::HashKey({"ab", "c"}), KernelDiskCache::HashKey({"a", "bc"}));
+}
+
+TEST(KernelDiskCache, HitAndMiss) {
+  std::string dir = MakeTempDir();
+  std::string value;
+  {
+    KernelDiskCache cache(dir, 0);
+    ASSERT_FALSE(cache.Lookup("k0", &value));
+    cache.Insert("k0", "ptx of k0");
+    ASSERT_TRUE(cache.Lookup("k0", &value));
+    ASSERT_EQ(value, "ptx of k0");
+    auto stats = cache.GetStats();
+    ASSERT_EQ(stats.num_hits, 1UL);
+    ASSERT_EQ(stats.num_misses, 1UL);
+  }
+  // the entries persist across the instances
+  KernelDiskCache cache(dir, 0);
+  ASSERT_TRUE(cache.Lookup("k0", &value));
+  ASSERT_EQ(value, "ptx of k0");
+}
+
+TEST(KernelDiskCache, EvictLeastRecentlyUsed) {
+  std::string dir = MakeTempDir();
+  KernelDiskCache cache(dir, 250);
+  std::string value;
+  cache.Insert("k0", std::string(100, 'a'));
+  usleep(10000);
+  cache.Insert("k1", std::string(100, 'b'));
+  usleep(10000);
+  // k0 becomes the most recently used one
+  ASSERT_TRUE(cache.Lookup("k0", &value));
+  usleep(10000);
+  cache.Insert("k2", std::string(100, 'c'));
+
+  ASSERT_EQ(cache.GetStats().num_evictions, 1UL);
+  ASSERT_LE(cache.TotalBytes(), 250);
+  ASSERT_TRUE(cache.Lookup("k0", &value));
+  ASSERT_FALSE(cache.Lookup("k1", &value));
+  ASSERT_TRUE(cache.Lookup("k2", &value));
+}
+
+}  // namespace backends
+}  // namespace cinn
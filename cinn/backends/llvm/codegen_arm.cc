@@ -0,0 +1,41 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/codegen_arm.h"
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/Function.h>
+
+#include "cinn/common/target.h"
+
+namespace cinn::backends {
+
+CodeGenARM::CodeGenARM(llvm::Module* m, llvm::IRBuilder<>* b, const std::shared_ptr<SymbolTable>& vars)
+    : CodeGenX86(m, b, vars) {}
+
+CodeGenARM::~CodeGenARM() {}
+
+void CodeGenARM::SetVectorWidthAttrs(llvm::Function* f) {
+  const auto& target = common::DefaultHostTarget();
+  if (!target.arm_supports(common::Target::ARMFeature::SVE)) return;
+#if LLVM_VERSION_MAJOR >= 12
+  // the vector length of SVE is fixed for the process, so the vectorizers size the scalable vectors by it, which
+  // also lets the fixed-width vectors of the vectorized loops use the whole SVE registers
+  unsigned vscale = target.arm_vector_bits() / 128;
+  f->addFnAttr(llvm::Attribute::getWithVScaleRangeArgs(f->getContext(), vscale, vscale));
+#endif
+}
+
+}  // namespace cinn::backends
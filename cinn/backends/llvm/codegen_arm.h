@@ -0,0 +1,36 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include <memory>
+
+#include "cinn/backends/llvm/codegen_x86.h"
+
+namespace cinn::backends {
+
+// The LLVM codegen of the AArch64 CPU. The parallel launch and the host runtime calls are the same as the X86 ones,
+// while the functions are tuned for the NEON or SVE vector registers of the host CPU.
+class CodeGenARM : public CodeGenX86 {
+ public:
+  explicit CodeGenARM(llvm::Module* m, llvm::IRBuilder<>* b, const std::shared_ptr<SymbolTable>& vars = nullptr);
+  virtual ~CodeGenARM();
+
+ protected:
+  void SetVectorWidthAttrs(llvm::Function* f) override;
+};
+
+}  // namespace cinn::backends
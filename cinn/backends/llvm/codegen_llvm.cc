@@ -350,8 +350,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
   auto from = op->v().type();
   auto to   = op->type();
 
-  llvm::Type *source = CinnTypeToLLVMType(from, m_);
-  llvm::Type *target = CinnTypeToLLVMType(to, m_);
+  llvm::Type *source = CinnTypeToLLVMType(from, m_, true);
+  llvm::Type *target = CinnTypeToLLVMType(to, m_, true);
   CHECK(source) << "source ir type is null";
   CHECK(target) << "target ir type is null";
 
@@ -673,6 +673,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::ScheduleBlockRealize *) { CINN_NOT_IMP
 llvm::Value *CodeGenLLVM::Visit(const ir::Call *op) {
   if (op->name == runtime::intrinsic::debug_log_repr) {
     return EmitCall_debug_info(op);
+  } else if (op->name == runtime::intrinsic::vector_reduce_add || op->name == runtime::intrinsic::vector_reduce_max ||
+             op->name == runtime::intrinsic::vector_reduce_min) {
+    return EmitCall_vector_reduce(op);
   } else if (op->is_extern_call()) {
     auto emitter_id     = ExternFuncID{backend_llvm_host, op->name.c_str()};
     const auto &fn_name = ExternFunctionEmitterRegistry::Global().Lookup(emitter_id);
@@ -1100,6 +1103,29 @@ llvm::Value *CodeGenLLVM::EmitCall_get_address(const ir::Call *op) {
   return nullptr;
 }
 
+llvm::Value *CodeGenLLVM::EmitCall_vector_reduce(const ir::Call *op) {
+  CHECK_EQ(op->read_args.size(), 1UL);
+  auto *vec = Visit(&op->read_args.front());
+  bool is_float = op->read_args.front().type().is_float();
+  if (op->name == runtime::intrinsic::vector_reduce_add) {
+    if (!is_float) return b_->CreateAddReduce(vec);
+    // the lanes are accumulated out of order, the same as the vectorized loop does
+    auto *res = b_->CreateFAddReduce(llvm::ConstantFP::getNegativeZero(CinnTypeToLLVMType(op->type(), m_)), vec);
+    llvm::cast<llvm::Instruction>(res)->setHasAllowReassoc(true);
+    return res;
+  }
+  bool is_max = op->name == runtime::intrinsic::vector_reduce_max;
+  if (!is_float) {
+    bool is_signed = op->read_args.front().type().is_int();
+    return is_max ? b_->CreateIntMaxReduce(vec, is_signed) : b_->CreateIntMinReduce(vec, is_signed);
+  }
+#if LLVM_VERSION_MAJOR >= 12
+  return is_max ? b_->CreateFPMaxReduce(vec) : b_->CreateFPMinReduce(vec);
+#else
+  return is_max ? b_->CreateFPMaxReduce(vec, /*NoNaN=*/true) : b_->CreateFPMinReduce(vec, /*NoNaN=*/true);
+#endif
+}
+
 llvm::Value *CodeGenLLVM::EmitCall_debug_info(const ir::Call *op) {
   auto callee = m_->getFunction(runtime::intrinsic::debug_log_repr);
   CHECK_GE(op->read_args.size(), 1UL);
@@ -1244,6 +1270,7 @@ void CodeGenLLVM::InitTarget(const Target &target) {
       naive_vec_alignment_ = 128;
       break;
     case Target::Arch::NVGPU:
+    case Target::Arch::AMDGPU:
       naive_vec_alignment_ = 128;
       break;
     case Target::Arch::Unk:
@@ -1320,13 +1347,21 @@ llvm::Value *CodeGenLLVM::Visit(const ir::IntrinsicOp *op) {
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferGetDataHandle *op) {
   std::vector<llvm::Value *> args({Visit(&op->buffer)});
   auto *callee = m_->getFunction("cinn_buffer_get_data_handle");
-  return Call(callee, std::move(args));
+  return AssumeBufferAligned(Call(callee, std::move(args)));
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferGetDataConstHandle *op) {
   std::vector<llvm::Value *> args({Visit(&op->buffer)});
   auto *callee = m_->getFunction("cinn_buffer_get_data_const_handle");
-  return Call(callee, std::move(args));
+  return AssumeBufferAligned(Call(callee, std::move(args)));
+}
+
+llvm::Value *CodeGenLLVM::AssumeBufferAligned(llvm::Value *memory) {
+  // the alignment is propagated to the loads and stores of the buffer, so they can be vectorized with aligned accesses
+  if (buffer_alignment_ > 0) {
+    b_->CreateAlignmentAssumption(m_->getDataLayout(), memory, buffer_alignment_);
+  }
+  return memory;
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BufferCreate *op) {
@@ -1459,6 +1494,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
       CHECK_GE(op->args.size(), 1U);
       llvm::Value *v = Visit(&op->args[0]);
       return b_->CreateFCmpUNO(v, v);
+    } else if (func_name == "reinterpret_cast") {
+      CHECK_GE(op->args.size(), 1U);
+      return b_->CreateBitCast(Visit(&op->args[0]), CinnTypeToLLVMType(op->type(), m_, true));
     }
   }
 
@@ -156,6 +156,9 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
 
   void Compile(const ir::Module &module);
 
+  //! Assume the memory of the buffers is aligned to \p alignment bytes, 0 assumes nothing.
+  void SetBufferAlignment(int alignment) { buffer_alignment_ = alignment; }
+
   using LLVMIRVisitor::Visit;
 
 #define __(op__) llvm::Value *Visit(const ir::op__ *) override;
@@ -200,6 +203,8 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::Value *EmitCall_buffer_malloc(const ir::Call *op);
   llvm::Value *EmitCall_get_address(const ir::Call *op);
   llvm::Value *EmitCall_debug_info(const ir::Call *op);
+  //! Reduce the lanes of the vector argument by the vector reduce intrinsics of LLVM.
+  llvm::Value *EmitCall_vector_reduce(const ir::Call *op);
   // @}
 
   llvm::Value *EmitBinaryOp(llvm::Value *lhs, llvm::Value *rhs, char opcode, bool is_integral, bool is_signed = true);
@@ -219,6 +224,9 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
    */
   void AddTbaaMetadata(llvm::Instruction *inst, absl::string_view buffer, Expr index);
 
+  //! Assume the \p memory of a buffer is aligned to buffer_alignment_ bytes, and return it.
+  llvm::Value *AssumeBufferAligned(llvm::Value *memory);
+
   void InitTarget(const Target &target);
 
   void Scalarize(const Expr &e, std::function<void(int i, llvm::Value *v)> flambda);
@@ -238,6 +246,7 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::MDNode *md_tbaa_alias_set_{nullptr};
 
   int naive_vec_alignment_{0};
+  int buffer_alignment_{0};
   Target target_;
 };
 namespace detail {
@@ -30,6 +30,7 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/Host.h"
 
 namespace cinn::backends {
 
@@ -62,6 +63,37 @@ void CodeGenX86::UnpackVars(const std::vector<std::string>& vars, llvm::Value* d
   }
 }
 
+void CodeGenX86::SetHostCPUAttrs(llvm::Function* f) {
+  static const std::string host_cpu = llvm::sys::getHostCPUName().str();
+  static const std::string host_features = []() {
+    llvm::StringMap<bool> feature_map;
+    std::string res;
+    if (!llvm::sys::getHostCPUFeatures(feature_map)) return res;
+    for (auto& feature : feature_map) {
+      if (!res.empty()) res += ",";
+      res += (feature.second ? "+" : "-") + feature.first().str();
+    }
+    return res;
+  }();
+  f->addFnAttr("target-cpu", host_cpu);
+  if (!host_features.empty()) f->addFnAttr("target-features", host_features);
+  SetVectorWidthAttrs(f);
+}
+
+void CodeGenX86::SetVectorWidthAttrs(llvm::Function* f) {
+  // LLVM prefers 256-bit vectors on the AVX-512 CPUs to avoid the frequency drop, while the compute-bound kernels
+  // generated by CINN run faster with the 512-bit ones.
+  std::string vector_bits = std::to_string(common::DefaultHostTarget().x86_vector_bits());
+  f->addFnAttr("prefer-vector-width", vector_bits);
+  f->addFnAttr("min-legal-vector-width", vector_bits);
+}
+
+llvm::Value* CodeGenX86::Visit(const ir::_LoweredFunc_* op) {
+  auto* f = llvm::cast<llvm::Function>(CodeGenLLVM::Visit(op));
+  SetHostCPUAttrs(f);
+  return f;
+}
+
 llvm::BasicBlock* CodeGenX86::CheckCallSuccess(llvm::Value* retcode) {
   llvm::BasicBlock* fail_block =
       llvm::BasicBlock::Create(b_->getContext(), "call_fail", b_->GetInsertBlock()->getParent(), nullptr);
@@ -80,6 +112,7 @@ void CodeGenX86::CreateParallelLaunch(Expr body, int num_task) {
       llvm::FunctionType::get(ll_int32_ty(), {ll_int32_ty(), ll_int32_ty(), ll_type_of(Float(32).PointerOf())}, false);
   llvm::Function* f =
       llvm::Function::Create(ftype_parallel_lambda, llvm::Function::PrivateLinkage, "__parallel_lambda", m_);
+  SetHostCPUAttrs(f);
   std::vector<std::string> vars = optim::CollectUndefinedVars(&body);
   uint64_t nbytes;
   auto* data = PackVars(vars, &nbytes);
@@ -33,6 +33,11 @@ class CodeGenX86 : public CodeGenLLVM {
   using LLVMIRVisitor::Visit;
 
   llvm::Value* Visit(const ir::For* op);
+  llvm::Value* Visit(const ir::_LoweredFunc_* op);
+
+ protected:
+  // Let the vectorizers use the widest vector register of the CPU.
+  virtual void SetVectorWidthAttrs(llvm::Function* f);
 
  private:
   // parallel information
@@ -52,6 +57,8 @@ class CodeGenX86 : public CodeGenLLVM {
   llvm::Value* PackVars(const std::vector<std::string>& vars, uint64_t* num_bytes);
   void UnpackVars(const std::vector<std::string>& vars, llvm::Value* data);
   llvm::BasicBlock* CheckCallSuccess(llvm::Value* retcode);
+  // Tune the function for the host CPU, and set its vector width by SetVectorWidthAttrs.
+  void SetHostCPUAttrs(llvm::Function* f);
   // Current parallel environment scope.
   ParallelEnv parallel_env_;
 };
@@ -14,13 +14,18 @@
 
 #include "cinn/backends/llvm/codegen_x86.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "cinn/backends/llvm/simple_jit.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/runtime/cinn_runtime.h"
 
+DECLARE_string(cinn_x86_vector_math);
+
 namespace cinn {
 namespace backends {
 
@@ -69,5 +74,60 @@ TEST(Vectorize, basic) {
   }
 }
 
+TEST(Vectorize, vector_math) {
+  FLAGS_cinn_x86_vector_math = "fast";
+  Expr M(1024);
+  Placeholder<float> A("A", {M});
+
+  auto Exp = Compute(
+      {M}, [&](Expr i) { return lang::Exp(A(i)); }, "Exp");
+  auto Log = Compute(
+      {M}, [&](Expr i) { return lang::Log(lang::Abs(A(i))); }, "Log");
+  auto Tanh = Compute(
+      {M}, [&](Expr i) { return lang::Tanh(A(i)); }, "Tanh");
+  auto Erf = Compute(
+      {M}, [&](Expr i) { return lang::Erf(A(i)); }, "Erf");
+  auto stages = CreateStages({Exp, Log, Tanh, Erf});
+  for (auto& tensor : {Exp, Log, Tanh, Erf}) {
+    stages[tensor]->Vectorize(0, 8);
+  }
+
+  auto fn = Lower("fn", stages, {A, Exp, Log, Tanh, Erf});
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  auto jit = SimpleJIT::Create();
+  jit->Link(builder.Build());
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+  FLAGS_cinn_x86_vector_math = "precise";
+
+  auto* A_buf = common::BufferBuilder(Float(32), {1024}).set_zero().set_align(64).Build();
+  std::vector<cinn_buffer_t*> out_bufs;
+  for (int i = 0; i < 4; i++) {
+    out_bufs.push_back(common::BufferBuilder(Float(32), {1024}).set_zero().set_align(64).Build());
+  }
+  auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+  for (int i = 0; i < A_buf->num_elements(); i++) {
+    A_data[i] = -20.f + 40.f * (i + 0.5f) / A_buf->num_elements();
+  }
+
+  auto args =
+      common::ArgsBuilder().Add(A_buf).Add(out_bufs[0]).Add(out_bufs[1]).Add(out_bufs[2]).Add(out_bufs[3]).Build();
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  // the fast tanh and erf are within 6 ULP
+  auto check = [&](int k, float (*ref)(float)) {
+    auto* out = reinterpret_cast<float*>(out_bufs[k]->memory);
+    for (int i = 0; i < A_buf->num_elements(); i++) {
+      float expected = ref(A_data[i]);
+      ASSERT_NEAR(expected, out[i], std::abs(expected) * 1e-6f) << "at x = " << A_data[i];
+    }
+  };
+  check(0, [](float x) { return std::exp(x); });
+  check(1, [](float x) { return std::log(std::abs(x)); });
+  check(2, [](float x) { return std::tanh(x); });
+  check(3, [](float x) { return std::erf(x); });
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -48,6 +48,8 @@
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
 
+#include <gflags/gflags.h>
+
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -57,6 +59,7 @@
 #include "cinn/backends/codegen_cuda_host.h"
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
 #include "cinn/backends/llvm/codegen_llvm.h"
+#include "cinn/backends/llvm/codegen_arm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
 #include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
@@ -65,6 +68,9 @@
 #include "cinn/runtime/intrinsic.h"
 #include "cinn/utils/profiler.h"
 
+DECLARE_string(cinn_llvm_object_cache_dir);
+DECLARE_int64(cinn_llvm_object_cache_max_bytes);
+
 namespace cinn::backends {
 namespace {
 void InitializeLLVMPasses() {
@@ -88,11 +94,13 @@ void InitializeLLVMPasses() {
 }
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
+  std::lock_guard<std::mutex> lock(mu_);
   cached_objects_[m->getModuleIdentifier()] =
       llvm::MemoryBuffer::getMemBufferCopy(obj_buffer.getBuffer(), obj_buffer.getBufferIdentifier());
 }
 
 std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Module *m) {
+  std::lock_guard<std::mutex> lock(mu_);
   auto it = cached_objects_.find(m->getModuleIdentifier());
   if (it == cached_objects_.end()) {
     VLOG(1) << "No object for " << m->getModuleIdentifier() << " in cache. Compiling.";
@@ -103,6 +111,93 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
 }
 
+namespace {
+constexpr char kObjectKeyPrefix[] = "cinn_object_";
+}  // namespace
+
+void DiskObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
+  NaiveObjectCache::notifyObjectCompiled(m, obj_buffer);
+  if (IsCacheKey(m->getModuleIdentifier())) {
+    disk_cache_->Insert(m->getModuleIdentifier(), obj_buffer.getBuffer().str());
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::getObject(const llvm::Module *m) {
+  const std::string &key = m->getModuleIdentifier();
+  bool in_memory         = false;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    in_memory = cached_objects_.count(key);
+  }
+  if (in_memory || !IsCacheKey(key)) {
+    return NaiveObjectCache::getObject(m);
+  }
+  std::string object;
+  if (!disk_cache_->Lookup(key, &object)) {
+    VLOG(3) << "No object for " << key << " in disk cache.";
+    return nullptr;
+  }
+  VLOG(3) << "Object for " << key << " loaded from disk cache.";
+  // keep a copy in memory, the object is asked again when the module is compiled by jit
+  std::lock_guard<std::mutex> lock(mu_);
+  cached_objects_[key] = llvm::MemoryBuffer::getMemBufferCopy(object, key);
+  return llvm::MemoryBuffer::getMemBuffer(cached_objects_[key]->getMemBufferRef());
+}
+
+std::string DiskObjectCache::MakeKey(const llvm::Module &module,
+                                     const llvm::TargetMachine &machine,
+                                     const OptimizeOptions &options) {
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  module.print(os, nullptr);
+  os.flush();
+  return kObjectKeyPrefix + KernelDiskCache::HashKey({ir,
+                                                      machine.getTargetTriple().str(),
+                                                      machine.getTargetCPU().str(),
+                                                      machine.getTargetFeatureString().str(),
+                                                      std::to_string(options.opt_level),
+                                                      std::to_string(options.loop_vectorize),
+                                                      std::to_string(options.slp_vectorize),
+                                                      std::to_string(options.loop_interleave),
+                                                      std::to_string(options.fast_math),
+                                                      std::to_string(options.inline_threshold),
+                                                      LLVM_VERSION_STRING});
+}
+
+KernelDiskCache *DiskObjectCache::GlobalDiskCache() {
+  if (FLAGS_cinn_llvm_object_cache_dir.empty()) return nullptr;
+  static KernelDiskCache cache(FLAGS_cinn_llvm_object_cache_dir, FLAGS_cinn_llvm_object_cache_max_bytes);
+  return &cache;
+}
+
+bool DiskObjectCache::IsCacheKey(const std::string &identifier) {
+  return identifier.compare(0, sizeof(kObjectKeyPrefix) - 1, kObjectKeyPrefix) == 0;
+}
+
+ExecutionEngine::ExecutionEngine(bool enable_object_cache, RuntimeSymbols &&module_symbols)
+    : module_symbols_(std::move(module_symbols)) {
+  auto *disk_cache = DiskObjectCache::GlobalDiskCache();
+  if (enable_object_cache && disk_cache) {
+    cache_ = std::make_unique<DiskObjectCache>(disk_cache);
+    use_disk_cache_ = true;
+  } else {
+    cache_ = std::make_unique<NaiveObjectCache>();
+  }
+}
+
+OptimizeOptions ExecutionOptions::GetOptimizeOptions() const {
+  OptimizeOptions res;
+  res.opt_level        = opt_level;
+  res.use_host_cpu     = use_host_cpu;
+  res.loop_vectorize   = loop_vectorize;
+  res.slp_vectorize    = slp_vectorize;
+  res.loop_interleave  = loop_interleave;
+  res.fast_math        = fast_math;
+  res.inline_threshold = inline_threshold;
+  res.print_passes     = true;
+  return res;
+}
+
 /*static*/ std::unique_ptr<ExecutionEngine> ExecutionEngine::Create(const ExecutionOptions &config) {
   return Create(config, {});
 }
@@ -117,15 +212,17 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   static std::once_flag flag;
   std::call_once(flag, InitializeLLVMPasses);
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  auto engine      = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  engine->options_ = config;
 
-  auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
+  // the machines of jit are the same as the one Link optimizes the modules for, a machine is created for each
+  // compilation so that the modules can be compiled concurrently
+  auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
-    auto machine = llvm::cantFail(jtmb.createTargetMachine());
+    auto jtmb = HostTargetMachineBuilder(engine->options_.GetOptimizeOptions());
     VLOG(1) << "create llvm compile layer";
-    VLOG(1) << "Target Name: " << machine->getTarget().getName();
-    VLOG(1) << "Target CPU: " << machine->getTargetCPU().str() << std::endl;
-    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(machine), engine->cache_.get());
+    VLOG(1) << "Target CPU: " << jtmb.getCPU() << std::endl;
+    return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), engine->cache_.get());
   };
 
   auto object_layer_creator = [&](llvm::orc::ExecutionSession &session, const llvm::Triple &triple) {
@@ -142,6 +239,7 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   engine->jit_ = llvm::cantFail(llvm::orc::LLJITBuilder()
                                     .setCompileFunctionCreator(compile_layer_creator)
                                     .setObjectLinkingLayerCreator(object_layer_creator)
+                                    .setNumCompileThreads(config.num_compile_threads)
                                     .create());
   engine->jit_->getMainJITDylib().addGenerator(llvm::cantFail(
       llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(engine->jit_->getDataLayout().getGlobalPrefix())));
@@ -155,33 +253,76 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 }
 
 template <typename CodeGenT>
-void ExecutionEngine::Link(const ir::Module &module) {
-  utils::RecordEvent("ExecutionEngine Link", utils::EventType::kOrdinary);
+void ExecutionEngine::Link(const ir::Module &module, std::string *object) {
+  utils::RecordEvent record_event("ExecutionEngine Link", utils::EventType::kOrdinary);
   llvm::SMDiagnostic error;
   auto ctx        = std::make_unique<llvm::LLVMContext>();
   auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
   auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
+  // the runtime IR is defined by every module linked into the engine, so it is kept private to each module
+  std::vector<llvm::GlobalObject *> runtime_values;
+  for (auto &f : m->functions()) {
+    if (!f.isDeclaration()) runtime_values.push_back(&f);
+  }
+  for (auto &g : m->globals()) {
+    if (!g.isDeclaration()) runtime_values.push_back(&g);
+  }
+  if (options_.fast_math) {
+    llvm::FastMathFlags fast_math_flags;
+    fast_math_flags.setFast();
+    b->setFastMathFlags(fast_math_flags);
+  }
   auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+  ir_emitter->SetBufferAlignment(options_.buffer_alignment);
   VLOG(3) << "ir_emitter->Compile(module) Begin";
   ir_emitter->Compile(module);
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
+  for (auto *value : runtime_values) {
+    value->setLinkage(llvm::GlobalValue::InternalLinkage);
+    value->setComdat(nullptr);
+  }
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  OptimizeOptions optimize_options = options_.GetOptimizeOptions();
+  auto machine                     = CreateHostTargetMachine(optimize_options);
+  m->setDataLayout(machine->createDataLayout());
+  // the object is linked instead of the IR, so that the module is compiled only once here, by the thread linking it
+  llvm::SmallString<0> object_buffer;
+  auto add_object = [&]() {
+    llvm::cantFail(jit_->addObjectFile(
+        llvm::MemoryBuffer::getMemBufferCopy(object_buffer.str(), m->getModuleIdentifier())));
+    if (object) {
+      object->assign(object_buffer.data(), object_buffer.size());
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    buffer_ = std::move(object_buffer);
+  };
+  if (use_disk_cache_) {
+    m->setModuleIdentifier(DiskObjectCache::MakeKey(*m, *machine, optimize_options));
+    // the optimizer and the object emission are skipped on a hit
+    if (auto cached_object = cache_->getObject(m.get())) {
+      object_buffer.assign(cached_object->getBufferStart(), cached_object->getBufferEnd());
+      add_object();
+      return;
+    }
+  }
+
+  LLVMModuleOptimizer optimize(machine.get(), optimize_options);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
     VLOG(5) << "function: " << DumpToString(f);
   }
 
-  llvm::raw_svector_ostream rawstream(buffer_);
+  llvm::raw_svector_ostream rawstream(object_buffer);
   llvm::legacy::PassManager pass_manager;
   machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
   pass_manager.run(*m);
+  if (use_disk_cache_) {
+    cache_->notifyObjectCompiled(m.get(), llvm::MemoryBufferRef(object_buffer.str(), m->getModuleIdentifier()));
+  }
 
-  CHECK(AddModule(std::move(m), std::move(ctx)));
+  add_object();
 
   if (VLOG_IS_ON(5)) {
     VLOG(5) << "======= dump jit execution session ======";
@@ -195,7 +336,7 @@ void ExecutionEngine::Link(const ir::Module &module) {
 }
 
 bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context) {
-  utils::RecordEvent("ExecutionEngine AddModule", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("ExecutionEngine AddModule", utils::EventType::kOrdinary);
   module->setDataLayout(jit_->getDataLayout());
   if (VLOG_IS_ON(5)) {
     VLOG(5) << "======= dump jit lib ==========";
@@ -212,6 +353,13 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
   return true;
 }
 
+void ExecutionEngine::AddObject(const std::string &object) {
+  utils::RecordEvent record_event("ExecutionEngine AddObject", utils::EventType::kOrdinary);
+  buffer_.assign(object.begin(), object.end());
+  auto object_buffer = llvm::MemoryBuffer::getMemBufferCopy(AsStringRef(object), "cinn_loaded_object");
+  llvm::cantFail(jit_->addObjectFile(std::move(object_buffer)));
+}
+
 void ExecutionEngine::ExportObject(const std::string &path) {
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
@@ -219,7 +367,7 @@ void ExecutionEngine::ExportObject(const std::string &path) {
 }
 
 void *ExecutionEngine::Lookup(absl::string_view name) {
-  utils::RecordEvent("ExecutionEngine Lookup", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("ExecutionEngine Lookup", utils::EventType::kOrdinary);
   std::lock_guard<std::mutex> lock(mu_);
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
     return reinterpret_cast<void *>(symbol->getAddress());
@@ -230,21 +378,34 @@ void *ExecutionEngine::Lookup(absl::string_view name) {
 }
 
 void ExecutionEngine::RegisterRuntimeSymbols() {
-  utils::RecordEvent("ExecutionEngine RegisterRuntimeSymbols", utils::EventType::kOrdinary);
-  const auto &registry = GlobalSymbolRegistry::Global();
-  auto *session        = &jit_->getExecutionSession();
-  for (const auto &sym : registry.All()) {
-    llvm::cantFail(jit_->define(llvm::orc::absoluteSymbols(
-        {{session->intern(sym.first), {llvm::pointerToJITTargetAddress(sym.second), llvm::JITSymbolFlags::None}}})));
+  utils::RecordEvent record_event("ExecutionEngine RegisterRuntimeSymbols", utils::EventType::kOrdinary);
+  DefineSymbols(GlobalSymbolRegistry::Global());
+  DefineSymbols(module_symbols_);
+}
+
+void ExecutionEngine::RegisterSymbols(RuntimeSymbols &&symbols) {
+  auto holder = std::make_unique<RuntimeSymbols>(std::move(symbols));
+  DefineSymbols(*holder);
+  std::lock_guard<std::mutex> lock(mu_);
+  registered_symbols_.push_back(std::move(holder));
+}
+
+void ExecutionEngine::DefineSymbols(const RuntimeSymbols &symbols) {
+  // all the symbols are defined at once, as each definition is a materialization unit of the session
+  llvm::orc::SymbolMap symbol_map;
+  auto *session = &jit_->getExecutionSession();
+  for (const auto &sym : symbols.All()) {
+    symbol_map[session->intern(sym.first)] = {llvm::pointerToJITTargetAddress(sym.second),
+                                              llvm::JITSymbolFlags::None};
   }
-  for (const auto &sym : module_symbols_.All()) {
-    llvm::cantFail(jit_->define(llvm::orc::absoluteSymbols(
-        {{session->intern(sym.first), {llvm::pointerToJITTargetAddress(sym.second), llvm::JITSymbolFlags::None}}})));
+  if (!symbol_map.empty()) {
+    llvm::cantFail(jit_->define(llvm::orc::absoluteSymbols(std::move(symbol_map))));
   }
 }
 
-template void ExecutionEngine::Link<CodeGenLLVM>(const ir::Module &module);
-template void ExecutionEngine::Link<CodeGenX86>(const ir::Module &module);
-template void ExecutionEngine::Link<CodeGenCUDA_Host>(const ir::Module &module);
+template void ExecutionEngine::Link<CodeGenLLVM>(const ir::Module &module, std::string *object);
+template void ExecutionEngine::Link<CodeGenX86>(const ir::Module &module, std::string *object);
+template void ExecutionEngine::Link<CodeGenARM>(const ir::Module &module, std::string *object);
+template void ExecutionEngine::Link<CodeGenCUDA_Host>(const ir::Module &module, std::string *object);
 
 }  // namespace cinn::backends
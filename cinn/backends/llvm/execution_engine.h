@@ -43,7 +43,10 @@
 #include <string>
 #include <vector>
 
+#include "cinn/backends/kernel_disk_cache.h"
+#include "cinn/backends/llvm/codegen_arm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/module.h"
@@ -55,16 +58,60 @@ class NaiveObjectCache : public llvm::ObjectCache {
   void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
 
- private:
+ protected:
+  // the objects are notified and got by the threads compiling the modules concurrently
+  std::mutex mu_;
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cached_objects_;
 };
 
+/**
+ * DiskObjectCache keeps the objects in memory like NaiveObjectCache, and also persists them into a KernelDiskCache, so
+ * that a restarted process loads the objects instead of optimizing and compiling the modules again.
+ *
+ * Only the modules whose identifier is made by MakeKey are persisted, the key covers the IR before optimization, the
+ * target triple, CPU and features, the optimization options and the LLVM version.
+ */
+class DiskObjectCache : public NaiveObjectCache {
+ public:
+  explicit DiskObjectCache(KernelDiskCache *disk_cache) : disk_cache_(disk_cache) {}
+
+  void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
+
+  static std::string MakeKey(const llvm::Module &module,
+                             const llvm::TargetMachine &machine,
+                             const OptimizeOptions &options);
+
+  //! The disk cache configured by FLAGS_cinn_llvm_object_cache_dir, nullptr if the flag is empty.
+  static KernelDiskCache *GlobalDiskCache();
+
+ private:
+  static bool IsCacheKey(const std::string &identifier);
+
+  KernelDiskCache *disk_cache_;
+};
+
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
-  // TODO(fc500110)
-  // int num_compile_threads{1};
-  // bool enable_fast_math;
+  //! The number of the threads of the jit compiling the modules added by AddModule concurrently, 0 means the modules
+  //! are compiled by the threads looking up their symbols.
+  int num_compile_threads{0};
+
+  //! The options of the LLVM optimization pipeline, see OptimizeOptions.
+  // @{
+  bool use_host_cpu{true};
+  bool loop_vectorize{true};
+  bool slp_vectorize{true};
+  bool loop_interleave{true};
+  bool fast_math{false};
+  int inline_threshold{-1};
+  // @}
+
+  //! The alignment in bytes of the memory of the buffers assumed by the generated code, 0 assumes nothing.
+  int buffer_alignment{0};
+
+  OptimizeOptions GetOptimizeOptions() const;
 };
 
 class ExecutionEngine {
@@ -75,19 +122,38 @@ class ExecutionEngine {
 
   void *Lookup(absl::string_view name);
 
+  /**
+   * Compile the \p module into an object and link it, several threads can link their modules into the same engine
+   * at the same time. The object is materialized on the first lookup of its symbols.
+   * @param module The module to link, whose functions are looked up by their names.
+   * @param object If not nullptr, get the object code emitted for the module.
+   */
   template <typename CodeGenT = CodeGenLLVM>
-  void Link(const ir::Module &module);
+  void Link(const ir::Module &module, std::string *object = nullptr);
+
+  //! Define the \p symbols for the modules linked after, such as the kernel pointers of the CUDA host modules.
+  void RegisterSymbols(RuntimeSymbols &&symbols);
 
   void ExportObject(const std::string &path);
 
+  //! The object code emitted by the last Link.
+  std::string GetObject() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return std::string(buffer_.data(), buffer_.size());
+  }
+
+  //! Link an object emitted by the engine before, such as the one got by GetObject, without compiling any IR.
+  void AddObject(const std::string &object);
+
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
 
  protected:
-  explicit ExecutionEngine(bool enable_object_cache, RuntimeSymbols &&module_symbols)
-      : cache_(std::make_unique<NaiveObjectCache>()), module_symbols_(std::move(module_symbols)) {}
+  explicit ExecutionEngine(bool enable_object_cache, RuntimeSymbols &&module_symbols);
 
   void RegisterRuntimeSymbols();
 
+  void DefineSymbols(const RuntimeSymbols &symbols);
+
   bool SetupTargetTriple(llvm::Module *module);
 
   // This may not be a compatible implementation.
@@ -98,7 +164,12 @@ class ExecutionEngine {
   llvm::SmallString<0> buffer_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
+  // whether cache_ is a DiskObjectCache
+  bool use_disk_cache_{false};
   RuntimeSymbols module_symbols_;
+  // the symbols registered after the engine is created, which hold the values of the scalar symbols
+  std::vector<std::unique_ptr<RuntimeSymbols>> registered_symbols_;
+  ExecutionOptions options_;
 };
 
 }  // namespace cinn::backends
@@ -32,6 +32,7 @@
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -325,5 +326,54 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, link_concurrently) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+
+  // the modules are linked into one engine by several threads, each of them defines the runtime IR too
+  constexpr int kNumModules = 4;
+  std::vector<ir::Module> modules;
+  for (int i = 0; i < kNumModules; i++) {
+    Placeholder<float> x("x", {M, N});
+    Placeholder<float> y("y", {M, N});
+    auto out    = Compute(
+        {M, N}, [=](Var m, Var n) { return x(m, n) * Expr(static_cast<float>(i)) + y(m, n); }, "out");
+    auto stages = CreateStages({out});
+    Module::Builder builder("module_" + std::to_string(i), common::DefaultHostTarget());
+    builder.AddFunction(Lower("axpy_" + std::to_string(i), stages, {x, y, out}));
+    modules.push_back(builder.Build());
+  }
+
+  auto engine = backends::ExecutionEngine::Create({1});
+  std::vector<std::string> objects(kNumModules);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumModules; i++) {
+    threads.emplace_back([&, i] { engine->Link(modules[i], &objects[i]); });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  auto _ab_bb_cb_ = CreateTestBuffer();  // NOLINT
+  auto &ab        = std::get<0>(_ab_bb_cb_);
+  auto &bb        = std::get<1>(_ab_bb_cb_);
+  auto &cb        = std::get<2>(_ab_bb_cb_);
+  auto *ad        = reinterpret_cast<float *>(ab->memory);
+  auto *bd        = reinterpret_cast<float *>(bb->memory);
+  auto *cd        = reinterpret_cast<float *>(cb->memory);
+  for (int i = 0; i < kNumModules; i++) {
+    ASSERT_FALSE(objects[i].empty());
+    auto axpy = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup("axpy_" + std::to_string(i)));
+    ASSERT_NE(axpy, nullptr);
+
+    cinn_pod_value_t a_arg(ab), b_arg(bb), c_arg(cb);
+    cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+    axpy(args, 3);
+    for (int j = 0; j < kM * kN; j++) {
+      ASSERT_NEAR(cd[j], ad[j] * i + bd[j], 1e-5);
+    }
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
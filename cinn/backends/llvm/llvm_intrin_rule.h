@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "cinn/backends/llvm/llvm_vector_math.h"
 #include "cinn/cinn.h"
 #include "cinn/ir/intrinsic_ops.h"
 #include "cinn/ir/registry.h"
@@ -45,13 +46,26 @@ inline void MakeFloatIntrinOp(lang::Args args, lang::RetValue *rv) {
   }
 }
 
+//! Expand the call into the inline vector math if it is enabled for its type, otherwise lower it into the intrinsic.
+template <int id>
+inline void MakeVectorMathOrFloatIntrinOp(Expr (*expand)(Expr), lang::Args args, lang::RetValue *rv) {
+  CHECK_GE(args.size(), 1U);
+  Expr arg       = args[0];
+  ir::Call *node = arg->as<ir::Call>();
+  CHECK(node);
+  CHECK(!node->read_args.empty());
+  if (UseX86VectorMath(node->name, node->type())) {
+    *rv = expand(node->read_args[0]);
+  } else {
+    MakeFloatIntrinOp<id, 1>(args, rv);
+  }
+}
+
 void RegisterCpuIntrinRule() {
 #define __(intrin_name__, id) \
   ir::Registry::Register("lower_cpu_intrinsic_" #intrin_name__, true).SetBody(MakeFloatIntrinOp<id, 1>);
-  __(exp, ::llvm::Intrinsic::exp)
   __(exp2, ::llvm::Intrinsic::exp2)
   __(sqrt, ::llvm::Intrinsic::sqrt)
-  __(log, ::llvm::Intrinsic::log)
   __(log2, ::llvm::Intrinsic::log2)
   __(log10, ::llvm::Intrinsic::log10)
   __(floor, ::llvm::Intrinsic::floor)
@@ -63,6 +77,24 @@ void RegisterCpuIntrinRule() {
   __(fabs, ::llvm::Intrinsic::fabs)
 #undef __
 
+  ir::Registry::Register("lower_cpu_intrinsic_exp", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    MakeVectorMathOrFloatIntrinOp<::llvm::Intrinsic::exp>(X86VectorExp, args, rv);
+  });
+
+  ir::Registry::Register("lower_cpu_intrinsic_log", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    MakeVectorMathOrFloatIntrinOp<::llvm::Intrinsic::log>(X86VectorLog, args, rv);
+  });
+
+  // erf is left by MapExternCall only if it is expanded, the others are returned as they are
+  ir::Registry::Register("lower_cpu_intrinsic_erf", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    CHECK_GE(args.size(), 1U);
+    Expr arg0      = args[0];
+    ir::Call *node = arg0->as<ir::Call>();
+    CHECK(node);
+    CHECK(!node->read_args.empty());
+    *rv = UseX86VectorMath(node->name, node->type()) ? X86VectorErf(node->read_args[0]) : arg0;
+  });
+
 // set id -1 if not llvm intrinsics
 #define RegisterBitwise(intrin_name__) \
   ir::Registry::Register("lower_cpu_intrinsic_" #intrin_name__, true).SetBody(MakeFloatIntrinOp<-1, 2, false>);
@@ -139,7 +171,11 @@ void RegisterCpuIntrinRule() {
     ir::Call *node = arg0->as<ir::Call>();
     CHECK(node);
     CHECK(!node->read_args.empty());
-    Expr arg     = node->read_args[0];
+    Expr arg = node->read_args[0];
+    if (UseX86VectorMath(node->name, node->type())) {
+      *rv = X86VectorTanh(arg);
+      return;
+    }
     Expr zero    = make_const(arg->type(), 0);
     Expr one     = make_const(arg->type(), 1);
     Expr two     = make_const(arg->type(), 2);
@@ -24,6 +24,7 @@
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
 #include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/LambdaResolver.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
@@ -38,6 +39,7 @@
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
@@ -115,16 +117,53 @@ using CustomFunctionPassManager = CustomPassManager<llvm::legacy::FunctionPassMa
 using CustomModulePassManager   = CustomPassManager<llvm::legacy::PassManager>;
 }  // namespace
 
-LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                                         int opt_level,
-                                         llvm::FastMathFlags fast_math_flags,
-                                         bool print_passes)
-    : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
+std::unique_ptr<llvm::TargetMachine> CreateHostTargetMachine(const OptimizeOptions &options) {
+  return llvm::cantFail(HostTargetMachineBuilder(options).createTargetMachine());
+}
+
+llvm::orc::JITTargetMachineBuilder HostTargetMachineBuilder(const OptimizeOptions &options) {
+  llvm::orc::JITTargetMachineBuilder jtmb{llvm::Triple(llvm::sys::getProcessTriple())};
+  if (options.use_host_cpu) {
+    jtmb.setCPU(llvm::sys::getHostCPUName().str());
+    llvm::StringMap<bool> host_features;
+    if (llvm::sys::getHostCPUFeatures(host_features)) {
+      for (auto &feature : host_features) {
+        jtmb.getFeatures().AddFeature(feature.first(), feature.second);
+      }
+    }
+  }
+  // the objects are position independent, so that the exported ones can be linked into a shared library for the
+  // deploy runtime
+  jtmb.setRelocationModel(llvm::Reloc::PIC_);
+  jtmb.setCodeGenOptLevel(options.opt_level >= 3   ? llvm::CodeGenOpt::Aggressive
+                          : options.opt_level == 0 ? llvm::CodeGenOpt::None
+                                                   : llvm::CodeGenOpt::Default);
+  if (options.fast_math) {
+    auto &target_options               = jtmb.getOptions();
+    target_options.UnsafeFPMath        = true;
+    target_options.NoInfsFPMath        = true;
+    target_options.NoNaNsFPMath        = true;
+    target_options.NoSignedZerosFPMath = true;
+    target_options.AllowFPOpFusion     = llvm::FPOpFusion::Fast;
+  }
+  return jtmb;
+}
+
+LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine, const OptimizeOptions &options)
+    : machine_(machine), options_(options) {}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
+  if (options_.fast_math) {
+    for (auto &fn : *m) {
+      if (fn.isDeclaration()) continue;
+      for (const char *attr :
+           {"unsafe-fp-math", "no-infs-fp-math", "no-nans-fp-math", "no-signed-zeros-fp-math", "approx-func-fp-math"}) {
+        fn.addFnAttr(attr, "true");
+      }
+    }
+  }
+
+  auto fpm = std::make_unique<CustomFunctionPassManager>(options_.print_passes, m);
   // fpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
   // fpm->add(llvm::createInstructionCombiningPass());
   // fpm->add(llvm::createReassociatePass());
@@ -139,19 +178,22 @@ void LLVMModuleOptimizer::operator()(llvm::Module *m) {
   // fpm->add(llvm::createLoadStoreVectorizerPass());
   // fpm->add(llvm::createLoopUnrollPass());
 
-  auto mpm = std::make_unique<CustomModulePassManager>(print_passes_);
+  auto mpm = std::make_unique<CustomModulePassManager>(options_.print_passes);
   // mpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
   // LOG(INFO) << "llvm run pass: target machine: name[" << machine_->getTarget().getName() << "]";
   // LOG(INFO) << "llvm run pass: target machine: cpu[" << machine_->getTargetCPU().str() << "]";
-  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  auto builder           = std::make_unique<llvm::PassManagerBuilder>();
-  builder->OptLevel      = opt_level_;
-  builder->Inliner       = llvm::createFunctionInliningPass();
-  builder->LoopVectorize = true;
-  builder->SLPVectorize  = true;
+  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
+  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
+  auto builder              = std::make_unique<llvm::PassManagerBuilder>();
+  builder->OptLevel         = options_.opt_level;
+  builder->Inliner          = options_.inline_threshold >= 0
+                                  ? llvm::createFunctionInliningPass(options_.inline_threshold)
+                                  : llvm::createFunctionInliningPass(options_.opt_level, 0, false);
+  builder->LoopVectorize    = options_.loop_vectorize;
+  builder->SLPVectorize     = options_.slp_vectorize;
+  builder->LoopsInterleaved = options_.loop_interleave;
 #if LLVM_VERSION_MAJOR >= 11
-  machine->adjustPassManager(*builder);
+  machine_->adjustPassManager(*builder);
 #endif
   builder->populateFunctionPassManager(*fpm);
   builder->populateModulePassManager(*mpm);
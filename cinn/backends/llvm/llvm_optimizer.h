@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
@@ -21,23 +22,42 @@
 #include <llvm/Target/TargetMachine.h>
 
 #include <functional>
+#include <memory>
 
 namespace cinn::backends {
 
-// TODO(fc500110): define class OptimizeOptions
+struct OptimizeOptions {
+  int opt_level{3};
+  //! Tune for the CPU of this machine and use all its features like `-march=native`, otherwise for the generic CPU of
+  //! the target triple.
+  bool use_host_cpu{true};
+  bool loop_vectorize{true};
+  bool slp_vectorize{true};
+  //! Interleave the iterations of the vectorized loops to hide the latency of the vector instructions.
+  bool loop_interleave{true};
+  //! Mark the functions with the unsafe fast-math attributes, which allows reassociating the floating-point reductions
+  //! for vectorization.
+  bool fast_math{false};
+  //! The inlining threshold, a negative value uses the default one of opt_level.
+  int inline_threshold{-1};
+  bool print_passes{false};
+};
+
+//! Create the target machine of the host triple configured by \p options.
+std::unique_ptr<llvm::TargetMachine> CreateHostTargetMachine(const OptimizeOptions &options);
+
+//! The builder of the machines created by CreateHostTargetMachine, which creates a machine for each compilation of
+//! the concurrent jit.
+llvm::orc::JITTargetMachineBuilder HostTargetMachineBuilder(const OptimizeOptions &options);
 
 // llvm module optimizer
 class LLVMModuleOptimizer final {
  public:
-  explicit LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                               int opt_level,
-                               llvm::FastMathFlags fast_math_flags,
-                               bool print_passes = false);
+  explicit LLVMModuleOptimizer(llvm::TargetMachine *machine, const OptimizeOptions &options);
   void operator()(llvm::Module *m);
 
  private:
   llvm::TargetMachine *machine_;
-  int opt_level_{};
-  bool print_passes_{};
+  OptimizeOptions options_;
 };
 }  // namespace cinn::backends
@@ -0,0 +1,189 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/llvm/llvm_vector_math.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <limits>
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/intrinsic_ops.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/lang/builtin.h"
+
+DECLARE_string(cinn_x86_vector_math);
+
+namespace cinn {
+namespace codegen {
+
+namespace {
+
+Expr Const(const Type& type, double value) { return common::make_const(type, value); }
+
+// The coefficients are from the highest degree, and each step is lowered into a fma.
+Expr Horner(Expr x, const std::vector<double>& coeffs) {
+  Expr p = Const(x.type(), coeffs[0]);
+  for (size_t i = 1; i < coeffs.size(); ++i) {
+    p = p * x + Const(x.type(), coeffs[i]);
+  }
+  return p;
+}
+
+Expr BitCast(const Type& type, Expr x) {
+  return ir::intrinsics::BuiltinIntrin::Make("reinterpret_cast", {x}, -1, 1, type);
+}
+
+Expr IntBinary(const std::string& name, Expr x, int64_t y) {
+  return ir::intrinsics::BuiltinIntrin::Make(name, {x, Const(x.type(), y)}, -1, 2, x.type());
+}
+
+Expr IsNan(Expr x) { return ir::intrinsics::BuiltinIntrin::Make("isnan", {x}, -1, 1, Bool(x.type().lanes())); }
+
+Expr Clamp(Expr x, double lo, double hi) {
+  return ir::Min::Make(ir::Max::Make(x, Const(x.type(), lo)), Const(x.type(), hi));
+}
+
+// 2^n for the integer n in [-126, 127].
+Expr Pow2(Expr n, const Type& type) { return BitCast(type, (n + Const(n.type(), 127)) * Const(n.type(), 1 << 23)); }
+
+const std::vector<double> kExpCoeffs = {
+    1.9875691500E-4, 1.3981999507E-3, 8.3334519073E-3, 4.1665795894E-2, 1.6666665459E-1, 5.0000001201E-1};
+const std::vector<double> kLogCoeffs = {7.0376836292E-2,
+                                        -1.1514610310E-1,
+                                        1.1676998740E-1,
+                                        -1.2420140846E-1,
+                                        1.4249322787E-1,
+                                        -1.6668057665E-1,
+                                        2.0000714765E-1,
+                                        -2.4999993993E-1,
+                                        3.3333331174E-1};
+const std::vector<double> kTanhCoeffs = {
+    -5.70498872745E-3, 2.06390887954E-2, -5.37397155531E-2, 1.33314422036E-1, -3.33332819422E-1};
+const std::vector<double> kFastTanhNumerator   = {-2.76076847742355e-16,
+                                                2.00018790482477e-13,
+                                                -8.60467152213735e-11,
+                                                5.12229709037114e-08,
+                                                1.48572235717979e-05,
+                                                6.37261928875436e-04,
+                                                4.89352455891786e-03};
+const std::vector<double> kFastTanhDenominator = {
+    1.19825839466702e-06, 1.18534705686654e-04, 2.26843463243900e-03, 4.89352518554385e-03};
+const std::vector<double> kFastErfNumerator   = {-2.72614225801306e-10,
+                                               2.77068142495902e-08,
+                                               -2.10102402082508e-06,
+                                               -5.69250639462346e-05,
+                                               -7.34990630326855e-04,
+                                               -2.95459980854025e-03,
+                                               -1.60960333262415e-02};
+const std::vector<double> kFastErfDenominator = {-1.45660718464996e-05,
+                                                 -2.13374055278905e-04,
+                                                 -1.68282697438203e-03,
+                                                 -7.37332916720468e-03,
+                                                 -1.42647390514189e-02};
+
+// x * P(x^2) / Q(x^2) on x clamped to [-bound, bound].
+Expr OddRational(Expr x,
+                 double bound,
+                 const std::vector<double>& numerator,
+                 const std::vector<double>& denominator) {
+  Expr xc = Clamp(x, -bound, bound);
+  Expr x2 = xc * xc;
+  return xc * Horner(x2, numerator) / Horner(x2, denominator);
+}
+
+}  // namespace
+
+bool UseX86VectorMath(const std::string& func_name, const Type& type) {
+  if (!type.is_float(32) || FLAGS_cinn_x86_vector_math == "none") {
+    return false;
+  }
+  CHECK(FLAGS_cinn_x86_vector_math == "precise" || FLAGS_cinn_x86_vector_math == "fast")
+      << "FLAGS_cinn_x86_vector_math should be one of \"precise\", \"fast\" and \"none\", but got "
+      << FLAGS_cinn_x86_vector_math;
+  if (func_name == "exp" || func_name == "log" || func_name == "tanh") {
+    return true;
+  }
+  return func_name == "erf" && FLAGS_cinn_x86_vector_math == "fast";
+}
+
+Expr X86VectorExp(Expr x) {
+  Type type     = x.type();
+  Type int_type = Int(32, type.lanes());
+  Expr inf      = Const(type, std::numeric_limits<float>::infinity());
+  // exp(x) = 2^n * exp(r), where n = round(x / ln2) and r = x - n * ln2 in [-ln2 / 2, ln2 / 2], ln2 is split into
+  // 0.693359375 - 2.12194440e-4 so that n * 0.693359375 is exact.
+  Expr xc = Clamp(x, -104.0, 88.72283935546875);
+  Expr n  = lang::Floor(xc * Const(type, 1.44269504088896341) + Const(type, 0.5));
+  Expr r  = xc + n * Const(type, -0.693359375);
+  r       = r + n * Const(type, 2.12194440e-4);
+  Expr y  = Horner(r, kExpCoeffs) * (r * r) + r + Const(type, 1.0);
+  // n is in [-150, 128], so 2^n is split into two normal factors.
+  Expr ni = ir::Cast::Make(int_type, n);
+  Expr n1 = IntBinary("right_shift", ni, 1);
+  y       = y * Pow2(n1, type) * Pow2(ni - n1, type);
+  y       = ir::Select::Make(x > Const(type, 88.72283935546875), inf, y);
+  return ir::Select::Make(IsNan(x), x, y);
+}
+
+Expr X86VectorLog(Expr x) {
+  Type type     = x.type();
+  Type int_type = Int(32, type.lanes());
+  Expr zero     = Const(type, 0.0);
+  Expr inf      = Const(type, std::numeric_limits<float>::infinity());
+  // x = 2^e * m, where m is in [sqrt(2) / 2, sqrt(2)), the subnormals are scaled by 2^23 first.
+  Expr subnormal = x < Const(type, std::numeric_limits<float>::min());
+  Expr bits      = BitCast(int_type, ir::Select::Make(subnormal, x * Const(type, 8388608.0), x));
+  Expr bias      = ir::Select::Make(subnormal, Const(int_type, 126 + 23), Const(int_type, 126));
+  Expr e         = ir::Cast::Make(type, IntBinary("right_shift", bits, 23) - bias);
+  Expr m         = BitCast(type, IntBinary("bitwise_or", IntBinary("bitwise_and", bits, 0x007fffff), 0x3f000000));
+  Expr small     = m < Const(type, 0.707106781186547524);
+  e              = ir::Select::Make(small, e - Const(type, 1.0), e);
+  m              = ir::Select::Make(small, m + m, m) + Const(type, -1.0);
+  // log(1 + m) = m - m^2 / 2 + m^3 * P(m), and e * ln2 is added in two parts as in exp.
+  Expr z = m * m;
+  Expr y = Horner(m, kLogCoeffs) * m * z;
+  y      = y + e * Const(type, -2.12194440e-4);
+  y      = y + z * Const(type, -0.5);
+  y      = m + y;
+  y      = y + e * Const(type, 0.693359375);
+  y      = ir::Select::Make(ir::EQ::Make(x, inf), x, y);
+  y      = ir::Select::Make(ir::EQ::Make(x, zero), -inf, y);
+  return ir::Select::Make(x >= zero, y, Const(type, std::numeric_limits<float>::quiet_NaN()));
+}
+
+Expr X86VectorTanh(Expr x) {
+  Type type = x.type();
+  if (FLAGS_cinn_x86_vector_math == "fast") {
+    Expr y = OddRational(x, 7.90531110763549805, kFastTanhNumerator, kFastTanhDenominator);
+    y      = ir::Select::Make(lang::Abs(x) < Const(type, 0.0004), x, y);
+    return ir::Select::Make(IsNan(x), x, y);
+  }
+  Expr abs_x = lang::Abs(x);
+  Expr z     = x * x;
+  Expr small = Horner(z, kTanhCoeffs) * z * x + x;
+  Expr large = Const(type, 1.0) - Const(type, 2.0) / (X86VectorExp(abs_x * Const(type, 2.0)) + Const(type, 1.0));
+  large      = ir::Select::Make(x < Const(type, 0.0), -large, large);
+  return ir::Select::Make(abs_x < Const(type, 0.625), small, large);
+}
+
+Expr X86VectorErf(Expr x) {
+  Expr y = OddRational(x, 4.0, kFastErfNumerator, kFastErfDenominator);
+  return ir::Select::Make(IsNan(x), x, y);
+}
+
+}  // namespace codegen
+}  // namespace cinn
@@ -0,0 +1,48 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "cinn/common/type.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace codegen {
+
+/**
+ * The inline vector math of the x86 backend. LLVM scalarizes the vector calls of libm into a call per lane, so the
+ * fp32 exp, log, tanh and erf are expanded into the polynomials of the lanes instead, which are vectorized into
+ * AVX2/AVX-512 inside the fused loops, and their Horner steps are lowered into fma by LowerIntrin. The accuracy is
+ * selected by FLAGS_cinn_x86_vector_math:
+ *  - "precise": exp and log within 1 ULP, tanh within 1.5 ULP, and erf keeps the erff of libm.
+ *  - "fast": tanh and erf are expanded into the rational approximations of Eigen, within 6 ULP.
+ *  - "none": all of them are computed by libm.
+ */
+bool UseX86VectorMath(const std::string& func_name, const Type& type);
+
+//! The Cephes expf, the result is scaled by 2^n in two steps, so the subnormal results are kept.
+Expr X86VectorExp(Expr x);
+
+//! The Cephes logf.
+Expr X86VectorLog(Expr x);
+
+//! The Cephes tanhf in "precise", which takes 1 - 2 / (exp(2|x|) + 1) for |x| >= 0.625.
+Expr X86VectorTanh(Expr x);
+
+Expr X86VectorErf(Expr x);
+
+}  // namespace codegen
+}  // namespace cinn
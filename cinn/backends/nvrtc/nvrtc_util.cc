@@ -17,30 +17,135 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <nvrtc.h>
+#include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
+#include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/cuda_util.h"
+#include "cinn/backends/kernel_disk_cache.h"
 #include "cinn/backends/nvrtc/header_generator.h"
 #include "cinn/common/common.h"
 #include "cinn/runtime/flags.h"
 #include "cinn/utils/string.h"
 
 DECLARE_string(cinn_nvcc_cmd_path);
+DECLARE_string(cinn_nvgpu_math_precision);
 DECLARE_bool(nvrtc_compile_to_cubin);
+DECLARE_bool(cinn_nvrtc_use_pch);
+DECLARE_string(cinn_nvrtc_cache_dir);
+DECLARE_int64(cinn_nvrtc_cache_max_bytes);
+DECLARE_int32(cinn_nvcc_max_jobs);
+DECLARE_string(cinn_nvcc_ptxas_options);
 
 namespace cinn {
 namespace backends {
 namespace nvrtc {
 
+namespace {
+
+// The disk cache configured by FLAGS_cinn_nvrtc_cache_dir, nullptr if the flag is empty.
+KernelDiskCache* NvrtcDiskCache() {
+  if (FLAGS_cinn_nvrtc_cache_dir.empty()) return nullptr;
+  static KernelDiskCache cache(FLAGS_cinn_nvrtc_cache_dir, FLAGS_cinn_nvrtc_cache_max_bytes);
+  return &cache;
+}
+
+// The contents of the jit-safe headers and the CINN runtime headers, which take part in the key of the disk cache.
+std::vector<std::string> HeaderContents(const HeaderGeneratorBase& header_gen,
+                                        const std::vector<std::string>& include_dirs) {
+  std::vector<std::string> contents;
+  for (size_t i = 0; i < header_gen.size(); ++i) {
+    contents.emplace_back(header_gen.include_names()[i]);
+    contents.emplace_back(header_gen.headers()[i]);
+  }
+  for (auto& dir : include_dirs) {
+    DIR* dp = opendir(dir.c_str());
+    if (dp == nullptr) continue;
+    std::vector<std::string> names;
+    while (struct dirent* ent = readdir(dp)) {
+      if (ent->d_type == DT_REG) names.emplace_back(ent->d_name);
+    }
+    closedir(dp);
+    std::sort(names.begin(), names.end());
+    for (auto& name : names) {
+      std::ifstream ifs(dir + "/" + name, std::ios::in | std::ios::binary);
+      std::stringstream ss;
+      ss << ifs.rdbuf();
+      contents.emplace_back(name);
+      contents.emplace_back(ss.str());
+    }
+  }
+  return contents;
+}
+
+// Limit the nvcc processes running at the same time, the compilations of the other threads wait for a free slot.
+class NvccJobSlot {
+ public:
+  NvccJobSlot() {
+    std::unique_lock<std::mutex> lock(mutex());
+    cond().wait(lock, [] { return running() < MaxJobs(); });
+    ++running();
+  }
+
+  ~NvccJobSlot() {
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      --running();
+    }
+    cond().notify_one();
+  }
+
+ private:
+  static int MaxJobs() {
+    static const int max_jobs = FLAGS_cinn_nvcc_max_jobs > 0
+                                    ? FLAGS_cinn_nvcc_max_jobs
+                                    : std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    return max_jobs;
+  }
+
+  static std::mutex& mutex() {
+    static std::mutex mtx;
+    return mtx;
+  }
+
+  static std::condition_variable& cond() {
+    static std::condition_variable cv;
+    return cv;
+  }
+
+  static int& running() {
+    static int num_running = 0;
+    return num_running;
+  }
+};
+
+}  // namespace
+
 std::string Compiler::operator()(const std::string& code, bool include_headers) {
   if (runtime::CanUseNvccCompiler()) {
+    compile_to_cubin_ = true;
     return CompileWithNvcc(code);
   }
+#ifdef CINN_WITH_NVJITLINK
+  // the generated sources declare the runtime functions they call instead of including the runtime source
+  if (include_headers &&
+      code.find(std::string("#define ") + CodeGenCUDA_Dev::kLinkRuntimeLibraryMacro) != std::string::npos) {
+    compile_to_cubin_ = true;
+    return LinkRuntimeLibrary(code);
+  }
+#endif
   return CompileCudaSource(code, include_headers);
 }
 
@@ -82,6 +187,10 @@ std::vector<std::string> Compiler::FindCUDAIncludePaths() {
 std::vector<std::string> Compiler::FindCINNRuntimeIncludePaths() { return {Context::Global().runtime_include_dir()}; }
 
 std::string Compiler::CompileCudaSource(const std::string& code, bool include_headers) {
+  return CompileCudaSource(code, include_headers, compile_to_cubin_ ? OutputKind::kCUBIN : OutputKind::kPTX);
+}
+
+std::string Compiler::CompileCudaSource(const std::string& code, bool include_headers, OutputKind output_kind) {
   const auto& header_gen = JitSafeHeaderGenerator::GetInstance();
   std::vector<std::string> compile_options;
   std::vector<const char*> param_cstrings{};
@@ -97,13 +206,21 @@ std::string Compiler::CompileCudaSource(const std::string& code, bool include_he
     LOG(WARNING) << "cannot detect compute capability from your device, "
                  << "fall back to compute_30.";
   }
-  if (compile_to_cubin_) {
+  if (output_kind == OutputKind::kCUBIN) {
     compile_options.push_back("-arch=sm_" + cc);
   } else {
     compile_options.push_back("-arch=compute_" + cc);
   }
+  if (output_kind == OutputKind::kLTOIR) {
+    // the relocatable device code in LTO-IR, whose calls across the modules are inlined by nvJitLink
+    compile_options.push_back("-rdc=true");
+    compile_options.push_back("-dlto");
+  }
   compile_options.push_back("-std=c++14");
   compile_options.push_back("-default-device");
+  if (FLAGS_cinn_nvgpu_math_precision == "fast") {
+    compile_options.push_back("--use_fast_math");
+  }
 
   if (include_headers) {  // prepare include headers
     auto cuda_headers = FindCUDAIncludePaths();
@@ -116,12 +233,40 @@ std::string Compiler::CompileCudaSource(const std::string& code, bool include_he
       include_paths.push_back("--include-path=" + header);
     }
     compile_options.insert(std::end(compile_options), include_paths.begin(), include_paths.end());
+    if (FLAGS_cinn_nvrtc_use_pch) {
+#if CUDA_VERSION >= 12010
+      // the leading headers of the generated source are the same for every module, let NVRTC precompile them once
+      compile_options.push_back("-pch");
+#else
+      LOG_FIRST_N(WARNING, 1) << "FLAGS_cinn_nvrtc_use_pch is ignored, the precompiled header of NVRTC requires "
+                                 "CUDA 12.1 or later, but the current version is "
+                              << CUDA_VERSION;
+#endif
+    }
   }
 
   for (const auto& option : compile_options) {
     param_cstrings.push_back(option.c_str());
   }
   VLOG(3) << "compile options: " << utils::Join(compile_options, " ");
+
+  auto* disk_cache = NvrtcDiskCache();
+  std::string cache_key;
+  if (disk_cache) {
+    // the arch, the include paths and whether to compile into cubin are all in the compile options
+    static const std::vector<std::string> header_contents =
+        HeaderContents(header_gen, Context::Global().runtime_include_dir());
+    std::vector<std::string> key_parts = {code, utils::Join(compile_options, " "), std::to_string(CUDA_VERSION)};
+    if (include_headers) {
+      key_parts.insert(key_parts.end(), header_contents.begin(), header_contents.end());
+    }
+    cache_key = KernelDiskCache::HashKey(key_parts);
+    std::string data;
+    if (disk_cache->Lookup(cache_key, &data)) {
+      return data;
+    }
+  }
+
   NVRTC_CALL(nvrtcCreateProgram(
       &prog, code.c_str(), nullptr, header_gen.size(), header_gen.headers().data(), header_gen.include_names().data()));
   nvrtcResult compile_res = nvrtcCompileProgram(prog, param_cstrings.size(), param_cstrings.data());
@@ -137,10 +282,18 @@ std::string Compiler::CompileCudaSource(const std::string& code, bool include_he
 
   size_t size;
   std::string data;
-  if (compile_to_cubin_) {
+  if (output_kind == OutputKind::kCUBIN) {
     NVRTC_CALL(nvrtcGetCUBINSize(prog, &size));
     data.resize(size);
     NVRTC_CALL(nvrtcGetCUBIN(prog, &data[0]));
+  } else if (output_kind == OutputKind::kLTOIR) {
+#ifdef CINN_WITH_NVJITLINK
+    NVRTC_CALL(nvrtcGetLTOIRSize(prog, &size));
+    data.resize(size);
+    NVRTC_CALL(nvrtcGetLTOIR(prog, &data[0]));
+#else
+    LOG(FATAL) << "Getting LTO-IR from NVRTC requires CUDA 12.0 or later with nvJitLink";
+#endif
   } else {
     NVRTC_CALL(nvrtcGetPTXSize(prog, &size));
     data.resize(size);
@@ -148,18 +301,110 @@ std::string Compiler::CompileCudaSource(const std::string& code, bool include_he
   }
 
   NVRTC_CALL(nvrtcDestroyProgram(&prog));
+  if (disk_cache) {
+    disk_cache->Insert(cache_key, data);
+  }
+  return data;
+}
+
+#ifdef CINN_WITH_NVJITLINK
+const std::string& Compiler::GetRuntimeLibrary() {
+  static std::mutex mtx;
+  // keyed by the device arch, as the compiler may be used on the devices of different archs
+  static std::unordered_map<std::string, std::string> libraries;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto arch = GetDeviceArch();
+  auto it   = libraries.find(arch);
+  if (it == libraries.end()) {
+    // the runtime functions are defined with the external linkage, so that the kernels can be linked with them
+    std::string source =
+        CodeGenCUDA_Dev::GetSourcePrelude() + "#define CINN_NVGPU_INLINE\n#include \"cinn_cuda_runtime_source.cuh\"\n";
+    it = libraries.emplace(arch, CompileCudaSource(source, true, OutputKind::kLTOIR)).first;
+    VLOG(3) << "Compile the CUDA runtime device library of " << arch << " into " << it->second.size()
+            << " bytes of LTO-IR";
+  }
+  return it->second;
+}
+
+std::string Compiler::LinkRuntimeLibrary(const std::string& code) {
+  std::string arch_option = "-arch=" + GetDeviceArch();
+
+  auto* disk_cache = NvrtcDiskCache();
+  std::string cache_key;
+  if (disk_cache) {
+    static const std::vector<std::string> header_contents =
+        HeaderContents(JitSafeHeaderGenerator::GetInstance(), Context::Global().runtime_include_dir());
+    std::vector<std::string> key_parts = {
+        code, "nvJitLink " + arch_option, FLAGS_cinn_nvgpu_math_precision, std::to_string(CUDA_VERSION)};
+    key_parts.insert(key_parts.end(), header_contents.begin(), header_contents.end());
+    cache_key = KernelDiskCache::HashKey(key_parts);
+    std::string data;
+    if (disk_cache->Lookup(cache_key, &data)) {
+      return data;
+    }
+  }
+
+  // only the generated code is parsed, the runtime functions called are linked and inlined from the library
+  auto kernel_ir         = CompileCudaSource(code, true, OutputKind::kLTOIR);
+  const auto& library_ir = GetRuntimeLibrary();
+
+  std::vector<const char*> link_options = {arch_option.c_str(), "-lto", "-O3"};
+  nvJitLinkHandle handle;
+  NVJITLINK_CALL(nvJitLinkCreate(&handle, link_options.size(), link_options.data()));
+  NVJITLINK_CALL(nvJitLinkAddData(
+      handle, NVJITLINK_INPUT_LTOIR, library_ir.data(), library_ir.size(), "cinn_cuda_runtime_source"));
+  NVJITLINK_CALL(nvJitLinkAddData(handle, NVJITLINK_INPUT_LTOIR, kernel_ir.data(), kernel_ir.size(), "kernels"));
+  nvJitLinkResult link_res = nvJitLinkComplete(handle);
+
+  {  // get log
+    size_t log_size;
+    NVJITLINK_CALL(nvJitLinkGetErrorLogSize(handle, &log_size));
+    std::string log(log_size, '\0');
+    if (log_size > 0) {
+      NVJITLINK_CALL(nvJitLinkGetErrorLog(handle, &log[0]));
+    }
+    CHECK_EQ(link_res, NVJITLINK_SUCCESS) << log;
+  }
+
+  size_t size;
+  NVJITLINK_CALL(nvJitLinkGetLinkedCubinSize(handle, &size));
+  std::string data(size, '\0');
+  NVJITLINK_CALL(nvJitLinkGetLinkedCubin(handle, &data[0]));
+  NVJITLINK_CALL(nvJitLinkDestroy(&handle));
+
+  if (disk_cache) {
+    disk_cache->Insert(cache_key, data);
+  }
   return data;
 }
+#endif
 
 std::string Compiler::CompileWithNvcc(const std::string& cuda_c) {
+  std::string options = GetNvccOptions();
+
+  auto* disk_cache = NvrtcDiskCache();
+  std::string cache_key;
+  if (disk_cache) {
+    static const std::vector<std::string> header_contents =
+        HeaderContents(JitSafeHeaderGenerator::GetInstance(), Context::Global().runtime_include_dir());
+    std::vector<std::string> key_parts = {cuda_c, "nvcc " + options, std::to_string(CUDA_VERSION)};
+    key_parts.insert(key_parts.end(), header_contents.begin(), header_contents.end());
+    cache_key = KernelDiskCache::HashKey(key_parts);
+    std::string data;
+    if (disk_cache->Lookup(cache_key, &data)) {
+      return data;
+    }
+  }
+
   // read dir source
   std::string dir = "./source";
   if (access(dir.c_str(), 0) == -1) {
-    CHECK(mkdir(dir.c_str(), 7) != -1) << "Fail to mkdir " << dir;
+    CHECK(mkdir(dir.c_str(), 0755) != -1 || errno == EEXIST) << "Fail to mkdir " << dir;
   }
-
-  // get unqiue prefix name
-  prefix_name_ = dir + "/" + common::UniqName("rtc_tmp");
+  // the files of a thread are overwritten by its next compilation instead of piling up in the directory
+  static thread_local std::string thread_prefix_name =
+      dir + "/" + common::UniqName("rtc_tmp_" + std::to_string(getpid()) + "_");
+  prefix_name_ = thread_prefix_name;
 
   auto cuda_c_file = prefix_name_ + ".cu";
   std::ofstream ofs(cuda_c_file, std::ios::out);
@@ -167,15 +412,25 @@ std::string Compiler::CompileWithNvcc(const std::string& cuda_c) {
   ofs << cuda_c;
   ofs.close();
 
-  CompileToPtx();
-  CompileToCubin();
+  // compile the source into cubin by one nvcc process
+  std::string command = std::string("export PATH=") + FLAGS_cinn_nvcc_cmd_path + ":$PATH && nvcc " + options;
+  command += " -o " + prefix_name_ + ".cubin";
+  command += " " + cuda_c_file;
+  VLOG(2) << "Nvcc Compile Options : " << command;
+  {
+    NvccJobSlot slot;
+    CHECK(system(command.c_str()) == 0) << command;
+  }
 
-  return prefix_name_ + ".cubin";
+  auto data = ReadFile(prefix_name_ + ".cubin", std::ios::in | std::ios::binary);
+  CHECK(!data.empty()) << "Nvcc compiles an empty cubin from " << cuda_c_file;
+  if (disk_cache) {
+    disk_cache->Insert(cache_key, data);
+  }
+  return data;
 }
 
-// std::string Compiler::GetPtx() { return ReadFile(prefix_name_ + ".ptx", std::ios::in); }
-
-void Compiler::CompileToPtx() {
+std::string Compiler::GetNvccOptions() {
   auto include_dir            = common::Context::Global().runtime_include_dir();
   std::string include_dir_str = "";
   for (auto dir : include_dir) {
@@ -186,25 +441,15 @@ void Compiler::CompileToPtx() {
     }
   }
 
-  std::string options = std::string("export PATH=") + FLAGS_cinn_nvcc_cmd_path +
-                        std::string(":$PATH && nvcc -std=c++14 --ptx -O3 -I ") + include_dir_str;
+  std::string options = "-std=c++14 --cubin -O3 -I " + include_dir_str;
   options += " -arch=" + GetDeviceArch();
-  options += " -o " + prefix_name_ + ".ptx";
-  options += " " + prefix_name_ + ".cu";
-
-  VLOG(2) << "Nvcc Compile Options : " << options;
-  CHECK(system(options.c_str()) == 0) << options;
-}
-
-void Compiler::CompileToCubin() {
-  std::string options =
-      std::string("export PATH=") + FLAGS_cinn_nvcc_cmd_path + std::string(":$PATH && nvcc --cubin -O3");
-  options += " -arch=" + GetDeviceArch();
-  options += " -o " + prefix_name_ + ".cubin";
-  options += " " + prefix_name_ + ".ptx";
-
-  VLOG(2) << "Nvcc Compile Options : " << options;
-  CHECK(system(options.c_str()) == 0) << options;
+  if (FLAGS_cinn_nvgpu_math_precision == "fast") {
+    options += " --use_fast_math";
+  }
+  if (!FLAGS_cinn_nvcc_ptxas_options.empty()) {
+    options += " -Xptxas " + FLAGS_cinn_nvcc_ptxas_options;
+  }
+  return options;
 }
 
 std::string Compiler::GetDeviceArch() {
@@ -223,7 +468,7 @@ std::string Compiler::ReadFile(const std::string& file_name, std::ios_base::open
   // open cubin file
   std::ifstream ifs(file_name, mode);
   CHECK(ifs.is_open()) << "Fail to open file " << file_name;
-  ifs.seekg(std::ios::end);
+  ifs.seekg(0, std::ios::end);
   auto len = ifs.tellg();
   ifs.seekg(0);
 
@@ -66,18 +66,34 @@ class Compiler {
    */
   std::string CompileCudaSource(const std::string& code, bool include_headers);
 
+  //! The outputs of NVRTC.
+  enum class OutputKind { kPTX, kCUBIN, kLTOIR };
+
+  std::string CompileCudaSource(const std::string& code, bool include_headers, OutputKind output_kind);
+
+#ifdef CINN_WITH_NVJITLINK
+  /**
+   * Get the LTO-IR of the CUDA runtime device library for the current device, which is compiled once per arch.
+   */
+  const std::string& GetRuntimeLibrary();
+
+  /**
+   * Compile the CUDA source code declaring the runtime functions it calls, and link it with the CUDA runtime device
+   * library into CUBIN.
+   */
+  std::string LinkRuntimeLibrary(const std::string& code);
+#endif
+
   /**
    * whether to compile the source code into cubin, only works with cuda version > 11.1
    */
   bool compile_to_cubin_{false};
 
-  // compile with nvcc
+  // compile with nvcc, and get CUBIN
   std::string CompileWithNvcc(const std::string&);
 
-  // compile to ptx
-  void CompileToPtx();
-  // compile to cubin
-  void CompileToCubin();
+  // the options of nvcc compiling the source into cubin
+  std::string GetNvccOptions();
   std::string GetDeviceArch();
 
   std::string ReadFile(const std::string&, std::ios_base::openmode);
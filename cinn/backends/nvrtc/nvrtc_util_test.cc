@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include "cinn/backends/codegen_cuda_dev.h"
+
 namespace cinn {
 namespace backends {
 namespace nvrtc {
@@ -85,6 +87,31 @@ void cast_fp32_to_bf16_cuda_kernel(const float* input, const int num, bfloat16*
   LOG(INFO) << "ptx:\n" << ptx;
 }
 
+#ifdef CINN_WITH_NVJITLINK
+TEST(Compiler, link_runtime_library) {
+  Compiler compiler;
+
+  std::string source_code = CodeGenCUDA_Dev::GetSourcePrelude() + "#define " +
+                            CodeGenCUDA_Dev::kLinkRuntimeLibraryMacro + R"(
+extern "C" {
+
+__device__ float cinn_nvgpu_exp_fp32(float);
+__device__ float cinn_warp_reduce_sum_fp32(const float*, int, int);
+
+__global__
+void exp_warp_sum_kernel(const float* input, float* out) {
+  out[threadIdx.x] = cinn_nvgpu_exp_fp32(input[threadIdx.x]) + cinn_warp_reduce_sum_fp32(input, 0, 32);
+}
+
+}
+)";
+
+  auto cubin = compiler(source_code);
+  ASSERT_FALSE(cubin.empty());
+  ASSERT_TRUE(compiler.compile_to_cubin());
+}
+#endif
+
 }  // namespace nvrtc
 }  // namespace backends
 }  // namespace cinn
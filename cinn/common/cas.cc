@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -28,13 +29,207 @@
 #include "cinn/ir/ir_visitor.h"
 #include "cinn/optim/cast_simplify.h"
 #include "cinn/optim/ir_copy.h"
+#include "cinn/utils/functional.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
 namespace common {
 using namespace ir;  // NOLINT
 
+namespace {
+
+template <typename T>
+void Combine(size_t* hash, const T& value) {
+  *hash = utils::HashCombine(*hash, value);
+}
+
+//! Hash the arithmetic expression \p e of constants and variables, and collect the names of the variables in it.
+//! @return false if \p e has other nodes, which are not memoized.
+bool HashArithExpr(const Expr& e, size_t* hash, std::vector<std::string>* vars) {
+  if (!e.defined()) {
+    Combine(hash, 0);
+    return true;
+  }
+  Combine(hash, static_cast<int>(e->node_type()));
+  Combine(hash, e.type().to_string());
+  switch (e->node_type()) {
+    case IrNodeTy::IntImm:
+      Combine(hash, e.As<IntImm>()->value);
+      return true;
+    case IrNodeTy::UIntImm:
+      Combine(hash, e.As<UIntImm>()->value);
+      return true;
+    case IrNodeTy::FloatImm:
+      Combine(hash, e.As<FloatImm>()->value);
+      return true;
+    case IrNodeTy::_Var_: {
+      auto* var = e.As<_Var_>();
+      Combine(hash, var->name);
+      Combine(hash, var->is_reduce_axis);
+      vars->push_back(var->name);
+      return HashArithExpr(var->lower_bound, hash, vars) && HashArithExpr(var->upper_bound, hash, vars);
+    }
+#define __(op__) case IrNodeTy::op__:
+      NODETY_OP_FOR_EACH(__)
+#undef __
+    case IrNodeTy::Cast:
+    case IrNodeTy::Select:
+      for (auto* field : e->expr_fields()) {
+        if (!HashArithExpr(*field, hash, vars)) return false;
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Compare the arithmetic expressions hashed by HashArithExpr, including the types.
+bool ArithExprEqual(const Expr& a, const Expr& b) {
+  if (a.get() == b.get()) return true;
+  if (!a.defined() || !b.defined()) return false;
+  if (a->node_type() != b->node_type() || a.type() != b.type()) return false;
+  switch (a->node_type()) {
+    case IrNodeTy::IntImm:
+      return a.As<IntImm>()->value == b.As<IntImm>()->value;
+    case IrNodeTy::UIntImm:
+      return a.As<UIntImm>()->value == b.As<UIntImm>()->value;
+    case IrNodeTy::FloatImm:
+      return a.As<FloatImm>()->value == b.As<FloatImm>()->value;
+    case IrNodeTy::_Var_: {
+      auto* x = a.As<_Var_>();
+      auto* y = b.As<_Var_>();
+      return x->name == y->name && x->is_reduce_axis == y->is_reduce_axis &&
+             ArithExprEqual(x->lower_bound, y->lower_bound) && ArithExprEqual(x->upper_bound, y->upper_bound);
+    }
+    default: {
+      auto fields_a = a->expr_fields();
+      auto fields_b = b->expr_fields();
+      if (fields_a.size() != fields_b.size()) return false;
+      for (int i = 0; i < fields_a.size(); ++i) {
+        if (!ArithExprEqual(*fields_a[i], *fields_b[i])) return false;
+      }
+      return true;
+    }
+  }
+}
+
+bool IntervalEqual(const CasInterval& a, const CasInterval& b) {
+  if (a.e_l.defined() || b.e_l.defined()) return ArithExprEqual(a.e_l, b.e_l) && ArithExprEqual(a.e_r, b.e_r);
+  return a.l == b.l && a.r == b.r;
+}
+
+thread_local AutoSimplifyCacheScope::Cache* current_simplify_cache = nullptr;
+
+}  // namespace
+
+struct AutoSimplifyCacheScope::Cache {
+  //! The expression and the intervals of the variables it depends on, sorted by the names of the variables.
+  struct Entry {
+    Expr expr;
+    std::vector<std::pair<std::string, CasInterval>> intervals;
+    Expr result;
+  };
+
+  explicit Cache(size_t capacity) : capacity(capacity) {}
+
+  //! Make the key of \p u under \p var_intervals, return false if it is not memoized.
+  bool MakeKey(const Expr& u, const cas_intervals_t& var_intervals, size_t* hash, Entry* entry) {
+    std::vector<std::string> vars;
+    if (!HashArithExpr(u, hash, &vars)) return false;
+    // the intervals may refer to the other variables
+    std::set<std::string> visited;
+    while (!vars.empty()) {
+      std::string var = vars.back();
+      vars.pop_back();
+      if (!visited.insert(var).second) continue;
+      auto it = var_intervals.find(var);
+      if (it == var_intervals.end()) continue;
+      entry->intervals.emplace_back(var, it->second);
+      if (it->second.e_l.defined() && (!HashArithExpr(it->second.e_l, hash, &vars) ||
+                                       !HashArithExpr(it->second.e_r, hash, &vars))) {
+        return false;
+      }
+    }
+    std::sort(entry->intervals.begin(), entry->intervals.end(), [](const auto& x, const auto& y) {
+      return x.first < y.first;
+    });
+    for (auto& item : entry->intervals) {
+      Combine(hash, item.first);
+      Combine(hash, item.second.l);
+      Combine(hash, item.second.r);
+    }
+    entry->expr = u;
+    return true;
+  }
+
+  const Entry* Find(size_t hash, const Entry& key) const {
+    auto it = table.find(hash);
+    if (it == table.end()) return nullptr;
+    for (auto& entry : it->second) {
+      if (!ArithExprEqual(entry.expr, key.expr) || entry.intervals.size() != key.intervals.size()) continue;
+      bool equal = true;
+      for (int i = 0; i < entry.intervals.size() && equal; ++i) {
+        equal = entry.intervals[i].first == key.intervals[i].first &&
+                IntervalEqual(entry.intervals[i].second, key.intervals[i].second);
+      }
+      if (equal) return &entry;
+    }
+    return nullptr;
+  }
+
+  void Insert(size_t hash, Entry&& entry) {
+    if (size >= capacity) {
+      VLOG(4) << "Clear the AutoSimplify cache of " << size << " entries";
+      table.clear();
+      size = 0;
+    }
+    table[hash].push_back(std::move(entry));
+    ++size;
+  }
+
+  size_t capacity;
+  size_t size{0};
+  size_t hits{0};
+  size_t misses{0};
+  absl::flat_hash_map<size_t, std::vector<Entry>> table;
+};
+
+AutoSimplifyCacheScope::AutoSimplifyCacheScope(size_t capacity)
+    : cache_(std::make_unique<Cache>(capacity)), prev_(current_simplify_cache) {
+  current_simplify_cache = cache_.get();
+}
+
+AutoSimplifyCacheScope::~AutoSimplifyCacheScope() {
+  VLOG(4) << "AutoSimplify cache hits " << cache_->hits << ", misses " << cache_->misses;
+  current_simplify_cache = prev_;
+}
+
+size_t AutoSimplifyCacheScope::num_hits() const { return cache_->hits; }
+size_t AutoSimplifyCacheScope::num_misses() const { return cache_->misses; }
+
+Expr AutoSimplifyImpl(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals);
+
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
+  auto* cache = current_simplify_cache;
+  size_t hash = 0;
+  AutoSimplifyCacheScope::Cache::Entry key;
+  if (!cache || !cache->MakeKey(u, var_intervals, &hash, &key)) {
+    return AutoSimplifyImpl(u, var_intervals);
+  }
+  // the keys and results are copied, for the callers may modify the expressions in place
+  if (auto* entry = cache->Find(hash, key)) {
+    ++cache->hits;
+    return optim::IRCopy(entry->result);
+  }
+  ++cache->misses;
+  Expr res   = AutoSimplifyImpl(u, var_intervals);
+  key.expr   = optim::IRCopy(u);
+  key.result = optim::IRCopy(res);
+  cache->Insert(hash, std::move(key));
+  return res;
+}
+
+Expr AutoSimplifyImpl(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
   VLOG(7) << "Begin AutoSimplify: " << u;
   u = detail::ConvertCinnToCAS(u);
   absl::flat_hash_map<std::string, CasInterval> s_var_intervals;
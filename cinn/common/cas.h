@@ -16,6 +16,7 @@
 #include <absl/container/flat_hash_map.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -84,6 +85,31 @@ using cas_intervals_t = absl::flat_hash_map<std::string, CasInterval>;
 
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
+/**
+ * Memoize the results of AutoSimplify on the current thread in the lifetime of this scope, such as a lowering session.
+ *
+ * The expressions are keyed by their structure and the intervals of the variables in them, and only the arithmetic
+ * expressions of the constants and variables are memoized. The table is cleared when it grows over \p capacity.
+ */
+class AutoSimplifyCacheScope {
+ public:
+  explicit AutoSimplifyCacheScope(size_t capacity = 1 << 16);
+  ~AutoSimplifyCacheScope();
+
+  AutoSimplifyCacheScope(const AutoSimplifyCacheScope&) = delete;
+  AutoSimplifyCacheScope& operator=(const AutoSimplifyCacheScope&) = delete;
+
+  //! The number of the AutoSimplify calls hit and missed in this scope.
+  size_t num_hits() const;
+  size_t num_misses() const;
+
+  struct Cache;
+
+ private:
+  std::unique_ptr<Cache> cache_;
+  Cache* prev_{};
+};
+
 //! Simplify a CAS expression.
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
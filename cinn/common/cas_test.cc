@@ -428,5 +428,28 @@ TEST(CAS, SimplifyFracOp) {
   EXPECT_EQ(GetStreamCnt(AutoSimplify(frac_f)), "2.00000000f");
 }
 
+TEST(CAS, AutoSimplifyCache) {
+  Var x = ir::_Var_::Make("x", Int(32));
+  Var y = ir::_Var_::Make("y", Int(32));
+  auto make = [&]() { return Mod::Make(Expr(x) * 8 + Expr(y) * 1024, Expr(64)); };
+
+  AutoSimplifyCacheScope scope;
+  cas_intervals_t intervals;
+  intervals.emplace("x", CasInterval{0, 7});
+  auto u1 = AutoSimplify(make(), intervals);
+  auto u2 = AutoSimplify(make(), intervals);
+  EXPECT_EQ(scope.num_hits(), 1UL);
+  EXPECT_EQ(GetStreamCnt(u1), GetStreamCnt(u2));
+  // the result is a copy, which is safe to modify in place
+  EXPECT_FALSE(u1.same_as(u2));
+
+  // the intervals are part of the key
+  intervals.clear();
+  intervals.emplace("x", CasInterval{0, 15});
+  AutoSimplify(make(), intervals);
+  EXPECT_EQ(scope.num_hits(), 1UL);
+  EXPECT_EQ(scope.num_misses(), 2UL);
+}
+
 }  // namespace common
 }  // namespace cinn
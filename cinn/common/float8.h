@@ -0,0 +1,103 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cinn {
+namespace common {
+
+namespace float8_detail {
+
+// The fp8 formats of the Hopper GPUs, see "FP8 Formats for Deep Learning":
+//  - E4M3 has no infinity, the only NaN is S.1111.111, so its max finite value is S.1111.110 = 448.
+//  - E5M2 follows IEEE-754, the max finite value is S.11110.11 = 57344.
+// The float is converted by rounding to the nearest even and saturated to the max finite value, the same as the
+// __NV_SATFINITE conversions of cuda_fp8.h.
+template <int kExpBits, int kManBits, bool kIEEE>
+struct Float8Format {
+  static constexpr int kBias       = (1 << (kExpBits - 1)) - 1;
+  static constexpr uint8_t kNaN    = 0x7F;
+  static constexpr uint8_t kMaxRaw = kIEEE ? ((((1 << kExpBits) - 2) << kManBits) | ((1 << kManBits) - 1)) : 0x7E;
+
+  static float ToFloat(uint8_t raw) {
+    float sign = (raw & 0x80) ? -1.0f : 1.0f;
+    int exp    = (raw >> kManBits) & ((1 << kExpBits) - 1);
+    int man    = raw & ((1 << kManBits) - 1);
+    if (kIEEE && exp == (1 << kExpBits) - 1) {
+      return man == 0 ? sign * std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+    }
+    if (!kIEEE && (raw & 0x7F) == kNaN) {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (exp == 0) {
+      return sign * std::ldexp(static_cast<float>(man), 1 - kBias - kManBits);
+    }
+    return sign * std::ldexp(static_cast<float>(man + (1 << kManBits)), exp - kBias - kManBits);
+  }
+
+  static uint8_t FromFloat(float value) {
+    uint8_t sign = std::signbit(value) ? 0x80 : 0x00;
+    if (std::isnan(value)) {
+      return sign | kNaN;
+    }
+    float abs_value = std::fabs(value);
+    if (abs_value >= ToFloat(kMaxRaw)) {
+      return sign | kMaxRaw;
+    }
+    int exp = 0;
+    std::frexp(abs_value, &exp);
+    // the subnormals share the exponent of the min normal value
+    exp          = std::max(exp - 1, 1 - kBias);
+    int quantum  = static_cast<int>(std::nearbyint(std::ldexp(abs_value, kManBits - exp)));
+    int raw_bits = ((exp + kBias - 1) << kManBits) + quantum;
+    // a subnormal rounded up to 1 << kManBits becomes the min normal value by the carry
+    if (quantum < (1 << kManBits)) {
+      raw_bits = quantum;
+    }
+    return sign | static_cast<uint8_t>(std::min<int>(raw_bits, kMaxRaw));
+  }
+};
+
+}  // namespace float8_detail
+
+/**
+ * The host storage types of fp8, they are only converted from and to float, the arithmetic is done in float. On the
+ * device, the generated code takes __nv_fp8_e4m3 and __nv_fp8_e5m2 of cuda_fp8.h instead.
+ */
+struct float8_e4m3 {
+  using Format = float8_detail::Float8Format<4, 3, false>;
+  uint8_t x;
+
+  float8_e4m3() = default;
+  explicit float8_e4m3(float val) : x(Format::FromFloat(val)) {}
+  explicit operator float() const { return Format::ToFloat(x); }
+};
+
+struct float8_e5m2 {
+  using Format = float8_detail::Float8Format<5, 2, true>;
+  uint8_t x;
+
+  float8_e5m2() = default;
+  explicit float8_e5m2(float val) : x(Format::FromFloat(val)) {}
+  explicit operator float() const { return Format::ToFloat(x); }
+};
+
+}  // namespace common
+}  // namespace cinn
@@ -20,6 +20,8 @@
 #include <functional>
 #include <set>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "cinn/common/common.h"
 #include "cinn/utils/dot_lang.h"
@@ -72,12 +74,44 @@ std::vector<GraphNode *> Graph::nodes() {
 std::tuple<std::vector<GraphNode *>, std::vector<GraphEdge *>> Graph::topological_order() const {
   std::vector<GraphNode *> node_order;
   std::vector<GraphEdge *> edge_order;
+
+  auto collect_edges = [&] {
+    for (int i = 0; i < node_order.size(); i++) {
+      node_order[i]->set_index(i);
+      for (auto &edge : node_order[i]->outlinks()) {
+        edge_order.push_back(edge.get());
+      }
+    }
+  };
+
+  // The removal of the links and the nodes keeps the cached order valid, so only the dropped nodes are filtered out,
+  // and it is recomputed if any node is linked or a node out of the cache is registered.
+  uint64_t link_version = GraphNode::link_version();
+  if (topological_order_cached_ && topological_order_version_ == link_version) {
+    std::unordered_set<GraphNode *> alive_nodes;
+    alive_nodes.reserve(nodes_.size());
+    for (auto &n : nodes_) {
+      alive_nodes.insert(n.get());
+    }
+    for (auto *n : topological_order_cache_) {
+      if (alive_nodes.erase(n)) {
+        node_order.push_back(n);
+      }
+    }
+    if (alive_nodes.empty()) {
+      topological_order_cache_ = node_order;
+      collect_edges();
+      return std::make_tuple(node_order, edge_order);
+    }
+    node_order.clear();
+  }
+
   std::deque<GraphNode *> queue;
 
   // collect indegreee.
-  std::map<std::string, int> indegree;
-  for (auto *n : nodes()) {
-    indegree[n->id()] = n->inlinks().size();
+  std::unordered_map<const GraphNode *, int> indegree;
+  for (auto &n : nodes_) {
+    indegree[n.get()] = n->inlinks().size();
   }
 
   // insert start points first.
@@ -86,27 +120,26 @@ std::tuple<std::vector<GraphNode *>, std::vector<GraphEdge *>> Graph::topologica
   }
 
   // start to visit
-  int count = 0;
   while (!queue.empty()) {
     auto *top_node = queue.front();
-    top_node->set_index(count);
     node_order.push_back(top_node);
-    count++;
-
     queue.pop_front();
 
     for (auto &edge : top_node->outlinks()) {
       CHECK_EQ(edge->source(), top_node);
-      edge_order.push_back(edge.get());
       auto *sink = edge->sink();
-      if ((--indegree[sink->id()]) == 0) {
+      if ((--indegree[sink]) == 0) {
         queue.push_back(sink);
       }
     }
   }
 
-  CHECK_EQ(node_order.size(), nodes().size()) << "circle detected in the schedule graph:\n\n" << Visualize();
+  CHECK_EQ(node_order.size(), nodes_.size()) << "circle detected in the schedule graph:\n\n" << Visualize();
 
+  topological_order_cache_   = node_order;
+  topological_order_version_ = link_version;
+  topological_order_cached_  = true;
+  collect_edges();
   return std::make_tuple(node_order, edge_order);
 }
 
@@ -138,6 +171,14 @@ GraphNode *Graph::RegisterNode(const std::string &key, GraphNode *node) {
   return RegisterNode(std::hash<std::string>{}(key), node);
 }
 
+void Graph::DropNodes(const std::unordered_set<GraphNode *> &nodes) {
+  nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [&](auto &x) { return nodes.count(x.get()); }),
+               nodes_.end());
+  for (auto *n : nodes) {
+    dirty_nodes_.erase(n);
+  }
+}
+
 GraphNode *Graph::RetrieveNode(size_t key) const {
   auto it = registry_.find(key);
   return it == registry_.end() ? nullptr : it->second;
@@ -169,26 +210,22 @@ void Graph::ClearUnlinkedNodes(absl::flat_hash_map<std::string, std::vector<int>
   CHECK(shape_dict);
   CHECK(type_dict);
   CHECK(layout_dict);
-  for (auto it = nodes_.begin(); it < nodes_.end(); ++it) {
-    auto node = *it;
-    if (node->inlinks().empty() && node->outlinks().empty()) {
-      VLOG(2) << "delete unlinked node: " << node->id();
-      nodes_.erase(it);
-      if (shape_dict->count(node->id())) {
-        shape_dict->erase(node->id());
-      }
-      if (type_dict->count(node->id())) {
-        type_dict->erase(node->id());
-      }
-      if (layout_dict->count(node->id())) {
-        layout_dict->erase(node->id());
-      }
-      --it;
+  auto is_unlinked = [&](const Shared<GraphNode> &node) {
+    if (!node->inlinks().empty() || !node->outlinks().empty()) {
+      return false;
     }
-  }
+    VLOG(2) << "delete unlinked node: " << node->id();
+    shape_dict->erase(node->id());
+    type_dict->erase(node->id());
+    layout_dict->erase(node->id());
+    dirty_nodes_.erase(node.get());
+    return true;
+  };
+  nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), is_unlinked), nodes_.end());
 }
 
 const char *GraphNode::__type_info__ = "GraphNode";
+std::atomic<uint64_t> GraphNode::link_version_{0};
 
 bool GraphEdgeCompare::operator()(const Shared<GraphEdge> &a, const Shared<GraphEdge> &b) const {
   if (a->source()->id() == b->source()->id()) {
@@ -19,6 +19,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
@@ -26,6 +27,7 @@
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/common/object.h"
@@ -89,6 +91,7 @@ class GraphNode : public Object {
     auto inlink_edge  = make_shared<GraphEdge>(this, other, other->index_inlinks);
     index_outlinks++;
     other->index_inlinks++;
+    link_version_++;
     outlinks_.insert(outlink_edge);
     other->inlinks_.insert(inlink_edge);
 
@@ -200,6 +203,10 @@ class GraphNode : public Object {
 
   static const char* __type_info__;
 
+  //! The version bumped by each new link of any node, the cached topological orders are invalidated by it, while the
+  //! removal of the links keeps them valid.
+  static uint64_t link_version() { return link_version_; }
+
  protected:
   //! The input links of the node.
   //! \note We record the raw pointer rather than the shared pointer to avoid cycle reference.
@@ -213,6 +220,8 @@ class GraphNode : public Object {
   int index_inlinks{0};
   int index_outlinks{0};
   int index{0};
+
+  static std::atomic<uint64_t> link_version_;
 };
 
 /**
@@ -240,6 +249,7 @@ class Graph {
   std::vector<GraphNode*> start_points();
 
   //! Return the graph's nodes and edges(visited) in topological order.
+  //! \note The order is cached until a new link or a linked node is added, the dropped nodes are filtered out of it.
   std::tuple<std::vector<GraphNode*>, std::vector<GraphEdge*>> topological_order() const;
 
   //! Return the graph's DFS order.
@@ -259,8 +269,18 @@ class Graph {
     if (it != nodes_.end()) {
       nodes_.erase(it);
     }
+    dirty_nodes_.erase(n);
   }
 
+  //! Drop a set of nodes in a single pass over the nodes.
+  void DropNodes(const std::unordered_set<GraphNode*>& nodes);
+
+  //! Mark the node whose inputs or attributes are rewritten, so that the analyses such as the InferShape are updated
+  //! only from the dirty nodes rather than the whole graph.
+  void MarkDirty(GraphNode* node) { dirty_nodes_.insert(node); }
+  const std::unordered_set<GraphNode*>& dirty_nodes() const { return dirty_nodes_; }
+  void ClearDirtyNodes() { dirty_nodes_.clear(); }
+
   //! Get a string representation to visualize a graph.
   std::string Visualize() const;
 
@@ -275,6 +295,14 @@ class Graph {
   std::map<size_t, GraphNode*> registry_;
   //! A list owns the graph nodes.
   std::vector<Shared<GraphNode>> nodes_;
+  //! The nodes rewritten since the last update of the analyses.
+  std::unordered_set<GraphNode*> dirty_nodes_;
+
+ private:
+  //! The cached topological order of the nodes and the link version it is computed at.
+  mutable std::vector<GraphNode*> topological_order_cache_;
+  mutable uint64_t topological_order_version_{0};
+  mutable bool topological_order_cached_{false};
 };
 
 }  // namespace common
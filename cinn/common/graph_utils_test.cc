@@ -88,5 +88,35 @@ TEST(Graph, simple) {
   }
 }
 
+TEST(Graph, CachedTopologicalOrder) {
+  auto graph = CreateGraph0();
+  auto* C    = graph->RetrieveNode("C");
+  auto* D    = graph->RetrieveNode("D");
+  auto* E    = graph->RetrieveNode("E");
+  ASSERT_EQ(std::get<0>(graph->topological_order()).size(), 5);
+
+  // the removed node is filtered out of the cached order
+  C->UnLinkAllTo(E);
+  graph->MarkDirty(E);
+  graph->DropNode(E);
+  ASSERT_TRUE(graph->dirty_nodes().empty());
+  auto node_order = std::get<0>(graph->topological_order());
+  ASSERT_EQ(node_order.size(), 4);
+  ASSERT_EQ(node_order.back(), D);
+
+  // the new link invalidates the cached order
+  auto* F = make_shared<GraphNodeWithName>("F");
+  graph->RegisterNode("F", F);
+  F->LinkTo(graph->RetrieveNode("A"));
+  Graph::edge_order_t edge_order;
+  std::tie(node_order, edge_order) = graph->topological_order();
+  ASSERT_EQ(node_order.size(), 5);
+  ASSERT_EQ(node_order.front(), F);
+  ASSERT_EQ(edge_order.size(), 4);
+  for (int i = 0; i < node_order.size(); i++) {
+    EXPECT_EQ(node_order[i]->get_index(), i);
+  }
+}
+
 }  // namespace common
 }  // namespace cinn
@@ -205,7 +205,7 @@ bool is_zero(Expr v) {
   auto *float_n = v.As<ir::FloatImm>();
 
   if (int_n) return int_n->value == 0;
-  if (float_n) return float_n->value = 0.f;
+  if (float_n) return float_n->value == 0.f;
   return false;
 }
 
@@ -315,6 +315,10 @@ Expr cast(Expr e, Type type) {
       return Expr(static_cast<cinn::common::bfloat16>(e.get_constant()));
     } else if (type.is_float16()) {
       return Expr(static_cast<cinn::common::float16>(e.get_constant()));
+    } else if (type.is_float8_e4m3()) {
+      return Expr(cinn::common::float8_e4m3(static_cast<float>(e.get_constant())));
+    } else if (type.is_float8_e5m2()) {
+      return Expr(cinn::common::float8_e5m2(static_cast<float>(e.get_constant())));
     } else {
       CINN_NOT_IMPLEMENTED
     }
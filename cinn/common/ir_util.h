@@ -115,13 +115,13 @@ Expr make_const(Type t, T v) {
     }
   } else {
     if (t.is_int()) {
-      return make_shared<ir::IntImm>(t, static_cast<int64_t>(v));
+      return ir::MakeIntImm(t, static_cast<int64_t>(v));
     } else if (t.is_uint()) {
-      return make_shared<ir::UIntImm>(t, static_cast<uint64_t>(v));
+      return ir::MakeUIntImm(t, static_cast<uint64_t>(v));
     } else if (t.is_float()) {
-      return make_shared<ir::FloatImm>(t, static_cast<double>(v));
+      return ir::MakeFloatImm(t, static_cast<double>(v));
     } else if (t.is_bool()) {
-      return make_shared<ir::UIntImm>(t, static_cast<bool>(v));
+      return ir::MakeUIntImm(t, static_cast<bool>(v));
     } else {
       CINN_NOT_IMPLEMENTED
     }
@@ -18,16 +18,39 @@
 
 #include <glog/logging.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <sys/prctl.h>
+#endif
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
 #include <sstream>
+#include <string>
 
 #include "cinn/common/target.h"
 #include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cpu/thread_backend.h"
 
 #ifdef CINN_WITH_CUDA
 #include <cuda_runtime_api.h>
 #include <driver_types.h>
 #endif
 
+#ifdef CINN_WITH_ROCM
+#include <hip/hip_runtime_api.h>
+#endif
+
 namespace cinn {
 namespace common {
 
@@ -53,37 +76,76 @@ int Target::runtime_arch() const {
 }
 
 int Target::max_num_threads() const {
-  CHECK(arch == Arch::NVGPU) << "The target is not NVGPU! Cannot get max number of threads.";
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get max number of threads.";
   return 1024;
 }
 
+int Target::warp_size() const {
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get warp size.";
+  return arch == Arch::AMDGPU ? 64 : 32;
+}
+
 int Target::get_multi_processor_count() const {
-  CHECK(arch == Arch::NVGPU) << "The target is not NVGPU! Cannot get multi processor count";
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get multi processor count";
   int num_sm = 0;
 #ifdef CINN_WITH_CUDA
   cudaDeviceGetAttribute(&num_sm, cudaDeviceAttr::cudaDevAttrMultiProcessorCount, 0);
+#endif
+#ifdef CINN_WITH_ROCM
+  hipDeviceGetAttribute(&num_sm, hipDeviceAttributeMultiprocessorCount, 0);
 #endif
   return num_sm;
 }
 
 int Target::get_max_threads_per_sm() const {
-  CHECK(arch == Arch::NVGPU) << "The target is not NVGPU! Cannot get max threads per stream processor";
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get max threads per stream processor";
   int max_thread = 0;
 #ifdef CINN_WITH_CUDA
   cudaDeviceGetAttribute(&max_thread, cudaDeviceAttr::cudaDevAttrMaxThreadsPerMultiProcessor, 0);
+#endif
+#ifdef CINN_WITH_ROCM
+  hipDeviceGetAttribute(&max_thread, hipDeviceAttributeMaxThreadsPerMultiProcessor, 0);
 #endif
   return max_thread;
 }
 
 int Target::get_max_blocks_per_sm() const {
-  CHECK(arch == Arch::NVGPU) << "The target is not NVGPU! Cannot get max blocks per stream processor";
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get max blocks per stream processor";
   int max_blocks = 1;
 #ifdef CINN_WITH_CUDA
   cudaDeviceGetAttribute(&max_blocks, cudaDeviceAttr::cudaDevAttrMaxBlocksPerMultiprocessor, 0);
+#endif
+#ifdef CINN_WITH_ROCM
+  // HIP has no attribute of the max blocks per compute unit, bound it by the blocks of a single wavefront
+  max_blocks = get_max_threads_per_sm() / warp_size();
 #endif
   return max_blocks;
 }
 
+int Target::get_max_shared_memory_per_block() const {
+  CHECK(is_gpu()) << "The target is not GPU! Cannot get max shared memory per block";
+  int max_bytes = 48 * 1024;
+#ifdef CINN_WITH_CUDA
+  cudaDeviceGetAttribute(&max_bytes, cudaDeviceAttr::cudaDevAttrMaxSharedMemoryPerBlock, 0);
+#endif
+#ifdef CINN_WITH_ROCM
+  hipDeviceGetAttribute(&max_bytes, hipDeviceAttributeMaxSharedMemoryPerBlock, 0);
+#endif
+  return max_bytes;
+}
+
+int Target::get_compute_capability() const {
+  CHECK(arch == Arch::NVGPU) << "The target is not NVGPU! Cannot get compute capability";
+  int major = 0, minor = 0;
+#ifdef CINN_WITH_CUDA
+  if (cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0) != cudaSuccess ||
+      cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0) != cudaSuccess) {
+    return 0;
+  }
+#endif
+  return major * 10 + minor;
+}
+
 std::vector<Target::Lib> Target::get_target_libs() const { return libs; }
 
 int Target::get_target_bits() const {
@@ -100,6 +162,153 @@ int Target::get_target_bits() const {
   return -1;
 }
 
+namespace {
+
+// Detect the SIMD extensions of the host X86 CPU by cpuid, the AVX states are also checked by xgetbv to make sure
+// the operating system saves the vector registers on context switch.
+std::bitset<32> DetectHostX86Features() {
+  std::bitset<32> res;
+#if defined(__x86_64__) || defined(__i386__)
+  auto set = [&res](Target::X86Feature feature, bool supported) { res.set(static_cast<int>(feature), supported); };
+
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return res;
+  bool os_xsave = (ecx >> 27) & 1;
+  if (!os_xsave) return res;
+  unsigned int xcr0_lo = 0, xcr0_hi = 0;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  // XMM and YMM states
+  bool os_avx = (xcr0_lo & 0x6) == 0x6;
+  // opmask, upper ZMM0-15 and ZMM16-31 states
+  bool os_avx512 = os_avx && (xcr0_lo & 0xe0) == 0xe0;
+  if (!os_avx) return res;
+  set(Target::X86Feature::FMA, (ecx >> 12) & 1);
+  set(Target::X86Feature::F16C, (ecx >> 29) & 1);
+
+  if (__get_cpuid_max(0, nullptr) < 7) return res;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  unsigned int max_subleaf = eax;
+  set(Target::X86Feature::AVX2, (ebx >> 5) & 1);
+  set(Target::X86Feature::AVX512F, os_avx512 && ((ebx >> 16) & 1));
+  set(Target::X86Feature::AVX512BW, os_avx512 && ((ebx >> 30) & 1));
+  set(Target::X86Feature::AVX512VL, os_avx512 && ((ebx >> 31) & 1));
+  set(Target::X86Feature::AVX512_VNNI, os_avx512 && ((ecx >> 11) & 1));
+  if (max_subleaf >= 1) {
+    __cpuid_count(7, 1, eax, ebx, ecx, edx);
+    set(Target::X86Feature::AVX512_BF16, os_avx512 && ((eax >> 5) & 1));
+  }
+#endif
+  return res;
+}
+
+// Detect the SIMD extensions of the host AArch64 CPU by the hardware capabilities reported by the Linux kernel, the
+// bits are the HWCAP_* and HWCAP2_* ones of asm/hwcap.h, which are missing in the old kernel headers.
+std::bitset<32> DetectHostARMFeatures() {
+  std::bitset<32> res;
+#if defined(__aarch64__) && defined(__linux__)
+  auto set = [&res](Target::ARMFeature feature, bool supported) { res.set(static_cast<int>(feature), supported); };
+
+  unsigned long hwcap  = getauxval(AT_HWCAP);   // NOLINT
+  unsigned long hwcap2 = getauxval(AT_HWCAP2);  // NOLINT
+  set(Target::ARMFeature::NEON, (hwcap >> 1) & 1);
+  set(Target::ARMFeature::FP16, (hwcap >> 10) & 1);
+  set(Target::ARMFeature::DOTPROD, (hwcap >> 20) & 1);
+  set(Target::ARMFeature::SVE, (hwcap >> 22) & 1);
+  set(Target::ARMFeature::SVE2, (hwcap2 >> 1) & 1);
+  set(Target::ARMFeature::I8MM, (hwcap2 >> 13) & 1);
+  set(Target::ARMFeature::BF16, (hwcap2 >> 14) & 1);
+#endif
+  return res;
+}
+
+// The vector length of SVE in bits set for the process, or 128 of NEON.
+int DetectHostARMVectorBits() {
+#if defined(__aarch64__) && defined(__linux__) && defined(PR_SVE_GET_VL)
+  if (DetectHostARMFeatures().test(static_cast<int>(Target::ARMFeature::SVE))) {
+    int vl = prctl(PR_SVE_GET_VL);
+    if (vl > 0) return (vl & PR_SVE_VL_LEN_MASK) * 8;
+  }
+#endif
+  return 128;
+}
+
+// Detect the caches by sysconf of glibc and the NUMA nodes by sysfs, the defaults of CpuInfo are kept for the ones
+// unknown, such as in the containers hiding /sys.
+Target::CpuInfo DetectHostCpuInfo() {
+  Target::CpuInfo info;
+  info.num_cores = max_concurrency();
+#ifdef __linux__
+  auto set_cache = [](int name, int* bytes) {
+    long size = sysconf(name);  // NOLINT
+    if (size > 0) *bytes = static_cast<int>(std::min<long>(size, 1L << 30));  // NOLINT
+  };
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+  set_cache(_SC_LEVEL1_DCACHE_SIZE, &info.l1_cache_bytes);
+  set_cache(_SC_LEVEL2_CACHE_SIZE, &info.l2_cache_bytes);
+  set_cache(_SC_LEVEL3_CACHE_SIZE, &info.llc_bytes);
+#endif
+  info.llc_bytes = std::max(info.llc_bytes, info.l2_cache_bytes);
+
+  int num_nodes = 0;
+  if (DIR* dir = opendir("/sys/devices/system/node")) {
+    while (auto* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+          std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(c); })) {
+        ++num_nodes;
+      }
+    }
+    closedir(dir);
+  }
+  info.num_numa_nodes = std::max(num_nodes, 1);
+#endif
+  VLOG(3) << "Host CPU: num_cores=" << info.num_cores << ", num_numa_nodes=" << info.num_numa_nodes
+          << ", l1_cache_bytes=" << info.l1_cache_bytes << ", l2_cache_bytes=" << info.l2_cache_bytes
+          << ", llc_bytes=" << info.llc_bytes;
+  return info;
+}
+
+}  // namespace
+
+bool Target::x86_supports(X86Feature feature) const {
+  if (arch != Arch::X86) return false;
+  static const std::bitset<32> host_features = DetectHostX86Features();
+  return host_features.test(static_cast<int>(feature));
+}
+
+int Target::x86_vector_bits() const {
+  if (x86_supports(X86Feature::AVX512F)) return 512;
+  if (x86_supports(X86Feature::AVX2)) return 256;
+  return 128;
+}
+
+bool Target::arm_supports(ARMFeature feature) const {
+  if (arch != Arch::ARM) return false;
+  static const std::bitset<32> host_features = DetectHostARMFeatures();
+  return host_features.test(static_cast<int>(feature));
+}
+
+int Target::arm_vector_bits() const {
+  static const int host_vector_bits = DetectHostARMVectorBits();
+  return arch == Arch::ARM ? host_vector_bits : 128;
+}
+
+int Target::cpu_vector_bits() const {
+  switch (arch) {
+    case Arch::X86:
+      return x86_vector_bits();
+    case Arch::ARM:
+      return arm_vector_bits();
+    default:
+      return 128;
+  }
+}
+
+const Target::CpuInfo &Target::cpu_info() const {
+  static const CpuInfo host_info = DetectHostCpuInfo();
+  return host_info;
+}
+
 std::string Target::arch_str() const {
   std::ostringstream oss;
   oss << arch;
@@ -132,6 +341,9 @@ std::ostream &operator<<(std::ostream &os, const Target &target) {
     case Target::Arch::NVGPU:
       os << "nvgpu";
       break;
+    case Target::Arch::AMDGPU:
+      os << "amdgpu";
+      break;
     case Target::Arch::Unk:
       os << "unk";
       break;
@@ -168,6 +380,9 @@ std::ostream &operator<<(std::ostream &os, Target::Arch arch) {
     case Target::Arch::NVGPU:
       os << "NVGPU";
       break;
+    case Target::Arch::AMDGPU:
+      os << "AMDGPU";
+      break;
   }
   return os;
 }
@@ -177,7 +392,11 @@ const Target &UnkTarget() {
   return target;
 }
 const Target &DefaultHostTarget() {
+#if defined(__aarch64__)
+  static Target target(Target::OS::Linux, Target::Arch::ARM, Target::Bit::k64, {}, {});
+#else
   static Target target(Target::OS::Linux, Target::Arch::X86, Target::Bit::k64, {}, {});
+#endif
   return target;
 }
 
@@ -186,6 +405,11 @@ const Target &DefaultNVGPUTarget() {
   return target;
 }
 
+const Target &DefaultAMDGPUTarget() {
+  static Target target(Target::OS::Linux, Target::Arch::AMDGPU, Target::Bit::k64, {}, {});
+  return target;
+}
+
 int GetMaxThreads() {
   // cudaDeviceGetAttribute ( int* value, cudaDeviceAttr attr, int  device )
   int max_threads = 1;
@@ -214,8 +438,10 @@ int GetMaxBlocks() {
 }
 
 const Target &DefaultTarget() {
-#ifdef CINN_WITH_CUDA
+#if defined(CINN_WITH_CUDA)
   return DefaultNVGPUTarget();
+#elif defined(CINN_WITH_ROCM)
+  return DefaultAMDGPUTarget();
 #else
   return DefaultHostTarget();
 #endif
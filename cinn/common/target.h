@@ -39,6 +39,7 @@ struct Target {
     X86,
     ARM,
     NVGPU,
+    AMDGPU,
   };
 
   enum class Bit : int {
@@ -66,6 +67,46 @@ struct Target {
   std::vector<Feature> features;
   std::vector<Lib> libs;
 
+  /**
+   * The SIMD extensions of the X86 CPU, they are detected from the host CPU which the code is JIT compiled for.
+   */
+  enum class X86Feature : int {
+    AVX2 = 0,
+    FMA,
+    F16C,
+    AVX512F,
+    AVX512BW,
+    AVX512VL,
+    AVX512_BF16,
+    AVX512_VNNI,
+  };
+
+  /**
+   * The SIMD extensions of the AArch64 CPU, they are detected from the hardware capabilities of the host CPU.
+   */
+  enum class ARMFeature : int {
+    NEON = 0,
+    FP16,
+    DOTPROD,
+    BF16,
+    I8MM,
+    SVE,
+    SVE2,
+  };
+
+  /**
+   * The description of the host CPU which the CPU kernels are scheduled for, the caches are the per-core L1 data
+   * cache and L2 cache and the last level cache shared by the cores.
+   */
+  struct CpuInfo {
+    //! The number of cores the parallel loops are launched on, the same as the workers of the host runtime.
+    int num_cores{1};
+    int num_numa_nodes{1};
+    int l1_cache_bytes{32 * 1024};
+    int l2_cache_bytes{1024 * 1024};
+    int llc_bytes{32 * 1024 * 1024};
+  };
+
   explicit Target(OS o                                 = OS::Linux,
                   Arch a                               = Arch::Unk,
                   Bit b                                = Bit::Unk,
@@ -75,6 +116,15 @@ struct Target {
 
   bool defined() const { return os != OS::Unk && arch != Arch::Unk && bits != Bit::Unk; }
 
+  //! Whether the target is a host CPU, the X86 and ARM ones share the LLVM codegen, the runtime and the schedules.
+  bool is_cpu() const { return arch == Arch::X86 || arch == Arch::ARM; }
+
+  //! Whether the target is a GPU, the NVIDIA and AMD ones share the lowering, the schedules and the device codegen.
+  bool is_gpu() const { return arch == Arch::NVGPU || arch == Arch::AMDGPU; }
+
+  //! The threads of a warp, which is a wavefront of 64 threads on the AMD GPUs.
+  int warp_size() const;
+
   //! Get the Runtime architecture, it is casted to integer to avoid header file depending.
   int runtime_arch() const;
 
@@ -86,12 +136,35 @@ struct Target {
 
   int get_max_blocks_per_sm() const;
 
+  int get_max_shared_memory_per_block() const;
+
+  //! The compute capability of the GPU as major * 10 + minor, such as 80 for sm_80, 0 if unknown.
+  int get_compute_capability() const;
+
   int get_target_bits() const;
 
   std::vector<Lib> get_target_libs() const;
 
   std::string arch_str() const;
 
+  //! Whether the X86 CPU supports \p feature, it is always false if the target is not X86.
+  bool x86_supports(X86Feature feature) const;
+
+  //! The width in bits of the widest vector register of the X86 CPU, 512 for AVX-512, 256 for AVX2 and 128 otherwise.
+  int x86_vector_bits() const;
+
+  //! Whether the ARM CPU supports \p feature, it is always false if the target is not ARM.
+  bool arm_supports(ARMFeature feature) const;
+
+  //! The width in bits of the vector register of the ARM CPU, the vector length of SVE or 128 for NEON.
+  int arm_vector_bits() const;
+
+  //! The width in bits of the widest vector register of the X86 or ARM CPU, 128 for the other targets.
+  int cpu_vector_bits() const;
+
+  //! The cores, caches and NUMA nodes of the host CPU, it is detected once and only meaningful for the CPU targets.
+  const CpuInfo& cpu_info() const;
+
   bool operator==(const Target& other) const;
   bool operator!=(const Target& other) const { return !(*this == other); }
   friend std::ostream& operator<<(std::ostream& os, const Target& target);
@@ -103,6 +176,8 @@ const Target& DefaultHostTarget();
 
 const Target& DefaultNVGPUTarget();
 
+const Target& DefaultAMDGPUTarget();
+
 const Target& DefaultTarget();
 
 int GetMaxThreads();
@@ -29,7 +29,7 @@ struct Type::Storage {
   Storage(type_t t, int b, int w, specific_type_t st) : type_(t), bits_(b), lanes_(w), specific_type_(st) {}
 
   type_t type_{type_t::Unk};
-  // distinguish FP16/BF16, or E5M2/E4M3 (when FP8 is supported)
+  // distinguish FP16/BF16, or E5M2/E4M3
   specific_type_t specific_type_{specific_type_t::None};
   cpp_type_t cpp_type_{cpp_type_t::None};
 
@@ -132,6 +132,9 @@ void Type::CheckTypeValid() const {
   if (GetStorage().type_ == type_t::Float && GetStorage().bits_ == 16) {
     CHECK(GetStorage().specific_type_ == specific_type_t::FP16 || GetStorage().specific_type_ == specific_type_t::BF16)
         << "When creating a 16 bits Float, the specific_type_t must be FP16 or BF16.";
+  } else if (GetStorage().type_ == type_t::Float && GetStorage().bits_ == 8) {
+    CHECK(GetStorage().specific_type_ == specific_type_t::E4M3 || GetStorage().specific_type_ == specific_type_t::E5M2)
+        << "When creating a 8 bits Float, the specific_type_t must be E4M3 or E5M2.";
   }
 }
 
@@ -154,9 +157,9 @@ Type Type::ConstOf() const {
 }
 
 bool Type::is_supported() const {
-  return this->is_float(32) || this->is_float16() || this->is_bfloat16() || this->is_float(64) || this->is_bool() ||
-         this->is_int(8) || this->is_int(16) || this->is_int(32) || this->is_int(64) || this->is_uint(8) ||
-         this->is_uint(16) || this->is_uint(32) || this->is_uint(64);
+  return this->is_float(32) || this->is_float16() || this->is_bfloat16() || this->is_float8() || this->is_float(64) ||
+         this->is_bool() || this->is_int(8) || this->is_int(16) || this->is_int(32) || this->is_int(64) ||
+         this->is_uint(8) || this->is_uint(16) || this->is_uint(32) || this->is_uint(64);
 }
 
 Type Type::IgnoreConst() const {
@@ -218,6 +221,10 @@ bool Type::valid() const {
     return (GetStorage().specific_type_ == specific_type_t::FP16 ||
             GetStorage().specific_type_ == specific_type_t::BF16);
   }
+  if (is_float() && GetStorage().bits_ == 8) {
+    return (GetStorage().specific_type_ == specific_type_t::E4M3 ||
+            GetStorage().specific_type_ == specific_type_t::E5M2);
+  }
   if (is_primitive()) {
     return bits() != 0;
   }
@@ -229,6 +236,9 @@ Type::Type(Type::type_t t, int b, int w, specific_type_t st) : storage_(new Stor
   if (t == Type::type_t::Float && b == 16) {
     CHECK(st == specific_type_t::FP16 || st == specific_type_t::BF16)
         << "When creating a 16 bits Float, the specific_type_t must be FP16 or BF16.";
+  } else if (t == Type::type_t::Float && b == 8) {
+    CHECK(st == specific_type_t::E4M3 || st == specific_type_t::E5M2)
+        << "When creating a 8 bits Float, the specific_type_t must be E4M3 or E5M2.";
   }
 }
 bool Type::is_primitive() const { return !is_unk() && type() != type_t::Customized; }
@@ -239,18 +249,25 @@ bool Type::is_void() const { return type() == type_t::Void; }
 bool Type::is_vector() const { return lanes() > 1; }
 bool Type::is_scalar() const { return lanes() == 1; }
 // Note: when calling is_float(16), 'st' can't be specific_type_t::None to distinguish FP16/BF16, or use
-// is_float16()/is_bfloat16() for short
+// is_float16()/is_bfloat16() for short, and so is is_float(8) to distinguish E4M3/E5M2
 bool Type::is_float(int bits, specific_type_t st) const {
   if (type() == type_t::Float && bits == 16) {
     CHECK(st != specific_type_t::None) << "when calling is_float(16), 'st' can't be specific_type_t::None to "
                                           "distinguish FP16/BF16, or use is_float16()/is_bfloat16() for short";
     return st == this->specific_type();
+  } else if (type() == type_t::Float && bits == 8) {
+    CHECK(st != specific_type_t::None) << "when calling is_float(8), 'st' can't be specific_type_t::None to "
+                                          "distinguish E4M3/E5M2, or use is_float8_e4m3()/is_float8_e5m2() for short";
+    return this->bits() == 8 && st == this->specific_type();
   } else {
     return type() == type_t::Float && (bits < 0 || bits == this->bits());
   }
 }
 bool Type::is_float16() const { return is_float(16, specific_type_t::FP16); }
 bool Type::is_bfloat16() const { return is_float(16, specific_type_t::BF16); }
+bool Type::is_float8_e4m3() const { return is_float(8, specific_type_t::E4M3); }
+bool Type::is_float8_e5m2() const { return is_float(8, specific_type_t::E5M2); }
+bool Type::is_float8() const { return is_float8_e4m3() || is_float8_e5m2(); }
 bool Type::is_uint(int bits) const { return type() == type_t::UInt && (bits < 0 || bits == this->bits()); }
 bool Type::is_int(int bits) const { return type() == type_t::Int && (bits < 0 || bits == this->bits()); }
 bool Type::is_integer(int bits) const {
@@ -312,6 +329,14 @@ const Type &F16() {
   static auto t = Float(16, 1, Type::specific_type_t::FP16);
   return t;
 }
+const Type &F8E4M3() {
+  static auto t = Float(8, 1, Type::specific_type_t::E4M3);
+  return t;
+}
+const Type &F8E5M2() {
+  static auto t = Float(8, 1, Type::specific_type_t::E5M2);
+  return t;
+}
 const Type &F32() {
   static auto t = Float(32);
   return t;
@@ -390,6 +415,8 @@ int Type::bytes() const {
   static std::unordered_map<Type, int, TypeHash> type_bytes = {
       GET_TYPE_SIZE_PAIR(bfloat16),
       GET_TYPE_SIZE_PAIR(float16),
+      GET_TYPE_SIZE_PAIR(float8_e4m3),
+      GET_TYPE_SIZE_PAIR(float8_e5m2),
       GET_TYPE_SIZE_PAIR(float),
       GET_TYPE_SIZE_PAIR(double),
 
@@ -472,6 +499,10 @@ Type Str2Type(const std::string &type) {
       {"float16", F16()},
       {"half", F16()},
 
+      // the same names as paddle and ml_dtypes, E4M3 has no infinity, which is marked by "fn"
+      {"float8_e4m3fn", F8E4M3()},
+      {"float8_e5m2", F8E5M2()},
+
       {"float", F32()},
       {"float32", F32()},
 
@@ -544,6 +575,10 @@ std::string Type2Str(const Type &type) {
           return "bfloat16";
         case Type::specific_type_t::FP16:
           return "float16";
+        case Type::specific_type_t::E4M3:
+          return "float8_e4m3fn";
+        case Type::specific_type_t::E5M2:
+          return "float8_e5m2";
         default:
           break;
       }
@@ -21,6 +21,7 @@
 #include "cinn/common/bfloat16.h"
 #include "cinn/common/float16.h"
 #include "cinn/common/float16_bfloat16_utils.h"
+#include "cinn/common/float8.h"
 #include "cinn/common/macros.h"
 #include "cinn/runtime/cinn_runtime.h"
 
@@ -47,16 +48,15 @@ struct Type {
   };
 
   // CINN use type_t and bits to distinguish data types, like is_float(64) for double,
-  // is_float(32) for float, but for Float16 and BFloat16, the bits are both 16, so we need
-  // some other info to distinguish them.
+  // is_float(32) for float, but for Float16 and BFloat16, the bits are both 16, and so are
+  // the bits of the two FP8 formats, so we need some other info to distinguish them.
   enum class specific_type_t {
     // None for some cases we only care about the bits, e.g. vectorize for hardwares
     None = -1,
     FP16,
     BF16,
-    // for FP8 in future
-    // E5M2,
-    // E4M3,
+    E5M2,
+    E4M3,
   };
 
   //! type decorators in C++, the different code can used together.
@@ -87,6 +87,9 @@ struct Type {
   CINN_NODISCARD bool is_float(int bits = -1, specific_type_t st = specific_type_t::None) const;
   CINN_NODISCARD bool is_float16() const;
   CINN_NODISCARD bool is_bfloat16() const;
+  CINN_NODISCARD bool is_float8_e4m3() const;
+  CINN_NODISCARD bool is_float8_e5m2() const;
+  CINN_NODISCARD bool is_float8() const;
   CINN_NODISCARD bool is_int(int bits = -1) const;
   CINN_NODISCARD bool is_integer(int bits = -1) const;
   CINN_NODISCARD bool is_uint(int bits = -1) const;
@@ -164,10 +167,15 @@ inline Type Int(int bits, int lanes = 1) { return Type(Type::type_t ::Int, bits,
 inline Type UInt(int bits, int lanes = 1) { return Type(Type::type_t ::UInt, bits, lanes); }
 inline Type BFloat16(int lanes = 1) { return Type(Type::type_t ::Float, 16, lanes, Type::specific_type_t::BF16); }
 inline Type Float16(int lanes = 1) { return Type(Type::type_t ::Float, 16, lanes, Type::specific_type_t::FP16); }
+inline Type Float8E4M3(int lanes = 1) { return Type(Type::type_t ::Float, 8, lanes, Type::specific_type_t::E4M3); }
+inline Type Float8E5M2(int lanes = 1) { return Type(Type::type_t ::Float, 8, lanes, Type::specific_type_t::E5M2); }
 inline Type Float(int bits, int lanes = 1, Type::specific_type_t st = Type::specific_type_t::None) {
   if (bits == 16) {
     CHECK(st == Type::specific_type_t::FP16 || st == Type::specific_type_t::BF16)
         << "When creating a 16 bits Float, the specific_type_t must be FP16 or BF16.";
+  } else if (bits == 8) {
+    CHECK(st == Type::specific_type_t::E4M3 || st == Type::specific_type_t::E5M2)
+        << "When creating a 8 bits Float, the specific_type_t must be E4M3 or E5M2.";
   }
   return Type(Type::type_t ::Float, bits, lanes, st);
 }
@@ -178,6 +186,8 @@ inline Type String() { return Type(Type::type_t::String, 1, 1); }
 // @{
 const Type& BF16();
 const Type& F16();
+const Type& F8E4M3();
+const Type& F8E5M2();
 const Type& F32();
 const Type& F64();
 const Type& I8();
@@ -200,6 +210,8 @@ template <> inline Type type_of<void>() { return Void(); }
 
 template <> inline Type type_of<bfloat16>() { return BF16(); }
 template <> inline Type type_of<float16>() { return F16(); }
+template <> inline Type type_of<float8_e4m3>() { return F8E4M3(); }
+template <> inline Type type_of<float8_e5m2>() { return F8E5M2(); }
 template <> inline Type type_of<float>() { return F32(); }
 template <> inline Type type_of<double>() { return F64(); }
 
@@ -227,6 +239,12 @@ inline Type type_of<int8_t*>() {
   return x;
 }
 template <>
+inline Type type_of<int32_t*>() {
+  Type x = Int(32);
+  x.set_cpp_handle();
+  return x;
+}
+template <>
 inline Type type_of<uint8_t*>() {
   Type x = UInt(8);
   x.set_cpp_handle();
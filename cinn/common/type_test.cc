@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 namespace cinn::common {
 
 TEST(Type, basic) {
@@ -28,4 +30,29 @@ TEST(Type, basic) {
   LOG(INFO) << type_of<float>();
 }
 
+TEST(Type, float8) {
+  ASSERT_TRUE(F8E4M3().is_float8_e4m3());
+  ASSERT_TRUE(F8E5M2().is_float8_e5m2());
+  ASSERT_EQ(F8E4M3().bytes(), 1);
+  ASSERT_EQ(Str2Type("float8_e4m3fn"), F8E4M3());
+  ASSERT_EQ(Str2Type("float8_e5m2"), F8E5M2());
+  ASSERT_EQ(Type2Str(F8E4M3()), "float8_e4m3fn");
+  ASSERT_EQ(Type2Str(F8E5M2()), "float8_e5m2");
+
+  // the values are rounded to the nearest even and saturated to the max finite value
+  ASSERT_EQ(static_cast<float>(float8_e4m3(1.0f)), 1.0f);
+  ASSERT_EQ(static_cast<float>(float8_e4m3(0.3f)), 0.3125f);
+  ASSERT_EQ(static_cast<float>(float8_e4m3(1000.0f)), 448.0f);
+  ASSERT_EQ(static_cast<float>(float8_e4m3(-1000.0f)), -448.0f);
+  ASSERT_EQ(static_cast<float>(float8_e5m2(1.0f)), 1.0f);
+  ASSERT_EQ(static_cast<float>(float8_e5m2(1e6f)), 57344.0f);
+  for (int raw = 0; raw < 256; ++raw) {
+    float8_e4m3 value;
+    value.x = raw;
+    if (!std::isnan(static_cast<float>(value))) {
+      ASSERT_EQ(float8_e4m3(static_cast<float>(value)).x, raw);
+    }
+  }
+}
+
 }  // namespace cinn::common
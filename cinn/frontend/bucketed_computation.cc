@@ -0,0 +1,213 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/bucketed_computation.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cinn {
+namespace frontend {
+
+BucketedComputation::BucketedComputation(const Target& target,
+                                         ProgramBuilder builder,
+                                         const Config& config,
+                                         const CinnComputation::CompileOptions& options,
+                                         void* stream)
+    : target_(target),
+      builder_(std::move(builder)),
+      config_(config),
+      options_(options),
+      stream_(stream),
+      buckets_(MakeBuckets(config.min_size, config.max_size, config.specialized_sizes)) {
+  if (config_.compile_in_background) {
+    compile_thread_ = std::thread([this]() { BackgroundCompile(); });
+  }
+}
+
+BucketedComputation::~BucketedComputation() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (compile_thread_.joinable()) {
+    compile_thread_.join();
+  }
+}
+
+std::vector<int> BucketedComputation::MakeBuckets(int min_size,
+                                                  int max_size,
+                                                  const std::vector<int>& specialized_sizes) {
+  CHECK_GT(min_size, 0) << "The smallest bucket should be positive";
+  CHECK_LE(min_size, max_size) << "The smallest bucket should not be larger than the largest one";
+  std::vector<int> buckets;
+  for (int64_t bucket = min_size; bucket < max_size; bucket *= 2) {
+    buckets.push_back(bucket);
+  }
+  buckets.push_back(max_size);
+  for (int size : specialized_sizes) {
+    CHECK_GT(size, 0) << "The specialized size should be positive";
+    CHECK_LE(size, max_size) << "The specialized size should not be larger than the largest bucket";
+    buckets.push_back(size);
+  }
+  std::sort(buckets.begin(), buckets.end());
+  buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+  return buckets;
+}
+
+int BucketedComputation::FindBucket(int size) const {
+  auto it = std::lower_bound(buckets_.begin(), buckets_.end(), size);
+  CHECK(it != buckets_.end()) << "The size " << size << " exceeds the largest bucket " << buckets_.back();
+  return *it;
+}
+
+void BucketedComputation::PadAlongAxis(
+    const void* src, void* dst, const std::vector<int>& shape, int axis, int size, size_t element_bytes) {
+  CHECK(axis >= 0 && axis < shape.size()) << "The axis " << axis << " is out of the range of the rank " << shape.size();
+  CHECK_LE(size, shape[axis]) << "The size should not be larger than the padded dimension";
+  size_t outer = 1;
+  for (int idx = 0; idx < axis; ++idx) {
+    outer *= shape[idx];
+  }
+  size_t inner = element_bytes;
+  for (int idx = axis + 1; idx < shape.size(); ++idx) {
+    inner *= shape[idx];
+  }
+  size_t src_row = size * inner;
+  size_t dst_row = shape[axis] * inner;
+  auto* src_ptr  = static_cast<const uint8_t*>(src);
+  auto* dst_ptr  = static_cast<uint8_t*>(dst);
+  for (size_t idx = 0; idx < outer; ++idx) {
+    std::memcpy(dst_ptr + idx * dst_row, src_ptr + idx * src_row, src_row);
+    std::memset(dst_ptr + idx * dst_row + src_row, 0, dst_row - src_row);
+  }
+}
+
+bool BucketedComputation::CountHotSize(int size) {
+  if (config_.num_hot_sizes <= 0) {
+    return false;
+  }
+  int64_t count = ++size_counts_[size];
+  if (hot_sizes_.count(size)) {
+    return true;
+  }
+  if (count < config_.hot_size_min_runs || static_cast<int>(hot_sizes_.size()) >= config_.num_hot_sizes) {
+    return false;
+  }
+  VLOG(3) << "The size " << size << " is run " << count << " times, compile it for its exact size";
+  hot_sizes_.insert(size);
+  return true;
+}
+
+std::shared_ptr<CinnComputation> BucketedComputation::GetComputation(int size, int* bucket) {
+  int target_bucket = FindBucket(size);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    // the hot size is served by its exact version once compiled, and by the buckets meanwhile
+    if (target_bucket != size && CountHotSize(size)) {
+      target_bucket = size;
+    }
+    auto it = computations_.lower_bound(target_bucket);
+    if (it != computations_.end() && (it->first == target_bucket || config_.compile_in_background)) {
+      // serve by a larger bucket until the target one is compiled in background
+      if (it->first != target_bucket && scheduled_buckets_.insert(target_bucket).second) {
+        VLOG(3) << "Serve the size " << size << " by the bucket " << it->first << ", and compile the bucket "
+                << target_bucket << " in background";
+        pending_buckets_.push_back(target_bucket);
+        cv_.notify_one();
+      }
+      if (bucket) *bucket = it->first;
+      return it->second;
+    }
+  }
+  // there is no larger bucket to serve it
+  if (bucket) *bucket = target_bucket;
+  return Compile(target_bucket);
+}
+
+void BucketedComputation::Precompile(int size) { Compile(FindBucket(size)); }
+
+std::shared_ptr<CinnComputation> BucketedComputation::Compile(int bucket) {
+  std::lock_guard<std::mutex> compile_lock(compile_mtx_);
+  {
+    // it may be compiled by another thread while waiting
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = computations_.find(bucket);
+    if (it != computations_.end()) {
+      return it->second;
+    }
+  }
+  VLOG(3) << "Compile the computation of the bucket " << bucket;
+  auto program     = builder_(bucket);
+  auto computation = CinnComputation::Compile(target_, program, options_, {}, stream_);
+  std::lock_guard<std::mutex> lock(mtx_);
+  computations_[bucket] = computation;
+  return computation;
+}
+
+void BucketedComputation::BackgroundCompile() {
+  while (true) {
+    int bucket = 0;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return stopped_ || !pending_buckets_.empty(); });
+      if (stopped_) return;
+      bucket = pending_buckets_.front();
+      pending_buckets_.pop_front();
+    }
+    Compile(bucket);
+  }
+}
+
+void BucketedComputation::FeedInputs(CinnComputation* computation,
+                                     int served_bucket,
+                                     int size,
+                                     const std::map<std::string, const void*>& inputs) const {
+  for (auto& item : inputs) {
+    auto tensor          = computation->GetTensor(item.first);
+    size_t element_bytes = tensor->type().bytes();
+    size_t nbytes        = tensor->shape().numel() * element_bytes;
+    auto it              = config_.dynamic_axes.find(item.first);
+    if (it == config_.dynamic_axes.end()) {
+      computation->SetTensorData(tensor, const_cast<void*>(item.second), nbytes);
+      continue;
+    }
+    auto& shape = tensor->shape().data();
+    CHECK(it->second >= 0 && it->second < shape.size()) << "The dynamic axis of " << item.first << " is out of range";
+    CHECK_EQ(shape[it->second], served_bucket)
+        << "The dynamic dimension of " << item.first << " is not of the bucket size, please check the ProgramBuilder";
+    if (size == served_bucket) {
+      computation->SetTensorData(tensor, const_cast<void*>(item.second), nbytes);
+      continue;
+    }
+    std::vector<uint8_t> padded(nbytes);
+    PadAlongAxis(item.second, padded.data(), shape, it->second, size, element_bytes);
+    computation->SetTensorData(tensor, padded.data(), nbytes);
+  }
+}
+
+std::shared_ptr<CinnComputation> BucketedComputation::Run(int size,
+                                                          const std::map<std::string, const void*>& inputs,
+                                                          int* bucket) {
+  int served_bucket = 0;
+  auto computation  = GetComputation(size, &served_bucket);
+  FeedInputs(computation.get(), served_bucket, size, inputs);
+  computation->Execute();
+  if (bucket) *bucket = served_bucket;
+  return computation;
+}
+
+}  // namespace frontend
+}  // namespace cinn
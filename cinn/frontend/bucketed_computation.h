@@ -0,0 +1,148 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/computation.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * BucketedComputation serves a computation whose inputs have one dynamic dimension, such as the batch size or the
+ * sequence length, by a set of CinnComputations compiled for the padded sizes(buckets) of the dimension.
+ *
+ * The buckets are doubled from Config::min_size, and capped by Config::max_size. The common sizes listed in
+ * Config::specialized_sizes are buckets too, so their runs are served by the kernels of their exact size. A run of
+ * size n is served by the smallest bucket >= n, the inputs are zero padded along their dynamic axes to the bucket, and
+ * copied directly when n is the bucket. If that bucket is not
+ * compiled yet, it is compiled in background and the run is served by a larger compiled bucket meanwhile, only when
+ * there is no larger one the run waits for the compilation.
+ *
+ * The sizes of the runs are counted, and the sizes run at least Config::hot_size_min_runs times are compiled for their
+ * exact sizes as well, up to Config::num_hot_sizes of them. Such a version is compiled like a missing bucket, and then
+ * preferred to the bucket of the size.
+ *
+ * The compilations are run one by one, as the compiler uses the global name generator.
+ */
+class BucketedComputation {
+ public:
+  // build the program whose dynamic dimension is of size \p bucket
+  using ProgramBuilder = std::function<Program(int bucket)>;
+
+  struct Config {
+    int min_size = 1;
+    int max_size = 1024;
+    // the dynamic axis of each input, the inputs not listed are not padded
+    std::unordered_map<std::string, int> dynamic_axes;
+    // the common sizes compiled besides the doubled buckets, such as the frequent sequence lengths
+    std::vector<int> specialized_sizes;
+    // compile the missing buckets in background instead of blocking the run
+    bool compile_in_background = true;
+    // the number of the hot sizes compiled for their exact sizes, and the runs to make a size hot
+    int num_hot_sizes     = 0;
+    int hot_size_min_runs = 16;
+  };
+
+  BucketedComputation(const Target& target,
+                      ProgramBuilder builder,
+                      const Config& config,
+                      const CinnComputation::CompileOptions& options = CinnComputation::DefaultCompileOptions(),
+                      void* stream                                   = nullptr);
+  ~BucketedComputation();
+
+  /**
+   * Run the computation of size \p size. The runs served by the same bucket share its tensors, so they can't be run
+   * concurrently.
+   * @param size The size of the dynamic dimension.
+   * @param inputs The host data of the inputs, whose dynamic dimensions are of size \p size.
+   * @param bucket Return the bucket which serves the run if not nullptr.
+   * @return The computation run, the outputs are read from it, whose dynamic dimensions are of the bucket size.
+   */
+  std::shared_ptr<CinnComputation> Run(int size,
+                                       const std::map<std::string, const void*>& inputs,
+                                       int* bucket = nullptr);
+
+  //! The computation to serve the size \p size, and compile the missing bucket.
+  std::shared_ptr<CinnComputation> GetComputation(int size, int* bucket = nullptr);
+
+  /**
+   * Feed the inputs of size \p size to \p computation compiled for \p bucket, padded along their dynamic axes as Run,
+   * without executing it.
+   */
+  void FeedInputs(CinnComputation* computation,
+                  int bucket,
+                  int size,
+                  const std::map<std::string, const void*>& inputs) const;
+
+  //! Compile the bucket of size \p size and wait for it, to warm up ahead of the traffic.
+  void Precompile(int size);
+
+  const Config& GetConfig() const { return config_; }
+  const std::vector<int>& Buckets() const { return buckets_; }
+  //! The smallest bucket >= \p size.
+  int FindBucket(int size) const;
+
+  //! The sizes doubled from \p min_size up to \p max_size, merged with the \p specialized_sizes.
+  static std::vector<int> MakeBuckets(int min_size, int max_size, const std::vector<int>& specialized_sizes = {});
+
+  /**
+   * Copy \p src whose dimension \p axis is of size \p size into \p dst of \p shape, and fill the padding with zeros.
+   */
+  static void PadAlongAxis(
+      const void* src, void* dst, const std::vector<int>& shape, int axis, int size, size_t element_bytes);
+
+ private:
+  std::shared_ptr<CinnComputation> FindCompiled(int bucket, int* served_bucket);
+  // count the run of \p size, and return whether it's compiled for its exact size
+  bool CountHotSize(int size);
+  std::shared_ptr<CinnComputation> Compile(int bucket);
+  void BackgroundCompile();
+
+  Target target_;
+  ProgramBuilder builder_;
+  Config config_;
+  CinnComputation::CompileOptions options_;
+  void* stream_;
+  std::vector<int> buckets_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::map<int, std::shared_ptr<CinnComputation>> computations_;
+  // the histogram of the sizes run, and the sizes chosen to be compiled exactly
+  std::unordered_map<int, int64_t> size_counts_;
+  std::set<int> hot_sizes_;
+  // the buckets waiting for the background compilation, and all the buckets scheduled to it
+  std::deque<int> pending_buckets_;
+  std::set<int> scheduled_buckets_;
+  bool stopped_{false};
+  // serialize the compilations
+  std::mutex compile_mtx_;
+  std::thread compile_thread_;
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,137 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/bucketed_computation.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cinn {
+namespace frontend {
+
+TEST(BucketedComputation, MakeBuckets) {
+  ASSERT_EQ(BucketedComputation::MakeBuckets(1, 8), std::vector<int>({1, 2, 4, 8}));
+  ASSERT_EQ(BucketedComputation::MakeBuckets(3, 20), std::vector<int>({3, 6, 12, 20}));
+  ASSERT_EQ(BucketedComputation::MakeBuckets(16, 16), std::vector<int>({16}));
+  // the specialized sizes are merged into the doubled buckets
+  ASSERT_EQ(BucketedComputation::MakeBuckets(1, 8, {3, 8}), std::vector<int>({1, 2, 3, 4, 8}));
+}
+
+TEST(BucketedComputation, PadAlongAxis) {
+  // pad the dimension 1 of a [2, 2, 2] tensor to [2, 3, 2]
+  std::vector<int> src = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int> dst(12, -1);
+  BucketedComputation::PadAlongAxis(src.data(), dst.data(), {2, 3, 2}, 1, 2, sizeof(int));
+  ASSERT_EQ(dst, std::vector<int>({1, 2, 3, 4, 0, 0, 5, 6, 7, 8, 0, 0}));
+}
+
+TEST(BucketedComputation, ServeByBucket) {
+  auto target  = common::DefaultHostTarget();
+  auto builder = [](int bucket) {
+    NetBuilder net_builder("bucketed_add");
+    auto x = net_builder.CreateInput(Float(32), {bucket, 4}, "x");
+    auto y = net_builder.CreateInput(Float(32), {bucket, 4}, "y");
+    net_builder.Add(x, y);
+    return net_builder.Build();
+  };
+  BucketedComputation::Config config;
+  config.min_size              = 1;
+  config.max_size              = 8;
+  config.dynamic_axes          = {{"x", 0}, {"y", 0}};
+  config.compile_in_background = false;
+  BucketedComputation computation(target, builder, config);
+  ASSERT_EQ(computation.FindBucket(3), 4);
+
+  const int size = 3;
+  std::vector<float> x(size * 4), y(size * 4);
+  for (int idx = 0; idx < x.size(); ++idx) {
+    x[idx] = idx;
+    y[idx] = 2 * idx;
+  }
+  int bucket  = 0;
+  auto result = computation.Run(size, {{"x", x.data()}, {"y", y.data()}}, &bucket);
+  ASSERT_EQ(bucket, 4);
+  auto output = result->GetOutputTensors()[0];
+  std::vector<float> out(4 * 4);
+  result->GetTensorData(output, out.data(), out.size() * sizeof(float));
+  for (int idx = 0; idx < out.size(); ++idx) {
+    // the padded rows are zeros
+    ASSERT_FLOAT_EQ(out[idx], idx < x.size() ? x[idx] + y[idx] : 0.f);
+  }
+
+  // without the background compilation, the missing bucket is compiled before serving
+  ASSERT_EQ(computation.GetComputation(2, &bucket), computation.GetComputation(2, &bucket));
+  ASSERT_EQ(bucket, 2);
+
+  // the run of a specialized size is served by its own bucket without padding
+  config.specialized_sizes = {3};
+  BucketedComputation specialized(target, builder, config);
+  result = specialized.Run(size, {{"x", x.data()}, {"y", y.data()}}, &bucket);
+  ASSERT_EQ(bucket, size);
+  out.resize(size * 4);
+  result->GetTensorData(result->GetOutputTensors()[0], out.data(), out.size() * sizeof(float));
+  for (int idx = 0; idx < out.size(); ++idx) {
+    ASSERT_FLOAT_EQ(out[idx], x[idx] + y[idx]);
+  }
+
+  // the size run twice becomes hot and is compiled for its exact size, the other sizes keep their buckets
+  config.specialized_sizes = {};
+  config.num_hot_sizes     = 1;
+  config.hot_size_min_runs = 2;
+  BucketedComputation hot(target, builder, config);
+  hot.GetComputation(5, &bucket);
+  ASSERT_EQ(bucket, 8);
+  hot.GetComputation(5, &bucket);
+  ASSERT_EQ(bucket, 5);
+  hot.GetComputation(6, &bucket);
+  hot.GetComputation(6, &bucket);
+  ASSERT_EQ(bucket, 8);
+}
+
+#ifdef CINN_WITH_CUDA
+// Instead of the buckets, the program compiled for the largest batch launches the rows of the actual batch only.
+TEST(BatchScalable, LaunchActualBatch) {
+  const int max_batch = 64, cols = 1024, batch = 3;
+  NetBuilder builder("batch_scalable");
+  auto x = builder.CreateInput(Float(32), {max_batch, cols}, "x");
+  auto y = builder.CreateInput(Float(32), {max_batch, cols}, "y");
+  auto z = builder.Relu(builder.Add(builder.Scale(x, 2.f), y));
+
+  auto options         = CinnComputation::DefaultCompileOptions();
+  options.batch_inputs = {"x", "y"};
+  auto computation     = CinnComputation::BuildAndCompile(common::DefaultNVGPUTarget(), builder, options, {z});
+
+  std::vector<float> x_data(max_batch * cols), y_data(max_batch * cols), z_data(max_batch * cols, -1.f);
+  for (int idx = 0; idx < x_data.size(); ++idx) {
+    x_data[idx] = idx % 7;
+    y_data[idx] = -(idx % 5);
+  }
+  computation->SetTensorData("x", x_data.data(), x_data.size() * sizeof(float));
+  computation->SetTensorData("y", y_data.data(), y_data.size() * sizeof(float));
+  computation->SetTensorData(z->id, z_data.data(), z_data.size() * sizeof(float));
+  computation->SetBatchSize(batch);
+  computation->Execute();
+  computation->GetTensorData(z->id, z_data.data(), z_data.size() * sizeof(float));
+  for (int idx = 0; idx < batch * cols; ++idx) {
+    ASSERT_FLOAT_EQ(z_data[idx], std::max(x_data[idx] * 2.f + y_data[idx], 0.f));
+  }
+  // the blocks of the last rows are not launched
+  ASSERT_FLOAT_EQ(z_data.back(), -1.f);
+}
+#endif
+
+}  // namespace frontend
+}  // namespace cinn
@@ -14,16 +14,179 @@
 
 #include "cinn/frontend/computation.h"
 
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "cinn/frontend/computation_cache.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/caching_allocator.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
+#ifdef CINN_WITH_CUDA
+#include "cinn/backends/cuda_util.h"
+#endif
 
 namespace cinn {
 namespace frontend {
 
+namespace {
+#ifdef CINN_WITH_CUDA
+// The pinned host memory staging the asynchronous copies. A block is given back to the cache only after the copy using
+// it completes, which is tracked by an event recorded after the copy, since the host writes the blocks out of the
+// order of the streams.
+class PinnedStagingPool {
+ public:
+  static PinnedStagingPool &Global() {
+    static auto *pool = new PinnedStagingPool;
+    return *pool;
+  }
+
+  void *Allocate(size_t nbytes) {
+    Reclaim();
+    return allocator_.Allocate(nbytes);
+  }
+
+  // give the block back once the works issued to the stream so far are done
+  void FreeAfter(void *ptr, cudaStream_t stream) {
+    cudaEvent_t event;
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    CUDA_CALL(cudaEventRecord(event, stream));
+    std::lock_guard<std::mutex> lock(mtx_);
+    pending_.emplace_back(ptr, event);
+  }
+
+ private:
+  PinnedStagingPool()
+      : allocator_(
+            [](size_t nbytes) {
+              void *ptr = nullptr;
+              CUDA_CALL(cudaMallocHost(&ptr, nbytes));
+              return ptr;
+            },
+            [](void *ptr) { CUDA_CALL(cudaFreeHost(ptr)); }) {}
+
+  void Reclaim() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = pending_.begin();
+    while (it != pending_.end()) {
+      if (cudaEventQuery(it->second) != cudaSuccess) {
+        ++it;
+        continue;
+      }
+      CUDA_CALL(cudaEventDestroy(it->second));
+      allocator_.Free(it->first);
+      it = pending_.erase(it);
+    }
+  }
+
+  hlir::framework::CachingAllocator allocator_;
+  std::mutex mtx_;
+  std::vector<std::pair<void *, cudaEvent_t>> pending_;
+};
+
+// copy the staged data to the user buffer on the host once the copy from the device is done
+struct StagedHostCopy {
+  void *dst;
+  const void *src;
+  size_t size;
+};
+
+void CUDART_CB RunStagedHostCopy(void *data) {
+  auto *copy = static_cast<StagedHostCopy *>(data);
+  std::memcpy(copy->dst, copy->src, copy->size);
+  delete copy;
+}
+#endif
+}  // namespace
+
+TransferEvent::TransferEvent(const Target &target, void *stream) {
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    cudaEvent_t event;
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    CUDA_CALL(cudaEventRecord(event, static_cast<cudaStream_t>(stream)));
+    event_ = event;
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  }
+}
+
+TransferEvent::~TransferEvent() {
+#ifdef CINN_WITH_CUDA
+  if (event_) {
+    CUDA_CALL(cudaEventDestroy(static_cast<cudaEvent_t>(event_)));
+  }
+#endif
+}
+
+bool TransferEvent::Query() const {
+#ifdef CINN_WITH_CUDA
+  if (event_) {
+    return cudaEventQuery(static_cast<cudaEvent_t>(event_)) == cudaSuccess;
+  }
+#endif
+  return true;
+}
+
+void TransferEvent::Synchronize() const {
+#ifdef CINN_WITH_CUDA
+  if (event_) {
+    CUDA_CALL(cudaEventSynchronize(static_cast<cudaEvent_t>(event_)));
+  }
+#endif
+}
+
+void TransferEvent::WaitOn(void *stream) const {
+#ifdef CINN_WITH_CUDA
+  if (event_) {
+    CUDA_CALL(cudaStreamWaitEvent(static_cast<cudaStream_t>(stream), static_cast<cudaEvent_t>(event_), 0));
+  }
+#endif
+}
+
+void CopyToDeviceAsync(const Target &target, void *dst, const void *src, size_t size, void *stream) {
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    auto &pool   = PinnedStagingPool::Global();
+    void *staged = pool.Allocate(size);
+    std::memcpy(staged, src, size);
+    CUDA_CALL(cudaMemcpyAsync(dst, staged, size, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream)));
+    pool.FreeAfter(staged, static_cast<cudaStream_t>(stream));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.is_cpu()) {
+    std::memcpy(dst, src, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+void CopyToHostAsync(const Target &target, void *dst, const void *src, size_t size, void *stream) {
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    auto &pool   = PinnedStagingPool::Global();
+    void *staged = pool.Allocate(size);
+    auto cstream = static_cast<cudaStream_t>(stream);
+    CUDA_CALL(cudaMemcpyAsync(staged, src, size, cudaMemcpyDeviceToHost, cstream));
+    CUDA_CALL(cudaLaunchHostFunc(cstream, RunStagedHostCopy, new StagedHostCopy{dst, staged, size}));
+    pool.FreeAfter(staged, cstream);
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.is_cpu()) {
+    std::memcpy(dst, src, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
 struct ComputationContext {
   Target target;
   void *stream;
@@ -36,10 +199,18 @@ struct ComputationContext {
 
   std::vector<hlir::framework::Tensor> inputs;
   std::vector<hlir::framework::Tensor> outputs;
+  std::vector<std::string> input_names;
+  // the leading dimension of the batch inputs on compiling
+  std::unordered_map<std::string, int> compiled_batch_sizes;
   std::unordered_map<std::string, Variable> varmap;
   std::unordered_map<std::string, std::string> varmap_paddle2program;
 };
 
+// Run the prerun instructions and collect the input and output tensors of the compiled program.
+std::shared_ptr<ComputationContext> FinishCompile(std::shared_ptr<ComputationContext> ctx,
+                                                  const Program &program,
+                                                  const std::vector<Variable> &outputs);
+
 std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
                                                    Program &program,
                                                    const std::vector<Variable> &outputs,
@@ -50,6 +221,22 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   ctx->stream          = stream;
   ctx->target          = target;
   ctx->compile_options = options;
+
+  // the key is hashed before the program is changed by the decomposer
+  bool use_cache = ComputationCache::IsCacheable(options);
+  std::string cache_key;
+  ComputationCache::Entry cache_entry;
+  if (use_cache) {
+    cache_key = ComputationCache::Key(program, outputs, target, options);
+    if (ComputationCache::Global().Lookup(cache_key, &cache_entry)) {
+      VLOG(3) << "Load the compiled computation " << cache_key << " from the cache";
+      ctx->graph   = cache_entry.graph;
+      ctx->scope   = scope ? scope : std::make_shared<hlir::framework::Scope>();
+      ctx->program = hlir::framework::Program::Deserialize(cache_entry.artifact, target, ctx->scope);
+      return FinishCompile(ctx, program, outputs);
+    }
+  }
+
   if (ctx->compile_options.use_decomposer) {
     ProgramPass::Apply(&program, {}, target, {"Decomposer"});
   }
@@ -59,7 +246,7 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
     hlir::framework::ApplyPass(ctx->graph.get(), "InferShape");
 
 #ifndef CINN_WITH_CUDA
-    if (target.arch == Target::Arch::X86) {
+    if (target.is_cpu()) {
       hlir::framework::ApplyPass(ctx->graph.get(), "AlterLayout");
     }
 #endif
@@ -79,6 +266,17 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   }
 
   ctx->program = ctx->graph_compiler->Build(options, std::move(fetch_var_ids)).runtime_program;
+  if (use_cache && ctx->program->IsSerializable()) {
+    cache_entry.graph    = ctx->graph;
+    cache_entry.artifact = ctx->program->Serialize();
+    ComputationCache::Global().Insert(cache_key, std::move(cache_entry));
+  }
+  return FinishCompile(ctx, program, outputs);
+}
+
+std::shared_ptr<ComputationContext> FinishCompile(std::shared_ptr<ComputationContext> ctx,
+                                                  const Program &program,
+                                                  const std::vector<Variable> &outputs) {
   if (ctx->compile_options.do_prerun) {
     ctx->program->PreRun();
   }
@@ -86,11 +284,15 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   for (auto &in_v : program.GetInputs()) {
     hlir::framework::Tensor t = ctx->scope->GetTensor(in_v->id);
     ctx->inputs.push_back(t);
+    ctx->input_names.push_back(in_v->id);
   }
   for (auto &out_v : outputs) {
     hlir::framework::Tensor t = ctx->scope->GetTensor(out_v->id);
     ctx->outputs.push_back(t);
   }
+  for (auto &name : ctx->compile_options.batch_inputs) {
+    ctx->compiled_batch_sizes[name] = ctx->scope->GetTensor(name)->shape().data().at(0);
+  }
   return ctx;
 }
 
@@ -192,7 +394,7 @@ void CinnComputation::SetTensorData(hlir::framework::Tensor &t, void *data, size
 #else
     CINN_NOT_IMPLEMENTED
 #endif
-  } else if (context_->target.arch == Target::Arch::X86) {
+  } else if (context_->target.is_cpu()) {
     memcpy(tdata, data, size);
   } else {
     CINN_NOT_IMPLEMENTED
@@ -207,7 +409,7 @@ void CinnComputation::GetTensorData(hlir::framework::Tensor &t, void *data, size
 #else
     CINN_NOT_IMPLEMENTED
 #endif
-  } else if (context_->target.arch == Target::Arch::X86) {
+  } else if (context_->target.is_cpu()) {
     memcpy(data, tdata, size);
   } else {
     CINN_NOT_IMPLEMENTED
@@ -219,6 +421,38 @@ void CinnComputation::GetTensorData(const std::string &tname, void *data, size_t
   GetTensorData(t, data, size);
 }
 
+void CinnComputation::SetTensorDataAsync(hlir::framework::Tensor &t, const void *data, size_t size) {
+  void *tdata = t->mutable_data(context_->target, t->type());
+  CHECK_EQ(size, t->shape().numel() * t->type().bytes());
+  CopyToDeviceAsync(context_->target, tdata, data, size, context_->stream);
+}
+
+void CinnComputation::SetTensorDataAsync(const std::string &tname, const void *data, size_t size) {
+  hlir::framework::Tensor t = GetTensor(tname);
+  SetTensorDataAsync(t, data, size);
+}
+
+void CinnComputation::GetTensorDataAsync(hlir::framework::Tensor &t, void *data, size_t size) {
+  void *tdata = t->mutable_data(context_->target, t->type());
+  CHECK_EQ(size, t->shape().numel() * t->type().bytes());
+  CopyToHostAsync(context_->target, data, tdata, size, context_->stream);
+}
+
+void CinnComputation::GetTensorDataAsync(const std::string &tname, void *data, size_t size) {
+  hlir::framework::Tensor t = GetTensor(tname);
+  GetTensorDataAsync(t, data, size);
+}
+
+std::shared_ptr<TransferEvent> CinnComputation::RecordEvent() {
+  return std::make_shared<TransferEvent>(context_->target, context_->stream);
+}
+
+const Target &CinnComputation::GetTarget() const { return context_->target; }
+
+const hlir::framework::MemoryEstimate &CinnComputation::GetMemoryEstimate() const {
+  return context_->program->GetMemoryEstimate();
+}
+
 std::vector<hlir::framework::Tensor> CinnComputation::GetInputTensors() { return context_->inputs; }
 
 std::vector<hlir::framework::Tensor> CinnComputation::GetOutputTensors() { return context_->outputs; }
@@ -235,9 +469,43 @@ hlir::framework::Tensor CinnComputation::GetTensor(const std::string &tname) {
   return context_->scope->GetTensor(it->second);
 }
 
+int CinnComputation::GetTensorId(const std::string &tname) {
+  int id = context_->scope->FindVarId(tname);
+  if (id >= 0) {
+    return id;
+  }
+  auto it = context_->varmap_paddle2program.find(tname);
+  if (it != context_->varmap_paddle2program.end()) {
+    id = context_->scope->FindVarId(it->second);
+  }
+  CHECK_GE(id, 0) << "No variable called [" << tname
+                  << "] found in computation\nThe existing vars: " << utils::Join(context_->scope->var_names(), ", ");
+  return id;
+}
+
+hlir::framework::Tensor CinnComputation::GetTensor(int id) { return context_->scope->GetTensor(id); }
+
+void CinnComputation::SetBatchSize(int batch_size) {
+  auto &batch_inputs = context_->compile_options.batch_inputs;
+  CHECK(!batch_inputs.empty()) << "No batch input is set in the compile options";
+  for (auto &name : batch_inputs) {
+    auto tensor = context_->scope->GetTensor(name);
+    auto shape  = tensor->shape().data();
+    CHECK(batch_size > 0 && batch_size <= context_->compiled_batch_sizes.at(name))
+        << "The batch size " << batch_size << " of " << name << " is out of the compiled batch size "
+        << context_->compiled_batch_sizes.at(name);
+    shape[0] = batch_size;
+    tensor->Resize(hlir::framework::Shape(shape));
+  }
+}
+
 void CinnComputation::Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs) {
   context_->program->Execute(name2podargs, context_->stream);
 }
 
+std::unique_ptr<hlir::framework::ExecutionContext> CinnComputation::CreateExecutionContext() {
+  return context_->program->CreateExecutionContext(context_->input_names);
+}
+
 }  // namespace frontend
 }  // namespace cinn
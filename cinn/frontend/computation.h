@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <iostream>
+#include <memory>
 
+#include "cinn/common/macros.h"
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph_compiler.h"
@@ -24,6 +26,41 @@ namespace frontend {
 
 struct ComputationContext;
 
+/**
+ * TransferEvent is recorded on a stream and completes once all the works issued to the stream before it are done, such
+ * as the asynchronous copies and the executions. On the targets without streams it is completed on creating.
+ */
+class TransferEvent {
+ public:
+  explicit TransferEvent(const Target &target, void *stream = nullptr);
+  ~TransferEvent();
+
+  //! whether the event is completed, without blocking
+  bool Query() const;
+  //! block the host until the event is completed
+  void Synchronize() const;
+  //! make the works issued to \p stream later wait for the event, without blocking the host
+  void WaitOn(void *stream) const;
+
+ private:
+  void *event_{nullptr};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(TransferEvent);
+};
+
+/**
+ * Copy \p size bytes from the host to the device asynchronously on \p stream. The host data is staged into a pool of
+ * pinned memory before return, so \p src can be reused at once, and the copy overlaps with the works on the other
+ * streams. On the host target it is a plain memcpy.
+ */
+void CopyToDeviceAsync(const Target &target, void *dst, const void *src, size_t size, void *stream);
+
+/**
+ * Copy \p size bytes from the device to the host asynchronously on \p stream through the pinned staging pool, \p dst
+ * is written once the works issued to \p stream before a later TransferEvent are done.
+ */
+void CopyToHostAsync(const Target &target, void *dst, const void *src, size_t size, void *stream);
+
 class CinnComputation {
  public:
   struct CompileOptions : public hlir::framework::GraphCompiler::CompileOptions {
@@ -103,6 +140,19 @@ class CinnComputation {
    */
   hlir::framework::Tensor GetTensor(const std::string &name);
 
+  /**
+   * get the id of a tensor in the scope, which is stable for the computation, so that the tensors fed or fetched on
+   * every run are looked up by the id instead of the name
+   * @param name tensor name
+   */
+  int GetTensorId(const std::string &name);
+
+  /**
+   * get tensor by the id returned by GetTensorId
+   * @param id tensor id
+   */
+  hlir::framework::Tensor GetTensor(int id);
+
   /**
    * get input tensors
    */
@@ -148,11 +198,58 @@ class CinnComputation {
    */
   void GetTensorData(const std::string &tname, void *data, size_t size);
 
+  /**
+   * set the data of a tensor asynchronously on the stream of the computation, the data is staged into pinned memory
+   * before return, so the user buffer can be reused at once.
+   * @param t the tensor
+   * @param data address of the memory buffer to store tensor's data
+   * @param size size of the memory buffer
+   */
+  void SetTensorDataAsync(hlir::framework::Tensor &t, const void *data, size_t size);
+  void SetTensorDataAsync(const std::string &tname, const void *data, size_t size);
+
+  /**
+   * copy the data of a tensor to user specified buffer asynchronously on the stream of the computation, the buffer is
+   * written once the event recorded by RecordEvent after it completes.
+   * @param t the tensor
+   * @param data address of the memory buffer to store tensor's data
+   * @param size size of the memory buffer
+   */
+  void GetTensorDataAsync(hlir::framework::Tensor &t, void *data, size_t size);
+  void GetTensorDataAsync(const std::string &tname, void *data, size_t size);
+
+  /**
+   * record an event on the stream of the computation, which completes after all the copies and the executions issued
+   * to the computation before.
+   */
+  std::shared_ptr<TransferEvent> RecordEvent();
+
+  const Target &GetTarget() const;
+
+  /**
+   * get the memory of a run estimated at compile time from the life time of the variables, which is empty if the
+   * program is loaded from the computation cache.
+   */
+  const hlir::framework::MemoryEstimate &GetMemoryEstimate() const;
+
+  /**
+   * set the actual batch of the following executions, which is the leading dimension of the batch inputs in
+   * CompileOptions and not larger than the compiled one. The batch-major kernels launch the rows of the batch only,
+   * the rows of the inputs and the outputs beyond it are not used.
+   */
+  void SetBatchSize(int batch_size);
+
   /**
    * run the compiled program
    */
   void Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs = nullptr);
 
+  /**
+   * create a context with its own inputs and intermediate tensors, to run the compiled program concurrently with the
+   * other contexts, while the kernels and the weights are shared. The computation must outlive the context.
+   */
+  std::unique_ptr<hlir::framework::ExecutionContext> CreateExecutionContext();
+
  private:
   std::shared_ptr<ComputationContext> context_;
 };
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/computation_cache.h"
+
+#include <gflags/gflags.h>
+
+#include <map>
+#include <sstream>
+
+#include "cinn/utils/string.h"
+
+DECLARE_int64(cinn_computation_cache_capacity);
+DECLARE_string(cinn_computation_cache_dir);
+DECLARE_int64(cinn_computation_cache_max_bytes);
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+// bump it when the passes or the compilation change the result of the same program
+constexpr char kComputationCacheVersion[] = "computation-v1";
+
+// Print the attribute exactly, the floats are printed in hex so that the close values are not mixed up.
+struct AttrPrinter {
+  std::ostream& os;
+  void operator()(int x) { os << x; }
+  void operator()(int64_t x) { os << x; }
+  void operator()(float x) { os << std::hexfloat << x << std::defaultfloat; }
+  void operator()(double x) { os << std::hexfloat << x << std::defaultfloat; }
+  void operator()(bool x) { os << (x ? "true" : "false"); }
+  void operator()(const std::string& x) { os << x.size() << ":" << x; }
+  template <typename T>
+  void operator()(const std::vector<T>& x) {
+    os << "[";
+    for (const auto& v : x) {
+      (*this)(v);
+      os << ",";
+    }
+    os << "]";
+  }
+  void operator()(const std::vector<bool>& x) {
+    os << "[";
+    for (bool v : x) {
+      os << (v ? "true" : "false") << ",";
+    }
+    os << "]";
+  }
+};
+
+void PrintVariable(std::ostream& os, const Variable& var) {
+  os << var->id << ":" << var->type << "[" << utils::Join(var->shape, ",") << "]" << (var->is_const ? "c" : "") << ";";
+}
+
+}  // namespace
+
+ComputationCache& ComputationCache::Global() {
+  static auto* cache = new ComputationCache;
+  return *cache;
+}
+
+ComputationCache::ComputationCache() {
+  if (!FLAGS_cinn_computation_cache_dir.empty()) {
+    disk_cache_ = std::make_unique<backends::KernelDiskCache>(FLAGS_cinn_computation_cache_dir,
+                                                              FLAGS_cinn_computation_cache_max_bytes);
+  }
+}
+
+std::string ComputationCache::Key(const Program& program,
+                                  const std::vector<Variable>& outputs,
+                                  const Target& target,
+                                  const CinnComputation::CompileOptions& options) {
+  std::ostringstream program_os;
+  for (auto& var : program.GetInputs()) {
+    PrintVariable(program_os, var);
+  }
+  for (int i = 0; i < program.size(); ++i) {
+    auto& instr = program[i];
+    program_os << "\n" << instr->op_type << "(";
+    for (auto& var : instr->inputs) {
+      PrintVariable(program_os, var);
+    }
+    program_os << ")->(";
+    for (auto& var : instr->outputs) {
+      PrintVariable(program_os, var);
+    }
+    program_os << "){";
+    // the attributes are unordered in the instruction
+    std::map<std::string, const utils::Attribute*> attrs;
+    for (auto& attr : instr->attrs) {
+      attrs.emplace(attr.first, &attr.second);
+    }
+    for (auto& attr : attrs) {
+      program_os << attr.first << "=";
+      absl::visit(AttrPrinter{program_os}, *attr.second);
+      program_os << ";";
+    }
+    program_os << "}";
+  }
+
+  std::ostringstream options_os;
+  options_os << "decomposer=" << options.use_decomposer << ";default_passes=" << options.use_default_passes
+             << ";passes=" << utils::Join(options.passes, ",")
+             << ";instantiate_variables=" << options.with_instantiate_variables
+             << ";buffer_handle=" << options.with_buffer_handle_instruction_inserted
+             << ";remove_unused_variables=" << options.remove_unused_variables
+             << ";static_memory_plan=" << options.with_static_memory_plan;
+
+  std::vector<std::string> output_ids;
+  for (auto& var : outputs) {
+    output_ids.push_back(var->id);
+  }
+  return backends::KernelDiskCache::HashKey({kComputationCacheVersion,
+                                             utils::GetStreamCnt(target),
+                                             options_os.str(),
+                                             options.attached_code,
+                                             utils::Join(output_ids, ","),
+                                             program_os.str()});
+}
+
+bool ComputationCache::IsCacheable(const CinnComputation::CompileOptions& options) {
+  // the instructions scalable by the batch are not marked in the artifact
+  return (FLAGS_cinn_computation_cache_capacity > 0 || !FLAGS_cinn_computation_cache_dir.empty()) &&
+         !options.with_lazy_compile && options.groups.empty() && options.lowered_funcs.empty() &&
+         options.batch_inputs.empty();
+}
+
+bool ComputationCache::Lookup(const std::string& key, Entry* entry) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *entry = it->second->second;
+    ++stats_.num_hits;
+    return true;
+  }
+  if (disk_cache_ && disk_cache_->Lookup(key, &entry->artifact)) {
+    entry->graph.reset();
+    ++stats_.num_disk_hits;
+    return true;
+  }
+  ++stats_.num_misses;
+  return false;
+}
+
+void ComputationCache::Insert(const std::string& key, Entry entry) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (disk_cache_) {
+    disk_cache_->Insert(key, entry.artifact);
+  }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+  }
+  entries_.emplace_front(key, std::move(entry));
+  index_[key] = entries_.begin();
+  while (entries_.size() > static_cast<size_t>(FLAGS_cinn_computation_cache_capacity)) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+void ComputationCache::Clear() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  entries_.clear();
+  index_.clear();
+}
+
+ComputationCache::Stats ComputationCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+}  // namespace frontend
+}  // namespace cinn
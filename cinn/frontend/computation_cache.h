@@ -0,0 +1,91 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cinn/backends/kernel_disk_cache.h"
+#include "cinn/common/macros.h"
+#include "cinn/frontend/computation.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * ComputationCache keeps the results of CinnComputation::Compile by the hash of the program, the outputs, the target
+ * and the compile options, so that compiling the same program again skips the program passes, the graph passes and
+ * the compilation.
+ *
+ * An entry holds the optimized graph with its fusion groups and the compiled program serialized as an artifact, the
+ * compiled program is deserialized into the scope of each new computation, so the computations never share tensors.
+ * The entries are kept in memory in the LRU order, at most FLAGS_cinn_computation_cache_capacity of them, and also
+ * on disk in FLAGS_cinn_computation_cache_dir if set, where only the artifacts are kept. The values of the flags
+ * changing the compilation are not hashed, the cache should be cleared when they change.
+ */
+class ComputationCache {
+ public:
+  struct Entry {
+    // the optimized graph, which is not kept on disk
+    std::shared_ptr<hlir::framework::Graph> graph;
+    std::string artifact;
+  };
+
+  struct Stats {
+    size_t num_hits{0};
+    size_t num_disk_hits{0};
+    size_t num_misses{0};
+  };
+
+  static ComputationCache& Global();
+
+  //! The key of compiling \p program with \p outputs fetched, which must be computed before the program is optimized.
+  static std::string Key(const Program& program,
+                         const std::vector<Variable>& outputs,
+                         const Target& target,
+                         const CinnComputation::CompileOptions& options);
+
+  //! Whether the compilation with \p options can be cached, such as not compiled lazily or with given groups.
+  static bool IsCacheable(const CinnComputation::CompileOptions& options);
+
+  bool Lookup(const std::string& key, Entry* entry);
+  void Insert(const std::string& key, Entry entry);
+
+  void Clear();
+  Stats GetStats() const;
+
+ private:
+  ComputationCache();
+
+  // the least recently used entry is at the back
+  std::list<std::pair<std::string, Entry>> entries_;
+  std::unordered_map<std::string, std::list<std::pair<std::string, Entry>>::iterator> index_;
+  std::unique_ptr<backends::KernelDiskCache> disk_cache_;
+
+  mutable std::mutex mtx_;
+  Stats stats_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ComputationCache);
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/computation_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+
+namespace cinn {
+namespace frontend {
+
+std::vector<float> RunComputation(NetBuilder* builder, const Variable& y) {
+  auto computation = CinnComputation::BuildAndCompile(
+      common::DefaultHostTarget(), *builder, CinnComputation::DefaultCompileOptions(), {y});
+  std::vector<float> x_data(32), y_data(32);
+  for (int i = 0; i < 32; ++i) {
+    x_data[i] = static_cast<float>(i % 5);
+  }
+  computation->SetTensorData("x", x_data.data(), x_data.size() * sizeof(float));
+  computation->Execute();
+  computation->GetTensorData(y->id, y_data.data(), y_data.size() * sizeof(float));
+  return y_data;
+}
+
+TEST(ComputationCache, Key) {
+  auto build = [](float scale) {
+    NetBuilder builder("computation_cache");
+    auto x = builder.CreateInput(Float(32), {4, 8}, "x");
+    auto y = builder.Scale(x, scale);
+    y.set_id("y");
+    return std::make_pair(builder.Build(), y);
+  };
+  auto target  = common::DefaultHostTarget();
+  auto options = CinnComputation::DefaultCompileOptions();
+  auto p1      = build(1.0f);
+  auto p2      = build(1.0f);
+  auto p3      = build(1.0f + 1e-7f);
+  auto key1    = ComputationCache::Key(p1.first, {p1.second}, target, options);
+  ASSERT_EQ(key1, ComputationCache::Key(p2.first, {p2.second}, target, options));
+  // the close attributes are not mixed up
+  ASSERT_NE(key1, ComputationCache::Key(p3.first, {p3.second}, target, options));
+  options.use_default_passes = false;
+  ASSERT_NE(key1, ComputationCache::Key(p1.first, {p1.second}, target, options));
+}
+
+TEST(ComputationCache, Hit) {
+  auto& cache = ComputationCache::Global();
+  cache.Clear();
+  auto stats = cache.GetStats();
+
+  // the ids of the variables are generated by the builder, so the same builder is compiled again
+  NetBuilder builder("computation_cache");
+  auto x  = builder.CreateInput(Float(32), {4, 8}, "x");
+  auto w  = builder.FillConstant({4, 8}, -1.f, "w", "float32");
+  auto y  = builder.Relu(builder.Scale(builder.Add(x, w), 2.f));
+  auto y1 = RunComputation(&builder, y);
+  ASSERT_EQ(cache.GetStats().num_misses, stats.num_misses + 1);
+  auto y2 = RunComputation(&builder, y);
+  ASSERT_EQ(cache.GetStats().num_hits, stats.num_hits + 1);
+
+  // a different constant misses the cache
+  NetBuilder other_builder("computation_cache");
+  x       = other_builder.CreateInput(Float(32), {4, 8}, "x");
+  w       = other_builder.FillConstant({4, 8}, -2.f, "w", "float32");
+  y       = other_builder.Relu(other_builder.Scale(other_builder.Add(x, w), 2.f));
+  auto y3 = RunComputation(&other_builder, y);
+  ASSERT_EQ(cache.GetStats().num_misses, stats.num_misses + 2);
+
+  for (int i = 0; i < 32; ++i) {
+    float x_value = static_cast<float>(i % 5);
+    ASSERT_FLOAT_EQ(y1[i], std::max((x_value - 1.f) * 2.f, 0.f));
+    ASSERT_FLOAT_EQ(y2[i], y1[i]);
+    ASSERT_FLOAT_EQ(y3[i], std::max((x_value - 2.f) * 2.f, 0.f));
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -12,8 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "cinn/frontend/decomposer_registry.h"
 #include "cinn/frontend/syntax.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_use_custom_call);
+DECLARE_string(cinn_custom_call_deny_ops);
 
 namespace cinn {
 namespace frontend {
@@ -279,6 +289,35 @@ void batch_norm(const Instruction& instr, const DecomposerContext& context) {
   context.MapOutToOrigin(y, instr->outputs[0]);
 }
 
+// The Welford kernels of the runtime take the 4-D x of float32, float16 or bfloat16 with the float32 parameters.
+bool UseBatchNormCustomCall(const Instruction& instr, const Variable& x, const Variable& param) {
+  auto deny_ops = utils::Split(FLAGS_cinn_custom_call_deny_ops, ";");
+  if (!FLAGS_cinn_use_custom_call || std::find(deny_ops.begin(), deny_ops.end(), instr->op_type) != deny_ops.end()) {
+    return false;
+  }
+  return x->shape.size() == 4UL && (x->type.is_float(32) || x->type.is_float16() || x->type.is_bfloat16()) &&
+         param->type.is_float(32);
+}
+
+// The batch_norm_train and the batch_norm_grad are kept on NVGPU and computed by a Welford reduction of the
+// per-channel statistics followed by a single elementwise pass through the custom_call, instead of the several
+// reduce groups of the decomposed ops.
+void batch_norm_train_nvgpu(const Instruction& instr, const DecomposerContext& context) {
+  if (UseBatchNormCustomCall(instr, instr->inputs[0], instr->inputs[1])) {
+    context.builder()->AppendInstruction(instr);
+    return;
+  }
+  batch_norm_train(instr, context);
+}
+
+void batch_norm_grad_nvgpu(const Instruction& instr, const DecomposerContext& context) {
+  if (UseBatchNormCustomCall(instr, instr->inputs[1], instr->inputs[2])) {
+    context.builder()->AppendInstruction(instr);
+    return;
+  }
+  batch_norm_grad(instr, context);
+}
+
 }  // namespace decomposer
 }  // namespace frontend
 }  // namespace cinn
@@ -290,13 +329,19 @@ CINN_REGISTER_HELPER(batch_norm_decomposer) {
 }
 
 CINN_REGISTER_HELPER(batch_norm_train_decomposer) {
-  CINN_DECOMPOSER_REGISTER(batch_norm_train, cinn::frontend::decomposer::batch_norm_train);
+  CINN_DECOMPOSER_REGISTER(
+      batch_norm_train, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::batch_norm_train);
+  CINN_DECOMPOSER_REGISTER(
+      batch_norm_train, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::batch_norm_train_nvgpu);
 
   return true;
 }
 
 CINN_REGISTER_HELPER(batch_norm_grad_decomposer) {
-  CINN_DECOMPOSER_REGISTER(batch_norm_grad, cinn::frontend::decomposer::batch_norm_grad);
+  CINN_DECOMPOSER_REGISTER(
+      batch_norm_grad, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::batch_norm_grad);
+  CINN_DECOMPOSER_REGISTER(
+      batch_norm_grad, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::batch_norm_grad_nvgpu);
 
   return true;
 }
@@ -12,10 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "cinn/frontend/decomposer/test_helper.h"
 
+DECLARE_string(cinn_custom_call_deny_ops);
+
 namespace cinn {
 namespace frontend {
 namespace {
@@ -171,6 +179,7 @@ TEST(Decomposer, BatchNormTrain) {
   RunDecomposer(&program, target, cinn::frontend::DefaultTrainingOptimizeOptions().program_passes, output_names);
 
   auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
   hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
   hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
 
@@ -352,6 +361,7 @@ TEST(Decomposer, BatchNormGrad) {
   RunDecomposer(&program, target, cinn::frontend::DefaultTrainingOptimizeOptions().program_passes, output_names);
 
   auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
   hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
   hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
 
@@ -415,6 +425,101 @@ TEST(Decomposer, BatchNormGrad) {
   }
 }
 
+// Run the program on NVGPU, the batch_norm ops are computed by the Welford kernels unless they are denied for
+// custom_call.
+std::vector<std::vector<float>> RunBatchNormProgram(Program* program,
+                                                    const std::unordered_map<std::string, std::vector<float>>& inputs,
+                                                    const std::vector<std::string>& output_ids) {
+  auto target = common::DefaultNVGPUTarget();
+  RunDecomposer(program, target);
+
+  std::unordered_set<std::string> fetch_ids(output_ids.begin(), output_ids.end());
+  auto graph = std::make_shared<hlir::framework::Graph>(*program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+  for (auto& input : inputs) {
+    scope->Var<hlir::framework::Tensor>(input.first);
+    auto tensor = scope->GetTensor(input.first);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(input.second, tensor, target);
+  }
+  run_program->Execute();
+
+  std::vector<std::vector<float>> outputs(output_ids.size());
+  for (size_t i = 0; i < output_ids.size(); ++i) {
+    CopyToVector(scope->GetTensor(output_ids[i]), &outputs[i]);
+  }
+  return outputs;
+}
+
+bool HasOp(const Program& program, const std::string& op_type) {
+  for (size_t i = 0; i < program.size(); ++i) {
+    if (program[i]->op_type == op_type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The Welford kernels reduce the channels-first layout by a block per channel and the channels-last layout by the
+// blocks of 32 adjacent channels, both are checked against the decomposed ops.
+TEST(Decomposer, BatchNormTrainGradFused) {
+  int n = 8, c = 48, h = 7, w = 9;
+  float epsilon  = 1e-5;
+  float momentum = 0.9f;
+  for (std::string data_layout : {"NCHW", "NHWC"}) {
+    std::vector<int> x_shape = data_layout == "NCHW" ? std::vector<int>{n, c, h, w} : std::vector<int>{n, h, w, c};
+    NetBuilder builder("batch_norm_fused");
+    auto x               = builder.CreateInput(Float(32), x_shape, "x");
+    auto scale           = builder.CreateInput(Float(32), {c}, "scale");
+    auto bias            = builder.CreateInput(Float(32), {c}, "bias");
+    auto moving_mean     = builder.CreateInput(Float(32), {c}, "moving_mean");
+    auto moving_variance = builder.CreateInput(Float(32), {c}, "moving_variance");
+    auto y_grad          = builder.CreateInput(Float(32), x_shape, "y_grad");
+    auto outs =
+        builder.BatchNorm(x, scale, bias, moving_mean, moving_variance, epsilon, momentum, data_layout, false);
+    auto grads = builder.BatchNormGrad(y_grad, x, scale, outs[1], outs[2], epsilon, data_layout);
+    std::vector<std::string> output_ids;
+    for (auto& out : outs) {
+      output_ids.push_back(out->id);
+    }
+    for (auto& grad : grads) {
+      output_ids.push_back(grad->id);
+    }
+
+    int num = n * c * h * w;
+    std::unordered_map<std::string, std::vector<float>> inputs;
+    InitRandomVector<float>(&inputs["x"], num, -1.0f, 1.0f, 1e-3);
+    InitRandomVector<float>(&inputs["scale"], c, 0.5f, 1.5f, 1e-3);
+    InitRandomVector<float>(&inputs["bias"], c, -1.0f, 1.0f, 1e-3);
+    InitRandomVector<float>(&inputs["moving_mean"], c, 0.0f, 1.0f, 1e-3);
+    InitRandomVector<float>(&inputs["moving_variance"], c, 0.0f, 1.0f, 1e-3);
+    InitRandomVector<float>(&inputs["y_grad"], num, -1.0f, 1.0f, 1e-3);
+
+    auto fused_program = builder.Build();
+    auto fused_outs    = RunBatchNormProgram(&fused_program, inputs, output_ids);
+    ASSERT_TRUE(HasOp(fused_program, "batch_norm_train"));
+    ASSERT_TRUE(HasOp(fused_program, "batch_norm_grad"));
+
+    FLAGS_cinn_custom_call_deny_ops = "batch_norm_train;batch_norm_grad";
+    auto decomposed_program         = builder.Build();
+    auto decomposed_outs            = RunBatchNormProgram(&decomposed_program, inputs, output_ids);
+    FLAGS_cinn_custom_call_deny_ops = "";
+    ASSERT_FALSE(HasOp(decomposed_program, "batch_norm_train"));
+
+    for (size_t i = 0; i < output_ids.size(); ++i) {
+      LOG(INFO) << data_layout << " output[" << i << "], var_name=" << output_ids[i];
+      // the gradients of the parameters are summed over the n * h * w elements
+      float atol = i < 6 ? 1e-4f : 1e-4f * n * h * w;
+      CheckOutput<float>(fused_outs[i], decomposed_outs[i], atol, 1e-3);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace frontend
 }  // namespace cinn
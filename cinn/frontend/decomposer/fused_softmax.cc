@@ -0,0 +1,179 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_use_custom_call);
+DECLARE_string(cinn_custom_call_deny_ops);
+
+namespace cinn {
+namespace frontend {
+namespace decomposer {
+
+// The fused softmax ops are computed in float32 along the last axis, the max is subtracted before the exponent.
+struct FusedSoftmaxHelper {
+  FusedSoftmaxHelper(NetBuilder* net_builder, const Instruction& instr) {
+    builder = net_builder;
+    x_shape = instr->inputs[0]->shape;
+    x_type  = instr->inputs[0]->type;
+    axis    = x_shape.size() - 1;
+
+    num_instructions = builder->size();
+    op_type          = instr->op_type;
+  }
+
+  ~FusedSoftmaxHelper() {
+    VLOG(4) << op_type << " is decomposed to " << builder->size() - num_instructions << " instructions.";
+  }
+
+  Variable ToFloat32(const Variable& x) { return x->type.is_float(32) ? x : builder->Cast(x, "float32"); }
+
+  Variable FromFloat32(const Variable& y) {
+    return x_type.is_float(32) ? y : builder->Cast(y, common::Type2Str(x_type));
+  }
+
+  // Return x - max(x) and the broadcast sum of its exponents.
+  std::pair<Variable, Variable> ShiftAndSum(const Variable& x) {
+    auto shifted = builder->Subtract(x, builder->BroadcastTo(builder->ReduceMax(x, {axis}, true), x_shape));
+    auto sum     = builder->BroadcastTo(builder->ReduceSum(builder->Exp(shifted), {axis}, true), x_shape);
+    return {shifted, sum};
+  }
+
+  NetBuilder* builder{nullptr};
+  std::vector<int> x_shape;
+  Type x_type;
+  int axis{0};
+  std::string op_type;
+  int num_instructions{0};
+};
+
+bool UseSoftmaxCustomCall(const std::string& op_type) {
+  auto deny_ops = utils::Split(FLAGS_cinn_custom_call_deny_ops, ";");
+  return FLAGS_cinn_use_custom_call && std::find(deny_ops.begin(), deny_ops.end(), op_type) == deny_ops.end();
+}
+
+void fused_softmax(const Instruction& instr, const DecomposerContext& context) {
+  CHECK(instr->inputs.size() == 1UL || instr->inputs.size() == 2UL)
+      << "The number of the given inputs is not equal to the required for op " << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 1UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  FusedSoftmaxHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  float scale      = instr->attrs.count("scale") ? instr.GetAttrs<float>("scale") : 1.0f;
+  bool log_softmax = instr->attrs.count("log_softmax") ? instr.GetAttrs<bool>("log_softmax") : false;
+
+  auto x = helper.ToFloat32(instr->inputs[0]);
+  if (scale != 1.0f) {
+    x = builder->Scale(x, scale);
+  }
+  if (instr->inputs.size() == 2UL && instr->inputs[1]->type.is_int(32)) {
+    // the columns of the packed mask whose bit is not set are masked out by -inf
+    auto keep = builder->BroadcastTo(builder->UnpackMask(instr->inputs[1], helper.x_shape.back()), helper.x_shape);
+    auto neg_inf =
+        builder->FillConstant(helper.x_shape, -std::numeric_limits<float>::infinity(), common::UniqName("neg_inf"));
+    x = builder->Select(keep, x, neg_inf);
+  } else if (instr->inputs.size() == 2UL) {
+    // the mask is broadcast to x by the AutoBroadcast pass
+    x = builder->Add(x, helper.ToFloat32(instr->inputs[1]));
+  }
+
+  auto shifted_and_sum = helper.ShiftAndSum(x);
+  auto& shifted        = shifted_and_sum.first;
+  auto& sum            = shifted_and_sum.second;
+  auto out = log_softmax ? builder->Subtract(shifted, builder->Log(sum)) : builder->Divide(builder->Exp(shifted), sum);
+
+  context.MapOutToOrigin(helper.FromFloat32(out), instr->outputs[0]);
+}
+
+// loss = -sum(one_hot(label) * log_softmax(logits)), the label out of [0, depth) gets no class and the loss is 0.
+void softmax_cross_entropy(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 2UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 2UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  FusedSoftmaxHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  int ignore_index = instr->attrs.count("ignore_index") ? instr.GetAttrs<int>("ignore_index") : -100;
+  int depth        = helper.x_shape.back();
+
+  auto shifted_and_sum = helper.ShiftAndSum(helper.ToFloat32(instr->inputs[0]));
+  auto log_softmax     = builder->Subtract(shifted_and_sum.first, builder->Log(shifted_and_sum.second));
+  auto softmax         = builder->Exp(log_softmax);
+
+  auto loss_shape   = helper.x_shape;
+  loss_shape.back() = 1;
+  std::vector<int> rows_shape(helper.x_shape.begin(), helper.x_shape.end() - 1);
+  auto label   = instr->inputs[1];
+  auto one_hot = builder->OneHot(builder->Reshape(label, rows_shape),
+                                 builder->FillConstant({1}, 1.0f, common::UniqName("one_hot_on"), "float32"),
+                                 builder->FillConstant({1}, 0.0f, common::UniqName("one_hot_off"), "float32"),
+                                 depth,
+                                 -1,
+                                 "float32");
+  auto loss = builder->Negative(builder->ReduceSum(builder->Multiply(one_hot, log_softmax), {helper.axis}, true));
+  if (ignore_index >= 0 && ignore_index < depth) {
+    auto ignore_value = builder->FillConstant(
+        loss_shape, ignore_index, common::UniqName("ignore_index"), common::Type2Str(label->type));
+    auto ignored = builder->Equal(builder->Reshape(label, loss_shape), ignore_value);
+    loss = builder->Select(
+        ignored, builder->FillConstant(loss_shape, 0.0f, common::UniqName("ignored_loss"), "float32"), loss);
+  }
+
+  context.MapOutToOrigin(helper.FromFloat32(softmax), instr->outputs[0]);
+  context.MapOutToOrigin(helper.FromFloat32(loss), instr->outputs[1]);
+}
+
+// The fused softmax ops are kept on NVGPU and computed by the online softmax kernel of the runtime through the
+// custom_call, instead of the reduce groups of the decomposed ops.
+#define FUSED_SOFTMAX_NVGPU_DECOMPOSER(op_type__)                                        \
+  void op_type__##_nvgpu(const Instruction& instr, const DecomposerContext& context) { \
+    if (UseSoftmaxCustomCall(#op_type__)) {                                              \
+      context.builder()->AppendInstruction(instr);                                       \
+      return;                                                                            \
+    }                                                                                    \
+    op_type__(instr, context);                                                           \
+  }
+
+FUSED_SOFTMAX_NVGPU_DECOMPOSER(fused_softmax)
+FUSED_SOFTMAX_NVGPU_DECOMPOSER(softmax_cross_entropy)
+#undef FUSED_SOFTMAX_NVGPU_DECOMPOSER
+
+}  // namespace decomposer
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(fused_softmax_decomposers) {
+  CINN_DECOMPOSER_REGISTER(
+      fused_softmax, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::fused_softmax);
+  CINN_DECOMPOSER_REGISTER(
+      fused_softmax, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::fused_softmax_nvgpu);
+  CINN_DECOMPOSER_REGISTER(
+      softmax_cross_entropy, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::softmax_cross_entropy);
+  CINN_DECOMPOSER_REGISTER(softmax_cross_entropy,
+                           ::cinn::common::DefaultNVGPUTarget(),
+                           cinn::frontend::decomposer::softmax_cross_entropy_nvgpu);
+  return true;
+}
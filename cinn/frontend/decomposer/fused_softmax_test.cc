@@ -0,0 +1,196 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+DECLARE_string(cinn_custom_call_deny_ops);
+
+namespace cinn::frontend {
+
+namespace {
+
+// Run the program on NVGPU, the fused softmax ops are computed by the runtime kernel unless they are denied for
+// custom_call. The label is the only int32 input.
+std::vector<std::vector<float>> RunSoftmaxProgram(Program* program,
+                                                  const std::unordered_map<std::string, std::vector<float>>& inputs,
+                                                  const std::vector<int>& label,
+                                                  const std::vector<std::string>& output_ids) {
+  auto target = common::DefaultNVGPUTarget();
+  RunDecomposer(program, target);
+
+  std::unordered_set<std::string> fetch_ids(output_ids.begin(), output_ids.end());
+  auto graph = std::make_shared<hlir::framework::Graph>(*program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+  for (auto& input : inputs) {
+    scope->Var<hlir::framework::Tensor>(input.first);
+    auto tensor = scope->GetTensor(input.first);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(input.second, tensor, target);
+  }
+  if (!label.empty()) {
+    scope->Var<hlir::framework::Tensor>("label");
+    auto tensor = scope->GetTensor("label");
+    tensor->mutable_data<int>(target);
+    CopyFromVector(label, tensor, target);
+  }
+  run_program->Execute();
+
+  std::vector<std::vector<float>> outputs(output_ids.size());
+  for (size_t i = 0; i < output_ids.size(); ++i) {
+    CopyToVector(scope->GetTensor(output_ids[i]), &outputs[i]);
+  }
+  return outputs;
+}
+
+bool HasOp(const Program& program, const std::string& op_type) {
+  for (size_t i = 0; i < program.size(); ++i) {
+    if (program[i]->op_type == op_type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Compute the log_softmax of each row in double.
+std::vector<double> ComputeLogSoftmax(const std::vector<float>& values, int rows, int cols) {
+  std::vector<double> out(rows * cols);
+  for (int i = 0; i < rows; ++i) {
+    double max_value = values[i * cols];
+    for (int j = 1; j < cols; ++j) {
+      max_value = std::max<double>(max_value, values[i * cols + j]);
+    }
+    double sum = 0.0;
+    for (int j = 0; j < cols; ++j) {
+      sum += std::exp(values[i * cols + j] - max_value);
+    }
+    for (int j = 0; j < cols; ++j) {
+      out[i * cols + j] = values[i * cols + j] - max_value - std::log(sum);
+    }
+  }
+  return out;
+}
+
+// Run the fused runtime kernel first and then the decomposed ops, and check both with the references.
+void CheckFusedAndDecomposed(NetBuilder* builder,
+                             const std::string& op_type,
+                             const std::unordered_map<std::string, std::vector<float>>& inputs,
+                             const std::vector<int>& label,
+                             const std::vector<std::string>& output_ids,
+                             const std::vector<std::vector<float>>& refs) {
+  auto fused_program = builder->Build();
+  auto fused_outs    = RunSoftmaxProgram(&fused_program, inputs, label, output_ids);
+  ASSERT_TRUE(HasOp(fused_program, op_type));
+
+  FLAGS_cinn_custom_call_deny_ops = op_type;
+  auto decomposed_program         = builder->Build();
+  auto decomposed_outs            = RunSoftmaxProgram(&decomposed_program, inputs, label, output_ids);
+  FLAGS_cinn_custom_call_deny_ops = "";
+  ASSERT_FALSE(HasOp(decomposed_program, op_type));
+
+  for (auto* outs : {&fused_outs, &decomposed_outs}) {
+    for (size_t i = 0; i < refs.size(); ++i) {
+      CheckOutput<float>(outs->at(i), refs[i], 1e-5, 1e-4);
+    }
+  }
+}
+
+// The mask [rows / 2, 1, cols] is broadcast along the middle dimension of x [rows / 2, 2, cols].
+void CheckFusedSoftmax(int rows, int cols, bool log_softmax) {
+  const float scale = 0.5f;
+  NetBuilder builder("fused_softmax");
+  auto x    = builder.CreateInput(Float(32), {rows / 2, 2, cols}, "x");
+  auto mask = builder.CreateInput(Float(32), {rows / 2, 1, cols}, "mask");
+  auto out  = builder.CustomInstr("fused_softmax", {x, mask}, {{"scale", scale}, {"log_softmax", log_softmax}})[0];
+
+  std::unordered_map<std::string, std::vector<float>> inputs;
+  InitRandomVector<float>(&inputs["x"], rows * cols, -10.0f, 10.0f, 1e-3);
+  InitRandomVector<float>(&inputs["mask"], rows / 2 * cols, -5.0f, 0.0f, 1e-3);
+  std::vector<float> values(rows * cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      values[i * cols + j] = inputs["x"][i * cols + j] * scale + inputs["mask"][i / 2 * cols + j];
+    }
+  }
+  auto log_probs = ComputeLogSoftmax(values, rows, cols);
+  std::vector<float> ref(rows * cols);
+  for (int i = 0; i < rows * cols; ++i) {
+    ref[i] = log_softmax ? log_probs[i] : std::exp(log_probs[i]);
+  }
+  CheckFusedAndDecomposed(&builder, "fused_softmax", inputs, {}, {out->id}, {ref});
+}
+
+// The label of every 3rd row is the ignore_index, whose loss is 0.
+void CheckSoftmaxCrossEntropy(int rows, int cols) {
+  const int ignore_index = 1;
+  NetBuilder builder("softmax_cross_entropy");
+  auto logits = builder.CreateInput(Float(32), {rows, cols}, "logits");
+  auto label  = builder.CreateInput(Int(32), {rows, 1}, "label");
+  auto outs   = builder.SoftmaxCrossEntropy(logits, label, ignore_index);
+
+  std::unordered_map<std::string, std::vector<float>> inputs;
+  InitRandomVector<float>(&inputs["logits"], rows * cols, -10.0f, 10.0f, 1e-3);
+  std::vector<int> labels;
+  InitRandomVector<int>(&labels, rows, 0, cols - 1, 1);
+  for (int i = 0; i < rows; i += 3) {
+    labels[i] = ignore_index;
+  }
+  auto log_probs = ComputeLogSoftmax(inputs["logits"], rows, cols);
+  std::vector<float> softmax(rows * cols), loss(rows);
+  for (int i = 0; i < rows * cols; ++i) {
+    softmax[i] = std::exp(log_probs[i]);
+  }
+  for (int i = 0; i < rows; ++i) {
+    loss[i] = labels[i] == ignore_index ? 0.0f : -log_probs[i * cols + labels[i]];
+  }
+  CheckFusedAndDecomposed(
+      &builder, "softmax_cross_entropy", inputs, labels, {outs[0]->id, outs[1]->id}, {softmax, loss});
+}
+
+}  // namespace
+
+// The short rows are computed by a warp each, the long rows by a block each, and the rows too long for the registers
+// are read from the global memory again.
+TEST(Decomposer, fused_softmax) {
+  for (int cols : {96, 1000, 4096, 40000}) {
+    CheckFusedSoftmax(6, cols, false);
+  }
+}
+
+TEST(Decomposer, fused_log_softmax) {
+  for (int cols : {96, 1000, 4096, 40000}) {
+    CheckFusedSoftmax(6, cols, true);
+  }
+}
+
+TEST(Decomposer, softmax_cross_entropy) {
+  for (int cols : {96, 1000, 40000}) {
+    CheckSoftmaxCrossEntropy(6, cols);
+  }
+}
+
+}  // namespace cinn::frontend
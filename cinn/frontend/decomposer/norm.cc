@@ -0,0 +1,235 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_use_custom_call);
+DECLARE_string(cinn_custom_call_deny_ops);
+
+namespace cinn {
+namespace frontend {
+namespace decomposer {
+
+// The norm ops are computed in float32 over the 2-D view [rows, cols] of the input, where the dimensions from
+// begin_norm_axis are flattened into the columns.
+struct NormHelper {
+  NormHelper(NetBuilder* net_builder, const Instruction& instr) {
+    builder = net_builder;
+    x_shape = instr->inputs[0]->shape;
+    x_type  = instr->inputs[0]->type;
+    epsilon = instr->attrs.count("epsilon") ? instr.GetAttrs<float>("epsilon") : 1e-5f;
+
+    int begin_norm_axis = instr.GetAttrs<int>("begin_norm_axis");
+    if (begin_norm_axis < 0) {
+      begin_norm_axis += x_shape.size();
+    }
+    for (int i = 0; i < x_shape.size(); ++i) {
+      if (i < begin_norm_axis) {
+        rows *= x_shape[i];
+      } else {
+        cols *= x_shape[i];
+      }
+    }
+
+    num_instructions = builder->size();
+    op_type          = instr->op_type;
+  }
+
+  ~NormHelper() {
+    VLOG(4) << op_type << " is decomposed to " << builder->size() - num_instructions << " instructions.";
+  }
+
+  // Cast the input to float32 and reshape it to [rows, cols].
+  Variable To2D(Variable x) {
+    if (!x->type.is_float(32)) {
+      x = builder->Cast(x, "float32");
+    }
+    return builder->Reshape(x, {rows, cols});
+  }
+
+  // Reshape the result back to the shape of the input and cast it to the dtype of the input.
+  Variable From2D(Variable y) {
+    y = builder->Reshape(y, x_shape);
+    if (!x_type.is_float(32)) {
+      y = builder->Cast(y, common::Type2Str(x_type));
+    }
+    return y;
+  }
+
+  Variable RowMean(Variable x) { return builder->Divide(builder->ReduceSum(x, {1}), Constant({rows}, cols)); }
+
+  Variable Constant(const std::vector<int>& shape, float value) {
+    return builder->FillConstant(shape, value, common::UniqName("norm_constant"), "float32");
+  }
+
+  Variable BroadcastRow(Variable row_stat) { return builder->BroadcastTo(row_stat, {rows, cols}, {0}); }
+
+  Variable BroadcastCol(Variable param) { return builder->BroadcastTo(param, {rows, cols}, {1}); }
+
+  NetBuilder* builder{nullptr};
+  std::vector<int> x_shape;
+  Type x_type;
+  float epsilon{1e-5f};
+  int rows{1};
+  int cols{1};
+  std::string op_type;
+  int num_instructions{0};
+};
+
+bool UseNormCustomCall(const std::string& op_type) {
+  auto deny_ops = utils::Split(FLAGS_cinn_custom_call_deny_ops, ";");
+  return FLAGS_cinn_use_custom_call && std::find(deny_ops.begin(), deny_ops.end(), op_type) == deny_ops.end();
+}
+
+void layer_norm(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 3UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 3UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  NormHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  // use `E[|x|^2] - |E[x]|^2` instead of `E[|x - E[x]|^2])` to compute variance
+  auto x        = helper.To2D(instr->inputs[0]);
+  auto mean     = helper.RowMean(x);
+  auto x2_mean  = helper.RowMean(builder->Multiply(x, builder->Identity(x)));
+  auto mean2    = builder->Multiply(mean, builder->Identity(mean));
+  auto variance = builder->Max(builder->Subtract(x2_mean, mean2), helper.Constant({helper.rows}, 0.0f));
+
+  auto inv_std = builder->Rsqrt(builder->Add(variance, helper.Constant({helper.rows}, helper.epsilon)));
+  auto x_hat   = builder->Multiply(builder->Subtract(x, helper.BroadcastRow(mean)), helper.BroadcastRow(inv_std));
+  auto y       = builder->Add(builder->Multiply(x_hat, helper.BroadcastCol(instr->inputs[1])),
+                        helper.BroadcastCol(instr->inputs[2]));
+
+  context.MapOutToOrigin(helper.From2D(y), instr->outputs[0]);
+  context.MapOutToOrigin(mean, instr->outputs[1]);
+  context.MapOutToOrigin(variance, instr->outputs[2]);
+}
+
+// dx = inv_std * (g - mean(g) - x_hat * mean(g * x_hat)), where g = dy * scale and x_hat = (x - mean) * inv_std.
+void layer_norm_grad(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 5UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 3UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  NormHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  auto x       = helper.To2D(instr->inputs[0]);
+  auto dy      = helper.To2D(instr->inputs[4]);
+  auto mean    = instr->inputs[2];
+  auto inv_std = builder->Rsqrt(builder->Add(instr->inputs[3], helper.Constant({helper.rows}, helper.epsilon)));
+  auto inv_std_2d = helper.BroadcastRow(inv_std);
+  auto x_hat      = builder->Multiply(builder->Subtract(x, helper.BroadcastRow(mean)), inv_std_2d);
+
+  auto g            = builder->Multiply(dy, helper.BroadcastCol(instr->inputs[1]));
+  auto mean_g       = helper.BroadcastRow(helper.RowMean(g));
+  auto mean_g_x_hat = helper.BroadcastRow(helper.RowMean(builder->Multiply(g, x_hat)));
+  auto dx           = builder->Multiply(
+      inv_std_2d, builder->Subtract(builder->Subtract(g, mean_g), builder->Multiply(x_hat, mean_g_x_hat)));
+
+  auto dscale = builder->ReduceSum(builder->Multiply(dy, x_hat), {0});
+  auto dbias  = builder->ReduceSum(dy, {0});
+
+  context.MapOutToOrigin(helper.From2D(dx), instr->outputs[0]);
+  context.MapOutToOrigin(dscale, instr->outputs[1]);
+  context.MapOutToOrigin(dbias, instr->outputs[2]);
+}
+
+void rms_norm(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 2UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 2UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  NormHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  auto x           = helper.To2D(instr->inputs[0]);
+  auto mean_square = helper.RowMean(builder->Multiply(x, builder->Identity(x)));
+  auto inv_rms     = builder->Rsqrt(builder->Add(mean_square, helper.Constant({helper.rows}, helper.epsilon)));
+  auto y           = builder->Multiply(builder->Multiply(x, helper.BroadcastRow(inv_rms)),
+                             helper.BroadcastCol(instr->inputs[1]));
+
+  context.MapOutToOrigin(helper.From2D(y), instr->outputs[0]);
+  context.MapOutToOrigin(inv_rms, instr->outputs[1]);
+}
+
+// dx = inv_rms * (g - x_hat * mean(g * x_hat)), where g = dy * scale and x_hat = x * inv_rms.
+void rms_norm_grad(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 4UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 2UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  NormHelper helper(context.builder(), instr);
+  auto* builder = context.builder();
+
+  auto x          = helper.To2D(instr->inputs[0]);
+  auto dy         = helper.To2D(instr->inputs[3]);
+  auto inv_rms_2d = helper.BroadcastRow(instr->inputs[2]);
+  auto x_hat      = builder->Multiply(x, inv_rms_2d);
+
+  auto g            = builder->Multiply(dy, helper.BroadcastCol(instr->inputs[1]));
+  auto mean_g_x_hat = helper.BroadcastRow(helper.RowMean(builder->Multiply(g, x_hat)));
+  auto dx           = builder->Multiply(inv_rms_2d, builder->Subtract(g, builder->Multiply(x_hat, mean_g_x_hat)));
+  auto dscale       = builder->ReduceSum(builder->Multiply(dy, x_hat), {0});
+
+  context.MapOutToOrigin(helper.From2D(dx), instr->outputs[0]);
+  context.MapOutToOrigin(dscale, instr->outputs[1]);
+}
+
+// The norm ops are kept on NVGPU and computed by the single-pass row kernels of the runtime through the custom_call,
+// instead of the several reduce groups of the decomposed ops.
+#define NORM_NVGPU_DECOMPOSER(op_type__)                                                 \
+  void op_type__##_nvgpu(const Instruction& instr, const DecomposerContext& context) { \
+    if (UseNormCustomCall(#op_type__)) {                                                 \
+      context.builder()->AppendInstruction(instr);                                       \
+      return;                                                                            \
+    }                                                                                    \
+    op_type__(instr, context);                                                           \
+  }
+
+NORM_NVGPU_DECOMPOSER(layer_norm)
+NORM_NVGPU_DECOMPOSER(layer_norm_grad)
+NORM_NVGPU_DECOMPOSER(rms_norm)
+NORM_NVGPU_DECOMPOSER(rms_norm_grad)
+#undef NORM_NVGPU_DECOMPOSER
+
+}  // namespace decomposer
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(norm_decomposers) {
+  CINN_DECOMPOSER_REGISTER(layer_norm, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::layer_norm);
+  CINN_DECOMPOSER_REGISTER(
+      layer_norm, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::layer_norm_nvgpu);
+  CINN_DECOMPOSER_REGISTER(
+      layer_norm_grad, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::layer_norm_grad);
+  CINN_DECOMPOSER_REGISTER(
+      layer_norm_grad, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::layer_norm_grad_nvgpu);
+  CINN_DECOMPOSER_REGISTER(rms_norm, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::rms_norm);
+  CINN_DECOMPOSER_REGISTER(rms_norm, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::rms_norm_nvgpu);
+  CINN_DECOMPOSER_REGISTER(
+      rms_norm_grad, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::rms_norm_grad);
+  CINN_DECOMPOSER_REGISTER(
+      rms_norm_grad, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::rms_norm_grad_nvgpu);
+  return true;
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+DECLARE_string(cinn_custom_call_deny_ops);
+
+namespace cinn::frontend {
+
+namespace {
+
+// Run the program on NVGPU, the norm ops are computed by the runtime kernels unless they are denied for custom_call.
+std::vector<std::vector<float>> RunNormProgram(Program* program,
+                                               const std::unordered_map<std::string, std::vector<float>>& inputs,
+                                               const std::vector<std::string>& output_ids) {
+  auto target = common::DefaultNVGPUTarget();
+  RunDecomposer(program, target);
+
+  std::unordered_set<std::string> fetch_ids(output_ids.begin(), output_ids.end());
+  auto graph = std::make_shared<hlir::framework::Graph>(*program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+  for (auto& input : inputs) {
+    scope->Var<hlir::framework::Tensor>(input.first);
+    auto tensor = scope->GetTensor(input.first);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(input.second, tensor, target);
+  }
+  run_program->Execute();
+
+  std::vector<std::vector<float>> outputs(output_ids.size());
+  for (size_t i = 0; i < output_ids.size(); ++i) {
+    CopyToVector(scope->GetTensor(output_ids[i]), &outputs[i]);
+  }
+  return outputs;
+}
+
+bool HasOp(const Program& program, const std::string& op_type) {
+  for (size_t i = 0; i < program.size(); ++i) {
+    if (program[i]->op_type == op_type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The reference of the layer_norm and its gradient, or of the rms_norm and its gradient when is_rms is true.
+void ComputeNormReference(const std::vector<float>& x,
+                          const std::vector<float>& scale,
+                          const std::vector<float>& bias,
+                          const std::vector<float>& dy,
+                          int rows,
+                          int cols,
+                          float epsilon,
+                          bool is_rms,
+                          std::vector<std::vector<float>>* refs) {
+  std::vector<float> y(rows * cols), dx(rows * cols), dscale(cols, 0.0f), dbias(cols, 0.0f);
+  for (int i = 0; i < rows; ++i) {
+    double mean = 0.0, square = 0.0;
+    for (int j = 0; j < cols; ++j) {
+      mean += x[i * cols + j];
+      square += x[i * cols + j] * x[i * cols + j];
+    }
+    mean /= cols;
+    square /= cols;
+    double inv_std = is_rms ? 1.0 / std::sqrt(square + epsilon) : 1.0 / std::sqrt(square - mean * mean + epsilon);
+    double shift   = is_rms ? 0.0 : mean;
+
+    double mean_g = 0.0, mean_g_x_hat = 0.0;
+    for (int j = 0; j < cols; ++j) {
+      double x_hat = (x[i * cols + j] - shift) * inv_std;
+      double g     = dy[i * cols + j] * scale[j];
+      y[i * cols + j] = x_hat * scale[j] + (is_rms ? 0.0 : bias[j]);
+      mean_g += g / cols;
+      mean_g_x_hat += g * x_hat / cols;
+      dscale[j] += dy[i * cols + j] * x_hat;
+      dbias[j] += dy[i * cols + j];
+    }
+    for (int j = 0; j < cols; ++j) {
+      double x_hat     = (x[i * cols + j] - shift) * inv_std;
+      double g         = dy[i * cols + j] * scale[j];
+      dx[i * cols + j] = inv_std * (g - (is_rms ? 0.0 : mean_g) - x_hat * mean_g_x_hat);
+    }
+  }
+  *refs = {y, dx, dscale};
+  if (!is_rms) {
+    refs->push_back(dbias);
+  }
+}
+
+void CheckNorm(int rows, int cols, bool is_rms) {
+  const float epsilon = 1e-5f;
+  NetBuilder builder(is_rms ? "rms_norm" : "layer_norm");
+  auto x     = builder.CreateInput(Float(32), {rows / 2, 2, cols}, "x");
+  auto scale = builder.CreateInput(Float(32), {cols}, "scale");
+  auto bias  = builder.CreateInput(Float(32), {cols}, "bias");
+  auto dy    = builder.CreateInput(Float(32), {rows / 2, 2, cols}, "dy");
+  std::vector<std::string> output_ids;
+  if (is_rms) {
+    auto outs  = builder.RMSNorm(x, scale, epsilon, 2);
+    auto grads = builder.RMSNormGrad(dy, x, scale, outs[1], 2);
+    output_ids = {outs[0]->id, grads[0]->id, grads[1]->id};
+  } else {
+    auto outs  = builder.LayerNorm(x, scale, bias, epsilon, 2);
+    auto grads = builder.LayerNormGrad(dy, x, scale, outs[1], outs[2], epsilon, 2);
+    output_ids = {outs[0]->id, grads[0]->id, grads[1]->id, grads[2]->id};
+  }
+
+  std::unordered_map<std::string, std::vector<float>> inputs;
+  InitRandomVector<float>(&inputs["x"], rows * cols, -1.0f, 1.0f, 1e-3);
+  InitRandomVector<float>(&inputs["scale"], cols, 0.5f, 1.5f, 1e-3);
+  InitRandomVector<float>(&inputs["bias"], cols, -1.0f, 1.0f, 1e-3);
+  InitRandomVector<float>(&inputs["dy"], rows * cols, -1.0f, 1.0f, 1e-3);
+  std::vector<std::vector<float>> refs;
+  ComputeNormReference(
+      inputs["x"], inputs["scale"], inputs["bias"], inputs["dy"], rows, cols, epsilon, is_rms, &refs);
+
+  // the fused runtime kernels first and then the decomposed ops
+  auto fused_program = builder.Build();
+  auto fused_outs    = RunNormProgram(&fused_program, inputs, output_ids);
+  ASSERT_TRUE(HasOp(fused_program, is_rms ? "rms_norm" : "layer_norm"));
+
+  FLAGS_cinn_custom_call_deny_ops = is_rms ? "rms_norm;rms_norm_grad" : "layer_norm;layer_norm_grad";
+  auto decomposed_program         = builder.Build();
+  auto decomposed_outs            = RunNormProgram(&decomposed_program, inputs, output_ids);
+  FLAGS_cinn_custom_call_deny_ops = "";
+  ASSERT_FALSE(HasOp(decomposed_program, is_rms ? "rms_norm" : "layer_norm"));
+
+  for (auto* outs : {&fused_outs, &decomposed_outs}) {
+    for (size_t i = 0; i < refs.size(); ++i) {
+      // the gradients of the parameters are summed over the rows
+      float atol = i < 2 ? 1e-4f : 1e-4f * rows;
+      CheckOutput<float>(outs->at(i), refs[i], atol, 1e-3);
+    }
+  }
+}
+
+}  // namespace
+
+// The short rows are normalized by a warp each, the long rows by a block each, and the rows too long for the
+// registers are read from the global memory again.
+TEST(Decomposer, layer_norm) {
+  for (int cols : {96, 1000, 4096, 40000}) {
+    CheckNorm(6, cols, false);
+  }
+}
+
+TEST(Decomposer, rms_norm) {
+  for (int cols : {96, 1000, 4096, 40000}) {
+    CheckNorm(6, cols, true);
+  }
+}
+
+}  // namespace cinn::frontend
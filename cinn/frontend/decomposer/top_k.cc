@@ -12,9 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <string>
+
 #include "cinn/frontend/decomposer_registry.h"
 #include "cinn/frontend/syntax.h"
 
+DECLARE_bool(cinn_use_custom_call);
+DECLARE_string(cinn_custom_call_deny_ops);
+
 namespace cinn {
 namespace frontend {
 namespace decomposer {
@@ -44,11 +51,22 @@ void top_k(const Instruction& instr, const DecomposerContext& context) {
   context.MapOutToOrigin(argsort_out, indices);
 }
 
+// The top_k is selected by the block-level kernel of the runtime through the custom_call on NVGPU, which is much
+// faster than sorting the whole axis.
+void top_k_nvgpu(const Instruction& instr, const DecomposerContext& context) {
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("top_k") == std::string::npos) {
+    context.builder()->AppendInstruction(instr);
+    return;
+  }
+  top_k(instr, context);
+}
+
 }  // namespace decomposer
 }  // namespace frontend
 }  // namespace cinn
 
 CINN_REGISTER_HELPER(top_k_decomposer) {
-  CINN_DECOMPOSER_REGISTER(top_k, cinn::frontend::decomposer::top_k);
+  CINN_DECOMPOSER_REGISTER(top_k, ::cinn::common::DefaultHostTarget(), cinn::frontend::decomposer::top_k);
+  CINN_DECOMPOSER_REGISTER(top_k, ::cinn::common::DefaultNVGPUTarget(), cinn::frontend::decomposer::top_k_nvgpu);
   return true;
 }
@@ -14,7 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <numeric>
+
 #include "cinn/frontend/decomposer/test_helper.h"
+#include "cinn/runtime/flags.h"
 
 namespace cinn::frontend {
 
@@ -33,6 +37,7 @@ TEST(Decomposer, top_k_decomposer) {
   RunDecomposer(&program, target);
 
   auto graph = std::make_shared<hlir::framework::Graph>(program, output_names, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
   hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
   hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
 
@@ -52,4 +57,58 @@ TEST(Decomposer, top_k_decomposer) {
   run_program->Execute();
 }
 
+// The top_k is kept and computed by the runtime kernels on NVGPU: the small k takes the block-level selection and the
+// large k takes the radix sort of the long axis.
+TEST(Decomposer, top_k_nvgpu_kernel) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  const int rows = 4, cols = 3000;
+  for (int k : {5, 40}) {
+    NetBuilder net_builder("top_k_nvgpu_kernel");
+    auto x = net_builder.CreateInput(Float(32), {rows, cols}, "x");
+    auto y = net_builder.TopK(x, k, -1, true);
+    std::unordered_set<std::string> output_names{y[0]->id, y[1]->id};
+    auto program = net_builder.Build();
+
+    auto target = common::DefaultNVGPUTarget();
+    RunDecomposer(&program, target);
+    ASSERT_EQ(program[program.size() - 1]->op_type, "top_k");
+
+    auto graph = std::make_shared<hlir::framework::Graph>(program, output_names, target);
+    hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+    hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+    hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+    auto scope = BuildScope(target, graph);
+    hlir::framework::GraphCompiler gc(target, scope, graph);
+    auto run_program = gc.Build();
+
+    std::vector<float> x_data(rows * cols);
+    InitRandomVector<float>(&x_data, rows * cols, 0.0f, 1.0f, 1e-3);
+    scope->Var<hlir::framework::Tensor>("x");
+    auto x_tensor = scope->GetTensor("x");
+    x_tensor->mutable_data<float>(target);
+    CopyFromVector(x_data, x_tensor, target);
+    run_program->Execute();
+
+    std::vector<float> values;
+    std::vector<int64_t> indices;
+    CopyToVector(scope->GetTensor(y[0]->id), &values);
+    CopyToVector(scope->GetTensor(y[1]->id), &indices);
+    for (int i = 0; i < rows; ++i) {
+      // the ties are taken in the order of the indices
+      std::vector<int> order(cols);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return x_data[i * cols + a] > x_data[i * cols + b];
+      });
+      for (int j = 0; j < k; ++j) {
+        ASSERT_EQ(indices[i * k + j], order[j]) << "k=" << k << ", i=" << i << ", j=" << j;
+        ASSERT_EQ(values[i * k + j], x_data[i * cols + order[j]]) << "k=" << k << ", i=" << i << ", j=" << j;
+      }
+    }
+  }
+}
+
 }  // namespace cinn::frontend
@@ -27,3 +27,5 @@ CINN_USE_REGISTER(batch_norm_decomposer)
 CINN_USE_REGISTER(batch_norm_train_decomposer)
 CINN_USE_REGISTER(batch_norm_grad_decomposer)
 CINN_USE_REGISTER(top_k_decomposer)
+CINN_USE_REGISTER(norm_decomposers)
+CINN_USE_REGISTER(fused_softmax_decomposers)
@@ -0,0 +1,178 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/dynamic_batcher.h"
+
+#include <cstring>
+#include <utility>
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+// The number of the slices along the dynamic axis before it, and the bytes of a slice.
+std::pair<size_t, size_t> GetAxisLayout(const hlir::framework::Tensor& tensor, const std::string& name, int axis) {
+  auto& shape = tensor->shape().data();
+  CHECK(axis >= 0 && axis < shape.size()) << "The dynamic axis of " << name << " is out of range";
+  size_t outer = 1;
+  for (int idx = 0; idx < axis; ++idx) {
+    outer *= shape[idx];
+  }
+  size_t slice = tensor->type().bytes();
+  for (int idx = axis + 1; idx < shape.size(); ++idx) {
+    slice *= shape[idx];
+  }
+  return {outer, slice};
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(std::shared_ptr<BucketedComputation> computation, const Config& config)
+    : computation_(std::move(computation)), config_(config) {
+  CHECK(computation_) << "The DynamicBatcher needs a BucketedComputation to run the batches";
+  CHECK_GT(config_.max_batch_size, 0) << "The largest batch should be positive";
+  CHECK_LE(config_.max_batch_size, computation_->Buckets().back())
+      << "The largest batch should not exceed the largest bucket";
+  CHECK_GE(config_.max_delay_us, 0) << "The delay of the batching should not be negative";
+  worker_ = std::thread([this]() { Serve(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+std::future<void> DynamicBatcher::Submit(const std::map<std::string, const void*>& inputs,
+                                         const std::map<std::string, void*>& outputs,
+                                         int size) {
+  CHECK_GT(size, 0) << "The size of the request should be positive";
+  CHECK_LE(size, config_.max_batch_size) << "The request of size " << size << " exceeds the largest batch";
+  auto request         = std::make_unique<Request>();
+  request->inputs      = inputs;
+  request->outputs     = outputs;
+  request->size        = size;
+  request->queued_time = std::chrono::steady_clock::now();
+  auto future          = request->done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CHECK(!stopped_) << "The DynamicBatcher is stopped";
+    queued_size_ += size;
+    requests_.push_back(std::move(request));
+  }
+  cv_.notify_all();
+  return future;
+}
+
+int64_t DynamicBatcher::NumBatches() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return num_batches_;
+}
+
+void DynamicBatcher::Serve() {
+  while (true) {
+    std::vector<std::unique_ptr<Request>> batch;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return stopped_ || !requests_.empty(); });
+      // drain the queued requests before exiting
+      if (requests_.empty()) return;
+      // wait for the others to join the batch of the first request, unless stopped
+      auto deadline = requests_.front()->queued_time + std::chrono::microseconds(config_.max_delay_us);
+      cv_.wait_until(lock, deadline, [this]() { return stopped_ || queued_size_ >= config_.max_batch_size; });
+      int total = 0;
+      while (!requests_.empty() && total + requests_.front()->size <= config_.max_batch_size) {
+        total += requests_.front()->size;
+        batch.push_back(std::move(requests_.front()));
+        requests_.pop_front();
+      }
+      queued_size_ -= total;
+      ++num_batches_;
+    }
+    RunBatch(&batch);
+  }
+}
+
+void DynamicBatcher::RunBatch(std::vector<std::unique_ptr<Request>>* batch) {
+  int total = 0;
+  for (auto& request : *batch) {
+    total += request->size;
+  }
+  int bucket       = 0;
+  auto computation = computation_->GetComputation(total, &bucket);
+  VLOG(4) << "Run a batch of " << batch->size() << " requests of total size " << total << " by the bucket " << bucket;
+
+  // concatenate the inputs of the requests along their dynamic axes
+  const auto& dynamic_axes = computation_->GetConfig().dynamic_axes;
+  std::vector<std::vector<uint8_t>> buffers;
+  buffers.reserve(batch->front()->inputs.size());
+  std::map<std::string, const void*> inputs;
+  for (auto& item : batch->front()->inputs) {
+    auto axis = dynamic_axes.find(item.first);
+    CHECK(axis != dynamic_axes.end()) << "The input " << item.first << " has no dynamic axis to be batched along";
+    auto layout = GetAxisLayout(computation->GetTensor(item.first), item.first, axis->second);
+    buffers.emplace_back(layout.first * total * layout.second);
+    uint8_t* dst = buffers.back().data();
+    int offset   = 0;
+    for (auto& request : *batch) {
+      auto src = request->inputs.find(item.first);
+      CHECK(src != request->inputs.end()) << "The input " << item.first << " is missing in a request";
+      size_t row = request->size * layout.second;
+      for (size_t idx = 0; idx < layout.first; ++idx) {
+        std::memcpy(dst + (idx * total + offset) * layout.second,
+                    static_cast<const uint8_t*>(src->second) + idx * row,
+                    row);
+      }
+      offset += request->size;
+    }
+    inputs[item.first] = dst;
+  }
+  computation_->FeedInputs(computation.get(), bucket, total, inputs);
+  computation->Execute();
+
+  // split the outputs of the bucket back to the requests, the padding is dropped
+  for (auto& item : config_.output_axes) {
+    auto tensor = computation->GetTensor(item.first);
+    auto layout = GetAxisLayout(tensor, item.first, item.second);
+    CHECK_EQ(tensor->shape().data()[item.second], bucket)
+        << "The dynamic dimension of the output " << item.first << " is not of the bucket size";
+    std::vector<uint8_t> output(tensor->shape().numel() * tensor->type().bytes());
+    computation->GetTensorData(tensor, output.data(), output.size());
+    int offset = 0;
+    for (auto& request : *batch) {
+      auto dst = request->outputs.find(item.first);
+      if (dst != request->outputs.end()) {
+        size_t row = request->size * layout.second;
+        for (size_t idx = 0; idx < layout.first; ++idx) {
+          std::memcpy(static_cast<uint8_t*>(dst->second) + idx * row,
+                      output.data() + (idx * bucket + offset) * layout.second,
+                      row);
+        }
+      }
+      offset += request->size;
+    }
+  }
+  for (auto& request : *batch) {
+    request->done.set_value();
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
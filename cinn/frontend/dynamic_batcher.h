@@ -0,0 +1,103 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/frontend/bucketed_computation.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * DynamicBatcher serves the concurrent small requests of a BucketedComputation as batches, so that a run fills the
+ * device instead of a request of a few rows.
+ *
+ * The requests are queued by Submit from any thread. A worker thread takes the requests in their order into a batch
+ * until their total size reaches Config::max_batch_size, or Config::max_delay_us passed since the first request of the
+ * batch was queued. The inputs of the batch are concatenated along their dynamic axes of the BucketedComputation, run
+ * by the bucket of the total size, and the outputs are split along Config::output_axes back to the buffers of the
+ * requests. The batches are run one by one, so a bucket is never run concurrently.
+ */
+class DynamicBatcher {
+ public:
+  struct Config {
+    // the largest total size of the requests in a batch, which should not exceed the largest bucket
+    int max_batch_size = 32;
+    // the longest time a request waits for the others to join its batch
+    int64_t max_delay_us = 1000;
+    // the dynamic axis of each output returned to the requests
+    std::unordered_map<std::string, int> output_axes;
+  };
+
+  DynamicBatcher(std::shared_ptr<BucketedComputation> computation, const Config& config);
+  //! The queued requests are served before the worker exits.
+  ~DynamicBatcher();
+
+  /**
+   * Queue a request of size \p size, the buffers should be kept valid until the returned future is ready.
+   * @param inputs The host data of the inputs, whose dynamic dimensions are of size \p size.
+   * @param outputs The host buffers to receive the outputs listed in Config::output_axes, whose dynamic dimensions are
+   * of size \p size.
+   * @param size The size of the request along the dynamic dimension, such as its number of samples.
+   * @return The future which is ready once the outputs are written.
+   */
+  std::future<void> Submit(const std::map<std::string, const void*>& inputs,
+                           const std::map<std::string, void*>& outputs,
+                           int size = 1);
+
+  //! The number of the batches run, to observe how the requests are coalesced.
+  int64_t NumBatches() const;
+
+ private:
+  struct Request {
+    std::map<std::string, const void*> inputs;
+    std::map<std::string, void*> outputs;
+    int size;
+    std::chrono::steady_clock::time_point queued_time;
+    std::promise<void> done;
+  };
+
+  void Serve();
+  void RunBatch(std::vector<std::unique_ptr<Request>>* batch);
+
+  std::shared_ptr<BucketedComputation> computation_;
+  Config config_;
+
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> requests_;
+  // the total size of the queued requests
+  int queued_size_{0};
+  int64_t num_batches_{0};
+  bool stopped_{false};
+  std::thread worker_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(DynamicBatcher);
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/dynamic_batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace cinn {
+namespace frontend {
+
+TEST(DynamicBatcher, CoalesceRequests) {
+  auto builder = [](int bucket) {
+    NetBuilder net_builder("batched_add");
+    auto x = net_builder.CreateInput(Float(32), {bucket, 4}, "x");
+    auto y = net_builder.CreateInput(Float(32), {4, bucket}, "y");
+    auto z = net_builder.Add(x, net_builder.Transpose(y, {1, 0}));
+    z.set_id("z");
+    return net_builder.Build();
+  };
+  BucketedComputation::Config bucket_config;
+  bucket_config.min_size              = 1;
+  bucket_config.max_size              = 8;
+  bucket_config.dynamic_axes          = {{"x", 0}, {"y", 1}};
+  bucket_config.compile_in_background = false;
+  auto computation = std::make_shared<BucketedComputation>(common::DefaultHostTarget(), builder, bucket_config);
+
+  DynamicBatcher::Config config;
+  config.max_batch_size = 6;
+  // long enough for all the requests to be queued
+  config.max_delay_us = 200000;
+  config.output_axes  = {{"z", 0}};
+  DynamicBatcher batcher(computation, config);
+
+  // the requests of sizes 1, 2 and 3 fill a batch, the last one is run alone after the delay
+  const std::vector<int> sizes = {1, 2, 3, 2};
+  std::vector<std::vector<float>> xs, ys, outs;
+  std::vector<std::future<void>> futures;
+  xs.reserve(sizes.size());
+  ys.reserve(sizes.size());
+  outs.reserve(sizes.size());
+  for (int size : sizes) {
+    xs.emplace_back(size * 4);
+    ys.emplace_back(size * 4);
+    outs.emplace_back(size * 4, -1.f);
+    for (int idx = 0; idx < size * 4; ++idx) {
+      xs.back()[idx] = futures.size() * 100 + idx;
+      // y is [4, size], the transpose of x
+      ys.back()[(idx % 4) * size + idx / 4] = 2 * idx;
+    }
+    futures.push_back(
+        batcher.Submit({{"x", xs.back().data()}, {"y", ys.back().data()}}, {{"z", outs.back().data()}}, size));
+  }
+  for (int req = 0; req < sizes.size(); ++req) {
+    futures[req].get();
+    for (int idx = 0; idx < sizes[req] * 4; ++idx) {
+      ASSERT_FLOAT_EQ(outs[req][idx], req * 100 + 3 * idx);
+    }
+  }
+  ASSERT_EQ(batcher.NumBatches(), 2);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/inference_pipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef CINN_WITH_CUDA
+#include "cinn/backends/cuda_util.h"
+#endif
+
+namespace cinn {
+namespace frontend {
+
+InferencePipeline::InferencePipeline(std::shared_ptr<CinnComputation> computation, int depth)
+    : computation_(std::move(computation)), target_(computation_->GetTarget()) {
+  CHECK_GT(depth, 0) << "The depth of the pipeline should be positive";
+  slots_.resize(depth);
+  for (auto& slot : slots_) {
+    slot.context = computation_->CreateExecutionContext();
+  }
+  if (target_.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    for (auto* stream : {&upload_stream_, &compute_stream_, &download_stream_}) {
+      cudaStream_t cuda_stream;
+      CUDA_CALL(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+      *stream = cuda_stream;
+    }
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  }
+}
+
+InferencePipeline::~InferencePipeline() {
+  Synchronize();
+#ifdef CINN_WITH_CUDA
+  for (auto* stream : {upload_stream_, compute_stream_, download_stream_}) {
+    if (stream) {
+      CUDA_CALL(cudaStreamDestroy(static_cast<cudaStream_t>(stream)));
+    }
+  }
+#endif
+}
+
+std::shared_ptr<TransferEvent> InferencePipeline::Submit(const std::map<std::string, const void*>& inputs,
+                                                         const std::map<std::string, void*>& outputs) {
+  return SubmitRows(inputs, outputs, -1);
+}
+
+namespace {
+// the bytes of the leading rows of the tensor, or all of it if rows is negative
+size_t GetRowsBytes(const hlir::framework::Tensor& tensor, int rows) {
+  size_t bytes = tensor->shape().numel() * tensor->type().bytes();
+  if (rows < 0) {
+    return bytes;
+  }
+  return bytes / tensor->shape().data()[0] * rows;
+}
+}  // namespace
+
+std::shared_ptr<TransferEvent> InferencePipeline::SubmitRows(const std::map<std::string, const void*>& inputs,
+                                                             const std::map<std::string, void*>& outputs,
+                                                             int rows) {
+  auto& slot = slots_[next_slot_];
+  next_slot_ = (next_slot_ + 1) % slots_.size();
+  // the tensors of the context are overwritten only after its previous request is done
+  if (slot.done) {
+    slot.done->Synchronize();
+  }
+
+  for (auto& input : inputs) {
+    CHECK(slot.context->IsPrivate(input.first)) << "The variable [" << input.first << "] is not an input";
+    auto tensor = slot.context->GetTensor(input.first);
+    CopyToDeviceAsync(target_,
+                      tensor->mutable_data(target_, tensor->type()),
+                      input.second,
+                      GetRowsBytes(tensor, rows),
+                      upload_stream_);
+  }
+  TransferEvent(target_, upload_stream_).WaitOn(compute_stream_);
+
+  slot.context->Execute(compute_stream_);
+  TransferEvent(target_, compute_stream_).WaitOn(download_stream_);
+
+  for (auto& output : outputs) {
+    auto tensor = slot.context->GetTensor(output.first);
+    CopyToHostAsync(target_, output.second, tensor->buffer()->memory, GetRowsBytes(tensor, rows), download_stream_);
+  }
+  slot.done = std::make_shared<TransferEvent>(target_, download_stream_);
+  return slot.done;
+}
+
+void InferencePipeline::RunChunked(const std::map<std::string, const void*>& inputs,
+                                   const std::map<std::string, void*>& outputs,
+                                   int batch_size) {
+  CHECK_GT(batch_size, 0) << "The batch size should be positive";
+  // the chunk is the compiled batch, the leading dimension of all the inputs and the outputs
+  auto& context  = slots_.front().context;
+  int chunk_size = -1;
+  std::map<std::string, size_t> row_bytes;
+  auto add_variable = [&](const std::string& name) {
+    auto tensor       = context->GetTensor(name);
+    const auto& shape = tensor->shape().data();
+    CHECK(!shape.empty() && shape[0] > 0) << "The variable [" << name << "] has no batch dimension";
+    CHECK(chunk_size < 0 || shape[0] == chunk_size)
+        << "The batch dimension " << shape[0] << " of [" << name << "] differs from the others " << chunk_size;
+    chunk_size      = shape[0];
+    row_bytes[name] = GetRowsBytes(tensor, 1);
+  };
+  for (auto& input : inputs) {
+    add_variable(input.first);
+  }
+  for (auto& output : outputs) {
+    add_variable(output.first);
+  }
+  CHECK_GT(chunk_size, 0) << "No input or output to run in chunks";
+
+  VLOG(3) << "Run " << batch_size << " rows in chunks of " << chunk_size << " rows";
+  for (int begin = 0; begin < batch_size; begin += chunk_size) {
+    int rows = std::min(chunk_size, batch_size - begin);
+    std::map<std::string, const void*> chunk_inputs;
+    for (auto& input : inputs) {
+      chunk_inputs[input.first] = static_cast<const uint8_t*>(input.second) + begin * row_bytes.at(input.first);
+    }
+    std::map<std::string, void*> chunk_outputs;
+    for (auto& output : outputs) {
+      chunk_outputs[output.first] = static_cast<uint8_t*>(output.second) + begin * row_bytes.at(output.first);
+    }
+    // the chunks of different slots overlap their copies with the executions of each other
+    SubmitRows(chunk_inputs, chunk_outputs, rows);
+  }
+  Synchronize();
+}
+
+void InferencePipeline::Synchronize() {
+  for (auto& slot : slots_) {
+    if (slot.done) {
+      slot.done->Synchronize();
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/frontend/computation.h"
+#include "cinn/hlir/framework/execution_context.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * InferencePipeline overlaps the copies of the inputs and the outputs with the execution of the other requests in a
+ * streaming inference loop.
+ *
+ * It holds \p depth execution contexts of one computation, and the n-th request is served by the context n % depth.
+ * The inputs of a request are copied to the device on the upload stream, the program is executed on the compute
+ * stream after the upload, and the outputs are copied back on the download stream after the execution, so that the
+ * upload of the request n + 1 and the download of the request n - 1 overlap with the execution of the request n.
+ * The copies go through the pinned staging pool, so the host buffers of the inputs can be reused once Submit returns.
+ */
+class InferencePipeline {
+ public:
+  /**
+   * @param computation The compiled computation, the kernels and the weights of which are shared by the contexts.
+   * @param depth The number of the requests in flight, 2 for double buffering.
+   */
+  explicit InferencePipeline(std::shared_ptr<CinnComputation> computation, int depth = 2);
+  ~InferencePipeline();
+
+  /**
+   * Submit a request, it blocks only if the context of the request is still used by the request submitted \p depth
+   * times before.
+   * @param inputs The host data of the inputs, by the names of the variables.
+   * @param outputs The host buffers to receive the outputs, by the names of the variables.
+   * @return The event which completes once the outputs are written.
+   */
+  std::shared_ptr<TransferEvent> Submit(const std::map<std::string, const void*>& inputs,
+                                        const std::map<std::string, void*>& outputs);
+
+  /**
+   * Run the inputs with \p batch_size rows, which may be larger than the compiled batch and the memory of the device,
+   * in chunks of the compiled batch streamed through the pipeline, and gather the outputs into the host buffers. All
+   * the inputs and the outputs are batch-major with the same compiled batch, and their rows are independent, the last
+   * chunk is run on the compiled batch with only its rows copied. It blocks until the outputs are written.
+   * @param inputs The host data of the inputs with \p batch_size rows, by the names of the variables.
+   * @param outputs The host buffers to receive the outputs with \p batch_size rows, by the names of the variables.
+   */
+  void RunChunked(const std::map<std::string, const void*>& inputs,
+                  const std::map<std::string, void*>& outputs,
+                  int batch_size);
+
+  //! Block until all the submitted requests are done.
+  void Synchronize();
+
+ private:
+  // submit a request copying the leading \p rows rows of the inputs and the outputs, or all of them if it is negative
+  std::shared_ptr<TransferEvent> SubmitRows(const std::map<std::string, const void*>& inputs,
+                                            const std::map<std::string, void*>& outputs,
+                                            int rows);
+
+  struct Slot {
+    std::unique_ptr<hlir::framework::ExecutionContext> context;
+    std::shared_ptr<TransferEvent> done;
+  };
+
+  std::shared_ptr<CinnComputation> computation_;
+  Target target_;
+  std::vector<Slot> slots_;
+  int next_slot_{0};
+  // cudaStream_t, hold as void* to not expose the CUDA headers
+  void* upload_stream_{nullptr};
+  void* compute_stream_{nullptr};
+  void* download_stream_{nullptr};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(InferencePipeline);
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,91 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/inference_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "cinn/common/target.h"
+
+namespace cinn {
+namespace frontend {
+
+void RunPipeline(const Target& target) {
+  NetBuilder builder("inference_pipeline");
+  auto x = builder.CreateInput(Float(32), {4, 8}, "x");
+  auto w = builder.FillConstant({4, 8}, -1.f, "w", "float32");
+  auto y = builder.Relu(builder.Add(x, w));
+
+  auto computation = CinnComputation::BuildAndCompile(target, builder, CinnComputation::DefaultCompileOptions(), {y});
+
+  // more requests than the depth, so that the contexts are reused
+  const int num_requests = 5;
+  std::vector<std::vector<float>> xs(num_requests, std::vector<float>(32));
+  std::vector<std::vector<float>> ys(num_requests, std::vector<float>(32));
+  std::vector<std::shared_ptr<TransferEvent>> events;
+  {
+    InferencePipeline pipeline(computation, 2);
+    for (int i = 0; i < num_requests; ++i) {
+      for (int j = 0; j < 32; ++j) {
+        xs[i][j] = static_cast<float>(i + j % 3);
+      }
+      events.push_back(pipeline.Submit({{"x", xs[i].data()}}, {{y->id, ys[i].data()}}));
+    }
+    events.back()->Synchronize();
+  }
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_TRUE(events[i]->Query());
+    for (int j = 0; j < 32; ++j) {
+      ASSERT_FLOAT_EQ(ys[i][j], std::max(xs[i][j] - 1.f, 0.f));
+    }
+  }
+}
+
+void RunChunked(const Target& target) {
+  NetBuilder builder("inference_pipeline_chunked");
+  auto x = builder.CreateInput(Float(32), {4, 8}, "x");
+  auto y = builder.Scale(x, 2.f, 1.f);
+
+  auto computation = CinnComputation::BuildAndCompile(target, builder, CinnComputation::DefaultCompileOptions(), {y});
+
+  // 11 rows are run in the chunks of 4, 4 and 3 rows
+  const int batch_size = 11;
+  std::vector<float> xs(batch_size * 8);
+  std::vector<float> ys(batch_size * 8, 0.f);
+  for (int i = 0; i < xs.size(); ++i) {
+    xs[i] = static_cast<float>(i);
+  }
+  InferencePipeline pipeline(computation, 2);
+  pipeline.RunChunked({{"x", xs.data()}}, {{y->id, ys.data()}}, batch_size);
+  for (int i = 0; i < xs.size(); ++i) {
+    ASSERT_FLOAT_EQ(ys[i], xs[i] * 2.f + 1.f);
+  }
+}
+
+TEST(InferencePipeline, Host) { RunPipeline(common::DefaultHostTarget()); }
+
+TEST(InferencePipeline, HostChunked) { RunChunked(common::DefaultHostTarget()); }
+
+#ifdef CINN_WITH_CUDA
+TEST(InferencePipeline, NVGPU) { RunPipeline(common::DefaultNVGPUTarget()); }
+
+TEST(InferencePipeline, NVGPUChunked) { RunChunked(common::DefaultNVGPUTarget()); }
+#endif
+
+}  // namespace frontend
+}  // namespace cinn
@@ -133,6 +133,11 @@ std::shared_ptr<hlir::framework::Scope> Interpreter::GetScope() {
   return impl_->scope_;
 }
 
+hlir::framework::Program* Interpreter::GetRuntimeProgram() {
+  CHECK(impl_->runtime_program_) << "The model is not loaded yet";
+  return impl_->runtime_program_.get();
+}
+
 Interpreter::Interpreter(const std::vector<std::string>& input_names,
                          const std::vector<hlir::framework::shape_t>& input_shapes)
     : impl_(new Impl(input_names, input_shapes)) {}
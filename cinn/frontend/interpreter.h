@@ -55,6 +55,9 @@ class Interpreter final {
 
   std::shared_ptr<hlir::framework::Scope> GetScope();
 
+  //! The runtime program built from the model, which is owned by the interpreter.
+  hlir::framework::Program* GetRuntimeProgram();
+
   ~Interpreter();
 
  private:
@@ -14,11 +14,15 @@
 
 #include "cinn/frontend/net_builder.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/control_flow.h"
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/runtime/flags.h"
 #include "cinn/utils/functional.h"
@@ -37,7 +41,7 @@ using utils::ShapeType;
 NetBuilder::NetBuilder(const std::string& name) : name_(name) {}
 
 Program NetBuilder::Build(bool in_reverse) {
-  utils::RecordEvent("NetBuilder::Build", utils::EventType::kProgram);
+  utils::RecordEvent record_event("NetBuilder::Build", utils::EventType::kProgram);
   std::vector<Instruction> instrs;
   if (in_reverse) {
     instrs.reserve(instrs_.size());
@@ -56,8 +60,9 @@ Program NetBuilder::Build(bool in_reverse) {
 void NetBuilder::InferShape(Instruction instr) const {
   using ShapeFunc           = std::function<std::vector<ShapeType>(const std::vector<ShapeType>&, const AttributeMap&)>;
   using TypeFunc            = std::function<std::vector<Type>(const std::vector<Type>&, const AttributeMap&)>;
-  const auto& op_infershape = Operator::GetAttrs<ShapeFunc>("infershape");
-  const auto& op_inferdtype = Operator::GetAttrs<TypeFunc>("inferdtype");
+  // the attributes of the registry are looked up once, they are never moved after registered
+  static const auto& op_infershape = Operator::GetAttrs<ShapeFunc>("infershape");
+  static const auto& op_inferdtype = Operator::GetAttrs<TypeFunc>("inferdtype");
 
   size_t size = instr->inputs.size();
   std::vector<ShapeType> in_shapes(size);
@@ -83,16 +88,14 @@ void NetBuilder::InferShape(Instruction instr) const {
 }
 
 const std::vector<Variable>& NetBuilder::CustomInstr(const std::string& type,
-                                                     const std::vector<Variable>& inputs,
-                                                     const AttributeMap& attrs) {
-  Instruction instr(type, inputs);
-  for (auto& kv : attrs) {
-    instr.SetAttr(kv.first, kv.second);
-  }
-  utils::RecordEvent("NetBuilder." + type, utils::EventType::kProgram);
+                                                     std::vector<Variable> inputs,
+                                                     AttributeMap attrs) {
+  Instruction instr(type, std::move(inputs));
+  instr.SetAttrs(std::move(attrs));
+  utils::RecordEvent record_event("NetBuilder." + type, utils::EventType::kProgram);
   InferShape(instr);
-  AppendInstruction(instr);
-  return instr.GetOutputs();
+  instrs_.emplace_back(std::move(instr));
+  return instrs_.back().GetOutputs();
 }
 
 Variable NetBuilder::BinaryOp(const std::string& op_type, const Variable& lhs, const Variable& rhs, int axis) {
@@ -444,6 +447,12 @@ Variable NetBuilder::BitcastConvert(const Variable& operand, const std::string&
   return CustomInstr("bitcast_convert", {operand}, {{"dtype", dtype}, {"input_data_type", input_data_type}}).front();
 }
 
+Variable NetBuilder::PackMask(const Variable& x) { return CustomInstr("pack_mask", {x}, {}).front(); }
+
+Variable NetBuilder::UnpackMask(const Variable& words, int size) {
+  return CustomInstr("unpack_mask", {words}, {{"size", size}}).front();
+}
+
 Variable NetBuilder::OneHot(const Variable& indices,
                             const Variable& on_value,
                             const Variable& off_value,
@@ -493,6 +502,18 @@ Variable NetBuilder::Sort(const Variable& operand, const int& axis, const bool&
   return CustomInstr("sort", {operand}, {{"axis", axis}, {"is_ascend", is_ascend}}).front();
 }
 
+Variable NetBuilder::Cumsum(const Variable& x, int axis, bool exclusive, bool reverse) {
+  return CustomInstr("cumsum", {x}, {{"axis", axis}, {"exclusive", exclusive}, {"reverse", reverse}}).front();
+}
+
+Variable NetBuilder::Cumprod(const Variable& x, int axis, bool exclusive, bool reverse) {
+  return CustomInstr("cumprod", {x}, {{"axis", axis}, {"exclusive", exclusive}, {"reverse", reverse}}).front();
+}
+
+Variable NetBuilder::Cummax(const Variable& x, int axis, bool exclusive, bool reverse) {
+  return CustomInstr("cummax", {x}, {{"axis", axis}, {"exclusive", exclusive}, {"reverse", reverse}}).front();
+}
+
 Variable NetBuilder::Argmax(const Variable& x, const int& axis, const bool& keep_dim) {
   return CustomInstr("argmax", {x}, {{"axis", axis}, {"keep_dim", keep_dim}}).front();
 }
@@ -757,8 +778,11 @@ Variable NetBuilder::Repeat(const Variable& x, int repeats, int axis) {
   return CustomInstr("repeat", {x}, {{"repeats", repeats}, {"axis", axis}}).front();
 }
 
-Variable NetBuilder::Resize(const Variable& x, const std::vector<int>& out_shape, const std::string& mode) {
-  return CustomInstr("resize", {x}, {{"out_shape", out_shape}, {"mode", mode}}).front();
+Variable NetBuilder::Resize(const Variable& x,
+                           const std::vector<int>& out_shape,
+                           const std::string& mode,
+                           const std::string& data_format) {
+  return CustomInstr("resize", {x}, {{"out_shape", out_shape}, {"mode", mode}, {"data_format", data_format}}).front();
 }
 
 std::vector<Variable> NetBuilder::BatchNorm(const Variable& a,
@@ -789,6 +813,55 @@ std::vector<Variable> NetBuilder::BatchNormGrad(const Variable& dy,
                      {{"epsilon", epsilon}, {"data_layout", data_layout}});
 }
 
+std::vector<Variable> NetBuilder::LayerNorm(
+    const Variable& x, const Variable& scale, const Variable& bias, float epsilon, int begin_norm_axis) {
+  return CustomInstr("layer_norm", {x, scale, bias}, {{"epsilon", epsilon}, {"begin_norm_axis", begin_norm_axis}});
+}
+
+std::vector<Variable> NetBuilder::LayerNormGrad(const Variable& dy,
+                                                const Variable& x,
+                                                const Variable& scale,
+                                                const Variable& mean,
+                                                const Variable& variance,
+                                                float epsilon,
+                                                int begin_norm_axis) {
+  return CustomInstr("layer_norm_grad",
+                     {x, scale, mean, variance, dy},
+                     {{"epsilon", epsilon}, {"begin_norm_axis", begin_norm_axis}});
+}
+
+std::vector<Variable> NetBuilder::RMSNorm(const Variable& x,
+                                          const Variable& scale,
+                                          float epsilon,
+                                          int begin_norm_axis) {
+  return CustomInstr("rms_norm", {x, scale}, {{"epsilon", epsilon}, {"begin_norm_axis", begin_norm_axis}});
+}
+
+std::vector<Variable> NetBuilder::RMSNormGrad(
+    const Variable& dy, const Variable& x, const Variable& scale, const Variable& inv_rms, int begin_norm_axis) {
+  return CustomInstr("rms_norm_grad", {x, scale, inv_rms, dy}, {{"begin_norm_axis", begin_norm_axis}});
+}
+
+Variable NetBuilder::KVCacheAppend(const Variable& key_cache,
+                                   const Variable& value_cache,
+                                   const Variable& block_tables,
+                                   const Variable& context_lens,
+                                   const Variable& key,
+                                   const Variable& value) {
+  return CustomInstr("kv_cache_append", {key_cache, value_cache, block_tables, context_lens, key, value}, {}).front();
+}
+
+Variable NetBuilder::PagedAttention(const Variable& query,
+                                    const Variable& key_cache,
+                                    const Variable& value_cache,
+                                    const Variable& block_tables,
+                                    const Variable& context_lens,
+                                    float scale) {
+  return CustomInstr(
+             "paged_attention", {query, key_cache, value_cache, block_tables, context_lens}, {{"scale", scale}})
+      .front();
+}
+
 Variable NetBuilder::Scale(const Variable& a, float scale, float bias, bool bias_after_scale) {
   return CustomInstr("scale", {a}, {{"scale", scale}, {"bias", bias}, {"bias_after_scale", bias_after_scale}}).front();
 }
@@ -800,12 +873,68 @@ Variable NetBuilder::Softmax(const Variable& a,
   return CustomInstr("softmax", {a}, {{"axes", axes}, {"mode", mode}, {"data_format", data_format}}).front();
 }
 
+std::vector<Variable> NetBuilder::SoftmaxCrossEntropy(const Variable& logits, const Variable& label, int ignore_index) {
+  return CustomInstr("softmax_cross_entropy", {logits, label}, {{"ignore_index", ignore_index}});
+}
+
 Variable NetBuilder::DropoutInfer(const Variable& a, float dropout_prob, const std::string& dropout_implementation) {
   return CustomInstr(
              "dropout_infer", {a}, {{"dropout_prob", dropout_prob}, {"dropout_implementation", dropout_implementation}})
       .front();
 }
 
+std::vector<Variable> NetBuilder::Dropout(const Variable& x,
+                                          float dropout_prob,
+                                          const std::string& dropout_implementation,
+                                          int seed) {
+  CHECK(dropout_implementation == "downgrade_in_infer" || dropout_implementation == "upscale_in_train")
+      << "The dropout_implementation of dropout should be downgrade_in_infer or upscale_in_train, but here "
+      << dropout_implementation;
+  auto dtype = common::Type2Str(x->type);
+  auto rand  = PhiloxUniform(x->shape, 0.0f, 1.0f, seed, dtype);
+  auto mask  = GreaterEqual(rand, FillConstant(x->shape, dropout_prob, UniqName("dropout_prob"), dtype));
+  auto out   = x;
+  if (dropout_implementation == "upscale_in_train") {
+    float scale = dropout_prob < 1.0f ? 1.0f / (1.0f - dropout_prob) : 0.0f;
+    out         = Scale(x, scale);
+  }
+  out = Select(mask, out, FillConstant(x->shape, 0.0f, UniqName("dropout_zero"), dtype));
+  return {out, mask};
+}
+
+Variable NetBuilder::QuantizeLinear(const Variable& x, const Variable& scale, int quant_axis, int bit_length) {
+  return CustomInstr("quantize_linear", {x, scale}, {{"quant_axis", quant_axis}, {"bit_length", bit_length}}).front();
+}
+
+Variable NetBuilder::DequantizeLinear(const Variable& x, const Variable& scale, int quant_axis, int bit_length) {
+  return CustomInstr("dequantize_linear", {x, scale}, {{"quant_axis", quant_axis}, {"bit_length", bit_length}})
+      .front();
+}
+
+Variable NetBuilder::Fp8Matmul(const Variable& x,
+                               const Variable& y,
+                               const Variable& x_scale,
+                               const Variable& y_scale,
+                               const std::string& out_dtype,
+                               float alpha) {
+  return CustomInstr("fp8_matmul", {x, y, x_scale, y_scale}, {{"out_dtype", out_dtype}, {"alpha", alpha}}).front();
+}
+
+Variable NetBuilder::SparseMatmul(const Variable& x, const Variable& w, float alpha) {
+  return CustomInstr("sparse_matmul", {x, w}, {{"alpha", alpha}}).front();
+}
+
+Variable NetBuilder::CsrSpmm(const Variable& crows,
+                             const Variable& cols,
+                             const Variable& values,
+                             const Variable& dense) {
+  return CustomInstr("csr_spmm", {crows, cols, values, dense}, {}).front();
+}
+
+Variable NetBuilder::Sddmm(const Variable& rows, const Variable& cols, const Variable& x, const Variable& y) {
+  return CustomInstr("sddmm", {rows, cols, x, y}, {}).front();
+}
+
 Variable NetBuilder::Sum(const std::vector<Variable>& inputs) {
   return CustomInstr("sum", inputs, {}).front();
   ;
@@ -863,6 +992,14 @@ Variable NetBuilder::UniformRandom(const std::vector<int>& shape,
   return uniform_res;
 }
 
+Variable NetBuilder::PhiloxUniform(
+    const std::vector<int>& shape, float min, float max, int seed, const std::string& dtype) {
+  CHECK_GE(max, min) << "Arg max must greater than min, please check.";
+  return CustomInstr(
+             "philox_uniform", {}, {{"shape", shape}, {"min", min}, {"max", max}, {"seed", seed}, {"dtype", dtype}})
+      .front();
+}
+
 Variable NetBuilder::RandInt(const std::vector<int>& shape, int min, int max, int seed, const std::string& dtype) {
   CHECK_GT(max, min) << "max: " << max << "should greater than"
                      << "min: " << min;
@@ -935,5 +1072,105 @@ std::vector<Variable> NetBuilder::TopK(const Variable& x, int k, int axis, bool
   return CustomInstr("top_k", {x}, {{"k", k}, {"axis", axis}, {"largest", largest}});
 }
 
+Variable NetBuilder::AllReduce(const Variable& x, const std::string& reduce_type, int ring_id, bool use_calc_stream) {
+  return CustomInstr(
+             "all_reduce",
+             {x},
+             {{"reduce_type", reduce_type}, {"ring_id", ring_id}, {"use_calc_stream", use_calc_stream}})
+      .front();
+}
+
+Variable NetBuilder::AllGather(const Variable& x, int nranks, int ring_id, bool use_calc_stream) {
+  return CustomInstr(
+             "all_gather", {x}, {{"nranks", nranks}, {"ring_id", ring_id}, {"use_calc_stream", use_calc_stream}})
+      .front();
+}
+
+Variable NetBuilder::ReduceScatter(
+    const Variable& x, int nranks, const std::string& reduce_type, int ring_id, bool use_calc_stream) {
+  return CustomInstr("reduce_scatter",
+                     {x},
+                     {{"nranks", nranks},
+                      {"reduce_type", reduce_type},
+                      {"ring_id", ring_id},
+                      {"use_calc_stream", use_calc_stream}})
+      .front();
+}
+
+namespace {
+
+hlir::framework::ControlFlowBody BuildControlFlowBody(const std::string& name,
+                                                      const std::vector<Variable>& operands,
+                                                      const NetBuilder::BodyBuilder& body_builder) {
+  NetBuilder builder(name);
+  std::vector<Variable> args;
+  for (const auto& operand : operands) {
+    args.emplace_back(builder.CreateInput(operand->type, operand->shape));
+  }
+  auto results = body_builder(&builder, args);
+  CHECK(!results.empty()) << "The body of the control flow op " << name << " should return its results";
+  for (auto& result : results) {
+    // every result should be computed by the body, so the operands passed through are copied
+    if (std::any_of(args.begin(), args.end(), [&result](const Variable& arg) { return arg->id == result->id; })) {
+      result = builder.Identity(result);
+    }
+  }
+  return {builder.Build(), std::move(results)};
+}
+
+}  // namespace
+
+std::vector<Variable> NetBuilder::Cond(const Variable& pred,
+                                       const std::vector<Variable>& operands,
+                                       const BodyBuilder& then_branch,
+                                       const BodyBuilder& else_branch) {
+  CHECK(pred->type.is_bool()) << "The predicate of cond should be bool";
+  CHECK_EQ(std::accumulate(pred->shape.begin(), pred->shape.end(), 1, std::multiplies<int>()), 1)
+      << "The predicate of cond should have only one element";
+  std::vector<hlir::framework::ControlFlowBody> bodies;
+  bodies.emplace_back(BuildControlFlowBody(name_ + "_then", operands, then_branch));
+  bodies.emplace_back(BuildControlFlowBody(name_ + "_else", operands, else_branch));
+  const auto& then_outs = bodies[0].outputs;
+  const auto& else_outs = bodies[1].outputs;
+  CHECK_EQ(then_outs.size(), else_outs.size()) << "The branches of cond should return the same number of results";
+  for (size_t i = 0; i < then_outs.size(); ++i) {
+    CHECK(then_outs[i]->shape == else_outs[i]->shape && then_outs[i]->type == else_outs[i]->type)
+        << "The " << i << "-th results of the branches of cond should have the same shape and type";
+  }
+  int body_id = hlir::framework::ControlFlowRegistry::Global()->Register(std::move(bodies));
+
+  std::vector<Variable> inputs = {pred};
+  inputs.insert(inputs.end(), operands.begin(), operands.end());
+  return CustomInstr("cond", std::move(inputs), {{"body_id", body_id}});
+}
+
+std::vector<Variable> NetBuilder::WhileLoop(const Variable& pred,
+                                            const std::vector<Variable>& loop_vars,
+                                            const std::vector<Variable>& operands,
+                                            const BodyBuilder& body) {
+  CHECK(pred->type.is_bool()) << "The predicate of while_loop should be bool";
+  CHECK_EQ(std::accumulate(pred->shape.begin(), pred->shape.end(), 1, std::multiplies<int>()), 1)
+      << "The predicate of while_loop should have only one element";
+  CHECK(!loop_vars.empty()) << "The while_loop should have at least one loop variable";
+  std::vector<Variable> args = loop_vars;
+  args.insert(args.end(), operands.begin(), operands.end());
+  std::vector<hlir::framework::ControlFlowBody> bodies;
+  bodies.emplace_back(BuildControlFlowBody(name_ + "_body", args, body));
+  const auto& outs = bodies[0].outputs;
+  CHECK_EQ(outs.size(), loop_vars.size() + 1)
+      << "The body of while_loop should return the next predicate and the next loop variables";
+  CHECK(outs[0]->type.is_bool()) << "The next predicate of while_loop should be bool";
+  for (size_t i = 0; i < loop_vars.size(); ++i) {
+    CHECK(outs[i + 1]->shape == loop_vars[i]->shape && outs[i + 1]->type == loop_vars[i]->type)
+        << "The loop variable " << i << " of while_loop should keep its shape and type";
+  }
+  int body_id = hlir::framework::ControlFlowRegistry::Global()->Register(std::move(bodies));
+
+  std::vector<Variable> inputs = {pred};
+  inputs.insert(inputs.end(), args.begin(), args.end());
+  return CustomInstr(
+      "while_loop", std::move(inputs), {{"body_id", body_id}, {"num_loop_vars", static_cast<int>(loop_vars.size())}});
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -146,11 +147,13 @@ class NetBuilder {
 
   void AppendInstruction(const Instruction& instr) { instrs_.push_back(instr); }
 
+  // reserve the space of the instructions, such as before converting a model with the known number of ops
+  void Reserve(size_t num_instrs) { instrs_.reserve(num_instrs); }
+
   void InferShape(Instruction instr) const;
 
-  const std::vector<Variable>& CustomInstr(const std::string& type,
-                                           const std::vector<Variable>& inputs,
-                                           const AttributeMap& attrs);
+  // the inputs and the attributes are taken by value, so that the temporary ones are moved into the instruction
+  const std::vector<Variable>& CustomInstr(const std::string& type, std::vector<Variable> inputs, AttributeMap attrs);
 
  protected:
   /**
@@ -282,6 +285,87 @@ class NetBuilder {
                         float dropout_prob                        = 0.5f,
                         const std::string& dropout_implementation = "downgrade_in_infer");
 
+  /**
+   * @brief Dropout of training, the mask is generated by PhiloxUniform inline in the kernel fused with the multiply,
+   * instead of a random tensor in the global memory.
+   * @param x The input variable.
+   * @param dropout_prob Probability of setting units to zero.
+   * @param dropout_implementation Choice the mode of dropout, the same as DropoutInfer.
+   * @param seed Random seed of generator, default is 0, which takes the global seed.
+   * @return The output with the same shape and data type as input, and the bool mask where the units are kept.
+   */
+  std::vector<Variable> Dropout(const Variable& x,
+                                float dropout_prob                        = 0.5f,
+                                const std::string& dropout_implementation = "downgrade_in_infer",
+                                int seed                                  = 0);
+
+  /**
+   * @brief Quantize the float input into int8 symmetrically: `clip(round(x * bound / scale), -bound, bound)`, where
+   * the bound is `2^(bit_length - 1) - 1`.
+   * @param x The input variable.
+   * @param scale The 1-D float scale, the max absolute value of x, which has a single value or one value per slice
+   * along quant_axis.
+   * @param quant_axis The axis of the per-channel scale, -1 means the scale is per-tensor.
+   * @param bit_length The bits of the quantized integers, no more than 8.
+   * @return The int8 variable with the same shape as input.
+   */
+  Variable QuantizeLinear(const Variable& x, const Variable& scale, int quant_axis = -1, int bit_length = 8);
+
+  /**
+   * @brief Dequantize the int8 input, or the int32 accumulation of the int8 matmul and conv2d, into float32:
+   * `x * scale / bound`, the arguments are the same as QuantizeLinear.
+   */
+  Variable DequantizeLinear(const Variable& x, const Variable& scale, int quant_axis = -1, int bit_length = 8);
+
+  /**
+   * @brief The matmul of the fp8 inputs on the fp8 tensor cores: `alpha * (x * x_scale) * (y * y_scale)^T`.
+   * @param x The fp8 left input of shape [M, K].
+   * @param y The fp8 right input of shape [N, K], which is transposed.
+   * @param x_scale The float32 scale of shape [1] which dequantizes x.
+   * @param y_scale The float32 scale of shape [1] which dequantizes y.
+   * @param out_dtype The dtype of the output, bfloat16, float16 or float32.
+   * @param alpha The scale of the output.
+   * @return The output of shape [M, N].
+   */
+  Variable Fp8Matmul(const Variable& x,
+                     const Variable& y,
+                     const Variable& x_scale,
+                     const Variable& y_scale,
+                     const std::string& out_dtype = "bfloat16",
+                     float alpha                  = 1.0f);
+
+  /**
+   * @brief The matmul of the 2:4 structured sparse weight on the sparse tensor cores: `alpha * x * w^T`.
+   * @param x The float16 or bfloat16 left input of shape [M, K].
+   * @param w The constant weight of shape [N, K], which is transposed. Every 4 consecutive elements along K should have
+   * at most 2 non-zeros, otherwise the matmul is computed by the dense gemm.
+   * @param alpha The scale of the output.
+   * @return The output of shape [M, N].
+   */
+  Variable SparseMatmul(const Variable& x, const Variable& w, float alpha = 1.0f);
+
+  /**
+   * @brief The product of the CSR sparse matrix and the dense matrix, the elementwise ops on its output are fused into
+   * its kernel, such as the normalization and the activation of the graph convolution.
+   * @param crows The int32 row offsets of the sparse matrix of shape [M + 1].
+   * @param cols The int32 column indices of the non-zeros of shape [nnz].
+   * @param values The values of the non-zeros of shape [nnz].
+   * @param dense The dense matrix of shape [K, N].
+   * @return The output of shape [M, N].
+   */
+  Variable CsrSpmm(const Variable& crows, const Variable& cols, const Variable& values, const Variable& dense);
+
+  /**
+   * @brief The sampled dense-dense matrix multiplication: `out[p] = dot(x[rows[p], :], y[cols[p], :])`, which computes
+   * the elements of `x * y^T` at the COO indices only, such as the attention scores on the edges of a graph.
+   * @param rows The int32 row indices of shape [nnz].
+   * @param cols The int32 column indices of shape [nnz].
+   * @param x The left input of shape [M, K].
+   * @param y The right input of shape [N, K], which is transposed.
+   * @return The output of shape [nnz].
+   */
+  Variable Sddmm(const Variable& rows, const Variable& cols, const Variable& x, const Variable& y);
+
   Variable GatherNd(const Variable& x, const Variable& index);
 
   Variable Scatter(const Variable& src, const Variable& index, const Variable& out, const int& axis = 0);
@@ -587,12 +671,16 @@ class NetBuilder {
 
   /**
    * @brief Resize operator does 2D scaling to the given size.
-   * @param x An input variable, the data layout of input is NCHW
+   * @param x An input variable, the data layout of input is NCHW or NHWC
    * @param out_shape The out size to which the image will be resized.
    * @param mode Scale method to used [nearest, bilinear, bicubic], this will default to `bilinear`.
+   * @param data_format The data layout of input [NCHW, NHWC], this will default to `NCHW`.
    * @return The resized result.
    */
-  Variable Resize(const Variable& x, const std::vector<int>& out_shape, const std::string& mode);
+  Variable Resize(const Variable& x,
+                  const std::vector<int>& out_shape,
+                  const std::string& mode,
+                  const std::string& data_format = "NCHW");
 
   // *******************************************
   // Broadcast operator
@@ -784,6 +872,16 @@ class NetBuilder {
                    const std::string& mode        = "fast",
                    const std::string& data_format = "AnyLayout");
 
+  /**
+   * @brief The softmax along the last axis of the logits and the cross entropy loss of the hard label.
+   * @param logits An N-D variable.
+   * @param label The int32 or int64 class index of each row, its shape is the shape of the logits except the last
+   * axis, which can be 1 or omitted.
+   * @param ignore_index The loss of the rows whose label is ignore_index is 0. Default: -100.
+   * @return The softmax with the same shape as the logits and the loss with the last axis of size 1.
+   */
+  std::vector<Variable> SoftmaxCrossEntropy(const Variable& logits, const Variable& label, int ignore_index = -100);
+
   // *******************************************
   // Type converter Operator
   /**
@@ -809,6 +907,24 @@ class NetBuilder {
    */
   Variable BitcastConvert(const Variable& x, const std::string& dtype);
 
+  /**
+   * @brief Pack the bool mask along its last axis into the bits of the int32 words, the element i is the bit
+   * `i % 32` of the word `i / 32`. The packed mask takes 1/8 of the memory of the bool one, and its producer such as
+   * a compare is fused into the packing without writing the bool mask.
+   * @param x An input N-D bool variable of the shape [..., n].
+   * @return The int32 variable of the shape [..., ceil(n / 32)].
+   */
+  Variable PackMask(const Variable& x);
+
+  /**
+   * @brief Unpack the int32 words packed by `PackMask` into the bool mask, which is extracted bit by bit inside the
+   * fused kernel of its consumer such as a select.
+   * @param words An input N-D int32 variable of the shape [..., ceil(size / 32)].
+   * @param size The size of the last axis of the bool mask.
+   * @return The bool variable of the shape [..., size].
+   */
+  Variable UnpackMask(const Variable& words, int size);
+
   /**
    *  @brief Returns a one-hot tensor where the locations repsented by indices take value `on_value`,
    *  other locations take value `off_value`.
@@ -1004,6 +1120,112 @@ class NetBuilder {
                                       const float epsilon            = 1e-5f,
                                       const std::string& data_layout = "NCHW");
 
+  /**
+   * @brief Normalize the variable x over the dimensions from `begin_norm_axis` by the mean and the variance of them.
+   * @param x An input N-D variable of float32, float16 or bfloat16.
+   * @param scale The float32 1-D variable multiplied to the normalized result, whose size is the number of the
+   * normalized elements.
+   * @param bias The float32 1-D variable added to the normalized result, whose size is the same as `scale`.
+   * @param epsilon The small value added to the variance to prevent division by zero. Default: 1e-5f.
+   * @param begin_norm_axis The first dimension to normalize, the dimensions before it are flattened into the rows.
+   * Default: 1.
+   * @return `{y, mean, variance}`, the mean and the variance are float32 1-D variables of the rows.
+   */
+  std::vector<Variable> LayerNorm(const Variable& x,
+                                  const Variable& scale,
+                                  const Variable& bias,
+                                  float epsilon       = 1e-5f,
+                                  int begin_norm_axis = 1);
+
+  /**
+   * @brief The gradient function of LayerNorm.
+   * @param dy The gradient variable of the `layer_norm`'s first output.
+   * @param x The input variable of the `layer_norm`.
+   * @param scale The scale variable of the `layer_norm`.
+   * @param mean The mean saved by the `layer_norm`.
+   * @param variance The variance saved by the `layer_norm`.
+   * @param epsilon The small value added to the variance to prevent division by zero. Default: 1e-5f.
+   * @param begin_norm_axis The first dimension normalized by the `layer_norm`. Default: 1.
+   * @return `{x_grad, scale_grad, bias_grad}`.
+   */
+  std::vector<Variable> LayerNormGrad(const Variable& dy,
+                                      const Variable& x,
+                                      const Variable& scale,
+                                      const Variable& mean,
+                                      const Variable& variance,
+                                      float epsilon       = 1e-5f,
+                                      int begin_norm_axis = 1);
+
+  /**
+   * @brief Normalize the variable x over the dimensions from `begin_norm_axis` by the root mean square of them.
+   * @param x An input N-D variable of float32, float16 or bfloat16.
+   * @param scale The float32 1-D variable multiplied to the normalized result, whose size is the number of the
+   * normalized elements.
+   * @param epsilon The small value added to the mean square to prevent division by zero. Default: 1e-6f.
+   * @param begin_norm_axis The first dimension to normalize, the dimensions before it are flattened into the rows.
+   * Default: -1.
+   * @return `{y, inv_rms}`, the inverse root mean square is a float32 1-D variable of the rows.
+   */
+  std::vector<Variable> RMSNorm(const Variable& x,
+                                const Variable& scale,
+                                float epsilon       = 1e-6f,
+                                int begin_norm_axis = -1);
+
+  /**
+   * @brief The gradient function of RMSNorm.
+   * @param dy The gradient variable of the `rms_norm`'s first output.
+   * @param x The input variable of the `rms_norm`.
+   * @param scale The scale variable of the `rms_norm`.
+   * @param inv_rms The inverse root mean square saved by the `rms_norm`.
+   * @param begin_norm_axis The first dimension normalized by the `rms_norm`. Default: -1.
+   * @return `{x_grad, scale_grad}`.
+   */
+  std::vector<Variable> RMSNormGrad(const Variable& dy,
+                                    const Variable& x,
+                                    const Variable& scale,
+                                    const Variable& inv_rms,
+                                    int begin_norm_axis = -1);
+
+  /**
+   * @brief Append the key and the value of the new token of each sequence to the paged caches for the decoding. The
+   * token t of a sequence is kept at the row `t % block_size` of the cache block `block_tables[b][t / block_size]`.
+   * @param key_cache The cache variable of the shape [num_blocks, num_kv_heads, block_size, head_dim] of float32,
+   * float16 or bfloat16, it is written in place.
+   * @param value_cache The cache variable of the same shape and dtype as `key_cache`, it is written in place.
+   * @param block_tables The int32 variable of the shape [batch_size, max_blocks_per_seq].
+   * @param context_lens The int32 variable of the shape [batch_size], the number of the tokens cached of each sequence.
+   * @param key The key variable of the new tokens of the shape [batch_size, num_kv_heads, head_dim].
+   * @param value The value variable of the new tokens of the shape [batch_size, num_kv_heads, head_dim].
+   * @return The new context lengths, the sequences whose block tables are full are not appended. It should be passed
+   * to the `PagedAttention` or fetched, otherwise the append is removed as dead code.
+   */
+  Variable KVCacheAppend(const Variable& key_cache,
+                         const Variable& value_cache,
+                         const Variable& block_tables,
+                         const Variable& context_lens,
+                         const Variable& key,
+                         const Variable& value);
+
+  /**
+   * @brief Compute the attention of the single query token of each sequence over its paged key and value caches,
+   * which are written by the `KVCacheAppend`.
+   * @param query The query variable of the shape [batch_size, num_heads, head_dim], the num_heads should be divisible
+   * by the num_kv_heads of the caches.
+   * @param key_cache The key cache variable of the shape [num_blocks, num_kv_heads, block_size, head_dim].
+   * @param value_cache The value cache variable of the same shape as `key_cache`.
+   * @param block_tables The int32 variable of the shape [batch_size, max_blocks_per_seq].
+   * @param context_lens The int32 variable of the shape [batch_size], the number of the tokens attended by each
+   * sequence.
+   * @param scale The scale multiplied to the logits, the non-positive value means `1 / sqrt(head_dim)`. Default: 0.
+   * @return The attention output of the shape [batch_size, num_heads, head_dim].
+   */
+  Variable PagedAttention(const Variable& query,
+                          const Variable& key_cache,
+                          const Variable& value_cache,
+                          const Variable& block_tables,
+                          const Variable& context_lens,
+                          float scale = 0.0f);
+
   /**
    * @brief Get index of variable x to the maximum value along the given axis.
    * @param x An input N-D variable.
@@ -1045,6 +1267,28 @@ class NetBuilder {
    */
   Variable Sort(const Variable& operand, const int& axis, const bool& is_ascend = true);
 
+  /**
+   * @brief The cumulative sum of x along the axis, computed by the single-pass scan kernel on NVGPU.
+   * @param x The input variable.
+   * @param axis The axis to scan along. Default: -1.
+   * @param exclusive If true, the element itself is excluded, so the first output element is 0. Default: false.
+   * @param reverse If true, scan from the last element of the axis. Default: false.
+   * @return The cumulative sum with the same shape and dtype as x.
+   */
+  Variable Cumsum(const Variable& x, int axis = -1, bool exclusive = false, bool reverse = false);
+
+  /**
+   * @brief The cumulative product of x along the axis, the same as Cumsum except that the first exclusive output
+   * element is 1.
+   */
+  Variable Cumprod(const Variable& x, int axis = -1, bool exclusive = false, bool reverse = false);
+
+  /**
+   * @brief The cumulative max of x along the axis, the same as Cumsum except that the first exclusive output element
+   * is the lowest value of the dtype. Only the values are returned, not the indices of the max.
+   */
+  Variable Cummax(const Variable& x, int axis = -1, bool exclusive = false, bool reverse = false);
+
   /**
    * @brief Lookup embeddings vector of ids provided by x .
    * @param table A variable with shape of lookup table parameter
@@ -1087,6 +1331,21 @@ class NetBuilder {
                          int diag_step            = 0,
                          float diag_val           = 1.0f);
 
+  /**
+   * @brief Uniform random generated by the counter-based Philox RNG from the seed and the index of each element, which
+   * is fused with its consumers and computed inline, unlike UniformRandom computed by a separate cuRAND call.
+   * @param shape Shape of the variable to be created.
+   * @param min The lower bound of the range of random values ​​generated, min is included in the range.
+   * @param max The upper bound of the range of random values ​​generated, max is not included in the range.
+   * @param seed Random seed of generator, default is 0, which takes the global seed.
+   * @param dtype Data tpye of output variable, supported data types: float32, float64.
+   */
+  Variable PhiloxUniform(const std::vector<int>& shape,
+                         float min                = 0.0f,
+                         float max                = 1.0f,
+                         int seed                 = 0,
+                         const std::string& dtype = "float32");
+
   /**
    * @brief Generate random integers in the range min to max
    * @param shape Shape of the variable to be created.
@@ -1138,6 +1397,76 @@ class NetBuilder {
    */
   std::vector<Variable> TopK(const Variable& x, int k, int axis, bool largest);
 
+  // *******************************************
+  // Collective Operator
+  /**
+   * @brief Reduce x over the ranks of a communication ring by NCCL, every rank gets the result.
+   * @param x The input on this rank.
+   * @param reduce_type The reduction, sum, prod, max, min or avg. Default: sum.
+   * @param ring_id The ring whose communicators are created by NcclCommContext. Default: 0.
+   * @param use_calc_stream Whether to run on the compute stream. If false, it runs on the communication stream of
+   * the ring and only the instructions reading its input or output wait for it, so that the independent compute
+   * instructions overlap with it. Default: true.
+   * @return The reduction with the same shape as x.
+   */
+  Variable AllReduce(const Variable& x,
+                     const std::string& reduce_type = "sum",
+                     int ring_id                    = 0,
+                     bool use_calc_stream           = true);
+
+  /**
+   * @brief Concatenate the x of the ranks of a communication ring along the first axis by NCCL.
+   * @param x The input on this rank.
+   * @param nranks The number of ranks of the ring.
+   * @return The variable whose first axis is nranks times of x.
+   */
+  Variable AllGather(const Variable& x, int nranks, int ring_id = 0, bool use_calc_stream = true);
+
+  /**
+   * @brief Reduce x over the ranks of a communication ring by NCCL, each rank gets its slice along the first axis.
+   * @param x The input on this rank, whose first axis is divisible by nranks.
+   * @param nranks The number of ranks of the ring.
+   * @return The slice of the reduction, whose first axis is 1/nranks of x.
+   */
+  Variable ReduceScatter(const Variable& x,
+                         int nranks,
+                         const std::string& reduce_type = "sum",
+                         int ring_id                    = 0,
+                         bool use_calc_stream           = true);
+
+  // *******************************************
+  // Control Flow Operator
+  // build the body of a control flow op with the given builder, the arguments are the placeholders of its operands
+  using BodyBuilder = std::function<std::vector<Variable>(NetBuilder*, const std::vector<Variable>&)>;
+
+  /**
+   * @brief Run then_branch or else_branch on the operands according to the predicate. The branches are compiled
+   * separately and the predicate is read on host, so only the taken branch is run.
+   * @param pred The bool predicate with one element.
+   * @param operands The variables used by the branches.
+   * @param then_branch The branch run when pred is true.
+   * @param else_branch The branch run when pred is false, whose results have the same shapes and types as then_branch.
+   * @return The results of the taken branch.
+   */
+  std::vector<Variable> Cond(const Variable& pred,
+                             const std::vector<Variable>& operands,
+                             const BodyBuilder& then_branch,
+                             const BodyBuilder& else_branch);
+
+  /**
+   * @brief Run the body while the predicate is true. The body takes the loop variables followed by the operands, and
+   * returns the next predicate followed by the next loop variables.
+   * @param pred The bool predicate with one element, which is checked before the first iteration.
+   * @param loop_vars The initial values of the loop variables.
+   * @param operands The variables used by the body, which are the same in all the iterations.
+   * @param body The loop body.
+   * @return The loop variables after the last iteration.
+   */
+  std::vector<Variable> WhileLoop(const Variable& pred,
+                                  const std::vector<Variable>& loop_vars,
+                                  const std::vector<Variable>& operands,
+                                  const BodyBuilder& body);
+
  private:
   CINN_DISALLOW_COPY_AND_ASSIGN(NetBuilder);
 };
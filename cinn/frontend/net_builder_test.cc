@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <vector>
 
@@ -29,6 +30,7 @@
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/utils/data_util.h"
+#include "cinn/utils/timer.h"
 #ifdef CINN_WITH_CUDA
 #include <cuda_runtime.h>
 #endif
@@ -74,6 +76,27 @@ TEST(net_build, basic) {
   }
 }
 
+// Benchmark of building a large program before the compilation, such as converting a large model.
+TEST(net_build, build_large_program) {
+  const int num_ops = 100000;
+  utils::Timer timer;
+  timer.Start();
+  NetBuilder builder("build_large_program");
+  builder.Reserve(num_ops);
+  auto x = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto y = builder.CreateInput(Float(32), {32, 16}, "y");
+  for (int i = 0; i < num_ops / 5; ++i) {
+    x = builder.Add(x, y);
+    x = builder.Scale(x, 0.5f, 1.0f);
+    x = builder.Relu(x);
+    x = builder.Reshape(x, {16, 32});
+    x = builder.Reshape(x, {32, 16});
+  }
+  auto program = builder.Build();
+  LOG(INFO) << "Build a program of " << program.size() << " instructions in " << timer.Stop() << " ms";
+  ASSERT_EQ(program.size(), num_ops);
+}
+
 TEST(net_build, program_execute_multi_elementwise_add) {
   auto program = CreateAddProgram();
 #ifdef CINN_WITH_CUDA
@@ -438,6 +461,96 @@ TEST(net_build, program_execute_gather_nd) {
   }
 }
 
+#ifdef CINN_WITH_CUDA
+TEST(net_build, program_execute_lookup_table) {
+  const int V = 50;
+  const int D = 64;
+  const int N = 37;
+
+  NetBuilder builder("net_builder");
+  Placeholder table = builder.CreateInput(Float(32), {V, D}, "Table");
+  Placeholder ids   = builder.CreateInput(Int(32), {N, 1}, "Ids");
+  Variable output   = builder.LookupTable(table, ids, 3);
+  auto program      = builder.Build();
+
+  Target target = common::DefaultNVGPUTarget();
+  std::unordered_set<std::string> fetch_ids;
+  auto graph = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto table_tensor = scope->GetTensor(std::string(table.id()));
+  SetRandData<float>(table_tensor, target);
+  std::vector<float> table_data = GetTensorData<float>(table_tensor, target);
+  auto ids_tensor = scope->GetTensor(std::string(ids.id()));
+  SetRandInt(ids_tensor, target, -1, 0, V);
+  std::vector<int> ids_data = GetTensorData<int>(ids_tensor, target);
+
+  runtime_program->Execute();
+
+  std::vector<float> output_data = GetTensorData<float>(scope->GetTensor(std::string(output->id)), target);
+  ASSERT_EQ(output_data.size(), N * D);
+  for (int n = 0; n < N; ++n) {
+    for (int d = 0; d < D; ++d) {
+      // the rows of the padding index are zero
+      float expected = ids_data[n] == 3 ? 0.0f : table_data[ids_data[n] * D + d];
+      EXPECT_EQ(output_data[n * D + d], expected) << "n=" << n << ", d=" << d;
+    }
+  }
+}
+
+TEST(net_build, program_execute_scatter_add) {
+  const int B = 3;
+  const int H = 8;
+  const int N = 20;
+  const int W = 12;
+
+  NetBuilder builder("net_builder");
+  Placeholder input   = builder.CreateInput(Float(32), {B, H, W}, "In");
+  Placeholder updates = builder.CreateInput(Float(32), {B, N, W}, "Updates");
+  Placeholder index   = builder.CreateInput(Int(32), {N}, "Index");
+  Variable output     = builder.ScatterAdd(input, updates, index, 1);
+  auto program        = builder.Build();
+
+  Target target = common::DefaultNVGPUTarget();
+  std::unordered_set<std::string> fetch_ids;
+  auto graph = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  SetRandData<float>(input_tensor, target);
+  std::vector<float> input_data = GetTensorData<float>(input_tensor, target);
+  auto updates_tensor = scope->GetTensor(std::string(updates.id()));
+  SetRandData<float>(updates_tensor, target);
+  std::vector<float> updates_data = GetTensorData<float>(updates_tensor, target);
+  // the index takes duplicates since N > H
+  auto index_tensor = scope->GetTensor(std::string(index.id()));
+  SetRandInt(index_tensor, target, -1, 0, H);
+  std::vector<int> index_data = GetTensorData<int>(index_tensor, target);
+
+  runtime_program->Execute();
+
+  std::vector<float> expected = input_data;
+  for (int b = 0; b < B; ++b) {
+    for (int n = 0; n < N; ++n) {
+      for (int w = 0; w < W; ++w) {
+        expected[(b * H + index_data[n]) * W + w] += updates_data[(b * N + n) * W + w];
+      }
+    }
+  }
+  std::vector<float> output_data = GetTensorData<float>(scope->GetTensor(std::string(output->id)), target);
+  ASSERT_EQ(output_data.size(), expected.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(output_data[i], expected[i], 1e-5) << "i=" << i;
+  }
+}
+#endif
+
 TEST(net_build, program_execute_cast) {
   const int B = 4;
   const int H = 7;
@@ -1497,5 +1610,316 @@ TEST(net_build, program_execute_one_hot) {
   }
 }
 
+TEST(net_build, program_execute_resize_nhwc) {
+  const int N     = 2;
+  const int H     = 5;
+  const int W     = 6;
+  const int C     = 8;
+  const int out_h = 7;
+  const int out_w = 9;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {N, H, W, C}, "In");
+  Variable output   = builder.Resize(input, {out_h, out_w}, "bilinear", "NHWC");
+  auto program      = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  std::unordered_set<std::string> fetch_ids;
+  auto graph = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>(std::string(input.id()));
+  scope->Var<hlir::framework::Tensor>(std::string(output->id));
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  SetRandData<float>(input_tensor, target);
+  std::vector<float> input_data = GetTensorData<float>(input_tensor, target);
+
+  runtime_program->Execute();
+
+  auto output_tensor                   = scope->GetTensor(std::string(output->id));
+  const std::vector<int>& output_shape = output_tensor->shape().data();
+  EXPECT_EQ(output_tensor->type(), Float(32));
+  EXPECT_EQ(output_shape, std::vector<int>({N, out_h, out_w, C}));
+
+  auto get_pixel = [&](int n, int y, int x, int c) {
+    y = std::max(std::min(y, H - 1), 0);
+    x = std::max(std::min(x, W - 1), 0);
+    return input_data[((n * H + y) * W + x) * C + c];
+  };
+  std::vector<float> output_data = GetTensorData<float>(output_tensor, target);
+  float scale_y                  = static_cast<float>(H) / out_h;
+  float scale_x                  = static_cast<float>(W) / out_w;
+  for (int n = 0; n < N; ++n) {
+    for (int oy = 0; oy < out_h; ++oy) {
+      for (int ox = 0; ox < out_w; ++ox) {
+        float in_y   = (oy + 0.5F) * scale_y - 0.5F;
+        float in_x   = (ox + 0.5F) * scale_x - 0.5F;
+        int y        = static_cast<int>(std::floor(in_y));
+        int x        = static_cast<int>(std::floor(in_x));
+        float y_lerp = in_y - y;
+        float x_lerp = in_x - x;
+        for (int c = 0; c < C; ++c) {
+          float top    = get_pixel(n, y, x, c) * (1.0F - x_lerp) + get_pixel(n, y, x + 1, c) * x_lerp;
+          float bottom = get_pixel(n, y + 1, x, c) * (1.0F - x_lerp) + get_pixel(n, y + 1, x + 1, c) * x_lerp;
+          float expect = top * (1.0F - y_lerp) + bottom * y_lerp;
+          EXPECT_NEAR(output_data[((n * out_h + oy) * out_w + ox) * C + c], expect, 1e-5);
+        }
+      }
+    }
+  }
+}
+
+TEST(net_build, program_execute_cond) {
+  const int N = 16;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {N}, "In");
+  auto sum          = builder.ReduceSum(input, {0}, true);
+  auto pred         = builder.GreaterThan(sum, builder.FillConstant<float>({1}, 0.0f));
+  auto then_branch  = [](NetBuilder* b, const std::vector<Variable>& args) {
+    return std::vector<Variable>{b->Scale(args[0], 2.0f)};
+  };
+  auto else_branch = [](NetBuilder* b, const std::vector<Variable>& args) {
+    return std::vector<Variable>{b->Scale(args[0], -1.0f)};
+  };
+  auto output  = builder.Cond(pred, {input}, then_branch, else_branch).front();
+  auto program = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  std::unordered_set<std::string> fetch_ids = {output->id};
+  auto graph                                = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  SetRandData<float>(input_tensor, target);
+  std::vector<float> input_data = GetTensorData<float>(input_tensor, target);
+
+  runtime_program->Execute();
+
+  auto output_tensor             = scope->GetTensor(std::string(output->id));
+  std::vector<float> output_data = GetTensorData<float>(output_tensor, target);
+  float input_sum                = std::accumulate(input_data.begin(), input_data.end(), 0.0f);
+  for (int i = 0; i < N; ++i) {
+    float expect = input_sum > 0.0f ? input_data[i] * 2.0f : -input_data[i];
+    EXPECT_NEAR(output_data[i], expect, 1e-5);
+  }
+}
+
+TEST(net_build, program_execute_while_loop) {
+  const int N          = 16;
+  const int iterations = 5;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {N}, "In");
+  auto counter      = builder.FillConstant<float>({1}, 0.0f);
+  auto limit        = builder.FillConstant<float>({1}, static_cast<float>(iterations));
+  auto pred         = builder.LessThan(counter, limit);
+  // the body adds the input to the accumulator and increases the counter
+  auto outputs = builder.WhileLoop(
+      pred, {counter, builder.Identity(input)}, {input, limit}, [](NetBuilder* b, const std::vector<Variable>& args) {
+        auto next_counter = b->Scale(args[0], 1.0f, 1.0f);
+        auto next_acc     = b->Add(args[1], args[2]);
+        return std::vector<Variable>{b->LessThan(next_counter, args[3]), next_counter, next_acc};
+      });
+  auto output  = outputs[1];
+  auto program = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  std::unordered_set<std::string> fetch_ids = {output->id};
+  auto graph                                = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  SetRandData<float>(input_tensor, target);
+  std::vector<float> input_data = GetTensorData<float>(input_tensor, target);
+
+  runtime_program->Execute();
+
+  auto output_tensor             = scope->GetTensor(std::string(output->id));
+  std::vector<float> output_data = GetTensorData<float>(output_tensor, target);
+  for (int i = 0; i < N; ++i) {
+    EXPECT_NEAR(output_data[i], input_data[i] * (iterations + 1), 1e-4);
+  }
+}
+
+#ifdef CINN_WITH_CUDA
+TEST(net_build, program_execute_paged_attention) {
+  const int B          = 3;
+  const int num_heads  = 4;
+  const int kv_heads   = 2;
+  const int D          = 64;
+  const int block_size = 16;
+  const int max_blocks = 40;
+  const int num_blocks = B * max_blocks;
+  // the last sequence spans two partitions of the kernel, the first one attends only the appended token
+  const std::vector<int> context_lens = {0, 100, 600};
+
+  NetBuilder builder("net_builder");
+  Placeholder key_cache    = builder.CreateInput(Float(32), {num_blocks, kv_heads, block_size, D}, "KeyCache");
+  Placeholder value_cache  = builder.CreateInput(Float(32), {num_blocks, kv_heads, block_size, D}, "ValueCache");
+  Placeholder block_tables = builder.CreateInput(Int(32), {B, max_blocks}, "BlockTables");
+  Placeholder lens         = builder.CreateInput(Int(32), {B}, "ContextLens");
+  Placeholder query        = builder.CreateInput(Float(32), {B, num_heads, D}, "Query");
+  Placeholder key          = builder.CreateInput(Float(32), {B, kv_heads, D}, "Key");
+  Placeholder value        = builder.CreateInput(Float(32), {B, kv_heads, D}, "Value");
+  Variable new_lens        = builder.KVCacheAppend(key_cache, value_cache, block_tables, lens, key, value);
+  Variable output          = builder.PagedAttention(query, key_cache, value_cache, block_tables, new_lens);
+  auto program             = builder.Build();
+
+  Target target                             = common::DefaultNVGPUTarget();
+  std::unordered_set<std::string> fetch_ids = {output->id, new_lens->id};
+  auto graph                                = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto set_int_data = [&](const std::string& name, const std::vector<int>& data) {
+    auto tensor = scope->GetTensor(name);
+    cudaMemcpy(tensor->mutable_data<int>(target), data.data(), data.size() * sizeof(int), cudaMemcpyHostToDevice);
+  };
+  // the blocks of the sequences are interleaved in the caches
+  std::vector<int> table_data(B * max_blocks);
+  for (int b = 0; b < B; ++b) {
+    for (int i = 0; i < max_blocks; ++i) {
+      table_data[b * max_blocks + i] = (max_blocks - 1 - i) * B + b;
+    }
+  }
+  set_int_data(std::string(block_tables.id()), table_data);
+  set_int_data(std::string(lens.id()), context_lens);
+  std::vector<std::vector<float>> data;
+  for (auto& input : {key_cache, value_cache, query, key, value}) {
+    auto tensor = scope->GetTensor(std::string(input.id()));
+    SetRandData<float>(tensor, target);
+    data.emplace_back(GetTensorData<float>(tensor, target));
+  }
+  auto& key_cache_data   = data[0];
+  auto& value_cache_data = data[1];
+
+  runtime_program->Execute();
+
+  auto cache_offset = [&](int b, int h, int t) {
+    int block = table_data[b * max_blocks + t / block_size];
+    return ((block * kv_heads + h) * block_size + t % block_size) * D;
+  };
+  for (int b = 0; b < B; ++b) {
+    for (int h = 0; h < kv_heads; ++h) {
+      for (int d = 0; d < D; ++d) {
+        key_cache_data[cache_offset(b, h, context_lens[b]) + d]   = data[3][(b * kv_heads + h) * D + d];
+        value_cache_data[cache_offset(b, h, context_lens[b]) + d] = data[4][(b * kv_heads + h) * D + d];
+      }
+    }
+  }
+  EXPECT_EQ(GetTensorData<float>(scope->GetTensor(std::string(key_cache.id())), target), key_cache_data);
+  EXPECT_EQ(GetTensorData<float>(scope->GetTensor(std::string(value_cache.id())), target), value_cache_data);
+
+  std::vector<int> new_lens_data = GetTensorData<int>(scope->GetTensor(std::string(new_lens->id)), target);
+  std::vector<float> output_data = GetTensorData<float>(scope->GetTensor(std::string(output->id)), target);
+  const float scale              = 1.0f / std::sqrt(static_cast<float>(D));
+  for (int b = 0; b < B; ++b) {
+    EXPECT_EQ(new_lens_data[b], context_lens[b] + 1);
+    for (int h = 0; h < num_heads; ++h) {
+      int kv_head    = h / (num_heads / kv_heads);
+      const float* q = data[2].data() + (b * num_heads + h) * D;
+      std::vector<float> logits(new_lens_data[b]);
+      for (int t = 0; t < new_lens_data[b]; ++t) {
+        const float* k = key_cache_data.data() + cache_offset(b, kv_head, t);
+        logits[t]      = std::inner_product(q, q + D, k, 0.0f) * scale;
+      }
+      float max_logit = *std::max_element(logits.begin(), logits.end());
+      float sum       = 0.0f;
+      for (auto& logit : logits) {
+        logit = std::exp(logit - max_logit);
+        sum += logit;
+      }
+      for (int d = 0; d < D; ++d) {
+        float expect = 0.0f;
+        for (int t = 0; t < new_lens_data[b]; ++t) {
+          expect += logits[t] * value_cache_data[cache_offset(b, kv_head, t) + d];
+        }
+        EXPECT_NEAR(output_data[(b * num_heads + h) * D + d], expect / sum, 1e-4);
+      }
+    }
+  }
+}
+#endif
+
+TEST(net_build, program_execute_pack_mask) {
+  const int B = 4;
+  const int N = 70;
+  const int W = (N + 31) / 32;
+
+  NetBuilder builder("net_builder");
+  Placeholder input1 = builder.CreateInput(Float(32), {B, N}, "In1");
+  Placeholder input2 = builder.CreateInput(Float(32), {B, N}, "In2");
+  Variable words     = builder.PackMask(builder.GreaterThan(input1, input2));
+  Variable output    = builder.Cast(builder.UnpackMask(words, N), "int32");
+  auto program       = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  std::unordered_set<std::string> fetch_ids = {words->id, output->id};
+  auto graph                                = Optimize(&program, fetch_ids, target);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto input1_tensor = scope->GetTensor(std::string(input1.id()));
+  SetRandData<float>(input1_tensor, target);
+  std::vector<float> input1_data = GetTensorData<float>(input1_tensor, target);
+
+  auto input2_tensor = scope->GetTensor(std::string(input2.id()));
+  SetRandData<float>(input2_tensor, target);
+  std::vector<float> input2_data = GetTensorData<float>(input2_tensor, target);
+
+  runtime_program->Execute();
+
+  auto words_tensor = scope->GetTensor(std::string(words->id));
+  EXPECT_EQ(words_tensor->type(), Int(32));
+  EXPECT_EQ(words_tensor->shape().data(), std::vector<int>({B, W}));
+  std::vector<int> words_data  = GetTensorData<int>(words_tensor, target);
+  std::vector<int> output_data = GetTensorData<int>(scope->GetTensor(std::string(output->id)), target);
+  for (int b = 0; b < B; ++b) {
+    for (int w = 0; w < W; ++w) {
+      unsigned int expected = 0;
+      for (int bit = 0; bit < 32 && w * 32 + bit < N; ++bit) {
+        int index = b * N + w * 32 + bit;
+        expected |= static_cast<unsigned int>(input1_data[index] > input2_data[index]) << bit;
+      }
+      EXPECT_EQ(static_cast<unsigned int>(words_data[b * W + w]), expected);
+    }
+    for (int n = 0; n < N; ++n) {
+      int index = b * N + n;
+      EXPECT_EQ(output_data[index], static_cast<int>(input1_data[index] > input2_data[index]));
+    }
+  }
+}
+
 }  // namespace frontend
 }  // namespace cinn
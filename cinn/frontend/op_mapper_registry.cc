@@ -75,6 +75,10 @@ Variable OpMapperContext::GetVar(const std::string& origin_name) const {
   return Variable();
 }
 
+bool OpMapperContext::HasVar(const std::string& origin_name) const {
+  return var_map_->count(origin_name) || scope_.FindVar(cinn::utils::TransValidVarName(origin_name));
+}
+
 void OpMapperContext::AddFeedInfo(const std::string& name, const FeedInfo& info) {
   CHECK(!feed_info_map_.count(name)) << "Duplicate variable info [" << name << "] found";
   feed_info_map_[name] = info;
@@ -85,5 +89,11 @@ const OpMapperContext::FeedInfo& OpMapperContext::GetFeedInfo(const std::string&
   return feed_info_map_.at(name);
 }
 
+const paddle::cpp::BlockDesc& OpMapperContext::GetBlock(int idx) const {
+  CHECK(program_desc_) << "The program of the model is not set, the block " << idx << " can't be found";
+  CHECK(idx >= 0 && idx < program_desc_->BlocksSize()) << "The block " << idx << " is out of range";
+  return program_desc_->GetConstBlock<paddle::cpp::BlockDesc>(idx);
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -28,6 +28,7 @@
 #include "cinn/common/type.h"
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/paddle/cpp/op_desc.h"
+#include "cinn/frontend/paddle/cpp/program_desc.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/utils/registry.h"
@@ -87,6 +88,9 @@ class OpMapperContext {
   // get Variable from local var_map or scope
   Variable GetVar(const std::string& name) const;
 
+  // whether the Variable is in local var_map or scope
+  bool HasVar(const std::string& name) const;
+
   // add map from paddle name to cinn name into var_model_to_program_map
   void AddVarModelToProgram(const std::string& name, const std::string& id, bool can_inplace = true) const;
 
@@ -101,6 +105,13 @@ class OpMapperContext {
 
   const FeedInfo& GetFeedInfo(const std::string& name) const;
 
+  // the program of the model, whose sub blocks are the bodies of the control flow ops
+  void SetProgramDesc(const paddle::cpp::ProgramDesc* program_desc) { program_desc_ = program_desc; }
+
+  const paddle::cpp::ProgramDesc* ProgramDesc() const { return program_desc_; }
+
+  const paddle::cpp::BlockDesc& GetBlock(int idx) const;
+
  private:
   const hlir::framework::Scope& scope_;
   const common::Target& target_;
@@ -113,6 +124,8 @@ class OpMapperContext {
   std::unordered_set<std::string>* fetch_var_names_{nullptr};
 
   std::unordered_map<std::string, FeedInfo> feed_info_map_;
+
+  const paddle::cpp::ProgramDesc* program_desc_{nullptr};
 };
 
 class OpMapper {
@@ -0,0 +1,220 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace paddle_mappers {
+
+namespace {
+
+void RunBlockOps(const paddle::cpp::BlockDesc& block, const OpMapperContext& ctx) {
+  for (int i = 0; i < block.OpsSize(); ++i) {
+    const auto& op_desc = block.GetConstOp<paddle::cpp::OpDesc>(i);
+    auto kernel         = OpMapperRegistry::Global()->Find(op_desc.Type());
+    CHECK(kernel) << "Op [" << op_desc.Type() << "] in the block " << block.Idx() << " Not supported in OpMapper";
+    VLOG(4) << "Running Op " << op_desc.Type() << " in the block " << block.Idx();
+    kernel->Run(op_desc, ctx);
+  }
+}
+
+// The variables defined out of the block and read by its ops, which are the operands of the control flow op.
+std::vector<std::string> GetBlockInputs(const paddle::cpp::BlockDesc& block, const OpMapperContext& ctx) {
+  std::vector<std::string> inputs;
+  std::unordered_set<std::string> visited;
+  for (int i = 0; i < block.OpsSize(); ++i) {
+    const auto& op_desc = block.GetConstOp<paddle::cpp::OpDesc>(i);
+    for (const auto& param : op_desc.InputArgumentNames()) {
+      for (const auto& name : op_desc.Input(param)) {
+        if (!visited.count(name) && ctx.HasVar(name)) {
+          inputs.push_back(name);
+        }
+        visited.insert(name);
+      }
+    }
+    for (const auto& param : op_desc.OutputArgumentNames()) {
+      for (const auto& name : op_desc.Output(param)) {
+        visited.insert(name);
+      }
+    }
+  }
+  return inputs;
+}
+
+// Convert the ops of the block into the body of a control flow op, whose arguments are bound to arg_names.
+std::vector<Variable> BuildBlock(const paddle::cpp::BlockDesc& block,
+                                 const OpMapperContext& ctx,
+                                 NetBuilder* builder,
+                                 const std::vector<std::string>& arg_names,
+                                 const std::vector<Variable>& args,
+                                 const std::vector<std::string>& result_names) {
+  CHECK_EQ(arg_names.size(), args.size());
+  std::unordered_map<std::string, Variable> var_map;
+  for (size_t i = 0; i < args.size(); ++i) {
+    var_map[arg_names[i]] = args[i];
+  }
+  std::unordered_map<std::string, std::string> var_model_to_program_map;
+  std::unordered_set<std::string> fetch_var_names;
+  OpMapperContext block_ctx(ctx.Scope(), ctx.Target(), builder, &var_map, &var_model_to_program_map, &fetch_var_names);
+  block_ctx.SetProgramDesc(ctx.ProgramDesc());
+
+  RunBlockOps(block, block_ctx);
+
+  std::vector<Variable> results;
+  for (const auto& name : result_names) {
+    results.emplace_back(block_ctx.GetVar(name));
+  }
+  return results;
+}
+
+}  // namespace
+
+void ConditionalBlockOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Cond").size(), 1UL);
+  auto cond_name = op_desc.Input("Cond").front();
+  auto out_names = op_desc.Output("Out");
+
+  const auto& block        = ctx.GetBlock(utils::GetAttrOrDefault<int>(op_desc, "sub_block"));
+  auto is_scalar_condition = utils::GetAttrOrDefault<bool>(op_desc, "is_scalar_condition", false);
+  if (!is_scalar_condition) {
+    // the block runs when none of the conditions is empty, which always holds for the static shapes
+    VLOG(4) << "Inline the block " << block.Idx() << " of conditional_block with the tensor condition";
+    RunBlockOps(block, ctx);
+    return;
+  }
+
+  auto input_names = GetBlockInputs(block, ctx);
+  // the outputs defined before the op keep their values when the condition is false
+  for (const auto& name : out_names) {
+    if (ctx.HasVar(name) && std::find(input_names.begin(), input_names.end(), name) == input_names.end()) {
+      input_names.push_back(name);
+    }
+  }
+  std::vector<Variable> operands;
+  for (const auto& name : input_names) {
+    operands.emplace_back(ctx.GetVar(name));
+  }
+
+  // the then branch is built first, and the else branch fills zeros of its shapes for the new outputs
+  std::vector<Variable> then_outs;
+  auto then_branch = [&](NetBuilder* builder, const std::vector<Variable>& args) {
+    then_outs = BuildBlock(block, ctx, builder, input_names, args, out_names);
+    return then_outs;
+  };
+  auto else_branch = [&](NetBuilder* builder, const std::vector<Variable>& args) {
+    std::vector<Variable> outs;
+    for (size_t i = 0; i < out_names.size(); ++i) {
+      auto it = std::find(input_names.begin(), input_names.end(), out_names[i]);
+      if (it != input_names.end()) {
+        outs.emplace_back(args[it - input_names.begin()]);
+      } else {
+        outs.emplace_back(builder->FillConstant(then_outs[i]->shape, "0", "", common::Type2Str(then_outs[i]->type)));
+      }
+    }
+    return outs;
+  };
+
+  auto outs = ctx.Builder()->Cond(ctx.GetVar(cond_name), operands, then_branch, else_branch);
+  for (size_t i = 0; i < out_names.size(); ++i) {
+    ctx.AddVar(out_names[i], outs[i]);
+    ctx.AddVarModelToProgram(out_names[i], outs[i]->id);
+  }
+}
+
+void SelectInputOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Mask").size(), 1UL);
+  auto mask_name = op_desc.Input("Mask").front();
+  auto x_names   = op_desc.Input("X");
+  CHECK(!x_names.empty());
+  CHECK_EQ(op_desc.Output("Out").size(), 1UL);
+  auto out_name = op_desc.Output("Out").front();
+
+  auto mask = ctx.GetVar(mask_name);
+  auto out  = ctx.GetVar(x_names[0]);
+  for (int i = 1; i < x_names.size(); ++i) {
+    auto x    = ctx.GetVar(x_names[i]);
+    auto pred = ctx.Builder()->Equal(mask, ctx.Builder()->FillConstant<int>(mask->shape, i));
+    if (pred->shape != x->shape) {
+      pred = ctx.Builder()->BroadcastTo(pred, x->shape);
+    }
+    out = ctx.Builder()->Select(pred, x, out);
+  }
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void WhileOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Condition").size(), 1UL);
+  auto cond_name = op_desc.Input("Condition").front();
+
+  const auto& block = ctx.GetBlock(utils::GetAttrOrDefault<int>(op_desc, "sub_block"));
+
+  // the outputs defined before the loop are carried over the iterations, the other inputs are unchanged
+  std::vector<std::string> loop_var_names;
+  for (const auto& name : op_desc.Output("Out")) {
+    if (name != cond_name && ctx.HasVar(name) &&
+        std::find(loop_var_names.begin(), loop_var_names.end(), name) == loop_var_names.end()) {
+      loop_var_names.push_back(name);
+    }
+  }
+  CHECK(!loop_var_names.empty()) << "The while op should update at least one variable defined before it";
+  std::vector<std::string> operand_names;
+  for (const auto& name : GetBlockInputs(block, ctx)) {
+    if (std::find(loop_var_names.begin(), loop_var_names.end(), name) == loop_var_names.end()) {
+      operand_names.push_back(name);
+    }
+  }
+
+  std::vector<Variable> loop_vars, operands;
+  for (const auto& name : loop_var_names) {
+    loop_vars.emplace_back(ctx.GetVar(name));
+  }
+  for (const auto& name : operand_names) {
+    operands.emplace_back(ctx.GetVar(name));
+  }
+
+  std::vector<std::string> arg_names = loop_var_names;
+  arg_names.insert(arg_names.end(), operand_names.begin(), operand_names.end());
+  std::vector<std::string> result_names = {cond_name};
+  result_names.insert(result_names.end(), loop_var_names.begin(), loop_var_names.end());
+  auto body = [&](NetBuilder* builder, const std::vector<Variable>& args) {
+    return BuildBlock(block, ctx, builder, arg_names, args, result_names);
+  };
+
+  auto outs = ctx.Builder()->WhileLoop(ctx.GetVar(cond_name), loop_vars, operands, body);
+  for (size_t i = 0; i < loop_var_names.size(); ++i) {
+    ctx.AddVar(loop_var_names[i], outs[i]);
+    ctx.AddVarModelToProgram(loop_var_names[i], outs[i]->id);
+  }
+}
+
+}  // namespace paddle_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(paddle_control_flow) {
+  CINN_REGISTER_OP_MAPPER(conditional_block, cinn::frontend::paddle_mappers::ConditionalBlockOpMapper)
+  CINN_REGISTER_OP_MAPPER(select_input, cinn::frontend::paddle_mappers::SelectInputOpMapper)
+  CINN_REGISTER_OP_MAPPER(while, cinn::frontend::paddle_mappers::WhileOpMapper)
+  return true;
+}
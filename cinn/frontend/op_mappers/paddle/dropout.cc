@@ -28,11 +28,31 @@ void DropoutInferOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperCont
   auto dropout_prob = utils::GetAttrOrDefault<float>(op_desc, "dropout_prob", 0.5f);
   auto dropout_implementation =
       utils::GetAttrOrDefault<std::string>(op_desc, "dropout_implementation", "downgrade_in_infer");
-  auto x   = ctx.GetVar(x_name);
-  auto out = ctx.Builder()->DropoutInfer(x, dropout_prob, dropout_implementation);
+  auto x = ctx.GetVar(x_name);
 
-  ctx.AddVar(out_name, out);
-  ctx.AddVarModelToProgram(out_name, out->id);
+  auto is_test = utils::GetAttrOrDefault<bool>(op_desc, "is_test", true);
+  if (is_test) {
+    auto out = ctx.Builder()->DropoutInfer(x, dropout_prob, dropout_implementation);
+
+    ctx.AddVar(out_name, out);
+    ctx.AddVarModelToProgram(out_name, out->id);
+    return;
+  }
+
+  // the random numbers are generated inline by the kernel fused with the dropout, only the Mask for the grad is stored
+  auto fix_seed = utils::GetAttrOrDefault<bool>(op_desc, "fix_seed", false);
+  auto seed     = fix_seed ? utils::GetAttrOrDefault<int>(op_desc, "seed", 0) : 0;
+  auto outs     = ctx.Builder()->Dropout(x, dropout_prob, dropout_implementation, seed);
+
+  ctx.AddVar(out_name, outs[0]);
+  ctx.AddVarModelToProgram(out_name, outs[0]->id);
+
+  if (op_desc.HasOutput("Mask") && !op_desc.Output("Mask").empty()) {
+    auto mask_name = op_desc.Output("Mask").front();
+    auto mask      = ctx.Builder()->Cast(outs[1], "uint8");
+    ctx.AddVar(mask_name, mask);
+    ctx.AddVarModelToProgram(mask_name, mask->id);
+  }
 }
 
 }  // namespace paddle_mappers
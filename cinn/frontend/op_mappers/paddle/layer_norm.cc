@@ -15,16 +15,41 @@
 #include <absl/types/optional.h>
 
 #include <string>
+#include <vector>
 
 #include "cinn/common/context.h"
 #include "cinn/frontend/op_mapper_registry.h"
 #include "cinn/frontend/op_mappers/common_utils.h"
 #include "cinn/frontend/syntax.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace frontend {
 namespace paddle_mappers {
 
+namespace {
+// The scale and the bias of the layer_norm ops are float32, the missing ones are filled with ones and zeros.
+Variable GetNormParam(const OpMapperContext& ctx, const absl::optional<Variable>& param, int size, float value) {
+  if (!param) {
+    return ctx.Builder()->FillConstant({size}, value, common::UniqName("layer_norm_param"), "float32");
+  }
+  if (!param.value()->type.is_float(32)) {
+    return ctx.Builder()->Cast(param.value(), "float32");
+  }
+  return param.value();
+}
+
+int GetNormSize(const std::vector<int>& x_shape, int begin_norm_axis) {
+  CHECK_LT(begin_norm_axis, x_shape.size()) << "`begin_norm_axis` must be less than the dimensions of X, but received "
+                                            << begin_norm_axis;
+  int right = 1;
+  for (int i = begin_norm_axis; i < x_shape.size(); i++) {
+    right *= x_shape[i];
+  }
+  return right;
+}
+}  // namespace
+
 void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
   auto get_input = [&op_desc](const std::string& name) {
     CHECK_EQ(op_desc.Input(name).size(), 1UL);
@@ -38,11 +63,11 @@ void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext
   // get input names
   auto x_name = get_input("X");
   absl::optional<std::string> scale_name;
-  if (op_desc.HasInput("Scale")) {
+  if (op_desc.HasInput("Scale") && !op_desc.Input("Scale").empty()) {
     scale_name = get_input("Scale");
   }
   absl::optional<std::string> bias_name;
-  if (op_desc.HasInput("Bias")) {
+  if (op_desc.HasInput("Bias") && !op_desc.Input("Bias").empty()) {
     bias_name = get_input("Bias");
   }
   // get attribute values
@@ -59,95 +84,81 @@ void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext
     bias = ctx.GetVar(*bias_name);
   }
 
-  VLOG(4) << "layer_norm X=" << x_name << "[" << x << "], Scale=" << scale_name.value() << "[" << scale.value()
-          << "], Bias=" << bias_name.value() << "[" << bias.value() << "], epsilon=" << epsilon
+  VLOG(4) << "layer_norm X=" << x_name << "[" << x << "], Scale=" << scale_name.value_or("None")
+          << ", Bias=" << bias_name.value_or("None") << ", epsilon=" << epsilon
           << ", begin_norm_axis=" << begin_norm_axis;
 
-  const auto& x_shape = x->shape;
-  auto x_ndim         = x_shape.size();
-  CHECK_LT(begin_norm_axis, x_ndim) << "`begin_norm_axis` must be less than the dimensions of X, but received "
-                                    << begin_norm_axis;
-  VLOG(4) << "-- [layer_norm] begin_norm_axis = " << begin_norm_axis;
-  int left = 1;
-  for (int i = 0; i < begin_norm_axis; i++) {
-    left *= x_shape[i];
-  }
-  int right = 1;
-  for (int i = begin_norm_axis; i < x_ndim; i++) {
-    right *= x_shape[i];
-  }
-  VLOG(4) << "-- [layer_norm] left = " << left << ", right = " << right;
-
-  // compute mean
-  auto* builder = ctx.Builder();
+  // the layer_norm is decomposed by the Decomposer, or computed by the single-pass kernel on NVGPU
+  int right = GetNormSize(x->shape, begin_norm_axis);
+  auto outs = ctx.Builder()->LayerNorm(
+      x, GetNormParam(ctx, scale, right, 1.0f), GetNormParam(ctx, bias, right, 0.0f), epsilon, begin_norm_axis);
 
-  const auto& x_type = x->type;
-  if (x_type.is_float16() || x_type.is_bfloat16()) {
-    x = builder->Cast(x, "float32");
-  }
+  // get output names
+  auto y_name        = get_output("Y");
+  auto mean_name     = get_output("Mean");
+  auto variance_name = get_output("Variance");
+  // re-mapper outputs
+  ctx.AddVar(y_name, outs[0]);
+  ctx.AddVarModelToProgram(y_name, outs[0]->id);
+  ctx.AddVar(mean_name, outs[1]);
+  ctx.AddVarModelToProgram(mean_name, outs[1]->id);
+  ctx.AddVar(variance_name, outs[2]);
+  ctx.AddVarModelToProgram(variance_name, outs[2]->id);
+}
 
-  std::vector<int> shape{left, right};
-  auto x_reshape = builder->Reshape(x, shape);
-  auto x_reduce  = builder->ReduceSum(x_reshape, {1});
-  auto ele_num   = builder->FillConstant(
-      {left}, static_cast<float>(right), common::UniqName("layer_norm_ele_num"), common::Type2Str(x->type));
-  auto x_mean = builder->Divide(x_reduce, ele_num);
-
-  // use `E[|x|^2] - |E[x]|^2` instead of `E[|x - E[x]|^2])` to compute variance
-  auto x2        = builder->Multiply(x_reshape, builder->Identity(x_reshape));
-  auto x2_reduce = builder->ReduceSum(x2, {1});
-  auto x2_mean   = builder->Divide(x2_reduce, ele_num);
-  auto x_mean2   = builder->Multiply(x_mean, builder->Identity(x_mean));
-  auto zero      = builder->FillConstant({left}, 0.f, common::UniqName("layer_norm_zero"), common::Type2Str(x->type));
-  auto x_var     = builder->Max(builder->Subtract(x2_mean, x_mean2), zero);
-
-  // compute x norm
-  auto x_mean_broadcast = builder->BroadcastTo(x_mean, shape, {0});
-  auto y_sub            = builder->Subtract(x_reshape, x_mean_broadcast);
-  auto epsilon_var =
-      builder->FillConstant({left}, epsilon, common::UniqName("layer_norm_epsilon"), common::Type2Str(x->type));
-  auto x_var_eps  = builder->Add(x_var, epsilon_var);
-  auto x_var_sqrt = builder->Sqrt(x_var_eps);
-  auto y_out      = builder->Divide(y_sub, builder->BroadcastTo(x_var_sqrt, shape, {0}));
-
-  // multiply scale
-  if (scale) {
-    if (scale.value()->type.is_float16() || scale.value()->type.is_bfloat16()) {
-      scale = ctx.Builder()->Cast(scale.value(), "float32");
+void LayerNormGradOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& name) {
+    CHECK_EQ(op_desc.Input(name).size(), 1UL);
+    return ctx.GetVar(op_desc.Input(name).front());
+  };
+  auto get_output_name = [&op_desc](const std::string& name) -> std::string {
+    if (!op_desc.HasOutput(name) || op_desc.Output(name).empty()) {
+      return "";
     }
-    auto scale_broadcast = builder->BroadcastTo(*scale, shape, {1});
-    y_out                = builder->Multiply(y_out, scale_broadcast);
-  }
+    CHECK_EQ(op_desc.Output(name).size(), 1UL);
+    return op_desc.Output(name).front();
+  };
 
-  // add bias
-  if (bias) {
-    if (bias.value()->type.is_float16() || bias.value()->type.is_bfloat16()) {
-      bias = ctx.Builder()->Cast(bias.value(), "float32");
-    }
-    auto bias_broadcast = builder->BroadcastTo(*bias, shape, {1});
-    y_out               = builder->Add(y_out, bias_broadcast);
+  auto x        = get_input_var("X");
+  auto mean     = get_input_var("Mean");
+  auto variance = get_input_var("Variance");
+  auto dy       = get_input_var(paddle::GradVarName("Y"));
+  absl::optional<Variable> scale;
+  if (op_desc.HasInput("Scale") && !op_desc.Input("Scale").empty()) {
+    scale = get_input_var("Scale");
+  }
+  absl::optional<Variable> bias;
+  if (op_desc.HasInput("Bias") && !op_desc.Input("Bias").empty()) {
+    bias = get_input_var("Bias");
   }
 
-  // reshape to the original shape
-  y_out = builder->Reshape(y_out, x_shape);
+  auto epsilon         = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-5f);
+  auto begin_norm_axis = utils::GetAttrOrDefault<int>(op_desc, "begin_norm_axis", 1);
 
-  if (x_type.is_float16()) {
-    y_out = builder->Cast(y_out, "float16");
-  } else if (x_type.is_bfloat16()) {
-    y_out = builder->Cast(y_out, "bfloat16");
+  std::vector<std::string> output_names = {get_output_name(paddle::GradVarName("X")),
+                                           get_output_name(paddle::GradVarName("Scale")),
+                                           get_output_name(paddle::GradVarName("Bias"))};
+  VLOG(4) << "{" << cinn::utils::Join(output_names, ", ") << "} = layer_norm_grad(X=" << x->id << ", dY=" << dy->id
+          << ", epsilon=" << epsilon << ", begin_norm_axis=" << begin_norm_axis << ")";
+
+  int right = GetNormSize(x->shape, begin_norm_axis);
+  auto outs = ctx.Builder()->LayerNormGrad(
+      dy, x, GetNormParam(ctx, scale, right, 1.0f), mean, variance, epsilon, begin_norm_axis);
+  CHECK_EQ(outs.size(), 3UL) << "layer_norm_grad APIs should return 3 Variable!";
+
+  // the gradients of the parameters have the dtype of the parameters
+  std::vector<absl::optional<Variable>> params = {absl::nullopt, scale, bias};
+  for (int i = 0; i < outs.size(); i++) {
+    if (output_names[i].empty()) {
+      continue;
+    }
+    auto out = outs[i];
+    if (params[i] && params[i].value()->type != out->type) {
+      out = ctx.Builder()->Cast(out, common::Type2Str(params[i].value()->type));
+    }
+    ctx.AddVar(output_names[i], out);
+    ctx.AddVarModelToProgram(output_names[i], out->id);
   }
-
-  // get output names
-  auto y_name        = get_output("Y");
-  auto mean_name     = get_output("Mean");
-  auto variance_name = get_output("Variance");
-  // re-mapper outputs
-  ctx.AddVar(y_name, y_out);
-  ctx.AddVarModelToProgram(y_name, y_out->id);
-  ctx.AddVar(mean_name, x_mean);
-  ctx.AddVarModelToProgram(mean_name, x_mean->id);
-  ctx.AddVar(variance_name, x_var);
-  ctx.AddVarModelToProgram(variance_name, x_var->id);
 }
 
 }  // namespace paddle_mappers
@@ -156,5 +167,6 @@ void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext
 
 CINN_REGISTER_HELPER(paddle_layer_norm) {
   CINN_REGISTER_OP_MAPPER(layer_norm, cinn::frontend::paddle_mappers::LayerNormOpMapper)
+  CINN_REGISTER_OP_MAPPER(layer_norm_grad, cinn::frontend::paddle_mappers::LayerNormGradOpMapper)
   return true;
 }
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace paddle_mappers {
+
+// The quantize_linear and dequantize_linear of the paddle quantized models are symmetric, so the ZeroPoint is ignored.
+void QuantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Input("Scale").size(), 1UL);
+  auto scale_name = op_desc.Input("Scale").front();
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+
+  auto quant_axis = utils::GetAttrOrDefault<int>(op_desc, "quant_axis", -1);
+  auto bit_length = utils::GetAttrOrDefault<int>(op_desc, "bit_length", 8);
+
+  auto x     = ctx.GetVar(x_name);
+  auto scale = ctx.GetVar(scale_name);
+  auto out   = ctx.Builder()->QuantizeLinear(x, scale, quant_axis, bit_length);
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void DequantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Input("Scale").size(), 1UL);
+  auto scale_name = op_desc.Input("Scale").front();
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+
+  auto quant_axis = utils::GetAttrOrDefault<int>(op_desc, "quant_axis", -1);
+  auto bit_length = utils::GetAttrOrDefault<int>(op_desc, "bit_length", 8);
+
+  auto x = ctx.GetVar(x_name);
+  // the weights of the quantized models may be saved in float with the integer values
+  if (!x->type.is_int(8)) {
+    x = ctx.Builder()->Cast(x, "int8");
+  }
+  auto scale = ctx.GetVar(scale_name);
+  auto out   = ctx.Builder()->DequantizeLinear(x, scale, quant_axis, bit_length);
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+}  // namespace paddle_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(paddle_quantize) {
+  CINN_REGISTER_OP_MAPPER(quantize_linear, cinn::frontend::paddle_mappers::QuantizeLinearOpMapper)
+  CINN_REGISTER_OP_MAPPER(dequantize_linear, cinn::frontend::paddle_mappers::DequantizeLinearOpMapper)
+  return true;
+}
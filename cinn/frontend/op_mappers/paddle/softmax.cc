@@ -34,11 +34,54 @@ void SoftmaxOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext&
   ctx.AddVarModelToProgram(out_name, out->id);
 }
 
+// Only the hard label along the last axis is computed by the fused softmax_cross_entropy, the soft label is computed
+// by the log of the softmax.
+void SoftmaxWithCrossEntropyOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Logits").size(), 1UL);
+  auto logits_name = op_desc.Input("Logits").front();
+  CHECK_EQ(op_desc.Input("Label").size(), 1UL);
+  auto label_name = op_desc.Input("Label").front();
+  CHECK_EQ(op_desc.Output("Softmax").size(), 1UL);
+  auto softmax_name = op_desc.Output("Softmax").front();
+  CHECK_EQ(op_desc.Output("Loss").size(), 1UL);
+  auto loss_name = op_desc.Output("Loss").front();
+
+  auto soft_label   = utils::GetAttrOrDefault<bool>(op_desc, "soft_label", false);
+  auto use_softmax  = utils::GetAttrOrDefault<bool>(op_desc, "use_softmax", true);
+  auto ignore_index = utils::GetAttrOrDefault<int>(op_desc, "ignore_index", -100);
+  auto axis         = utils::GetAttrOrDefault<int>(op_desc, "axis", -1);
+  CHECK(use_softmax) << "The softmax_with_cross_entropy without softmax is not supported yet.";
+
+  auto logits = ctx.GetVar(logits_name);
+  auto label  = ctx.GetVar(label_name);
+  if (axis < 0) {
+    axis += logits->shape.size();
+  }
+  Variable softmax, loss;
+  if (soft_label) {
+    softmax = ctx.Builder()->Softmax(logits, {axis}, "accurate");
+    loss    = ctx.Builder()->Negative(
+        ctx.Builder()->ReduceSum(ctx.Builder()->Multiply(label, ctx.Builder()->Log(softmax)), {axis}, true));
+  } else {
+    CHECK_EQ(axis, logits->shape.size() - 1)
+        << "The softmax_with_cross_entropy of the hard label only supports the last axis.";
+    auto outs = ctx.Builder()->SoftmaxCrossEntropy(logits, label, ignore_index);
+    softmax   = outs[0];
+    loss      = outs[1];
+  }
+
+  ctx.AddVar(softmax_name, softmax);
+  ctx.AddVarModelToProgram(softmax_name, softmax->id);
+  ctx.AddVar(loss_name, loss);
+  ctx.AddVarModelToProgram(loss_name, loss->id);
+}
+
 }  // namespace paddle_mappers
 }  // namespace frontend
 }  // namespace cinn
 
 CINN_REGISTER_HELPER(paddle_softmax) {
   CINN_REGISTER_OP_MAPPER(softmax, cinn::frontend::paddle_mappers::SoftmaxOpMapper)
+  CINN_REGISTER_OP_MAPPER(softmax_with_cross_entropy, cinn::frontend::paddle_mappers::SoftmaxWithCrossEntropyOpMapper)
   return true;
 }
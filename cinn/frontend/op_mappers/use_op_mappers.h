@@ -65,6 +65,8 @@ CINN_USE_REGISTER(paddle_randint)
 CINN_USE_REGISTER(paddle_roll)
 CINN_USE_REGISTER(paddle_cholesky)
 CINN_USE_REGISTER(paddle_scatter)
+CINN_USE_REGISTER(paddle_quantize)
+CINN_USE_REGISTER(paddle_control_flow)
 
 CINN_USE_REGISTER(science_broadcast)
 CINN_USE_REGISTER(science_transform)
@@ -30,13 +30,27 @@
 #include "cinn/runtime/flags.h"
 
 DECLARE_bool(cinn_use_fill_constant_folding);
+DECLARE_bool(cinn_use_fused_attention);
+DECLARE_bool(cinn_use_fp8_matmul);
+DECLARE_bool(cinn_use_sparse_matmul);
+DECLARE_bool(cinn_use_nvgpu_channels_last);
 DECLARE_bool(cinn_use_op_fusion);
 DECLARE_bool(cinn_use_common_subexpression_elimination);
 DECLARE_string(cinn_check_fusion_accuracy_pass);
 DECLARE_bool(cinn_use_custom_call);
 DECLARE_bool(use_reduce_split_pass);
+DECLARE_double(cinn_reduce_split_min_occupancy);
 DECLARE_bool(cinn_use_dense_merge_pass);
+DECLARE_bool(cinn_use_transpose_sinking);
+DECLARE_bool(cinn_use_grouped_gemm);
+DECLARE_bool(cinn_use_weight_prerun);
+DECLARE_bool(cinn_use_multi_tensor_update_pass);
+DECLARE_bool(cinn_use_cublaslt);
+DECLARE_bool(cinn_use_conv_implicit_gemm);
+DECLARE_bool(cinn_use_tiled_depthwise_conv);
 DECLARE_string(cinn_custom_call_deny_ops);
+DECLARE_int64(cinn_recompute_memory_budget_mb);
+DECLARE_string(cinn_amp_dtype);
 
 namespace cinn {
 namespace frontend {
@@ -44,6 +58,59 @@ namespace frontend {
 OptimizeOptions DefaultTrainingOptimizeOptions() {
   OptimizeOptions options;
   options.program_passes.emplace_back("ExpandZeroDim");
+#ifdef CINN_WITH_CUDA
+  // the softmax of the attention is broken down by the Decomposer, so the pattern is matched before it
+  if (FLAGS_cinn_use_fused_attention && FLAGS_cinn_use_custom_call &&
+      FLAGS_cinn_custom_call_deny_ops.find("fused_attention") == std::string::npos) {
+    options.program_passes.emplace_back("FusedAttentionRewriter");
+  }
+  // the RMSNorm written by the primitive ops is computed by the single-pass kernel of the rms_norm
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("rms_norm") == std::string::npos) {
+    options.program_passes.emplace_back("RMSNormRewriter");
+  }
+  // the softmax along the last axis is computed by the online softmax kernel with its scale, mask and log fused
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("fused_softmax") == std::string::npos) {
+    options.program_passes.emplace_back("SoftmaxRewriter");
+  }
+#endif
+#ifdef CINN_WITH_CUDA
+  // the int8 matmul folded from the dequantize_linear of its inputs is computed by cublas
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("cublas_matmul") == std::string::npos) {
+    options.program_passes.emplace_back("QuantizeFolding");
+  }
+#elif defined(CINN_WITH_MKLDNN)
+  options.program_passes.emplace_back("QuantizeFolding");
+#endif
+#ifdef CINN_WITH_CUDA
+  // the gather of the whole rows by many indices is computed by the vectorized kernel of the lookup_table
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("lookup_table") == std::string::npos) {
+    options.program_passes.emplace_back("GatherRowsRewriter");
+  }
+  // the argmax and the argmin are computed with the reduce of the same axis by the single-pass kernel of arg_reduce
+  if (FLAGS_cinn_use_custom_call && FLAGS_cinn_custom_call_deny_ops.find("arg_reduce") == std::string::npos) {
+    options.program_passes.emplace_back("ArgReduceRewriter");
+  }
+  // the float matmul is quantized into fp8 before the AutoCast, which computes the ops of the fp8 inputs in float32
+  if (FLAGS_cinn_use_fp8_matmul && FLAGS_cinn_use_custom_call &&
+      FLAGS_cinn_custom_call_deny_ops.find("fp8_matmul") == std::string::npos) {
+    options.program_passes.emplace_back("Fp8MatmulRewriter");
+  }
+#endif
+#ifdef CINN_WITH_CUSPARSELT
+  // the weight of the sparse_matmul is compressed once by its address, so it should be kept by the weight prerun
+  if (FLAGS_cinn_use_sparse_matmul && FLAGS_cinn_use_weight_prerun && FLAGS_cinn_use_custom_call &&
+      FLAGS_cinn_custom_call_deny_ops.find("sparse_matmul") == std::string::npos) {
+    options.program_passes.emplace_back("SparseMatmulRewriter");
+  }
+#endif
+  // the batch_norm is broken down by the Decomposer, so it is folded into the conv2d before it
+  if (FLAGS_cinn_use_weight_prerun) {
+    options.program_passes.emplace_back("ConvBnFolding");
+  }
+  // the float32 program is rewritten into the mixed precision, and its casts are collapsed by the CastCollapsing
+  if (!FLAGS_cinn_amp_dtype.empty()) {
+    options.program_passes.emplace_back("AutoMixedPrecision");
+  }
   options.program_passes.emplace_back("AutoCast");
   options.program_passes.emplace_back("Decomposer");
   options.program_passes.emplace_back("RemoveIdentity");
@@ -74,22 +141,74 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
   }
   options.program_passes.emplace_back("RemoveIdentity");
   options.program_passes.emplace_back("DeadCodeEliminate");
+  // the cheap variables held from the forward to the backward are recomputed to fit the memory budget
+  if (FLAGS_cinn_recompute_memory_budget_mb > 0) {
+    options.program_passes.emplace_back("Recompute");
+  }
 
-  options.graph_passes = {"ConstantFolding"};
+  options.graph_passes = {};
+#ifdef CINN_WITH_CUDA
+  // the conv2d must be altered before it is translated to the custom_call
+  if (FLAGS_cinn_use_nvgpu_channels_last) {
+    options.graph_passes.emplace_back("AlterLayout");
+  }
+#endif
+  options.graph_passes.emplace_back("ConstantFolding");
+  if (FLAGS_cinn_use_transpose_sinking) {
+    options.graph_passes.emplace_back("TransposeSinkingPass");
+  }
+  if (FLAGS_cinn_use_weight_prerun) {
+    options.graph_passes.emplace_back("ConstPropagate");
+  }
   if (FLAGS_cinn_use_dense_merge_pass) {
     options.graph_passes.push_back("DenseMergePass");
   }
+#ifdef CINN_WITH_CUDA
+  if (FLAGS_cinn_use_grouped_gemm) {
+    options.graph_passes.emplace_back("DotMerger");
+  }
+#endif
 
   if (FLAGS_cinn_use_custom_call) {
     options.graph_passes.emplace_back("TransToCustomCallPass");
+#ifdef CINN_WITH_CUDA
+    if (FLAGS_cinn_use_cublaslt) {
+      options.graph_passes.emplace_back("CublasLtEpiloguePass");
+    }
+#endif
+  }
+
+#ifdef CINN_WITH_CUDA
+  // the passes only rewrite the conv2d and depthwise_conv2d left by TransToCustomCallPass
+  if (FLAGS_cinn_use_conv_implicit_gemm) {
+    options.graph_passes.emplace_back("ConvImplicitGemmPass");
+  }
+  if (FLAGS_cinn_use_tiled_depthwise_conv) {
+    options.graph_passes.emplace_back("DepthwiseConvTilingPass");
   }
+#endif
+
+#ifdef CINN_WITH_MKLDNN
+  // the pass only rewrites the conv2d and matmul lowered to oneDNN on x86
+  options.graph_passes.emplace_back("MkldnnPostOpsPass");
+#endif
 
-  if (FLAGS_cinn_use_common_subexpression_elimination) {
+  // the recomputed instructions would be merged back by the common subexpression elimination
+  if (FLAGS_cinn_use_common_subexpression_elimination && FLAGS_cinn_recompute_memory_budget_mb <= 0) {
     options.graph_passes.emplace_back("CommonSubexpressionEliminationPass");
   }
 
+  if (FLAGS_cinn_use_multi_tensor_update_pass) {
+    options.graph_passes.emplace_back("MultiTensorUpdatePass");
+  }
+
   // this pass should be applied before merge
-  if (FLAGS_use_reduce_split_pass) {
+  bool use_reduce_split_pass = FLAGS_use_reduce_split_pass;
+#ifdef CINN_WITH_CUDA
+  // only the reductions of low occupancy are split
+  use_reduce_split_pass = use_reduce_split_pass || FLAGS_cinn_reduce_split_min_occupancy > 0;
+#endif
+  if (use_reduce_split_pass) {
     options.graph_passes.emplace_back("ReduceSplit");
   }
 
@@ -102,6 +221,8 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
 
 #ifdef CINN_WITH_CUDA
   options.graph_passes.emplace_back("SingleGroupOptimizePass");
+  // the collective ops off the compute stream are issued early to overlap with the groups independent of them
+  options.graph_passes.emplace_back("CollectiveSchedulePass");
 #endif
 
   // WARNING: the pass must be the last pass !!!
@@ -14,7 +14,15 @@
 
 #include "cinn/frontend/paddle/model_parser.h"
 
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <fstream>
+#include <mutex>
 #include <vector>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -23,6 +31,11 @@
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
+#include "cinn/hlir/framework/weight_store.h"
+#include "cinn/utils/multi_threading.h"
+
+DECLARE_int32(cinn_load_params_num_threads);
+DECLARE_bool(cinn_share_weights);
 
 namespace cinn::frontend::paddle {
 
@@ -33,8 +46,8 @@ int SizeOfType(framework_proto::VarType::Type type) {
   case Type::VarType_Type_##desc: \
     return sizeof(type);
     DO(BOOL, bool);
-    DO(BF16, float);
-    DO(FP16, float);
+    DO(BF16, uint16_t);
+    DO(FP16, uint16_t);
     DO(FP32, float);
     DO(INT8, int8_t);
     DO(INT16, int16_t);
@@ -72,7 +85,7 @@ void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const
   void *buf;
   size_t size = tensor->shape().numel() * SizeOfType(desc.data_type());
   // alllocate memory
-  if (target.arch == Target::Arch::X86) {
+  if (target.is_cpu()) {
     switch (static_cast<int>(desc.data_type())) {
 #define SET_TENSOR(desc, type, precision)     \
   case Type::VarType_Type_##desc:             \
@@ -128,6 +141,9 @@ void LoadLoDTensor(std::istream &is, hlir::framework::Variable *var, const commo
   }
 
   TensorFromStream(is, tensor.operator->(), target);
+  if (FLAGS_cinn_share_weights) {
+    hlir::framework::WeightStore::Global().Share(tensor, target);
+  }
 }
 
 void ReadBinaryFile(const std::string &filename, std::string *contents) {
@@ -145,9 +161,8 @@ void ReadBinaryFile(const std::string &filename, std::string *contents) {
 std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string &path, bool program_from_memory) {
   std::unique_ptr<framework_proto::ProgramDesc> main_program(new framework_proto::ProgramDesc);
   if (!program_from_memory) {
-    std::string desc_str;
-    ReadBinaryFile(path, &desc_str);
-    main_program->ParseFromString(desc_str);
+    MappedFile file(path);
+    main_program->ParseFromArray(file.data(), file.size());
   } else {
     main_program->ParseFromString(path);
   }
@@ -205,6 +220,8 @@ void LoadCombinedParamsPb(const std::string &path,
   if (params_from_memory) {
     std::stringstream fin(path, std::ios::in | std::ios::binary);
     load_var_func(fin);
+  } else if (FLAGS_cinn_load_params_num_threads > 0) {
+    LoadCombinedParamsMapped(path, scope, paramlist, target);
   } else {
     std::ifstream fin(path, std::ios::binary);
     CHECK(fin.is_open());
@@ -212,6 +229,285 @@ void LoadCombinedParamsPb(const std::string &path,
   }
 }
 
+namespace {
+
+// The chunk size of the pinned staging buffer, which is double buffered so that the copy from the mapped file to the
+// pinned memory overlaps with the copy from the pinned memory to the device.
+constexpr size_t kParamStagingChunk = 16UL << 20;
+
+common::Type TypeOfVarType(framework_proto::VarType::Type type) {
+  using Type = framework_proto::VarType::Type;
+  switch (static_cast<int>(type)) {
+    case Type::VarType_Type_BOOL:
+      return common::Bool();
+    case Type::VarType_Type_BF16:
+      return common::BFloat16();
+    case Type::VarType_Type_FP16:
+      return common::Float16();
+    case Type::VarType_Type_FP32:
+      return common::Float(32);
+    case Type::VarType_Type_INT8:
+      return common::Int(8);
+    case Type::VarType_Type_INT16:
+      return common::Int(16);
+    case Type::VarType_Type_INT32:
+      return common::Int(32);
+    case Type::VarType_Type_INT64:
+      return common::Int(64);
+    default:
+      LOG(FATAL) << "unknown data type " << type;
+  }
+  return common::Type();
+}
+
+// The data of a LoDTensor in a mapped file, the tensor of the parameter is allocated after the header is parsed.
+struct ParamRecord {
+  hlir::framework::_Tensor_* tensor;
+  const char* data;
+  size_t bytes;
+};
+
+// Parse the header of the LoDTensor at the beginning of data in the same format as LoadLoDTensor, allocate the tensor,
+// and return the size of the whole LoDTensor.
+size_t ParseLoDTensor(const char* data,
+                      size_t size,
+                      hlir::framework::_Tensor_* tensor,
+                      const common::Target& target,
+                      ParamRecord* record) {
+  size_t offset = 0;
+  auto read     = [&](void* dst, size_t bytes) {
+    CHECK_LE(offset + bytes, size) << "There is a problem with loading model parameters: the file is truncated";
+    std::memcpy(dst, data + offset, bytes);
+    offset += bytes;
+  };
+  uint32_t version;
+  read(&version, sizeof(version));
+  uint64_t lod_level;
+  read(&lod_level, sizeof(lod_level));
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t lod_size;
+    read(&lod_size, sizeof(lod_size));
+    CHECK_LE(offset + lod_size, size) << "There is a problem with loading model parameters: the file is truncated";
+    offset += lod_size;
+  }
+
+  read(&version, sizeof(version));
+  CHECK_EQ(version, 0U) << "Only version 0 is supported";
+  int32_t desc_size;
+  read(&desc_size, sizeof(desc_size));
+  CHECK_LE(offset + desc_size, size) << "There is a problem with loading model parameters: the file is truncated";
+  framework_proto::VarType::TensorDesc desc;
+  CHECK(desc.ParseFromArray(data + offset, desc_size)) << "Cannot parse tensor desc";
+  offset += desc_size;
+
+  std::vector<int32_t> dims_vec(desc.dims().begin(), desc.dims().end());
+  tensor->Resize(hlir::framework::Shape(dims_vec));
+  auto type     = TypeOfVarType(desc.data_type());
+  record->bytes = static_cast<size_t>(tensor->shape().numel()) * type.bytes();
+  CHECK_LE(offset + record->bytes, size) << "There is a problem with loading model parameters: the file is truncated";
+  tensor->set_type(type);
+  record->tensor = tensor;
+  record->data   = data + offset;
+  return offset + record->bytes;
+}
+
+#ifdef CINN_WITH_CUDA
+// The pinned staging buffers with their own streams, each is taken by one loading thread at a time.
+class ParamStagingPool {
+ public:
+  explicit ParamStagingPool(int num_buffers) {
+    buffers_.resize(num_buffers);
+    for (auto& buffer : buffers_) {
+      CUDA_CALL(cudaMallocHost(&buffer.host, 2 * kParamStagingChunk));
+      CUDA_CALL(cudaStreamCreateWithFlags(&buffer.stream, cudaStreamNonBlocking));
+      for (auto& event : buffer.events) {
+        CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+      }
+      free_.push_back(&buffer);
+    }
+  }
+
+  ~ParamStagingPool() {
+    for (auto& buffer : buffers_) {
+      CUDA_CALL(cudaStreamSynchronize(buffer.stream));
+      for (auto& event : buffer.events) {
+        CUDA_CALL(cudaEventDestroy(event));
+      }
+      CUDA_CALL(cudaStreamDestroy(buffer.stream));
+      CUDA_CALL(cudaFreeHost(buffer.host));
+    }
+  }
+
+  // Copy the record to the device through the two halves of a staging buffer alternately.
+  void Copy(const ParamRecord& record) {
+    auto* buffer = Acquire();
+    auto* dst    = static_cast<char*>(reinterpret_cast<void*>(record.tensor->buffer()->memory));
+    for (size_t offset = 0, chunk = 0; offset < record.bytes; offset += kParamStagingChunk, chunk ^= 1) {
+      size_t bytes = std::min(kParamStagingChunk, record.bytes - offset);
+      char* host   = static_cast<char*>(buffer->host) + chunk * kParamStagingChunk;
+      // wait for the previous copy from this half to finish
+      CUDA_CALL(cudaEventSynchronize(buffer->events[chunk]));
+      std::memcpy(host, record.data + offset, bytes);
+      CUDA_CALL(cudaMemcpyAsync(dst + offset, host, bytes, cudaMemcpyHostToDevice, buffer->stream));
+      CUDA_CALL(cudaEventRecord(buffer->events[chunk], buffer->stream));
+    }
+    Release(buffer);
+  }
+
+ private:
+  struct StagingBuffer {
+    void* host;
+    cudaStream_t stream;
+    cudaEvent_t events[2];
+  };
+
+  StagingBuffer* Acquire() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CHECK(!free_.empty()) << "More loading threads than the staging buffers";
+    auto* buffer = free_.back();
+    free_.pop_back();
+    return buffer;
+  }
+
+  void Release(StagingBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    free_.push_back(buffer);
+  }
+
+  std::vector<StagingBuffer> buffers_;
+  std::vector<StagingBuffer*> free_;
+  std::mutex mtx_;
+};
+#endif
+
+// Allocate the tensors of the records, the ones with the same data as the parameters loaded before share their buffers
+// instead, and they are removed from the records since nothing is left to copy.
+void AllocateParamRecords(std::vector<ParamRecord>* records, const common::Target& target) {
+  auto& store = hlir::framework::WeightStore::Global();
+  size_t kept = 0;
+  for (auto& record : *records) {
+    auto* tensor = record.tensor;
+    if (FLAGS_cinn_share_weights) {
+      auto shared = store.Find(record.data, record.bytes, tensor->type(), tensor->shape().data(), target);
+      if (shared) {
+        tensor->set_buffer(shared);
+        continue;
+      }
+    }
+    tensor->mutable_data(target, tensor->type());
+    (*records)[kept++] = record;
+  }
+  VLOG(3) << "Share " << records->size() - kept << " parameters with the ones loaded before";
+  records->resize(kept);
+}
+
+// Add the buffers of the copied records to the store, so that the following models can share them.
+void InsertParamRecords(const std::vector<ParamRecord>& records, const common::Target& target) {
+  if (!FLAGS_cinn_share_weights) {
+    return;
+  }
+  auto& store = hlir::framework::WeightStore::Global();
+  for (auto& record : records) {
+    auto* tensor = record.tensor;
+    auto buffer  = tensor->get_buffer();
+    auto shared  = store.Insert(buffer, record.data, record.bytes, tensor->type(), tensor->shape().data(), target);
+    if (shared != buffer) {
+      tensor->set_buffer(shared);
+    }
+  }
+}
+
+// Copy the data of the records into the allocated tensors by a pool of threads.
+void CopyParamRecords(const std::vector<ParamRecord>& records, const common::Target& target) {
+  int num_threads = std::max(std::min<int>(FLAGS_cinn_load_params_num_threads, records.size()), 1);
+  if (target.is_cpu()) {
+    utils::parallel_run(
+        [&](int index) {
+          auto& record = records[index];
+          std::memcpy(reinterpret_cast<void*>(record.tensor->buffer()->memory), record.data, record.bytes);
+        },
+        utils::SequenceDispatcher(0, records.size()),
+        num_threads);
+  } else if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    int device_id;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    ParamStagingPool pool(num_threads);
+    utils::parallel_run(
+        [&](int index) {
+          CUDA_CALL(cudaSetDevice(device_id));
+          pool.Copy(records[index]);
+        },
+        utils::SequenceDispatcher(0, records.size()),
+        num_threads);
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path) {
+  fd_ = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd_, 0) << "Cannot open file: " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd_, &st), 0) << "Cannot stat file: " << path;
+  size_ = st.st_size;
+  if (size_ > 0) {
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    CHECK(data_ != MAP_FAILED) << "Cannot mmap file: " << path;
+    // the file is read through once from the beginning to the end
+    madvise(data_, size_, MADV_SEQUENTIAL | MADV_WILLNEED);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data_ && data_ != MAP_FAILED) {
+    munmap(data_, size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void LoadCombinedParamsMapped(const std::string& path,
+                              hlir::framework::Scope* scope,
+                              const std::vector<std::string>& param_names,
+                              const common::Target& target) {
+  MappedFile file(path);
+  std::vector<ParamRecord> records(param_names.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < param_names.size(); ++i) {
+    auto* var    = scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(param_names[i]));
+    auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+    offset += ParseLoDTensor(file.data() + offset, file.size() - offset, tensor.operator->(), target, &records[i]);
+  }
+  CHECK_EQ(offset, file.size()) << "You are not allowed to load partial data via"
+                                << " LoadCombinedParamsPb, use LoadParam instead.";
+  AllocateParamRecords(&records, target);
+  CopyParamRecords(records, target);
+  InsertParamRecords(records, target);
+}
+
+void LoadSeparateParamsMapped(const std::vector<std::pair<std::string, std::string>>& name_and_paths,
+                              hlir::framework::Scope* scope,
+                              const common::Target& target) {
+  std::vector<std::unique_ptr<MappedFile>> files;
+  std::vector<ParamRecord> records(name_and_paths.size());
+  for (size_t i = 0; i < name_and_paths.size(); ++i) {
+    files.emplace_back(new MappedFile(name_and_paths[i].second));
+    auto* var    = scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(name_and_paths[i].first));
+    auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+    ParseLoDTensor(files.back()->data(), files.back()->size(), tensor.operator->(), target, &records[i]);
+  }
+  AllocateParamRecords(&records, target);
+  CopyParamRecords(records, target);
+  InsertParamRecords(records, target);
+}
+
 void LoadModelPb(const std::string &model_dir,
                  const std::string &model_file,
                  const std::string &param_file,
@@ -249,20 +545,23 @@ void LoadModelPb(const std::string &model_dir,
     LoadCombinedParamsPb(param_file_temp, scope, *cpp_prog, model_from_memory, target);
   } else {
     auto main_block = pb_proto_prog.blocks(0);
+    std::vector<std::pair<std::string, std::string>> name_and_paths;
     for (auto &var : main_block.vars()) {
       if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
 
       std::string file_path = model_dir + "/" + var.name();
       VLOG(4) << "reading weight " << var.name();
+      CHECK(var.type().type() == framework_proto::VarType_Type_LOD_TENSOR) << "unknown weight type";
 
-      std::ifstream file(file_path, std::ios::binary);
-      switch (var.type().type()) {
-        case framework_proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
-          break;
-        default:
-          LOG(FATAL) << "unknown weight type";
+      if (FLAGS_cinn_load_params_num_threads > 0) {
+        name_and_paths.emplace_back(var.name(), file_path);
+        continue;
       }
+      std::ifstream file(file_path, std::ios::binary);
+      LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
+    }
+    if (!name_and_paths.empty()) {
+      LoadSeparateParamsMapped(name_and_paths, scope, target);
     }
   }
 
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/frontend/paddle/cpp/program_desc.h"
@@ -56,6 +57,34 @@ void LoadCombinedParamsPb(const std::string& path,
                           bool params_from_memory      = false,
                           const common::Target& target = common::DefaultHostTarget());
 
+// A read-only view of a whole file mapped into memory, whose pages are read in by the OS on demand.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  int fd_{-1};
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+// Load the parameters from the memory-mapped files: the tensor headers are parsed once to allocate the tensors, then
+// the data are copied into the tensors by FLAGS_cinn_load_params_num_threads threads, through the double-buffered
+// pinned staging buffers on NVGPU.
+void LoadCombinedParamsMapped(const std::string& path,
+                              hlir::framework::Scope* scope,
+                              const std::vector<std::string>& param_names,
+                              const common::Target& target = common::DefaultHostTarget());
+void LoadSeparateParamsMapped(const std::vector<std::pair<std::string, std::string>>& name_and_paths,
+                              hlir::framework::Scope* scope,
+                              const common::Target& target = common::DefaultHostTarget());
+
 // LoDTensor to ostream
 void TensorToStream(std::ostream& os, const hlir::framework::_Tensor_& tensor);
 void TensorFromStream(std::istream& is,
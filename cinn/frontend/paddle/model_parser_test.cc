@@ -17,6 +17,11 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
 DEFINE_string(model_dir, "<NOTEXIST>", "model directory path");
 
 namespace cinn::frontend::paddle {
@@ -42,4 +47,59 @@ TEST(LoadModelPb, naive_model) {
   // fetch
 }
 
+namespace {
+template <typename T>
+void WriteLoDTensor(std::ostream& os,
+                    const std::vector<int64_t>& dims,
+                    framework_proto::VarType::Type type,
+                    const std::vector<T>& data) {
+  uint32_t version   = 0;
+  uint64_t lod_level = 0;
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  os.write(reinterpret_cast<const char*>(&lod_level), sizeof(lod_level));
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  framework_proto::VarType::TensorDesc desc;
+  desc.set_data_type(type);
+  for (auto dim : dims) {
+    desc.add_dims(dim);
+  }
+  auto desc_str     = desc.SerializeAsString();
+  int32_t desc_size = desc_str.size();
+  os.write(reinterpret_cast<const char*>(&desc_size), sizeof(desc_size));
+  os.write(desc_str.data(), desc_size);
+  os.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+}  // namespace
+
+TEST(LoadCombinedParamsMapped, host) {
+  std::vector<float> weight(6 * 7);
+  std::vector<int64_t> ids(5);
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = 0.5f * i;
+  for (size_t i = 0; i < ids.size(); ++i) ids[i] = 100 + i;
+
+  std::string path = "./test_combined_params";
+  {
+    std::ofstream fout(path, std::ios::binary);
+    WriteLoDTensor(fout, {6, 7}, framework_proto::VarType::FP32, weight);
+    WriteLoDTensor(fout, {5}, framework_proto::VarType::INT64, ids);
+  }
+
+  hlir::framework::Scope scope;
+  LoadCombinedParamsMapped(path, &scope, {"a_weight", "b_ids"});
+  std::remove(path.c_str());
+
+  auto weight_tensor = scope.GetTensor("a_weight");
+  ASSERT_EQ(weight_tensor->shape().data(), (std::vector<int>{6, 7}));
+  ASSERT_EQ(weight_tensor->type(), Float(32));
+  for (size_t i = 0; i < weight.size(); ++i) {
+    ASSERT_EQ(weight_tensor->data<float>()[i], weight[i]);
+  }
+  auto ids_tensor = scope.GetTensor("b_ids");
+  ASSERT_EQ(ids_tensor->shape().data(), (std::vector<int>{5}));
+  ASSERT_EQ(ids_tensor->type(), Int(64));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(ids_tensor->data<int64_t>()[i], ids[i]);
+  }
+}
+
 }  // namespace cinn::frontend::paddle
@@ -58,6 +58,8 @@ void PaddleModelConvertor::PrepareRun(const paddle::cpp::BlockDesc& block_desc,
     var_desc_map[var_desc.Name()] = &var_desc;
   }
 
+  // most ops are mapped to one instruction at least
+  ctx->Builder()->Reserve(ctx->Builder()->size() + block_desc.OpsSize());
   for (int i = 0; i < block_desc.OpsSize(); i++) {
     const auto& op_desc = block_desc.GetConstOp<paddle::cpp::OpDesc>(i);
 
@@ -109,7 +111,7 @@ Program PaddleModelConvertor::LoadModel(const std::string& model_dir,
                                         const std::unordered_map<std::string, std::vector<int64_t>>& feed) {
   paddle::cpp::ProgramDesc program_desc;
   paddle::LoadModelPb(model_dir, "__model__", "", scope_.get(), &program_desc, is_combined, false, target_);
-  CHECK_EQ(program_desc.BlocksSize(), 1) << "CINN can only support the model with a single block";
+  // the sub blocks are only the bodies of the control flow ops, which are converted with the ops
   auto* block_desc = program_desc.GetBlock<paddle::cpp::BlockDesc>(0);
 
   // Set feeds shape
@@ -124,6 +126,7 @@ Program PaddleModelConvertor::LoadModel(const std::string& model_dir,
   }
 
   OpMapperContext ctx(*scope_, target_, builder_.get(), &var_map_, &var_model_to_program_map_, &fetch_var_names_);
+  ctx.SetProgramDesc(&program_desc);
 
   PrepareRun(*block_desc, &ctx);
   for (int i = 0; i < block_desc->OpsSize(); i++) {
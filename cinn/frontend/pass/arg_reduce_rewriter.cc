@@ -0,0 +1,175 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the argmax and the argmin into the arg_reduce, which outputs the value with its index:
+//   reduce_max(x, dim=[axis]), argmax(x, axis) -> arg_reduce(x, axis, is_max=true)
+//   reduce_min(x, dim=[axis]), argmin(x, axis) -> arg_reduce(x, axis, is_max=false)
+// The argmax and the argmin are computed by sorting the whole axis, and the reduce of the same x and axis is another
+// pass over x, while the arg_reduce is computed by the runtime kernel on NVGPU, which carries the (value, index)
+// pairs through the warp and the block reduction in one pass. The argmax without a matching reduce is rewritten as
+// well, and the value output is left unused.
+class ArgReduceRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"argmax", "argmin"}; }
+
+ protected:
+  // The x, whether it is the max and the normalized axis, with the keep_dim.
+  using ArgKey = std::tuple<_Variable_*, bool, int, bool>;
+
+  struct ArgReduce {
+    Instruction arg;
+    _Instruction_* reduce;
+    bool emitted;
+  };
+
+  void Clear() override {
+    arg_reduces_.clear();
+    instr2group_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+    std::map<ArgKey, std::vector<Instruction>> key2reduces;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      ArgKey key;
+      if (instr->op_type == "argmax" || instr->op_type == "argmin") {
+        if (GetArgKey(instr, &key)) {
+          arg_reduces_.push_back({instr, nullptr, false});
+        }
+      } else if ((instr->op_type == "reduce_max" || instr->op_type == "reduce_min") && GetReduceKey(instr, &key)) {
+        key2reduces[key].push_back(instr);
+      }
+    }
+    if (arg_reduces_.empty()) {
+      return;
+    }
+
+    for (size_t i = 0; i < arg_reduces_.size(); ++i) {
+      auto& group = arg_reduces_[i];
+      ArgKey key;
+      GetArgKey(group.arg, &key);
+      auto it = key2reduces.find(key);
+      if (it != key2reduces.end() && !it->second.empty()) {
+        group.reduce = it->second.front().get();
+        it->second.erase(it->second.begin());
+        instr2group_.emplace(group.reduce, i);
+      }
+      instr2group_.emplace(group.arg.get(), i);
+    }
+
+    NetBuilder builder("arg_reduce_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = instr2group_.find(instr.get());
+      if (it == instr2group_.end()) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      // the arg_reduce takes the place of the first instruction of the group, both of which only depend on x
+      auto& group = arg_reduces_[it->second];
+      if (group.emitted) {
+        continue;
+      }
+      group.emitted = true;
+      auto& arg     = group.arg;
+      bool is_max   = arg->op_type == "argmax";
+      auto outs     = builder.CustomInstr(
+          "arg_reduce",
+          {arg->inputs[0]},
+          {{"axis", arg.GetAttrs<int>("axis")}, {"keep_dim", arg.GetAttrs<bool>("keep_dim")}, {"is_max", is_max}});
+      outs[1].set_id(arg->outputs[0]->id);
+      if (group.reduce) {
+        outs[0].set_id(group.reduce->outputs[0]->id);
+      }
+      VLOG(4) << "Rewrite the " << arg->op_type << " producing " << arg->outputs[0]->id << " into arg_reduce"
+              << (group.reduce ? " with the " + group.reduce->op_type : std::string());
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  // The runtime kernel compares the floating point and the integer values.
+  static bool IsSupportedType(const Type& type) {
+    return type.is_float(32) || type.is_float(64) || type.is_float16() || type.is_bfloat16() || type.is_int(32) ||
+           type.is_int(64);
+  }
+
+  static bool GetArgKey(const Instruction& arg, ArgKey* key) {
+    const auto& x = arg->inputs[0];
+    int rank      = x->shape.size();
+    int axis      = arg.GetAttrs<int>("axis");
+    if (axis < 0) {
+      axis += rank;
+    }
+    if (!IsSupportedType(x->type) || axis < 0 || axis >= rank) {
+      return false;
+    }
+    *key = ArgKey(x.get(), arg->op_type == "argmax", axis, arg.GetAttrs<bool>("keep_dim"));
+    return true;
+  }
+
+  // Only the reduce along a single axis matches the argmax or the argmin.
+  static bool GetReduceKey(const Instruction& reduce, ArgKey* key) {
+    const auto& x = reduce->inputs[0];
+    int rank      = x->shape.size();
+    auto dim      = reduce->attrs.count("dim") ? reduce.GetAttrs<std::vector<int>>("dim") : std::vector<int>{};
+    if (dim.size() != 1UL && !(dim.empty() && rank == 1)) {
+      return false;
+    }
+    int axis      = dim.empty() ? 0 : (dim[0] < 0 ? dim[0] + rank : dim[0]);
+    bool keep_dim = reduce->attrs.count("keep_dim") ? reduce.GetAttrs<bool>("keep_dim") : false;
+    *key          = ArgKey(x.get(), reduce->op_type == "reduce_max", axis, keep_dim);
+    return true;
+  }
+
+  std::vector<ArgReduce> arg_reduces_;
+  std::unordered_map<_Instruction_*, size_t> instr2group_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(ArgReduceRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(ArgReduceRewriter, fp::ArgReduceRewriterPass);
+
+  return true;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/utils/data_util.h"
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildArgmax(int reduce_axis, int arg_axis, bool with_reduce) {
+  NetBuilder builder("net_builder");
+  auto x = builder.CreateInput(Float(32), {16, 24, 300}, "X");
+  if (with_reduce) {
+    auto value = builder.ReduceMax(x, {reduce_axis});
+    value.set_id("Value");
+  }
+  auto index = builder.Argmax(x, arg_axis);
+  index.set_id("Index");
+  return builder.Build();
+}
+
+std::vector<std::string> GetOpTypes(const Program& program) {
+  std::vector<std::string> op_types;
+  for (size_t i = 0; i < program.size(); ++i) {
+    op_types.push_back(program[i]->op_type);
+  }
+  return op_types;
+}
+
+// Run the program on NVGPU with the same random x, and return the value and the index.
+std::pair<std::vector<float>, std::vector<int>> RunArgmax(const Program& program) {
+  auto target = common::DefaultNVGPUTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(
+      program, std::unordered_set<std::string>{"Value", "Index"}, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  scope->Var<hlir::framework::Tensor>("X");
+  SetRandData<float>(scope->GetTensor("X"), target, 123);
+  runtime_program->Execute();
+  return {GetTensorData<float>(scope->GetTensor("Value"), target),
+          GetTensorData<int>(scope->GetTensor("Index"), target)};
+}
+}  // namespace
+
+TEST(ArgReduceRewriter, MergeReduceMaxAndArgmax) {
+  auto program = BuildArgmax(1, -2, true);
+  ProgramPass::Apply(&program, {"Value", "Index"}, common::DefaultNVGPUTarget(), {"ArgReduceRewriter"});
+
+  // the reduce_max and the argmax of the same axis are computed by one arg_reduce
+  ASSERT_EQ(GetOpTypes(program), std::vector<std::string>({"arg_reduce"}));
+  ASSERT_EQ(program[0]->outputs[0]->id, "Value");
+  ASSERT_EQ(program[0]->outputs[1]->id, "Index");
+  ASSERT_EQ(program[0]->outputs[1]->shape, std::vector<int>({16, 300}));
+}
+
+TEST(ArgReduceRewriter, KeepReduceOfOtherAxis) {
+  auto program = BuildArgmax(2, 1, true);
+  ProgramPass::Apply(&program, {"Value", "Index"}, common::DefaultNVGPUTarget(), {"ArgReduceRewriter"});
+
+  // the argmax is still rewritten, but the reduce_max of another axis is kept
+  ASSERT_EQ(GetOpTypes(program), std::vector<std::string>({"reduce_max", "arg_reduce"}));
+  ASSERT_EQ(program[0]->outputs[0]->id, "Value");
+  ASSERT_EQ(program[1]->outputs[1]->id, "Index");
+}
+
+// The columns of the inner axis and the rows of the last axis are reduced by different kernels, whose results should
+// be the same as the reduce_max and the argmax.
+TEST(ArgReduceRewriter, CompareResult) {
+  for (int axis : {1, 2}) {
+    auto program      = BuildArgmax(axis, axis, true);
+    auto origin       = RunArgmax(program);
+    auto origin_types = GetOpTypes(program);
+    ProgramPass::Apply(&program, {"Value", "Index"}, common::DefaultNVGPUTarget(), {"ArgReduceRewriter"});
+    ASSERT_NE(GetOpTypes(program), origin_types);
+    auto fused = RunArgmax(program);
+    ASSERT_EQ(origin.first, fused.first);
+    ASSERT_EQ(origin.second, fused.second);
+  }
+}
+
+}  // namespace cinn::frontend
@@ -60,9 +60,8 @@ class AutoBroadcastPass : public ProgramPass {
     const auto& instr   = *broadcast_op;
     const auto& op_name = instr->op_type;
 
-    const auto& op_pattern_dict_ =
-        &cinn::hlir::framework::Operator::GetAttrs<cinn::hlir::framework::OpPatternKind>("OpPattern");
-    const auto* op = cinn::hlir::framework::Operator::Get(op_name);
+    const auto& op_pattern_dict_ = &cinn::hlir::framework::Operator::GetOpPatternAttrs();
+    const auto* op               = cinn::hlir::framework::Operator::Get(op_name);
     if (!op_pattern_dict_->Find(op) || (*op_pattern_dict_)[op] != cinn::hlir::framework::kBroadcast) {
       // no set OpPattern or not broadcast kind operator, skip
       builder->AppendInstruction(instr);
@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/program_pass.h"
@@ -48,6 +50,30 @@ Instruction CreateNewIdentityInstruction(const Variable& input, const Variable&
   return new_identity_instr;
 }
 
+bool IsInputHasFP8(const std::vector<Variable>& inputs) {
+  return std::find_if(inputs.begin(), inputs.end(), [](const Variable& var) { return var->type.is_float8(); }) !=
+         inputs.end();
+}
+
+// The fp8 types are only for storage, so the ops only moving the values take the fp8 inputs directly.
+static std::unordered_set<std::string> fp8_native_ops = {"cast", "fp8_matmul", "reshape", "transpose", "identity"};
+
+// Compute the ops of the fp8 inputs in float32, and cast the outputs back to their dtype.
+void FP8CastImpl(NetBuilder* builder, const Instruction& instr) {
+  std::vector<Variable> casted_inputs;
+  for (const auto& var : instr->inputs) {
+    casted_inputs.emplace_back(var->type.is_float8() ? builder->Cast(var, "float32") : var);
+  }
+  const auto& outputs = builder->CustomInstr(instr->op_type, casted_inputs, instr->attrs);
+  for (int i = 0; i < outputs.size(); ++i) {
+    if (outputs[i]->type != instr->outputs[i]->type) {
+      builder->AppendInstruction(CreateNewCastInstruction(outputs[i], instr->outputs[i]));
+    } else {
+      builder->AppendInstruction(CreateNewIdentityInstruction(outputs[i], instr->outputs[i]));
+    }
+  }
+}
+
 void CommonCastImpl(NetBuilder* builder, const Instruction& instr) {
   if (!IsInputHasFP16OrBF16(instr->inputs)) {
     // DO NOT NEED CAST
@@ -227,7 +253,9 @@ class AutoCastPass : public ProgramPass {
     for (int i = 0; i < program->size(); ++i) {
       auto& instr = (*program)[i];
 
-      if (need_cast_list.count(instr->op_type)) {
+      if (IsInputHasFP8(instr->inputs) && !fp8_native_ops.count(instr->op_type)) {
+        FP8CastImpl(&builder, instr);
+      } else if (need_cast_list.count(instr->op_type)) {
         need_cast_list.at(instr->op_type)(&builder, instr);
       } else {
         builder.AppendInstruction(instr);
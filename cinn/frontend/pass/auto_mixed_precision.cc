@@ -0,0 +1,205 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/utils/string.h"
+#include "glog/logging.h"
+
+DECLARE_string(cinn_amp_dtype);
+DECLARE_string(cinn_amp_allow_ops);
+DECLARE_string(cinn_amp_deny_ops);
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite a float32 program into the mixed precision of FLAGS_cinn_amp_dtype (float16 or bfloat16).
+//   * The ops of the allow list, bound by the math throughput, always run in the low precision. The matmul of the
+//     low precision accumulates in float32 by the cublas compute type.
+//   * The ops of the gray list, bound by the memory, follow their inputs: they run in the low precision once any input
+//     is only produced in the low precision, so that no cast is inserted between them and their producer.
+//   * All the other ops, such as the reductions, the softmax and the math functions, run in float32, which also makes
+//     the reductions accumulate in float32.
+// The low precision copy of a variable and the float32 copy of a low precision result are both cast once and shared
+// by all the consumers. The casts are elementwise, so they are fused into the kernel of their producer or consumer,
+// and the cast chains left are collapsed by the CastCollapsing pass after. The fetched variables keep float32.
+class AutoMixedPrecisionPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void Clear() override {
+    low_vars_.clear();
+    fp32_defined_.clear();
+  }
+
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (FLAGS_cinn_amp_dtype.empty()) {
+      return;
+    }
+    amp_type_ = common::Str2Type(FLAGS_cinn_amp_dtype);
+    CHECK(amp_type_.is_float16() || amp_type_.is_bfloat16())
+        << "FLAGS_cinn_amp_dtype should be float16 or bfloat16, but here " << FLAGS_cinn_amp_dtype;
+    InitOpLists();
+
+    NetBuilder builder("auto_mixed_precision_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+      fp32_defined_.insert(var->id);
+    }
+    for (int i = 0; i < program->size(); ++i) {
+      const auto& instr = (*program)[i];
+      if (RunInLowPrecision(instr)) {
+        AppendLowPrecision(&builder, instr);
+      } else {
+        AppendFloat32(&builder, instr);
+      }
+    }
+    for (const auto& id : fetch_ids) {
+      if (low_vars_.count(id) && !fp32_defined_.count(id)) {
+        DefineFloat32(&builder, low_vars_.at(id));
+      }
+    }
+    *program = builder.Build();
+  }
+
+ private:
+  void InitOpLists() {
+    allow_ops_ = {"matmul", "mul", "conv2d", "depthwise_conv2d"};
+    gray_ops_  = {"elementwise_add", "subtract", "elementwise_mul", "divide",  "max",          "min",
+                 "relu",            "relu6",    "scale",           "reshape", "transpose",    "slice",
+                 "concat",          "squeeze",  "expand_dims",     "select",  "broadcast_to", "gather",
+                 "identity"};
+    if (!FLAGS_cinn_amp_allow_ops.empty()) {
+      for (const auto& op : cinn::utils::Split(FLAGS_cinn_amp_allow_ops, ";")) {
+        gray_ops_.erase(op);
+        allow_ops_.insert(op);
+      }
+    }
+    if (!FLAGS_cinn_amp_deny_ops.empty()) {
+      for (const auto& op : cinn::utils::Split(FLAGS_cinn_amp_deny_ops, ";")) {
+        allow_ops_.erase(op);
+        gray_ops_.erase(op);
+      }
+    }
+  }
+
+  // The instruction runs in the low precision only if all its float inputs are float32 or the low precision, all its
+  // float outputs are float32, and its output dtype is not given by the attribute.
+  bool RunInLowPrecision(const Instruction& instr) const {
+    bool is_allow = allow_ops_.count(instr->op_type);
+    if ((!is_allow && !gray_ops_.count(instr->op_type)) || instr->attrs.count("dtype")) {
+      return false;
+    }
+    bool has_low_input = false;
+    for (const auto& var : instr->inputs) {
+      if (!var->type.is_float()) {
+        continue;
+      }
+      if (var->type.is_float(32)) {
+        has_low_input |= low_vars_.count(var->id) && !fp32_defined_.count(var->id);
+      } else if (var->type != amp_type_) {
+        return false;
+      } else {
+        has_low_input = true;
+      }
+    }
+    for (const auto& var : instr->outputs) {
+      if (var->type.is_float() && !var->type.is_float(32)) {
+        return false;
+      }
+    }
+    return is_allow || has_low_input;
+  }
+
+  void AppendLowPrecision(NetBuilder* builder, const Instruction& instr) {
+    std::vector<Variable> inputs;
+    for (const auto& var : instr->inputs) {
+      inputs.emplace_back(var->type.is_float(32) ? GetLowPrecision(builder, var) : var);
+    }
+    const auto& outputs = builder->CustomInstr(instr->op_type, inputs, instr->attrs);
+    CHECK_EQ(outputs.size(), instr->outputs.size())
+        << "The number of the outputs of op " << instr->op_type << " is changed by the low precision";
+    for (int i = 0; i < outputs.size(); ++i) {
+      const auto& origin = instr->outputs[i];
+      if (origin->type.is_float(32) && outputs[i]->type == amp_type_) {
+        low_vars_[origin->id] = outputs[i];
+      } else {
+        Instruction identity("identity", {outputs[i]});
+        identity->outputs = {origin};
+        builder->AppendInstruction(identity);
+        fp32_defined_.insert(origin->id);
+      }
+    }
+  }
+
+  void AppendFloat32(NetBuilder* builder, const Instruction& instr) {
+    for (const auto& var : instr->inputs) {
+      if (low_vars_.count(var->id) && !fp32_defined_.count(var->id)) {
+        DefineFloat32(builder, var);
+      }
+    }
+    builder->AppendInstruction(instr);
+    for (const auto& var : instr->outputs) {
+      fp32_defined_.insert(var->id);
+    }
+  }
+
+  // The low precision copy of a float32 variable, which is cast once and shared by all the consumers.
+  Variable GetLowPrecision(NetBuilder* builder, const Variable& var) {
+    if (!low_vars_.count(var->id)) {
+      low_vars_[var->id] = builder->Cast(var, common::Type2Str(amp_type_));
+    }
+    return low_vars_.at(var->id);
+  }
+
+  // Define the float32 variable of a result produced only in the low precision by casting it back.
+  void DefineFloat32(NetBuilder* builder, const Variable& var) {
+    const auto& low = low_vars_.at(var->id);
+    Instruction cast("cast", {low});
+    cast->outputs       = {var};
+    cast->attrs         = {{"dtype", common::Type2Str(var->type)}};
+    cast->attrs_ordered = {{"dtype", common::Type2Str(var->type)}};
+    builder->AppendInstruction(cast);
+    fp32_defined_.insert(var->id);
+  }
+
+  common::Type amp_type_;
+  std::unordered_set<std::string> allow_ops_;
+  std::unordered_set<std::string> gray_ops_;
+  // the low precision copy of each float32 variable, either cast from it or produced instead of it
+  std::unordered_map<std::string, Variable> low_vars_;
+  // the float32 variables defined in the new program
+  std::unordered_set<std::string> fp32_defined_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(AutoMixedPrecision) {
+  CINN_REGISTER_PROGRAM_PASS(AutoMixedPrecision, cinn::frontend::pass::AutoMixedPrecisionPass);
+
+  return true;
+}
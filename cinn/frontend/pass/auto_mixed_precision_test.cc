@@ -0,0 +1,79 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+DECLARE_string(cinn_amp_dtype);
+DECLARE_string(cinn_amp_deny_ops);
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildMatmulBiasRelu() {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {16, 32}, "X");
+  auto w    = builder.CreateInput(Float(32), {32, 8}, "W");
+  auto bias = builder.CreateInput(Float(32), {16, 8}, "Bias");
+  auto out  = builder.Relu(builder.Add(builder.Matmul(x, w), bias));
+  out.set_id("Out");
+  auto sum = builder.ReduceSum(out, {1});
+  sum.set_id("Sum");
+  return builder.Build();
+}
+
+std::vector<std::string> GetOpTypes(const Program& program) {
+  std::vector<std::string> op_types;
+  for (size_t i = 0; i < program.size(); ++i) {
+    op_types.push_back(program[i]->op_type);
+  }
+  return op_types;
+}
+}  // namespace
+
+TEST(AutoMixedPrecision, MatmulBiasReluInFloat16) {
+  FLAGS_cinn_amp_dtype = "float16";
+  auto program         = BuildMatmulBiasRelu();
+  ProgramPass::Apply(&program, {"Out", "Sum"}, common::DefaultNVGPUTarget(), {"AutoMixedPrecision"});
+
+  // the add and relu follow the float16 matmul, the reduce_sum takes the float32 result cast once for the fetch too
+  std::vector<std::string> expected{"cast", "cast", "matmul", "cast", "elementwise_add", "relu", "cast", "reduce_sum"};
+  ASSERT_EQ(GetOpTypes(program), expected);
+  ASSERT_TRUE(program[2]->outputs[0]->type.is_float16());
+  ASSERT_TRUE(program[5]->outputs[0]->type.is_float16());
+  ASSERT_EQ(program[6]->outputs[0]->id, "Out");
+  ASSERT_TRUE(program[6]->outputs[0]->type.is_float(32));
+  ASSERT_TRUE(program[7]->outputs[0]->type.is_float(32));
+  FLAGS_cinn_amp_dtype = "";
+}
+
+TEST(AutoMixedPrecision, KeepDenyOpsInFloat32) {
+  FLAGS_cinn_amp_dtype    = "bfloat16";
+  FLAGS_cinn_amp_deny_ops = "matmul";
+  auto program            = BuildMatmulBiasRelu();
+  auto origin             = GetOpTypes(program);
+  ProgramPass::Apply(&program, {"Out", "Sum"}, common::DefaultNVGPUTarget(), {"AutoMixedPrecision"});
+  // the gray ops follow the float32 matmul, so no cast is inserted
+  ASSERT_EQ(GetOpTypes(program), origin);
+  FLAGS_cinn_amp_dtype    = "";
+  FLAGS_cinn_amp_deny_ops = "";
+}
+
+}  // namespace cinn::frontend
@@ -50,6 +50,8 @@ class CastKey {
 class CastCollapsingPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"cast"}; }
   using OutputToOpMap = std::unordered_map<std::string, Instruction*>;
   using InputToOpMap  = std::unordered_map<std::string, std::unordered_set<Instruction*>>;
 
@@ -197,4 +197,18 @@ TEST(TransposeCollapsing, FuseVerAndHorTranspose) {
   CompareResult(&program, target, input_ids, {out->id}, 3, passes, 123, true);
 }
 
+TEST(CastCollapsing, SkipWithoutCast) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {4, 5, 3}, "X");
+  auto out     = builder.Relu(builder.Add(x, x));
+  auto program = builder.Build();
+
+  ASSERT_EQ(ProgramPassRegistry::Global()->Get("CastCollapsing")->TargetOpTypes(),
+            std::unordered_set<std::string>({"cast"}));
+  // the program without any cast is skipped by the pass
+  ProgramPass::Apply(&program, {out->id}, common::DefaultHostTarget(), {"CastCollapsing"});
+  ASSERT_EQ(program.size(), 2);
+  ASSERT_EQ(program[1]->op_type, "relu");
+}
+
 }  // namespace cinn::frontend
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Fold the inference batch_norm into the conv2d producing its input when the filter and the statistics are constants:
+//   factor = scale / sqrt(variance + epsilon)
+//   y      = conv2d(x, filter * factor) + (bias - mean * factor)
+// The new filter and bias only depend on the constants, so they are computed once on PreRun after ConstPropagate.
+class ConvBnFoldingPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"conv2d"}; }
+
+ protected:
+  void Clear() override {
+    folded_bns_.clear();
+    removed_convs_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    std::unordered_map<_Variable_*, Instruction> output2conv;
+    std::unordered_map<_Variable_*, int> var_used_count;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "conv2d") {
+        output2conv.emplace(instr->outputs[0].get(), instr);
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count[var.get()]++;
+      }
+    }
+
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& bn = (*prog)[i];
+      if (bn->op_type != "batch_norm" || bn->inputs.size() != 5) {
+        continue;
+      }
+      auto it = output2conv.find(bn->inputs[0].get());
+      if (it == output2conv.end() || var_used_count[bn->inputs[0].get()] != 1 ||
+          fetch_ids.count(bn->inputs[0]->id)) {
+        continue;
+      }
+      if (CanFold(it->second, bn)) {
+        folded_bns_.emplace(bn.get(), it->second);
+        removed_convs_.insert(it->second.get());
+      }
+    }
+    if (folded_bns_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("conv_bn_folding_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = folded_bns_.find(instr.get());
+      if (it != folded_bns_.end()) {
+        auto& conv     = it->second;
+        float epsilon  = instr->attrs.count("epsilon") ? instr.GetAttrs<float>("epsilon") : 1e-5f;
+        auto inv_std   = builder.Rsqrt(builder.Scale(instr->inputs[4], 1.0f, epsilon));
+        auto factor    = builder.Multiply(instr->inputs[1], inv_std);
+        auto filter    = builder.Multiply(conv->inputs[1], factor, 0);
+        auto bias      = builder.Subtract(instr->inputs[2], builder.Multiply(instr->inputs[3], factor));
+        auto conv_out  = builder.CustomInstr("conv2d", {conv->inputs[0], filter}, conv->attrs).front();
+        auto fused_out = builder.Add(conv_out, bias, 1);
+        fused_out.set_id(instr->outputs[0]->id);
+        VLOG(4) << "Fold " << instr->op_type << " into the conv2d producing " << conv->outputs[0]->id;
+      } else if (!removed_convs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+      }
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  static bool CanFold(const Instruction& conv, const Instruction& bn) {
+    auto get_str_attr = [](const Instruction& instr, const std::string& name, const std::string& default_value) {
+      return instr->attrs.count(name) ? instr.GetAttrs<std::string>(name) : default_value;
+    };
+    if (get_str_attr(conv, "conv_type", "forward") != "forward" ||
+        get_str_attr(conv, "data_format", "NCHW") != "NCHW" || get_str_attr(bn, "data_layout", "NCHW") != "NCHW") {
+      return false;
+    }
+    // only the weights are folded, the statistics computed from the input are not constants
+    if (!conv->inputs[1]->is_const) {
+      return false;
+    }
+    for (int idx = 1; idx < 5; ++idx) {
+      auto& var = bn->inputs[idx];
+      if (!var->is_const || var->shape.size() != 1 || var->type != conv->inputs[1]->type) {
+        return false;
+      }
+    }
+    return conv->inputs[1]->shape.size() == 4 && conv->inputs[1]->shape[0] == bn->inputs[1]->shape[0];
+  }
+
+  std::unordered_map<_Instruction_*, Instruction> folded_bns_;
+  std::unordered_set<_Instruction_*> removed_convs_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(ConvBnFolding) {
+  CINN_REGISTER_PROGRAM_PASS(ConvBnFolding, fp::ConvBnFoldingPass);
+
+  return true;
+}
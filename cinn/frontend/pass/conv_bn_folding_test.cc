@@ -0,0 +1,72 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildConvBn() {
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {2, 3, 8, 8}, "X");
+  auto filter = builder.CreateInput(Float(32), {4, 3, 3, 3}, "Filter");
+  auto scale  = builder.CreateInput(Float(32), {4}, "Scale");
+  auto bias   = builder.CreateInput(Float(32), {4}, "Bias");
+  auto mean   = builder.CreateInput(Float(32), {4}, "Mean");
+  auto var    = builder.CreateInput(Float(32), {4}, "Variance");
+  for (auto* param : {&filter, &scale, &bias, &mean, &var}) {
+    param->set_const(true);
+  }
+  auto conv = builder.Conv2d(x, filter, {1, 1}, {1, 1});
+  auto out  = builder.BatchNorm(conv, scale, bias, mean, var, 1e-5f, 0.9f, "NCHW", true)[0];
+  out.set_id("Out");
+  return builder.Build();
+}
+}  // namespace
+
+TEST(ConvBnFolding, FoldIntoFilter) {
+  common::Target target = common::DefaultTarget();
+  std::vector<std::string> input_ids{"X", "Filter", "Scale", "Bias", "Mean", "Variance"};
+
+  auto origin_program = BuildConvBn();
+  ProgramPass::Apply(&origin_program, {"Out"}, target, {"Decomposer"});
+  auto origin_out = RunProgram(origin_program, target, input_ids, {"Out"}, {"OpFusionPass", "FusionMergePass"}, 123);
+
+  // the batch_norm is gone, only the conv2d and the add of the bias are run on the input
+  auto folded_program = BuildConvBn();
+  ProgramPass::Apply(&folded_program, {"Out"}, target, {"ConvBnFolding", "Decomposer"});
+  bool has_batch_norm = false;
+  for (size_t i = 0; i < folded_program.size(); ++i) {
+    has_batch_norm |= folded_program[i]->op_type.find("batch_norm") != std::string::npos;
+  }
+  ASSERT_FALSE(has_batch_norm);
+  auto folded_out = RunProgram(
+      folded_program, target, input_ids, {"Out"}, {"ConstPropagate", "OpFusionPass", "FusionMergePass"}, 123);
+
+  ASSERT_EQ(origin_out.size(), folded_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], folded_out[i], 1e-4 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+
+}  // namespace cinn::frontend
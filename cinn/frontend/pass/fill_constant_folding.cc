@@ -75,6 +75,8 @@ class FillConstantKey {
 class FillConstantFoldingPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"fill_constant"}; }
   using InputToOpMap = std::unordered_map<std::string, std::unordered_set<Instruction*>>;
 
  protected:
@@ -136,6 +136,8 @@ class FillConstantRewriterPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
 
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"fill_constant"}; }
+
  protected:
   void Clear() override {}
 
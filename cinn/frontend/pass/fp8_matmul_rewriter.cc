@@ -0,0 +1,156 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the float matmul into the fp8_matmul computed by cublasLt on the fp8 tensor cores. Both inputs are quantized
+// into float8_e4m3fn by the per-tensor dynamic scaling, which maps the max absolute value of the tensor to the max
+// finite value of E4M3:
+//   scale = max(amax(x), eps) / 448, x_fp8 = cast(x / scale, float8_e4m3fn)
+// so the amax and the quantize are computed in a reduce and an elementwise kernel, and the scales are applied to the
+// float32 accumulation of the gemm, whose output keeps the dtype of the original matmul.
+class Fp8MatmulRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"matmul"}; }
+
+ protected:
+  void Clear() override { rewritten_instrs_.clear(); }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "matmul" && CanRewrite(instr)) {
+        rewritten_instrs_.insert(instr.get());
+      }
+    }
+    if (rewritten_instrs_.empty()) {
+      return;
+    }
+
+    NetBuilder builder("fp8_matmul_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (!rewritten_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      auto out = RewriteMatmul(&builder, instr);
+      out.set_id(instr->outputs[0]->id);
+      VLOG(4) << "Rewrite the matmul producing " << instr->outputs[0]->id << " into fp8_matmul";
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  // the max finite value of float8_e4m3fn
+  static constexpr float kFp8E4M3Max = 448.0f;
+
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    return instr->attrs.count(name) ? instr.GetAttrs<T>(name) : default_value;
+  }
+
+  static bool CanRewrite(const Instruction& matmul) {
+    const auto& a    = matmul->inputs[0];
+    const auto& b    = matmul->inputs[1];
+    const auto& type = a->type;
+    if (!(type.is_float16() || type.is_bfloat16() || type.is_float(32)) || b->type != type) {
+      return false;
+    }
+    // the left input is flattened into 2-D, and the right one is the [N, K] weight or transposed into it
+    if (GetAttr<bool>(matmul, "trans_a", false) || a->shape.size() < 2 || b->shape.size() != 2) {
+      return false;
+    }
+    bool trans_b = GetAttr<bool>(matmul, "trans_b", false);
+    int k        = trans_b ? b->shape[1] : b->shape[0];
+    int n        = trans_b ? b->shape[0] : b->shape[1];
+    // the fp8 tensor cores require the leading dimensions aligned to 16 bytes
+    return a->shape.back() == k && k % 16 == 0 && n % 16 == 0;
+  }
+
+  // Quantize x into float8_e4m3fn, and return it with its float32 scale of shape [1].
+  static std::pair<Variable, Variable> QuantizeToFp8(NetBuilder* builder, const Variable& x) {
+    auto x_fp32 = x->type.is_float(32) ? x : builder->Cast(x, "float32");
+    auto amax   = builder->ReduceMax(builder->Abs(x_fp32));
+    auto eps    = builder->FillConstant<float>({1}, 1e-12f);
+    auto scale  = builder->Scale(builder->Max(amax, eps), 1.0f / kFp8E4M3Max);
+    auto x_fp8  = builder->Cast(builder->Multiply(x_fp32, builder->BroadcastTo(builder->Reciprocal(scale), x->shape)),
+                               "float8_e4m3fn");
+    return {x_fp8, scale};
+  }
+
+  static Variable RewriteMatmul(NetBuilder* builder, const Instruction& matmul) {
+    Variable a          = matmul->inputs[0];
+    Variable b          = matmul->inputs[1];
+    const auto& a_shape = a->shape;
+    if (a_shape.size() > 2) {
+      int m = 1;
+      for (size_t i = 0; i + 1 < a_shape.size(); ++i) {
+        m *= a_shape[i];
+      }
+      a = builder->Reshape(a, {m, a_shape.back()});
+    }
+    if (!GetAttr<bool>(matmul, "trans_b", false)) {
+      b = builder->Transpose(b, {1, 0});
+    }
+
+    auto a_fp8 = QuantizeToFp8(builder, a);
+    auto b_fp8 = QuantizeToFp8(builder, b);
+    auto out   = builder->Fp8Matmul(a_fp8.first,
+                                  b_fp8.first,
+                                  a_fp8.second,
+                                  b_fp8.second,
+                                  common::Type2Str(matmul->outputs[0]->type),
+                                  GetAttr<float>(matmul, "alpha", 1.0f));
+    if (a_shape.size() > 2) {
+      out = builder->Reshape(out, matmul->outputs[0]->shape);
+    }
+    return out;
+  }
+
+  std::unordered_set<_Instruction_*> rewritten_instrs_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(Fp8MatmulRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(Fp8MatmulRewriter, fp::Fp8MatmulRewriterPass);
+
+  return true;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildMatmul(int k) {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(common::BFloat16(), {2, 8, k}, "X");
+  auto w   = builder.CreateInput(common::BFloat16(), {k, 32}, "W");
+  auto out = builder.Matmul(x, w);
+  out.set_id("Out");
+  return builder.Build();
+}
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (size_t i = 0; i < program.size(); ++i) {
+    count += program[i]->op_type == op_type;
+  }
+  return count;
+}
+}  // namespace
+
+TEST(Fp8MatmulRewriter, RewriteBf16Matmul) {
+  auto program = BuildMatmul(64);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"Fp8MatmulRewriter"});
+
+  ASSERT_EQ(CountOp(program, "matmul"), 0);
+  ASSERT_EQ(CountOp(program, "fp8_matmul"), 1);
+  for (size_t i = 0; i < program.size(); ++i) {
+    if (program[i]->op_type == "fp8_matmul") {
+      // x is flattened into [16, 64] and w is transposed into [32, 64], both quantized into E4M3
+      ASSERT_EQ(program[i]->inputs[0]->shape, std::vector<int>({16, 64}));
+      ASSERT_EQ(program[i]->inputs[1]->shape, std::vector<int>({32, 64}));
+      ASSERT_TRUE(program[i]->inputs[0]->type.is_float8_e4m3());
+      ASSERT_TRUE(program[i]->outputs[0]->type.is_bfloat16());
+    }
+  }
+  ASSERT_EQ(program[program.size() - 1]->outputs[0]->id, "Out");
+  ASSERT_EQ(program[program.size() - 1]->outputs[0]->shape, std::vector<int>({2, 8, 32}));
+}
+
+TEST(Fp8MatmulRewriter, KeepUnalignedMatmul) {
+  // the reduction dimension not aligned to 16 can't be computed by the fp8 tensor cores
+  auto program = BuildMatmul(60);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"Fp8MatmulRewriter"});
+  ASSERT_EQ(CountOp(program, "matmul"), 1);
+  ASSERT_EQ(CountOp(program, "fp8_matmul"), 0);
+}
+
+}  // namespace cinn::frontend
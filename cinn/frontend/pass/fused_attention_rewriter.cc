@@ -0,0 +1,202 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the attention pattern
+//   matmul(q, k, trans_b=true, alpha) -> [scale] -> [elementwise_add(mask)] -> softmax(axis=-1) -> matmul(p, v)
+// into the fused_attention op, which is computed by the flash attention kernel without materializing the scores.
+class FusedAttentionRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"matmul"}; }
+
+ protected:
+  void Clear() override {
+    removed_instrs_.clear();
+    fused_instrs_.clear();
+    output2instr_.clear();
+    var_used_count_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+
+    CollectInfo(*prog);
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "matmul") {
+        MatchAttention(instr, fetch_ids);
+      }
+    }
+    if (fused_instrs_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("fused_attention_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = fused_instrs_.find(instr.get());
+      if (it != fused_instrs_.end()) {
+        auto& attention = it->second;
+        VLOG(4) << "Rewrite the attention into fused_attention with scale " << attention.scale << " and "
+                << attention.inputs.size() << " inputs";
+        auto new_out = builder.CustomInstr(
+            "fused_attention", attention.inputs, {{"scale", attention.scale}, {"causal", false}})[0];
+        new_out.set_id(instr.GetOutput(0)->id);
+      } else if (!removed_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+      }
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  struct Attention {
+    // q, k, v and the optional mask
+    std::vector<Variable> inputs;
+    float scale;
+  };
+
+  void CollectInfo(const Program& prog) {
+    for (size_t i = 0; i < prog.size(); i++) {
+      auto& instr = prog[i];
+      for (auto& var : instr->outputs) {
+        output2instr_.emplace(var.get(), instr);
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count_[var.get()]++;
+      }
+    }
+  }
+
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    auto& attrs = instr->attrs;
+    return attrs.count(name) ? absl::get<T>(attrs.at(name)) : default_value;
+  }
+
+  // Get the instruction producing the intermediate var, which can only be consumed once and can't be fetched.
+  const Instruction* GetIntermediateProducer(const Variable& var, const std::unordered_set<std::string>& fetch_ids) {
+    auto it = output2instr_.find(var.get());
+    if (it == output2instr_.end() || var_used_count_[var.get()] != 1 || fetch_ids.count(var->id)) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // Match the pattern backward from the matmul of the probabilities and the values.
+  void MatchAttention(const Instruction& pv_matmul, const std::unordered_set<std::string>& fetch_ids) {
+    if (GetAttr<bool>(pv_matmul, "trans_a", false) || GetAttr<bool>(pv_matmul, "trans_b", false) ||
+        GetAttr<float>(pv_matmul, "alpha", 1.0f) != 1.0f) {
+      return;
+    }
+    auto& v       = pv_matmul->inputs[1];
+    auto* softmax = GetIntermediateProducer(pv_matmul->inputs[0], fetch_ids);
+    if (!softmax || (*softmax)->op_type != "softmax") {
+      return;
+    }
+    auto axes = GetAttr<std::vector<int>>(*softmax, "axes", {-1});
+    if (axes.size() != 1 || (axes[0] != -1 && axes[0] != 3)) {
+      return;
+    }
+
+    std::vector<const Instruction*> matched = {softmax};
+    auto* producer                          = GetIntermediateProducer((*softmax)->inputs[0], fetch_ids);
+    const Variable* mask                    = nullptr;
+    if (producer && (*producer)->op_type == "elementwise_add") {
+      auto& add = *producer;
+      // the mask is the operand not produced by the matmul of q and k
+      for (int idx = 0; idx < 2; ++idx) {
+        auto* qk = GetIntermediateProducer(add->inputs[idx], fetch_ids);
+        if (qk && ((*qk)->op_type == "matmul" || (*qk)->op_type == "scale")) {
+          mask     = &add->inputs[1 - idx];
+          producer = qk;
+          break;
+        }
+      }
+      if (!mask || (*mask)->shape.size() != 4 || (*mask)->type != v->type) {
+        return;
+      }
+      matched.push_back(&add);
+    }
+
+    float scale = 1.0f;
+    if (producer && (*producer)->op_type == "scale") {
+      if (GetAttr<float>(*producer, "bias", 0.0f) != 0.0f) {
+        return;
+      }
+      scale = GetAttr<float>(*producer, "scale", 1.0f);
+      matched.push_back(producer);
+      producer = GetIntermediateProducer((*producer)->inputs[0], fetch_ids);
+    }
+
+    if (!producer || (*producer)->op_type != "matmul" || GetAttr<bool>(*producer, "trans_a", false) ||
+        !GetAttr<bool>(*producer, "trans_b", false)) {
+      return;
+    }
+    auto& q = (*producer)->inputs[0];
+    auto& k = (*producer)->inputs[1];
+    if (q->shape.size() != 4 || k->shape.size() != 4 || v->shape.size() != 4) {
+      return;
+    }
+    scale *= GetAttr<float>(*producer, "alpha", 1.0f);
+    matched.push_back(producer);
+
+    Attention attention{{q, k, v}, scale};
+    if (mask) {
+      attention.inputs.push_back(*mask);
+    }
+    for (auto* instr : matched) {
+      removed_instrs_.insert(instr->get());
+    }
+    fused_instrs_.emplace(pv_matmul.get(), attention);
+  }
+
+  std::unordered_set<_Instruction_*> removed_instrs_;
+  std::unordered_map<_Instruction_*, Attention> fused_instrs_;
+  std::unordered_map<_Variable_*, Instruction> output2instr_;
+  std::unordered_map<_Variable_*, int> var_used_count_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(FusedAttentionRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(FusedAttentionRewriter, fp::FusedAttentionRewriterPass);
+
+  return true;
+}
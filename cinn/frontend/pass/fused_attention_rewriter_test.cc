@@ -0,0 +1,71 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/runtime/flags.h"
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildAttention(const std::vector<int>& mask_shape) {
+  NetBuilder builder("net_builder");
+  auto q      = builder.CreateInput(Float(32), {2, 4, 80, 32}, "Q");
+  auto k      = builder.CreateInput(Float(32), {2, 4, 48, 32}, "K");
+  auto v      = builder.CreateInput(Float(32), {2, 4, 48, 16}, "V");
+  auto mask   = builder.CreateInput(Float(32), mask_shape, "Mask");
+  auto scores = builder.Scale(builder.Matmul(q, k, false, true), 0.01f);
+  auto probs  = builder.Softmax(builder.Add(scores, mask));
+  auto out    = builder.Matmul(probs, v);
+  out.set_id("Out");
+  return builder.Build();
+}
+}  // namespace
+
+TEST(FusedAttentionRewriter, BroadcastMask) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  common::Target target = common::DefaultNVGPUTarget();
+  std::vector<std::string> input_ids{"Q", "K", "V", "Mask"};
+  std::vector<std::string> graph_passes{"TransToCustomCallPass", "OpFusionPass", "FusionMergePass"};
+
+  auto origin_program = BuildAttention({2, 1, 1, 48});
+  ProgramPass::Apply(&origin_program, {"Out"}, target, {"Decomposer"});
+  auto origin_out = RunProgram(origin_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  // the matmul, scale, elementwise_add, softmax and matmul are rewritten into one fused_attention
+  auto fused_program = BuildAttention({2, 1, 1, 48});
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{}, {"FusedAttentionRewriter"}};
+  ASSERT_TRUE(CompareProgramPassResult(&fused_program, target, {"Out"}, 4, passes));
+  ASSERT_EQ(fused_program[0]->op_type, "fused_attention");
+  auto fused_out = RunProgram(fused_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  // the softmax is computed online by the fused kernel, so the results differ in the rounding
+  ASSERT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], fused_out[i], 1e-4 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,153 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gflags/gflags.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+DECLARE_int32(cinn_gather_rows_min_index);
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the gather on the outermost axis by a 1-D index into the lookup_table of the rows:
+//   gather(x, broadcast_to(reshape(index, [N, 1, ...]), [N, d1, ...]), axis=0)
+//     = reshape(lookup_table(reshape(x, [R, d1 * ...]), reshape(index, [N, 1])), [N, d1, ...])
+// The generated gather loads an index for each element, while the lookup_table is computed by the external kernel
+// on NVGPU, whose warps copy the whole rows with the vectorized loads and stores. The lookup_table is not fusible,
+// so only the gathers of many indices are rewritten.
+class GatherRowsRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"gather"}; }
+
+ protected:
+  void Clear() override { row_index_.clear(); }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || FLAGS_cinn_gather_rows_min_index <= 0 || !prog->size()) {
+      return;
+    }
+    std::unordered_map<_Variable_*, Instruction> var2producer;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      for (auto& out : instr->outputs) {
+        var2producer.emplace(out.get(), instr);
+      }
+      if (instr->op_type != "gather") {
+        continue;
+      }
+      Variable index;
+      if (GetRowIndex(instr, var2producer, &index)) {
+        row_index_.emplace(instr.get(), index);
+      }
+    }
+    if (row_index_.empty()) {
+      return;
+    }
+
+    NetBuilder builder("gather_rows_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = row_index_.find(instr.get());
+      if (it == row_index_.end()) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      auto out = RewriteGather(&builder, instr, it->second);
+      out.set_id(instr->outputs[0]->id);
+      VLOG(4) << "Rewrite the gather producing " << instr->outputs[0]->id << " into lookup_table";
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  // Get the 1-D index of the rows gathered on the outermost axis, and return false if the gather doesn't gather the
+  // whole rows. The index is broadcast from the shape [N, 1, ...] by NetBuilder::Gather.
+  static bool GetRowIndex(const Instruction& gather,
+                          const std::unordered_map<_Variable_*, Instruction>& var2producer,
+                          Variable* row_index) {
+    int axis = gather->attrs.count("axis") ? gather.GetAttrs<int>("axis") : 0;
+    if (axis != 0) {
+      return false;
+    }
+    Variable index = gather->inputs[1];
+    int num_index  = index->shape[0];
+    if (num_index < FLAGS_cinn_gather_rows_min_index || !(index->type.is_int(32) || index->type.is_int(64))) {
+      return false;
+    }
+    auto producer = var2producer.find(index.get());
+    if (producer != var2producer.end() && producer->second->op_type == "broadcast_to") {
+      index    = producer->second->inputs[0];
+      producer = var2producer.find(index.get());
+    }
+    if (producer != var2producer.end() && producer->second->op_type == "reshape") {
+      index = producer->second->inputs[0];
+    }
+    // every row of the output is gathered by the same index
+    if (index->shape.size() != 1 || index->shape[0] != num_index) {
+      return false;
+    }
+    *row_index = index;
+    return true;
+  }
+
+  static Variable RewriteGather(NetBuilder* builder, const Instruction& gather, const Variable& index) {
+    Variable x          = gather->inputs[0];
+    const auto& x_shape = x->shape;
+    int num_cols        = 1;
+    for (size_t i = 1; i < x_shape.size(); ++i) {
+      num_cols *= x_shape[i];
+    }
+    if (x_shape.size() != 2) {
+      x = builder->Reshape(x, {x_shape[0], num_cols});
+    }
+    auto ids = builder->Reshape(index, {index->shape[0], 1});
+    // the ids are never -1, so no row is padded
+    auto out = builder->LookupTable(x, ids, -1);
+    if (x_shape.size() != 2) {
+      out = builder->Reshape(out, gather->outputs[0]->shape);
+    }
+    return out;
+  }
+
+  std::unordered_map<_Instruction_*, Variable> row_index_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(GatherRowsRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(GatherRowsRewriter, fp::GatherRowsRewriterPass);
+
+  return true;
+}
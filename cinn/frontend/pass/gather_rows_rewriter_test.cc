@@ -0,0 +1,74 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+DECLARE_int32(cinn_gather_rows_min_index);
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildGather(int axis) {
+  NetBuilder builder("net_builder");
+  auto x     = builder.CreateInput(Float(32), {64, 4, 8}, "X");
+  auto index = builder.CreateInput(Int(32), {32}, "Index");
+  auto out   = builder.Relu(builder.Gather(x, index, axis));
+  out.set_id("Out");
+  return builder.Build();
+}
+
+std::vector<std::string> GetOpTypes(const Program& program) {
+  std::vector<std::string> op_types;
+  for (size_t i = 0; i < program.size(); ++i) {
+    op_types.push_back(program[i]->op_type);
+  }
+  return op_types;
+}
+}  // namespace
+
+TEST(GatherRowsRewriter, RewriteIntoLookupTable) {
+  FLAGS_cinn_gather_rows_min_index = 16;
+  auto program                     = BuildGather(0);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"GatherRowsRewriter", "DeadCodeEliminate"});
+
+  // the rows of 4 * 8 elements are copied by the lookup_table, and the broadcast index is removed
+  std::vector<std::string> expected{"reshape", "reshape", "lookup_table", "reshape", "relu"};
+  ASSERT_EQ(GetOpTypes(program), expected);
+  ASSERT_EQ(program[2]->inputs[0]->shape, std::vector<int>({64, 32}));
+  ASSERT_EQ(program[2]->inputs[1]->shape, std::vector<int>({32, 1}));
+  ASSERT_EQ(program[3]->outputs[0]->shape, std::vector<int>({32, 4, 8}));
+  FLAGS_cinn_gather_rows_min_index = 1024;
+}
+
+TEST(GatherRowsRewriter, KeepGatherOfInnerAxisOrFewIndices) {
+  for (int min_index : {16, 1024}) {
+    FLAGS_cinn_gather_rows_min_index = min_index;
+    // the gather on the inner axis is kept, and so is the one of fewer indices than the threshold
+    auto program = BuildGather(min_index == 16 ? 1 : 0);
+    auto origin  = GetOpTypes(program);
+    ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"GatherRowsRewriter"});
+    ASSERT_EQ(GetOpTypes(program), origin);
+  }
+  FLAGS_cinn_gather_rows_min_index = 1024;
+}
+
+}  // namespace cinn::frontend
@@ -29,6 +29,8 @@ class GemmRewriterPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
 
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"matmul"}; }
+
  protected:
   void Clear() override {
     removed_instrs_.clear();
@@ -0,0 +1,234 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Fold the dequantize_linear of both inputs into the matmul or conv2d, so that it runs on the int8 values and
+// accumulates in int32, which is then dequantized by the product of the two scales:
+//   y = matmul(dequant(qa, sa), dequant(qb, sb)) = dequant(matmul(qa, qb), sa * sb / bound_a)
+// The matmul is computed by cublas on NVGPU and oneDNN on x86, and the conv2d by oneDNN on x86 only. The requantize
+// epilogue, such as the dequantize, bias, activation and the quantize of the next layer, is elementwise, so it is
+// fused into a single kernel after the int8 matmul. The dequantize_linear left unused are removed by DeadCodeEliminate.
+class QuantizeFoldingPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"dequantize_linear"}; }
+
+ protected:
+  void Clear() override { folded_instrs_.clear(); }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    std::unordered_map<_Variable_*, Instruction> output2dequant;
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "dequantize_linear") {
+        output2dequant.emplace(instr->outputs[0].get(), instr);
+      }
+    }
+    if (output2dequant.empty()) {
+      return;
+    }
+
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type != "matmul" && instr->op_type != "conv2d") {
+        continue;
+      }
+      auto lhs = output2dequant.find(instr->inputs[0].get());
+      auto rhs = output2dequant.find(instr->inputs[1].get());
+      if (lhs == output2dequant.end() || rhs == output2dequant.end()) {
+        continue;
+      }
+      bool can_fold = instr->op_type == "matmul" ? CanFoldMatmul(instr, lhs->second, rhs->second, target)
+                                                 : CanFoldConv2d(instr, lhs->second, rhs->second, target);
+      if (can_fold) {
+        folded_instrs_.emplace(instr.get(), std::make_pair(lhs->second, rhs->second));
+      }
+    }
+    if (folded_instrs_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("quantize_folding_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = folded_instrs_.find(instr.get());
+      if (it == folded_instrs_.end()) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      auto& dequant_a = it->second.first;
+      auto& dequant_b = it->second.second;
+      Variable out    = instr->op_type == "matmul" ? FoldMatmul(&builder, instr, dequant_a, dequant_b, target)
+                                                   : FoldConv2d(&builder, instr, dequant_a, dequant_b);
+      out.set_id(instr->outputs[0]->id);
+      VLOG(4) << "Fold the dequantize_linear of the inputs into " << instr->op_type << " producing "
+              << instr->outputs[0]->id;
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    return instr->attrs.count(name) ? instr.GetAttrs<T>(name) : default_value;
+  }
+
+  static float GetBound(const Instruction& dequant) {
+    return static_cast<float>((1 << (GetAttr<int>(dequant, "bit_length", 8) - 1)) - 1);
+  }
+
+  static bool IsPerTensor(const Instruction& dequant) { return GetAttr<int>(dequant, "quant_axis", -1) < 0; }
+
+  static bool IsInt8Dequant(const Instruction& dequant) {
+    return dequant->inputs[0]->type.is_int(8) && dequant->inputs[1]->type.is_float(32);
+  }
+
+  static bool CanFoldMatmul(const Instruction& matmul,
+                            const Instruction& dequant_a,
+                            const Instruction& dequant_b,
+                            const common::Target& target) {
+    if (target.arch != common::Target::Arch::NVGPU && target.arch != common::Target::Arch::X86) {
+      return false;
+    }
+    if (!IsInt8Dequant(dequant_a) || !IsInt8Dequant(dequant_b) || !IsPerTensor(dequant_a)) {
+      return false;
+    }
+    // the input of the left matrix is flattened into 2-D, and the scale of the right one is either per-tensor or
+    // per-column, which is broadcast along the last axis of the output
+    const auto& a_shape = matmul->inputs[0]->shape;
+    const auto& b_shape = matmul->inputs[1]->shape;
+    if (GetAttr<bool>(matmul, "trans_a", false) || a_shape.size() < 2 || b_shape.size() != 2) {
+      return false;
+    }
+    bool trans_b = GetAttr<bool>(matmul, "trans_b", false);
+    if (!IsPerTensor(dequant_b) && GetAttr<int>(dequant_b, "quant_axis", -1) != (trans_b ? 0 : 1)) {
+      return false;
+    }
+    // the integer tensor cores require the leading dimensions aligned to 4 bytes
+    int k = trans_b ? b_shape[1] : b_shape[0];
+    int n = trans_b ? b_shape[0] : b_shape[1];
+    return target.arch != common::Target::Arch::NVGPU || (k % 4 == 0 && n % 4 == 0);
+  }
+
+  static bool CanFoldConv2d(const Instruction& conv,
+                            const Instruction& dequant_x,
+                            const Instruction& dequant_w,
+                            const common::Target& target) {
+    // the int8 conv2d of cudnn requires the NHWC or NCHW_VECT_C layouts, so it is only folded on x86 with oneDNN
+#ifdef CINN_WITH_MKLDNN
+    if (target.arch != common::Target::Arch::X86) {
+      return false;
+    }
+    if (!IsInt8Dequant(dequant_x) || !IsInt8Dequant(dequant_w) || !IsPerTensor(dequant_x)) {
+      return false;
+    }
+    if (GetAttr<std::string>(conv, "conv_type", "forward") != "forward" ||
+        GetAttr<std::string>(conv, "data_format", "NCHW") != "NCHW") {
+      return false;
+    }
+    return IsPerTensor(dequant_w) || GetAttr<int>(dequant_w, "quant_axis", -1) == 0;
+#else
+    return false;
+#endif
+  }
+
+  // The scale of the int32 accumulation, dequantized by the bound of the right input.
+  static Variable GetAccumulationScale(NetBuilder* builder,
+                                       const Instruction& dequant_a,
+                                       const Instruction& dequant_b,
+                                       float alpha) {
+    Variable scale_a = dequant_a->inputs[1];
+    Variable scale_b = dequant_b->inputs[1];
+    if (scale_a->shape != scale_b->shape) {
+      scale_a = builder->BroadcastTo(scale_a, scale_b->shape);
+    }
+    return builder->Scale(builder->Multiply(scale_a, scale_b), alpha / GetBound(dequant_a));
+  }
+
+  static Variable FoldMatmul(NetBuilder* builder,
+                             const Instruction& matmul,
+                             const Instruction& dequant_a,
+                             const Instruction& dequant_b,
+                             const common::Target& target) {
+    Variable qa         = dequant_a->inputs[0];
+    Variable qb         = dequant_b->inputs[0];
+    const auto& a_shape = qa->shape;
+    auto out_shape      = matmul->outputs[0]->shape;
+    if (a_shape.size() > 2) {
+      int m = 1;
+      for (size_t i = 0; i + 1 < a_shape.size(); ++i) {
+        m *= a_shape[i];
+      }
+      qa = builder->Reshape(qa, {m, a_shape.back()});
+    }
+
+    utils::AttributeMap attrs = {{"trans_a", false}, {"trans_b", GetAttr<bool>(matmul, "trans_b", false)}};
+    if (target.arch == common::Target::Arch::X86) {
+      attrs["use_mkldnn"] = true;
+    }
+    auto acc = builder->CustomInstr("matmul", {qa, qb}, attrs).front();
+    if (a_shape.size() > 2) {
+      acc = builder->Reshape(acc, out_shape);
+    }
+
+    auto scale   = GetAccumulationScale(builder, dequant_a, dequant_b, GetAttr<float>(matmul, "alpha", 1.0f));
+    int out_axis = IsPerTensor(dequant_b) ? -1 : static_cast<int>(out_shape.size()) - 1;
+    return builder->DequantizeLinear(acc, scale, out_axis, GetAttr<int>(dequant_b, "bit_length", 8));
+  }
+
+  static Variable FoldConv2d(NetBuilder* builder,
+                             const Instruction& conv,
+                             const Instruction& dequant_x,
+                             const Instruction& dequant_w) {
+    auto attrs          = conv->attrs;
+    attrs["use_mkldnn"] = true;
+    auto acc   = builder->CustomInstr("conv2d", {dequant_x->inputs[0], dequant_w->inputs[0]}, attrs).front();
+    auto scale = GetAccumulationScale(builder, dequant_x, dequant_w, 1.0f);
+    return builder->DequantizeLinear(
+        acc, scale, IsPerTensor(dequant_w) ? -1 : 1, GetAttr<int>(dequant_w, "bit_length", 8));
+  }
+
+  std::unordered_map<_Instruction_*, std::pair<Instruction, Instruction>> folded_instrs_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(QuantizeFolding) {
+  CINN_REGISTER_PROGRAM_PASS(QuantizeFolding, fp::QuantizeFoldingPass);
+
+  return true;
+}
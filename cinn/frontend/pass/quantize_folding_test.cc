@@ -0,0 +1,75 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn::frontend {
+
+namespace {
+// matmul(dequant(qa, sa), dequant(qb, sb)), the weights are quantized per column
+Program BuildQuantizedMatmul(int k) {
+  NetBuilder builder("net_builder");
+  auto qa = builder.CreateInput(Int(8), {2, 8, k}, "QA");
+  auto sa = builder.CreateInput(Float(32), {1}, "SA");
+  auto qb = builder.CreateInput(Int(8), {k, 32}, "QB");
+  auto sb = builder.CreateInput(Float(32), {32}, "SB");
+  qb.set_const(true);
+  sb.set_const(true);
+  auto a   = builder.DequantizeLinear(qa, sa);
+  auto b   = builder.DequantizeLinear(qb, sb, 1);
+  auto out = builder.Relu(builder.Matmul(a, b));
+  out.set_id("Out");
+  return builder.Build();
+}
+
+std::vector<std::string> GetOpTypes(const Program& program) {
+  std::vector<std::string> op_types;
+  for (size_t i = 0; i < program.size(); ++i) {
+    op_types.push_back(program[i]->op_type);
+  }
+  return op_types;
+}
+}  // namespace
+
+TEST(QuantizeFolding, FoldIntoInt8Matmul) {
+  auto program = BuildQuantizedMatmul(16);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"QuantizeFolding", "DeadCodeEliminate"});
+
+  // the matmul takes the int8 inputs directly, and its int32 accumulation is dequantized by sa * sb / 127
+  std::vector<std::string> expected{
+      "reshape", "matmul", "reshape", "broadcast_to", "elementwise_mul", "scale", "dequantize_linear", "relu"};
+  ASSERT_EQ(GetOpTypes(program), expected);
+  ASSERT_TRUE(program[1]->inputs[0]->type.is_int(8));
+  ASSERT_TRUE(program[1]->inputs[1]->type.is_int(8));
+  ASSERT_TRUE(program[1]->outputs[0]->type.is_int(32));
+  ASSERT_EQ(program[6]->inputs[0]->shape, std::vector<int>({2, 8, 32}));
+  ASSERT_EQ(program[6].GetAttrs<int>("quant_axis"), 2);
+}
+
+TEST(QuantizeFolding, KeepUnalignedMatmul) {
+  // the reduction dimension not aligned to 4 can't be computed by the integer tensor cores
+  auto program = BuildQuantizedMatmul(15);
+  auto origin  = GetOpTypes(program);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"QuantizeFolding"});
+  ASSERT_EQ(GetOpTypes(program), origin);
+}
+
+}  // namespace cinn::frontend
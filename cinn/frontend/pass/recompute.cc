@@ -0,0 +1,236 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/memory_planner.h"
+#include "cinn/hlir/framework/op.h"
+#include "glog/logging.h"
+
+DECLARE_int64(cinn_recompute_memory_budget_mb);
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+using hlir::framework::VariableLifeTime;
+
+// In a training program, the forward results consumed by the backward are held from the forward to the backward,
+// which makes the peak memory. While the peak memory estimated by the life time of the intermediate variables exceeds
+// FLAGS_cinn_recompute_memory_budget_mb, the largest variable held across the peak step and produced by a cheap
+// elementwise or broadcast instruction is recomputed: the instruction is copied before the first late use, and the
+// late uses take the copy, so that the variable is freed after its early uses. The copy is fused into the group of its
+// consumer by the OpFusion pass, so the recompute costs no extra memory.
+class RecomputePass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void Clear() override {
+    producers_.clear();
+    uses_.clear();
+    recomputes_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (FLAGS_cinn_recompute_memory_budget_mb <= 0 || !prog->size()) {
+      return;
+    }
+    size_t budget = static_cast<size_t>(FLAGS_cinn_recompute_memory_budget_mb) << 20;
+
+    // only the variables produced by the instructions are counted, the inputs and parameters are fed by users
+    VariableLifeTime life_time;
+    absl::flat_hash_map<std::string, size_t> sizes;
+    CollectInfo(*prog, fetch_ids, &life_time, &sizes);
+
+    int peak_step      = -1;
+    size_t origin_peak = life_time.EstimatePeakBytes(sizes, &peak_step);
+    size_t peak        = origin_peak;
+    std::unordered_set<std::string> pinned_vars;
+    while (peak > budget) {
+      Recompute recompute;
+      if (!SelectRecompute(*prog, fetch_ids, life_time, sizes, pinned_vars, peak_step, &recompute)) {
+        break;
+      }
+      const auto& var = recompute.var;
+      VLOG(4) << "Recompute " << var << " of " << sizes.at(var) << " bytes before step " << recompute.late_first_use
+              << ", which is held from step " << life_time.FirstStep(var) << " to step " << life_time.LastStep(var);
+      // the inputs of the copied instruction are used by the copy, so they can't be recomputed anymore
+      for (auto& input : (*prog)[producers_.at(var)]->inputs) {
+        pinned_vars.insert(input->id);
+      }
+      pinned_vars.insert(var);
+      life_time.Reset(var, life_time.FirstStep(var), recompute.early_last_use);
+      life_time.Reset(var + "@RECOMPUTE", recompute.late_first_use, recompute.late_last_use);
+      sizes.emplace(var + "@RECOMPUTE", sizes.at(var));
+      recomputes_.emplace(recompute.late_first_use, recompute);
+      peak = life_time.EstimatePeakBytes(sizes, &peak_step);
+    }
+
+    LOG(INFO) << "The estimated peak memory of the intermediate variables is " << ToMB(origin_peak)
+              << " MB before and " << ToMB(peak) << " MB after recomputing " << recomputes_.size()
+              << " variables, the budget is " << FLAGS_cinn_recompute_memory_budget_mb << " MB";
+    if (peak > budget) {
+      LOG(WARNING) << "No more variable can be recomputed to fit the memory budget of "
+                   << FLAGS_cinn_recompute_memory_budget_mb << " MB";
+    }
+    if (recomputes_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("recompute_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (int step = 0; step < prog->size(); ++step) {
+      auto range = recomputes_.equal_range(step);
+      for (auto it = range.first; it != range.second; ++it) {
+        auto& recompute = it->second;
+        auto& producer  = (*prog)[producers_.at(recompute.var)];
+        auto new_var    = builder.CustomInstr(producer->op_type, producer->inputs, producer->attrs).front();
+        for (int use : uses_.at(recompute.var)) {
+          if (use < step) {
+            continue;
+          }
+          for (auto& input : (*prog)[use]->inputs) {
+            if (input->id == recompute.var) {
+              input = new_var;
+            }
+          }
+        }
+      }
+      builder.AppendInstruction((*prog)[step]);
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  struct Recompute {
+    std::string var;
+    int early_last_use;
+    int late_first_use;
+    int late_last_use;
+  };
+
+  static double ToMB(size_t bytes) { return static_cast<double>(bytes) / (1 << 20); }
+
+  void CollectInfo(const Program& prog,
+                   const std::unordered_set<std::string>& fetch_ids,
+                   VariableLifeTime* life_time,
+                   absl::flat_hash_map<std::string, size_t>* sizes) {
+    for (int step = 0; step < prog.size(); ++step) {
+      auto& instr = prog[step];
+      for (auto& var : instr->inputs) {
+        life_time->Use(var->id, step);
+        auto& uses = uses_[var->id];
+        if (uses.empty() || uses.back() != step) {
+          uses.push_back(step);
+        }
+      }
+      for (auto& var : instr->outputs) {
+        life_time->Use(var->id, step);
+        producers_.emplace(var->id, step);
+        size_t numel = 1;
+        for (int dim : var->shape) {
+          numel *= dim;
+        }
+        sizes->emplace(var->id, numel * var->type.bytes());
+      }
+    }
+    // the fetched variables are held until the end of the program
+    for (auto& id : fetch_ids) {
+      if (life_time->Contains(id)) {
+        life_time->Use(id, prog.size() - 1);
+      }
+    }
+  }
+
+  bool IsCheapInstruction(const Instruction& instr) {
+    const auto& op_pattern_dict = hlir::framework::Operator::GetOpPatternAttrs();
+    const auto* op              = hlir::framework::OpRegistry::Global()->Find(instr->op_type);
+    if (!op || !op_pattern_dict.Find(op)) {
+      return false;
+    }
+    auto kind = op_pattern_dict[op];
+    return (kind == hlir::framework::kElementWise || kind == hlir::framework::kBroadcast) &&
+           instr->outputs.size() == 1UL;
+  }
+
+  // Select the largest variable held across the peak step, which can be recomputed without holding its inputs longer.
+  bool SelectRecompute(const Program& prog,
+                       const std::unordered_set<std::string>& fetch_ids,
+                       const VariableLifeTime& life_time,
+                       const absl::flat_hash_map<std::string, size_t>& sizes,
+                       const std::unordered_set<std::string>& pinned_vars,
+                       int peak_step,
+                       Recompute* recompute) {
+    size_t selected_bytes = 0;
+    for (auto& item : producers_) {
+      const auto& var = item.first;
+      auto uses_it    = uses_.find(var);
+      if (pinned_vars.count(var) || fetch_ids.count(var) || uses_it == uses_.end() || sizes.at(var) <= selected_bytes ||
+          !IsCheapInstruction(prog[item.second])) {
+        continue;
+      }
+      // split the uses at the peak step into the early uses and the late uses
+      const auto& uses = uses_it->second;
+      auto late_it     = std::upper_bound(uses.begin(), uses.end(), peak_step);
+      if (late_it == uses.end() || late_it == uses.begin() || *std::prev(late_it) >= peak_step) {
+        continue;
+      }
+      // the inputs produced by the instructions should be held until the first late use anyway
+      int late_first_use = *late_it;
+      bool inputs_alive  = true;
+      for (auto& input : prog[item.second]->inputs) {
+        if (producers_.count(input->id) && life_time.LastStep(input->id) < late_first_use) {
+          inputs_alive = false;
+          break;
+        }
+      }
+      if (!inputs_alive) {
+        continue;
+      }
+      *recompute     = Recompute{var, *std::prev(late_it), late_first_use, uses.back()};
+      selected_bytes = sizes.at(var);
+    }
+    return selected_bytes > 0;
+  }
+
+  std::unordered_map<std::string, int> producers_;
+  std::unordered_map<std::string, std::vector<int>> uses_;
+  std::unordered_multimap<int, Recompute> recomputes_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(Recompute) {
+  CINN_REGISTER_PROGRAM_PASS(Recompute, fp::RecomputePass);
+
+  return true;
+}
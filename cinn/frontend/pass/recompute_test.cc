@@ -0,0 +1,95 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/runtime/flags.h"
+
+DECLARE_int64(cinn_recompute_memory_budget_mb);
+
+namespace cinn::frontend {
+
+namespace {
+// Every variable of [256, 1024] float32 takes 1 MB. The sum "a" is computed at the beginning and used again at the
+// end, which is held while the 3 variables of the middle are alive, and the estimated peak memory is 4 MB.
+Program BuildProgram() {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(Float(32), {256, 1024}, "X");
+  auto y   = builder.CreateInput(Float(32), {256, 1024}, "Y");
+  auto a   = builder.Add(x, y);
+  auto b   = builder.Exp(a);
+  auto c   = builder.Multiply(b, b);
+  auto e   = builder.Add(c, b);
+  auto s   = builder.ReduceSum(e, {1});
+  auto out = builder.Multiply(builder.BroadcastTo(s, {256, 1024}, {0}), a);
+  out.set_id("Out");
+  return builder.Build();
+}
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (size_t i = 0; i < program.size(); ++i) {
+    count += program[i]->op_type == op_type;
+  }
+  return count;
+}
+}  // namespace
+
+TEST(Recompute, RecomputeElementwise) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  common::Target target = common::DefaultNVGPUTarget();
+  std::vector<std::string> graph_passes{"OpFusionPass", "FusionMergePass"};
+
+  auto origin_program = BuildProgram();
+  auto origin_out     = RunProgram(origin_program, target, {"X", "Y"}, {"Out"}, graph_passes, 123);
+
+  // the sum is recomputed before the last multiply, so the peak memory is 3 MB
+  FLAGS_cinn_recompute_memory_budget_mb = 3;
+  auto recompute_program                = BuildProgram();
+  ProgramPass::Apply(&recompute_program, {"Out"}, target, {"Recompute"});
+  FLAGS_cinn_recompute_memory_budget_mb = 0;
+  ASSERT_EQ(recompute_program.size(), origin_program.size() + 1);
+  ASSERT_EQ(CountOp(recompute_program, "elementwise_add"), 3);
+  ASSERT_EQ(recompute_program[recompute_program.size() - 2]->op_type, "elementwise_add");
+
+  auto recompute_out = RunProgram(recompute_program, target, {"X", "Y"}, {"Out"}, graph_passes, 123);
+  ASSERT_EQ(origin_out.size(), recompute_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_FLOAT_EQ(origin_out[i], recompute_out[i]) << " i is " << i;
+  }
+}
+
+TEST(Recompute, FitBudget) {
+  common::Target target = common::DefaultHostTarget();
+  // the budget is disabled by default
+  auto program = BuildProgram();
+  ProgramPass::Apply(&program, {"Out"}, target, {"Recompute"});
+  ASSERT_EQ(program.size(), 7UL);
+
+  // the peak memory fits the budget already
+  FLAGS_cinn_recompute_memory_budget_mb = 4;
+  ProgramPass::Apply(&program, {"Out"}, target, {"Recompute"});
+  FLAGS_cinn_recompute_memory_budget_mb = 0;
+  ASSERT_EQ(program.size(), 7UL);
+}
+
+}  // namespace cinn::frontend
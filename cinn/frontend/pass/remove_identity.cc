@@ -128,6 +128,17 @@ class RemoveIdentityPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
 
+  std::unordered_set<std::string> TargetOpTypes() const override {
+    std::unordered_set<std::string> op_types;
+    for (const auto& op : identity_ops) {
+      op_types.insert(op.first);
+    }
+    for (const auto& op : reshape_ops) {
+      op_types.insert(op.first);
+    }
+    return op_types;
+  }
+
  protected:
   void ApplyImpl(Program* program,
                  const std::unordered_set<std::string>& fetch_ids,
@@ -0,0 +1,292 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the RMSNorm pattern written by the primitive ops
+//   x * rsqrt(reduce_sum(x * x or pow(x, 2), keep_dim) / n + epsilon) [* weight]
+// into the rms_norm op, which is computed by the single-pass row kernel instead of a reduce and a broadcast group.
+// The mean can also be a scale by 1 / n and the epsilon can also be added by a scale.
+class RMSNormRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"elementwise_mul"}; }
+
+ protected:
+  void Clear() override {
+    removed_instrs_.clear();
+    fused_instrs_.clear();
+    output2instr_.clear();
+    var_used_count_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+
+    CollectInfo(*prog);
+    // match backward, so that the multiply of the weight is matched before the multiply of the rsqrt
+    for (int i = prog->size() - 1; i >= 0; i--) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "elementwise_mul" && !removed_instrs_.count(instr.get())) {
+        MatchRMSNorm(instr, fetch_ids);
+      }
+    }
+    if (fused_instrs_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("rms_norm_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = fused_instrs_.find(instr.get());
+      if (it != fused_instrs_.end()) {
+        auto& norm = it->second;
+        auto& x    = norm.x;
+        int cols   = 1;
+        for (int j = norm.begin_norm_axis; j < x->shape.size(); ++j) {
+          cols *= x->shape[j];
+        }
+        Variable weight;
+        if (norm.weight) {
+          weight = norm.weight->type.is_float(32) ? *norm.weight : builder.Cast(*norm.weight, "float32");
+        } else {
+          weight = builder.FillConstant({cols}, 1.0f, common::UniqName("rms_norm_weight"), "float32");
+        }
+        VLOG(4) << "Rewrite the RMSNorm of " << x->id << " into rms_norm with epsilon " << norm.epsilon
+                << " and begin_norm_axis " << norm.begin_norm_axis;
+        auto new_out = builder.RMSNorm(x, weight, norm.epsilon, norm.begin_norm_axis)[0];
+        new_out.set_id(instr.GetOutput(0)->id);
+      } else if (!removed_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+      }
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  struct RMSNorm {
+    Variable x;
+    const Variable* weight;
+    float epsilon;
+    int begin_norm_axis;
+  };
+
+  void CollectInfo(const Program& prog) {
+    for (size_t i = 0; i < prog.size(); i++) {
+      auto& instr = prog[i];
+      for (auto& var : instr->outputs) {
+        output2instr_.emplace(var.get(), instr);
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count_[var.get()]++;
+      }
+    }
+  }
+
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    auto& attrs = instr->attrs;
+    return attrs.count(name) ? absl::get<T>(attrs.at(name)) : default_value;
+  }
+
+  // Get the instruction producing the intermediate var, which can only be consumed once and can't be fetched.
+  const Instruction* GetIntermediateProducer(const Variable& var, const std::unordered_set<std::string>& fetch_ids) {
+    auto it = output2instr_.find(var.get());
+    if (it == output2instr_.end() || var_used_count_[var.get()] != 1 || fetch_ids.count(var->id)) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // Get the scalar value of the var produced by the fill_constant, return false if it is not a constant.
+  bool GetConstantValue(const Variable& var, double* value) {
+    auto it = output2instr_.find(var.get());
+    if (it == output2instr_.end() || it->second->op_type != "fill_constant") {
+      return false;
+    }
+    const auto& attr = it->second->attrs.at("value");
+    if (absl::holds_alternative<float>(attr)) {
+      *value = absl::get<float>(attr);
+    } else if (absl::holds_alternative<double>(attr)) {
+      *value = absl::get<double>(attr);
+    } else if (absl::holds_alternative<int>(attr)) {
+      *value = absl::get<int>(attr);
+    } else if (absl::holds_alternative<int64_t>(attr)) {
+      *value = absl::get<int64_t>(attr);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Get the other operand of the binary instruction and the producer of the operand equal to the given op type.
+  const Instruction* GetOperandProducer(const Instruction& instr,
+                                        const std::string& op_type,
+                                        const std::unordered_set<std::string>& fetch_ids,
+                                        const Variable** other) {
+    for (int idx = 0; idx < 2; ++idx) {
+      auto* producer = GetIntermediateProducer(instr->inputs[idx], fetch_ids);
+      if (producer && (*producer)->op_type == op_type) {
+        *other = &instr->inputs[1 - idx];
+        return producer;
+      }
+    }
+    return nullptr;
+  }
+
+  // Match the pattern backward from the multiply of the normalized x and the weight, or of x and the rsqrt.
+  void MatchRMSNorm(const Instruction& out_mul, const std::unordered_set<std::string>& fetch_ids) {
+    std::vector<const Instruction*> matched;
+    const Variable* weight   = nullptr;
+    const Variable* x        = nullptr;
+    const Instruction* rsqrt = GetOperandProducer(out_mul, "rsqrt", fetch_ids, &x);
+    if (!rsqrt) {
+      auto* norm_mul = GetOperandProducer(out_mul, "elementwise_mul", fetch_ids, &weight);
+      if (!norm_mul || (*weight)->shape.size() != 1) {
+        return;
+      }
+      rsqrt = GetOperandProducer(*norm_mul, "rsqrt", fetch_ids, &x);
+      matched.push_back(norm_mul);
+    }
+    if (!rsqrt) {
+      return;
+    }
+    matched.push_back(rsqrt);
+
+    // the epsilon is added by an elementwise_add of a constant or by a scale
+    double epsilon = 0.0;
+    auto* add      = GetIntermediateProducer((*rsqrt)->inputs[0], fetch_ids);
+    if (!add) {
+      return;
+    }
+    const Instruction* mean = nullptr;
+    if ((*add)->op_type == "scale" && GetAttr<float>(*add, "scale", 1.0f) == 1.0f) {
+      epsilon = GetAttr<float>(*add, "bias", 0.0f);
+      mean    = GetIntermediateProducer((*add)->inputs[0], fetch_ids);
+    } else if ((*add)->op_type == "elementwise_add") {
+      for (int idx = 0; idx < 2 && !mean; ++idx) {
+        if (GetConstantValue((*add)->inputs[1 - idx], &epsilon)) {
+          mean = GetIntermediateProducer((*add)->inputs[idx], fetch_ids);
+        }
+      }
+    }
+    if (!mean || epsilon < 0.0) {
+      return;
+    }
+    matched.push_back(add);
+
+    // the mean is a divide by a constant or a scale of the reduce_sum
+    double mean_factor            = 0.0;
+    const Instruction* reduce_sum = GetIntermediateProducer((*mean)->inputs[0], fetch_ids);
+    if ((*mean)->op_type == "divide") {
+      double count = 0.0;
+      if (!GetConstantValue((*mean)->inputs[1], &count) || count == 0.0) {
+        return;
+      }
+      mean_factor = 1.0 / count;
+    } else if ((*mean)->op_type == "scale" && GetAttr<float>(*mean, "bias", 0.0f) == 0.0f) {
+      mean_factor = GetAttr<float>(*mean, "scale", 1.0f);
+    } else {
+      return;
+    }
+    if (!reduce_sum || (*reduce_sum)->op_type != "reduce_sum" || !GetAttr<bool>(*reduce_sum, "keep_dim", false)) {
+      return;
+    }
+    matched.push_back(mean);
+    matched.push_back(reduce_sum);
+
+    // the reduced dimensions should be the trailing dimensions of x
+    const auto& x_shape = (*x)->shape;
+    auto dims           = GetAttr<std::vector<int>>(*reduce_sum, "dim", {});
+    if (dims.empty() || dims.size() >= x_shape.size()) {
+      return;
+    }
+    std::sort(dims.begin(), dims.end());
+    int begin_norm_axis = x_shape.size() - dims.size();
+    int cols            = 1;
+    for (int i = 0; i < dims.size(); ++i) {
+      if (dims[i] != begin_norm_axis + i) {
+        return;
+      }
+      cols *= x_shape[dims[i]];
+    }
+    if (std::abs(mean_factor * cols - 1.0) > 1e-5) {
+      return;
+    }
+    if (weight && (*weight)->shape[0] != cols) {
+      return;
+    }
+
+    // the square is a multiply of x by itself or a pow of 2
+    auto* square = GetIntermediateProducer((*reduce_sum)->inputs[0], fetch_ids);
+    if (!square || (*square)->inputs[0].get() != x->get()) {
+      return;
+    }
+    double exponent = 0.0;
+    if (!((*square)->op_type == "elementwise_mul" && (*square)->inputs[1].get() == x->get()) &&
+        !((*square)->op_type == "pow" && GetConstantValue((*square)->inputs[1], &exponent) && exponent == 2.0)) {
+      return;
+    }
+    matched.push_back(square);
+
+    if (!((*x)->type.is_float(32) || (*x)->type.is_float16() || (*x)->type.is_bfloat16()) ||
+        out_mul->outputs[0]->type != (*x)->type || out_mul->outputs[0]->shape != x_shape) {
+      return;
+    }
+
+    for (auto* instr : matched) {
+      removed_instrs_.insert(instr->get());
+    }
+    fused_instrs_.emplace(out_mul.get(), RMSNorm{*x, weight, static_cast<float>(epsilon), begin_norm_axis});
+  }
+
+  std::unordered_set<_Instruction_*> removed_instrs_;
+  std::unordered_map<_Instruction_*, RMSNorm> fused_instrs_;
+  std::unordered_map<_Variable_*, Instruction> output2instr_;
+  std::unordered_map<_Variable_*, int> var_used_count_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(RMSNormRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(RMSNormRewriter, fp::RMSNormRewriterPass);
+
+  return true;
+}
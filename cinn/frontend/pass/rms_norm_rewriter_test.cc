@@ -0,0 +1,98 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/runtime/flags.h"
+
+namespace cinn::frontend {
+
+namespace {
+// x * rsqrt(reduce_sum(x * x) / 256 + 1e-6) * weight
+Program BuildWeightedRMSNorm() {
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {4, 6, 256}, "X");
+  auto weight = builder.CreateInput(Float(32), {256}, "W");
+  auto sum    = builder.ReduceSum(builder.Multiply(x, x), {2}, true);
+  auto mean   = builder.Divide(sum, builder.FillConstant({1}, 256.0f));
+  auto rsqrt  = builder.Rsqrt(builder.Add(mean, builder.FillConstant({1}, 1e-6f)));
+  auto out    = builder.Multiply(builder.Multiply(x, rsqrt), weight);
+  out.set_id("Out");
+  return builder.Build();
+}
+
+// x * rsqrt(reduce_sum(pow(x, 2)) * (1 / 256) + 1e-6) without the weight
+Program BuildScaledRMSNorm() {
+  NetBuilder builder("net_builder");
+  auto x     = builder.CreateInput(Float(32), {4, 6, 256}, "X");
+  auto sum   = builder.ReduceSum(builder.Pow(x, builder.FillConstant({1}, 2.0f)), {2}, true);
+  auto rsqrt = builder.Rsqrt(builder.Scale(builder.Scale(sum, 1.0f / 256), 1.0f, 1e-6f));
+  auto out   = builder.Multiply(x, rsqrt);
+  out.set_id("Out");
+  return builder.Build();
+}
+
+void CheckRMSNormRewriter(Program (*build_program)(), const std::vector<std::string>& input_ids, size_t size_diff) {
+  common::Target target = common::DefaultNVGPUTarget();
+  std::vector<std::string> graph_passes{"TransToCustomCallPass", "OpFusionPass", "FusionMergePass"};
+
+  auto origin_program = build_program();
+  ProgramPass::Apply(&origin_program, {"Out"}, target, {"Decomposer"});
+  auto origin_out = RunProgram(origin_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  auto fused_program = build_program();
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{}, {"RMSNormRewriter"}};
+  ASSERT_TRUE(CompareProgramPassResult(&fused_program, target, {"Out"}, size_diff, passes));
+  bool has_rms_norm = false;
+  for (size_t i = 0; i < fused_program.size(); ++i) {
+    has_rms_norm |= fused_program[i]->op_type == "rms_norm";
+  }
+  ASSERT_TRUE(has_rms_norm);
+  ProgramPass::Apply(&fused_program, {"Out"}, target, {"Decomposer"});
+  auto fused_out = RunProgram(fused_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  // the row is reduced by a warp in the fused kernel, so the results differ in the rounding
+  ASSERT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], fused_out[i], 1e-4 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+}  // namespace
+
+TEST(RMSNormRewriter, Weighted) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  // the multiply, reduce_sum, divide, elementwise_add, rsqrt, multiply and multiply are rewritten into one rms_norm
+  CheckRMSNormRewriter(BuildWeightedRMSNorm, {"X", "W"}, 6);
+}
+
+TEST(RMSNormRewriter, Scaled) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  // the pow, reduce_sum, scale, scale, rsqrt and multiply are rewritten into a fill_constant of the ones and a rms_norm
+  CheckRMSNormRewriter(BuildScaledRMSNorm, {"X"}, 4);
+}
+
+}  // namespace cinn::frontend
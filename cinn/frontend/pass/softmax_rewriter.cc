@@ -0,0 +1,282 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the softmax along the last axis with its producers and consumer
+//   [scale(x)] -> [elementwise_add(mask)] -> softmax(axis=-1) -> [log]
+// into the fused_softmax op, which is computed by the online softmax kernel in one pass over the row instead of a
+// max reduce group, a sum reduce group and the elementwise ops. The additive mask select(unpack_mask(words), 0, -inf)
+// of a packed bool mask is read by the kernel from the words directly.
+class SoftmaxRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"softmax"}; }
+
+ protected:
+  void Clear() override {
+    removed_instrs_.clear();
+    fused_instrs_.clear();
+    output2instr_.clear();
+    var_consumers_.clear();
+  }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+
+    CollectInfo(*prog);
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "softmax") {
+        MatchSoftmax(instr, fetch_ids);
+      }
+    }
+    if (fused_instrs_.empty()) {
+      Clear();
+      return;
+    }
+
+    NetBuilder builder("softmax_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      auto it     = fused_instrs_.find(instr.get());
+      if (it != fused_instrs_.end()) {
+        auto& softmax = it->second;
+        VLOG(4) << "Rewrite the softmax of " << softmax.inputs[0]->id << " into fused_softmax with scale "
+                << softmax.scale << (softmax.inputs.size() > 1 ? ", the mask" : "")
+                << (softmax.log_softmax ? " and the log" : "");
+        auto new_out = builder.CustomInstr(
+            "fused_softmax", softmax.inputs, {{"scale", softmax.scale}, {"log_softmax", softmax.log_softmax}})[0];
+        new_out.set_id(softmax.out_id);
+      } else if (!removed_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+      }
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  struct FusedSoftmax {
+    // x and the optional mask
+    std::vector<Variable> inputs;
+    float scale;
+    bool log_softmax;
+    std::string out_id;
+  };
+
+  void CollectInfo(const Program& prog) {
+    for (size_t i = 0; i < prog.size(); i++) {
+      auto& instr = prog[i];
+      for (auto& var : instr->outputs) {
+        output2instr_.emplace(var.get(), instr);
+      }
+      for (auto& var : instr->inputs) {
+        var_consumers_[var.get()].push_back(instr);
+      }
+    }
+  }
+
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    auto& attrs = instr->attrs;
+    return attrs.count(name) ? absl::get<T>(attrs.at(name)) : default_value;
+  }
+
+  // Get the instruction producing the intermediate var, which can only be consumed once and can't be fetched.
+  const Instruction* GetIntermediateProducer(const Variable& var, const std::unordered_set<std::string>& fetch_ids) {
+    auto it = output2instr_.find(var.get());
+    if (it == output2instr_.end() || var_consumers_[var.get()].size() != 1 || fetch_ids.count(var->id)) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  // The mask is broadcast to x along its dimensions of size 1 except the last one, and the kernel locates the mask
+  // row by the strides of at most 3 groups of the leading dimensions, the adjacent dimensions are grouped if both are
+  // broadcast or they are contiguous in the mask.
+  static bool IsMaskSupported(const std::vector<int>& x_shape, std::vector<int> mask_shape) {
+    if (mask_shape.empty() || mask_shape.size() > x_shape.size() || mask_shape.back() != x_shape.back()) {
+      return false;
+    }
+    mask_shape.insert(mask_shape.begin(), x_shape.size() - mask_shape.size(), 1);
+    std::vector<std::pair<int, int>> groups;
+    int stride = mask_shape.back();
+    for (int i = x_shape.size() - 2; i >= 0; --i) {
+      if (mask_shape[i] != 1 && mask_shape[i] != x_shape[i]) {
+        return false;
+      }
+      int dim_stride = mask_shape[i] == 1 ? 0 : stride;
+      stride *= mask_shape[i];
+      if (x_shape[i] == 1) {
+        continue;
+      }
+      bool mergeable = !groups.empty() && (groups.back().second == 0
+                                               ? dim_stride == 0
+                                               : dim_stride == groups.back().first * groups.back().second);
+      if (mergeable) {
+        groups.back().first *= x_shape[i];
+      } else {
+        groups.emplace_back(x_shape[i], dim_stride);
+      }
+    }
+    return groups.size() <= 3;
+  }
+
+  bool GetConstantValue(const Variable& var, double* value) {
+    auto it = output2instr_.find(var.get());
+    if (it == output2instr_.end() || it->second->op_type != "fill_constant") {
+      return false;
+    }
+    const auto& attr = it->second->attrs.at("value");
+    if (absl::holds_alternative<float>(attr)) {
+      *value = absl::get<float>(attr);
+    } else if (absl::holds_alternative<double>(attr)) {
+      *value = absl::get<double>(attr);
+    } else if (absl::holds_alternative<int>(attr)) {
+      *value = absl::get<int>(attr);
+    } else if (absl::holds_alternative<int64_t>(attr)) {
+      *value = absl::get<int64_t>(attr);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Get the words of the packed mask if the additive mask is select(unpack_mask(words), 0, neg) with a negative value
+  // small enough that its exponent underflows to 0 like -inf, the matched instructions are appended.
+  const Variable* GetPackedMaskWords(const Variable& mask,
+                                     const std::unordered_set<std::string>& fetch_ids,
+                                     std::vector<const Instruction*>* matched) {
+    auto* select = GetIntermediateProducer(mask, fetch_ids);
+    if (!select || (*select)->op_type != "select") {
+      return nullptr;
+    }
+    auto* unpack      = GetIntermediateProducer((*select)->inputs[0], fetch_ids);
+    double true_value = 1.0, false_value = 0.0;
+    if (!unpack || (*unpack)->op_type != "unpack_mask" || !GetConstantValue((*select)->inputs[1], &true_value) ||
+        !GetConstantValue((*select)->inputs[2], &false_value) || true_value != 0.0 || false_value > -1e4) {
+      return nullptr;
+    }
+    matched->push_back(select);
+    matched->push_back(unpack);
+    // the constants are removed too unless they are used elsewhere
+    for (int idx = 1; idx < 3; ++idx) {
+      if (auto* constant = GetIntermediateProducer((*select)->inputs[idx], fetch_ids)) {
+        matched->push_back(constant);
+      }
+    }
+    return &(*unpack)->inputs[0];
+  }
+
+  // Match the pattern from the softmax, backward for the scale and the mask and forward for the log.
+  void MatchSoftmax(const Instruction& softmax, const std::unordered_set<std::string>& fetch_ids) {
+    auto& x_shape = softmax->inputs[0]->shape;
+    auto& x_type  = softmax->inputs[0]->type;
+    auto axes     = GetAttr<std::vector<int>>(softmax, "axes", {-1});
+    if (x_shape.empty() || axes.size() != 1 || (axes[0] != -1 && axes[0] != x_shape.size() - 1) ||
+        !(x_type.is_float(32) || x_type.is_float16() || x_type.is_bfloat16())) {
+      return;
+    }
+
+    std::vector<const Instruction*> matched;
+    Variable x           = softmax->inputs[0];
+    const Variable* mask = nullptr;
+    auto* producer       = GetIntermediateProducer(x, fetch_ids);
+    if (producer && (*producer)->op_type == "elementwise_add" && (*producer)->outputs[0]->shape == x_shape) {
+      // x is the operand produced by a scale, otherwise the operand not broadcast, and the other one is the mask
+      auto& add = *producer;
+      int x_idx = add->inputs[0]->shape == x_shape ? 0 : 1;
+      for (int idx = 0; idx < 2; ++idx) {
+        auto* operand = GetIntermediateProducer(add->inputs[idx], fetch_ids);
+        if (operand && (*operand)->op_type == "scale" && add->inputs[idx]->shape == x_shape) {
+          x_idx = idx;
+          break;
+        }
+      }
+      auto& other = add->inputs[1 - x_idx];
+      if (add->inputs[x_idx]->shape == x_shape && other->type == x_type && IsMaskSupported(x_shape, other->shape)) {
+        mask = &other;
+        x    = add->inputs[x_idx];
+        matched.push_back(producer);
+        if (auto* words = GetPackedMaskWords(other, fetch_ids, &matched)) {
+          mask = words;
+        }
+        producer = GetIntermediateProducer(x, fetch_ids);
+      }
+    }
+
+    float scale = 1.0f;
+    if (producer && (*producer)->op_type == "scale" && GetAttr<float>(*producer, "bias", 0.0f) == 0.0f) {
+      scale = GetAttr<float>(*producer, "scale", 1.0f);
+      x     = (*producer)->inputs[0];
+      matched.push_back(producer);
+    }
+
+    // the log of the softmax is computed from the shifted value directly
+    auto out_id           = softmax->outputs[0]->id;
+    bool log_softmax      = false;
+    const auto& consumers = var_consumers_[softmax->outputs[0].get()];
+    if (consumers.size() == 1 && consumers[0]->op_type == "log" && !fetch_ids.count(out_id)) {
+      out_id      = consumers[0]->outputs[0]->id;
+      log_softmax = true;
+      matched.push_back(&consumers[0]);
+    }
+
+    FusedSoftmax fused{{x}, scale, log_softmax, out_id};
+    if (mask) {
+      fused.inputs.push_back(*mask);
+    }
+    for (auto* instr : matched) {
+      removed_instrs_.insert(instr->get());
+    }
+    fused_instrs_.emplace(softmax.get(), fused);
+  }
+
+  std::unordered_set<_Instruction_*> removed_instrs_;
+  std::unordered_map<_Instruction_*, FusedSoftmax> fused_instrs_;
+  std::unordered_map<_Variable_*, Instruction> output2instr_;
+  std::unordered_map<_Variable_*, std::vector<Instruction>> var_consumers_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(SoftmaxRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(SoftmaxRewriter, fp::SoftmaxRewriterPass);
+
+  return true;
+}
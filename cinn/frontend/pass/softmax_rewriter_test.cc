@@ -0,0 +1,88 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+#include "cinn/runtime/flags.h"
+
+namespace cinn::frontend {
+
+namespace {
+// log(softmax(x * 0.125 + mask)), the mask is broadcast along the heads and the rows
+Program BuildMaskedLogSoftmax() {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {2, 4, 16, 64}, "X");
+  auto mask = builder.CreateInput(Float(32), {2, 1, 1, 64}, "Mask");
+  auto out  = builder.Log(builder.Softmax(builder.Add(builder.Scale(x, 0.125f), mask)));
+  out.set_id("Out");
+  return builder.Build();
+}
+
+Program BuildSoftmax() {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(Float(32), {8, 1000}, "X");
+  auto out = builder.Softmax(x, {1});
+  out.set_id("Out");
+  return builder.Build();
+}
+
+void CheckSoftmaxRewriter(Program (*build_program)(), const std::vector<std::string>& input_ids, size_t size_diff) {
+  common::Target target = common::DefaultNVGPUTarget();
+  std::vector<std::string> graph_passes{"TransToCustomCallPass", "OpFusionPass", "FusionMergePass"};
+
+  auto origin_program = build_program();
+  ProgramPass::Apply(&origin_program, {"Out"}, target, {"Decomposer"});
+  auto origin_out = RunProgram(origin_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  auto fused_program = build_program();
+  std::pair<std::vector<std::string>, std::vector<std::string>> passes{{}, {"SoftmaxRewriter"}};
+  ASSERT_TRUE(CompareProgramPassResult(&fused_program, target, {"Out"}, size_diff, passes));
+  ASSERT_EQ(fused_program.size(), 1UL);
+  ASSERT_EQ(fused_program[0]->op_type, "fused_softmax");
+  ProgramPass::Apply(&fused_program, {"Out"}, target, {"Decomposer"});
+  auto fused_out = RunProgram(fused_program, target, input_ids, {"Out"}, graph_passes, 123);
+
+  // the maximum and the sum are accumulated online by the fused kernel, so the results differ in the rounding
+  ASSERT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], fused_out[i], 1e-5 * std::max(1.0f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+}
+}  // namespace
+
+TEST(SoftmaxRewriter, MaskedLogSoftmax) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  // the scale, elementwise_add, softmax and log are rewritten into one fused_softmax
+  CheckSoftmaxRewriter(BuildMaskedLogSoftmax, {"X", "Mask"}, 3);
+}
+
+TEST(SoftmaxRewriter, Softmax) {
+  if (!cinn::runtime::IsCompiledWithCUDA()) {
+    return;
+  }
+  CheckSoftmaxRewriter(BuildSoftmax, {"X"}, 0);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the matmul of a constant float16 or bfloat16 weight into the sparse_matmul computed by cuSPARSELt on the
+// sparse tensor cores of Ampere and later, which skip the zeros of the weights pruned into the 2:4 structured sparsity:
+//   matmul(x, w) = sparse_matmul(x, transpose(w))
+// The weight is transposed into [N, K] by a constant op, which is computed once by the weight prerun. The 2:4 pattern
+// depends on the values of the weight, so it is checked by the sparse_matmul when the weight is first seen, and the
+// weight is compressed once then, otherwise the matmul falls back to the dense gemm.
+class SparseMatmulRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"matmul"}; }
+
+ protected:
+  void Clear() override { rewritten_instrs_.clear(); }
+
+  void ApplyImpl(Program* prog,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::NVGPU || !prog->size()) {
+      return;
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (instr->op_type == "matmul" && CanRewrite(instr)) {
+        rewritten_instrs_.insert(instr.get());
+      }
+    }
+    if (rewritten_instrs_.empty()) {
+      return;
+    }
+
+    NetBuilder builder("sparse_matmul_rewriter_builder");
+    for (auto& var : prog->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (size_t i = 0; i < prog->size(); i++) {
+      auto& instr = (*prog)[i];
+      if (!rewritten_instrs_.count(instr.get())) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      auto out = RewriteMatmul(&builder, instr);
+      out.set_id(instr->outputs[0]->id);
+      VLOG(4) << "Rewrite the matmul producing " << instr->outputs[0]->id << " into sparse_matmul";
+    }
+    *prog = builder.Build(true);
+    Clear();
+  }
+
+ private:
+  template <typename T>
+  static T GetAttr(const Instruction& instr, const std::string& name, const T& default_value) {
+    return instr->attrs.count(name) ? instr.GetAttrs<T>(name) : default_value;
+  }
+
+  static bool CanRewrite(const Instruction& matmul) {
+    const auto& a    = matmul->inputs[0];
+    const auto& b    = matmul->inputs[1];
+    const auto& type = a->type;
+    if (!(type.is_float16() || type.is_bfloat16()) || b->type != type || !b->is_const) {
+      return false;
+    }
+    // the left input is flattened into 2-D, and the right one is the [N, K] weight or transposed into it
+    if (GetAttr<bool>(matmul, "trans_a", false) || GetAttr<bool>(matmul, "trans_out", false) || a->shape.size() < 2 ||
+        b->shape.size() != 2) {
+      return false;
+    }
+    int m = 1;
+    for (size_t i = 0; i + 1 < a->shape.size(); ++i) {
+      m *= a->shape[i];
+    }
+    bool trans_b = GetAttr<bool>(matmul, "trans_b", false);
+    int k        = trans_b ? b->shape[1] : b->shape[0];
+    int n        = trans_b ? b->shape[0] : b->shape[1];
+    // cuSPARSELt requires the dimensions of the 16-bit matrices to be multiples of 16
+    return a->shape.back() == k && m % 16 == 0 && k % 16 == 0 && n % 16 == 0;
+  }
+
+  static Variable RewriteMatmul(NetBuilder* builder, const Instruction& matmul) {
+    Variable a          = matmul->inputs[0];
+    Variable b          = matmul->inputs[1];
+    const auto& a_shape = a->shape;
+    if (a_shape.size() > 2) {
+      int m = 1;
+      for (size_t i = 0; i + 1 < a_shape.size(); ++i) {
+        m *= a_shape[i];
+      }
+      a = builder->Reshape(a, {m, a_shape.back()});
+    }
+    if (!GetAttr<bool>(matmul, "trans_b", false)) {
+      b = builder->Transpose(b, {1, 0});
+    }
+    auto out = builder->SparseMatmul(a, b, GetAttr<float>(matmul, "alpha", 1.0f));
+    if (a_shape.size() > 2) {
+      out = builder->Reshape(out, matmul->outputs[0]->shape);
+    }
+    return out;
+  }
+
+  std::unordered_set<_Instruction_*> rewritten_instrs_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(SparseMatmulRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(SparseMatmulRewriter, fp::SparseMatmulRewriterPass);
+
+  return true;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn::frontend {
+
+namespace {
+Program BuildMatmul(int k, bool const_weight) {
+  NetBuilder builder("net_builder");
+  auto x = builder.CreateInput(common::Float16(), {2, 16, k}, "X");
+  auto w = builder.CreateInput(common::Float16(), {k, 32}, "W");
+  w.set_const(const_weight);
+  auto out = builder.Relu(builder.Matmul(x, w));
+  out.set_id("Out");
+  return builder.Build();
+}
+
+std::vector<std::string> GetOpTypes(const Program& program) {
+  std::vector<std::string> op_types;
+  for (size_t i = 0; i < program.size(); ++i) {
+    op_types.push_back(program[i]->op_type);
+  }
+  return op_types;
+}
+}  // namespace
+
+TEST(SparseMatmulRewriter, RewriteIntoSparseMatmul) {
+  auto program = BuildMatmul(64, true);
+  ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"SparseMatmulRewriter", "DeadCodeEliminate"});
+
+  // the constant weight is transposed into [N, K], and the left input is flattened into 2-D
+  std::vector<std::string> expected{"reshape", "transpose", "sparse_matmul", "reshape", "relu"};
+  ASSERT_EQ(GetOpTypes(program), expected);
+  ASSERT_EQ(program[2]->inputs[0]->shape, std::vector<int>({32, 64}));
+  ASSERT_EQ(program[2]->inputs[1]->shape, std::vector<int>({32, 64}));
+  ASSERT_EQ(program[3]->outputs[0]->shape, std::vector<int>({2, 16, 32}));
+}
+
+TEST(SparseMatmulRewriter, KeepVariableOrUnalignedWeight) {
+  // the weight not constant may change its sparsity, and the K not aligned to 16 is not supported by cuSPARSELt
+  for (auto program : {BuildMatmul(64, false), BuildMatmul(72, true)}) {
+    auto origin = GetOpTypes(program);
+    ProgramPass::Apply(&program, {"Out"}, common::DefaultNVGPUTarget(), {"SparseMatmulRewriter"});
+    ASSERT_EQ(GetOpTypes(program), origin);
+  }
+}
+
+}  // namespace cinn::frontend
@@ -60,6 +60,8 @@ class TransposeKey {
 class TransposeCollapsingPass : public ProgramPass {
  public:
   using ProgramPass::ProgramPass;
+
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"transpose"}; }
   using OutputToOpMap = std::unordered_map<std::string, Instruction*>;
   using InputToOpMap  = std::unordered_map<std::string, std::unordered_set<Instruction*>>;
 
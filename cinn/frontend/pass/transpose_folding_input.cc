@@ -31,6 +31,8 @@ class TransposeFoldingInputPass : public TransposeFoldingBase {
  public:
   using TransposeFoldingBase::TransposeFoldingBase;
 
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"matmul"}; }
+
  protected:
   void set_target_instrs() override { TransposeFoldingBase::target_instrs_ = {"matmul"}; }
 
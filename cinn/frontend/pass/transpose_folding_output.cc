@@ -28,6 +28,8 @@ class TransposeFoldingOutputPass : public TransposeFoldingBase {
  public:
   using TransposeFoldingBase::TransposeFoldingBase;
 
+  std::unordered_set<std::string> TargetOpTypes() const override { return {"cublas_matmul"}; }
+
  protected:
   void set_target_instrs() override { TransposeFoldingBase::target_instrs_ = {"cublas_matmul"}; }
 
@@ -18,14 +18,25 @@
 
 CINN_USE_REGISTER(ExpandZeroDim)
 CINN_USE_REGISTER(AutoCast)
+CINN_USE_REGISTER(AutoMixedPrecision)
 CINN_USE_REGISTER(Decomposer)
 CINN_USE_REGISTER(DeadCodeEliminate)
 CINN_USE_REGISTER(RemoveIdentity)
 CINN_USE_REGISTER(TransposeCollapsing)
 CINN_USE_REGISTER(TransposeFoldingInput)
 CINN_USE_REGISTER(GemmRewriter)
+CINN_USE_REGISTER(FusedAttentionRewriter)
+CINN_USE_REGISTER(RMSNormRewriter)
+CINN_USE_REGISTER(SoftmaxRewriter)
+CINN_USE_REGISTER(ConvBnFolding)
+CINN_USE_REGISTER(QuantizeFolding)
+CINN_USE_REGISTER(Fp8MatmulRewriter)
+CINN_USE_REGISTER(GatherRowsRewriter)
+CINN_USE_REGISTER(ArgReduceRewriter)
+CINN_USE_REGISTER(SparseMatmulRewriter)
 CINN_USE_REGISTER(TransposeFoldingOutput)
 CINN_USE_REGISTER(FillConstantRewriter)
 CINN_USE_REGISTER(FillConstantFolding)
 CINN_USE_REGISTER(CastCollapsing)
 CINN_USE_REGISTER(AutoBroadcast)
+CINN_USE_REGISTER(Recompute)
@@ -14,9 +14,12 @@
 
 #include "cinn/frontend/program_pass.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "cinn/hlir/framework/visualize_helper.h"
+#include "cinn/utils/compile_stats.h"
 
 namespace cinn {
 namespace frontend {
@@ -30,15 +33,35 @@ void ProgramPass::Apply(Program* prog,
     const auto* pass = ProgramPassRegistry::Global()->Get(name);
     fpass.push_back(pass);
   }
+  // The op types of the program are indexed once and updated only after a pass is applied, so the passes without any
+  // target op in the program are skipped without scanning the instructions.
+  std::unordered_map<std::string, int> op_type_count;
+  auto index_op_types = [&]() {
+    op_type_count.clear();
+    for (size_t i = 0; i < prog->size(); i++) {
+      op_type_count[(*prog)[i]->op_type]++;
+    }
+  };
+  index_op_types();
   for (const auto* pass : fpass) {
+    auto target_op_types = pass->TargetOpTypes();
+    if (!target_op_types.empty() && std::none_of(target_op_types.begin(), target_op_types.end(), [&](auto& op_type) {
+          return op_type_count.count(op_type);
+        })) {
+      VLOG(1) << "Skip " << pass->name() << " pass, the program has none of its target ops";
+      continue;
+    }
     int before = prog->size();
     cinn::hlir::framework::PassPrinter::GetInstance()->PassBegin(pass->name(), *prog);
+    utils::CompileStats::PhaseTimer stats_timer("ProgramPass " + pass->name());
     pass->ApplyImpl(prog, fetch_ids, target);
     const_cast<ProgramPass*>(pass)->Clear();
     int after = prog->size();
+    stats_timer.SetIRSize(after);
     cinn::hlir::framework::PassPrinter::GetInstance()->PassEnd(pass->name(), *prog);
     VLOG(1) << "Apply " << pass->name() << " pass, program size: " << before << " -> " << after
             << ", diff: " << after - before;
+    index_op_types();
   }
 }
 
@@ -43,6 +43,12 @@ class ProgramPass {
 
   const std::string& name() const { return name_; }
 
+  /**
+   * \brief The op types the pass rewrites, the pass is skipped if none of them is in the program.
+   * @return The op types, empty if the pass may rewrite any op.
+   */
+  virtual std::unordered_set<std::string> TargetOpTypes() const { return {}; }
+
  protected:
   virtual void ApplyImpl(Program* prog,
                          const std::unordered_set<std::string>& fetch_ids,
@@ -36,16 +36,17 @@ using hlir::framework::Scope;
 void Instruction::PrepareOutputs() {
   auto* op_def = hlir::framework::OpRegistry::Global()->Find(get()->op_type);
   CHECK(op_def) << "No operator called [" << get()->op_type << "]";
+  get()->outputs.reserve(op_def->num_outputs);
   for (int i = 0; i < op_def->num_outputs; i++) {
-    get()->outputs.push_back(Variable());
+    get()->outputs.emplace_back();
   }
 }
 
-Instruction::Instruction(absl::string_view op_type, const std::vector<Variable>& inputs, Program* parent)
+Instruction::Instruction(absl::string_view op_type, std::vector<Variable> inputs, Program* parent)
     : common::Shared<_Instruction_>(common::make_shared<_Instruction_>()) {
   get()->op_type        = std::string(op_type);
   get()->parent_program = parent;
-  get()->inputs         = inputs;
+  get()->inputs         = std::move(inputs);
   PrepareOutputs();
 }
 
@@ -141,13 +141,13 @@ struct _Instruction_ : public common::Object {
  * Instruction is the basic computational unit of a Program, similar to the operator concept in a DNN platform.
  */
 struct Instruction : public common::Shared<_Instruction_> {
-  explicit Instruction(absl::string_view op_type, const std::vector<Variable>& inputs = {}, Program* parent = nullptr);
+  explicit Instruction(absl::string_view op_type, std::vector<Variable> inputs = {}, Program* parent = nullptr);
 
   /**
    * Set the inputs of the instruction.
    * @param vars The input variables.
    */
-  void SetInputs(const std::vector<Variable>& vars) { get()->inputs = vars; }
+  void SetInputs(std::vector<Variable> vars) { get()->inputs = std::move(vars); }
   const std::vector<Variable>& GetOutputs() const { return get()->outputs; }
   const Variable& GetOutput(size_t offset) const {
     CHECK_LT(offset, get()->outputs.size());
@@ -165,6 +165,12 @@ struct Instruction : public common::Shared<_Instruction_> {
     get()->attrs[key] = v;
   }
 
+  /**
+   * Set all the attributes of the instruction at once, the given attributes are moved instead of copied one by one.
+   * @param attrs The attributes, which replace the existing ones.
+   */
+  void SetAttrs(utils::AttributeMap&& attrs) { get()->attrs = std::move(attrs); }
+
   /**
    * Get an attribute of the instruction.
    * @tparam T The data type of the attribute value.
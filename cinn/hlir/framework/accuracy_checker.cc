@@ -14,14 +14,20 @@
 
 #include "cinn/hlir/framework/accuracy_checker.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <limits>
 
 #ifdef CINN_WITH_CUDA
 #include <cuda_runtime.h>
+
+#include "cinn/runtime/cuda/cuda_util.h"
 #endif
 
 DECLARE_int64(cinn_self_check_accuracy_num);
+DECLARE_int64(cinn_self_check_accuracy_sample_runs);
+DECLARE_double(cinn_self_check_accuracy_sample_ratio);
 
 namespace cinn {
 namespace hlir {
@@ -307,6 +313,250 @@ CheckResult AccuracyChecker::CheckNanOrInf(const Tensor& cpu_tensor) {
   return CheckResult::kOK;
 }
 
+namespace {
+
+#ifdef CINN_WITH_CUDA
+constexpr int kNumDeviceSlots = 64;
+#endif
+
+template <typename T>
+void AccumulateHostStats(const cinn_buffer_t* buffer, TensorStats* stats) {
+  const T* data = reinterpret_cast<const T*>(buffer->memory);
+  for (int64_t i = 0; i < stats->numel; ++i) {
+    double value;
+    if constexpr (std::is_same<T, float16>::value || std::is_same<T, bfloat16>::value) {
+      value = static_cast<double>(static_cast<float>(data[i]));
+    } else {
+      value = static_cast<double>(data[i]);
+    }
+    if (std::isnan(value)) {
+      stats->nan_count++;
+    } else if (std::isinf(value)) {
+      stats->inf_count++;
+    } else {
+      stats->min = std::min(stats->min, value);
+      stats->max = std::max(stats->max, value);
+      stats->sum += value;
+    }
+  }
+}
+
+// Return false if the type is not supported.
+bool ComputeHostStats(const cinn_buffer_t* buffer, TensorStats* stats) {
+  if (buffer->type == cinn_float32_t()) {
+    AccumulateHostStats<float>(buffer, stats);
+  } else if (buffer->type == cinn_float64_t()) {
+    AccumulateHostStats<double>(buffer, stats);
+  } else if (buffer->type == cinn_bfloat16_t()) {
+    AccumulateHostStats<bfloat16>(buffer, stats);
+  } else if (buffer->type == cinn_float16_t()) {
+    AccumulateHostStats<float16>(buffer, stats);
+  } else if (buffer->type == cinn_int8_t()) {
+    AccumulateHostStats<int8_t>(buffer, stats);
+  } else if (buffer->type == cinn_int16_t()) {
+    AccumulateHostStats<int16_t>(buffer, stats);
+  } else if (buffer->type == cinn_int32_t()) {
+    AccumulateHostStats<int32_t>(buffer, stats);
+  } else if (buffer->type == cinn_int64_t()) {
+    AccumulateHostStats<int64_t>(buffer, stats);
+  } else if (buffer->type == cinn_uint8_t()) {
+    AccumulateHostStats<uint8_t>(buffer, stats);
+  } else if (buffer->type == cinn_uint16_t()) {
+    AccumulateHostStats<uint16_t>(buffer, stats);
+  } else if (buffer->type == cinn_uint32_t()) {
+    AccumulateHostStats<uint32_t>(buffer, stats);
+  } else if (buffer->type == cinn_uint64_t()) {
+    AccumulateHostStats<uint64_t>(buffer, stats);
+  } else if (buffer->type == cinn_bool_t()) {
+    AccumulateHostStats<bool>(buffer, stats);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string TensorStats::DebugString() const {
+  std::stringstream ss;
+  ss << "numel=" << numel << ", min=" << PrintValue(min) << ", max=" << PrintValue(max)
+     << ", mean=" << PrintValue(numel > nan_count + inf_count ? sum / (numel - nan_count - inf_count) : 0.0)
+     << ", nan=" << nan_count << ", inf=" << inf_count;
+  if (nan_count > 0) {
+    ss << ", NaN";
+  } else if (inf_count > 0) {
+    ss << ", Inf";
+  } else {
+    ss << ", OK";
+  }
+  return ss.str();
+}
+
+SampledAccuracyChecker& SampledAccuracyChecker::Global() {
+  // leaked on purpose, the logger thread may still run at exit
+  static SampledAccuracyChecker* checker = new SampledAccuracyChecker();
+  return *checker;
+}
+
+SampledAccuracyChecker::SampledAccuracyChecker() : random_engine_(std::random_device()()) {
+  log_thread_ = std::thread([this]() { LogLoop(); });
+  log_thread_.detach();
+}
+
+bool SampledAccuracyChecker::ShouldCheck(int64_t run_id) {
+  if (FLAGS_cinn_self_check_accuracy_sample_runs <= 0 || run_id % FLAGS_cinn_self_check_accuracy_sample_runs != 0) {
+    return false;
+  }
+  if (FLAGS_cinn_self_check_accuracy_sample_ratio >= 1.0) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mtx_);
+  return std::uniform_real_distribution<double>(0.0, 1.0)(random_engine_) < FLAGS_cinn_self_check_accuracy_sample_ratio;
+}
+
+void SampledAccuracyChecker::Check(const Target& target,
+                                   const std::string& instr_name,
+                                   const std::string& arg_name,
+                                   const cinn_buffer_t* buffer,
+                                   void* stream) {
+  PendingCheck check;
+  check.instr_name  = instr_name;
+  check.arg_name    = arg_name;
+  check.stats.min   = std::numeric_limits<double>::infinity();
+  check.stats.max   = -std::numeric_limits<double>::infinity();
+  check.stats.numel = buffer->num_elements();
+  if (check.stats.numel == 0 || buffer->memory == nullptr) {
+    return;
+  }
+
+#ifdef CINN_WITH_CUDA
+  if (target == common::DefaultNVGPUTarget()) {
+    int slot = -1;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (device_slots_.empty()) {
+        device_slots_.resize(kNumDeviceSlots);
+        for (int i = kNumDeviceSlots - 1; i >= 0; --i) {
+          auto& device_slot = device_slots_[i];
+          device_slot.owner = this;
+          CUDA_CALL(cudaMalloc(&device_slot.device_partial, runtime::cuda::kTensorStatsMaxBlocks * 5 * sizeof(double)));
+          CUDA_CALL(cudaMallocHost(&device_slot.host_partial, runtime::cuda::kTensorStatsMaxBlocks * 5 * sizeof(double)));
+          free_slots_.push_back(i);
+        }
+      }
+      if (free_slots_.empty()) {
+        num_dropped_++;
+        return;
+      }
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+
+    auto& device_slot = device_slots_[slot];
+    check.num_blocks  = runtime::cuda::cinn_compute_tensor_stats_nvgpu(buffer, device_slot.device_partial, stream);
+    if (check.num_blocks == 0) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      free_slots_.push_back(slot);
+      return;
+    }
+    check.slot        = slot;
+    device_slot.check = std::move(check);
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      num_pending_++;
+    }
+    auto cuda_stream = static_cast<cudaStream_t>(stream);
+    CUDA_CALL(cudaMemcpyAsync(device_slot.host_partial,
+                              device_slot.device_partial,
+                              device_slot.check.num_blocks * 5 * sizeof(double),
+                              cudaMemcpyDeviceToHost,
+                              cuda_stream));
+    CUDA_CALL(cudaLaunchHostFunc(cuda_stream, &SampledAccuracyChecker::OnPartialCopied, &device_slot));
+    return;
+  }
+#endif
+  CHECK(target == common::DefaultHostTarget()) << "Not supported target type.";
+  if (!ComputeHostStats(buffer, &check.stats)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    num_pending_++;
+  }
+  Submit(std::move(check));
+}
+
+#ifdef CINN_WITH_CUDA
+void SampledAccuracyChecker::OnPartialCopied(void* slot) {
+  // no CUDA API can be called in the host function, the partial results are reduced by the logger thread
+  auto* device_slot = static_cast<DeviceSlot*>(slot);
+  device_slot->owner->Submit(device_slot->check);
+}
+#endif
+
+void SampledAccuracyChecker::Submit(PendingCheck check) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  ready_checks_.emplace_back(std::move(check));
+  cv_.notify_all();
+}
+
+void SampledAccuracyChecker::LogLoop() {
+  while (true) {
+    PendingCheck check;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return !ready_checks_.empty(); });
+      check = std::move(ready_checks_.front());
+      ready_checks_.pop_front();
+    }
+
+#ifdef CINN_WITH_CUDA
+    if (check.slot >= 0) {
+      const double* partial = device_slots_[check.slot].host_partial;
+      for (int i = 0; i < check.num_blocks; ++i) {
+        check.stats.min = std::min(check.stats.min, partial[i * 5]);
+        check.stats.max = std::max(check.stats.max, partial[i * 5 + 1]);
+        check.stats.sum += partial[i * 5 + 2];
+        check.stats.nan_count += static_cast<int64_t>(partial[i * 5 + 3]);
+        check.stats.inf_count += static_cast<int64_t>(partial[i * 5 + 4]);
+      }
+    }
+#endif
+    if (check.stats.nan_count > 0 || check.stats.inf_count > 0) {
+      LOG(WARNING) << "Sampled accuracy check of " << check.instr_name << ": name=" << check.arg_name << ", "
+                   << check.stats.DebugString();
+    } else {
+      LOG(INFO) << "Sampled accuracy check of " << check.instr_name << ": name=" << check.arg_name << ", "
+                << check.stats.DebugString();
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    last_stats_[check.arg_name] = check.stats;
+#ifdef CINN_WITH_CUDA
+    if (check.slot >= 0) {
+      free_slots_.push_back(check.slot);
+    }
+#endif
+    num_pending_--;
+    cv_.notify_all();
+  }
+}
+
+void SampledAccuracyChecker::Flush() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_.wait(lock, [this]() { return num_pending_ == 0; });
+}
+
+bool SampledAccuracyChecker::GetLastStats(const std::string& arg_name, TensorStats* stats) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = last_stats_.find(arg_name);
+  if (it == last_stats_.end()) {
+    return false;
+  }
+  *stats = it->second;
+  return true;
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -14,6 +14,15 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/framework/tensor.h"
 
@@ -47,6 +56,87 @@ class AccuracyChecker {
   Scope* scope_;  // Not owned
 };
 
+// The statistics of a tensor, the minimum, the maximum and the sum are of the finite values.
+struct TensorStats {
+  double min{0.0};
+  double max{0.0};
+  double sum{0.0};
+  int64_t nan_count{0};
+  int64_t inf_count{0};
+  int64_t numel{0};
+
+  std::string DebugString() const;
+};
+
+/**
+ * SampledAccuracyChecker is the sampling mode of the self-check, which is cheap enough to be left on in production.
+ * Every FLAGS_cinn_self_check_accuracy_sample_runs-th run of each instruction is checked with the probability
+ * FLAGS_cinn_self_check_accuracy_sample_ratio, and only the statistics of the outputs are computed instead of copying
+ * them to host: on NVGPU a kernel is launched on the stream of the instruction without synchronizing, and its partial
+ * results are copied back asynchronously. The statistics are logged by a background thread. A check is dropped instead
+ * of waiting when all the slots of the pending checks are in use.
+ */
+class SampledAccuracyChecker {
+ public:
+  static SampledAccuracyChecker& Global();
+
+  //! Whether to check the \p run_id-th run of an instruction.
+  bool ShouldCheck(int64_t run_id);
+
+  //! Check the output \p buffer named \p arg_name of the instruction \p instr_name after it is issued to \p stream.
+  void Check(const Target& target,
+             const std::string& instr_name,
+             const std::string& arg_name,
+             const cinn_buffer_t* buffer,
+             void* stream);
+
+  //! Wait until all the pending checks are logged.
+  void Flush();
+
+  //! Get the statistics logged last time of \p arg_name, return false if it is never checked.
+  bool GetLastStats(const std::string& arg_name, TensorStats* stats);
+
+  //! The number of the checks dropped as all the slots are in use.
+  int64_t num_dropped() const { return num_dropped_; }
+
+ private:
+  struct PendingCheck {
+    std::string instr_name;
+    std::string arg_name;
+    TensorStats stats;
+    // the slot holding the partial results of the device kernel, -1 if the stats are computed on host
+    int slot{-1};
+    int num_blocks{0};
+  };
+
+  SampledAccuracyChecker();
+
+  void Submit(PendingCheck check);
+  void LogLoop();
+
+#ifdef CINN_WITH_CUDA
+  struct DeviceSlot {
+    SampledAccuracyChecker* owner{nullptr};
+    double* device_partial{nullptr};
+    double* host_partial{nullptr};
+    PendingCheck check;
+  };
+  static void OnPartialCopied(void* slot);
+
+  std::vector<DeviceSlot> device_slots_;
+  std::vector<int> free_slots_;
+#endif
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<PendingCheck> ready_checks_;
+  int64_t num_pending_{0};
+  int64_t num_dropped_{0};
+  std::map<std::string, TensorStats> last_stats_;
+  std::mt19937 random_engine_;
+  std::thread log_thread_;
+};
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <random>
 #ifdef CINN_WITH_CUDA
 #include <cuda_runtime.h>
@@ -26,6 +29,7 @@
 #include "cinn/hlir/framework/op_strategy.h"
 
 DECLARE_string(cinn_self_check_accuracy);
+DECLARE_int64(cinn_self_check_accuracy_sample_runs);
 
 namespace cinn {
 namespace hlir {
@@ -157,6 +161,59 @@ TEST(AccuracyChecker, instruction_podargs) {
   FLAGS_cinn_self_check_accuracy = "";
 }
 
+TEST(AccuracyChecker, sampled_instruction) {
+  Target target = common::DefaultHostTarget();
+  Scope scope;
+  InstantiateScope(&scope, target);
+
+  auto jit    = GetLoweredFunc(target);
+  auto fn_ptr = jit->Lookup("fn_sqrt");
+  CHECK(fn_ptr);
+
+  FLAGS_cinn_self_check_accuracy             = "true";
+  FLAGS_cinn_self_check_accuracy_sample_runs = 3;
+  Instruction instr(target, &scope, {"x"}, {"y"});
+  instr.SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), "fn_sqrt");
+  instr.Finalize();
+
+  // only the 1st and the 4th runs are checked
+  auto& checker = SampledAccuracyChecker::Global();
+  ASSERT_TRUE(checker.ShouldCheck(0));
+  ASSERT_FALSE(checker.ShouldCheck(1));
+  for (int i = 0; i < 4; ++i) {
+    instr.Run();
+  }
+  checker.Flush();
+  FLAGS_cinn_self_check_accuracy_sample_runs = 0;
+  FLAGS_cinn_self_check_accuracy             = "";
+
+  // the sqrt of the negative values of x are NaNs
+  const float* x = scope.GetTensor("x")->data<float>();
+  TensorStats expected;
+  expected.min   = std::numeric_limits<double>::infinity();
+  expected.max   = -expected.min;
+  expected.numel = 16 * 16;
+  for (int i = 0; i < expected.numel; ++i) {
+    if (x[i] < 0.0f) {
+      expected.nan_count++;
+    } else {
+      double y     = std::sqrt(x[i]);
+      expected.min = std::min(expected.min, y);
+      expected.max = std::max(expected.max, y);
+      expected.sum += y;
+    }
+  }
+  TensorStats stats;
+  ASSERT_TRUE(checker.GetLastStats("y", &stats));
+  ASSERT_EQ(stats.numel, expected.numel);
+  ASSERT_EQ(stats.nan_count, expected.nan_count);
+  ASSERT_EQ(stats.inf_count, 0);
+  ASSERT_NEAR(stats.min, expected.min, 1e-5);
+  ASSERT_NEAR(stats.max, expected.max, 1e-5);
+  ASSERT_NEAR(stats.sum, expected.sum, 1e-2);
+  LOG(INFO) << stats.DebugString();
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
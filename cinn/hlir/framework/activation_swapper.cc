@@ -0,0 +1,141 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/activation_swapper.h"
+
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+ActivationSwapper::ActivationSwapper(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                                     Scope* scope,
+                                     const Target& target,
+                                     const SwapPlan& plan)
+    : instrs_(instrs) {
+  CHECK(target.arch == Target::Arch::NVGPU) << "Swapping the variables is only supported on NVGPU";
+  swap_out_at_.resize(instrs.size());
+  release_at_.resize(instrs.size());
+  swap_in_at_.resize(instrs.size());
+  wait_at_.resize(instrs.size());
+#ifdef CINN_WITH_CUDA
+  for (auto& item : plan.items) {
+    CHECK(item.swap_out_step <= item.release_step && item.release_step < item.swap_in_step &&
+          item.swap_in_step <= item.wait_step && item.wait_step < instrs.size())
+        << "The swap of variable [" << item.var << "] is out of the order of the steps";
+    auto* var = scope->FindVar(item.var);
+    CHECK(var) << "The swapped variable [" << item.var << "] is not found in scope";
+    Swap swap;
+    swap.item   = item;
+    swap.buffer = absl::get<Tensor>(*var)->get_buffer();
+    CUDA_CALL(cudaHostAlloc(&swap.host, item.bytes, cudaHostAllocDefault));
+    for (auto* event : {&swap.ready_event, &swap.out_event, &swap.in_event}) {
+      cudaEvent_t e;
+      CUDA_CALL(cudaEventCreateWithFlags(&e, cudaEventDisableTiming));
+      *event = e;
+    }
+    int id = swaps_.size();
+    swap_out_at_[item.swap_out_step].push_back(id);
+    release_at_[item.release_step].push_back(id);
+    swap_in_at_[item.swap_in_step].push_back(id);
+    wait_at_[item.wait_step].push_back(id);
+    swaps_.push_back(swap);
+  }
+  cudaStream_t side_stream;
+  CUDA_CALL(cudaStreamCreateWithFlags(&side_stream, cudaStreamNonBlocking));
+  side_stream_ = side_stream;
+  VLOG(3) << "Swap " << swaps_.size() << " variables, which reduces the estimated peak from " << plan.peak_bytes_before
+          << " to " << plan.peak_bytes_after << " bytes";
+#else
+  LOG(FATAL) << "Swapping the variables requires CINN compiled with CUDA";
+#endif
+}
+
+ActivationSwapper::~ActivationSwapper() {
+#ifdef CINN_WITH_CUDA
+  if (side_stream_) {
+    cudaStreamSynchronize(static_cast<cudaStream_t>(side_stream_));
+    cudaStreamDestroy(static_cast<cudaStream_t>(side_stream_));
+  }
+  for (auto& swap : swaps_) {
+    if (swap.host) cudaFreeHost(swap.host);
+    for (auto* event : {swap.ready_event, swap.out_event, swap.in_event}) {
+      if (event) cudaEventDestroy(static_cast<cudaEvent_t>(event));
+    }
+  }
+#endif
+}
+
+void ActivationSwapper::SwapOut(Swap* swap, void* stream) {
+#ifdef CINN_WITH_CUDA
+  auto side_stream = static_cast<cudaStream_t>(side_stream_);
+  auto ready_event = static_cast<cudaEvent_t>(swap->ready_event);
+  CUDA_CALL(cudaEventRecord(ready_event, static_cast<cudaStream_t>(stream)));
+  CUDA_CALL(cudaStreamWaitEvent(side_stream, ready_event, 0));
+  CUDA_CALL(cudaMemcpyAsync(
+      swap->host, swap->buffer->data()->memory, swap->item.bytes, cudaMemcpyDeviceToHost, side_stream));
+  CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(swap->out_event), side_stream));
+#endif
+}
+
+void ActivationSwapper::Release(Swap* swap, void* stream) {
+#ifdef CINN_WITH_CUDA
+  // the memory freed is reused by the kernels queued on the compute stream after the copy out
+  CUDA_CALL(cudaStreamWaitEvent(static_cast<cudaStream_t>(stream), static_cast<cudaEvent_t>(swap->out_event), 0));
+  swap->buffer->Free();
+#endif
+}
+
+void ActivationSwapper::SwapIn(Swap* swap, void* stream) {
+#ifdef CINN_WITH_CUDA
+  // the reallocated memory may be the one of a variable released by the kernels queued before
+  swap->buffer->Resize(swap->item.bytes);
+  auto side_stream = static_cast<cudaStream_t>(side_stream_);
+  auto ready_event = static_cast<cudaEvent_t>(swap->ready_event);
+  CUDA_CALL(cudaEventRecord(ready_event, static_cast<cudaStream_t>(stream)));
+  CUDA_CALL(cudaStreamWaitEvent(side_stream, ready_event, 0));
+  CUDA_CALL(cudaMemcpyAsync(
+      swap->buffer->data()->memory, swap->host, swap->item.bytes, cudaMemcpyHostToDevice, side_stream));
+  CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(swap->in_event), side_stream));
+#endif
+}
+
+void ActivationSwapper::Run(void* stream, bool use_cache) {
+#ifdef CINN_WITH_CUDA
+  utils::RecordEvent record_run("ActivationSwapper Run", utils::EventType::kOrdinary);
+  auto compute_stream = static_cast<cudaStream_t>(stream);
+  for (int i = 0; i < instrs_.size(); ++i) {
+    for (int id : swap_in_at_[i]) {
+      SwapIn(&swaps_[id], stream);
+    }
+    for (int id : wait_at_[i]) {
+      CUDA_CALL(cudaStreamWaitEvent(compute_stream, static_cast<cudaEvent_t>(swaps_[id].in_event), 0));
+    }
+    instrs_[i]->Run(nullptr, false, stream, use_cache);
+    for (int id : swap_out_at_[i]) {
+      SwapOut(&swaps_[id], stream);
+    }
+    for (int id : release_at_[i]) {
+      Release(&swaps_[id], stream);
+    }
+  }
+#else
+  LOG(FATAL) << "Swapping the variables requires CINN compiled with CUDA";
+#endif
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
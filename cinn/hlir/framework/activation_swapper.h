@@ -0,0 +1,86 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/memory_planner.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * ActivationSwapper runs the instructions of a Program with the swaps planned by SwapPlanner at compile time, which
+ * moves the long-lived variables out of the device memory during the gaps between their uses.
+ *
+ * The copies are issued on a side stream ordered with the compute stream by events: a variable is copied to its
+ * pinned host memory after the instruction at swap_out_step, its device memory is released after the instruction at
+ * release_step once the compute stream waits for the copy, reallocated and copied back before the instruction at
+ * swap_in_step, and the instruction at wait_step waits for the copy back. The buffers keep their cinn_buffer_t, so the
+ * cached arguments of the instructions stay valid, and all the variables are on device again at the end of a run.
+ */
+class ActivationSwapper {
+ public:
+  /**
+   * @param instrs The runtime instructions of the plan, in the order of execution, they must outlive the swapper.
+   * @param scope The scope holding the swapped variables.
+   * @param target The target of the instructions, only NVGPU is supported.
+   * @param plan The swaps in the steps of \p instrs.
+   */
+  ActivationSwapper(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                    Scope* scope,
+                    const Target& target,
+                    const SwapPlan& plan);
+  ~ActivationSwapper();
+
+  //! Run the instructions on \p stream with the variables swapped, the arguments are taken from the scope.
+  void Run(void* stream, bool use_cache);
+
+ private:
+  struct Swap {
+    SwapItem item;
+    std::shared_ptr<Buffer> buffer;
+    // the pinned host memory holding the variable while swapped out
+    void* host{nullptr};
+    // cudaEvent_t: the compute stream reaching the swap out or in, and the copies done on the side stream
+    void* ready_event{nullptr};
+    void* out_event{nullptr};
+    void* in_event{nullptr};
+  };
+
+  void SwapOut(Swap* swap, void* stream);
+  void Release(Swap* swap, void* stream);
+  void SwapIn(Swap* swap, void* stream);
+
+  const std::vector<std::unique_ptr<Instruction>>& instrs_;
+  std::vector<Swap> swaps_;
+  // the swaps at each step, by the index in swaps_
+  std::vector<std::vector<int>> swap_out_at_, release_at_, swap_in_at_, wait_at_;
+  // cudaStream_t, hold as void* to not expose the CUDA headers
+  void* side_stream_{nullptr};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ActivationSwapper);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
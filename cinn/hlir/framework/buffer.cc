@@ -14,6 +14,10 @@
 
 #include "cinn/hlir/framework/buffer.h"
 
+#include <gflags/gflags.h>
+
+DECLARE_bool(cinn_assume_aligned_buffers);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -44,6 +48,34 @@ void Buffer::Resize(uint32_t alignment, uint32_t size) {
   }
 }
 
+void Buffer::SetExternalMemory(uint8_t* memory, uint32_t size) {
+  if (size_ > 0) {
+    Free();
+    size_ = 0;
+  }
+  data_.memory        = memory;
+  data_.memory_size   = size;
+  size_               = size;
+  is_external_memory_ = memory != nullptr;
+}
+
+void Buffer::SetExternalMemory(uint8_t* memory,
+                               uint32_t size,
+                               const common::Target& target,
+                               std::shared_ptr<void> holder) {
+  int alignment = AssumedAlignment();
+  CHECK(alignment == 0 || reinterpret_cast<uintptr_t>(memory) % alignment == 0)
+      << "The external memory at " << static_cast<void*>(memory) << " is not aligned to " << alignment
+      << " bytes as the compiled kernels assume, please set FLAGS_cinn_assume_aligned_buffers=false to share it";
+  // release the memory held on the current target before switching to the target of the external memory
+  SetExternalMemory(nullptr, 0);
+  SetTarget(target);
+  SetExternalMemory(memory, size);
+  external_holder_ = std::move(holder);
+}
+
+int Buffer::AssumedAlignment() { return FLAGS_cinn_assume_aligned_buffers ? CINN_BUFFER_ALIGNMENT : 0; }
+
 void Buffer::SetTarget(const common::Target& target) {
   target_           = target;
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
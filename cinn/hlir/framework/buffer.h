@@ -59,18 +59,48 @@ struct Buffer final {
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
+    if (is_external_memory_) {
+      // the memory is owned by others, just detach from it
+      data_.memory        = nullptr;
+      size_               = 0;
+      is_external_memory_ = false;
+      external_holder_.reset();
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
+    MemoryManager::Global().RecordFree(target_.arch, size_);
+    data_.memory = nullptr;
+    size_        = 0;
   }
 
+  //! Point to the memory \p memory of \p size owned by others, it will not be freed by this buffer.
+  void SetExternalMemory(uint8_t* memory, uint32_t size);
+
+  //! Point to the memory \p memory of \p size on \p target owned by others, such as a DLPack tensor or a numpy array,
+  //! and \p holder keeps the memory alive until this buffer detaches from it.
+  void SetExternalMemory(uint8_t* memory,
+                         uint32_t size,
+                         const common::Target& target,
+                         std::shared_ptr<void> holder);
+
+  const common::Target& target() const { return target_; }
+
+  //! The alignment in bytes of the memory assumed by the compiled kernels, or 0 if they assume nothing.
+  static int AssumedAlignment();
+
  private:
   inline void* Malloc(uint32_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
-    return memory_mng_cache_->malloc(size);
+    void* data = memory_mng_cache_->malloc(size);
+    if (data) MemoryManager::Global().RecordAlloc(target_.arch, size);
+    return data;
   }
 
   inline void* AlignedAlloc(uint32_t alignment, uint32_t size) CINN_RESULT_SHOULD_USE {
     CHECK(memory_mng_cache_) << "Should set target first";
-    return memory_mng_cache_->aligned_alloc(alignment, size);
+    void* data = memory_mng_cache_->aligned_alloc(alignment, size);
+    if (data) MemoryManager::Global().RecordAlloc(target_.arch, size);
+    return data;
   }
 
  private:
@@ -84,6 +114,12 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Whether the memory is owned by others, such as an arena planned at compile time.
+  bool is_external_memory_{false};
+
+  //! Keep the external memory alive while this buffer points to it.
+  std::shared_ptr<void> external_holder_;
 };
 
 }  // namespace framework
@@ -18,6 +18,8 @@
 #endif
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace cinn {
@@ -31,6 +33,56 @@ TEST(Buffer, basic) {
   for (int i = 0; i < 10; i++) data[i] = i;
 }
 
+TEST(Buffer, external_memory) {
+  std::vector<float> external(10, 1.0f);
+  auto holder = std::make_shared<int>(0);
+  Buffer buffer(common::DefaultHostTarget());
+  buffer.Resize(10 * sizeof(float));
+  // the owned memory is freed, and the external memory is kept alive by the holder until the buffer detaches from it
+  buffer.SetExternalMemory(
+      reinterpret_cast<uint8_t*>(external.data()), 10 * sizeof(float), common::DefaultHostTarget(), holder);
+  ASSERT_EQ(buffer.data()->memory, reinterpret_cast<uint8_t*>(external.data()));
+  ASSERT_EQ(holder.use_count(), 2);
+  // the lazy resize keeps the external memory large enough
+  buffer.ResizeLazy(10 * sizeof(float), common::DefaultHostTarget());
+  ASSERT_EQ(buffer.data()->memory, reinterpret_cast<uint8_t*>(external.data()));
+  buffer.Free();
+  ASSERT_EQ(buffer.data()->memory, nullptr);
+  ASSERT_EQ(holder.use_count(), 1);
+}
+
+TEST(Buffer, memory_stats) {
+  auto arch     = common::DefaultHostTarget().arch;
+  auto& manager = MemoryManager::Global();
+  manager.ResetPeakStats(arch);
+  size_t base_bytes = manager.GetStats(arch).live_bytes;
+  {
+    Buffer a(common::DefaultHostTarget());
+    a.Resize(1024);
+    std::string instr_name = "fn_test";
+    {
+      MemoryManager::ScopedInstructionAllocs alloc_scope(&instr_name);
+      Buffer b(common::DefaultHostTarget());
+      b.Resize(4096);
+      ASSERT_EQ(manager.GetStats(arch).live_bytes, base_bytes + 5120);
+    }
+    // the peak is kept after b is freed
+    auto stats = manager.GetStats(arch);
+    ASSERT_EQ(stats.live_bytes, base_bytes + 1024);
+    ASSERT_EQ(stats.peak_bytes, base_bytes + 5120);
+    ASSERT_EQ(stats.num_allocs, 2UL);
+    ASSERT_EQ(stats.num_frees, 1UL);
+    ASSERT_EQ(stats.instruction_allocs.size(), 1UL);
+    ASSERT_EQ(stats.instruction_allocs.at(instr_name).num_allocs, 1UL);
+    ASSERT_EQ(stats.instruction_allocs.at(instr_name).bytes, 4096UL);
+    // resizing frees the old memory first
+    a.Resize(2048);
+    ASSERT_EQ(manager.GetStats(arch).live_bytes, base_bytes + 2048);
+  }
+  ASSERT_EQ(manager.GetStats(arch).live_bytes, base_bytes);
+  LOG(INFO) << manager.GetStats(arch).DebugString();
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(Buffer, nvgpu) {
   const int num_elements = 10;
@@ -0,0 +1,242 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_allocator.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+inline size_t RoundUp(size_t size, size_t align) { return (size + align - 1) / align * align; }
+
+// the size of the segment requested from the raw allocator to hold a block of \p size
+inline size_t SegmentSize(size_t size) {
+  if (size <= CachingAllocator::kSmallSize) {
+    return CachingAllocator::kSmallSegmentSize;
+  }
+  return RoundUp(size, CachingAllocator::kLargeRound);
+}
+
+}  // namespace
+
+bool CachingAllocator::BlockComparator::operator()(const Block* a, const Block* b) const {
+  if (a->stream != b->stream) {
+    return reinterpret_cast<uintptr_t>(a->stream) < reinterpret_cast<uintptr_t>(b->stream);
+  }
+  if (a->size != b->size) {
+    return a->size < b->size;
+  }
+  return reinterpret_cast<uintptr_t>(a->ptr) < reinterpret_cast<uintptr_t>(b->ptr);
+}
+
+CachingAllocator::CachingAllocator(RawAllocFunc raw_alloc, RawFreeFunc raw_free, size_t max_reserved_bytes)
+    : raw_alloc_(std::move(raw_alloc)), raw_free_(std::move(raw_free)), max_reserved_bytes_(max_reserved_bytes) {
+  CHECK(raw_alloc_) << "The raw allocate function of CachingAllocator should not be empty";
+  CHECK(raw_free_) << "The raw free function of CachingAllocator should not be empty";
+}
+
+CachingAllocator::~CachingAllocator() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (!allocated_blocks_.empty()) {
+    LOG(WARNING) << "CachingAllocator is destroyed with " << allocated_blocks_.size()
+                 << " blocks still in use, they will not be released";
+  }
+  ReleasePool(&small_blocks_);
+  ReleasePool(&large_blocks_);
+}
+
+size_t CachingAllocator::RoundSize(size_t nbytes) {
+  if (nbytes < kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  return RoundUp(nbytes, kMinBlockSize);
+}
+
+void* CachingAllocator::Allocate(size_t nbytes, void* stream) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  size_t size   = RoundSize(nbytes);
+  bool is_small = size <= kSmallSize;
+
+  Block* block = FindFreeBlock(size, stream, is_small);
+  if (block) {
+    ++stats_.num_cache_hits;
+  } else {
+    block = AllocSegment(SegmentSize(size), stream, is_small);
+  }
+  SplitBlock(block, size);
+
+  block->allocated = true;
+  allocated_blocks_.emplace(block->ptr, block);
+  stats_.allocated_bytes += block->size;
+  VLOG(6) << "CachingAllocator allocate " << block->size << " bytes at " << block->ptr << " on stream " << stream;
+  return block->ptr;
+}
+
+void CachingAllocator::Free(void* ptr) {
+  if (!ptr) return;
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = allocated_blocks_.find(ptr);
+  CHECK(it != allocated_blocks_.end()) << "The pointer " << ptr << " is not allocated by CachingAllocator";
+  Block* block = it->second;
+  allocated_blocks_.erase(it);
+
+  block->allocated = false;
+  stats_.allocated_bytes -= block->size;
+  VLOG(6) << "CachingAllocator free " << block->size << " bytes at " << block->ptr;
+
+  auto& pool = GetPool(block->is_small);
+  if (block->prev && !block->prev->allocated) {
+    Block* prev = block->prev;
+    pool.erase(prev);
+    MergeBlock(prev, block);
+    block = prev;
+  }
+  if (block->next && !block->next->allocated) {
+    Block* next = block->next;
+    pool.erase(next);
+    MergeBlock(block, next);
+  }
+  pool.insert(block);
+}
+
+size_t CachingAllocator::ReleaseCached() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return ReleasePool(&small_blocks_) + ReleasePool(&large_blocks_);
+}
+
+CachingAllocator::Stats CachingAllocator::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return stats_;
+}
+
+void CachingAllocator::SetMaxReservedBytes(size_t max_reserved_bytes) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  max_reserved_bytes_ = max_reserved_bytes;
+}
+
+CachingAllocator::Block* CachingAllocator::FindFreeBlock(size_t size, void* stream, bool is_small) {
+  auto& pool = GetPool(is_small);
+  Block key;
+  key.stream = stream;
+  key.size   = size;
+  // the best fit: the smallest cached block on the same stream that is large enough
+  auto it = pool.lower_bound(&key);
+  if (it == pool.end() || (*it)->stream != stream) {
+    return nullptr;
+  }
+  Block* block = *it;
+  pool.erase(it);
+  return block;
+}
+
+CachingAllocator::Block* CachingAllocator::AllocSegment(size_t size, void* stream, bool is_small) {
+  // free the cached segments when exceeding the memory cap before asking for more memory
+  if (max_reserved_bytes_ > 0 && stats_.reserved_bytes + size > max_reserved_bytes_) {
+    ReleasePool(&small_blocks_);
+    ReleasePool(&large_blocks_);
+  }
+  CHECK(max_reserved_bytes_ == 0 || stats_.reserved_bytes + size <= max_reserved_bytes_)
+      << "CachingAllocator out of memory: trying to reserve " << size << " bytes with " << stats_.reserved_bytes
+      << " bytes reserved and " << stats_.allocated_bytes << " bytes allocated, but the memory cap is "
+      << max_reserved_bytes_ << " bytes";
+
+  void* ptr = raw_alloc_(size);
+  if (!ptr) {
+    // retry after returning all the cached memory to the device
+    ReleasePool(&small_blocks_);
+    ReleasePool(&large_blocks_);
+    ptr = raw_alloc_(size);
+  }
+  CHECK(ptr) << "CachingAllocator failed to allocate " << size << " bytes with " << stats_.reserved_bytes
+             << " bytes reserved and " << stats_.allocated_bytes << " bytes allocated";
+
+  ++stats_.num_raw_allocs;
+  stats_.reserved_bytes += size;
+  stats_.peak_reserved_bytes = std::max(stats_.peak_reserved_bytes, stats_.reserved_bytes);
+
+  auto* block     = new Block;
+  block->ptr      = ptr;
+  block->size     = size;
+  block->stream   = stream;
+  block->is_small = is_small;
+  return block;
+}
+
+void CachingAllocator::SplitBlock(Block* block, size_t size) {
+  CHECK_GE(block->size, size);
+  size_t remaining = block->size - size;
+  // large blocks are only split when the rest can serve another large request, to limit fragmentation
+  bool should_split = block->is_small ? remaining >= kMinBlockSize : remaining > kSmallSize;
+  if (!should_split) {
+    return;
+  }
+
+  auto* rest     = new Block;
+  rest->ptr      = static_cast<char*>(block->ptr) + size;
+  rest->size     = remaining;
+  rest->stream   = block->stream;
+  rest->is_small = block->is_small;
+  rest->prev     = block;
+  rest->next     = block->next;
+  if (rest->next) {
+    rest->next->prev = rest;
+  }
+  block->next = rest;
+  block->size = size;
+  GetPool(rest->is_small).insert(rest);
+}
+
+void CachingAllocator::MergeBlock(Block* dst, Block* src) {
+  CHECK_EQ(dst->next, src) << "Only the adjacent blocks can be merged";
+  dst->size += src->size;
+  dst->next = src->next;
+  if (dst->next) {
+    dst->next->prev = dst;
+  }
+  delete src;
+}
+
+size_t CachingAllocator::ReleasePool(BlockPool* pool) {
+  size_t released = 0;
+  for (auto it = pool->begin(); it != pool->end();) {
+    Block* block = *it;
+    // only a free block covering the whole segment can be returned
+    if (block->prev || block->next) {
+      ++it;
+      continue;
+    }
+    raw_free_(block->ptr);
+    ++stats_.num_raw_frees;
+    stats_.reserved_bytes -= block->size;
+    released += block->size;
+    it = pool->erase(it);
+    delete block;
+  }
+  if (released > 0) {
+    VLOG(4) << "CachingAllocator release " << released << " bytes of cached memory";
+  }
+  return released;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
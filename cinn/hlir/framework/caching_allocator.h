@@ -0,0 +1,132 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "cinn/common/macros.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * CachingAllocator keeps the memory released by users in a pool instead of returning it to the device immediately,
+ * so that the following allocations can be served without calling into the (synchronous) device allocator.
+ *
+ * Requests are rounded up to size classes: small requests(<= kSmallSize) are carved out of kSmallSegmentSize
+ * segments, larger ones get a segment rounded up to a multiple of kLargeRound. A cached block larger than the request is split,
+ * and a freed block is coalesced with its free neighbours in the same segment. Blocks are cached per stream, a block
+ * freed on one stream is only reused by the requests on the same stream, which keeps the reuse stream-ordered.
+ *
+ * The raw allocator is injected by the constructor, so the same logic serves both device and host memory.
+ */
+class CachingAllocator {
+ public:
+  using RawAllocFunc = std::function<void*(size_t nbytes)>;
+  using RawFreeFunc  = std::function<void(void* ptr)>;
+
+  static constexpr size_t kMinBlockSize     = 512;       // all sizes are rounded to at least 512 bytes
+  static constexpr size_t kSmallSize        = 1048576;   // largest "small" allocation is 1 MiB
+  static constexpr size_t kSmallSegmentSize = 2097152;   // small requests are packed into 2 MiB segments
+  static constexpr size_t kLargeRound       = 2097152;   // round up large segments to multiples of 2 MiB
+
+  struct Stats {
+    // bytes currently held from the raw allocator, including cached blocks
+    size_t reserved_bytes{0};
+    // bytes currently handed out to users
+    size_t allocated_bytes{0};
+    // the high-water mark of reserved_bytes
+    size_t peak_reserved_bytes{0};
+    // number of calls into the raw allocator and raw free
+    size_t num_raw_allocs{0};
+    size_t num_raw_frees{0};
+    // number of requests served from the cache
+    size_t num_cache_hits{0};
+  };
+
+  /**
+   * @param raw_alloc The function to allocate a segment from the device.
+   * @param raw_free The function to return a segment to the device.
+   * @param max_reserved_bytes The cap of memory held by this allocator, 0 means unlimited.
+   */
+  CachingAllocator(RawAllocFunc raw_alloc, RawFreeFunc raw_free, size_t max_reserved_bytes = 0);
+  ~CachingAllocator();
+
+  //! Allocate \p nbytes memory which will be used on \p stream.
+  void* Allocate(size_t nbytes, void* stream = nullptr);
+
+  //! Give the memory back to the pool, it must be allocated by this allocator.
+  void Free(void* ptr);
+
+  //! Return all the cached segments that are not in use to the device, and return the number of released bytes.
+  size_t ReleaseCached();
+
+  Stats GetStats() const;
+
+  void SetMaxReservedBytes(size_t max_reserved_bytes);
+
+  //! The size class of a request of \p nbytes, exposed for test.
+  static size_t RoundSize(size_t nbytes);
+
+ private:
+  struct Block {
+    void* ptr{nullptr};
+    size_t size{0};
+    void* stream{nullptr};
+    bool allocated{false};
+    bool is_small{false};
+    // neighbours in the same segment
+    Block* prev{nullptr};
+    Block* next{nullptr};
+  };
+
+  struct BlockComparator {
+    bool operator()(const Block* a, const Block* b) const;
+  };
+  using BlockPool = std::set<Block*, BlockComparator>;
+
+  BlockPool& GetPool(bool is_small) { return is_small ? small_blocks_ : large_blocks_; }
+  Block* FindFreeBlock(size_t size, void* stream, bool is_small);
+  Block* AllocSegment(size_t size, void* stream, bool is_small);
+  void SplitBlock(Block* block, size_t size);
+  void MergeBlock(Block* dst, Block* src);
+  size_t ReleasePool(BlockPool* pool);
+
+  RawAllocFunc raw_alloc_;
+  RawFreeFunc raw_free_;
+  size_t max_reserved_bytes_;
+
+  // cached free blocks ordered by (stream, size, address)
+  BlockPool small_blocks_;
+  BlockPool large_blocks_;
+  // blocks handed out to users
+  absl::flat_hash_map<void*, Block*> allocated_blocks_;
+
+  Stats stats_;
+  mutable std::mutex mtx_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CachingAllocator);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
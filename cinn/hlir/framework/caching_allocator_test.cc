@@ -0,0 +1,93 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/caching_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(CachingAllocator, RoundSize) {
+  ASSERT_EQ(CachingAllocator::RoundSize(1), CachingAllocator::kMinBlockSize);
+  ASSERT_EQ(CachingAllocator::RoundSize(512), 512UL);
+  ASSERT_EQ(CachingAllocator::RoundSize(513), 1024UL);
+}
+
+TEST(CachingAllocator, ReuseCachedBlock) {
+  CachingAllocator allocator([](size_t nbytes) { return ::malloc(nbytes); }, [](void* ptr) { ::free(ptr); });
+  void* a = allocator.Allocate(1000);
+  allocator.Free(a);
+  void* b = allocator.Allocate(1000);
+  // the block freed just now is reused without asking the raw allocator
+  ASSERT_EQ(a, b);
+  auto stats = allocator.GetStats();
+  ASSERT_EQ(stats.num_raw_allocs, 1UL);
+  ASSERT_EQ(stats.num_cache_hits, 1UL);
+  allocator.Free(b);
+}
+
+TEST(CachingAllocator, SplitAndCoalesce) {
+  CachingAllocator allocator([](size_t nbytes) { return ::malloc(nbytes); }, [](void* ptr) { ::free(ptr); });
+  // small requests are carved out of the same segment
+  void* a = allocator.Allocate(4096);
+  void* b = allocator.Allocate(4096);
+  ASSERT_EQ(static_cast<char*>(a) + 4096, static_cast<char*>(b));
+  ASSERT_EQ(allocator.GetStats().num_raw_allocs, 1UL);
+  ASSERT_EQ(allocator.GetStats().allocated_bytes, 8192UL);
+
+  allocator.Free(a);
+  allocator.Free(b);
+  ASSERT_EQ(allocator.GetStats().allocated_bytes, 0UL);
+  // the blocks are merged into a whole segment again, so it can be released
+  ASSERT_EQ(allocator.ReleaseCached(), CachingAllocator::kSmallSegmentSize);
+  auto stats = allocator.GetStats();
+  ASSERT_EQ(stats.reserved_bytes, 0UL);
+  ASSERT_EQ(stats.num_raw_frees, 1UL);
+}
+
+TEST(CachingAllocator, SeparateStreams) {
+  CachingAllocator allocator([](size_t nbytes) { return ::malloc(nbytes); }, [](void* ptr) { ::free(ptr); });
+  void* stream_a = reinterpret_cast<void*>(0x1);
+  void* stream_b = reinterpret_cast<void*>(0x2);
+  void* a        = allocator.Allocate(CachingAllocator::kSmallSize * 2, stream_a);
+  allocator.Free(a);
+  // a block cached on a stream is not reused by another stream
+  void* b = allocator.Allocate(CachingAllocator::kSmallSize * 2, stream_b);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(allocator.GetStats().num_raw_allocs, 2UL);
+  allocator.Free(b);
+}
+
+TEST(CachingAllocator, MemoryCap) {
+  CachingAllocator allocator(
+      [](size_t nbytes) { return ::malloc(nbytes); }, [](void* ptr) { ::free(ptr); }, 2 * CachingAllocator::kLargeRound);
+  void* a = allocator.Allocate(CachingAllocator::kLargeRound);
+  allocator.Free(a);
+  // the cached block can't serve the larger request, so it is released to keep under the cap
+  void* b    = allocator.Allocate(CachingAllocator::kLargeRound * 2);
+  auto stats = allocator.GetStats();
+  ASSERT_EQ(stats.num_raw_frees, 1UL);
+  ASSERT_EQ(stats.reserved_bytes, CachingAllocator::kLargeRound * 2);
+  allocator.Free(b);
+  ASSERT_EQ(allocator.ReleaseCached(), CachingAllocator::kLargeRound * 2);
+  ASSERT_EQ(allocator.GetStats().reserved_bytes, 0UL);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,272 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/control_flow.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime.h>
+
+#include "cinn/backends/cuda_util.h"
+#endif
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/utils/profiler.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+size_t GetVariableBytes(const frontend::Variable& var) {
+  size_t numel = std::accumulate(var->shape.begin(), var->shape.end(), 1UL, std::multiplies<size_t>());
+  return numel * var->type.bytes();
+}
+
+void CopyBuffer(void* dst, const void* src, size_t bytes, const Target& target, void* stream) {
+  if (dst == src || bytes == 0) {
+    return;
+  }
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToDevice, static_cast<cudaStream_t>(stream)));
+#else
+    LOG(FATAL) << "NVGPU Target only support on flag CINN_WITH_CUDA ON! Please check.";
+#endif
+  } else {
+    std::memcpy(dst, src, bytes);
+  }
+}
+
+// The predicate computed on device is copied to host, which waits for all the work issued to the stream.
+bool ReadPredicate(const cinn_buffer_t* pred, const Target& target, void* stream) {
+  bool value = false;
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    auto cuda_stream = static_cast<cudaStream_t>(stream);
+    CUDA_CALL(cudaMemcpyAsync(&value, pred->memory, sizeof(bool), cudaMemcpyDeviceToHost, cuda_stream));
+    CUDA_CALL(cudaStreamSynchronize(cuda_stream));
+#else
+    LOG(FATAL) << "NVGPU Target only support on flag CINN_WITH_CUDA ON! Please check.";
+#endif
+  } else {
+    value = *reinterpret_cast<const bool*>(pred->memory);
+  }
+  return value;
+}
+
+std::vector<cinn_buffer_t*> GetBuffers(void* v_args, int num_args) {
+  auto* args = static_cast<cinn_pod_value_t*>(v_args);
+  std::vector<cinn_buffer_t*> buffers(num_args);
+  for (int i = 0; i < num_args; ++i) {
+    buffers[i] = args[i].operator cinn_buffer_t*();
+  }
+  return buffers;
+}
+
+void RunCond(void* v_args, int num_args, int body_id, const Target& target, void* stream) {
+  utils::RecordEvent record_run("cinn_call_cond", utils::EventType::kInstruction);
+  auto* registry     = ControlFlowRegistry::Global();
+  const auto& bodies = registry->GetBodies(body_id);
+  CHECK_EQ(bodies.size(), 2UL) << "The cond " << body_id << " should have the then and else branches";
+  int num_operands = bodies[0].program.GetInputs().size();
+  CHECK_EQ(num_args, 1 + num_operands + static_cast<int>(bodies[0].outputs.size()))
+      << "The cond only accept the predicate, " << num_operands << " operands and " << bodies[0].outputs.size()
+      << " outputs";
+  auto buffers = GetBuffers(v_args, num_args);
+  bool pred    = ReadPredicate(buffers[0], target, stream);
+  VLOG(4) << "The cond " << body_id << " takes the " << (pred ? "then" : "else") << " branch";
+  registry->RunBody(body_id, pred ? 0 : 1, target, buffers.data() + 1, buffers.data() + 1 + num_operands, stream);
+}
+
+void RunWhileLoop(void* v_args, int num_args, int body_id, int num_loop_vars, const Target& target, void* stream) {
+  utils::RecordEvent record_run("cinn_call_while_loop", utils::EventType::kInstruction);
+  int num_operands = num_args - 1 - 2 * num_loop_vars;
+  CHECK_GE(num_operands, 0) << "The while_loop only accept the predicate, " << num_loop_vars
+                            << " loop variables, the operands and " << num_loop_vars << " outputs";
+  auto buffers = GetBuffers(v_args, num_args);
+  ControlFlowRegistry::Global()->RunWhileLoop(body_id,
+                                              target,
+                                              buffers[0],
+                                              buffers.data() + 1,
+                                              num_loop_vars,
+                                              buffers.data() + 1 + num_loop_vars,
+                                              num_operands,
+                                              buffers.data() + 1 + num_loop_vars + num_operands,
+                                              stream);
+}
+
+}  // namespace
+
+int ControlFlowRegistry::Register(std::vector<ControlFlowBody>&& bodies) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry    = std::make_unique<Entry>();
+  entry->bodies = std::move(bodies);
+  entries_.emplace_back(std::move(entry));
+  return entries_.size() - 1;
+}
+
+const std::vector<ControlFlowBody>& ControlFlowRegistry::GetBodies(int body_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK(body_id >= 0 && body_id < entries_.size()) << "The control flow body " << body_id << " is not registered";
+  return entries_[body_id]->bodies;
+}
+
+std::unique_ptr<ControlFlowRegistry::CompiledBody> ControlFlowRegistry::Compile(const ControlFlowBody& body,
+                                                                                const Target& target) {
+  utils::RecordEvent record_compile("ControlFlowRegistry Compile", utils::EventType::kCompile);
+  auto compiled = std::make_unique<CompiledBody>();
+  // the passes replace the instruction list of the program, so the registered one is kept for the other targets
+  frontend::Program program = body.program;
+  std::unordered_set<std::string> fetch_ids;
+  for (auto& out : body.outputs) {
+    fetch_ids.insert(out->id);
+  }
+  compiled->graph          = frontend::Optimize(&program, fetch_ids, target);
+  compiled->scope          = BuildScope(target, compiled->graph);
+  compiled->graph_compiler = std::make_unique<GraphCompiler>(target, compiled->scope, compiled->graph);
+
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  compiled->program = compiled->graph_compiler->Build(options, std::move(fetch_ids)).runtime_program;
+
+  for (auto& input : body.program.GetInputs()) {
+    auto* var = compiled->scope->FindVar(input->id);
+    compiled->inputs.push_back(var ? absl::get<Tensor>(*var)->buffer() : nullptr);
+    compiled->input_bytes.push_back(GetVariableBytes(input));
+  }
+  for (auto& output : body.outputs) {
+    auto* var = compiled->scope->FindVar(output->id);
+    CHECK(var) << "The result " << output->id << " of the control flow body is not computed";
+    compiled->outputs.push_back(absl::get<Tensor>(*var)->buffer());
+    compiled->output_bytes.push_back(GetVariableBytes(output));
+  }
+  VLOG(3) << "Compile the control flow body into " << compiled->program->size() << " instructions on " << target;
+  return compiled;
+}
+
+ControlFlowRegistry::CompiledBody* ControlFlowRegistry::GetCompiledBody(int body_id, int idx, const Target& target) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK(body_id >= 0 && body_id < entries_.size()) << "The control flow body " << body_id << " is not registered";
+  auto& entry = *entries_[body_id];
+  CHECK(idx >= 0 && idx < entry.bodies.size());
+  auto it = std::find_if(
+      entry.compiled.begin(), entry.compiled.end(), [&target](const auto& item) { return item.first == target; });
+  if (it == entry.compiled.end()) {
+    entry.compiled.emplace_back(target, std::vector<std::unique_ptr<CompiledBody>>(entry.bodies.size()));
+    it = std::prev(entry.compiled.end());
+  }
+  auto& compiled = it->second[idx];
+  if (!compiled) {
+    compiled = Compile(entry.bodies[idx], target);
+  }
+  return compiled.get();
+}
+
+void ControlFlowRegistry::RunBody(
+    int body_id, int idx, const Target& target, cinn_buffer_t** operands, cinn_buffer_t** outputs, void* stream) {
+  auto* body = GetCompiledBody(body_id, idx, target);
+  std::lock_guard<std::mutex> lock(body->run_mutex);
+  for (size_t i = 0; i < body->inputs.size(); ++i) {
+    if (body->inputs[i]) {
+      CopyBuffer(body->inputs[i]->memory, operands[i]->memory, body->input_bytes[i], target, stream);
+    }
+  }
+  body->program->Execute(nullptr, stream);
+  for (size_t i = 0; i < body->outputs.size(); ++i) {
+    CopyBuffer(outputs[i]->memory, body->outputs[i]->memory, body->output_bytes[i], target, stream);
+  }
+}
+
+void ControlFlowRegistry::RunWhileLoop(int body_id,
+                                       const Target& target,
+                                       cinn_buffer_t* pred,
+                                       cinn_buffer_t** loop_vars,
+                                       int num_loop_vars,
+                                       cinn_buffer_t** operands,
+                                       int num_operands,
+                                       cinn_buffer_t** outputs,
+                                       void* stream) {
+  auto* body = GetCompiledBody(body_id, 0, target);
+  std::lock_guard<std::mutex> lock(body->run_mutex);
+  CHECK_EQ(body->inputs.size(), num_loop_vars + num_operands);
+  CHECK_EQ(body->outputs.size(), num_loop_vars + 1);
+  // the loop variables are carried in the outputs of the op, and the operands are the same in all the iterations
+  for (int i = 0; i < num_loop_vars; ++i) {
+    CopyBuffer(outputs[i]->memory, loop_vars[i]->memory, body->input_bytes[i], target, stream);
+  }
+  for (int i = num_loop_vars; i < body->inputs.size(); ++i) {
+    if (body->inputs[i]) {
+      CopyBuffer(body->inputs[i]->memory, operands[i - num_loop_vars]->memory, body->input_bytes[i], target, stream);
+    }
+  }
+
+  int64_t num_iterations = 0;
+  for (bool keep = ReadPredicate(pred, target, stream); keep; keep = ReadPredicate(body->outputs[0], target, stream)) {
+    for (int i = 0; i < num_loop_vars; ++i) {
+      if (body->inputs[i]) {
+        CopyBuffer(body->inputs[i]->memory, outputs[i]->memory, body->input_bytes[i], target, stream);
+      }
+    }
+    body->program->Execute(nullptr, stream);
+    for (int i = 0; i < num_loop_vars; ++i) {
+      CopyBuffer(outputs[i]->memory, body->outputs[i + 1]->memory, body->output_bytes[i + 1], target, stream);
+    }
+    ++num_iterations;
+  }
+  VLOG(4) << "The while_loop " << body_id << " exits after " << num_iterations << " iterations";
+}
+
+std::string GetControlFlowApi(const std::string& op_name, const Target& target) {
+  CHECK(IsControlFlowOp(op_name)) << op_name << " is not a control flow op";
+  CHECK(target.arch == Target::Arch::NVGPU || target.is_cpu())
+      << "The control flow op " << op_name << " doesn't support " << target;
+  return "cinn_call_" + op_name + (target.arch == Target::Arch::NVGPU ? "_nvgpu" : "_host");
+}
+
+bool IsControlFlowInstruction(const std::string& function_name) {
+  return utils::Startswith(function_name, "fn_cond_") || utils::Startswith(function_name, "fn_while_loop_");
+}
+
+void cinn_call_cond_host(void* v_args, int num_args, int body_id) {
+  RunCond(v_args, num_args, body_id, common::DefaultHostTarget(), nullptr);
+}
+
+void cinn_call_while_loop_host(void* v_args, int num_args, int body_id, int num_loop_vars) {
+  RunWhileLoop(v_args, num_args, body_id, num_loop_vars, common::DefaultHostTarget(), nullptr);
+}
+
+#ifdef CINN_WITH_CUDA
+void cinn_call_cond_nvgpu(void* v_args, int num_args, int body_id, void* stream) {
+  RunCond(v_args, num_args, body_id, common::DefaultNVGPUTarget(), stream);
+}
+
+void cinn_call_while_loop_nvgpu(void* v_args, int num_args, int body_id, int num_loop_vars, void* stream) {
+  RunWhileLoop(v_args, num_args, body_id, num_loop_vars, common::DefaultNVGPUTarget(), stream);
+}
+#endif
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,140 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+class Graph;
+class GraphCompiler;
+class Program;
+class Scope;
+
+/**
+ * The body of a structured control flow op, such as a branch of cond or the body of while_loop, which is a frontend
+ * program whose inputs are bound to the operands of the op in order, and whose outputs are the results of the body.
+ * Every output is produced by an instruction of the program, so it lives in the scope of the compiled body.
+ */
+struct ControlFlowBody {
+  frontend::Program program;
+  std::vector<frontend::Variable> outputs;
+};
+
+/**
+ * The bodies of the control flow ops are held by the registry and referred by the attribute "body_id" of the ops,
+ * since the attributes can't hold a program. The op is lowered to a custom call of the host function, which reads the
+ * predicate, and runs the bodies compiled on the first run into runtime programs, so the control flow doesn't leave
+ * the compiled program.
+ *
+ * The operands are copied into the inputs of the compiled body, and the results are copied out of it, so the compiled
+ * body is run by one op at a time.
+ */
+class ControlFlowRegistry {
+ public:
+  static ControlFlowRegistry* Global() {
+    static ControlFlowRegistry registry;
+    return &registry;
+  }
+
+  //! Register the bodies of a control flow op, which are the then and else branches of cond, or the body of
+  //! while_loop, and return the id to store in the attribute "body_id" of the op.
+  int Register(std::vector<ControlFlowBody>&& bodies);
+
+  const std::vector<ControlFlowBody>& GetBodies(int body_id);
+
+  //! Run the \p idx-th body of \p body_id compiled for \p target on the operands, and copy its results into outputs.
+  void RunBody(int body_id,
+               int idx,
+               const common::Target& target,
+               cinn_buffer_t** operands,
+               cinn_buffer_t** outputs,
+               void* stream);
+
+  //! Run the body of the while_loop \p body_id until the predicate it computes is false.
+  void RunWhileLoop(int body_id,
+                    const common::Target& target,
+                    cinn_buffer_t* pred,
+                    cinn_buffer_t** loop_vars,
+                    int num_loop_vars,
+                    cinn_buffer_t** operands,
+                    int num_operands,
+                    cinn_buffer_t** outputs,
+                    void* stream);
+
+ private:
+  // A body compiled for a target, the graph compiler owns the compiled code of the program.
+  struct CompiledBody {
+    std::shared_ptr<Graph> graph;
+    std::shared_ptr<Scope> scope;
+    std::unique_ptr<GraphCompiler> graph_compiler;
+    std::unique_ptr<Program> program;
+    // the buffers of the inputs and outputs in the scope, nullptr for the inputs unused by the body
+    std::vector<cinn_buffer_t*> inputs;
+    std::vector<cinn_buffer_t*> outputs;
+    std::vector<size_t> input_bytes;
+    std::vector<size_t> output_bytes;
+    std::mutex run_mutex;
+  };
+
+  struct Entry {
+    std::vector<ControlFlowBody> bodies;
+    // the bodies compiled for each target, indexed the same as bodies
+    std::vector<std::pair<common::Target, std::vector<std::unique_ptr<CompiledBody>>>> compiled;
+  };
+
+  ControlFlowRegistry() = default;
+
+  CompiledBody* GetCompiledBody(int body_id, int idx, const common::Target& target);
+  static std::unique_ptr<CompiledBody> Compile(const ControlFlowBody& body, const common::Target& target);
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ControlFlowRegistry);
+};
+
+//! Whether the op is a structured control flow op, which is lowered to the custom call of the host function.
+inline bool IsControlFlowOp(const std::string& op_name) { return op_name == "cond" || op_name == "while_loop"; }
+
+//! The host function of the control flow op on target, the ops are not registered as external apis so that they
+//! keep their names after TransToCustomCallPass.
+std::string GetControlFlowApi(const std::string& op_name, const common::Target& target);
+
+//! Whether the instruction runs a control flow op, whose function is named after the id of the op node. It branches on
+//! host over the values computed on device, so the program can't be captured into a CUDA Graph.
+bool IsControlFlowInstruction(const std::string& function_name);
+
+// The custom calls of the control flow ops, the arguments are the predicate, the operands and the outputs of the op.
+void cinn_call_cond_host(void* v_args, int num_args, int body_id);
+void cinn_call_while_loop_host(void* v_args, int num_args, int body_id, int num_loop_vars);
+#ifdef CINN_WITH_CUDA
+void cinn_call_cond_nvgpu(void* v_args, int num_args, int body_id, void* stream);
+void cinn_call_while_loop_nvgpu(void* v_args, int num_args, int body_id, int num_loop_vars, void* stream);
+#endif
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,296 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/dag_executor.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+
+#include "cinn/runtime/cpu/thread_pool.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// Dispatch the instructions whose predecessors are all finished, it blocks until one is ready or all are finished.
+class DagDispatcher : public utils::JobDispatcher {
+ public:
+  DagDispatcher(const std::vector<std::vector<int>>& deps, const std::vector<std::vector<int>>& succs)
+      : succs_(succs), finished_(0) {
+    pending_.reserve(deps.size());
+    for (int i = 0; i < deps.size(); ++i) {
+      pending_.push_back(deps[i].size());
+      if (deps[i].empty()) {
+        ready_.push_back(i);
+      }
+    }
+  }
+
+  int Next() const override {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return !ready_.empty() || finished_ == pending_.size(); });
+    if (ready_.empty()) {
+      return -1;
+    }
+    int index = ready_.front();
+    ready_.pop_front();
+    return index;
+  }
+
+  void Done(int index) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      ++finished_;
+      for (int succ : succs_[index]) {
+        if (--pending_[succ] == 0) {
+          ready_.push_back(succ);
+        }
+      }
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  const std::vector<std::vector<int>>& succs_;
+  std::vector<int> pending_;
+  int finished_;
+  mutable std::deque<int> ready_;
+  mutable std::mutex mtx_;
+  mutable std::condition_variable cv_;
+};
+
+}  // namespace
+
+std::vector<std::vector<int>> DagExecutor::BuildDependencies(const std::vector<std::vector<std::string>>& reads,
+                                                             const std::vector<std::vector<std::string>>& writes) {
+  CHECK_EQ(reads.size(), writes.size());
+  std::vector<std::vector<int>> deps(reads.size());
+  absl::flat_hash_map<std::string, int> last_writer;
+  absl::flat_hash_map<std::string, std::vector<int>> readers_since_write;
+  for (int i = 0; i < reads.size(); ++i) {
+    std::set<int> preds;
+    for (auto& var : reads[i]) {
+      auto it = last_writer.find(var);
+      if (it != last_writer.end()) preds.insert(it->second);
+    }
+    for (auto& var : writes[i]) {
+      auto it = last_writer.find(var);
+      if (it != last_writer.end()) preds.insert(it->second);
+      auto& readers = readers_since_write[var];
+      preds.insert(readers.begin(), readers.end());
+    }
+    for (auto& var : reads[i]) {
+      readers_since_write[var].push_back(i);
+    }
+    for (auto& var : writes[i]) {
+      last_writer[var] = i;
+      readers_since_write[var].clear();
+    }
+    preds.erase(i);
+    deps[i].assign(preds.begin(), preds.end());
+  }
+  return deps;
+}
+
+std::vector<int> DagExecutor::AssignStreams(const std::vector<std::vector<int>>& deps, int num_streams) {
+  CHECK_GT(num_streams, 0);
+  std::vector<int> stream_ids(deps.size(), 0);
+  // the last instruction issued on each stream and the number of instructions on it
+  std::vector<int> tails(num_streams, -1);
+  std::vector<int> loads(num_streams, 0);
+  for (int i = 0; i < deps.size(); ++i) {
+    int chosen = -1;
+    // continue the chain of a predecessor if it is the tail of its stream, the latest one is preferred
+    for (auto it = deps[i].rbegin(); it != deps[i].rend(); ++it) {
+      if (tails[stream_ids[*it]] == *it) {
+        chosen = stream_ids[*it];
+        break;
+      }
+    }
+    // otherwise start a new chain on the least loaded stream
+    if (chosen == -1) {
+      chosen = std::min_element(loads.begin(), loads.end()) - loads.begin();
+    }
+    stream_ids[i] = chosen;
+    tails[chosen] = i;
+    ++loads[chosen];
+  }
+  return stream_ids;
+}
+
+DagExecutor::DagExecutor(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                         const Target& target,
+                         int num_workers)
+    : instrs_(instrs), target_(target), num_workers_(std::max(num_workers, 1)) {
+  std::vector<std::vector<std::string>> reads, writes;
+  for (auto& ins : instrs_) {
+    std::vector<std::string> in_vars, out_vars;
+    for (auto& args : ins->GetInArgs()) {
+      in_vars.insert(in_vars.end(), args.begin(), args.end());
+    }
+    for (auto& args : ins->GetOutArgs()) {
+      out_vars.insert(out_vars.end(), args.begin(), args.end());
+    }
+    reads.emplace_back(std::move(in_vars));
+    writes.emplace_back(std::move(out_vars));
+  }
+  deps_ = BuildDependencies(reads, writes);
+  succs_.resize(deps_.size());
+  for (int i = 0; i < deps_.size(); ++i) {
+    for (int pred : deps_[i]) {
+      succs_[pred].push_back(i);
+    }
+  }
+
+  if (target_.arch != Target::Arch::NVGPU) return;
+
+  stream_ids_ = AssignStreams(deps_, num_workers_);
+  waits_.resize(instrs_.size());
+  need_record_.assign(instrs_.size(), false);
+  stream_tails_.assign(num_workers_, -1);
+  // synced[s][t] is the latest instruction of stream t which stream s has waited on
+  std::vector<std::vector<int>> synced(num_workers_, std::vector<int>(num_workers_, -1));
+  for (int i = 0; i < deps_.size(); ++i) {
+    int stream_id = stream_ids_[i];
+    std::vector<int> latest(num_workers_, -1);
+    for (int pred : deps_[i]) {
+      latest[stream_ids_[pred]] = std::max(latest[stream_ids_[pred]], pred);
+    }
+    for (int t = 0; t < num_workers_; ++t) {
+      if (t == stream_id || latest[t] <= synced[stream_id][t]) continue;
+      waits_[i].push_back(latest[t]);
+      need_record_[latest[t]] = true;
+      synced[stream_id][t]    = latest[t];
+    }
+    stream_tails_[stream_id] = i;
+  }
+  for (int t = 1; t < num_workers_; ++t) {
+    if (stream_tails_[t] >= 0) need_record_[stream_tails_[t]] = true;
+  }
+  VLOG(3) << "DagExecutor spreads " << instrs_.size() << " instructions over "
+          << std::count_if(stream_tails_.begin(), stream_tails_.end(), [](int tail) { return tail >= 0; })
+          << " streams";
+
+#ifdef CINN_WITH_CUDA
+  // the stream 0 is given by users on running
+  streams_.assign(num_workers_, nullptr);
+  for (int t = 1; t < num_workers_; ++t) {
+    if (stream_tails_[t] < 0) continue;
+    cudaStream_t stream;
+    // the non-blocking streams don't synchronize with the legacy default stream implicitly
+    CUDA_CALL(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    streams_[t] = stream;
+  }
+  events_.assign(instrs_.size(), nullptr);
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (!need_record_[i]) continue;
+    cudaEvent_t event;
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    events_[i] = event;
+  }
+  cudaEvent_t fork_event;
+  CUDA_CALL(cudaEventCreateWithFlags(&fork_event, cudaEventDisableTiming));
+  fork_event_ = fork_event;
+#else
+  LOG(FATAL) << "Running on NVGPU requires CINN compiled with CUDA";
+#endif
+}
+
+DagExecutor::~DagExecutor() {
+#ifdef CINN_WITH_CUDA
+  for (auto* event : events_) {
+    if (event) cudaEventDestroy(static_cast<cudaEvent_t>(event));
+  }
+  if (fork_event_) cudaEventDestroy(static_cast<cudaEvent_t>(fork_event_));
+  for (auto* stream : streams_) {
+    if (stream) cudaStreamDestroy(static_cast<cudaStream_t>(stream));
+  }
+#endif
+}
+
+void DagExecutor::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+  utils::RecordEvent record_run("DagExecutor Run", utils::EventType::kOrdinary);
+  if (target_.arch == Target::Arch::NVGPU) {
+    RunOnStreams(name2podargs, stream, use_cache);
+  } else {
+    RunOnThreads(name2podargs, use_cache);
+  }
+}
+
+void DagExecutor::RunOnStreams(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                               void* stream,
+                               bool use_cache) {
+#ifdef CINN_WITH_CUDA
+  auto get_stream = [&](int stream_id) {
+    return stream_id == 0 ? static_cast<cudaStream_t>(stream) : static_cast<cudaStream_t>(streams_[stream_id]);
+  };
+  // fork: the pool streams wait for the work issued to the user stream before
+  auto fork_event = static_cast<cudaEvent_t>(fork_event_);
+  CUDA_CALL(cudaEventRecord(fork_event, static_cast<cudaStream_t>(stream)));
+  for (int t = 1; t < num_workers_; ++t) {
+    if (streams_[t]) CUDA_CALL(cudaStreamWaitEvent(get_stream(t), fork_event, 0));
+  }
+
+  for (int i = 0; i < instrs_.size(); ++i) {
+    auto cur_stream = get_stream(stream_ids_[i]);
+    for (int pred : waits_[i]) {
+      CUDA_CALL(cudaStreamWaitEvent(cur_stream, static_cast<cudaEvent_t>(events_[pred]), 0));
+    }
+    instrs_[i]->Run(name2podargs, false, cur_stream, use_cache);
+    if (need_record_[i]) {
+      CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(events_[i]), cur_stream));
+    }
+  }
+
+  // join: the user stream waits for the last instruction of every pool stream
+  for (int t = 1; t < num_workers_; ++t) {
+    if (stream_tails_[t] < 0) continue;
+    CUDA_CALL(cudaStreamWaitEvent(
+        static_cast<cudaStream_t>(stream), static_cast<cudaEvent_t>(events_[stream_tails_[t]]), 0));
+  }
+#else
+  LOG(FATAL) << "Running on NVGPU requires CINN compiled with CUDA";
+#endif
+}
+
+void DagExecutor::RunOnThreads(const std::map<std::string, cinn_pod_value_t>* name2podargs, bool use_cache) {
+  if (num_workers_ == 1) {
+    for (auto& ins : instrs_) {
+      ins->Run(name2podargs, false, nullptr, use_cache);
+    }
+    return;
+  }
+  DagDispatcher dispatcher(deps_, succs_);
+  // the thread budget of the caller is kept on the worker threads
+  int thread_budget = runtime::cpu::ThreadPool::GetThreadBudget();
+  auto worker_fn    = [&](int index) {
+    runtime::cpu::ScopedThreadBudget budget(thread_budget);
+    instrs_[index]->Run(name2podargs, false, nullptr, use_cache);
+    dispatcher.Done(index);
+  };
+  utils::parallel_run(worker_fn, std::move(dispatcher), num_workers_);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
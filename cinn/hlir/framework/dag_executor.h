@@ -0,0 +1,95 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/instruction.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * DagExecutor runs the instructions of a Program according to their data dependencies instead of one by one.
+ *
+ * The dependency DAG is derived from the arguments of each instruction: an instruction depends on the last writer of
+ * every variable it reads or writes (read-after-write, write-after-write), and on the readers of every variable it
+ * writes since the last write (write-after-read). The instructions are issued in the original order, which is already
+ * a topological order of the DAG.
+ *
+ * On NVGPU, the chains of the DAG are assigned to a pool of streams, and a stream waits on the event of the
+ * predecessors issued on the other streams. The first stream is the one given by users, the others fork from and join
+ * to it by events, so the behaviour seen by users is the same as running on a single stream.
+ * On X86, the ready instructions are run by a pool of threads in parallel.
+ */
+class DagExecutor {
+ public:
+  /**
+   * @param instrs The instructions to run, they must outlive the executor.
+   * @param target The target of all the instructions.
+   * @param num_workers The number of streams on NVGPU or threads on X86.
+   */
+  DagExecutor(const std::vector<std::unique_ptr<Instruction>>& instrs, const Target& target, int num_workers);
+  ~DagExecutor();
+
+  void Run(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr,
+           void* stream                                                = nullptr,
+           bool use_cache                                              = true);
+
+  //! The predecessors of each instruction, given the variables read and written by every instruction.
+  static std::vector<std::vector<int>> BuildDependencies(const std::vector<std::vector<std::string>>& reads,
+                                                         const std::vector<std::vector<std::string>>& writes);
+
+  //! Assign each instruction to one of \p num_streams streams, a chain of the DAG is kept on the same stream.
+  static std::vector<int> AssignStreams(const std::vector<std::vector<int>>& deps, int num_streams);
+
+  const std::vector<std::vector<int>>& deps() const { return deps_; }
+  const std::vector<int>& stream_ids() const { return stream_ids_; }
+
+ private:
+  void RunOnStreams(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+  void RunOnThreads(const std::map<std::string, cinn_pod_value_t>* name2podargs, bool use_cache);
+
+  const std::vector<std::unique_ptr<Instruction>>& instrs_;
+  Target target_;
+  int num_workers_;
+
+  std::vector<std::vector<int>> deps_;
+  std::vector<std::vector<int>> succs_;
+  // the stream of each instruction and the events it should wait on
+  std::vector<int> stream_ids_;
+  std::vector<std::vector<int>> waits_;
+  // whether the event of an instruction should be recorded after it is issued
+  std::vector<bool> need_record_;
+  // the last instruction of each stream, the user stream joins them at the end
+  std::vector<int> stream_tails_;
+
+  // cudaStream_t and cudaEvent_t, hold as void* to not expose the CUDA headers
+  std::vector<void*> streams_;
+  std::vector<void*> events_;
+  void* fork_event_{nullptr};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(DagExecutor);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
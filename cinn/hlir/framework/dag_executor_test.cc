@@ -0,0 +1,91 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/dag_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(DagExecutor, BuildDependencies) {
+  // 0: b = f(a), 1: c = f(a), 2: d = f(b, c), 3: a = f(d)
+  std::vector<std::vector<std::string>> reads  = {{"a"}, {"a"}, {"b", "c"}, {"d"}};
+  std::vector<std::vector<std::string>> writes = {{"b"}, {"c"}, {"d"}, {"a"}};
+  auto deps                                    = DagExecutor::BuildDependencies(reads, writes);
+  ASSERT_TRUE(deps[0].empty());
+  ASSERT_TRUE(deps[1].empty());
+  ASSERT_EQ(deps[2], std::vector<int>({0, 1}));
+  // read-after-write on "d" and write-after-read on "a"
+  ASSERT_EQ(deps[3], std::vector<int>({0, 1, 2}));
+}
+
+TEST(DagExecutor, AssignStreams) {
+  // two independent chains 0->2 and 1->3 joined by 4
+  std::vector<std::vector<int>> deps = {{}, {}, {0}, {1}, {2, 3}};
+  auto stream_ids                    = DagExecutor::AssignStreams(deps, 2);
+  ASSERT_EQ(stream_ids, std::vector<int>({0, 1, 0, 1, 1}));
+  // all on one stream
+  ASSERT_EQ(DagExecutor::AssignStreams(deps, 1), std::vector<int>(5, 0));
+}
+
+// out = in + value for the buffers of float[1]
+template <int value>
+void AddValue(void* v_args, int32_t num_args) {
+  auto* args = static_cast<cinn_pod_value_t*>(v_args);
+  float sum  = 0.f;
+  for (int i = 0; i < num_args - 1; ++i) {
+    sum += reinterpret_cast<float*>(cinn_pod_value_to_buffer_p(&args[i])->memory)[0];
+  }
+  reinterpret_cast<float*>(cinn_pod_value_to_buffer_p(&args[num_args - 1])->memory)[0] = sum + value;
+}
+
+TEST(DagExecutor, RunOnThreads) {
+  Scope scope;
+  for (auto& name : std::vector<std::string>({"a", "b", "c", "d"})) {
+    auto& tensor = absl::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape({1}));
+    tensor->mutable_data<float>(common::DefaultHostTarget())[0] = 0.f;
+  }
+  scope.GetTensor("a")->mutable_data<float>(common::DefaultHostTarget())[0] = 1.f;
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::vector<std::string>& in_args, const std::string& out_arg, void* fn) {
+    instrs.emplace_back(std::make_unique<Instruction>(
+        common::DefaultHostTarget(), &scope, in_args, std::vector<std::string>({out_arg})));
+    instrs.back()->SetLoweredFunc(fn);
+    instrs.back()->Finalize();
+  };
+  add_instr({"a"}, "b", reinterpret_cast<void*>(&AddValue<1>));
+  add_instr({"a"}, "c", reinterpret_cast<void*>(&AddValue<2>));
+  add_instr({"b", "c"}, "d", reinterpret_cast<void*>(&AddValue<0>));
+
+  DagExecutor executor(instrs, common::DefaultHostTarget(), 4);
+  for (int i = 0; i < 10; ++i) {
+    executor.Run();
+    ASSERT_EQ(scope.GetTensor("d")->data<float>()[0], 5.f);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
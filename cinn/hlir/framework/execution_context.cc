@@ -0,0 +1,225 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/execution_context.h"
+
+#include <limits>
+#include <unordered_map>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/utils/profiler.h"
+
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime.h>
+
+#include "cinn/runtime/cuda/cuda_module.h"
+#endif
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+// Set the current device in the scope, nothing is done for a negative device id.
+class DeviceGuard {
+ public:
+  explicit DeviceGuard(int device_id) {
+#ifdef CINN_WITH_CUDA
+    if (device_id < 0) return;
+    CUDA_CALL(cudaGetDevice(&origin_device_));
+    if (origin_device_ == device_id) {
+      origin_device_ = -1;
+    } else {
+      CUDA_CALL(cudaSetDevice(device_id));
+    }
+#else
+    CHECK_LT(device_id, 0) << "Running a program on a given device requires CUDA";
+#endif
+  }
+  ~DeviceGuard() {
+#ifdef CINN_WITH_CUDA
+    if (origin_device_ >= 0) cudaSetDevice(origin_device_);
+#endif
+  }
+
+ private:
+  int origin_device_{-1};
+};
+
+// Tell whether the tensor of the program should be copied to the device of a replica rather than shared.
+bool NeedReplicate(const Tensor& tensor, int device_id) {
+#ifdef CINN_WITH_CUDA
+  if (device_id < 0 || !tensor->buffer() || !tensor->buffer()->memory) return false;
+  if (tensor->get_buffer()->target().arch != Target::Arch::NVGPU) return false;
+  cudaPointerAttributes attributes;
+  CUDA_CALL(cudaPointerGetAttributes(&attributes, tensor->buffer()->memory));
+  return attributes.device != device_id;
+#else
+  return false;
+#endif
+}
+}  // namespace
+
+ExecutionContext::ExecutionContext(Program* program, const std::vector<std::string>& input_names, int device_id)
+    : program_(program),
+      device_id_(device_id),
+      scope_(std::make_shared<Scope>()),
+      private_names_(input_names.begin(), input_names.end()) {
+  utils::RecordEvent record_event("ExecutionContext Create", utils::EventType::kOrdinary);
+  // the arena and the private variables are allocated on the device of the context
+  DeviceGuard device_guard(device_id_);
+#ifdef CINN_WITH_CUDA
+  if (device_id_ >= 0) {
+    runtime::cuda::CUDAModule::EnableCrossDeviceLaunch();
+  }
+#endif
+  const auto& instrs = program_->GetRunInstructions();
+  for (auto& ins : instrs) {
+    for (auto& args : ins->GetOutArgs()) {
+      private_names_.insert(args.begin(), args.end());
+    }
+  }
+
+  const auto& plan = program_->GetMemoryPlan();
+  uint8_t* base    = nullptr;
+  if (!plan.empty()) {
+    CHECK_LE(plan.arena_bytes, std::numeric_limits<uint32_t>::max())
+        << "The arena of the static memory plan is too large";
+    const auto& target = program_->GetMemoryPlanTarget();
+    arena_             = std::make_unique<Buffer>(target);
+    if (target == common::DefaultHostTarget()) {
+      arena_->ResizeLazy(1024, plan.arena_bytes);
+    } else {
+      arena_->ResizeLazy(plan.arena_bytes);
+    }
+    base = arena_->data()->memory;
+  }
+
+  // the private variables sharing a buffer in the program share a buffer of the context as well
+  std::unordered_map<Buffer*, std::shared_ptr<Buffer>> buffers;
+  auto& program_scope = program_->GetScope();
+  auto add_private    = [&](const std::string& name) {
+    auto origin = program_scope->GetTensor(name);
+    Tensor tensor;
+    tensor->Resize(origin->shape());
+    tensor->set_type(origin->type());
+    auto it = buffers.find(origin->get_buffer().get());
+    if (it != buffers.end()) {
+      tensor->set_buffer(it->second);
+    } else {
+      if (plan.offsets.count(name)) {
+        tensor->get_buffer()->SetExternalMemory(base + plan.offsets.at(name), plan.sizes.at(name));
+      } else if (origin->buffer()->memory) {
+        tensor->mutable_data(origin->get_buffer()->target(), origin->type());
+      }
+      buffers.emplace(origin->get_buffer().get(), tensor->get_buffer());
+    }
+    absl::get<Tensor>(*scope_->Var<Tensor>(name)) = tensor;
+  };
+  // bind the planned variables first, so that their aliases are bound to the arena too
+  for (auto& item : plan.offsets) {
+    if (private_names_.count(item.first)) {
+      add_private(item.first);
+    }
+  }
+  // the weights and the results of the prerun instructions on another device are copied to the device once
+  for (auto& name : program_scope->var_names()) {
+    std::string var_name(name);
+    if (scope_->FindVar(var_name)) continue;
+    if (private_names_.count(var_name)) {
+      add_private(var_name);
+    } else if (NeedReplicate(program_scope->GetTensor(var_name), device_id_)) {
+      add_private(var_name);
+      replicated_names_.insert(var_name);
+    } else {
+      absl::get<Tensor>(*scope_->Var<Tensor>(var_name)) = program_scope->GetTensor(var_name);
+    }
+  }
+#ifdef CINN_WITH_CUDA
+  for (auto& name : replicated_names_) {
+    auto origin = program_scope->GetTensor(name);
+    cudaPointerAttributes attributes;
+    CUDA_CALL(cudaPointerGetAttributes(&attributes, origin->buffer()->memory));
+    CUDA_CALL(cudaMemcpyPeer(scope_->GetTensor(name)->buffer()->memory,
+                             device_id_,
+                             origin->buffer()->memory,
+                             attributes.device,
+                             origin->shape().numel() * origin->type().bytes()));
+  }
+#endif
+
+  for (auto& name : scope_->var_names()) {
+    std::string var_name(name);
+    name2podargs_.emplace(var_name, cinn_pod_value_t(scope_->GetTensor(var_name)->buffer()));
+  }
+  args_.reserve(instrs.size());
+  for (auto& ins : instrs) {
+    args_.emplace_back(ins->BuildArgs(name2podargs_));
+  }
+  VLOG(3) << "Create an execution context with " << private_names_.size() << " private variables and "
+          << replicated_names_.size() << " replicated variables of " << scope_->var_names().size()
+          << " variables on device " << device_id_;
+}
+
+ExecutionContext::~ExecutionContext() {
+  DeviceGuard device_guard(device_id_);
+  if (arena_) {
+    // the tensors may outlive the context, detach them from the arena to be released
+    for (auto& item : program_->GetMemoryPlan().offsets) {
+      if (private_names_.count(item.first) || replicated_names_.count(item.first)) {
+        scope_->GetTensor(item.first)->get_buffer()->Free();
+      }
+    }
+  }
+  // release the memory of the device while it is current
+  scope_.reset();
+  arena_.reset();
+}
+
+void ExecutionContext::Execute(void* stream) {
+  DeviceGuard device_guard(device_id_);
+  const auto& instrs = program_->GetRunInstructions();
+  for (size_t i = 0; i < instrs.size(); ++i) {
+    instrs[i]->RunWithArgs(&args_[i], &name2podargs_, stream);
+  }
+#ifdef CINN_WITH_CUDA
+  if (!instrs.empty() && instrs[0]->target_.arch == Target::Arch::NVGPU && stream == nullptr) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+}
+
+ProgramReplicas::ProgramReplicas(Program* program,
+                                 const std::vector<std::string>& input_names,
+                                 const std::vector<int>& device_ids) {
+  CHECK(!device_ids.empty()) << "No device to replicate the program onto";
+  for (int device_id : device_ids) {
+    replicas_.push_back({program->CreateExecutionContext(input_names, device_id), std::make_unique<std::mutex>()});
+  }
+}
+
+int ProgramReplicas::Run(const std::function<void(ExecutionContext*)>& feed,
+                         const std::function<void(ExecutionContext*)>& fetch) {
+  int index     = next_replica_++ % replicas_.size();
+  auto& replica = replicas_[index];
+  std::lock_guard<std::mutex> lock(*replica.mutex);
+  if (feed) feed(replica.context.get());
+  replica.context->Execute();
+  if (fetch) fetch(replica.context.get());
+  return index;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
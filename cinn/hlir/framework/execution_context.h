@@ -0,0 +1,128 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/buffer.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+class Program;
+
+/**
+ * ExecutionContext holds the state of one request running a compiled Program, so that several threads can run the
+ * same Program at the same time, each with its own context.
+ *
+ * The compiled functions of the instructions and the variables only read by them, such as the weights and the results
+ * of the prerun instructions, are shared with the Program. The inputs given by users and the variables written by the
+ * instructions are private to the context: they have the same shapes and dtypes as in the scope of the Program, the
+ * aliases sharing a buffer in the Program share a buffer in the context too, and the variables of the static memory
+ * plan are bound to an arena of the context at the same offsets. The arguments of the instructions are built once on
+ * creating.
+ *
+ * The private variables are not initialized, the inputs should be set by GetTensor before Execute. The CUDA Graph,
+ * the dag executor and the profiling of the Program are not used by the context.
+ *
+ * A context can also replicate a program compiled for NVGPU onto another GPU: the variables are allocated on that
+ * device, the shared ones on other devices, such as the weights, are copied once on creating, and the kernels are
+ * loaded on that device from the same cubin on the first launch. The custom calls must not keep device pointers of
+ * their own, and the global variables of the device modules are not replicated.
+ */
+class ExecutionContext {
+ public:
+  /**
+   * @param program The compiled program, which must outlive the context. Use Program::CreateExecutionContext to make
+   * sure the program is compiled and the prerun instructions are run before.
+   * @param input_names The names of the variables fed by users.
+   * @param device_id The GPU to run the program on, which is set as the current device in Execute, or -1 to run on
+   * the current device with the weights shared.
+   */
+  ExecutionContext(Program* program, const std::vector<std::string>& input_names, int device_id = -1);
+  ~ExecutionContext();
+
+  //! Run all the instructions of the program with the variables of this context, the stream must belong to the
+  //! device of the context.
+  void Execute(void* stream = nullptr);
+
+  Tensor GetTensor(const std::string& name) const { return scope_->GetTensor(name); }
+  const std::shared_ptr<Scope>& GetScope() const { return scope_; }
+  bool IsPrivate(const std::string& name) const { return private_names_.count(name); }
+  int device_id() const { return device_id_; }
+
+ private:
+  Program* program_;
+  int device_id_;
+  std::unique_ptr<Buffer> arena_;
+  std::shared_ptr<Scope> scope_;
+  std::set<std::string> private_names_;
+  // the shared variables copied from another device
+  std::set<std::string> replicated_names_;
+  std::map<std::string, cinn_pod_value_t> name2podargs_;
+  // the arguments of each function of each instruction
+  std::vector<std::vector<std::vector<cinn_pod_value_t>>> args_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ExecutionContext);
+};
+
+/**
+ * ProgramReplicas runs a compiled Program data parallel, with one ExecutionContext on each of the given devices, and
+ * dispatches the batches to them in turn. The batches dispatched to the same replica run one by one.
+ */
+class ProgramReplicas {
+ public:
+  /**
+   * @param program The compiled program, which must outlive the replicas.
+   * @param input_names The names of the variables fed by users.
+   * @param device_ids The devices to replicate the program onto, -1 means the current device.
+   */
+  ProgramReplicas(Program* program, const std::vector<std::string>& input_names, const std::vector<int>& device_ids);
+
+  /**
+   * Run a batch on the next replica: \p feed sets the inputs of the context, then the program is executed, then
+   * \p fetch reads the outputs, all of them holding the replica. Thread-safe.
+   * @return The index of the replica running the batch.
+   */
+  int Run(const std::function<void(ExecutionContext*)>& feed, const std::function<void(ExecutionContext*)>& fetch);
+
+  size_t size() const { return replicas_.size(); }
+  ExecutionContext* GetReplica(int index) const { return replicas_[index].context.get(); }
+
+ private:
+  struct Replica {
+    std::unique_ptr<ExecutionContext> context;
+    std::unique_ptr<std::mutex> mutex;
+  };
+  std::vector<Replica> replicas_;
+  std::atomic<unsigned> next_replica_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ProgramReplicas);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,127 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/execution_context.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// out = sum(in) + value for the buffers of float[1]
+template <int value>
+void AddValue(void* v_args, int32_t num_args) {
+  auto* args = static_cast<cinn_pod_value_t*>(v_args);
+  float sum  = 0.f;
+  for (int i = 0; i < num_args - 1; ++i) {
+    sum += reinterpret_cast<float*>(cinn_pod_value_to_buffer_p(&args[i])->memory)[0];
+  }
+  reinterpret_cast<float*>(cinn_pod_value_to_buffer_p(&args[num_args - 1])->memory)[0] = sum + value;
+}
+
+TEST(ExecutionContext, ConcurrentRun) {
+  auto target = common::DefaultHostTarget();
+  auto scope  = std::make_shared<Scope>();
+  for (auto& name : std::vector<std::string>({"w", "x", "y", "z"})) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape({1}));
+    tensor->mutable_data<float>(target)[0] = 0.f;
+  }
+  scope->GetTensor("w")->mutable_data<float>(target)[0] = 10.f;
+
+  // y = x + w + 1, z = y + 2
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::vector<std::string>& in_args, const std::string& out_arg, void* fn) {
+    instrs.emplace_back(
+        std::make_unique<Instruction>(target, scope.get(), in_args, std::vector<std::string>({out_arg})));
+    instrs.back()->SetLoweredFunc(fn);
+    instrs.back()->Finalize();
+  };
+  add_instr({"x", "w"}, "y", reinterpret_cast<void*>(&AddValue<1>));
+  add_instr({"y"}, "z", reinterpret_cast<void*>(&AddValue<2>));
+  Program program(scope, std::move(instrs));
+
+  std::vector<std::unique_ptr<ExecutionContext>> contexts;
+  for (int i = 0; i < 4; ++i) {
+    contexts.emplace_back(program.CreateExecutionContext({"x"}));
+    ASSERT_TRUE(contexts.back()->IsPrivate("y"));
+    ASSERT_FALSE(contexts.back()->IsPrivate("w"));
+    // the weight is shared, the others are private
+    ASSERT_EQ(contexts.back()->GetTensor("w")->buffer(), scope->GetTensor("w")->buffer());
+    ASSERT_NE(contexts.back()->GetTensor("x")->buffer(), scope->GetTensor("x")->buffer());
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < contexts.size(); ++i) {
+    threads.emplace_back([&contexts, &target, i]() {
+      auto& context                                          = contexts[i];
+      context->GetTensor("x")->mutable_data<float>(target)[0] = static_cast<float>(i);
+      for (int run = 0; run < 100; ++run) {
+        context->Execute();
+        ASSERT_EQ(context->GetTensor("z")->data<float>()[0], i + 13.f);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // the variables of the program are not touched
+  ASSERT_EQ(scope->GetTensor("z")->data<float>()[0], 0.f);
+}
+
+TEST(ProgramReplicas, RoundRobin) {
+  auto target = common::DefaultHostTarget();
+  auto scope  = std::make_shared<Scope>();
+  for (auto& name : std::vector<std::string>({"w", "x", "y"})) {
+    auto& tensor = absl::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape({1}));
+    tensor->mutable_data<float>(target)[0] = 0.f;
+  }
+  scope->GetTensor("w")->mutable_data<float>(target)[0] = 10.f;
+
+  // y = x + w + 1
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  instrs.emplace_back(std::make_unique<Instruction>(
+      target, scope.get(), std::vector<std::string>({"x", "w"}), std::vector<std::string>({"y"})));
+  instrs.back()->SetLoweredFunc(reinterpret_cast<void*>(&AddValue<1>));
+  instrs.back()->Finalize();
+  Program program(scope, std::move(instrs));
+
+  ProgramReplicas replicas(&program, {"x"}, {-1, -1, -1});
+  ASSERT_EQ(replicas.size(), 3);
+  for (int batch = 0; batch < 6; ++batch) {
+    float result = 0.f;
+    int index    = replicas.Run(
+        [&](ExecutionContext* context) {
+          context->GetTensor("x")->mutable_data<float>(target)[0] = static_cast<float>(batch);
+        },
+        [&](ExecutionContext* context) { result = context->GetTensor("y")->data<float>()[0]; });
+    ASSERT_EQ(index, batch % 3);
+    ASSERT_EQ(result, batch + 11.f);
+    ASSERT_EQ(replicas.GetReplica(index)->GetTensor("w")->buffer(), scope->GetTensor("w")->buffer());
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -14,6 +14,7 @@
 
 #include "cinn/hlir/framework/graph.h"
 
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 
@@ -494,6 +495,71 @@ std::unordered_set<NodeData*> Graph::Group::GetOutputNodeDatas() {
   return group_outputs;
 }
 
+std::string Graph::Group::StructuralSignature(const absl::flat_hash_map<std::string, shape_t>& shape_dict,
+                                              const absl::flat_hash_map<std::string, common::Type>& dtype_dict,
+                                              std::vector<std::string>* var_names) {
+  std::stringstream ss;
+  absl::flat_hash_map<std::string, int> var_index;
+  auto write_var = [&](NodeData* node_data) {
+    if (node_data == nullptr) {
+      ss << "null,";
+      return;
+    }
+    std::string id = node_data->id();
+    auto it        = var_index.find(id);
+    if (it != var_index.end()) {
+      ss << "v" << it->second << ",";
+      return;
+    }
+    var_index[id] = var_names->size();
+    var_names->push_back(id);
+    // the shape and dtype are written at the first appearance
+    ss << "v" << var_index[id] << "[";
+    if (shape_dict.count(id)) ss << utils::Join(shape_dict.at(id), " ");
+    ss << "]";
+    if (dtype_dict.count(id)) ss << dtype_dict.at(id);
+    ss << ",";
+  };
+  auto write_group = [&](Group* group) {
+    ss << "pattern" << group->op_pattern_kind << "{";
+    for (auto* node : group->nodes) {
+      ss << node->op()->name << "(";
+      std::vector<std::string> attr_names;
+      for (auto& attr : node->attrs.attr_store) {
+        attr_names.push_back(attr.first);
+      }
+      std::sort(attr_names.begin(), attr_names.end());
+      for (auto& name : attr_names) {
+        ss << name << "=" << utils::Attribute2String(node->attrs.attr_store.at(name)) << ";";
+      }
+      ss << ")in:";
+      for (auto& link : node->inlinks_in_order()) {
+        write_var(link->source()->safe_as<NodeData>());
+      }
+      ss << "out:";
+      for (auto& link : node->outlinks_in_order()) {
+        write_var(link->sink()->safe_as<NodeData>());
+      }
+      // the roles of the node in the group and the group it belongs to
+      ss << "role:" << group->output_nodes.count(node) << group->internal_nodes.count(node)
+         << group->master_nodes.count(node) << output_nodes.count(node) << internal_nodes.count(node)
+         << master_nodes.count(node) << ";";
+    }
+    ss << "}";
+  };
+
+  ss << "pattern" << op_pattern_kind << "[";
+  if (fused_sub_groups.empty()) {
+    write_group(this);
+  } else {
+    for (auto& sub_group : fused_sub_groups) {
+      write_group(sub_group.get());
+    }
+  }
+  ss << "]";
+  return ss.str();
+}
+
 void Graph::SaveSourceCode(const std::string& code) {
   if (cinn::runtime::CheckStringFlagFalse(FLAGS_cinn_fusion_groups_graphviz_dir) || viz_path_.empty()) {
     return;
@@ -126,6 +126,16 @@ class Graph : public cinn::common::Graph {
     std::unordered_set<NodeData*> GetOutputNodeDatas();
 
     std::string GetFuncName() { return "fn_" + group_id + unique_id; }
+
+    /**
+     * The structural signature of the group, two groups get the same signature if they have the same op patterns,
+     * ops, attrs, shapes, dtypes and connections, no matter what the names of the nodes and variables are.
+     * @param var_names The names of the variables in the order they appear in the signature, so the variables of two
+     * groups with the same signature correspond to each other by position.
+     */
+    std::string StructuralSignature(const absl::flat_hash_map<std::string, shape_t>& shape_dict,
+                                    const absl::flat_hash_map<std::string, common::Type>& dtype_dict,
+                                    std::vector<std::string>* var_names);
   };
   std::vector<std::shared_ptr<Group>> fusion_groups;
 
@@ -16,22 +16,53 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <absl/container/flat_hash_set.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <set>
 #include <unordered_set>
 
+#include "cinn/auto_schedule/tuning_pack.h"
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/common/context.h"
+#include "cinn/hlir/framework/control_flow.h"
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/op_lowering_util.h"
+#include "cinn/hlir/framework/program_artifact.pb.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/lang/lower.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/poly/stage.h"
+#include "cinn/runtime/cpu/thread_pool.h"
+#include "cinn/utils/multi_threading.h"
 #include "cinn/utils/profiler.h"
+#ifdef CINN_WITH_ROCM
+#include "cinn/runtime/hip/hip_util.h"
+#endif
 
 DECLARE_bool(cinn_ir_schedule);
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_use_cuda_graph);
+DECLARE_bool(cinn_use_dag_executor);
+DECLARE_int32(cinn_dag_executor_num_workers);
+DECLARE_int32(cinn_program_thread_budget);
+DECLARE_int32(cinn_lazy_compile_prefetch_thread);
+DECLARE_bool(cinn_stitch_small_kernels);
+DECLARE_bool(cinn_use_inplace_variables);
+DECLARE_bool(cinn_use_concat_slices);
+DECLARE_int64(cinn_swap_memory_budget_mb);
+DECLARE_double(cinn_swap_host_gbps);
+DECLARE_string(cinn_tuning_pack_file);
+DECLARE_string(cinn_export_cc);
 
 namespace cinn {
 namespace hlir {
@@ -39,6 +70,8 @@ namespace framework {
 
 using cinn::common::bfloat16;
 using cinn::common::float16;
+using cinn::common::float8_e4m3;
+using cinn::common::float8_e5m2;
 
 // Store params from node to instruction
 void AddAttrs(const absl::flat_hash_map<std::string, AttrType>& attrs_store,
@@ -65,7 +98,7 @@ void AddAttrs(const absl::flat_hash_map<std::string, AttrType>& attrs_store,
 }
 
 Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs)
-    : scope_(scope) {
+    : scope_(scope), thread_budget_(FLAGS_cinn_program_thread_budget) {
   for (auto& ins : instrs) {
     if (ins->pre_run) {
       prerun_instrs_.push_back(std::move(ins));
@@ -75,15 +108,104 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
   }
 }
 
+Program::~Program() {
+  StopPrefetchCompile();
+  ResetCudaGraph();
+#ifdef CINN_WITH_CUDA
+  if (cuda_graph_stream_) {
+    cudaStreamDestroy(static_cast<cudaStream_t>(cuda_graph_stream_));
+  }
+#endif
+  if (!arena_) return;
+  // the scope may outlive the program, detach the variables from the arena to be released
+  for (auto& item : memory_plan_.offsets) {
+    auto* var = scope_->FindVar(item.first);
+    if (var) {
+      absl::get<Tensor>(*var)->get_buffer()->Free();
+    }
+  }
+}
+
+void Program::SetMemoryPlan(MemoryPlan&& plan, const Target& target) {
+  CHECK(!arena_) << "The memory plan has been bound to the variables already";
+  memory_plan_  = std::move(plan);
+  arena_target_ = target;
+}
+
+void Program::SetSwapPlan(SwapPlan&& plan) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  activation_swapper_.reset();
+  swap_plan_ = std::move(plan);
+  if (!swap_plan_.empty()) {
+    // the captured CUDA Graph doesn't free and reallocate the swapped variables
+    ResetCudaGraph();
+    cuda_graph_disabled_ = true;
+  }
+}
+
+void Program::BindMemoryPlan() {
+  if (arena_ || memory_plan_.empty()) return;
+  utils::RecordEvent record_event("Program BindMemoryPlan", utils::EventType::kOrdinary);
+  CHECK_LE(memory_plan_.arena_bytes, std::numeric_limits<uint32_t>::max())
+      << "The arena of the static memory plan is too large";
+  arena_ = std::make_unique<Buffer>(arena_target_);
+  if (arena_target_ == common::DefaultHostTarget()) {
+    arena_->ResizeLazy(1024, memory_plan_.arena_bytes);
+  } else {
+    arena_->ResizeLazy(memory_plan_.arena_bytes);
+  }
+  uint8_t* base = arena_->data()->memory;
+  for (auto& item : memory_plan_.offsets) {
+    auto* var = scope_->FindVar(item.first);
+    CHECK(var) << "The planned variable [" << item.first << "] is not found in scope";
+    auto& tensor = absl::get<Tensor>(*var);
+    tensor->get_buffer()->SetExternalMemory(base + item.second, memory_plan_.sizes.at(item.first));
+  }
+  VLOG(3) << "Bind " << memory_plan_.offsets.size() << " variables to an arena of " << memory_plan_.arena_bytes
+          << " bytes, which saves " << memory_plan_.total_bytes - memory_plan_.arena_bytes << " bytes";
+}
+
+void Program::StartPrefetchCompile(int num_threads) {
+  if (num_threads <= 0 || prefetch_.valid()) return;
+  bool has_lazy = std::any_of(instrs_.begin(), instrs_.end(), [](const auto& ins) { return !ins->IsCompiled(); });
+  if (!has_lazy) return;
+  VLOG(3) << "Prefetch the compilation of " << instrs_.size() << " instructions by " << num_threads << " threads";
+  prefetch_ = utils::TaskPool::Global().Submit([this, num_threads]() {
+    // the jobs are dispatched in the order of execution, the instructions compiled by the run already are skipped
+    auto compile = [this](int index) {
+      if (prefetch_stopped_.load(std::memory_order_relaxed)) return;
+      instrs_[index]->Compile();
+    };
+    utils::parallel_run(compile, utils::SequenceDispatcher(0, instrs_.size()), num_threads);
+  });
+}
+
+void Program::StopPrefetchCompile() {
+  prefetch_stopped_.store(true, std::memory_order_relaxed);
+  if (prefetch_.valid()) {
+    utils::TaskPool::Global().Wait(&prefetch_);
+  }
+}
+
+void Program::CompileInstructions() {
+  for (auto& ins : instrs_) {
+    ins->Compile();
+  }
+}
+
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  BindMemoryPlan();
   for (auto& ins : prerun_instrs_) {
     ins->Run(name2podargs);
   }
+  prerun_done_ = true;
   for (auto& ins : instrs_) {
     if (ins->size() == 4) {
       ins->PreRun(name2podargs);
     }
   }
+  feed_slots_.clear();
 }
 
 void Program::Export(const std::vector<std::string>& persistent_vars, const std::string& filename) {
@@ -209,9 +331,325 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
   fclose(f);
 }
 
-void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+// bump it when the layout of the artifact changes
+static constexpr int kProgramArtifactVersion = 1;
+
+bool Program::IsSerializable() {
+  if (instrs_.empty()) return false;
+  absl::flat_hash_set<std::string> compiled_fns;
+  for (auto& module : loaded_modules_) {
+    compiled_fns.insert(module.fn_names.begin(), module.fn_names.end());
+  }
+  if (parallel_compiler_) {
+    for (auto& module : parallel_compiler_->GetCompiledModules()) {
+      compiled_fns.insert(module.fn_names.begin(), module.fn_names.end());
+    }
+  }
+  for (auto* instrs : {&prerun_instrs_, &instrs_}) {
+    for (auto& ins : *instrs) {
+      if (!ins->IsCompiled()) return false;
+      for (auto& fn_name : ins->GetFnNames()) {
+        if (!compiled_fns.count(fn_name)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::string Program::Serialize() {
+  utils::RecordEvent record_event("Program Serialize", utils::EventType::kOrdinary);
+  CHECK(!instrs_.empty()) << "There is no instruction to save";
+  // the lazy instructions get their arguments and functions after compiled
+  CompileInstructions();
+  std::vector<CompiledModule> modules = loaded_modules_;
+  if (parallel_compiler_) {
+    auto compiled_modules = parallel_compiler_->GetCompiledModules();
+    modules.insert(modules.end(), compiled_modules.begin(), compiled_modules.end());
+  }
+
+  proto::ProgramArtifact artifact;
+  artifact.set_version(kProgramArtifactVersion);
+  artifact.set_target_arch(static_cast<int>(instrs_[0]->target_.arch));
+  artifact.set_target_bits(static_cast<int>(instrs_[0]->target_.bits));
+
+  absl::flat_hash_set<std::string> compiled_fns;
+  for (auto& module : modules) {
+    auto* module_desc = artifact.add_modules();
+    for (auto& fn_name : module.fn_names) {
+      module_desc->add_fn_names(fn_name);
+      compiled_fns.insert(fn_name);
+    }
+    module_desc->set_host_object(module.host_object);
+    module_desc->set_device_code(module.device_code);
+    module_desc->set_device_code_is_cubin(module.device_code_is_cubin);
+    for (auto& kernel_name : module.kernel_names) {
+      module_desc->add_kernel_names(kernel_name);
+    }
+  }
+
+  auto save_instruction = [&](Instruction* ins, bool pre_run) {
+    auto* desc = artifact.add_instructions();
+    desc->set_function_name(ins->GetFunctionName());
+    for (auto& fn_name : ins->GetFnNames()) {
+      CHECK(compiled_fns.count(fn_name)) << "The function [" << fn_name
+                                         << "] is not compiled by the parallel compiler, the program can't be saved";
+      desc->add_fn_names(fn_name);
+    }
+    for (auto& args : ins->GetInArgs()) {
+      auto* args_desc = desc->add_in_args();
+      for (auto& name : args) {
+        args_desc->add_names(name);
+      }
+    }
+    for (auto& args : ins->GetOutArgs()) {
+      auto* args_desc = desc->add_out_args();
+      for (auto& name : args) {
+        args_desc->add_names(name);
+      }
+    }
+    for (int attr : ins->attrs) {
+      desc->add_attrs(attr);
+    }
+    for (auto& attr : ins->str_attrs) {
+      desc->add_str_attrs(attr);
+    }
+    desc->set_pre_run(pre_run);
+    desc->set_library_call(ins->IsLibraryCall());
+  };
+  for (auto& ins : prerun_instrs_) {
+    save_instruction(ins.get(), true);
+  }
   for (auto& ins : instrs_) {
-    ins->Run(name2podargs, false, stream, use_cache);
+    save_instruction(ins.get(), false);
+  }
+
+  for (auto& name : scope_->var_names()) {
+    auto* var = scope_->FindVar(std::string({name.data(), name.size()}));
+    if (!absl::holds_alternative<Tensor>(*var)) continue;
+    auto& tensor   = absl::get<Tensor>(*var);
+    auto* var_desc = artifact.add_variables();
+    var_desc->set_name(std::string({name.data(), name.size()}));
+    for (int dim : tensor->shape().data()) {
+      var_desc->add_shape(dim);
+    }
+    if (!tensor->type().is_unk()) {
+      var_desc->set_dtype(common::Type2Str(tensor->type()));
+    }
+  }
+
+  auto* plan_desc = artifact.mutable_memory_plan();
+  plan_desc->set_arena_bytes(memory_plan_.arena_bytes);
+  plan_desc->set_total_bytes(memory_plan_.total_bytes);
+  for (auto& item : memory_plan_.offsets) {
+    (*plan_desc->mutable_offsets())[item.first] = item.second;
+  }
+  for (auto& item : memory_plan_.sizes) {
+    (*plan_desc->mutable_sizes())[item.first] = item.second;
+  }
+
+  std::string data;
+  CHECK(artifact.SerializeToString(&data)) << "Failed to serialize the program";
+  VLOG(3) << "Serialize " << artifact.instructions_size() << " instructions and " << artifact.modules_size()
+          << " modules";
+  return data;
+}
+
+void Program::Save(const std::string& path) {
+  std::string data = Serialize();
+  std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK(ofs.is_open()) << "Failed to open [" << path << "] to save the program";
+  CHECK(ofs.write(data.data(), data.size())) << "Failed to save the program to [" << path << "]";
+  VLOG(3) << "Save the program to " << path;
+}
+
+void Program::ExportLibrary(const std::string& path) {
+  utils::RecordEvent record_event("Program ExportLibrary", utils::EventType::kOrdinary);
+  CompileInstructions();
+  CHECK(IsSerializable()) << "All the instructions must be compiled by the parallel compiler to export the library";
+  std::vector<CompiledModule> modules = loaded_modules_;
+  if (parallel_compiler_) {
+    auto compiled_modules = parallel_compiler_->GetCompiledModules();
+    modules.insert(modules.end(), compiled_modules.begin(), compiled_modules.end());
+  }
+
+  char dir_template[] = "/tmp/cinn_export_XXXXXX";
+  CHECK(mkdtemp(dir_template)) << "Failed to create a directory to export the library";
+  std::string dir(dir_template);
+  std::vector<std::string> files;
+  // the kernel pointers the host functions launch by are defined in the library and set by the deploy runtime
+  std::string kernel_ptrs;
+  for (int idx = 0; idx < modules.size(); ++idx) {
+    std::string file = dir + "/module_" + std::to_string(idx) + ".o";
+    std::ofstream ofs(file, std::ios::out | std::ios::binary | std::ios::trunc);
+    CHECK(ofs.write(modules[idx].host_object.data(), modules[idx].host_object.size()))
+        << "Failed to write the object to [" << file << "]";
+    files.push_back(file);
+    for (auto& kernel_name : modules[idx].kernel_names) {
+      kernel_ptrs += "void* " + kernel_name + "_ptr_ = 0;\n";
+    }
+  }
+  std::string kernel_ptrs_file = dir + "/kernel_ptrs.c";
+  std::ofstream(kernel_ptrs_file) << kernel_ptrs;
+  files.push_back(kernel_ptrs_file);
+
+  std::string command = FLAGS_cinn_export_cc + " -shared -fPIC -o " + path;
+  for (auto& file : files) {
+    command += " " + file;
+  }
+  VLOG(2) << "Link the library: " << command;
+  int ret = system(command.c_str());
+  for (auto& file : files) {
+    remove(file.c_str());
+  }
+  rmdir(dir.c_str());
+  CHECK_EQ(ret, 0) << "Failed to link the library: " << command;
+  VLOG(3) << "Export the library of " << modules.size() << " modules to " << path;
+}
+
+std::unique_ptr<Program> Program::Load(const std::string& path, const Target& target, std::shared_ptr<Scope> scope) {
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  CHECK(ifs.is_open()) << "Failed to open the program artifact [" << path << "]";
+  std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  VLOG(3) << "Load the program from " << path;
+  return Deserialize(data, target, std::move(scope));
+}
+
+std::unique_ptr<Program> Program::Deserialize(const std::string& data,
+                                              const Target& target,
+                                              std::shared_ptr<Scope> scope) {
+  utils::RecordEvent record_event("Program Deserialize", utils::EventType::kOrdinary);
+  proto::ProgramArtifact artifact;
+  CHECK(artifact.ParseFromString(data)) << "Failed to parse the program artifact";
+  CHECK_EQ(artifact.version(), kProgramArtifactVersion) << "The version of the program artifact is not supported";
+  CHECK(artifact.target_arch() == static_cast<int>(target.arch) &&
+        artifact.target_bits() == static_cast<int>(target.bits))
+      << "The program artifact is not compiled for the target " << target;
+  if (!scope) {
+    scope = std::make_shared<Scope>();
+  }
+
+  MemoryPlan memory_plan;
+  memory_plan.arena_bytes = artifact.memory_plan().arena_bytes();
+  memory_plan.total_bytes = artifact.memory_plan().total_bytes();
+  for (auto& item : artifact.memory_plan().offsets()) {
+    memory_plan.offsets[item.first] = item.second;
+  }
+  for (auto& item : artifact.memory_plan().sizes()) {
+    memory_plan.sizes[item.first] = item.second;
+  }
+
+  for (auto& var_desc : artifact.variables()) {
+    // the variables given by the scope, such as the parameters, are kept
+    if (scope->FindVar(var_desc.name())) continue;
+    auto* var    = scope->Var<Tensor>(var_desc.name());
+    auto& tensor = absl::get<Tensor>(*var);
+    tensor->Resize(Shape(std::vector<int>(var_desc.shape().begin(), var_desc.shape().end())));
+    if (!var_desc.dtype().empty()) {
+      tensor->set_type(common::Str2Type(var_desc.dtype()));
+    }
+    // the planned variables are bound to the arena on the first run
+    if (!memory_plan.offsets.count(var_desc.name()) && !tensor->type().is_unk()) {
+      tensor->mutable_data(target, tensor->type());
+    }
+  }
+
+  std::vector<CompiledModule> modules;
+  std::vector<std::unique_ptr<backends::ExecutionEngine>> engines;
+#ifdef CINN_WITH_CUDA
+  std::vector<std::shared_ptr<runtime::cuda::CUDAModule>> cumodules;
+#endif
+  absl::flat_hash_map<std::string, backends::ExecutionEngine*> fn_engines;
+  for (auto& module_desc : artifact.modules()) {
+    CompiledModule module;
+    module.fn_names.assign(module_desc.fn_names().begin(), module_desc.fn_names().end());
+    module.host_object          = module_desc.host_object();
+    module.device_code          = module_desc.device_code();
+    module.device_code_is_cubin = module_desc.device_code_is_cubin();
+    module.kernel_names.assign(module_desc.kernel_names().begin(), module_desc.kernel_names().end());
+
+    backends::RuntimeSymbols symbols;
+    if (!module.device_code.empty()) {
+#ifdef CINN_WITH_CUDA
+      using runtime::cuda::CUDAModule;
+      auto cumodule = CUDAModule::GetShared(
+          module.device_code, module.device_code_is_cubin ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+      for (auto& kernel_name : module.kernel_names) {
+        auto cufunc = cumodule->GetFunction(0, kernel_name);
+        CHECK(cufunc) << "Can't find the kernel [" << kernel_name << "] in the program artifact";
+        symbols.RegisterVar(kernel_name + "_ptr_", reinterpret_cast<void*>(cufunc));
+      }
+      cumodules.push_back(std::move(cumodule));
+#else
+      LOG(FATAL) << "The program artifact holds the device code, which needs CINN compiled with CUDA";
+#endif
+    }
+    auto engine = backends::ExecutionEngine::Create(backends::ExecutionOptions(), std::move(symbols));
+    engine->AddObject(module.host_object);
+    for (auto& fn_name : module.fn_names) {
+      fn_engines[fn_name] = engine.get();
+    }
+    engines.push_back(std::move(engine));
+    modules.push_back(std::move(module));
+  }
+
+  auto to_names = [](const proto::ProgramArtifact::Arguments& args) {
+    return std::vector<std::string>(args.names().begin(), args.names().end());
+  };
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  for (auto& desc : artifact.instructions()) {
+    CHECK_GT(desc.fn_names_size(), 0) << "The instruction " << desc.function_name() << " has no function";
+    CHECK_EQ(desc.fn_names_size(), desc.in_args_size());
+    CHECK_EQ(desc.fn_names_size(), desc.out_args_size());
+    auto instr = std::make_unique<Instruction>(
+        target, scope.get(), to_names(desc.in_args(0)), to_names(desc.out_args(0)), desc.function_name());
+    for (int idx = 1; idx < desc.fn_names_size(); ++idx) {
+      instr->AddInArgs(to_names(desc.in_args(idx)));
+      instr->AddOutArgs(to_names(desc.out_args(idx)));
+    }
+    for (auto& fn_name : desc.fn_names()) {
+      CHECK(fn_engines.count(fn_name)) << "The function [" << fn_name << "] is not found in the program artifact";
+      auto fn_ptr = fn_engines.at(fn_name)->Lookup(fn_name);
+      CHECK(fn_ptr) << "Can't find jit function : " << fn_name;
+      instr->SetLoweredFunc(fn_ptr, fn_name);
+    }
+    instr->attrs.assign(desc.attrs().begin(), desc.attrs().end());
+    instr->str_attrs.assign(desc.str_attrs().begin(), desc.str_attrs().end());
+    instr->pre_run = desc.pre_run();
+    instr->Finalize();
+    instrs.push_back(std::move(instr));
+  }
+
+  auto program = std::make_unique<Program>(scope, std::move(instrs));
+  program->SetMemoryPlan(std::move(memory_plan), target);
+  program->loaded_modules_ = std::move(modules);
+  program->loaded_engines_ = std::move(engines);
+#ifdef CINN_WITH_CUDA
+  program->loaded_cumodules_ = std::move(cumodules);
+#endif
+  VLOG(3) << "Deserialize " << artifact.instructions_size() << " instructions and " << artifact.modules_size()
+          << " modules";
+  return program;
+}
+
+void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  BindMemoryPlan();
+  // the instructions only depending on the constants are run once, and their results are kept in the scope
+  if (!prerun_done_) {
+    for (auto& ins : prerun_instrs_) {
+      ins->Run(name2podargs, false, stream, use_cache);
+    }
+    prerun_done_ = true;
+  }
+  runtime::cpu::ScopedThreadBudget thread_budget(thread_budget_);
+  if (weight_offloader_) {
+    weight_offloader_->Run(name2podargs, stream, use_cache);
+  } else if (profiler_) {
+    profiler_->Run(name2podargs, stream, use_cache);
+  } else if (FLAGS_cinn_use_cuda_graph && ExecuteCudaGraph(name2podargs, stream, use_cache)) {
+    return;
+  } else {
+    RunInstructions(name2podargs, stream, use_cache);
   }
 #ifdef CINN_WITH_CUDA
   VLOG(4) << "-- The value of the used stream: " << stream;
@@ -219,9 +657,264 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
     CUDA_CALL(cudaDeviceSynchronize());
   }
 #endif
+#ifdef CINN_WITH_ROCM
+  if (instrs_[0]->target_.arch == Target::Arch::AMDGPU && stream == nullptr) {
+    HIP_CALL(hipDeviceSynchronize());
+  }
+#endif
+}
+
+void Program::FeedArg(const std::string& name, const cinn_pod_value_t& value) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  if (feed_slots_.empty()) {
+    BindMemoryPlan();
+    CompileInstructions();
+    for (auto& ins : instrs_) {
+      const auto& arg_names = ins->GetArgNames();
+      for (int slot = 0; slot < arg_names.size(); ++slot) {
+        feed_slots_[arg_names[slot]].emplace_back(ins.get(), slot);
+      }
+    }
+  }
+  auto it = feed_slots_.find(name);
+  CHECK(it != feed_slots_.end()) << "Variable [" << name << "] is not an argument of the instructions";
+  for (auto& use : it->second) {
+    use.first->PatchArg(use.second, value);
+  }
+  // the captured CUDA Graph is keyed by the buffers in the scope, which don't know the fed values
+  ResetCudaGraph();
+  cuda_graph_disabled_ = true;
+}
+
+std::unique_ptr<ExecutionContext> Program::CreateExecutionContext(const std::vector<std::string>& input_names,
+                                                                  int device_id) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  CHECK(!weight_offloader_) << "The contexts can't share the offloaded parameters, which are uploaded by each run";
+  // the results of the prerun instructions are shared by the contexts, and the arguments are built by the final ones
+  BindMemoryPlan();
+  if (!prerun_done_) {
+    for (auto& ins : prerun_instrs_) {
+      ins->Run();
+    }
+    prerun_done_ = true;
+  }
+  CompileInstructions();
+  return std::make_unique<ExecutionContext>(this, input_names, device_id);
+}
+
+void Program::EnableProfiling(bool enable, bool collect_counters) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  if (!enable) {
+    profiler_.reset();
+  } else if (!profiler_ || profiler_->collect_counters() != collect_counters) {
+    profiler_ = std::make_unique<InstructionProfiler>(instrs_, collect_counters);
+  }
+}
+
+void Program::EnableWeightOffload(const WeightOffloadOptions& options) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  CHECK(!instrs_.empty());
+  // the prerun instructions may read the parameters, and the offloaded ones are bound to the final arguments
+  BindMemoryPlan();
+  CompileInstructions();
+  if (!prerun_done_) {
+    for (auto& ins : prerun_instrs_) {
+      ins->Run();
+    }
+    prerun_done_ = true;
+  }
+  weight_offloader_.reset();
+  weight_offloader_ = std::make_unique<WeightOffloader>(instrs_, scope_.get(), instrs_[0]->target_, options);
+  // the captured CUDA Graph and the dag executor don't wait on the uploads
+  ResetCudaGraph();
+  cuda_graph_disabled_ = true;
+}
+
+void Program::DisableWeightOffload() {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  weight_offloader_.reset();
+}
+
+ProfileReport Program::GetProfileReport() const {
+  CHECK(profiler_) << "The profiling of the program is not enabled, please call EnableProfiling first";
+  return profiler_->GetReport();
+}
+
+RooflineReport Program::GetRooflineReport() const {
+  CHECK(profiler_) << "The profiling of the program is not enabled, please call EnableProfiling first";
+  CHECK(!instrs_.empty());
+  std::map<std::string, auto_schedule::KernelWork> works;
+  if (parallel_compiler_) {
+    for (auto& func : parallel_compiler_->GetLoweredFuncs()) {
+      works[func->name] = auto_schedule::AnalyzeKernelWork(func, instrs_[0]->target_);
+    }
+  }
+  return BuildRooflineReport(profiler_->GetReport(), works, GetDevicePeak(instrs_[0]->target_));
+}
+
+void Program::ResetProfile() {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  if (profiler_) profiler_->Reset();
+}
+
+void Program::RunInstructions(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                              void* stream,
+                              bool use_cache) {
+  if (!swap_plan_.empty() && !name2podargs) {
+    if (!activation_swapper_) {
+      activation_swapper_ = std::make_unique<ActivationSwapper>(instrs_, scope_.get(), instrs_[0]->target_, swap_plan_);
+    }
+    activation_swapper_->Run(stream, use_cache);
+    return;
+  }
+  if (FLAGS_cinn_use_dag_executor && !instrs_.empty()) {
+    if (!dag_executor_) {
+      // the dependencies are analysed by the final arguments
+      CompileInstructions();
+      // the dag executor dispatches the instructions on one kind of device only
+      bool same_arch = std::all_of(instrs_.begin(), instrs_.end(), [this](const auto& ins) {
+        return ins->target_.arch == instrs_[0]->target_.arch;
+      });
+      if (same_arch) {
+        dag_executor_ =
+            std::make_unique<DagExecutor>(instrs_, instrs_[0]->target_, FLAGS_cinn_dag_executor_num_workers);
+      }
+    }
+    if (dag_executor_) {
+      dag_executor_->Run(name2podargs, stream, use_cache);
+      return;
+    }
+  }
+  for (auto& ins : instrs_) {
+    ins->Run(name2podargs, false, stream, use_cache);
+  }
+}
+
+std::vector<void*> Program::CollectArgsAddress(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  if (cuda_graph_arg_names_.empty()) {
+    CompileInstructions();
+    for (auto& ins : instrs_) {
+      for (auto& args : ins->GetInArgs()) {
+        cuda_graph_arg_names_.insert(cuda_graph_arg_names_.end(), args.begin(), args.end());
+      }
+      for (auto& args : ins->GetOutArgs()) {
+        cuda_graph_arg_names_.insert(cuda_graph_arg_names_.end(), args.begin(), args.end());
+      }
+    }
+  }
+
+  std::vector<void*> addresses;
+  addresses.reserve(cuda_graph_arg_names_.size());
+  for (auto& name : cuda_graph_arg_names_) {
+    cinn_buffer_t* buffer = nullptr;
+    if (name2podargs) {
+      auto it = name2podargs->find(name);
+      CHECK(it != name2podargs->end()) << "Argument [" << name << "] not found in the name2podargs";
+      buffer = it->second;
+    } else {
+      auto* var = scope_->FindVar(name);
+      CHECK(var) << "Argument [" << name << "] not found in the scope";
+      buffer = absl::get<Tensor>(*var)->buffer();
+    }
+    addresses.push_back(buffer->memory);
+  }
+  return addresses;
+}
+
+void Program::ResetCudaGraph() {
+#ifdef CINN_WITH_CUDA
+  if (cuda_graph_exec_) {
+    CUDA_CALL(cudaGraphExecDestroy(static_cast<cudaGraphExec_t>(cuda_graph_exec_)));
+    cuda_graph_exec_ = nullptr;
+  }
+#endif
+  cuda_graph_key_.clear();
+}
+
+bool Program::ExecuteCudaGraph(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                               void* stream,
+                               bool use_cache) {
+#ifdef CINN_WITH_CUDA
+  if (cuda_graph_disabled_ || instrs_.empty()) return false;
+  // the instructions running on host, such as the buffer handlers, can't be captured
+  bool all_on_device = std::all_of(
+      instrs_.begin(), instrs_.end(), [](const auto& ins) { return ins->target_.arch == Target::Arch::NVGPU; });
+  if (!all_on_device) {
+    VLOG(3) << "Some instructions don't run on NVGPU, the program can't be captured into a CUDA Graph";
+    cuda_graph_disabled_ = true;
+    return false;
+  }
+  bool has_control_flow = std::any_of(
+      instrs_.begin(), instrs_.end(), [](const auto& ins) { return IsControlFlowInstruction(ins->GetFunctionName()); });
+  if (has_control_flow) {
+    VLOG(3) << "The control flow instructions branch on host, the program can't be captured into a CUDA Graph";
+    cuda_graph_disabled_ = true;
+    return false;
+  }
+
+  // the legacy default stream can't be captured, so a stream is created for it
+  if (stream == nullptr && cuda_graph_stream_ == nullptr) {
+    cudaStream_t owned_stream;
+    CUDA_CALL(cudaStreamCreate(&owned_stream));
+    cuda_graph_stream_ = owned_stream;
+  }
+  auto run_stream = static_cast<cudaStream_t>(stream ? stream : cuda_graph_stream_);
+
+  // the addresses of the arguments are baked into the kernel launches, the graph is captured again if any changes
+  std::vector<void*> key = CollectArgsAddress(name2podargs);
+  key.push_back(run_stream);
+  // so are the grids of the instructions scalable by the batch
+  for (auto& ins : instrs_) {
+    if (ins->IsBatchScalable()) {
+      key.push_back(reinterpret_cast<void*>(static_cast<intptr_t>(ins->GetBatchSize())));
+      break;
+    }
+  }
+  if (key != cuda_graph_key_) {
+    ResetCudaGraph();
+    cuda_graph_key_ = std::move(key);
+    // run eagerly once as warm-up, so that the lazy initialization, such as the workspace of cuDNN and the device
+    // memory of the caching allocator, is not captured
+    VLOG(3) << "The arguments of the program changed, warm up before capturing the CUDA Graph";
+    return false;
+  }
+
+  if (cuda_graph_exec_ == nullptr) {
+    utils::RecordEvent record_capture("Program CaptureCudaGraph", utils::EventType::kOrdinary);
+    CUDA_CALL(cudaStreamBeginCapture(run_stream, cudaStreamCaptureModeThreadLocal));
+    RunInstructions(name2podargs, run_stream, use_cache);
+    cudaGraph_t graph = nullptr;
+    auto status       = cudaStreamEndCapture(run_stream, &graph);
+    if (status != cudaSuccess || graph == nullptr) {
+      LOG(WARNING) << "Failed to capture the program into a CUDA Graph for " << cudaGetErrorString(status)
+                   << ", fall back to run the instructions one by one";
+      // clear the sticky error of the failed capture
+      cudaGetLastError();
+      cuda_graph_disabled_ = true;
+      return false;
+    }
+    cudaGraphExec_t graph_exec = nullptr;
+    CUDA_CALL(cudaGraphInstantiateWithFlags(&graph_exec, graph, 0));
+    CUDA_CALL(cudaGraphDestroy(graph));
+    cuda_graph_exec_ = graph_exec;
+    VLOG(3) << "Captured " << instrs_.size() << " instructions into a CUDA Graph";
+  }
+
+  {
+    utils::RecordEvent record_launch("Program LaunchCudaGraph", utils::EventType::kOrdinary);
+    CUDA_CALL(cudaGraphLaunch(static_cast<cudaGraphExec_t>(cuda_graph_exec_), run_stream));
+  }
+  if (stream == nullptr) {
+    CUDA_CALL(cudaStreamSynchronize(run_stream));
+  }
+  return true;
+#else
+  return false;
+#endif
 }
 
 void Program::ExecuteTest(int repeat_) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
     for (auto& ins : instrs_) {
@@ -238,6 +931,11 @@ void Program::ExecuteTest(int repeat_) {
   if (instrs_[0]->target_.arch == Target::Arch::NVGPU) {
     CUDA_CALL(cudaDeviceSynchronize());
   }
+#endif
+#ifdef CINN_WITH_ROCM
+  if (instrs_[0]->target_.arch == Target::Arch::AMDGPU) {
+    HIP_CALL(hipDeviceSynchronize());
+  }
 #endif
   double test_op_time = timer1.Stop() / repeat_;
   VLOG(3) << "Repeat times: [" << repeat_ << "], average op time: [" << test_op_time << "] ms";
@@ -272,7 +970,7 @@ std::string GraphCompiler::GenSourceCode() {
   }
   // // compile the module
   if (!compiler_) {
-    compiler_ = backends::Compiler::Create(target_);
+    compiler_ = backends::Compiler::Create(target_, Buffer::AssumedAlignment());
   }
 
   auto build_module = m_builder_.Build();
@@ -314,6 +1012,10 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFuncWithIRSchedule(
       input = lang::Placeholder<bfloat16>(id, shape);
     } else if (dtype.is_float16()) {
       input = lang::Placeholder<float16>(id, shape);
+    } else if (dtype.is_float8_e4m3()) {
+      input = lang::Placeholder<float8_e4m3>(id, shape);
+    } else if (dtype.is_float8_e5m2()) {
+      input = lang::Placeholder<float8_e5m2>(id, shape);
     } else if (dtype.is_bool()) {
       input = lang::Placeholder<bool>(id, shape);
     } else if (dtype.is_int(8)) {
@@ -382,6 +1084,10 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
       temp = lang::Placeholder<bfloat16>(input_id, in_shape);
     } else if (dtype.is_float16()) {
       temp = lang::Placeholder<float16>(input_id, in_shape);
+    } else if (dtype.is_float8_e4m3()) {
+      temp = lang::Placeholder<float8_e4m3>(input_id, in_shape);
+    } else if (dtype.is_float8_e5m2()) {
+      temp = lang::Placeholder<float8_e5m2>(input_id, in_shape);
     } else if (dtype.is_bool()) {
       temp = lang::Placeholder<bool>(input_id, in_shape);
     } else if (dtype.is_int(8)) {
@@ -427,7 +1133,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
   for (int i = 0; i < C->size() - 1; i++) {
     ir::Expr temp = C[i];
     // checkout whether the tensor is with buffer.
-    if ((!temp.as_tensor_ref()->buffer.defined() || this->target_ != common::DefaultNVGPUTarget()) &&
+    if ((!temp.as_tensor_ref()->buffer.defined() || !this->target_.is_gpu()) &&
         !stages[temp.as_tensor_ref()]->inlined()) {
       inputs.push_back(temp.as_tensor_ref());
     }
@@ -444,7 +1150,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
 // get the most complex op's index in the fused groups according to the OpPattern. If the OpPattern is same, we will
 // take the latter.
 int GetMasterRefNode(const std::vector<Node*>& nodes) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   int master_index      = 0;
   int master_pattern    = op_pattern_dict[nodes[0]->op()];
   for (int i = 1; i < nodes.size(); i++) {
@@ -504,6 +1210,10 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
           temp_in = lang::Placeholder<bfloat16>(input_id, in_shape);
         } else if (dtype.is_float16()) {
           temp_in = lang::Placeholder<float16>(input_id, in_shape);
+        } else if (dtype.is_float8_e4m3()) {
+          temp_in = lang::Placeholder<float8_e4m3>(input_id, in_shape);
+        } else if (dtype.is_float8_e5m2()) {
+          temp_in = lang::Placeholder<float8_e5m2>(input_id, in_shape);
         } else if (dtype.is_bool()) {
           temp_in = lang::Placeholder<bool>(input_id, in_shape);
         } else if (dtype.is_int(8)) {
@@ -620,7 +1330,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
   // args order: inputs + final output + fetch outputs + other no_fused outputs
   for (auto& tensor : outputs) {
     // checkout the tensor is with buffer.
-    if ((!tensor->buffer.defined() || this->target_ != common::DefaultNVGPUTarget()) && !stages[tensor]->inlined()) {
+    if ((!tensor->buffer.defined() || !this->target_.is_gpu()) && !stages[tensor]->inlined()) {
       inputs.push_back(tensor);
     }
   }
@@ -727,7 +1437,7 @@ void GraphCompiler::ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_
 }
 
 std::unique_ptr<Program> GraphCompiler::Build(const std::string& code) {
-  utils::RecordEvent("GraphCompiler::Build", utils::EventType::kGraph);
+  utils::RecordEvent record_event("GraphCompiler::Build", utils::EventType::kGraph);
   GraphCompiler::CompileOptions options;
   options.attached_code              = code;
   options.with_instantiate_variables = true;
@@ -742,41 +1452,73 @@ void GraphCompiler::CompileOptions::Apply(const auto_schedule::TuningResult& tun
   lowered_funcs.assign(tuning_result.function_groups.begin(), tuning_result.function_groups.end());
 }
 
+// The TuningPack of FLAGS_cinn_tuning_pack_file, loaded once at the first compilation
+static const auto_schedule::TuningPack& GetTuningPackFromFlags() {
+  static const auto_schedule::TuningPack pack = []() {
+    auto_schedule::TuningPack loaded;
+    loaded.Load(FLAGS_cinn_tuning_pack_file);
+    return loaded;
+  }();
+  return pack;
+}
+
+// the swaps free and reallocate the buffers of the variables at runtime, which can't be bound to the arena of the
+// static memory plan, and are planned from the final arguments of the instructions at compile time
+static bool ShouldPlanActivationSwaps(const GraphCompiler::CompileOptions& options, const Target& target) {
+  return FLAGS_cinn_swap_memory_budget_mb > 0 && target.arch == Target::Arch::NVGPU && !options.with_lazy_compile &&
+         !options.with_static_memory_plan && !options.with_buffer_handle_instruction_inserted;
+}
+
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options,
                                                       std::unordered_set<std::string>&& fetch_var_ids,
                                                       void* stream) {
+  // lower the fusion groups with the tuned schedules, which are compiled the same as the TuningResult applied
+  if (!FLAGS_cinn_tuning_pack_file.empty() && options.groups.empty() && options.lowered_funcs.empty() &&
+      !graph_->fusion_groups.empty() && GetTuningPackFromFlags().Size() > 0) {
+    CompileOptions tuned_options = options;
+    tuned_options.Apply(GetTuningPackFromFlags().Lower(graph_.get()));
+    return Build(tuned_options, std::move(fetch_var_ids), stream);
+  }
   Context::Global().ResetNameId();
-  if (FLAGS_cinn_parallel_compile_size) {
+  auto stats = std::make_shared<utils::CompileStats>();
+  utils::CompileStats::TakePending(stats.get());
+  utils::CompileStats::ScopedActive active_stats(stats.get());
+  utils::CompileStats::PhaseTimer build_timer("GraphCompiler::Build");
+  CHECK(!(options.with_static_memory_plan && options.with_buffer_handle_instruction_inserted))
+      << "The static memory plan can't work with the buffer handle instructions which allocate memory at runtime";
+  // the parallel compiler compiles the fusion groups of the graph, so the other groups given by the options, such as
+  // the ones split by the graph tuning, are compiled one by one
+  bool use_graph_groups = options.groups.empty() || options.groups == graph_->fusion_groups;
+  CHECK(!options.with_lazy_compile || (FLAGS_cinn_parallel_compile_size && use_graph_groups))
+      << "The lazy compilation is only supported by the parallel compiler";
+  CHECK(!options.with_lazy_compile ||
+        !(options.with_static_memory_plan || options.with_buffer_handle_instruction_inserted))
+      << "The static memory plan and the buffer handle instructions need the arguments of the instructions at compile "
+         "time, which can't work with the lazy compilation";
+  if (FLAGS_cinn_parallel_compile_size && use_graph_groups) {
     // write group's information into FLAGS_cinn_fusion_groups_graphviz_dir
     graph_->VisualizeGroupedGraph(fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids);
 
-    if (options.with_instantiate_variables) {
-      VLOG(3) << "Instantiate all variables on compile-time";
-      utils::RecordEvent("GraphCompiler MutableData", utils::EventType::kOrdinary);
-      // All variables reside in scope_, so traverse it to instantiate each one
-      for (auto& name : scope_->var_names()) {
-        auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
-        auto& tensor = absl::get<Tensor>(*var);
-        if (reuse_vars_map_.count(name)) {
-          auto src_var_name = reuse_vars_map_.at(name);
-          auto* src_var     = scope_->Var<Tensor>(src_var_name);
-          auto& src_tensor  = absl::get<Tensor>(*src_var);
-          tensor->set_buffer(src_tensor->get_buffer());
-        } else {
-          tensor->mutable_data(target_, tensor->type());
-        }
-      }
-    }
-
     VLOG(2) << "Compile With Parallel Compiler!";
-    utils::RecordEvent("GraphCompiler CompileResult", utils::EventType::kOrdinary);
+    utils::RecordEvent record_event("GraphCompiler CompileResult", utils::EventType::kOrdinary);
     ParallelCompiler::CompileOptions option;
     option.lowered_funcs = options.lowered_funcs;
+    option.lazy_compile  = options.with_lazy_compile;
+    option.stats         = stats;
+    option.stitch_small_kernels =
+        FLAGS_cinn_stitch_small_kernels && target_.arch == Target::Arch::NVGPU && options.lowered_funcs.empty();
+
+    // the compiler is local to this call, so that the candidates of auto-tune can be built at the same time
+    auto parallel_compiler = std::make_shared<ParallelCompiler>(scope_, graph_, option, target_);
+    std::vector<std::unique_ptr<Instruction>> instructions;
+    {
+      // the wall time of the parallel compilation, compared with the time of the groups and modules
+      utils::CompileStats::PhaseTimer parallel_compile_timer("ParallelCompiler");
+      instructions = (*parallel_compiler.get())();
+    }
 
-    parallel_compiler_ = std::make_shared<ParallelCompiler>(scope_, graph_, option, target_);
-    auto instructions  = (*parallel_compiler_.get())();
-
-    if (options.remove_unused_variables) {
+    // the arguments of the lazy instructions are not final, so the variables are kept
+    if (options.remove_unused_variables && !options.with_lazy_compile) {
       RemoveInvalidVariables(instructions);
     }
 
@@ -786,8 +1528,52 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     }
     VLOG(2) << "Compile With Parallel Compiler Done!";
 
+    if (options.with_instantiate_variables) {
+      // the buffers freed by the buffer handle instructions can't be shared
+      if (FLAGS_cinn_use_inplace_variables && !options.with_lazy_compile &&
+          !options.with_buffer_handle_instruction_inserted) {
+        std::vector<std::vector<Node*>> groups;
+        for (auto& group : graph_->fusion_groups) {
+          groups.push_back(group->CollectNodes());
+        }
+        AnalyzeInplaceVariables(groups, instructions, fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids);
+      }
+      InstantiateVariables();
+    }
+
+    MemoryPlan memory_plan;
+    if (options.with_static_memory_plan) {
+      std::vector<std::vector<Node*>> groups;
+      for (auto& group : graph_->fusion_groups) {
+        groups.push_back(group->CollectNodes());
+      }
+      AnalyzeConcatSlices(groups, instructions, fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids);
+      memory_plan = PlanStaticMemory(instructions, fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids);
+    }
+    SwapPlan swap_plan;
+    if (ShouldPlanActivationSwaps(options, target_)) {
+      std::map<std::string, auto_schedule::KernelWork> works;
+      for (auto& func : parallel_compiler->GetLoweredFuncs()) {
+        works[func->name] = auto_schedule::AnalyzeKernelWork(func, target_);
+      }
+      swap_plan = PlanActivationSwaps(instructions, fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids, works);
+    }
+
     GraphCompiler::CompilationResult compilation_result;
+    compilation_result.stats = stats;
+    // the arguments of the lazy instructions are not known yet
+    if (!options.with_lazy_compile) {
+      compilation_result.memory_estimate = EstimateMemory(
+          instructions, fetch_var_ids.empty() ? fetch_var_ids_ : fetch_var_ids, options, memory_plan);
+    }
     compilation_result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+    compilation_result.runtime_program->SetMemoryPlan(std::move(memory_plan), target_);
+    compilation_result.runtime_program->SetMemoryEstimate(compilation_result.memory_estimate);
+    compilation_result.runtime_program->SetSwapPlan(std::move(swap_plan));
+    compilation_result.runtime_program->SetParallelCompiler(parallel_compiler);
+    if (options.with_lazy_compile) {
+      compilation_result.runtime_program->StartPrefetchCompile(FLAGS_cinn_lazy_compile_prefetch_thread);
+    }
     return compilation_result;
   }
 
@@ -822,7 +1608,8 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // if the input lowered_funcs is empty, we will use the default lowering process to generate
   std::vector<std::vector<ir::LoweredFunc>> local_lowered_funcs;
   if (options.lowered_funcs.empty()) {
-    utils::RecordEvent("GraphCompiler LoweredFuncs", utils::EventType::kOrdinary);
+    utils::RecordEvent record_event("GraphCompiler LoweredFuncs", utils::EventType::kOrdinary);
+    utils::CompileStats::PhaseTimer stats_timer("GraphCompiler Lowering");
     // lowering of new fusion pass is not compatible with the groups from the input options,
     // thus process it separately
     if (!graph_->fusion_groups.empty()) {
@@ -868,7 +1655,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   const auto& lowered_funcs = options.lowered_funcs.empty() ? local_lowered_funcs : options.lowered_funcs;
   CHECK_EQ(groups.size(), lowered_funcs.size()) << "The size of groups and lowered_funcs should be equal";
   {
-    utils::RecordEvent("GraphCompiler ProcessFunction", utils::EventType::kOrdinary);
+    utils::RecordEvent record_event("GraphCompiler ProcessFunction", utils::EventType::kOrdinary);
     for (auto&& lowered_func : lowered_funcs) {
       this->ProcessFunction(lowered_func);
     }
@@ -877,26 +1664,30 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // compile the module
   // Need to create a new compiler for every call of Build,
   // because the underneath jit engine doesn't support addIRModule repeatedly now.
-  compiler_ = backends::Compiler::Create(target_);
+  compiler_ = backends::Compiler::Create(target_, Buffer::AssumedAlignment());
 
   auto build_module = m_builder_.Build();
   VLOG(3) << "End of m_builder_.Build()";
   if (this->target_.arch == Target::Arch::X86) {
-    utils::RecordEvent("GraphCompiler CodeGenCX86", utils::EventType::kOrdinary);
-    CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
+    utils::RecordEvent record_event("GraphCompiler CodeGenCX86", utils::EventType::kOrdinary);
+    CodeGenCX86 codegen(this->target_, CodeGenCX86::GetFeature(this->target_));
     codegen.SetInlineBuiltinCodes(false);
+    codegen.SetBufferAlignment(Buffer::AssumedAlignment());
     auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
     VLOG(3) << "[X86] C Code is:\n" << out;
   }
 
   {
-    utils::RecordEvent("GraphCompiler BackendsBuild", utils::EventType::kOrdinary);
+    utils::RecordEvent record_event("GraphCompiler BackendsBuild", utils::EventType::kOrdinary);
     compiler_->Build(build_module, options.attached_code);
     VLOG(3) << "End of compiler_->Build";
   }
 
   auto instructions = BuildInstructions(groups, options.groups.empty() ? graph_->fusion_groups : options.groups);
   VLOG(3) << "End of BuildInstructions";
+  if (!options.batch_inputs.empty()) {
+    MarkBatchScalableInstructions(groups, instructions, options.batch_inputs);
+  }
   if (options.remove_unused_variables) {
     RemoveInvalidVariables(instructions);
   }
@@ -906,25 +1697,30 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   }
 
   if (options.with_instantiate_variables) {
-    VLOG(3) << "Instantiate all variables on compile-time";
-    utils::RecordEvent("GraphCompiler MutableData", utils::EventType::kOrdinary);
-    // All variables reside in scope_, so traverse it to instantiate each one
-    for (auto& name : scope_->var_names()) {
-      auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
-      auto& tensor = absl::get<Tensor>(*var);
-      if (reuse_vars_map_.count(name)) {
-        auto src_var_name = reuse_vars_map_.at(name);
-        auto* src_var     = scope_->Var<Tensor>(src_var_name);
-        auto& src_tensor  = absl::get<Tensor>(*src_var);
-        tensor->set_buffer(src_tensor->get_buffer());
-      } else {
-        tensor->mutable_data(target_, tensor->type());
-      }
+    if (FLAGS_cinn_use_inplace_variables && !options.with_buffer_handle_instruction_inserted) {
+      AnalyzeInplaceVariables(groups, instructions, fetch_var_ids_);
     }
+    InstantiateVariables();
+  }
+
+  MemoryPlan memory_plan;
+  if (options.with_static_memory_plan) {
+    AnalyzeConcatSlices(groups, instructions, fetch_var_ids_);
+    memory_plan = PlanStaticMemory(instructions, fetch_var_ids_);
+  }
+  // the lowered functions are compiled into the module already, so the time is estimated from the arguments
+  SwapPlan swap_plan;
+  if (ShouldPlanActivationSwaps(options, target_)) {
+    swap_plan = PlanActivationSwaps(instructions, fetch_var_ids_, {});
   }
 
   GraphCompiler::CompilationResult result;
+  result.stats           = stats;
+  result.memory_estimate = EstimateMemory(instructions, fetch_var_ids_, options, memory_plan);
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  result.runtime_program->SetMemoryPlan(std::move(memory_plan), target_);
+  result.runtime_program->SetMemoryEstimate(result.memory_estimate);
+  result.runtime_program->SetSwapPlan(std::move(swap_plan));
   return result;
 }
 
@@ -995,7 +1791,7 @@ void GraphCompiler::BuildCublasInstr(const Node& node, Instruction* instr) const
 
 std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
     const std::vector<std::vector<Node*>>& groups, const std::vector<std::shared_ptr<Graph::Group>>& fusion_groups) {
-  utils::RecordEvent("GraphCompiler BuildInstructions", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("GraphCompiler BuildInstructions", utils::EventType::kOrdinary);
   std::vector<std::unique_ptr<Instruction>> instructions;
   auto topo_order = graph_->topological_order();
   auto& nodes     = std::get<0>(topo_order);
@@ -1014,17 +1810,6 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
     if (group.size() == 1) {
       auto node       = group[0];
       auto instr_name = node->op()->name;
-      if (node->op()->name == "reshape" && compile_options_.with_instantiate_variables) {
-        // not run instruction and shares buffer only when instantiate_variables
-        const auto& inlinks  = node->inlinks_in_order();
-        const auto& outlinks = node->outlinks_in_order();
-        CHECK_EQ(inlinks.size(), 1U);
-        CHECK_EQ(outlinks.size(), 1U);
-        std::string in_id       = inlinks[0]->source()->safe_as<NodeData>()->id();
-        std::string out_id      = outlinks[0]->sink()->safe_as<NodeData>()->id();
-        reuse_vars_map_[out_id] = in_id;
-        instr_name              = "no_run";
-      }
       auto instr = std::unique_ptr<Instruction>(
           new Instruction(target_,
                           scope_.get(),
@@ -1247,10 +2032,12 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
       // So try to find the rest kernel, if it exists.
       SetSubKernels(instr.get(), fuse_name);
 
+      // the fused instruction is run once on PreRun only if all of its ops only depend on the constants
+      instr->pre_run = true;
       for (int j = 0; j < group.size(); j++) {
         auto node = group[j];
-        if (node->attrs.attr_store.count("pre_run") && absl::get<bool>(node->attrs.attr_store["pre_run"]) == true) {
-          instr->pre_run = true;
+        if (!node->attrs.attr_store.count("pre_run") || absl::get<bool>(node->attrs.attr_store["pre_run"]) == false) {
+          instr->pre_run = false;
         }
       }
       // explicitly call Finalize of the instruction after all assignments on it were done
@@ -1263,7 +2050,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
 
 void GraphCompiler::RemoveInvalidVariables(const std::vector<std::unique_ptr<Instruction>>& instructions) {
   // mark all variables are invalid initially
-  utils::RecordEvent("GraphCompiler RemoveInvalidVariables", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("GraphCompiler RemoveInvalidVariables", utils::EventType::kOrdinary);
   std::unordered_set<std::string> invalid_variables;
   auto var_names = scope_->var_names();
   invalid_variables.reserve(var_names.size());
@@ -1320,40 +2107,409 @@ static void BufferFreeWithCallback(void* args, int num_args) {
   }
 }
 
+void GraphCompiler::InstantiateVariables() {
+  VLOG(3) << "Instantiate all variables on compile-time";
+  utils::RecordEvent record_event("GraphCompiler MutableData", utils::EventType::kOrdinary);
+  // All variables reside in scope_, so traverse it to instantiate each one, and the sources are instantiated first
+  for (auto& name : scope_->var_names()) {
+    if (reuse_vars_map_.count(name)) continue;
+    auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
+    auto& tensor = absl::get<Tensor>(*var);
+    tensor->mutable_data(target_, tensor->type());
+  }
+  for (auto& item : reuse_vars_map_) {
+    auto* var = scope_->FindVar(item.first);
+    if (!var) continue;
+    auto& tensor     = absl::get<Tensor>(*var);
+    auto* src_var    = scope_->Var<Tensor>(item.second);
+    auto& src_tensor = absl::get<Tensor>(*src_var);
+    tensor->set_buffer(src_tensor->get_buffer());
+  }
+}
+
+void GraphCompiler::MarkBatchScalableInstructions(const std::vector<std::vector<Node*>>& groups,
+                                                  const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                                  const std::vector<std::string>& batch_inputs) {
+  if (target_.arch != Target::Arch::NVGPU) {
+    return;
+  }
+  if (groups.size() != instructions.size()) {
+    VLOG(3) << "The instructions don't correspond to the groups, skip the batch analysis";
+    return;
+  }
+  auto& shape_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
+  CHECK(shape_dict.count(batch_inputs[0])) << "The batch input " << batch_inputs[0] << " is not found in the graph";
+  const auto& batch_shape = shape_dict.at(batch_inputs[0]);
+  CHECK(!batch_shape.empty()) << "The batch input " << batch_inputs[0] << " should have the leading dimension";
+  int batch_size    = batch_shape[0];
+  auto batch_tensor = scope_->GetTensor(batch_inputs[0]);
+
+  // the variables derived from the batch inputs, the groups are in the topological order
+  std::unordered_set<std::string> batch_vars(batch_inputs.begin(), batch_inputs.end());
+  int num_scalable = 0;
+  for (int i = 0; i < groups.size(); ++i) {
+    bool scalable = true;
+    for (auto* node : groups[i]) {
+      auto kind    = op_pattern_dict[node->op()];
+      scalable     = scalable && (kind == kElementWise || kind == kBroadcast);
+      bool derived = false;
+      for (auto& name : OpGetInputNames(node)) {
+        derived = derived || batch_vars.count(name);
+      }
+      if (derived) {
+        for (auto& name : OpGetOutputNames(node)) {
+          batch_vars.insert(name);
+        }
+      }
+    }
+
+    // the blocks of the fused kernel cover the outputs of the same size in order
+    int64_t numel = -1;
+    for (auto& args : instructions[i]->GetOutArgs()) {
+      for (auto& name : args) {
+        auto it = shape_dict.find(name);
+        if (!scalable || !batch_vars.count(name) || it == shape_dict.end() || it->second.empty() ||
+            it->second[0] != batch_size) {
+          scalable = false;
+          continue;
+        }
+        int64_t out_numel = std::accumulate(it->second.begin(), it->second.end(), 1LL, std::multiplies<int64_t>());
+        scalable          = numel < 0 || numel == out_numel;
+        numel             = out_numel;
+      }
+    }
+    if (scalable && numel > 0) {
+      VLOG(4) << "The instruction " << instructions[i]->GetFunctionName() << " is scalable by the batch";
+      instructions[i]->SetBatchScalable(batch_tensor, batch_size);
+      ++num_scalable;
+    }
+  }
+  VLOG(3) << num_scalable << " of " << instructions.size() << " instructions are scalable by the batch of "
+          << batch_inputs[0];
+}
+
+void GraphCompiler::AnalyzeInplaceVariables(const std::vector<std::vector<Node*>>& groups,
+                                            const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                            const std::unordered_set<std::string>& fetch_var_ids) {
+  utils::RecordEvent record_event("GraphCompiler AnalyzeInplaceVariables", utils::EventType::kOrdinary);
+  reuse_vars_map_.clear();
+  if (groups.size() != instructions.size()) {
+    VLOG(3) << "The instructions don't correspond to the groups, skip the in-place analysis";
+    return;
+  }
+  auto& shape_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
+
+  // the inputs fed by users and the results of PreRun are kept, so they can't be overwritten
+  VariableLifeTime life_time;
+  std::unordered_set<std::string> produced_vars, kept_vars(fetch_var_ids.begin(), fetch_var_ids.end());
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr = instructions[step];
+    for (auto& args : instr->GetInArgs()) {
+      for (auto& var_name : args) {
+        if (!produced_vars.count(var_name)) {
+          kept_vars.insert(var_name);
+        }
+        life_time.Use(var_name, step);
+      }
+    }
+    for (auto& args : instr->GetOutArgs()) {
+      for (auto& var_name : args) {
+        produced_vars.insert(var_name);
+        if (instr->pre_run) {
+          kept_vars.insert(var_name);
+        }
+        life_time.Use(var_name, step);
+      }
+    }
+  }
+
+  // a buffer is used until the last step of all the variables sharing it, and kept if any of them is kept
+  absl::flat_hash_map<std::string, int> source_last_step;
+  auto source_of = [this](const std::string& var_name) -> const std::string& {
+    auto it = reuse_vars_map_.find(var_name);
+    return it == reuse_vars_map_.end() ? var_name : it->second;
+  };
+  auto share_buffer = [&](const std::string& var_name, const std::string& source) {
+    reuse_vars_map_[var_name] = source;
+    if (!source_last_step.count(source)) {
+      source_last_step[source] = life_time.LastStep(source);
+    }
+    source_last_step[source] = std::max(source_last_step[source], life_time.LastStep(var_name));
+    if (kept_vars.count(var_name)) {
+      kept_vars.insert(source);
+    }
+  };
+  auto is_same_var = [&](const std::string& lhs, const std::string& rhs) {
+    return shape_dict.count(lhs) && shape_dict.count(rhs) && shape_dict.at(lhs) == shape_dict.at(rhs) &&
+           dtype_dict.at(lhs) == dtype_dict.at(rhs);
+  };
+
+  int num_aliases = 0, num_inplaces = 0;
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr   = instructions[step];
+    auto& group   = groups[step];
+    auto in_args  = instr->GetInArgs();
+    auto out_args = instr->GetOutArgs();
+    if (instr->pre_run || in_args.size() != 1 || out_args.size() != 1 || out_args[0].size() != 1 || group.empty()) {
+      continue;
+    }
+    const auto& out_name = out_args[0][0];
+
+    // the reshape-like instruction keeps the data unchanged, so its output is an alias of its input
+    const auto& op_name = group[0]->op()->name;
+    if (group.size() == 1 && in_args[0].size() == 1 &&
+        (op_name == "reshape" || op_name == "squeeze" || op_name == "expand_dims")) {
+      share_buffer(out_name, source_of(in_args[0][0]));
+      instr->SkipRun();
+      ++num_aliases;
+      continue;
+    }
+
+    // every element of the output of an elementwise group only depends on the elements of the inputs at the same
+    // position, so the output can overwrite an input of the same shape that dies at this step
+    bool is_elementwise = std::all_of(group.begin(), group.end(), [&](Node* node) {
+      if (!op_pattern_dict.Find(node->op())) return false;
+      auto kind = op_pattern_dict[node->op()];
+      return kind == kElementWise || kind == kBroadcast;
+    });
+    if (!is_elementwise) {
+      continue;
+    }
+    for (auto& in_name : in_args[0]) {
+      const auto& source = source_of(in_name);
+      if (kept_vars.count(source) || !is_same_var(in_name, out_name) ||
+          (source_last_step.count(source) ? source_last_step.at(source) : life_time.LastStep(source)) != step) {
+        continue;
+      }
+      // the other inputs sharing the buffer may be read at the other positions
+      bool shared_by_others = std::any_of(in_args[0].begin(), in_args[0].end(), [&](const std::string& other) {
+        return other != in_name && source_of(other) == source && !is_same_var(other, out_name);
+      });
+      if (shared_by_others) {
+        continue;
+      }
+      share_buffer(out_name, source);
+      ++num_inplaces;
+      break;
+    }
+  }
+  VLOG(3) << "Skip " << num_aliases << " reshape-like instructions and run " << num_inplaces
+          << " elementwise instructions in place";
+}
+
+void GraphCompiler::AnalyzeConcatSlices(const std::vector<std::vector<Node*>>& groups,
+                                        const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                        const std::unordered_set<std::string>& fetch_var_ids) {
+  utils::RecordEvent record_event("GraphCompiler AnalyzeConcatSlices", utils::EventType::kOrdinary);
+  slice_vars_map_.clear();
+  if (!FLAGS_cinn_use_concat_slices) {
+    return;
+  }
+  if (groups.size() != instructions.size()) {
+    VLOG(3) << "The instructions don't correspond to the groups, skip the concat analysis";
+    return;
+  }
+  auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+
+  // the inputs fed by users, the fetched variables and the results of PreRun are kept out of the memory plan, and
+  // the variables sharing the buffers of others are planned at their sources
+  std::unordered_set<std::string> produced_vars, kept_vars(fetch_var_ids.begin(), fetch_var_ids.end());
+  for (auto& instr : instructions) {
+    for (auto& args : instr->GetInArgs()) {
+      for (auto& var_name : args) {
+        if (!produced_vars.count(var_name)) {
+          kept_vars.insert(var_name);
+        }
+      }
+    }
+    for (auto& args : instr->GetOutArgs()) {
+      for (auto& var_name : args) {
+        produced_vars.insert(var_name);
+        if (instr->pre_run) {
+          kept_vars.insert(var_name);
+        }
+      }
+    }
+  }
+  auto can_plan = [&](const std::string& var_name) {
+    return !kept_vars.count(var_name) && !reuse_vars_map_.count(var_name) && shape_dict.count(var_name) &&
+           dtype_dict.count(var_name);
+  };
+
+  // the slices are aligned for the vectorized accesses of the kernels, which may assume the alignment of the buffers
+  constexpr size_t kSliceAlignment = CINN_BUFFER_ALIGNMENT;
+  int num_concats                  = 0;
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr   = instructions[step];
+    auto& group   = groups[step];
+    auto in_args  = instr->GetInArgs();
+    auto out_args = instr->GetOutArgs();
+    if (instr->pre_run || group.size() != 1 || in_args.size() != 1 || out_args.size() != 1 ||
+        out_args[0].size() != 1) {
+      continue;
+    }
+    auto* node          = group[0];
+    std::string op_name = node->op()->name;
+    if (op_name == "custom_call") {
+      op_name = absl::get<std::string>(node->attrs.attr_store.at("original_op"));
+    }
+    const auto& out_name = out_args[0][0];
+    // the repeated inputs are passed once
+    if (op_name != "concat" || in_args[0].size() != node->inlinks_in_order().size() || !can_plan(out_name)) {
+      continue;
+    }
+    const auto& out_shape = shape_dict.at(out_name);
+    int axis = node->attrs.attr_store.count("axis") ? absl::get<int>(node->attrs.attr_store.at("axis")) : 0;
+    if (axis < 0) {
+      axis += out_shape.size();
+    }
+    if (std::any_of(out_shape.begin(), out_shape.begin() + axis, [](int dim) { return dim != 1; })) {
+      continue;
+    }
+
+    std::vector<std::pair<std::string, size_t>> slices;
+    size_t offset = 0;
+    for (auto& in_name : in_args[0]) {
+      if (!can_plan(in_name) || slice_vars_map_.count(in_name) || offset % kSliceAlignment != 0 ||
+          dtype_dict.at(in_name) != dtype_dict.at(out_name)) {
+        break;
+      }
+      const auto& in_shape = shape_dict.at(in_name);
+      slices.emplace_back(in_name, offset);
+      offset += std::accumulate(in_shape.begin(), in_shape.end(), 1, std::multiplies<int>()) *
+                dtype_dict.at(in_name).bytes();
+    }
+    if (slices.size() != in_args[0].size()) {
+      continue;
+    }
+    for (auto& slice : slices) {
+      slice_vars_map_.emplace(slice.first, std::make_pair(out_name, slice.second));
+    }
+    instr->SkipRun();
+    ++num_concats;
+  }
+  VLOG(3) << "Skip " << num_concats << " concat instructions whose inputs are planned at the slices of the outputs";
+}
+
 void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
                                             std::unordered_map<int, std::vector<std::string>>* step2malloc,
                                             std::unordered_map<int, std::vector<std::string>>* step2free) {
-  utils::RecordEvent("GraphCompiler AnalyzeVariableLifeTime", utils::EventType::kOrdinary);
-  absl::flat_hash_map<std::string, int> variable_last_used, variable_first_used;
+  auto life_time = AnalyzeVariableLifeTime(instructions);
+  for (const auto& var2steps : life_time.life_times()) {
+    (*step2malloc)[var2steps.second.first].emplace_back(var2steps.first);
+    (*step2free)[var2steps.second.second].emplace_back(var2steps.first);
+  }
+}
+
+// the malloc and free instructions inserted by InsertBufferHandlers, which don't compute the variables
+static bool IsBufferHandler(Instruction& instr) {
+  auto fn_names = instr.GetFnNames();
+  return fn_names.size() == 1 && (fn_names[0].find("malloc_buffer_instruction") != std::string::npos ||
+                                  fn_names[0].find("free_buffer_instruction") != std::string::npos);
+}
+
+VariableLifeTime GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  utils::RecordEvent record_event("GraphCompiler AnalyzeVariableLifeTime", utils::EventType::kOrdinary);
+  VariableLifeTime life_time;
   for (auto step = 0; step < instructions.size(); ++step) {
     const auto& instr = instructions.at(step);
+    if (IsBufferHandler(*instr)) continue;
 
     for (const auto& args : instr->GetInArgs()) {
       for (const auto& var_name : args) {
-        // use try_emplace to record the first time a variable appearance
-        variable_first_used.try_emplace(var_name, step);
-        // will update until last time a variable used
-        variable_last_used[var_name] = step;
+        life_time.Use(var_name, step);
       }
     }
     for (const auto& args : instr->GetOutArgs()) {
       for (const auto& var_name : args) {
-        variable_first_used.try_emplace(var_name, step);
-        variable_last_used[var_name] = step;
+        life_time.Use(var_name, step);
+      }
+    }
+  }
+  return life_time;
+}
+
+MemoryEstimate GraphCompiler::EstimateMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                             const std::unordered_set<std::string>& fetch_var_ids,
+                                             const CompileOptions& options,
+                                             const MemoryPlan& memory_plan) {
+  utils::RecordEvent record_event("GraphCompiler EstimateMemory", utils::EventType::kOrdinary);
+  auto source_of = [this](const std::string& var_name) -> const std::string& {
+    auto it = reuse_vars_map_.find(var_name);
+    return it == reuse_vars_map_.end() ? var_name : it->second;
+  };
+  // the variables used before produced are fed by users
+  std::unordered_set<std::string> persistent_vars, used_vars;
+  for (auto& var_name : fetch_var_ids) {
+    persistent_vars.insert(source_of(var_name));
+  }
+  for (const auto& instr : instructions) {
+    if (IsBufferHandler(*instr)) continue;
+    for (const auto& args : instr->GetInArgs()) {
+      for (const auto& arg_name : args) {
+        if (used_vars.insert(arg_name).second) {
+          persistent_vars.insert(source_of(arg_name));
+        }
+      }
+    }
+    for (const auto& args : instr->GetOutArgs()) {
+      for (const auto& arg_name : args) {
+        used_vars.insert(arg_name);
+        if (instr->pre_run) {
+          persistent_vars.insert(source_of(arg_name));
+        }
       }
     }
   }
 
-  for (const auto& var2first : variable_first_used) {
-    (*step2malloc)[var2first.second].emplace_back(var2first.first);
+  // the aliases share the buffers of their sources, so the source is held over the life time of all
+  VariableLifeTime life_time;
+  for (const auto& var2steps : AnalyzeVariableLifeTime(instructions).life_times()) {
+    const auto& var_name = source_of(var2steps.first);
+    int first_step       = var2steps.second.first;
+    int last_step        = var2steps.second.second;
+    if (life_time.Contains(var_name)) {
+      first_step = std::min(first_step, life_time.FirstStep(var_name));
+      last_step  = std::max(last_step, life_time.LastStep(var_name));
+    }
+    life_time.Reset(var_name, first_step, last_step);
+  }
+
+  MemoryEstimate estimate;
+  absl::flat_hash_map<std::string, size_t> intermediate_sizes;
+  for (const auto& var2steps : life_time.life_times()) {
+    const auto& var_name = var2steps.first;
+    auto* var            = scope_->FindVar(var_name);
+    if (!var) continue;
+    auto& tensor  = absl::get<Tensor>(*var);
+    size_t nbytes = tensor->shape().numel() * tensor->type().bytes();
+    estimate.total_bytes += nbytes;
+    if (persistent_vars.count(var_name)) {
+      estimate.persistent_bytes += nbytes;
+    } else {
+      intermediate_sizes.emplace(var_name, nbytes);
+    }
   }
-  for (const auto& var2last : variable_last_used) {
-    (*step2free)[var2last.second].emplace_back(var2last.first);
+  estimate.peak_intermediate_bytes = life_time.EstimatePeakBytes(intermediate_sizes, &estimate.peak_step);
+  estimate.arena_bytes             = memory_plan.arena_bytes;
+  if (options.with_buffer_handle_instruction_inserted) {
+    estimate.peak_bytes = estimate.persistent_bytes + estimate.peak_intermediate_bytes;
+  } else {
+    // the variables not planned still own their buffers
+    estimate.peak_bytes = estimate.total_bytes - memory_plan.total_bytes + memory_plan.arena_bytes;
   }
+  VLOG(3) << "The estimated peak memory is " << estimate.peak_bytes << " bytes, of which " << estimate.persistent_bytes
+          << " bytes are persistent, and the intermediate variables reach the peak of "
+          << estimate.peak_intermediate_bytes << " bytes at step " << estimate.peak_step;
+  return estimate;
 }
 
 void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions) {
-  utils::RecordEvent("GraphCompiler InsertBufferHandlers", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("GraphCompiler InsertBufferHandlers", utils::EventType::kOrdinary);
   std::unordered_map<int, std::vector<std::string>> step2malloc, step2free;
   AnalyzeVariableLifeTime(*instructions, &step2malloc, &step2free);
 
@@ -1397,6 +2553,201 @@ void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction
   instructions->swap(results);
 }
 
+MemoryPlan GraphCompiler::PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                           const std::unordered_set<std::string>& fetch_var_ids) {
+  utils::RecordEvent record_event("GraphCompiler PlanStaticMemory", utils::EventType::kOrdinary);
+  // only the variables produced by the instructions can be planned, the others, such as the inputs and
+  // parameters, are fed by users
+  // the reused variables share the buffers of their sources, so the source is planned over the life time of all
+  absl::flat_hash_map<std::string, int> variable_first_used, variable_last_used;
+  auto source_of = [this](const std::string& var_name) -> const std::string& {
+    auto it = reuse_vars_map_.find(var_name);
+    return it == reuse_vars_map_.end() ? var_name : it->second;
+  };
+  std::unordered_set<std::string> excluded_vars;
+  for (auto& var_name : fetch_var_ids) {
+    excluded_vars.insert(source_of(var_name));
+  }
+  for (auto step = 0; step < instructions.size(); ++step) {
+    const auto& instr = instructions.at(step);
+    for (const auto& args : instr->GetInArgs()) {
+      for (const auto& arg_name : args) {
+        const auto& var_name = source_of(arg_name);
+        if (!variable_first_used.count(var_name)) {
+          excluded_vars.insert(var_name);
+        }
+        variable_last_used[var_name] = step;
+      }
+    }
+    for (const auto& args : instr->GetOutArgs()) {
+      for (const auto& arg_name : args) {
+        const auto& var_name = source_of(arg_name);
+        // the results of the instructions run only once on PreRun should be kept
+        if (instr->pre_run) {
+          excluded_vars.insert(var_name);
+        }
+        variable_first_used.try_emplace(var_name, step);
+        variable_last_used[var_name] = step;
+      }
+    }
+  }
+
+  // the slices of the skipped concats live in the memory of the outermost concat outputs, which are held over the
+  // life time of all their slices
+  auto root_of = [this](const std::string& var_name, size_t* offset) {
+    std::string root = var_name;
+    *offset          = 0;
+    for (auto it = slice_vars_map_.find(root); it != slice_vars_map_.end(); it = slice_vars_map_.find(root)) {
+      root = it->second.first;
+      *offset += it->second.second;
+    }
+    return root;
+  };
+  for (auto& slice : slice_vars_map_) {
+    size_t offset;
+    auto root = root_of(slice.first, &offset);
+    CHECK(!excluded_vars.count(slice.first) && !excluded_vars.count(root))
+        << "The concat input " << slice.first << " can't be planned at the slice of " << root;
+    variable_first_used[root] = std::min(variable_first_used.at(root), variable_first_used.at(slice.first));
+    variable_last_used[root]  = std::max(variable_last_used.at(root), variable_last_used.at(slice.first));
+  }
+
+  MemoryPlanner planner;
+  for (auto& var2first : variable_first_used) {
+    const auto& var_name = var2first.first;
+    auto* var            = scope_->FindVar(var_name);
+    if (excluded_vars.count(var_name) || slice_vars_map_.count(var_name) || !var) continue;
+    auto& tensor  = absl::get<Tensor>(*var);
+    size_t nbytes = tensor->shape().numel() * tensor->type().bytes();
+    if (nbytes == 0) continue;
+    planner.AddVariable(var_name, nbytes, var2first.second, variable_last_used.at(var_name));
+  }
+  auto plan = planner.Plan();
+  for (auto& slice : slice_vars_map_) {
+    auto& tensor  = absl::get<Tensor>(*scope_->FindVar(slice.first));
+    size_t nbytes = tensor->shape().numel() * tensor->type().bytes();
+    if (nbytes == 0) continue;
+    size_t offset;
+    auto root = root_of(slice.first, &offset);
+    plan.offsets[slice.first] = plan.offsets.at(root) + offset;
+    plan.sizes[slice.first]   = nbytes;
+    plan.total_bytes += nbytes;
+  }
+  return plan;
+}
+
+SwapPlan GraphCompiler::PlanActivationSwaps(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                            const std::unordered_set<std::string>& fetch_var_ids,
+                                            const std::map<std::string, auto_schedule::KernelWork>& works) {
+  utils::RecordEvent record_event("GraphCompiler PlanActivationSwaps", utils::EventType::kOrdinary);
+  auto source_of = [this](const std::string& var_name) -> const std::string& {
+    auto it = reuse_vars_map_.find(var_name);
+    return it == reuse_vars_map_.end() ? var_name : it->second;
+  };
+  auto nbytes_of = [this](const std::string& var_name) -> size_t {
+    auto* var = scope_->FindVar(var_name);
+    if (!var) return 0;
+    auto& tensor = absl::get<Tensor>(*var);
+    return tensor->shape().numel() * tensor->type().bytes();
+  };
+
+  // the variables used before produced are fed by users, and the results of the prerun instructions are held all
+  // along, neither of them is swapped. The variables used by the host instructions are not swapped either.
+  std::unordered_set<std::string> persistent_vars, used_vars, unswappable_vars;
+  for (auto& var_name : fetch_var_ids) {
+    persistent_vars.insert(source_of(var_name));
+  }
+  // the launch overhead of an instruction in microseconds
+  constexpr double kLaunchUs = 5.;
+  auto device_peak           = GetDevicePeak(target_);
+  std::vector<int> runtime_steps(instructions.size(), -1);
+  std::vector<double> step_us;
+  for (auto i = 0; i < instructions.size(); ++i) {
+    const auto& instr = instructions.at(i);
+    double arg_bytes  = 0.;
+    for (const auto& args : instr->GetInArgs()) {
+      for (const auto& arg_name : args) {
+        if (used_vars.insert(arg_name).second) {
+          persistent_vars.insert(source_of(arg_name));
+        }
+        if (instr->target_.arch != Target::Arch::NVGPU) {
+          unswappable_vars.insert(source_of(arg_name));
+        }
+        arg_bytes += nbytes_of(arg_name);
+      }
+    }
+    for (const auto& args : instr->GetOutArgs()) {
+      for (const auto& arg_name : args) {
+        used_vars.insert(arg_name);
+        if (instr->pre_run) {
+          persistent_vars.insert(source_of(arg_name));
+        }
+        if (instr->target_.arch != Target::Arch::NVGPU) {
+          unswappable_vars.insert(source_of(arg_name));
+        }
+        arg_bytes += nbytes_of(arg_name);
+      }
+    }
+    if (instr->pre_run) continue;
+
+    // the roofline time of the functions, or the time of moving the arguments once if any function is not known
+    double flops = 0., bytes = 0.;
+    for (const auto& fn_name : instr->GetFnNames()) {
+      auto it = works.find(fn_name);
+      if (it == works.end()) {
+        flops = 0.;
+        bytes = arg_bytes;
+        break;
+      }
+      flops += it->second.flops;
+      bytes += it->second.bytes_read + it->second.bytes_written;
+    }
+    double us = 0.;
+    if (device_peak.gflops > 0.) {
+      us = std::max(us, flops / (device_peak.gflops * 1e3));
+    }
+    if (device_peak.gbytes_per_sec > 0.) {
+      us = std::max(us, bytes / (device_peak.gbytes_per_sec * 1e3));
+    }
+    runtime_steps[i] = step_us.size();
+    step_us.push_back(kLaunchUs + us);
+  }
+
+  // the aliases share the buffers of their sources, which are held over the uses of all and not swapped
+  std::map<std::string, std::set<int>> var_steps;
+  auto life_time = AnalyzeVariableLifeTime(instructions);
+  for (const auto& var2steps : life_time.life_times()) {
+    const auto& var_name = source_of(var2steps.first);
+    if (var_name != var2steps.first) {
+      unswappable_vars.insert(var_name);
+    }
+    for (int step : life_time.UseSteps(var2steps.first)) {
+      if (runtime_steps[step] >= 0) {
+        var_steps[var_name].insert(runtime_steps[step]);
+      }
+    }
+  }
+
+  SwapPlanner planner(step_us, FLAGS_cinn_swap_host_gbps);
+  for (auto& item : var_steps) {
+    const auto& var_name = item.first;
+    size_t nbytes        = nbytes_of(var_name);
+    if (persistent_vars.count(var_name) || nbytes == 0) continue;
+    bool swappable = !unswappable_vars.count(var_name) && !slice_vars_map_.count(var_name);
+    planner.AddVariable(var_name, nbytes, std::vector<int>(item.second.begin(), item.second.end()), swappable);
+  }
+  size_t budget = static_cast<size_t>(FLAGS_cinn_swap_memory_budget_mb) << 20;
+  auto plan     = planner.Plan(budget);
+  LOG(INFO) << "The estimated peak memory of the intermediate variables is " << (plan.peak_bytes_before >> 20)
+            << " MB before and " << (plan.peak_bytes_after >> 20) << " MB after swapping " << plan.items.size()
+            << " variables to the host, the budget is " << FLAGS_cinn_swap_memory_budget_mb << " MB";
+  if (plan.peak_bytes_after > budget) {
+    LOG(WARNING) << "No more variable can be swapped to fit the memory budget of " << FLAGS_cinn_swap_memory_budget_mb
+                 << " MB, the gaps between the uses are too short to hide the copies";
+  }
+  return plan;
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   if (node->op()->name == "cublas_gemm" || node->op()->name == "cublas_matmul" || node->op()->name == "conv2d" ||
@@ -1428,7 +2779,7 @@ std::vector<std::string> GraphCompiler::OpGetOutputNames(const Node* node) const
 }
 
 std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& graph, std::shared_ptr<Scope> scope) {
-  utils::RecordEvent("GraphCompiler BuildScope", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("GraphCompiler BuildScope", utils::EventType::kOrdinary);
   auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
   auto& dtype_dict = graph->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
   if (!scope) scope = std::make_shared<Scope>();
@@ -1456,7 +2807,7 @@ std::vector<ir::LoweredFunc> GetFuncFromImpl(const std::shared_ptr<OpImpl>& impl
                                              const std::vector<std::string>& input_output_nodes,
                                              const std::string& node_id,
                                              const Target& target) {
-  utils::RecordEvent("GraphCompiler GetFuncFromImpl", utils::EventType::kOrdinary);
+  utils::RecordEvent record_event("GraphCompiler GetFuncFromImpl", utils::EventType::kOrdinary);
   // 1.Call Op's Compute function, using the default stages and LowerVec to get IR tree.
   common::CINNValuePack C = impl->fcompute(cinn_inputs);
 
@@ -1465,7 +2816,7 @@ std::vector<ir::LoweredFunc> GetFuncFromImpl(const std::shared_ptr<OpImpl>& impl
   for (int i = 0; i < C->size() - 1; i++) {
     ir::Expr temp = C[i];
     // checkout whether the tensor is with buffer.
-    if (!temp.as_tensor_ref()->buffer.defined() || target != common::DefaultNVGPUTarget()) {
+    if (!temp.as_tensor_ref()->buffer.defined() || !target.is_gpu()) {
       all_arg_tensors.push_back(temp.as_tensor_ref());
     }
   }
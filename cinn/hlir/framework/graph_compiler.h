@@ -16,9 +16,14 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <atomic>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -27,13 +32,21 @@
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/macros.h"
+#include "cinn/hlir/framework/activation_swapper.h"
+#include "cinn/hlir/framework/dag_executor.h"
+#include "cinn/hlir/framework/execution_context.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/instruction_profiler.h"
+#include "cinn/hlir/framework/memory_planner.h"
 #include "cinn/hlir/framework/op_strategy.h"
 #include "cinn/hlir/framework/parallel_compiler.h"
+#include "cinn/hlir/framework/roofline.h"
 #include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/framework/weight_offloader.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
+#include "cinn/utils/compile_stats.h"
 #include "cinn/utils/timer.h"
 
 namespace cinn {
@@ -52,12 +65,56 @@ class Program {
    */
   Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs);
 
+  ~Program();
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
 
   void Export(const std::vector<std::string>& persistent_vars, const std::string& filename);
 
+  /**
+   * Save the compiled program as an artifact, which holds the instructions, the shapes and dtypes of the variables,
+   * the compiled code and the memory plan. The values of the variables, such as the parameters, are not saved.
+   * All the instructions must be compiled by the parallel compiler.
+   */
+  void Save(const std::string& path);
+
+  /**
+   * Load a program saved by Save, and bind the functions of the instructions to the compiled code, no graph pass,
+   * lowering, or compiling is run.
+   * @param path The path of the artifact.
+   * @param target The target of the program, which must be the one the artifact compiled for.
+   * @param scope The scope to create the variables in, a new scope is created if it is nullptr.
+   */
+  static std::unique_ptr<Program> Load(const std::string& path,
+                                       const Target& target,
+                                       std::shared_ptr<Scope> scope = nullptr);
+
+  /**
+   * Link the host code of the compiled program into the shared library at \p path, which runs the program saved by
+   * Save with the deploy runtime, see cinn/runtime/deploy_runtime.h. The library is linked by the system compiler
+   * given by FLAGS_cinn_export_cc.
+   */
+  void ExportLibrary(const std::string& path);
+
+  //! Same as Save but return the artifact as bytes, such as to send it to another process.
+  std::string Serialize();
+
+  //! Whether all the instructions are compiled and their functions are held by the compiled modules, which can be saved.
+  bool IsSerializable();
+
+  //! Same as Load but build the program from the bytes returned by Serialize.
+  static std::unique_ptr<Program> Deserialize(const std::string& data,
+                                              const Target& target,
+                                              std::shared_ptr<Scope> scope = nullptr);
+
+  //! Hold the compiler, which owns the code of the instructions compiled or to be compiled lazily.
+  void SetParallelCompiler(const std::shared_ptr<ParallelCompiler>& compiler) { parallel_compiler_ = compiler; }
+
+  const std::shared_ptr<Scope>& GetScope() const { return scope_; }
+
   /**
    * Execute the program -- that is running all the instructions inside it.
+   * The runs from different threads are serialized, since they share the variables in scope.
    */
   void Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr,
                void* stream                                                = nullptr,
@@ -65,6 +122,13 @@ class Program {
 
   void ExecuteTest(int repeat_);
 
+  /**
+   * Feed the variable \p name with \p value by patching the cached arguments of the instructions taking it, which is
+   * O(#uses) instead of rebuilding the arguments of all the instructions by the names. The fed value is used by the
+   * following Execute with the cache and without name2podargs, and the CUDA Graph is not used since then.
+   */
+  void FeedArg(const std::string& name, const cinn_pod_value_t& value);
+
   /**
    * Get the number of instructions.
    */
@@ -73,13 +137,134 @@ class Program {
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
+  /**
+   * Set the static memory plan of the variables in scope, the arena will be allocated and the variables will be bound
+   * to it once on PreRun.
+   */
+  void SetMemoryPlan(MemoryPlan&& plan, const Target& target);
+  const MemoryPlan& GetMemoryPlan() const { return memory_plan_; }
+
+  //! The memory estimated at compile time, which is empty for the programs loaded from an artifact.
+  void SetMemoryEstimate(const MemoryEstimate& estimate) { memory_estimate_ = estimate; }
+  const MemoryEstimate& GetMemoryEstimate() const { return memory_estimate_; }
+  const Target& GetMemoryPlanTarget() const { return arena_target_; }
+
+  /**
+   * Set the swaps of the variables planned at compile time in the steps of the runtime instructions, which are run one
+   * by one with the swaps by an ActivationSwapper when the arguments are taken from the scope, without the CUDA Graph
+   * or the dag executor. The runs with the arguments given by name2podargs don't swap.
+   */
+  void SetSwapPlan(SwapPlan&& plan);
+  const SwapPlan& GetSwapPlan() const { return swap_plan_; }
+
+  /**
+   * Create a context to run this program with private inputs and intermediate variables, the contexts can be run by
+   * several threads at the same time, while the compiled functions and the weights are shared. All the lazily compiled
+   * instructions are compiled and the prerun instructions are run before.
+   * @param input_names The names of the variables fed by users, which are private to the context.
+   * @param device_id The GPU to replicate the program onto, -1 means the current device, see ExecutionContext.
+   */
+  std::unique_ptr<ExecutionContext> CreateExecutionContext(const std::vector<std::string>& input_names,
+                                                           int device_id = -1);
+
+  /**
+   * Compile the lazily compiled instructions in the order of execution by \p num_threads background threads, so that
+   * the most of them are ready before the first run reaches them.
+   */
+  void StartPrefetchCompile(int num_threads);
+
+  //! Limit the number of threads used by the parallel loops of the host kernels, 0 means unlimited.
+  void SetThreadBudget(int budget) { thread_budget_ = budget; }
+
+  /**
+   * Record the time of each instruction on Execute, the instructions are run one by one on the given stream while
+   * profiling. Disabling it drops the records.
+   *
+   * With \p collect_counters, the hardware counters of the kernels of each instruction are collected by CUPTI on the
+   * first run, see InstructionProfiler.
+   */
+  void EnableProfiling(bool enable, bool collect_counters = false);
+  bool IsProfiling() const { return profiler_ != nullptr; }
+  ProfileReport GetProfileReport() const;
+  void ResetProfile();
+
+  /**
+   * The roofline of each profiled instruction, from its time recorded by the profiling and the static work of its
+   * lowered functions, so the profiling must be enabled. Only the programs built by the parallel compiler keep the
+   * lowered functions, those loaded from the artifacts have none to analyze.
+   */
+  RooflineReport GetRooflineReport() const;
+
+  /**
+   * Keep the large parameters in pinned host memory or spill them to disk, and upload them into a rotating device
+   * buffer ahead of the instructions consuming them on a separate copy stream, which runs the models whose weights
+   * don't fit into the device memory, see WeightOffloader. Only on NVGPU, the prerun instructions are run before
+   * offloading, and the instructions are run one by one without the CUDA Graph or the dag executor since then.
+   */
+  void EnableWeightOffload(const WeightOffloadOptions& options);
+  //! Upload the offloaded parameters back to their own device memory.
+  void DisableWeightOffload();
+  const WeightOffloader* GetWeightOffloader() const { return weight_offloader_.get(); }
+
  private:
+  void BindMemoryPlan();
+  // compile all the lazily compiled instructions, for the runs which need their final arguments ahead
+  void CompileInstructions();
+  void StopPrefetchCompile();
+
+  // Run the runtime instructions one by one, or by the dag executor if enabled.
+  void RunInstructions(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+
+  // Run the instructions by replaying a CUDA Graph captured from them, return false if it should run eagerly.
+  bool ExecuteCudaGraph(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+  // The addresses of the arguments, which are baked into the captured CUDA Graph.
+  std::vector<void*> CollectArgsAddress(const std::map<std::string, cinn_pod_value_t>* name2podargs);
+  void ResetCudaGraph();
+
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
-  // prerun instructions
+  // prerun instructions, which are run once by PreRun or the first Execute
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
+  bool prerun_done_{false};
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  // the (instruction, slot) of the uses of each variable by the runtime instructions, built on the first FeedArg
+  std::unordered_map<std::string, std::vector<std::pair<Instruction*, int>>> feed_slots_;
+  // the static memory plan of the intermediate variables, and the arena holding them
+  MemoryPlan memory_plan_;
+  MemoryEstimate memory_estimate_;
+  Target arena_target_;
+  std::unique_ptr<Buffer> arena_;
+  // the states of the CUDA Graph execution mode: the instantiated graph, the stream owned for capturing when no
+  // stream is given, the addresses of the arguments when captured and whether the instructions can be captured
+  void* cuda_graph_exec_{nullptr};
+  void* cuda_graph_stream_{nullptr};
+  std::vector<std::string> cuda_graph_arg_names_;
+  std::vector<void*> cuda_graph_key_;
+  bool cuda_graph_disabled_{false};
+  // run the independent instructions concurrently
+  std::unique_ptr<DagExecutor> dag_executor_;
+  // the thread budget of the host kernels
+  int thread_budget_;
+  // record the time of each instruction
+  std::unique_ptr<InstructionProfiler> profiler_;
+  // upload the offloaded parameters ahead of the instructions
+  std::unique_ptr<WeightOffloader> weight_offloader_;
+  // swap the long-lived variables out of the device memory between their uses, created on the first run
+  SwapPlan swap_plan_;
+  std::unique_ptr<ActivationSwapper> activation_swapper_;
+  // the owners of the code of the instructions, either the compiler or the modules loaded from an artifact
+  std::shared_ptr<ParallelCompiler> parallel_compiler_;
+  std::vector<CompiledModule> loaded_modules_;
+  std::vector<std::unique_ptr<backends::ExecutionEngine>> loaded_engines_;
+#ifdef CINN_WITH_CUDA
+  std::vector<std::shared_ptr<runtime::cuda::CUDAModule>> loaded_cumodules_;
+#endif
+  // the task of the global task pool compiling the instructions in advance
+  std::future<void> prefetch_;
+  std::atomic<bool> prefetch_stopped_{false};
+  // serialize the runs and the changes of the running states from different threads
+  std::mutex run_mutex_;
 };
 
 /**
@@ -92,6 +277,10 @@ class GraphCompiler final {
 
   struct CompilationResult {
     std::unique_ptr<Program> runtime_program;
+    // the time and IR size of each compile phase, including the passes run on this thread before Build
+    std::shared_ptr<utils::CompileStats> stats;
+    // the memory of a run estimated from the life time of the variables
+    MemoryEstimate memory_estimate;
   };
 
   struct CompileOptions {
@@ -99,6 +288,15 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // pack the intermediate variables into one arena according to their life time at compile time
+    bool with_static_memory_plan = false;
+    // compile each instruction on its first run instead of ahead, which starts up quickly when only a few of the
+    // instructions are run, see FLAGS_cinn_lazy_compile_prefetch_thread to compile the others in background
+    bool with_lazy_compile = false;
+    // the inputs whose leading dimension is the batch, the kernels computing the batch-major outputs from them launch
+    // only the rows of the actual batch on NVGPU, which is the leading dimension of the first input on running, so
+    // that the program compiled for the largest batch serves the smaller ones, see Instruction::SetBatchScalable
+    std::vector<std::string> batch_inputs;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::shared_ptr<Graph::Group>> groups;
@@ -159,16 +357,56 @@ class GraphCompiler final {
   void AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
                                std::unordered_map<int, std::vector<std::string>>* step2malloc,
                                std::unordered_map<int, std::vector<std::string>>* step2free);
+  VariableLifeTime AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  // estimate the memory of a run of the instructions, see MemoryEstimate
+  MemoryEstimate EstimateMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                const std::unordered_set<std::string>& fetch_var_ids,
+                                const CompileOptions& options,
+                                const MemoryPlan& memory_plan);
 
   // insert a buffer malloc instruction applying on variables before they are
   // firstly used in the next instruction, and insert a buffer free instruction
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
- private:
-  // parallel compiler
-  std::shared_ptr<ParallelCompiler> parallel_compiler_;
+  // share the buffers of the variables in place: the output of a reshape, squeeze or expand_dims instruction is an
+  // alias of its input and the instruction is skipped, and the output of an elementwise instruction overwrites an
+  // input of the same shape and dtype, which is neither used by the following instructions nor fetched.
+  void AnalyzeInplaceVariables(const std::vector<std::vector<Node*>>& groups,
+                               const std::vector<std::unique_ptr<Instruction>>& instructions,
+                               const std::unordered_set<std::string>& fetch_var_ids);
+
+  // mark the instructions of the elementwise and broadcast groups whose outputs are derived from the batch inputs and
+  // of the same batch-major shapes as scalable by the batch, the others always compute the whole compiled batch.
+  void MarkBatchScalableInstructions(const std::vector<std::vector<Node*>>& groups,
+                                     const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                     const std::vector<std::string>& batch_inputs);
+
+  // allocate the buffers of all the variables in scope, and the reused variables share the buffers of their sources
+  void InstantiateVariables();
+
+  // plan the inputs of a concat on its outermost axis, whose dimensions before the axis are all 1, at the slices of
+  // its output, so the producers write into the output directly and the concat is skipped. The inputs should be
+  // produced by the instructions, neither kept nor sharing the buffers of others, and concatenated only once.
+  void AnalyzeConcatSlices(const std::vector<std::vector<Node*>>& groups,
+                           const std::vector<std::unique_ptr<Instruction>>& instructions,
+                           const std::unordered_set<std::string>& fetch_var_ids);
+
+  // pack the intermediate variables, which are produced and consumed inside the instructions and not fetched, into
+  // one arena according to their life time, so that no memory is allocated at runtime.
+  MemoryPlan PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                              const std::unordered_set<std::string>& fetch_var_ids);
+
+  // plan the swaps of the intermediate variables on NVGPU out to the host memory during the gaps between their uses by
+  // SwapPlanner until the peak fits FLAGS_cinn_swap_memory_budget_mb, see SwapPlan. The time of each instruction is
+  // estimated on the roofline from the static \p works of its functions, or from the bytes of its arguments if not
+  // known. The steps are those of the runtime instructions, the prerun ones excluded.
+  SwapPlan PlanActivationSwaps(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                               const std::unordered_set<std::string>& fetch_var_ids,
+                               const std::map<std::string, auto_schedule::KernelWork>& works);
 
+ private:
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_funcs);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
   Target target_;
@@ -184,6 +422,8 @@ class GraphCompiler final {
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
+  // map the input of a skipped concat to its output and the byte offset of its slice
+  absl::flat_hash_map<std::string, std::pair<std::string, size_t>> slice_vars_map_;
 
   std::unique_ptr<backends::Compiler> compiler_;
   CompileOptions compile_options_;
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
@@ -25,6 +28,10 @@
 #include "cinn/hlir/pass/use_pass.h"
 #include "cinn/utils/data_util.h"
 
+DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_use_inplace_variables);
+DECLARE_bool(cinn_use_concat_slices);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -117,6 +124,129 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestMemoryEstimate) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {64, 128}, "A");
+  auto b = builder.CreateInput(Float(32), {64, 128}, "B");
+  auto c = builder.Add(a, b);
+  auto d = builder.Relu(c);
+  auto e = builder.Exp(d);
+  auto f = builder.Add(e, a);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, std::unordered_set<std::string>{f->id}, target);
+  auto scope   = BuildScope(target, graph);
+
+  // every instruction computes a node, the inputs and the fetched variable are persistent, and at most two of the
+  // intermediate variables are held at the same time
+  const size_t var_bytes = 64 * 128 * sizeof(float);
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_buffer_handle_instruction_inserted = true;
+  auto result                                     = gc.Build(options, {f->id});
+  const auto& estimate                            = result.memory_estimate;
+  ASSERT_EQ(estimate.total_bytes, 6 * var_bytes);
+  ASSERT_EQ(estimate.persistent_bytes, 3 * var_bytes);
+  ASSERT_EQ(estimate.peak_intermediate_bytes, 2 * var_bytes);
+  ASSERT_EQ(estimate.peak_bytes, 5 * var_bytes);
+  ASSERT_EQ(result.runtime_program->GetMemoryEstimate().peak_bytes, estimate.peak_bytes);
+}
+
+// Every node is an instruction: the exp and the scale overwrite their dead inputs, and the reshape is skipped, so all
+// the intermediate variables share the buffer of the relu.
+TEST(GraphCompilerTest, TestInplaceVariables) {
+  frontend::NetBuilder builder("test");
+  auto x   = builder.CreateInput(Float(32), {4, 16}, "X");
+  auto y   = builder.Relu(x);
+  auto z   = builder.Exp(y);
+  auto r   = builder.Reshape(z, {64});
+  auto out = builder.Scale(r, 2.0f, 1.0f);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, std::unordered_set<std::string>{out->id}, target);
+
+  FLAGS_cinn_parallel_compile_size = 0;
+  std::vector<std::vector<float>> results;
+  for (bool inplace : {false, true}) {
+    FLAGS_cinn_use_inplace_variables = inplace;
+    auto scope                       = BuildScope(target, graph);
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.with_instantiate_variables = true;
+    auto runtime_program               = gc.Build(options, {out->id}).runtime_program;
+
+    auto buffer = scope->GetTensor(y->id)->get_buffer();
+    for (auto& var : {z, r, out}) {
+      ASSERT_EQ(scope->GetTensor(var->id)->get_buffer() == buffer, inplace) << var->id;
+    }
+    const auto& instructions = runtime_program->GetRunInstructions();
+    ASSERT_EQ(instructions.size(), 4UL);
+    ASSERT_EQ(instructions[2]->GetFunctionName() == "no_run", inplace);
+
+    auto x_tensor = scope->GetTensor("X");
+    SetRandData<float>(x_tensor, target);
+    runtime_program->Execute();
+    auto host_x   = GetTensorData<float>(x_tensor, target);
+    auto host_out = GetTensorData<float>(scope->GetTensor(out->id), target);
+    for (int i = 0; i < host_x.size(); ++i) {
+      ASSERT_NEAR(host_out[i], std::exp(std::max(host_x[i], 0.0f)) * 2.0f + 1.0f, 1e-4);
+    }
+  }
+  FLAGS_cinn_parallel_compile_size = 16;
+  FLAGS_cinn_use_inplace_variables = true;
+}
+
+// The relu and the exp write into the slices of the concat output on the outermost axis, so the concat is skipped.
+TEST(GraphCompilerTest, TestConcatSlices) {
+  frontend::NetBuilder builder("test");
+  auto a   = builder.CreateInput(Float(32), {2, 16}, "A");
+  auto b   = builder.CreateInput(Float(32), {2, 16}, "B");
+  auto y1  = builder.Relu(a);
+  auto y2  = builder.Exp(b);
+  auto c   = builder.Concat({y1, y2}, 0);
+  auto out = builder.Scale(c, 2.0f);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, std::unordered_set<std::string>{out->id}, target);
+
+  FLAGS_cinn_parallel_compile_size = 0;
+  for (bool use_slices : {false, true}) {
+    FLAGS_cinn_use_concat_slices = use_slices;
+    auto scope                   = BuildScope(target, graph);
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.with_static_memory_plan = true;
+    auto runtime_program            = gc.Build(options, {out->id}).runtime_program;
+
+    const auto& instructions = runtime_program->GetRunInstructions();
+    ASSERT_EQ(instructions.size(), 4UL);
+    ASSERT_EQ(instructions[2]->GetFunctionName() == "no_run", use_slices);
+    const auto& plan = runtime_program->GetMemoryPlan();
+    if (use_slices) {
+      ASSERT_EQ(plan.offsets.at(y1->id), plan.offsets.at(c->id));
+      ASSERT_EQ(plan.offsets.at(y2->id), plan.offsets.at(c->id) + 2 * 16 * sizeof(float));
+    }
+
+    auto a_tensor = scope->GetTensor("A");
+    auto b_tensor = scope->GetTensor("B");
+    SetRandData<float>(a_tensor, target);
+    SetRandData<float>(b_tensor, target);
+    runtime_program->Execute();
+    auto host_a   = GetTensorData<float>(a_tensor, target);
+    auto host_b   = GetTensorData<float>(b_tensor, target);
+    auto host_out = GetTensorData<float>(scope->GetTensor(out->id), target);
+    for (int i = 0; i < host_a.size(); ++i) {
+      ASSERT_NEAR(host_out[i], std::max(host_a[i], 0.0f) * 2.0f, 1e-4);
+      ASSERT_NEAR(host_out[host_a.size() + i], std::exp(host_b[i]) * 2.0f, 1e-4);
+    }
+  }
+  FLAGS_cinn_parallel_compile_size = 16;
+  FLAGS_cinn_use_concat_slices     = true;
+}
+
 #ifdef CINN_WITH_CUDA
 std::vector<float> test_mul(
     const std::vector<float>& A, const std::vector<float>& B, int M, int K, int N, bool trans_a, bool trans_b) {
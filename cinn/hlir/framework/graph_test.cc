@@ -65,6 +65,46 @@ TEST(Graph, visualize_recompute) {
   graph->VisualizeGroupedGraph({add_2->id, add_3->id});
 }
 
+TEST(Graph, StructuralSignature) {
+  frontend::NetBuilder builder("test");
+  auto a       = builder.CreateInput(Float(32), {32, 16}, "a");
+  auto b       = builder.CreateInput(Float(32), {32, 16}, "b");
+  auto c       = builder.CreateInput(Float(32), {32, 16}, "c");
+  auto d       = builder.CreateInput(Float(32), {32, 16}, "d");
+  auto e       = builder.CreateInput(Float(32), {16, 32}, "e");
+  auto f       = builder.CreateInput(Float(32), {16, 32}, "f");
+  auto relu_1  = builder.Relu(builder.Add(a, b));
+  auto relu_2  = builder.Relu(builder.Add(c, d));
+  auto relu_3  = builder.Relu(builder.Add(e, f));
+  auto program = builder.Build();
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(program, target);
+  ApplyPass(graph.get(), "OpFusionPass");
+  ASSERT_EQ(graph->fusion_groups.size(), 3UL);
+
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  std::unordered_map<std::string, std::vector<std::vector<std::string>>> signature_to_var_names;
+  for (auto& group : graph->fusion_groups) {
+    std::vector<std::string> var_names;
+    auto signature = group->StructuralSignature(shape_dict, dtype_dict, &var_names);
+    signature_to_var_names[signature].push_back(var_names);
+  }
+  // the first two groups only differ in names
+  ASSERT_EQ(signature_to_var_names.size(), 2UL);
+  for (auto& item : signature_to_var_names) {
+    if (item.second.size() == 1) continue;
+    ASSERT_EQ(item.second.size(), 2UL);
+    auto& names_0 = item.second[0];
+    auto& names_1 = item.second[1];
+    ASSERT_EQ(names_0.size(), names_1.size());
+    for (int i = 0; i < names_0.size(); ++i) {
+      ASSERT_NE(names_0[i], names_1[i]);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -15,20 +15,102 @@
 #include "cinn/hlir/framework/instruction.h"
 
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 
 #include "cinn/common/test_helper.h"
 #include "cinn/hlir/framework/accuracy_checker.h"
+#include "cinn/runtime/cuda/nccl_util.h"
 #include "cinn/runtime/flags.h"
 #include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_sync_run);
 DECLARE_string(cinn_self_check_accuracy);
+DECLARE_int64(cinn_self_check_accuracy_sample_runs);
 
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+namespace {
+#ifdef CINN_WITH_CUDA
+// scale the grids of the kernels launched in the scope by the actual batch
+class LaunchGridScaleGuard {
+ public:
+  LaunchGridScaleGuard(int batch_size, int compiled_batch_size) {
+    runtime::cuda::SetLaunchGridScale(batch_size, compiled_batch_size);
+  }
+  ~LaunchGridScaleGuard() { runtime::cuda::SetLaunchGridScale(0, 0); }
+};
+
+class KernelLaunchArgsGuard {
+ public:
+  explicit KernelLaunchArgsGuard(runtime::cuda::KernelLaunchArgs* launch_args) {
+    runtime::cuda::SetKernelLaunchArgs(launch_args);
+  }
+  ~KernelLaunchArgsGuard() { runtime::cuda::SetKernelLaunchArgs(nullptr); }
+};
+#endif
+
+#ifdef CINN_WITH_CUDNN
+void CallCudnnConv2d(const std::vector<int>& attrs,
+                     const std::vector<std::string>& str_attrs,
+                     std::vector<cinn_pod_value_t>* args,
+                     void* stream) {
+  auto& pod_args = *args;
+  if (str_attrs[0] == "forward") {
+    if (str_attrs.size() > 1 && str_attrs[1] == "NHWC") {
+      absl::flat_hash_map<std::string, int> attrs_map = {
+          {"input_n", attrs[0]},     {"input_h", attrs[1]},     {"input_w", attrs[2]},   {"input_c", attrs[3]},
+          {"weights_n", attrs[4]},   {"weights_c", attrs[5]},   {"weights_h", attrs[6]}, {"weights_w", attrs[7]},
+          {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
+          {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[15]},
+          {"output_h", attrs[16]},   {"output_w", attrs[17]},   {"output_c", attrs[18]},
+      };
+      runtime::cuda::cinn_gpu_cudnn_conv2d(
+          attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream), common::Layout::kNHWC);
+
+    } else {
+      absl::flat_hash_map<std::string, int> attrs_map = {
+          {"input_n", attrs[0]},     {"input_c", attrs[1]},     {"input_h", attrs[2]},   {"input_w", attrs[3]},
+          {"weights_n", attrs[4]},   {"weights_c", attrs[5]},   {"weights_h", attrs[6]}, {"weights_w", attrs[7]},
+          {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
+          {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[15]},
+          {"output_c", attrs[16]},   {"output_h", attrs[17]},   {"output_w", attrs[18]},
+      };
+      runtime::cuda::cinn_gpu_cudnn_conv2d(
+          attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream), common::Layout::kNCHW);
+    }
+  } else if (str_attrs[0] == "backward_data") {
+    // w, dy, dx
+    absl::flat_hash_map<std::string, int> attrs_map = {
+        {"input_n", attrs[15]},    {"input_c", attrs[16]},    {"input_h", attrs[17]},  {"input_w", attrs[18]},
+        {"weights_n", attrs[0]},   {"weights_c", attrs[1]},   {"weights_h", attrs[2]}, {"weights_w", attrs[3]},
+        {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
+        {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[4]},
+        {"output_c", attrs[5]},    {"output_h", attrs[6]},    {"output_w", attrs[7]},
+    };
+    // w, dy, dx
+    runtime::cuda::cinn_gpu_cudnn_conv2d_backward_data(
+        attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
+  } else {
+    // x, dy, w
+    absl::flat_hash_map<std::string, int> attrs_map = {
+        {"input_n", attrs[0]},     {"input_c", attrs[1]},     {"input_h", attrs[2]},    {"input_w", attrs[3]},
+        {"weights_n", attrs[15]},  {"weights_c", attrs[16]},  {"weights_h", attrs[17]}, {"weights_w", attrs[18]},
+        {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]},  {"stride_w", attrs[11]},
+        {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},    {"output_n", attrs[4]},
+        {"output_c", attrs[5]},    {"output_h", attrs[6]},    {"output_w", attrs[7]},
+    };
+    // x, dy, w
+    runtime::cuda::cinn_gpu_cudnn_conv2d_backward_filter(
+        attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
+  }
+}
+#endif
+}  // namespace
+
 namespace details {
 class ResultsPrint {
  public:
@@ -75,34 +157,116 @@ class ResultsPrint {
 }  // namespace details
 
 void Instruction::UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
-  int cache_size = size();
-  args_cached_.resize(cache_size);
+  Compile();
+#ifdef CINN_WITH_CUDA
+  launch_args_cached_.clear();
+#endif
+  ResolveArgSlots();
+  std::vector<cinn_pod_value_t> values;
+  values.reserve(arg_names_.size());
+  if (name2podargs != nullptr) {
+    for (const auto& arg : arg_names_) {
+      auto it = name2podargs->find(arg);
+      CHECK(it != name2podargs->end()) << "Argument [" << arg << "] not found in the name2podargs";
+      VLOG(5) << "Get a argument, name=" << arg << ",type_code=" << it->second.type_code();
+      values.push_back(it->second);
+    }
+  } else {
+    // the variables are resolved into their ids in the scope once, and looked up by the ids since then
+    if (arg_var_ids_.size() != arg_names_.size()) {
+      arg_var_ids_.clear();
+      for (const auto& arg : arg_names_) {
+        int id = scope_->FindVarId(arg);
+        CHECK_GE(id, 0) << "Argument [" << arg << "] not found in the scope";
+        arg_var_ids_.push_back(id);
+      }
+    }
+    for (int id : arg_var_ids_) {
+      auto* var = scope_->GetVar(id);
+      CHECK(var) << "Argument [" << scope_->GetVarName(id) << "] not found in the scope";
 
-  for (int i = 0; i < cache_size; ++i) {
-    common::ArgsBuilder builder;
+      // TODO(Superjomn) Support other types.
+      auto& tensor = absl::get<Tensor>(*var);
+      values.emplace_back(tensor->buffer());
+    }
+  }
+
+  args_cached_.resize(size());
+  for (int i = 0; i < args_cached_.size(); ++i) {
+    const auto& slots = arg_slots_[i];
+    args_cached_[i].resize(slots.size());
+    for (int j = 0; j < slots.size(); ++j) {
+      args_cached_[i][j] = values[slots[j]];
+    }
+  }
+}
+
+void Instruction::ResolveArgSlots() {
+  if (!arg_slots_.empty() && arg_slots_.size() == size()) {
+    return;
+  }
+  CHECK_EQ(in_args_.size(), size()) << "The arguments of " << function_name_ << " don't match its functions";
+  CHECK_EQ(out_args_.size(), size()) << "The arguments of " << function_name_ << " don't match its functions";
+  arg_names_.clear();
+  arg_var_ids_.clear();
+  slot_uses_.clear();
+  arg_slots_.assign(size(), {});
+  std::unordered_map<std::string, int> name2slot;
+  for (int i = 0; i < size(); ++i) {
     std::vector<std::string> all_args = in_args_[i];
     all_args.insert(std::end(all_args), out_args_[i].begin(), out_args_[i].end());
-
-    if (name2podargs != nullptr) {
-      for (const auto& arg : all_args) {
-        CHECK_NE(name2podargs->count(arg), 0) << "Argument [" << arg << "] not found in the name2podargs";
-        VLOG(5) << "Get a argument, name=" << arg << ",type_code=" << name2podargs->at(arg).type_code();
-        builder.Add(name2podargs->at(arg));
-      }
-    } else {
-      for (const auto& arg : all_args) {
-        auto* var = scope_->FindVar(arg);
-        CHECK(var) << "Argument [" << arg << "] not found in the scope";
-
-        // TODO(Superjomn) Support other types.
-        auto& tensor = absl::get<Tensor>(*var);
-        VLOG(5) << "Get a argument, name=" << arg;
-        builder.Add(tensor->buffer());
+    for (const auto& arg : all_args) {
+      auto it = name2slot.find(arg);
+      if (it == name2slot.end()) {
+        it = name2slot.emplace(arg, arg_names_.size()).first;
+        arg_names_.push_back(arg);
+        slot_uses_.emplace_back();
       }
+      slot_uses_[it->second].emplace_back(i, arg_slots_[i].size());
+      arg_slots_[i].push_back(it->second);
+    }
+  }
+}
+
+const std::vector<std::string>& Instruction::GetArgNames() {
+  Compile();
+  ResolveArgSlots();
+  return arg_names_;
+}
+
+void Instruction::PatchArg(int slot, const cinn_pod_value_t& value) {
+  if (args_cached_.size() != size()) {
+    UpdateArgsCache(nullptr);
+  }
+  CHECK(slot >= 0 && slot < slot_uses_.size())
+      << "The slot " << slot << " is out of the arguments of " << function_name_;
+  for (auto& use : slot_uses_[slot]) {
+    args_cached_[use.first][use.second] = value;
+#ifdef CINN_WITH_CUDA
+    // the launch arguments point into the buffers of the arguments, so they are rebuilt on the next launch
+    if (use.first < launch_args_cached_.size()) {
+      launch_args_cached_[use.first].v_args = nullptr;
     }
+#endif
+  }
+}
 
-    args_cached_[i] = builder.Build();
+std::vector<std::vector<cinn_pod_value_t>> Instruction::BuildArgs(
+    const std::map<std::string, cinn_pod_value_t>& name2podargs) {
+  Compile();
+  std::vector<std::vector<cinn_pod_value_t>> args(size());
+  for (int i = 0; i < args.size(); ++i) {
+    common::ArgsBuilder builder;
+    std::vector<std::string> all_args = in_args_[i];
+    all_args.insert(std::end(all_args), out_args_[i].begin(), out_args_[i].end());
+    for (const auto& arg : all_args) {
+      CHECK_NE(name2podargs.count(arg), 0) << "Argument [" << arg << "] not found in the name2podargs";
+      VLOG(5) << "Get a argument, name=" << arg << ",type_code=" << name2podargs.at(arg).type_code();
+      builder.Add(name2podargs.at(arg));
+    }
+    args[i] = builder.Build();
   }
+  return args;
 }
 
 void Instruction::Finalize() {
@@ -111,17 +275,57 @@ void Instruction::Finalize() {
     out_args_.erase(out_args_.begin());
     in_args_.erase(in_args_.begin());
   }
+  arg_slots_.clear();
+  ResolveDispatch();
 
   finalized_flag_ = true;
 }
 
+void Instruction::ResolveDispatch() {
+  dispatch_kind_ = DispatchKind::kLoweredFuncs;
+  if (function_name_ == "no_run") {
+    dispatch_kind_ = DispatchKind::kSkip;
+    return;
+  }
+#ifdef CINN_WITH_CUDA
+  static const std::unordered_map<std::string, DispatchKind> library_calls = {
+      {"cublas_gemm", DispatchKind::kCublasGemm},
+      {"cublas_matmul", DispatchKind::kCublasMatmul},
+#ifdef CINN_WITH_CUDNN
+      {"mul", DispatchKind::kCublasMul},
+      // conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
+      {"conv2d", DispatchKind::kCudnnConv2d},
+      {"depthwise_conv2d", DispatchKind::kCudnnConv2d},
+      {"pool2d", DispatchKind::kCudnnPool2d},
+      {"softmax", DispatchKind::kCudnnSoftmax},
+#endif
+  };
+  auto it = library_calls.find(function_name_);
+  if (it != library_calls.end() && target_.arch == Target::Arch::NVGPU) {
+    dispatch_kind_ = it->second;
+  }
+#endif
+}
+
+void Instruction::Compile() {
+  if (IsCompiled()) return;
+  std::call_once(compile_once_, [this]() {
+    utils::RecordEvent record_compile("Lazy Compile " + function_name_, utils::EventType::kCompile);
+    VLOG(2) << "Compile function " << function_name_ << " on the first use";
+    compile_thunk_(this);
+    CHECK(finalized_flag_) << "The compile thunk of " << function_name_ << " must finalize the instruction";
+    compiled_.store(true, std::memory_order_release);
+  });
+}
+
 void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs,
                       bool dryrun,
                       void* stream,
                       bool use_cache) {
   utils::RecordEvent record_run(function_name_, cinn::utils::EventType::kInstruction);
+  Compile();
   CHECK(finalized_flag_) << "Instruction must be finalized before run";
-  if (function_name_ == "no_run") {
+  if (dispatch_kind_ == DispatchKind::kSkip) {
     VLOG(2) << "skip instruction";
     return;
   }
@@ -135,127 +339,138 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     }
   }
 
+  RunImpl(&args_cached_, name2podargs, dryrun, stream);
+}
+
+void Instruction::RunWithArgs(std::vector<std::vector<cinn_pod_value_t>>* args,
+                              const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                              void* stream) {
+  utils::RecordEvent record_run(function_name_, cinn::utils::EventType::kInstruction);
+  Compile();
+  CHECK(finalized_flag_) << "Instruction must be finalized before run";
+  if (dispatch_kind_ == DispatchKind::kSkip) {
+    VLOG(2) << "skip instruction";
+    return;
+  }
+  CHECK_EQ(args->size(), size()) << "The arguments are not built for the instruction " << function_name_;
+  VLOG(2) << "Run function " << function_name_ << " with the given arguments";
+  RunImpl(args, name2podargs, false, stream);
+}
+
+#ifdef CINN_WITH_CUDA
+runtime::cuda::KernelLaunchArgs* Instruction::GetKernelLaunchArgs(std::vector<std::vector<cinn_pod_value_t>>* all_args,
+                                                                  int idx) {
+  // only the cached arguments live across the runs, the given ones are launched as they are
+  if (all_args != &args_cached_) {
+    return nullptr;
+  }
+  launch_args_cached_.resize(args_cached_.size());
+  auto& launch_args = launch_args_cached_[idx];
+  auto& pod_args    = args_cached_[idx];
+  if (launch_args.v_args != pod_args.data() || launch_args.ptrs.size() != pod_args.size()) {
+    runtime::cuda::BuildKernelLaunchArgs(pod_args.data(), pod_args.size(), &launch_args);
+  }
+  return &launch_args;
+}
+#endif
+
+void Instruction::RunImpl(std::vector<std::vector<cinn_pod_value_t>>* all_args,
+                          const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                          bool dryrun,
+                          void* stream) {
+  auto& args = *all_args;
   utils::RecordEvent record_args("Instruction::Run", cinn::utils::EventType::kInstruction);
-#if defined(CINN_WITH_CUDA) && !defined(CINN_WITH_CUDNN)
-  if (function_name_ == "cublas_gemm" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
-    VLOG(3) << "The pod_args size of cublas_gemm: " << pod_args.size();
-    runtime::cuda::cinn_gpu_cublas_gemm(
-        attrs, pod_args[0], pod_args[1], pod_args[2], pod_args[3], static_cast<cudaStream_t>(stream));
-  } else if (function_name_ == "cublas_matmul" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
-    VLOG(3) << "The pod_args size of cublas_matmul: " << pod_args.size();
-    runtime::cuda::cinn_gpu_cublas_gemm(
-        attrs, pod_args[0], pod_args[1], nullptr, pod_args[2], static_cast<cudaStream_t>(stream));
-  } else {
-    VLOG(3) << "Runing extern function " << function_name_;
-    for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
-      VLOG(3) << "Runing func name: " << fn_names_[idx];
-      auto& pod_args = args_cached_[idx];
-      CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
-      if (!dryrun) {
-        if (target_ == common::DefaultNVGPUTarget()) {
-          ((lower_func_ptr_g)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size(), stream);
-        } else {
-          ((lower_func_ptr_t)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size());
-        }
-      }
+  MemoryManager::ScopedInstructionAllocs alloc_scope(&function_name_);
+#ifdef CINN_WITH_NCCL
+  // the collective ops running off the compute stream are waited by the instructions touching their buffers
+  if (!dryrun && target_.arch == Target::Arch::NVGPU) {
+    runtime::cuda::WaitCollectiveResults(args, stream);
+  }
+#endif
+#ifdef CINN_WITH_CUDA
+  std::unique_ptr<LaunchGridScaleGuard> grid_scale_guard;
+  if (compiled_batch_size_ > 0) {
+    int batch_size = GetBatchSize();
+    CHECK(batch_size > 0 && batch_size <= compiled_batch_size_)
+        << "The batch size " << batch_size << " is out of the compiled batch size " << compiled_batch_size_;
+    if (batch_size < compiled_batch_size_) {
+      grid_scale_guard = std::make_unique<LaunchGridScaleGuard>(batch_size, compiled_batch_size_);
     }
-    VLOG(3) << "Done Runing extern function " << function_name_;
   }
-#elif defined(CINN_WITH_CUDNN)
-  auto& pod_args = args_cached_[0];
-  // Here conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
-  if ((function_name_ == "conv2d" || function_name_ == "depthwise_conv2d") && target_.arch == Target::Arch::NVGPU) {
-    if (str_attrs[0] == "forward") {
-      if (str_attrs.size() > 1 && str_attrs[1] == "NHWC") {
-        absl::flat_hash_map<std::string, int> attrs_map = {
-            {"input_n", attrs[0]},     {"input_h", attrs[1]},     {"input_w", attrs[2]},   {"input_c", attrs[3]},
-            {"weights_n", attrs[4]},   {"weights_c", attrs[5]},   {"weights_h", attrs[6]}, {"weights_w", attrs[7]},
-            {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
-            {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[15]},
-            {"output_h", attrs[16]},   {"output_w", attrs[17]},   {"output_c", attrs[18]},
-        };
-        runtime::cuda::cinn_gpu_cudnn_conv2d(
-            attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream), common::Layout::kNHWC);
+#endif
+  switch (dispatch_kind_) {
+#ifdef CINN_WITH_CUDA
+    case DispatchKind::kCublasGemm: {
+      auto& pod_args = args[0];
+      VLOG(3) << "The pod_args size of cublas_gemm: " << pod_args.size();
+      runtime::cuda::cinn_gpu_cublas_gemm(
+          attrs, pod_args[0], pod_args[1], pod_args[2], pod_args[3], static_cast<cudaStream_t>(stream));
+      break;
+    }
+    case DispatchKind::kCublasMatmul: {
+      auto& pod_args = args[0];
+      VLOG(3) << "The pod_args size of cublas_matmul: " << pod_args.size();
+      runtime::cuda::cinn_gpu_cublas_gemm(
+          attrs, pod_args[0], pod_args[1], nullptr, pod_args[2], static_cast<cudaStream_t>(stream));
+      break;
+    }
+#endif
+#ifdef CINN_WITH_CUDNN
+    case DispatchKind::kCudnnConv2d:
+      CallCudnnConv2d(attrs, str_attrs, &args[0], stream);
+      break;
+    case DispatchKind::kCudnnPool2d: {
+      auto& pod_args = args[0];
+      runtime::cuda::cinn_gpu_cudnn_pool2d(
+          attrs, str_attrs, pod_args[0], pod_args[1], static_cast<cudaStream_t>(stream));
+      break;
+    }
+    case DispatchKind::kCudnnSoftmax: {
+      auto& pod_args = args[0];
+      CHECK_EQ(pod_args.size(), 3);
+      runtime::cuda::cinn_gpu_cudnn_softmax(attrs, pod_args[0], pod_args[1], static_cast<cudaStream_t>(stream));
+      break;
+    }
+    case DispatchKind::kCublasMul: {
+      auto& pod_args = args[0];
+      CHECK_EQ(pod_args.size(), 4);
+      runtime::cuda::cinn_gpu_cublas_mul(
+          attrs, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
+      break;
+    }
+#endif
+    default:
+      RunLoweredFuncs(all_args, dryrun, stream);
+  }
 
-      } else {
-        absl::flat_hash_map<std::string, int> attrs_map = {
-            {"input_n", attrs[0]},     {"input_c", attrs[1]},     {"input_h", attrs[2]},   {"input_w", attrs[3]},
-            {"weights_n", attrs[4]},   {"weights_c", attrs[5]},   {"weights_h", attrs[6]}, {"weights_w", attrs[7]},
-            {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
-            {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[15]},
-            {"output_c", attrs[16]},   {"output_h", attrs[17]},   {"output_w", attrs[18]},
-        };
-        runtime::cuda::cinn_gpu_cudnn_conv2d(
-            attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream), common::Layout::kNCHW);
-      }
-    } else if (str_attrs[0] == "backward_data") {
-      // w, dy, dx
-      absl::flat_hash_map<std::string, int> attrs_map = {
-          {"input_n", attrs[15]},    {"input_c", attrs[16]},    {"input_h", attrs[17]},  {"input_w", attrs[18]},
-          {"weights_n", attrs[0]},   {"weights_c", attrs[1]},   {"weights_h", attrs[2]}, {"weights_w", attrs[3]},
-          {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]}, {"stride_w", attrs[11]},
-          {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},   {"output_n", attrs[4]},
-          {"output_c", attrs[5]},    {"output_h", attrs[6]},    {"output_w", attrs[7]},
-      };
-      // w, dy, dx
-      runtime::cuda::cinn_gpu_cudnn_conv2d_backward_data(
-          attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
+  if (!cinn::runtime::CheckStringFlagFalse(FLAGS_cinn_self_check_accuracy)) {
+    if (FLAGS_cinn_self_check_accuracy_sample_runs > 0) {
+      SampleResults(name2podargs, stream);
     } else {
-      // x, dy, w
-      absl::flat_hash_map<std::string, int> attrs_map = {
-          {"input_n", attrs[0]},     {"input_c", attrs[1]},     {"input_h", attrs[2]},    {"input_w", attrs[3]},
-          {"weights_n", attrs[15]},  {"weights_c", attrs[16]},  {"weights_h", attrs[17]}, {"weights_w", attrs[18]},
-          {"pad_h", attrs[8]},       {"pad_w", attrs[9]},       {"stride_h", attrs[10]},  {"stride_w", attrs[11]},
-          {"dilation_h", attrs[12]}, {"dilation_w", attrs[13]}, {"groups", attrs[14]},    {"output_n", attrs[4]},
-          {"output_c", attrs[5]},    {"output_h", attrs[6]},    {"output_w", attrs[7]},
-      };
-      // x, dy, w
-      runtime::cuda::cinn_gpu_cudnn_conv2d_backward_filter(
-          attrs_map, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
+      CheckResults(name2podargs, stream);
     }
-  } else if (function_name_ == "pool2d" && target_.arch == Target::Arch::NVGPU) {
-    runtime::cuda::cinn_gpu_cudnn_pool2d(attrs, str_attrs, pod_args[0], pod_args[1], static_cast<cudaStream_t>(stream));
-  } else if (function_name_ == "softmax" && target_.arch == Target::Arch::NVGPU) {
-    CHECK_EQ(pod_args.size(), 3);
-    runtime::cuda::cinn_gpu_cudnn_softmax(attrs, pod_args[0], pod_args[1], static_cast<cudaStream_t>(stream));
-  } else if (function_name_ == "mul" && target_.arch == Target::Arch::NVGPU) {
-    CHECK_EQ(pod_args.size(), 4);
-    runtime::cuda::cinn_gpu_cublas_mul(attrs, pod_args[0], pod_args[1], pod_args[2], static_cast<cudaStream_t>(stream));
-  } else if (function_name_ == "cublas_gemm" && target_.arch == Target::Arch::NVGPU) {
-    VLOG(3) << "The pod_args size of cublas_gemm: " << pod_args.size();
-    runtime::cuda::cinn_gpu_cublas_gemm(
-        attrs, pod_args[0], pod_args[1], pod_args[2], pod_args[3], static_cast<cudaStream_t>(stream));
-  } else if (function_name_ == "cublas_matmul" && target_.arch == Target::Arch::NVGPU) {
-    auto& pod_args = args_cached_[0];
-    VLOG(3) << "The pod_args size of cublas_matmul: " << pod_args.size();
-    runtime::cuda::cinn_gpu_cublas_gemm(
-        attrs, pod_args[0], pod_args[1], nullptr, pod_args[2], static_cast<cudaStream_t>(stream));
-  } else {
-    VLOG(3) << "Runing extern function " << function_name_;
-    for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
-      VLOG(3) << "Runing func name: " << fn_names_[idx];
-      auto& pod_args = args_cached_[idx];
-      CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
-      if (!dryrun) {
-        if (target_ == common::DefaultNVGPUTarget()) {
-          ((lower_func_ptr_g)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size(), stream);
-        } else {
-          ((lower_func_ptr_t)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size());
-        }
-      }
-    }
-    VLOG(3) << "Done Runing extern function " << function_name_;
   }
-#else
+  // TODO(thisjiang): revert while flags correct
+  //   if (FLAGS_cinn_sync_run) {
+  // #ifdef CINN_WITH_CUDA
+  //     utils::RecordEvent record_sync("FLAGS_cinn_sync_run");
+  //     CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
+  // #endif
+  //   }
+}
+
+void Instruction::RunLoweredFuncs(std::vector<std::vector<cinn_pod_value_t>>* all_args, bool dryrun, void* stream) {
+  auto& args = *all_args;
   VLOG(3) << "Runing extern function " << function_name_;
   for (int idx = 0; idx < fn_ptrs_.size(); ++idx) {
     VLOG(3) << "Runing func name: " << fn_names_[idx];
-    auto& pod_args = args_cached_[idx];
+    auto& pod_args = args[idx];
     CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
     if (!dryrun) {
-      if (target_ == common::DefaultNVGPUTarget()) {
+      if (target_.is_gpu()) {
+#ifdef CINN_WITH_CUDA
+        KernelLaunchArgsGuard launch_args_guard(GetKernelLaunchArgs(all_args, idx));
+#endif
         ((lower_func_ptr_g)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size(), stream);
       } else {
         ((lower_func_ptr_t)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size());
@@ -263,18 +478,6 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
     }
   }
   VLOG(3) << "Done Runing extern function " << function_name_;
-#endif
-
-  if (!cinn::runtime::CheckStringFlagFalse(FLAGS_cinn_self_check_accuracy)) {
-    CheckResults(name2podargs, stream);
-  }
-  // TODO(thisjiang): revert while flags correct
-  //   if (FLAGS_cinn_sync_run) {
-  // #ifdef CINN_WITH_CUDA
-  //     utils::RecordEvent record_sync("FLAGS_cinn_sync_run");
-  //     CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
-  // #endif
-  //   }
 }
 
 void Instruction::CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
@@ -328,6 +531,28 @@ void Instruction::CheckResults(const std::map<std::string, cinn_pod_value_t>* na
   details::ResultsPrint::GetInstance()->write(ss.str());
 }
 
+void Instruction::SampleResults(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
+  auto& checker = SampledAccuracyChecker::Global();
+  if (!checker.ShouldCheck(run_count_++)) {
+    return;
+  }
+  for (size_t i = 0; i < fn_names_.size(); ++i) {
+    if (fn_names_[i].find("malloc_buffer_instruction") != std::string::npos ||
+        fn_names_[i].find("free_buffer_instruction") != std::string::npos) {
+      continue;
+    }
+    for (auto& out_name : out_args_[i]) {
+      const cinn_buffer_t* buffer = nullptr;
+      if (name2podargs) {
+        buffer = cinn_pod_value_to_buffer_p(const_cast<cinn_pod_value_t*>(&name2podargs->at(out_name)));
+      } else {
+        buffer = scope_->GetTensor(out_name)->buffer();
+      }
+      checker.Check(target_, fn_names_[i], out_name, buffer, stream);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,7 +70,31 @@ class Instruction {
   // explicitly finalize the instruction, and can't append function again after call it
   void Finalize();
 
+  /**
+   * Compile the instruction lazily: \p compile_thunk is called once on the first Run, it sets the arguments and the
+   * compiled functions of the instruction and finalizes it.
+   */
+  void SetCompileThunk(std::function<void(Instruction*)> compile_thunk) { compile_thunk_ = std::move(compile_thunk); }
+  // run the compile thunk if not yet, it is thread safe so that the instructions can be compiled in advance by others
+  void Compile();
+  bool IsCompiled() const { return !compile_thunk_ || compiled_.load(std::memory_order_acquire); }
+
+  /**
+   * Rebuild the cached arguments from \p name2podargs, or from the scope if it is nullptr. Each variable is looked up
+   * once by its name, and copied into all its slots.
+   */
   void UpdateArgsCache(const std::map<std::string, cinn_pod_value_t>* name2podargs);
+
+  /**
+   * The arguments of all the functions are resolved into a table of the distinct variables, whose index is the slot of
+   * the variable, so that a variable is fed by patching its slots rather than rebuilding all the arguments by names.
+   */
+  const std::vector<std::string>& GetArgNames();
+  //! Replace the variable in \p slot of the cached arguments by \p value, the cache is built from the scope first.
+  void PatchArg(int slot, const cinn_pod_value_t& value);
+
+  //! Build the arguments of each function from \p name2podargs without caching them in the instruction.
+  std::vector<std::vector<cinn_pod_value_t>> BuildArgs(const std::map<std::string, cinn_pod_value_t>& name2podargs);
   /**
    * Run the Instruction.
    */
@@ -75,6 +102,13 @@ class Instruction {
            bool dryrun                                                 = false,
            void* stream                                                = nullptr,
            bool use_cache                                              = true);
+  /**
+   * Run the Instruction with the arguments built by BuildArgs and owned by the caller, the state of the instruction is
+   * not changed, so that the instruction can be run by several threads with their own arguments at the same time.
+   */
+  void RunWithArgs(std::vector<std::vector<cinn_pod_value_t>>* args,
+                   const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr,
+                   void* stream                                                = nullptr);
 
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
     CHECK_EQ(fn_ptrs_.size(), 4);
@@ -96,7 +130,7 @@ class Instruction {
         flag           = idx;
         auto& pod_args = args_cached_[idx];
         CHECK(fn_ptrs_[idx]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
-        if (target_ == common::DefaultNVGPUTarget()) {
+        if (target_.is_gpu()) {
           ((lower_func_ptr_g)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size(), stream);
         } else {
           ((lower_func_ptr_t)fn_ptrs_[idx])(static_cast<void*>(pod_args.data()), pod_args.size());
@@ -107,6 +141,10 @@ class Instruction {
       }
     }
     if (flag >= 0) {
+#ifdef CINN_WITH_CUDA
+      launch_args_cached_.clear();
+#endif
+      arg_slots_.clear();
       args_cached_.erase(args_cached_.begin() + flag);
       in_args_.erase(in_args_.begin() + flag);
       out_args_.erase(out_args_.begin() + flag);
@@ -119,11 +157,46 @@ class Instruction {
 
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
-  void ClearInArgs() { in_args_.clear(); }
-  void ClearOutArgs() { out_args_.clear(); }
+  void ClearInArgs() {
+    in_args_.clear();
+    arg_slots_.clear();
+  }
+  void ClearOutArgs() {
+    out_args_.clear();
+    arg_slots_.clear();
+  }
   std::vector<std::string> GetFnNames() { return fn_names_; }
-  void AddInArgs(const std::vector<std::string>& in_args) { in_args_.push_back(in_args); }
-  void AddOutArgs(const std::vector<std::string>& out_args) { out_args_.push_back(out_args); }
+  const std::string& GetFunctionName() const { return function_name_; }
+  // skip the instruction on run, such as when its output is an alias sharing the buffer of its input
+  void SkipRun() {
+    function_name_ = "no_run";
+    dispatch_kind_ = DispatchKind::kSkip;
+  }
+  //! Whether the finalized instruction calls a library, such as cublas or cudnn, by its name instead of its functions.
+  bool IsLibraryCall() const {
+    return dispatch_kind_ != DispatchKind::kLoweredFuncs && dispatch_kind_ != DispatchKind::kSkip;
+  }
+
+  /**
+   * Mark the kernels of the instruction as scalable by the batch: their blocks cover the batch-major outputs, whose
+   * leading dimension is \p compiled_batch_size, in order, so only the blocks of the rows of the actual batch, the
+   * leading dimension of \p batch_tensor on running, are launched.
+   */
+  void SetBatchScalable(const Tensor& batch_tensor, int compiled_batch_size) {
+    batch_tensor_        = batch_tensor;
+    compiled_batch_size_ = compiled_batch_size;
+  }
+  bool IsBatchScalable() const { return compiled_batch_size_ > 0; }
+  // the actual batch to run of the instruction scalable by the batch
+  int GetBatchSize() { return batch_tensor_->shape().data()[0]; }
+  void AddInArgs(const std::vector<std::string>& in_args) {
+    in_args_.push_back(in_args);
+    arg_slots_.clear();
+  }
+  void AddOutArgs(const std::vector<std::string>& out_args) {
+    out_args_.push_back(out_args);
+    arg_slots_.clear();
+  }
   std::vector<int> attrs;
   std::vector<std::string> str_attrs;
   bool pre_run = false;
@@ -131,18 +204,67 @@ class Instruction {
 
  protected:
   void CheckResults(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr, void* stream = nullptr);
+  // check the statistics of the outputs in the sampling mode of the self-check without synchronizing the stream
+  void SampleResults(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr, void* stream = nullptr);
 
  private:
+  // How Run calls the instruction, resolved once on Finalize from the function name and the target rather than
+  // comparing the name on every run. The library calls take the arguments of the first function.
+  enum class DispatchKind {
+    kLoweredFuncs,
+    kSkip,
+    kCublasGemm,
+    kCublasMatmul,
+    kCublasMul,
+    kCudnnConv2d,
+    kCudnnPool2d,
+    kCudnnSoftmax,
+  };
+  void ResolveDispatch();
+  void ResolveArgSlots();
+
+  void RunImpl(std::vector<std::vector<cinn_pod_value_t>>* args,
+               const std::map<std::string, cinn_pod_value_t>* name2podargs,
+               bool dryrun,
+               void* stream);
+  void RunLoweredFuncs(std::vector<std::vector<cinn_pod_value_t>>* all_args, bool dryrun, void* stream);
+#ifdef CINN_WITH_CUDA
+  // the launch arguments of the idx-th function prebuilt on the cached arguments, nullptr for the given arguments
+  runtime::cuda::KernelLaunchArgs* GetKernelLaunchArgs(std::vector<std::vector<cinn_pod_value_t>>* all_args, int idx);
+#endif
+
   bool finalized_flag_ = false;
   Scope* scope_{};
   std::string function_name_;
   std::vector<std::vector<std::string>> in_args_;
   std::vector<std::vector<std::string>> out_args_;
+  DispatchKind dispatch_kind_{DispatchKind::kLoweredFuncs};
+
+  // the distinct variables of the arguments, the slot of each argument of each function, and the (function, argument)
+  // indices of the uses of each slot, they are cleared when the arguments change and resolved again on use
+  std::vector<std::string> arg_names_;
+  // the ids in the scope of arg_names_, resolved on the first run from the scope
+  std::vector<int> arg_var_ids_;
+  std::vector<std::vector<int>> arg_slots_;
+  std::vector<std::vector<std::pair<int, int>>> slot_uses_;
 
   std::vector<std::vector<cinn_pod_value_t>> args_cached_;
+#ifdef CINN_WITH_CUDA
+  // the argument pointers of cuLaunchKernel bound to args_cached_, rebuilt with it
+  std::vector<runtime::cuda::KernelLaunchArgs> launch_args_cached_;
+#endif
 
   std::vector<void*> fn_ptrs_{};
   std::vector<std::string> fn_names_;
+
+  std::function<void(Instruction*)> compile_thunk_;
+  std::once_flag compile_once_;
+  std::atomic<bool> compiled_{false};
+
+  Tensor batch_tensor_;
+  int compiled_batch_size_{0};
+
+  std::atomic<int64_t> run_count_{0};
 };
 
 }  // namespace framework
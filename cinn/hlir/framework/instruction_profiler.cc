@@ -0,0 +1,273 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/instruction_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+#ifdef CINN_WITH_CUPTI
+// the metrics read by the fields of KernelCounters, which are followed by the ones of kWarpStallReasons
+const std::vector<std::string> kCounterMetrics = {
+    "gpu__time_duration.sum",
+    "dram__bytes.sum",
+    "sm__warps_active.avg.pct_of_peak_sustained_active",
+    "sm__throughput.avg.pct_of_peak_sustained_elapsed",
+    "lts__t_sector_hit_rate.pct",
+};
+
+const std::vector<std::string> kWarpStallReasons = {
+    "long_scoreboard",
+    "short_scoreboard",
+    "mio_throttle",
+    "lg_throttle",
+    "math_pipe_throttle",
+    "barrier",
+    "wait",
+    "no_instruction",
+};
+
+std::vector<std::string> CounterMetricNames() {
+  auto names = kCounterMetrics;
+  for (auto& reason : kWarpStallReasons) {
+    names.push_back("smsp__average_warps_issue_stalled_" + reason + "_per_issue_active.ratio");
+  }
+  return names;
+}
+
+KernelCounters ToKernelCounters(const runtime::cuda::KernelMetrics& metrics) {
+  CHECK_EQ(metrics.values.size(), kCounterMetrics.size() + kWarpStallReasons.size());
+  KernelCounters counters;
+  counters.kernel_name        = metrics.kernel_name;
+  counters.duration_ms        = metrics.values[0] * 1e-6;
+  counters.dram_bytes         = metrics.values[1];
+  counters.achieved_occupancy = metrics.values[2];
+  counters.sm_throughput      = metrics.values[3];
+  counters.l2_hit_rate        = metrics.values[4];
+  for (int i = 0; i < kWarpStallReasons.size(); ++i) {
+    counters.warp_stalls[kWarpStallReasons[i]] = metrics.values[kCounterMetrics.size() + i];
+  }
+  return counters;
+}
+#endif
+
+KernelCounters AggregateCounters(const std::vector<KernelCounters>& kernels) {
+  KernelCounters total;
+  for (auto& kernel : kernels) {
+    total.duration_ms += kernel.duration_ms;
+    total.dram_bytes += kernel.dram_bytes;
+  }
+  if (total.duration_ms <= 0.) return total;
+  for (auto& kernel : kernels) {
+    double weight = kernel.duration_ms / total.duration_ms;
+    total.achieved_occupancy += kernel.achieved_occupancy * weight;
+    total.sm_throughput += kernel.sm_throughput * weight;
+    total.l2_hit_rate += kernel.l2_hit_rate * weight;
+    for (auto& stall : kernel.warp_stalls) {
+      total.warp_stalls[stall.first] += stall.second * weight;
+    }
+  }
+  return total;
+}
+
+}  // namespace
+
+std::string ProfileReport::ToString(int top_k) const {
+  std::vector<int> order(instructions.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+    return instructions[a].total_ms > instructions[b].total_ms;
+  });
+  if (top_k > 0 && top_k < order.size()) {
+    order.resize(top_k);
+  }
+
+  std::stringstream ss;
+  ss << "Profile of " << instructions.size() << " instructions in " << num_runs << " runs, total " << std::fixed
+     << std::setprecision(3) << total_ms << " ms\n";
+  ss << std::setw(6) << "index" << std::setw(10) << "launches" << std::setw(14) << "total(ms)" << std::setw(12)
+     << "avg(ms)" << std::setw(10) << "ratio" << "  functions\n";
+  for (int index : order) {
+    auto& profile = instructions[index];
+    ss << std::setw(6) << index << std::setw(10) << profile.launch_count << std::setw(14) << profile.total_ms
+       << std::setw(12) << profile.avg_ms() << std::setw(9) << profile.ratio * 100 << "%  "
+       << utils::Join(profile.fn_names, ", ") << "\n";
+  }
+
+  if (std::none_of(instructions.begin(), instructions.end(), [](auto& profile) { return profile.has_counters(); })) {
+    return ss.str();
+  }
+  ss << "Hardware counters of the kernels\n";
+  ss << std::setw(6) << "index" << std::setw(10) << "kernels" << std::setw(12) << "time(ms)" << std::setw(12)
+     << "dram(MB)" << std::setw(11) << "occupancy" << std::setw(10) << "sm_thpt" << std::setw(10) << "l2_hit"
+     << "  top stall  functions\n";
+  for (int index : order) {
+    auto& profile = instructions[index];
+    if (!profile.has_counters()) continue;
+    auto& counters = profile.counters;
+    auto top_stall = std::max_element(counters.warp_stalls.begin(),
+                                      counters.warp_stalls.end(),
+                                      [](auto& a, auto& b) { return a.second < b.second; });
+    ss << std::setw(6) << index << std::setw(10) << profile.kernel_counters.size() << std::setw(12)
+       << counters.duration_ms << std::setw(12) << counters.dram_bytes / (1 << 20) << std::setw(10)
+       << counters.achieved_occupancy << "%" << std::setw(9) << counters.sm_throughput << "%" << std::setw(9)
+       << counters.l2_hit_rate << "%  ";
+    if (top_stall != counters.warp_stalls.end()) {
+      ss << top_stall->first << "(" << top_stall->second << ")  ";
+    }
+    ss << utils::Join(profile.fn_names, ", ") << "\n";
+  }
+  return ss.str();
+}
+
+InstructionProfiler::InstructionProfiler(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                                         bool collect_counters)
+    : instrs_(instrs),
+      launch_counts_(instrs.size(), 0),
+      times_ms_(instrs.size(), 0.),
+      start_events_(instrs.size(), nullptr),
+      end_events_(instrs.size(), nullptr),
+      collect_counters_(collect_counters),
+      kernel_counters_(instrs.size()) {
+  if (collect_counters_) {
+#ifdef CINN_WITH_CUPTI
+    counter_profiler_ = std::make_unique<runtime::cuda::CuptiRangeProfiler>(CounterMetricNames());
+#else
+    LOG(WARNING) << "CINN is not compiled with CUPTI, the hardware counters of the kernels are not collected";
+#endif
+  }
+#ifdef CINN_WITH_CUDA
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (instrs_[i]->target_.arch != Target::Arch::NVGPU) continue;
+    cudaEvent_t start, end;
+    CUDA_CALL(cudaEventCreate(&start));
+    CUDA_CALL(cudaEventCreate(&end));
+    start_events_[i] = start;
+    end_events_[i]   = end;
+  }
+#endif
+}
+
+InstructionProfiler::~InstructionProfiler() {
+#ifdef CINN_WITH_CUDA
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (start_events_[i]) cudaEventDestroy(static_cast<cudaEvent_t>(start_events_[i]));
+    if (end_events_[i]) cudaEventDestroy(static_cast<cudaEvent_t>(end_events_[i]));
+  }
+#endif
+}
+
+void InstructionProfiler::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                              void* stream,
+                              bool use_cache) {
+  if (collect_counters_ && !counters_collected_) {
+    CollectCounters(name2podargs, stream, use_cache);
+    counters_collected_ = true;
+    return;
+  }
+  utils::Timer timer;
+  for (int i = 0; i < instrs_.size(); ++i) {
+#ifdef CINN_WITH_CUDA
+    if (start_events_[i]) {
+      CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(start_events_[i]), static_cast<cudaStream_t>(stream)));
+      instrs_[i]->Run(name2podargs, false, stream, use_cache);
+      CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(end_events_[i]), static_cast<cudaStream_t>(stream)));
+      ++launch_counts_[i];
+      continue;
+    }
+#endif
+    timer.Start();
+    instrs_[i]->Run(name2podargs, false, stream, use_cache);
+    times_ms_[i] += timer.Stop();
+    ++launch_counts_[i];
+  }
+
+#ifdef CINN_WITH_CUDA
+  // the events are read after all the instructions are launched, so the launches are not serialized
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (!end_events_[i]) continue;
+    float elapsed_ms = 0.f;
+    CUDA_CALL(cudaEventSynchronize(static_cast<cudaEvent_t>(end_events_[i])));
+    CUDA_CALL(cudaEventElapsedTime(
+        &elapsed_ms, static_cast<cudaEvent_t>(start_events_[i]), static_cast<cudaEvent_t>(end_events_[i])));
+    times_ms_[i] += elapsed_ms;
+  }
+#endif
+  ++num_runs_;
+}
+
+void InstructionProfiler::CollectCounters(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                                          void* stream,
+                                          bool use_cache) {
+  for (int i = 0; i < instrs_.size(); ++i) {
+    kernel_counters_[i].clear();
+#ifdef CINN_WITH_CUPTI
+    if (instrs_[i]->target_.arch == Target::Arch::NVGPU) {
+      // a session per instruction attributes the kernels of the libraries called by it to it as well
+      counter_profiler_->Begin();
+      instrs_[i]->Run(name2podargs, false, stream, use_cache);
+      CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
+      for (auto& metrics : counter_profiler_->End()) {
+        kernel_counters_[i].emplace_back(ToKernelCounters(metrics));
+      }
+      continue;
+    }
+#endif
+    instrs_[i]->Run(name2podargs, false, stream, use_cache);
+  }
+}
+
+ProfileReport InstructionProfiler::GetReport() const {
+  ProfileReport report;
+  report.num_runs = num_runs_;
+  report.total_ms = std::accumulate(times_ms_.begin(), times_ms_.end(), 0.);
+  for (int i = 0; i < instrs_.size(); ++i) {
+    InstructionProfile profile;
+    profile.fn_names     = instrs_[i]->GetFnNames();
+    profile.launch_count = launch_counts_[i];
+    profile.total_ms     = times_ms_[i];
+    profile.ratio        = report.total_ms > 0. ? times_ms_[i] / report.total_ms : 0.;
+    if (!kernel_counters_[i].empty()) {
+      profile.kernel_counters = kernel_counters_[i];
+      profile.counters        = AggregateCounters(kernel_counters_[i]);
+    }
+    report.instructions.emplace_back(std::move(profile));
+  }
+  return report;
+}
+
+void InstructionProfiler::Reset() {
+  std::fill(launch_counts_.begin(), launch_counts_.end(), 0);
+  std::fill(times_ms_.begin(), times_ms_.end(), 0.);
+  num_runs_           = 0;
+  counters_collected_ = false;
+  for (auto& counters : kernel_counters_) {
+    counters.clear();
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,117 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/instruction.h"
+#ifdef CINN_WITH_CUPTI
+#include "cinn/runtime/cuda/cupti_profiler.h"
+#endif
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// the hardware counters of the kernels collected by CUPTI
+struct KernelCounters {
+  // empty for the aggregation of all the kernels of an instruction
+  std::string kernel_name;
+  double duration_ms{0.};
+  double dram_bytes{0.};
+  // the percentages of the peak, which are weighted by the durations of the kernels in the aggregation
+  double achieved_occupancy{0.};
+  double sm_throughput{0.};
+  double l2_hit_rate{0.};
+  // the average number of the warps stalled by each reason per issued instruction
+  std::map<std::string, double> warp_stalls;
+};
+
+struct InstructionProfile {
+  // the names of the fused functions run by the instruction
+  std::vector<std::string> fn_names;
+  int64_t launch_count{0};
+  double total_ms{0.};
+  // the share of the total time of all the instructions
+  double ratio{0.};
+  // the counters of the whole instruction and of each kernel launched by it, only collected in the counter mode
+  KernelCounters counters;
+  std::vector<KernelCounters> kernel_counters;
+
+  double avg_ms() const { return launch_count ? total_ms / launch_count : 0.; }
+  bool has_counters() const { return !kernel_counters.empty(); }
+};
+
+struct ProfileReport {
+  // in the order of the instructions
+  std::vector<InstructionProfile> instructions;
+  int64_t num_runs{0};
+  double total_ms{0.};
+
+  //! A table of the instructions sorted by the total time, only the top \p top_k ones are listed if it is positive.
+  //! The hardware counters are listed in another table in the same order if they are collected.
+  std::string ToString(int top_k = 0) const;
+};
+
+/**
+ * InstructionProfiler runs the instructions one by one and records the wall time of each one, which is measured by
+ * CUDA events on NVGPU and by utils::Timer on host.
+ *
+ * In the counter mode, the first run after the construction or Reset collects the hardware counters of the kernels of
+ * each instruction on NVGPU by the CUPTI range profiling instead of timing them. The kernels are replayed by CUPTI,
+ * which is much slower than a normal run, so the run is not counted in the times. It requires building with
+ * WITH_CUPTI, otherwise no counter is collected.
+ */
+class InstructionProfiler {
+ public:
+  explicit InstructionProfiler(const std::vector<std::unique_ptr<Instruction>>& instrs, bool collect_counters = false);
+  ~InstructionProfiler();
+
+  void Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+
+  ProfileReport GetReport() const;
+
+  void Reset();
+
+  bool collect_counters() const { return collect_counters_; }
+
+ private:
+  void CollectCounters(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+
+  const std::vector<std::unique_ptr<Instruction>>& instrs_;
+  std::vector<int64_t> launch_counts_;
+  std::vector<double> times_ms_;
+  int64_t num_runs_{0};
+  // cudaEvent_t around each instruction running on NVGPU
+  std::vector<void*> start_events_;
+  std::vector<void*> end_events_;
+  bool collect_counters_;
+  bool counters_collected_{false};
+  // the counters of each kernel in the order of the instructions
+  std::vector<std::vector<KernelCounters>> kernel_counters_;
+#ifdef CINN_WITH_CUPTI
+  std::unique_ptr<runtime::cuda::CuptiRangeProfiler> counter_profiler_;
+#endif
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(InstructionProfiler);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/instruction_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+template <int sleep_ms>
+void SleepFunc(void* v_args, int32_t num_args) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+}
+
+TEST(InstructionProfiler, Host) {
+  Scope scope;
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::string& fn_name, void* fn) {
+    instrs.emplace_back(std::make_unique<Instruction>(
+        common::DefaultHostTarget(), &scope, std::vector<std::string>{}, std::vector<std::string>{}, fn_name));
+    instrs.back()->SetLoweredFunc(fn, fn_name);
+    instrs.back()->Finalize();
+  };
+  add_instr("fn_fast", reinterpret_cast<void*>(&SleepFunc<1>));
+  add_instr("fn_slow", reinterpret_cast<void*>(&SleepFunc<10>));
+
+  InstructionProfiler profiler(instrs);
+  for (int i = 0; i < 3; ++i) {
+    profiler.Run(nullptr, nullptr, true);
+  }
+  auto report = profiler.GetReport();
+  ASSERT_EQ(report.num_runs, 3);
+  ASSERT_EQ(report.instructions.size(), 2UL);
+  ASSERT_EQ(report.instructions[1].fn_names, std::vector<std::string>({"fn_slow"}));
+  ASSERT_EQ(report.instructions[1].launch_count, 3);
+  ASSERT_GE(report.instructions[1].total_ms, 30.);
+  ASSERT_GT(report.instructions[1].ratio, report.instructions[0].ratio);
+  ASSERT_NEAR(report.instructions[0].ratio + report.instructions[1].ratio, 1., 1e-6);
+  // the slowest one is listed first
+  auto table = report.ToString(1);
+  ASSERT_NE(table.find("fn_slow"), std::string::npos);
+  ASSERT_EQ(table.find("fn_fast"), std::string::npos);
+
+  profiler.Reset();
+  ASSERT_EQ(profiler.GetReport().num_runs, 0);
+  ASSERT_EQ(profiler.GetReport().total_ms, 0.);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
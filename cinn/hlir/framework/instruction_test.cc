@@ -96,6 +96,40 @@ TEST(Instruction, basic) {
   }
 }
 
+TEST(Instruction, LazyCompile) {
+  const int M = 10;
+  const int N = 20;
+
+  Scope scope;
+  InstantiateScope(M, N, &scope);
+  // the arguments are given by the compile thunk
+  Instruction instr(common::DefaultHostTarget(), &scope, {}, {}, "fn");
+  std::unique_ptr<backends::SimpleJIT> jit;
+  int num_compiled = 0;
+  instr.SetCompileThunk([&](Instruction* instr) {
+    ++num_compiled;
+    jit = GetLoweredFunc(M, N);
+    instr->ClearInArgs();
+    instr->ClearOutArgs();
+    instr->AddInArgs({"x", "y"});
+    instr->AddOutArgs({"z"});
+    instr->SetLoweredFunc(reinterpret_cast<void*>(jit->Lookup("fn")), "fn");
+    instr->Finalize();
+  });
+  ASSERT_FALSE(instr.IsCompiled());
+  instr.Run();
+  instr.Run();
+  ASSERT_TRUE(instr.IsCompiled());
+  ASSERT_EQ(num_compiled, 1);
+
+  auto* xd = scope.GetTensor("x")->data<float>();
+  auto* yd = scope.GetTensor("y")->data<float>();
+  auto* zd = scope.GetTensor("z")->data<float>();
+  for (int i = 0; i < M * N; i++) {
+    ASSERT_NEAR(xd[i] + yd[i], zd[i], 1e-5);
+  }
+}
+
 TEST(Instruction, RunWithRawPodArgs) {
   const int M       = 10;
   const int N       = 20;
@@ -155,6 +189,32 @@ TEST(Instruction, RunWithRawPodArgs) {
   check_equal_by_element();
 }
 
+TEST(Instruction, PatchArg) {
+  const int M = 10;
+  const int N = 20;
+
+  Scope scope;
+  InstantiateScope(M, N, &scope);
+  // x is taken twice, so both of its arguments are patched
+  Instruction instr(common::DefaultHostTarget(), &scope, {"x", "x"}, {"z"});
+  auto jit    = GetLoweredFunc(M, N);
+  auto fn_ptr = jit->Lookup("fn");
+  CHECK(fn_ptr);
+  instr.SetLoweredFunc(reinterpret_cast<void*>(fn_ptr));
+  instr.Finalize();
+  ASSERT_EQ(instr.GetArgNames(), std::vector<std::string>({"x", "z"}));
+
+  // feed the buffer of y as x without rebuilding the arguments from the scope
+  instr.PatchArg(0, cinn_pod_value_t(scope.GetTensor("y")->buffer()));
+  instr.Run();
+
+  auto* yd = scope.GetTensor("y")->data<float>();
+  auto* zd = scope.GetTensor("z")->data<float>();
+  for (int i = 0; i < M * N; i++) {
+    ASSERT_NEAR(yd[i] + yd[i], zd[i], 1e-5);
+  }
+}
+
 #ifdef CINN_WITH_CUDNN
 
 class TestInstruction : public Instruction {
@@ -0,0 +1,186 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_stitcher.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "cinn/ir/ir_operators.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/runtime/intrinsic.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+// the max bytes of the static shared memory of a CUDA kernel
+constexpr int kMaxStaticSharedMemBytes = 48 * 1024;
+
+int GetStaticSharedMemBytes(const ir::LoweredFunc& func) {
+  int total_bytes = 0;
+  for (auto& temp_buf : func->temp_bufs) {
+    if (temp_buf->memory_type != ir::MemoryType::GPUShared || temp_buf->shape.empty() || temp_buf->type() == Void()) {
+      continue;
+    }
+    int bytes = temp_buf->dtype.bytes();
+    for (auto& dim : temp_buf->shape) {
+      if (!dim.is_constant()) {
+        return -1;
+      }
+      bytes *= dim.as_int32();
+    }
+    total_bytes += bytes;
+  }
+  return total_bytes;
+}
+
+int GetGridBlocks(const ir::CudaAxisInfo& info) { return info.grid_dim(0) * info.grid_dim(1) * info.grid_dim(2); }
+}  // namespace
+
+bool KernelStitcher::IsStitchable(const ir::LoweredFunc& func) const {
+  // the external calls, such as cublas, are not generated kernels
+  if (!func->body.defined() || func->body.As<ir::Call>()) {
+    return false;
+  }
+  auto& info = func->cuda_axis_info;
+  if (!info.valid() || info.cooperative() || GetGridBlocks(info) > max_grid_blocks_) {
+    return false;
+  }
+  if (func->CudaDynamicSharedMemBytes() > 0) {
+    return false;
+  }
+  int shared_mem_bytes = GetStaticSharedMemBytes(func);
+  return shared_mem_bytes >= 0 && shared_mem_bytes <= kMaxStaticSharedMemBytes;
+}
+
+bool KernelStitcher::CanAppend(const ir::LoweredFunc& func) const {
+  if (!IsStitchable(func)) {
+    return false;
+  }
+  if (funcs_.empty()) {
+    return true;
+  }
+  auto& first = funcs_.front()->cuda_axis_info;
+  auto& info  = func->cuda_axis_info;
+  for (int i = 0; i < 3; ++i) {
+    if (first.block_dim(i) != info.block_dim(i)) {
+      return false;
+    }
+  }
+  for (auto& temp_buf : func->temp_bufs) {
+    if (temp_buf_names_.count(temp_buf->name)) {
+      return false;
+    }
+  }
+  return shared_mem_bytes_ + GetStaticSharedMemBytes(func) <= kMaxStaticSharedMemBytes;
+}
+
+void KernelStitcher::Append(const ir::LoweredFunc& func, const std::vector<std::string>& arg_names) {
+  CHECK(CanAppend(func)) << "The kernel " << func->name << " can't be stitched";
+  CHECK_EQ(func->args.size(), arg_names.size()) << "The arguments of " << func->name << " mismatch its variables";
+  funcs_.push_back(func);
+  arg_names_.push_back(arg_names);
+  for (auto& temp_buf : func->temp_bufs) {
+    temp_buf_names_.insert(temp_buf->name);
+  }
+  shared_mem_bytes_ += GetStaticSharedMemBytes(func);
+}
+
+ir::LoweredFunc KernelStitcher::Build(const std::string& name,
+                                      std::vector<std::string>* input_names,
+                                      std::vector<std::string>* output_names) const {
+  CHECK(!funcs_.empty()) << "No kernel is appended to stitch";
+  CHECK(input_names && output_names);
+  input_names->clear();
+  output_names->clear();
+
+  // the arguments of the same buffer are shared by the stages, which is an output if any stage writes it
+  std::vector<ir::Argument> args;
+  std::vector<std::string> var_names;
+  std::unordered_map<std::string, int> arg_index;
+  for (int i = 0; i < funcs_.size(); ++i) {
+    auto& func_args = funcs_[i]->args;
+    for (int j = 0; j < func_args.size(); ++j) {
+      auto it = arg_index.find(func_args[j].name());
+      if (it == arg_index.end()) {
+        arg_index.emplace(func_args[j].name(), args.size());
+        args.push_back(func_args[j]);
+        var_names.push_back(arg_names_[i][j]);
+      } else if (func_args[j].is_output()) {
+        args[it->second].io = ir::Argument::IO::kOutput;
+      }
+    }
+  }
+  // the output arguments are in the tail
+  std::vector<ir::Argument> sorted_args;
+  for (int i = 0; i < args.size(); ++i) {
+    if (args[i].is_input()) {
+      sorted_args.push_back(args[i]);
+      input_names->push_back(var_names[i]);
+    }
+  }
+  for (int i = 0; i < args.size(); ++i) {
+    if (args[i].is_output()) {
+      sorted_args.push_back(args[i]);
+      output_names->push_back(var_names[i]);
+    }
+  }
+
+  ir::CudaAxisInfo axis_info = funcs_.front()->cuda_axis_info;
+  std::vector<ir::Buffer> temp_bufs;
+  for (auto& func : funcs_) {
+    axis_info.ExtendWith(func->cuda_axis_info);
+    temp_bufs.insert(temp_bufs.end(), func->temp_bufs.begin(), func->temp_bufs.end());
+  }
+  axis_info.set_cooperative(true);
+
+  // each stage is run by the blocks within its own grid, and the grid-wide barrier separates it from the next stage
+  static const char* block_idx_names[] = {"blockIdx.x", "blockIdx.y", "blockIdx.z"};
+  std::vector<Expr> stages;
+  for (auto& func : funcs_) {
+    if (!stages.empty()) {
+      stages.push_back(runtime::IntrinsicCall(Void(), runtime::intrinsic::cuda_grid_sync, {}));
+    }
+    Expr cond;
+    for (int i = 0; i < 3; ++i) {
+      int grid_dim = func->cuda_axis_info.grid_dim(i);
+      if (grid_dim == axis_info.grid_dim(i)) {
+        continue;
+      }
+      Expr in_grid = ir::LT::Make(ir::Var(block_idx_names[i]), Expr(grid_dim));
+      cond         = cond.defined() ? ir::And::Make(cond, in_grid) : in_grid;
+    }
+    Expr body = optim::IRCopy(func->body);
+    // the nested blocks are flattened by the codegen, so a stage is always scoped by a condition
+    stages.push_back(ir::IfThenElse::Make(cond.defined() ? cond : Expr(true), body));
+  }
+
+  auto stitched_func            = ir::_LoweredFunc_::Make(name, sorted_args, ir::Block::Make(stages), temp_bufs);
+  stitched_func->cuda_axis_info = axis_info;
+  VLOG(3) << "Stitch " << funcs_.size() << " kernels into " << name << " " << axis_info;
+  return stitched_func;
+}
+
+void KernelStitcher::Clear() {
+  funcs_.clear();
+  arg_names_.clear();
+  temp_buf_names_.clear();
+  shared_mem_bytes_ = 0;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/ir/lowered_func.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * Stitch the CUDA kernels of the consecutive fusion groups into one cooperative persistent kernel, which saves the
+ * launch of each kernel for the small graphs whose kernels run only a few microseconds.
+ *
+ * The kernels are run one after another as the stages of the stitched kernel, whose grid covers the largest grid of
+ * them, and each stage is run by the blocks within its own grid. A grid-wide barrier between the stages makes the
+ * outputs of a stage visible to the later ones, so all the blocks have to be resident on the device at the same time,
+ * which is guaranteed by the cooperative launch with the grid no larger than \p max_grid_blocks. Only the kernels of
+ * the same block are stitched, so that the __syncthreads in a stage are reached by all the threads of a block.
+ */
+class KernelStitcher {
+ public:
+  explicit KernelStitcher(int max_grid_blocks) : max_grid_blocks_(max_grid_blocks) {}
+
+  //! Whether \p func is a kernel that can be stitched.
+  bool IsStitchable(const ir::LoweredFunc& func) const;
+  //! Whether \p func can be stitched after the kernels appended so far.
+  bool CanAppend(const ir::LoweredFunc& func) const;
+  //! Append \p func as the next stage, \p arg_names are the variables of its arguments in order.
+  void Append(const ir::LoweredFunc& func, const std::vector<std::string>& arg_names);
+
+  /**
+   * Build the stitched kernel named \p name from the appended kernels, and get the variables of its input and output
+   * arguments in order. A variable written by any stage is an output.
+   */
+  ir::LoweredFunc Build(const std::string& name,
+                        std::vector<std::string>* input_names,
+                        std::vector<std::string>* output_names) const;
+
+  int size() const { return funcs_.size(); }
+  void Clear();
+
+ private:
+  int max_grid_blocks_;
+  std::vector<ir::LoweredFunc> funcs_;
+  std::vector<std::vector<std::string>> arg_names_;
+  std::unordered_set<std::string> temp_buf_names_;
+  int shared_mem_bytes_{0};
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
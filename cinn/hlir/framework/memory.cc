@@ -14,12 +14,30 @@
 
 #include "cinn/hlir/framework/memory.h"
 
+#include <gflags/gflags.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/caching_allocator.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+
 #ifdef CINN_WITH_CUDA
 #include <cuda.h>
 #include <cuda_runtime.h>
 
 #include "cinn/backends/cuda_util.h"
 #endif
+#ifdef CINN_WITH_ROCM
+#include <hip/hip_runtime.h>
+
+#include "cinn/runtime/hip/hip_util.h"
+#endif
+
+DECLARE_bool(cinn_use_cuda_caching_allocator);
+DECLARE_int64(cinn_cuda_allocator_max_bytes);
 
 namespace cinn {
 namespace hlir {
@@ -29,14 +47,50 @@ using common::Target;
 
 namespace {
 
+// the host buffers smaller than it are left to be placed by the kernel touching them first
+constexpr size_t kNumaFirstTouchBytes = 4UL << 20;
+
+struct FirstTouchArgs {
+  char* data;
+  size_t nbytes;
+  size_t page_bytes;
+};
+
+int FirstTouchTask(int task_id, int num_task, void* datas) {
+  auto* args   = static_cast<FirstTouchArgs*>(datas);
+  size_t chunk = (args->nbytes + num_task - 1) / num_task;
+  size_t begin = std::min(chunk * task_id, args->nbytes);
+  size_t end   = std::min(begin + chunk, args->nbytes);
+  for (size_t i = begin; i < end; i += args->page_bytes) {
+    args->data[i] = 0;
+  }
+  return 0;
+}
+
 class X86MemoryMng : public MemoryInterface {
  public:
-  void* malloc(size_t nbytes) override { return ::malloc(nbytes); }
+  void* malloc(size_t nbytes) override { return FirstTouch(::malloc(nbytes), nbytes); }
   void free(void* data) override {
     if (!data) return;
     ::free(data);
   }
-  void* aligned_alloc(size_t alignment, size_t nbytes) override { return ::aligned_alloc(alignment, nbytes); }
+  void* aligned_alloc(size_t alignment, size_t nbytes) override {
+    return FirstTouch(::aligned_alloc(alignment, nbytes), nbytes);
+  }
+
+ private:
+  // On a multi-socket host, the pages of a large buffer are touched by all the workers in the same contiguous
+  // partition as the parallel loops of the host kernels, so that the linux first-touch policy places each page on
+  // the NUMA node of the worker processing it, instead of all on the node of the thread allocating the buffer.
+  static void* FirstTouch(void* data, size_t nbytes) {
+    static const bool multi_node = common::DefaultHostTarget().cpu_info().num_numa_nodes > 1;
+    if (data == nullptr || nbytes < kNumaFirstTouchBytes || !multi_node) {
+      return data;
+    }
+    FirstTouchArgs args{static_cast<char*>(data), nbytes, static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+    cinn_backend_parallel_launch(&FirstTouchTask, &args, 0);
+    return data;
+  }
 };
 
 #ifdef CINN_WITH_CUDA
@@ -51,15 +105,136 @@ class CudaMemoryMng : public MemoryInterface {
   void free(void* data) override { CUDA_CALL(cudaFree(data)); }
 };
 
+// Serve the device memory from a CachingAllocator, so that the malloc/free instructions inserted between the kernels
+// don't synchronize the device by cudaFree.
+class CudaCachingMemoryMng : public MemoryInterface {
+ public:
+  CudaCachingMemoryMng()
+      : allocator_(
+            [](size_t nbytes) -> void* {
+              void* data = nullptr;
+              if (cudaMalloc(&data, nbytes) != cudaSuccess) {
+                // clear the error so that the allocator can retry after releasing the cached memory
+                cudaGetLastError();
+                return nullptr;
+              }
+              return data;
+            },
+            [](void* data) { CUDA_CALL(cudaFree(data)); },
+            FLAGS_cinn_cuda_allocator_max_bytes > 0 ? FLAGS_cinn_cuda_allocator_max_bytes : 0) {}
+
+  void* malloc(size_t nbytes) override { return allocator_.Allocate(nbytes); }
+
+  void free(void* data) override { allocator_.Free(data); }
+
+  size_t ReleaseCachedMemory() override { return allocator_.ReleaseCached(); }
+
+  size_t ReservedBytes() override { return allocator_.GetStats().reserved_bytes; }
+
+ private:
+  CachingAllocator allocator_;
+};
+
 #endif
 
+#ifdef CINN_WITH_ROCM
+class HipMemoryMng : public MemoryInterface {
+ public:
+  void* malloc(size_t nbytes) override {
+    void* data;
+    HIP_CALL(hipMalloc(&data, nbytes));
+    return data;
+  }
+
+  void free(void* data) override { HIP_CALL(hipFree(data)); }
+};
+
+#endif
+
+// the instruction running on the calling thread, whose allocations are attributed to
+thread_local const std::string* current_instruction = nullptr;
+
 }  // namespace
 
+std::string MemoryStats::DebugString() const {
+  std::stringstream ss;
+  ss << "live_bytes=" << live_bytes << ", peak_bytes=" << peak_bytes << ", num_allocs=" << num_allocs
+     << ", num_frees=" << num_frees << ", reserved_bytes=" << reserved_bytes << ", fragmentation=" << fragmentation;
+  for (auto& item : instruction_allocs) {
+    ss << "\n  " << item.first << ": num_allocs=" << item.second.num_allocs << ", bytes=" << item.second.bytes;
+  }
+  return ss.str();
+}
+
+void MemoryManager::RecordAlloc(key_t key, size_t nbytes) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  auto& stats = stats_[key];
+  stats.live_bytes += nbytes;
+  stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+  stats.num_allocs++;
+  if (current_instruction) {
+    auto& allocs = stats.instruction_allocs[*current_instruction];
+    allocs.num_allocs++;
+    allocs.bytes += nbytes;
+  }
+}
+
+void MemoryManager::RecordFree(key_t key, size_t nbytes) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  auto& stats = stats_[key];
+  // the memory allocated before the stats are tracked may be freed
+  stats.live_bytes -= std::min(stats.live_bytes, nbytes);
+  stats.num_frees++;
+}
+
+MemoryStats MemoryManager::GetStats(key_t key) {
+  MemoryStats stats;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto it = stats_.find(key);
+    if (it != stats_.end()) {
+      stats = it->second;
+    }
+  }
+  auto* mng = Retrieve(key);
+  if (mng) {
+    stats.reserved_bytes = mng->ReservedBytes();
+  }
+  if (stats.reserved_bytes > stats.live_bytes) {
+    stats.fragmentation = 1.0 - static_cast<double>(stats.live_bytes) / stats.reserved_bytes;
+  }
+  return stats;
+}
+
+void MemoryManager::ResetPeakStats(key_t key) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  auto& stats      = stats_[key];
+  stats.peak_bytes = stats.live_bytes;
+  stats.num_allocs = 0;
+  stats.num_frees  = 0;
+  stats.instruction_allocs.clear();
+}
+
+MemoryManager::ScopedInstructionAllocs::ScopedInstructionAllocs(const std::string* name)
+    : prev_name_(current_instruction) {
+  current_instruction = name;
+}
+
+MemoryManager::ScopedInstructionAllocs::~ScopedInstructionAllocs() { current_instruction = prev_name_; }
+
 MemoryManager::MemoryManager() {
   Register(Target::Arch::Unk, new X86MemoryMng);
   Register(Target::Arch::X86, new X86MemoryMng);
+  Register(Target::Arch::ARM, new X86MemoryMng);
 #ifdef CINN_WITH_CUDA
-  Register(Target::Arch::NVGPU, new CudaMemoryMng);
+  if (FLAGS_cinn_use_cuda_caching_allocator) {
+    Register(Target::Arch::NVGPU, new CudaCachingMemoryMng);
+  } else {
+    Register(Target::Arch::NVGPU, new CudaMemoryMng);
+  }
+#endif
+#ifdef CINN_WITH_ROCM
+  Register(Target::Arch::AMDGPU, new HipMemoryMng);
 #endif
 }
 
@@ -17,7 +17,10 @@
 #include <absl/container/flat_hash_map.h>
 #include <glog/logging.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include "cinn/common/macros.h"
 #include "cinn/common/target.h"
@@ -31,9 +34,38 @@ class MemoryInterface {
   virtual void* malloc(size_t nbytes) = 0;
   virtual void free(void* data)       = 0;
   virtual void* aligned_alloc(size_t alignment, size_t nbytes) { return nullptr; }
+  //! Return the memory cached by the implementation to the device, and return the number of released bytes.
+  virtual size_t ReleaseCachedMemory() { return 0; }
+  //! The number of bytes held from the device by the implementation, including the cached memory, 0 if not cached.
+  virtual size_t ReservedBytes() { return 0; }
   virtual ~MemoryInterface() {}
 };
 
+/**
+ * The memory allocated by the Buffers on an architecture, the memory owned by others, such as the external memory
+ * of a Buffer, is not counted.
+ */
+struct MemoryStats {
+  struct InstructionAllocs {
+    size_t num_allocs{0};
+    size_t bytes{0};
+  };
+
+  // the bytes in use and the high-water mark of them since the last reset
+  size_t live_bytes{0};
+  size_t peak_bytes{0};
+  size_t num_allocs{0};
+  size_t num_frees{0};
+  // the bytes held from the device by the memory manager, including the cached ones, 0 if the memory is not cached
+  size_t reserved_bytes{0};
+  // the fraction of the reserved bytes not in use, 0 if the memory is not cached
+  double fragmentation{0.0};
+  // the allocations made while running each instruction, by the function name of the instruction
+  std::map<std::string, InstructionAllocs> instruction_allocs;
+
+  std::string DebugString() const;
+};
+
 /**
  * MemoryManager holds a map of MemoryInterface for each articture.
  */
@@ -64,10 +96,43 @@ class MemoryManager final {
     return item;
   }
 
+  //! Release the cached memory of all the architectures.
+  size_t ReleaseCachedMemory() {
+    size_t released = 0;
+    for (auto& item : memory_mngs_) {
+      released += item.second->ReleaseCachedMemory();
+    }
+    return released;
+  }
+
+  //! Record the allocation and the free of \p nbytes on \p key, which are called by the Buffers.
+  void RecordAlloc(key_t key, size_t nbytes);
+  void RecordFree(key_t key, size_t nbytes);
+
+  MemoryStats GetStats(key_t key);
+
+  //! Reset the peak to the bytes in use now and clear the counts, to measure the high-water mark of a period.
+  void ResetPeakStats(key_t key);
+
+  /**
+   * Attribute the allocations made by the calling thread in the scope to the instruction named \p name, such as the
+   * buffers allocated by the malloc instructions.
+   */
+  class ScopedInstructionAllocs {
+   public:
+    explicit ScopedInstructionAllocs(const std::string* name);
+    ~ScopedInstructionAllocs();
+
+   private:
+    const std::string* prev_name_;
+  };
+
  private:
   MemoryManager();
 
   absl::flat_hash_map<common::Target::Arch, std::unique_ptr<MemoryInterface>> memory_mngs_;
+  absl::flat_hash_map<common::Target::Arch, MemoryStats> stats_;
+  std::mutex stats_mutex_;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(MemoryManager);
 };
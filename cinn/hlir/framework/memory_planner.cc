@@ -0,0 +1,218 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_set>
+#include <utility>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+void VariableLifeTime::Use(const std::string& name, int step) {
+  auto it = life_times_.find(name);
+  if (it == life_times_.end()) {
+    life_times_.emplace(name, std::make_pair(step, step));
+  } else {
+    CHECK_GE(step, it->second.second) << "The steps using variable [" << name << "] should be in ascending order";
+    it->second.second = step;
+  }
+  auto& steps = use_steps_[name];
+  if (steps.empty() || steps.back() != step) {
+    steps.push_back(step);
+  }
+}
+
+void VariableLifeTime::Reset(const std::string& name, int first_step, int last_step) {
+  CHECK_LE(first_step, last_step) << "The life time of variable [" << name << "] is invalid";
+  life_times_[name] = std::make_pair(first_step, last_step);
+}
+
+size_t VariableLifeTime::EstimatePeakBytes(const absl::flat_hash_map<std::string, size_t>& sizes,
+                                           int* peak_step) const {
+  // sweep the steps with the bytes allocated at the first step and freed after the last step of each variable
+  std::map<int, int64_t> deltas;
+  for (auto& item : life_times_) {
+    auto it = sizes.find(item.first);
+    if (it == sizes.end() || it->second == 0) continue;
+    deltas[item.second.first] += it->second;
+    deltas[item.second.second + 1] -= it->second;
+  }
+  int64_t held = 0, peak = 0;
+  int step     = -1;
+  for (auto& delta : deltas) {
+    held += delta.second;
+    if (held > peak) {
+      peak = held;
+      step = delta.first;
+    }
+  }
+  if (peak_step) {
+    *peak_step = step;
+  }
+  return peak;
+}
+
+void MemoryPlanner::AddVariable(const std::string& name, size_t nbytes, int first_step, int last_step) {
+  CHECK_LE(first_step, last_step) << "The life time of variable [" << name << "] is invalid";
+  size_t aligned = (nbytes + alignment_ - 1) / alignment_ * alignment_;
+  items_.push_back({name, aligned, first_step, last_step});
+}
+
+MemoryPlan MemoryPlanner::Plan() const {
+  std::vector<const Item*> order;
+  order.reserve(items_.size());
+  for (auto& item : items_) {
+    order.push_back(&item);
+  }
+  // the larger variables are placed first, and the tie is broken by the life time to make the plan stable
+  std::sort(order.begin(), order.end(), [](const Item* a, const Item* b) {
+    if (a->nbytes != b->nbytes) return a->nbytes > b->nbytes;
+    if (a->first_step != b->first_step) return a->first_step < b->first_step;
+    return a->name < b->name;
+  });
+
+  MemoryPlan plan;
+  std::vector<std::pair<const Item*, size_t>> placed;
+  for (const Item* item : order) {
+    // collect the memory ranges occupied by the placed variables alive at the same time
+    std::vector<std::pair<size_t, size_t>> occupied;
+    for (auto& p : placed) {
+      if (p.first->first_step <= item->last_step && item->first_step <= p.first->last_step) {
+        occupied.emplace_back(p.second, p.second + p.first->nbytes);
+      }
+    }
+    std::sort(occupied.begin(), occupied.end());
+
+    // find the smallest gap which can hold the variable, or append it at the end of the occupied memory
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap    = std::numeric_limits<size_t>::max();
+    size_t cursor      = 0;
+    for (auto& range : occupied) {
+      if (range.first > cursor) {
+        size_t gap = range.first - cursor;
+        if (gap >= item->nbytes && gap < best_gap) {
+          best_gap    = gap;
+          best_offset = cursor;
+        }
+      }
+      cursor = std::max(cursor, range.second);
+    }
+    if (best_offset == std::numeric_limits<size_t>::max()) {
+      best_offset = cursor;
+    }
+
+    placed.emplace_back(item, best_offset);
+    plan.offsets[item->name] = best_offset;
+    plan.sizes[item->name]   = item->nbytes;
+    plan.arena_bytes         = std::max(plan.arena_bytes, best_offset + item->nbytes);
+    plan.total_bytes += item->nbytes;
+  }
+  VLOG(3) << "MemoryPlanner packs " << items_.size() << " variables of " << plan.total_bytes << " bytes into an arena of "
+          << plan.arena_bytes << " bytes";
+  return plan;
+}
+
+SwapPlanner::SwapPlanner(std::vector<double> step_us, double host_gbps)
+    : step_us_(std::move(step_us)), host_gbps_(host_gbps) {
+  CHECK_GT(host_gbps_, 0.) << "The bandwidth between the host and the device should be positive";
+}
+
+void SwapPlanner::AddVariable(const std::string& name,
+                              size_t nbytes,
+                              const std::vector<int>& use_steps,
+                              bool swappable) {
+  CHECK(!use_steps.empty()) << "The variable [" << name << "] is not used by any step";
+  CHECK(std::is_sorted(use_steps.begin(), use_steps.end())) << "The steps using [" << name << "] should be ascending";
+  CHECK_LT(use_steps.back(), step_us_.size()) << "The variable [" << name << "] is used out of the steps";
+  items_.push_back({name, nbytes, use_steps, swappable});
+}
+
+bool SwapPlanner::FindSwapSteps(const Item& item, int last_use, int next_use, SwapItem* swap) const {
+  // the time in microseconds of copying the variable in one direction, GB/s is 1e3 bytes per microsecond
+  double copy_us = item.nbytes / (host_gbps_ * 1e3);
+  int release    = last_use;
+  double elapsed = 0.;
+  while (elapsed < copy_us && release + 1 < next_use) {
+    elapsed += step_us_[++release];
+  }
+  if (elapsed < copy_us) return false;
+  int swap_in = next_use;
+  elapsed     = 0.;
+  while (elapsed < copy_us && swap_in - 1 > release) {
+    elapsed += step_us_[--swap_in];
+  }
+  // at least one step should run without the variable
+  if (elapsed < copy_us || swap_in <= release + 1) return false;
+  *swap = {item.name, item.nbytes, last_use, release, swap_in, next_use};
+  return true;
+}
+
+SwapPlan SwapPlanner::Plan(size_t budget_bytes) const {
+  VariableLifeTime life_time;
+  absl::flat_hash_map<std::string, size_t> sizes;
+  for (auto& item : items_) {
+    life_time.Reset(item.name, item.use_steps.front(), item.use_steps.back());
+    sizes[item.name] = item.nbytes;
+  }
+  SwapPlan plan;
+  int peak_step          = -1;
+  size_t peak            = life_time.EstimatePeakBytes(sizes, &peak_step);
+  plan.peak_bytes_before = peak;
+  std::unordered_set<std::string> swapped;
+  while (peak > budget_bytes) {
+    // the largest variable held across the peak step whose gap spanning it hides the copies, the tie is broken by the
+    // name to make the plan stable
+    const Item* best = nullptr;
+    SwapItem best_swap;
+    for (auto& item : items_) {
+      if (!item.swappable || item.nbytes == 0 || swapped.count(item.name)) continue;
+      if (best && (item.nbytes < best->nbytes || (item.nbytes == best->nbytes && item.name > best->name))) continue;
+      auto next = std::upper_bound(item.use_steps.begin(), item.use_steps.end(), peak_step);
+      if (next == item.use_steps.begin() || next == item.use_steps.end()) continue;
+      SwapItem swap;
+      if (FindSwapSteps(item, *(next - 1), *next, &swap) && swap.release_step < peak_step &&
+          peak_step < swap.swap_in_step) {
+        best      = &item;
+        best_swap = swap;
+      }
+    }
+    if (!best) break;
+    swapped.insert(best->name);
+    // the variable is held again from the swap in, which is counted as another variable
+    life_time.Reset(best->name, best->use_steps.front(), best_swap.release_step);
+    life_time.Reset(best->name + "@SWAP", best_swap.swap_in_step, best->use_steps.back());
+    sizes[best->name + "@SWAP"] = best->nbytes;
+    plan.items.push_back(best_swap);
+    peak = life_time.EstimatePeakBytes(sizes, &peak_step);
+  }
+  plan.peak_bytes_after = peak;
+  std::sort(plan.items.begin(), plan.items.end(), [](const SwapItem& a, const SwapItem& b) {
+    if (a.swap_out_step != b.swap_out_step) return a.swap_out_step < b.swap_out_step;
+    return a.var < b.var;
+  });
+  VLOG(3) << "SwapPlanner swaps " << plan.items.size() << " variables, which reduces the peak from "
+          << plan.peak_bytes_before << " to " << plan.peak_bytes_after << " bytes";
+  return plan;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
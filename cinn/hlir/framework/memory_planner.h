@@ -0,0 +1,192 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The result of MemoryPlanner: every planned variable lives at a fixed offset of one arena.
+ */
+struct MemoryPlan {
+  // the number of bytes of the arena holding all the planned variables
+  size_t arena_bytes{0};
+  // the number of bytes needed if every planned variable owns its buffer
+  size_t total_bytes{0};
+  // the offset in the arena of each planned variable
+  absl::flat_hash_map<std::string, size_t> offsets;
+  // the number of bytes of each planned variable
+  absl::flat_hash_map<std::string, size_t> sizes;
+
+  bool empty() const { return offsets.empty(); }
+};
+
+/**
+ * The memory of a compiled program estimated at compile time from the life time of the variables.
+ */
+struct MemoryEstimate {
+  // the bytes of all the variables if each owns its buffer, the aliases sharing a buffer are counted once
+  size_t total_bytes{0};
+  // the bytes of the variables held across the runs: the inputs, the parameters, the fetched variables and the
+  // results of the prerun instructions
+  size_t persistent_bytes{0};
+  // the peak of the bytes of the other variables held at the same time, and the first step reaching it
+  size_t peak_intermediate_bytes{0};
+  int peak_step{-1};
+  // the bytes of the arena of the static memory plan, 0 if not planned
+  size_t arena_bytes{0};
+  // the peak of the memory of a run: the intermediate variables are held during their life time with the buffer
+  // handle instructions, packed into the arena with the static memory plan, and held all along otherwise
+  size_t peak_bytes{0};
+};
+
+/**
+ * VariableLifeTime records the life time of each variable used by a sequence of instructions, which is the interval
+ * [first_step, last_step] from the first to the last instruction using it.
+ */
+class VariableLifeTime {
+ public:
+  //! Record that \p name is used by the instruction at \p step, the steps should be recorded in ascending order.
+  void Use(const std::string& name, int step);
+
+  //! Reset the life time of \p name to [first_step, last_step], the variable is added if not recorded yet.
+  void Reset(const std::string& name, int first_step, int last_step);
+
+  bool Contains(const std::string& name) const { return life_times_.count(name); }
+  int FirstStep(const std::string& name) const { return life_times_.at(name).first; }
+  int LastStep(const std::string& name) const { return life_times_.at(name).second; }
+  //! All the steps recorded by Use of \p name in ascending order without duplicates, which are kept on Reset.
+  const std::vector<int>& UseSteps(const std::string& name) const { return use_steps_.at(name); }
+
+  const absl::flat_hash_map<std::string, std::pair<int, int>>& life_times() const { return life_times_; }
+
+  //! Estimate the peak of the bytes held at the same time if every variable of \p sizes owns its buffer during its
+  //! life time, the variables not in \p sizes are ignored. The first step reaching the peak is returned by
+  //! \p peak_step, or -1 if no variable is held.
+  size_t EstimatePeakBytes(const absl::flat_hash_map<std::string, size_t>& sizes, int* peak_step = nullptr) const;
+
+ private:
+  absl::flat_hash_map<std::string, std::pair<int, int>> life_times_;
+  absl::flat_hash_map<std::string, std::vector<int>> use_steps_;
+};
+
+/**
+ * MemoryPlanner packs the variables into an arena at compile time according to their life time, which is the
+ * interval [first_step, last_step] of the instructions using it. Two variables can share the same memory as long as
+ * their life times don't overlap.
+ *
+ * It uses the greedy-by-size strategy: variables are placed from the largest to the smallest, and each one takes the
+ * smallest gap(best-fit) among the memory occupied by the placed variables whose life times overlap with it.
+ */
+class MemoryPlanner {
+ public:
+  explicit MemoryPlanner(size_t alignment = 256) : alignment_(alignment) {}
+
+  //! Add a variable of \p nbytes used by the instructions from \p first_step to \p last_step.
+  void AddVariable(const std::string& name, size_t nbytes, int first_step, int last_step);
+
+  MemoryPlan Plan() const;
+
+ private:
+  struct Item {
+    std::string name;
+    size_t nbytes;
+    int first_step;
+    int last_step;
+  };
+
+  size_t alignment_;
+  std::vector<Item> items_;
+};
+
+/**
+ * The swap of a variable out to the host memory during a gap between two of its uses, in the steps of the instructions.
+ */
+struct SwapItem {
+  std::string var;
+  size_t bytes{0};
+  // the copy to the host is issued after the use at swap_out_step, and the device memory is released after the
+  // instruction at release_step, by when the copy is estimated to finish
+  int swap_out_step{-1};
+  int release_step{-1};
+  // the copy back is issued before the instruction at swap_in_step, early enough to finish before the next use at
+  // wait_step, which waits for it
+  int swap_in_step{-1};
+  int wait_step{-1};
+};
+
+struct SwapPlan {
+  // ordered by swap_out_step
+  std::vector<SwapItem> items;
+  // the peak of the bytes of the intermediate variables held at the same time without and with the swaps
+  size_t peak_bytes_before{0};
+  size_t peak_bytes_after{0};
+
+  bool empty() const { return items.empty(); }
+};
+
+/**
+ * SwapPlanner picks the variables to swap out to the host memory during the gaps between their uses, such as the
+ * activations of a training graph kept from the forward to the backward, so that the peak memory fits a budget.
+ *
+ * The time of each step is estimated ahead, and a gap is swappable only if the instructions run in it take long
+ * enough to hide both the copy out and the copy back at the bandwidth between the host and the device: the memory is
+ * released once the instructions after the swap out have taken the time of a copy, and the copy back is issued at the
+ * latest step before the next use leaving the time of a copy, so at least one step runs without the variable.
+ *
+ * Like RecomputePass, while the peak is over the budget, the largest swappable variable held across the peak step is
+ * swapped during the gap spanning it, and each variable is swapped at most once.
+ */
+class SwapPlanner {
+ public:
+  /**
+   * @param step_us The estimated time in microseconds of each step.
+   * @param host_gbps The bandwidth in GB/s of the copies between the host and the device.
+   */
+  SwapPlanner(std::vector<double> step_us, double host_gbps);
+
+  //! Add a variable of \p nbytes used by the steps of \p use_steps in ascending order, the ones not \p swappable are
+  //! only counted into the peak.
+  void AddVariable(const std::string& name, size_t nbytes, const std::vector<int>& use_steps, bool swappable = true);
+
+  SwapPlan Plan(size_t budget_bytes) const;
+
+ private:
+  struct Item {
+    std::string name;
+    size_t nbytes;
+    std::vector<int> use_steps;
+    bool swappable;
+  };
+
+  // find the steps to swap the variable in the gap between the uses at \p last_use and \p next_use, return false if
+  // the gap is too short to hide the copies
+  bool FindSwapSteps(const Item& item, int last_use, int next_use, SwapItem* swap) const;
+
+  std::vector<double> step_us_;
+  double host_gbps_;
+  std::vector<Item> items_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(MemoryPlanner, ReuseDisjointLifeTime) {
+  MemoryPlanner planner(256);
+  planner.AddVariable("a", 1024, 0, 1);
+  planner.AddVariable("b", 1024, 1, 2);
+  planner.AddVariable("c", 1000, 2, 3);
+  auto plan = planner.Plan();
+  // "a" and "c" are not alive at the same time, so they share the same memory
+  ASSERT_EQ(plan.offsets.at("a"), plan.offsets.at("c"));
+  ASSERT_NE(plan.offsets.at("a"), plan.offsets.at("b"));
+  ASSERT_EQ(plan.sizes.at("c"), 1024UL);
+  ASSERT_EQ(plan.arena_bytes, 2048UL);
+  ASSERT_EQ(plan.total_bytes, 3072UL);
+}
+
+TEST(MemoryPlanner, BestFitGap) {
+  MemoryPlanner planner(256);
+  planner.AddVariable("a", 4096, 0, 2);
+  planner.AddVariable("b", 2048, 0, 0);
+  planner.AddVariable("c", 1024, 0, 2);
+  planner.AddVariable("d", 512, 2, 2);
+  auto plan = planner.Plan();
+  ASSERT_EQ(plan.offsets.at("a"), 0UL);
+  ASSERT_EQ(plan.offsets.at("b"), 4096UL);
+  ASSERT_EQ(plan.offsets.at("c"), 6144UL);
+  // the memory of "b" is free at step 2, "d" takes the gap instead of growing the arena
+  ASSERT_EQ(plan.offsets.at("d"), 4096UL);
+  ASSERT_EQ(plan.arena_bytes, 7168UL);
+}
+
+TEST(MemoryPlanner, OverlappedLifeTime) {
+  MemoryPlanner planner(256);
+  planner.AddVariable("a", 100, 0, 3);
+  planner.AddVariable("b", 100, 1, 2);
+  planner.AddVariable("c", 100, 2, 4);
+  auto plan = planner.Plan();
+  ASSERT_EQ(plan.arena_bytes, 768UL);
+  ASSERT_EQ(plan.offsets.size(), 3UL);
+  ASSERT_TRUE(MemoryPlan().empty());
+}
+
+TEST(VariableLifeTime, EstimatePeakBytes) {
+  VariableLifeTime life_time;
+  life_time.Use("a", 0);
+  life_time.Use("b", 1);
+  life_time.Use("a", 2);
+  life_time.Use("c", 3);
+  life_time.Use("b", 3);
+  ASSERT_EQ(life_time.FirstStep("a"), 0);
+  ASSERT_EQ(life_time.LastStep("a"), 2);
+  ASSERT_FALSE(life_time.Contains("d"));
+
+  absl::flat_hash_map<std::string, size_t> sizes = {{"a", 100}, {"b", 200}, {"c", 400}};
+  int peak_step                                  = -1;
+  ASSERT_EQ(life_time.EstimatePeakBytes(sizes, &peak_step), 600UL);
+  ASSERT_EQ(peak_step, 3);
+
+  // "b" is not held between step 1 and step 3 anymore, such as being recomputed at step 3
+  life_time.Reset("b", 1, 1);
+  life_time.Reset("b_recompute", 3, 3);
+  sizes.emplace("b_recompute", 200);
+  ASSERT_EQ(life_time.EstimatePeakBytes(sizes, &peak_step), 600UL);
+  sizes.erase("c");
+  ASSERT_EQ(life_time.EstimatePeakBytes(sizes, &peak_step), 300UL);
+  ASSERT_EQ(peak_step, 1);
+  ASSERT_EQ(life_time.UseSteps("b"), std::vector<int>({1, 3}));
+}
+
+TEST(SwapPlanner, HideCopiesInGap) {
+  // each step takes 10us, and a copy of 10000 bytes at 1 GB/s takes one step
+  std::vector<double> step_us(10, 10.);
+  SwapPlanner planner(step_us, 1.);
+  planner.AddVariable("act", 10000, {0, 9});
+  planner.AddVariable("tmp", 20000, {4, 5}, false);
+  // the gap between step 3 and step 6 can't hide both copies
+  planner.AddVariable("short", 10000, {3, 6});
+  auto plan = planner.Plan(25000);
+  ASSERT_EQ(plan.peak_bytes_before, 40000UL);
+  ASSERT_EQ(plan.peak_bytes_after, 30000UL);
+  ASSERT_EQ(plan.items.size(), 1UL);
+  auto& item = plan.items[0];
+  ASSERT_EQ(item.var, "act");
+  ASSERT_EQ(item.swap_out_step, 0);
+  ASSERT_EQ(item.release_step, 1);
+  ASSERT_EQ(item.swap_in_step, 8);
+  ASSERT_EQ(item.wait_step, 9);
+
+  // nothing is swapped if the peak fits the budget, or the copies are too slow
+  ASSERT_TRUE(planner.Plan(40000).empty());
+  SwapPlanner slow_planner(step_us, 0.1);
+  slow_planner.AddVariable("act", 10000, {0, 9});
+  ASSERT_TRUE(slow_planner.Plan(0).empty());
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
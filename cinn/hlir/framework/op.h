@@ -170,6 +170,16 @@ class Operator {
     return absl::any_cast<const OpValueType<ValueType>&>(*ref);
   }
 
+  /**
+   * \brief Get the OpPattern of the ops, which the fusion and the lowering read for every node. The attribute map is
+   *  resolved on the first call only, so the pattern is indexed by the op without hashing the key again. The map is
+   *  owned by the registry and updated in place by set_attr, so it stays valid when more ops are registered.
+   */
+  static const OpValueType<OpPatternKind>& GetOpPatternAttrs() {
+    static const OpValueType<OpPatternKind>& op_pattern_dict = GetAttrs<OpPatternKind>("OpPattern");
+    return op_pattern_dict;
+  }
+
   auto get_index() const { return index; }
 
  private:
@@ -14,8 +14,10 @@
 
 #include "cinn/hlir/framework/op_lowering.h"
 
+#include "cinn/hlir/framework/control_flow.h"
 #include "cinn/hlir/framework/op_lowering_util.h"
 #include "cinn/hlir/op/external_api_registry.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 
@@ -276,6 +278,7 @@ std::vector<Expr> OpLowerer::IRElementwiseCompute(poly::StageMap& stages,
     // do compute
     common::CINNValuePack pack = impl->fcompute(common::CINNValuePack{cinn_inputs});
     CHECK_EQ(pack.size(), 2U);
+    SetMathPrecision(node, pack);
 
     Expr expr                  = pack[0];
     poly::StageMap node_stages = pack.back();
@@ -317,7 +320,7 @@ std::vector<Expr> OpLowerer::IRReduceCompute(poly::StageMap& stages,
                                              bool apply_impl_schedule) {
   VLOG(2) << "ReduceCompute Group : " << sub_group->group_id;
   auto& cinn_strategy   = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
 
   std::vector<Expr> ast_exprs;
   for (auto& node : sub_group->nodes) {
@@ -345,6 +348,7 @@ std::vector<Expr> OpLowerer::IRReduceCompute(poly::StageMap& stages,
 
     CHECK_GE(pack.size(), 2UL);
     CHECK_LE(pack.size(), 5UL);
+    SetMathPrecision(node, pack);
     poly::StageMap tmp_stages = pack.back();
 
     std::string post = "";
@@ -355,7 +359,7 @@ std::vector<Expr> OpLowerer::IRReduceCompute(poly::StageMap& stages,
       post = "_" + std::to_string(idx);
 
       // Insert outout tensors
-      if (!expr.as_tensor_ref()->buffer.defined() || this->target_ != common::DefaultNVGPUTarget()) {
+      if (!expr.as_tensor_ref()->buffer.defined() || !this->target_.is_gpu()) {
         tensor_inputs.push_back(expr.as_tensor_ref());
       }
     }
@@ -393,7 +397,7 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerNonFusibleOp(GroupPtr& group, boo
   // get input tensor and output tensor
   CHECK(group->nodes.size() || group->fused_sub_groups.size());
   auto& cinn_strategy   = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
 
   auto node = group->fused_sub_groups.size() ? group->fused_sub_groups[0]->nodes.front() : group->nodes.front();
   VLOG(3) << "GetOpFunc of op " << node->id();
@@ -432,11 +436,13 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerNonFusibleOp(GroupPtr& group, boo
   }
 
   auto impl = OpStrategy::SelectImpl(cinn_strategy[node->op()](node->attrs, inputs, out_types, out_shapes, target_));
-  // if node op is custom_call, apply custom_call compute.
-  if (node->op()->name == "custom_call") {
+  // if node op is custom_call or control flow, apply custom_call compute.
+  if (node->op()->name == "custom_call" || IsControlFlowOp(node->op()->name)) {
     std::string external_api;
     if (node->attrs.attr_store.count("custom_call")) {
       external_api = absl::get<std::string>(node->attrs.attr_store.at("custom_call"));
+    } else if (IsControlFlowOp(node->op()->name)) {
+      external_api = GetControlFlowApi(node->op()->name, target_);
     } else {
       external_api = ExternalApiRegistry::Global()->GetExternalApi(node, target_);
     }
@@ -453,10 +459,11 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerNonFusibleOp(GroupPtr& group, boo
   }
 
   common::CINNValuePack pack = impl->fcompute(common::CINNValuePack{cinn_inputs});
+  SetMathPrecision(node, pack);
   for (int i = 0; i < pack->size() - 1; i++) {
     ir::Expr temp = pack[i];
     // checkout whether the tensor is with buffer.
-    if (!temp.as_tensor_ref()->buffer.defined() || this->target_ != common::DefaultNVGPUTarget()) {
+    if (!temp.as_tensor_ref()->buffer.defined() || !this->target_.is_gpu()) {
       inputs.push_back(temp.as_tensor_ref());
       temp.as_tensor_ref()->WithBuffer();
       args.emplace_back(temp.as_tensor_ref()->buffer, ir::Argument::IO::kOutput);
@@ -523,7 +530,7 @@ void OpLowerer::IRSchedule(ir::IRSchedule& ir_sch,
   // find reducer.
   std::unordered_set<Node*> nodes_inline;
   auto greducer         = FindGlobalReducer(nodes_in_order);
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
 
   // do schedule
   for (auto node : nodes_in_order) {
@@ -652,6 +659,18 @@ void OpLowerer::IRSchedule(ir::IRSchedule& ir_sch,
     }
   }
 
+  // parallelize the loop nests by the cores of the host CPU, the blocks in a nest parallelized already are skipped
+  if (target_.is_cpu()) {
+    std::vector<std::string> block_names;
+    for (auto& block : ir_sch.GetAllBlocks()) {
+      block_names.push_back(block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name);
+    }
+    for (auto& block_name : block_names) {
+      pe::IRScheduleParallelCPU(ir_sch, block_name, target_);
+    }
+    VLOG(4) << "After parallelize, ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
+  }
+
   VLOG(3) << "Before Sync IRLowerOp schedule, ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
   SyncThreadWithShared(ir_sch, group, nodes_inline, nodes_set, this->shape_dict_, tensor_map);
   VLOG(4) << "After IRSchedule,  ir is: \n" << ir_sch.GetModule().GetExprs().at(0);
@@ -24,6 +24,7 @@
 #include "cinn/backends/nvrtc/nvrtc_util.h"
 #include "cinn/common/target.h"
 #include "cinn/frontend/decomposer/test_helper.h"
+#include "cinn/ir/collect_ir_nodes.h"
 
 namespace cinn {
 namespace hlir {
@@ -1263,6 +1264,41 @@ TEST(OpFusionPass, Warp_Reduce_Fuse_Elementwise) {
   Compile(net_builder);
 }
 
+TEST(OP_LOWERING, Host_Parallel_Elementwise_Reduce) {
+  auto target = common::DefaultHostTarget();
+  if (target.cpu_info().num_cores <= 1) {
+    return;
+  }
+  int h = 2048, w = 2048;
+  NetBuilder net_builder("Host_Parallel_Elementwise_Reduce");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.Add(A, B);
+    auto D = net_builder.ReduceSum(C, {1});
+  }
+
+  auto program = net_builder.Build();
+  auto graph   = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+
+  OpLowerer op_lowerer(dtype_dict, shape_dict, target);
+  for (auto& fusion_op : graph->fusion_groups) {
+    auto lowered_func = op_lowerer.Lower(fusion_op);
+    CHECK_EQ(lowered_func.size(), 1);
+    // the spatial loops of the large kernels run on all the cores
+    auto parallel_loops = ir::CollectIRNodes(lowered_func[0]->body, [](const Expr* x) {
+      return x->As<ir::For>() && x->As<ir::For>()->is_parallel();
+    });
+    ASSERT_FALSE(parallel_loops.empty()) << lowered_func[0];
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
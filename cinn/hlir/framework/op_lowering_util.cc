@@ -15,6 +15,7 @@
 #include "cinn/hlir/framework/op_lowering_util.h"
 
 #include "cinn/hlir/pe/nn_util.h"
+#include "cinn/ir/ir_mutator.h"
 #include "cinn/utils/string.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/common/bfloat16.h"
@@ -53,6 +54,10 @@ ir::Tensor GetTensor(const NodeData* node_data,
     return lang::Placeholder<common::bfloat16>(node_data->id(), shape_dict.at(node_data->id()));
   } else if (dtype.is_float16()) {
     return lang::Placeholder<common::float16>(node_data->id(), shape_dict.at(node_data->id()));
+  } else if (dtype.is_float8_e4m3()) {
+    return lang::Placeholder<common::float8_e4m3>(node_data->id(), shape_dict.at(node_data->id()));
+  } else if (dtype.is_float8_e5m2()) {
+    return lang::Placeholder<common::float8_e5m2>(node_data->id(), shape_dict.at(node_data->id()));
   } else if (dtype.is_bool()) {
     return lang::Placeholder<bool>(node_data->id(), shape_dict.at(node_data->id()));
   } else if (dtype.is_int(8)) {
@@ -185,7 +190,7 @@ std::vector<int> GetOutputShape(const Node* node, const absl::flat_hash_map<std:
 }
 
 Node* FindGlobalReducer(const std::vector<Node*>& nodes_in_order) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   for (auto iter = nodes_in_order.rbegin(); iter != nodes_in_order.rend(); ++iter) {
     if (op_pattern_dict[(*iter)->op()] == framework::kReduction) {
       return *iter;
@@ -197,7 +202,7 @@ Node* FindGlobalReducer(const std::vector<Node*>& nodes_in_order) {
 
 using Visitor = std::function<std::vector<Node*>(const Node*, const std::unordered_set<Node*>&)>;
 Node* FindReducerInRoute(const Node* node, const std::unordered_set<Node*>& nodes_set, Visitor visitor) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   std::queue<const Node*> candidates;
   candidates.push(node);
   while (!candidates.empty()) {
@@ -216,7 +221,7 @@ Node* FindReducerInRoute(const Node* node, const std::unordered_set<Node*>& node
 }
 
 Node* FindNearestReducer(const Node* node, const std::unordered_set<Node*>& nodes_set) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   // from consumers find reducer.
   auto reducer = FindReducerInRoute(node, nodes_set, GetConsumersInSet);
   if (reducer)
@@ -232,7 +237,7 @@ std::unordered_map<Node*, Node*> BuildVirtualConsumer(const GroupPtr& group,
   if (group->op_pattern_kind != framework::kReduction) {
     return virtual_consumers;
   }
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
 
   Node* e_node = nullptr;
   Node* r_node = nullptr;
@@ -409,7 +414,7 @@ std::vector<Node*> BFSTopologicalOrderWithPriority(const GroupPtr& group,
       index = visited_numel.size();
       visited_numel.push_back(numel);
     }
-    auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+    auto& op_pattern_dict = Operator::GetOpPatternAttrs();
     return index * 10 + static_cast<int>(op_pattern_dict[node->op()]);
   };
 
@@ -651,17 +656,18 @@ void LoopAssignReduceWithLast(ir::IRSchedule& ir_sch,
   // If the number of current device SM is smaller than the number of SM
   // required by Warp Reduce, the performance of Warp Reduce is better.
   // Otherwise, use Block Reduce.
-  auto max_num_threads       = common::DefaultNVGPUTarget().max_num_threads();
+  auto max_num_threads       = target.max_num_threads();
   int need_reduce_last_count = 1;
   for (int i = 0; i < inshape.size(); i++) {
     if (find(axes.begin(), axes.end(), i) == axes.end()) {
       need_reduce_last_count *= inshape[i];
     }
   }
-  int warp_reduce_need_sm_count = ceil((need_reduce_last_count * 32) / float(target.get_max_threads_per_sm()));
-  // Set Num_max_threads to 32 is Warp Reduce
+  int warp_reduce_need_sm_count =
+      ceil((need_reduce_last_count * target.warp_size()) / float(target.get_max_threads_per_sm()));
+  // Set Num_max_threads to the warp size is Warp Reduce
   if (target.get_multi_processor_count() < warp_reduce_need_sm_count) {
-    max_num_threads = 32;
+    max_num_threads = target.warp_size();
   }
   // find first reduce and second reduce axis.
   int lane  = 1;
@@ -753,7 +759,7 @@ bool CanbeInline(Node* node,
     return false;
   }
 
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   for (auto consumer : consumers) {
     if (op_pattern_dict[consumer->op()] == framework::kReduction) {
       return false;
@@ -808,7 +814,7 @@ Node* GetMasterToComputeAt(Node* node,
                            const std::unordered_set<Node*>& nodes_set,
                            const std::unordered_map<Node*, Node*>& virtual_consumers,
                            const absl::flat_hash_map<std::string, shape_t>& shape_dict) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   // if node is reduction, try find horizontal to compute at.
   if (op_pattern_dict[node->op()] == framework::kReduction) {
     // find all reduce node has done schedule.
@@ -898,7 +904,7 @@ void LoopAssignReduce(ir::IRSchedule& ir_sch,
                       const Target& target,
                       const std::unordered_map<std::string, ir::Tensor>& tensor_map,
                       const absl::flat_hash_map<std::string, shape_t>& shape_dict) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   // if node is reducer, return.
   if (op_pattern_dict[node->op()] == framework::kReduction) {
     return;
@@ -1394,7 +1400,7 @@ void MergeReduceLoop(ir::IRSchedule& ir_sch,
                      const Node* master,
                      const absl::flat_hash_map<std::string, shape_t>& shape_dict,
                      const std::unordered_map<std::string, ir::Tensor>& tensor_map) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   if (op_pattern_dict[master->op()] == kReduction && node != master) {
     MergeReduceToReduce(ir_sch, node, master, shape_dict, tensor_map);
     return;
@@ -1492,7 +1498,7 @@ void LoopComputeAt(ir::IRSchedule& ir_sch,
                    const GroupPtr& group,
                    const absl::flat_hash_map<std::string, shape_t>& shape_dict,
                    const std::unordered_map<std::string, ir::Tensor>& tensor_map) {
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
   if (!group->output_nodes.count(node)) {
     auto block = ir_sch.GetBlock(GetNodeData(node)->id());
     ir_sch.SetBuffer(block, "local");
@@ -1590,7 +1596,7 @@ void SyncThreadWithShared(ir::IRSchedule& ir_sch,
                           const std::unordered_map<std::string, ir::Tensor>& tensor_map) {
   auto exprs_inorder    = ir_sch.GetAllBlocks();
   auto node_data_set    = GetNodeDataSet(nodes_set);
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
 
   std::unordered_set<std::string> sync_mark;
   auto check_sync_mark = [&](const int start, const std::string& m_id) {
@@ -1656,6 +1662,41 @@ void SyncThreadWithShared(ir::IRSchedule& ir_sch,
   }
 }
 
+void SetMathPrecision(const Node* node, const common::CINNValuePack& pack) {
+  auto it = node->attrs.attr_store.find("math_precision");
+  if (it == node->attrs.attr_store.end()) {
+    return;
+  }
+  struct Mutator : public ir::IRMutator<> {
+    explicit Mutator(const std::string& precision) : precision(precision) {}
+
+    void operator()(Expr* e) { ir::IRMutator<>::Visit(e, e); }
+
+    void Visit(const ir::Call* op, Expr* expr) override {
+      if (op->call_type == ir::CallType::Extern) {
+        expr->As<ir::Call>()->attrs["math_precision"] = precision;
+      }
+      ir::IRMutator<>::Visit(op, expr);
+    }
+
+    std::string precision;
+  };
+
+  Mutator mutator(absl::get<std::string>(it->second));
+  for (int i = 0; i < pack.size() - 1; ++i) {
+    if (!pack[i].is_tensor()) {
+      continue;
+    }
+    ir::Tensor tensor = pack[i].operator ir::Expr().as_tensor_ref();
+    if (!tensor->is_compute_node()) {
+      continue;
+    }
+    for (auto& body : tensor->get_compute_op()->body) {
+      mutator(&body);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
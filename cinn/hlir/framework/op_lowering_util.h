@@ -97,6 +97,10 @@ void SyncThreadWithShared(ir::IRSchedule& ir_sch,
                           const absl::flat_hash_map<std::string, shape_t>& shape_dict,
                           const std::unordered_map<std::string, ir::Tensor>& tensor_map);
 
+// Set the "math_precision" attribute of the node on the extern calls in the computes of its output tensors, which
+// overrides FLAGS_cinn_nvgpu_math_precision for them in MapExternCall.
+void SetMathPrecision(const Node* node, const common::CINNValuePack& pack);
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
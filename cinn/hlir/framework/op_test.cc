@@ -82,6 +82,14 @@ TEST(Operator, GetAttrs) {
   }
 }
 
+TEST(Operator, GetOpPatternAttrs) {
+  auto& op_pattern_dict = Operator::GetOpPatternAttrs();
+  // the cached map is the one of the registry, so it sees the patterns of all the registered ops
+  ASSERT_EQ(&op_pattern_dict, &Operator::GetAttrs<OpPatternKind>("OpPattern"));
+  ASSERT_EQ(op_pattern_dict[Operator::Get("relu")], kElementWise);
+  ASSERT_EQ(op_pattern_dict[Operator::Get("reduce_sum")], kReduction);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
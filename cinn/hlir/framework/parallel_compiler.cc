@@ -16,22 +16,38 @@
 
 #include <algorithm>
 #include <fstream>
+#include <mutex>
 #include <thread>
 
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
 #include "cinn/backends/codegen_cuda_util.h"
+#include "cinn/backends/codegen_hip_dev.h"
 #include "cinn/backends/compiler.h"
+#include "cinn/backends/hiprtc/hiprtc_util.h"
+#include "cinn/backends/llvm/codegen_arm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/common/cas.h"
 #include "cinn/common/context.h"
+#include "cinn/hlir/framework/buffer.h"
+#include "cinn/hlir/framework/kernel_stitcher.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/module.h"
 #include "cinn/runtime/flags.h"
+#include "cinn/utils/compile_stats.h"
+#include "cinn/utils/multi_threading.h"
+#include "cinn/utils/profiler.h"
+#include "cinn/utils/timer.h"
 
+DECLARE_int32(cinn_parallel_compile_max_modules);
 DECLARE_int32(cinn_parallel_compile_size);
 DECLARE_int32(cinn_parallel_compile_thread);
+DECLARE_int32(cinn_parallel_jit_thread);
+DECLARE_bool(cinn_deduplicate_fusion_groups);
 
 namespace cinn {
 namespace hlir {
@@ -42,16 +58,22 @@ std::vector<std::unique_ptr<Instruction>> ParallelCompiler::operator()() {
   if (graph_->fusion_groups.size() == 0) {
     hlir::framework::ApplyPasses(graph_.get(), {"BuildNonFusedGroupsPass"});
   }
-  // Task Spilt
-  SplitTask();
-  // launch task
-  LaunchTask();
+  if (option_.stitch_small_kernels && !option_.lazy_compile && option_.lowered_funcs.empty()) {
+    return CompileStitchedGroups();
+  }
+  // share the function among the structurally equal groups
+  DeduplicateGroups();
+  if (option_.lazy_compile) {
+    return BuildLazyInstructions();
+  }
+  CompileGroups();
+  BuildDuplicateInstructions();
   // merge instruction
   return MergeResult();
 }
 
 OpPatternKind GetOpKind(const framework::Node* node) {
-  auto& op_pattern_dict = framework::Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& op_pattern_dict = framework::Operator::GetOpPatternAttrs();
   CHECK(op_pattern_dict.Find(node->op())) << "Don't find the pattern of op : " << node->id();
   auto kind = op_pattern_dict[node->op()];
 
@@ -65,30 +87,168 @@ OpPatternKind GetOpKind(const framework::Node* node) {
   return kind;
 }
 
-void ParallelCompiler::SplitTask() {
-  CHECK(graph_->fusion_groups.size());
+namespace {
+
+// The lowering time in ms of the groups compiled before in this process, keyed by the structural signature.
+class CompileTimeHistory {
+ public:
+  static CompileTimeHistory& Global() {
+    static CompileTimeHistory instance;
+    return instance;
+  }
+
+  bool Find(const std::string& signature, double* time_ms) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = times_.find(signature);
+    if (it == times_.end()) return false;
+    *time_ms = it->second;
+    return true;
+  }
+
+  void Record(const std::string& signature, double time_ms, int num_nodes) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    times_[signature] = time_ms;
+    total_ms_ += time_ms;
+    total_nodes_ += num_nodes;
+  }
+
+  // the average lowering time of a node, to estimate the groups never compiled
+  double MsPerNode() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return total_nodes_ > 0 ? total_ms_ / total_nodes_ : 1.0;
+  }
+
+ private:
+  std::mutex mtx_;
+  std::unordered_map<std::string, double> times_;
+  double total_ms_{0.0};
+  int64_t total_nodes_{0};
+};
+
+}  // namespace
+
+void ParallelCompiler::DeduplicateGroups() {
+  int num_groups = graph_->fusion_groups.size();
+  compile_gidx_.clear();
+  compiled_as_.resize(num_groups);
+  group_signatures_.resize(num_groups);
+  group_var_names_.assign(num_groups, {});
+  duplicate_instructions_.resize(num_groups);
+
+  auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (int idx = 0; idx < num_groups; ++idx) {
+    group_signatures_[idx] =
+        graph_->fusion_groups[idx]->StructuralSignature(shape_dict, dtype_dict, &group_var_names_[idx]);
+  }
+  // the lowered functions given by options are bound to each group
+  if (!FLAGS_cinn_deduplicate_fusion_groups || option_.lowered_funcs.size()) {
+    for (int idx = 0; idx < num_groups; ++idx) {
+      compiled_as_[idx] = idx;
+      compile_gidx_.push_back(idx);
+    }
+    return;
+  }
+
+  std::unordered_map<std::string, int> signature_to_gidx;
+  for (int idx = 0; idx < num_groups; ++idx) {
+    auto it           = signature_to_gidx.emplace(group_signatures_[idx], idx).first;
+    compiled_as_[idx] = it->second;
+    if (it->second == idx) {
+      compile_gidx_.push_back(idx);
+    }
+  }
+  VLOG(2) << "Deduplicate " << num_groups << " fusion groups to " << compile_gidx_.size() << " distinct groups";
+}
+
+void ParallelCompiler::CompileGroups() {
+  CHECK(compile_gidx_.size());
   CHECK(graph_->fusion_groups.size() == option_.lowered_funcs.size() || option_.lowered_funcs.size() == 0);
+  EstimateCost();
+  // the most expensive groups go first, so that they don't end up holding the whole build at last
+  std::stable_sort(compile_gidx_.begin(), compile_gidx_.end(), [this](int a, int b) {
+    return estimated_cost_[a] > estimated_cost_[b];
+  });
+  SplitTask();
+  LaunchTask();
+}
+
+void ParallelCompiler::EstimateCost() {
+  estimated_cost_.resize(graph_->fusion_groups.size());
+  auto& history      = CompileTimeHistory::Global();
+  double ms_per_node = history.MsPerNode();
+  for (int gidx : compile_gidx_) {
+    double time_ms = 0.0;
+    if (!history.Find(group_signatures_[gidx], &time_ms)) {
+      time_ms = graph_->fusion_groups[gidx]->CollectNodes().size() * ms_per_node;
+    }
+    estimated_cost_[gidx] = time_ms;
+  }
+}
+
+int ParallelCompiler::NumThreads(int num_threads_flag, int num_jobs) const {
+  int num_threads = num_threads_flag > 0 ? num_threads_flag : std::thread::hardware_concurrency();
+  return std::max(1, std::min(num_threads, num_jobs));
+}
+
+std::vector<ir::LoweredFunc> ParallelCompiler::LowerGroup(int gidx) {
+  if (option_.lowered_funcs.size()) {
+    return option_.lowered_funcs[gidx];
+  }
+  auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& group      = graph_->fusion_groups[gidx];
+  VLOG(1) << "Start Lowering Group " << gidx << " at " << std::this_thread::get_id() << " :\n"
+          << "Group " << gidx << " {\n"
+          << graph_->DebugGroupedGraph(group->CollectNodes()) << "}\n";
+  utils::RecordEvent record_lowering("Lowering " + group->GetFuncName(), utils::EventType::kCompute);
+  utils::CompileStats::ScopedActive active_stats(option_.stats ? option_.stats.get() : utils::CompileStats::Active());
+  utils::Timer timer;
+  timer.Start();
+  OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
+  auto lowered_funcs = op_lowerer.Lower(group);
+  CHECK_EQ(lowered_funcs.size(), 1) << "Lowerd Function Is Not Equal 1!";
+  double lowering_ms = timer.Stop();
+  int num_nodes      = group->CollectNodes().size();
+  CompileTimeHistory::Global().Record(group_signatures_[gidx], lowering_ms, num_nodes);
+  if (option_.stats) {
+    auto ir_size = ir::CollectIRNodes(lowered_funcs[0]->body, [](const Expr*) { return true; }).size();
+    option_.stats->AddGroup({group->GetFuncName(), num_nodes, lowering_ms, static_cast<int64_t>(ir_size)});
+  }
+  return lowered_funcs;
+}
+
+void ParallelCompiler::SplitTask() {
   // split task
-  int max_task_num =
-      FLAGS_cinn_parallel_compile_thread > 0 ? FLAGS_cinn_parallel_compile_thread : graph_->fusion_groups.size();
+  int max_task_num = FLAGS_cinn_parallel_compile_thread > 0 ? FLAGS_cinn_parallel_compile_thread : compile_gidx_.size();
 
-  int group_per_task = graph_->fusion_groups.size();
+  int group_per_task = compile_gidx_.size();
   if (max_task_num > 1) {
-    group_per_task = FLAGS_cinn_parallel_compile_size > 0
-                         ? FLAGS_cinn_parallel_compile_size
-                         : ((graph_->fusion_groups.size() + max_task_num - 1) / max_task_num);
+    group_per_task = FLAGS_cinn_parallel_compile_size > 0 ? FLAGS_cinn_parallel_compile_size
+                                                          : ((compile_gidx_.size() + max_task_num - 1) / max_task_num);
+  }
+  int num_tasks = (compile_gidx_.size() + group_per_task - 1) / group_per_task;
+  // each task is emitted as one module, so fewer tasks means fewer(but larger) translation units for NVRTC
+  if (FLAGS_cinn_parallel_compile_max_modules > 0) {
+    num_tasks = std::min(num_tasks, FLAGS_cinn_parallel_compile_max_modules);
   }
 
-  for (int idx = 0; idx < graph_->fusion_groups.size(); idx += group_per_task) {
+  task_begin_ = tasks_.size();
+  for (int idx = 0; idx < num_tasks; ++idx) {
     tasks_.emplace_back(this, scope_, graph_, option_, target_);
   }
-  VLOG(2) << "Split task to " << tasks_.size() << " sub-task!";
+  // the groups are sorted by the estimated cost, each one goes to the task with the least cost so far
+  std::vector<double> task_costs(num_tasks, 0.0);
+  for (int gidx : compile_gidx_) {
+    int task_idx = std::min_element(task_costs.begin(), task_costs.end()) - task_costs.begin();
+    task_costs[task_idx] += estimated_cost_[gidx];
+    tasks_[task_begin_ + task_idx].gidx.push_back(gidx);
+  }
+  VLOG(2) << "Split task to " << num_tasks << " sub-task!";
 }
 
 void RunTask(ParallelCompiler::Task* task) {
   VLOG(2) << "Stark run sub-task, Thread Id : " << std::this_thread::get_id();
-  VLOG(4) << "Start Lowering";
-  task->Lowering();
   VLOG(4) << "Start CodegenAndJit";
   task->CodegenAndJit();
   VLOG(4) << "Start BuildInstruction";
@@ -97,19 +257,117 @@ void RunTask(ParallelCompiler::Task* task) {
 }
 
 void ParallelCompiler::LaunchTask() {
-  // start sub-task.
-  std::vector<std::thread> threads;
-  for (int idx = 1; idx < tasks_.size(); ++idx) {
-    threads.emplace_back(RunTask, &tasks_[idx]);
+  int num_tasks = tasks_.size() - task_begin_;
+  // the groups are lowered in the order of the tasks, so that the first tasks get ready to compile early
+  std::vector<std::pair<int, int>> lowering_jobs;
+  std::vector<int> num_unlowered(num_tasks);
+  for (int task_idx = 0; task_idx < num_tasks; ++task_idx) {
+    auto& task = tasks_[task_begin_ + task_idx];
+    task.lowered_funcs.resize(task.gidx.size());
+    num_unlowered[task_idx] = task.gidx.size();
+    for (int pos = 0; pos < task.gidx.size(); ++pos) {
+      lowering_jobs.emplace_back(task_idx, pos);
+    }
   }
 
-  RunTask(&tasks_[0]);
-  // syncthreads.
-  for (auto& worker : threads) {
-    worker.join();
+  int num_jit_threads = NumThreads(FLAGS_cinn_parallel_jit_thread, num_tasks);
+  // all the tasks fit in the queue, so the lowering never waits for the jit stage, which may not get a thread of the
+  // task pool until the lowering is done
+  utils::QueueDispatcher ready_tasks(num_tasks);
+  std::mutex mtx;
+  // stage 2: codegen and jit the tasks, which overlaps with the lowering of the following tasks
+  auto jit_stage = utils::TaskPool::Global().Submit([&]() {
+    utils::parallel_run(
+        [this](int index) { RunTask(&tasks_[task_begin_ + index]); }, std::move(ready_tasks), num_jit_threads);
+  });
+  // stage 1: lower the groups, a task goes to the next stage as soon as all of its groups are lowered
+  auto lower_group = [&](int index) {
+    int task_idx = lowering_jobs[index].first;
+    int pos      = lowering_jobs[index].second;
+    auto& task   = tasks_[task_begin_ + task_idx];
+    {
+      // the IR nodes of the group live in an arena released with its lowered functions
+      ir::IrArenaScope arena_scope;
+      common::AutoSimplifyCacheScope simplify_cache_scope;
+      task.lowered_funcs[pos] = LowerGroup(task.gidx[pos]);
+    }
+    bool ready = false;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ready = --num_unlowered[task_idx] == 0;
+    }
+    if (ready) {
+      ready_tasks.Push(task_idx);
+    }
+  };
+  utils::parallel_run(lower_group,
+                      utils::SequenceDispatcher(0, lowering_jobs.size()),
+                      NumThreads(FLAGS_cinn_parallel_compile_thread, lowering_jobs.size()));
+  ready_tasks.Close();
+  utils::TaskPool::Global().Wait(&jit_stage);
+}
+
+void ParallelCompiler::BuildDuplicateInstructions() {
+  std::vector<int> uncompiled_gidx;
+  for (int idx = 0; idx < compiled_as_.size(); ++idx) {
+    int compiled_idx = compiled_as_[idx];
+    if (compiled_idx == idx) continue;
+    auto& compiled_group = graph_->fusion_groups[compiled_idx];
+    auto& group          = graph_->fusion_groups[idx];
+    // the variables of the two groups correspond to each other by their positions in the signature
+    absl::flat_hash_map<std::string, std::string> var_name_map;
+    auto& compiled_var_names = group_var_names_[compiled_idx];
+    auto& var_names          = group_var_names_[idx];
+    CHECK_EQ(compiled_var_names.size(), var_names.size());
+    for (int i = 0; i < var_names.size(); ++i) {
+      var_name_map[compiled_var_names[i]] = var_names[i];
+    }
+    auto map_names = [&](const std::vector<std::string>& names, std::vector<std::string>* mapped_names) {
+      for (auto& name : names) {
+        if (!var_name_map.count(name)) return false;
+        mapped_names->push_back(var_name_map.at(name));
+      }
+      return true;
+    };
+    std::vector<std::string> input_names, output_names;
+    // the arguments made by the lowering are not the variables of the group, it has to be compiled separately
+    if (!map_names(compiled_group->input_names, &input_names) ||
+        !map_names(compiled_group->output_names, &output_names)) {
+      VLOG(3) << "Can't share the function of group " << compiled_idx << " with group " << idx;
+      compiled_as_[idx] = idx;
+      uncompiled_gidx.push_back(idx);
+      continue;
+    }
+    group->input_names  = std::move(input_names);
+    group->output_names = std::move(output_names);
+
+    auto fn_name = compiled_group->GetFuncName();
+    auto instr   = std::unique_ptr<Instruction>(
+        new Instruction(target_, scope_.get(), group->input_names, group->output_names, fn_name));
+    instr->SetLoweredFunc(FindCompiledFunction(compiled_idx), fn_name);
+    instr->Finalize();
+    duplicate_instructions_[idx] = std::move(instr);
+  }
+
+  if (uncompiled_gidx.size()) {
+    compile_gidx_ = std::move(uncompiled_gidx);
+    CompileGroups();
   }
 }
 
+void* ParallelCompiler::FindCompiledFunction(int gidx) {
+  auto fn_name = graph_->fusion_groups[gidx]->GetFuncName();
+  for (auto& task : tasks_) {
+    if (std::find(task.gidx.begin(), task.gidx.end(), gidx) != task.gidx.end()) {
+      auto fn_ptr = task.engine->Lookup(fn_name);
+      CHECK(fn_ptr) << "Can't find jit function : " << fn_name;
+      return fn_ptr;
+    }
+  }
+  LOG(FATAL) << "Group " << gidx << " is not compiled";
+  return nullptr;
+}
+
 std::vector<std::unique_ptr<Instruction>> ParallelCompiler::MergeResult() {
   std::vector<std::unique_ptr<Instruction>> res(graph_->fusion_groups.size());
   for (auto& task : tasks_) {
@@ -117,45 +375,235 @@ std::vector<std::unique_ptr<Instruction>> ParallelCompiler::MergeResult() {
       res[task.gidx[idx]] = std::move(task.instructions[idx]);
     }
   }
+  for (int idx = 0; idx < duplicate_instructions_.size(); ++idx) {
+    if (duplicate_instructions_[idx]) {
+      res[idx] = std::move(duplicate_instructions_[idx]);
+    }
+  }
+  return std::move(res);
+}
+
+std::vector<std::unique_ptr<Instruction>> ParallelCompiler::BuildLazyInstructions() {
+  VLOG(2) << "Build " << graph_->fusion_groups.size() << " instructions to be compiled on the first use";
+  std::vector<std::unique_ptr<Instruction>> res;
+  for (int gidx = 0; gidx < graph_->fusion_groups.size(); ++gidx) {
+    auto& group = graph_->fusion_groups[gidx];
+    // the arguments are decided by the lowering, the variables of the group stand for them until then
+    std::vector<std::string> input_names, output_names;
+    for (auto* node_data : group->GetInputNodeDatas()) {
+      input_names.push_back(node_data->id());
+    }
+    for (auto* node_data : group->GetOutputNodeDatas()) {
+      output_names.push_back(node_data->id());
+    }
+    std::sort(input_names.begin(), input_names.end());
+    std::sort(output_names.begin(), output_names.end());
+    auto instr = std::unique_ptr<Instruction>(
+        new Instruction(target_, scope_.get(), input_names, output_names, group->GetFuncName()));
+    instr->SetCompileThunk([this, gidx](Instruction* instr) { CompileLazily(gidx, instr); });
+    res.push_back(std::move(instr));
+  }
   return std::move(res);
 }
 
-void ParallelCompiler::Task::Lowering() {
-  if (options.lowered_funcs.size()) {
-    CHECK_EQ(options.lowered_funcs.size(), graph->fusion_groups.size());
+void ParallelCompiler::CompileLazily(int gidx, Instruction* instr) {
+  auto task = std::make_unique<Task>(this, scope_, graph_, option_, target_);
+  task->gidx.push_back(gidx);
+  task->lowered_funcs.push_back(LowerGroup(gidx));
+  task->CodegenAndJit();
+
+  auto& group = graph_->fusion_groups[gidx];
+  CHECK(group->input_names.size() > 0 || group->output_names.size() > 0);
+  instr->ClearInArgs();
+  instr->ClearOutArgs();
+  instr->AddInArgs(group->input_names);
+  instr->AddOutArgs(group->output_names);
+  auto fn_ptr = task->engine->Lookup(group->GetFuncName());
+  CHECK(fn_ptr) << "Can't find jit function : " << group->GetFuncName();
+  instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), group->GetFuncName());
+  instr->Finalize();
+
+  std::lock_guard<std::mutex> lock(lazy_mtx_);
+  lazy_tasks_.push_back(std::move(task));
+}
+
+std::shared_ptr<backends::ExecutionEngine> ParallelCompiler::GetEngine() {
+  std::lock_guard<std::mutex> lock(engine_mtx_);
+  if (!engine_) {
+    backends::ExecutionOptions options;
+    options.buffer_alignment = Buffer::AssumedAlignment();
+    engine_                  = backends::ExecutionEngine::Create(options);
+  }
+  return engine_;
+}
+
+std::vector<std::unique_ptr<Instruction>> ParallelCompiler::CompileStitchedGroups() {
+  int num_groups = graph_->fusion_groups.size();
+  // the signatures are only used to record the lowering time
+  group_signatures_.resize(num_groups);
+  group_var_names_.assign(num_groups, {});
+  auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (int idx = 0; idx < num_groups; ++idx) {
+    group_signatures_[idx] =
+        graph_->fusion_groups[idx]->StructuralSignature(shape_dict, dtype_dict, &group_var_names_[idx]);
   }
-  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
-  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
 
-  OpLowerer op_lowerer(dtype_dict, shape_dict, target);
-  while (true) {
-    int idx = compiler->GetGroupIdx();
-    if (idx < 0) {
-      break;
-    }
+  std::vector<ir::LoweredFunc> group_funcs(num_groups);
+  utils::parallel_run(
+      [&](int gidx) {
+        ir::IrArenaScope arena_scope;
+        common::AutoSimplifyCacheScope simplify_cache_scope;
+        group_funcs[gidx] = LowerGroup(gidx)[0];
+      },
+      utils::SequenceDispatcher(0, num_groups),
+      NumThreads(FLAGS_cinn_parallel_compile_thread, num_groups));
+
+  // all the blocks of a cooperative kernel have to be resident, one block per multiprocessor is always guaranteed
+  int max_grid_blocks = 0;
+#ifdef CINN_WITH_CUDA
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&max_grid_blocks, cudaDevAttrMultiProcessorCount, device_id));
+#endif
 
-    gidx.push_back(idx);
-    if (options.lowered_funcs.size()) {
-      lowered_funcs.push_back(options.lowered_funcs[idx]);
+  // each kernel is either a stitched one of several groups, or the kernel of a single group
+  struct Kernel {
+    ir::LoweredFunc func;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+  };
+  std::vector<Kernel> kernels;
+  KernelStitcher stitcher(max_grid_blocks);
+  std::vector<int> stitched_gidx;
+  auto flush = [&]() {
+    if (stitched_gidx.size() > 1) {
+      Kernel kernel;
+      auto name   = graph_->fusion_groups[stitched_gidx.front()]->GetFuncName() + "_stitched";
+      kernel.func = stitcher.Build(name, &kernel.input_names, &kernel.output_names);
+      kernels.push_back(std::move(kernel));
+    } else if (stitched_gidx.size() == 1) {
+      auto& group = graph_->fusion_groups[stitched_gidx.front()];
+      kernels.push_back({group_funcs[stitched_gidx.front()], group->input_names, group->output_names});
+    }
+    stitcher.Clear();
+    stitched_gidx.clear();
+  };
+  for (int gidx = 0; gidx < num_groups; ++gidx) {
+    auto& group = graph_->fusion_groups[gidx];
+    auto& func  = group_funcs[gidx];
+    if (!stitcher.IsStitchable(func)) {
+      flush();
+      kernels.push_back({func, group->input_names, group->output_names});
       continue;
     }
-    auto& group = graph->fusion_groups[idx];
-    VLOG(1) << "Start Lowering Group " << idx << " at " << std::this_thread::get_id() << " :\n"
-            << "Group " << idx << " {\n"
-            << graph->DebugGroupedGraph(group->CollectNodes()) << "}\n";
-    lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
-    CHECK_EQ(lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
+    if (!stitcher.CanAppend(func)) {
+      flush();
+    }
+    // the arguments of the function are the inputs followed by the outputs of the group
+    std::vector<std::string> arg_names(group->input_names);
+    arg_names.insert(arg_names.end(), group->output_names.begin(), group->output_names.end());
+    stitcher.Append(func, arg_names);
+    stitched_gidx.push_back(gidx);
+  }
+  flush();
+  VLOG(2) << "Stitch " << num_groups << " fusion groups into " << kernels.size() << " kernels";
+
+  // compile the kernels in modules of the parallel compile size, the tasks have no group to build instructions
+  int kernels_per_task = FLAGS_cinn_parallel_compile_size > 0 ? FLAGS_cinn_parallel_compile_size : kernels.size();
+  int num_tasks        = (kernels.size() + kernels_per_task - 1) / kernels_per_task;
+  task_begin_          = tasks_.size();
+  for (int idx = 0; idx < num_tasks; ++idx) {
+    tasks_.emplace_back(this, scope_, graph_, option_, target_);
   }
+  for (int idx = 0; idx < kernels.size(); ++idx) {
+    tasks_[task_begin_ + idx / kernels_per_task].lowered_funcs.push_back({kernels[idx].func});
+  }
+  utils::parallel_run([this](int index) { tasks_[task_begin_ + index].CodegenAndJit(); },
+                      utils::SequenceDispatcher(0, num_tasks),
+                      NumThreads(FLAGS_cinn_parallel_jit_thread, num_tasks));
+
+  std::vector<std::unique_ptr<Instruction>> res;
+  for (int idx = 0; idx < kernels.size(); ++idx) {
+    auto& kernel = kernels[idx];
+    auto fn_name = kernel.func->name;
+    auto instr   = std::unique_ptr<Instruction>(
+        new Instruction(target_, scope_.get(), kernel.input_names, kernel.output_names, fn_name));
+    auto fn_ptr = tasks_[task_begin_ + idx / kernels_per_task].engine->Lookup(fn_name);
+    CHECK(fn_ptr) << "Can't find jit function : " << fn_name;
+    instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), fn_name);
+    instr->Finalize();
+    res.push_back(std::move(instr));
+  }
+  return std::move(res);
 }
 
+std::vector<CompiledModule> ParallelCompiler::GetCompiledModules() {
+  std::vector<CompiledModule> res;
+  for (auto& task : tasks_) {
+    res.push_back(task.compiled_module);
+  }
+  std::lock_guard<std::mutex> lock(lazy_mtx_);
+  for (auto& task : lazy_tasks_) {
+    res.push_back(task->compiled_module);
+  }
+  return res;
+}
+
+std::vector<ir::LoweredFunc> ParallelCompiler::GetLoweredFuncs() {
+  std::vector<ir::LoweredFunc> res;
+  auto collect = [&res](const Task& task) {
+    for (auto& funcs : task.lowered_funcs) {
+      res.insert(res.end(), funcs.begin(), funcs.end());
+    }
+  };
+  for (auto& task : tasks_) {
+    collect(task);
+  }
+  std::lock_guard<std::mutex> lock(lazy_mtx_);
+  for (auto& task : lazy_tasks_) {
+    collect(*task);
+  }
+  return res;
+}
+
+#ifdef CINN_WITH_CUDA
+namespace {
+// The register and shared memory usage of the loaded kernel, and the occupancy of its launch configuration, which
+// tell the schedules spilling the registers into the local memory or running too few warps.
+utils::CompileStats::KernelStats GetKernelStats(const ir::LoweredFunc& fn, CUfunction cufunc) {
+  using runtime::cuda::CUDAModule;
+  auto resource            = CUDAModule::GetKernelResource(cufunc);
+  int dynamic_shared_bytes = fn->CudaDynamicSharedMemBytes();
+  utils::CompileStats::KernelStats stats;
+  stats.kernel_name   = fn->name;
+  stats.block_threads = fn->cuda_axis_info.block_dim(0) * fn->cuda_axis_info.block_dim(1) *
+                        fn->cuda_axis_info.block_dim(2);
+  stats.num_regs      = resource.num_regs;
+  stats.local_bytes   = resource.local_bytes;
+  stats.shared_bytes  = resource.static_shared_bytes + dynamic_shared_bytes;
+  stats.occupancy     = CUDAModule::GetOccupancy(cufunc, stats.block_threads, dynamic_shared_bytes);
+  VLOG(3) << "Kernel " << stats.kernel_name << " of " << stats.block_threads << " threads takes " << stats.num_regs
+          << " registers, " << stats.local_bytes << " bytes of local memory and " << stats.shared_bytes
+          << " bytes of shared memory, occupancy: " << stats.occupancy;
+  return stats;
+}
+}  // namespace
+#endif
+
 void ParallelCompiler::Task::CodegenAndJit() {
   VLOG(2) << "Start Codegen and JIT with Group [" << cinn::utils::Join(this->gidx, ", ") << "] at "
           << std::this_thread::get_id();
+  utils::CompileStats::ScopedActive active_stats(options.stats ? options.stats.get() : utils::CompileStats::Active());
+  utils::CompileStats::ModuleStats module_stats;
+  utils::Timer timer;
+  ir::IrArenaScope arena_scope;
   // build module
   ir::Module::Builder builder(common::UniqName("module"), target);
   for (auto& func : lowered_funcs) {
     CHECK_EQ(func.size(), 1);
     builder.AddFunction(func[0]);
+    compiled_module.fn_names.push_back(func[0]->name);
   }
 
   auto ir_module = builder.Build();
@@ -168,19 +616,33 @@ void ParallelCompiler::Task::CodegenAndJit() {
 
     VLOG(3) << "Host Code:\n" << hmodule;
     VLOG(3) << "Device Code:\n" << dmodule;
+    utils::RecordEvent record_codegen("CodeGenCUDA_Dev", utils::EventType::kCodeGen);
+    timer.Start();
     backends::CodeGenCUDA_Dev codegen(target);
+    codegen.SetBufferAlignment(Buffer::AssumedAlignment());
     auto cuda_c = codegen.Compile(dmodule);
     CHECK(!cuda_c.empty()) << "Compile CUDA C code failed from device module:\n" << dmodule;
+    record_codegen.End();
+    module_stats.codegen_ms   = timer.Stop();
+    module_stats.source_bytes = cuda_c.size();
 
     cinn::backends::SourceCodePrint::GetInstance()->write(cuda_c);
     graph->SaveSourceCode(cuda_c);
 
     using runtime::cuda::CUDAModule;
+    utils::RecordEvent record_nvrtc("NVRTC Compile", utils::EventType::kCompile);
+    timer.Start();
     backends::nvrtc::Compiler compiler;
     auto ptx = compiler(cuda_c);
     CHECK(!ptx.empty()) << "Compile PTX failed from source code:\n" << cuda_c;
     // load cumodule
-    cumodule.reset(new CUDAModule(ptx, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX));
+    cumodule =
+        CUDAModule::GetShared(ptx, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+    record_nvrtc.End();
+    module_stats.device_compile_ms       = timer.Stop();
+    module_stats.device_code_bytes       = ptx.size();
+    compiled_module.device_code          = ptx;
+    compiled_module.device_code_is_cubin = compiler.compile_to_cubin();
 
     // register kernel
     backends::RuntimeSymbols symbols;
@@ -188,13 +650,81 @@ void ParallelCompiler::Task::CodegenAndJit() {
       auto cufunc = cumodule->GetFunction(0, fn->name);
       CHECK(cufunc);
       symbols.RegisterVar(fn->name + "_ptr_", reinterpret_cast<void*>(cufunc));
+      compiled_module.kernel_names.push_back(fn->name);
+      if (options.stats) {
+        options.stats->AddKernel(GetKernelStats(fn, cufunc));
+      }
     }
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions(), std::move(symbols));
-    engine->Link<backends::CodeGenCUDA_Host>(hmodule);
+    utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+    timer.Start();
+    // the task's ParallelCompiler, which the local device compiler shadows
+    engine = this->compiler->GetEngine();
+    engine->RegisterSymbols(std::move(symbols));
+    engine->Link<backends::CodeGenCUDA_Host>(hmodule, &compiled_module.host_object);
+    module_stats.jit_ms = timer.Stop();
+#endif
+  } else if (target.arch == common::Target::Arch::AMDGPU) {
+#ifdef CINN_WITH_ROCM
+    auto splited_module = backends::SplitCudaAndHostModule(ir_module, target);
+    auto hmodule        = std::get<0>(splited_module);
+    auto dmodule        = std::get<1>(splited_module);
+
+    VLOG(3) << "Host Code:\n" << hmodule;
+    VLOG(3) << "Device Code:\n" << dmodule;
+    utils::RecordEvent record_codegen("CodeGenHIP_Dev", utils::EventType::kCodeGen);
+    timer.Start();
+    backends::CodeGenHIP_Dev codegen(target);
+    auto hip_c = codegen.Compile(dmodule);
+    CHECK(!hip_c.empty()) << "Compile HIP C code failed from device module:\n" << dmodule;
+    record_codegen.End();
+    module_stats.codegen_ms   = timer.Stop();
+    module_stats.source_bytes = hip_c.size();
+
+    cinn::backends::SourceCodePrint::GetInstance()->write(hip_c);
+    graph->SaveSourceCode(hip_c);
+
+    // the code objects are not saved in the program artifacts, which are reloaded by CUDAModule only
+    utils::RecordEvent record_hiprtc("hipRTC Compile", utils::EventType::kCompile);
+    timer.Start();
+    backends::hiprtc::Compiler compiler;
+    auto code_object = compiler(hip_c);
+    CHECK(!code_object.empty()) << "Compile code object failed from source code:\n" << hip_c;
+    hipmodule = runtime::hip::HIPModule::GetShared(code_object);
+    record_hiprtc.End();
+    module_stats.device_compile_ms = timer.Stop();
+    module_stats.device_code_bytes = code_object.size();
+
+    // register kernel
+    backends::RuntimeSymbols symbols;
+    for (auto& fn : dmodule.functions()) {
+      auto hipfunc = hipmodule->GetFunction(0, fn->name);
+      CHECK(hipfunc);
+      symbols.RegisterVar(fn->name + "_ptr_", reinterpret_cast<void*>(hipfunc));
+      compiled_module.kernel_names.push_back(fn->name);
+    }
+    utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+    timer.Start();
+    // the task's ParallelCompiler, which the local device compiler shadows
+    engine = this->compiler->GetEngine();
+    engine->RegisterSymbols(std::move(symbols));
+    engine->Link<backends::CodeGenCUDA_Host>(hmodule, &compiled_module.host_object);
+    module_stats.jit_ms = timer.Stop();
 #endif
   } else {
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions());
-    engine->Link<backends::CodeGenX86>(ir_module);
+    utils::RecordEvent record_jit("LLVM JIT", utils::EventType::kCompile);
+    timer.Start();
+    engine = compiler->GetEngine();
+    if (target.arch == common::Target::Arch::ARM) {
+      engine->Link<backends::CodeGenARM>(ir_module, &compiled_module.host_object);
+    } else {
+      engine->Link<backends::CodeGenX86>(ir_module, &compiled_module.host_object);
+    }
+    module_stats.jit_ms = timer.Stop();
+  }
+  if (options.stats) {
+    module_stats.fn_names     = compiled_module.fn_names;
+    module_stats.object_bytes = compiled_module.host_object.size();
+    options.stats->AddModule(module_stats);
   }
 }
 
@@ -216,15 +746,6 @@ void ParallelCompiler::Task::BuildInstruction() {
   }
 }
 
-int ParallelCompiler::GetGroupIdx() {
-  std::lock_guard<std::mutex> lock(mtx_);
-  if (index < graph_->fusion_groups.size()) {
-    return index++;
-  } else {
-    return -1;
-  }
-}
-
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
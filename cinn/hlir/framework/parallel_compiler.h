@@ -14,6 +14,7 @@
 #pragma once
 
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "cinn/backends/llvm/execution_engine.h"
@@ -22,17 +23,39 @@
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/ir/lowered_func.h"
+#include "cinn/utils/compile_stats.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/runtime/cuda/cuda_module.h"
 #endif
+#ifdef CINN_WITH_ROCM
+#include "cinn/runtime/hip/hip_module.h"
+#endif
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+// The code of a module compiled by the ParallelCompiler, which is kept to save the compiled program as an artifact.
+struct CompiledModule {
+  // the functions defined by the module
+  std::vector<std::string> fn_names;
+  // the object code of the host module
+  std::string host_object;
+  // the cubin or PTX of the device module and the names of its kernels
+  std::string device_code;
+  bool device_code_is_cubin{false};
+  std::vector<std::string> kernel_names;
+};
+
 class ParallelCompiler {
  public:
   struct CompileOptions {
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
+    // don't compile the groups ahead, each instruction compiles its group on the first run instead
+    bool lazy_compile = false;
+    // record the lowering of each group and the code generation of each module if not nullptr
+    std::shared_ptr<utils::CompileStats> stats;
+    // stitch the consecutive small CUDA kernels into cooperative kernels, see KernelStitcher
+    bool stitch_small_kernels = false;
   };
 
  public:
@@ -44,10 +67,36 @@ class ParallelCompiler {
   ~ParallelCompiler() {}
   std::vector<std::unique_ptr<Instruction>> operator()();
 
+  // the code of all the modules compiled so far
+  std::vector<CompiledModule> GetCompiledModules();
+  // the lowered functions of all the modules compiled so far
+  std::vector<ir::LoweredFunc> GetLoweredFuncs();
+
  private:
+  // find the groups structurally equal to a previous one, only the first one of them is compiled
+  void DeduplicateGroups();
+  // lower, codegen and jit the groups in compile_gidx_
+  void CompileGroups();
+  // estimate the cost of each group by its lowering time before, or its number of nodes if never compiled
+  void EstimateCost();
+  std::vector<ir::LoweredFunc> LowerGroup(int gidx);
+  // distribute the groups to tasks with balanced cost, each task is compiled as a module
   void SplitTask();
+  // run the tasks in a pipeline: the groups are lowered one by one in parallel, and a task is compiled by another
+  // thread pool as soon as its groups are all lowered
   void LaunchTask();
+  int NumThreads(int num_threads_flag, int num_jobs) const;
+  // build the instructions of the duplicated groups with the function compiled for the group they duplicate
+  void BuildDuplicateInstructions();
+  void* FindCompiledFunction(int gidx);
   std::vector<std::unique_ptr<Instruction>> MergeResult();
+  // build the instructions holding the thunks to compile their groups on the first use
+  std::vector<std::unique_ptr<Instruction>> BuildLazyInstructions();
+  void CompileLazily(int gidx, Instruction* instr);
+  // the engine all the tasks link their host modules into, which shares the jit session and the runtime symbols
+  std::shared_ptr<backends::ExecutionEngine> GetEngine();
+  // lower all the groups, stitch the consecutive small kernels of them and build an instruction for each kernel
+  std::vector<std::unique_ptr<Instruction>> CompileStitchedGroups();
 
  public:
   struct Task {
@@ -58,7 +107,6 @@ class ParallelCompiler {
          const CompileOptions& cp,
          const Target& t)
         : compiler(p), scope(s), graph(g), options(cp), target(t) {}
-    void Lowering();
     void CodegenAndJit();
     void BuildInstruction();
 
@@ -74,20 +122,37 @@ class ParallelCompiler {
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
 
    public:
-    std::unique_ptr<backends::ExecutionEngine> engine;
+    CompiledModule compiled_module;
+    std::shared_ptr<backends::ExecutionEngine> engine;
 #ifdef CINN_WITH_CUDA
-    std::unique_ptr<runtime::cuda::CUDAModule> cumodule;
+    std::shared_ptr<runtime::cuda::CUDAModule> cumodule;
+#endif
+#ifdef CINN_WITH_ROCM
+    std::shared_ptr<runtime::hip::HIPModule> hipmodule;
 #endif
   };
   std::vector<Task> tasks_;
-  int GetGroupIdx();
 
  private:
-  int index{0};
-  std::mutex mtx_;
+  // the groups to be compiled by the tasks launched from task_begin_
+  std::vector<int> compile_gidx_;
+  int task_begin_{0};
+  std::vector<double> estimated_cost_;
+  std::vector<std::string> group_signatures_;
+  // the index of the group whose function is shared by each group, which is itself if not duplicated
+  std::vector<int> compiled_as_;
+  // the variable names of each group in the order of its structural signature
+  std::vector<std::vector<std::string>> group_var_names_;
+  std::vector<std::unique_ptr<Instruction>> duplicate_instructions_;
+  // the tasks compiled on demand by the lazy instructions, which may be run by several threads
+  std::vector<std::unique_ptr<Task>> lazy_tasks_;
+  std::mutex lazy_mtx_;
+  std::shared_ptr<backends::ExecutionEngine> engine_;
+  std::mutex engine_mtx_;
 
   const common::Target target_;
-  const CompileOptions& option_;
+  // hold a copy of the options, as the lazy instructions use them after the compiler is constructed
+  const CompileOptions option_;
   std::shared_ptr<Scope> scope_;
   std::shared_ptr<Graph> graph_;
 };
@@ -21,6 +21,8 @@
 #include "cinn/frontend/optimize.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 
+DECLARE_bool(cinn_stitch_small_kernels);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -78,6 +80,61 @@ TEST(ParallelCompilerTest, Matmul_Test_0) {
   auto runtime_program = pc();
 }
 
+TEST(ParallelCompilerTest, SaveAndLoad) {
+  frontend::NetBuilder builder("SaveAndLoad");
+  auto A       = builder.CreateInput(Float(32), {128, 128}, "A");
+  auto B       = builder.CreateInput(Float(32), {128, 128}, "B");
+  auto C       = builder.Add(A, B);
+  auto D       = builder.Relu(C);
+  auto target  = common::DefaultNVGPUTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto compiled_program              = gc.Build(options, {D->id}).runtime_program;
+  compiled_program->Save("./parallel_compiler_test_artifact");
+
+  // the loaded program runs the same instructions without compiling
+  auto loaded_program = Program::Load("./parallel_compiler_test_artifact", target);
+  ASSERT_EQ(loaded_program->size(), compiled_program->size());
+  for (int idx = 0; idx < loaded_program->size(); ++idx) {
+    auto& compiled_instr = compiled_program->GetRunInstructions()[idx];
+    auto& loaded_instr   = loaded_program->GetRunInstructions()[idx];
+    ASSERT_EQ(loaded_instr->GetFnNames(), compiled_instr->GetFnNames());
+    ASSERT_EQ(loaded_instr->GetInArgs(), compiled_instr->GetInArgs());
+    ASSERT_EQ(loaded_instr->GetOutArgs(), compiled_instr->GetOutArgs());
+  }
+  ASSERT_TRUE(loaded_program->GetScope()->FindVar(D->id));
+  loaded_program->Execute();
+}
+
+TEST(ParallelCompilerTest, StitchSmallKernels) {
+  frontend::NetBuilder builder("StitchSmallKernels");
+  auto A = builder.CreateInput(Float(32), {4, 32}, "A");
+  // the reduce splits the program into several small groups
+  auto B = builder.ReduceSum(builder.Relu(A), {1}, true);
+  auto C = builder.Exp(builder.Add(A, builder.BroadcastTo(B, {4, 32})));
+
+  auto target  = common::DefaultNVGPUTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  FLAGS_cinn_stitch_small_kernels = true;
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto runtime_program               = gc.Build(options, {C->id}).runtime_program;
+  FLAGS_cinn_stitch_small_kernels    = false;
+  // the groups of the same block are stitched, each instruction runs one or more groups
+  ASSERT_LE(runtime_program->size(), graph->fusion_groups.size());
+  runtime_program->Execute();
+  ASSERT_TRUE(scope->FindVar(C->id));
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
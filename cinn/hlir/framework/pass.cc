@@ -14,13 +14,90 @@
 
 #include "cinn/hlir/framework/pass.h"
 
+#include <gflags/gflags.h>
+
+#include <unordered_map>
+
 #include "cinn/hlir/framework/visualize_helper.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/compile_stats.h"
+#include "cinn/utils/multi_threading.h"
+
+DECLARE_int32(cinn_partition_pass_min_nodes);
 
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+namespace {
+// Split the graph into the weakly connected components, ordered by their first nodes in topological order.
+std::vector<GraphPartition> PartitionGraph(Graph* g) {
+  auto topo_nodes = std::get<0>(g->topological_order());
+  std::unordered_map<common::GraphNode*, common::GraphNode*> parent;
+  for (auto* node : topo_nodes) {
+    parent[node] = node;
+  }
+  auto find_root = [&parent](common::GraphNode* node) {
+    while (parent.at(node) != node) {
+      parent[node] = parent.at(parent.at(node));
+      node         = parent.at(node);
+    }
+    return node;
+  };
+  for (auto* node : topo_nodes) {
+    for (auto& edge : node->outlinks()) {
+      auto* root_a = find_root(node);
+      auto* root_b = find_root(edge->sink());
+      if (root_a != root_b) {
+        parent[root_b] = root_a;
+      }
+    }
+  }
+
+  std::vector<GraphPartition> partitions;
+  std::unordered_map<common::GraphNode*, int> root2partition;
+  for (auto* node : topo_nodes) {
+    auto* op_node = node->safe_as<Node>();
+    if (!op_node) {
+      continue;
+    }
+    auto it = root2partition.emplace(find_root(node), partitions.size()).first;
+    if (it->second == static_cast<int>(partitions.size())) {
+      partitions.emplace_back();
+    }
+    partitions[it->second].nodes.push_back(op_node);
+  }
+  for (auto& group : g->fusion_groups) {
+    auto nodes = group->CollectNodes();
+    CHECK(!nodes.empty()) << "The fusion group " << group->group_id << " has no node";
+    partitions[root2partition.at(find_root(nodes.front()))].fusion_groups.push_back(group);
+  }
+  return partitions;
+}
+
+// Apply a partitionable pass on the partitions of the graph in parallel, return false if the graph is too small or
+// has only one partition.
+bool ApplyPartitionPass(Graph* g, const PassFunctionRegister* r) {
+  if (!r->partition_body || (r->partition_enabled && !r->partition_enabled()) ||
+      FLAGS_cinn_partition_pass_min_nodes <= 0 ||
+      g->nodes().size() < static_cast<size_t>(FLAGS_cinn_partition_pass_min_nodes)) {
+    return false;
+  }
+  auto partitions = PartitionGraph(g);
+  if (partitions.size() <= 1) {
+    return false;
+  }
+  VLOG(3) << "Apply pass " << r->name << " on " << partitions.size() << " partitions in parallel";
+  utils::parallel_run([&](int index) { r->partition_body(g, &partitions[index]); },
+                      utils::SequenceDispatcher(0, partitions.size()));
+  g->fusion_groups.clear();
+  for (auto& partition : partitions) {
+    g->fusion_groups.insert(g->fusion_groups.end(), partition.fusion_groups.begin(), partition.fusion_groups.end());
+  }
+  return true;
+}
+}  // namespace
+
 void ApplyPasses(Graph* g, const std::vector<std::string>& passes) {
   std::vector<const PassFunctionRegister*> fpass;
   for (auto& name : passes) {
@@ -39,7 +116,11 @@ void ApplyPasses(Graph* g, const std::vector<std::string>& passes) {
         CHECK(!pass_dep) << "And the attribute is provided by pass [" << pass_dep->name << "].";
       }
     }
-    r->body(g);
+    utils::CompileStats::PhaseTimer stats_timer("GraphPass " + r->name);
+    if (!ApplyPartitionPass(g, r)) {
+      r->body(g);
+    }
+    stats_timer.SetIRSize(g->nodes().size());
     cinn::hlir::framework::PassPrinter::GetInstance()->PassEnd(r->name, g);
   }
 }
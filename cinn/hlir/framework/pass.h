@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +32,17 @@ namespace framework {
 class PassFunctionRegister;
 typedef std::function<void(Graph* g)> PassFunction;
 
+/**
+ * A weakly connected component of a graph, which shares no variable with the other components.
+ */
+struct GraphPartition {
+  //! the operator nodes in topological order
+  std::vector<Node*> nodes;
+  //! the fusion groups of the nodes in the order of Graph::fusion_groups, replaced by the ones the pass results in
+  std::vector<std::shared_ptr<Graph::Group>> fusion_groups;
+};
+typedef std::function<void(Graph* g, GraphPartition* partition)> PartitionPassFunction;
+
 /**
  * \brief Given an attribute of graph, find the pass that generates this attribute.
  * @param attr_name Name of the graph attribute.
@@ -46,6 +59,10 @@ class PassFunctionRegister : public FunctionRegEntryBase<PassFunctionRegister, P
   std::vector<std::string> graph_attr_dependency{};
   //! generated targets of graph attributes
   std::vector<std::string> graph_attr_targets{};
+  //! the body applied on each partition of the graph, null if the pass is not partitionable
+  PartitionPassFunction partition_body{nullptr};
+  //! whether the partition body is used currently, such as by the flags, always if null
+  std::function<bool()> partition_enabled{nullptr};
 
   /**
    * \brief Imply whether this pass will change the Graph's structure.
@@ -57,6 +74,21 @@ class PassFunctionRegister : public FunctionRegEntryBase<PassFunctionRegister, P
     return *this;
   }
 
+  /**
+   * \brief Declare this pass partitionable: it only reads the graph and changes Graph::fusion_groups, and never
+   *        merges the groups of different weakly connected components. So the large graphs are split into the
+   *        components to apply the pass in parallel, and the resulting groups are concatenated in the order of the
+   *        components, which is deterministic.
+   * @param body The body applied on a partition of the graph.
+   * @param enabled Whether the pass is partitionable currently, optional.
+   * @return Reference to self.
+   */
+  PassFunctionRegister& set_partition_body(PartitionPassFunction body, std::function<bool()> enabled = nullptr) {
+    partition_body    = std::move(body);
+    partition_enabled = std::move(enabled);
+    return *this;
+  }
+
   /**
    * \brief Declare that this pass will generate the given graph attribute name
    *        once it is applied on the graph.
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/roofline.h"
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include "cinn/utils/string.h"
+#ifdef CINN_WITH_CUDA
+#include "cinn/backends/cuda_util.h"
+#endif
+#ifdef CINN_WITH_ROCM
+#include "cinn/runtime/hip/hip_util.h"
+#endif
+
+DECLARE_double(cinn_roofline_peak_gflops);
+DECLARE_double(cinn_roofline_peak_gbps);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// the max frequency of the host CPU in GHz, 0 if unknown
+double MaxCpuGHz() {
+  std::ifstream max_freq("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+  double khz = 0.;
+  if (max_freq >> khz && khz > 0.) {
+    return khz * 1e-6;
+  }
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    auto pos = line.find(':');
+    if (line.rfind("cpu MHz", 0) == 0 && pos != std::string::npos) {
+      return std::stod(line.substr(pos + 1)) * 1e-3;
+    }
+  }
+  return 0.;
+}
+
+#ifdef CINN_WITH_CUDA
+// the FP32 lanes of a multiprocessor of the compute capability
+int Fp32CoresPerSM(int compute_capability) {
+  switch (compute_capability) {
+    case 61:
+    case 62:
+      return 128;
+    case 60:
+    case 70:
+    case 72:
+    case 75:
+    case 80:
+      return 64;
+    default:
+      return compute_capability >= 86 ? 128 : 64;
+  }
+}
+#endif
+
+}  // namespace
+
+DevicePeak GetDevicePeak(const common::Target& target) {
+  DevicePeak peak;
+  if (target.is_cpu()) {
+    int lanes   = target.cpu_vector_bits() / 32;
+    peak.gflops = target.cpu_info().num_cores * lanes * 2 /* FMA units */ * 2 /* flops of an FMA */ * MaxCpuGHz();
+  }
+#ifdef CINN_WITH_CUDA
+  if (target.arch == common::Target::Arch::NVGPU) {
+    int device, num_sm, clock_khz, memory_clock_khz, bus_bits;
+    CUDA_CALL(cudaGetDevice(&device));
+    CUDA_CALL(cudaDeviceGetAttribute(&num_sm, cudaDevAttrMultiProcessorCount, device));
+    CUDA_CALL(cudaDeviceGetAttribute(&clock_khz, cudaDevAttrClockRate, device));
+    CUDA_CALL(cudaDeviceGetAttribute(&memory_clock_khz, cudaDevAttrMemoryClockRate, device));
+    CUDA_CALL(cudaDeviceGetAttribute(&bus_bits, cudaDevAttrGlobalMemoryBusWidth, device));
+    peak.gflops = num_sm * Fp32CoresPerSM(target.get_compute_capability()) * 2. * clock_khz * 1e-6;
+    // the memory transfers on both edges of the clock
+    peak.gbytes_per_sec = 2. * memory_clock_khz * (bus_bits / 8) * 1e-6;
+  }
+#endif
+#ifdef CINN_WITH_ROCM
+  if (target.arch == common::Target::Arch::AMDGPU) {
+    int device, num_cu, clock_khz, memory_clock_khz, bus_bits;
+    HIP_CALL(hipGetDevice(&device));
+    HIP_CALL(hipDeviceGetAttribute(&num_cu, hipDeviceAttributeMultiprocessorCount, device));
+    HIP_CALL(hipDeviceGetAttribute(&clock_khz, hipDeviceAttributeClockRate, device));
+    HIP_CALL(hipDeviceGetAttribute(&memory_clock_khz, hipDeviceAttributeMemoryClockRate, device));
+    HIP_CALL(hipDeviceGetAttribute(&bus_bits, hipDeviceAttributeMemoryBusWidth, device));
+    // a compute unit has 64 FP32 lanes
+    peak.gflops         = num_cu * 64 * 2. * clock_khz * 1e-6;
+    peak.gbytes_per_sec = 2. * memory_clock_khz * (bus_bits / 8) * 1e-6;
+  }
+#endif
+  if (FLAGS_cinn_roofline_peak_gflops > 0.) {
+    peak.gflops = FLAGS_cinn_roofline_peak_gflops;
+  }
+  if (FLAGS_cinn_roofline_peak_gbps > 0.) {
+    peak.gbytes_per_sec = FLAGS_cinn_roofline_peak_gbps;
+  }
+  return peak;
+}
+
+std::string RooflineReport::ToString(int top_k) const {
+  auto lost_ms = [](const KernelRoofline& kernel) { return kernel.total_ms * (1. - kernel.bound_ratio); };
+  std::vector<int> order(kernels.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return lost_ms(kernels[a]) > lost_ms(kernels[b]); });
+  if (top_k > 0 && top_k < order.size()) {
+    order.resize(top_k);
+  }
+
+  std::stringstream ss;
+  ss << "Roofline of " << kernels.size() << " kernels, peak " << std::fixed << std::setprecision(3) << peak.gflops
+     << " GFLOPS and " << peak.gbytes_per_sec << " GB/s\n";
+  ss << std::setw(6) << "index" << std::setw(12) << "avg(ms)" << std::setw(12) << "MFLOP" << std::setw(12) << "MB"
+     << std::setw(11) << "flop/byte" << std::setw(12) << "GFLOPS" << std::setw(12) << "GB/s" << std::setw(8)
+     << "bound" << std::setw(10) << "achieved" << std::setw(12) << "lost(ms)" << "  functions\n";
+  for (int idx : order) {
+    auto& kernel = kernels[idx];
+    ss << std::setw(6) << kernel.index << std::setw(12) << kernel.avg_ms << std::setw(12) << kernel.work.flops * 1e-6
+       << std::setw(12) << (kernel.work.bytes_read + kernel.work.bytes_written) / (1 << 20) << std::setw(11)
+       << kernel.work.arithmetic_intensity() << std::setw(12) << kernel.achieved_gflops << std::setw(12)
+       << kernel.achieved_gbytes_per_sec << std::setw(8) << (kernel.memory_bound ? "memory" : "compute")
+       << std::setw(9) << kernel.bound_ratio * 100 << "%" << std::setw(12) << lost_ms(kernel) << "  "
+       << utils::Join(kernel.fn_names, ", ") << "\n";
+  }
+  return ss.str();
+}
+
+RooflineReport BuildRooflineReport(const ProfileReport& profile,
+                                   const std::map<std::string, auto_schedule::KernelWork>& works,
+                                   const DevicePeak& peak) {
+  RooflineReport report;
+  report.peak = peak;
+  for (int i = 0; i < profile.instructions.size(); ++i) {
+    auto& instr = profile.instructions[i];
+    if (instr.fn_names.empty() || instr.avg_ms() <= 0.) continue;
+    KernelRoofline kernel;
+    bool analyzed = true;
+    for (auto& fn_name : instr.fn_names) {
+      auto it = works.find(fn_name);
+      if (it == works.end()) {
+        analyzed = false;
+        break;
+      }
+      kernel.work.flops += it->second.flops;
+      kernel.work.bytes_read += it->second.bytes_read;
+      kernel.work.bytes_written += it->second.bytes_written;
+    }
+    if (!analyzed) continue;
+
+    kernel.index                   = i;
+    kernel.fn_names                = instr.fn_names;
+    kernel.total_ms                = instr.total_ms;
+    kernel.avg_ms                  = instr.avg_ms();
+    kernel.achieved_gflops         = kernel.work.flops / kernel.avg_ms * 1e-6;
+    kernel.achieved_gbytes_per_sec = (kernel.work.bytes_read + kernel.work.bytes_written) / kernel.avg_ms * 1e-6;
+    // the intensity where the bandwidth roof meets the compute roof
+    double ridge_point  = peak.gbytes_per_sec > 0. ? peak.gflops / peak.gbytes_per_sec : 0.;
+    kernel.memory_bound = peak.gbytes_per_sec > 0. &&
+                          (peak.gflops <= 0. || kernel.work.arithmetic_intensity() < ridge_point);
+    if (kernel.memory_bound) {
+      kernel.bound_ratio = kernel.achieved_gbytes_per_sec / peak.gbytes_per_sec;
+    } else if (peak.gflops > 0.) {
+      kernel.bound_ratio = kernel.achieved_gflops / peak.gflops;
+    }
+    report.kernels.emplace_back(std::move(kernel));
+  }
+  return report;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/instruction_profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// the peak FP32 compute and memory bandwidth of the device running the kernels, 0 if unknown
+struct DevicePeak {
+  double gflops{0.};
+  double gbytes_per_sec{0.};
+};
+
+/**
+ * The peaks of \p target, which are overridden by FLAGS_cinn_roofline_peak_gflops and FLAGS_cinn_roofline_peak_gbps
+ * if positive. Those of a GPU are queried from the current device, and the compute of a CPU is estimated from its
+ * cores, vector width and max frequency assuming two FMA units per core, while its bandwidth is unknown.
+ */
+DevicePeak GetDevicePeak(const common::Target& target);
+
+struct KernelRoofline {
+  // the index of the instruction
+  int index{-1};
+  // the names of the fused functions run by the instruction
+  std::vector<std::string> fn_names;
+  // the static work of one launch, summed over the functions
+  auto_schedule::KernelWork work;
+  double total_ms{0.};
+  double avg_ms{0.};
+  double achieved_gflops{0.};
+  double achieved_gbytes_per_sec{0.};
+  // whether the arithmetic intensity is under the ridge point of the roofline
+  bool memory_bound{false};
+  // the share of the bound of the roofline achieved, the peak bandwidth if memory bound or the peak compute otherwise
+  double bound_ratio{0.};
+};
+
+struct RooflineReport {
+  DevicePeak peak;
+  // in the order of the instructions, only those whose functions are all analyzed and which are run
+  std::vector<KernelRoofline> kernels;
+
+  //! A table of the kernels sorted by the time lost to their bounds, which is total_ms * (1 - bound_ratio), only the
+  //! top \p top_k ones are listed if it is positive.
+  std::string ToString(int top_k = 0) const;
+};
+
+/**
+ * Combine the time of each instruction in \p profile with the static work of its functions in \p works, keyed by the
+ * function names, into the roofline of the instruction on a device of \p peak.
+ */
+RooflineReport BuildRooflineReport(const ProfileReport& profile,
+                                   const std::map<std::string, auto_schedule::KernelWork>& works,
+                                   const DevicePeak& peak);
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/roofline.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(Roofline, BuildReport) {
+  auto add_profile = [](ProfileReport* report, const std::string& fn_name, double total_ms) {
+    InstructionProfile profile;
+    profile.fn_names     = {fn_name};
+    profile.launch_count = 2;
+    profile.total_ms     = total_ms;
+    report->instructions.push_back(profile);
+  };
+  ProfileReport profile;
+  profile.num_runs = 2;
+  add_profile(&profile, "fn_copy", 2.);
+  add_profile(&profile, "fn_matmul", 4.);
+  add_profile(&profile, "fn_library_call", 1.);
+
+  std::map<std::string, auto_schedule::KernelWork> works;
+  // 1 GB in 1 ms
+  works["fn_copy"].bytes_read    = 5e8;
+  works["fn_copy"].bytes_written = 5e8;
+  // 1 TFLOP in 2 ms over 10 MB
+  works["fn_matmul"].flops      = 1e12;
+  works["fn_matmul"].bytes_read = 1e7;
+
+  DevicePeak peak;
+  peak.gflops         = 1e6;
+  peak.gbytes_per_sec = 2e3;
+  auto report         = BuildRooflineReport(profile, works, peak);
+  // the library call has no work analyzed
+  ASSERT_EQ(report.kernels.size(), 2UL);
+
+  auto& copy = report.kernels[0];
+  ASSERT_EQ(copy.index, 0);
+  ASSERT_DOUBLE_EQ(copy.avg_ms, 1.);
+  ASSERT_DOUBLE_EQ(copy.achieved_gbytes_per_sec, 1e3);
+  ASSERT_TRUE(copy.memory_bound);
+  ASSERT_DOUBLE_EQ(copy.bound_ratio, 0.5);
+
+  auto& matmul = report.kernels[1];
+  ASSERT_EQ(matmul.index, 1);
+  ASSERT_DOUBLE_EQ(matmul.achieved_gflops, 5e5);
+  ASSERT_FALSE(matmul.memory_bound);
+  ASSERT_DOUBLE_EQ(matmul.bound_ratio, 0.5);
+
+  // the matmul loses 2 ms to its bound and the copy loses 1 ms
+  auto table = report.ToString(1);
+  ASSERT_NE(table.find("fn_matmul"), std::string::npos);
+  ASSERT_EQ(table.find("fn_copy"), std::string::npos);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
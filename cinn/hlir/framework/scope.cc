@@ -21,16 +21,24 @@ namespace hlir {
 namespace framework {
 
 void Scope::EraseVar(const std::string& name) {
-  CHECK(data_.count(name)) << "Variable(" << name << ") not found";
-  data_.erase(name);
+  auto it = name2id_.find(name);
+  CHECK(it != name2id_.end() && vars_[it->second]) << "Variable(" << name << ") not found";
+  // the id is kept for the name, so that it is the same if the variable is created again
+  vars_[it->second].reset();
 }
 
 Variable* Scope::FindVar(const std::string& name) const {
-  auto it = data_.find(name);
-  if (it != data_.end()) return it->second.get();
+  auto it = name2id_.find(name);
+  if (it != name2id_.end()) return vars_[it->second].get();
   return nullptr;
 }
 
+int Scope::FindVarId(const std::string& name) const {
+  auto it = name2id_.find(name);
+  if (it != name2id_.end() && vars_[it->second]) return it->second;
+  return -1;
+}
+
 Tensor Scope::GetTensor(const std::string& name) const {
   CheckVarNameValid(name);
   auto* var = FindVar(name);
@@ -38,10 +46,18 @@ Tensor Scope::GetTensor(const std::string& name) const {
   return absl::get<Tensor>(*var);
 }
 
+Tensor Scope::GetTensor(int id) const {
+  auto* var = GetVar(id);
+  CHECK(var) << "The variable [" << names_[id] << "] of id " << id << " has been erased";
+  return absl::get<Tensor>(*var);
+}
+
 std::vector<absl::string_view> Scope::var_names() const {
   std::vector<absl::string_view> names;
-  for (auto& item : data_) {
-    names.push_back(item.first);
+  for (int id = 0; id < vars_.size(); ++id) {
+    if (vars_[id]) {
+      names.push_back(names_[id]);
+    }
   }
   return names;
 }
@@ -33,6 +33,11 @@ using Variable = absl::variant<Tensor>;
 
 struct _Tensor_;
 
+/**
+ * Scope holds the variables of a program. Each variable gets an integer id when it is first created, which is kept
+ * for the name even if the variable is erased and created again, so the ids resolved at compile time stay valid and
+ * the runtime looks the variables up by index. The lookups by name are kept for debugging and the Python API.
+ */
 class Scope {
  public:
   static std::shared_ptr<Scope> Create() { return std::make_shared<Scope>(); }
@@ -49,24 +54,51 @@ class Scope {
 
   Tensor GetTensor(const std::string& name) const;
 
+  //! Get the id of a variable, -1 if not exists.
+  int FindVarId(const std::string& name) const;
+
+  //! Get the variable by its id, null if it has been erased.
+  Variable* GetVar(int id) const {
+    CHECK(id >= 0 && id < vars_.size()) << "Variable id " << id << " is out of the scope";
+    return vars_[id].get();
+  }
+
+  Tensor GetTensor(int id) const;
+
+  const std::string& GetVarName(int id) const {
+    CHECK(id >= 0 && id < names_.size()) << "Variable id " << id << " is out of the scope";
+    return names_[id];
+  }
+
   //! Get variable names.
   std::vector<absl::string_view> var_names() const;
 
   Scope() = default;
 
  private:
-  absl::flat_hash_map<std::string, std::unique_ptr<Variable>> data_;
+  // the variables and their names indexed by the ids
+  std::vector<std::unique_ptr<Variable>> vars_;
+  std::vector<std::string> names_;
+  absl::flat_hash_map<std::string, int> name2id_;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Scope);
 };
 
 template <typename T>
 Variable* Scope::Var(const std::string& name) {
+  auto it = name2id_.find(name);
+  if (it != name2id_.end() && vars_[it->second]) {
+    return vars_[it->second].get();
+  }
   VLOG(4) << "Scope insert Var [" << name << "]";
-  Variable* x = FindVar(name);
-  if (x) return x;
   auto* data = new Variable(T());
-  data_[name].reset(data);
+  if (it != name2id_.end()) {
+    vars_[it->second].reset(data);
+    return data;
+  }
+  name2id_.emplace(name, vars_.size());
+  vars_.emplace_back(data);
+  names_.push_back(name);
   return data;
 }
 
@@ -40,6 +40,25 @@ TEST(ScopeTest, TestEraseVar) {
   ASSERT_DEATH(scope.EraseVar("key"), "");
 }
 
+TEST(ScopeTest, TestVarId) {
+  Scope scope;
+  scope.Var<Tensor>("x");
+  scope.Var<Tensor>("y");
+  int id = scope.FindVarId("y");
+  ASSERT_GE(id, 0);
+  EXPECT_EQ(scope.GetVarName(id), "y");
+  EXPECT_EQ(scope.GetVar(id), scope.FindVar("y"));
+  EXPECT_EQ(scope.FindVarId("z"), -1);
+
+  // the id is kept for the name after the variable is erased and created again
+  scope.EraseVar("y");
+  EXPECT_EQ(scope.FindVarId("y"), -1);
+  EXPECT_EQ(scope.GetVar(id), nullptr);
+  scope.Var<Tensor>("y");
+  EXPECT_EQ(scope.FindVarId("y"), id);
+  EXPECT_EQ(scope.var_names().size(), 2);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -48,6 +48,10 @@ void _Tensor_::set_type(Type type) {
     buffer_->data()->type = cinn_bfloat16_t();
   } else if (type.is_float16()) {
     buffer_->data()->type = cinn_float16_t();
+  } else if (type.is_float8_e4m3()) {
+    buffer_->data()->type = cinn_float8_e4m3_t();
+  } else if (type.is_float8_e5m2()) {
+    buffer_->data()->type = cinn_float8_e5m2_t();
   } else {
     buffer_->data()->type = cinn_unk_t();
   }
@@ -0,0 +1,341 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/weight_offloader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// the alignment of the parameters in the rotating buffer
+constexpr size_t kAlignment = 256;
+// the number of the pinned buffers staging the reads from the spill file, a read overlaps with the copy of the other
+constexpr int kNumStaging = 2;
+
+size_t AlignUp(size_t bytes) { return (bytes + kAlignment - 1) / kAlignment * kAlignment; }
+
+void WriteAll(int fd, const void* data, size_t bytes, size_t offset) {
+  auto* ptr = static_cast<const char*>(data);
+  while (bytes > 0) {
+    ssize_t written = pwrite(fd, ptr, bytes, offset);
+    CHECK_GT(written, 0) << "Failed to write the spilled parameters";
+    ptr += written;
+    offset += written;
+    bytes -= written;
+  }
+}
+
+void ReadAll(int fd, void* data, size_t bytes, size_t offset) {
+  auto* ptr = static_cast<char*>(data);
+  while (bytes > 0) {
+    ssize_t num_read = pread(fd, ptr, bytes, offset);
+    CHECK_GT(num_read, 0) << "Failed to read the spilled parameters";
+    ptr += num_read;
+    offset += num_read;
+    bytes -= num_read;
+  }
+}
+
+}  // namespace
+
+std::vector<WeightOffloader::Segment> WeightOffloader::PlanSegments(
+    const std::vector<std::pair<int, size_t>>& instr_bytes, size_t buffer_bytes) {
+  std::vector<Segment> segments;
+  size_t head = 0;
+  for (auto& item : instr_bytes) {
+    size_t bytes = item.second;
+    CHECK_LE(bytes, buffer_bytes) << "The offloaded parameters of the instruction " << item.first << " take " << bytes
+                                  << " bytes, which don't fit into the device buffer of " << buffer_bytes << " bytes";
+    if (head + bytes > buffer_bytes) {
+      head = 0;
+    }
+    Segment segment{item.first, head, bytes, -1};
+    for (int j = static_cast<int>(segments.size()) - 1; j >= 0; --j) {
+      if (segments[j].offset < head + bytes && head < segments[j].offset + segments[j].bytes) {
+        segment.reuse_after = j;
+        break;
+      }
+    }
+    segments.push_back(segment);
+    head += bytes;
+  }
+  return segments;
+}
+
+WeightOffloader::WeightOffloader(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                                 Scope* scope,
+                                 const Target& target,
+                                 const WeightOffloadOptions& options)
+    : instrs_(instrs), target_(target) {
+  CHECK(target_.arch == Target::Arch::NVGPU) << "Offloading the weights is only supported on NVGPU";
+  // the readers of each variable and the written ones, an offloaded parameter has exactly one reader
+  std::unordered_map<std::string, std::set<int>> readers;
+  std::set<std::string> written;
+  for (int i = 0; i < instrs_.size(); ++i) {
+    for (auto& args : instrs_[i]->GetInArgs()) {
+      for (auto& name : args) readers[name].insert(i);
+    }
+    for (auto& args : instrs_[i]->GetOutArgs()) {
+      written.insert(args.begin(), args.end());
+    }
+  }
+
+  // the offloaded parameters of each instruction in the order of their names given
+  std::map<int, std::vector<int>> instr_params;
+  for (auto& name : options.params) {
+    auto* var = scope->FindVar(name);
+    CHECK(var) << "Parameter [" << name << "] not found in the scope";
+    auto& tensor = absl::get<Tensor>(*var);
+    size_t bytes = tensor->shape().numel() * tensor->type().bytes();
+    auto it      = readers.find(name);
+    if (bytes < options.threshold_bytes || it == readers.end() || !tensor->buffer()->memory) {
+      continue;
+    }
+    // the buffer is referenced by the tensor and the temporary copy here unless shared with other tensors
+    if (it->second.size() != 1 || written.count(name) || tensor->get_buffer().use_count() > 2) {
+      VLOG(3) << "Parameter [" << name << "] is kept on device, it is read by " << it->second.size()
+              << " instructions, or written, or shared with other scopes";
+      continue;
+    }
+    instr_params[*it->second.begin()].push_back(params_.size());
+    params_.push_back(Param{name, tensor->get_buffer(), bytes, 0});
+  }
+
+  std::vector<std::pair<int, size_t>> instr_bytes;
+  for (auto& item : instr_params) {
+    size_t offset = 0;
+    for (int id : item.second) {
+      params_[id].offset = offset;
+      offset += AlignUp(params_[id].bytes);
+    }
+    instr_bytes.emplace_back(item.first, offset);
+  }
+  segments_ = PlanSegments(instr_bytes, options.device_buffer_bytes);
+  instr_segments_.assign(instrs_.size(), -1);
+  segment_params_.resize(segments_.size());
+  size_t buffer_bytes = 0;
+  for (int s = 0; s < segments_.size(); ++s) {
+    instr_segments_[segments_[s].instr] = s;
+    segment_params_[s]                  = instr_params[segments_[s].instr];
+    buffer_bytes                        = std::max(buffer_bytes, segments_[s].offset + segments_[s].bytes);
+  }
+
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaGetDevice(&device_id_));
+  if (!options.spill_dir.empty()) {
+    spill_path_ = options.spill_dir + "/cinn_offload_" + std::to_string(getpid()) + "_" +
+                  std::to_string(reinterpret_cast<uintptr_t>(this)) + ".bin";
+    spill_fd_ = open(spill_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    CHECK_GE(spill_fd_, 0) << "Cannot open the file to spill the parameters: " << spill_path_;
+  }
+  // move the parameters out of the device memory, through a pinned buffer when spilled to the file
+  size_t max_bytes = 0;
+  for (auto& param : params_) {
+    max_bytes = std::max(max_bytes, param.bytes);
+  }
+  if (spill_fd_ >= 0) {
+    staging_.resize(kNumStaging);
+    for (auto& staging : staging_) {
+      CUDA_CALL(cudaHostAlloc(&staging, max_bytes, cudaHostAllocDefault));
+    }
+  }
+  size_t file_offset = 0;
+  for (auto& param : params_) {
+    void* device_ptr = param.buffer->data()->memory;
+    if (spill_fd_ >= 0) {
+      CUDA_CALL(cudaMemcpy(staging_[0], device_ptr, param.bytes, cudaMemcpyDeviceToHost));
+      WriteAll(spill_fd_, staging_[0], param.bytes, file_offset);
+      param.file_offset = file_offset;
+      file_offset += param.bytes;
+    } else {
+      CUDA_CALL(cudaHostAlloc(&param.host, param.bytes, cudaHostAllocDefault));
+      CUDA_CALL(cudaMemcpy(param.host, device_ptr, param.bytes, cudaMemcpyDeviceToHost));
+    }
+    offloaded_names_.push_back(param.name);
+    offloaded_bytes_ += param.bytes;
+  }
+
+  // bind the parameters to their segments, which frees their own device memory
+  if (buffer_bytes > 0) {
+    CUDA_CALL(cudaMalloc(&device_buffer_, buffer_bytes));
+  }
+  for (int s = 0; s < segments_.size(); ++s) {
+    for (int id : segment_params_[s]) {
+      auto* dst = static_cast<uint8_t*>(device_buffer_) + segments_[s].offset + params_[id].offset;
+      params_[id].buffer->SetExternalMemory(dst, params_[id].bytes);
+    }
+  }
+
+  cudaStream_t copy_stream;
+  CUDA_CALL(cudaStreamCreateWithFlags(&copy_stream, cudaStreamNonBlocking));
+  copy_stream_ = copy_stream;
+  auto create_events = [](int num, std::vector<void*>* events) {
+    events->resize(num);
+    for (auto& event : *events) {
+      cudaEvent_t e;
+      CUDA_CALL(cudaEventCreateWithFlags(&e, cudaEventDisableTiming));
+      event = e;
+    }
+  };
+  create_events(segments_.size(), &ready_events_);
+  create_events(segments_.size(), &done_events_);
+  create_events(staging_.size(), &staging_events_);
+  cudaEvent_t run_event;
+  CUDA_CALL(cudaEventCreateWithFlags(&run_event, cudaEventDisableTiming));
+  run_event_ = run_event;
+  LOG(INFO) << "Offload " << params_.size() << " parameters of " << offloaded_bytes_ << " bytes to "
+            << (spill_fd_ >= 0 ? spill_path_ : std::string("pinned host memory")) << ", uploaded by "
+            << segments_.size() << " segments into a device buffer of " << buffer_bytes << " bytes";
+#else
+  LOG(FATAL) << "Offloading the weights requires CINN compiled with CUDA";
+#endif
+}
+
+WeightOffloader::~WeightOffloader() {
+#ifdef CINN_WITH_CUDA
+  Restore();
+  for (auto& param : params_) {
+    if (param.host) cudaFreeHost(param.host);
+  }
+  for (auto* staging : staging_) {
+    if (staging) cudaFreeHost(staging);
+  }
+  for (auto* events : {&ready_events_, &done_events_, &staging_events_}) {
+    for (auto* event : *events) {
+      if (event) cudaEventDestroy(static_cast<cudaEvent_t>(event));
+    }
+  }
+  if (run_event_) cudaEventDestroy(static_cast<cudaEvent_t>(run_event_));
+  if (copy_stream_) cudaStreamDestroy(static_cast<cudaStream_t>(copy_stream_));
+  if (device_buffer_) cudaFree(device_buffer_);
+#endif
+  if (spill_fd_ >= 0) {
+    close(spill_fd_);
+    std::remove(spill_path_.c_str());
+  }
+}
+
+void WeightOffloader::Restore() {
+#ifdef CINN_WITH_CUDA
+  // wait for the last run reading the rotating buffer, then move each parameter back to its own device memory
+  if (run_event_) CUDA_CALL(cudaEventSynchronize(static_cast<cudaEvent_t>(run_event_)));
+  for (int i = 0; i < params_.size(); ++i) {
+    auto& param = params_[i];
+    param.buffer->SetExternalMemory(nullptr, 0);
+    param.buffer->Resize(param.bytes);
+    Upload(param, param.buffer->data()->memory, i % kNumStaging);
+  }
+  if (copy_stream_) CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(copy_stream_)));
+#endif
+}
+
+void WeightOffloader::Upload(const Param& param, void* dst, int staging_id) {
+#ifdef CINN_WITH_CUDA
+  auto copy_stream = static_cast<cudaStream_t>(copy_stream_);
+  const void* src  = param.host;
+  if (spill_fd_ >= 0) {
+    // the staging buffer is reused once its previous copy finishes
+    auto staging_event = static_cast<cudaEvent_t>(staging_events_[staging_id]);
+    CUDA_CALL(cudaEventSynchronize(staging_event));
+    ReadAll(spill_fd_, staging_[staging_id], param.bytes, param.file_offset);
+    src = staging_[staging_id];
+  }
+  CUDA_CALL(cudaMemcpyAsync(dst, src, param.bytes, cudaMemcpyHostToDevice, copy_stream));
+  if (spill_fd_ >= 0) {
+    CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(staging_events_[staging_id]), copy_stream));
+  }
+#endif
+}
+
+void WeightOffloader::Prefetch() {
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaSetDevice(device_id_));
+  auto copy_stream = static_cast<cudaStream_t>(copy_stream_);
+  int num_copies   = 0;
+  for (int s = 0; s < segments_.size(); ++s) {
+    int reuse_after = segments_[s].reuse_after;
+    if (reuse_after >= 0) {
+      // the event of the instruction reusing the memory is recorded once it is launched
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this, reuse_after] { return num_launched_ > reuse_after; });
+      lock.unlock();
+      CUDA_CALL(cudaStreamWaitEvent(copy_stream, static_cast<cudaEvent_t>(done_events_[reuse_after]), 0));
+    }
+    for (int id : segment_params_[s]) {
+      auto* dst = static_cast<uint8_t*>(device_buffer_) + segments_[s].offset + params_[id].offset;
+      Upload(params_[id], dst, num_copies++ % kNumStaging);
+    }
+    CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(ready_events_[s]), copy_stream));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      num_uploaded_ = s + 1;
+    }
+    cv_.notify_all();
+  }
+#endif
+}
+
+void WeightOffloader::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
+#ifdef CINN_WITH_CUDA
+  utils::RecordEvent record_run("WeightOffloader Run", utils::EventType::kOrdinary);
+  auto compute_stream = static_cast<cudaStream_t>(stream);
+  auto copy_stream    = static_cast<cudaStream_t>(copy_stream_);
+  // the first segments overwrite the memory read by the last ones of the previous run
+  CUDA_CALL(cudaStreamWaitEvent(copy_stream, static_cast<cudaEvent_t>(run_event_), 0));
+  num_uploaded_ = 0;
+  num_launched_ = 0;
+  std::thread prefetch_thread([this] { Prefetch(); });
+
+  for (int i = 0; i < instrs_.size(); ++i) {
+    int s = instr_segments_[i];
+    if (s >= 0) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this, s] { return num_uploaded_ > s; });
+      lock.unlock();
+      CUDA_CALL(cudaStreamWaitEvent(compute_stream, static_cast<cudaEvent_t>(ready_events_[s]), 0));
+    }
+    instrs_[i]->Run(name2podargs, false, stream, use_cache);
+    if (s >= 0) {
+      CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(done_events_[s]), compute_stream));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_launched_ = s + 1;
+      }
+      cv_.notify_all();
+    }
+  }
+  prefetch_thread.join();
+  CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(run_event_), compute_stream));
+#else
+  LOG(FATAL) << "Offloading the weights requires CINN compiled with CUDA";
+#endif
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,154 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+struct WeightOffloadOptions {
+  //! The parameters that may be offloaded, the ones of at least threshold_bytes are offloaded and the others stay on
+  //! device.
+  std::vector<std::string> params;
+  size_t threshold_bytes = 64UL << 20;
+  //! The bytes of the rotating device buffer the offloaded parameters are uploaded into, it must hold the offloaded
+  //! parameters of any single instruction, and a larger one prefetches further ahead.
+  size_t device_buffer_bytes = 1UL << 30;
+  //! The directory to spill the offloaded parameters to, such as one on an NVMe disk, they are read back through
+  //! pinned staging buffers on running. Empty means keeping them in pinned host memory.
+  std::string spill_dir;
+};
+
+/**
+ * WeightOffloader keeps the large parameters of a Program out of the device memory, and uploads them into a rotating
+ * device buffer ahead of the instructions consuming them, so that a model whose weights don't fit into the device
+ * memory can be run.
+ *
+ * The uploads are planned by the order of the instructions: the offloaded parameters of an instruction take a segment
+ * of the rotating buffer right after the one of the previous consumer, wrapping around at the end. Each parameter is
+ * bound to the address of its segment once, so the cached arguments of the instructions stay valid.
+ *
+ * On running, a prefetch thread issues the uploads in order on a separate copy stream. The upload of a segment waits
+ * on the event of the last instruction using the memory it overwrites, and an instruction waits on the event of its
+ * upload before being launched, so the copies of the following segments overlap with the kernels running before them.
+ *
+ * The parameters read by more than one instruction, written by any, or shared with other scopes by the WeightStore are
+ * kept on device. The offloaded parameters are uploaded back to their own device memory when the offloader is freed.
+ */
+class WeightOffloader {
+ public:
+  //! The range of the rotating buffer holding the offloaded parameters of an instruction.
+  struct Segment {
+    int instr;
+    size_t offset;
+    size_t bytes;
+    //! The last segment before this one overlapping it, its instruction must finish before uploading this one, -1 if
+    //! none in the same run.
+    int reuse_after;
+  };
+
+  /**
+   * @param instrs The instructions to run, in the order of execution, they must outlive the offloader.
+   * @param scope The scope holding the parameters.
+   * @param target The target of the instructions, only NVGPU is supported.
+   * @param options The parameters to offload and the size of the rotating buffer.
+   */
+  WeightOffloader(const std::vector<std::unique_ptr<Instruction>>& instrs,
+                  Scope* scope,
+                  const Target& target,
+                  const WeightOffloadOptions& options);
+  ~WeightOffloader();
+
+  //! Run the instructions on \p stream with the offloaded parameters uploaded ahead of them.
+  void Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache);
+
+  //! The names of the offloaded parameters, and their bytes in total.
+  const std::vector<std::string>& offloaded_params() const { return offloaded_names_; }
+  size_t offloaded_bytes() const { return offloaded_bytes_; }
+
+  const std::vector<Segment>& segments() const { return segments_; }
+
+  //! Place the segments of \p instr_bytes, which are pairs of the instruction and its bytes in the order of execution,
+  //! into a rotating buffer of \p buffer_bytes.
+  static std::vector<Segment> PlanSegments(const std::vector<std::pair<int, size_t>>& instr_bytes, size_t buffer_bytes);
+
+ private:
+  struct Param {
+    std::string name;
+    std::shared_ptr<Buffer> buffer;
+    size_t bytes;
+    // the offset in the segment of the instruction reading it
+    size_t offset;
+    // the pinned host memory holding it, or the offset in the spill file
+    void* host{nullptr};
+    size_t file_offset{0};
+  };
+
+  // upload the segments in order on the copy stream, run by the prefetch thread
+  void Prefetch();
+  // copy the parameter to the device memory at dst on the copy stream
+  void Upload(const Param& param, void* dst, int staging_id);
+  void Restore();
+
+  const std::vector<std::unique_ptr<Instruction>>& instrs_;
+  Target target_;
+  int device_id_{0};
+
+  std::vector<Param> params_;
+  std::vector<Segment> segments_;
+  // the parameters of each segment, and the segment of each instruction, -1 if none
+  std::vector<std::vector<int>> segment_params_;
+  std::vector<int> instr_segments_;
+  std::vector<std::string> offloaded_names_;
+  size_t offloaded_bytes_{0};
+
+  // the file the parameters are spilled to, and the pinned buffers staging the reads from it
+  std::string spill_path_;
+  int spill_fd_{-1};
+  std::vector<void*> staging_;
+
+  // the rotating device buffer, cudaStream_t and cudaEvent_t, hold as void* to not expose the CUDA headers
+  void* device_buffer_{nullptr};
+  void* copy_stream_{nullptr};
+  std::vector<void*> ready_events_;
+  std::vector<void*> done_events_;
+  std::vector<void*> staging_events_;
+  void* run_event_{nullptr};
+
+  // the progress of a run shared with the prefetch thread: the number of the segments uploaded and launched
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int num_uploaded_{0};
+  int num_launched_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(WeightOffloader);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,52 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/weight_offloader.h"
+
+#include <gtest/gtest.h>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(WeightOffloader, PlanSegments) {
+  // the instructions 1, 3, 4 and 6 read 400, 300, 500 and 200 bytes of offloaded parameters
+  auto segments = WeightOffloader::PlanSegments({{1, 400}, {3, 300}, {4, 500}, {6, 200}}, 1000);
+  ASSERT_EQ(segments.size(), 4UL);
+
+  EXPECT_EQ(segments[0].instr, 1);
+  EXPECT_EQ(segments[0].offset, 0UL);
+  EXPECT_EQ(segments[0].reuse_after, -1);
+  EXPECT_EQ(segments[1].offset, 400UL);
+  EXPECT_EQ(segments[1].reuse_after, -1);
+  // wrap around at the end, the memory of the first two segments is reused
+  EXPECT_EQ(segments[2].offset, 0UL);
+  EXPECT_EQ(segments[2].reuse_after, 1);
+  EXPECT_EQ(segments[3].offset, 500UL);
+  EXPECT_EQ(segments[3].reuse_after, 1);
+}
+
+TEST(WeightOffloader, PlanSegmentsFitAll) {
+  // the buffer holding all the parameters uploads them without waiting on any instruction
+  auto segments = WeightOffloader::PlanSegments({{0, 100}, {2, 100}, {5, 100}}, 300);
+  ASSERT_EQ(segments.size(), 3UL);
+  for (int i = 0; i < segments.size(); ++i) {
+    EXPECT_EQ(segments[i].offset, 100UL * i);
+    EXPECT_EQ(segments[i].reuse_after, -1);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,157 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/weight_store.h"
+
+#include <glog/logging.h>
+
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime.h>
+
+#include "cinn/backends/cuda_util.h"
+#endif
+#include "cinn/utils/functional.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+void CopyToHost(void* dst, const void* src, size_t bytes, const common::Target& target) {
+  if (target.arch == common::Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToHost));
+#else
+    LOG(FATAL) << "NVGPU Target only support on flag CINN_WITH_CUDA ON! Please check.";
+#endif
+  } else {
+    std::memcpy(dst, src, bytes);
+  }
+}
+
+// Whether the buffer holds the bytes of data, the buffer is read back to host on the device targets.
+bool EqualBytes(const Buffer& buffer, const void* data, size_t bytes, const common::Target& target) {
+  const void* memory = buffer.data()->memory;
+  if (target.arch != common::Target::Arch::NVGPU) {
+    return std::memcmp(memory, data, bytes) == 0;
+  }
+  std::vector<char> host(bytes);
+  CopyToHost(host.data(), memory, bytes, target);
+  return std::memcmp(host.data(), data, bytes) == 0;
+}
+
+}  // namespace
+
+uint64_t WeightStore::Hash(const void* data, size_t bytes, const common::Type& type, const std::vector<int>& shape) {
+  uint64_t hash = std::hash<std::string_view>()(std::string_view(static_cast<const char*>(data), bytes));
+  hash          = utils::HashCombine(hash, type.type());
+  hash          = utils::HashCombine(hash, type.bits());
+  for (int dim : shape) {
+    hash = utils::HashCombine(hash, dim);
+  }
+  return hash;
+}
+
+std::shared_ptr<Buffer> WeightStore::FindLocked(uint64_t hash,
+                                                const void* data,
+                                                size_t bytes,
+                                                const common::Type& type,
+                                                const std::vector<int>& shape,
+                                                const common::Target& target) {
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto buffer = it->second.buffer.lock();
+    if (!buffer) {
+      it = entries_.erase(it);
+      continue;
+    }
+    const auto& entry = it->second;
+    if (entry.bytes == bytes && entry.type == type && entry.shape == shape && entry.target == target &&
+        EqualBytes(*buffer, data, bytes, target)) {
+      return buffer;
+    }
+    ++it;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<Buffer> WeightStore::Find(const void* data,
+                                          size_t bytes,
+                                          const common::Type& type,
+                                          const std::vector<int>& shape,
+                                          const common::Target& target) {
+  uint64_t hash = Hash(data, bytes, type, shape);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto buffer = FindLocked(hash, data, bytes, type, shape, target);
+  if (buffer) {
+    saved_bytes_ += bytes;
+  }
+  return buffer;
+}
+
+std::shared_ptr<Buffer> WeightStore::Insert(const std::shared_ptr<Buffer>& buffer,
+                                            const void* data,
+                                            size_t bytes,
+                                            const common::Type& type,
+                                            const std::vector<int>& shape,
+                                            const common::Target& target) {
+  uint64_t hash = Hash(data, bytes, type, shape);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto existing = FindLocked(hash, data, bytes, type, shape, target);
+  if (existing) {
+    saved_bytes_ += bytes;
+    return existing;
+  }
+  entries_.emplace(hash, Entry{bytes, type, shape, target, buffer});
+  return buffer;
+}
+
+bool WeightStore::Share(Tensor tensor, const common::Target& target) {
+  auto* memory = tensor->buffer()->memory;
+  CHECK(memory) << "Only the allocated tensor can be shared";
+  size_t bytes = static_cast<size_t>(tensor->shape().numel()) * tensor->type().bytes();
+
+  const void* data = memory;
+  std::vector<char> host;
+  if (target.arch == common::Target::Arch::NVGPU) {
+    host.resize(bytes);
+    CopyToHost(host.data(), memory, bytes, target);
+    data = host.data();
+  }
+  auto buffer = tensor->get_buffer();
+  auto shared = Insert(buffer, data, bytes, tensor->type(), tensor->shape().data(), target);
+  if (shared == buffer) {
+    return false;
+  }
+  VLOG(4) << "Share the parameter of " << bytes << " bytes with the existing buffer";
+  tensor->set_buffer(shared);
+  return true;
+}
+
+size_t WeightStore::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    it = it->second.buffer.expired() ? entries_.erase(it) : std::next(it);
+  }
+  return entries_.size();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/buffer.h"
+#include "cinn/hlir/framework/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * WeightStore shares the buffers of the parameters with the same bytes, type and shape on the same target across all
+ * the scopes of the process, such as the variants of one model built for different batch sizes. The parameters are
+ * looked up by the hash of their bytes and compared byte by byte on a hit.
+ *
+ * The store only holds weak references, a buffer is refcounted by the tensors sharing it and freed with the last one.
+ * The shared buffers are read-only, the parameters updated in place should not be shared.
+ */
+class WeightStore {
+ public:
+  static WeightStore& Global() {
+    static WeightStore store;
+    return store;
+  }
+
+  //! Find the buffer holding the \p bytes of \p data with \p type and \p shape on \p target, \p data is on host.
+  //! Return nullptr if not found.
+  std::shared_ptr<Buffer> Find(const void* data,
+                               size_t bytes,
+                               const common::Type& type,
+                               const std::vector<int>& shape,
+                               const common::Target& target);
+
+  //! Add \p buffer holding the \p bytes of \p data to the store, and return the buffer to use, which is the one
+  //! already in the store if an identical parameter was added meanwhile.
+  std::shared_ptr<Buffer> Insert(const std::shared_ptr<Buffer>& buffer,
+                                 const void* data,
+                                 size_t bytes,
+                                 const common::Type& type,
+                                 const std::vector<int>& shape,
+                                 const common::Target& target);
+
+  //! Replace the buffer of the allocated \p tensor with the shared one holding the same parameter, or add its buffer
+  //! to the store. Return whether the buffer is replaced.
+  bool Share(Tensor tensor, const common::Target& target);
+
+  //! The number of the buffers alive in the store.
+  size_t size();
+
+  //! The bytes saved by the sharing, which is the size of the parameters served by the existing buffers.
+  size_t saved_bytes() const { return saved_bytes_; }
+
+ private:
+  WeightStore() = default;
+
+  struct Entry {
+    size_t bytes;
+    common::Type type;
+    std::vector<int> shape;
+    common::Target target;
+    std::weak_ptr<Buffer> buffer;
+  };
+
+  static uint64_t Hash(const void* data, size_t bytes, const common::Type& type, const std::vector<int>& shape);
+
+  // find the alive buffer of the same parameter with the hash, and remove the expired entries of the hash
+  std::shared_ptr<Buffer> FindLocked(uint64_t hash,
+                                     const void* data,
+                                     size_t bytes,
+                                     const common::Type& type,
+                                     const std::vector<int>& shape,
+                                     const common::Target& target);
+
+  std::mutex mutex_;
+  std::unordered_multimap<uint64_t, Entry> entries_;
+  std::atomic<size_t> saved_bytes_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(WeightStore);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/weight_store.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+Tensor CreateParam(Scope* scope, const std::string& name, const std::vector<int>& shape, float value) {
+  auto* var    = scope->Var<Tensor>(name);
+  auto& tensor = absl::get<Tensor>(*var);
+  tensor->Resize(Shape{shape});
+  auto* data = tensor->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < tensor->shape().numel(); ++i) {
+    data[i] = value + i;
+  }
+  return tensor;
+}
+
+}  // namespace
+
+TEST(WeightStore, ShareAcrossScopes) {
+  auto target = common::DefaultHostTarget();
+  auto& store = WeightStore::Global();
+  {
+    Scope scope_a, scope_b;
+    auto a = CreateParam(&scope_a, "w", {4, 8}, 1.f);
+    auto b = CreateParam(&scope_b, "w", {4, 8}, 1.f);
+    // the same bytes with another shape or other bytes are not shared
+    auto c = CreateParam(&scope_b, "w_reshaped", {8, 4}, 1.f);
+    auto d = CreateParam(&scope_b, "v", {4, 8}, 2.f);
+
+    EXPECT_FALSE(store.Share(a, target));
+    EXPECT_TRUE(store.Share(b, target));
+    EXPECT_FALSE(store.Share(c, target));
+    EXPECT_FALSE(store.Share(d, target));
+    EXPECT_EQ(a->get_buffer(), b->get_buffer());
+    EXPECT_NE(a->get_buffer(), c->get_buffer());
+    EXPECT_NE(a->get_buffer(), d->get_buffer());
+    EXPECT_EQ(store.size(), 3UL);
+    EXPECT_EQ(store.saved_bytes(), 4 * 8 * sizeof(float));
+  }
+  // the buffers are freed with the scopes
+  EXPECT_EQ(store.size(), 0UL);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
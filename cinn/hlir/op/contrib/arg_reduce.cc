@@ -0,0 +1,97 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+// The arg_reduce outputs the max or the min value along the axis with its first index, it is only created by the
+// ArgReduceRewriter on NVGPU and computed by the single-pass kernel of the runtime through the custom_call.
+std::shared_ptr<framework::OpStrategy> StrategyForArgReduce(const framework::NodeAttr &attrs,
+                                                            const std::vector<ir::Tensor> &inputs,
+                                                            const std::vector<Type> &out_type,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  framework::CINNCompute arg_reduce_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The arg_reduce is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      arg_reduce_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.arg_reduce.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForArgReduce(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The arg_reduce takes only one input! Please check again.";
+  int ndim = inputs_shape[0].size();
+  CHECK(attrs.count("axis")) << "The arg_reduce should have the attr of axis!";
+  int axis      = absl::get<int>(attrs.at("axis"));
+  bool keep_dim = attrs.count("keep_dim") ? absl::get<bool>(attrs.at("keep_dim")) : false;
+  if (axis < 0) {
+    axis += ndim;
+  }
+  CHECK(axis >= 0 && axis < ndim) << "The axis of arg_reduce should be in [" << -ndim << ", " << ndim << ")!";
+
+  framework::shape_t out_shape;
+  for (int i = 0; i < ndim; ++i) {
+    if (i != axis) {
+      out_shape.push_back(inputs_shape[0][i]);
+    } else if (keep_dim) {
+      out_shape.push_back(1);
+    }
+  }
+  if (out_shape.empty()) {
+    out_shape.push_back(1);
+  }
+  return {out_shape, out_shape};
+}
+
+// The value has the dtype of x, and the index is int32 as the argmax and the argmin.
+std::vector<Type> InferDtypeForArgReduce(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The arg_reduce takes only one input! Please check again.";
+  return {inputs_type[0], Int(32)};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(arg_reduce_ops) {
+  CINN_REGISTER_OP(arg_reduce)
+      .describe("Reduce the max or the min value with its index along the axis")
+      .set_num_inputs(1)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForArgReduce)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForArgReduce))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForArgReduce))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
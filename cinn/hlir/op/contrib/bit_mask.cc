@@ -0,0 +1,209 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/compute.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+constexpr int kMaskWordBits = 32;
+
+// The bool mask is packed along its last axis into the int32 words, the element i is the bit i % 32 of the word
+// i / 32, and the bits beyond the last element are zeros. A mask takes 1/8 of the memory of the bool tensor.
+ir::Tensor PackMask(const ir::Tensor &x, const std::string &name) {
+  int size         = x->shape.back().as_int32();
+  int tail_bits    = size % kMaskWordBits;
+  auto out_shape   = x->shape;
+  out_shape.back() = Expr((size + kMaskWordBits - 1) / kMaskWordBits);
+  return lang::Compute(
+      out_shape,
+      [=](const std::vector<Expr> &indices) {
+        // each word is computed from its 32 elements, so the producer of the bool mask is fused into it and the mask
+        // is only kept in the registers
+        std::vector<Expr> x_indices = indices;
+        Expr word;
+        for (int bit = 0; bit < kMaskWordBits; ++bit) {
+          Expr col = indices.back() * kMaskWordBits + bit;
+          Expr in_range;
+          if (tail_bits != 0 && bit >= tail_bits) {
+            in_range = ir::LT::Make(col, Expr(size));
+            col      = ir::Min::Make(col, Expr(size - 1));
+          }
+          x_indices.back() = col;
+          Expr cond        = in_range.defined() ? ir::And::Make(in_range, x(x_indices)) : x(x_indices);
+          Expr value       = ir::Select::Make(cond, Expr(static_cast<int32_t>(1u << bit)), Expr(0));
+          word             = word.defined() ? word + value : value;
+        }
+        return word;
+      },
+      name);
+}
+
+// The element i of the last axis is extracted from the bit i % 32 of the word i / 32.
+ir::Tensor UnpackMask(const ir::Tensor &words, int size, const std::string &name) {
+  auto out_shape   = words->shape;
+  out_shape.back() = Expr(size);
+  return lang::Compute(
+      out_shape,
+      [=](const std::vector<Expr> &indices) {
+        std::vector<Expr> word_indices = indices;
+        word_indices.back()            = indices.back() / kMaskWordBits;
+        Expr bit                       = (words(word_indices) >> (indices.back() % kMaskWordBits)) & Expr(1);
+        return ir::EQ::Make(bit, Expr(1));
+      },
+      name);
+}
+
+std::string GetOutputName(const CINNValuePack &pack_args, const std::string &op_name) {
+  if (FLAGS_cinn_ir_schedule) {
+    CHECK_EQ(pack_args.size(), 2U);
+    return pack_args[1].operator std::string();
+  }
+  return common::UniqName("T_" + op_name + "_out");
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForPackMask(const framework::NodeAttr &attrs,
+                                                           const std::vector<ir::Tensor> &inputs,
+                                                           const std::vector<Type> &out_type,
+                                                           const std::vector<std::vector<int>> &output_shapes,
+                                                           const Target &target) {
+  framework::CINNCompute pack_mask_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of pack_mask compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 1U) << "At least 1 input tensor for pack_mask compute!";
+    Expr x = pack_args[0];
+    CHECK(x.as_tensor());
+    auto out    = PackMask(x.as_tensor_ref(), GetOutputName(pack_args, "pack_mask"));
+    auto stages = CreateStages({x.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      pack_mask_compute, GetInjectiveScheduleFunc(output_shapes, target, false), "strategy.pack_mask.x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForUnpackMask(const framework::NodeAttr &attrs,
+                                                             const std::vector<ir::Tensor> &inputs,
+                                                             const std::vector<Type> &out_type,
+                                                             const std::vector<std::vector<int>> &output_shapes,
+                                                             const Target &target) {
+  int size = SafeGetAttr(attrs.attr_store, "size", 0);
+  framework::CINNCompute unpack_mask_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of unpack_mask compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 1U) << "At least 1 input tensor for unpack_mask compute!";
+    Expr words = pack_args[0];
+    CHECK(words.as_tensor());
+    auto out    = UnpackMask(words.as_tensor_ref(), size, GetOutputName(pack_args, "unpack_mask"));
+    auto stages = CreateStages({words.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      unpack_mask_compute, GetInjectiveScheduleFunc(output_shapes, target, false), "strategy.unpack_mask.x86", 1);
+  return strategy;
+}
+
+// pack_mask(x) packs the bool x of the shape [..., n] into the int32 words of the shape [..., ceil(n / 32)].
+std::vector<framework::shape_t> InferShapeForPackMask(const std::vector<framework::shape_t> &inputs_shape,
+                                                      const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The pack_mask should has and only has 1 input! Please check again.";
+  CHECK(!inputs_shape[0].empty()) << "The input of pack_mask should not be a scalar!";
+  framework::shape_t out_shape = inputs_shape[0];
+  out_shape.back()             = (out_shape.back() + kMaskWordBits - 1) / kMaskWordBits;
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForPackMask(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The pack_mask should has and only has 1 input! Please check again.";
+  CHECK(inputs_type[0].is_bool()) << "The input of pack_mask should be bool, but got " << inputs_type[0];
+  return {Int(32)};
+}
+
+// unpack_mask(words, size) unpacks the int32 words of the shape [..., ceil(size / 32)] into the bool mask of the
+// shape [..., size].
+std::vector<framework::shape_t> InferShapeForUnpackMask(const std::vector<framework::shape_t> &inputs_shape,
+                                                        const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The unpack_mask should has and only has 1 input! Please check again.";
+  CHECK(!inputs_shape[0].empty()) << "The input of unpack_mask should not be a scalar!";
+  int size = SafeGetAttr(attrs, "size", 0);
+  CHECK_GT(size, 0) << "The size of unpack_mask should be positive!";
+  CHECK_EQ(inputs_shape[0].back(), (size + kMaskWordBits - 1) / kMaskWordBits)
+      << "The last axis of the words should be ceil(size / 32) for the size " << size << "!";
+  framework::shape_t out_shape = inputs_shape[0];
+  out_shape.back()             = size;
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForUnpackMask(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The unpack_mask should has and only has 1 input! Please check again.";
+  CHECK(inputs_type[0].is_int(32)) << "The words of unpack_mask should be int32, but got " << inputs_type[0];
+  return {Bool()};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(bit_mask_ops) {
+  CINN_REGISTER_OP(pack_mask)
+      .describe("Pack the bool mask along the last axis into the int32 words of 32 bits")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForPackMask)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForPackMask))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForPackMask))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(unpack_mask)
+      .describe("Unpack the int32 words of 32 bits along the last axis into the bool mask")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForUnpackMask)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForUnpackMask))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForUnpackMask))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+namespace {
+
+// The collective ops are only implemented by the NCCL runtime called through the custom_call on NVGPU.
+std::shared_ptr<framework::OpStrategy> MakeCollectiveStrategy(const std::string &op_name,
+                                                              const std::vector<std::vector<int>> &output_shapes,
+                                                              const Target &target) {
+  framework::CINNCompute collective_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The " << op_name
+               << " is only implemented by the custom_call on NVGPU with NCCL, please check whether CINN is built "
+                  "with WITH_NCCL and the TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      collective_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+int GetNranks(const framework::AttrMapType &attrs, const std::string &op_name) {
+  CHECK(attrs.count("nranks")) << "The " << op_name << " should have the attribute nranks!";
+  int nranks = absl::get<int>(attrs.at("nranks"));
+  CHECK_GT(nranks, 0) << "The nranks of " << op_name << " should be positive!";
+  return nranks;
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForAllReduce(const framework::NodeAttr &attrs,
+                                                            const std::vector<ir::Tensor> &inputs,
+                                                            const std::vector<Type> &out_type,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  return MakeCollectiveStrategy("all_reduce", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForAllGather(const framework::NodeAttr &attrs,
+                                                            const std::vector<ir::Tensor> &inputs,
+                                                            const std::vector<Type> &out_type,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  return MakeCollectiveStrategy("all_gather", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForReduceScatter(const framework::NodeAttr &attrs,
+                                                                const std::vector<ir::Tensor> &inputs,
+                                                                const std::vector<Type> &out_type,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  return MakeCollectiveStrategy("reduce_scatter", output_shapes, target);
+}
+
+// all_reduce(x) -> the reduction of x over the ranks, with the same shape as x
+std::vector<framework::shape_t> InferShapeForAllReduce(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The all_reduce takes only one input! Please check again.";
+  return {inputs_shape[0]};
+}
+
+// all_gather(x) -> the x of the ranks concatenated along the first axis
+std::vector<framework::shape_t> InferShapeForAllGather(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The all_gather takes only one input! Please check again.";
+  CHECK(!inputs_shape[0].empty()) << "The input of all_gather should not be a scalar!";
+  auto out_shape = inputs_shape[0];
+  out_shape[0] *= GetNranks(attrs, "all_gather");
+  return {out_shape};
+}
+
+// reduce_scatter(x) -> the rank-th slice along the first axis of the reduction of x over the ranks
+std::vector<framework::shape_t> InferShapeForReduceScatter(const std::vector<framework::shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The reduce_scatter takes only one input! Please check again.";
+  CHECK(!inputs_shape[0].empty()) << "The input of reduce_scatter should not be a scalar!";
+  int nranks     = GetNranks(attrs, "reduce_scatter");
+  auto out_shape = inputs_shape[0];
+  CHECK_EQ(out_shape[0] % nranks, 0) << "The first axis of the input of reduce_scatter should be divisible by nranks!";
+  out_shape[0] /= nranks;
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForCollective(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The collective ops take only one input! Please check again.";
+  const auto &type = inputs_type[0];
+  CHECK(type.is_float() || type.is_bfloat16() || type.is_int(8) || type.is_int(32) || type.is_int(64) ||
+        type.is_uint(8) || type.is_uint(32) || type.is_uint(64))
+      << "The dtype " << type << " is not supported by the collective ops!";
+  return {type};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(collective_ops) {
+  CINN_REGISTER_OP(all_reduce)
+      .describe("Reduce the input over the ranks of a communication ring, every rank gets the result")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForAllReduce)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForAllReduce))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCollective))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(all_gather)
+      .describe("Concatenate the inputs of the ranks of a communication ring along the first axis")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForAllGather)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForAllGather))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCollective))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(reduce_scatter)
+      .describe("Reduce the input over the ranks of a communication ring, each rank gets a slice along the first axis")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForReduceScatter)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForReduceScatter))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCollective))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/control_flow.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using framework::ControlFlowRegistry;
+
+// the control flow ops are lowered to the custom call of their host functions
+std::shared_ptr<framework::OpStrategy> StrategyForCustomCall(const framework::NodeAttr &attrs,
+                                                             const std::vector<ir::Tensor> &inputs,
+                                                             const std::vector<Type> &out_type,
+                                                             const std::vector<std::vector<int>> &output_shapes,
+                                                             const Target &target);
+
+std::vector<framework::shape_t> InferShapeForCond(const std::vector<framework::shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK(attrs.count("body_id")) << "The cond should have the attribute body_id! Please check.";
+  const auto &bodies = ControlFlowRegistry::Global()->GetBodies(absl::get<int>(attrs.at("body_id")));
+  CHECK_EQ(inputs_shape.size(), 1 + bodies[0].program.GetInputs().size())
+      << "The inputs of cond should be the predicate and the operands of the branches! Please check.";
+  std::vector<framework::shape_t> res;
+  for (const auto &out : bodies[0].outputs) {
+    res.push_back(out->shape);
+  }
+  return res;
+}
+
+std::vector<Type> InferDtypeForCond(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(attrs.count("body_id")) << "The cond should have the attribute body_id! Please check.";
+  const auto &bodies = ControlFlowRegistry::Global()->GetBodies(absl::get<int>(attrs.at("body_id")));
+  CHECK(inputs_type[0].is_bool()) << "The predicate of cond should be bool! Please check.";
+  std::vector<Type> res;
+  for (const auto &out : bodies[0].outputs) {
+    res.push_back(out->type);
+  }
+  return res;
+}
+
+std::vector<framework::shape_t> InferShapeForWhileLoop(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK(attrs.count("num_loop_vars")) << "The while_loop should have the attribute num_loop_vars! Please check.";
+  int num_loop_vars = absl::get<int>(attrs.at("num_loop_vars"));
+  CHECK_GE(inputs_shape.size(), 1 + num_loop_vars)
+      << "The inputs of while_loop should be the predicate, the loop variables and the operands! Please check.";
+  // the loop variables keep their shapes and types over the iterations
+  return {inputs_shape.begin() + 1, inputs_shape.begin() + 1 + num_loop_vars};
+}
+
+std::vector<Type> InferDtypeForWhileLoop(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(attrs.count("num_loop_vars")) << "The while_loop should have the attribute num_loop_vars! Please check.";
+  int num_loop_vars = absl::get<int>(attrs.at("num_loop_vars"));
+  CHECK(inputs_type[0].is_bool()) << "The predicate of while_loop should be bool! Please check.";
+  return {inputs_type.begin() + 1, inputs_type.begin() + 1 + num_loop_vars};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(control_flow_ops) {
+  CINN_REGISTER_OP(cond)
+      .describe("Run the then or the else branch according to the predicate")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCustomCall)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCond))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCond))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(while_loop)
+      .describe("Run the body while the predicate computed by it is true")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCustomCall)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForWhileLoop))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForWhileLoop))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  const auto &host_target = cinn::common::DefaultHostTarget();
+  using cinn::hlir::framework::cinn_call_cond_host;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cond_host, host_target)
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // body_id
+      .End();
+
+  using cinn::hlir::framework::cinn_call_while_loop_host;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_while_loop_host, host_target)
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // body_id
+      .AddInputType<int>()     // num_loop_vars
+      .End();
+
+#ifdef CINN_WITH_CUDA
+  using cinn::hlir::framework::cinn_call_cond_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cond_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // body_id
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::hlir::framework::cinn_call_while_loop_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_while_loop_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // body_id
+      .AddInputType<int>()     // num_loop_vars
+      .AddInputType<void *>()  // stream
+      .End();
+#endif
+
+  return true;
+}
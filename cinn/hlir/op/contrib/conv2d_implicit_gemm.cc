@@ -0,0 +1,192 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
+#include "cinn/hlir/pe/nn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The epilogue is the fused ops after the convolution in order, such as "bias_residual_relu".
+bool HasEpilogue(const framework::AttrMapType &attrs, const std::string &op) {
+  auto epilogue = SafeGetAttr(attrs, "epilogue", std::string(""));
+  return epilogue.find(op) != std::string::npos;
+}
+
+}  // namespace
+
+// The conv2d_implicit_gemm is rewritten from the NHWC conv2d by ConvImplicitGemmPass, whose input is padded in advance
+// and whose filter is transposed to HWIO, so the GEMM reads both of them in place and is tensorized by Tensor Cores.
+std::shared_ptr<framework::OpStrategy> StrategyForConv2dImplicitGemm(const framework::NodeAttr &attrs,
+                                                                     const std::vector<ir::Tensor> &inputs,
+                                                                     const std::vector<Type> &out_type,
+                                                                     const std::vector<std::vector<int>> &output_shapes,
+                                                                     const Target &target) {
+  auto stride       = SafeGetAttr(attrs.attr_store, "stride", std::vector<int>{1, 1});
+  auto dilation     = SafeGetAttr(attrs.attr_store, "dilation", std::vector<int>{1, 1});
+  bool has_bias     = HasEpilogue(attrs.attr_store, "bias");
+  bool has_residual = HasEpilogue(attrs.attr_store, "residual");
+  bool relu         = HasEpilogue(attrs.attr_store, "relu");
+  CHECK_EQ(output_shapes.size(), 2U) << "The conv2d_implicit_gemm should have the output and the accumulator!";
+  int output_width = output_shapes[0][2];
+
+  framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(FLAGS_cinn_ir_schedule) << "The conv2d_implicit_gemm is only lowered with the IR schedule!";
+    CHECK(!args.empty()) << "The input argument of conv2d_implicit_gemm compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    int num_inputs          = 2 + has_bias + has_residual;
+    CHECK_EQ(pack_args.size(), num_inputs + 2) << "The conv2d_implicit_gemm compute takes " << num_inputs
+                                               << " input tensors and the names of its 2 outputs!";
+    std::vector<ir::Tensor> input_tensors;
+    for (int i = 0; i < num_inputs; ++i) {
+      Expr tensor = pack_args[i];
+      CHECK(tensor.as_tensor());
+      input_tensors.push_back(tensor.as_tensor_ref());
+    }
+    ir::Tensor bias      = has_bias ? input_tensors[2] : ir::Tensor();
+    ir::Tensor residual  = has_residual ? input_tensors.back() : ir::Tensor();
+    std::string out_name = pack_args[num_inputs].operator std::string();
+    std::string acc_name = pack_args[num_inputs + 1].operator std::string();
+
+    auto stages = CreateStages(input_tensors);
+    auto out    = pe::Conv2d_NHWC_ImplicitGemm(input_tensors[0],
+                                               input_tensors[1],
+                                               bias,
+                                               residual,
+                                               stride[0],
+                                               stride[1],
+                                               dilation[0],
+                                               dilation[1],
+                                               output_width,
+                                               relu,
+                                               out_name,
+                                               acc_name);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_implicit_gemm schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    std::vector<std::string> tensor_names;
+    std::vector<Expr> vec_ast;
+    for (int i = 0; i < arg_pack.size(); i++) {
+      if (arg_pack[i].is_tensor()) {
+        Expr tensor = arg_pack[i];
+        tensor_names.push_back(tensor.as_tensor_ref()->name);
+      } else if (arg_pack[i].is_expr()) {
+        vec_ast.emplace_back(arg_pack[i]);
+      }
+    }
+    CHECK_EQ(tensor_names.size(), 2U);
+    CHECK(!vec_ast.empty());
+    ir::ModuleExpr mod_expr(vec_ast);
+    ir::IRSchedule ir_sch(mod_expr);
+    ir_sch.MergeExprs();
+    CHECK(target.arch == Target::Arch::NVGPU) << "The conv2d_implicit_gemm is only implemented on NVGPU";
+    pe::IRCudaScheduleConv2dImplicitGemm(ir_sch, tensor_names[1], tensor_names[0]);
+    *ret = CINNValuePack{{CINNValue(ir_sch.GetModule().GetExprs().at(0))}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(conv2d_compute, conv2d_schedule, "strategy.conv2d_implicit_gemm.x86", 1);
+  return strategy;
+}
+
+// conv2d_implicit_gemm(x_pad[n, h, w, ci], filter[kh, kw, ci, co], [bias[co]], [residual[n, oh, ow, co]]) returns the
+// output [n, oh, ow, co] and the float32 accumulator [n, oh, acc_w, co], whose width is rounded up to the Tensor Core
+// tiles by the padding after the input, and the output only keeps the first output_width columns of it.
+std::vector<framework::shape_t> InferShapeForConv2dImplicitGemm(const std::vector<framework::shape_t> &inputs_shape,
+                                                                const framework::AttrMapType &attrs) {
+  int num_inputs = 2 + HasEpilogue(attrs, "bias") + HasEpilogue(attrs, "residual");
+  CHECK_EQ(inputs_shape.size(), num_inputs) << "The inputs of conv2d_implicit_gemm don't match its epilogue!";
+  const auto &x_shape = inputs_shape[0];
+  const auto &w_shape = inputs_shape[1];
+  CHECK_EQ(x_shape.size(), 4U) << "The input of conv2d_implicit_gemm should be 4-D NHWC!";
+  CHECK_EQ(w_shape.size(), 4U) << "The filter of conv2d_implicit_gemm should be 4-D HWIO!";
+  CHECK_EQ(x_shape[3], w_shape[2]) << "The input channels of conv2d_implicit_gemm mismatch the filter's!";
+  auto stride   = SafeGetAttr(attrs, "stride", std::vector<int>{1, 1});
+  auto dilation = SafeGetAttr(attrs, "dilation", std::vector<int>{1, 1});
+  CHECK(stride.size() == 2U && dilation.size() == 2U) << "The stride and dilation of conv2d_implicit_gemm are not 2-D!";
+
+  int out_h = (x_shape[1] - ((w_shape[0] - 1) * dilation[0] + 1)) / stride[0] + 1;
+  int acc_w = (x_shape[2] - ((w_shape[1] - 1) * dilation[1] + 1)) / stride[1] + 1;
+  int out_w = attrs.count("output_width") ? absl::get<int>(attrs.at("output_width")) : acc_w;
+  CHECK(out_h > 0 && out_w > 0 && out_w <= acc_w) << "The output of conv2d_implicit_gemm is out of its input!";
+  framework::shape_t out_shape = {x_shape[0], out_h, out_w, w_shape[3]};
+  if (HasEpilogue(attrs, "bias")) {
+    CHECK(inputs_shape[2] == framework::shape_t{w_shape[3]}) << "The bias of conv2d_implicit_gemm should be [co]!";
+  }
+  if (HasEpilogue(attrs, "residual")) {
+    CHECK(inputs_shape.back() == out_shape) << "The residual of conv2d_implicit_gemm should be of the output shape!";
+  }
+  return {out_shape, {x_shape[0], out_h, acc_w, w_shape[3]}};
+}
+
+std::vector<Type> InferDtypeForConv2dImplicitGemm(const std::vector<Type> &inputs_type,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_GE(inputs_type.size(), 2U) << "The conv2d_implicit_gemm takes at least the input and filter!";
+  for (auto &type : inputs_type) {
+    CHECK(type == inputs_type[0]) << "The inputs of conv2d_implicit_gemm should have the same dtype, but here "
+                                  << inputs_type[0] << " and " << type;
+  }
+  return {inputs_type[0], Float(32)};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(conv2d_implicit_gemm_ops) {
+  CINN_REGISTER_OP(conv2d_implicit_gemm)
+      .describe("The NHWC conv2d computed as an implicit GEMM by Tensor Cores, with the bias, residual and relu fused")
+      .set_num_inputs(4)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForConv2dImplicitGemm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForConv2dImplicitGemm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForConv2dImplicitGemm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+// The fp8 matmul is only computed by cublasLt on the fp8 tensor cores, which is called through the custom_call on
+// NVGPU, so it has no compute of its own.
+std::shared_ptr<framework::OpStrategy> StrategyForFp8Matmul(const framework::NodeAttr &attrs,
+                                                            const std::vector<ir::Tensor> &inputs,
+                                                            const std::vector<Type> &out_type,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  framework::CINNCompute fp8_matmul_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The fp8_matmul is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      fp8_matmul_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.fp8_matmul.x86", 1);
+  return strategy;
+}
+
+// fp8_matmul(x[m, k], y[n, k], x_scale[1], y_scale[1]) -> alpha * (x * x_scale) * (y * y_scale)^T of shape [m, n]
+std::vector<framework::shape_t> InferShapeForFp8Matmul(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "The fp8_matmul takes x, y, x_scale and y_scale! Please check again.";
+  const auto &x_shape = inputs_shape[0];
+  const auto &y_shape = inputs_shape[1];
+  CHECK_EQ(x_shape.size(), 2U) << "The x of fp8_matmul should be 2-D!";
+  CHECK_EQ(y_shape.size(), 2U) << "The y of fp8_matmul should be 2-D!";
+  CHECK_EQ(x_shape[1], y_shape[1]) << "The K dimension of fp8_matmul should be equal! Please check.";
+  CHECK(inputs_shape[2] == framework::shape_t({1}) && inputs_shape[3] == framework::shape_t({1}))
+      << "The scales of fp8_matmul should be per-tensor with a single value!";
+  return {{x_shape[0], y_shape[0]}};
+}
+
+std::vector<Type> InferDtypeForFp8Matmul(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 4U) << "The fp8_matmul takes x, y, x_scale and y_scale! Please check again.";
+  CHECK(inputs_type[0].is_float8() && inputs_type[1].is_float8())
+      << "The x and y of fp8_matmul should be float8_e4m3fn or float8_e5m2, but here " << inputs_type[0] << " and "
+      << inputs_type[1];
+  CHECK(inputs_type[2].is_float(32) && inputs_type[3].is_float(32)) << "The scales of fp8_matmul should be float32!";
+
+  auto out_dtype = common::Str2Type(SafeGetAttr(attrs, "out_dtype", std::string("bfloat16")));
+  CHECK(out_dtype.is_bfloat16() || out_dtype.is_float16() || out_dtype.is_float(32))
+      << "The out_dtype of fp8_matmul should be bfloat16, float16 or float32, but here " << out_dtype;
+  return {out_dtype};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(fp8_matmul_ops) {
+  CINN_REGISTER_OP(fp8_matmul)
+      .describe("The matmul of the scaled fp8 inputs accumulated in float32, whose right input is transposed")
+      .set_num_inputs(4)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForFp8Matmul)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFp8Matmul))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFp8Matmul))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+// The fused attention computes softmax(q * k^T * scale + mask) * v without materializing the scores, it is only
+// implemented by the flash attention kernel called through the custom_call.
+std::shared_ptr<framework::OpStrategy> StrategyForFusedAttention(const framework::NodeAttr &attrs,
+                                                                 const std::vector<ir::Tensor> &inputs,
+                                                                 const std::vector<Type> &out_type,
+                                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                                 const Target &target) {
+  framework::CINNCompute fused_attention_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The fused_attention is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      fused_attention_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.fused_attention.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForFusedAttention(const std::vector<framework::shape_t> &inputs_shape,
+                                                            const framework::AttrMapType &attrs) {
+  CHECK(inputs_shape.size() == 3U || inputs_shape.size() == 4U)
+      << "The fused_attention takes q, k, v and an optional mask! Please check again.";
+  const auto &q_shape = inputs_shape[0];
+  const auto &k_shape = inputs_shape[1];
+  const auto &v_shape = inputs_shape[2];
+  CHECK_EQ(q_shape.size(), 4U) << "The q of fused_attention should be [batch, heads, seq_q, head_dim]!";
+  CHECK_EQ(k_shape.size(), 4U) << "The k of fused_attention should be [batch, heads, seq_k, head_dim]!";
+  CHECK_EQ(v_shape.size(), 4U) << "The v of fused_attention should be [batch, heads, seq_k, value_dim]!";
+  for (int i = 0; i < 2; ++i) {
+    CHECK(q_shape[i] == k_shape[i] && q_shape[i] == v_shape[i])
+        << "The batch and heads of q, k and v of fused_attention should be the same!";
+  }
+  CHECK_EQ(q_shape[3], k_shape[3]) << "The head_dim of q and k of fused_attention should be the same!";
+  CHECK_EQ(k_shape[2], v_shape[2]) << "The seq_k of k and v of fused_attention should be the same!";
+
+  if (inputs_shape.size() == 4U) {
+    const auto &mask_shape = inputs_shape[3];
+    CHECK_EQ(mask_shape.size(), 4U) << "The mask of fused_attention should be [batch, heads, seq_q, seq_k]!";
+    for (int i = 0; i < 3; ++i) {
+      CHECK(mask_shape[i] == 1 || mask_shape[i] == q_shape[i])
+          << "The mask of fused_attention can only be broadcast along the batch, heads and seq_q!";
+    }
+    CHECK_EQ(mask_shape[3], k_shape[2]) << "The last dimension of the mask of fused_attention should be seq_k!";
+  }
+  return {{q_shape[0], q_shape[1], q_shape[2], v_shape[3]}};
+}
+
+std::vector<Type> InferDtypeForFusedAttention(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK(inputs_type.size() == 3U || inputs_type.size() == 4U)
+      << "The fused_attention takes q, k, v and an optional mask! Please check again.";
+  CHECK(inputs_type[0].is_float(32) || inputs_type[0].is_float16() || inputs_type[0].is_bfloat16())
+      << "The dtype of fused_attention should be float32, float16 or bfloat16! Please check again.";
+  for (auto &type : inputs_type) {
+    CHECK_EQ(type, inputs_type[0]) << "The inputs of fused_attention should have the same dtype!";
+  }
+  return {inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(fused_attention_ops) {
+  CINN_REGISTER_OP(fused_attention)
+      .describe("FusedAttention")
+      .set_num_inputs(4)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForFusedAttention)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFusedAttention))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFusedAttention))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
+#include "cinn/hlir/pe/nn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The epilogue is the fused ops after the depthwise convolution in order, such as "bias_relu6".
+bool HasEpilogue(const framework::AttrMapType &attrs, const std::string &op) {
+  auto ops = utils::Split(SafeGetAttr(attrs, "epilogue", std::string("")), "_");
+  return std::find(ops.begin(), ops.end(), op) != ops.end();
+}
+
+std::string GetActivation(const framework::AttrMapType &attrs) {
+  if (HasEpilogue(attrs, "relu6")) {
+    return "relu6";
+  }
+  return HasEpilogue(attrs, "relu") ? "relu" : "";
+}
+
+}  // namespace
+
+// The fused_depthwise_conv2d is rewritten from the NCHW depthwise_conv2d by DepthwiseConvTilingPass, whose filter size
+// and stride have a register tile specialized in IRCudaScheduleDepthwiseConvTiled.
+std::shared_ptr<framework::OpStrategy> StrategyForFusedDepthwiseConv2d(
+    const framework::NodeAttr &attrs,
+    const std::vector<ir::Tensor> &inputs,
+    const std::vector<Type> &out_type,
+    const std::vector<std::vector<int>> &output_shapes,
+    const Target &target) {
+  auto padding           = SafeGetAttr(attrs.attr_store, "padding", std::vector<int>{0, 0});
+  auto stride            = SafeGetAttr(attrs.attr_store, "stride", std::vector<int>{1, 1});
+  bool has_bias          = HasEpilogue(attrs.attr_store, "bias");
+  std::string activation = GetActivation(attrs.attr_store);
+  CHECK_GE(inputs.size(), 2U) << "The fused_depthwise_conv2d takes at least the input and filter!";
+  int filter_size = inputs[1]->shape[2].as_int32();
+
+  framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(FLAGS_cinn_ir_schedule) << "The fused_depthwise_conv2d is only lowered with the IR schedule!";
+    CHECK(!args.empty()) << "The input argument of fused_depthwise_conv2d compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    int num_inputs          = 2 + has_bias;
+    CHECK_EQ(pack_args.size(), num_inputs + 1)
+        << "The fused_depthwise_conv2d compute takes " << num_inputs << " input tensors and the name of its output!";
+    std::vector<ir::Tensor> input_tensors;
+    for (int i = 0; i < num_inputs; ++i) {
+      Expr tensor = pack_args[i];
+      CHECK(tensor.as_tensor());
+      input_tensors.push_back(tensor.as_tensor_ref());
+    }
+    ir::Tensor bias      = has_bias ? input_tensors[2] : ir::Tensor();
+    std::string out_name = pack_args[num_inputs].operator std::string();
+
+    auto stages = CreateStages(input_tensors);
+    auto out    = pe::Depthwise_Conv2d_NCHW_Epilogue(input_tensors[0],
+                                                     input_tensors[1],
+                                                     bias,
+                                                     padding[0],
+                                                     padding[1],
+                                                     stride[0],
+                                                     stride[1],
+                                                     activation,
+                                                     out_name);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of fused_depthwise_conv2d schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    std::vector<std::string> tensor_names;
+    std::vector<Expr> vec_ast;
+    for (int i = 0; i < arg_pack.size(); i++) {
+      if (arg_pack[i].is_tensor()) {
+        Expr tensor = arg_pack[i];
+        tensor_names.push_back(tensor.as_tensor_ref()->name);
+      } else if (arg_pack[i].is_expr()) {
+        vec_ast.emplace_back(arg_pack[i]);
+      }
+    }
+    // the output, the accumulator and the padded input
+    CHECK_EQ(tensor_names.size(), 3U);
+    CHECK(!vec_ast.empty());
+    ir::ModuleExpr mod_expr(vec_ast);
+    ir::IRSchedule ir_sch(mod_expr);
+    ir_sch.MergeExprs();
+    CHECK(target.arch == Target::Arch::NVGPU) << "The fused_depthwise_conv2d is only implemented on NVGPU";
+    pe::IRCudaScheduleDepthwiseConvTiled(
+        ir_sch, tensor_names[2], tensor_names[1], tensor_names[0], filter_size, stride[0]);
+    *ret = CINNValuePack{{CINNValue(ir_sch.GetModule().GetExprs().at(0))}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(conv2d_compute, conv2d_schedule, "strategy.fused_depthwise_conv2d.x86", 1);
+  return strategy;
+}
+
+// fused_depthwise_conv2d(x[n, c, h, w], filter[c, m, k, k], [bias[c * m]]) returns the output [n, c * m, oh, ow] with
+// the bias added and the activation applied.
+std::vector<framework::shape_t> InferShapeForFusedDepthwiseConv2d(const std::vector<framework::shape_t> &inputs_shape,
+                                                                  const framework::AttrMapType &attrs) {
+  int num_inputs = 2 + HasEpilogue(attrs, "bias");
+  CHECK_EQ(inputs_shape.size(), num_inputs) << "The inputs of fused_depthwise_conv2d don't match its epilogue!";
+  const auto &x_shape = inputs_shape[0];
+  const auto &w_shape = inputs_shape[1];
+  CHECK_EQ(x_shape.size(), 4U) << "The input of fused_depthwise_conv2d should be 4-D NCHW!";
+  CHECK_EQ(w_shape.size(), 4U) << "The filter of fused_depthwise_conv2d should be 4-D!";
+  CHECK_EQ(x_shape[1], w_shape[0]) << "The input channels of fused_depthwise_conv2d mismatch the filter's!";
+  auto padding = SafeGetAttr(attrs, "padding", std::vector<int>{0, 0});
+  auto stride  = SafeGetAttr(attrs, "stride", std::vector<int>{1, 1});
+  CHECK(padding.size() == 2U && stride.size() == 2U) << "The padding and stride of fused_depthwise_conv2d are not 2-D!";
+  CHECK(pe::IsTiledDepthwiseConv(w_shape[2], w_shape[3], stride[0], stride[1]))
+      << "The fused_depthwise_conv2d has no tile for the filter " << w_shape[2] << "x" << w_shape[3] << " and stride "
+      << stride[0] << "x" << stride[1];
+
+  int out_h = (x_shape[2] - w_shape[2] + 2 * padding[0]) / stride[0] + 1;
+  int out_w = (x_shape[3] - w_shape[3] + 2 * padding[1]) / stride[1] + 1;
+  CHECK(out_h > 0 && out_w > 0) << "The output of fused_depthwise_conv2d is out of its input!";
+  framework::shape_t out_shape = {x_shape[0], w_shape[0] * w_shape[1], out_h, out_w};
+  if (HasEpilogue(attrs, "bias")) {
+    CHECK(inputs_shape[2] == framework::shape_t{out_shape[1]}) << "The bias of fused_depthwise_conv2d should be [c]!";
+  }
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForFusedDepthwiseConv2d(const std::vector<Type> &inputs_type,
+                                                    const framework::AttrMapType &attrs) {
+  CHECK_GE(inputs_type.size(), 2U) << "The fused_depthwise_conv2d takes at least the input and filter!";
+  for (auto &type : inputs_type) {
+    CHECK(type == inputs_type[0]) << "The inputs of fused_depthwise_conv2d should have the same dtype, but here "
+                                  << inputs_type[0] << " and " << type;
+  }
+  return {inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(fused_depthwise_conv2d_ops) {
+  CINN_REGISTER_OP(fused_depthwise_conv2d)
+      .describe("The NCHW depthwise conv2d computed by register tiles, with the bias and activation fused")
+      .set_num_inputs(3)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForFusedDepthwiseConv2d)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFusedDepthwiseConv2d))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFusedDepthwiseConv2d))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
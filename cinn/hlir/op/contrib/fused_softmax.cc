@@ -0,0 +1,163 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The fused softmax ops are decomposed into the primitive ops by the Decomposer when they cannot be lowered by the
+// custom_call, so only the online softmax kernel called through the custom_call on NVGPU implements them.
+std::shared_ptr<framework::OpStrategy> MakeFusedSoftmaxStrategy(const std::string &op_name,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  framework::CINNCompute softmax_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The " << op_name
+               << " is only implemented by the custom_call on NVGPU, please check whether the Decomposer and the "
+                  "TransToCustomCallPass are applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      softmax_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+void CheckSoftmaxDtype(const Type &type, const std::string &op_name) {
+  CHECK(type.is_float(32) || type.is_float16() || type.is_bfloat16())
+      << "The dtype of " << op_name << " should be float32, float16 or bfloat16! Please check again.";
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForFusedSoftmax(const framework::NodeAttr &attrs,
+                                                               const std::vector<ir::Tensor> &inputs,
+                                                               const std::vector<Type> &out_type,
+                                                               const std::vector<std::vector<int>> &output_shapes,
+                                                               const Target &target) {
+  return MakeFusedSoftmaxStrategy("fused_softmax", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForSoftmaxCrossEntropy(
+    const framework::NodeAttr &attrs,
+    const std::vector<ir::Tensor> &inputs,
+    const std::vector<Type> &out_type,
+    const std::vector<std::vector<int>> &output_shapes,
+    const Target &target) {
+  return MakeFusedSoftmaxStrategy("softmax_cross_entropy", output_shapes, target);
+}
+
+// fused_softmax(x, [mask]) -> softmax(x * scale + mask) or log_softmax(x * scale + mask) along the last axis, an int32
+// mask is the bool mask packed by pack_mask, whose last axis holds the 32-bit words of the columns
+std::vector<framework::shape_t> InferShapeForFusedSoftmax(const std::vector<framework::shape_t> &inputs_shape,
+                                                          const framework::AttrMapType &attrs) {
+  CHECK(inputs_shape.size() == 1U || inputs_shape.size() == 2U)
+      << "The fused_softmax takes x and an optional mask! Please check again.";
+  const auto &x_shape = inputs_shape[0];
+  CHECK(!x_shape.empty()) << "The x of fused_softmax should not be a scalar!";
+  if (inputs_shape.size() == 2U) {
+    const auto &mask_shape = inputs_shape[1];
+    int words = (x_shape.back() + 31) / 32;
+    CHECK(!mask_shape.empty() && mask_shape.size() <= x_shape.size() &&
+          (mask_shape.back() == x_shape.back() || mask_shape.back() == words))
+        << "The mask of fused_softmax should be broadcastable to x except the last axis!";
+    for (int i = 2; i <= mask_shape.size(); ++i) {
+      int dim = mask_shape[mask_shape.size() - i];
+      CHECK(dim == 1 || dim == x_shape[x_shape.size() - i])
+          << "The mask of fused_softmax should be broadcastable to x!";
+    }
+  }
+  return {x_shape};
+}
+
+std::vector<Type> InferDtypeForFusedSoftmax(const std::vector<Type> &inputs_type,
+                                            const framework::AttrMapType &attrs) {
+  CHECK(inputs_type.size() == 1U || inputs_type.size() == 2U)
+      << "The fused_softmax takes x and an optional mask! Please check again.";
+  CheckSoftmaxDtype(inputs_type[0], "fused_softmax");
+  if (inputs_type.size() == 2U) {
+    CHECK(inputs_type[1] == inputs_type[0] || inputs_type[1].is_int(32))
+        << "The mask of fused_softmax should have the same dtype as x, or be the int32 words of a packed mask!";
+  }
+  return {inputs_type[0]};
+}
+
+// softmax_cross_entropy(logits, label) -> (softmax, loss), the loss keeps the last axis as 1
+std::vector<framework::shape_t> InferShapeForSoftmaxCrossEntropy(const std::vector<framework::shape_t> &inputs_shape,
+                                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The softmax_cross_entropy takes logits and label! Please check again.";
+  const auto &logits_shape = inputs_shape[0];
+  CHECK(!logits_shape.empty()) << "The logits of softmax_cross_entropy should not be a scalar!";
+  framework::shape_t loss_shape = logits_shape;
+  loss_shape.back()             = 1;
+
+  framework::shape_t rows_shape(logits_shape.begin(), logits_shape.end() - 1);
+  CHECK(inputs_shape[1] == loss_shape || inputs_shape[1] == rows_shape)
+      << "The label of softmax_cross_entropy should be the shape of logits except the last axis!";
+  return {logits_shape, loss_shape};
+}
+
+std::vector<Type> InferDtypeForSoftmaxCrossEntropy(const std::vector<Type> &inputs_type,
+                                                   const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The softmax_cross_entropy takes logits and label! Please check again.";
+  CheckSoftmaxDtype(inputs_type[0], "softmax_cross_entropy");
+  CHECK(inputs_type[1].is_int(32) || inputs_type[1].is_int(64))
+      << "The label of softmax_cross_entropy should be int32 or int64!";
+  return {inputs_type[0], inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(fused_softmax_ops) {
+  CINN_REGISTER_OP(fused_softmax)
+      .describe("The softmax or log_softmax along the last axis fused with the scale and the mask of the input")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForFusedSoftmax)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFusedSoftmax))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFusedSoftmax))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(softmax_cross_entropy)
+      .describe("The softmax along the last axis and the cross entropy loss of the hard label")
+      .set_num_inputs(2)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForSoftmaxCrossEntropy)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForSoftmaxCrossEntropy))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForSoftmaxCrossEntropy))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -57,7 +57,7 @@ ir::Tensor LogicalRightShift(const ir::Tensor &A,
   std::string extern_func = "cinn_";
   if (target == common::DefaultHostTarget()) {
     extern_func += "host_";
-  } else if (target == common::DefaultNVGPUTarget()) {
+  } else if (target.is_gpu()) {
     extern_func += "nvgpu_";
   } else {
     CINN_NOT_IMPLEMENTED
@@ -0,0 +1,236 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The norm ops are decomposed into the primitive ops by the Decomposer when they cannot be lowered by the
+// custom_call, so only the single-pass row kernels called through the custom_call on NVGPU implement them.
+std::shared_ptr<framework::OpStrategy> MakeNormStrategy(const std::string &op_name,
+                                                        const std::vector<std::vector<int>> &output_shapes,
+                                                        const Target &target) {
+  framework::CINNCompute norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The " << op_name
+               << " is only implemented by the custom_call on NVGPU, please check whether the Decomposer and the "
+                  "TransToCustomCallPass are applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(norm_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+// Return the number of the rows and the columns, the dimensions from begin_norm_axis are normalized together.
+std::pair<int, int> GetNormRowsAndCols(const framework::shape_t &x_shape, const framework::AttrMapType &attrs) {
+  int begin_norm_axis = attrs.count("begin_norm_axis") ? absl::get<int>(attrs.at("begin_norm_axis")) : 1;
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += x_shape.size();
+  }
+  CHECK(begin_norm_axis > 0 && begin_norm_axis < x_shape.size())
+      << "The begin_norm_axis of the norm should be in [1, " << x_shape.size() << "), but received "
+      << begin_norm_axis;
+  int rows = 1, cols = 1;
+  for (int i = 0; i < x_shape.size(); ++i) {
+    if (i < begin_norm_axis) {
+      rows *= x_shape[i];
+    } else {
+      cols *= x_shape[i];
+    }
+  }
+  return {rows, cols};
+}
+
+void CheckNormParam(const framework::shape_t &param_shape, int cols, const std::string &name) {
+  CHECK_EQ(param_shape.size(), 1U) << "The " << name << " of the norm should be 1-D!";
+  CHECK_EQ(param_shape[0], cols) << "The size of the " << name
+                                 << " of the norm should be equal to the number of the normalized elements!";
+}
+
+// The parameters and the statistics are float32 whatever the dtype of x is, the dy of the gradients is the last input.
+void CheckNormDtype(const std::vector<Type> &inputs_type, const std::string &op_name, bool has_dy) {
+  CHECK(inputs_type[0].is_float(32) || inputs_type[0].is_float16() || inputs_type[0].is_bfloat16())
+      << "The dtype of " << op_name << " should be float32, float16 or bfloat16! Please check again.";
+  int num_params = has_dy ? inputs_type.size() - 1 : inputs_type.size();
+  for (int i = 1; i < num_params; ++i) {
+    CHECK(inputs_type[i].is_float(32)) << "The parameters and the statistics of " << op_name << " should be float32!";
+  }
+  if (has_dy) {
+    CHECK_EQ(inputs_type.back(), inputs_type[0]) << "The dy of " << op_name << " should have the same dtype as x!";
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForLayerNorm(const framework::NodeAttr &attrs,
+                                                            const std::vector<ir::Tensor> &inputs,
+                                                            const std::vector<Type> &out_type,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  return MakeNormStrategy("layer_norm", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForLayerNormGrad(const framework::NodeAttr &attrs,
+                                                                const std::vector<ir::Tensor> &inputs,
+                                                                const std::vector<Type> &out_type,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  return MakeNormStrategy("layer_norm_grad", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForRMSNorm(const framework::NodeAttr &attrs,
+                                                          const std::vector<ir::Tensor> &inputs,
+                                                          const std::vector<Type> &out_type,
+                                                          const std::vector<std::vector<int>> &output_shapes,
+                                                          const Target &target) {
+  return MakeNormStrategy("rms_norm", output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForRMSNormGrad(const framework::NodeAttr &attrs,
+                                                              const std::vector<ir::Tensor> &inputs,
+                                                              const std::vector<Type> &out_type,
+                                                              const std::vector<std::vector<int>> &output_shapes,
+                                                              const Target &target) {
+  return MakeNormStrategy("rms_norm_grad", output_shapes, target);
+}
+
+// layer_norm(x, scale, bias) -> (y, mean, variance)
+std::vector<framework::shape_t> InferShapeForLayerNorm(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The layer_norm takes x, scale and bias! Please check again.";
+  auto rows_and_cols = GetNormRowsAndCols(inputs_shape[0], attrs);
+  CheckNormParam(inputs_shape[1], rows_and_cols.second, "scale");
+  CheckNormParam(inputs_shape[2], rows_and_cols.second, "bias");
+  return {inputs_shape[0], {rows_and_cols.first}, {rows_and_cols.first}};
+}
+
+std::vector<Type> InferDtypeForLayerNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 3U) << "The layer_norm takes x, scale and bias! Please check again.";
+  CheckNormDtype(inputs_type, "layer_norm", false);
+  return {inputs_type[0], Float(32), Float(32)};
+}
+
+// layer_norm_grad(x, scale, mean, variance, dy) -> (dx, dscale, dbias)
+std::vector<framework::shape_t> InferShapeForLayerNormGrad(const std::vector<framework::shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 5U) << "The layer_norm_grad takes x, scale, mean, variance and dy! Please check again.";
+  auto rows_and_cols = GetNormRowsAndCols(inputs_shape[0], attrs);
+  CheckNormParam(inputs_shape[1], rows_and_cols.second, "scale");
+  CHECK(inputs_shape[4] == inputs_shape[0]) << "The dy of layer_norm_grad should have the same shape as x!";
+  return {inputs_shape[0], {rows_and_cols.second}, {rows_and_cols.second}};
+}
+
+std::vector<Type> InferDtypeForLayerNormGrad(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 5U) << "The layer_norm_grad takes x, scale, mean, variance and dy! Please check again.";
+  CheckNormDtype(inputs_type, "layer_norm_grad", true);
+  return {inputs_type[0], Float(32), Float(32)};
+}
+
+// rms_norm(x, scale) -> (y, inv_rms)
+std::vector<framework::shape_t> InferShapeForRMSNorm(const std::vector<framework::shape_t> &inputs_shape,
+                                                     const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The rms_norm takes x and scale! Please check again.";
+  auto rows_and_cols = GetNormRowsAndCols(inputs_shape[0], attrs);
+  CheckNormParam(inputs_shape[1], rows_and_cols.second, "scale");
+  return {inputs_shape[0], {rows_and_cols.first}};
+}
+
+std::vector<Type> InferDtypeForRMSNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The rms_norm takes x and scale! Please check again.";
+  CheckNormDtype(inputs_type, "rms_norm", false);
+  return {inputs_type[0], Float(32)};
+}
+
+// rms_norm_grad(x, scale, inv_rms, dy) -> (dx, dscale)
+std::vector<framework::shape_t> InferShapeForRMSNormGrad(const std::vector<framework::shape_t> &inputs_shape,
+                                                         const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "The rms_norm_grad takes x, scale, inv_rms and dy! Please check again.";
+  auto rows_and_cols = GetNormRowsAndCols(inputs_shape[0], attrs);
+  CheckNormParam(inputs_shape[1], rows_and_cols.second, "scale");
+  CHECK(inputs_shape[3] == inputs_shape[0]) << "The dy of rms_norm_grad should have the same shape as x!";
+  return {inputs_shape[0], {rows_and_cols.second}};
+}
+
+std::vector<Type> InferDtypeForRMSNormGrad(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 4U) << "The rms_norm_grad takes x, scale, inv_rms and dy! Please check again.";
+  CheckNormDtype(inputs_type, "rms_norm_grad", true);
+  return {inputs_type[0], Float(32)};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(norm_ops) {
+  CINN_REGISTER_OP(layer_norm)
+      .describe("LayerNorm")
+      .set_num_inputs(3)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLayerNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNorm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(layer_norm_grad)
+      .describe("The gradient of LayerNorm")
+      .set_num_inputs(5)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLayerNormGrad)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNormGrad))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNormGrad))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(rms_norm)
+      .describe("RMSNorm")
+      .set_num_inputs(2)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRMSNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForRMSNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForRMSNorm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(rms_norm_grad)
+      .describe("The gradient of RMSNorm")
+      .set_num_inputs(4)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRMSNormGrad)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForRMSNormGrad))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForRMSNormGrad))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
+#include "cinn/hlir/pe/nn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The padding after each axis takes the same value as the one before if not given.
+std::vector<int> GetPadAfter(const framework::AttrMapType &attrs, const std::vector<int> &pad_before) {
+  auto pad_after = SafeGetAttr(attrs, "pad_after", std::vector<int>{});
+  if (pad_after.empty()) {
+    pad_after = pad_before;
+  }
+  CHECK_EQ(pad_before.size(), pad_after.size()) << "The pad_before and pad_after of pad should have the same size!";
+  return pad_after;
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForPad(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<Type> &out_type,
+                                                      const std::vector<std::vector<int>> &output_shapes,
+                                                      const Target &target) {
+  auto pad_before = SafeGetAttr(attrs.attr_store, "pad_before", std::vector<int>{});
+  auto pad_after  = GetPadAfter(attrs.attr_store, pad_before);
+
+  framework::CINNCompute pad_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of pad compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 1U) << "At least 1 input tensor for pad compute!";
+    Expr x = pack_args[0];
+    CHECK(x.as_tensor());
+    std::string tensor_name = common::UniqName("T_pad_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 2U);
+      tensor_name = pack_args[1].operator std::string();
+    }
+    std::vector<Expr> before, after;
+    for (size_t i = 0; i < pad_before.size(); ++i) {
+      before.emplace_back(pad_before[i]);
+      after.emplace_back(pad_after[i]);
+    }
+    auto out    = pe::Pad(x.as_tensor_ref(), before, after, Expr(), tensor_name);
+    auto stages = CreateStages({x.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(pad_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.pad.x86", 1);
+  return strategy;
+}
+
+// pad(x) pads the leading axes of x with zeros by pad_before and pad_after, and keeps the other axes unchanged.
+std::vector<framework::shape_t> InferShapeForPad(const std::vector<framework::shape_t> &inputs_shape,
+                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The pad should has and only has 1 input! Please check again.";
+  auto pad_before = SafeGetAttr(attrs, "pad_before", std::vector<int>{});
+  auto pad_after  = GetPadAfter(attrs, pad_before);
+  CHECK_LE(pad_before.size(), inputs_shape[0].size()) << "The pad_before of pad is more than the axes of input!";
+  framework::shape_t out_shape = inputs_shape[0];
+  for (size_t i = 0; i < pad_before.size(); ++i) {
+    CHECK(pad_before[i] >= 0 && pad_after[i] >= 0) << "The padding of pad should not be negative!";
+    out_shape[i] += pad_before[i] + pad_after[i];
+  }
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForPad(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The pad should has and only has 1 input! Please check again.";
+  return {inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(pad_ops) {
+  CINN_REGISTER_OP(pad)
+      .describe("Pad the leading axes of the input with zeros")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForPad)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForPad))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForPad))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  return true;
+}
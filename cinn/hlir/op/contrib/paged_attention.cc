@@ -0,0 +1,155 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+// The kv_cache_append writes the new key and value into the paged caches in place and outputs the new context
+// lengths, so the paged_attention consuming them is ordered after the append. Both are only implemented by the
+// kernels of the runtime through the custom_call on NVGPU.
+std::shared_ptr<framework::OpStrategy> StrategyForKVCacheAppend(const framework::NodeAttr &attrs,
+                                                                const std::vector<ir::Tensor> &inputs,
+                                                                const std::vector<Type> &out_type,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  framework::CINNCompute kv_cache_append_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The kv_cache_append is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      kv_cache_append_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.kv_cache_append.x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForPagedAttention(const framework::NodeAttr &attrs,
+                                                                 const std::vector<ir::Tensor> &inputs,
+                                                                 const std::vector<Type> &out_type,
+                                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                                 const Target &target) {
+  framework::CINNCompute paged_attention_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The paged_attention is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      paged_attention_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.paged_attention.x86", 1);
+  return strategy;
+}
+
+// Check the caches of the shape [num_blocks, num_kv_heads, block_size, head_dim] and the block tables of the shape
+// [batch_size, max_blocks_per_seq] with the context lengths of the shape [batch_size].
+void CheckPagedCacheShapes(const framework::shape_t &key_cache,
+                           const framework::shape_t &value_cache,
+                           const framework::shape_t &block_tables,
+                           const framework::shape_t &context_lens) {
+  CHECK_EQ(key_cache.size(), 4U) << "The key_cache should be [num_blocks, num_kv_heads, block_size, head_dim]";
+  CHECK(key_cache == value_cache) << "The key_cache and the value_cache should have the same shape";
+  CHECK_EQ(block_tables.size(), 2U) << "The block_tables should be [batch_size, max_blocks_per_seq]";
+  CHECK_EQ(context_lens.size(), 1U) << "The context_lens should be [batch_size]";
+  CHECK_EQ(context_lens[0], block_tables[0]) << "The context_lens and the block_tables should have the same batch size";
+}
+
+std::vector<framework::shape_t> InferShapeForKVCacheAppend(const std::vector<framework::shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 6U) << "The kv_cache_append takes the key_cache, the value_cache, the block_tables, "
+                                       "the context_lens, the key and the value! Please check again.";
+  CheckPagedCacheShapes(inputs_shape[0], inputs_shape[1], inputs_shape[2], inputs_shape[3]);
+  const auto &cache = inputs_shape[0];
+  framework::shape_t token_shape{inputs_shape[2][0], cache[1], cache[3]};
+  CHECK(inputs_shape[4] == token_shape) << "The key should be [batch_size, num_kv_heads, head_dim]";
+  CHECK(inputs_shape[5] == token_shape) << "The value should be [batch_size, num_kv_heads, head_dim]";
+  return {inputs_shape[3]};
+}
+
+std::vector<Type> InferDtypeForKVCacheAppend(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 6U) << "The kv_cache_append takes 6 inputs! Please check again.";
+  CHECK(inputs_type[0].is_float(32) || inputs_type[0].is_float16() || inputs_type[0].is_bfloat16())
+      << "The paged caches only support float32, float16 and bfloat16, but got " << inputs_type[0];
+  CHECK(inputs_type[1] == inputs_type[0] && inputs_type[4] == inputs_type[0] && inputs_type[5] == inputs_type[0])
+      << "The caches, the key and the value should have the same dtype";
+  CHECK(inputs_type[2].is_int(32) && inputs_type[3].is_int(32))
+      << "The block_tables and the context_lens should be int32";
+  return {Int(32)};
+}
+
+std::vector<framework::shape_t> InferShapeForPagedAttention(const std::vector<framework::shape_t> &inputs_shape,
+                                                            const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 5U) << "The paged_attention takes the query, the key_cache, the value_cache, the "
+                                       "block_tables and the context_lens! Please check again.";
+  CheckPagedCacheShapes(inputs_shape[1], inputs_shape[2], inputs_shape[3], inputs_shape[4]);
+  const auto &query = inputs_shape[0];
+  const auto &cache = inputs_shape[1];
+  CHECK_EQ(query.size(), 3U) << "The query should be [batch_size, num_heads, head_dim]";
+  CHECK_EQ(query[0], inputs_shape[3][0]) << "The query and the block_tables should have the same batch size";
+  CHECK_EQ(query[2], cache[3]) << "The query and the caches should have the same head size";
+  CHECK_EQ(query[1] % cache[1], 0) << "The num_heads of the query should be divisible by the num_kv_heads "
+                                   << cache[1] << " of the caches, but got " << query[1];
+  return {query};
+}
+
+std::vector<Type> InferDtypeForPagedAttention(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 5U) << "The paged_attention takes 5 inputs! Please check again.";
+  CHECK(inputs_type[0].is_float(32) || inputs_type[0].is_float16() || inputs_type[0].is_bfloat16())
+      << "The paged_attention only supports float32, float16 and bfloat16, but got " << inputs_type[0];
+  CHECK(inputs_type[1] == inputs_type[0] && inputs_type[2] == inputs_type[0])
+      << "The query and the caches should have the same dtype";
+  CHECK(inputs_type[3].is_int(32) && inputs_type[4].is_int(32))
+      << "The block_tables and the context_lens should be int32";
+  return {inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(paged_attention_ops) {
+  CINN_REGISTER_OP(kv_cache_append)
+      .describe("Append the key and the value of the new tokens to the paged caches in place")
+      .set_num_inputs(6)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForKVCacheAppend)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForKVCacheAppend))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForKVCacheAppend))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(paged_attention)
+      .describe("Compute the decode attention of the single query token over the paged caches")
+      .set_num_inputs(5)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForPagedAttention)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForPagedAttention))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForPagedAttention))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
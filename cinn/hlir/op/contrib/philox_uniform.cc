@@ -0,0 +1,156 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/variant.h"
+#include "cinn/common/cinn_value.h"
+#include "cinn/common/common.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+#include "cinn/runtime/flags.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+/**
+ * The uniform random numbers in [min, max) generated by the counter-based Philox RNG from the seed and the offset of
+ * each element, unlike the uniform_random called by the custom_call, it is an elementwise op fused with its consumers,
+ * such as the mask of dropout, so that the random numbers are never written to the global memory.
+ */
+ir::Tensor PhiloxUniform(const std::vector<int> &shape,
+                         float min,
+                         float max,
+                         int64_t seed,
+                         const Type &type,
+                         const Target &target,
+                         const std::string &output_name) {
+  std::string extern_func = "cinn_";
+  if (target == common::DefaultHostTarget()) {
+    extern_func += "host_";
+  } else if (target.is_gpu()) {
+    extern_func += "nvgpu_";
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+  extern_func += "philox_uniform";
+  if (type.is_float(32)) {
+    extern_func += "_fp32";
+  } else if (type.is_float(64)) {
+    extern_func += "_fp64";
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+
+  return lang::Compute(
+      ToCinnExprs(shape),
+      [=](const std::vector<Expr> &indices) {
+        Expr offset = ir::Cast::Make(Int(64), common::IndiceToAbsOffset(shape, indices));
+        Expr value  = lang::CallExtern(extern_func, {Expr(seed), offset});
+        return ir::Cast::Make(type, Expr(min)) + value * ir::Cast::Make(type, Expr(max - min));
+      },
+      output_name);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForPhiloxUniform(const framework::NodeAttr &attrs,
+                                                                const std::vector<ir::Tensor> &inputs,
+                                                                const std::vector<Type> &out_type,
+                                                                const std::vector<std::vector<int>> &output_shapes,
+                                                                const Target &target) {
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("shape")) << "The philox_uniform should have the attribute shape!";
+  auto shape = absl::get<std::vector<int>>(attr_store.at("shape"));
+  float min  = attr_store.count("min") ? absl::get<float>(attr_store.at("min")) : 0.0f;
+  float max  = attr_store.count("max") ? absl::get<float>(attr_store.at("max")) : 1.0f;
+  int seed   = attr_store.count("seed") ? absl::get<int>(attr_store.at("seed")) : 0;
+  // the seed is compiled into the kernel, so the global seed is taken at compile time instead of at run time
+  auto rand_seed = seed == 0 ? runtime::RandomSeed::GetOrSet() : static_cast<unsigned long long>(seed);
+
+  framework::CINNCompute philox_uniform_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of philox_uniform compute is empty! Please check.";
+    CINNValuePack arg_pack  = args[0];
+    std::string tensor_name = UniqName("philox_uniform_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(arg_pack.size(), 1U);
+      CHECK(arg_pack[0].is_string());
+      tensor_name = arg_pack[0].operator std::string();
+    }
+    auto out    = PhiloxUniform(shape, min, max, static_cast<int64_t>(rand_seed), out_type[0], target, tensor_name);
+    auto stages = CreateStages({out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      philox_uniform_compute, GetElementwiseScheduleFunc(output_shapes, target), "strategy.philox_uniform.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForPhiloxUniform(const std::vector<framework::shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK(attrs.count("shape")) << "The philox_uniform should have the attribute shape!";
+  auto shape = absl::get<std::vector<int>>(attrs.at("shape"));
+  CHECK(!shape.empty()) << "shape attr is empty!";
+  return {shape};
+}
+
+std::vector<Type> InferDtypeForPhiloxUniform(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  std::string dtype = "float32";
+  if (attrs.find("dtype") != attrs.end()) {
+    dtype = absl::get<std::string>(attrs.at("dtype"));
+  }
+  std::vector<Type> res{common::Str2Type(dtype)};
+  CHECK(res[0].is_float(32) || res[0].is_float(64))
+      << "philox_uniform only support float32 and float64, but here " << res[0] << "! Please check.";
+  return res;
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(philox_uniform_ops) {
+  CINN_REGISTER_OP(philox_uniform)
+      .describe("Uniform random numbers generated inline by the counter-based Philox RNG")
+      .set_num_inputs(0)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForPhiloxUniform)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForPhiloxUniform))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForPhiloxUniform))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElementWise)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/variant.h"
+#include "cinn/common/cinn_value.h"
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+namespace {
+
+// The symmetric linear quantization of paddle, the scale is the max absolute value mapped to the bound of the integer
+// range, which is a single value or one value per slice along the quant_axis.
+struct QuantizeParam {
+  int quant_axis{-1};
+  int bit_length{8};
+
+  explicit QuantizeParam(const framework::AttrMapType &attrs) {
+    quant_axis = SafeGetAttr(attrs, "quant_axis", -1);
+    bit_length = SafeGetAttr(attrs, "bit_length", 8);
+    CHECK(bit_length > 1 && bit_length <= 8) << "The bit_length of quantization should be in (1, 8], but here "
+                                             << bit_length;
+  }
+
+  float Bound() const { return static_cast<float>((1 << (bit_length - 1)) - 1); }
+
+  void CheckScale(const framework::shape_t &x_shape, const framework::shape_t &scale_shape) const {
+    CHECK_EQ(scale_shape.size(), 1U) << "The scale of quantization should be 1-D!";
+    if (quant_axis < 0) {
+      CHECK_EQ(scale_shape[0], 1) << "The scale of the per-tensor quantization should have a single value!";
+    } else {
+      CHECK_LT(quant_axis, x_shape.size()) << "The quant_axis is out of the rank of the input!";
+      CHECK_EQ(scale_shape[0], x_shape[quant_axis])
+          << "The scale of the per-channel quantization should have a value for each slice along the quant_axis!";
+    }
+  }
+
+  Expr GetScale(const ir::Tensor &scale, const std::vector<Expr> &indices) const {
+    return ir::Cast::Make(Float(32), scale(quant_axis < 0 ? Expr(0) : indices[quant_axis]));
+  }
+};
+
+std::shared_ptr<framework::OpStrategy> MakeQuantizeStrategy(
+    const std::string &op_name,
+    const std::function<Expr(const Expr &, const Expr &)> &fn,
+    const std::vector<std::vector<int>> &output_shapes,
+    const QuantizeParam &param,
+    const Target &target) {
+  framework::CINNCompute quantize_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 2U) << "2 input tensors for " << op_name << " compute";
+    Expr x_expr     = pack_args[0];
+    Expr scale_expr = pack_args[1];
+    CHECK(x_expr.as_tensor());
+    CHECK(scale_expr.as_tensor());
+    ir::Tensor x     = x_expr.as_tensor_ref();
+    ir::Tensor scale = scale_expr.as_tensor_ref();
+
+    std::string tensor_name = UniqName(op_name + "_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 3U);
+      tensor_name = pack_args[2].operator std::string();
+    }
+
+    auto out = lang::Compute(
+        x->shape,
+        [=](const std::vector<Expr> &indices) { return fn(x(indices), param.GetScale(scale, indices)); },
+        tensor_name);
+    auto stages = CreateStages({out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      quantize_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForQuantizeLinear(const framework::NodeAttr &attrs,
+                                                                 const std::vector<ir::Tensor> &inputs,
+                                                                 const std::vector<Type> &out_type,
+                                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                                 const Target &target) {
+  QuantizeParam param(attrs.attr_store);
+  float bound = param.Bound();
+  // q = clip(round(x * bound / scale), -bound, bound)
+  auto quantize = [=](const Expr &x, const Expr &scale) {
+    Expr value = lang::Round(ir::Cast::Make(Float(32), x) * Expr(bound) / scale);
+    value      = ir::Min::Make(ir::Max::Make(value, Expr(-bound)), Expr(bound));
+    return ir::Cast::Make(out_type[0], value);
+  };
+  return MakeQuantizeStrategy("quantize_linear", quantize, output_shapes, param, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForDequantizeLinear(const framework::NodeAttr &attrs,
+                                                                   const std::vector<ir::Tensor> &inputs,
+                                                                   const std::vector<Type> &out_type,
+                                                                   const std::vector<std::vector<int>> &output_shapes,
+                                                                   const Target &target) {
+  QuantizeParam param(attrs.attr_store);
+  float bound = param.Bound();
+  // x = q * scale / bound, where q may also be the int32 accumulation of the int8 matmul or conv2d
+  auto dequantize = [=](const Expr &x, const Expr &scale) {
+    return ir::Cast::Make(out_type[0], ir::Cast::Make(Float(32), x) * scale / Expr(bound));
+  };
+  return MakeQuantizeStrategy("dequantize_linear", dequantize, output_shapes, param, target);
+}
+
+std::vector<framework::shape_t> InferShapeForQuantize(const std::vector<framework::shape_t> &inputs_shape,
+                                                      const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The quantization takes the input and the scale! Please check again.";
+  QuantizeParam(attrs).CheckScale(inputs_shape[0], inputs_shape[1]);
+  return {inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForQuantizeLinear(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The quantize_linear takes the input and the scale! Please check again.";
+  CHECK(inputs_type[0].is_float()) << "The input of quantize_linear should be float, but here " << inputs_type[0];
+  return {Int(8)};
+}
+
+std::vector<Type> InferDtypeForDequantizeLinear(const std::vector<Type> &inputs_type,
+                                                const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The dequantize_linear takes the input and the scale! Please check again.";
+  CHECK(inputs_type[0].is_int(8) || inputs_type[0].is_int(32))
+      << "The input of dequantize_linear should be int8 or int32, but here " << inputs_type[0];
+  return {Float(32)};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(quantize_ops) {
+  CINN_REGISTER_OP(quantize_linear)
+      .describe("Quantize the float input into int8 by the symmetric scale")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantizeLinear)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantizeLinear))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(dequantize_linear)
+      .describe("Dequantize the int8 input or the int32 accumulation into float32 by the symmetric scale")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForDequantizeLinear)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDequantizeLinear))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  return true;
+}
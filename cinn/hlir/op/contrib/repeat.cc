@@ -189,9 +189,9 @@ std::shared_ptr<framework::OpStrategy> StrategyForRepeat(const framework::NodeAt
       ir_sch.MergeExprs();
       long prod_size = std::accumulate(output_shapes[0].begin(), output_shapes[0].end(), 1, std::multiplies<int>());
       if (prod_size > 1) {
-        if (target.arch == Target::Arch::NVGPU) {
+        if (target.is_gpu()) {
           pe::IRCudaScheduleInjective(ir_sch, output_shapes.front(), target);
-        } else if (target.arch == Target::Arch::X86) {
+        } else if (target.is_cpu()) {
           pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target, true);
         }
       }
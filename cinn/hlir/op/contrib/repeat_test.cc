@@ -99,8 +99,9 @@ void TestGenerateCodeCpu_Repeat(void* _args, int32_t num_args)
   const int32_t* in = ((const int32_t*)(_in->memory));
   int32_t* test_repeat = ((int32_t*)(_test_repeat->memory));
   for (int32_t i = 0; i < 8; i += 1) {
+    int32_t j_inv0 = (4 * (((((i > 0) && (2 > 0)) || ((i < 0) && (2 < 0)))) ? (i / 2) : ((((i & 1) == 0)) ? (i / 2) : ((i / 2) + -1))));
     for (int32_t j = 0; j < 4; j += 1) {
-      test_repeat[((4 * i) + j)] = in[((4 * (((((i > 0) && (2 > 0)) || ((i < 0) && (2 < 0)))) ? (i / 2) : ((((i & 1) == 0)) ? (i / 2) : ((i / 2) + -1)))) + j)];
+      test_repeat[((4 * i) + j)] = in[(j_inv0 + j)];
     };
   };
   cinn_buffer_free((void*)(0), _in);
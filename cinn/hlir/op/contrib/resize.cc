@@ -33,6 +33,7 @@
 #include "cinn/hlir/pe/transform.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_operators.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
 #include "cinn/lang/compute.h"
@@ -51,16 +52,99 @@ using common::CINNValuePack;
          common::AutoSimplify(ir::Max::Make(ir::Min::Make(y, h - Expr(1)), Expr(0))), \
          common::AutoSimplify(ir::Max::Make(ir::Min::Make(x, w - Expr(1)), Expr(0)))})
 
+// The weights of the 4 taps of the cubic convolution with alpha -0.5 at the fraction t, the same as the extern
+// functions of the bicubic resize.
+static std::vector<Expr> CubicWeights(const Expr &t) {
+  Expr alpha = Expr(-0.5f);
+  Expr t2    = t * t;
+  Expr t3    = t2 * t;
+  return {alpha * (t3 - Expr(2.0f) * t2 + t),
+          (alpha + Expr(2.0f)) * t3 - (alpha + Expr(3.0f)) * t2 + Expr(1.0f),
+          Expr(0.0f) - (alpha + Expr(2.0f)) * t3 + (Expr(2.0f) * alpha + Expr(3.0f)) * t2 - alpha * t,
+          Expr(0.0f) - alpha * t3 + alpha * t2};
+}
+
+// Resize of the NHWC layout computed in IR. The interpolation coefficients of an output pixel only depend on its row
+// and column, the scales are folded into constants, so they are computed once for all the adjacent channels of the
+// pixel, which are vectorized by the schedule.
+static ir::Tensor ResizeNHWC(const ir::Tensor &input,
+                             const std::vector<int> &out_shape,
+                             const std::string &mode,
+                             const std::string &output_name) {
+  int in_h      = input->shape[1].as_int32();
+  int in_w      = input->shape[2].as_int32();
+  float scale_y = static_cast<float>(in_h) / out_shape[0];
+  float scale_x = static_cast<float>(in_w) / out_shape[1];
+
+  auto clamp = [](const Expr &index, int size) {
+    return common::AutoSimplify(ir::Max::Make(ir::Min::Make(index, Expr(size - 1)), Expr(0)));
+  };
+  auto get_pixel = [=](const Expr &n, const Expr &y, const Expr &x, const Expr &c) {
+    return ir::Cast::Make(common::F32(), input({n, clamp(y, in_h), clamp(x, in_w), c}));
+  };
+
+  std::vector<Expr> new_shape = {input->shape[0], Expr(out_shape[0]), Expr(out_shape[1]), input->shape[3]};
+  return lang::Compute(
+      new_shape,
+      [=](const std::vector<Expr> &indices) {
+        Expr n     = indices[0];
+        Expr out_y = ir::Cast::Make(common::F32(), indices[1]);
+        Expr out_x = ir::Cast::Make(common::F32(), indices[2]);
+        Expr c     = indices[3];
+
+        if (mode == "nearest") {
+          Expr in_y = ir::Cast::Make(common::Int(32), lang::Floor(Expr(scale_y) * out_y));
+          Expr in_x = ir::Cast::Make(common::Int(32), lang::Floor(Expr(scale_x) * out_x));
+          return input({n, in_y, in_x, c});
+        }
+
+        Expr in_y     = (out_y + Expr(0.5f)) * Expr(scale_y) - Expr(0.5f);
+        Expr in_x     = (out_x + Expr(0.5f)) * Expr(scale_x) - Expr(0.5f);
+        Expr in_y_int = ir::Cast::Make(common::Int(32), lang::Floor(in_y));
+        Expr in_x_int = ir::Cast::Make(common::Int(32), lang::Floor(in_x));
+        Expr y_fract  = in_y - ir::Cast::Make(common::F32(), in_y_int);
+        Expr x_fract  = in_x - ir::Cast::Make(common::F32(), in_x_int);
+
+        Expr value;
+        if (mode == "bilinear") {
+          Expr top = get_pixel(n, in_y_int, in_x_int, c) * (Expr(1.0f) - x_fract) +
+                     get_pixel(n, in_y_int, in_x_int + 1, c) * x_fract;
+          Expr bottom = get_pixel(n, in_y_int + 1, in_x_int, c) * (Expr(1.0f) - x_fract) +
+                        get_pixel(n, in_y_int + 1, in_x_int + 1, c) * x_fract;
+          value = top * (Expr(1.0f) - y_fract) + bottom * y_fract;
+        } else {
+          auto weights_y = CubicWeights(y_fract);
+          auto weights_x = CubicWeights(x_fract);
+          for (int i = 0; i < 4; ++i) {
+            Expr row;
+            for (int j = 0; j < 4; ++j) {
+              Expr tap = get_pixel(n, in_y_int + (i - 1), in_x_int + (j - 1), c) * weights_x[j];
+              row      = row.defined() ? row + tap : tap;
+            }
+            value = value.defined() ? value + row * weights_y[i] : row * weights_y[i];
+          }
+        }
+        return ir::Cast::Make(input->type(), value);
+      },
+      common::UniqName(output_name));
+}
+
 ir::Tensor Resize(const ir::Tensor &input,
                   const common::Target &target,
                   const std::vector<int> &out_shape,
                   const std::string &mode,
+                  const std::string &data_format,
                   const std::string &output_name) {
+  if (data_format == "NHWC") {
+    return ResizeNHWC(input, out_shape, mode, output_name);
+  }
+  CHECK_EQ(data_format, "NCHW") << "Resize only supports NCHW and NHWC data_format.";
+
   std::string func_name;
 
-  if (target.arch == common::Target::Arch::NVGPU) {
+  if (target.is_gpu()) {
     func_name.assign("cinn_cuda_resize_");
-  } else if (target.arch == common::Target::Arch::X86) {
+  } else if (target.is_cpu()) {
     func_name.assign("cinn_host_resize_");
   } else {
     LOG(FATAL) << "Resize only supports X86 and NVGPU ! Please Check.\n";
@@ -127,19 +211,33 @@ std::vector<std::vector<int>> InferShapeForResize(const std::vector<std::vector<
   CHECK(mode == "nearest" || mode == "bilinear" || mode == "bicubic")
       << "Resize only supports `nearest`, `bilinear` and `bicubic` mode.";
 
+  std::string data_format = "NCHW";
+  if (attrs.find("data_format") != attrs.end()) {
+    data_format = absl::get<std::string>(attrs.at("data_format"));
+  }
+  CHECK(data_format == "NCHW" || data_format == "NHWC") << "Resize only supports NCHW and NHWC data_format.";
+
   framework::shape_t x_shape = inputs_shape[0];
   std::vector<int> new_shape;
-  new_shape.push_back(x_shape[0]);
-  new_shape.push_back(x_shape[1]);
-  new_shape.push_back(out_shape[0]);
-  new_shape.push_back(out_shape[1]);
+  if (data_format == "NHWC") {
+    new_shape = {x_shape[0], out_shape[0], out_shape[1], x_shape[3]};
+  } else {
+    new_shape = {x_shape[0], x_shape[1], out_shape[0], out_shape[1]};
+  }
 
   return {new_shape};
 }
 
 std::vector<Type> InferDtypeForResize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
-  CHECK(inputs_type[0] == Int(32)) << "Resize only supports int32 type input.";
+  // The NHWC layout is computed in IR, while the interpolation of the NCHW layout calls the int32 extern functions
+  if (attrs.find("data_format") != attrs.end() && absl::get<std::string>(attrs.at("data_format")) == "NHWC") {
+    CHECK(inputs_type[0].is_int(32) || inputs_type[0].is_float(32) || inputs_type[0].is_float16() ||
+          inputs_type[0].is_bfloat16())
+        << "Resize of NHWC only supports int32, float32, float16 and bfloat16 type input.";
+  } else {
+    CHECK(inputs_type[0] == Int(32)) << "Resize only supports int32 type input.";
+  }
   std::vector<Type> res{inputs_type[0]};
   return res;
 }
@@ -150,13 +248,16 @@ std::shared_ptr<framework::OpStrategy> StrategyForResize(const framework::NodeAt
                                                          const std::vector<std::vector<int>> &output_shapes,
                                                          const Target &target) {
   std::vector<int> out_shape;
-  std::string mode = "bilinear";
+  std::string mode        = "bilinear";
+  std::string data_format = "NCHW";
 
   for (auto &iter : attrs.attr_store) {
     if (iter.first == "out_shape") {
       out_shape = absl::get<std::vector<int>>(iter.second);
     } else if (iter.first == "mode") {
       mode = absl::get<std::string>(iter.second);
+    } else if (iter.first == "data_format") {
+      data_format = absl::get<std::string>(iter.second);
     }
   }
 
@@ -180,7 +281,7 @@ std::shared_ptr<framework::OpStrategy> StrategyForResize(const framework::NodeAt
       tensor_name = pack_args[1].operator std::string();
     }
 
-    ir::Tensor out = Resize(tensor_A, target, out_shape, mode, tensor_name);
+    ir::Tensor out = Resize(tensor_A, target, out_shape, mode, data_format, tensor_name);
 
     std::vector<common::CINNValue> res;
     auto stages = CreateStages({tensor_A});
@@ -206,9 +307,11 @@ std::shared_ptr<framework::OpStrategy> StrategyForResize(const framework::NodeAt
     ir_sch.MergeExprs();
     long prod_size = std::accumulate(output_shapes[0].begin(), output_shapes[0].end(), 1, std::multiplies<int>());
     if (prod_size > 1) {
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu() && data_format == "NHWC") {
+        pe::IRCudaScheduleResizeNHWC(ir_sch, target);
+      } else if (target.is_gpu()) {
         pe::IRCudaScheduleInjective(ir_sch, output_shapes.front(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target, true);
       }
     }
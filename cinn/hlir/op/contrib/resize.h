@@ -29,6 +29,7 @@ ir::Tensor Resize(const ir::Tensor &x,
                   const common::Target &target,
                   const std::vector<int> &out_shape,
                   const std::string &mode,
+                  const std::string &data_format,
                   const std::string &output_name);
 
 }  // namespace op
@@ -0,0 +1,215 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/op/contrib/scan.h"
+
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+ir::Tensor Cumulative(const ir::Tensor& x,
+                      const std::string& scan_type,
+                      int axis,
+                      bool exclusive,
+                      bool reverse,
+                      const std::string& output_name) {
+  int rank = x->shape.size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  CHECK(axis >= 0 && axis < rank) << "The axis " << axis << " is out of the rank of " << x->name;
+  Var k(x->shape[axis], UniqName("scan_k"));
+  return lang::Compute(
+      x->shape,
+      [=](const std::vector<Expr>& indices) {
+        std::vector<Expr> x_indices(indices);
+        x_indices[axis] = Expr(k);
+        Expr i          = indices[axis];
+        Expr in_range;
+        if (reverse) {
+          in_range = exclusive ? ir::GT::Make(Expr(k), i) : ir::GE::Make(Expr(k), i);
+        } else {
+          in_range = exclusive ? ir::LT::Make(Expr(k), i) : ir::LE::Make(Expr(k), i);
+        }
+        if (scan_type == "sum") {
+          return lang::ReduceSum(ir::Select::Make(in_range, x(x_indices), lang::Zero(x->type())), {k});
+        } else if (scan_type == "prod") {
+          return lang::ReduceMul(ir::Select::Make(in_range, x(x_indices), lang::One(x->type())), {k});
+        }
+        CHECK_EQ(scan_type, "max") << "The cumulative op only supports sum, prod and max";
+        return lang::ReduceMax(ir::Select::Make(in_range, x(x_indices), lang::min_value(x->type())), {k});
+      },
+      output_name);
+}
+
+std::shared_ptr<framework::OpStrategy> MakeCumulativeStrategy(const std::string& scan_type,
+                                                              const framework::NodeAttr& attrs,
+                                                              const std::vector<std::vector<int>>& output_shapes,
+                                                              const Target& target) {
+  const auto& attr_store = attrs.attr_store;
+  int axis               = attr_store.count("axis") ? absl::get<int>(attr_store.at("axis")) : -1;
+  bool exclusive         = attr_store.count("exclusive") ? absl::get<bool>(attr_store.at("exclusive")) : false;
+  bool reverse           = attr_store.count("reverse") ? absl::get<bool>(attr_store.at("reverse")) : false;
+  std::string op_name    = "cum" + scan_type;
+
+  framework::CINNCompute cumulative_compute([=](lang::Args args, lang::RetValue* ret) {
+    CHECK(!args.empty()) << "The input arguments of " << op_name << " compute is empty! Please check.\n";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 1U) << "At least 1 input tensors for " << op_name << " compute\n";
+    Expr x = pack_args[0];
+    CHECK(x.as_tensor());
+    auto tensor_x    = x.as_tensor_ref();
+    auto stages      = CreateStages({tensor_x});
+    auto tensor_name = UniqName(op_name + "_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 2U);
+      CHECK(pack_args[1].is_string());
+      tensor_name = pack_args[1].operator std::string();
+    }
+    ir::Tensor out = Cumulative(tensor_x, scan_type, axis, exclusive, reverse, tensor_name);
+    stages->InsertLazily(out);
+    *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  // The masked reduction is left in the serial loops, since the cumulative ops are replaced by the custom call of
+  // the scan kernel on NVGPU, unless they are denied by FLAGS_cinn_custom_call_deny_ops.
+  framework::CINNSchedule cumulative_schedule([=](lang::Args args, lang::RetValue* ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    if (FLAGS_cinn_ir_schedule) {
+      std::vector<Expr> vec_ast;
+      for (int i = 0; i < arg_pack.size(); i++) {
+        if (arg_pack[i].is_expr()) {
+          Expr temp = arg_pack[i];
+          vec_ast.emplace_back(temp);
+        }
+      }
+      CHECK(!vec_ast.empty());
+      ir::ModuleExpr mod_expr(vec_ast);
+      ir::IRSchedule ir_sch(mod_expr);
+      ir_sch.MergeExprs();
+      std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+      *ret = CINNValuePack{res};
+    } else {
+      Expr out = arg_pack[0];
+      CHECK(out.as_tensor());
+      *ret = arg_pack;
+    }
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(cumulative_compute, cumulative_schedule, "strategy." + op_name, 1);
+  return strategy;
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForCumsum(const framework::NodeAttr& attrs,
+                                                         const std::vector<ir::Tensor>& inputs,
+                                                         const std::vector<Type>& out_type,
+                                                         const std::vector<std::vector<int>>& output_shapes,
+                                                         const Target& target) {
+  return MakeCumulativeStrategy("sum", attrs, output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForCumprod(const framework::NodeAttr& attrs,
+                                                          const std::vector<ir::Tensor>& inputs,
+                                                          const std::vector<Type>& out_type,
+                                                          const std::vector<std::vector<int>>& output_shapes,
+                                                          const Target& target) {
+  return MakeCumulativeStrategy("prod", attrs, output_shapes, target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForCummax(const framework::NodeAttr& attrs,
+                                                         const std::vector<ir::Tensor>& inputs,
+                                                         const std::vector<Type>& out_type,
+                                                         const std::vector<std::vector<int>>& output_shapes,
+                                                         const Target& target) {
+  return MakeCumulativeStrategy("max", attrs, output_shapes, target);
+}
+
+std::vector<framework::shape_t> InferShapeForCumulative(const std::vector<framework::shape_t>& inputs_shape,
+                                                        const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The cumulative op takes only one input! Please check again.";
+  int rank = inputs_shape[0].size();
+  int axis = attrs.count("axis") ? absl::get<int>(attrs.at("axis")) : -1;
+  CHECK(axis >= -rank && axis < rank) << "The axis " << axis << " of the cumulative op is out of the rank " << rank;
+  return inputs_shape;
+}
+
+std::vector<Type> InferDtypeForCumulative(const std::vector<Type>& inputs_type, const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_type.size(), 1U) << "The cumulative op takes only one input! Please check again.";
+  return inputs_type;
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(scan_ops) {
+  CINN_REGISTER_OP(cumsum)
+      .describe("The cumulative sum of x along the axis.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCumsum)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCumulative))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCumulative))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(cumprod)
+      .describe("The cumulative product of x along the axis.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCumprod)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCumulative))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCumulative))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(cummax)
+      .describe("The cumulative max of x along the axis.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCummax)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCumulative))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCumulative))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
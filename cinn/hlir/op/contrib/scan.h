@@ -0,0 +1,42 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+/**
+ * The cumulative sum, product or max of x along the axis, where scan_type is one of "sum", "prod" and "max". The
+ * element i of the output takes the elements [0, i] of the axis, or [i, n) if reverse, and the element i itself is
+ * excluded if exclusive. An element of the output is the masked reduction over the whole axis, which is only the
+ * fallback of the host, the cumulative ops are computed by the single-pass scan kernel on NVGPU.
+ */
+ir::Tensor Cumulative(const ir::Tensor& x,
+                      const std::string& scan_type,
+                      int axis,
+                      bool exclusive,
+                      bool reverse,
+                      const std::string& output_name);
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/op/contrib/scan.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/backends/codegen_c.h"
+#include "cinn/backends/codegen_c_x86.h"
+#include "cinn/common/context.h"
+#include "cinn/lang/lower.h"
+#include "cinn/lang/placeholder.h"
+#include "cinn/poly/stage.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+namespace {
+std::string CompileToC(const std::string& name, const ir::Tensor& res, const std::vector<ir::Tensor>& args) {
+  common::Target target = common::DefaultHostTarget();
+  poly::StageMap stages = poly::CreateStages({res});
+  std::vector<ir::Tensor> tensor_args(args);
+  tensor_args.push_back(res);
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("TestGenerateCodeCpu_" + name, stages, tensor_args, {}, {}, nullptr, target, true);
+
+  ir::Module::Builder builder(name + "_Module", target);
+  for (auto& f : funcs) {
+    builder.AddFunction(f);
+  }
+  backends::CodeGenCX86 codegen(target, backends::CodeGenCX86::Feature::AVX512);
+  codegen.SetInlineBuiltinCodes(false);
+  std::string code = codegen.Compile(builder.Build(), backends::CodeGenC::OutputKind::CImpl);
+  VLOG(6) << "codegen code: " << code;
+  return code;
+}
+}  // namespace
+
+TEST(GenerateCode_Cpu, Cumsum) {
+  common::Context::Global().ResetNameId();
+
+  lang::Placeholder<float> x("x", std::vector<int>{4, 16, 8});
+  ir::Tensor res = Cumulative(x, "sum", 1, false, false, "test_cumsum_out");
+  ASSERT_EQ(res->shape.size(), 3U);
+  EXPECT_EQ(res->shape[1].as_int32(), 16);
+
+  std::string code = CompileToC("Cumsum", res, {x});
+  EXPECT_NE(code.find("test_cumsum_out"), std::string::npos);
+}
+
+TEST(GenerateCode_Cpu, CummaxReverseExclusive) {
+  common::Context::Global().ResetNameId();
+
+  lang::Placeholder<int> x("x", std::vector<int>{8, 32});
+  ir::Tensor res = Cumulative(x, "max", -1, true, true, "test_cummax_out");
+  ASSERT_EQ(res->shape.size(), 2U);
+  EXPECT_EQ(res->shape[1].as_int32(), 32);
+
+  std::string code = CompileToC("Cummax", res, {x});
+  EXPECT_NE(code.find("test_cummax_out"), std::string::npos);
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
@@ -55,9 +55,9 @@ std::vector<ir::Tensor> ArgSort(const ir::Tensor &A,
                                 const std::string &name) {
   std::string find_func_name;
   std::string index_func_name;
-  if (target.arch == common::Target::Arch::NVGPU) {
+  if (target.is_gpu()) {
     find_func_name.assign("cinn_nvgpu_next_smallest_int32");
-  } else if (target.arch == common::Target::Arch::X86) {
+  } else if (target.is_cpu()) {
     find_func_name.assign("cinn_host_next_smallest_int32");
   } else {
     LOG(FATAL) << "ArgSort only supports X86 and NVGPU ! Please Check.\n";
@@ -204,7 +204,7 @@ std::shared_ptr<framework::OpStrategy> StrategyForSort(const framework::NodeAttr
       ir_sch.SetBuffer(blocks[1], "local");
 
       long prod_size = std::accumulate(output_shapes[0].begin(), output_shapes[0].end(), 1, std::multiplies<int>());
-      if (prod_size > 1 && target.arch == Target::Arch::X86) {
+      if (prod_size > 1 && target.is_cpu()) {
         pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target, true);
       }
       std::vector<common::CINNValue> res{common::CINNValue(ir_sch.GetModule().GetExprs().at(0))};
@@ -285,7 +285,7 @@ std::shared_ptr<framework::OpStrategy> StrategyForArgSort(const framework::NodeA
       // TODO: There is a bug, setting buffer to "local" here will cause the var declared twice at CodeGen.
       // ir_sch.SetBuffer(blocks[0], "local");
       long prod_size = std::accumulate(output_shapes[0].begin(), output_shapes[0].end(), 1, std::multiplies<int>());
-      if (prod_size > 1 && target.arch == Target::Arch::X86) {
+      if (prod_size > 1 && target.is_cpu()) {
         pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target, true);
       }
       std::vector<common::CINNValue> res{common::CINNValue(ir_sch.GetModule().GetExprs().at(0))};
@@ -0,0 +1,210 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/op/contrib/sparse.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/cas.h"
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+#include "gflags/gflags.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+using common::CINNValue;
+using common::CINNValuePack;
+
+ir::Tensor CsrSpmm(const ir::Tensor& crows,
+                   const ir::Tensor& cols,
+                   const ir::Tensor& values,
+                   const ir::Tensor& dense,
+                   const common::Target& target,
+                   const std::string& output_name) {
+  CHECK_EQ(crows->shape.size(), 1U) << "The crows of csr_spmm should be 1-D";
+  CHECK_EQ(dense->shape.size(), 2U) << "The dense matrix of csr_spmm should be 2-D";
+  std::string func_name = GetExternFuncName(target, values->type(), "csr_spmm");
+  Expr m                = common::AutoSimplify(crows->shape[0] - Expr(1));
+  Expr n                = dense->shape[1];
+  return lang::Compute(
+      {m, n},
+      [=](const std::vector<Expr>& indices) {
+        return lang::CallExtern(func_name, {crows, cols, values, dense, indices[0], indices[1], n});
+      },
+      output_name);
+}
+
+ir::Tensor Sddmm(const ir::Tensor& rows,
+                 const ir::Tensor& cols,
+                 const ir::Tensor& x,
+                 const ir::Tensor& y,
+                 const common::Target& target,
+                 const std::string& output_name) {
+  CHECK_EQ(x->shape.size(), 2U) << "The x of sddmm should be 2-D";
+  CHECK_EQ(y->shape.size(), 2U) << "The y of sddmm should be 2-D";
+  std::string func_name = GetExternFuncName(target, x->type(), "sddmm");
+  Expr k                = x->shape[1];
+  return lang::Compute(
+      rows->shape,
+      [=](const std::vector<Expr>& indices) {
+        return lang::CallExtern(func_name, {rows, cols, x, y, indices[0], k});
+      },
+      output_name);
+}
+
+namespace {
+using SparseComputeFunc = std::function<ir::Tensor(const std::vector<ir::Tensor>&, const std::string&)>;
+
+// Both sparse ops take 4 input tensors and compute an element of the output by a thread, so they share the injective
+// schedule, which lets the elementwise epilogues be fused into the sparse kernel.
+std::shared_ptr<framework::OpStrategy> MakeSparseStrategy(const std::string& op_name,
+                                                          const SparseComputeFunc& compute_func,
+                                                          const std::vector<std::vector<int>>& output_shapes,
+                                                          const Target& target) {
+  framework::CINNCompute sparse_compute([=](lang::Args args, lang::RetValue* ret) {
+    CHECK(!args.empty()) << "The input arguments of " << op_name << " compute is empty! Please check.\n";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 4U) << "4 input tensors for " << op_name << " compute\n";
+    std::vector<ir::Tensor> inputs;
+    for (int i = 0; i < 4; ++i) {
+      Expr input = pack_args[i];
+      CHECK(input.as_tensor());
+      inputs.push_back(input.as_tensor_ref());
+    }
+    auto stages             = CreateStages(inputs);
+    std::string tensor_name = UniqName(op_name + "_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 5U);
+      tensor_name = pack_args[4].operator std::string();
+    }
+    ir::Tensor out = compute_func(inputs, tensor_name);
+    stages->InsertLazily(out);
+    *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(sparse_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name, 1);
+  return strategy;
+}
+}  // namespace
+
+std::shared_ptr<framework::OpStrategy> StrategyForCsrSpmm(const framework::NodeAttr& attrs,
+                                                          const std::vector<ir::Tensor>& inputs,
+                                                          const std::vector<Type>& out_type,
+                                                          const std::vector<std::vector<int>>& output_shapes,
+                                                          const Target& target) {
+  return MakeSparseStrategy(
+      "csr_spmm",
+      [=](const std::vector<ir::Tensor>& tensors, const std::string& name) {
+        return CsrSpmm(tensors[0], tensors[1], tensors[2], tensors[3], target, name);
+      },
+      output_shapes,
+      target);
+}
+
+std::shared_ptr<framework::OpStrategy> StrategyForSddmm(const framework::NodeAttr& attrs,
+                                                        const std::vector<ir::Tensor>& inputs,
+                                                        const std::vector<Type>& out_type,
+                                                        const std::vector<std::vector<int>>& output_shapes,
+                                                        const Target& target) {
+  return MakeSparseStrategy(
+      "sddmm",
+      [=](const std::vector<ir::Tensor>& tensors, const std::string& name) {
+        return Sddmm(tensors[0], tensors[1], tensors[2], tensors[3], target, name);
+      },
+      output_shapes,
+      target);
+}
+
+// csr_spmm(crows[M + 1], cols[nnz], values[nnz], dense[K, N]) -> [M, N]
+std::vector<framework::shape_t> InferShapeForCsrSpmm(const std::vector<framework::shape_t>& inputs_shape,
+                                                     const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "The csr_spmm takes crows, cols, values and dense! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 1U) << "The crows of csr_spmm should be 1-D!";
+  CHECK_EQ(inputs_shape[1].size(), 1U) << "The cols of csr_spmm should be 1-D!";
+  CHECK(inputs_shape[1] == inputs_shape[2]) << "The cols and values of csr_spmm should have the same shape!";
+  CHECK_EQ(inputs_shape[3].size(), 2U) << "The dense matrix of csr_spmm should be 2-D!";
+  CHECK_GE(inputs_shape[0][0], 1) << "The crows of csr_spmm should have M + 1 elements!";
+  return {{inputs_shape[0][0] - 1, inputs_shape[3][1]}};
+}
+
+std::vector<Type> InferDtypeForCsrSpmm(const std::vector<Type>& inputs_type, const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_type.size(), 4U) << "The csr_spmm takes crows, cols, values and dense! Please check again.";
+  CHECK(inputs_type[0].is_int(32) && inputs_type[1].is_int(32)) << "The indices of csr_spmm should be int32!";
+  CHECK_EQ(inputs_type[2], inputs_type[3]) << "The values and dense of csr_spmm should have the same dtype!";
+  return {inputs_type[2]};
+}
+
+// sddmm(rows[nnz], cols[nnz], x[M, K], y[N, K]) -> [nnz]
+std::vector<framework::shape_t> InferShapeForSddmm(const std::vector<framework::shape_t>& inputs_shape,
+                                                   const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "The sddmm takes rows, cols, x and y! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 1U) << "The rows of sddmm should be 1-D!";
+  CHECK(inputs_shape[0] == inputs_shape[1]) << "The rows and cols of sddmm should have the same shape!";
+  CHECK_EQ(inputs_shape[2].size(), 2U) << "The x of sddmm should be 2-D!";
+  CHECK_EQ(inputs_shape[3].size(), 2U) << "The y of sddmm should be 2-D!";
+  CHECK_EQ(inputs_shape[2][1], inputs_shape[3][1]) << "The K dimension of sddmm should be equal! Please check.";
+  return {inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForSddmm(const std::vector<Type>& inputs_type, const framework::AttrMapType& attrs) {
+  CHECK_EQ(inputs_type.size(), 4U) << "The sddmm takes rows, cols, x and y! Please check again.";
+  CHECK(inputs_type[0].is_int(32) && inputs_type[1].is_int(32)) << "The indices of sddmm should be int32!";
+  CHECK_EQ(inputs_type[2], inputs_type[3]) << "The x and y of sddmm should have the same dtype!";
+  return {inputs_type[2]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(sparse_ops) {
+  CINN_REGISTER_OP(csr_spmm)
+      .describe("The product of a CSR sparse matrix and a dense matrix")
+      .set_num_inputs(4)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCsrSpmm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForCsrSpmm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCsrSpmm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(sddmm)
+      .describe("The sampled dense-dense matrix multiplication at the COO indices")
+      .set_num_inputs(4)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForSddmm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForSddmm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForSddmm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+/**
+ * The product of the CSR sparse matrix [M, K] and the dense matrix [K, N], where the sparse matrix is given by the
+ * int32 row offsets crows of [M + 1], the int32 column indices cols of [nnz] and the values of [nnz]. An element of
+ * the output is computed by a thread over the non-zeros of its row, so it is scheduled and fused as an injective op.
+ */
+ir::Tensor CsrSpmm(const ir::Tensor& crows,
+                   const ir::Tensor& cols,
+                   const ir::Tensor& values,
+                   const ir::Tensor& dense,
+                   const common::Target& target,
+                   const std::string& output_name);
+
+/**
+ * The sampled dense-dense matrix multiplication out[p] = dot(x[rows[p], :], y[cols[p], :]), where x is [M, K], y is
+ * [N, K], and the int32 rows and cols of [nnz] are the COO indices of the sampled elements of x * y^T.
+ */
+ir::Tensor Sddmm(const ir::Tensor& rows,
+                 const ir::Tensor& cols,
+                 const ir::Tensor& x,
+                 const ir::Tensor& y,
+                 const common::Target& target,
+                 const std::string& output_name);
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/macros.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/op/op_util.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+// The sparse matmul is only computed by cuSPARSELt on the sparse tensor cores, which is called through the
+// custom_call on NVGPU, so it has no compute of its own.
+std::shared_ptr<framework::OpStrategy> StrategyForSparseMatmul(const framework::NodeAttr &attrs,
+                                                               const std::vector<ir::Tensor> &inputs,
+                                                               const std::vector<Type> &out_type,
+                                                               const std::vector<std::vector<int>> &output_shapes,
+                                                               const Target &target) {
+  framework::CINNCompute sparse_matmul_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The sparse_matmul is only implemented by the custom_call on NVGPU, please check whether the "
+                  "TransToCustomCallPass is applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      sparse_matmul_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy.sparse_matmul.x86", 1);
+  return strategy;
+}
+
+// sparse_matmul(x[m, k], w[n, k]) -> alpha * x * w^T of shape [m, n], where w is 2:4 sparse along k
+std::vector<framework::shape_t> InferShapeForSparseMatmul(const std::vector<framework::shape_t> &inputs_shape,
+                                                          const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The sparse_matmul takes x and w! Please check again.";
+  const auto &x_shape = inputs_shape[0];
+  const auto &w_shape = inputs_shape[1];
+  CHECK_EQ(x_shape.size(), 2U) << "The x of sparse_matmul should be 2-D!";
+  CHECK_EQ(w_shape.size(), 2U) << "The w of sparse_matmul should be 2-D!";
+  CHECK_EQ(x_shape[1], w_shape[1]) << "The K dimension of sparse_matmul should be equal! Please check.";
+  return {{x_shape[0], w_shape[0]}};
+}
+
+std::vector<Type> InferDtypeForSparseMatmul(const std::vector<Type> &inputs_type,
+                                            const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The sparse_matmul takes x and w! Please check again.";
+  CHECK(inputs_type[0].is_float16() || inputs_type[0].is_bfloat16())
+      << "The x of sparse_matmul should be float16 or bfloat16, but here " << inputs_type[0];
+  CHECK_EQ(inputs_type[0], inputs_type[1]) << "The x and w of sparse_matmul should have the same dtype!";
+  return {inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(sparse_matmul_ops) {
+  CINN_REGISTER_OP(sparse_matmul)
+      .describe("The matmul of the 2:4 structured sparse weight, whose right input is transposed")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForSparseMatmul)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForSparseMatmul))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForSparseMatmul))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
+      .set_support_level(4);
+
+  return true;
+}
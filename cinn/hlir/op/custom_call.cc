@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
 #include "cinn/backends/codegen_cuda_util.h"
 #include "cinn/common/cas.h"
 #include "cinn/hlir/framework/node.h"
@@ -30,6 +36,8 @@
 #include "cudnn.h"
 #endif
 
+DECLARE_bool(cinn_scatter_add_deterministic);
+
 namespace cinn {
 namespace hlir {
 namespace op {
@@ -90,8 +98,8 @@ std::shared_ptr<OpStrategy> StrategyForCustomCall(const framework::NodeAttr &att
     host_args.insert(host_args.end(), args_list.begin(), args_list.end());
     std::vector<ir::Argument> arguments = {ir::Argument(kernel_args, ir::Argument::IO::kOutput),
                                            ir::Argument(kernel_args_num, ir::Argument::IO::kInput)};
-    // if target is nvgpu, add stream.
-    if (target == common::DefaultNVGPUTarget()) {
+    // if target is a gpu, add stream.
+    if (target.is_gpu()) {
       ir::Var kernel_stream(KERNEL_STREAM, type_of<void *>());
 
       host_args.push_back(kernel_stream);
@@ -112,7 +120,7 @@ std::shared_ptr<OpStrategy> StrategyForCustomCall(const framework::NodeAttr &att
   return strategy;
 }
 
-#ifdef CINN_WITH_CUDA
+#if defined(CINN_WITH_CUDA) || defined(CINN_WITH_ROCM)
 std::vector<ir::Expr> CustomCallArgsForCublas(const framework::NodeAttr &attrs,
                                               const std::vector<ir::Tensor> &inputs,
                                               const std::vector<std::vector<int>> &output_shapes) {
@@ -215,20 +223,163 @@ std::vector<ir::Expr> CustomCallArgsForCublas(const framework::NodeAttr &attrs,
   args.insert(args.end(), b_shape.begin(), b_shape.end());
   return args;
 }
+#endif
+
+#ifdef CINN_WITH_ROCM
+std::vector<ir::Expr> CustomCallArgsForMIOpenConvForward(const framework::NodeAttr &attrs,
+                                                         const std::vector<ir::Tensor> &inputs,
+                                                         const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 2UL);
+  const auto &attr_store = attrs.attr_store;
+  float alpha            = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
+  float beta             = attr_store.count("beta") ? absl::get<float>(attr_store.at("beta")) : 0.0f;
+
+  CHECK(attr_store.count("padding"));
+  auto padding = absl::get<std::vector<int>>(attr_store.at("padding"));
+  CHECK(attr_store.count("stride"));
+  auto stride = absl::get<std::vector<int>>(attr_store.at("stride"));
+  auto dilation =
+      attr_store.count("dilation") ? absl::get<std::vector<int>>(attr_store.at("dilation")) : std::vector<int>({1, 1});
+  std::string data_format =
+      attr_store.count("data_format") ? absl::get<std::string>(attr_store.at("data_format")) : "NCHW";
+  CHECK(data_format != "NHWC") << "MIOpen conv2d only takes the NCHW layout";
+  int groups = attr_store.count("groups") ? absl::get<int>(attr_store.at("groups")) : 1;
+
+  std::vector<Expr> input  = inputs[0]->shape;
+  std::vector<Expr> filter = inputs[1]->shape;
+  std::vector<Expr> output = {};
+  std::transform(output_shapes[0].begin(), output_shapes[0].end(), std::back_inserter(output), [](const int dim) {
+    return ir::Expr(dim);
+  });
+
+  std::vector<ir::Expr> args = {ir::Expr(alpha), ir::Expr(beta)};
+  args.insert(args.end(), input.begin(), input.end());
+  args.insert(args.end(), filter.begin(), filter.end());
+  args.push_back(ir::Expr(padding[0]));
+  args.push_back(ir::Expr(padding[1]));
+  args.push_back(ir::Expr(stride[0]));
+  args.push_back(ir::Expr(stride[1]));
+  args.push_back(ir::Expr(dilation[0]));
+  args.push_back(ir::Expr(dilation[1]));
+  args.push_back(ir::Expr(groups));
+  args.insert(args.end(), output.begin(), output.end());
+
+  return args;
+}
+#endif
+
+#ifdef CINN_WITH_CUDA
+std::vector<ir::Expr> CustomCallArgsForCublasLt(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<std::vector<int>> &output_shapes) {
+  CHECK(inputs.size() == 3 || inputs.size() == 4) << "The cublasLt matmul should have inputs A, B, bias and residual";
+  CHECK_EQ(output_shapes.size(), 1);
+  CHECK_EQ(inputs[0]->shape.size(), 2);
+  CHECK_EQ(inputs[1]->shape.size(), 2);
+  CHECK_EQ(inputs[2]->shape.size(), 1);
+
+  const auto &attr_store = attrs.attr_store;
+  bool trans_a           = attr_store.count("trans_a") ? absl::get<bool>(attr_store.at("trans_a")) : false;
+  bool trans_b           = attr_store.count("trans_b") ? absl::get<bool>(attr_store.at("trans_b")) : false;
+  float alpha            = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
+  std::string epilogue   = attr_store.count("epilogue") ? absl::get<std::string>(attr_store.at("epilogue")) : "";
+
+  int m = trans_a ? inputs[0]->shape[1].as_int32() : inputs[0]->shape[0].as_int32();
+  int k = trans_a ? inputs[0]->shape[0].as_int32() : inputs[0]->shape[1].as_int32();
+  int n = trans_b ? inputs[1]->shape[0].as_int32() : inputs[1]->shape[1].as_int32();
+  CHECK_EQ(k, trans_b ? inputs[1]->shape[1].as_int32() : inputs[1]->shape[0].as_int32())
+      << "The K dimension of matmul should be equal! Please check.";
+  CHECK_EQ(n, inputs[2]->shape[0].as_int32()) << "The bias should have the same size as the N dimension of matmul!";
+
+  // the epilogue code is consistent with cinn_call_cublaslt_matmul
+  static const std::unordered_map<std::string, int> epilogue_codes = {
+      {"", 0}, {"bias", 1}, {"bias_relu", 2}, {"bias_residual", 3}, {"bias_residual_relu", 4}};
+  CHECK(epilogue_codes.count(epilogue)) << "Unsupported cublasLt epilogue: " << epilogue;
+  int epilogue_code = epilogue_codes.at(epilogue);
+  bool residual     = epilogue_code >= 3;
+  CHECK_EQ(inputs.size(), residual ? 4UL : 3UL) << "The residual should be given by the epilogue " << epilogue;
+  if (residual) {
+    CHECK_EQ(inputs[3]->shape.size(), 2);
+    CHECK_EQ(inputs[3]->shape[0].as_int32(), m) << "The residual should have the same shape as the output of matmul!";
+    CHECK_EQ(inputs[3]->shape[1].as_int32(), n) << "The residual should have the same shape as the output of matmul!";
+  }
+
+  std::vector<ir::Expr> args = {
+      Expr(trans_a), Expr(trans_b), Expr(alpha), Expr(m), Expr(n), Expr(k), Expr(epilogue_code)};
+  return args;
+}
+
+// fp8_matmul(x[m, k], y[n, k], x_scale, y_scale) takes the alpha and the sizes of the gemm.
+std::vector<ir::Expr> CustomCallArgsForCublasLtFp8(const framework::NodeAttr &attrs,
+                                                   const std::vector<ir::Tensor> &inputs,
+                                                   const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 4) << "The fp8 matmul should have inputs x, y, x_scale and y_scale";
+  CHECK_EQ(output_shapes.size(), 1);
+  CHECK_EQ(inputs[0]->shape.size(), 2);
+  CHECK_EQ(inputs[1]->shape.size(), 2);
+
+  const auto &attr_store = attrs.attr_store;
+  float alpha            = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
+
+  int m = inputs[0]->shape[0].as_int32();
+  int k = inputs[0]->shape[1].as_int32();
+  int n = inputs[1]->shape[0].as_int32();
+  CHECK_EQ(k, inputs[1]->shape[1].as_int32()) << "The K dimension of fp8 matmul should be equal! Please check.";
+  return {Expr(alpha), Expr(m), Expr(n), Expr(k)};
+}
+
+// csr_spmm(crows[m + 1], cols[nnz], values[nnz], dense[k, n]) takes the sizes of the sparse matmul.
+std::vector<ir::Expr> CustomCallArgsForCusparseSpmm(const framework::NodeAttr &attrs,
+                                                    const std::vector<ir::Tensor> &inputs,
+                                                    const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 4UL) << "The csr_spmm takes the crows, cols, values and dense";
+  int m   = inputs[0]->shape[0].as_int32() - 1;
+  int nnz = inputs[1]->shape[0].as_int32();
+  int k   = inputs[3]->shape[0].as_int32();
+  int n   = inputs[3]->shape[1].as_int32();
+  return {Expr(m), Expr(n), Expr(k), Expr(nnz)};
+}
+
+#ifdef CINN_WITH_CUSPARSELT
+// sparse_matmul(x[m, k], w[n, k]) takes the alpha and the sizes of the gemm.
+std::vector<ir::Expr> CustomCallArgsForCusparseLt(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 2) << "The sparse matmul should have inputs x and w";
+  CHECK_EQ(output_shapes.size(), 1);
+  CHECK_EQ(inputs[0]->shape.size(), 2);
+  CHECK_EQ(inputs[1]->shape.size(), 2);
+
+  const auto &attr_store = attrs.attr_store;
+  float alpha            = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
+
+  int m = inputs[0]->shape[0].as_int32();
+  int k = inputs[0]->shape[1].as_int32();
+  int n = inputs[1]->shape[0].as_int32();
+  CHECK_EQ(k, inputs[1]->shape[1].as_int32()) << "The K dimension of sparse matmul should be equal! Please check.";
+  return {Expr(alpha), Expr(m), Expr(n), Expr(k)};
+}
+#endif
 
 std::vector<ir::Expr> CustomCallArgsForBatchedCublas(const framework::NodeAttr &attrs,
                                                      const std::vector<ir::Tensor> &inputs,
                                                      const std::vector<std::vector<int>> &output_shapes) {
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("side"));
+  const auto &side = absl::get<std::string>(attr_store.at("side"));
   CHECK_GT(inputs.size(), 2);
   CHECK_GT(output_shapes.size(), 1);
-  CHECK_EQ(inputs.size() - 1, output_shapes.size());
+  if (side == "grouped") {
+    CHECK_EQ(inputs.size(), output_shapes.size() * 2);
+  } else {
+    CHECK_EQ(inputs.size() - 1, output_shapes.size());
+  }
 
-  const auto &attr_store = attrs.attr_store;
-  bool trans_a           = attr_store.count("trans_a") ? absl::get<bool>(attr_store.at("trans_a")) : false;
-  bool trans_b           = attr_store.count("trans_b") ? absl::get<bool>(attr_store.at("trans_b")) : false;
-  bool trans_out         = attr_store.count("trans_out") ? absl::get<bool>(attr_store.at("trans_out")) : false;
-  float alpha            = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
-  float beta             = attr_store.count("beta") ? absl::get<float>(attr_store.at("beta")) : 0.0f;
+  bool trans_a   = attr_store.count("trans_a") ? absl::get<bool>(attr_store.at("trans_a")) : false;
+  bool trans_b   = attr_store.count("trans_b") ? absl::get<bool>(attr_store.at("trans_b")) : false;
+  bool trans_out = attr_store.count("trans_out") ? absl::get<bool>(attr_store.at("trans_out")) : false;
+  float alpha    = attr_store.count("alpha") ? absl::get<float>(attr_store.at("alpha")) : 1.0f;
+  float beta     = attr_store.count("beta") ? absl::get<float>(attr_store.at("beta")) : 0.0f;
 
   int x_num_col_dims = attr_store.count("x_num_col_dims") ? absl::get<int>(attr_store.at("x_num_col_dims")) : 0;
   int y_num_col_dims = attr_store.count("y_num_col_dims") ? absl::get<int>(attr_store.at("y_num_col_dims")) : 0;
@@ -236,10 +387,13 @@ std::vector<ir::Expr> CustomCallArgsForBatchedCublas(const framework::NodeAttr &
   CHECK((x_num_col_dims == 0 && y_num_col_dims == 0) || (x_num_col_dims > 0 && y_num_col_dims > 0));
 
   ir::Tensor left, right;
-  CHECK(attr_store.count("side"));
-  if (absl::get<std::string>(attr_store.at("side")) == "left") {
+  if (side == "left") {
     left  = inputs[0];
     right = inputs[1];
+  } else if (side == "grouped") {
+    // the inputs are [A0, A1, ..., B0, B1, ...], and all the gemms have the same shape
+    left  = inputs[0];
+    right = inputs[output_shapes.size()];
   } else {
     left  = inputs[1];
     right = inputs[0];
@@ -321,7 +475,7 @@ std::vector<ir::Expr> CustomCallArgsForBatchedCublas(const framework::NodeAttr &
   CHECK_EQ(a_shape.size(), 4);
   CHECK_EQ(b_shape.size(), 4);
   // func args
-  std::vector<ir::Expr> args = {absl::get<std::string>(attr_store.at("side")) == "left" ? ir::Expr(0) : ir::Expr(1),
+  std::vector<ir::Expr> args = {side == "left" ? ir::Expr(0) : (side == "right" ? ir::Expr(1) : ir::Expr(2)),
                                 ir::Expr(trans_a),
                                 ir::Expr(trans_b),
                                 ir::Expr(trans_out),
@@ -605,6 +759,33 @@ std::vector<ir::Expr> CustomCallArgsForAssertTrue(const framework::NodeAttr &att
   return args;
 }
 
+std::vector<ir::Expr> CustomCallArgsForCond(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<std::vector<int>> &output_shapes) {
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("body_id"));
+  int body_id = absl::get<int>(attr_store.at("body_id"));
+
+  std::vector<ir::Expr> args = {ir::Expr(body_id)};
+
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForWhileLoop(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<std::vector<int>> &output_shapes) {
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("body_id"));
+  CHECK(attr_store.count("num_loop_vars"));
+  int body_id       = absl::get<int>(attr_store.at("body_id"));
+  int num_loop_vars = absl::get<int>(attr_store.at("num_loop_vars"));
+  CHECK_EQ(output_shapes.size(), num_loop_vars);
+
+  std::vector<ir::Expr> args = {ir::Expr(body_id), ir::Expr(num_loop_vars)};
+
+  return args;
+}
+
 std::vector<ir::Expr> CustomCallArgsForGaussianRandom(const framework::NodeAttr &attrs,
                                                       const std::vector<ir::Tensor> &inputs,
                                                       const std::vector<std::vector<int>> &output_shapes) {
@@ -713,6 +894,444 @@ std::vector<ir::Expr> CustomCallArgsForTriangularSolve(const framework::NodeAttr
   return args;
 }
 
+std::vector<ir::Expr> CustomCallArgsForFlashAttention(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<std::vector<int>> &output_shapes) {
+  CHECK(inputs.size() == 3UL || inputs.size() == 4UL) << "The fused_attention takes q, k, v and an optional mask";
+  const auto &attr_store = attrs.attr_store;
+  float scale            = attr_store.count("scale") ? absl::get<float>(attr_store.at("scale")) : 1.0f;
+  bool causal            = attr_store.count("causal") ? absl::get<bool>(attr_store.at("causal")) : false;
+
+  ir::Tensor q  = inputs[0];
+  ir::Tensor v  = inputs[2];
+  int seq_k     = v->shape[2].as_int32();
+  int value_dim = v->shape[3].as_int32();
+
+  // the mask is broadcast along the dimensions of size 1.
+  int mask_batch_stride = 0, mask_head_stride = 0, mask_row_stride = 0;
+  if (inputs.size() == 4UL) {
+    ir::Tensor mask  = inputs[3];
+    mask_row_stride  = mask->shape[2].as_int32() == 1 ? 0 : seq_k;
+    mask_head_stride = mask->shape[1].as_int32() == 1 ? 0 : mask->shape[2].as_int32() * seq_k;
+    mask_batch_stride =
+        mask->shape[0].as_int32() == 1 ? 0 : mask->shape[1].as_int32() * mask->shape[2].as_int32() * seq_k;
+  }
+
+  std::vector<ir::Expr> args = {ir::Expr(q->shape[0].as_int32()),
+                                ir::Expr(q->shape[1].as_int32()),
+                                ir::Expr(q->shape[2].as_int32()),
+                                ir::Expr(seq_k),
+                                ir::Expr(q->shape[3].as_int32()),
+                                ir::Expr(value_dim),
+                                ir::Expr(mask_batch_stride),
+                                ir::Expr(mask_head_stride),
+                                ir::Expr(mask_row_stride),
+                                ir::Expr(scale),
+                                ir::Expr(causal)};
+
+  return args;
+}
+
+// Get the sizes of the dimensions before, on and after the sorted axis.
+std::vector<int> GetSortSegmentSizes(const ir::Tensor &x, int axis) {
+  int rank = x->shape.size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  CHECK(axis >= 0 && axis < rank) << "The axis " << axis << " is out of the rank of " << x->name;
+  int outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) {
+    outer *= x->shape[i].as_int32();
+  }
+  for (int i = axis + 1; i < rank; ++i) {
+    inner *= x->shape[i].as_int32();
+  }
+  return {outer, x->shape[axis].as_int32(), inner};
+}
+
+std::vector<ir::Expr> CustomCallArgsForSort(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 1UL) << "The sort takes only one input";
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("axis")) << "find no attr of axis";
+  int axis       = absl::get<int>(attr_store.at("axis"));
+  bool is_ascend = attr_store.count("is_ascend") ? absl::get<bool>(attr_store.at("is_ascend")) : true;
+
+  auto sizes = GetSortSegmentSizes(inputs[0], axis);
+  std::vector<ir::Expr> args{ir::Expr(sizes[0]), ir::Expr(sizes[1]), ir::Expr(sizes[2]), ir::Expr(is_ascend)};
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForTopK(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 1UL) << "The top_k takes only one input";
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("k")) << "find no attr of k";
+  CHECK(attr_store.count("axis")) << "find no attr of axis";
+  int k        = absl::get<int>(attr_store.at("k"));
+  int axis     = absl::get<int>(attr_store.at("axis"));
+  bool largest = attr_store.count("largest") ? absl::get<bool>(attr_store.at("largest")) : true;
+
+  auto sizes = GetSortSegmentSizes(inputs[0], axis);
+  std::vector<ir::Expr> args{
+      ir::Expr(sizes[0]), ir::Expr(sizes[1]), ir::Expr(sizes[2]), ir::Expr(std::min(k, sizes[1])), ir::Expr(largest)};
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForCumulative(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 1UL) << "The cumulative op takes only one input";
+  const auto &attr_store = attrs.attr_store;
+  int axis               = attr_store.count("axis") ? absl::get<int>(attr_store.at("axis")) : -1;
+  bool exclusive         = attr_store.count("exclusive") ? absl::get<bool>(attr_store.at("exclusive")) : false;
+  bool reverse           = attr_store.count("reverse") ? absl::get<bool>(attr_store.at("reverse")) : false;
+
+  auto sizes = GetSortSegmentSizes(inputs[0], axis);
+  std::vector<ir::Expr> args{
+      ir::Expr(sizes[0]), ir::Expr(sizes[1]), ir::Expr(sizes[2]), ir::Expr(exclusive), ir::Expr(reverse)};
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForLookupTable(const framework::NodeAttr &attrs,
+                                                   const std::vector<ir::Tensor> &inputs,
+                                                   const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 2UL) << "The lookup_table takes the table and the ids";
+  const auto &attr_store = attrs.attr_store;
+  int64_t padding_idx    = attr_store.count("padding_idx") ? absl::get<int64_t>(attr_store.at("padding_idx")) : -1;
+
+  ir::Tensor table = inputs[0];
+  int num_ids      = 1;
+  for (auto &dim : inputs[1]->shape) {
+    num_ids *= dim.as_int32();
+  }
+  std::vector<ir::Expr> args{ir::Expr(num_ids),
+                             ir::Expr(table->shape[0].as_int32()),
+                             ir::Expr(table->shape[1].as_int32()),
+                             ir::Expr(padding_idx)};
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForScatterAdd(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 3UL) << "The scatter_add takes the input, the updates and the index";
+  const auto &attr_store = attrs.attr_store;
+  int axis               = attr_store.count("axis") ? absl::get<int>(attr_store.at("axis")) : 0;
+
+  auto sizes = GetSortSegmentSizes(inputs[0], axis);
+  std::vector<ir::Expr> args{ir::Expr(sizes[0]),
+                             ir::Expr(sizes[1]),
+                             ir::Expr(inputs[2]->shape[0].as_int32()),
+                             ir::Expr(sizes[2]),
+                             ir::Expr(FLAGS_cinn_scatter_add_deterministic)};
+  return args;
+}
+
+// The operands of the same shape are viewed as [outer, inner], split before the axis of concat or split.
+std::vector<ir::Expr> GetSegmentCopyArgs(const framework::NodeAttr &attrs, const std::vector<int> &operand_shape) {
+  const auto &attr_store = attrs.attr_store;
+  int axis               = attr_store.count("axis") ? absl::get<int>(attr_store.at("axis")) : 0;
+  int rank               = operand_shape.size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  CHECK(axis >= 0 && axis < rank) << "The axis " << axis << " is out of the rank " << rank;
+  int outer = 1, inner = 1;
+  for (int i = 0; i < rank; ++i) {
+    (i < axis ? outer : inner) *= operand_shape[i];
+  }
+  return {ir::Expr(outer), ir::Expr(inner)};
+}
+
+std::vector<ir::Expr> CustomCallArgsForConcat(const framework::NodeAttr &attrs,
+                                              const std::vector<ir::Tensor> &inputs,
+                                              const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_GE(inputs.size(), 2UL) << "The concat takes at least 2 inputs";
+  std::vector<int> shape;
+  for (auto &dim : inputs[0]->shape) {
+    shape.push_back(dim.as_int32());
+  }
+  return GetSegmentCopyArgs(attrs, shape);
+}
+
+std::vector<ir::Expr> CustomCallArgsForSplit(const framework::NodeAttr &attrs,
+                                             const std::vector<ir::Tensor> &inputs,
+                                             const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 1UL) << "The split takes only one input";
+  CHECK_GE(output_shapes.size(), 2UL) << "The split has at least 2 outputs";
+  return GetSegmentCopyArgs(attrs, output_shapes[0]);
+}
+
+// The norm is computed over the dimensions from begin_norm_axis, which are flattened into the columns.
+std::vector<ir::Expr> CustomCallArgsForNorm(const framework::NodeAttr &attrs,
+                                           const std::vector<ir::Tensor> &inputs,
+                                           const std::vector<std::vector<int>> &output_shapes) {
+  CHECK(!inputs.empty()) << "The norm takes the x as the first input";
+  const auto &attr_store = attrs.attr_store;
+  float epsilon          = attr_store.count("epsilon") ? absl::get<float>(attr_store.at("epsilon")) : 1e-5f;
+  int begin_norm_axis    = attr_store.count("begin_norm_axis") ? absl::get<int>(attr_store.at("begin_norm_axis")) : 1;
+
+  const auto &x_shape = inputs[0]->shape;
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += x_shape.size();
+  }
+  int rows = 1, cols = 1;
+  for (int i = 0; i < x_shape.size(); ++i) {
+    (i < begin_norm_axis ? rows : cols) *= x_shape[i].as_int32();
+  }
+  return {ir::Expr(rows), ir::Expr(cols), ir::Expr(epsilon)};
+}
+
+std::vector<ir::Expr> CustomCallArgsForRMSNormGrad(const framework::NodeAttr &attrs,
+                                                   const std::vector<ir::Tensor> &inputs,
+                                                   const std::vector<std::vector<int>> &output_shapes) {
+  auto args = CustomCallArgsForNorm(attrs, inputs, output_shapes);
+  // the inverse root mean square saved by the forward already contains the epsilon
+  args.pop_back();
+  return args;
+}
+
+// The x of the batch_norm_train and the dy of the batch_norm_grad have the same shape, which is viewed as
+// [outer, channels, inner] by its data_layout.
+std::vector<ir::Expr> CustomCallArgsForBatchNorm(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<std::vector<int>> &output_shapes) {
+  CHECK(!inputs.empty()) << "The batch_norm takes the x or the dy as the first input";
+  const auto &attr_store = attrs.attr_store;
+  float epsilon          = attr_store.count("epsilon") ? absl::get<float>(attr_store.at("epsilon")) : 1e-5f;
+  std::string data_layout =
+      attr_store.count("data_layout") ? absl::get<std::string>(attr_store.at("data_layout")) : "NCHW";
+
+  const auto &x_shape = inputs[0]->shape;
+  CHECK_EQ(x_shape.size(), 4UL) << "The batch_norm only supports the 4-D input";
+  CHECK(data_layout == "NCHW" || data_layout == "NHWC") << "The batch_norm does not support " << data_layout;
+  int channel_axis = data_layout == "NCHW" ? 1 : 3;
+  int outer = 1, inner = 1;
+  for (int i = 0; i < x_shape.size(); ++i) {
+    if (i < channel_axis) {
+      outer *= x_shape[i].as_int32();
+    } else if (i > channel_axis) {
+      inner *= x_shape[i].as_int32();
+    }
+  }
+  return {ir::Expr(x_shape[channel_axis].as_int32()), ir::Expr(outer), ir::Expr(inner), ir::Expr(epsilon)};
+}
+
+std::vector<ir::Expr> CustomCallArgsForBatchNormTrain(const framework::NodeAttr &attrs,
+                                                     const std::vector<ir::Tensor> &inputs,
+                                                     const std::vector<std::vector<int>> &output_shapes) {
+  auto args              = CustomCallArgsForBatchNorm(attrs, inputs, output_shapes);
+  const auto &attr_store = attrs.attr_store;
+  args.emplace_back(attr_store.count("momentum") ? absl::get<float>(attr_store.at("momentum")) : 0.9f);
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForArgReduce(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 1UL) << "The arg_reduce takes only one input";
+  const auto &attr_store = attrs.attr_store;
+  CHECK(attr_store.count("axis")) << "find no attr of axis";
+  int axis    = absl::get<int>(attr_store.at("axis"));
+  bool is_max = attr_store.count("is_max") ? absl::get<bool>(attr_store.at("is_max")) : true;
+
+  auto sizes = GetSortSegmentSizes(inputs[0], axis);
+  return {ir::Expr(sizes[0]), ir::Expr(sizes[1]), ir::Expr(sizes[2]), ir::Expr(is_max)};
+}
+
+std::vector<ir::Expr> CustomCallArgsForKVCacheAppend(const framework::NodeAttr &attrs,
+                                                    const std::vector<ir::Tensor> &inputs,
+                                                    const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 6UL) << "The kv_cache_append takes 6 inputs";
+  // key_cache: [num_blocks, num_kv_heads, block_size, head_dim], block_tables: [batch_size, max_blocks_per_seq]
+  auto cache_shape = ToPodVector<int>(inputs[0]->shape);
+  auto table_shape = ToPodVector<int>(inputs[2]->shape);
+  return {ir::Expr(table_shape[0]),
+          ir::Expr(cache_shape[1]),
+          ir::Expr(cache_shape[3]),
+          ir::Expr(cache_shape[2]),
+          ir::Expr(table_shape[1])};
+}
+
+std::vector<ir::Expr> CustomCallArgsForPagedAttention(const framework::NodeAttr &attrs,
+                                                     const std::vector<ir::Tensor> &inputs,
+                                                     const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 5UL) << "The paged_attention takes 5 inputs";
+  // query: [batch_size, num_heads, head_dim]
+  auto query_shape       = ToPodVector<int>(inputs[0]->shape);
+  auto cache_shape       = ToPodVector<int>(inputs[1]->shape);
+  auto table_shape       = ToPodVector<int>(inputs[3]->shape);
+  const auto &attr_store = attrs.attr_store;
+  float scale            = attr_store.count("scale") ? absl::get<float>(attr_store.at("scale")) : 0.0f;
+  if (scale <= 0.0f) {
+    scale = 1.0f / std::sqrt(static_cast<float>(query_shape[2]));
+  }
+  return {ir::Expr(query_shape[0]),
+          ir::Expr(query_shape[1]),
+          ir::Expr(cache_shape[1]),
+          ir::Expr(query_shape[2]),
+          ir::Expr(cache_shape[2]),
+          ir::Expr(table_shape[1]),
+          ir::Expr(scale)};
+}
+
+// Collapse the leading dimensions of x into 3 dimensions on which the offset of the mask row is linear, and return
+// the sizes of the last two and the strides of the mask on all three. The mask is broadcast along its dimensions of
+// size 1, its last dimension should be the same as x.
+std::vector<int> GetSoftmaxMaskStrides(const std::vector<int> &x_shape, std::vector<int> mask_shape) {
+  CHECK_LE(mask_shape.size(), x_shape.size()) << "The rank of the mask should not be larger than x";
+  CHECK_EQ(mask_shape.back(), x_shape.back()) << "The mask should not be broadcast along the softmax axis";
+  mask_shape.insert(mask_shape.begin(), x_shape.size() - mask_shape.size(), 1);
+
+  std::vector<std::pair<int, int>> dims;
+  int stride = mask_shape.back();
+  for (int i = x_shape.size() - 2; i >= 0; --i) {
+    int dim_stride = mask_shape[i] == 1 ? 0 : stride;
+    stride *= mask_shape[i];
+    if (x_shape[i] == 1) {
+      continue;
+    }
+    // merge the dimension into the inner group if both are broadcast or they are contiguous in the mask
+    bool mergeable = !dims.empty() && (dims.back().second == 0 ? dim_stride == 0
+                                                               : dim_stride == dims.back().first * dims.back().second);
+    if (mergeable) {
+      dims.back().first *= x_shape[i];
+    } else {
+      dims.emplace_back(x_shape[i], dim_stride);
+    }
+  }
+  CHECK_LE(dims.size(), 3UL) << "The mask of the fused_softmax can only be broadcast along up to 3 dimension groups";
+  dims.resize(3, {1, 0});
+  return {dims[1].first, dims[0].first, dims[2].second, dims[1].second, dims[0].second};
+}
+
+std::vector<ir::Expr> CustomCallArgsForFusedSoftmax(const framework::NodeAttr &attrs,
+                                                    const std::vector<ir::Tensor> &inputs,
+                                                    const std::vector<std::vector<int>> &output_shapes) {
+  CHECK(inputs.size() == 1UL || inputs.size() == 2UL) << "The fused_softmax takes x and an optional mask";
+  const auto &attr_store = attrs.attr_store;
+  float scale            = attr_store.count("scale") ? absl::get<float>(attr_store.at("scale")) : 1.0f;
+  bool log_softmax       = attr_store.count("log_softmax") ? absl::get<bool>(attr_store.at("log_softmax")) : false;
+
+  auto to_shape = [](const ir::Tensor &tensor) {
+    std::vector<int> shape;
+    for (auto &dim : tensor->shape) {
+      shape.push_back(dim.as_int32());
+    }
+    return shape;
+  };
+  auto x_shape = to_shape(inputs[0]);
+  int cols     = x_shape.back();
+  int rows     = 1;
+  for (int i = 0; i + 1 < x_shape.size(); ++i) {
+    rows *= x_shape[i];
+  }
+
+  std::vector<int> mask_strides = {1, 1, 0, 0, 0};
+  if (inputs.size() == 2UL) {
+    // the rows of a packed mask are its 32-bit words
+    auto mask_x_shape = x_shape;
+    if (inputs[1]->type().is_int(32)) {
+      mask_x_shape.back() = (cols + 31) / 32;
+    }
+    mask_strides = GetSoftmaxMaskStrides(mask_x_shape, to_shape(inputs[1]));
+  }
+
+  std::vector<ir::Expr> args = {ir::Expr(rows), ir::Expr(cols), ir::Expr(scale), ir::Expr(log_softmax)};
+  for (int value : mask_strides) {
+    args.emplace_back(value);
+  }
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForSoftmaxCrossEntropy(const framework::NodeAttr &attrs,
+                                                           const std::vector<ir::Tensor> &inputs,
+                                                           const std::vector<std::vector<int>> &output_shapes) {
+  CHECK_EQ(inputs.size(), 2UL) << "The softmax_cross_entropy takes the logits and the label";
+  const auto &attr_store = attrs.attr_store;
+  int ignore_index       = attr_store.count("ignore_index") ? absl::get<int>(attr_store.at("ignore_index")) : -100;
+
+  const auto &shape = inputs[0]->shape;
+  int cols          = shape.back().as_int32();
+  int rows          = 1;
+  for (int i = 0; i + 1 < shape.size(); ++i) {
+    rows *= shape[i].as_int32();
+  }
+  return {ir::Expr(rows), ir::Expr(cols), ir::Expr(ignore_index)};
+}
+
+#ifdef CINN_WITH_NCCL
+// The collective ops take the number of elements, the dtype, the reduction and the ring of the communicator.
+std::vector<ir::Expr> CustomCallArgsForCollective(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  bool count_output,
+                                                  bool has_reduce_type) {
+  CHECK_EQ(inputs.size(), 1UL) << "The collective ops take only one input";
+  CHECK_EQ(output_shapes.size(), 1UL) << "The collective ops have only one output";
+  const auto &attr_store = attrs.attr_store;
+  int ring_id            = attr_store.count("ring_id") ? absl::get<int>(attr_store.at("ring_id")) : 0;
+  bool use_calc_stream =
+      attr_store.count("use_calc_stream") ? absl::get<bool>(attr_store.at("use_calc_stream")) : true;
+
+  int64_t count = 1;
+  if (count_output) {
+    for (int dim : output_shapes[0]) {
+      count *= dim;
+    }
+  } else {
+    for (auto &dim : inputs[0]->shape) {
+      count *= dim.as_int32();
+    }
+  }
+  CHECK_LE(count, std::numeric_limits<int>::max()) << "The collective ops support up to INT_MAX elements";
+
+  const auto &type = inputs[0]->type();
+  int type_code    = cinn_type_int;
+  if (type.is_bfloat16()) {
+    type_code = cinn_type_bfloat;
+  } else if (type.is_float()) {
+    type_code = cinn_type_float;
+  } else if (type.is_uint()) {
+    type_code = cinn_type_uint;
+  }
+  std::vector<ir::Expr> args = {ir::Expr(static_cast<int>(count)), ir::Expr(type_code), ir::Expr(type.bits())};
+
+  if (has_reduce_type) {
+    static const std::unordered_map<std::string, int> reduce_types = {
+        {"sum", 0}, {"prod", 1}, {"max", 2}, {"min", 3}, {"avg", 4}};
+    std::string reduce_type =
+        attr_store.count("reduce_type") ? absl::get<std::string>(attr_store.at("reduce_type")) : "sum";
+    CHECK(reduce_types.count(reduce_type)) << "Unsupported reduce_type " << reduce_type << " of the collective ops";
+    args.emplace_back(reduce_types.at(reduce_type));
+  }
+  args.emplace_back(ring_id);
+  args.emplace_back(use_calc_stream);
+  return args;
+}
+
+std::vector<ir::Expr> CustomCallArgsForAllReduce(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<std::vector<int>> &output_shapes) {
+  return CustomCallArgsForCollective(attrs, inputs, output_shapes, false, true);
+}
+
+std::vector<ir::Expr> CustomCallArgsForAllGather(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<std::vector<int>> &output_shapes) {
+  return CustomCallArgsForCollective(attrs, inputs, output_shapes, false, false);
+}
+
+std::vector<ir::Expr> CustomCallArgsForReduceScatter(const framework::NodeAttr &attrs,
+                                                     const std::vector<ir::Tensor> &inputs,
+                                                     const std::vector<std::vector<int>> &output_shapes) {
+  return CustomCallArgsForCollective(attrs, inputs, output_shapes, true, true);
+}
+#endif
+
 std::vector<ir::Expr> CustomCallArgsForMemset(const framework::NodeAttr &attrs,
                                               const std::vector<ir::Tensor> &inputs,
                                               const std::vector<std::vector<int>> &output_shapes) {
@@ -798,14 +1417,88 @@ bool RegisteryCustomCallArgsFunc() {
       "cinn_call_cholesky_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForCholesky);
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_call_batched_cublas", common::DefaultNVGPUTarget(), CustomCallArgsForBatchedCublas);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cublaslt_matmul", common::DefaultNVGPUTarget(), CustomCallArgsForCublasLt);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cublaslt_fp8_matmul", common::DefaultNVGPUTarget(), CustomCallArgsForCublasLtFp8);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cusparse_spmm", common::DefaultNVGPUTarget(), CustomCallArgsForCusparseSpmm);
+#ifdef CINN_WITH_CUSPARSELT
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cusparselt_matmul", common::DefaultNVGPUTarget(), CustomCallArgsForCusparseLt);
+#endif
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_call_triangular_solve_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForTriangularSolve);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_flash_attention_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForFlashAttention);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_sort_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForSort);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_argsort_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForSort);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_top_k_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForTopK);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cumsum_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForCumulative);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cumprod_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForCumulative);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cummax_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForCumulative);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_lookup_table_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForLookupTable);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_scatter_add_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForScatterAdd);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_concat_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForConcat);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_split_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForSplit);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_layer_norm_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForNorm);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_layer_norm_grad_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForNorm);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_rms_norm_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForNorm);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_rms_norm_grad_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForRMSNormGrad);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_batch_norm_train_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForBatchNormTrain);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_batch_norm_grad_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForBatchNorm);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_arg_reduce_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForArgReduce);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_kv_cache_append_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForKVCacheAppend);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_paged_attention_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForPagedAttention);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_fused_softmax_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForFusedSoftmax);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_softmax_cross_entropy_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForSoftmaxCrossEntropy);
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_assert_true_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForAssertTrue);
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_call_cuda_memset", common::DefaultNVGPUTarget(), CustomCallArgsForMemset);
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_call_cuda_memcpy", common::DefaultNVGPUTarget(), CustomCallArgsForMemcpy);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cond_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForCond);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_while_loop_nvgpu", common::DefaultNVGPUTarget(), CustomCallArgsForWhileLoop);
+#endif
+
+#ifdef CINN_WITH_ROCM
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_rocblas", common::DefaultAMDGPUTarget(), CustomCallArgsForCublas);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_miopen_conv2d_forward", common::DefaultAMDGPUTarget(), CustomCallArgsForMIOpenConvForward);
+#endif
+
+#ifdef CINN_WITH_NCCL
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_nccl_all_reduce", common::DefaultNVGPUTarget(), CustomCallArgsForAllReduce);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_nccl_all_gather", common::DefaultNVGPUTarget(), CustomCallArgsForAllGather);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_nccl_reduce_scatter", common::DefaultNVGPUTarget(), CustomCallArgsForReduceScatter);
 #endif
 
 #ifdef CINN_WITH_CUDNN
@@ -834,6 +1527,10 @@ bool RegisteryCustomCallArgsFunc() {
 
   CustomCallArgsFuncRegistry::Global().Register(
       "cinn_assert_true_host", common::DefaultHostTarget(), CustomCallArgsForAssertTrue);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_cond_host", common::DefaultHostTarget(), CustomCallArgsForCond);
+  CustomCallArgsFuncRegistry::Global().Register(
+      "cinn_call_while_loop_host", common::DefaultHostTarget(), CustomCallArgsForWhileLoop);
 
   return true;
 }
@@ -14,14 +14,66 @@
 
 #include "cinn/hlir/op/external_api_registry.h"
 
+#include <gflags/gflags.h>
+
+DECLARE_int32(cinn_concat_custom_call_min_inputs);
+DECLARE_int32(cinn_csr_spmm_custom_call_min_nnz);
+
 namespace cinn {
 namespace hlir {
 namespace op {
 
+namespace {
+// The concat and split of many operands are lowered to the copies over a table of the operand pointers instead of
+// the select chain over the index, which only holds for the operands of the same shape.
+bool UseSegmentCopy(const std::vector<std::string>& operands, const framework::Graph* graph) {
+  if (FLAGS_cinn_concat_custom_call_min_inputs <= 0 ||
+      static_cast<int>(operands.size()) < FLAGS_cinn_concat_custom_call_min_inputs || !graph->HasAttr("infershape")) {
+    return false;
+  }
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
+  for (auto& operand : operands) {
+    if (!shape_dict.count(operand) || shape_dict.at(operand) != shape_dict.at(operands[0])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The csr_spmm of many non-zeros is computed by cuSPARSE, which balances the rows of skewed lengths, instead of the
+// row-split kernel fused with its epilogue.
+bool UseCusparseSpmm(const framework::Node* node, const framework::Graph* graph) {
+  if (FLAGS_cinn_csr_spmm_custom_call_min_nnz <= 0 || !graph->HasAttr("infershape")) {
+    return false;
+  }
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
+  auto inlinks           = node->inlinks_in_order();
+  CHECK_EQ(inlinks.size(), 4U) << "The csr_spmm takes the crows, cols, values and dense";
+  auto it = shape_dict.find(inlinks[1]->source()->id());
+  return it != shape_dict.end() && it->second[0] >= FLAGS_cinn_csr_spmm_custom_call_min_nnz;
+}
+
+// MIOpen is only called for the forward convolution of NCHW, the gradients and NHWC are left to the codegen kernels.
+bool IsForwardNCHWConv(const framework::Node* node, const framework::Graph* graph) {
+  const auto& attr_store = node->attrs.attr_store;
+  auto conv_type         = attr_store.find("conv_type");
+  auto data_format       = attr_store.find("data_format");
+  return (conv_type == attr_store.end() || absl::get<std::string>(conv_type->second) == "forward") &&
+         (data_format == attr_store.end() || absl::get<std::string>(data_format->second) != "NHWC");
+}
+}  // namespace
+
 ExternalApiInfo& ExternalApiRegistry::Register(const std::string& op_name, const common::Target& target) {
   return __REGISTER__(GenKey(op_name, target));
 }
 
+bool ExternalApiRegistry::Has(const framework::Node* op_node,
+                              const framework::Graph* graph,
+                              const common::Target& target) {
+  const ExternalApiInfo* external_api_info = Find(GenKey(op_node->op()->name, target));
+  return external_api_info && (!external_api_info->filter || external_api_info->filter(op_node, graph));
+}
+
 std::string ExternalApiRegistry::GetExternalApi(const framework::Node* op_node, const common::Target& target) {
   CHECK(op_node->attrs.attr_store.count("original_op")) << "a custom_call op must store its original op name";
   std::string op_name                      = absl::get<std::string>(op_node->attrs.attr_store.at("original_op"));
@@ -60,8 +112,59 @@ CINN_REGISTER_HELPER(op_external_api) {
   CINN_OP_REGISTER_EXTERNAL_API(cholesky, default_nvgpu).set_api_name("cinn_call_cholesky_nvgpu");
   CINN_OP_REGISTER_EXTERNAL_API(cholesky, default_host).set_api_name("cinn_call_cholesky_host");
   CINN_OP_REGISTER_EXTERNAL_API(triangular_solve, default_nvgpu).set_api_name("cinn_call_triangular_solve_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(fused_attention, default_nvgpu).set_api_name("cinn_call_flash_attention_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(sort, default_nvgpu).set_api_name("cinn_call_sort_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(argsort, default_nvgpu).set_api_name("cinn_call_argsort_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(top_k, default_nvgpu).set_api_name("cinn_call_top_k_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(cumsum, default_nvgpu).set_api_name("cinn_call_cumsum_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(cumprod, default_nvgpu).set_api_name("cinn_call_cumprod_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(cummax, default_nvgpu).set_api_name("cinn_call_cummax_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(lookup_table, default_nvgpu).set_api_name("cinn_call_lookup_table_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(scatter_add, default_nvgpu).set_api_name("cinn_call_scatter_add_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(concat, default_nvgpu)
+      .set_api_name("cinn_call_concat_nvgpu")
+      .set_filter([](const ::cinn::hlir::framework::Node* node, const ::cinn::hlir::framework::Graph* graph) {
+        std::vector<std::string> inputs;
+        for (auto& link : node->inlinks_in_order()) {
+          inputs.push_back(link->source()->id());
+        }
+        return ::cinn::hlir::op::UseSegmentCopy(inputs, graph);
+      });
+  CINN_OP_REGISTER_EXTERNAL_API(split, default_nvgpu)
+      .set_api_name("cinn_call_split_nvgpu")
+      .set_filter([](const ::cinn::hlir::framework::Node* node, const ::cinn::hlir::framework::Graph* graph) {
+        std::vector<std::string> outputs;
+        for (auto& link : node->outlinks_in_order()) {
+          outputs.push_back(link->sink()->id());
+        }
+        return ::cinn::hlir::op::UseSegmentCopy(outputs, graph);
+      });
+  CINN_OP_REGISTER_EXTERNAL_API(csr_spmm, default_nvgpu)
+      .set_api_name("cinn_call_cusparse_spmm")
+      .set_filter(::cinn::hlir::op::UseCusparseSpmm);
+  CINN_OP_REGISTER_EXTERNAL_API(layer_norm, default_nvgpu).set_api_name("cinn_call_layer_norm_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(layer_norm_grad, default_nvgpu).set_api_name("cinn_call_layer_norm_grad_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(rms_norm, default_nvgpu).set_api_name("cinn_call_rms_norm_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(rms_norm_grad, default_nvgpu).set_api_name("cinn_call_rms_norm_grad_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(batch_norm_train, default_nvgpu).set_api_name("cinn_call_batch_norm_train_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(batch_norm_grad, default_nvgpu).set_api_name("cinn_call_batch_norm_grad_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(arg_reduce, default_nvgpu).set_api_name("cinn_call_arg_reduce_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(kv_cache_append, default_nvgpu).set_api_name("cinn_call_kv_cache_append_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(paged_attention, default_nvgpu).set_api_name("cinn_call_paged_attention_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(fused_softmax, default_nvgpu).set_api_name("cinn_call_fused_softmax_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(softmax_cross_entropy, default_nvgpu)
+      .set_api_name("cinn_call_softmax_cross_entropy_nvgpu");
+  CINN_OP_REGISTER_EXTERNAL_API(fp8_matmul, default_nvgpu).set_api_name("cinn_call_cublaslt_fp8_matmul");
   CINN_OP_REGISTER_EXTERNAL_API(assert_true, default_nvgpu).set_api_name("cinn_assert_true_nvgpu");
   CINN_OP_REGISTER_EXTERNAL_API(assert_true, default_host).set_api_name("cinn_assert_true_host");
+#ifdef CINN_WITH_CUSPARSELT
+  CINN_OP_REGISTER_EXTERNAL_API(sparse_matmul, default_nvgpu).set_api_name("cinn_call_cusparselt_matmul");
+#endif
+#ifdef CINN_WITH_NCCL
+  CINN_OP_REGISTER_EXTERNAL_API(all_reduce, default_nvgpu).set_api_name("cinn_call_nccl_all_reduce");
+  CINN_OP_REGISTER_EXTERNAL_API(all_gather, default_nvgpu).set_api_name("cinn_call_nccl_all_gather");
+  CINN_OP_REGISTER_EXTERNAL_API(reduce_scatter, default_nvgpu).set_api_name("cinn_call_nccl_reduce_scatter");
+#endif
 #ifdef CINN_WITH_CUDNN
   CINN_OP_REGISTER_EXTERNAL_API(conv2d, default_nvgpu).set_trans_func([](const ::cinn::hlir::framework::Node* node) {
     CHECK(node->attrs.attr_store.count("conv_type"));
@@ -81,6 +184,19 @@ CINN_REGISTER_HELPER(op_external_api) {
       });
   CINN_OP_REGISTER_EXTERNAL_API(pool2d, default_nvgpu).set_api_name("cinn_call_cudnn_pool2d_forward");
   CINN_OP_REGISTER_EXTERNAL_API(pool2d_grad, default_nvgpu).set_api_name("cinn_call_cudnn_pool2d_backward");
+#endif
+#ifdef CINN_WITH_ROCM
+  const auto& default_amdgpu = ::cinn::common::DefaultAMDGPUTarget();
+  CINN_OP_REGISTER_EXTERNAL_API(matmul, default_amdgpu).set_api_name("cinn_call_rocblas");
+  CINN_OP_REGISTER_EXTERNAL_API(mul, default_amdgpu).set_api_name("cinn_call_rocblas");
+  CINN_OP_REGISTER_EXTERNAL_API(cublas_gemm, default_amdgpu).set_api_name("cinn_call_rocblas");
+  CINN_OP_REGISTER_EXTERNAL_API(cublas_matmul, default_amdgpu).set_api_name("cinn_call_rocblas");
+  CINN_OP_REGISTER_EXTERNAL_API(conv2d, default_amdgpu)
+      .set_api_name("cinn_call_miopen_conv2d_forward")
+      .set_filter(::cinn::hlir::op::IsForwardNCHWConv);
+  CINN_OP_REGISTER_EXTERNAL_API(depthwise_conv2d, default_amdgpu)
+      .set_api_name("cinn_call_miopen_conv2d_forward")
+      .set_filter(::cinn::hlir::op::IsForwardNCHWConv);
 #endif
   return true;
 }
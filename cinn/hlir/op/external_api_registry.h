@@ -16,6 +16,7 @@
 #include <sstream>
 
 #include "cinn/common/target.h"
+#include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/utils/registry.h"
 
@@ -28,14 +29,17 @@ namespace hlir {
 namespace op {
 
 using OpNodeTransToExternalApiFunction = std::function<std::string(const framework::Node* op_node)>;
+using OpNodeExternalApiFilter = std::function<bool(const framework::Node* op_node, const framework::Graph* graph)>;
 
 // This class contains detail external api information of a specified Operator.
 // To provide the external api name, we can directly set it through `set_api_name`
-// or set a transform function wth `set_trans_func` that return a api name finally
+// or set a transform function wth `set_trans_func` that return a api name finally.
+// If a filter is set with `set_filter`, only the nodes accepted by it use the external api.
 struct ExternalApiInfo {
   std::string name;
   std::string api_name;
   OpNodeTransToExternalApiFunction trans_func;
+  OpNodeExternalApiFilter filter;
 
   inline ExternalApiInfo& set_api_name(const std::string& name) {
     this->api_name = name;
@@ -46,6 +50,11 @@ struct ExternalApiInfo {
     this->trans_func = func;
     return *this;
   }
+
+  inline ExternalApiInfo& set_filter(OpNodeExternalApiFilter func) {
+    this->filter = func;
+    return *this;
+  }
 };
 
 // A registry that stores external api for ops supported by vendor library
@@ -62,6 +71,15 @@ class ExternalApiRegistry : public Registry<ExternalApiInfo> {
     return nullptr != Registry<ExternalApiInfo>::Find(GenKey(op_name, target));
   }
 
+  // whether the op node of the graph uses the external api on the specified target
+  bool Has(const framework::Node* op_node, const framework::Graph* graph, const common::Target& target);
+
+  // whether the external api of the op is only used for the nodes accepted by a filter
+  bool HasFilter(const std::string& op_name, const common::Target& target) {
+    const ExternalApiInfo* external_api_info = Registry<ExternalApiInfo>::Find(GenKey(op_name, target));
+    return external_api_info && external_api_info->filter;
+  }
+
   // return the api name on the specified target
   std::string GetExternalApi(const framework::Node* op_node, const common::Target& target);
 
@@ -16,8 +16,12 @@
 
 #include <gtest/gtest.h>
 
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
 
 namespace cinn {
 namespace hlir {
@@ -32,6 +36,32 @@ TEST(ExternalApiRegistry, Has) {
   ASSERT_FALSE(ExternalApiRegistry::Global()->Has("op_doesn't_exist", common::DefaultNVGPUTarget()));
 }
 
+// Only the concat of many inputs of the same shape uses the external api.
+TEST(ExternalApiRegistry, Filter) {
+  auto target = common::DefaultNVGPUTarget();
+  for (int num_inputs : {2, 8}) {
+    frontend::NetBuilder builder("test");
+    std::vector<frontend::Variable> inputs;
+    for (int i = 0; i < num_inputs; ++i) {
+      inputs.push_back(builder.CreateInput(common::Float(32), {4, 16}, "X" + std::to_string(i)));
+    }
+    builder.Concat(inputs, 1);
+    auto program = builder.Build();
+    auto graph   = std::make_shared<Graph>(program, target);
+    ApplyPass(graph.get(), "InferShape");
+
+    auto nodes = std::get<0>(graph->topological_order());
+    for (auto* graph_node : nodes) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && node->op()->name == "concat") {
+        ASSERT_EQ(ExternalApiRegistry::Global()->Has(node, graph.get(), target), num_inputs >= 8);
+      }
+    }
+  }
+  ASSERT_TRUE(ExternalApiRegistry::Global()->HasFilter("concat", target));
+  ASSERT_FALSE(ExternalApiRegistry::Global()->HasFilter("matmul", target));
+}
+
 TEST(ExternalApiRegistry, GetExternalApi) {
   auto node                             = std::make_unique<Node>(Operator::Get("custom_call"), "custom_call");
   node->attrs.attr_store["original_op"] = std::string("matmul");
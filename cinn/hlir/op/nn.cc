@@ -122,6 +122,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   std::string key         = "";
   std::string conv_type   = "";
   bool use_mkldnn         = false;
+  std::string post_op     = "";
   if (attrs.attr_store.find("padding") != attrs.attr_store.end()) {
     padding = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
   }
@@ -140,6 +141,9 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   if (attrs.attr_store.find("use_mkldnn") != attrs.attr_store.end()) {
     use_mkldnn = absl::get<bool>(attrs.attr_store.at("use_mkldnn"));
   }
+  if (attrs.attr_store.find("post_op") != attrs.attr_store.end()) {
+    post_op = absl::get<std::string>(attrs.attr_store.at("post_op"));
+  }
   if (attrs.attr_store.find("key") != attrs.attr_store.end()) {
     key = absl::get<std::string>(attrs.attr_store.at("key"));
   }
@@ -177,7 +181,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
     }
     if (data_format == "NCHW") {
       // A is input: [N, C, H, W], B is filter: [C_out, C_in/group, filter_h, filter_w]
-      if (target.arch == Target::Arch::X86) {
+      if (target.is_cpu()) {
         if (groups == 1 && !use_mkldnn) {
           out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
                                    B.as_tensor_ref(),
@@ -200,7 +204,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
                                        stride[1],
                                        dilation[0],
                                        dilation[1],
-                                       tensor_name);
+                                       tensor_name,
+                                       post_op);
 #else
           out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
                                    B.as_tensor_ref(),
@@ -279,7 +284,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       ir::ModuleExpr mod_expr(vec_ast);
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
 #ifdef CINN_WITH_CUDNN
         // If conv_type is backward_filter or backward_data, we built a fake op.
         // As runtime use cudnn to compute conv2d, this fake op is not to be called.
@@ -302,7 +307,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
         } else {
           CINN_NOT_IMPLEMENTED
         }
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         CINN_NOT_IMPLEMENTED
       }
       LOG(FATAL) << "This target [" << target << "] is not supported yet.";
@@ -311,7 +316,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       CINNValuePack arg_pack = args[0];
       CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL || arg_pack.size() == 13UL);
       poly::StageMap stages = arg_pack.back();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
 #ifdef CINN_WITH_CUDNN
         // If conv_type is backward_filter or backward_data, we built a fake op.
         // As runtime use cudnn to compute conv2d, this fake op is not to be called.
@@ -386,7 +391,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
           *ret         = CINNValuePack{{arg_pack[10], arg_pack[5], arg_pack[7], arg_pack[8], CINNValue(stages)}};
           return;
         }
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         if (arg_pack.size() == 6UL) {
           Expr res              = arg_pack[0];
           Expr packed_out       = arg_pack[1];
@@ -594,6 +599,13 @@ std::vector<shape_t> InferShapeForConv2d(const std::vector<shape_t> &inputs_shap
 std::vector<Type> InferDtypeForConv2d(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
   std::vector<Type> res{inputs_type[0], inputs_type[0], inputs_type[0], inputs_type[0]};
+  // the mkldnn conv2d of uint8 input and int8 weights outputs the dequantized float32, and that of int8 input outputs
+  // the int32 accumulation
+  if (inputs_type[0].is_uint(8)) {
+    res[0] = Float(32);
+  } else if (inputs_type[0].is_int(8)) {
+    res[0] = Int(32);
+  }
   return res;
 }
 
@@ -648,7 +660,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &at
     CHECK_EQ(stride.size(), 2) << "The size of stride in conv2d_NCHWc op is not 2! Please check.";
     CHECK_EQ(dilation.size(), 2) << "The size of stride in conv2d_NCHWc op is not 2! Please check.";
     std::vector<ir::Tensor> out;
-    CHECK(target.arch == Target::Arch::X86) << "conv2d_NCHWc op is only used in x86";
+    CHECK(target.is_cpu()) << "conv2d_NCHWc op is only used in cpu";
     // A is input: [N, C_in_outer, H, W, C_in_inner], B is filter: [C_out, C_in_group_outer, filter_h, filter_w,
     // C_in_group_inner]
     std::string key;
@@ -844,7 +856,7 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
       tensor_name = pack_args[2].operator std::string();
     }
     if (data_format == "NCHW") {
-      if (target.arch == Target::Arch::X86) {
+      if (target.is_cpu()) {
         out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
                                  B.as_tensor_ref(),
                                  padding[0],
@@ -898,7 +910,7 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
       ir::ModuleExpr mod_expr(vec_ast);
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         pe::IRCudaScheduleDepthwiseConv(ir_sch, vec_tensor);
       } else {
         CINN_NOT_IMPLEMENTED
@@ -917,12 +929,12 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
         CHECK(input_pad.as_tensor());
         stages[input_pad.as_tensor_ref()]->ComputeInline();
       }
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         ir::Tensor output = Out.as_tensor_ref();
         CHECK(Out.as_tensor());
         pe::CudaScheduleDepthwiseConv(stages, output, target);
         arg_pack[0] = Expr(output);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         if (arg_pack.size() == 6UL) {
           Expr res              = arg_pack[0];
           Expr packed_out       = arg_pack[1];
@@ -1047,7 +1059,7 @@ std::shared_ptr<OpStrategy> StrategyForBatchNorm(const framework::NodeAttr &attr
     CHECK(Variance.as_tensor());
     ir::Tensor out;
     auto tensor_input = A.as_tensor_ref();
-    if (tensor_input->shape.size() != 4 && target.arch == Target::Arch::X86) {
+    if (tensor_input->shape.size() != 4 && target.is_cpu()) {
       CHECK_EQ(input_layouts.size(), 5U) << "batch_norm_NCHWc's input layout should be 5";
       std::string input_layout = input_layouts[0];
       CHECK_GE(input_layout.size(), 5U);
@@ -1206,7 +1218,7 @@ std::shared_ptr<OpStrategy> StrategyForPool1d(const framework::NodeAttr &attrs,
         auto block_input_pad = ir_sch.GetBlock(input_pad.as_tensor()->name);
         ir_sch.ComputeInline(block_input_pad);
       }
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         CHECK(!vec_tensor.empty());
         Expr Out = vec_tensor[0];
         CHECK(Out.as_tensor());
@@ -1230,7 +1242,7 @@ std::shared_ptr<OpStrategy> StrategyForPool1d(const framework::NodeAttr &attrs,
         stages[input_pad.as_tensor_ref()]->ComputeInline();
       }
 
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         CHECK(Out.as_tensor());
         stages[Out.as_tensor_ref()]->Split(1, 2);
         stages[Out.as_tensor_ref()]->Bind(0, "blockIdx.x");
@@ -1424,7 +1436,7 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
       ir::ModuleExpr mod_expr(vec_ast);
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         pe::IRGlobalPoolScheduleGPU(ir_sch, target);
       } else {
         CINN_NOT_IMPLEMENTED
@@ -1511,7 +1523,12 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
         auto block_input_pad = ir_sch.GetBlock(input_pad_name);
         ir_sch.ComputeInline(block_input_pad);
       }
-      if (target.arch == Target::Arch::NVGPU) {
+      // the channels-last layout is vectorized over the channels, vec_tensor[0] is the output
+      bool channels_last = data_format == "NHWC" && !adaptive && A_tensor->shape.size() == 4U;
+      if (target.is_gpu() && channels_last && !vec_tensor.empty()) {
+        CHECK(vec_tensor[0].as_tensor());
+        pe::IRCudaSchedulePoolNHWC(ir_sch, vec_tensor[0].as_tensor()->name, kernel_size, stride_size, target);
+      } else if (target.is_gpu()) {
         pe::IRPoolScheduleGPU(ir_sch, target, arg_pack_size);
       }
       std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
@@ -1529,7 +1546,7 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
         stages[input_pad.as_tensor_ref()]->ComputeInline();
       }
       ir::Tensor temp_out = Out.as_tensor_ref();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         pe::PoolScheduleGPU(stages, temp_out, target);
         arg_pack[arg_pack.size() - 2] = Expr(temp_out);
       }
@@ -1540,7 +1557,7 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
   auto strategy = std::make_shared<framework::OpStrategy>();
 
   bool use_warp_reduce = false;
-  if (global_pooling && data_format == "NCHW" && target.arch == Target::Arch::NVGPU) {
+  if (global_pooling && data_format == "NCHW" && target.is_gpu()) {
     // TODO 32 may not be the exact number, try also 16 or 8 or other number
     //      we choose 32 to make sure all the threads in a warp has work to do,
     if ((A_tensor->shape[2].as_int32() * A_tensor->shape[3].as_int32()) >= 32) {
@@ -1734,7 +1751,7 @@ std::shared_ptr<OpStrategy> StrategyForPool3d(const framework::NodeAttr &attrs,
         auto block_input_pad = ir_sch.GetBlock(input_pad.as_tensor()->name);
         ir_sch.ComputeInline(block_input_pad);
       }
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         CHECK(!vec_tensor.empty());
         Expr Out = vec_tensor[0];
         CHECK(Out.as_tensor());
@@ -1758,7 +1775,7 @@ std::shared_ptr<OpStrategy> StrategyForPool3d(const framework::NodeAttr &attrs,
         stages[input_pad.as_tensor_ref()]->ComputeInline();
       }
 
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         CHECK(Out.as_tensor());
         stages[Out.as_tensor_ref()]->Split(1, 2);
         stages[Out.as_tensor_ref()]->Bind(0, "blockIdx.x");
@@ -1931,7 +1948,7 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
       ir::ModuleExpr mod_expr(vec_ast);
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         if (output_shapes[0].size() > 1) {
           auto all_blocks = ir_sch.GetAllBlocks();
           CHECK_EQ(all_blocks.size(), 3);
@@ -1955,7 +1972,7 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
         }
         std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
         *ret = CINNValuePack{res};
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::IRSoftmaxScheduleCPU(ir_sch, axis);
         std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
         *ret = CINNValuePack{res};
@@ -1972,7 +1989,7 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
       CHECK(out2.as_tensor());
       ir::Tensor tensor_a = out1.as_tensor_ref();
       ir::Tensor tensor_b = out2.as_tensor_ref();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         if (tensor_a->shape.size() > 1) {
           stages[tensor_a]->Split(1, 5);
           stages[tensor_a]->Bind(0, "blockIdx.x");
@@ -1980,7 +1997,7 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
           int shape_size = tensor_a->shape.size();
           stages[tensor_b]->ComputeAt(stages[tensor_a], shape_size);
         }
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
       }
       *ret = arg_pack;
@@ -2147,6 +2164,39 @@ std::vector<std::vector<std::string>> InferLayoutForUnary(const std::vector<fram
   return {input_layouts, input_layouts};
 }
 
+// The batch_norm_train and the batch_norm_grad are decomposed into the primitive ops by the Decomposer when they
+// cannot be lowered by the custom_call, so only the Welford kernels called through the custom_call on NVGPU
+// implement them.
+std::shared_ptr<OpStrategy> MakeBatchNormCustomCallStrategy(const std::string &op_name,
+                                                            const std::vector<std::vector<int>> &output_shapes,
+                                                            const Target &target) {
+  framework::CINNCompute batch_norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    LOG(FATAL) << "The " << op_name
+               << " is only implemented by the custom_call on NVGPU, please check whether the Decomposer and the "
+                  "TransToCustomCallPass are applied.";
+  });
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      batch_norm_compute, GetInjectiveScheduleFunc(output_shapes, target), "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<OpStrategy> StrategyForBatchNormTrain(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<Type> &out_type,
+                                                      const std::vector<std::vector<int>> &output_shapes,
+                                                      const Target &target) {
+  return MakeBatchNormCustomCallStrategy("batch_norm_train", output_shapes, target);
+}
+
+std::shared_ptr<OpStrategy> StrategyForBatchNormGrad(const framework::NodeAttr &attrs,
+                                                     const std::vector<ir::Tensor> &inputs,
+                                                     const std::vector<Type> &out_type,
+                                                     const std::vector<std::vector<int>> &output_shapes,
+                                                     const Target &target) {
+  return MakeBatchNormCustomCallStrategy("batch_norm_grad", output_shapes, target);
+}
+
 // batch norm train
 std::vector<framework::shape_t> InferShapeForBatchNormTrain(const std::vector<framework::shape_t> &inputs_shape,
                                                             const framework::AttrMapType &attrs) {
@@ -2436,16 +2486,20 @@ CINN_REGISTER_HELPER(nn_grad_ops) {
       .describe("This operator implements the batch normalization training forward.")
       .set_num_inputs(5)
       .set_num_outputs(5)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForBatchNormTrain)
       .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForBatchNormTrain))
       .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForBatchNormTrain))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
       .set_support_level(4);
 
   CINN_REGISTER_OP(batch_norm_grad)
       .describe("This operator implements the batch normalization backward.")
       .set_num_inputs(5)
       .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForBatchNormGrad)
       .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForBatchNormGrad))
       .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForBatchNormGrad))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kNonFusible)
       .set_support_level(4);
 
   CINN_REGISTER_OP(pool2d_grad)
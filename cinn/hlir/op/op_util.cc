@@ -54,9 +54,9 @@ CINNSchedule GetElementwiseScheduleFunc(const std::vector<std::vector<int>>& out
       poly::StageMap stages          = arg_pack[1];
       CHECK(out.as_tensor());
       CHECK_EQ(arg_pack.size(), 2UL);
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes.front(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes.front(), target, vectorizable);
       }
       *ret = arg_pack;
@@ -85,7 +85,7 @@ CINNSchedule GetInjectiveScheduleFunc(const std::vector<std::vector<int>>& outpu
       pe::IRInjectiveSchedule(ir_sch, output_shapes.front(), target);
       /*if (target.arch == Target::Arch::NVGPU) {
         pe::IRInjectiveSchedule(ir_sch, output_shapes.front(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target, vectorizable);
       }*/
       std::vector<common::CINNValue> res{common::CINNValue(ir_sch.GetModule().GetExprs().at(0))};
@@ -97,9 +97,9 @@ CINNSchedule GetInjectiveScheduleFunc(const std::vector<std::vector<int>>& outpu
       poly::StageMap stages          = arg_pack[1];
       CHECK(out.as_tensor());
       CHECK_EQ(arg_pack.size(), 2UL);
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes.front(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
         pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes.front(), target, vectorizable);
       }
       *ret = arg_pack;
@@ -118,9 +118,10 @@ std::string GetExternFuncName(const common::Target& target,
     func_proto_name.append("cinn_");
   }
   if (need_target) {
-    if (target.arch == common::Target::Arch::NVGPU) {
+    // the AMD GPUs call the same device functions of the runtime source as the NVIDIA ones
+    if (target.is_gpu()) {
       func_proto_name.append("nvgpu_");
-    } else if (target.arch == common::Target::Arch::X86) {
+    } else if (target.is_cpu()) {
       func_proto_name.append("host_");
     } else {
       LOG(FATAL) << func_name << " only supports X86 and NVGPU! Please Check.\n";
@@ -133,7 +134,7 @@ std::string GetExternFuncName(const common::Target& target,
   func_proto_name.append("_");
   if (type.is_bool()) {
     func_proto_name.append("bool");
-  } else if (type.is_float(8)) {
+  } else if (type.is_float8()) {
     func_proto_name.append("fp8");
   } else if (type.is_float16()) {
     func_proto_name.append("fp16");
@@ -54,6 +54,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                               const std::string &op_name,
                                               BlockReduceFunc gpu_reduce_with_last_axis_func,
                                               BlockReduceFunc gpu_reduce_without_last_axis_func,
+                                              BlockReduceFunc gpu_grid_reduce_func,
                                               ReduceFunc cpu_reduce_func) {
   std::vector<int> reduce_axes;
   auto ndim = inputs[0]->shape.size();
@@ -103,6 +104,13 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
     }
   };
 
+  // the huge reduction over all the elements is computed by the grid reduce in a single kernel.
+  std::vector<int> input_shape;
+  for (auto &dim : inputs[0]->shape) {
+    input_shape.push_back(dim.as_int32());
+  }
+  bool use_grid_reduce = FLAGS_cinn_ir_schedule && pe::UseGridReduce(input_shape, reduce_axes, target);
+
   framework::CINNCompute reduction_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
     CINNValuePack arg_packs = args[0];
@@ -123,8 +131,19 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
         << "The type of input argument " << x->name << " of " << op_name << " should be bool, but get " << x->type()
         << "! Please check.";
 
-    if (target == common::DefaultNVGPUTarget()) {
-      if (!WithoutLastDimInReduce(inputs[0]->shape, reduce_axes)) {
+    if (target.is_gpu()) {
+      if (use_grid_reduce) {
+        VLOG(3) << "Do Grid Reduce Compute!";
+        auto res    = gpu_grid_reduce_func(x, reduce_axes, keep_dim, tensor_name);
+        auto stages = CreateStages(res);
+
+        std::vector<CINNValue> cinn_values;
+        for (auto &t : res) {
+          cinn_values.emplace_back(t);
+        }
+        cinn_values.emplace_back(stages);
+        *ret = CINNValuePack{cinn_values};
+      } else if (!WithoutLastDimInReduce(inputs[0]->shape, reduce_axes)) {
         VLOG(3) << "Do Two Step Block Reduce Compute!";
         auto res    = gpu_reduce_with_last_axis_func(x, reduce_axes, keep_dim, tensor_name);
         auto stages = CreateStages(res);
@@ -186,8 +205,18 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
       ir::ModuleExpr mod_expr(vec_ast);
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
-      if (target.arch == Target::Arch::NVGPU) {
-        if (!WithoutLastDimInReduce(inputs[0]->shape, reduce_axes)) {
+      if (target.is_gpu()) {
+        if (use_grid_reduce) {
+          CHECK_EQ(vec_tensor.size(), 2);
+          Expr out     = vec_tensor[0];
+          Expr tmp_out = vec_tensor[1];
+
+          VLOG(3) << "Do IRCudaScheduleGridReduce Schedule!";
+          pe::IRCudaScheduleGridReduce(ir_sch, tmp_out.as_tensor_ref(), out.as_tensor_ref(), target);
+
+          std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+          *ret = CINNValuePack{res};
+        } else if (!WithoutLastDimInReduce(inputs[0]->shape, reduce_axes)) {
           if (arg_pack.size() == 4) {
             CHECK_EQ(vec_tensor.size(), 2);
             Expr out     = vec_tensor[0];
@@ -223,7 +252,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                             reduce_tmp_out.as_tensor_ref(),
                                             tmp_out.as_tensor_ref(),
                                             out.as_tensor_ref(),
-                                            common::DefaultNVGPUTarget());
+                                            target);
 
             std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
             *ret = CINNValuePack{res};
@@ -238,7 +267,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                           reduce_tmp_out.as_tensor_ref(),
                                           tmp_out.as_tensor_ref(),
                                           out.as_tensor_ref(),
-                                          common::DefaultNVGPUTarget());
+                                          target);
 
             std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
             *ret = CINNValuePack{res};
@@ -282,7 +311,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
     } else {
       CHECK_GE(arg_pack.size(), 2UL);
       CHECK_LE(arg_pack.size(), 5UL);
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         if (!WithoutLastDimInReduce(inputs[0]->shape, reduce_axes)) {
           if (arg_pack.size() == 3) {
             Expr out              = arg_pack[0];
@@ -290,7 +319,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
             poly::StageMap stages = arg_pack.back();
             VLOG(3) << "Do CudaBlockReduceInternalSchedule Schedule!";
             pe::CudaBlockReduceInternalSchedule(
-                stages, tmp_out.as_tensor_ref(), out.as_tensor_ref(), common::DefaultNVGPUTarget());
+                stages, tmp_out.as_tensor_ref(), out.as_tensor_ref(), target);
           } else if (arg_pack.size() == 4) {
             Expr out              = arg_pack[0];
             Expr tmp_out          = arg_pack[1];
@@ -301,7 +330,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                         reduce_tmp_out.as_tensor_ref(),
                                         tmp_out.as_tensor_ref(),
                                         out.as_tensor_ref(),
-                                        common::DefaultNVGPUTarget());
+                                        target);
           } else {
             Expr out              = arg_pack[0];
             Expr tmp_out          = arg_pack[1];
@@ -314,7 +343,7 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                           reduce_tmp_out.as_tensor_ref(),
                                           tmp_out.as_tensor_ref(),
                                           out.as_tensor_ref(),
-                                          common::DefaultNVGPUTarget());
+                                          target);
           }
         } else {
           if (arg_pack.size() == 2) {
@@ -348,8 +377,12 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
   return strategy;
 }
 
-#define STRATEGY_FOR_REDUCE(                                                                                  \
-    op_name_, reduce_op_, gpu_reduce_with_last_axis_func, gpu_reduce_without_last_axis_func, cpu_reduce_func) \
+#define STRATEGY_FOR_REDUCE(op_name_,                                                                         \
+                            reduce_op_,                                                                       \
+                            gpu_reduce_with_last_axis_func,                                                   \
+                            gpu_reduce_without_last_axis_func,                                                \
+                            gpu_grid_reduce_func,                                                             \
+                            cpu_reduce_func)                                                                  \
   std::shared_ptr<OpStrategy> StrategyFor##reduce_op_(const framework::NodeAttr &attrs,                       \
                                                       const std::vector<ir::Tensor> &inputs,                  \
                                                       const std::vector<Type> &out_type,                      \
@@ -363,15 +396,26 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                              #op_name_,                                                                       \
                              gpu_reduce_with_last_axis_func,                                                  \
                              gpu_reduce_without_last_axis_func,                                               \
+                             gpu_grid_reduce_func,                                                            \
                              cpu_reduce_func);                                                                \
   }
 
-STRATEGY_FOR_REDUCE(reduce_sum, ReduceSum, pe::TwoStepBlockReduceSum, pe::BlockShuffleReduceSum, pe::ReduceSum);
-STRATEGY_FOR_REDUCE(reduce_prod, ReduceProd, pe::TwoStepBlockReduceProd, pe::BlockShuffleReduceProd, pe::ReduceProd);
-STRATEGY_FOR_REDUCE(reduce_max, ReduceMax, pe::TwoStepBlockReduceMax, pe::BlockShuffleReduceMax, pe::ReduceMax);
-STRATEGY_FOR_REDUCE(reduce_min, ReduceMin, pe::TwoStepBlockReduceMin, pe::BlockShuffleReduceMin, pe::ReduceMin);
-STRATEGY_FOR_REDUCE(reduce_all, ReduceAll, pe::TwoStepBlockReduceAll, pe::BlockShuffleReduceAll, pe::ReduceAll);
-STRATEGY_FOR_REDUCE(reduce_any, ReduceAny, pe::TwoStepBlockReduceAny, pe::BlockShuffleReduceAny, pe::ReduceAny);
+STRATEGY_FOR_REDUCE(
+    reduce_sum, ReduceSum, pe::TwoStepBlockReduceSum, pe::BlockShuffleReduceSum, pe::GridReduceSum, pe::ReduceSum);
+STRATEGY_FOR_REDUCE(reduce_prod,
+                    ReduceProd,
+                    pe::TwoStepBlockReduceProd,
+                    pe::BlockShuffleReduceProd,
+                    pe::GridReduceProd,
+                    pe::ReduceProd);
+STRATEGY_FOR_REDUCE(
+    reduce_max, ReduceMax, pe::TwoStepBlockReduceMax, pe::BlockShuffleReduceMax, pe::GridReduceMax, pe::ReduceMax);
+STRATEGY_FOR_REDUCE(
+    reduce_min, ReduceMin, pe::TwoStepBlockReduceMin, pe::BlockShuffleReduceMin, pe::GridReduceMin, pe::ReduceMin);
+STRATEGY_FOR_REDUCE(
+    reduce_all, ReduceAll, pe::TwoStepBlockReduceAll, pe::BlockShuffleReduceAll, pe::GridReduceAll, pe::ReduceAll);
+STRATEGY_FOR_REDUCE(
+    reduce_any, ReduceAny, pe::TwoStepBlockReduceAny, pe::BlockShuffleReduceAny, pe::GridReduceAny, pe::ReduceAny);
 
 #undef STRATEGY_FOR_REDUCE
 
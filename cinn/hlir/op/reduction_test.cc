@@ -40,6 +40,8 @@
 #include "cinn/runtime/cinn_runtime.h"
 #include "cinn/runtime/cuda/cuda_module.h"
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_use_multi_rows_reduce);
+DECLARE_int32(cinn_grid_reduce_threshold);
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -517,7 +519,7 @@ TEST(Operator, Operator_Reduction_Case_Warp_Reduce) {
   std::vector<int> shape = {warp_reduce_threshold + 10, 256};
   std::vector<int> dim   = {1};
 
-  auto res = GenReduceCode(shape, dim, "Operator_Reduction_Case_Warp_Reduce");
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Warp_Reduce");
   CHECK(res.second.find("threadIdx.x < 32") != std::string::npos);
 }
 
@@ -529,7 +531,7 @@ TEST(Operator, Operator_Reduction_Case_Block_Reduce) {
   std::vector<int> shape = {warp_reduce_threshold - 10, 33};
   std::vector<int> dim   = {1};
 
-  auto res = GenReduceCode(shape, dim, "Operator_Reduction_Case_Block_Reduce");
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Block_Reduce");
   CHECK(res.second.find("threadIdx.x < 32") == std::string::npos);
 }
 
@@ -541,7 +543,7 @@ TEST(Operator, Operator_Reduction_Case_Warp_Reduce_Case_1) {
   std::vector<int> shape = {(warp_reduce_threshold + 32) / 2, 2, 10, 256};
   std::vector<int> dim   = {2, 3};
 
-  auto res = GenReduceCode(shape, dim, "Operator_Reduction_Case_Warp_Reduce_Case_1");
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Warp_Reduce_Case_1");
   CHECK(res.second.find("threadIdx.x < 32") != std::string::npos);
 }
 
@@ -553,9 +555,50 @@ TEST(Operator, Operator_Reduction_Case_Block_Reduce_Case_1) {
   std::vector<int> shape = {(warp_reduce_threshold - 32) / 2, 2, 10, 33};
   std::vector<int> dim   = {2, 3};
 
-  auto res = GenReduceCode(shape, dim, "Operator_Reduction_Case_Block_Reduce_Case_2");
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Block_Reduce_Case_2");
   CHECK(res.second.find("threadIdx.x < 32") == std::string::npos);
 }
+
+TEST(Operator, Operator_Reduction_Case_Warp_Reduce_Multi_Rows) {
+  int sm_count              = common::DefaultNVGPUTarget().get_multi_processor_count();
+  int max_threads_per_sm    = common::DefaultNVGPUTarget().get_max_threads_per_sm();
+  int warp_reduce_threshold = sm_count * max_threads_per_sm / 32;
+
+  std::vector<int> shape = {(warp_reduce_threshold / 8 + 1) * 8, 256};
+  std::vector<int> dim   = {1};
+
+  FLAGS_cinn_use_multi_rows_reduce = true;
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Warp_Reduce_Multi_Rows");
+  FLAGS_cinn_use_multi_rows_reduce = false;
+  // each warp computes a row, and the rows of a block are bound to threadIdx.y
+  CHECK(res.second.find("threadIdx.x < 32") != std::string::npos);
+  CHECK(res.second.find("threadIdx.y") != std::string::npos);
+}
+
+TEST(Operator, Operator_Reduction_Case_Sub_Warp_Reduce_Multi_Rows) {
+  std::vector<int> shape = {4096, 16};
+  std::vector<int> dim   = {1};
+
+  FLAGS_cinn_use_multi_rows_reduce = true;
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Sub_Warp_Reduce_Multi_Rows");
+  FLAGS_cinn_use_multi_rows_reduce = false;
+  CHECK(res.second.find("threadIdx.y") != std::string::npos);
+}
+
+TEST(Operator, Operator_Reduction_Case_Grid_Reduce) {
+  std::vector<int> shape = {256, 1024};
+  std::vector<int> dim   = {0, 1};
+
+  int threshold                    = FLAGS_cinn_grid_reduce_threshold;
+  FLAGS_cinn_grid_reduce_threshold = 256 * 1024;
+  auto res                         = GenReduceCode(shape, dim, "Operator_Reduction_Case_Grid_Reduce");
+  auto partial_res                 = GenReduceCode({256, 1024}, {1}, "Operator_Reduction_Case_Grid_Reduce_Partial");
+  FLAGS_cinn_grid_reduce_threshold = threshold;
+  // all the elements are reduced in a single kernel without the temporary tensor of the two step reduce
+  CHECK(res.second.find("cinn_grid_reduce_sum_fp32") != std::string::npos);
+  CHECK(res.second.find("cinn_block_reduce_sum_fp32") == std::string::npos);
+  CHECK(partial_res.second.find("cinn_grid_reduce_sum_fp32") == std::string::npos);
+}
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
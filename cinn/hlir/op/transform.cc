@@ -30,6 +30,7 @@
 #include "cinn/utils/string.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_use_packed_gemm);
 
 namespace cinn {
 namespace hlir {
@@ -41,6 +42,29 @@ using framework::OpStrategy;
 using framework::shape_t;
 using framework::StrategyFunction;
 
+// The oneDNN matmul is used by the 2-D matmul marked with use_mkldnn, which may carry a fused post_op.
+bool UseMkldnnMatmul(const framework::AttrMapType &attrs, const std::vector<int> &shape_A) {
+#ifdef CINN_WITH_MKLDNN
+  return SafeGetAttr(attrs, "use_mkldnn", false) && shape_A.size() == 2U;
+#else
+  return false;
+#endif
+}
+
+// The packed GEMM covers the 2-D int8 matmul, and the fp32 one if MKL is not linked.
+bool UsePackedGemm(
+    const std::vector<int> &shape_A, const Type &type_A, const Type &type_B, bool trans_a, float alpha) {
+  if (!FLAGS_cinn_use_packed_gemm || shape_A.size() != 2U) return false;
+  if (type_A.is_float(32) && type_B.is_float(32)) {
+#ifdef CINN_WITH_MKL_CBLAS
+    return false;
+#else
+    return true;
+#endif
+  }
+  return !trans_a && alpha == 1.0f && (type_A.is_int(8) || type_A.is_uint(8)) && type_B.is_int(8);
+}
+
 std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
                                               const std::vector<ir::Tensor> &inputs,
                                               const std::vector<Type> &out_type,
@@ -59,6 +83,10 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
   const auto &new_shape_A  = new_shape[0];
   const auto &new_shape_B  = new_shape[1];
   const auto &output_shape = new_shape[2];
+  bool use_mkldnn          = target.arch == Target::Arch::X86 && UseMkldnnMatmul(attr_store, new_shape_A);
+  bool use_packed_gemm     = target.is_cpu() && !use_mkldnn &&
+                         UsePackedGemm(new_shape_A, inputs[0]->type(), inputs[1]->type(), trans_a, alpha);
+  std::string post_op      = SafeGetAttr(attr_store, "post_op", std::string(""));
 
   framework::CINNCompute matmul_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of Matmul compute is empty! Please check.\n";
@@ -87,7 +115,13 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
     auto new_B = tensor_B->Reshape(new_shape_B_e, stages);
 
     std::vector<ir::Tensor> out;
-    if (target.arch == Target::Arch::X86) {
+    if (use_mkldnn) {
+#ifdef CINN_WITH_MKLDNN
+      out = pe::MatmulMKLDNN(new_A, new_B, trans_a, trans_b, alpha, post_op, UniqName("MatmulMKLDNN_output"), target);
+#endif
+    } else if (use_packed_gemm) {
+      out = pe::MatmulPacked(new_A, new_B, trans_a, trans_b, alpha, false, UniqName("MatmulPacked_output"), target);
+    } else if (target.is_cpu()) {
 #ifdef CINN_WITH_MKL_CBLAS
       out = pe::MatmulMKL(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulMKL_output"), target);
 #else
@@ -118,20 +152,22 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
     } else {
       CHECK(arg_pack.size() == 2UL || arg_pack.size() == 3UL);
       poly::StageMap stages = arg_pack.back();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         Expr out = arg_pack[0];
         CHECK(out.as_tensor());
         pe::MatmulScheduleCUDA(stages, out.as_tensor_ref(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
 #ifdef CINN_WITH_MKL_CBLAS
         CHECK_EQ(arg_pack.size(), 3UL);
 #else
         CHECK_EQ(arg_pack.size(), 3UL);
-        Expr out     = arg_pack[0];
-        Expr packedB = arg_pack[1];
-        CHECK(packedB.as_tensor());
-        CHECK(out.as_tensor());
-        pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        if (!use_packed_gemm && !use_mkldnn) {
+          Expr out     = arg_pack[0];
+          Expr packedB = arg_pack[1];
+          CHECK(packedB.as_tensor());
+          CHECK(out.as_tensor());
+          pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        }
 #endif
       }
       *ret = arg_pack;
@@ -169,6 +205,11 @@ std::vector<std::vector<int>> InferShapeForMatMul(const std::vector<std::vector<
 
 std::vector<Type> InferDtypeForMatMul(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
   CHECK_EQ(inputs_type.size(), 2UL) << "The input's type size should be 2! Please check again.";
+  // the int8 matmul accumulates in int32, and A may be uint8 as the VNNI instructions take, while the oneDNN matmul of
+  // uint8 and int8 outputs float32
+  if ((inputs_type[0].is_int(8) || inputs_type[0].is_uint(8)) && inputs_type[1].is_int(8)) {
+    return {SafeGetAttr(attrs, "use_mkldnn", false) && inputs_type[0].is_uint(8) ? Float(32) : Int(32)};
+  }
   CHECK_EQ(inputs_type[0], inputs_type[1]) << "The input's types should be equal! Please check again.";
 
   std::vector<Type> res{inputs_type[0]};
@@ -505,6 +546,8 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
   const auto &new_shape_A  = new_shape[0];
   const auto &new_shape_B  = new_shape[1];
   const auto &output_shape = new_shape[2];
+  bool use_packed_gemm     = target.is_cpu() &&
+                         UsePackedGemm(new_shape_A, inputs[0]->type(), inputs[1]->type(), false, 1.0f);
 
   framework::CINNCompute mul_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of Mul compute is empty! Please check.\n";
@@ -532,7 +575,10 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
       tensor_name = pack_args.back().operator std::string();
     }
 
-    if (target.arch == Target::Arch::X86) {
+    if (use_packed_gemm) {
+      // the weight of the inference is constant, so it is packed once
+      out = pe::MatmulPacked(new_A, new_B, false, is_infer, 1.0f, is_infer, tensor_name, target);
+    } else if (target.is_cpu()) {
 #ifdef CINN_WITH_MKL_CBLAS
       out = pe::MatmulMKL(new_A, new_B, false, is_infer, 1.0f, tensor_name, target);
 #else
@@ -563,20 +609,22 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
     } else {
       CHECK(arg_pack.size() == 2UL || arg_pack.size() == 3UL);
       poly::StageMap stages = arg_pack.back();
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         Expr out = arg_pack[0];
         CHECK(out.as_tensor());
         pe::MatmulScheduleCUDA(stages, out.as_tensor_ref(), target);
-      } else if (target.arch == Target::Arch::X86) {
+      } else if (target.is_cpu()) {
 #ifdef CINN_WITH_MKL_CBLAS
         CHECK_EQ(arg_pack.size(), 3UL);
 #else
         CHECK_EQ(arg_pack.size(), 3UL);
-        Expr out     = arg_pack[0];
-        Expr packedB = arg_pack[1];
-        CHECK(packedB.as_tensor());
-        CHECK(out.as_tensor());
-        pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        if (!use_packed_gemm) {
+          Expr out     = arg_pack[0];
+          Expr packedB = arg_pack[1];
+          CHECK(packedB.as_tensor());
+          CHECK(out.as_tensor());
+          pe::MatmulScheduleCPU(stages, out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+        }
 #endif
       }
       *ret = arg_pack;
@@ -622,6 +670,10 @@ std::vector<std::vector<int>> InferShapeForMul(const std::vector<std::vector<int
 
 std::vector<Type> InferDtypeForMul(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
   CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
+  // the int8 mul accumulates in int32, see InferDtypeForMatMul
+  if ((inputs_type[0].is_int(8) || inputs_type[0].is_uint(8)) && inputs_type[1].is_int(8)) {
+    return {Int(32)};
+  }
   CHECK_EQ(inputs_type[0], inputs_type[1]) << "The input's types should be equal! Please check again.";
 
   return {inputs_type[0]};
@@ -752,7 +804,7 @@ std::shared_ptr<OpStrategy> StrategyForLayoutTransform(const framework::NodeAttr
       ir::IRSchedule ir_sch(mod_expr);
       ir_sch.MergeExprs();
 
-      if (target.arch == Target::Arch::X86) {
+      if (target.is_cpu()) {
         pe::IRScheduleInjectiveCPU(ir_sch, output_shapes.front(), target);
       } else {
         CINN_NOT_IMPLEMENTED
@@ -771,7 +823,7 @@ std::shared_ptr<OpStrategy> StrategyForLayoutTransform(const framework::NodeAttr
       for (auto shape : tensor_out->shape) {
         out_shape.push_back(shape.as_int32());
       }
-      if (target.arch == Target::Arch::X86) {
+      if (target.is_cpu()) {
         pe::ScheduleInjectiveCPU(stages[tensor_out], out_shape, target);
       } else {
         CINN_NOT_IMPLEMENTED
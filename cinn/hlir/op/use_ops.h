@@ -24,6 +24,7 @@ CINN_USE_REGISTER(elementwise_ops)
 CINN_USE_REGISTER(transform_ops)
 CINN_USE_REGISTER(gather_nd_ops)
 CINN_USE_REGISTER(sort_ops)
+CINN_USE_REGISTER(scan_ops)
 CINN_USE_REGISTER(argmin_ops)
 CINN_USE_REGISTER(argmax_ops)
 CINN_USE_REGISTER(reduce_ops)
@@ -34,10 +35,26 @@ CINN_USE_REGISTER(lookup_table_ops)
 CINN_USE_REGISTER(reciprocal_ops)
 CINN_USE_REGISTER(gaussian_random_ops)
 CINN_USE_REGISTER(uniform_random_ops)
+CINN_USE_REGISTER(philox_uniform_ops)
+CINN_USE_REGISTER(quantize_ops)
+CINN_USE_REGISTER(fp8_matmul_ops)
+CINN_USE_REGISTER(sparse_matmul_ops)
+CINN_USE_REGISTER(sparse_ops)
 CINN_USE_REGISTER(randint_ops)
 CINN_USE_REGISTER(cholesky_ops)
 CINN_USE_REGISTER(triangular_solve_ops)
+CINN_USE_REGISTER(fused_attention_ops)
+CINN_USE_REGISTER(norm_ops)
+CINN_USE_REGISTER(arg_reduce_ops)
+CINN_USE_REGISTER(paged_attention_ops)
+CINN_USE_REGISTER(fused_softmax_ops)
+CINN_USE_REGISTER(collective_ops)
 CINN_USE_REGISTER(bitcast_convert_ops)
+CINN_USE_REGISTER(bit_mask_ops)
 CINN_USE_REGISTER(op_external_api)
 CINN_USE_REGISTER(resize_ops)
+CINN_USE_REGISTER(pad_ops)
+CINN_USE_REGISTER(conv2d_implicit_gemm_ops)
+CINN_USE_REGISTER(fused_depthwise_conv2d_ops)
 CINN_USE_REGISTER(assert_true_ops)
+CINN_USE_REGISTER(control_flow_ops)
@@ -12,15 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/infershape.h"
 #include "cinn/hlir/pass/use_pass.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/layout.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(cinn_use_nvgpu_channels_last);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -124,9 +133,309 @@ std::vector<framework::shape_t> UpdateInferInfos(Node* node,
   return infershapes;
 }
 
+// The NHWC axes in the NCHW order, which is also the OHWI axes of an OIHW filter.
+static const std::vector<int> kNCHWToNHWC = {0, 2, 3, 1};
+// The position of each NCHW axis in the NHWC order.
+static const std::vector<int> kNHWCToNCHW = {0, 3, 1, 2};
+
+// On NVGPU the layout is not blocked, but the NHWC layout keeps cuDNN on its Tensor Core paths. The conv2d ops are
+// altered to NHWC, and the pool2d, element-wise and reduce ops consuming NHWC vars are altered too, so the transposes
+// are only left at the borders of the NHWC regions. Each altered op keeps its NCHW output through a transpose, which
+// is removed if all of its consumers are altered.
+class ChannelsLastHelper {
+ public:
+  explicit ChannelsLastHelper(Graph* graph)
+      : graph_(graph),
+        shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape")),
+        type_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype")),
+        op_pattern_dict_(Operator::GetOpPatternAttrs()) {}
+
+  int operator()() {
+    int cnt = 0;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (!node || node->outlinks().size() != 1) {
+        continue;
+      }
+      auto op_name = node->op()->name;
+      bool altered = false;
+      if (op_name == "conv2d") {
+        altered = AlterConv2d(node);
+      } else if (op_name == "pool2d") {
+        altered = AlterPool2d(node);
+      } else if (op_pattern_dict_[node->op()] == framework::kElementWise) {
+        altered = AlterElementwise(node);
+      } else if (op_pattern_dict_[node->op()] == framework::kReduction) {
+        altered = AlterReduce(node);
+      }
+      cnt += altered;
+    }
+    if (cnt) {
+      RemoveDeadNodes();
+      absl::flat_hash_map<std::string, std::string> layout_dict;
+      for (auto& iter : nhwc_vars_) {
+        layout_dict[iter.second->id()] = "NHWC";
+      }
+      graph_->attrs["inferlayout"] = std::make_shared<absl::any>(layout_dict);
+    }
+    return cnt;
+  }
+
+ private:
+  static std::string GetDataFormat(const Node* node) {
+    auto& attrs = node->attrs.attr_store;
+    std::string data_format =
+        attrs.count("data_format") ? absl::get<std::string>(attrs.at("data_format")) : std::string("NCHW");
+    return data_format == "AnyLayout" ? "NCHW" : data_format;
+  }
+
+  const framework::shape_t& GetShape(const GraphNode* data) const {
+    CHECK(shape_dict_.count(data->id())) << data->id() << " finds no infershape";
+    return shape_dict_.at(data->id());
+  }
+
+  std::vector<NodeData*> GetInputs(const Node* node) const {
+    std::vector<NodeData*> inputs;
+    for (auto& link : node->inlinks_in_order()) {
+      inputs.push_back(link->source()->safe_as<NodeData>());
+    }
+    return inputs;
+  }
+
+  bool AlterConv2d(Node* node) {
+    auto& attrs = node->attrs.attr_store;
+    if (GetDataFormat(node) != "NCHW" ||
+        (attrs.count("conv_type") && absl::get<std::string>(attrs.at("conv_type")) != "forward")) {
+      return false;
+    }
+    auto inputs = GetInputs(node);
+    if (inputs.size() != 2U || GetShape(inputs[0]).size() != 4U || GetShape(inputs[1]).size() != 4U) {
+      return false;
+    }
+    // the filter is transposed from OIHW to OHWI with the same axes.
+    AlterNode(node, {GetNHWCVar(inputs[0]), GetNHWCVar(inputs[1])}, "NHWC");
+    return true;
+  }
+
+  bool AlterPool2d(Node* node) {
+    auto inputs = GetInputs(node);
+    if (GetDataFormat(node) != "NCHW" || inputs.size() != 1U || !nhwc_vars_.count(inputs[0])) {
+      return false;
+    }
+    AlterNode(node, {nhwc_vars_.at(inputs[0])}, "NHWC");
+    return true;
+  }
+
+  // alter the op if its NHWC operands are not fewer than the ones to be transposed.
+  bool AlterElementwise(Node* node) {
+    auto inputs = GetInputs(node);
+    if (inputs.empty() || GetShape(GetOutput(node)).size() != 4U) {
+      return false;
+    }
+    int num_nhwc = 0;
+    for (auto* input : inputs) {
+      if (GetShape(input).size() != 4U) {
+        return false;
+      }
+      num_nhwc += nhwc_vars_.count(input) || GetRemappableBroadcast(input);
+    }
+    if (!num_nhwc || 2 * num_nhwc < static_cast<int>(inputs.size())) {
+      return false;
+    }
+    std::vector<NodeData*> new_inputs;
+    for (auto* input : inputs) {
+      new_inputs.push_back(GetNHWCVar(input));
+    }
+    AlterNode(node, new_inputs, "");
+    return true;
+  }
+
+  bool AlterReduce(Node* node) {
+    auto inputs = GetInputs(node);
+    auto& attrs = node->attrs.attr_store;
+    if (inputs.size() != 1U || !nhwc_vars_.count(inputs[0]) || !attrs.count("dim")) {
+      return false;
+    }
+    auto dims = absl::get<std::vector<int>>(attrs.at("dim"));
+    if (dims.empty()) {
+      dims = {0, 1, 2, 3};
+    }
+    std::vector<bool> reduced(4, false);
+    std::vector<int> new_dims;
+    for (auto dim : dims) {
+      dim          = dim < 0 ? dim + 4 : dim;
+      reduced[dim] = true;
+      new_dims.push_back(kNHWCToNCHW[dim]);
+    }
+    std::sort(new_dims.begin(), new_dims.end());
+
+    bool keep_dim = attrs.count("keep_dim") ? absl::get<bool>(attrs.at("keep_dim")) : false;
+    if (keep_dim) {
+      attrs["dim"] = new_dims;
+      AlterNode(node, {nhwc_vars_.at(inputs[0])}, "");
+      return true;
+    }
+    // the reduced var is the same in both layouts if its remaining axes keep the order.
+    if (!reduced[1] && (!reduced[2] || !reduced[3])) {
+      return false;
+    }
+    attrs["dim"] = new_dims;
+    ReplaceInputs(node, {nhwc_vars_.at(inputs[0])});
+    return true;
+  }
+
+  NodeData* GetOutput(const Node* node) const { return node->outlinks_in_order()[0]->sink()->safe_as<NodeData>(); }
+
+  // The broadcast_to from a lower rank can produce the NHWC var directly by broadcasting to other axes.
+  Node* GetRemappableBroadcast(NodeData* data) const {
+    auto* producer = data->source_node.get();
+    if (!producer || producer->op()->name != "broadcast_to" || !producer->attrs.attr_store.count("broadcast_axes")) {
+      return nullptr;
+    }
+    auto axes = absl::get<std::vector<int>>(producer->attrs.attr_store.at("broadcast_axes"));
+    for (int i = 1; i < axes.size(); ++i) {
+      if (kNHWCToNCHW[axes[i - 1]] >= kNHWCToNCHW[axes[i]]) {
+        return nullptr;
+      }
+    }
+    return producer;
+  }
+
+  NodeData* GetNHWCVar(NodeData* data) {
+    if (nhwc_vars_.count(data)) {
+      return nhwc_vars_.at(data);
+    }
+    Node* new_node  = nullptr;
+    auto* broadcast = GetRemappableBroadcast(data);
+    if (broadcast) {
+      new_node                   = MakeNode("broadcast_to");
+      new_node->attrs.attr_store = broadcast->attrs.attr_store;
+      auto out_shape             = absl::get<std::vector<int>>(broadcast->attrs.attr_store.at("out_shape"));
+      auto axes                  = absl::get<std::vector<int>>(broadcast->attrs.attr_store.at("broadcast_axes"));
+      std::vector<int> new_out_shape;
+      for (auto axis : kNCHWToNHWC) {
+        new_out_shape.push_back(out_shape[axis]);
+      }
+      for (auto& axis : axes) {
+        axis = kNHWCToNCHW[axis];
+      }
+      new_node->attrs.attr_store["out_shape"]      = new_out_shape;
+      new_node->attrs.attr_store["broadcast_axes"] = axes;
+      for (auto* input : GetInputs(broadcast)) {
+        input->LinkTo(new_node);
+      }
+      removable_nodes_.insert(broadcast);
+    } else {
+      new_node                           = MakeNode("transpose");
+      new_node->attrs.attr_store["axis"] = kNCHWToNHWC;
+      data->LinkTo(new_node);
+    }
+    auto* nhwc_data  = LinkNewOutput(new_node);
+    nhwc_vars_[data] = nhwc_data;
+    return nhwc_data;
+  }
+
+  Node* MakeNode(const std::string& op_type) {
+    auto* node = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type + "_channels_last"));
+    graph_->RegisterNode(node->id(), node);
+    removable_nodes_.insert(node);
+    return node;
+  }
+
+  NodeData* LinkNewOutput(Node* node) {
+    auto* output = new NodeData(Shared<Node>(node), 0, 0, common::UniqName(node->id() + "_out"));
+    graph_->RegisterNode(output->id(), output);
+    node->LinkTo(output);
+    InferShape(node, type_dict_, shape_dict_);
+    return output;
+  }
+
+  void ReplaceInputs(Node* node, const std::vector<NodeData*>& new_inputs) {
+    for (auto& link : node->inlinks_in_order()) {
+      link->source()->UnLinkSingleTo(node);
+    }
+    for (auto* input : new_inputs) {
+      input->LinkTo(node);
+    }
+  }
+
+  // alter the node to compute the NHWC var, and keep the NCHW output by a transpose.
+  void AlterNode(Node* node, const std::vector<NodeData*>& new_inputs, const std::string& data_format) {
+    VLOG(3) << "Alter " << node->id() << " to the NHWC layout";
+    ReplaceInputs(node, new_inputs);
+    if (!data_format.empty()) {
+      node->attrs.attr_store["data_format"] = data_format;
+    }
+    auto* output = GetOutput(node);
+    node->UnLinkSingleTo(output);
+    auto* nhwc_output = LinkNewOutput(node);
+
+    auto* transpose                     = MakeNode("transpose");
+    transpose->attrs.attr_store["axis"] = kNHWCToNCHW;
+    nhwc_output->LinkTo(transpose);
+    transpose->LinkTo(output);
+    output->source_node = Shared<Node>(transpose);
+    InferShape(transpose, type_dict_, shape_dict_);
+
+    nhwc_vars_[output] = nhwc_output;
+  }
+
+  void RemoveNode(GraphNode* node) {
+    auto inlinks = node->inlinks();
+    for (auto& link : inlinks) {
+      link->source()->UnLinkSingleTo(link->sink());
+    }
+    auto outlinks = node->outlinks();
+    for (auto& link : outlinks) {
+      link->source()->UnLinkSingleTo(link->sink());
+    }
+    graph_->DropNode(node);
+  }
+
+  // the transposes and broadcasts consumed by nothing are removed, which cancels the transposes inside the regions.
+  void RemoveDeadNodes() {
+    auto& outputs = graph_->outputs;
+    bool changed  = true;
+    while (changed) {
+      changed = false;
+      for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+        auto* node = graph_node->safe_as<Node>();
+        if (!node || !removable_nodes_.count(node) || node->outlinks().size() != 1) {
+          continue;
+        }
+        auto* output = GetOutput(node);
+        if (!output->outlinks().empty() || std::find(outputs.begin(), outputs.end(), output) != outputs.end()) {
+          continue;
+        }
+        VLOG(3) << "Remove the dead " << node->id();
+        RemoveNode(output);
+        RemoveNode(node);
+        changed = true;
+      }
+    }
+  }
+
+  Graph* graph_;
+  absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
+  absl::flat_hash_map<std::string, Type>& type_dict_;
+  const OpValueType<framework::OpPatternKind>& op_pattern_dict_;
+  // the NHWC var holding the same data of each NCHW var
+  std::unordered_map<NodeData*, NodeData*> nhwc_vars_;
+  // the created transposes and broadcasts, and the broadcasts remapped to NHWC
+  std::unordered_set<Node*> removable_nodes_;
+};
+
 void AlterLayoutPass(Graph* graph) {
+  if (graph->target_.is_gpu()) {
+    if (FLAGS_cinn_use_nvgpu_channels_last) {
+      ChannelsLastHelper helper(graph);
+      int cnt = helper();
+      VLOG(3) << "AlterLayout altered " << cnt << " ops to the NHWC layout on NVGPU.";
+    }
+    return;
+  }
   // alterlayout only in X86 for it's specific layout requirements
-  if (graph->target_.arch == Target::Arch::X86) {
+  if (graph->target_.is_cpu()) {
     auto store_nodes     = std::get<0>(graph->topological_order());
     auto& shape_dict     = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
     auto& type_dict      = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
@@ -639,8 +948,8 @@ void AlterLayoutPass(Graph* graph) {
 CINN_REGISTER_HELPER(AlterLayout) {
   CINN_REGISTER_PASS(AlterLayout)
       .describe(
-          "This pass alters ops' data layouts in the graph(e.g. NCHW -> NCHWxc, OIHW -> OIHWxoxi) and saves to "
-          "g.attrs[\"inferlayout\"]")
+          "This pass alters ops' data layouts in the graph(e.g. NCHW -> NCHWxc, OIHW -> OIHWxoxi on X86, NCHW -> NHWC "
+          "on NVGPU) and saves to g.attrs[\"inferlayout\"]")
       .set_change_structure(true)
       .provide_graph_attr("infershape")
       .provide_graph_attr("inferdtype")
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+DECLARE_bool(cinn_use_nvgpu_channels_last);
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+std::vector<hlir::framework::Node*> GetOps(const hlir::framework::Graph& graph, const std::string& op_type) {
+  std::vector<hlir::framework::Node*> ops;
+  for (auto* node : std::get<0>(graph.topological_order())) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node && op_node->op()->name == op_type) {
+      ops.push_back(op_node);
+    }
+  }
+  return ops;
+}
+}  // namespace
+
+TEST(AlterLayout, NVGPUChannelsLast) {
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(16), {2, 8, 16, 16}, "X");
+  auto w      = builder.CreateInput(Float(16), {16, 8, 3, 3}, "W");
+  auto b      = builder.CreateInput(Float(16), {16}, "B");
+  auto conv   = builder.Conv2d(x, w, {1, 1}, {1, 1});
+  auto bias   = builder.BroadcastTo(b, {2, 16, 16, 16}, {1});
+  auto relu   = builder.Relu(builder.Add(conv, bias));
+  auto pool   = builder.Pool2d(relu, "max", {2, 2}, {2, 2});
+  auto reduce = builder.ReduceSum(pool, {0, 2, 3});
+
+  auto program = builder.Build();
+
+  auto target = common::DefaultNVGPUTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(
+      program, std::unordered_set<std::string>{pool->id, reduce->id}, target);
+  FLAGS_cinn_use_nvgpu_channels_last = true;
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  FLAGS_cinn_use_nvgpu_channels_last = false;
+  LOG(INFO) << graph->Visualize();
+
+  auto convs = GetOps(*graph, "conv2d");
+  auto pools = GetOps(*graph, "pool2d");
+  ASSERT_EQ(convs.size(), 1U);
+  ASSERT_EQ(pools.size(), 1U);
+  EXPECT_EQ(absl::get<std::string>(convs[0]->attrs.attr_store.at("data_format")), "NHWC");
+  EXPECT_EQ(absl::get<std::string>(pools[0]->attrs.attr_store.at("data_format")), "NHWC");
+  // only the input, the filter and the fetched pool2d output are transposed, the bias is broadcast to NHWC directly
+  EXPECT_EQ(GetOps(*graph, "transpose").size(), 3U);
+  EXPECT_EQ(GetOps(*graph, "broadcast_to").size(), 1U);
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  EXPECT_EQ(shape_dict.at(pool->id), (hlir::framework::shape_t{2, 16, 8, 8}));
+  EXPECT_EQ(shape_dict.at(reduce->id), (hlir::framework::shape_t{16}));
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -222,6 +222,8 @@ NodePtr CheckFusionAccuracyPass::CreateCheckNode(Node* node) {
 
   auto check_node              = Node::Create(node->op(), GenerateAccCheckNodeId(node->attrs.node_name), check_node_id);
   check_node->attrs.attr_store = node->attrs.attr_store;
+  // the check node is the reference of the fused kernel, so the error of the approximate math is checked
+  check_node->attrs.attr_store["math_precision"] = std::string("precise");
 
   graph_->RegisterNode(check_node_id, check_node.get());
 
@@ -235,7 +237,7 @@ NodePtr CheckFusionAccuracyPass::CreateCheckNode(Node* node) {
 }
 
 OpPatternKind CheckFusionAccuracyPass::GetOpKind(const framework::Node* node) {
-  auto op_pattern_dict_ = &framework::Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto op_pattern_dict_ = &framework::Operator::GetOpPatternAttrs();
   CHECK(op_pattern_dict_->Find(node->op())) << "Don't find the pattern of op : " << node->id();
   auto kind = op_pattern_dict_[0][node->op()];
 
@@ -0,0 +1,144 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+
+namespace cinn::hlir::pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using Group = framework::Graph::Group;
+
+namespace {
+
+// Tell whether the node is a collective op running off the compute stream, before or after the TransToCustomCallPass.
+bool IsAsyncCollective(const Node* node) {
+  static const std::unordered_set<std::string> collective_ops = {"all_reduce", "all_gather", "reduce_scatter"};
+  const auto& attr_store = node->attrs.attr_store;
+  std::string op_name    = node->op()->name;
+  if (op_name == "custom_call" && attr_store.count("original_op")) {
+    op_name = absl::get<std::string>(attr_store.at("original_op"));
+  }
+  if (!collective_ops.count(op_name)) return false;
+  return attr_store.count("use_calc_stream") && !absl::get<bool>(attr_store.at("use_calc_stream"));
+}
+
+}  // namespace
+
+/**
+ * Reorder the fusion groups, which are compiled to the instructions in order, so that the collective ops running off
+ * the compute stream are issued as soon as their inputs are ready, and the groups reading their results are deferred
+ * after the independent groups, which then overlap with the communication. The groups are list scheduled in the
+ * topological order: a ready collective first, then a ready group not reading a collective, keeping the original
+ * order among the same kind.
+ */
+void CollectiveSchedulePassInternal(Graph* graph) {
+  auto& groups   = graph->fusion_groups;
+  int num_groups = groups.size();
+
+  std::unordered_map<const Node*, int> node_to_group;
+  std::vector<bool> is_collective(num_groups, false);
+  for (int i = 0; i < num_groups; ++i) {
+    for (auto* node : groups[i]->CollectNodes()) {
+      node_to_group[node] = i;
+      if (IsAsyncCollective(node)) {
+        is_collective[i] = true;
+      }
+    }
+  }
+  if (std::find(is_collective.begin(), is_collective.end(), true) == is_collective.end()) {
+    VLOG(3) << "No collective op runs off the compute stream, skip the CollectiveSchedulePass";
+    return;
+  }
+
+  std::vector<std::set<int>> successors(num_groups);
+  std::vector<int> num_predecessors(num_groups, 0);
+  std::vector<bool> reads_collective(num_groups, false);
+  for (int i = 0; i < num_groups; ++i) {
+    std::set<int> predecessors;
+    for (auto* node : groups[i]->CollectNodes()) {
+      for (auto& in_edge : node->inlinks_in_order()) {
+        auto* data = in_edge->source()->safe_as<NodeData>();
+        if (!data || !data->source_node.get()) continue;
+        auto it = node_to_group.find(data->source_node.get());
+        if (it != node_to_group.end() && it->second != i) {
+          predecessors.insert(it->second);
+        }
+      }
+    }
+    for (int pred : predecessors) {
+      successors[pred].insert(i);
+      reads_collective[i] = reads_collective[i] || is_collective[pred];
+    }
+    num_predecessors[i] = predecessors.size();
+  }
+
+  // the ready groups of each priority, ordered by the original index
+  std::set<int> ready_collectives, ready_independents, ready_readers;
+  auto make_ready = [&](int i) {
+    if (is_collective[i]) {
+      ready_collectives.insert(i);
+    } else if (reads_collective[i]) {
+      ready_readers.insert(i);
+    } else {
+      ready_independents.insert(i);
+    }
+  };
+  for (int i = 0; i < num_groups; ++i) {
+    if (num_predecessors[i] == 0) make_ready(i);
+  }
+
+  std::vector<std::shared_ptr<Group>> scheduled;
+  scheduled.reserve(num_groups);
+  while (scheduled.size() < num_groups) {
+    std::set<int>* ready = &ready_readers;
+    if (!ready_collectives.empty()) {
+      ready = &ready_collectives;
+    } else if (!ready_independents.empty()) {
+      ready = &ready_independents;
+    }
+    CHECK(!ready->empty()) << "The fusion groups have a cycle";
+    int i = *ready->begin();
+    ready->erase(ready->begin());
+    scheduled.push_back(groups[i]);
+    for (int succ : successors[i]) {
+      if (--num_predecessors[succ] == 0) make_ready(succ);
+    }
+  }
+  groups = std::move(scheduled);
+  VLOG(3) << "Scheduled " << num_groups << " fusion groups around the collective ops";
+}
+
+}  // namespace cinn::hlir::pass
+
+CINN_REGISTER_HELPER(CollectiveSchedulePass) {
+  CINN_REGISTER_PASS(CollectiveSchedulePass)
+      .describe(
+          "Reorder the fusion groups to overlap the collective ops running off the compute stream with the groups "
+          "independent of them.")
+      .set_change_structure(false)
+      .set_body(cinn::hlir::pass::CollectiveSchedulePassInternal);
+  return true;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+std::vector<std::string> GetGroupOps(const hlir::framework::Graph& graph) {
+  std::vector<std::string> ops;
+  for (auto& group : graph.fusion_groups) {
+    ops.push_back(group->CollectNodes().front()->op()->name);
+  }
+  return ops;
+}
+
+TEST(CollectiveSchedulePass, defer_readers) {
+  NetBuilder net_builder("defer_readers");
+  auto x = net_builder.CreateInput(Float(32), {8, 16}, "x");
+  auto y = net_builder.CreateInput(Float(32), {8, 16}, "y");
+  auto a = net_builder.AllReduce(x, "sum", 0, false);
+  auto b = net_builder.Add(a, x);
+  auto c = net_builder.Relu(y);
+
+  auto program = net_builder.Build();
+  auto graph   = std::make_shared<hlir::framework::Graph>(
+      program, std::unordered_set<std::string>{b->id, c->id}, common::DefaultTarget());
+  hlir::framework::ApplyPass(graph.get(), "BuildNonFusedGroupsPass");
+  hlir::framework::ApplyPass(graph.get(), "CollectiveSchedulePass");
+
+  // the relu independent of the all_reduce runs before the add reading its result
+  ASSERT_EQ(GetGroupOps(*graph), std::vector<std::string>({"all_reduce", "relu", "elementwise_add"}));
+}
+
+TEST(CollectiveSchedulePass, keep_calc_stream) {
+  NetBuilder net_builder("keep_calc_stream");
+  auto x = net_builder.CreateInput(Float(32), {8, 16}, "x");
+  auto y = net_builder.CreateInput(Float(32), {8, 16}, "y");
+  auto a = net_builder.AllReduce(x);
+  auto b = net_builder.Add(a, x);
+  auto c = net_builder.Relu(y);
+
+  auto program = net_builder.Build();
+  auto graph   = std::make_shared<hlir::framework::Graph>(
+      program, std::unordered_set<std::string>{b->id, c->id}, common::DefaultTarget());
+  hlir::framework::ApplyPass(graph.get(), "BuildNonFusedGroupsPass");
+  auto origin_ops = GetGroupOps(*graph);
+  hlir::framework::ApplyPass(graph.get(), "CollectiveSchedulePass");
+
+  // the collective ops on the compute stream don't overlap with the others, so the order is kept
+  ASSERT_EQ(GetGroupOps(*graph), origin_ops);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,321 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+#include "cinn/hlir/pass/infershape.h"
+#include "cinn/ir/ir_schedule_util.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+// ConvImplicitGemm Pass: lower the float16 NHWC conv2d left by TransToCustomCallPass as an implicit GEMM computed by
+// Tensor Cores, and fuse the bias add, the residual add and the activation after it into its epilogue.
+// B = conv2d(A, W)  // A is NHWC and W is OHWI
+// C = elementwise_add(B, broadcast_to(bias))
+// D = elementwise_add(C, residual)
+// E = relu(D)
+// after
+// A_pad = pad(A)
+// W_hwio = transpose(W)
+// E, acc = conv2d_implicit_gemm(A_pad, W_hwio, bias, residual)
+// The im2col matrix of the GEMM is addressed from A_pad on the fly. A_pad is also padded after the width to align the
+// output columns to the Tensor Core tiles, and it is computed by an injective kernel which the element-wise producers
+// of A are fused into. The transpose of a constant filter is computed once on PreRun.
+class ConvImplicitGemmHelper : public FusionHelperBase {
+ public:
+  ConvImplicitGemmHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        graph_(graph),
+        type_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype")),
+        mutable_shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape")) {}
+
+  void operator()() {
+    auto conv_nodes = graph_->CollectNodes([](const common::GraphNode* graph_node) -> bool {
+      auto node = graph_node->safe_as<Node>();
+      return node && node->op()->name == "conv2d";
+    });
+    for (auto* graph_node : conv_nodes) {
+      auto* conv = graph_node->safe_as<Node>();
+      if (CanRewrite(conv)) {
+        Rewrite(conv);
+      }
+    }
+  }
+
+ private:
+  template <typename T>
+  static T GetAttr(const Node* node, const std::string& name, const T& default_value) {
+    const auto& attr_store = node->attrs.attr_store;
+    return attr_store.count(name) ? absl::get<T>(attr_store.at(name)) : default_value;
+  }
+
+  bool IsGraphOutput(const NodeData* node_data) const {
+    return std::find(graph_->outputs.begin(), graph_->outputs.end(), node_data) != graph_->outputs.end();
+  }
+
+  // The tiles of the GEMM are of 16 output columns, 16 output channels and 16 input channels, and its M dimension
+  // walks the output columns, which requires the unit stride of width for the Tensor Core fragments.
+  bool CanRewrite(const Node* conv) const {
+    if (GetAttr<std::string>(conv, "data_format", "NCHW") != "NHWC" ||
+        GetAttr<std::string>(conv, "conv_type", "forward") != "forward" || GetAttr<int>(conv, "groups", 1) != 1 ||
+        GetAttr<std::vector<int>>(conv, "stride", {1, 1}) != std::vector<int>{1, 1} ||
+        GetAttr<std::vector<int>>(conv, "padding", {0, 0}).size() != 2U ||
+        GetAttr<std::vector<int>>(conv, "dilation", {1, 1}).size() != 2U) {
+      return false;
+    }
+    auto inputs = GetProducerNodeData(conv);
+    if (inputs.size() != 2U || inputs[0] == inputs[1] || GetNodeDatas(conv).size() != 1U) {
+      return false;
+    }
+    const auto& x_shape = shape_dict_.at(inputs[0]->id());
+    const auto& w_shape = shape_dict_.at(inputs[1]->id());
+    if (x_shape.size() != 4U || w_shape.size() != 4U || x_shape[3] != w_shape[3] ||
+        x_shape[3] % ir::kTensorCoreFragmentSize != 0 || w_shape[0] % ir::kTensorCoreFragmentSize != 0) {
+      return false;
+    }
+    return type_dict_.at(inputs[0]->id()).is_float16() && type_dict_.at(inputs[1]->id()).is_float16();
+  }
+
+  // Return the only consumer of the node's output if its name is op_name, otherwise return nullptr.
+  Node* GetSingleConsumer(const Node* node, const std::string& op_name) const {
+    auto outputs = GetNodeDatas(node);
+    if (outputs.size() != 1 || IsGraphOutput(outputs[0])) {
+      return nullptr;
+    }
+    auto consumers = GetConsumerNode(node);
+    if (consumers.size() != 1 || consumers[0]->op()->name != op_name) {
+      return nullptr;
+    }
+    return consumers[0];
+  }
+
+  // Return the input of add other than the output of producer, or nullptr if add doesn't take it as a single operand.
+  NodeData* GetOtherInput(const Node* add, const NodeData* producer_out) const {
+    auto add_inputs = GetProducerNodeData(add);
+    if (add_inputs.size() != 2 || add_inputs[0] == add_inputs[1]) {
+      return nullptr;
+    }
+    if (add_inputs[0] != producer_out && add_inputs[1] != producer_out) {
+      return nullptr;
+    }
+    return add_inputs[0] == producer_out ? add_inputs[1] : add_inputs[0];
+  }
+
+  // Return the bias vector of shape [co] added to the channels of the output, which is either added directly or
+  // broadcast by broadcast_to. The broadcast_to node is returned by broadcast_node if exists.
+  NodeData* GetBias(const Node* add, NodeData* add_input, const shape_t& out_shape, Node** broadcast_node) const {
+    int axis = GetAttr<int>(add, "axis", -1);
+    if (axis != -1 && axis != 3) {
+      return nullptr;
+    }
+    auto* producer = add_input->source_node.get();
+    if (producer && producer->op()->name == "broadcast_to") {
+      if (IsGraphOutput(add_input) || add_input->outlinks().size() != 1 ||
+          GetAttr<std::vector<int>>(producer, "broadcast_axes", {}) != std::vector<int>{3}) {
+        return nullptr;
+      }
+      *broadcast_node = producer;
+      add_input       = GetProducerNodeData(producer)[0];
+    }
+    if (shape_dict_.at(add_input->id()) != shape_t{out_shape[3]}) {
+      return nullptr;
+    }
+    return add_input;
+  }
+
+  NodeData* AddOutput(Node* node, const std::string& suffix, int index = 0) {
+    auto* output = new NodeData(common::Shared<Node>(node), index, 0, common::UniqName(node->id() + suffix));
+    graph_->RegisterNode(output->id(), output);
+    node->LinkTo(output);
+    return output;
+  }
+
+  Node* AddNode(const std::string& op_type) {
+    auto* node = new Node(framework::Operator::Get(op_type), op_type, common::UniqName(op_type));
+    graph_->RegisterNode(node->id(), node);
+    return node;
+  }
+
+  void Rewrite(Node* conv) {
+    auto inputs           = GetProducerNodeData(conv);
+    auto* x               = inputs[0];
+    auto* filter          = inputs[1];
+    auto* conv_out        = GetNodeData(conv);
+    const auto& out_shape = shape_dict_.at(conv_out->id());
+    auto out_type         = type_dict_.at(conv_out->id());
+
+    // the nodes fused after the conv2d in order, the output of each one is only consumed by the next one
+    std::vector<Node*> chain;
+    NodeData* chain_out = conv_out;
+    Node* broadcast     = nullptr;
+    NodeData* bias      = nullptr;
+    NodeData* bias_arg  = nullptr;
+    auto* bias_add      = GetSingleConsumer(conv, "elementwise_add");
+    if (bias_add && (bias_arg = GetOtherInput(bias_add, chain_out))) {
+      bias = GetBias(bias_add, bias_arg, out_shape, &broadcast);
+    }
+    if (bias && type_dict_.at(bias->id()) == out_type && bias != x && bias != filter) {
+      chain.push_back(bias_add);
+      chain_out = GetNodeData(bias_add);
+    } else {
+      bias      = nullptr;
+      broadcast = nullptr;
+    }
+    NodeData* residual = nullptr;
+    auto* residual_add = GetSingleConsumer(chain.empty() ? conv : chain.back(), "elementwise_add");
+    if (residual_add && GetAttr<int>(residual_add, "axis", -1) == -1) {
+      residual = GetOtherInput(residual_add, chain_out);
+    }
+    // an input of the conv2d_implicit_gemm can't be linked twice
+    if (residual && shape_dict_.at(residual->id()) == out_shape && type_dict_.at(residual->id()) == out_type &&
+        residual != x && residual != filter && residual != bias) {
+      chain.push_back(residual_add);
+      chain_out = GetNodeData(residual_add);
+    } else {
+      residual = nullptr;
+    }
+    auto* relu = GetSingleConsumer(chain.empty() ? conv : chain.back(), "relu");
+    if (relu) {
+      chain.push_back(relu);
+    }
+    auto* out            = chain.empty() ? conv_out : GetNodeData(chain.back());
+    std::string epilogue = std::string(bias ? "bias" : "") + (residual ? "_residual" : "") + (relu ? "_relu" : "");
+    VLOG(4) << "Rewrite " << conv->id() << " to the implicit GEMM with the epilogue " << epilogue << " of "
+            << chain.size() << " nodes";
+
+    // unlink the rewritten nodes
+    x->UnLinkSingleTo(conv);
+    filter->UnLinkSingleTo(conv);
+    conv->UnLinkSingleTo(conv_out);
+    std::vector<NodeData*> dropped_datas;
+    NodeData* producer_out = conv_out;
+    for (auto* node : chain) {
+      producer_out->UnLinkSingleTo(node);
+      if (producer_out != conv_out) {
+        dropped_datas.push_back(producer_out);
+      }
+      producer_out = GetNodeData(node);
+      node->UnLinkSingleTo(producer_out);
+    }
+    if (bias) {
+      bias_arg->UnLinkSingleTo(bias_add);
+      if (broadcast) {
+        bias->UnLinkSingleTo(broadcast);
+        broadcast->UnLinkSingleTo(bias_arg);
+      }
+    }
+    if (residual) {
+      residual->UnLinkSingleTo(residual_add);
+    }
+
+    // pad the input by the padding of conv2d, and after the width to round the output columns up to the tiles
+    auto padding    = GetAttr<std::vector<int>>(conv, "padding", {0, 0});
+    auto dilation   = GetAttr<std::vector<int>>(conv, "dilation", {1, 1});
+    int tile        = ir::kTensorCoreFragmentSize;
+    int tail_width  = (out_shape[2] + tile - 1) / tile * tile - out_shape[2];
+    NodeData* x_pad = x;
+    if (padding[0] > 0 || padding[1] > 0 || tail_width > 0) {
+      auto* pad                           = AddNode("pad");
+      pad->attrs.attr_store["pad_before"] = std::vector<int>{0, padding[0], padding[1], 0};
+      pad->attrs.attr_store["pad_after"]  = std::vector<int>{0, padding[0], padding[1] + tail_width, 0};
+      x->LinkTo(pad);
+      x_pad = AddOutput(pad, "_out");
+      InferShape(pad, type_dict_, mutable_shape_dict_);
+    }
+    // transpose the filter from OHWI to HWIO, so that the K dimension of the GEMM is followed by its N dimension
+    auto* transpose                     = AddNode("transpose");
+    transpose->attrs.attr_store["axis"] = std::vector<int>{1, 2, 3, 0};
+    filter->LinkTo(transpose);
+    auto* filter_hwio = AddOutput(transpose, "_out");
+    InferShape(transpose, type_dict_, mutable_shape_dict_);
+    if (filter->is_const()) {
+      transpose->attrs.attr_store["pre_run"] = true;
+      filter_hwio->set_const(true);
+    }
+
+    auto* gemm                             = AddNode("conv2d_implicit_gemm");
+    gemm->attrs.attr_store["stride"]       = std::vector<int>{1, 1};
+    gemm->attrs.attr_store["dilation"]     = dilation;
+    gemm->attrs.attr_store["output_width"] = out_shape[2];
+    gemm->attrs.attr_store["epilogue"]     = epilogue;
+    x_pad->LinkTo(gemm);
+    filter_hwio->LinkTo(gemm);
+    if (bias) {
+      bias->LinkTo(gemm);
+    }
+    if (residual) {
+      residual->LinkTo(gemm);
+    }
+    gemm->LinkTo(out);
+    out->source_node.Reset(gemm);
+    AddOutput(gemm, "_acc", 1);
+    InferShape(gemm, type_dict_, mutable_shape_dict_);
+    CHECK(shape_dict_.at(out->id()) == out_shape) << "The output shape of " << gemm->id() << " is changed!";
+
+    for (auto* node_data : dropped_datas) {
+      graph_->DropNode(node_data);
+    }
+    if (out != conv_out) {
+      graph_->DropNode(conv_out);
+    }
+    graph_->DropNode(conv);
+    if (broadcast) {
+      graph_->DropNode(bias_arg);
+      graph_->DropNode(broadcast);
+    }
+    for (auto* node : chain) {
+      graph_->DropNode(node);
+    }
+  }
+
+  Graph* graph_;
+  absl::flat_hash_map<std::string, common::Type>& type_dict_;
+  absl::flat_hash_map<std::string, shape_t>& mutable_shape_dict_;
+};
+
+void ConvImplicitGemmPassInternal(Graph* graph) {
+  if (graph->target_.arch != common::Target::Arch::NVGPU) {
+    return;
+  }
+  VLOG(3) << "ConvImplicitGemmPass...!";
+  ConvImplicitGemmHelper conv_implicit_gemm_helper(graph);
+  conv_implicit_gemm_helper();
+  VLOG(3) << "ConvImplicitGemmPass Finish...!";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(ConvImplicitGemmPass) {
+  CINN_REGISTER_PASS(ConvImplicitGemmPass)
+      .describe(
+          "This pass rewrites the float16 NHWC conv2d to the implicit GEMM computed by Tensor Cores, and fuses the "
+          "bias add, residual add and relu after it, it should be applied after TransToCustomCallPass")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::ConvImplicitGemmPassInternal);
+  return true;
+}
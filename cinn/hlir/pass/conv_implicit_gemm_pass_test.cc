@@ -0,0 +1,124 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+int GetSize(const std::vector<int>& shape) {
+  return std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+}
+
+std::vector<float> RunGraph(std::shared_ptr<hlir::framework::Graph> graph,
+                            const std::vector<Variable>& inputs,
+                            const std::vector<std::vector<float>>& inputs_data,
+                            const std::string& fetch_id) {
+  auto target = common::DefaultNVGPUTarget();
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+
+  for (int idx = 0; idx < inputs.size(); ++idx) {
+    scope->Var<hlir::framework::Tensor>(inputs[idx]->id);
+    auto tensor = scope->GetTensor(inputs[idx]->id);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(inputs_data[idx], tensor, target);
+  }
+  run_program->Execute();
+
+  auto tensor = scope->GetTensor(fetch_id);
+  std::vector<float> data(tensor->shape().numel());
+  CopyToVector(tensor, &data);
+  return data;
+}
+
+int CountNodes(const hlir::framework::Graph& graph, const std::string& op_name) {
+  int count = 0;
+  for (auto* node : std::get<0>(graph.topological_order())) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node && op_node->op()->name == op_name) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// The float32 inputs are cast to float16 before the conv2d, and the casts are fused into the pad of the input.
+void RunModelTest(Program& program, const std::vector<Variable>&& inputs, const std::string& fetch_id) {
+  std::vector<std::vector<float>> inputs_data;
+  for (auto input : inputs) {
+    inputs_data.emplace_back(GetSize(input->shape));
+    InitRandomVector<float>(&inputs_data.back(), inputs_data.back().size(), -1.0f, 1.0f, 1e-3);
+  }
+
+  auto target = common::DefaultNVGPUTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  auto expected = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  graph = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  hlir::framework::ApplyPass(graph.get(), "ConvImplicitGemmPass");
+  ASSERT_EQ(CountNodes(*graph, "conv2d_implicit_gemm"), 1);
+  ASSERT_EQ(CountNodes(*graph, "conv2d"), 0);
+  ASSERT_EQ(CountNodes(*graph, "relu"), 0);
+  auto actual = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  CheckOutput<float>(expected, actual, 1e-2, 1e-2);
+}
+
+TEST(ConvImplicitGemmPass, Conv_Bias_Relu) {
+  int n = 2, h = 14, w = 14, ci = 32, co = 64;
+  NetBuilder net_builder("Conv_Bias_Relu");
+  auto X    = net_builder.CreateInput(Float(32), {n, h, w, ci}, "X");
+  auto W    = net_builder.CreateInput(Float(32), {co, 3, 3, ci}, "W");
+  auto bias = net_builder.CreateInput(Float(32), {co}, "bias");
+  auto conv = net_builder.Conv2d(net_builder.Cast(X, "float16"),
+                                 net_builder.Cast(W, "float16"),
+                                 {1, 1},
+                                 {1, 1},
+                                 {1, 1},
+                                 1,
+                                 "NHWC");
+  auto add  = net_builder.Add(conv, net_builder.BroadcastTo(net_builder.Cast(bias, "float16"), {n, h, w, co}, {3}));
+  auto out  = net_builder.Cast(net_builder.Relu(add), "float32");
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {X, W, bias}, out->id);
+}
+
+TEST(ConvImplicitGemmPass, Conv_Bias_Residual_Relu) {
+  int n = 1, h = 16, w = 32, ci = 16, co = 32;
+  NetBuilder net_builder("Conv_Bias_Residual_Relu");
+  auto X        = net_builder.CreateInput(Float(32), {n, h, w, ci}, "X");
+  auto W        = net_builder.CreateInput(Float(32), {co, 1, 1, ci}, "W");
+  auto bias     = net_builder.CreateInput(Float(32), {co}, "bias");
+  auto residual = net_builder.CreateInput(Float(32), {n, h, w, co}, "residual");
+  auto conv     = net_builder.Conv2d(
+      net_builder.Cast(X, "float16"), net_builder.Cast(W, "float16"), {1, 1}, {0, 0}, {1, 1}, 1, "NHWC");
+  auto add      = net_builder.Add(conv, net_builder.BroadcastTo(net_builder.Cast(bias, "float16"), {n, h, w, co}, {3}));
+  auto sum      = net_builder.Add(net_builder.Cast(residual, "float16"), add);
+  auto out      = net_builder.Cast(net_builder.Relu(sum), "float32");
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {X, W, bias, residual}, out->id);
+}
+
+}  // namespace frontend
+}  // namespace cinn
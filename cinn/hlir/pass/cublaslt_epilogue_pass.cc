@@ -0,0 +1,257 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+// CublasLt Epilogue Pass: fuse the bias add, the residual add and the activation after a matmul into the epilogue of
+// cublasLtMatmul.
+// C = custom_call[cinn_call_cublas](A, B)
+// D = elementwise_add(C, broadcast_to(bias))
+// E = elementwise_add(D, residual)
+// F = relu(E)
+// after
+// F = custom_call[cinn_call_cublaslt_matmul](A, B, bias, residual)
+// The residual is accumulated as the C matrix of cublasLt with beta = 1, which is added before the activation, so the
+// output of matmul is written only once instead of being re-read by the following elementwise kernels.
+
+class CublasLtEpilogueHelper : public FusionHelperBase {
+ public:
+  CublasLtEpilogueHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        graph_(graph),
+        type_dict_(graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype")) {}
+
+  void operator()() {
+    auto mark_nodes = graph_->CollectNodes([](const common::GraphNode* graph_node) -> bool {
+      auto node = graph_node->safe_as<Node>();
+      if (!node || node->op()->name != "custom_call" || !node->attrs.attr_store.count("original_op")) {
+        return false;
+      }
+      auto original_op = absl::get<std::string>(node->attrs.attr_store.at("original_op"));
+      return original_op == "matmul" || original_op == "cublas_matmul";
+    });
+
+    for (auto* graph_node : mark_nodes) {
+      FuseEpilogue(graph_node->safe_as<Node>());
+    }
+  }
+
+ private:
+  bool IsGraphOutput(const NodeData* node_data) const {
+    return std::find(graph_->outputs.begin(), graph_->outputs.end(), node_data) != graph_->outputs.end();
+  }
+
+  // Return the only consumer of the node's output if its name is op_name, otherwise return nullptr.
+  Node* GetSingleConsumer(const Node* node, const std::string& op_name) const {
+    auto outputs = GetNodeDatas(node);
+    if (outputs.size() != 1 || IsGraphOutput(outputs[0])) {
+      return nullptr;
+    }
+    auto consumers = GetConsumerNode(node);
+    if (consumers.size() != 1 || consumers[0]->op()->name != op_name) {
+      return nullptr;
+    }
+    return consumers[0];
+  }
+
+  // Return the bias vector of shape [n] added to the matmul output of shape [m, n], which is either added directly or
+  // broadcast by broadcast_to. The broadcast_to node is returned by broadcast_node if exists.
+  NodeData* GetBias(const Node* add, NodeData* add_input, int n, Node** broadcast_node) const {
+    const auto& add_attrs = add->attrs.attr_store;
+    int axis              = add_attrs.count("axis") ? absl::get<int>(add_attrs.at("axis")) : -1;
+    if (axis != -1 && axis != 1) {
+      return nullptr;
+    }
+    auto* producer = add_input->source_node.get();
+    if (producer && producer->op()->name == "broadcast_to") {
+      const auto& attr_store = producer->attrs.attr_store;
+      if (!attr_store.count("broadcast_axes") || IsGraphOutput(add_input) || add_input->outlinks().size() != 1 ||
+          absl::get<std::vector<int>>(attr_store.at("broadcast_axes")) != std::vector<int>{1}) {
+        return nullptr;
+      }
+      *broadcast_node = producer;
+      add_input       = GetProducerNodeData(producer)[0];
+    }
+    if (shape_dict_.at(add_input->id()) != shape_t{n}) {
+      return nullptr;
+    }
+    return add_input;
+  }
+
+  // Return the residual of shape [m, n] added to the bias added output, or nullptr if the add can't be fused.
+  NodeData* GetResidual(const Node* residual_add, const NodeData* add_out, const shape_t& out_shape) const {
+    const auto& attr_store = residual_add->attrs.attr_store;
+    if (attr_store.count("axis") && absl::get<int>(attr_store.at("axis")) != -1) {
+      return nullptr;
+    }
+    auto add_inputs = GetProducerNodeData(residual_add);
+    if (add_inputs.size() != 2 || add_inputs[0] == add_inputs[1]) {
+      return nullptr;
+    }
+    auto* residual = add_inputs[0] == add_out ? add_inputs[1] : add_inputs[0];
+    if (shape_dict_.at(residual->id()) != out_shape || type_dict_.at(residual->id()) != type_dict_.at(add_out->id())) {
+      return nullptr;
+    }
+    return residual;
+  }
+
+  void FuseEpilogue(Node* matmul) {
+    const auto& attr_store = matmul->attrs.attr_store;
+    bool trans_out         = attr_store.count("trans_out") ? absl::get<bool>(attr_store.at("trans_out")) : false;
+    auto inputs            = GetProducerNodeData(matmul);
+    if (trans_out || inputs.size() != 2 || shape_dict_.at(inputs[0]->id()).size() != 2 ||
+        shape_dict_.at(inputs[1]->id()).size() != 2) {
+      return;
+    }
+
+    auto* add = GetSingleConsumer(matmul, "elementwise_add");
+    if (!add) {
+      return;
+    }
+    auto* matmul_out = GetNodeData(matmul);
+    auto add_inputs  = GetProducerNodeData(add);
+    CHECK_EQ(add_inputs.size(), 2);
+    if (add_inputs[0] != matmul_out && add_inputs[1] != matmul_out) {
+      return;
+    }
+    auto* add_input = add_inputs[0] == matmul_out ? add_inputs[1] : add_inputs[0];
+
+    const auto& out_shape = shape_dict_.at(matmul_out->id());
+    Node* broadcast       = nullptr;
+    auto* bias            = GetBias(add, add_input, out_shape[1], &broadcast);
+    if (!bias || type_dict_.at(bias->id()) != type_dict_.at(matmul_out->id())) {
+      return;
+    }
+
+    // the residual of the same shape and dtype as the output, which is not the bias added output itself
+    auto* add_out      = GetNodeData(add);
+    auto* residual_add = GetSingleConsumer(add, "elementwise_add");
+    NodeData* residual = residual_add ? GetResidual(residual_add, add_out, out_shape) : nullptr;
+    // an input of the custom call can't be linked twice
+    if (!residual || residual == inputs[0] || residual == inputs[1] || residual == bias) {
+      residual     = nullptr;
+      residual_add = nullptr;
+    }
+
+    // the nodes fused after the matmul in order, the output of each one is only consumed by the next one
+    std::vector<Node*> chain = {add};
+    if (residual_add) {
+      chain.push_back(residual_add);
+    }
+    auto* relu = GetSingleConsumer(chain.back(), "relu");
+    if (relu) {
+      chain.push_back(relu);
+    }
+    Node* last           = chain.back();
+    auto* out            = GetNodeData(last);
+    std::string epilogue = std::string("bias") + (residual_add ? "_residual" : "") + (relu ? "_relu" : "");
+    VLOG(4) << "Fuse " << chain.size() << " nodes from " << add->id() << " to " << last->id()
+            << " into the epilogue " << epilogue << " of " << matmul->id();
+
+    // create custom call node
+    Node* node_tmp = new Node(Operator::Get("custom_call"), "custom_call", common::UniqName("custom_call"));
+    graph_->RegisterNode(node_tmp->id(), node_tmp);
+    node_tmp->attrs.attr_store                = matmul->attrs.attr_store;
+    node_tmp->attrs.attr_store["original_op"] = std::string("matmul");
+    node_tmp->attrs.attr_store["custom_call"] = std::string("cinn_call_cublaslt_matmul");
+    node_tmp->attrs.attr_store["epilogue"]    = epilogue;
+
+    // unlink the fused nodes
+    for (auto* input : inputs) {
+      input->UnLinkSingleTo(matmul);
+    }
+    matmul->UnLinkSingleTo(matmul_out);
+    matmul_out->UnLinkSingleTo(add);
+    add_input->UnLinkSingleTo(add);
+    if (broadcast) {
+      bias->UnLinkSingleTo(broadcast);
+      broadcast->UnLinkSingleTo(add_input);
+    }
+    if (residual_add) {
+      residual->UnLinkSingleTo(residual_add);
+    }
+    std::vector<NodeData*> dropped_datas;
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+      auto* chain_out = GetNodeData(chain[i]);
+      chain[i]->UnLinkSingleTo(chain_out);
+      chain_out->UnLinkSingleTo(chain[i + 1]);
+      dropped_datas.push_back(chain_out);
+    }
+    last->UnLinkSingleTo(out);
+
+    // link to new node
+    inputs[0]->LinkTo(node_tmp);
+    inputs[1]->LinkTo(node_tmp);
+    bias->LinkTo(node_tmp);
+    if (residual_add) {
+      residual->LinkTo(node_tmp);
+    }
+    node_tmp->LinkTo(out);
+    out->source_node.Reset(node_tmp);
+
+    for (auto* node_data : dropped_datas) {
+      graph_->DropNode(node_data);
+    }
+    graph_->DropNode(matmul_out);
+    graph_->DropNode(matmul);
+    if (broadcast) {
+      graph_->DropNode(add_input);
+      graph_->DropNode(broadcast);
+    }
+    for (auto* node : chain) {
+      graph_->DropNode(node);
+    }
+  }
+
+  Graph* graph_;
+  const absl::flat_hash_map<std::string, common::Type>& type_dict_;
+};
+
+void CublasLtEpiloguePassInternal(Graph* graph) {
+  VLOG(3) << "CublasLtEpiloguePass...!";
+  CublasLtEpilogueHelper cublaslt_epilogue_helper(graph);
+  cublaslt_epilogue_helper();
+  VLOG(3) << "CublasLtEpiloguePass Finish...!";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(CublasLtEpiloguePass) {
+  CINN_REGISTER_PASS(CublasLtEpiloguePass)
+      .describe(
+          "This pass fuses the bias add, residual add and relu after a matmul custom_call into one cublasLtMatmul with "
+          "the epilogue, it should be applied after TransToCustomCallPass")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::CublasLtEpiloguePassInternal);
+  return true;
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+int GetSize(std::vector<int>& shape) { return std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>()); }
+
+std::vector<float> RunGraph(std::shared_ptr<hlir::framework::Graph> graph,
+                            const std::vector<Variable>& inputs,
+                            const std::vector<std::vector<float>>& inputs_data,
+                            const std::string& fetch_id) {
+  auto target = common::DefaultNVGPUTarget();
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+
+  for (int idx = 0; idx < inputs.size(); ++idx) {
+    scope->Var<hlir::framework::Tensor>(inputs[idx]->id);
+    auto tensor = scope->GetTensor(inputs[idx]->id);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(inputs_data[idx], tensor, target);
+  }
+  run_program->Execute();
+
+  auto tensor = scope->GetTensor(fetch_id);
+  std::vector<float> data(tensor->shape().numel());
+  CopyToVector(tensor, &data);
+  return data;
+}
+
+int CountCublasLtNodes(const hlir::framework::Graph& graph) {
+  int count = 0;
+  for (auto* node : std::get<0>(graph.topological_order())) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node && op_node->attrs.attr_store.count("custom_call") &&
+        absl::get<std::string>(op_node->attrs.attr_store.at("custom_call")) == "cinn_call_cublaslt_matmul") {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void RunModelTest(Program& program, const std::vector<Variable>&& inputs, const std::string& fetch_id) {
+  // init input data.
+  std::vector<std::vector<float>> inputs_data;
+  for (auto input : inputs) {
+    inputs_data.emplace_back(GetSize(input->shape));
+    InitRandomVector<float>(&inputs_data.back(), inputs_data.back().size(), -1.0f, 1.0f, 1e-3);
+  }
+
+  auto target = common::DefaultNVGPUTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  auto expected = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  graph = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  hlir::framework::ApplyPass(graph.get(), "TransToCustomCallPass");
+  hlir::framework::ApplyPass(graph.get(), "CublasLtEpiloguePass");
+  ASSERT_EQ(CountCublasLtNodes(*graph), 1);
+  auto actual = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  CheckOutput<float>(expected, actual, 1e-8, 1e-4);
+}
+
+TEST(CublasLtEpiloguePass, Matmul_Bias) {
+  int m = 128, k = 64, n = 256;
+  NetBuilder net_builder("Matmul_Bias");
+  auto A    = net_builder.CreateInput(Float(32), {m, k}, "A");
+  auto B    = net_builder.CreateInput(Float(32), {k, n}, "B");
+  auto bias = net_builder.CreateInput(Float(32), {n}, "bias");
+  auto C    = net_builder.Matmul(A, B);
+  auto D    = net_builder.Add(C, net_builder.BroadcastTo(bias, {m, n}, {1}));
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {A, B, bias}, D->id);
+}
+
+TEST(CublasLtEpiloguePass, Matmul_Trans_Bias_Relu) {
+  int m = 128, k = 64, n = 256;
+  NetBuilder net_builder("Matmul_Trans_Bias_Relu");
+  auto A    = net_builder.CreateInput(Float(32), {k, m}, "A");
+  auto B    = net_builder.CreateInput(Float(32), {n, k}, "B");
+  auto bias = net_builder.CreateInput(Float(32), {n}, "bias");
+  auto C    = net_builder.Matmul(A, B, true, true);
+  auto D    = net_builder.Add(C, net_builder.BroadcastTo(bias, {m, n}, {1}));
+  auto E    = net_builder.Relu(D);
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {A, B, bias}, E->id);
+}
+
+TEST(CublasLtEpiloguePass, Matmul_Bias_Residual_Relu) {
+  int m = 128, k = 64, n = 256;
+  NetBuilder net_builder("Matmul_Bias_Residual_Relu");
+  auto A        = net_builder.CreateInput(Float(32), {m, k}, "A");
+  auto B        = net_builder.CreateInput(Float(32), {k, n}, "B");
+  auto bias     = net_builder.CreateInput(Float(32), {n}, "bias");
+  auto residual = net_builder.CreateInput(Float(32), {m, n}, "residual");
+  auto C        = net_builder.Matmul(A, B);
+  auto D        = net_builder.Add(C, net_builder.BroadcastTo(bias, {m, n}, {1}));
+  auto E        = net_builder.Add(residual, D);
+  auto F        = net_builder.Relu(E);
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {A, B, bias, residual}, F->id);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -15,9 +15,11 @@
 #include "cinn/common/type.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/op/external_api_registry.h"
+#include "cinn/hlir/pass/custom_call_selection.h"
 #include "cinn/utils/string.h"
 
 DECLARE_string(cinn_custom_call_deny_ops);
+DECLARE_bool(cinn_custom_call_autotune);
 
 namespace cinn {
 namespace hlir {
@@ -26,7 +28,6 @@ namespace pass {
 using cinn::hlir::op::ExternalApiRegistry;
 using framework::Graph;
 using framework::Node;
-using framework::NodeData;
 
 class GraphAlterHelper {
  public:
@@ -42,8 +43,13 @@ class GraphAlterHelper {
       if (graph_node->safe_as<Node>()) {
         auto node      = graph_node->safe_as<Node>();
         auto&& op_name = node->op()->name;
-        // a op with external_api registered and not excluded explicitly will be selected
-        if (!IsExcluded(op_name) && ExternalApiRegistry::Global()->Has(op_name, target)) {
+        // a op with external_api registered, accepted by its filter and not excluded explicitly will be selected
+        if (!IsExcluded(op_name) && ExternalApiRegistry::Global()->Has(node, graph_, target)) {
+          // the generated kernel is kept if it runs faster on the device
+          if (FLAGS_cinn_custom_call_autotune && !CustomCallSelector::Global()->UseCustomCall(node, graph_, target)) {
+            VLOG(4) << "Op:" << op_name << " will use the generated kernel, which runs faster than custom_call";
+            return false;
+          }
           VLOG(4) << "Op:" << op_name << " will use custom_call";
           return true;
         }
@@ -53,22 +59,7 @@ class GraphAlterHelper {
     });
 
     for (auto* graph_node : mark_nodes) {
-      auto* node = graph_node->safe_as<Node>();
-      // revise the output edges for conv2d because the compute implement of
-      // codegen-registered is not consistent with cudnn
-      if ((node->op()->name == "conv2d" || node->op()->name == "depthwise_conv2d") &&
-          target == common::DefaultNVGPUTarget()) {
-        auto out_links = node->outlinks_in_order();
-        for (int idx = 1; idx < out_links.size(); ++idx) {
-          auto link = out_links[idx];
-          CHECK(link->sink()->safe_as<NodeData>());
-          node->UnLinkSingleTo(link->sink());
-          graph_->DropNode(link->sink());
-        }
-      }
-
-      node->attrs.attr_store["original_op"] = node->op()->name;
-      node->attrs.op                        = framework::Operator::Get("custom_call");
+      ReplaceWithCustomCall(graph_, graph_node->safe_as<Node>(), target);
     }
   }
 
@@ -0,0 +1,207 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pass/custom_call_selection.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/backends/cuda_util.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_string(cinn_custom_call_selection_file);
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+void ReplaceWithCustomCall(Graph* graph, Node* node, const common::Target& target) {
+  // revise the output edges for conv2d because the compute implement of
+  // codegen-registered is not consistent with cudnn
+  if ((node->op()->name == "conv2d" || node->op()->name == "depthwise_conv2d") &&
+      target.is_gpu()) {
+    auto out_links = node->outlinks_in_order();
+    for (int idx = 1; idx < out_links.size(); ++idx) {
+      auto link = out_links[idx];
+      CHECK(link->sink()->safe_as<NodeData>());
+      node->UnLinkSingleTo(link->sink());
+      graph->DropNode(link->sink());
+    }
+  }
+
+  node->attrs.attr_store["original_op"] = node->op()->name;
+  node->attrs.op                        = framework::Operator::Get("custom_call");
+}
+
+CustomCallSelector* CustomCallSelector::Global() {
+  static CustomCallSelector selector(FLAGS_cinn_custom_call_selection_file);
+  return &selector;
+}
+
+CustomCallSelector::CustomCallSelector(const std::string& file_path) : file_path_(file_path) { LoadChoices(); }
+
+std::string CustomCallSelector::Key(const Node* node, const Graph* graph, const common::Target& target) {
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
+  const auto& dtype_dict = graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  std::ostringstream os;
+  os << target.arch_str();
+  if (target.arch == common::Target::Arch::NVGPU) {
+    os << "_sm" << target.get_compute_capability();
+  }
+  os << " " << node->op()->name << "(";
+  for (auto& link : node->inlinks_in_order()) {
+    auto* data = link->source()->safe_as<NodeData>();
+    CHECK(data);
+    os << common::Type2Str(dtype_dict.at(data->id())) << "[" << utils::Join(shape_dict.at(data->id()), ",") << "] ";
+  }
+  os << ")";
+  // the attributes are sorted since the order of a hash map is not stable
+  std::vector<std::pair<std::string, std::string>> attrs;
+  for (auto& attr : node->attrs.attr_store) {
+    attrs.emplace_back(attr.first, utils::Attribute2String(attr.second));
+  }
+  std::sort(attrs.begin(), attrs.end());
+  for (auto& attr : attrs) {
+    os << " " << attr.first << "=" << attr.second;
+  }
+  std::string key = os.str();
+  std::replace(key.begin(), key.end(), '\n', ' ');
+  return key;
+}
+
+bool CustomCallSelector::UseCustomCall(const Node* node, const Graph* graph, const common::Target& target) {
+  std::string key = Key(node, graph, target);
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = choices_.find(key);
+  if (it != choices_.end()) {
+    return it->second.use_custom_call;
+  }
+  Choice choice;
+  choice.library_ms      = Measure(node, graph, target, true);
+  choice.codegen_ms      = Measure(node, graph, target, false);
+  choice.use_custom_call = choice.library_ms <= choice.codegen_ms;
+  VLOG(3) << "Select " << (choice.use_custom_call ? "custom_call" : "the generated kernel") << " for " << key
+          << ", library: " << choice.library_ms << " ms, codegen: " << choice.codegen_ms << " ms";
+  choices_.emplace(key, choice);
+  SaveChoice(key, choice);
+  return choice.use_custom_call;
+}
+
+double CustomCallSelector::Measure(const Node* node,
+                                   const Graph* graph,
+                                   const common::Target& target,
+                                   bool use_custom_call) {
+  constexpr int kWarmupRuns = 3;
+  constexpr int kRuns       = 20;
+  const auto& shape_dict    = graph->GetAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
+  const auto& dtype_dict    = graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+
+  // rebuild the op alone with the same inputs and attributes
+  frontend::NetBuilder builder("custom_call_selection");
+  std::vector<frontend::Variable> inputs;
+  for (auto& link : node->inlinks_in_order()) {
+    auto* data = link->source()->safe_as<NodeData>();
+    inputs.emplace_back(frontend::Placeholder(dtype_dict.at(data->id()), shape_dict.at(data->id()), data->id()));
+  }
+  auto outputs = builder.CustomInstr(node->op()->name, inputs, node->attrs.attr_store);
+  auto program = builder.Build();
+  auto op_graph = std::make_shared<Graph>(program, std::unordered_set<std::string>{outputs.front()->id}, target);
+  if (use_custom_call) {
+    for (auto* graph_node : op_graph->CollectNodes(
+             [](const common::GraphNode* graph_node) { return graph_node->safe_as<Node>() != nullptr; })) {
+      ReplaceWithCustomCall(op_graph.get(), graph_node->safe_as<Node>(), target);
+    }
+  }
+  framework::ApplyPasses(op_graph.get(), {"OpFusionPass", "FusionMergePass"});
+
+  auto scope = framework::BuildScope(target, op_graph);
+  framework::GraphCompiler compiler(target, scope, op_graph);
+  auto runtime_program = compiler.Build();
+
+  auto synchronize = [&target]() {
+#ifdef CINN_WITH_CUDA
+    if (target.arch == common::Target::Arch::NVGPU) {
+      CUDA_CALL(cudaDeviceSynchronize());
+    }
+#endif
+  };
+  // the warmup runs load the kernels and let the library choose its algorithm
+  for (int i = 0; i < kWarmupRuns; ++i) {
+    runtime_program->Execute();
+  }
+  synchronize();
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < kRuns; ++i) {
+    runtime_program->Execute();
+  }
+  synchronize();
+  return timer.Stop() / kRuns;
+}
+
+void CustomCallSelector::LoadChoices() {
+  if (file_path_.empty()) {
+    return;
+  }
+  std::ifstream ifs(file_path_);
+  std::string line;
+  // a line is "use_custom_call library_ms codegen_ms key", the last line of a key wins
+  while (std::getline(ifs, line)) {
+    std::istringstream is(line);
+    Choice choice;
+    std::string key;
+    bool parsed = static_cast<bool>(is >> choice.use_custom_call >> choice.library_ms >> choice.codegen_ms) &&
+                  static_cast<bool>(std::getline(is >> std::ws, key));
+    if (!parsed || key.empty()) {
+      LOG(WARNING) << "Skip the broken line of " << file_path_ << ": " << line;
+      continue;
+    }
+    choices_[key] = choice;
+  }
+  VLOG(3) << "Loaded " << choices_.size() << " custom_call choices from " << file_path_;
+}
+
+void CustomCallSelector::SaveChoice(const std::string& key, const Choice& choice) {
+  if (file_path_.empty()) {
+    return;
+  }
+  std::ofstream ofs(file_path_, std::ios::app);
+  if (!ofs.is_open()) {
+    LOG(WARNING) << "Failed to open " << file_path_ << " to save the custom_call choice";
+    return;
+  }
+  ofs << choice.use_custom_call << " " << choice.library_ms << " " << choice.codegen_ms << " " << key << "\n";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
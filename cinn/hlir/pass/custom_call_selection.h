@@ -0,0 +1,73 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+// Replace the op of node by custom_call, which calls the external api registered for it.
+void ReplaceWithCustomCall(framework::Graph* graph, framework::Node* node, const common::Target& target);
+
+/**
+ * CustomCallSelector chooses between the external library call and the generated kernel of an op by timing both on
+ * the target device, since the generated kernel often runs faster for the odd shapes. Each op is timed by a graph of
+ * it alone, so the choice is made per op, shape, dtype and attributes. The choices are kept for the process and
+ * appended to the file of FLAGS_cinn_custom_call_selection_file if given, so a shape is timed once across the runs.
+ */
+class CustomCallSelector {
+ public:
+  static CustomCallSelector* Global();
+
+  //! Whether the custom_call of node runs faster, it is timed against the generated kernel if not chosen yet.
+  bool UseCustomCall(const framework::Node* node, const framework::Graph* graph, const common::Target& target);
+
+  //! The key of the choice, made of the device, the op, the dtypes and shapes of its inputs and its attributes.
+  static std::string Key(const framework::Node* node, const framework::Graph* graph, const common::Target& target);
+
+ private:
+  struct Choice {
+    bool use_custom_call{true};
+    double library_ms{0.};
+    double codegen_ms{0.};
+  };
+
+  explicit CustomCallSelector(const std::string& file_path);
+
+  // The average time in ms of running node alone, by custom_call or by the generated kernel
+  double Measure(const framework::Node* node,
+                 const framework::Graph* graph,
+                 const common::Target& target,
+                 bool use_custom_call);
+
+  void LoadChoices();
+  void SaveChoice(const std::string& key, const Choice& choice);
+
+  const std::string file_path_;
+  std::mutex mtx_;
+  std::unordered_map<std::string, Choice> choices_;
+};
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
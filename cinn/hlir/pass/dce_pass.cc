@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <queue>
+#include <unordered_set>
 
 #include "cinn/common/type.h"
 #include "cinn/hlir/pass/op_fusion_pass_util.h"
@@ -81,6 +82,8 @@ class DceHelper : public FusionHelperBase {
       all_nodes_list.push_back(node->safe_as<Node>());
     }
 
+    // the dead nodes are dropped together, rather than searched in the graph one by one
+    std::unordered_set<GraphNode*> dead_nodes;
     for (auto node : all_nodes_list) {
       if (nodes_set_.count(node)) {
         continue;
@@ -104,12 +107,13 @@ class DceHelper : public FusionHelperBase {
           ndata->UnLinkAllTo(dest);
         }
         VLOG(1) << "Drop : " << ndata->id();
-        graph_->DropNode(ndata);
+        dead_nodes.insert(ndata);
       }
 
       VLOG(1) << "Drop : " << node->id();
-      graph_->DropNode(node);
+      dead_nodes.insert(node);
     }
+    graph_->DropNodes(dead_nodes);
   }
 
   framework::Graph* graph_;
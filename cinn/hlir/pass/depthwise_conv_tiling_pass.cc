@@ -0,0 +1,263 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+#include "cinn/hlir/pass/infershape.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+// DepthwiseConvTiling Pass: lower the NCHW depthwise_conv2d left by TransToCustomCallPass, whose filter is 3x3 or 5x5
+// and whose stride is 1 or 2, to the register-tiled kernel, and fuse the bias add and the activation after it.
+// B = depthwise_conv2d(A, W)
+// C = elementwise_add(B, broadcast_to(bias))
+// D = relu(C)  // or relu6
+// after
+// D = fused_depthwise_conv2d(A, W, bias)
+// The depthwise convolution is memory-bound, so its output is written once after the epilogue instead of read back by
+// the following element-wise kernel.
+class DepthwiseConvTilingHelper : public FusionHelperBase {
+ public:
+  DepthwiseConvTilingHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        graph_(graph),
+        type_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype")),
+        mutable_shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape")) {}
+
+  void operator()() {
+    auto conv_nodes = graph_->CollectNodes([](const common::GraphNode* graph_node) -> bool {
+      auto node = graph_node->safe_as<Node>();
+      return node && node->op()->name == "depthwise_conv2d";
+    });
+    for (auto* graph_node : conv_nodes) {
+      auto* conv = graph_node->safe_as<Node>();
+      if (CanRewrite(conv)) {
+        Rewrite(conv);
+      }
+    }
+  }
+
+ private:
+  template <typename T>
+  static T GetAttr(const Node* node, const std::string& name, const T& default_value) {
+    const auto& attr_store = node->attrs.attr_store;
+    return attr_store.count(name) ? absl::get<T>(attr_store.at(name)) : default_value;
+  }
+
+  bool IsGraphOutput(const NodeData* node_data) const {
+    return std::find(graph_->outputs.begin(), graph_->outputs.end(), node_data) != graph_->outputs.end();
+  }
+
+  bool CanRewrite(const Node* conv) const {
+    auto stride = GetAttr<std::vector<int>>(conv, "stride", {1, 1});
+    if (GetAttr<std::string>(conv, "data_format", "NCHW") != "NCHW" ||
+        GetAttr<std::string>(conv, "conv_type", "forward") != "forward" ||
+        GetAttr<std::vector<int>>(conv, "dilation", {1, 1}) != std::vector<int>{1, 1} ||
+        GetAttr<std::vector<int>>(conv, "padding", {0, 0}).size() != 2U || stride.size() != 2U) {
+      return false;
+    }
+    auto inputs = GetProducerNodeData(conv);
+    if (inputs.size() != 2U || inputs[0] == inputs[1]) {
+      return false;
+    }
+    // the outputs after the first one are the intermediate tensors of the codegen on x86
+    auto outputs = GetNodeDatas(conv);
+    for (int i = 1; i < outputs.size(); ++i) {
+      if (!outputs[i]->outlinks().empty() || IsGraphOutput(outputs[i])) {
+        return false;
+      }
+    }
+    const auto& x_shape = shape_dict_.at(inputs[0]->id());
+    const auto& w_shape = shape_dict_.at(inputs[1]->id());
+    return x_shape.size() == 4U && w_shape.size() == 4U && x_shape[1] == w_shape[0] &&
+           pe::IsTiledDepthwiseConv(w_shape[2], w_shape[3], stride[0], stride[1]);
+  }
+
+  // Return the only consumer of the node's first output if its name is op_name, otherwise return nullptr.
+  Node* GetSingleConsumer(const Node* node, const std::string& op_name) const {
+    auto* output = GetNodeDatas(node)[0];
+    if (IsGraphOutput(output) || output->outlinks().size() != 1) {
+      return nullptr;
+    }
+    auto* consumer = (*output->outlinks().begin())->sink()->safe_as<Node>();
+    return consumer && consumer->op()->name == op_name ? consumer : nullptr;
+  }
+
+  // Return the bias vector of shape [c] added to the channels of the output, which is either added on the axis 1 or
+  // broadcast by broadcast_to. The broadcast_to node is returned by broadcast_node if exists.
+  NodeData* GetBias(const Node* add, const NodeData* conv_out, const shape_t& out_shape, Node** broadcast_node) const {
+    auto add_inputs = GetProducerNodeData(add);
+    if (add_inputs.size() != 2 || add_inputs[0] != conv_out || add_inputs[1] == conv_out) {
+      return nullptr;
+    }
+    auto* bias     = add_inputs[1];
+    auto* producer = bias->source_node.get();
+    if (producer && producer->op()->name == "broadcast_to") {
+      if (IsGraphOutput(bias) || bias->outlinks().size() != 1 ||
+          GetAttr<std::vector<int>>(producer, "broadcast_axes", {}) != std::vector<int>{1}) {
+        return nullptr;
+      }
+      *broadcast_node = producer;
+      bias            = GetProducerNodeData(producer)[0];
+    } else if (GetAttr<int>(add, "axis", -1) != 1) {
+      return nullptr;
+    }
+    if (shape_dict_.at(bias->id()) != shape_t{out_shape[1]}) {
+      *broadcast_node = nullptr;
+      return nullptr;
+    }
+    return bias;
+  }
+
+  void Rewrite(Node* conv) {
+    auto inputs           = GetProducerNodeData(conv);
+    auto* x               = inputs[0];
+    auto* filter          = inputs[1];
+    auto conv_outputs     = GetNodeDatas(conv);
+    auto* conv_out        = conv_outputs[0];
+    const auto& out_shape = shape_dict_.at(conv_out->id());
+    auto out_type         = type_dict_.at(conv_out->id());
+
+    // the nodes fused after the depthwise_conv2d in order, the output of each one is only consumed by the next one
+    std::vector<Node*> chain;
+    Node* broadcast = nullptr;
+    NodeData* bias  = nullptr;
+    auto* bias_add  = GetSingleConsumer(conv, "elementwise_add");
+    if (bias_add) {
+      bias = GetBias(bias_add, conv_out, out_shape, &broadcast);
+    }
+    // an input of the fused_depthwise_conv2d can't be linked twice
+    if (bias && type_dict_.at(bias->id()) == out_type && bias != x && bias != filter) {
+      chain.push_back(bias_add);
+    } else {
+      bias      = nullptr;
+      broadcast = nullptr;
+    }
+    std::string activation;
+    for (auto op_name : {"relu", "relu6"}) {
+      auto* act = GetSingleConsumer(chain.empty() ? conv : chain.back(), op_name);
+      if (act) {
+        chain.push_back(act);
+        activation = op_name;
+        break;
+      }
+    }
+    auto* out            = chain.empty() ? conv_out : GetNodeData(chain.back());
+    std::string epilogue = std::string(bias ? "bias" : "") + (bias && !activation.empty() ? "_" : "") + activation;
+    VLOG(4) << "Rewrite " << conv->id() << " to the tiled depthwise conv with the epilogue " << epilogue << " of "
+            << chain.size() << " nodes";
+
+    // unlink the rewritten nodes
+    x->UnLinkSingleTo(conv);
+    filter->UnLinkSingleTo(conv);
+    for (auto* conv_output : conv_outputs) {
+      conv->UnLinkSingleTo(conv_output);
+    }
+    std::vector<NodeData*> dropped_datas;
+    NodeData* producer_out = conv_out;
+    for (auto* node : chain) {
+      producer_out->UnLinkSingleTo(node);
+      if (producer_out != conv_out) {
+        dropped_datas.push_back(producer_out);
+      }
+      producer_out = GetNodeData(node);
+      node->UnLinkSingleTo(producer_out);
+    }
+    NodeData* bias_arg = nullptr;
+    if (bias) {
+      bias_arg = GetProducerNodeData(bias_add)[1];
+      bias_arg->UnLinkSingleTo(bias_add);
+      if (broadcast) {
+        bias->UnLinkSingleTo(broadcast);
+        broadcast->UnLinkSingleTo(bias_arg);
+      }
+    }
+
+    auto* fused = new Node(framework::Operator::Get("fused_depthwise_conv2d"),
+                           "fused_depthwise_conv2d",
+                           common::UniqName("fused_depthwise_conv2d"));
+    graph_->RegisterNode(fused->id(), fused);
+    fused->attrs.attr_store["padding"]  = GetAttr<std::vector<int>>(conv, "padding", {0, 0});
+    fused->attrs.attr_store["stride"]   = GetAttr<std::vector<int>>(conv, "stride", {1, 1});
+    fused->attrs.attr_store["epilogue"] = epilogue;
+    x->LinkTo(fused);
+    filter->LinkTo(fused);
+    if (bias) {
+      bias->LinkTo(fused);
+    }
+    fused->LinkTo(out);
+    out->source_node.Reset(fused);
+    InferShape(fused, type_dict_, mutable_shape_dict_);
+    CHECK(shape_dict_.at(out->id()) == out_shape) << "The output shape of " << fused->id() << " is changed!";
+
+    for (auto* node_data : dropped_datas) {
+      graph_->DropNode(node_data);
+    }
+    for (auto* conv_output : conv_outputs) {
+      if (conv_output != out) {
+        graph_->DropNode(conv_output);
+      }
+    }
+    graph_->DropNode(conv);
+    if (broadcast) {
+      graph_->DropNode(bias_arg);
+      graph_->DropNode(broadcast);
+    }
+    for (auto* node : chain) {
+      graph_->DropNode(node);
+    }
+  }
+
+  Graph* graph_;
+  absl::flat_hash_map<std::string, common::Type>& type_dict_;
+  absl::flat_hash_map<std::string, shape_t>& mutable_shape_dict_;
+};
+
+void DepthwiseConvTilingPassInternal(Graph* graph) {
+  if (graph->target_.arch != common::Target::Arch::NVGPU) {
+    return;
+  }
+  VLOG(3) << "DepthwiseConvTilingPass...!";
+  DepthwiseConvTilingHelper depthwise_conv_tiling_helper(graph);
+  depthwise_conv_tiling_helper();
+  VLOG(3) << "DepthwiseConvTilingPass Finish...!";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(DepthwiseConvTilingPass) {
+  CINN_REGISTER_PASS(DepthwiseConvTilingPass)
+      .describe(
+          "This pass rewrites the NCHW depthwise_conv2d with a 3x3 or 5x5 filter and a stride of 1 or 2 to the "
+          "register-tiled kernel, and fuses the bias add and relu/relu6 after it, it should be applied after "
+          "TransToCustomCallPass")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::DepthwiseConvTilingPassInternal);
+  return true;
+}
@@ -12,11 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
 #include "cinn/common/graph_utils.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/pass/infershape.h"
 
+DECLARE_bool(cinn_use_grouped_gemm);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -412,6 +419,128 @@ class DotMergerPass {
   }
 };
 
+// Merge the independent dots of the same shape, like the projections of the heads or the experts, into one
+// `cinn_call_batched_cublas` custom call, whose inputs are [A0, A1, ..., B0, B1, ...] and outputs are [C0, C1, ...].
+class GroupedDotMergerPass {
+ public:
+  static int Apply(framework::Graph* graph, const std::string& dot_type) {
+    auto& dtype_dict = graph->GetMutableAttrs<dtype_dict_t>("inferdtype");
+    auto& shape_dict = graph->GetMutableAttrs<shape_dict_t>("infershape");
+
+    // The dots of the same depth can't reach each other, so they are grouped by the depth and the signature.
+    std::map<std::string, std::vector<Node*>> groups;
+    std::unordered_map<Node*, int> depths;
+    for (auto* n : std::get<0>(graph->topological_order())) {
+      auto* op_node = n->safe_as<Node>();
+      if (!op_node) {
+        continue;
+      }
+      int depth = 0;
+      for (auto& edge : op_node->inlinks()) {
+        auto* var_node = edge->source()->safe_as<NodeData>();
+        if (var_node && var_node->source_node.get() && depths.count(var_node->source_node.get())) {
+          depth = std::max(depth, depths.at(var_node->source_node.get()) + 1);
+        }
+      }
+      depths[op_node] = depth;
+      if (op_node->op()->name == dot_type && is_candidate(op_node, shape_dict)) {
+        groups[std::to_string(depth) + "|" + GenSign(op_node, dtype_dict, shape_dict)].push_back(op_node);
+      }
+    }
+
+    int cnt{};
+    for (auto& group : groups) {
+      // A dot can't appear twice in the inputs of the custom call, so the dots reading the same var are left.
+      std::vector<Node*> dots;
+      std::unordered_set<NodeData*> used_inputs;
+      for (auto* dot : group.second) {
+        auto* lhs = input_operand(dot, 0);
+        auto* rhs = input_operand(dot, 1);
+        if (lhs != rhs && !used_inputs.count(lhs) && !used_inputs.count(rhs)) {
+          used_inputs.insert({lhs, rhs});
+          dots.push_back(dot);
+        }
+      }
+      if (!is_profitable(dots, shape_dict)) {
+        continue;
+      }
+      VLOG(3) << "Merge " << dots.size() << " independent `" << dot_type << "` into one grouped gemm.";
+      MergeDots(graph, dots);
+      cnt += 1;
+    }
+    return cnt;
+  }
+
+ private:
+  // A merged call saves a launch for every dot but one, and costs a copy of the pointer arrays and a sync of the
+  // stream, which is about as much as a few launches. The large dots keep their own gemm, which is tuned for the
+  // shape better than the batched one, while their launches are hidden by the compute.
+  static constexpr size_t kMinGroupedDots       = 4;
+  static constexpr int64_t kMaxGroupedGemmFlops = 1LL << 27;
+
+  static bool is_candidate(Node* dot, const shape_dict_t& shape_dict) {
+    if (dot->inlinks().size() != 2 || dot->outlinks().size() != 1) {
+      return false;
+    }
+    for (int idx = 0; idx < 2; ++idx) {
+      auto rank = shape_dict.at(input_operand(dot, idx)->id()).size();
+      if (rank < 2 || rank > 4) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static std::string GenSign(Node* dot, const dtype_dict_t& dtype_dict, const shape_dict_t& shape_dict) {
+    std::stringstream ss;
+    ss << get_attr<bool>(dot, "trans_a", false) << get_attr<bool>(dot, "trans_b", false)
+       << get_attr<bool>(dot, "trans_out", false) << "|" << get_attr<float>(dot, "alpha", 1.f) << "|"
+       << dtype_dict.at(output_operand(dot, 0)->id());
+    for (int idx = 0; idx < 2; ++idx) {
+      ss << "|";
+      for (auto dim : shape_dict.at(input_operand(dot, idx)->id())) {
+        ss << dim << ",";
+      }
+    }
+    return ss.str();
+  }
+
+  static bool is_profitable(const std::vector<Node*>& dots, const shape_dict_t& shape_dict) {
+    if (dots.size() < kMinGroupedDots) {
+      return false;
+    }
+    // 2 * M * N * K flops, with the batch dimensions folded into the output
+    const auto& out_shape = shape_dict.at(output_operand(dots[0], 0)->id());
+    const auto& a_shape   = shape_dict.at(input_operand(dots[0], 0)->id());
+    int64_t k   = get_attr<bool>(dots[0], "trans_a", false) ? a_shape[a_shape.size() - 2] : a_shape.back();
+    int64_t mnk = k;
+    for (auto dim : out_shape) {
+      mnk *= dim;
+    }
+    return 2 * mnk <= kMaxGroupedGemmFlops;
+  }
+
+  static void MergeDots(framework::Graph* graph, const std::vector<Node*>& dots) {
+    Node* grouped = new Node(Operator::Get("custom_call"), "custom_call", common::UniqName("custom_call"));
+    graph->RegisterNode(grouped->id(), grouped);
+    grouped->attrs.attr_store                = dots[0]->attrs.attr_store;
+    grouped->attrs.attr_store["side"]        = std::string("grouped");
+    grouped->attrs.attr_store["custom_call"] = std::string("cinn_call_batched_cublas");
+
+    for (int idx = 0; idx < 2; ++idx) {
+      for (auto* dot : dots) {
+        input_operand(dot, idx)->LinkTo(grouped);
+      }
+    }
+    for (auto* dot : dots) {
+      auto* output = output_operand(dot, 0);
+      grouped->LinkTo(output);
+      output->source_node.Reset(grouped);
+      remove_node(graph, dot);
+    }
+  }
+};
+
 }  // namespace
 
 void DotMergerPassFunc(framework::Graph* graph) {
@@ -419,6 +548,10 @@ void DotMergerPassFunc(framework::Graph* graph) {
   for (auto& dot_type : {"matmul", "cublas_matmul"}) {
     int n = DotMergerPass::Apply(graph, dot_type);
     VLOG(3) << "The fusion of `" << dot_type << "` was performed " << n << " times.";
+    if (FLAGS_cinn_use_grouped_gemm && graph->target_.arch == common::Target::Arch::NVGPU) {
+      n = GroupedDotMergerPass::Apply(graph, dot_type);
+      VLOG(3) << "The grouping of `" << dot_type << "` was performed " << n << " times.";
+    }
   }
 }
 
@@ -16,6 +16,8 @@
 
 #include "cinn/frontend/decomposer/test_helper.h"
 
+DECLARE_bool(cinn_use_grouped_gemm);
+
 namespace cinn {
 namespace frontend {
 
@@ -108,5 +110,41 @@ TEST(DotMerger, Test_dot_merger0) {
   RunModelTest(program, {A, B, C, D, E, F}, fetch_ids);
 }
 
+TEST(DotMerger, Test_grouped_dot_merger) {
+  if (common::DefaultTarget().arch != common::Target::Arch::NVGPU) {
+    return;
+  }
+  // the projections of 4 experts, which have no operand in common
+  int m = 16, k = 32, n = 8;
+  NetBuilder net_builder("Test_grouped_dot_merger");
+  std::vector<Variable> inputs;
+  std::unordered_set<std::string> fetch_ids;
+  for (int idx = 0; idx < 4; ++idx) {
+    auto x = net_builder.CreateInput(Float(32), {m, k}, "X" + std::to_string(idx));
+    auto w = net_builder.CreateInput(Float(32), {k, n}, "W" + std::to_string(idx));
+    fetch_ids.insert(net_builder.Matmul(x, w)->id);
+    inputs.push_back(x);
+    inputs.push_back(w);
+  }
+  auto program = net_builder.Build();
+
+  FLAGS_cinn_use_grouped_gemm = true;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, fetch_ids, common::DefaultTarget());
+  hlir::framework::ApplyPass(graph.get(), "DotMerger");
+  int num_custom_call = 0, num_matmul = 0;
+  for (auto& node : graph->nodes()) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node) {
+      num_custom_call += op_node->op()->name == "custom_call";
+      num_matmul += op_node->op()->name == "matmul";
+    }
+  }
+  ASSERT_EQ(num_custom_call, 1);
+  ASSERT_EQ(num_matmul, 0);
+
+  RunModelTest(program, std::move(inputs), fetch_ids);
+  FLAGS_cinn_use_grouped_gemm = false;
+}
+
 }  // namespace frontend
 }  // namespace cinn
\ No newline at end of file
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/type.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+// An analytical cost model of the fusion groups, which estimates the time of a kernel in the time to move one byte
+// from or to the global memory:
+//   cost = launch + (bytes moved + flops / flops_per_byte) / efficiency
+// The bytes are the inputs read from and the outputs written to the global memory, the flops of a reduce are its input
+// elements, and the efficiency is the ratio of the threads of the kernel to the threads filling the device, as the
+// kernel with fewer threads can't saturate the memory bandwidth. A reduce is computed by at most a block of threads on
+// a row, so it limits the threads of the kernel fused with it.
+// The gain of a fusion plan is the cost of the kernels before the fusion minus the cost of the fused ones, so fusing
+// saves the launches and the round trips of the intermediates, and loses the parallelism and adds the recomputation.
+class FusionCostModel {
+ public:
+  using GroupPtr  = std::shared_ptr<Graph::Group>;
+  using GroupList = std::vector<GroupPtr>;
+
+  FusionCostModel(const FusionHelperBase* helper, const Graph* graph) : helper_(helper), target_(graph->target_) {
+    if (graph->HasAttr("inferdtype")) {
+      type_dict_ = &graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+    }
+    if (target_.is_gpu()) {
+      int num_sm          = target_.get_multi_processor_count();
+      int threads_per_sm  = target_.get_max_threads_per_sm();
+      full_threads_       = (num_sm > 0 ? num_sm : 80) * (threads_per_sm > 0 ? threads_per_sm : 2048);
+      launch_cost_        = 1 << 20;
+      flops_per_byte_     = 16.0;
+      max_threads_of_row_ = target_.max_num_threads();
+    } else {
+      // the host kernel is parallelized on the cores and vectorized, and launched by a function call
+      full_threads_       = std::max(target_.cpu_info().num_cores, 1) * 8;
+      launch_cost_        = 16 << 10;
+      flops_per_byte_     = 8.0;
+      max_threads_of_row_ = 8;
+    }
+  }
+
+  // The gain of fusing the producer into each of the consumers, the producer is recomputed in every fused group, and
+  // its outputs consumed by the others are written once.
+  double VerticalFusionGain(const GroupPtr& producer, const GroupList& consumers) const {
+    auto producer_nodes = producer->NodeSet();
+    double before       = KernelCost(producer_nodes, {});
+    double after        = 0.0;
+    std::unordered_set<Node*> scope(producer_nodes.begin(), producer_nodes.end());
+    for (auto& consumer : consumers) {
+      auto consumer_nodes = consumer->NodeSet();
+      before += KernelCost(consumer_nodes, {});
+      scope.insert(consumer_nodes.begin(), consumer_nodes.end());
+    }
+    for (auto& consumer : consumers) {
+      auto fused_nodes = consumer->NodeSet();
+      fused_nodes.insert(producer_nodes.begin(), producer_nodes.end());
+      after += KernelCost(fused_nodes, producer_nodes);
+    }
+    for (auto* node : producer_nodes) {
+      if (IsWritten(node, scope)) {
+        after += OutputBytes(node);
+      }
+    }
+    VLOG(4) << "The gain of fusing " << producer->group_id << " into " << consumers.size() << " consumers is "
+            << before - after;
+    return before - after;
+  }
+
+  // The gain of fusing the groups sharing no data but the inputs into one kernel.
+  double HorizontalFusionGain(const GroupList& groups) const {
+    double before = 0.0;
+    std::unordered_set<Node*> fused_nodes;
+    for (auto& group : groups) {
+      auto nodes = group->NodeSet();
+      before += KernelCost(nodes, {});
+      fused_nodes.insert(nodes.begin(), nodes.end());
+    }
+    double after = KernelCost(fused_nodes, {});
+    VLOG(4) << "The gain of fusing " << groups.size() << " groups horizontally is " << before - after;
+    return before - after;
+  }
+
+  // The cost of a kernel computing the nodes, the outputs of the nodes in skipped_writes are not written.
+  double KernelCost(const std::unordered_set<Node*>& nodes, const std::unordered_set<Node*>& skipped_writes) const {
+    double bytes = 0.0;
+    double flops = 0.0;
+    std::unordered_set<NodeData*> inputs;
+    int64_t threads = 0;
+    int64_t limit   = -1;
+    for (auto* node : nodes) {
+      for (auto* input : helper_->GetProducerNodeData(node)) {
+        auto* source = input->source_node.get();
+        if ((!source || !nodes.count(source)) && inputs.insert(input).second) {
+          bytes += DataBytes(input);
+        }
+      }
+      if (!skipped_writes.count(node) && IsWritten(node, nodes)) {
+        bytes += OutputBytes(node);
+      }
+
+      int64_t numel = Numel(helper_->GetNodeDataShape(node));
+      threads       = std::max(threads, numel);
+      if (helper_->GetOpKind(node) == framework::kReduction) {
+        int64_t reduce_numel = Numel(helper_->GetNodeInputShape(node)) / std::max<int64_t>(numel, 1);
+        flops += numel * reduce_numel;
+        // the rows are reduced by at most a block of threads
+        int64_t row_threads = numel * std::min<int64_t>(reduce_numel, max_threads_of_row_);
+        limit               = limit < 0 ? row_threads : std::min(limit, row_threads);
+      } else {
+        flops += numel;
+      }
+    }
+    if (limit >= 0) {
+      threads = std::min(threads, limit);
+    }
+    double efficiency = std::min(1.0, std::max<double>(threads, 1) / full_threads_);
+    return launch_cost_ + (bytes + flops / flops_per_byte_) / efficiency;
+  }
+
+ private:
+  static int64_t Numel(const shape_t& shape) {
+    return std::accumulate(shape.begin(), shape.end(), int64_t(1), std::multiplies<int64_t>());
+  }
+
+  // Whether the output of the node is a graph output or consumed out of the scope.
+  bool IsWritten(const Node* node, const std::unordered_set<Node*>& scope) const {
+    if (helper_->output_nodes_set_.count(node)) {
+      return true;
+    }
+    for (auto* consumer : helper_->GetConsumerNode(node)) {
+      if (!scope.count(consumer)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  double DataBytes(const NodeData* node_data) const {
+    auto it    = helper_->shape_dict_.find(node_data->id());
+    auto numel = it == helper_->shape_dict_.end() ? 1 : Numel(it->second);
+    int bytes  = 4;
+    if (type_dict_ && type_dict_->count(node_data->id())) {
+      bytes = std::max(type_dict_->at(node_data->id()).bytes(), 1);
+    }
+    return static_cast<double>(numel) * bytes;
+  }
+
+  double OutputBytes(const Node* node) const {
+    double bytes = 0.0;
+    for (auto* output : FusionHelperBase::GetNodeDatas(node)) {
+      bytes += DataBytes(output);
+    }
+    return bytes;
+  }
+
+  const FusionHelperBase* helper_;
+  const common::Target& target_;
+  const absl::flat_hash_map<std::string, common::Type>* type_dict_{nullptr};
+  // the threads saturating the device
+  int64_t full_threads_;
+  // the launch overhead in bytes moved
+  double launch_cost_;
+  double flops_per_byte_;
+  // the max threads reducing a row
+  int64_t max_threads_of_row_;
+};
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
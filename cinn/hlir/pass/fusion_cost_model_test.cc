@@ -0,0 +1,90 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+namespace {
+using GroupPtr = std::shared_ptr<Graph::Group>;
+
+GroupPtr MakeGroup(const std::vector<Node*>& nodes) {
+  auto group       = std::make_shared<Graph::Group>();
+  group->group_id  = nodes.front()->id();
+  group->nodes     = nodes;
+  group->nodes_set = std::unordered_set<Node*>(nodes.begin(), nodes.end());
+  return group;
+}
+
+Node* FindNode(const Graph& graph, const std::string& op_name) {
+  for (auto* graph_node : std::get<0>(graph.topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (node && node->op()->name == op_name) {
+      return node;
+    }
+  }
+  LOG(FATAL) << "Can't find the node of " << op_name;
+  return nullptr;
+}
+}  // namespace
+
+TEST(FusionCostModel, FuseElementwiseChain) {
+  frontend::NetBuilder net_builder("FuseElementwiseChain");
+  auto A = net_builder.CreateInput(Float(32), {32, 32}, "A");
+  auto B = net_builder.CreateInput(Float(32), {32, 32}, "B");
+  auto C = net_builder.Relu(net_builder.Add(A, B));
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultNVGPUTarget();
+  Graph graph(program, target);
+  FusionHelperBase helper(&graph);
+  FusionCostModel cost_model(&helper, &graph);
+
+  // the fused kernel saves a launch and the round trip of the intermediate
+  auto producer = MakeGroup({FindNode(graph, "elementwise_add")});
+  auto consumer = MakeGroup({FindNode(graph, "relu")});
+  ASSERT_GT(cost_model.VerticalFusionGain(producer, {consumer}), 0);
+}
+
+TEST(FusionCostModel, KeepReduceFromBroadcast) {
+  int rows = 8, cols = 32768;
+  frontend::NetBuilder net_builder("KeepReduceFromBroadcast");
+  auto A = net_builder.CreateInput(Float(32), {rows, cols}, "A");
+  auto B = net_builder.CreateInput(Float(32), {rows, cols}, "B");
+  auto C = net_builder.ReduceSum(A, {1});
+  auto D = net_builder.Add(net_builder.BroadcastTo(C, {rows, cols}, {0}), B);
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultNVGPUTarget();
+  Graph graph(program, target);
+  FusionHelperBase helper(&graph);
+  FusionCostModel cost_model(&helper, &graph);
+
+  // the rows are reduced by 8 blocks, and the large elementwise kernel would be computed by them after the fusion
+  auto producer = MakeGroup({FindNode(graph, "reduce_sum")});
+  auto consumer = MakeGroup({FindNode(graph, "broadcast_to"), FindNode(graph, "elementwise_add")});
+  ASSERT_LT(cost_model.VerticalFusionGain(producer, {consumer}), 0);
+  ASSERT_GT(cost_model.KernelCost(consumer->NodeSet(), {}), 0);
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -21,6 +21,7 @@
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pe/reduction.h"
 #include "cinn/hlir/pass/use_pass.h"
 #include "cinn/utils/string.h"
 
@@ -35,7 +36,7 @@ class FusionHelperBase {
   FusionHelperBase(const framework::Graph* graph)
       : shape_dict_(graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape")), target_(graph->target_) {
     // get op pattern dict
-    op_pattern_dict_ = &framework::Operator::GetAttrs<OpPatternKind>("OpPattern");
+    op_pattern_dict_ = &framework::Operator::GetOpPatternAttrs();
     // output node set
     for (auto node_data : graph->outputs) {
       CHECK(node_data->source_node.get());
@@ -54,10 +55,24 @@ class FusionHelperBase {
         return framework::kElementWise;
       }
     }
+    // the grid reduce is computed and scheduled by itself in a single kernel, which can't fuse other ops.
+    if (kind == framework::kReduction && IsGridReduce(node)) {
+      return framework::kNonFusible;
+    }
 
     return kind;
   }
 
+  bool IsGridReduce(const framework::Node* node) const {
+    auto& attr_store = node->attrs.attr_store;
+    if (!attr_store.count("dim") || !absl::holds_alternative<std::vector<int>>(attr_store.at("dim")) ||
+        node->inlinks_in_order().empty()) {
+      return false;
+    }
+    auto axes = absl::get<std::vector<int>>(attr_store.at("dim"));
+    return pe::UseGridReduce(GetNodeInputShape(node), axes, target_);
+  }
+
   static bool IsConstOp(const framework::Node* node) {
     static std::unordered_set<std::string> const_op_type = {"const_scalar", "fill_constant", "arange"};
     if (const_op_type.count(node->op()->name)) {
@@ -67,6 +82,18 @@ class FusionHelperBase {
     }
   }
 
+  // The op marked pre_run by ConstPropagate only depends on the constants, and it is run once before the others, so it
+  // can't be fused with the ops run every time.
+  static bool IsPreRunOp(const framework::Node* node) {
+    auto& attr_store = node->attrs.attr_store;
+    return attr_store.count("pre_run") && absl::get<bool>(attr_store.at("pre_run"));
+  }
+
+  static bool IsPreRunGroup(const std::shared_ptr<Graph::Group>& group) {
+    auto nodes = group->CollectNodes();
+    return std::all_of(nodes.begin(), nodes.end(), [](const Node* node) { return IsPreRunOp(node); });
+  }
+
   static std::vector<NodeData*> GetNodeDatas(const Node* node) {
     std::vector<NodeData*> consumer_node_data;
     for (auto& edge : node->outlinks_in_order()) {
@@ -12,9 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <functional>
+#include <map>
+#include <numeric>
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/fusion_merge_pass_util.h"
 
 DECLARE_bool(enhance_vertical_fusion_with_recompute);
+DECLARE_bool(cinn_fuse_independent_groups);
+DECLARE_bool(cinn_fusion_cost_model);
 
 namespace cinn {
 namespace hlir {
@@ -43,8 +50,12 @@ using ConditionFunction = std::function<bool(const FusionHelperBase*, const Grou
 // code generation.
 class FusionMergePassHelper : public FusionHelperBase {
  public:
-  FusionMergePassHelper(const Graph* graph) : FusionHelperBase(graph) {
-    fusion_groups_ = graph->fusion_groups;
+  FusionMergePassHelper(const Graph* graph) : FusionMergePassHelper(graph, graph->fusion_groups) {}
+
+  // merge the given groups, such as the ones of a partition of the graph
+  FusionMergePassHelper(const Graph* graph, const GroupList& fusion_groups)
+      : FusionHelperBase(graph), cost_model_(this, graph) {
+    fusion_groups_ = fusion_groups;
     // init fusion relation.
     InitFusionRelation();
     // init input to consumers.
@@ -80,6 +91,56 @@ class FusionMergePassHelper : public FusionHelperBase {
     }
     while (DoVerticalFusion(/* recompute=*/true)) {
     }
+    if (FLAGS_cinn_fuse_independent_groups) {
+      while (DoIndependentFusion()) {
+      }
+    }
+  }
+
+  // pack the groups sharing no data into one kernel, e.g. the updates of the parameters in an optimizer step.
+  bool DoIndependentFusion() {
+    VLOG(3) << "DoIndependentFusion...!";
+    // the groups at the same level of the longest path from the inputs can't depend on each other.
+    std::unordered_map<GroupPtr, int, Hasher, Comparator> levels;
+    std::function<int(const GroupPtr&)> get_level = [&](const GroupPtr& group) {
+      auto it = levels.find(group);
+      if (it != levels.end()) {
+        return it->second;
+      }
+      int level = 0;
+      for (auto& producer : group->producer_groups) {
+        level = std::max(level, get_level(producer) + 1);
+      }
+      levels[group] = level;
+      return level;
+    };
+
+    // only the groups without reduce share the loops of a kernel freely, the reduce ones keep their own launches.
+    std::map<std::pair<int, int>, std::unordered_set<GroupPtr, Hasher, Comparator>> level_size_to_groups;
+    for (auto& group : fusion_groups_) {
+      if (group->belong_groups.size()) {
+        continue;
+      }
+      if (group->op_pattern_kind != framework::kElementWise && group->op_pattern_kind != framework::kBroadcast &&
+          group->op_pattern_kind != framework::kInjective) {
+        continue;
+      }
+      auto shape = GetNodeDataShape(*group->master_nodes.begin());
+      int size   = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+      level_size_to_groups[{get_level(group), size}].insert(group);
+    }
+
+    bool updated = false;
+    for (auto& groups : level_size_to_groups) {
+      if (groups.second.size() > 1) {
+        updated |= HorizontalFusion(nullptr, groups.second);
+      }
+    }
+
+    if (updated) {
+      UpdateFusionGroup();
+    }
+    return updated;
   }
 
   bool DoHorizontalFusion() {
@@ -213,7 +274,8 @@ class FusionMergePassHelper : public FusionHelperBase {
       auto& relation  = fusion_relation_map_[candidate->op_pattern_kind];
       for (auto& groups : fusionable_consumers) {
         auto& last = groups.back();
-        if (!relation.horizontal_relation.count(last->op_pattern_kind)) {
+        if (!relation.horizontal_relation.count(last->op_pattern_kind) ||
+            IsPreRunGroup(candidate) != IsPreRunGroup(last)) {
           continue;
         }
 
@@ -235,6 +297,10 @@ class FusionMergePassHelper : public FusionHelperBase {
     bool updated = false;
     for (auto& groups : fusionable_consumers) {
       if (groups.size() > 1) {
+        if (FLAGS_cinn_fusion_cost_model && cost_model_.HorizontalFusionGain(groups) <= 0) {
+          VLOG(4) << "Don't fuse " << groups.size() << " groups horizontally, as it costs more!";
+          continue;
+        }
         updated = true;
         HorizontalFuse(groups);
       }
@@ -397,7 +463,8 @@ class FusionMergePassHelper : public FusionHelperBase {
     for (auto& consumer : consumers) {
       VLOG(4) << "Check consuemr " << consumer->group_id << " can fuse to producer " << producer->group_id;
       // if can't fuse
-      if (!relation.vertical_relation.count(consumer->op_pattern_kind)) {
+      if (!relation.vertical_relation.count(consumer->op_pattern_kind) ||
+          IsPreRunGroup(producer) != IsPreRunGroup(consumer)) {
         VLOG(4) << "Can't fuse producer " << producer->group_id << " consumer " << consumer->group_id;
         continue;
       }
@@ -437,6 +504,9 @@ class FusionMergePassHelper : public FusionHelperBase {
       if (!recompute) {
         return false;
       } else {
+        if (FLAGS_cinn_fusion_cost_model && !IsProfitable(producer, fuse_consumers_unsafe)) {
+          return false;
+        }
         RecomputeEleGraph(producer, fuse_consumers_unsafe);
         VerticalFuse(producer, fuse_consumers_unsafe);
         return true;
@@ -446,6 +516,9 @@ class FusionMergePassHelper : public FusionHelperBase {
     if (fuse_consumers.size()) {
       SelectConsumerToFuse(producer, fuse_consumers);
     }
+    if (fuse_consumers.size() && FLAGS_cinn_fusion_cost_model && !IsProfitable(producer, fuse_consumers)) {
+      return false;
+    }
 
     // if fusionable consumers exist
     if (fuse_consumers.size()) {
@@ -633,6 +706,35 @@ class FusionMergePassHelper : public FusionHelperBase {
     }
   }
 
+  // Whether fusing the producer into the consumers costs less than running them in their own kernels.
+  bool IsProfitable(const GroupPtr& producer, const std::unordered_set<GroupPtr, Hasher, Comparator>& consumers) {
+    double gain = cost_model_.VerticalFusionGain(producer, GroupList(consumers.begin(), consumers.end()));
+    if (gain <= 0) {
+      VLOG(4) << "Don't fuse producer " << producer->group_id << " into " << consumers.size()
+              << " consumers, as it costs more!";
+      return false;
+    }
+    return true;
+  }
+
+  // Select the consumer of the max gain to fuse the producer into, the first one is selected if the gains are equal.
+  template <typename GroupContainer>
+  GroupPtr SelectConsumerByCost(const GroupPtr& producer, const GroupContainer& candidates) {
+    GroupPtr selected = *candidates.begin();
+    if (!FLAGS_cinn_fusion_cost_model) {
+      return selected;
+    }
+    double max_gain = cost_model_.VerticalFusionGain(producer, {selected});
+    for (auto& candidate : candidates) {
+      double gain = cost_model_.VerticalFusionGain(producer, {candidate});
+      if (gain > max_gain) {
+        max_gain = gain;
+        selected = candidate;
+      }
+    }
+    return selected;
+  }
+
   void RecomputeEleGraph(const GroupPtr& producer,
                          std::unordered_set<GroupPtr, Hasher, Comparator>& fusionable_consumers) {
     if (producer->op_pattern_kind != framework::kElementWise) {
@@ -711,7 +813,7 @@ class FusionMergePassHelper : public FusionHelperBase {
 
       fusionable_consumers.clear();
       if (candidates.size()) {
-        fusionable_consumers.insert(*candidates.begin());
+        fusionable_consumers.insert(SelectConsumerByCost(producer, candidates));
       }
     } else {
       std::unordered_set<GroupPtr, Hasher, Comparator> candidates;
@@ -732,7 +834,7 @@ class FusionMergePassHelper : public FusionHelperBase {
 
       fusionable_consumers.clear();
       if (candidates.size()) {
-        fusionable_consumers.insert(*candidates.begin());
+        fusionable_consumers.insert(SelectConsumerByCost(producer, candidates));
       }
     }
   }
@@ -1004,6 +1106,7 @@ class FusionMergePassHelper : public FusionHelperBase {
     std::unordered_map<framework::OpPatternKind, ConditionFunction> horizontal_relation;
   };
   std::unordered_map<framework::OpPatternKind, Relation> fusion_relation_map_;
+  FusionCostModel cost_model_;
 };
 
 void FusionMergePassInternal(Graph* graph) {
@@ -1016,6 +1119,14 @@ void FusionMergePassInternal(Graph* graph) {
   graph->fusion_groups = fusion_merge_pass_helper();
 }
 
+void FusionMergePassPartition(Graph* graph, framework::GraphPartition* partition) {
+  if (partition->fusion_groups.size() <= 1) {
+    return;
+  }
+  FusionMergePassHelper fusion_merge_pass_helper(graph, partition->fusion_groups);
+  partition->fusion_groups = fusion_merge_pass_helper();
+}
+
 }  // namespace pass
 }  // namespace hlir
 }  // namespace cinn
@@ -1026,7 +1137,10 @@ CINN_REGISTER_HELPER(FusionMergePass) {
           "Fusion Merge Pass which performs Fusion-Ops fusion, Producer Fusion-Ops are fused into Consumer Fusion-Ops "
           "with certain conditions.")
       .set_change_structure(false)
-      .set_body(cinn::hlir::pass::FusionMergePassInternal);
+      .set_body(cinn::hlir::pass::FusionMergePassInternal)
+      // the independent fusion packs the groups of different components
+      .set_partition_body(cinn::hlir::pass::FusionMergePassPartition,
+                          []() { return !FLAGS_cinn_fuse_independent_groups; });
 
   return true;
 }
@@ -179,6 +179,33 @@ TEST(FusionMergePass, ElementWise_Fusion_5) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(FusionMergePass, Independent_Fusion_0) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("Independent_Fusion_0");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E = net_builder.CreateInput(Float(32), {h * w}, "E");
+    auto F = net_builder.CreateInput(Float(32), {h * w}, "F");
+    auto G = net_builder.Add(A, B);
+    auto H = net_builder.Multiply(C, D);
+    auto I = net_builder.Subtract(E, F);
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 3);
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  CHECK_EQ(graph->fusion_groups.size(), 1);
+}
+
 TEST(FusionMergePass, Broadcast_Test_0) {
   int h = 32, w = 32;
   NetBuilder net_builder("Broadcast_Test_0");
@@ -14,6 +14,9 @@
 
 #include "cinn/hlir/pass/infershape.h"
 
+#include <unordered_set>
+#include <utility>
+
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/pass/use_pass.h"
@@ -38,8 +41,9 @@ using shape_dict_t = absl::flat_hash_map<std::string, framework::shape_t>;
 
 void InferShape(Node* node, dtype_dict_t& dtype_dict, shape_dict_t& shape_dict) {
   VLOG(3) << "Begin InferShape of node " << node->id();
-  auto op_infershape = Operator::GetAttrs<infershape_t>("infershape");
-  auto op_inferdtype = Operator::GetAttrs<inferdtype_t>("inferdtype");
+  // the attribute maps are resolved once instead of copied for every node
+  static const auto& op_infershape = Operator::GetAttrs<infershape_t>("infershape");
+  static const auto& op_inferdtype = Operator::GetAttrs<inferdtype_t>("inferdtype");
   CHECK(node) << "The node can not be nullptr.";
 
   auto product = [](const framework::shape_t& shape) {
@@ -92,8 +96,66 @@ void InferShape(Node* node, dtype_dict_t& dtype_dict, shape_dict_t& shape_dict)
   }
 }
 
+void InferShapeIncrementally(Graph* graph) {
+  auto& shape_dict = graph->GetMutableAttrs<shape_dict_t>("infershape");
+  auto& dtype_dict = graph->GetMutableAttrs<dtype_dict_t>("inferdtype");
+
+  // the dirty variables, such as the relinked or the retyped ones, are changed for their consumers
+  std::unordered_set<const common::GraphNode*> changed_nodes;
+  for (auto* dirty_node : graph->dirty_nodes()) {
+    if (dirty_node->safe_as<NodeData>()) {
+      changed_nodes.insert(dirty_node);
+    }
+  }
+  auto is_affected = [&](Node* node) {
+    if (graph->dirty_nodes().count(node)) {
+      return true;
+    }
+    for (auto& in_edge : node->inlinks()) {
+      if (changed_nodes.count(in_edge->source())) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // the ops without the infershape, such as the custom calls, keep the shapes of their outputs
+  auto& op_infershape = Operator::GetAttrs<infershape_t>("infershape");
+  int num_inferred    = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || !is_affected(node) || !op_infershape.Find(node->op())) {
+      continue;
+    }
+    std::vector<std::pair<framework::shape_t, Type>> old_outputs;
+    for (auto& out_edge : node->outlinks_in_order()) {
+      const auto& id = out_edge->sink()->id();
+      old_outputs.emplace_back(shape_dict.count(id) ? shape_dict.at(id) : framework::shape_t{},
+                               dtype_dict.count(id) ? dtype_dict.at(id) : Type());
+    }
+    InferShape(node, dtype_dict, shape_dict);
+    num_inferred++;
+
+    const auto& out_links = node->outlinks_in_order();
+    for (int i = 0; i < out_links.size(); i++) {
+      const auto& id = out_links[i]->sink()->id();
+      if (shape_dict.at(id) != old_outputs[i].first || dtype_dict.at(id) != old_outputs[i].second) {
+        changed_nodes.insert(out_links[i]->sink());
+      }
+    }
+  }
+  VLOG(3) << "Incrementally infer the shapes of " << num_inferred << " nodes from " << graph->dirty_nodes().size()
+          << " dirty nodes";
+  graph->ClearDirtyNodes();
+}
+
 void InferShapePass(Graph* graph) {
   VLOG(3) << "Begin InferShapePass";
+  // the graph already inferred is updated from the nodes rewritten by the passes since then
+  if (!graph->dirty_nodes().empty() && graph->HasAttr("infershape") && graph->HasAttr("inferdtype")) {
+    InferShapeIncrementally(graph);
+    return;
+  }
   auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
   auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
   auto store_nodes = std::get<0>(graph->topological_order());
@@ -110,6 +172,7 @@ void InferShapePass(Graph* graph) {
       InferShape(node, dtype_dict, shape_dict);
     }
   }
+  graph->ClearDirtyNodes();
 }
 
 }  // namespace pass
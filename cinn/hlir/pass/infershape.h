@@ -24,6 +24,10 @@ void InferShape(framework::Node* node,
                 absl::flat_hash_map<std::string, common::Type>& dtype_dict,
                 absl::flat_hash_map<std::string, framework::shape_t>& shape_dict);
 
+// Infer the shapes and dtypes of the dirty nodes of the graph, and propagate them to the consumers only if the output
+// shapes or dtypes are changed, so the cost scales with the rewritten part of the graph. The dirty nodes are cleared.
+void InferShapeIncrementally(framework::Graph* graph);
+
 }  // namespace pass
 }  // namespace hlir
 }  // namespace cinn
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+// MKLDNN Post-ops Pass: fuse the activation after a conv2d or matmul computed by oneDNN into the post-op of the
+// primitive.
+// B = conv2d[use_mkldnn](input, weights)
+// C = relu(B)
+// after
+// C = conv2d[use_mkldnn, post_op=relu](input, weights)
+// So the output is activated while it is still in the cache instead of being re-read by another kernel.
+
+class MkldnnPostOpsHelper : public FusionHelperBase {
+ public:
+  MkldnnPostOpsHelper(Graph* graph) : FusionHelperBase(graph), graph_(graph) {}
+
+  void operator()() {
+    if (graph_->target_.arch != common::Target::Arch::X86) {
+      return;
+    }
+    auto mark_nodes = graph_->CollectNodes([this](const common::GraphNode* graph_node) -> bool {
+      auto node = graph_node->safe_as<Node>();
+      return node && IsMkldnnNode(node);
+    });
+
+    for (auto* graph_node : mark_nodes) {
+      FusePostOp(graph_node->safe_as<Node>());
+    }
+  }
+
+ private:
+  template <typename T>
+  static T GetAttr(const Node* node, const std::string& key, const T& default_value) {
+    const auto& attr_store = node->attrs.attr_store;
+    return attr_store.count(key) ? absl::get<T>(attr_store.at(key)) : default_value;
+  }
+
+  // Whether the node is lowered to a oneDNN primitive, see the strategies of conv2d and matmul.
+  bool IsMkldnnNode(const Node* node) const {
+    if (!GetAttr<std::string>(node, "post_op", "").empty()) {
+      return false;
+    }
+    if (node->op()->name == "conv2d") {
+      return GetAttr<std::string>(node, "data_format", "NCHW") == "NCHW" &&
+             GetAttr<std::string>(node, "conv_type", "forward") == "forward" &&
+             (GetAttr<bool>(node, "use_mkldnn", false) || GetAttr<int>(node, "groups", 1) > 1);
+    }
+    if (node->op()->name == "matmul") {
+      auto inputs = GetProducerNodeData(node);
+      return GetAttr<bool>(node, "use_mkldnn", false) && !GetAttr<bool>(node, "trans_out", false) &&
+             inputs.size() == 2 && shape_dict_.at(inputs[0]->id()).size() == 2 &&
+             shape_dict_.at(inputs[1]->id()).size() == 2;
+    }
+    return false;
+  }
+
+  bool IsGraphOutput(const NodeData* node_data) const {
+    return std::find(graph_->outputs.begin(), graph_->outputs.end(), node_data) != graph_->outputs.end();
+  }
+
+  void FusePostOp(Node* node) {
+    static const std::unordered_set<std::string> post_ops = {"relu", "sigmoid", "tanh"};
+
+    auto outputs = GetNodeDatas(node);
+    if (outputs.size() != 1 || IsGraphOutput(outputs[0])) {
+      return;
+    }
+    auto consumers = GetConsumerNode(node);
+    if (consumers.size() != 1 || !post_ops.count(consumers[0]->op()->name)) {
+      return;
+    }
+    auto* act      = consumers[0];
+    auto* node_out = outputs[0];
+    auto* act_out  = GetNodeData(act);
+    VLOG(4) << "Fuse " << act->id() << " into the post-op of " << node->id();
+
+    node->attrs.attr_store["post_op"] = act->op()->name;
+
+    // unlink the activation and link its output to the node
+    node->UnLinkSingleTo(node_out);
+    node_out->UnLinkSingleTo(act);
+    act->UnLinkSingleTo(act_out);
+    node->LinkTo(act_out);
+    act_out->source_node.Reset(node);
+
+    graph_->DropNode(node_out);
+    graph_->DropNode(act);
+  }
+
+  Graph* graph_;
+};
+
+void MkldnnPostOpsPassInternal(Graph* graph) {
+  VLOG(3) << "MkldnnPostOpsPass...!";
+  MkldnnPostOpsHelper mkldnn_post_ops_helper(graph);
+  mkldnn_post_ops_helper();
+  VLOG(3) << "MkldnnPostOpsPass Finish...!";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(MkldnnPostOpsPass) {
+  CINN_REGISTER_PASS(MkldnnPostOpsPass)
+      .describe(
+          "This pass fuses the relu, sigmoid or tanh after a conv2d or matmul computed by oneDNN into the post-op of "
+          "the primitive.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::MkldnnPostOpsPassInternal);
+  return true;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <numeric>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+std::vector<float> RunGraph(std::shared_ptr<hlir::framework::Graph> graph,
+                            const std::vector<Variable>& inputs,
+                            const std::vector<std::vector<float>>& inputs_data,
+                            const std::string& fetch_id) {
+  auto target = common::DefaultHostTarget();
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+
+  for (int idx = 0; idx < inputs.size(); ++idx) {
+    scope->Var<hlir::framework::Tensor>(inputs[idx]->id);
+    auto tensor = scope->GetTensor(inputs[idx]->id);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(inputs_data[idx], tensor, target);
+  }
+  run_program->Execute();
+
+  auto tensor = scope->GetTensor(fetch_id);
+  std::vector<float> data(tensor->shape().numel());
+  CopyToVector(tensor, &data);
+  return data;
+}
+
+int CountPostOpNodes(const hlir::framework::Graph& graph) {
+  int count = 0;
+  for (auto* node : std::get<0>(graph.topological_order())) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node && op_node->attrs.attr_store.count("post_op")) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void RunModelTest(Program& program, const std::vector<Variable>&& inputs, const std::string& fetch_id) {
+  // init input data.
+  std::vector<std::vector<float>> inputs_data;
+  for (auto input : inputs) {
+    inputs_data.emplace_back(std::accumulate(input->shape.begin(), input->shape.end(), 1, std::multiplies<int>()));
+    InitRandomVector<float>(&inputs_data.back(), inputs_data.back().size(), -1.0f, 1.0f, 1e-3);
+  }
+
+  auto target   = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  auto expected = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  graph = std::make_shared<hlir::framework::Graph>(program, std::unordered_set<std::string>{fetch_id}, target);
+  hlir::framework::ApplyPass(graph.get(), "MkldnnPostOpsPass");
+  ASSERT_EQ(CountPostOpNodes(*graph), 1);
+  auto actual = RunGraph(graph, inputs, inputs_data, fetch_id);
+
+  CheckOutput<float>(expected, actual, 1e-8, 1e-4);
+}
+
+// The group conv2d is computed by oneDNN on x86.
+TEST(MkldnnPostOpsPass, GroupConv2d_Relu) {
+  NetBuilder net_builder("GroupConv2d_Relu");
+  auto x = net_builder.CreateInput(Float(32), {2, 32, 28, 28}, "x");
+  auto w = net_builder.CreateInput(Float(32), {64, 16, 3, 3}, "w");
+  auto y = net_builder.Conv2d(x, w, {1, 1}, {1, 1}, {1, 1}, 2);
+  auto z = net_builder.Relu(y);
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {x, w}, z->id);
+}
+
+TEST(MkldnnPostOpsPass, GroupConv2d_Sigmoid) {
+  NetBuilder net_builder("GroupConv2d_Sigmoid");
+  auto x = net_builder.CreateInput(Float(32), {1, 16, 14, 14}, "x");
+  auto w = net_builder.CreateInput(Float(32), {16, 4, 3, 3}, "w");
+  auto y = net_builder.Conv2d(x, w, {2, 2}, {1, 1}, {1, 1}, 4);
+  auto z = net_builder.Sigmoid(y);
+
+  auto program = net_builder.Build();
+  RunModelTest(program, {x, w}, z->id);
+}
+
+}  // namespace frontend
+}  // namespace cinn
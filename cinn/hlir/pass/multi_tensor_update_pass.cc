@@ -0,0 +1,318 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+#include <map>
+#include <numeric>
+#include <tuple>
+
+#include "cinn/common/graph_utils.h"
+#include "cinn/common/type.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+#include "cinn/hlir/pass/infershape.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::GraphNode;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::shape_t;
+
+using dtype_dict_t = absl::flat_hash_map<std::string, common::Type>;
+using shape_dict_t = absl::flat_hash_map<std::string, framework::shape_t>;
+
+// Multi Tensor Update Pass: pack the same element-wise op applied to many independent tensors, like the updates of
+// the parameters in an optimizer step, into one op over the flattened tensors.
+// P0 - G0, P1 - G1, P2 - G2,...
+// after
+// [P0, P1, P2,...] - [G0, G1, G2,...]
+// The slices of a packed result consumed in order by the next packed op are bypassed, so a whole update chain runs
+// over the packed tensors, and the number of parameters only changes the concat and the slices at its ends.
+
+class MultiTensorUpdatePassHelper : public FusionHelperBase {
+ public:
+  MultiTensorUpdatePassHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        graph_(graph),
+        dtype_dict_(graph->GetMutableAttrs<dtype_dict_t>("inferdtype")),
+        mutable_shape_dict_(graph->GetMutableAttrs<shape_dict_t>("infershape")) {}
+
+  int operator()() {
+    int cnt = 0;
+    for (auto& bucket : GetBuckets()) {
+      auto& nodes = bucket.second;
+      std::vector<bool> packed(nodes.size(), false);
+      for (int i = 0; i < nodes.size(); ++i) {
+        if (packed[i]) {
+          continue;
+        }
+        std::vector<Node*> pack = {nodes[i]};
+        int64_t numel           = GetNumel(GetNodeDataShape(nodes[i]));
+        for (int j = i + 1; j < nodes.size(); ++j) {
+          if (packed[j] || nodes[j]->attrs.attr_store != nodes[i]->attrs.attr_store) {
+            continue;
+          }
+          // the packed tensor is indexed with int32.
+          int64_t size = GetNumel(GetNodeDataShape(nodes[j]));
+          if (numel + size > std::numeric_limits<int32_t>::max()) {
+            continue;
+          }
+          numel += size;
+          pack.push_back(nodes[j]);
+          packed[j] = true;
+        }
+        if (pack.size() > 1) {
+          Pack(pack);
+          ++cnt;
+        }
+      }
+    }
+    RemoveDeadUnpackOps();
+    return cnt;
+  }
+
+ private:
+  static int GetNumel(const shape_t& shape) {
+    return std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+  }
+
+  bool IsPackable(const Node* node) const {
+    if (GetOpKind(node) != framework::kElementWise || IsConstOp(node)) {
+      return false;
+    }
+    if (node->inlinks().empty() || node->outlinks().size() != 1) {
+      return false;
+    }
+    // the broadcasts between the operands can't be flattened.
+    auto shape = GetNodeDataShape(node);
+    for (auto* input : GetProducerNodeData(node)) {
+      if (shape_dict_.at(input->id()) != shape) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The ops at the same level of the longest path from the inputs can't depend on each other, so each bucket holds
+  // the independent ops of the same type and dtype.
+  std::map<std::tuple<int, std::string, std::string, int>, std::vector<Node*>> GetBuckets() {
+    std::map<std::tuple<int, std::string, std::string, int>, std::vector<Node*>> buckets;
+    std::unordered_map<const Node*, int> levels;
+    auto nodes_inorder = std::get<0>(graph_->topological_order());
+    for (auto* graph_node : nodes_inorder) {
+      auto* node = graph_node->safe_as<Node>();
+      if (!node) {
+        continue;
+      }
+      int level = 0;
+      for (auto* producer : GetProducerNode(node)) {
+        level = std::max(level, levels[producer] + 1);
+      }
+      levels[node] = level;
+      if (IsPackable(node)) {
+        auto dtype = common::Type2Str(dtype_dict_.at(GetNodeData(node)->id()));
+        auto key   = std::make_tuple(level, node->op()->name, dtype, static_cast<int>(node->inlinks().size()));
+        buckets[key].push_back(node);
+      }
+    }
+    return buckets;
+  }
+
+  void Pack(std::vector<Node*> nodes) {
+    VLOG(3) << "Pack " << nodes.size() << " " << nodes[0]->op()->name << " ops into one";
+    SortByPackedOperand(&nodes);
+
+    auto packed_node              = MakeNode(nodes[0]->op()->name);
+    packed_node->attrs.attr_store = nodes[0]->attrs.attr_store;
+    int num_operands              = nodes[0]->inlinks().size();
+    for (int idx = 0; idx < num_operands; ++idx) {
+      std::vector<NodeData*> operands;
+      for (auto* node : nodes) {
+        operands.push_back(GetProducerNodeData(node)[idx]);
+      }
+      PackOperands(operands)->LinkTo(packed_node.get());
+    }
+    auto* packed_data = LinkOutput(packed_node, nullptr);
+
+    int offset = 0;
+    for (auto* node : nodes) {
+      auto* output = GetNodeData(node);
+      auto shape   = shape_dict_.at(output->id());
+      int size     = GetNumel(shape);
+      RemoveNode(node);
+      if (shape.size() == 1) {
+        Slice(offset, size, packed_data, output);
+      } else {
+        Reshape(shape, Slice(offset, size, packed_data, nullptr), output);
+      }
+      packed_slices_[output] = {packed_data, offset};
+      offset += size;
+    }
+  }
+
+  // keep the order of the tensors packed by the producers, so their slices can be bypassed.
+  void SortByPackedOperand(std::vector<Node*>* nodes) {
+    int num_operands = (*nodes)[0]->inlinks().size();
+    for (int idx = 0; idx < num_operands; ++idx) {
+      std::unordered_map<Node*, int> offsets;
+      NodeData* packed_data = nullptr;
+      for (auto* node : *nodes) {
+        auto it = packed_slices_.find(GetProducerNodeData(node)[idx]);
+        if (it == packed_slices_.end() || (packed_data && it->second.first != packed_data)) {
+          break;
+        }
+        packed_data   = it->second.first;
+        offsets[node] = it->second.second;
+      }
+      if (offsets.size() == nodes->size()) {
+        std::sort(nodes->begin(), nodes->end(), [&](Node* a, Node* b) { return offsets[a] < offsets[b]; });
+        return;
+      }
+    }
+  }
+
+  NodeData* PackOperands(const std::vector<NodeData*>& operands) {
+    auto it = packed_slices_.find(operands[0]);
+    if (it != packed_slices_.end()) {
+      auto* packed_data = it->second.first;
+      int offset        = 0;
+      for (auto* operand : operands) {
+        auto slice = packed_slices_.find(operand);
+        if (slice == packed_slices_.end() || slice->second.first != packed_data || slice->second.second != offset) {
+          offset = -1;
+          break;
+        }
+        offset += GetNumel(shape_dict_.at(operand->id()));
+      }
+      if (offset == GetNumel(shape_dict_.at(packed_data->id()))) {
+        return packed_data;
+      }
+    }
+
+    std::vector<NodeData*> flattened;
+    for (auto* operand : operands) {
+      auto shape = shape_dict_.at(operand->id());
+      flattened.push_back(shape.size() == 1 ? operand : Reshape({GetNumel(shape)}, operand, nullptr));
+    }
+    return Concat(flattened);
+  }
+
+  common::Shared<Node> MakeNode(const std::string& type) {
+    auto node = common::Shared<Node>(new Node(Operator::Get(type), type, common::UniqName(type + "_multi_tensor")));
+    graph_->RegisterNode(node->id(), node.get());
+    return node;
+  }
+
+  // link the node to the output, or to a new variable if the output is null.
+  NodeData* LinkOutput(common::Shared<Node>& node, NodeData* output) {
+    if (!output) {
+      output = new NodeData(node, 0, 0, common::UniqName("var_multi_tensor"), false);
+      graph_->RegisterNode(output->id(), output);
+    }
+    node->LinkTo(output);
+    output->source_node = node;
+    InferShape(node.get(), dtype_dict_, mutable_shape_dict_);
+    return output;
+  }
+
+  NodeData* Concat(const std::vector<NodeData*>& inputs) {
+    auto node                      = MakeNode("concat");
+    node->attrs.attr_store["axis"] = 0;
+    for (auto* input : inputs) {
+      input->LinkTo(node.get());
+    }
+    return LinkOutput(node, nullptr);
+  }
+
+  NodeData* Reshape(const shape_t& shape, NodeData* input, NodeData* output) {
+    auto node                       = MakeNode("reshape");
+    node->attrs.attr_store["shape"] = shape;
+    input->LinkTo(node.get());
+    if (output) {
+      unpack_nodes_.push_back(node.get());
+    }
+    return LinkOutput(node, output);
+  }
+
+  NodeData* Slice(int start, int size, NodeData* input, NodeData* output) {
+    auto node                               = MakeNode("slice");
+    node->attrs.attr_store["axes"]          = std::vector<int>{0};
+    node->attrs.attr_store["starts"]        = std::vector<int>{start};
+    node->attrs.attr_store["ends"]          = std::vector<int>{start + size};
+    node->attrs.attr_store["infer_flags"]   = std::vector<int>{};
+    node->attrs.attr_store["strides"]       = std::vector<int>{};
+    node->attrs.attr_store["decrease_axis"] = std::vector<int>{};
+    input->LinkTo(node.get());
+    unpack_nodes_.push_back(node.get());
+    return LinkOutput(node, output);
+  }
+
+  void RemoveNode(GraphNode* node) {
+    auto inlinks = node->inlinks();
+    for (auto& link : inlinks) {
+      link->source()->UnLinkSingleTo(link->sink());
+    }
+    auto outlinks = node->outlinks();
+    for (auto& link : outlinks) {
+      link->source()->UnLinkSingleTo(link->sink());
+    }
+    graph_->DropNode(node);
+  }
+
+  // the slices only consumed by the packed ops are dead.
+  void RemoveDeadUnpackOps() {
+    auto& outputs = graph_->outputs;
+    for (auto it = unpack_nodes_.rbegin(); it != unpack_nodes_.rend(); ++it) {
+      auto* output = GetNodeData(*it);
+      if (!output->outlinks().empty() || std::find(outputs.begin(), outputs.end(), output) != outputs.end()) {
+        continue;
+      }
+      RemoveNode(*it);
+      RemoveNode(output);
+    }
+  }
+
+  Graph* graph_;
+  dtype_dict_t& dtype_dict_;
+  shape_dict_t& mutable_shape_dict_;
+  // the packed variable and the offset of each unpacked one.
+  std::unordered_map<NodeData*, std::pair<NodeData*, int>> packed_slices_;
+  // the slice and reshape ops unpacking the results, in the order of the creation.
+  std::vector<Node*> unpack_nodes_;
+};
+
+void MultiTensorUpdatePassInternal(Graph* graph) {
+  MultiTensorUpdatePassHelper multi_tensor_update_pass_helper(graph);
+  int cnt = multi_tensor_update_pass_helper();
+  VLOG(3) << "MultiTensorUpdatePass packed " << cnt << " groups of ops.";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(MultiTensorUpdatePass) {
+  CINN_REGISTER_PASS(MultiTensorUpdatePass)
+      .describe(
+          "Pack the same element-wise op applied to many independent tensors, like the parameter updates of an "
+          "optimizer, into one op over the concatenated tensors.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::MultiTensorUpdatePassInternal);
+  return true;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+int GetSize(std::vector<int>& shape) { return std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>()); }
+
+int CountOps(const hlir::framework::Graph& graph, const std::string& op_type) {
+  int cnt = 0;
+  for (auto& node : graph.nodes()) {
+    auto* op_node = node->safe_as<hlir::framework::Node>();
+    if (op_node && op_node->op()->name == op_type) {
+      ++cnt;
+    }
+  }
+  return cnt;
+}
+
+std::unordered_map<std::string, std::vector<float>> RunProgram(Program& program,
+                                                               const std::vector<Variable>& inputs,
+                                                               const std::vector<std::vector<float>>& inputs_data,
+                                                               const std::unordered_set<std::string>& fetch_ids,
+                                                               bool multi_tensor_update) {
+  auto target = common::DefaultTarget();
+  auto graph  = std::make_shared<hlir::framework::Graph>(program, fetch_ids, target);
+  if (multi_tensor_update) {
+    hlir::framework::ApplyPass(graph.get(), "MultiTensorUpdatePass");
+    // the updates of all the parameters are done by one scale and one add.
+    CHECK_EQ(CountOps(*graph, "scale"), 1);
+    CHECK_EQ(CountOps(*graph, "elementwise_add"), 1);
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+
+  for (int idx = 0; idx < inputs.size(); ++idx) {
+    scope->Var<hlir::framework::Tensor>(inputs[idx]->id);
+    auto tensor = scope->GetTensor(inputs[idx]->id);
+    tensor->mutable_data<float>(target);
+    CopyFromVector(inputs_data[idx], tensor, target);
+  }
+  run_program->Execute();
+
+  std::unordered_map<std::string, std::vector<float>> outputs;
+  for (auto& id : fetch_ids) {
+    auto tensor = scope->GetTensor(id);
+    std::vector<float> data(tensor->shape().numel());
+    CopyToVector(tensor, &data);
+    outputs[id] = data;
+  }
+  return outputs;
+}
+}  // namespace
+
+TEST(MultiTensorUpdatePass, Test_Sgd) {
+  NetBuilder net_builder("Test_Sgd");
+  std::vector<std::vector<int>> shapes = {{32, 16}, {64}, {8, 4, 4}};
+  std::vector<Variable> inputs;
+  std::unordered_set<std::string> fetch_ids;
+  for (int idx = 0; idx < shapes.size(); ++idx) {
+    auto param = net_builder.CreateInput(Float(32), shapes[idx], "param_" + std::to_string(idx));
+    auto grad  = net_builder.CreateInput(Float(32), shapes[idx], "grad_" + std::to_string(idx));
+    auto out   = net_builder.Add(param, net_builder.Scale(grad, -0.01f));
+    inputs.push_back(param);
+    inputs.push_back(grad);
+    fetch_ids.insert(out->id);
+  }
+  auto program = net_builder.Build();
+
+  std::vector<std::vector<float>> inputs_data;
+  for (auto& input : inputs) {
+    inputs_data.emplace_back(GetSize(input->shape));
+    InitRandomVector<float>(&inputs_data.back(), inputs_data.back().size(), 0.0f, 1.0f, 1e-3);
+  }
+
+  auto expected = RunProgram(program, inputs, inputs_data, fetch_ids, false);
+  auto actual   = RunProgram(program, inputs, inputs_data, fetch_ids, true);
+  for (auto& id : fetch_ids) {
+    CheckOutput<float>(actual[id], expected[id], 1e-8, 1e-4);
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
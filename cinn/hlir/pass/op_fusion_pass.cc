@@ -20,6 +20,7 @@ namespace hlir {
 namespace pass {
 
 using framework::Graph;
+using framework::GraphPartition;
 using framework::Node;
 using framework::NodeData;
 using framework::OpPatternKind;
@@ -33,44 +34,55 @@ using GroupList = std::vector<GroupPtr>;
 
 using ConditionFunction = std::function<bool(const FusionHelperBase*, const Node*, const GroupPtr&)>;
 
+// the operator nodes of the graph in topological order
+std::vector<Node*> GetOpNodesInOrder(const Graph* graph) {
+  std::vector<Node*> nodes;
+  for (auto graph_node : std::get<0>(graph->topological_order())) {
+    auto node = graph_node->safe_as<Node>();
+    if (node) {
+      nodes.push_back(node);
+    }
+  }
+  return nodes;
+}
+
 // Op Fusion Pass which performs Ops fusion, Ops are fused
 // "vertically", meaning producing Ops are fused into their consumers
 // with the intent that the loops which compute their values will be fused in
 // code generation.
 class OpFusionPassHelper : public FusionHelperBase {
  public:
-  OpFusionPassHelper(const Graph* graph) : FusionHelperBase(graph) {
+  OpFusionPassHelper(const Graph* graph) : OpFusionPassHelper(graph, GetOpNodesInOrder(graph)) {}
+
+  // fuse the given operator nodes in topological order, such as the ones of a partition of the graph
+  OpFusionPassHelper(const Graph* graph, const std::vector<Node*>& nodes_inorder) : FusionHelperBase(graph) {
     // init fusion relation
     InitFusionRelation();
-    // filter node data, create group for each node
-    auto nodes_inorder = std::get<0>(graph->topological_order());
-    for (auto graph_node : nodes_inorder) {
-      auto node = graph_node->safe_as<Node>();
-      if (node) {
-        nodes_.push_back(node);
-        auto group = std::make_shared<Graph::Group>();
-        // init group
-        group->nodes.push_back(node);
-        group->nodes_set.insert(node);
-        group->output_nodes.insert(node);
-        // input node
-        for (auto& edge : node->inlinks()) {
-          auto input_graph_node = edge->source();
-          auto input_node_data  = input_graph_node->safe_as<NodeData>();
-          CHECK(input_node_data);
-          // input data has no source node
-          if (input_node_data->source_node.get()) {
-            group->input_nodes[input_node_data->source_node.get()] = 1;
-          }
+    // create group for each node
+    for (auto node : nodes_inorder) {
+      nodes_.push_back(node);
+      auto group = std::make_shared<Graph::Group>();
+      // init group
+      group->nodes.push_back(node);
+      group->nodes_set.insert(node);
+      group->output_nodes.insert(node);
+      // input node
+      for (auto& edge : node->inlinks()) {
+        auto input_graph_node = edge->source();
+        auto input_node_data  = input_graph_node->safe_as<NodeData>();
+        CHECK(input_node_data);
+        // input data has no source node
+        if (input_node_data->source_node.get()) {
+          group->input_nodes[input_node_data->source_node.get()] = 1;
         }
-
-        // group type
-        group->op_pattern_kind = GetOpKind(node);
-        // use current node as master node for schedule
-        group->master_nodes.insert(node);
-        group->group_id      = node->id();
-        fusion_groups_[node] = group;
       }
+
+      // group type
+      group->op_pattern_kind = GetOpKind(node);
+      // use current node as master node for schedule
+      group->master_nodes.insert(node);
+      group->group_id      = node->id();
+      fusion_groups_[node] = group;
     }
     // reverse node for output to input
     std::reverse(nodes_.begin(), nodes_.end());
@@ -152,6 +164,10 @@ class OpFusionPassHelper : public FusionHelperBase {
         if (producer_kind == framework::kNonFusible) {
           continue;
         }
+        // the op run once on PreRun can't fuse the op run every time.
+        if (IsPreRunOp(producer) != IsPreRunOp(consumer)) {
+          continue;
+        }
         VLOG(3) << "Producer Op: " << producer->id() << ", Op Pattern: " << producer_kind
                 << " -> Consumer Op: " << consumer->id() << ", Op Pattern: " << consumer_kind;
         bool can_fuse = true;
@@ -358,12 +374,22 @@ void OpFusionPassInternal(Graph* graph) {
   VLOG(3) << "OpFusionPass Finish...!";
 }
 
+void OpFusionPassPartition(Graph* graph, GraphPartition* partition) {
+  auto op_fusion_helper    = OpFusionPassHelper(graph, partition->nodes);
+  partition->fusion_groups = op_fusion_helper();
+}
+
 void BuildNonFusedGroupsPassInternal(framework::Graph* graph) {
   auto op_fusion_helper = OpFusionPassHelper(graph);
   VLOG(3) << "Apply OpFusionPass to generate initial non-fusion groups";
   graph->fusion_groups = op_fusion_helper(false);
 }
 
+void BuildNonFusedGroupsPassPartition(Graph* graph, GraphPartition* partition) {
+  auto op_fusion_helper    = OpFusionPassHelper(graph, partition->nodes);
+  partition->fusion_groups = op_fusion_helper(false);
+}
+
 }  // namespace pass
 }  // namespace hlir
 }  // namespace cinn
@@ -373,12 +399,14 @@ CINN_REGISTER_HELPER(OpFusionPass) {
       .describe(
           "Op Fusion Pass which performs Ops fusion, Producer Ops are fused into Consumer Ops with certain conditions.")
       .set_change_structure(false)
-      .set_body(cinn::hlir::pass::OpFusionPassInternal);
+      .set_body(cinn::hlir::pass::OpFusionPassInternal)
+      .set_partition_body(cinn::hlir::pass::OpFusionPassPartition);
 
   CINN_REGISTER_PASS(BuildNonFusedGroupsPass)
       .describe("Build No Fused Groups.")
       .set_change_structure(false)
-      .set_body(cinn::hlir::pass::BuildNonFusedGroupsPassInternal);
+      .set_body(cinn::hlir::pass::BuildNonFusedGroupsPassInternal)
+      .set_partition_body(cinn::hlir::pass::BuildNonFusedGroupsPassPartition);
 
   return true;
 }
@@ -14,8 +14,14 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
+#include <string>
+
 #include "cinn/frontend/decomposer/test_helper.h"
 
+DECLARE_int32(cinn_partition_pass_min_nodes);
+DECLARE_bool(cinn_fuse_independent_groups);
+
 namespace cinn {
 namespace frontend {
 
@@ -272,5 +278,47 @@ TEST(OpFusionPass, Test_Insert_BroadcastTo) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(OpFusionPass, Partition_Parallel) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("Partition_Parallel");
+  // create model with two independent chains
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E = net_builder.ReduceSum(net_builder.Add(A, B), {1});
+    auto F = net_builder.Relu(net_builder.Add(C, D));
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto get_group_nodes = [&](int min_nodes) {
+    FLAGS_cinn_partition_pass_min_nodes = min_nodes;
+    FLAGS_cinn_fuse_independent_groups  = false;
+    auto graph                          = std::make_shared<hlir::framework::Graph>(program, target);
+    hlir::framework::ApplyPasses(graph.get(), {"OpFusionPass", "FusionMergePass"});
+    std::set<std::set<std::string>> group_nodes;
+    for (auto& group : graph->fusion_groups) {
+      std::set<std::string> node_ids;
+      for (auto* node : group->CollectNodes()) {
+        node_ids.insert(node->id());
+      }
+      group_nodes.insert(node_ids);
+    }
+    return group_nodes;
+  };
+  // the partitions are fused in parallel, with the same groups as fusing the whole graph
+  auto serial_groups   = get_group_nodes(0);
+  auto parallel_groups = get_group_nodes(1);
+  FLAGS_cinn_partition_pass_min_nodes = 10000;
+  FLAGS_cinn_fuse_independent_groups  = true;
+
+  ASSERT_EQ(serial_groups.size(), 2UL);
+  ASSERT_EQ(parallel_groups, serial_groups);
+}
+
 }  // namespace frontend
 }  // namespace cinn
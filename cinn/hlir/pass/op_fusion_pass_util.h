@@ -196,7 +196,7 @@ CONDITION_FUNC(horizontal_or_vertical_reduce_relation) {
     break;
   }
 
-  return helper->target_ == common::DefaultNVGPUTarget()
+  return helper->target_.is_gpu()
              ? (succesive_reduce_dimension <= helper->target_.max_num_threads() ? true : false)
              : true;
 }
@@ -239,7 +239,7 @@ CONDITION_FUNC(reduce_fuse_broadcast) {
     return false;
   }
 
-  if (helper->target_ != common::DefaultNVGPUTarget()) {
+  if (!helper->target_.is_gpu()) {
     return true;
   }
 
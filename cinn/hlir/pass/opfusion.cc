@@ -118,7 +118,7 @@ class DomTree {
   }
 
   DomNode* FindLCA(GraphNode* graph_node, OpPatternKind* pattern) {
-    static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+    auto& op_pattern_dict = Operator::GetOpPatternAttrs();
     CHECK(graph_node);
     CHECK(pattern);
     DomNode* parent = nullptr;
@@ -237,7 +237,7 @@ class GraphPartition {
   std::unordered_set<GraphNode*> visited_nodes_;
   const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
   void InitGroups(const std::vector<GraphNode*>& graph_nodes) {
-    static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+    auto& op_pattern_dict = Operator::GetOpPatternAttrs();
     for (int i = 0; i < graph_nodes.size(); i++) {
       GroupNode* group_node = new GroupNode();
       GraphNode* graph_node = graph_nodes[i];
@@ -341,7 +341,7 @@ class GraphPartition {
   // check all the nodes between source and sink meet the function of fusion.
   template <typename T>
   bool VerifyFuse(GraphNode* source, GraphNode* sink, T fn) {
-    static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+    auto& op_pattern_dict = Operator::GetOpPatternAttrs();
     auto op_node                 = source->safe_as<Node>();
     visited_nodes_.clear();
     CHECK(source != sink);
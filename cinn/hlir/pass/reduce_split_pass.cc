@@ -12,12 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "cinn/hlir/pass/reduce_split_pass.h"
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
 #include "cinn/common/graph_utils.h"
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/pass/infershape.h"
-#include "cinn/hlir/pe/nn_util.h"
+
+DECLARE_double(cinn_reduce_split_min_occupancy);
 
 namespace cinn {
 namespace hlir {
@@ -40,21 +51,6 @@ bool IsReduceOp(const framework::Node* node) {
   }
 }
 
-std::pair<int, int> DivideToClosetNum(int n) {
-  int a = sqrt(n);
-  int b = n / a;
-  while (a * b != n) {
-    if (a * b < n) {
-      a++;
-      b = n / a;
-    } else {
-      a--;
-      b = n / a;
-    }
-  }
-  return {a, b};
-}
-
 uint32_t NextPowerOf2(uint32_t n) {
   n--;
   n |= n >> 1;
@@ -65,151 +61,184 @@ uint32_t NextPowerOf2(uint32_t n) {
   return n++;
 }
 
+// Create the op node of a single output, whose output is registered with the shape and the dtype.
+NodeData* CreateOpNode(framework::Graph* graph,
+                       const std::string& op_type,
+                       const framework::AttrMapType& attrs,
+                       NodeData* input,
+                       const shape_t& out_shape,
+                       const common::Type& out_dtype,
+                       NodeData* output = nullptr) {
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+
+  Node* node             = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type + "_split"));
+  node->attrs.attr_store = attrs;
+  graph->RegisterNode(node->id(), node);
+  input->LinkTo(node);
+  if (!output) {
+    output = new NodeData(Shared<Node>(node), 0, 0, common::UniqName("var"), false);
+    graph->RegisterNode(output->id(), output);
+  } else {
+    output->source_node = Shared<Node>(node);
+  }
+  node->LinkTo(output);
+  shape_dict[output->id()] = out_shape;
+  dtype_dict[output->id()] = out_dtype;
+  return output;
+}
+
 class ReduceSplitPass {
  public:
-  // Find the reduce op with nwhc format and large shape, split it into two ops
+  // Split the row reductions [kept..., reduce...] and the column reductions [reduce..., kept] of low occupancy into
+  // two reductions, the first one reduces each kept element into `factor` partial results over the whole device.
   static int Apply(framework::Graph* graph) {
-    int MAX_NUM_THREADS               = common::DefaultNVGPUTarget().max_num_threads();
-    constexpr int MAX_ITER_PER_THREAD = 32;  // empirical value
+    const auto& target = graph->target_;
+    if (!target.is_gpu()) {
+      return 0;
+    }
+    int num_sm                = target.get_multi_processor_count();
+    int max_threads_per_sm    = target.get_max_threads_per_sm();
+    int max_threads_per_block = target.max_num_threads();
 
     int cnt          = 0;
     auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
-    auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+    auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
 
     // loop the nodes in graph and find reduce_xx op
     auto nodes_inorder = std::get<0>(graph->topological_order());
     for (auto node : nodes_inorder) {
-      if (!node->safe_as<Node>()) {
+      auto n = node->safe_as<Node>();
+      if (!n || !IsReduceOp(n)) {
         continue;
       }
-      auto n = node->safe_as<Node>();
-      if (IsReduceOp(n)) {
-        auto* op  = n->op();
-        auto name = op->name;
-
-        auto dims     = absl::get<std::vector<int>>(n->attrs.attr_store.at("dim"));
-        bool keep_dim = absl::get<bool>(n->attrs.attr_store.at("keep_dim"));
-        auto in       = (*n->inlinks().begin())->source()->safe_as<NodeData>();
-        auto out      = (*n->outlinks().begin())->sink()->safe_as<NodeData>();
-
-        auto in_shape  = shape_dict.at(in->id());
-        auto out_shape = shape_dict.at(out->id());
-        // all preceding reduced
-        CHECK(in_shape.size() > 1);
-        // [NHWC]->[C], only the last dim kept
-        bool all_preceding_dim_reduced = true;
-        for (auto i = 0; i < in_shape.size() - 1; ++i) {
-          if (std::find(dims.begin(), dims.end(), i) == dims.end()) {
-            all_preceding_dim_reduced = false;
-          }
-        }
-        bool reduce_all =
-            all_preceding_dim_reduced && std::find(dims.begin(), dims.end(), in_shape.size() - 1) != dims.end();
-        if (!all_preceding_dim_reduced || reduce_all) {
-          continue;
-        }
-        int numel        = std::accumulate(in_shape.begin(), in_shape.end(), 1, std::multiplies<int>());
-        int reduce_numel = std::accumulate(in_shape.begin(), in_shape.end() - 1, 1, std::multiplies<int>());
-        CHECK(reduce_numel > 0);
-        // if the numel is not large enough, it is no need to split
-        // if loop times is too large with reduce optimize
-        int size   = std::accumulate(in_shape.begin(), (in_shape.end() - 1), 1, std::multiplies<int>());
-        int tail   = 0;
-        bool bound = true;
-        auto shape = pe::GetFirstStepReduceShape({size, in_shape.back()}, {0}, bound, tail);
-        CHECK(bound);
-        CHECK_EQ(shape.size(), 3);
-
-        auto res          = DivideToClosetNum(reduce_numel);
-        int reduce_numel0 = std::get<0>(res), reduce_numel1 = std::get<1>(res);
-
-        VLOG(3) << "InShape -> "
-                << std::accumulate(
-                       in_shape.begin(), in_shape.end(), std::string(""), [](const std::string& left, const int right) {
-                         return left + std::to_string(right) + " ";
-                       });
-        VLOG(3) << "  reduce  split : " << reduce_numel0 << " " << reduce_numel1 << " " << in_shape.back();
-        VLOG(3) << "  reshape split : "
-                << std::accumulate(shape.begin(), shape.end(), std::string(""), [](std::string left, int right) {
-                     return left + std::to_string(right) + " ";
-                   });
-
-        // Two do reduce split:
-        //   1. reshape_loop > split_loop
-        //   2. reshape thread > max_threads.
-        if (shape[0] <= reduce_numel0 && shape[1] * shape[2] <= common::GetMaxThreads()) {
-          VLOG(3) << "  Don't Do Reduce Split!";
-          continue;
-        }
-        VLOG(3) << "  Do Reduce Split!";
-
-        /*
-        if ((!all_preceding_dim_reduced) || numel <= MAX_NUM_THREADS * MAX_ITER_PER_THREAD || reduce_all) {
-          continue;
-        }
-        */
-        // create reshape node0
-        Node* reshape0 = new Node(Operator::Get("reshape"), "reshape", common::UniqName("reshape_split"));
-        reshape0->attrs.attr_store["shape"] =
-            std::vector<int>{reduce_numel0, reduce_numel1, in_shape[in_shape.size() - 1]};
-        graph->RegisterNode(reshape0->id(), reshape0);
-        in->LinkTo(reshape0);
-        in->UnLinkSingleTo(node);
-        node->UnLinkSingleTo(out);
-        auto reshape0_data = new NodeData(Shared<Node>(reshape0), 0, 0, common::UniqName("var"), false);
-        graph->RegisterNode(reshape0_data->id(), reshape0_data);
-        reshape0->LinkTo(reshape0_data);
-        shape_dict[reshape0_data->id()] = absl::get<std::vector<int>>(reshape0->attrs.attr_store.at("shape"));
-        dtype_dict[reshape0_data->id()] = common::Str2Type(common::Type2Str(dtype_dict[in->id()]));
-
-        // create reduce node0
-        Node* reduce0                         = new Node(Operator::Get(name), name, common::UniqName(name + "_split"));
-        reduce0->attrs.attr_store["dim"]      = std::vector<int>{0};
-        reduce0->attrs.attr_store["keep_dim"] = absl::get<bool>(n->attrs.attr_store.at("keep_dim"));
-        graph->RegisterNode(reduce0->id(), reduce0);
-        reshape0_data->LinkTo(reduce0);
-        auto reduce0_data = new NodeData(Shared<Node>(reduce0), 0, 0, common::UniqName("var"), false);
-        graph->RegisterNode(reduce0_data->id(), reduce0_data);
-        reduce0->LinkTo(reduce0_data);
-        shape_dict[reduce0_data->id()] = keep_dim ? std::vector<int>{1, reduce_numel1, in_shape[in_shape.size() - 1]}
-                                                  : std::vector<int>{reduce_numel1, in_shape[in_shape.size() - 1]};
-        dtype_dict[reduce0_data->id()] = common::Str2Type(common::Type2Str(dtype_dict[in->id()]));
-
-        // create reduce node1
-        Node* reduce1                         = new Node(Operator::Get(name), name, common::UniqName(name + "_split"));
-        reduce1->attrs.attr_store["dim"]      = keep_dim ? std::vector<int>{0, 1} : std::vector<int>{0};
-        reduce1->attrs.attr_store["keep_dim"] = absl::get<bool>(n->attrs.attr_store.at("keep_dim"));
-        graph->RegisterNode(reduce1->id(), reduce1);
-        reduce0_data->LinkTo(reduce1);
-        auto reduce1_data = new NodeData(Shared<Node>(reduce1), 0, 0, common::UniqName("var"), false);
-        graph->RegisterNode(reduce1_data->id(), reduce1_data);
-        reduce1->LinkTo(reduce1_data);
-        shape_dict[reduce1_data->id()] = keep_dim ? std::vector<int>{1, 1, in_shape[in_shape.size() - 1]}
-                                                  : std::vector<int>{in_shape[in_shape.size() - 1]};
-        dtype_dict[reduce1_data->id()] = common::Str2Type(common::Type2Str(dtype_dict[in->id()]));
-
-        // create reshape node1
-        Node* reshape1 = new Node(Operator::Get("reshape"), "reshape", common::UniqName("reshape_split"));
-        reshape1->attrs.attr_store["shape"] = out_shape;
-        graph->RegisterNode(reshape1->id(), reshape1);
-        reduce1_data->LinkTo(reshape1);
-        reshape1->LinkTo(out);
-        out->source_node = common::Shared<Node>(reshape1);
-
-        // drop old node
-        graph->DropNode(node);
-
-        cnt++;
+      auto in        = (*n->inlinks().begin())->source()->safe_as<NodeData>();
+      auto out       = (*n->outlinks().begin())->sink()->safe_as<NodeData>();
+      auto in_shape  = shape_dict.at(in->id());
+      auto out_shape = shape_dict.at(out->id());
+      int rank       = in_shape.size();
+
+      auto dims = absl::get<std::vector<int>>(n->attrs.attr_store.at("dim"));
+      for (auto& dim : dims) {
+        dim = dim < 0 ? dim + rank : dim;
+      }
+      std::sort(dims.begin(), dims.end());
+      if (dims.empty() || dims.size() == rank || dims.back() - dims.front() + 1 != dims.size()) {
+        continue;
+      }
+      // [NHWC]->[C] reduces all the preceding axes, and [NC]->[N] all the trailing ones
+      bool is_row_reduce = dims.back() == rank - 1;
+      if (!is_row_reduce && dims.front() != 0) {
+        continue;
+      }
+      int reduce_numel = 1;
+      for (int dim : dims) {
+        reduce_numel *= in_shape[dim];
       }
+      int numel      = std::accumulate(in_shape.begin(), in_shape.end(), 1, std::multiplies<int>());
+      int kept_numel = numel / reduce_numel;
+
+      // the factor pinned on the node, such as the tuned one, overrides the estimated one
+      int factor = GetReduceSplitFactor(
+          kept_numel, reduce_numel, is_row_reduce, num_sm, max_threads_per_sm, max_threads_per_block);
+      if (n->attrs.attr_store.count("reduce_split_factor")) {
+        factor = absl::get<int>(n->attrs.attr_store.at("reduce_split_factor"));
+      }
+      if (factor <= 1 || reduce_numel % factor != 0 || factor == reduce_numel) {
+        continue;
+      }
+      VLOG(3) << "Split " << n->id() << " of [" << kept_numel << ", " << reduce_numel << "] by " << factor
+              << (is_row_reduce ? " in row" : " in column");
+
+      // the row reduction reduces [kept, factor, reduce / factor] into [kept, factor] and then [kept], and the column
+      // one reduces [reduce / factor, factor, kept] into [factor, kept] and then [kept]
+      const auto& dtype = dtype_dict.at(in->id());
+      shape_t reshape_shape, partial_shape;
+      if (is_row_reduce) {
+        reshape_shape = {kept_numel, factor, reduce_numel / factor};
+        partial_shape = {kept_numel, factor};
+      } else {
+        reshape_shape = {reduce_numel / factor, factor, kept_numel};
+        partial_shape = {factor, kept_numel};
+      }
+      auto reduce_attrs = [&](int dim) {
+        framework::AttrMapType attrs = n->attrs.attr_store;
+        attrs["dim"]                 = std::vector<int>{dim};
+        attrs["keep_dim"]            = false;
+        attrs.erase("reduce_split_factor");
+        return attrs;
+      };
+
+      in->UnLinkSingleTo(n);
+      n->UnLinkSingleTo(out);
+      const auto& op_type = n->op()->name;
+      auto reshaped       = CreateOpNode(graph, "reshape", {{"shape", reshape_shape}}, in, reshape_shape, dtype);
+      auto partial = CreateOpNode(graph, op_type, reduce_attrs(is_row_reduce ? 2 : 0), reshaped, partial_shape, dtype);
+      auto reduced = CreateOpNode(graph, op_type, reduce_attrs(is_row_reduce ? 1 : 0), partial, {kept_numel}, dtype);
+      CreateOpNode(graph, "reshape", {{"shape", out_shape}}, reduced, out_shape, dtype_dict.at(out->id()), out);
+
+      // drop old node
+      graph->DropNode(n);
+
+      cnt++;
     }
     return cnt;
   }
-
- private:
 };
 
 }  // namespace
 
+int GetReduceSplitFactor(int kept_numel,
+                         int reduce_numel,
+                         bool is_row_reduce,
+                         int num_sm,
+                         int max_threads_per_sm,
+                         int max_threads_per_block) {
+  // each partial result reduces kMinReduceNumel elements at least, otherwise the second reduction costs as much
+  constexpr int kMinReduceNumel = 32;
+  int64_t capacity              = static_cast<int64_t>(num_sm) * max_threads_per_sm;
+  if (capacity <= 0 || static_cast<int64_t>(kept_numel) * reduce_numel < capacity) {
+    return 1;
+  }
+  auto occupancy = [&](int factor) {
+    int64_t outputs = static_cast<int64_t>(kept_numel) * factor;
+    int inner       = reduce_numel / factor;
+    // a block spans max_threads_per_block / outputs rows of a column reduction
+    int64_t threads = is_row_reduce
+                          ? outputs * std::min(inner, max_threads_per_block)
+                          : outputs * std::min<int64_t>(inner, std::max<int64_t>(1, max_threads_per_block / outputs));
+    return std::min(1.0, static_cast<double>(threads) / capacity);
+  };
+  if (occupancy(1) >= FLAGS_cinn_reduce_split_min_occupancy) {
+    return 1;
+  }
+
+  std::vector<int> factors;
+  for (int i = 2; i * i <= reduce_numel; ++i) {
+    if (reduce_numel % i == 0) {
+      factors.push_back(i);
+      factors.push_back(reduce_numel / i);
+    }
+  }
+  std::sort(factors.begin(), factors.end());
+  int best_factor       = 1;
+  double best_occupancy = occupancy(1);
+  for (int factor : factors) {
+    if (reduce_numel / factor < kMinReduceNumel) {
+      break;
+    }
+    double factor_occupancy = occupancy(factor);
+    if (factor_occupancy > best_occupancy) {
+      best_factor    = factor;
+      best_occupancy = factor_occupancy;
+    }
+    if (factor_occupancy >= 1.0) {
+      break;
+    }
+  }
+  return best_factor;
+}
+
 void ReduceSplitFunc(framework::Graph* graph) {
   int n = ReduceSplitPass::Apply(graph);
   VLOG(3) << "ReduceSplit was performed " << n << " times.";
@@ -221,7 +250,7 @@ void ReduceSplitFunc(framework::Graph* graph) {
 
 CINN_REGISTER_HELPER(ReduceSplit) {
   CINN_REGISTER_PASS(ReduceSplit)
-      .describe("")
+      .describe("This pass splits the reductions of low occupancy on NVGPU into two reductions.")
       .set_change_structure(true)
       .provide_graph_attr("infershape")
       .provide_graph_attr("inferdtype")
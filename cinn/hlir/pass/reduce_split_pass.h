@@ -0,0 +1,46 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+/**
+ * Decide how many partial results each kept element of a reduction is split into, which are reduced by a second
+ * reduction. The unsplit reduction is estimated to run one block per kept element for a row reduction, and one thread
+ * per kept element in the blocks spanning the reduce axis for a column reduction. It is split only if the estimated
+ * occupancy of the device is below FLAGS_cinn_reduce_split_min_occupancy, and the smallest factor dividing the reduce
+ * extent that fills the device is taken, so skinny reductions with few kept elements and a huge reduce extent are
+ * spread over all the SMs.
+ * @param kept_numel The number of the elements kept by the reduction.
+ * @param reduce_numel The number of the elements reduced into each kept element.
+ * @param is_row_reduce Whether the reduced axes are the innermost ones.
+ * @param num_sm The number of the SMs of the device.
+ * @param max_threads_per_sm The max number of the resident threads of a SM.
+ * @param max_threads_per_block The max number of the threads of a block.
+ * @return The split factor, or 1 if the reduction is not split.
+ */
+int GetReduceSplitFactor(int kept_numel,
+                         int reduce_numel,
+                         bool is_row_reduce,
+                         int num_sm,
+                         int max_threads_per_sm,
+                         int max_threads_per_block);
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include "cinn/frontend/decomposer/test_helper.h"
+#include "cinn/hlir/pass/reduce_split_pass.h"
 
 namespace cinn {
 namespace frontend {
@@ -91,5 +92,19 @@ TEST(ReduceSplit, reduce_mean_nhwc_small_size) {
   }
 }
 
+TEST(ReduceSplit, split_factor) {
+  // a device of 108 SMs with 2048 threads each
+  auto get_factor = [](int kept_numel, int reduce_numel, bool is_row_reduce) {
+    return hlir::pass::GetReduceSplitFactor(kept_numel, reduce_numel, is_row_reduce, 108, 2048, 1024);
+  };
+  // the skinny row reduction is split to fill the device
+  ASSERT_EQ(get_factor(4, 1 << 20, true), 64);
+  ASSERT_EQ(get_factor(4096, 1024, true), 1);
+  // the column reduction is split as much as each partial result still reduces 32 elements
+  ASSERT_EQ(get_factor(256, 12544, false), 392);
+  // the small reduction can't fill the device anyway
+  ASSERT_EQ(get_factor(256, 128, false), 1);
+}
+
 }  // namespace frontend
 }  // namespace cinn
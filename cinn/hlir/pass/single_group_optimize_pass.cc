@@ -171,7 +171,7 @@ bool SingleGroupOptimizePass::CanReplaceToMemcpy(Node* node) const {
 }
 
 void SingleGroupOptimizePassImpl(Graph* graph) {
-  if (graph->target_ != common::DefaultNVGPUTarget()) {
+  if (!graph->target_.is_gpu()) {
     return;
   }
   graph->fusion_groups = SingleGroupOptimizePass(graph).Apply();
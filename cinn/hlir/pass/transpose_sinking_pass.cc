@@ -0,0 +1,332 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/fusion_helper_base.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+// Transpose Sinking Pass: the transposes left after the frontend passes are sunk through the elementwise ops and the
+// reductions until they cancel each other or land on the operand of a matmul, which folds them into trans_a/trans_b.
+// B = transpose(A, [1, 0])             B = relu(A)
+// C = relu(B)                 =>       E = matmul(B, D, trans_a=true)
+// E = matmul(C, D)
+// So the standalone transpose kernels bound by the memory are removed. A transpose is only moved if its output is
+// consumed by a single op and isn't the output of the graph.
+class TransposeSinkingHelper : public FusionHelperBase {
+ public:
+  TransposeSinkingHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        graph_(graph),
+        shape_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape")),
+        dtype_dict_(graph->GetMutableAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype")) {}
+
+  int operator()() {
+    std::vector<Node*> transposes;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && node->op()->name == "transpose") {
+        transposes.push_back(node);
+      }
+    }
+    int num_eliminated = 0;
+    for (auto* transpose : transposes) {
+      // the transposes merged or removed by the former ones are skipped
+      if (dropped_.count(transpose)) {
+        continue;
+      }
+      // each step moves the transpose past a consumer, or removes it
+      while (true) {
+        auto step = Sink(transpose);
+        if (step == Step::kRemoved) {
+          num_eliminated++;
+          break;
+        }
+        if (step == Step::kStopped) {
+          break;
+        }
+      }
+    }
+    return num_eliminated;
+  }
+
+ private:
+  enum class Step { kMoved, kRemoved, kStopped };
+
+  template <typename T>
+  static T GetAttr(const Node* node, const std::string& key, const T& default_value) {
+    const auto& attr_store = node->attrs.attr_store;
+    return attr_store.count(key) ? absl::get<T>(attr_store.at(key)) : default_value;
+  }
+
+  static std::vector<int> GetAxis(const Node* transpose) { return GetAttr<std::vector<int>>(transpose, "axis", {}); }
+
+  static bool IsIdentity(const std::vector<int>& axis) {
+    for (int i = 0; i < axis.size(); ++i) {
+      if (axis[i] != i) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool IsGraphOutput(const NodeData* node_data) const {
+    return std::find(graph_->outputs.begin(), graph_->outputs.end(), node_data) != graph_->outputs.end();
+  }
+
+  // Replace the input `from` of the node by `to`, the inputs are relinked in order to keep their indices.
+  static void ReplaceInput(Node* node, NodeData* from, NodeData* to) {
+    std::vector<common::GraphNode*> sources;
+    for (auto& link : node->inlinks_in_order()) {
+      sources.push_back(link->source());
+      link->source()->UnLinkSingleTo(node);
+    }
+    for (auto* source : sources) {
+      (source == from ? static_cast<common::GraphNode*>(to) : source)->LinkTo(node);
+    }
+  }
+
+  void DropNode(Node* node, NodeData* output) {
+    dropped_.insert(node);
+    for (auto* input : GetProducerNodeData(node)) {
+      input->UnLinkSingleTo(node);
+    }
+    node->UnLinkSingleTo(output);
+    shape_dict_.erase(output->id());
+    dtype_dict_.erase(output->id());
+    graph_->DropNode(node);
+    graph_->DropNode(output);
+  }
+
+  Step Sink(Node* transpose) {
+    auto* input  = GetProducerNodeData(transpose)[0];
+    auto* output = GetNodeData(transpose);
+    if (IsGraphOutput(output)) {
+      return Step::kStopped;
+    }
+    auto consumers = GetConsumerNode(transpose);
+    if (consumers.size() != 1) {
+      return Step::kStopped;
+    }
+    auto* consumer = consumers[0];
+    auto axis      = GetAxis(transpose);
+    if (consumer->op()->name == "transpose") {
+      return MergeTranspose(transpose, consumer, input, output, axis);
+    }
+    if (consumer->op()->name == "matmul" || consumer->op()->name == "cublas_matmul") {
+      return FoldIntoMatmul(transpose, consumer, input, output, axis);
+    }
+    if (GetNodeDatas(consumer).size() != 1) {
+      return Step::kStopped;
+    }
+    auto kind = GetOpKind(consumer);
+    // the elementwise ops such as reshape change the shape, and the broadcast of the binary ops depends on the layout
+    if (kind == framework::kElementWise &&
+        shape_dict_.at(GetNodeData(consumer)->id()) == shape_dict_.at(output->id())) {
+      auto num_inputs = GetProducerNodeData(consumer).size();
+      if (num_inputs == 1) {
+        SwapWithConsumer(transpose, consumer, input, output, shape_dict_.at(input->id()));
+        return Step::kMoved;
+      }
+      if (num_inputs == 2) {
+        return SinkThroughBinary(transpose, consumer, input, output, axis);
+      }
+    }
+    if (kind == framework::kReduction && consumer->attrs.attr_store.count("dim")) {
+      return SinkThroughReduce(transpose, consumer, input, output, axis);
+    }
+    return Step::kStopped;
+  }
+
+  // transpose(transpose(x, p), q) = transpose(x, p[q]), and it is removed if the axis is the identity
+  Step MergeTranspose(
+      Node* transpose, Node* consumer, NodeData* input, NodeData* output, const std::vector<int>& axis) {
+    auto consumer_axis = GetAxis(consumer);
+    std::vector<int> merged_axis;
+    for (int i : consumer_axis) {
+      merged_axis.push_back(axis[i]);
+    }
+    VLOG(4) << "Merge " << transpose->id() << " into " << consumer->id();
+    consumer->attrs.attr_store["axis"] = merged_axis;
+    ReplaceInput(consumer, output, input);
+    DropNode(transpose, output);
+
+    auto* consumer_output = GetNodeData(consumer);
+    if (IsIdentity(merged_axis) && !IsGraphOutput(consumer_output)) {
+      VLOG(4) << "Remove the identity " << consumer->id();
+      for (auto* next : GetConsumerNode(consumer)) {
+        // the consumer taking the output twice is relinked once
+        if (consumer_output->IsLinkedTo(next)) {
+          ReplaceInput(next, consumer_output, input);
+        }
+      }
+      DropNode(consumer, consumer_output);
+    }
+    return Step::kRemoved;
+  }
+
+  // the transpose swapping the last two axes is folded into the trans_a/trans_b of the matmul
+  Step FoldIntoMatmul(Node* transpose, Node* matmul, NodeData* input, NodeData* output, const std::vector<int>& axis) {
+    int rank = axis.size();
+    if (rank < 2 || axis[rank - 1] != rank - 2 || axis[rank - 2] != rank - 1 ||
+        !IsIdentity(std::vector<int>(axis.begin(), axis.end() - 2))) {
+      return Step::kStopped;
+    }
+    auto inputs = GetProducerNodeData(matmul);
+    if (inputs.size() != 2 || inputs[0] == inputs[1]) {
+      return Step::kStopped;
+    }
+    std::string trans_attr = inputs[0] == output ? "trans_a" : "trans_b";
+    VLOG(4) << "Fold " << transpose->id() << " into the " << trans_attr << " of " << matmul->id();
+    matmul->attrs.attr_store[trans_attr] = !GetAttr<bool>(matmul, trans_attr, false);
+    ReplaceInput(matmul, output, input);
+    DropNode(transpose, output);
+    return Step::kRemoved;
+  }
+
+  // y = op(transpose(x)) is rewritten into y = transpose(op(x)), the output of the transpose is reused as the one of
+  // the op, whose shape is the one of op(x).
+  void SwapWithConsumer(Node* transpose,
+                        Node* consumer,
+                        NodeData* input,
+                        NodeData* output,
+                        const shape_t& consumer_out_shape) {
+    auto* consumer_output = GetNodeData(consumer);
+    ReplaceInput(consumer, output, input);
+    input->UnLinkSingleTo(transpose);
+    transpose->UnLinkSingleTo(output);
+    consumer->UnLinkSingleTo(consumer_output);
+
+    consumer->LinkTo(output);
+    output->source_node.Reset(consumer);
+    output->LinkTo(transpose);
+    transpose->LinkTo(consumer_output);
+    consumer_output->source_node.Reset(transpose);
+
+    shape_dict_[output->id()] = consumer_out_shape;
+    dtype_dict_[output->id()] = dtype_dict_.at(consumer_output->id());
+    VLOG(4) << "Sink " << transpose->id() << " after " << consumer->id();
+  }
+
+  // op(transpose(x, p), transpose(y, p)) = transpose(op(x, y), p), and one of the transposes is removed
+  Step SinkThroughBinary(
+      Node* transpose, Node* consumer, NodeData* input, NodeData* output, const std::vector<int>& axis) {
+    auto operands         = GetProducerNodeData(consumer);
+    auto* other           = operands[0] == output ? operands[1] : operands[0];
+    auto* other_transpose = other->source_node.get();
+    if (!other_transpose || other_transpose->op()->name != "transpose" || GetAxis(other_transpose) != axis ||
+        IsGraphOutput(other) || other->outlinks().size() != 1) {
+      return Step::kStopped;
+    }
+    auto* other_input = GetProducerNodeData(other_transpose)[0];
+    if (shape_dict_.at(other_input->id()) != shape_dict_.at(input->id())) {
+      return Step::kStopped;
+    }
+    ReplaceInput(consumer, other, other_input);
+    DropNode(other_transpose, other);
+    SwapWithConsumer(transpose, consumer, input, output, shape_dict_.at(input->id()));
+    return Step::kMoved;
+  }
+
+  // reduce(transpose(x, p), dims) = transpose(reduce(x, p[dims]), q), where q is p on the axes kept by the reduction
+  Step SinkThroughReduce(
+      Node* transpose, Node* consumer, NodeData* input, NodeData* output, const std::vector<int>& axis) {
+    int rank      = axis.size();
+    auto dims     = GetAttr<std::vector<int>>(consumer, "dim", {});
+    bool keep_dim = GetAttr<bool>(consumer, "keep_dim", false);
+    if (dims.empty()) {
+      return Step::kStopped;
+    }
+    std::vector<bool> reduced(rank, false);
+    std::vector<int> input_dims;
+    for (int dim : dims) {
+      dim = dim < 0 ? dim + rank : dim;
+      input_dims.push_back(axis[dim]);
+      reduced[axis[dim]] = true;
+    }
+    std::sort(input_dims.begin(), input_dims.end());
+
+    // the position of each axis of x in the output of reduce(x)
+    std::vector<int> out_pos(rank, -1);
+    shape_t reduced_shape;
+    const auto& input_shape = shape_dict_.at(input->id());
+    for (int i = 0; i < rank; ++i) {
+      if (!reduced[i] || keep_dim) {
+        out_pos[i] = reduced_shape.size();
+        reduced_shape.push_back(reduced[i] ? 1 : input_shape[i]);
+      }
+    }
+    std::vector<int> out_axis;
+    for (int i = 0; i < rank; ++i) {
+      if (!reduced[axis[i]] || keep_dim) {
+        out_axis.push_back(out_pos[axis[i]]);
+      }
+    }
+    if (reduced_shape.empty()) {
+      reduced_shape.push_back(1);
+    }
+
+    consumer->attrs.attr_store["dim"] = input_dims;
+    if (out_axis.size() <= 1 || IsIdentity(out_axis)) {
+      // the reduction leaves the axes in order, so the transpose is removed
+      VLOG(4) << "Remove " << transpose->id() << " before " << consumer->id();
+      ReplaceInput(consumer, output, input);
+      DropNode(transpose, output);
+      return Step::kRemoved;
+    }
+    transpose->attrs.attr_store["axis"] = out_axis;
+    SwapWithConsumer(transpose, consumer, input, output, reduced_shape);
+    return Step::kMoved;
+  }
+
+  Graph* graph_;
+  std::unordered_set<Node*> dropped_;
+  absl::flat_hash_map<std::string, shape_t>& shape_dict_;
+  absl::flat_hash_map<std::string, common::Type>& dtype_dict_;
+};
+
+void TransposeSinkingPassInternal(Graph* graph) {
+  VLOG(3) << "TransposeSinkingPass...!";
+  TransposeSinkingHelper transpose_sinking_helper(graph);
+  int num_eliminated = transpose_sinking_helper();
+  VLOG(3) << "TransposeSinkingPass eliminates " << num_eliminated << " transposes";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(TransposeSinkingPass) {
+  CINN_REGISTER_PASS(TransposeSinkingPass)
+      .describe(
+          "This pass sinks the transposes through the elementwise ops and the reductions until they cancel each other "
+          "or are folded into the trans_a/trans_b of a matmul.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::TransposeSinkingPassInternal);
+  return true;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+int CountOp(hlir::framework::Graph* graph, const std::string& op_name) {
+  int count = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_name) {
+      count++;
+    }
+  }
+  return count;
+}
+}  // namespace
+
+TEST(TransposeSinking, CancelThroughElementwise) {
+  NetBuilder net_builder("CancelThroughElementwise");
+  auto A = net_builder.CreateInput(Float(32), {16, 32}, "A");
+  auto B = net_builder.CreateInput(Float(32), {16, 32}, "B");
+  auto C = net_builder.Relu(net_builder.Transpose(A, {1, 0}));
+  auto D = net_builder.Add(C, net_builder.Transpose(B, {1, 0}));
+  auto E = net_builder.Transpose(net_builder.Exp(D), {1, 0});
+  auto F = net_builder.Scale(E, 2.0f);
+
+  auto fetch_ids = {F->id};
+  auto program   = net_builder.Build();
+  auto target    = common::DefaultTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransposeSinkingPass");
+
+  ASSERT_EQ(CountOp(graph.get(), "transpose"), 0);
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  ASSERT_EQ(shape_dict.at(F->id), hlir::framework::shape_t({16, 32}));
+}
+
+TEST(TransposeSinking, SinkThroughReduce) {
+  NetBuilder net_builder("SinkThroughReduce");
+  auto A = net_builder.CreateInput(Float(32), {4, 8, 16}, "A");
+  auto B = net_builder.ReduceSum(net_builder.Transpose(A, {2, 0, 1}), {1});
+  auto C = net_builder.Relu(B);
+
+  auto fetch_ids = {C->id};
+  auto program   = net_builder.Build();
+  auto target    = common::DefaultTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransposeSinkingPass");
+
+  // reduce_sum(transpose(A, [2, 0, 1]), [1]) = transpose(reduce_sum(A, [0]), [1, 0])
+  ASSERT_EQ(CountOp(graph.get(), "transpose"), 1);
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == "reduce_sum") {
+      ASSERT_EQ(absl::get<std::vector<int>>(node->attrs.attr_store.at("dim")), std::vector<int>({0}));
+    }
+  }
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  ASSERT_EQ(shape_dict.at(C->id), hlir::framework::shape_t({16, 8}));
+}
+
+TEST(TransposeSinking, FoldIntoMatmul) {
+  NetBuilder net_builder("FoldIntoMatmul");
+  auto A = net_builder.CreateInput(Float(32), {32, 16}, "A");
+  auto B = net_builder.CreateInput(Float(32), {32, 64}, "B");
+  auto C = net_builder.Matmul(net_builder.Relu(net_builder.Transpose(A, {1, 0})), B);
+
+  auto fetch_ids = {C->id};
+  auto program   = net_builder.Build();
+  auto target    = common::DefaultTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, fetch_ids, target);
+  hlir::framework::ApplyPass(graph.get(), "TransposeSinkingPass");
+
+  ASSERT_EQ(CountOp(graph.get(), "transpose"), 0);
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == "matmul") {
+      ASSERT_TRUE(absl::get<bool>(node->attrs.attr_store.at("trans_a")));
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -30,6 +30,13 @@ CINN_USE_REGISTER(CheckFusionAccuracyPass)
 CINN_USE_REGISTER(CommonSubexpressionEliminationPass)
 CINN_USE_REGISTER(TransToCustomCallPass)
 CINN_USE_REGISTER(DenseMergePass)
+CINN_USE_REGISTER(MultiTensorUpdatePass)
+CINN_USE_REGISTER(CublasLtEpiloguePass)
+CINN_USE_REGISTER(ConvImplicitGemmPass)
+CINN_USE_REGISTER(DepthwiseConvTilingPass)
+CINN_USE_REGISTER(MkldnnPostOpsPass)
 CINN_USE_REGISTER(ConstantFolding)
 CINN_USE_REGISTER(ReduceSplit)
+CINN_USE_REGISTER(TransposeSinkingPass)
 CINN_USE_REGISTER(SingleGroupOptimizePass)
+CINN_USE_REGISTER(CollectiveSchedulePass)
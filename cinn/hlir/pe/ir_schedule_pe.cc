@@ -29,25 +29,89 @@
 #include "cinn/common/target.h"
 #include "cinn/hlir/pe/load_x86_params.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule_util.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/poly/isl_utils.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(cinn_use_multi_rows_reduce);
+DECLARE_bool(cinn_cuda_thread_coarsening);
+
 namespace cinn {
 namespace hlir {
 namespace pe {
 
+// the threads of a block running a coarsened elementwise loop
+static constexpr int kCoarsenedBlockThreads = 256;
+// the bytes each thread accesses at once in a coarsened elementwise loop, the widest CUDA load
+static constexpr int kCoarsenedAccessBytes = 16;
+
+// With FLAGS_cinn_cuda_thread_coarsening, bind the flattened loop of an elementwise block as a grid-stride loop: a
+// grid of one wave of threads on all the SMs, in which each thread runs several iterations strided by the threads of
+// the grid, each accessing a vector of 16 bytes. Return false if the loop is left to be bound otherwise, which is
+// when the loop is too small to fill a wave several times or can not be split evenly into such a grid.
+static bool IRCudaCoarsenElementwiseLoop(ir::IRSchedule &ir_sch,
+                                         const Expr &block,
+                                         const Expr &loop,
+                                         const common::Target &target) {
+  if (!FLAGS_cinn_cuda_thread_coarsening) return false;
+  int num_sm = target.get_multi_processor_count();
+  if (num_sm <= 0) return false;
+  auto block_name = block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+  if (ir_sch.GetLoops(block_name).size() != 1U) return false;
+  int size = ir::GetLoopExtent(loop);
+
+  // the lanes of the vector types supported by the CUDA vectorizer
+  Type type        = ir::GetTensor(block)->type();
+  int vector_width = 1;
+  if (type.is_float(32) || type.is_float16() || type.is_bfloat16()) {
+    vector_width = std::min(kCoarsenedAccessBytes / type.bytes(), 8);
+    while (vector_width > 1 && size % vector_width != 0) {
+      vector_width /= 2;
+    }
+  }
+  if ((size / vector_width) % kCoarsenedBlockThreads != 0) return false;
+
+  // the rows of a block of threads, each row is run by a block in an iteration of a thread
+  int num_rows        = size / vector_width / kCoarsenedBlockThreads;
+  int wave_blocks     = std::max(num_sm * target.get_max_threads_per_sm() / kCoarsenedBlockThreads, 1);
+  int rows_per_thread = (num_rows + wave_blocks - 1) / wave_blocks;
+  while (rows_per_thread > 1 && num_rows % rows_per_thread != 0) {
+    --rows_per_thread;
+  }
+  if (rows_per_thread < 2) return false;
+  VLOG(3) << "Coarsen the elementwise loop of " << size << " iterations into " << num_rows / rows_per_thread
+          << " blocks, each thread runs " << rows_per_thread << " iterations of " << vector_width << " lanes";
+
+  std::vector<int> factors = {rows_per_thread, num_rows / rows_per_thread, kCoarsenedBlockThreads};
+  if (vector_width > 1) {
+    factors.push_back(vector_width);
+  }
+  auto splited = ir_sch.Split(loop, factors);
+  ir_sch.Reorder({splited[1], splited[2], splited[0]});
+  // the loops are [blocks, threads, rows of a thread, vector lanes] after reordered
+  ir_sch.Bind(ir_sch.GetLoops(block_name)[0], "blockIdx.x");
+  ir_sch.Bind(ir_sch.GetLoops(block_name)[1], "threadIdx.x");
+  if (vector_width > 1) {
+    ir_sch.Vectorize(ir_sch.GetLoops(block_name)[3], vector_width);
+  }
+  return true;
+}
+
 void IRElementwiseSchedule(ir::IRSchedule &ir_sch, const std::vector<int> &output_shape, const common::Target &target) {
   VLOG(3) << "Before IRElementwiseSchedule, new ir is : " << ir_sch.GetModule().GetExprs().at(0);
-  if (target == common::DefaultNVGPUTarget()) {
+  if (target.is_gpu()) {
     auto blocks = ir_sch.GetAllBlocks();
     ir_sch.FlattenLoops(ir_sch.GetLoops(blocks[0]), true);
 
     auto loops = ir_sch.GetLoops(blocks[0]);
     auto size  = std::accumulate(output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
-    if (size <= target.max_num_threads()) {
+    if (IRCudaCoarsenElementwiseLoop(ir_sch, blocks[0], loops[0], target)) {
+      VLOG(3) << "The elementwise loop is coarsened";
+    } else if (size <= target.max_num_threads()) {
       ir_sch.Bind(loops[0], "threadIdx.x");
     } else {
       auto splited = ir_sch.Split(loops[0], {-1, target.max_num_threads()});
@@ -64,13 +128,15 @@ void IRElementwiseSchedule(ir::IRSchedule &ir_sch, const std::vector<int> &outpu
 
 void IRInjectiveSchedule(ir::IRSchedule &ir_sch, const std::vector<int> &output_shape, const common::Target &target) {
   VLOG(3) << "Before IRInjectiveSchedule, new ir is : " << ir_sch.GetModule().GetExprs().at(0);
-  if (target == common::DefaultNVGPUTarget()) {
+  if (target.is_gpu()) {
     auto blocks = ir_sch.GetAllBlocks();
     ir_sch.FlattenLoops(ir_sch.GetLoops(blocks[0]), false);
 
     auto loops = ir_sch.GetLoops(blocks[0]);
     auto size  = std::accumulate(output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
-    if (size <= target.max_num_threads()) {
+    if (IRCudaCoarsenElementwiseLoop(ir_sch, blocks[0], loops[0], target)) {
+      VLOG(3) << "The injective loop is coarsened";
+    } else if (size <= target.max_num_threads()) {
       ir_sch.Bind(loops[0], "threadIdx.x");
     } else {
       auto splited = ir_sch.Split(loops[0], {-1, target.max_num_threads()});
@@ -91,6 +157,7 @@ void IRScheduleInjectiveCPU(ir::IRSchedule &ir_sch,
                             bool vectorizable) {
   VLOG(3) << "Begin IRScheduleInjectiveCPU" << ir_sch.GetModule().GetExprs().at(0);
   auto all_blocks = ir_sch.GetAllBlocks();
+  auto block_name = all_blocks[0].As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
   auto loops      = ir_sch.GetLoops(all_blocks[0]);
   int dims        = output_shape.size();
   int factor      = GetBasicFactor(GetTensor(all_blocks[0])->type(), target);
@@ -104,22 +171,91 @@ void IRScheduleInjectiveCPU(ir::IRSchedule &ir_sch,
     fused = ir_sch.Fuse({loops[0], loops[1]});
     dims  = dims - 1;
   }
+  IRScheduleParallelCPU(ir_sch, block_name, target);
   // This part needs to be fixed. @Haoze
-  /*   ir_sch.Parallel(fused);
-    if (vectorizable) {
+  /*  if (vectorizable) {
       auto all_blocks = ir_sch.GetAllBlocks();
       auto loops      = ir_sch.GetLoops(all_blocks[0]);
       int last_shape  = ir::GetLoopExtent(loops.back());
       factor          = GetVectorizeFactor(last_shape, factor);
       auto splited    = ir_sch.Split(loops.back(), {-1, factor});
       ir_sch.Vectorize(splited[1], factor);
-      if (dims == 1) {
-        ir_sch.Parallel(splited[0]);
-      }
     } */
   VLOG(3) << "After IRScheduleInjectiveCPU, new ir is : " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+// the parallel loop is split into several tasks per core, so that the cores finishing early balance the others
+static constexpr int kParallelTasksPerCore = 4;
+
+// Whether the loop can run in parallel for all the blocks in it, that is, each block writes to the distinct elements
+// of a global buffer in the different iterations of the loop.
+static bool IsParallelizableLoop(const Expr &loop) {
+  const auto &loop_var = loop.As<ir::For>()->loop_var;
+  auto realizes        = ir::CollectIRNodesWithoutTensor(
+      loop, [](const Expr *x) { return x->As<ir::ScheduleBlockRealize>() != nullptr; });
+  if (realizes.empty()) return false;
+  for (auto &realize : realizes) {
+    auto *block_realize = realize.As<ir::ScheduleBlockRealize>();
+    auto *block         = block_realize->schedule_block.As<ir::ScheduleBlock>();
+    auto stores =
+        ir::CollectIRNodesWithoutTensor(realize, [](const Expr *x) { return x->As<ir::Store>() != nullptr; });
+    if (stores.size() != 1U) return false;
+    auto tensor = stores.begin()->As<ir::Store>()->tensor.as_tensor_ref();
+    // the local buffers are allocated once for the whole function on CPU, which the tasks can't share
+    if (tensor->buffer.defined() && tensor->buffer->memory_type != ir::MemoryType::Heap) return false;
+    bool in_spatial_axis = false;
+    for (int i = 0; i < block_realize->iter_values.size(); ++i) {
+      if (!ContainVar({block_realize->iter_values[i]}, loop_var->name)) continue;
+      if (block->iter_vars[i]->is_reduce_axis) return false;
+      in_spatial_axis = true;
+    }
+    if (!in_spatial_axis) return false;
+  }
+  return true;
+}
+
+void IRScheduleParallelCPU(ir::IRSchedule &ir_sch, const std::string &block_name, const common::Target &target) {
+  const auto &cpu = target.cpu_info();
+  auto loops      = ir_sch.GetLoops(block_name);
+  if (cpu.num_cores <= 1 || loops.empty()) return;
+  // the nested parallel loops are not supported by the host runtime, so the nests scheduled already are left
+  for (auto &loop : loops) {
+    if (loop.As<ir::For>()->is_parallel()) return;
+  }
+
+  // a nest whose data fits in the L2 cache of a core runs faster on a single core than paying for the launch
+  auto tensor          = GetTensor(ir_sch.GetBlock(block_name));
+  int64_t num_elements = 1;
+  for (auto &loop : loops) {
+    num_elements *= ir::GetLoopExtent(loop);
+  }
+  if (num_elements * tensor->type().bytes() <= cpu.l2_cache_bytes) return;
+
+  // fuse the leading perfectly nested loops until there are enough iterations to balance the cores, the runtime
+  // gives each core a contiguous range of them. The innermost loop is left to be vectorized once all the cores are
+  // busy.
+  int min_tasks  = cpu.num_cores * kParallelTasksPerCore;
+  int num_fused  = 0;
+  int64_t extent = 1;
+  while (num_fused < loops.size() && extent < min_tasks) {
+    if (num_fused + 1 == loops.size() && num_fused > 0 && extent >= cpu.num_cores) break;
+    if (!loops[num_fused].As<ir::For>()->is_serial() || !IsParallelizableLoop(loops[num_fused])) break;
+    if (num_fused > 0) {
+      auto *body = loops[num_fused - 1].As<ir::For>()->body.As<ir::Block>();
+      if (!body || body->stmts.size() != 1 || body->stmts[0].As<ir::For>() != loops[num_fused].As<ir::For>()) break;
+    }
+    extent *= ir::GetLoopExtent(loops[num_fused]);
+    ++num_fused;
+  }
+  if (num_fused == 0 || extent < 2) return;
+
+  std::vector<Expr> fused_loops(loops.begin(), loops.begin() + num_fused);
+  auto fused = num_fused > 1 ? ir_sch.Fuse(fused_loops) : fused_loops[0];
+  ir_sch.Parallel(fused);
+  VLOG(3) << "Parallelize " << num_fused << " loops of " << block_name << " with extent " << extent << " on "
+          << cpu.num_cores << " cores";
+}
+
 void IRCudaScheduleInjective(ir::IRSchedule &ir_sch,
                              const std::vector<int> &output_shape,
                              const common::Target &target) {
@@ -131,7 +267,9 @@ void IRCudaScheduleInjective(ir::IRSchedule &ir_sch,
   int num_thread   = target.max_num_threads();
   int vector_width = 1;
   int prod_size    = std::accumulate(output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
-  if (prod_size > num_thread) {
+  if (IRCudaCoarsenElementwiseLoop(ir_sch, all_blocks[0], fused, target)) {
+    VLOG(3) << "The injective loop is coarsened";
+  } else if (prod_size > num_thread) {
     auto splited = ir_sch.Split(fused, {-1, num_thread});
     ir_sch.Bind(splited[0], "blockIdx.x");
     ir_sch.Bind(splited[1], "threadIdx.x");
@@ -144,7 +282,7 @@ void IRCudaScheduleInjective(ir::IRSchedule &ir_sch,
 std::vector<common::CINNValue> IRCudaScheduleMatMul(const common::CINNValuePack &arg_pack,
                                                     const std::vector<int> &output_shape,
                                                     const common::Target &target) {
-  if (target.arch == Target::Arch::X86) {
+  if (target.is_cpu()) {
     CINN_NOT_IMPLEMENTED
   }
   std::vector<Expr> vec_ast;
@@ -247,7 +385,7 @@ void IRCudaSplitSchedule(ir::IRSchedule &ir_sch,
     block_names.push_back(get_block_name(block));
   }
   // if output with same shape.
-  if (with_same_shape && target == common::DefaultNVGPUTarget()) {
+  if (with_same_shape && target.is_gpu()) {
     // flat loops.
     {
       auto tsize = std::accumulate(output_shapes[0].begin(), output_shapes[0].end(), 1, std::multiplies<int>());
@@ -273,7 +411,7 @@ void IRCudaSplitSchedule(ir::IRSchedule &ir_sch,
         ir_sch.SimpleComputeAt(ir_sch.GetBlock(block_names[idx]), master_loops[1]);
       }
     }
-  } else if (target == common::DefaultNVGPUTarget()) {
+  } else if (target.is_gpu()) {
     // flat loops.
     {
       for (int idx = 0; idx < block_names.size(); ++idx) {
@@ -352,6 +490,63 @@ void IRCudaScheduleReduce(ir::IRSchedule &ir_sch,
   VLOG(3) << "After IRCudaScheduleReduce : " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+// The max number of threads of a block which computes multiple rows of reduce.
+static constexpr int kMultiRowsBlockThreads = 256;
+
+// When each row of reduce is computed by a warp or a part of warp, the rows are so short that one block per row
+// leaves the most of GPU idle, so multiple rows are put into one block and bound to threadIdx.y. Return the number
+// of rows per block, 1 means one block per row is used.
+static int GetReduceRowsPerBlock(int num_rows, int row_threads, int warp_size) {
+  if (!FLAGS_cinn_use_multi_rows_reduce || row_threads > warp_size || (row_threads & (row_threads - 1)) != 0) {
+    return 1;
+  }
+  int rows_per_block = 1;
+  while (rows_per_block * 2 * row_threads <= kMultiRowsBlockThreads && num_rows % (rows_per_block * 2) == 0) {
+    rows_per_block *= 2;
+  }
+  return rows_per_block;
+}
+
+// Bind the loops [rows, row threads, ...] of tensor to [blockIdx.x, threadIdx.y, threadIdx.x, ...].
+static void BindReduceMultiRows(ir::IRSchedule &ir_sch, const std::string &tensor_name, int rows_per_block) {
+  auto loops   = ir_sch.GetLoops(tensor_name);
+  auto splited = ir_sch.Split(loops[0], {-1, rows_per_block});
+  ir_sch.Bind(splited[0], "blockIdx.x");
+  ir_sch.Bind(splited[1], "threadIdx.y");
+  loops = ir_sch.GetLoops(tensor_name);
+  ir_sch.Bind(loops[2], "threadIdx.x");
+}
+
+// The length-1 loops of the scalar output are simplified, insert a length-1 loop of it after the first statement of
+// the root block, which computes the internal tensor it reads, so that it can be bound to the gpu axis.
+static void InsertUnitLoop(ir::IRSchedule &ir_sch, const ir::Tensor &out) {
+  // block and root
+  auto out_block  = ir_sch.GetBlock(out->name);
+  auto root_block = ir_sch.GetRootBlock(out_block);
+
+  CHECK(out_block->as<ir::ScheduleBlockRealize>());
+  CHECK(out_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>());
+
+  // create var
+  auto var = ir::Var(ir::Expr(0), ir::Expr(1), common::UniqName("i"));
+  out_block->as<ir::ScheduleBlockRealize>()->iter_values.push_back(var);
+  out_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>()->iter_vars.push_back(var);
+
+  CHECK(root_block->as<ir::ScheduleBlockRealize>());
+  CHECK(root_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>());
+
+  // create for and block node
+  auto for_node =
+      ir::For::Make(var, Expr(0), Expr(1), ir::ForType::Serial, ir::DeviceAPI::UNK, ir::Block::Make({out_block}));
+  auto block_node = ir::Block::Make({root_block->as<ir::ScheduleBlockRealize>()
+                                         ->schedule_block->as<ir::ScheduleBlock>()
+                                         ->body->as<ir::Block>()
+                                         ->stmts[0],
+                                     for_node});
+
+  root_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>()->body = block_node;
+}
+
 void IRCudaScheduleBlockReduceInternal(ir::IRSchedule &ir_sch,
                                        ir::Tensor tmp_out,
                                        ir::Tensor out,
@@ -369,32 +564,7 @@ void IRCudaScheduleBlockReduceInternal(ir::IRSchedule &ir_sch,
   // as out shape size = [1], insert for in ast tree.
   if (tmp_out->shape.size() == 1) {
     CHECK_EQ(out->shape[0], Expr(1));
-
-    // block and root
-    auto out_block  = ir_sch.GetBlock(out->name);
-    auto root_block = ir_sch.GetRootBlock(out_block);
-
-    CHECK(out_block->as<ir::ScheduleBlockRealize>());
-    CHECK(out_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>());
-
-    // create var
-    auto var = ir::Var(ir::Expr(0), ir::Expr(1), common::UniqName("i"));
-    out_block->as<ir::ScheduleBlockRealize>()->iter_values.push_back(var);
-    out_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>()->iter_vars.push_back(var);
-
-    CHECK(root_block->as<ir::ScheduleBlockRealize>());
-    CHECK(root_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>());
-
-    // create for and block node
-    auto for_node =
-        ir::For::Make(var, Expr(0), Expr(1), ir::ForType::Serial, ir::DeviceAPI::UNK, ir::Block::Make({out_block}));
-    auto block_node = ir::Block::Make({root_block->as<ir::ScheduleBlockRealize>()
-                                           ->schedule_block->as<ir::ScheduleBlock>()
-                                           ->body->as<ir::Block>()
-                                           ->stmts[0],
-                                       for_node});
-
-    root_block->as<ir::ScheduleBlockRealize>()->schedule_block->as<ir::ScheduleBlock>()->body = block_node;
+    InsertUnitLoop(ir_sch, out);
 
     for (auto &tensor : {tmp_out, out}) {
       auto loops = ir_sch.GetLoops(tensor->name);
@@ -408,15 +578,23 @@ void IRCudaScheduleBlockReduceInternal(ir::IRSchedule &ir_sch,
     ir_sch.Bind(loops_tmp_out[0], "threadIdx.x");
     ir_sch.Bind(loops_out[0], "threadIdx.x");
   } else {
-    ir_sch.Bind(loops_tmp_out[0], "blockIdx.x");
-    ir_sch.Bind(loops_tmp_out[1], "threadIdx.x");
-
     if (loops_out.size() == 1) {
       ir_sch.Split(loops_out[0], {-1, 1});
     }
-    loops_out = ir_sch.GetLoops(out->name);
-    ir_sch.Bind(loops_out[0], "blockIdx.x");
-    ir_sch.Bind(loops_out[1], "threadIdx.x");
+    int rows_per_block = GetReduceRowsPerBlock(
+        ir::GetLoopExtent(loops_tmp_out[0]), ir::GetLoopExtent(loops_tmp_out[1]), target.warp_size());
+    if (rows_per_block > 1) {
+      VLOG(3) << "Reduce " << rows_per_block << " rows per block";
+      BindReduceMultiRows(ir_sch, tmp_out->name, rows_per_block);
+      BindReduceMultiRows(ir_sch, out->name, rows_per_block);
+    } else {
+      ir_sch.Bind(loops_tmp_out[0], "blockIdx.x");
+      ir_sch.Bind(loops_tmp_out[1], "threadIdx.x");
+
+      loops_out = ir_sch.GetLoops(out->name);
+      ir_sch.Bind(loops_out[0], "blockIdx.x");
+      ir_sch.Bind(loops_out[1], "threadIdx.x");
+    }
   }
 
   for (auto &tensor : {tmp_out}) {
@@ -427,6 +605,31 @@ void IRCudaScheduleBlockReduceInternal(ir::IRSchedule &ir_sch,
   VLOG(3) << "After IRCudaScheduleBlockReduceInternal : " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+void IRCudaScheduleGridReduce(ir::IRSchedule &ir_sch,
+                              ir::Tensor tmp_out,
+                              ir::Tensor out,
+                              const common::Target &target) {
+  VLOG(3) << "Before IRCudaScheduleGridReduce : " << ir_sch.GetModule().GetExprs().at(0);
+  auto loops_tmp_out = ir_sch.GetLoops(tmp_out->name);
+  CHECK_EQ(loops_tmp_out.size(), 2U);
+  ir_sch.Bind(loops_tmp_out[0], "blockIdx.x");
+  ir_sch.Bind(loops_tmp_out[1], "threadIdx.x");
+
+  // only the last block done reaches the output, whose first thread writes it.
+  if (ir_sch.GetLoops(out->name).empty()) {
+    InsertUnitLoop(ir_sch, out);
+  }
+  auto loops_out = ir_sch.GetLoops(out->name);
+  if (loops_out.size() > 1) {
+    ir_sch.Fuse(loops_out);
+  }
+  ir_sch.Bind(ir_sch.GetLoops(out->name)[0], "threadIdx.x");
+
+  auto block = ir_sch.GetBlock(tmp_out->name);
+  ir_sch.SetBuffer(block, "local", true);
+  VLOG(3) << "After IRCudaScheduleGridReduce : " << ir_sch.GetModule().GetExprs().at(0);
+}
+
 void IRCudaScheduleBlockReduce(ir::IRSchedule &ir_sch,
                                ir::Tensor reduce_tmp_out,
                                ir::Tensor tmp_out,
@@ -516,31 +719,35 @@ void IRCudaScheduleBlockReduce(ir::IRSchedule &ir_sch,
       if (ir_sch.GetLoops(tmp_out->name).size() == 1) {
         ir_sch.Split(loops[0], {b_loop, -1});
       }
-      loops = ir_sch.GetLoops(reduce_tmp_out->name);
     }
-    ir_sch.Bind(loops[0], "blockIdx.x");
-    ir_sch.Bind(loops[1], "threadIdx.x");
   }
   // tmp_out
   {
     auto loops = ir_sch.GetLoops(tmp_out->name);
     if (loops.size() < 2U) {
       ir_sch.Split(loops.back(), {b_loop, -1});
-      loops = ir_sch.GetLoops(tmp_out->name);
     }
-
-    ir_sch.Bind(loops[0], "blockIdx.x");
-    ir_sch.Bind(loops[1], "threadIdx.x");
   }
   // out
   {
     auto loops = ir_sch.GetLoops(out->name);
     if (loops.size() < 2U) {
       ir_sch.Split(loops.back(), {-1, 1});
-      loops = ir_sch.GetLoops(out->name);
     }
-    ir_sch.Bind(loops[0], "blockIdx.x");
-    ir_sch.Bind(loops[1], "threadIdx.x");
+  }
+  int rows_per_block =
+      GetReduceRowsPerBlock(b_loop, ir::GetLoopExtent(ir_sch.GetLoops(tmp_out->name)[1]), target.warp_size());
+  if (rows_per_block > 1) {
+    VLOG(3) << "Reduce " << rows_per_block << " rows per block";
+  }
+  for (auto &tensor : {reduce_tmp_out, tmp_out, out}) {
+    if (rows_per_block > 1) {
+      BindReduceMultiRows(ir_sch, tensor->name, rows_per_block);
+    } else {
+      auto loops = ir_sch.GetLoops(tensor->name);
+      ir_sch.Bind(loops[0], "blockIdx.x");
+      ir_sch.Bind(loops[1], "threadIdx.x");
+    }
   }
 
   for (auto &tensor : {reduce_tmp_out, tmp_out}) {
@@ -955,6 +1162,111 @@ void IRGlobalPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &targe
   VLOG(3) << "After IRGlobalPoolScheduleGPU: " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+// Restore the unit loops eliminated in the lowering process by the constant iter values in the ScheduleBlock, until
+// the block has num_loops loops.
+static void RestoreUnitLoops(ir::IRSchedule &ir_sch, const std::string &block_name, int num_loops) {
+  auto loops = ir_sch.GetLoops(block_name);
+  while (static_cast<int>(loops.size()) < num_loops) {
+    auto iter_values = ir_sch.GetBlock(block_name).As<ir::ScheduleBlockRealize>()->iter_values;
+    int index        = 0;
+    while (index < loops.size() && !iter_values[index].is_constant()) {
+      ++index;
+    }
+    CHECK_LT(index, loops.size()) << "Can't restore the unit loops of " << block_name;
+    ir_sch.Split(loops[index], {1, -1});
+    loops = ir_sch.GetLoops(block_name);
+  }
+}
+
+// The lanes of the widest CUDA vector over the channels of the channels-last layout, which divide the channels.
+static int GetChannelsLastVectorLanes(int channels, const Type &type) {
+  if (!(type.is_float(32) || type.is_int(32) || type.is_float16() || type.is_bfloat16())) return 1;
+  int lanes = std::min(kCoarsenedAccessBytes / type.bytes(), 8);
+  while (lanes > 1 && channels % lanes != 0) {
+    lanes /= 2;
+  }
+  return lanes;
+}
+
+void IRCudaScheduleResizeNHWC(ir::IRSchedule &ir_sch, const common::Target &target) {
+  VLOG(3) << "Begin IRCudaScheduleResizeNHWC with expr: " << ir_sch.GetModule().GetExprs().at(0);
+  auto all_blocks = ir_sch.GetAllBlocks();
+  CHECK_EQ(all_blocks.size(), 1U);
+  auto output = GetTensor(all_blocks[0]);
+  CHECK_EQ(output->shape.size(), 4U);
+  std::string out_name = output->name;
+  int lanes            = GetChannelsLastVectorLanes(output->shape[3].as_int32(), output->type());
+
+  // (n, oh, ow, c) -> (n * oh * ow * c_o, c_v)
+  RestoreUnitLoops(ir_sch, out_name, 4);
+  auto loops = ir_sch.GetLoops(out_name);
+  ir_sch.Split(loops[3], {-1, lanes});
+  loops      = ir_sch.GetLoops(out_name);
+  auto fused = ir_sch.Fuse({loops[0], loops[1], loops[2], loops[3]});
+  int size   = ir::GetLoopExtent(fused);
+  ir_sch.Split(fused, {-1, std::min(size, kCoarsenedBlockThreads)});
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[0], "blockIdx.x");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[1], "threadIdx.x");
+  if (lanes > 1) {
+    loops = ir_sch.GetLoops(out_name);
+    ir_sch.Vectorize(loops[2], lanes);
+  }
+  VLOG(3) << "After IRCudaScheduleResizeNHWC with expr: " << ir_sch.GetModule().GetExprs().at(0);
+}
+
+// the most elements a thread pools in the unrolled windows of its output columns and channels
+static constexpr int kMaxUnrolledPoolElements = 256;
+
+void IRCudaSchedulePoolNHWC(ir::IRSchedule &ir_sch,
+                            const std::string &out_name,
+                            const std::vector<int> &kernel_size,
+                            const std::vector<int> &stride_size,
+                            const common::Target &target) {
+  VLOG(3) << "Begin IRCudaSchedulePoolNHWC with expr: " << ir_sch.GetModule().GetExprs().at(0);
+  CHECK_EQ(kernel_size.size(), 2U);
+  CHECK_EQ(stride_size.size(), 2U);
+  auto output = GetTensor(ir_sch.GetBlock(out_name));
+  CHECK_EQ(output->shape.size(), 4U);
+  int out_w = output->shape[2].as_int32();
+  int lanes = GetChannelsLastVectorLanes(output->shape[3].as_int32(), output->type());
+  // The adjacent output columns of a thread share kernel_w - stride_w input columns if the windows overlap
+  int reg_w = stride_size[1] < kernel_size[1] ? 4 : 1;
+  while (out_w % reg_w != 0) {
+    reg_w /= 2;
+  }
+
+  // The initialization shares the spatial loops with the pooling, (n, oh, ow, c) -> (n * oh * ow_o * c_o, ow_r, c_v)
+  std::string init_name = ir::GenReduceInitTensorNameOf(out_name);
+  RestoreUnitLoops(ir_sch, init_name, 4);
+  auto loops = ir_sch.GetLoops(init_name);
+  ir_sch.Split(loops[3], {-1, lanes});
+  loops = ir_sch.GetLoops(init_name);
+  ir_sch.Split(loops[2], {-1, reg_w});
+  loops = ir_sch.GetLoops(init_name);
+  ir_sch.Reorder({loops[4], loops[3]});
+  loops      = ir_sch.GetLoops(init_name);
+  auto fused = ir_sch.Fuse({loops[0], loops[1], loops[2], loops[3]});
+  int size   = ir::GetLoopExtent(fused);
+  ir_sch.Split(fused, {-1, std::min(size, kCoarsenedBlockThreads)});
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[0], "blockIdx.x");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[1], "threadIdx.x");
+
+  // Each thread pools the adjacent channels of the adjacent output columns, which are unrolled with a small window,
+  // so that the input elements are loaded once for the overlapped windows and the adjacent channels.
+  int num_unrolled = ir_sch.GetLoops(out_name).size();
+  if (kernel_size[0] * kernel_size[1] * reg_w * lanes > kMaxUnrolledPoolElements) {
+    num_unrolled = 4;
+  }
+  for (int i = 2; i < num_unrolled; ++i) {
+    ir_sch.Unroll(ir_sch.GetLoops(out_name)[i]);
+  }
+  VLOG(3) << "After IRCudaSchedulePoolNHWC with expr: " << ir_sch.GetModule().GetExprs().at(0);
+}
+
 void IRCudaScheduleDepthwiseConv(ir::IRSchedule &ir_sch, const std::vector<ir::Expr> &tensors) {
   if (tensors.size() == 3U) {
     CHECK(tensors[1].as_tensor());
@@ -978,6 +1290,114 @@ void IRCudaScheduleDepthwiseConv(ir::IRSchedule &ir_sch, const std::vector<ir::E
   VLOG(3) << "After IRCudaScheduleDepthwiseConv with expr: " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+bool IsTiledDepthwiseConv(int filter_h, int filter_w, int stride_h, int stride_w) {
+  return filter_h == filter_w && (filter_h == 3 || filter_h == 5) && stride_h == stride_w &&
+         (stride_h == 1 || stride_h == 2);
+}
+
+void IRCudaScheduleDepthwiseConvTiled(ir::IRSchedule &ir_sch,
+                                      const std::string &pad_name,
+                                      const std::string &acc_name,
+                                      const std::string &out_name,
+                                      int filter_size,
+                                      int stride) {
+  VLOG(3) << "Begin IRCudaScheduleDepthwiseConvTiled with expr: " << ir_sch.GetModule().GetExprs().at(0);
+  CHECK(IsTiledDepthwiseConv(filter_size, filter_size, stride, stride))
+      << "No tile of depthwise conv is specialized for the filter size " << filter_size << " and stride " << stride;
+  // The adjacent output columns of a thread share filter_size - stride input columns, so the stride of 1 keeps more
+  // of them in registers. The wider filter needs a wider halo of the shared input tile, so its tile is narrower.
+  int reg_w        = stride == 1 ? 4 : 2;
+  int max_thread_x = filter_size == 3 ? 32 : 16;
+  int max_thread_y = stride == 1 ? 8 : 4;
+
+  auto output = GetTensor(ir_sch.GetBlock(out_name));
+  CHECK_EQ(output->shape.size(), 4U);
+  int out_h = output->shape[2].as_int32();
+  int out_w = output->shape[3].as_int32();
+  while (out_w % reg_w != 0) {
+    reg_w /= 2;
+  }
+  int thread_x = GetMaxSplitter(out_w / reg_w, max_thread_x);
+  int thread_y = GetMaxSplitter(out_h, max_thread_y);
+  VLOG(4) << "The tile of depthwise conv is " << thread_y << " x " << thread_x * reg_w << " by " << thread_y << " x "
+          << thread_x << " threads";
+
+  // (n, c, oh, ow) -> (n * c, oh_o, ow_o, oh_i, ow_t, ow_r)
+  auto tile_output_loops = [&](const std::string &block_name) {
+    RestoreUnitLoops(ir_sch, block_name, 4);
+    auto loops = ir_sch.GetLoops(block_name);
+    CHECK_EQ(loops.size(), 4U);
+    ir_sch.Split(loops[3], {-1, thread_x, reg_w});
+    loops = ir_sch.GetLoops(block_name);
+    ir_sch.Split(loops[2], {-1, thread_y});
+    loops = ir_sch.GetLoops(block_name);
+    ir_sch.Reorder({loops[4], loops[3]});
+    loops = ir_sch.GetLoops(block_name);
+    ir_sch.Fuse({loops[0], loops[1]});
+  };
+
+  auto pad_block = ir_sch.GetBlock(pad_name);
+  ir_sch.SetBuffer(pad_block, "shared");
+  auto acc_block = ir_sch.GetBlock(acc_name);
+  ir_sch.SetBuffer(acc_block, "local");
+  // the reads of the accumulator are itself, the padded input and the filter
+  acc_block         = ir_sch.GetBlock(acc_name);
+  auto filter_cache = ir_sch.CacheRead(acc_block, 2, "local");
+  auto filter_name  = GetTensor(filter_cache)->name;
+
+  std::string init_name = ir::GenReduceInitTensorNameOf(acc_name);
+  tile_output_loops(out_name);
+  tile_output_loops(init_name);
+
+  // the accumulator of a thread is (ow_r, rh, rw), which is reordered to (rh, rw, ow_r) to reuse each filter element
+  auto loops = ir_sch.GetLoops(out_name);
+  ir_sch.ComputeAt(ir_sch.GetBlock(acc_name), loops[4]);
+  loops = ir_sch.GetLoops(acc_name);
+  if (reg_w > 1) {
+    CHECK_EQ(loops.size(), 8U);
+    ir_sch.Reorder({loops[6], loops[7], loops[5]});
+  }
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.SimpleComputeAt(ir_sch.GetBlock(init_name), loops[4]);
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.ComputeAt(ir_sch.GetBlock(filter_name), loops[4]);
+
+  // every thread block loads its padded input tile by all of its threads
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.ComputeAt(ir_sch.GetBlock(pad_name), loops[2]);
+  loops = ir_sch.GetLoops(pad_name);
+  CHECK_EQ(loops.size(), 5U);
+  ir_sch.Fuse({loops[3], loops[4]});
+  loops = ir_sch.GetLoops(pad_name);
+  ir_sch.Split(loops[3], {-1, thread_y, thread_x});
+  loops = ir_sch.GetLoops(pad_name);
+  ir_sch.Bind(loops[5], "threadIdx.x");
+  loops = ir_sch.GetLoops(pad_name);
+  ir_sch.Bind(loops[4], "threadIdx.y");
+  loops = ir_sch.GetLoops(pad_name);
+  ir_sch.SyncThreads(loops[3], true);
+
+  // the filter and the accumulator are indexed by constants after unrolled, so they are kept in registers
+  for (auto &block_name : {filter_name, init_name, acc_name, out_name}) {
+    int num_loops = ir_sch.GetLoops(block_name).size();
+    for (int i = 5; i < num_loops; ++i) {
+      ir_sch.Unroll(ir_sch.GetLoops(block_name)[i]);
+    }
+  }
+
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[0], "blockIdx.x");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[1], "blockIdx.y");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[2], "blockIdx.z");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[3], "threadIdx.y");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[4], "threadIdx.x");
+  VLOG(3) << "After IRCudaScheduleDepthwiseConvTiled with expr: " << ir_sch.GetModule().GetExprs().at(0);
+}
+
 void IRCudaScheduleConv(ir::IRSchedule &ir_sch, const common::Target &target) {
   VLOG(3) << "Begin IRCudaScheduleConv with expr: " << ir_sch.GetModule().GetExprs().at(0);
   auto &res = ScheduleParam::get_cuda_instance().GetParam();
@@ -1218,6 +1638,61 @@ void IRCudaScheduleConv2(ir::IRSchedule &ir_sch,
   VLOG(3) << "After IRCudaScheduleConv2, expr is: " << ir_sch.GetModule().GetExprs().at(0);
 }
 
+void IRCudaScheduleConv2dImplicitGemm(ir::IRSchedule &ir_sch,
+                                      const std::string &acc_name,
+                                      const std::string &out_name) {
+  VLOG(3) << "Begin IRCudaScheduleConv2dImplicitGemm with expr: " << ir_sch.GetModule().GetExprs().at(0);
+  constexpr int kTile = ir::kTensorCoreFragmentSize;
+  ir::MatmulBlockPattern pattern;
+  CHECK(ir::MatchMatmulBlock(ir_sch.GetBlock(acc_name), &pattern))
+      << "The implicit GEMM of " << acc_name << " is not matmul-like, its stride of width should be 1";
+  std::string intrin_name = ir::GetMatmulTensorizeIntrin(pattern);
+  CHECK(!intrin_name.empty()) << "No Tensor Core intrinsic computes the implicit GEMM of " << acc_name;
+
+  // the loops of the accumulator are (n, oh, ow, co, rh, rw, rc), where ow, co and rc are the M, N and K of the GEMM
+  auto loops = ir_sch.GetLoops(acc_name);
+  CHECK_EQ(loops.size(), 7U);
+  ir_sch.Split(loops[6], {-1, kTile});
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Split(loops[3], {-1, kTile});
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Split(loops[2], {-1, kTile});
+  // reorder from (n, oh, ow_o, ow_i, co_o, co_i, rh, rw, rc_o, rc_i) to (n, oh, ow_o, co_o, rh, rw, rc_o, ow_i, co_i,
+  // rc_i), so the filter window and the input channels are all accumulated to the same tile
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Reorder({loops[4], loops[6], loops[7], loops[8], loops[3], loops[5], loops[9]});
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Tensorize(loops[7], intrin_name);
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Bind(loops[3], "blockIdx.y");
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Bind(loops[2], "blockIdx.z");
+  loops = ir_sch.GetLoops(acc_name);
+  ir_sch.Bind(ir_sch.Fuse({loops[0], loops[1]}), "blockIdx.x");
+
+  // the epilogue walks the same tile of each block, whose columns beyond the output width are skipped
+  loops = ir_sch.GetLoops(out_name);
+  CHECK_EQ(loops.size(), 4U);
+  ir_sch.Split(loops[3], {-1, kTile});
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Reorder({loops[3], loops[2]});
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Split(loops[3], {-1, kTile});
+  // (n, oh, co_o, ow_o, ow_i, co_i)
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[5], "threadIdx.x");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[3], "blockIdx.z");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(loops[2], "blockIdx.y");
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.Bind(ir_sch.Fuse({loops[0], loops[1]}), "blockIdx.x");
+  // the tile of the accumulator is stored by the fragments of the whole warp
+  loops = ir_sch.GetLoops(out_name);
+  ir_sch.SyncThreads(loops[0], false);
+  VLOG(3) << "After IRCudaScheduleConv2dImplicitGemm, expr: " << ir_sch.GetModule().GetExprs().at(0);
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
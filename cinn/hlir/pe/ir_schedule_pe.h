@@ -40,6 +40,13 @@ void IRScheduleInjectiveCPU(ir::IRSchedule &ir_sch,
                             const common::Target &target,
                             bool vectorizable = true);
 
+/**
+ * Parallelize the loops of the block by the cores of the host CPU described by \p target. The leading spatial loops
+ * are fused until there are a few iterations for each core, and the nests small enough for the L2 cache of a single
+ * core or scheduled parallel already are left serial.
+ */
+void IRScheduleParallelCPU(ir::IRSchedule &ir_sch, const std::string &block_name, const common::Target &target);
+
 void IRCudaScheduleInjective(ir::IRSchedule &ir_sch,
                              const std::vector<int> &output_shape,
                              const common::Target &target);
@@ -70,6 +77,11 @@ void IRCudaScheduleBlockReduceInternal(ir::IRSchedule &ir_sch,
                                        ir::Tensor out,
                                        const common::Target &target);
 
+void IRCudaScheduleGridReduce(ir::IRSchedule &ir_sch,
+                              ir::Tensor tmp_out,
+                              ir::Tensor out,
+                              const common::Target &target);
+
 void IRCudaScheduleBlockShuffleReduce(
     ir::IRSchedule &ir_sch, ir::Tensor reshape, ir::Tensor internal, ir::Tensor out, const common::Target &target);
 
@@ -86,8 +98,40 @@ void IRPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &target, int
 
 void IRCudaScheduleDepthwiseConv(ir::IRSchedule &ir_sch, const std::vector<ir::Expr> &tensors);
 
+// Whether IRCudaScheduleDepthwiseConvTiled has a tile specialized for the filter size and the stride.
+bool IsTiledDepthwiseConv(int filter_h, int filter_w, int stride_h, int stride_w);
+
+/**
+ * Schedule the depthwise convolution of Depthwise_Conv2d_NCHW_Epilogue with a square filter of 3x3 or 5x5 and a stride
+ * of 1 or 2. Each thread block computes a tile of output rows and columns of one channel, whose padded input tile is
+ * staged in shared memory. Each thread keeps the filter of the channel in registers and accumulates a few adjacent
+ * output columns in registers, and the epilogue is applied when they are written to the output.
+ */
+void IRCudaScheduleDepthwiseConvTiled(ir::IRSchedule &ir_sch,
+                                      const std::string &pad_name,
+                                      const std::string &acc_name,
+                                      const std::string &out_name,
+                                      int filter_size,
+                                      int stride);
+
 void IRGlobalPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &target);
 
+/**
+ * Schedule the resize of the NHWC layout, each thread computes a vector of the adjacent channels of an output pixel,
+ * which share the interpolation coefficients computed from the row and the column of the pixel.
+ */
+void IRCudaScheduleResizeNHWC(ir::IRSchedule &ir_sch, const common::Target &target);
+
+/**
+ * Schedule the pool2d of the NHWC layout, whose padding is inlined. Each thread pools the adjacent channels of a few
+ * adjacent output columns, whose overlapped windows are unrolled to reuse the loaded input elements.
+ */
+void IRCudaSchedulePoolNHWC(ir::IRSchedule &ir_sch,
+                            const std::string &out_name,
+                            const std::vector<int> &kernel_size,
+                            const std::vector<int> &stride_size,
+                            const common::Target &target);
+
 void IRCudaScheduleConv2(ir::IRSchedule &ir_sch,
                          ir::Tensor &input_pad,
                          ir::Tensor &weights,
@@ -97,6 +141,13 @@ void IRCudaScheduleConv2(ir::IRSchedule &ir_sch,
 
 void IRCudaScheduleConv(ir::IRSchedule &ir_sch, const common::Target &target);
 
+/**
+ * Schedule the implicit GEMM convolution of Conv2d_NHWC_ImplicitGemm. Each thread block computes a tile of 16 output
+ * columns and 16 output channels of the accumulator by a warp of Tensor Core fragments, then computes the epilogue of
+ * the same tile after a __syncthreads.
+ */
+void IRCudaScheduleConv2dImplicitGemm(ir::IRSchedule &ir_sch, const std::string &acc_name, const std::string &out_name);
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -33,6 +33,10 @@
 #include "cinn/lang/compute.h"
 #include "cinn/optim/ir_copy.h"
 
+#ifdef CINN_WITH_MKLDNN
+#include "cinn/runtime/cpu/mkldnn_math.h"
+#endif
+
 namespace cinn {
 namespace hlir {
 namespace pe {
@@ -491,6 +495,38 @@ std::vector<ir::Tensor> Conv2d_NCHWc(const ir::Tensor &input,
 }
 
 #ifdef CINN_WITH_MKLDNN
+int GetMkldnnDataType(const Type &type) {
+  if (type.is_float(32)) {
+    return cinn_mkldnn_f32;
+  } else if (type.is_bfloat16()) {
+    return cinn_mkldnn_bf16;
+  } else if (type.is_uint(8)) {
+    return cinn_mkldnn_u8s8;
+  } else if (type.is_int(8)) {
+    return cinn_mkldnn_s8s8;
+  }
+  LOG(FATAL) << "The mkldnn primitives don't support the data type " << type;
+  return cinn_mkldnn_f32;
+}
+
+Type GetMkldnnOutType(int data_type, const Type &type) {
+  if (data_type == cinn_mkldnn_u8s8) {
+    return Float(32);
+  } else if (data_type == cinn_mkldnn_s8s8) {
+    return Int(32);
+  }
+  return type;
+}
+
+int GetMkldnnPostOp(const std::string &post_op) {
+  static const absl::flat_hash_map<std::string, int> post_ops = {{"", cinn_mkldnn_post_op_none},
+                                                                 {"relu", cinn_mkldnn_post_op_relu},
+                                                                 {"sigmoid", cinn_mkldnn_post_op_sigmoid},
+                                                                 {"tanh", cinn_mkldnn_post_op_tanh}};
+  CHECK(post_ops.count(post_op)) << "The mkldnn primitives don't support the post op " << post_op;
+  return post_ops.at(post_op);
+}
+
 std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            const ir::Tensor &weights,
                                            int pad_h,
@@ -499,41 +535,54 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            int stride_w,
                                            int dilation_h,
                                            int dilation_w,
-                                           const std::string &output_name) {
+                                           const std::string &output_name,
+                                           const std::string &post_op,
+                                           bool constant_weights) {
   CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of Conv2d_NCHW op is not 4! Please check.";
   CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of Conv2d_NCHW op is not 4! Please check.";
-  std::vector<Expr> output_shape;
-  std::vector<Expr> new_weights_shape;
-  std::vector<Expr> input_pad_shape;
   int group = input->shape[1].as_int32() / weights->shape[1].as_int32();
   CHECK_EQ(input->shape[1].as_int32(), weights->shape[1].as_int32() * group)
       << "input channel should be divisible by filter channel";
+  int data_type = GetMkldnnDataType(input->type());
+  if (data_type == cinn_mkldnn_u8s8 || data_type == cinn_mkldnn_s8s8) {
+    CHECK(weights->type().is_int(8)) << "The int8 conv2d requires int8 weights, but got " << weights->type();
+  } else {
+    CHECK_EQ(input->type(), weights->type()) << "The input and weights of conv2d should have the same type";
+  }
+  int layout       = cinn_mkldnn_nchw;
+  int post_op_type = GetMkldnnPostOp(post_op);
+
   auto call = Compute(
       {Expr(1)},
       [=]() -> Expr {
-        return lang::CallExtern("cinn_cpu_mkldnn_conv2d_nchw_fp32",
+        return lang::CallExtern("cinn_cpu_mkldnn_conv2d",
                                 {
-                                    Expr(input->shape[0]),    // batch_size
-                                    Expr(input->shape[1]),    // c_in
-                                    Expr(input->shape[2]),    // input_h
-                                    Expr(input->shape[3]),    // input_w
-                                    Expr(weights->shape[0]),  // c_out
-                                    Expr(group),              // group
-                                    Expr(weights->shape[2]),  // filter_h
-                                    Expr(weights->shape[3]),  // filter_w
-                                    Expr(pad_h),              // pad_h
-                                    Expr(pad_w),              // pad_w
-                                    Expr(stride_h),           // stride_h
-                                    Expr(stride_w),           // stride_w
-                                    Expr(dilation_h),         // dilation_h
-                                    Expr(dilation_w),         // dilation_w
-                                    input,                    // input
-                                    weights                   // weights
+                                    Expr(data_type),                      // data_type
+                                    Expr(layout),                         // layout
+                                    Expr(post_op_type),                   // post_op
+                                    Expr(1.f),                            // scale
+                                    common::make_bool(constant_weights),  // constant_weights
+                                    Expr(input->shape[0]),                // batch_size
+                                    Expr(input->shape[1]),                // c_in
+                                    Expr(input->shape[2]),                // input_h
+                                    Expr(input->shape[3]),                // input_w
+                                    Expr(weights->shape[0]),              // c_out
+                                    Expr(group),                          // group
+                                    Expr(weights->shape[2]),              // filter_h
+                                    Expr(weights->shape[3]),              // filter_w
+                                    Expr(pad_h),                          // pad_h
+                                    Expr(pad_w),                          // pad_w
+                                    Expr(stride_h),                       // stride_h
+                                    Expr(stride_w),                       // stride_w
+                                    Expr(dilation_h),                     // dilation_h
+                                    Expr(dilation_w),                     // dilation_w
+                                    input,                                // input
+                                    weights                               // weights
                                 });
       },
       UniqName("conv2d_nchw_mkldnn_out"));
   auto out = call->TupleGet(0);
-  out->WithBuffer(input->type());
+  out->WithBuffer(GetMkldnnOutType(data_type, input->type()));
   return {out, call};
 }
 #endif
@@ -603,6 +652,63 @@ std::vector<ir::Tensor> Conv2d_NHWC(const ir::Tensor &input,
   return {res, input_pad, weights_dilation};
 }
 
+std::vector<ir::Tensor> Conv2d_NHWC_ImplicitGemm(const ir::Tensor &input,
+                                                 const ir::Tensor &weights,
+                                                 const ir::Tensor &bias,
+                                                 const ir::Tensor &residual,
+                                                 int stride_h,
+                                                 int stride_w,
+                                                 int dilation_h,
+                                                 int dilation_w,
+                                                 int output_width,
+                                                 bool relu,
+                                                 const std::string &output_name,
+                                                 const std::string &acc_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of Conv2d_NHWC_ImplicitGemm is not 4! Please check.";
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of Conv2d_NHWC_ImplicitGemm is not 4! Please check.";
+  CHECK(MathEqual(input->shape[3], weights->shape[2]))
+      << "The input channels of Conv2d_NHWC_ImplicitGemm should be equal to the filter's! Please check.";
+  std::vector<Expr> output_shape = {
+      input->shape[0],                                                                      // N
+      Expr((input->shape[1] - ((weights->shape[0] - 1) * dilation_h + 1)) / stride_h + 1),  // H
+      Expr((input->shape[2] - ((weights->shape[1] - 1) * dilation_w + 1)) / stride_w + 1),  // W
+      weights->shape[3]                                                                     // C_out
+  };
+  Var rh(weights->shape[0], UniqName("rh"));
+  Var rw(weights->shape[1], UniqName("rw"));
+  Var rc(weights->shape[2], UniqName("rc"));
+  // the row of the im2col matrix is (n, oh, ow) and its column is (rh, rw, rc)
+  auto acc = Compute(
+      output_shape,
+      [=](Expr nn, Expr yy, Expr xx, Expr ff) {
+        return lang::ReduceSum(
+            ir::Cast::Make(Float(32), input(nn, yy * stride_h + rh * dilation_h, xx * stride_w + rw * dilation_w, rc)) *
+                ir::Cast::Make(Float(32), weights(rh, rw, rc, ff)),
+            {rh, rw, rc});
+      },
+      acc_name);
+  if (output_width > 0) {
+    output_shape[2] = Expr(output_width);
+  }
+  auto res = Compute(
+      output_shape,
+      [=](Expr nn, Expr yy, Expr xx, Expr ff) {
+        Expr value = acc(nn, yy, xx, ff);
+        if (bias.defined()) {
+          value = value + ir::Cast::Make(Float(32), bias(ff));
+        }
+        if (residual.defined()) {
+          value = value + ir::Cast::Make(Float(32), residual(nn, yy, xx, ff));
+        }
+        if (relu) {
+          value = ir::Max::Make(value, make_const(Float(32), 0));
+        }
+        return ir::Cast::Make(input->type(), value);
+      },
+      output_name);
+  return {res, acc};
+}
+
 std::vector<Tensor> Depthwise_Conv2d_NCHW(const Tensor &input,
                                           const Tensor &weight,
                                           int pad_h,
@@ -650,6 +756,40 @@ std::vector<Tensor> Depthwise_Conv2d_NCHW(const Tensor &input,
   return {res, input_pad};
 }
 
+std::vector<Tensor> Depthwise_Conv2d_NCHW_Epilogue(const Tensor &input,
+                                                   const Tensor &weight,
+                                                   const Tensor &bias,
+                                                   int pad_h,
+                                                   int pad_w,
+                                                   int stride_h,
+                                                   int stride_w,
+                                                   const std::string &activation,
+                                                   const std::string &output_name,
+                                                   const std::string &acc_name) {
+  CHECK(activation.empty() || activation == "relu" || activation == "relu6")
+      << "The activation of Depthwise_Conv2d_NCHW_Epilogue should be relu or relu6, but here " << activation;
+  auto conv = Depthwise_Conv2d_NCHW(input, weight, pad_h, pad_w, stride_h, stride_w, acc_name);
+  CHECK_EQ(conv.size(), 2U);
+  auto acc = conv[0];
+  auto res = Compute(
+      acc->shape,
+      [=](Expr nn, Expr ff, Expr yy, Expr xx) {
+        Expr value = acc(nn, ff, yy, xx);
+        if (bias.defined()) {
+          value = value + bias(ff);
+        }
+        if (!activation.empty()) {
+          value = ir::Max::Make(value, make_const(value.type(), 0));
+        }
+        if (activation == "relu6") {
+          value = ir::Min::Make(value, make_const(value.type(), 6));
+        }
+        return value;
+      },
+      output_name);
+  return {res, acc, conv[1]};
+}
+
 std::vector<Tensor> Depthwise_Conv2d_NHWC(const Tensor &input,
                                           const Tensor &weight,
                                           int pad_h,
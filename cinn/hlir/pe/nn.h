@@ -167,6 +167,23 @@ std::vector<ir::Tensor> Conv2d_NCHWc(const ir::Tensor &input,
                                      const common::Target &target   = common::DefaultHostTarget());
 
 #ifdef CINN_WITH_MKLDNN
+//! Return the cinn_mkldnn_data_type_t of the oneDNN primitives taking the input of the given type.
+int GetMkldnnDataType(const Type &type);
+
+//! Return the output type of the oneDNN primitives of the given cinn_mkldnn_data_type_t and input type.
+Type GetMkldnnOutType(int data_type, const Type &type);
+
+//! Return the cinn_mkldnn_post_op_t of the elementwise op name, "" means no post-op.
+int GetMkldnnPostOp(const std::string &post_op);
+
+/**
+ * @brief Perform a 2-D convolution by oneDNN, the input may be float32, bfloat16, or uint8 and int8 with int8 weights.
+ *
+ * @param post_op The elementwise op fused into the output of the convolution, "relu", "sigmoid", "tanh" or ""
+ * @param constant_weights Whether the weights are constant, they are reordered once and reused by the later runs
+ *
+ * @return the output tensor, float32 for the uint8 input, and the tensor of the extern call
+ */
 std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            const ir::Tensor &weights,
                                            int pad_h,
@@ -175,7 +192,9 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            int stride_w,
                                            int dilation_h,
                                            int dilation_w,
-                                           const std::string &output_name = UniqName("T_Conv2d_NCHW_out"));
+                                           const std::string &output_name = UniqName("T_Conv2d_NCHW_out"),
+                                           const std::string &post_op     = "",
+                                           bool constant_weights          = false);
 #endif
 
 /**
@@ -204,6 +223,41 @@ std::vector<ir::Tensor> Conv2d_NHWC(const ir::Tensor &input,
                                     int dilation_w,
                                     const std::string &output_name = UniqName("T_Conv2d_NHWC_out"));
 
+/**
+ * @brief Perform a 2-D convolution with an NHWC-layout as the implicit GEMM of
+ * [N * out_h * out_w, filter_h * filter_w * C_in] x [filter_h * filter_w * C_in, C_out]. The im2col matrix is not
+ * materialized, its elements are addressed from the padded input on the fly, and the products are accumulated in
+ * float32 so that the GEMM can be tensorized by the Tensor Core intrinsics.
+ *
+ * @param input The 4-D padded input tensor {N, H, W, C_in}
+ * @param weights The 4-D weight tensor {filter_h, filter_w, C_in, C_out}
+ * @param bias The optional 1-D bias tensor {C_out} added to the output, undefined if not exists
+ * @param residual The optional 4-D residual tensor of the output shape added after the bias, undefined if not exists
+ * @param stride_h striding applied to the height of the image
+ * @param stride_w striding applied to the width of the image
+ * @param dilation_h dilation applied to the height of the image
+ * @param dilation_w dilation applied to the width of the image
+ * @param output_width The width of the output, which is less than the accumulator's if the input is padded after the
+ * width to align the accumulator to the tiles, or -1 to keep the whole accumulator
+ * @param relu whether to apply relu after the bias and residual added
+ * @param output_name The name of the output tensor
+ * @param acc_name The name of the float32 accumulator tensor
+ *
+ * @return {output, accumulator}, the output is cast back to the input type after the epilogue
+ */
+std::vector<ir::Tensor> Conv2d_NHWC_ImplicitGemm(const ir::Tensor &input,
+                                                 const ir::Tensor &weights,
+                                                 const ir::Tensor &bias,
+                                                 const ir::Tensor &residual,
+                                                 int stride_h,
+                                                 int stride_w,
+                                                 int dilation_h,
+                                                 int dilation_w,
+                                                 int output_width,
+                                                 bool relu,
+                                                 const std::string &output_name = UniqName("T_ImplicitGemm_out"),
+                                                 const std::string &acc_name    = UniqName("T_ImplicitGemm_acc"));
+
 /**
  * @brief Perform a 2-D depthwise convolution with an NCHW-layout
  *
@@ -226,6 +280,34 @@ std::vector<ir::Tensor> Depthwise_Conv2d_NCHW(const ir::Tensor &input,
                                               int stride_w,
                                               const std::string output_name = UniqName("T_depthwise_conv2d_nchw"));
 
+/**
+ * @brief Perform a 2-D depthwise convolution with an NCHW-layout, whose products are accumulated in a separate tensor
+ * and the bias and activation after it are applied when the accumulator is written to the output.
+ *
+ * @param input The 4-D input tensor {N, C_in, H, W}
+ * @param weight The 4-D weight tensor {C_in, channel_multiplier, filter_h, filter_w}
+ * @param bias The optional 1-D bias tensor {C_in * channel_multiplier}, undefined if not exists
+ * @param pad_h padding counts applied to the height of the image, before and after (symmetric padding)
+ * @param pad_w padding counts applied to the width of the image, before and after (symmetric padding)
+ * @param stride_h striding applied to the height of the image
+ * @param stride_w striding applied to the width of the image
+ * @param activation The activation applied after the bias, which is "relu", "relu6" or empty
+ * @param output_name The name of the output tensor
+ * @param acc_name The name of the accumulator tensor
+ *
+ * @return {output, accumulator, padded input}
+ */
+std::vector<ir::Tensor> Depthwise_Conv2d_NCHW_Epilogue(const ir::Tensor &input,
+                                                       const ir::Tensor &weight,
+                                                       const ir::Tensor &bias,
+                                                       int pad_h,
+                                                       int pad_w,
+                                                       int stride_h,
+                                                       int stride_w,
+                                                       const std::string &activation,
+                                                       const std::string &output_name = UniqName("T_depthwise_out"),
+                                                       const std::string &acc_name    = UniqName("T_depthwise_acc"));
+
 /**
  * @brief Perform a 2-D depthwise convolution with an NHWC-layout
  *
@@ -17,6 +17,8 @@
 #include <cinn/ir/ir_base.h>
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
 
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
@@ -27,8 +29,11 @@
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
 #include "cinn/lang/compute.h"
+#include "cinn/runtime/flags.h"
 #include "cinn/utils/string.h"
 
+DECLARE_int32(cinn_grid_reduce_threshold);
+
 namespace cinn {
 namespace hlir {
 namespace pe {
@@ -36,6 +41,13 @@ namespace pe {
 using ir::Tensor;
 using lang::Compute;
 
+namespace {
+// The GPU target of the build, whose device and warp size the reduce computes on GPU follow.
+const common::Target& GpuTarget() {
+  return common::DefaultTarget().is_gpu() ? common::DefaultTarget() : common::DefaultNVGPUTarget();
+}
+}  // namespace
+
 /**
  * @brief transform reduction axes which could be empty or have negative elements into real axes with valid dimension
  * indices.
@@ -242,7 +254,7 @@ std::vector<Tensor> WarpReduce(const ir::Tensor& A,
 
   // comput tmp output shape.
   std::vector<Expr> tmp_shape(A->shape.begin(), A->shape.begin() + shape_size_without_reduce_dim);
-  tmp_shape.push_back(Expr(32));
+  tmp_shape.push_back(Expr(GpuTarget().warp_size()));
   auto tmp_out = Compute(
       tmp_shape,
       [=](const std::vector<Expr>& indexs) -> Expr {
@@ -676,7 +688,8 @@ std::vector<ir::Tensor> TwoStepBlockReduceInternal(const ir::Tensor& A,
   // If the number of current device SM is smaller than the number of SM
   // required by Warp Reduce, the performance of Warp Reduce is better.
   // Otherwise, use Block Reduce.
-  auto max_num_threads       = common::DefaultNVGPUTarget().max_num_threads();
+  auto& target               = GpuTarget();
+  auto max_num_threads       = target.max_num_threads();
   int need_reduce_last_count = 1;
   for (int i = 0; i < A->shape.size(); i++) {
     if (find(axes.begin(), axes.end(), i) == axes.end()) {
@@ -684,10 +697,10 @@ std::vector<ir::Tensor> TwoStepBlockReduceInternal(const ir::Tensor& A,
     }
   }
   int warp_reduce_need_sm_count =
-      ceil((need_reduce_last_count * 32) / float(common::DefaultNVGPUTarget().get_max_threads_per_sm()));
-  // Set Num_max_threads to 32 is Warp Reduce
-  if (common::DefaultNVGPUTarget().get_multi_processor_count() < warp_reduce_need_sm_count) {
-    max_num_threads = 32;
+      ceil((need_reduce_last_count * target.warp_size()) / float(target.get_max_threads_per_sm()));
+  // Set Num_max_threads to the warp size is Warp Reduce
+  if (target.get_multi_processor_count() < warp_reduce_need_sm_count) {
+    max_num_threads = target.warp_size();
   }
 
   int lane  = A->shape[axes.back()].as_int32();
@@ -879,6 +892,75 @@ std::vector<ir::Tensor> TwoStepBlockReduceAny(const ir::Tensor& A,
   return TwoStepBlockReduceInternal(A, axes, keep_dim, output_name, ReduceAny, BlockReduceAnyInternal, Expr(false));
 }
 
+bool UseGridReduce(const std::vector<int>& shape, const std::vector<int>& axes, const common::Target& target) {
+  if (!target.is_gpu() || FLAGS_cinn_grid_reduce_threshold <= 0) {
+    return false;
+  }
+  if (!axes.empty() && axes.size() != shape.size()) {
+    return false;
+  }
+  int64_t numel = std::accumulate(shape.begin(), shape.end(), int64_t(1), std::multiplies<int64_t>());
+  return numel >= FLAGS_cinn_grid_reduce_threshold;
+}
+
+// the threads of a block, and the max number of blocks, which is the size of the device workspace of the grid reduce
+constexpr int kGridReduceThreads   = 256;
+constexpr int kGridReduceMaxBlocks = 1024;
+// each thread reduces at least this number of elements before the block reduce
+constexpr int kGridReduceMinElementsPerThread = 16;
+
+std::vector<ir::Tensor> GridReduce(const ir::Tensor& A,
+                                   const std::vector<int>& axes,
+                                   const bool keep_dim,
+                                   const std::string& reduce_type,
+                                   const std::string& output_name) {
+  CHECK_EQ(axes.size(), A->shape.size()) << "The grid reduce should reduce all the axes!";
+  int numel = 1;
+  for (auto& dim : A->shape) {
+    numel *= dim.as_int32();
+  }
+  int num_blocks = (numel + kGridReduceThreads * kGridReduceMinElementsPerThread - 1) /
+                   (kGridReduceThreads * kGridReduceMinElementsPerThread);
+  num_blocks     = std::min(num_blocks, kGridReduceMaxBlocks);
+  // the partial results are reduced in a different order with a different number of blocks, so the number of blocks
+  // can't depend on the device in the deterministic mode.
+  if (!(runtime::IsCompiledWithCUDNN() && runtime::GetCinnCudnnDeterministic())) {
+    auto& target          = GpuTarget();
+    int max_active_blocks = target.get_multi_processor_count() * target.get_max_threads_per_sm() / kGridReduceThreads;
+    num_blocks            = std::min(num_blocks, std::max(max_active_blocks, 1));
+  }
+  VLOG(4) << "Grid reduce " << output_name << " of " << numel << " elements by " << num_blocks << " blocks";
+
+  auto tmp_out = Compute(
+      {Expr(num_blocks), Expr(kGridReduceThreads)},
+      [=](const std::vector<Expr>& indexs) -> Expr {
+        return lang::CallExtern(reduce_type, {A, Expr(0), Expr(numel)});
+      },
+      UniqName(output_name + "_tmp"));
+
+  std::vector<Expr> out_shape(keep_dim ? A->shape.size() : 1, Expr(1));
+  auto out = Compute(
+      out_shape,
+      [=](const std::vector<Expr>& indexs) -> Expr { return tmp_out(Expr(0), Expr(0)); },
+      output_name);
+  return {out, tmp_out};
+}
+
+#define GRID_REDUCE(name, reduce_type)                                                                          \
+  std::vector<ir::Tensor> GridReduce##name(                                                                     \
+      const ir::Tensor& A, const std::vector<int>& axes, const bool keep_dim, const std::string& output_name) { \
+    return GridReduce(A, axes, keep_dim, reduce_type, output_name);                                             \
+  }
+
+GRID_REDUCE(Sum, "cinn_grid_reduce_sum" + Type2StrForReduce(A->type()));
+GRID_REDUCE(Prod, "cinn_grid_reduce_prod" + Type2StrForReduce(A->type()));
+GRID_REDUCE(Max, "cinn_grid_reduce_max" + Type2StrForReduce(A->type()));
+GRID_REDUCE(Min, "cinn_grid_reduce_min" + Type2StrForReduce(A->type()));
+GRID_REDUCE(All, "cinn_grid_reduce_all");
+GRID_REDUCE(Any, "cinn_grid_reduce_any");
+
+#undef GRID_REDUCE
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
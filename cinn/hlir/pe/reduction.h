@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
 
 namespace cinn {
@@ -414,6 +415,59 @@ std::vector<ir::Tensor> TwoStepBlockReduceAny(const ir::Tensor& A,
                                               const std::vector<int>& axes,
                                               const bool keep_dim,
                                               const std::string& output_name = "T_Reduce_Any_out");
+
+/**
+ * @brief whether to compute the reduction of the input shape over the axes by the grid reduce, which is used on NVGPU
+ * when all the elements are reduced and their number reaches FLAGS_cinn_grid_reduce_threshold.
+ *
+ * @param shape The shape of the input Tensor.
+ * @param axes the reduce axes, empty means all the axes.
+ * @param target The target to compute the reduction.
+ */
+bool UseGridReduce(const std::vector<int>& shape, const std::vector<int>& axes, const common::Target& target);
+
+/**
+ * @brief compute the value of all the array elements by the grid reduce in a single kernel. Each block reduces a
+ *        grid-stride part of the input into the device workspace, and the last block done reduces the partial results
+ *        in the order of the blocks, so there is neither a second kernel nor a temporary tensor. The number of blocks
+ *        only depends on the number of elements when the deterministic mode(FLAGS_cinn_cudnn_deterministic) is on,
+ *        so the result is the same on all the devices, otherwise it is also bounded by the resident blocks of the
+ *        device. The returned tensors are the output and the internal tensor computed by the blocks.
+ *
+ * @param A The input Tensor.
+ * @param axes the reduce axes, which should be all the axes of A.
+ * @param keep_dim keep the output tensor shape size as input.
+ * @param output_name The name of the output Tensor.
+ */
+std::vector<ir::Tensor> GridReduceSum(const ir::Tensor& A,
+                                      const std::vector<int>& axes,
+                                      const bool keep_dim,
+                                      const std::string& output_name = "T_Reduce_Sum_out");
+
+std::vector<ir::Tensor> GridReduceProd(const ir::Tensor& A,
+                                       const std::vector<int>& axes,
+                                       const bool keep_dim,
+                                       const std::string& output_name = "T_Reduce_Prod_out");
+
+std::vector<ir::Tensor> GridReduceMax(const ir::Tensor& A,
+                                      const std::vector<int>& axes,
+                                      const bool keep_dim,
+                                      const std::string& output_name = "T_Reduce_Max_out");
+
+std::vector<ir::Tensor> GridReduceMin(const ir::Tensor& A,
+                                      const std::vector<int>& axes,
+                                      const bool keep_dim,
+                                      const std::string& output_name = "T_Reduce_Min_out");
+
+std::vector<ir::Tensor> GridReduceAll(const ir::Tensor& A,
+                                      const std::vector<int>& axes,
+                                      const bool keep_dim,
+                                      const std::string& output_name = "T_Reduce_All_out");
+
+std::vector<ir::Tensor> GridReduceAny(const ir::Tensor& A,
+                                      const std::vector<int>& axes,
+                                      const bool keep_dim,
+                                      const std::string& output_name = "T_Reduce_Any_out");
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -85,6 +85,11 @@ int SplitEven(int origin) {
 }
 
 int GetBasicFactor(const Type &type, const common::Target &target) {
+  // a row of the register tile on AArch64 spans two vector registers, so that the 32 vector registers hold the tile
+  // of several rows and the loads of the other operand
+  if (target.arch == common::Target::Arch::ARM) {
+    return 2 * target.arm_vector_bits() / type.bits();
+  }
   int target_native_vector_bits = target.get_target_bits() * 8;
   int type_bits                 = type.bits();
   return target_native_vector_bits / type_bits;
@@ -607,7 +612,8 @@ void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       const common::Target &target,
                       const std::string &key,
                       bool import_params) {
-  if (import_params) {
+  // the saved params are tuned on x86
+  if (import_params && target.arch == common::Target::Arch::X86) {
     auto &params = ScheduleParam::get_x86_instance().GetParam();
     if (params.count(key)) {
       VLOG(3) << "find saved param, key is: " << key;
@@ -835,7 +841,7 @@ void Conv2d_NCHWc_1X1_Schedule_CPU(poly::StageMap stages,
                                    const common::Target &target,
                                    const std::string &key,
                                    bool do_padding) {
-  CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_1X1_Schedule_CPU schedule only used in x86";
+  CHECK(target.is_cpu()) << "Conv2d_NCHWc_1X1_Schedule_CPU schedule only used in cpu";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
@@ -963,7 +969,7 @@ void Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(poly::StageMap stages,
                                           const ir::Tensor &weights_dilation,
                                           const ir::Tensor &data,
                                           const common::Target &target) {
-  CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse schedule only used in x86";
+  CHECK(target.is_cpu()) << "Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse schedule only used in cpu";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
@@ -1068,7 +1074,7 @@ void Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                       const ir::Tensor &weights_dilation,
                                       const ir::Tensor &data,
                                       const common::Target &target) {
-  CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_Schedule_CPU_Nofuse schedule only used in x86";
+  CHECK(target.is_cpu()) << "Conv2d_NCHWc_Schedule_CPU_Nofuse schedule only used in cpu";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
@@ -1162,7 +1168,7 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
                                const common::Target &target,
                                const std::string &key,
                                bool do_padding) {
-  CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_Schedule_CPU schedule only used in x86";
+  CHECK(target.is_cpu()) << "Conv2d_NCHWc_Schedule_CPU schedule only used in cpu";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
@@ -1277,7 +1283,7 @@ void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                                 const ir::Tensor &data,
                                                 const common::Target &target,
                                                 bool do_padding) {
-  CHECK(target.arch == Target::Arch::X86) << "Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse schedule only used in x86";
+  CHECK(target.is_cpu()) << "Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse schedule only used in cpu";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
@@ -2250,7 +2256,7 @@ void CudaSplitSchedule(common::CINNValuePack *arg_pack,
     if (i != axis) fused_shape = fused_shape * output_shapes[0][i];
   }
   int compute_at_level = 0;
-  if (target.arch == Target::Arch::NVGPU) {
+  if (target.is_gpu()) {
     if (fused_shape > target.max_num_threads()) {
       stages[last_output]->Split(0, target.max_num_threads());
       stages[last_output]->Bind(0, "blockIdx.x");
@@ -22,12 +22,17 @@
 #include "cinn/common/ir_util.h"
 #include "cinn/hlir/op/op_util.h"
 #include "cinn/hlir/pe/elementwise.h"
+#include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
 #include "cinn/lang/compute.h"
 #include "cinn/utils/string.h"
 
+#ifdef CINN_WITH_MKLDNN
+#include "cinn/runtime/cpu/mkldnn_math.h"
+#endif
+
 namespace cinn {
 namespace hlir {
 namespace pe {
@@ -385,6 +390,25 @@ ir::Tensor Concat(const ir::Tensor& A, const ir::Tensor& B, int axis, const std:
   return res;
 }
 
+// Select the input of the element by the binary search over the offsets of the inputs [begin, end) on the axis, so
+// each element evaluates log2(end - begin) comparisons instead of a select chain over all the inputs.
+static Expr SelectConcatInput(const std::vector<ir::Tensor>& input_tensors,
+                              const std::vector<Expr>& offsets,
+                              int axis,
+                              const std::vector<Expr>& indice,
+                              int begin,
+                              int end) {
+  if (end - begin == 1) {
+    std::vector<Expr> new_indice = indice;
+    new_indice[axis]             = indice[axis] - offsets[begin];
+    return input_tensors[begin](new_indice);
+  }
+  int mid = (begin + end) / 2;
+  return ir::Select::Make(indice[axis] < offsets[mid],
+                          SelectConcatInput(input_tensors, offsets, axis, indice, begin, mid),
+                          SelectConcatInput(input_tensors, offsets, axis, indice, mid, end));
+}
+
 ir::Tensor Concat(const std::vector<ir::Tensor>& input_tensors, int axis, const std::string& name) {
   int input_size = input_tensors.size();
   CHECK_GE(input_size, 2U) << "Concat should have at least 2 input tensors";
@@ -400,18 +424,16 @@ ir::Tensor Concat(const std::vector<ir::Tensor>& input_tensors, int axis, const
     output_shape[axis] = common::AutoSimplify(output_shape[axis] + input_tensors[i]->shape[axis]);
   }
 
+  // the offset of each input on the axis
+  std::vector<Expr> offsets(1, Expr(0));
+  for (int i = 0; i < input_size - 1; i++) {
+    offsets.push_back(common::AutoSimplify(offsets.back() + input_tensors[i]->shape[axis]));
+  }
+
   auto res = Compute(
       output_shape,
       [=](const std::vector<Expr>& indice) {
-        auto ret              = input_tensors[0](indice);
-        Expr accumulate_shape = Expr(0);
-        for (int i = 0; i < input_size - 1; i++) {
-          accumulate_shape             = common::AutoSimplify(accumulate_shape + input_tensors[i]->shape[axis]);
-          std::vector<Expr> new_indice = indice;
-          new_indice[axis]             = indice[axis] - accumulate_shape;
-          ret = ir::Select::Make(indice[axis] < accumulate_shape, ret, input_tensors[i + 1](new_indice));
-        }
-        return ret;
+        return SelectConcatInput(input_tensors, offsets, axis, indice, 0, input_size);
       },
       name);
   return res;
@@ -586,6 +608,133 @@ std::vector<Tensor> MatmulMKL(const Tensor& A,
   return {out, call};
 }
 
+std::vector<Tensor> MatmulPacked(const Tensor& A,
+                                 const Tensor& B,
+                                 bool trans_a,
+                                 bool trans_b,
+                                 float alpha,
+                                 bool constant_b,
+                                 const std::string& name,
+                                 const common::Target& target) {
+  CHECK(target.is_cpu()) << "packed gemm should be used in the cpu environment";
+  std::vector<Expr> shape_A = A->shape;
+  std::vector<Expr> shape_B = B->shape;
+  CHECK_EQ(shape_A.size(), 2U) << "tensor_A's dim should be 2 while current dim is " << shape_A.size();
+  CHECK_EQ(shape_B.size(), 2U) << "tensor_B's dim should be 2 while current dim is " << shape_B.size();
+
+  Expr x_width  = trans_a ? shape_A[0] : shape_A[1];
+  Expr y_height = trans_b ? shape_B[1] : shape_B[0];
+  Expr M        = trans_a ? shape_A[1] : shape_A[0];
+  Expr N        = trans_b ? shape_B[0] : shape_B[1];
+  CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+
+  bool is_int8 = A->type().is_int(8) || A->type().is_uint(8);
+  ir::Tensor call;
+  if (is_int8) {
+    CHECK(B->type().is_int(8)) << "the int8 matmul requires B to be int8, but got " << B->type();
+    CHECK(!trans_a) << "the int8 matmul doesn't support transposing A";
+    CHECK_EQ(alpha, 1.f) << "the int8 matmul doesn't support alpha";
+    call = Compute(
+        {Expr(1)},
+        [=]() -> Expr {
+          return lang::CallExtern("cinn_cpu_packed_gemm_int8",
+                                  {
+                                      M,                                      // M
+                                      N,                                      // N
+                                      x_width,                                // K
+                                      common::make_bool(A->type().is_int()),  // a_signed
+                                      common::make_bool(trans_b),             // tb
+                                      shape_A.back(),                         // lda
+                                      shape_B.back(),                         // ldb
+                                      N,                                      // ldc
+                                      common::make_bool(constant_b),          // constant_b
+                                      A,                                      // A
+                                      B,                                      // B
+                                  });
+        },
+        UniqName("matmul_packed_out"));
+  } else {
+    CHECK(A->type().is_float(32) && B->type().is_float(32))
+        << "the packed matmul supports float32 and int8, but got " << A->type() << " and " << B->type();
+    call = Compute(
+        {Expr(1)},
+        [=]() -> Expr {
+          return lang::CallExtern("cinn_cpu_packed_gemm_fp32",
+                                  {
+                                      Expr(alpha),                     // alpha
+                                      M,                               // M
+                                      N,                               // N
+                                      x_width,                         // K
+                                      common::make_bool(trans_a),      // ta
+                                      common::make_bool(trans_b),      // tb
+                                      shape_A.back(),                  // lda
+                                      shape_B.back(),                  // ldb
+                                      N,                               // ldc
+                                      common::make_bool(constant_b),   // constant_b
+                                      A,                               // A
+                                      B,                               // B
+                                  });
+        },
+        UniqName("matmul_packed_out"));
+  }
+  auto out = call->TupleGet(0);
+  out->WithBuffer(is_int8 ? Int(32) : A->type());
+  return {out, call};
+}
+
+#ifdef CINN_WITH_MKLDNN
+std::vector<Tensor> MatmulMKLDNN(const Tensor& A,
+                                 const Tensor& B,
+                                 bool trans_a,
+                                 bool trans_b,
+                                 float alpha,
+                                 const std::string& post_op,
+                                 const std::string& name,
+                                 const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "mkldnn should be used in the cpu environment";
+  std::vector<Expr> shape_A = A->shape;
+  std::vector<Expr> shape_B = B->shape;
+  CHECK_EQ(shape_A.size(), 2U) << "tensor_A's dim should be 2 while current dim is " << shape_A.size();
+  CHECK_EQ(shape_B.size(), 2U) << "tensor_B's dim should be 2 while current dim is " << shape_B.size();
+
+  Expr x_width  = trans_a ? shape_A[0] : shape_A[1];
+  Expr y_height = trans_b ? shape_B[1] : shape_B[0];
+  Expr M        = trans_a ? shape_A[1] : shape_A[0];
+  Expr N        = trans_b ? shape_B[0] : shape_B[1];
+  CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+
+  int data_type    = GetMkldnnDataType(A->type());
+  int post_op_type = GetMkldnnPostOp(post_op);
+  if (data_type == cinn_mkldnn_u8s8 || data_type == cinn_mkldnn_s8s8) {
+    CHECK(B->type().is_int(8)) << "the int8 matmul requires B to be int8, but got " << B->type();
+  } else {
+    CHECK_EQ(A->type(), B->type()) << "the inputs of matmul should have the same type";
+  }
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_mkldnn_matmul",
+                                {
+                                    Expr(data_type),             // data_type
+                                    Expr(post_op_type),          // post_op
+                                    Expr(alpha),                 // alpha
+                                    M,                           // M
+                                    N,                           // N
+                                    x_width,                     // K
+                                    common::make_bool(trans_a),  // ta
+                                    common::make_bool(trans_b),  // tb
+                                    A,                           // A
+                                    B,                           // B
+                                });
+      },
+      UniqName("matmul_mkldnn_out"));
+  auto out = call->TupleGet(0);
+  out->WithBuffer(GetMkldnnOutType(data_type, A->type()));
+  return {out, call};
+}
+#endif
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target) {
   int split_base   = GetBasicFactor(type, target);
   int split_factor = 1;
@@ -608,7 +757,7 @@ std::vector<Tensor> MulBase(const Tensor& A, const Tensor& B, const std::string&
   output_shape.push_back(A->shape[0]);
   output_shape.push_back(B->shape[0]);
 
-  if (target.arch == Target::Arch::X86) {
+  if (target.is_cpu()) {
     int reduce_dim   = A->shape[1].as_int32();
     int split_factor = GetMulFactor(reduce_dim, A->type(), target);
     Var reduce_k_first(ir::Cast::Make(A->shape[1]->type(), Expr(reduce_dim / split_factor)),
@@ -1086,9 +1235,9 @@ ir::Tensor ScatterAssign(const ir::Tensor& input,
                          const std::string& output_name) {
   CHECK_EQ(index->type(), common::Int(32)) << "Param [Index] of ScatterAssign only support int32 ! Please Check.\n";
   std::string extern_fun_name;
-  if (target.arch == common::Target::Arch::NVGPU) {
+  if (target.is_gpu()) {
     extern_fun_name.assign("cinn_cuda_find_int");
-  } else if (target.arch == common::Target::Arch::X86) {
+  } else if (target.is_cpu()) {
     extern_fun_name.assign("cinn_host_find_int");
   } else {
     LOG(FATAL) << "ScatterAssign only support X86 and NVGPU ! Please Check.\n";
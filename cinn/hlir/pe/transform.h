@@ -89,6 +89,45 @@ std::vector<ir::Tensor> MatmulMKL(const ir::Tensor& A,
                                   const std::string& name      = UniqName("T_Transform_MatmulMKL_out"),
                                   const common::Target& target = common::DefaultHostTarget());
 
+#ifdef CINN_WITH_MKLDNN
+/**
+ * @brief Matrix multiplication by the oneDNN matmul primitive with an elementwise post-op fused into its output.
+ *
+ * @param A The first input tensor, [M, K] or [K, M] if trans_a, float32, bfloat16 or uint8
+ * @param B The second input tensor, [K, N] or [N, K] if trans_b, the same type as A, or int8 if A is uint8
+ * @param post_op The elementwise op fused into the output, "relu", "sigmoid", "tanh" or ""
+ *
+ * @return the output tensor, float32 for the uint8 inputs, and the tensor of the extern call
+ */
+std::vector<ir::Tensor> MatmulMKLDNN(const ir::Tensor& A,
+                                     const ir::Tensor& B,
+                                     bool trans_a                 = false,
+                                     bool trans_b                 = false,
+                                     float alpha                  = 1,
+                                     const std::string& post_op   = "",
+                                     const std::string& name      = UniqName("T_Transform_MatmulMKLDNN_out"),
+                                     const common::Target& target = common::DefaultHostTarget());
+#endif
+
+/**
+ * @brief Matrix multiplication by the packed GEMM of the x86 runtime, which multiplies the packed panels of A and B
+ * with a register-blocked micro-kernel on the threads of the parallel backend.
+ *
+ * @param A The first input tensor, [M, K] or [K, M] if trans_a, float32, or int8/uint8 without trans_a
+ * @param B The second input tensor, [K, N] or [N, K] if trans_b, float32 or int8 as A
+ * @param constant_b Whether B is a constant weight, its packed panels are made once and reused by the later runs
+ *
+ * @return the output tensor, float32 or int32 for the int8 inputs, and the tensor of the extern call
+ */
+std::vector<ir::Tensor> MatmulPacked(const ir::Tensor& A,
+                                     const ir::Tensor& B,
+                                     bool trans_a                 = false,
+                                     bool trans_b                 = false,
+                                     float alpha                  = 1,
+                                     bool constant_b              = false,
+                                     const std::string& name      = UniqName("T_Transform_MatmulPacked_out"),
+                                     const common::Target& target = common::DefaultHostTarget());
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target);
 
 /**
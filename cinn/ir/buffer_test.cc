@@ -16,11 +16,14 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/backends/codegen_c.h"
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
+#include "cinn/ir/lowered_func.h"
 #include "cinn/ir/module.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/buffer.h"
@@ -82,5 +85,30 @@ TEST(Buffer, bind_to_multiple_tensors) {
   std::cout << "codegen C:" << std::endl << out << std::endl;
 }
 
+TEST(Buffer, cuda_dynamic_shared_memory) {
+  auto make_shared_buffer = [](const std::string& name, Type dtype, int numel) {
+    auto buffer         = _Buffer_::Make(name, dtype);
+    buffer->shape       = {Expr(numel)};
+    buffer->memory_type = MemoryType::GPUShared;
+    return buffer;
+  };
+  LoweredFunc func(make_shared<_LoweredFunc_>());
+  func->name = "fn";
+
+  // 32 KB in total are kept in the static shared memory
+  func->temp_bufs = {make_shared_buffer("A_shared", Float(32), 4096), make_shared_buffer("B_shared", Float(16), 8192)};
+  ASSERT_EQ(func->CudaDynamicSharedMemBytes(), 0);
+
+  // the 2 bytes of C_shared are padded to 16 bytes before the next buffer
+  func->temp_bufs = {make_shared_buffer("C_shared", Float(16), 1),
+                     make_shared_buffer("A_shared", Float(32), 16384),
+                     make_shared_buffer("B_shared", Float(16), 8192)};
+  std::unordered_map<std::string, int> offsets;
+  ASSERT_EQ(func->CudaDynamicSharedMemBytes(&offsets), 81936);
+  ASSERT_EQ(offsets.at("C_shared"), 0);
+  ASSERT_EQ(offsets.at("A_shared"), 16);
+  ASSERT_EQ(offsets.at("B_shared"), 65552);
+}
+
 }  // namespace ir
 }  // namespace cinn
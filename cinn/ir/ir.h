@@ -985,6 +985,10 @@ constexpr const char* compute_at_extra_var = "compute_at_extra_var";
 constexpr const char* reverse_compute_at_extra_var = "reverse_compute_at_extra_var";
 // record the cooperative process info, used in post schedule rule(CooperativeProcess)
 constexpr const char* cooperative_process = "cooperative_process";
+// record the tensor core intrinsic which the block body is replaced with, used in Tensorize
+constexpr const char* tensorize_intrin = "tensorize_intrin";
+// record the number of stages to pipeline the shared buffer written by the block in its loop, used in SoftwarePipeline
+constexpr const char* software_pipeline_stages = "software_pipeline_stages";
 
 }  // namespace attr
 
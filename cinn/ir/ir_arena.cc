@@ -0,0 +1,119 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <new>
+
+DECLARE_bool(cinn_use_ir_arena);
+
+namespace cinn {
+namespace ir {
+
+namespace {
+thread_local IrArena* current_arena = nullptr;
+
+constexpr uint32_t kHeapClass = static_cast<uint32_t>(-1);
+}  // namespace
+
+IrArena* IrArena::Current() { return current_arena; }
+
+void* IrArena::Allocate(size_t size) {
+  IrArena* arena = current_arena;
+  if (arena && size + sizeof(Header) <= kMaxPoolSize) {
+    return arena->AllocateInArena(size);
+  }
+  auto* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+  if (!header) throw std::bad_alloc();
+  header->arena      = nullptr;
+  header->size_class = kHeapClass;
+  return header + 1;
+}
+
+void IrArena::Deallocate(void* p) {
+  if (!p) return;
+  auto* header = static_cast<Header*>(p) - 1;
+  if (!header->arena) {
+    std::free(header);
+    return;
+  }
+  header->arena->DeallocateInArena(header);
+}
+
+void* IrArena::AllocateInArena(size_t size) {
+  size_t size_class = (size + sizeof(Header) - 1) / kAlignment;
+  size_t bytes      = (size_class + 1) * kAlignment;
+  live_.fetch_add(1, std::memory_order_relaxed);
+
+  Header* header = nullptr;
+  if (free_lists_[size_class]) {
+    header                  = static_cast<Header*>(free_lists_[size_class]);
+    free_lists_[size_class] = *reinterpret_cast<void**>(header + 1);
+  } else {
+    if (remain_ < bytes) {
+      chunks_.push_back(static_cast<char*>(std::malloc(kChunkSize)));
+      if (!chunks_.back()) throw std::bad_alloc();
+      cursor_ = chunks_.back();
+      remain_ = kChunkSize;
+    }
+    header = reinterpret_cast<Header*>(cursor_);
+    cursor_ += bytes;
+    remain_ -= bytes;
+  }
+  header->arena      = this;
+  header->size_class = size_class;
+  return header + 1;
+}
+
+void IrArena::DeallocateInArena(Header* header) {
+  // only the owner thread reuses the block, the ones freed by the other threads are released with the whole arena
+  if (current_arena == this) {
+    *reinterpret_cast<void**>(header + 1) = free_lists_[header->size_class];
+    free_lists_[header->size_class]       = header;
+  }
+  Unref();
+}
+
+void IrArena::Unref() {
+  if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+IrArena::~IrArena() {
+  for (char* chunk : chunks_) std::free(chunk);
+}
+
+IrArenaScope::IrArenaScope(bool enable) : prev_(current_arena) {
+  if (enable && FLAGS_cinn_use_ir_arena) {
+    arena_ = new IrArena;
+  }
+  current_arena = arena_;
+}
+
+IrArenaScope::~IrArenaScope() {
+  current_arena = prev_;
+  if (arena_) {
+    VLOG(4) << "Exit the IR arena with " << arena_->num_live_nodes() << " live nodes in "
+            << arena_->num_chunk_bytes() << " bytes";
+    arena_->Unref();
+  }
+}
+
+}  // namespace ir
+}  // namespace cinn
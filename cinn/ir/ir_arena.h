@@ -0,0 +1,103 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cinn {
+namespace ir {
+
+/**
+ * The memory of the IR nodes created in a compilation, such as lowering a group and generating the code of its module.
+ *
+ * The nodes are carved from large chunks instead of malloc one by one, and the memory of a freed node is reused by the
+ * later nodes of the same size on the owner thread. The nodes are still reference counted, an arena counts its live
+ * nodes and releases all the chunks as a whole when the last one is freed after its scope exits, so the nodes escaped
+ * from the compilation keep the arena alive.
+ */
+class IrArena {
+ public:
+  IrArena(const IrArena&) = delete;
+  IrArena& operator=(const IrArena&) = delete;
+
+  //! Allocate the memory of a node of \p size bytes in the arena of the current thread, or in the heap if no arena is
+  //! active.
+  static void* Allocate(size_t size);
+  //! Free the memory of a node allocated by Allocate.
+  static void Deallocate(void* p);
+
+  //! The arena activated by the innermost IrArenaScope of the current thread, nullptr if none.
+  static IrArena* Current();
+
+  //! The number of the nodes alive in this arena.
+  int64_t num_live_nodes() const { return live_.load() - 1; }
+  //! The bytes of the chunks held by this arena.
+  size_t num_chunk_bytes() const { return chunks_.size() * kChunkSize; }
+
+ private:
+  friend class IrArenaScope;
+
+  //! The header ahead of each node, which keeps the max alignment of the node.
+  struct alignas(16) Header {
+    IrArena* arena;
+    uint32_t size_class;
+  };
+
+  static constexpr size_t kAlignment   = 16;
+  static constexpr size_t kChunkSize   = 256 * 1024;
+  static constexpr size_t kNumClasses  = 32;
+  static constexpr size_t kMaxPoolSize = kAlignment * kNumClasses;
+
+  IrArena() = default;
+  ~IrArena();
+
+  void* AllocateInArena(size_t size);
+  void DeallocateInArena(Header* header);
+  //! Drop a reference of the scope or a node, delete the arena when it is the last one.
+  void Unref();
+
+  std::vector<char*> chunks_;
+  char* cursor_{};
+  size_t remain_{};
+  //! The freed blocks of each size class, only touched by the owner thread while the arena is active.
+  void* free_lists_[kNumClasses]{};
+  //! The live nodes plus one for the scope.
+  std::atomic<int64_t> live_{1};
+};
+
+/**
+ * Activate a new arena for the IR nodes created on the current thread in the lifetime of this scope, the previous
+ * arena is restored at exit. The nodes are allocated in the heap if \p enable is false, which is used by the caches
+ * holding IR nodes longer than a compilation.
+ */
+class IrArenaScope {
+ public:
+  explicit IrArenaScope(bool enable = true);
+  ~IrArenaScope();
+
+  IrArenaScope(const IrArenaScope&) = delete;
+  IrArenaScope& operator=(const IrArenaScope&) = delete;
+
+  IrArena* arena() const { return arena_; }
+
+ private:
+  IrArena* prev_{};
+  IrArena* arena_{};
+};
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace ir {
+
+TEST(IrArena, interned_imm) {
+  EXPECT_TRUE(Expr(1).same_as(Expr(1)));
+  EXPECT_TRUE(Expr(int64_t(-3)).same_as(Expr(int64_t(-3))));
+  EXPECT_TRUE(Expr(0.f).same_as(Expr(0.f)));
+  EXPECT_TRUE(Expr(true).same_as(Expr(true)));
+  EXPECT_TRUE(IsInternedImm(Expr(1024).ptr()));
+  // the types and the values are kept apart
+  EXPECT_FALSE(Expr(1).same_as(Expr(int64_t(1))));
+  EXPECT_FALSE(Expr(0.f).same_as(Expr(-0.f)));
+  EXPECT_FALSE(Expr(100000).same_as(Expr(100000)));
+  EXPECT_FALSE(IsInternedImm(Expr(100000).ptr()));
+
+  Expr e = Expr(2) + Expr(3);
+  Expr copied = optim::IRCopy(e);
+  EXPECT_FALSE(copied.same_as(e));
+  EXPECT_TRUE(copied.As<Add>()->a().same_as(e.As<Add>()->a()));
+}
+
+TEST(IrArena, scope) {
+  Var i("i");
+  Expr outside;
+  {
+    IrArenaScope scope;
+    ASSERT_EQ(IrArena::Current(), scope.arena());
+    Expr e = Expr(i) * 100000 + Expr(i);
+    for (int k = 0; k < 100; ++k) {
+      e = e + Expr(k + 100000);
+    }
+    EXPECT_GT(scope.arena()->num_live_nodes(), 100);
+    outside = Expr(i) + Expr(200000);
+    {
+      IrArenaScope heap_scope(false);
+      EXPECT_EQ(IrArena::Current(), nullptr);
+    }
+    EXPECT_EQ(IrArena::Current(), scope.arena());
+  }
+  EXPECT_EQ(IrArena::Current(), nullptr);
+  // the nodes escaped from the scope keep the arena alive
+  ASSERT_TRUE(outside.As<Add>());
+  EXPECT_EQ(outside.As<Add>()->b().as_int32(), 200000);
+}
+
+}  // namespace ir
+}  // namespace cinn
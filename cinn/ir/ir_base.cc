@@ -14,6 +14,8 @@
 
 #include "cinn/ir/ir_base.h"
 
+#include <cmath>
+
 #include "cinn/common/cinn_value.h"
 #include "cinn/common/common.h"
 #include "cinn/ir/buffer.h"
@@ -28,6 +30,8 @@ namespace ir {
 
 using cinn::common::bfloat16;
 using cinn::common::float16;
+using cinn::common::float8_e4m3;
+using cinn::common::float8_e5m2;
 
 //! Implementations for Ir Expr Nodes.
 // @{
@@ -56,9 +60,92 @@ std::ostream &operator<<(std::ostream &os, IrNodeTy type) {
   return os;
 }
 
+namespace {
+constexpr int64_t kMinInternedInt = -128;
+constexpr int64_t kMaxInternedInt = 1024;
+
+//! The interned constants, which are allocated out of the IR arenas and live as long as the process.
+struct InternedImms {
+  std::vector<IrNode *> int32s;
+  std::vector<IrNode *> int64s;
+  IrNode *bools[2];
+  IrNode *float32s[2];
+  IrNode *float64s[2];
+
+  InternedImms() {
+    IrArenaScope heap_scope(false);
+    for (int64_t v = kMinInternedInt; v <= kMaxInternedInt; ++v) {
+      int32s.push_back(Hold(new IntImm(Int(32), v)));
+      int64s.push_back(Hold(new IntImm(Int(64), v)));
+    }
+    for (int v = 0; v < 2; ++v) {
+      bools[v]    = Hold(new UIntImm(UInt(1), v));
+      float32s[v] = Hold(new FloatImm(Float(32), v));
+      float64s[v] = Hold(new FloatImm(Float(64), v));
+    }
+  }
+
+  static IrNode *Hold(IrNode *node) {
+    common::ref_count(node).Inc();
+    return node;
+  }
+
+  static const InternedImms &Global() {
+    static InternedImms imms;
+    return imms;
+  }
+};
+
+//! The index of the interned float 0 or 1, -1 if \p v is not interned. The negative zero is not the same as 0.
+int InternedFloatIndex(double v) {
+  if (v == 1.) return 1;
+  if (v == 0. && !std::signbit(v)) return 0;
+  return -1;
+}
+}  // namespace
+
+IrNode *MakeIntImm(Type t, int64_t v) {
+  if (v >= kMinInternedInt && v <= kMaxInternedInt) {
+    if (t == Int(32)) return InternedImms::Global().int32s[v - kMinInternedInt];
+    if (t == Int(64)) return InternedImms::Global().int64s[v - kMinInternedInt];
+  }
+  return new IntImm(t, v);
+}
+
+IrNode *MakeUIntImm(Type t, uint64_t v) {
+  if (t == UInt(1)) return InternedImms::Global().bools[v ? 1 : 0];
+  return new UIntImm(t, v);
+}
+
+IrNode *MakeFloatImm(Type t, double v) {
+  int index = InternedFloatIndex(v);
+  if (index >= 0) {
+    if (t == Float(32)) return InternedImms::Global().float32s[index];
+    if (t == Float(64)) return InternedImms::Global().float64s[index];
+  }
+  return new FloatImm(t, v);
+}
+
+bool IsInternedImm(const IrNode *node) {
+  if (!node) return false;
+  const auto &imms = InternedImms::Global();
+  if (auto *int_n = node->node_type() == IrNodeTy::IntImm ? static_cast<const IntImm *>(node) : nullptr) {
+    if (int_n->value < kMinInternedInt || int_n->value > kMaxInternedInt) return false;
+    return node == imms.int32s[int_n->value - kMinInternedInt] || node == imms.int64s[int_n->value - kMinInternedInt];
+  }
+  if (node->node_type() == IrNodeTy::UIntImm) return node == imms.bools[0] || node == imms.bools[1];
+  if (node->node_type() == IrNodeTy::FloatImm) {
+    return node == imms.float32s[0] || node == imms.float32s[1] || node == imms.float64s[0] ||
+           node == imms.float64s[1];
+  }
+  return false;
+}
+
 Expr Zero(const Type &type) {
   if (type.is_bfloat16()) return Expr(bfloat16(0.f));
   if (type.is_float16()) return Expr(float16(0.f));
+  if (type.is_float8_e4m3()) return Expr(float8_e4m3(0.f));
+  if (type.is_float8_e5m2()) return Expr(float8_e5m2(0.f));
   if (type.is_float(32)) return Expr(0.f);
   if (type.is_float(64)) return Expr(double(0.));  // NOLINT
 
@@ -80,6 +167,8 @@ Expr Zero(const Type &type) {
 Expr One(const Type &type) {
   if (type.is_bfloat16()) return Expr(bfloat16(1.f));
   if (type.is_float16()) return Expr(float16(1.f));
+  if (type.is_float8_e4m3()) return Expr(float8_e4m3(1.f));
+  if (type.is_float8_e5m2()) return Expr(float8_e5m2(1.f));
   if (type.is_float(32)) return Expr(1.f);
   if (type.is_float(64)) return Expr(double(1.));  // NOLINT
 
@@ -25,6 +25,7 @@
 #include "cinn/common/object.h"
 #include "cinn/common/shared.h"
 #include "cinn/common/type.h"
+#include "cinn/ir/ir_arena.h"
 
 namespace cinn {
 
@@ -32,6 +33,8 @@ namespace ir {
 using common::BFloat16;
 using common::Float;
 using common::Float16;
+using common::Float8E4M3;
+using common::Float8E5M2;
 using common::Int;
 using common::Type;
 using common::type_of;
@@ -149,6 +152,12 @@ class IrNode : public common::Object {
   explicit IrNode(Type t) : type_(t) {}
   virtual ~IrNode() = default;
 
+  //! The nodes are allocated in the IR arena of the current compilation, see IrArena.
+  // @{
+  static void* operator new(size_t size) { return IrArena::Allocate(size); }
+  static void operator delete(void* p) { IrArena::Deallocate(p); }
+  // @}
+
   virtual IrNodeTy node_type() const { return IrNodeTy::kUnk; }
   virtual Type type() const { return type_; }
   void set_type(Type type) { type_ = type; }
@@ -280,6 +289,17 @@ struct StringImm : public ExprNode<StringImm> {
   static const IrNodeTy _node_type_ = IrNodeTy::StringImm;
 };
 
+//! Make the constant nodes, the common values are interned and shared by all the expressions, so a constant node
+//! should never be modified in place, replace it with a new one instead.
+// @{
+IrNode* MakeIntImm(Type t, int64_t v);
+IrNode* MakeUIntImm(Type t, uint64_t v);
+IrNode* MakeFloatImm(Type t, double v);
+// @}
+
+//! Whether \p node is an interned constant.
+bool IsInternedImm(const IrNode* node);
+
 class Var;
 /**
  * An expression that represents some value or the result of some operations.
@@ -293,22 +313,24 @@ struct Expr : public IrNodeRef {
 
   //! Helper function to construct numeric constants of various types.
   // @{
-  explicit Expr(bool x) : IrNodeRef(new UIntImm(UInt(1), x)) {}
-
-  explicit Expr(int8_t x) : IrNodeRef(new IntImm(Int(8), x)) {}
-  explicit Expr(int16_t x) : IrNodeRef(new IntImm(Int(16), x)) {}
-  explicit Expr(int32_t x) : IrNodeRef(new IntImm(Int(32), x)) {}
-  explicit Expr(int64_t x) : IrNodeRef(new IntImm(Int(64), x)) {}
-
-  explicit Expr(uint8_t x) : IrNodeRef(new UIntImm(UInt(8), x)) {}
-  explicit Expr(uint16_t x) : IrNodeRef(new UIntImm(UInt(16), x)) {}
-  explicit Expr(uint32_t x) : IrNodeRef(new UIntImm(UInt(32), x)) {}
-  explicit Expr(uint64_t x) : IrNodeRef(new UIntImm(UInt(64), x)) {}
-
-  explicit Expr(cinn::common::bfloat16 x) : IrNodeRef(new FloatImm(BFloat16(), x)) {}
-  explicit Expr(cinn::common::float16 x) : IrNodeRef(new FloatImm(Float16(), x)) {}
-  explicit Expr(float x) : IrNodeRef(new FloatImm(Float(32), x)) {}
-  explicit Expr(double x) : IrNodeRef(new FloatImm(Float(64), x)) {}
+  explicit Expr(bool x) : IrNodeRef(MakeUIntImm(UInt(1), x)) {}
+
+  explicit Expr(int8_t x) : IrNodeRef(MakeIntImm(Int(8), x)) {}
+  explicit Expr(int16_t x) : IrNodeRef(MakeIntImm(Int(16), x)) {}
+  explicit Expr(int32_t x) : IrNodeRef(MakeIntImm(Int(32), x)) {}
+  explicit Expr(int64_t x) : IrNodeRef(MakeIntImm(Int(64), x)) {}
+
+  explicit Expr(uint8_t x) : IrNodeRef(MakeUIntImm(UInt(8), x)) {}
+  explicit Expr(uint16_t x) : IrNodeRef(MakeUIntImm(UInt(16), x)) {}
+  explicit Expr(uint32_t x) : IrNodeRef(MakeUIntImm(UInt(32), x)) {}
+  explicit Expr(uint64_t x) : IrNodeRef(MakeUIntImm(UInt(64), x)) {}
+
+  explicit Expr(cinn::common::bfloat16 x) : IrNodeRef(MakeFloatImm(BFloat16(), x)) {}
+  explicit Expr(cinn::common::float16 x) : IrNodeRef(MakeFloatImm(Float16(), x)) {}
+  explicit Expr(cinn::common::float8_e4m3 x) : IrNodeRef(MakeFloatImm(Float8E4M3(), static_cast<float>(x))) {}
+  explicit Expr(cinn::common::float8_e5m2 x) : IrNodeRef(MakeFloatImm(Float8E5M2(), static_cast<float>(x))) {}
+  explicit Expr(float x) : IrNodeRef(MakeFloatImm(Float(32), x)) {}
+  explicit Expr(double x) : IrNodeRef(MakeFloatImm(Float(64), x)) {}
 
   explicit Expr(const std::string& x) : IrNodeRef(new StringImm(x)) {}
   // @}
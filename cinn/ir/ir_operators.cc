@@ -80,9 +80,9 @@ Expr operator|(Expr a, Expr b) {
     }
   }
   auto target = cinn::runtime::CurrentTarget::GetCurrentTarget();
-  if (target.arch == common::Target::Arch::X86) {
+  if (target.is_cpu()) {
     return lang::CallExtern("bitwise_or", {a, b}, {{"vectorizable", false}});
-  } else if (target.arch == common::Target::Arch::NVGPU) {
+  } else if (target.is_gpu()) {
     auto func_name = hlir::GetExternFuncName(target, t_a, "bitwise_or");
     return lang::CallExtern(func_name, {a, b}, {{"vectorizable", false}});
   } else {
@@ -103,9 +103,9 @@ Expr operator&(Expr a, Expr b) {
     }
   }
   auto target = cinn::runtime::CurrentTarget::GetCurrentTarget();
-  if (target.arch == common::Target::Arch::X86) {
+  if (target.is_cpu()) {
     return lang::CallExtern("bitwise_and", {a, b}, {{"vectorizable", false}});
-  } else if (target.arch == common::Target::Arch::NVGPU) {
+  } else if (target.is_gpu()) {
     auto func_name = hlir::GetExternFuncName(target, t_a, "bitwise_and");
     return lang::CallExtern(func_name, {a, b}, {{"vectorizable", false}});
   } else {
@@ -126,9 +126,9 @@ Expr operator^(Expr a, Expr b) {
     }
   }
   auto target = cinn::runtime::CurrentTarget::GetCurrentTarget();
-  if (target.arch == common::Target::Arch::X86) {
+  if (target.is_cpu()) {
     return lang::CallExtern("bitwise_xor", {a, b}, {{"vectorizable", false}});
-  } else if (target.arch == common::Target::Arch::NVGPU) {
+  } else if (target.is_gpu()) {
     auto func_name = hlir::GetExternFuncName(target, t_a, "bitwise_xor");
     return lang::CallExtern(func_name, {a, b}, {{"vectorizable", false}});
   } else {
@@ -139,9 +139,9 @@ Expr operator^(Expr a, Expr b) {
 Expr operator~(Expr a) {
   CHECK(a.type().is_int() || a.type().is_uint());
   auto target = cinn::runtime::CurrentTarget::GetCurrentTarget();
-  if (target.arch == common::Target::Arch::X86) {
+  if (target.is_cpu()) {
     return lang::CallExtern("bitwise_not", {a}, {{"vectorizable", false}});
-  } else if (target.arch == common::Target::Arch::NVGPU) {
+  } else if (target.is_gpu()) {
     auto func_name = hlir::GetExternFuncName(target, a->type(), "bitwise_not");
     return lang::CallExtern(func_name, {a}, {{"vectorizable", false}});
   } else {
@@ -92,6 +92,11 @@ void IrPrinter::Visit(const FloatImm *x) {
       os_ << "(bfloat16)" << std::setprecision(std::numeric_limits<bfloat16>::max_digits10)
           << static_cast<bfloat16>(x->value) << "f";
     }
+  } else if (x->type().is_float8()) {
+    // the constant is converted from float with the saturation, the same as the cast
+    os_ << (x->type().is_float8_e4m3() ? "(float8_e4m3)" : "(float8_e5m2)")
+        << std::setprecision(std::numeric_limits<float>::max_digits10) << std::showpoint
+        << static_cast<float>(x->value) << "f";
   } else if (x->type().is_float(32)) {
     os_ << std::setprecision(std::numeric_limits<float>::max_digits10) << std::showpoint << x->value;
     if (std::isfinite(x->value)) {
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <set>
 #include <string>
@@ -35,6 +36,7 @@
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule_util.h"
 #include "cinn/ir/ir_visitor.h"
+#include "cinn/ir/tensorize_intrin.h"
 #include "cinn/lang/compute.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
@@ -99,6 +101,8 @@ class ScheduleImpl {
   void ReverseComputeInline(const Expr& schedule_block);
   void Bind(const Expr& loop, const std::string& thread_axis);
   Expr Rfactor(const Expr& rf_loop, int rf_axis);
+  void Tensorize(const Expr& loop, const std::string& intrin_name);
+  void SoftwarePipeline(const Expr& loop, int num_stages);
   Expr AddUnitLoop(const Expr& block) const;
   void Annotate(const Expr& block, const std::string& key, const attr_t& value);
   void Unannotate(Expr& block, const std::string& key);
@@ -114,6 +118,11 @@ class ScheduleImpl {
 
   ModuleExpr module_expr_;
   bool debug_flag_{false};
+
+ public:
+  bool debug_flag() const { return debug_flag_; }
+  //! Guard the AST shared by the copies of an IRSchedule, see IRSchedule::Impl.
+  std::mutex share_mutex;
 };
 
 std::vector<Expr> ScheduleImpl::Split(const Expr& loop, const std::vector<int>& factors) {
@@ -599,6 +608,154 @@ Expr ScheduleImpl::Rfactor(const Expr& rf_loop, int rf_axis) {
   return rf_create.CreateRfAllStmts();
 }
 
+void ScheduleImpl::Tensorize(const Expr& loop, const std::string& intrin_name) {
+  CHECK(loop.As<ir::For>()) << "Expr param of Tensorize must be For node! Please check.";
+  auto* intrin = TensorizeIntrinRegistry::Global()->Get(intrin_name);
+  // collect the perfect nest of the M, N and K loops
+  std::vector<int> extents{intrin->m(), intrin->n(), intrin->k()};
+  std::vector<Expr> nest;
+  Expr body = loop;
+  while (nest.size() < 3U) {
+    auto* for_node = body.As<ir::For>();
+    int extent     = extents[nest.size()];
+    CHECK(for_node) << "Tensorize requires a perfect nest of three loops, but got:\n" << loop;
+    CHECK(for_node->is_serial()) << "The loops to tensorize must be serial, but got:\n" << body;
+    CHECK(common::is_zero(for_node->min) && for_node->extent.is_constant() && for_node->extent.get_constant() == extent)
+        << "The loop to tensorize by " << intrin_name << " must be (0, " << extent << "), but got:\n"
+        << body;
+    nest.emplace_back(body);
+    body = for_node->body;
+    while (body.As<ir::Block>() && body.As<ir::Block>()->stmts.size() == 1U) {
+      body = body.As<ir::Block>()->stmts[0];
+    }
+  }
+  CHECK(body.As<ir::ScheduleBlockRealize>()) << "The innermost loop to tensorize must only contain a block, but got:\n"
+                                             << body;
+  MatmulBlockPattern pattern;
+  CHECK(MatchMatmulBlock(body, &pattern)) << "The block to tensorize is not matmul-like:\n" << body;
+  CHECK(intrin->MatchTypes(pattern)) << "The intrinsic " << intrin_name << " doesn't support the data types of block:\n"
+                                     << body;
+  std::vector<Var> nest_vars{nest[0].As<ir::For>()->loop_var,
+                             nest[1].As<ir::For>()->loop_var,
+                             nest[2].As<ir::For>()->loop_var};
+  CHECK(nest_vars[0]->name == pattern.m_var->name && nest_vars[1]->name == pattern.n_var->name &&
+        nest_vars[2]->name == pattern.k_var->name)
+      << "The loops to tensorize must walk the M, N and K dimensions in order, but got:\n"
+      << loop;
+
+  // the intrinsic computes the whole tile from its origin, where the loops of the nest are at their first iteration
+  Expr new_block          = optim::IRCopy(body);
+  auto* new_block_realize = new_block.As<ir::ScheduleBlockRealize>();
+  for (auto& value : new_block_realize->iter_values) {
+    ReplaceExpr(&value, nest_vars, {Expr(0), Expr(0), Expr(0)});
+    value = common::AutoSimplify(value);
+  }
+  auto* new_schedule_block = new_block_realize->schedule_block.As<ir::ScheduleBlock>();
+  new_schedule_block->body = ir::Block::Make({intrin->MakeCall(pattern)});
+  new_schedule_block->attrs.emplace(ir::attr::tensorize_intrin, intrin_name);
+
+  Expr new_loop = ir::Block::Make({new_block});
+  if (intrin->num_threads() > 1) {
+    // all the threads of the intrinsic, such as a warp, execute it cooperatively
+    new_loop = ir::For::Make(Var(nest_vars[0]->name + "_lane"),
+                             Expr(0),
+                             Expr(intrin->num_threads()),
+                             ForType::GPUThread,
+                             DeviceAPI::GPU,
+                             new_loop,
+                             VectorizeInfo(),
+                             BindInfo(ForType::GPUThread, 0, DeviceAPI::GPU));
+  }
+  this->Replace(loop, new_loop);
+
+  std::string init_block_name = GenReduceInitTensorNameOf(new_schedule_block->name);
+  if (this->HasBlock(init_block_name)) {
+    Expr init_block = this->GetBlock(init_block_name);
+    Expr root       = this->GetRootBlock(init_block);
+    Expr source_expr, target_expr;
+    LeafBlockRemovalPlan remove_plan(init_block, &source_expr, &target_expr);
+    remove_plan(&root);
+    if (source_expr.defined() && target_expr.defined()) {
+      this->Replace(source_expr, target_expr);
+    }
+  }
+  VLOG(3) << "After Tensorize, ir is:\n" << new_loop;
+}
+
+void ScheduleImpl::SoftwarePipeline(const Expr& loop, int num_stages) {
+  CHECK(loop.As<ir::For>()) << "Expr param of SoftwarePipeline must be For node! Please check.";
+  auto* for_node = loop.As<ir::For>();
+  CHECK_GE(num_stages, 2) << "SoftwarePipeline needs at least 2 stages";
+  CHECK(for_node->is_serial()) << "Only a serial loop can be pipelined, but got:\n" << loop;
+  CHECK(for_node->extent.is_constant() && for_node->extent.as_int32() >= num_stages)
+      << "The extent of the loop to pipeline must be a constant not less than the number of stages, but got:\n"
+      << loop;
+
+  // the blocks copying into shared or local buffers are the producers, and the other blocks reading the buffers in
+  // the loop are the consumers, a block reading what it writes, such as the accumulation of a local cache, is neither
+  auto buffer_names = [](const std::vector<Expr>& buffer_ranges) {
+    std::set<std::string> names;
+    for (auto&& buffer_range : buffer_ranges) {
+      names.insert(buffer_range.As<ir::_BufferRange_>()->buffer.as_buffer()->name);
+    }
+    return names;
+  };
+  auto get_schedule_block = [](const Expr& block) {
+    return block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+  };
+  auto copies_to_cache = [&](const Expr& block) {
+    auto* schedule_block = get_schedule_block(block);
+    auto stores          = ir::CollectIRNodesWithoutTensor(schedule_block->body, [](const Expr* x) {
+      if (!x->As<ir::Store>() || !x->As<ir::Store>()->tensor.as_tensor_ref()->buffer.defined()) return false;
+      auto memory_type = x->As<ir::Store>()->tensor.as_tensor_ref()->buffer->memory_type;
+      return memory_type == ir::MemoryType::GPUShared || memory_type == ir::MemoryType::GPULocal;
+    });
+    if (stores.empty()) return false;
+    auto reads = buffer_names(schedule_block->read_buffers);
+    for (auto&& name : buffer_names(schedule_block->write_buffers)) {
+      if (reads.count(name)) return false;
+    }
+    return true;
+  };
+  auto blocks = ir::CollectIRNodesInOrder(loop, [](const Expr* x) { return x->As<ir::ScheduleBlockRealize>(); });
+  // the blocks under each inner loop, a producer sharing an inner loop with its consumer is pipelined by that loop
+  std::vector<std::vector<Expr>> inner_loop_blocks;
+  ir::CollectIRNodesWithoutTensor(loop.As<ir::For>()->body, [&](const Expr* x) {
+    if (x->As<ir::For>()) {
+      inner_loop_blocks.push_back(
+          ir::CollectIRNodesInOrder(*x, [](const Expr* y) { return y->As<ir::ScheduleBlockRealize>(); }));
+    }
+    return false;
+  });
+  auto contains = [](const std::vector<Expr>& exprs, const Expr& expr) {
+    return std::any_of(exprs.begin(), exprs.end(), [&](const Expr& x) { return x.same_as(expr); });
+  };
+  std::vector<Expr> producers;
+  for (auto&& block : blocks) {
+    if (!copies_to_cache(block)) continue;
+    auto cache_buffers = buffer_names(get_schedule_block(block)->write_buffers);
+    auto is_consumer   = [&](const Expr& other) {
+      if (other.same_as(block)) return false;
+      for (auto&& name : buffer_names(get_schedule_block(other)->read_buffers)) {
+        if (cache_buffers.count(name)) return true;
+      }
+      return false;
+    };
+    bool in_inner_loop = std::any_of(inner_loop_blocks.begin(), inner_loop_blocks.end(), [&](const auto& inner) {
+      return contains(inner, block) && std::any_of(inner.begin(), inner.end(), is_consumer);
+    });
+    if (!in_inner_loop && std::any_of(blocks.begin(), blocks.end(), is_consumer)) {
+      producers.push_back(block);
+    }
+  }
+  CHECK(!producers.empty()) << "No block copying into shared or local buffers read in the loop to pipeline:\n"
+                            << loop;
+
+  for (auto&& block : producers) {
+    this->Annotate(block, ir::attr::software_pipeline_stages, num_stages);
+  }
+}
+
 struct CacheReadRewriter : public ir::IRMutator<> {
  public:
   static Expr Rewrite(const Expr& root, CacheBlockInfo* info) {
@@ -1972,38 +2129,59 @@ Expr ScheduleImpl::SampleCategorical(utils::LinearRandomEngine::StateType* rand_
 IRSchedule::IRSchedule() {}
 
 IRSchedule::IRSchedule(const ModuleExpr& module_expr, utils::LinearRandomEngine::StateType rand_seed, bool debug_flag) {
-  impl_ = std::make_unique<ScheduleImpl>(module_expr, debug_flag);
+  impl_ = std::make_shared<ScheduleImpl>(module_expr, debug_flag);
   this->InitSeed(rand_seed);
 }
 
 IRSchedule::IRSchedule(ir::ModuleExpr&& mod_expr, ScheduleDesc&& trace, utils::LinearRandomEngine::StateType rand_seed)
-    : impl_(std::make_unique<ScheduleImpl>(std::move(mod_expr))), trace_(std::move(trace)) {
+    : impl_(std::make_shared<ScheduleImpl>(std::move(mod_expr))), trace_(std::move(trace)) {
   this->InitSeed(rand_seed);
 }
 
-IRSchedule::IRSchedule(const IRSchedule& other)
-    : impl_(std::make_unique<ScheduleImpl>(optim::IRCopy(other.GetModule()))), trace_(other.trace_) {
+IRSchedule::IRSchedule(const IRSchedule& other) : impl_(other.impl_), owns_module_(false), trace_(other.trace_) {
   this->InitSeed(other.ForkSeed());
 }
 
 IRSchedule& IRSchedule::operator=(const IRSchedule& src) {
-  impl_  = std::make_unique<ScheduleImpl>(optim::IRCopy(src.GetModule()));
-  trace_ = src.trace_;
+  if (this == &src) return *this;
+  impl_        = src.impl_;
+  owns_module_ = false;
+  trace_       = src.trace_;
   this->InitSeed(src.ForkSeed());
   return *this;
 }
 
-IRSchedule::IRSchedule(IRSchedule&& other) : impl_(std::move(other.impl_)), trace_(std::move(other.trace_)) {
+IRSchedule::IRSchedule(IRSchedule&& other)
+    : impl_(std::move(other.impl_)), owns_module_(other.owns_module_), trace_(std::move(other.trace_)) {
   this->InitSeed(other.ForkSeed());
 }
 
 IRSchedule& IRSchedule::operator=(IRSchedule&& src) {
-  impl_  = std::move(src.impl_);
-  trace_ = std::move(src.trace_);
+  impl_        = std::move(src.impl_);
+  owns_module_ = src.owns_module_;
+  trace_       = std::move(src.trace_);
   this->InitSeed(src.ForkSeed());
   return *this;
 }
 
+ScheduleImpl* IRSchedule::Impl() const {
+  CHECK(impl_) << "The IRSchedule is not initialized with a ModuleExpr";
+  // hold the shared impl until it is unlocked, the other schedules may drop it at the same time
+  std::shared_ptr<ScheduleImpl> shared = impl_;
+  std::lock_guard<std::mutex> lock(shared->share_mutex);
+  if (shared.use_count() > 2) {
+    if (owns_module_) {
+      // the AST and the exprs got from it before are kept by this schedule, and the copies get a snapshot
+      impl_ = std::make_shared<ScheduleImpl>(shared->GetModule(), shared->debug_flag());
+      shared->SetExprs(optim::IRCopy(shared->GetModule().GetExprs()));
+    } else {
+      impl_ = std::make_shared<ScheduleImpl>(optim::IRCopy(shared->GetModule()), shared->debug_flag());
+    }
+  }
+  owns_module_ = true;
+  return impl_.get();
+}
+
 IRSchedule::~IRSchedule() {}
 
 void IRSchedule::InitSeed(utils::LinearRandomEngine::StateType rand_seed) {
@@ -2013,51 +2191,51 @@ void IRSchedule::InitSeed(utils::LinearRandomEngine::StateType rand_seed) {
 utils::LinearRandomEngine::StateType IRSchedule::ForkSeed() const { return utils::ForkRandomState(&rand_seed_); }
 
 void IRSchedule::SetExprs(const std::vector<Expr>& exprs) {
-  return impl_->SetExprs(exprs);
+  return Impl()->SetExprs(exprs);
   // no need to trace
 }
 
 const ModuleExpr& IRSchedule::GetModule() const {
-  return impl_->GetModule();
+  return Impl()->GetModule();
   // no need to trace
 }
 
 bool IRSchedule::HasBlock(const std::string& block_name) const {
-  return impl_->HasBlock(block_name);
+  return Impl()->HasBlock(block_name);
   // no need to trace
 }
 
 void IRSchedule::MergeExprs() {
-  impl_->MergeExprs();
+  Impl()->MergeExprs();
   trace_.Append(ScheduleDesc::Step("MergeExprs", {}, {}, {}));
 }
 
 std::vector<Expr> IRSchedule::GetLoops(const Expr& block) const {
-  auto results = impl_->GetLoops(block);
+  auto results = Impl()->GetLoops(block);
   trace_.Append(ScheduleDesc::Step("GetLoops", {{"block", std::vector<Expr>({block})}}, {}, results));
   return results;
 }
 
 std::vector<Expr> IRSchedule::GetLoops(const std::string& block_name) const {
-  auto results = impl_->GetLoops(block_name);
+  auto results = Impl()->GetLoops(block_name);
   trace_.Append(ScheduleDesc::Step("GetLoopsWithName", {}, {{"block_name", block_name}}, results));
   return results;
 }
 
 std::vector<Expr> IRSchedule::GetAllBlocks() const {
-  auto results = impl_->GetAllBlocks();
+  auto results = Impl()->GetAllBlocks();
   trace_.Append(ScheduleDesc::Step("GetAllBlocks", {}, {}, results));
   return results;
 }
 
 std::vector<Expr> IRSchedule::GetChildBlocks(const Expr& expr) const {
-  auto results = impl_->GetChildBlocks(expr);
+  auto results = Impl()->GetChildBlocks(expr);
   trace_.Append(ScheduleDesc::Step("GetChildBlocks", {{"expr", std::vector<Expr>({expr})}}, {}, results));
   return results;
 }
 
 Expr IRSchedule::GetBlock(const std::string& block_name) const {
-  auto result = impl_->GetBlock(block_name);
+  auto result = Impl()->GetBlock(block_name);
   trace_.Append(ScheduleDesc::Step("GetBlock", {}, {{"block_name", block_name}}, {result}));
   return result;
 }
@@ -2081,33 +2259,33 @@ std::vector<Expr> IRSchedule::Split(const std::string& block_name, int loop_inde
 std::vector<Expr> IRSchedule::Split(const Expr& loop, const std::vector<Expr>& factors) {
   std::vector<int> int_factors;
   std::transform(factors.begin(), factors.end(), std::back_inserter(int_factors), [](Expr x) { return x.as_int32(); });
-  auto results = impl_->Split(loop, int_factors);
+  auto results = Impl()->Split(loop, int_factors);
   trace_.Append(ScheduleDesc::Step("Split", {{"loop", std::vector<Expr>({loop})}, {"factors", factors}}, {}, results));
   return results;
 }
 
 Expr IRSchedule::Fuse(const std::vector<Expr>& loops) {
-  auto result = impl_->Fuse(loops);
+  auto result = Impl()->Fuse(loops);
   trace_.Append(ScheduleDesc::Step("Fuse", {{"loops", loops}}, {}, {result}));
   return result;
 }
 
 Expr IRSchedule::Fuse(const std::string& block_name, const std::vector<int>& loops_index) {
-  auto result = impl_->Fuse(block_name, loops_index);
+  auto result = Impl()->Fuse(block_name, loops_index);
   trace_.Append(
       ScheduleDesc::Step("FuseWithName", {}, {{"block_name", block_name}, {"loops_index", loops_index}}, {result}));
   return result;
 }
 
 Expr IRSchedule::Fuse(const Expr& block, const std::vector<int>& loops_index) {
-  auto result = impl_->Fuse(block, loops_index);
+  auto result = Impl()->Fuse(block, loops_index);
   trace_.Append(ScheduleDesc::Step(
       "FuseWithBlock", {{"block", std::vector<Expr>({block})}}, {{"loops_index", loops_index}}, {result}));
   return result;
 }
 
 void IRSchedule::ComputeAt(const Expr& block, const Expr& loop, bool keep_unit_loops) {
-  impl_->ComputeAt(block, loop, keep_unit_loops);
+  Impl()->ComputeAt(block, loop, keep_unit_loops);
   trace_.Append(ScheduleDesc::Step("ComputeAt",
                                    {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}},
                                    {{"keep_unit_loops", keep_unit_loops}},
@@ -2115,13 +2293,13 @@ void IRSchedule::ComputeAt(const Expr& block, const Expr& loop, bool keep_unit_l
 }
 
 void IRSchedule::SimpleComputeAt(const Expr& block, const Expr& loop) {
-  impl_->SimpleComputeAt(block, loop);
+  Impl()->SimpleComputeAt(block, loop);
   trace_.Append(ScheduleDesc::Step(
       "SimpleComputeAt", {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::ReverseComputeAt(const Expr& block, const Expr& loop, bool keep_unit_loops) {
-  impl_->ReverseComputeAt(block, loop, keep_unit_loops);
+  Impl()->ReverseComputeAt(block, loop, keep_unit_loops);
   trace_.Append(ScheduleDesc::Step("ReverseComputeAt",
                                    {{"block", std::vector<Expr>({block})}, {"loop", std::vector<Expr>({loop})}},
                                    {{"keep_unit_loops", keep_unit_loops}},
@@ -2129,13 +2307,13 @@ void IRSchedule::ReverseComputeAt(const Expr& block, const Expr& loop, bool keep
 }
 
 Expr IRSchedule::GetRootBlock(const Expr& expr) const {
-  auto result = impl_->GetRootBlock(expr);
+  auto result = Impl()->GetRootBlock(expr);
   trace_.Append(ScheduleDesc::Step("GetRootBlock", {{"expr", std::vector<Expr>({expr})}}, {}, {result}));
   return result;
 }
 
 Expr IRSchedule::CacheRead(const Expr& block, int read_buffer_index, const std::string& memory_type) {
-  auto result = impl_->CacheRead(block, read_buffer_index, memory_type);
+  auto result = Impl()->CacheRead(block, read_buffer_index, memory_type);
   trace_.Append(ScheduleDesc::Step("CacheRead",
                                    {{"block", std::vector<Expr>({block})}},
                                    {{"read_buffer_index", read_buffer_index}, {"memory_type", memory_type}},
@@ -2144,7 +2322,7 @@ Expr IRSchedule::CacheRead(const Expr& block, int read_buffer_index, const std::
 }
 
 Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std::string& memory_type) {
-  auto result = impl_->CacheWrite(block, write_buffer_index, memory_type);
+  auto result = Impl()->CacheWrite(block, write_buffer_index, memory_type);
   trace_.Append(ScheduleDesc::Step("CacheWrite",
                                    {{"block", std::vector<Expr>({block})}},
                                    {{"write_buffer_index", write_buffer_index}, {"memory_type", memory_type}},
@@ -2153,77 +2331,89 @@ Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std
 }
 
 void IRSchedule::SyncThreads(const Expr& ir_node, bool after_node) {
-  impl_->SyncThreads(ir_node, after_node);
+  Impl()->SyncThreads(ir_node, after_node);
   trace_.Append(
       ScheduleDesc::Step("SyncThreads", {{"ir_node", std::vector<Expr>({ir_node})}}, {{"after_node", after_node}}, {}));
 }
 
 void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type, bool fixed) {
-  impl_->SetBuffer(block, memory_type, fixed);
+  Impl()->SetBuffer(block, memory_type, fixed);
   trace_.Append(ScheduleDesc::Step(
       "SetBuffer", {{"block", std::vector<Expr>({block})}}, {{"memory_type", memory_type}, {"fixed", fixed}}, {}));
 }
 
 Expr IRSchedule::Reorder(const std::vector<Expr>& loops) {
-  Expr ret = impl_->Reorder(loops);
+  Expr ret = Impl()->Reorder(loops);
   trace_.Append(ScheduleDesc::Step("Reorder", {{"loops", loops}}, {}, {ret}));
   return ret;
 }
 
 Expr IRSchedule::Reorder(const std::string& block_name, const std::vector<int>& loops_index) {
-  Expr ret = impl_->Reorder(block_name, loops_index);
+  Expr ret = Impl()->Reorder(block_name, loops_index);
   trace_.Append(
       ScheduleDesc::Step("ReorderWithName", {}, {{"block_name", block_name}, {"loops_index", loops_index}}, {ret}));
   return ret;
 }
 
 Expr IRSchedule::Reorder(const Expr& block, const std::vector<int>& loops_index) {
-  Expr ret = impl_->Reorder(block, loops_index);
+  Expr ret = Impl()->Reorder(block, loops_index);
   trace_.Append(ScheduleDesc::Step(
       "ReorderWithBlock", {{"block", std::vector<Expr>({block})}}, {{"loops_index", loops_index}}, {ret}));
   return ret;
 }
 
 void IRSchedule::Parallel(const Expr& loop) {
-  impl_->Parallel(loop);
+  Impl()->Parallel(loop);
   trace_.Append(ScheduleDesc::Step("Parallel", {{"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::Vectorize(const Expr& loop, int factor) {
-  impl_->Vectorize(loop, factor);
+  Impl()->Vectorize(loop, factor);
   trace_.Append(ScheduleDesc::Step("Vectorize", {{"loop", std::vector<Expr>({loop})}}, {{"factor", factor}}, {}));
 }
 
 void IRSchedule::Unroll(const Expr& loop) {
-  impl_->Unroll(loop);
+  Impl()->Unroll(loop);
   trace_.Append(ScheduleDesc::Step("Unroll", {{"loop", std::vector<Expr>({loop})}}, {}, {}));
 }
 
 void IRSchedule::ComputeInline(const Expr& schedule_block) {
-  impl_->ComputeInline(schedule_block);
+  Impl()->ComputeInline(schedule_block);
   trace_.Append(ScheduleDesc::Step("ComputeInline", {{"schedule_block", std::vector<Expr>({schedule_block})}}, {}, {}));
 }
 
 void IRSchedule::ReverseComputeInline(const Expr& schedule_block) {
-  impl_->ReverseComputeInline(schedule_block);
+  Impl()->ReverseComputeInline(schedule_block);
   trace_.Append(
       ScheduleDesc::Step("ReverseComputeInline", {{"schedule_block", std::vector<Expr>({schedule_block})}}, {}, {}));
 }
 
 void IRSchedule::Bind(const Expr& loop, const std::string& thread_axis) {
-  impl_->Bind(loop, thread_axis);
+  Impl()->Bind(loop, thread_axis);
   trace_.Append(ScheduleDesc::Step("Bind", {{"loop", std::vector<Expr>({loop})}}, {{"thread_axis", thread_axis}}, {}));
 }
 
 Expr IRSchedule::Rfactor(const Expr& rf_loop, int rf_axis) {
-  auto result = impl_->Rfactor(rf_loop, rf_axis);
+  auto result = Impl()->Rfactor(rf_loop, rf_axis);
   trace_.Append(
       ScheduleDesc::Step("Rfactor", {{"rf_loop", std::vector<Expr>({rf_loop})}}, {{"rf_axis", rf_axis}}, {result}));
   return result;
 }
 
+void IRSchedule::Tensorize(const Expr& loop, const std::string& intrin_name) {
+  Impl()->Tensorize(loop, intrin_name);
+  trace_.Append(
+      ScheduleDesc::Step("Tensorize", {{"loop", std::vector<Expr>({loop})}}, {{"intrin_name", intrin_name}}, {}));
+}
+
+void IRSchedule::SoftwarePipeline(const Expr& loop, int num_stages) {
+  Impl()->SoftwarePipeline(loop, num_stages);
+  trace_.Append(
+      ScheduleDesc::Step("SoftwarePipeline", {{"loop", std::vector<Expr>({loop})}}, {{"num_stages", num_stages}}, {}));
+}
+
 void IRSchedule::Annotate(const Expr& block, const std::string& key, const attr_t& value) {
-  impl_->Annotate(block, key, value);
+  Impl()->Annotate(block, key, value);
 
 #define TRACE_ANNOTATE_ITEM(data_type, step_name)                                            \
   if (absl::holds_alternative<data_type>(value)) {                                           \
@@ -2243,23 +2433,23 @@ void IRSchedule::Annotate(const Expr& block, const std::string& key, const attr_
 }
 
 void IRSchedule::Unannotate(Expr& block, const std::string& key) {
-  impl_->Unannotate(block, key);
+  Impl()->Unannotate(block, key);
   trace_.Append(ScheduleDesc::Step("Unannotate", {{"block", std::vector<Expr>({block})}}, {{"key", key}}, {}));
 }
 
 void IRSchedule::FlattenLoops(const std::vector<Expr>& loops, const bool force_flat) {
-  impl_->FlattenLoops(loops, force_flat);
+  Impl()->FlattenLoops(loops, force_flat);
   trace_.Append(
       ScheduleDesc::Step("FlattenLoops", {{"loop", std::vector<Expr>({loops})}}, {{"force_flat", force_flat}}, {}));
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const Expr& block, const Expr& block_target) {
-  impl_->CopyTransformAndLoopInfo(block, block_target);
+  Impl()->CopyTransformAndLoopInfo(block, block_target);
   // don't support to trace, because we can't ensure both blocks are from the same ModuleExpr
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const std::string& block_name, const std::string& block_target_name) {
-  impl_->CopyTransformAndLoopInfo(block_name, block_target_name);
+  Impl()->CopyTransformAndLoopInfo(block_name, block_target_name);
   // don't support to trace, because we can't ensure both blocks are from the same ModuleExpr
 }
 
@@ -2270,7 +2460,7 @@ std::vector<Expr> IRSchedule::SamplePerfectTile(const Expr& loop,
   std::vector<Expr> factors;
   std::vector<int> new_decision;
   if (decision.empty()) {
-    factors = impl_->SamplePerfectTile(&rand_seed_, loop, n, max_innermost_factor);
+    factors = Impl()->SamplePerfectTile(&rand_seed_, loop, n, max_innermost_factor);
     std::transform(
         factors.begin(), factors.end(), std::back_inserter(new_decision), [](Expr x) { return x.as_int32(); });
   } else {
@@ -2293,7 +2483,7 @@ Expr IRSchedule::SampleCategorical(const std::vector<int>& candidates,
   Expr result;
   std::vector<int> new_decision;
   if (decision.empty()) {
-    result = impl_->SampleCategorical(&rand_seed_, candidates, probs);
+    result = Impl()->SampleCategorical(&rand_seed_, candidates, probs);
     new_decision.push_back(result.as_int32());
   } else {
     new_decision = decision;
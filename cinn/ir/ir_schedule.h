@@ -353,6 +353,54 @@ class IRSchedule {
    */
   Expr Rfactor(const Expr& rf_loop, int rf_axis);
 
+  /**
+   * \brief Replace a matmul-like loop nest with a hardware intrinsic registered in TensorizeIntrinRegistry.
+   * @param loop the outermost loop of the nest to be tensorized.
+   * @param intrin_name the name of the intrinsic, such as "wmma_m16n16k16_f16f32" or "vnni_m16n16k16_s8s8s32".
+   *
+   * The loop must be the outermost one of a perfect nest of three loops walking the M, N and K dimensions
+   * in order, each of them has the extent of the tile of the intrinsic, and the innermost one only contains
+   * a matmul-like block of the data types of the intrinsic. For example, input the nest:
+   * \code
+   * for (i1, 0, 16)
+   *   for (j1, 0, 16)
+   *     for (k1, 0, 16)
+   *       C[i0 * 16 + i1, j0 * 16 + j1] = C[i0 * 16 + i1, j0 * 16 + j1] + A[i0 * 16 + i1, k0 * 16 + k1] * B[...]
+   * \endcode
+   * the nest is replaced by a loop bound to threadIdx.x with the extent of warp size, or the call only if the
+   * intrinsic is executed by a single thread:
+   * \code
+   * for (lane, 0, 32)
+   *   cinn_wmma_m16n16k16_f16f32(&C[i0 * 16, j0 * 16], &A[i0 * 16, k0 * 16], &B[k0 * 16, j0 * 16],
+   *                              lda, ldb, ldc, (k0 * 16 == 0))
+   * \endcode
+   * The block initializing C is removed, since the intrinsic fills the fragment with zero at the first tile of K.
+   */
+  void Tensorize(const Expr& loop, const std::string& intrin_name);
+
+  /**
+   * \brief Pipeline the loads of the shared buffers in a loop with multiple stages.
+   * @param loop The serial loop, such as the outer loop of reduction, whose body loads the shared buffers and then
+   * computes on them.
+   * @param num_stages The number of shared buffers to rotate, 2 for double buffering and 3 for triple buffering.
+   *
+   * The blocks writing the shared buffers in the loop are annotated with the number of stages, and the loop is
+   * rewritten when lowering: each shared buffer is expanded with a leading stage axis, the first (num_stages - 1)
+   * iterations are loaded in advance, and every iteration loads the data of (num_stages - 1) iterations later while
+   * computing on the current one, with only one __syncthreads:
+   * \code
+   * load(0) ... load(num_stages - 2)
+   * for (k, 0, n)
+   *   __syncthreads()
+   *   if (k + num_stages - 1 < n) load(k + num_stages - 1)
+   *   compute(k)
+   * \endcode
+   * The loads copying global memory to the shared buffer directly are issued by cp.async on sm80 and above. The local
+   * buffers, such as the register fragments loaded from the shared buffers, are pipelined likewise but indexed by the
+   * constant stages and rotated by unrolled copies after the compute, so that they stay in registers.
+   */
+  void SoftwarePipeline(const Expr& loop, int num_stages);
+
   /*!
    * \brief Annotate a block with a key-value pair to set as its attribute
    * \param block The block to be annotated
@@ -420,8 +468,15 @@ class IRSchedule {
   // Fork a new seed from current seed
   utils::LinearRandomEngine::StateType ForkSeed() const;
 
+  // Get the ScheduleImpl whose AST is not shared with the other schedules. A copied schedule shares the AST with its
+  // source until one of them accesses it, then the source keeps the AST and the copy gets a deep copy of it, so a
+  // copy which is never scheduled, or whose source is dropped before, costs nothing.
+  ScheduleImpl* Impl() const;
+
  private:
-  std::unique_ptr<ScheduleImpl> impl_;
+  mutable std::shared_ptr<ScheduleImpl> impl_;
+  // Whether the AST in impl_ belongs to this schedule rather than the schedule it is copied from.
+  mutable bool owns_module_{true};
   mutable ScheduleDesc trace_;  // trace the scheduling process
   mutable utils::LinearRandomEngine::StateType rand_seed_;
 };
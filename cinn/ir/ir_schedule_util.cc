@@ -27,9 +27,11 @@
 #include "cinn/common/ir_util.h"
 #include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_visitor.h"
+#include "cinn/ir/tensorize_intrin.h"
 #include "cinn/lang/compute.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
@@ -1034,5 +1036,130 @@ std::vector<int> SampleTile(utils::LinearRandomEngine::StateType* rand_seed, int
   tile.push_back(extent);
   return tile;
 }
+
+namespace {
+
+// The constant stride of var in the index expression, or an undefined Expr if it is not a constant.
+Expr IndexStride(const Expr& index, const Var& var) {
+  Expr upper = optim::IRCopy(index);
+  Expr lower = optim::IRCopy(index);
+  ReplaceExpr(&upper, {var}, {Expr(1)});
+  ReplaceExpr(&lower, {var}, {Expr(0)});
+  Expr stride = common::AutoSimplify(upper - lower);
+  return stride.is_constant() ? stride : Expr();
+}
+
+// Whether var walks the last two indices with the given strides, and doesn't appear in the leading indices.
+bool MatchIndexStrides(const std::vector<Expr>& indices, const Var& var, int second_last_stride, int last_stride) {
+  if (indices.size() < 2U) return false;
+  for (int i = 0; i < indices.size(); ++i) {
+    int expected = 0;
+    if (i == indices.size() - 2) expected = second_last_stride;
+    if (i == indices.size() - 1) expected = last_stride;
+    Expr stride = IndexStride(indices[i], var);
+    if (!stride.defined() || stride.get_constant() != expected) return false;
+  }
+  return true;
+}
+
+Expr StripCast(const Expr& expr) { return expr.As<ir::Cast>() ? expr.As<ir::Cast>()->v() : expr; }
+
+}  // namespace
+
+bool MatchMatmulBlock(const Expr& block, MatmulBlockPattern* pattern) {
+  auto* block_realize = block.As<ir::ScheduleBlockRealize>();
+  CHECK(block_realize) << "Param block must be ScheduleBlockRealize! Please check.";
+  auto* schedule_block = block_realize->schedule_block.As<ir::ScheduleBlock>();
+  CHECK(schedule_block);
+
+  Expr body = schedule_block->body;
+  while (body.As<ir::Block>() && body.As<ir::Block>()->stmts.size() == 1U) {
+    body = body.As<ir::Block>()->stmts[0];
+  }
+  auto* store = body.As<ir::Store>();
+  if (!store || !store->value.As<ir::Add>()) return false;
+  auto* add = store->value.As<ir::Add>();
+
+  // find the accumulation C[..., x, y] + A[..., x, z] * B[..., z, y]
+  auto is_accumulator = [&](const Expr& operand) {
+    auto* load = operand.As<ir::Load>();
+    if (!load || load->tensor.as_tensor_ref()->name != store->tensor.as_tensor_ref()->name) return false;
+    if (load->indices.size() != store->indices.size()) return false;
+    for (int i = 0; i < load->indices.size(); ++i) {
+      if (!IrEqualVisitor().Compare(load->indices[i], store->indices[i])) return false;
+    }
+    return true;
+  };
+  Expr product;
+  if (is_accumulator(add->a())) {
+    product = add->b();
+  } else if (is_accumulator(add->b())) {
+    product = add->a();
+  } else {
+    return false;
+  }
+  auto* mul = product.As<ir::Mul>();
+  if (!mul) return false;
+  Expr lhs = StripCast(mul->a());
+  Expr rhs = StripCast(mul->b());
+  if (!lhs.As<ir::Load>() || !rhs.As<ir::Load>()) return false;
+
+  // express the indices by the loop vars instead of the block iter vars
+  auto to_loop_indices = [&](const std::vector<Expr>& indices) {
+    std::vector<Expr> result;
+    for (auto&& index : indices) {
+      Expr copied = optim::IRCopy(index);
+      ReplaceExpr(&copied, schedule_block->iter_vars, block_realize->iter_values);
+      result.emplace_back(copied);
+    }
+    return result;
+  };
+  std::vector<Var> loop_vars;
+  for (auto&& value : block_realize->iter_values) {
+    auto vars = ir::CollectIRNodesWithoutTensor(value, [](const Expr* x) { return x->as_var(); });
+    for (auto&& var : vars) {
+      if (std::find(loop_vars.begin(), loop_vars.end(), var.as_var_ref()) == loop_vars.end()) {
+        loop_vars.emplace_back(var.as_var_ref());
+      }
+    }
+  }
+  auto c_indices = to_loop_indices(store->indices);
+
+  for (auto&& operands : std::vector<std::pair<Expr, Expr>>{{lhs, rhs}, {rhs, lhs}}) {
+    auto a_indices = to_loop_indices(operands.first.As<ir::Load>()->indices);
+    auto b_indices = to_loop_indices(operands.second.As<ir::Load>()->indices);
+    MatmulBlockPattern result;
+    for (auto&& var : loop_vars) {
+      if (!result.m_var.defined() && MatchIndexStrides(c_indices, var, 1, 0) &&
+          MatchIndexStrides(a_indices, var, 1, 0) && MatchIndexStrides(b_indices, var, 0, 0)) {
+        result.m_var = var;
+      } else if (!result.n_var.defined() && MatchIndexStrides(c_indices, var, 0, 1) &&
+                 MatchIndexStrides(a_indices, var, 0, 0) && MatchIndexStrides(b_indices, var, 0, 1)) {
+        result.n_var = var;
+      } else if (!result.k_var.defined() && MatchIndexStrides(c_indices, var, 0, 0) &&
+                 MatchIndexStrides(a_indices, var, 0, 1) && MatchIndexStrides(b_indices, var, 1, 0)) {
+        result.k_var = var;
+      }
+    }
+    if (result.m_var.defined() && result.n_var.defined() && result.k_var.defined()) {
+      result.store  = body;
+      result.a_load = operands.first;
+      result.b_load = operands.second;
+      for (auto&& iter_var : schedule_block->iter_vars) {
+        if (iter_var->is_reduce_axis) result.reduce_iter_vars.emplace_back(iter_var);
+      }
+      *pattern = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string GetMatmulTensorizeIntrin(const MatmulBlockPattern& pattern) {
+  std::vector<int> shape(3, kTensorCoreFragmentSize);
+  auto* intrin = TensorizeIntrinRegistry::Global()->Find(pattern, common::Target::Arch::NVGPU, shape);
+  return intrin ? intrin->name : "";
+}
+
 }  // namespace ir
 }  // namespace cinn
@@ -444,5 +444,40 @@ std::unordered_map<int, int> PrimeFactorize(int n);
  * \param dividend The dividend of the number.
  */
 std::vector<int> SampleTile(utils::LinearRandomEngine::StateType* rand_seed, int n, int dividend);
+
+// The M, N and K extents of the matrix fragments computed by a tensor core intrinsic
+constexpr int kTensorCoreFragmentSize = 16;
+
+/*!
+ * \brief The accesses of a matmul-like block computing C[..., x, y] = C[..., x, y] + A[..., x, z] * B[..., z, y].
+ * The loads of A and B may be wrapped by Cast, and the leading indices are the batch dimensions.
+ */
+struct MatmulBlockPattern {
+  // the Store of C, the Load of A and Load of B with the Cast stripped, all indexed by the block iter vars
+  Expr store;
+  Expr a_load;
+  Expr b_load;
+  // the loop vars walking the M, N and K dimensions with unit stride
+  Var m_var;
+  Var n_var;
+  Var k_var;
+  // the reduce iter vars of the block, the tile is initialized when all of them are at their first iteration
+  std::vector<Var> reduce_iter_vars;
+};
+
+/*!
+ * \brief Check whether a block is matmul-like and get its accesses.
+ * \param block The ScheduleBlockRealize to check.
+ * \param pattern The output accesses, only filled when the block matches.
+ * \return Whether the block is matmul-like.
+ */
+bool MatchMatmulBlock(const Expr& block, MatmulBlockPattern* pattern);
+
+/*!
+ * \brief Get the tensor core intrinsic supporting the data types of a matmul-like block.
+ * \param pattern The accesses of the block.
+ * \return The name of the intrinsic, or an empty string if no intrinsic supports it.
+ */
+std::string GetMatmulTensorizeIntrin(const MatmulBlockPattern& pattern);
 }  // namespace ir
 }  // namespace cinn
@@ -169,6 +169,39 @@ std::vector<Expr> _LoweredFunc_::CudaPrepareAllocTempBufferExprs() const {
   return alloc_output_buffer_exprs;
 }
 
+int _LoweredFunc_::CudaDynamicSharedMemBytes(std::unordered_map<std::string, int>* offsets) const {
+  // the max bytes of the static shared memory of a CUDA kernel
+  constexpr int kMaxStaticSharedMemBytes = 48 * 1024;
+  constexpr int kSharedMemAlignment      = 16;
+  std::unordered_map<std::string, int> buffer_offsets;
+  int total_bytes = 0;
+  for (auto& temp_buf : temp_bufs) {
+    if (temp_buf->memory_type != MemoryType::GPUShared || temp_buf->shape.empty() || temp_buf->type() == Void() ||
+        buffer_offsets.count(temp_buf->name)) {
+      continue;
+    }
+    int bytes = temp_buf->dtype.bytes();
+    for (auto& dim : temp_buf->shape) {
+      if (!dim.is_constant()) {
+        VLOG(3) << "The shared memory buffer " << temp_buf->name << " of " << name
+                << " has a dynamic shape, keep the static shared memory";
+        return 0;
+      }
+      bytes *= dim.as_int32();
+    }
+    int offset = (total_bytes + kSharedMemAlignment - 1) / kSharedMemAlignment * kSharedMemAlignment;
+    buffer_offsets[temp_buf->name] = offset;
+    total_bytes                    = offset + bytes;
+  }
+  if (total_bytes <= kMaxStaticSharedMemBytes) {
+    return 0;
+  }
+  if (offsets) {
+    *offsets = std::move(buffer_offsets);
+  }
+  return total_bytes;
+}
+
 void _LoweredFunc_::PrepareDeallocOutputBufferExprs() {
   CHECK(dealloc_output_buffer_exprs.empty()) << "duplicate prepare the allocate buffer for outputs";
 
@@ -431,6 +464,9 @@ std::string Argument::human_readable() const {
 std::ostream& operator<<(std::ostream& os, const CudaAxisInfo& x) {
   os << "<grid:" << x.grid_dim(0) << ", " << x.grid_dim(1) << ", " << x.grid_dim(2) << ">";
   os << "<block:" << x.block_dim(0) << ", " << x.block_dim(1) << ", " << x.block_dim(2) << ">";
+  if (x.cooperative()) {
+    os << "<cooperative>";
+  }
   return os;
 }
 
@@ -456,6 +492,7 @@ int CudaAxisInfo::block_dim(int offset) const {
 }
 void CudaAxisInfo::ExtendWith(const CudaAxisInfo& other) {
   set_valid(true);
+  cooperative_ = cooperative_ || other.cooperative_;
   for (int i = 0; i < 3; i++) {
     grid_dims_[i]  = std::max(grid_dims_[i], other.grid_dims_[i]);
     block_dims_[i] = std::max(block_dims_[i], other.block_dims_[i]);
@@ -15,6 +15,7 @@
 #pragma once
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/ir/buffer.h"
@@ -101,6 +102,10 @@ struct CudaAxisInfo {
   inline void set_valid(bool x = false) { valid_ = x; }
   inline bool valid() const { return valid_; }
 
+  //! Whether the kernel is launched cooperatively, which lets all of its blocks synchronize by the grid-wide barriers.
+  inline void set_cooperative(bool x) { cooperative_ = x; }
+  inline bool cooperative() const { return cooperative_; }
+
   //! Extend the axis dims and keep the larger dims.
   void ExtendWith(const CudaAxisInfo& other);
 
@@ -110,6 +115,7 @@ struct CudaAxisInfo {
   // the three dimensions represents x, y, z
   dim3_t block_dims_;
   bool valid_{false};
+  bool cooperative_{false};
 };
 
 std::ostream& operator<<(std::ostream& os, const CudaAxisInfo& x);
@@ -176,6 +182,13 @@ struct _LoweredFunc_ : ExprNode<_LoweredFunc_> {
   std::vector<Expr> PrepareDeallocTempBufferExprs() const;
   std::vector<Expr> CudaPrepareAllocTempBufferExprs() const;
   std::vector<Expr> CudaAliasVarExprs() const;
+  /**
+   * Get the bytes of the dynamic shared memory of the CUDA kernel, and the offsets of the GPUShared temporary buffers
+   * placed in it by name, which are aligned to 16 bytes. The buffers are only placed in the dynamic shared memory if
+   * their total bytes exceed the 48 KB limit of the static shared memory, otherwise 0 is returned and the buffers are
+   * kept as static `__shared__` arrays.
+   */
+  int CudaDynamicSharedMemBytes(std::unordered_map<std::string, int>* offsets = nullptr) const;
   void PrepareBufferCastExprs(bool with_expr_gen_tensor = true);
   void PrepareCudaAxisInfoFromBody();
 
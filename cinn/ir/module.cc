@@ -36,7 +36,7 @@ void Module::Builder::AddBuffer(ir::Buffer buffer) {
         return x.as_buffer()->name == buffer->name;
       }) == std::end(module_->buffers)) {
     module_->buffers.push_back(buffer);
-    if (module_->target.arch == Target::Arch::X86) {
+    if (module_->target.is_cpu()) {
       module_->buffers.back().as_buffer()->data_alignment = 32;
     }
   }
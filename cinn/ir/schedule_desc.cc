@@ -18,10 +18,12 @@
 
 #include <functional>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/macros.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
@@ -420,6 +422,16 @@ CINN_BUILD_STEP_KIND(Rfactor)
     .Attrs({"rf_axis"})
     .SetApplyFn(APPLY_FUNC_UNIFORM(FREE_FUNCTION_CONVERTER(&IRSchedule::Rfactor)));
 
+CINN_BUILD_STEP_KIND(Tensorize)
+    .Inputs({"loop"})
+    .Attrs({"intrin_name"})
+    .SetApplyFn(APPLY_FUNC_UNIFORM(FREE_FUNCTION_CONVERTER(&IRSchedule::Tensorize)));
+
+CINN_BUILD_STEP_KIND(SoftwarePipeline)
+    .Inputs({"loop"})
+    .Attrs({"num_stages"})
+    .SetApplyFn(APPLY_FUNC_UNIFORM(FREE_FUNCTION_CONVERTER(&IRSchedule::SoftwarePipeline)));
+
 CINN_BUILD_STEP_KIND(MergeExprs)
     .SetApplyFn(APPLY_FUNC_UNIFORM(FREE_FUNCTION_CONVERTER(&IRSchedule::MergeExprs)));
 
@@ -611,9 +623,46 @@ proto::ScheduleDesc ScheduleDesc::ToProto() const {
   return desc_proto;
 }
 
+// Restore a step from its proto and apply it to the IRSchedule, the Exprs of the inputs and outputs are mapped by
+// their formatted names (e1, e2, ...)
+std::vector<Expr> ReplayStep(const proto::ScheduleDesc_Step& step_proto,
+                             IRSchedule* sch,
+                             absl::flat_hash_map<std::string, Expr>* name2expr,
+                             const ScheduleDesc::StepRewriter& rewriter) {
+  VLOG(4) << "Replay step:\n" << step_proto.DebugString();
+  ScheduleDesc::Step step;
+  step.type = step_proto.type();
+  CHECK(!step.type.empty()) << "Name of StepKind is empty";
+  const StepKindInfo* step_kind = StepKindRegistry::Global()->Find(step.type);
+  CHECK(step_kind) << "Can't find StepKind:" << step.type;
+
+  for (auto&& param2args : step_proto.inputs()) {
+    for (auto&& arg : param2args.arguments()) {
+      auto arg_it = name2expr->find(arg);
+      CHECK(arg_it != name2expr->end()) << "Cant't find argument:" << arg;
+      step.inputs[param2args.parameter()].emplace_back(arg_it->second);
+    }
+  }
+  for (auto&& attr : step_proto.attrs()) {
+    step.attrs[attr.name()] = AttrProtoToVariant(attr);
+  }
+  if (rewriter) {
+    rewriter(&step);
+  }
+
+  PackedStepContext context(step, step_kind, sch);
+  step.outputs = step_kind->Apply(&context);
+  CHECK_EQ(step_proto.outputs().size(), step.outputs.size()) << "Output size not matched";
+  for (size_t i = 0; i < step.outputs.size(); ++i) {
+    (*name2expr)[step_proto.outputs(i)] = step.outputs.at(i);
+  }
+  return std::move(step.outputs);
+}
+
 std::vector<Expr> ScheduleDesc::ReplayWithProto(const proto::ScheduleDesc& desc_proto,
                                                 IRSchedule* sch,
-                                                bool without_post_schedule) {
+                                                bool without_post_schedule,
+                                                const StepRewriter& rewriter) {
   VLOG(4) << "proto::ScheduleDesc:\n" << desc_proto.DebugString();
   if (desc_proto.steps().empty()) {
     LOG(WARNING) << "Input proto::ScheduleDesc is empty";
@@ -626,39 +675,21 @@ std::vector<Expr> ScheduleDesc::ReplayWithProto(const proto::ScheduleDesc& desc_
 
   // resotre each scheduling step and apply to the new IRSchedule object
   for (auto&& step_proto : desc_proto.steps()) {
-    VLOG(4) << "Replay step:\n" << step_proto.DebugString();
-    ScheduleDesc::Step step;
-    step.type = step_proto.type();
-    CHECK(!step.type.empty()) << "Name of StepKind is empty";
-    if (without_post_schedule && step.type == "TagPostSchedule") {
+    if (without_post_schedule && step_proto.type() == "TagPostSchedule") {
       break;
     }
-    const StepKindInfo* step_kind = StepKindRegistry::Global()->Find(step.type);
-    CHECK(step_kind) << "Can't find StepKind:" << step.type;
-
-    for (auto&& param2args : step_proto.inputs()) {
-      for (auto&& arg : param2args.arguments()) {
-        auto arg_it = name2expr.find(arg);
-        CHECK(arg_it != name2expr.end()) << "Cant't find argument:" << arg;
-        step.inputs[param2args.parameter()].emplace_back(arg_it->second);
-      }
-    }
-    for (auto&& attr : step_proto.attrs()) {
-      step.attrs[attr.name()] = AttrProtoToVariant(attr);
-    }
-
-    PackedStepContext context(step, step_kind, sch);
-    step.outputs = step_kind->Apply(&context);
-    CHECK_EQ(step_proto.outputs().size(), step.outputs.size()) << "Output size not matched";
-    for (size_t i = 0; i < step.outputs.size(); ++i) {
-      name2expr[step_proto.outputs(i)] = step.outputs.at(i);
-    }
-    last_outputs = std::move(step.outputs);
+    last_outputs = ReplayStep(step_proto, sch, &name2expr, rewriter);
   }
   return last_outputs;
 }
 
 ScheduleDesc ScheduleDesc::ForkAndUpdate(int step_idx, utils::Attribute decision, bool without_post_schedule) const {
+  Step new_step              = steps_.at(step_idx);
+  new_step.attrs["decision"] = decision;
+  return ForkAndUpdate(step_idx, new_step, without_post_schedule);
+}
+
+ScheduleDesc ScheduleDesc::ForkAndUpdate(int step_idx, const Step& new_step, bool without_post_schedule) const {
   int n_valid_step = 0;
   if (!without_post_schedule) {
     n_valid_step = steps_.size();
@@ -672,9 +703,129 @@ ScheduleDesc ScheduleDesc::ForkAndUpdate(int step_idx, utils::Attribute decision
     }
   }
   std::vector<ScheduleDesc::Step> new_steps(steps_.begin(), steps_.begin() + n_valid_step);
-  new_steps[step_idx].attrs["decision"] = decision;
+  new_steps[step_idx] = new_step;
   return ScheduleDesc(std::move(new_steps));
 }
 
+// A state of replaying, it is deep copied when cached or resumed, with the Exprs got by the steps mapped to the copy
+struct ScheduleReplayCache::State {
+  std::vector<Expr> exprs;
+  std::vector<ScheduleDesc::Step> steps;
+  absl::flat_hash_map<std::string, Expr> name2expr;
+
+  State Copy() const {
+    std::unordered_map<const IrNode*, Expr> copied_nodes;
+    State res;
+    res.exprs     = optim::IRCopy(exprs, &copied_nodes);
+    // the Exprs out of the AST, such as the sampled constants or the loops removed, are shared by the copy
+    auto map_expr = [&copied_nodes](const Expr& expr) {
+      auto it = copied_nodes.find(expr.ptr());
+      return it != copied_nodes.end() ? it->second : expr;
+    };
+    res.steps = steps;
+    for (auto& step : res.steps) {
+      for (auto& param2exprs : step.inputs) {
+        for (auto& expr : param2exprs.second) {
+          expr = map_expr(expr);
+        }
+      }
+      for (auto& expr : step.outputs) {
+        expr = map_expr(expr);
+      }
+    }
+    for (auto&& name2expr_pair : name2expr) {
+      res.name2expr.emplace(name2expr_pair.first, map_expr(name2expr_pair.second));
+    }
+    return res;
+  }
+};
+
+struct ScheduleReplayCache::TrieNode {
+  std::unordered_map<std::string, std::unique_ptr<TrieNode>> children;
+  std::shared_ptr<const State> snapshot;
+};
+
+ScheduleReplayCache::ScheduleReplayCache(const ModuleExpr& module_expr, int snapshot_interval, int max_snapshots)
+    : snapshot_interval_(snapshot_interval), max_snapshots_(max_snapshots), root_(std::make_unique<TrieNode>()) {
+  CHECK_GT(snapshot_interval_, 0) << "The snapshot interval must be positive";
+  State origin;
+  origin.exprs    = module_expr.GetExprs();
+  root_->snapshot = std::make_shared<const State>(origin.Copy());
+}
+
+ScheduleReplayCache::~ScheduleReplayCache() {}
+
+IRSchedule ScheduleReplayCache::Replay(const proto::ScheduleDesc& desc_proto,
+                                       bool without_post_schedule,
+                                       utils::LinearRandomEngine::StateType rand_seed) {
+  // the steps with the same proto result in the same state, since the names of the Exprs are numbered in order
+  std::vector<std::string> step_keys;
+  for (auto&& step_proto : desc_proto.steps()) {
+    if (without_post_schedule && step_proto.type() == "TagPostSchedule") {
+      break;
+    }
+    step_keys.emplace_back(step_proto.SerializeAsString());
+  }
+
+  std::shared_ptr<const State> resumed;
+  size_t resumed_size = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TrieNode* node = root_.get();
+    resumed        = node->snapshot;
+    for (size_t i = 0; i < step_keys.size(); ++i) {
+      auto it = node->children.find(step_keys[i]);
+      if (it == node->children.end()) {
+        break;
+      }
+      node = it->second.get();
+      if (node->snapshot) {
+        resumed      = node->snapshot;
+        resumed_size = i + 1;
+      }
+    }
+  }
+  reused_step_count_ += resumed_size;
+  VLOG(4) << "Resume the replay from step " << resumed_size << " of " << step_keys.size();
+
+  State state = resumed->Copy();
+  IRSchedule sch(ModuleExpr(std::move(state.exprs)), ScheduleDesc(std::move(state.steps)), rand_seed);
+  auto& name2expr = state.name2expr;
+  for (size_t i = resumed_size; i < step_keys.size(); ++i) {
+    ReplayStep(desc_proto.steps(i), &sch, &name2expr, nullptr);
+    if ((i + 1) % snapshot_interval_ != 0 && i + 1 != step_keys.size()) {
+      continue;
+    }
+    State current;
+    current.exprs     = sch.GetModule().GetExprs();
+    current.steps     = sch.GetTraceDesc().Steps();
+    current.name2expr = name2expr;
+    auto snapshot     = std::make_shared<const State>(current.Copy());
+    std::lock_guard<std::mutex> lock(mutex_);
+    Insert({step_keys.begin(), step_keys.begin() + i + 1}, std::move(snapshot));
+  }
+  return sch;
+}
+
+void ScheduleReplayCache::Insert(const std::vector<std::string>& step_keys, std::shared_ptr<const State> state) {
+  TrieNode* node = root_.get();
+  for (const auto& key : step_keys) {
+    auto& child = node->children[key];
+    if (!child) {
+      child = std::make_unique<TrieNode>();
+    }
+    node = child.get();
+  }
+  if (node->snapshot) {
+    return;
+  }
+  node->snapshot = std::move(state);
+  snapshot_nodes_.push_back(node);
+  if (snapshot_nodes_.size() > static_cast<size_t>(max_snapshots_)) {
+    snapshot_nodes_.front()->snapshot.reset();
+    snapshot_nodes_.pop_front();
+  }
+}
+
 }  // namespace ir
 }  // namespace cinn
@@ -15,12 +15,18 @@
 #pragma once
 #include <absl/container/flat_hash_map.h>
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "cinn/ir/ir.h"
 #include "cinn/ir/schedule_desc.pb.h"
+#include "cinn/utils/random_engine.h"
 #include "cinn/utils/registry.h"
 #include "cinn/utils/type_defs.h"
 
@@ -50,15 +56,20 @@ class ScheduleDesc {
         : type(type_i), inputs(inputs_i), attrs(attrs_i), outputs(outputs_i) {}
   };
 
+  // A function to modify a restored step before it is applied, such as adjusting its decision to the new IR
+  using StepRewriter = std::function<void(Step* step)>;
+
   /**
    * \brief Re-applied a scheduling process represented as a proto::ScheduleDesc to a new IRSchedule object.
    * @param desc_proto The proto of the ScheduleDesc to be re-applied.
    * @param sch The original IRSchedule to be replayed the description on.
    * @param without_post_schedule Determine whether to delete the post schedules.
+   * @param rewriter The function called on each step before it is applied, optional.
    */
   static std::vector<Expr> ReplayWithProto(const proto::ScheduleDesc& desc_proto,
                                            IRSchedule* sch,
-                                           bool without_post_schedule = false);
+                                           bool without_post_schedule = false,
+                                           const StepRewriter& rewriter = nullptr);
 
   ScheduleDesc() = default;
 
@@ -98,9 +109,61 @@ class ScheduleDesc {
    */
   ScheduleDesc ForkAndUpdate(int step_idx, utils::Attribute decision, bool without_post_schedule) const;
 
+  /**
+   * \brief Fork this ScheduleDesc and replace a step of the new ScheduleDesc, such as changing its attributes or
+   * its inputs to other Exprs resulted by the preceding steps.
+   * @param step_idx The index of the step to be replaced.
+   * @param new_step The new step.
+   * @param without_post_schedule Determine whether to delete the post schedules.
+   * @return The new ScheduleDesc.
+   */
+  ScheduleDesc ForkAndUpdate(int step_idx, const Step& new_step, bool without_post_schedule) const;
+
  private:
   std::vector<Step> steps_;  // all operations are recorded in order.
 };
 
+class ModuleExpr;  // forward declartion to avoid cross-reference
+
+// A ScheduleReplayCache replays the traces on copies of the same original ModuleExpr, such as the candidates mutated
+// from each other in the search or the tuned records restored. The intermediate states are cached in a trie keyed by
+// the steps, so a trace resumes from the state of its longest cached prefix and only replays the rest steps.
+// The states are snapshot every `snapshot_interval` steps and at the end of each trace, and the oldest ones are
+// dropped beyond `max_snapshots`. The traces modified by a StepRewriter are not cached, replay them directly.
+class ScheduleReplayCache {
+ public:
+  explicit ScheduleReplayCache(const ModuleExpr& module_expr, int snapshot_interval = 4, int max_snapshots = 512);
+  ~ScheduleReplayCache();
+
+  /**
+   * \brief Replay a scheduling process on a new IRSchedule of a copy of the original ModuleExpr, it is thread-safe.
+   * @param desc_proto The proto of the ScheduleDesc to be replayed.
+   * @param without_post_schedule Determine whether to delete the post schedules.
+   * @param rand_seed The random seed of the returned IRSchedule.
+   * @return The IRSchedule replayed, the same as the one replaying all the steps by ScheduleDesc::ReplayWithProto.
+   */
+  IRSchedule Replay(const proto::ScheduleDesc& desc_proto,
+                    bool without_post_schedule                     = false,
+                    utils::LinearRandomEngine::StateType rand_seed = -1);
+
+  // the number of steps skipped by resuming from the cached states, for debug and test
+  int64_t ReusedStepCount() const { return reused_step_count_; }
+
+ private:
+  struct State;
+  struct TrieNode;
+
+  // cache the state after the steps of keys, it is called with mutex_ locked
+  void Insert(const std::vector<std::string>& step_keys, std::shared_ptr<const State> state);
+
+  const int snapshot_interval_;
+  const int max_snapshots_;
+  std::mutex mutex_;
+  std::unique_ptr<TrieNode> root_;
+  // the nodes holding a snapshot in the order of caching, the root is not included as it's never dropped
+  std::deque<TrieNode*> snapshot_nodes_;
+  std::atomic<int64_t> reused_step_count_{0};
+};
+
 }  // namespace ir
 }  // namespace cinn
@@ -805,5 +805,39 @@ TEST_F(TestScheduleDesc, StepKind_SampleCategorical) {
   CheckReplayResult(ir_sch, ir_sch.GetTraceDesc());
 }
 
+TEST_F(TestScheduleDesc, ReplayCache) {
+  lowered_funcs         = LowerCompute({32, 32, 64}, target);
+  ir::IRSchedule ir_sch = MakeIRSchedule(lowered_funcs);
+  auto fused            = ir_sch.Fuse(ir_sch.GetLoops("B"));
+  auto sample           = ir_sch.SamplePerfectTile(fused, 2, 1, {256, -1});
+  ir_sch.Split(fused, sample);
+  auto trace_proto = ir_sch.GetTraceDesc().ToProto();
+  ASSERT_EQ(trace_proto.steps_size(), 4);
+
+  ScheduleReplayCache replay_cache(MakeIRSchedule(lowered_funcs).GetModule(), /*snapshot_interval=*/1);
+  // the first replay runs all the steps and caches the state after each of them
+  Context::Global().ResetNameId();
+  auto replayed_sch = replay_cache.Replay(trace_proto);
+  ASSERT_EQ(replay_cache.ReusedStepCount(), 0);
+  ASSERT_EQ(replayed_sch.GetTraceDesc().ToProto().DebugString(), trace_proto.DebugString());
+  CheckReplayResult(replayed_sch, ir_sch.GetTraceDesc());
+
+  // the trace mutated at the sampling step resumes from the state after the first two steps
+  auto mutated_proto = ir_sch.GetTraceDesc().ForkAndUpdate(2, std::vector<int>{128, -1}, false).ToProto();
+  auto mutated_sch   = replay_cache.Replay(mutated_proto);
+  ASSERT_EQ(replay_cache.ReusedStepCount(), 2);
+  ASSERT_EQ(mutated_sch.GetTraceDesc().ToProto().DebugString(), mutated_proto.DebugString());
+  auto loops = mutated_sch.GetLoops("B");
+  ASSERT_EQ(loops.size(), 2);
+  ASSERT_EQ(loops[0].As<ir::For>()->extent.as_int32(), 128);
+  ASSERT_EQ(loops[1].As<ir::For>()->extent.as_int32(), 512);
+
+  // replaying the same trace again is a copy of the cached result
+  auto copied_sch = replay_cache.Replay(trace_proto);
+  ASSERT_EQ(replay_cache.ReusedStepCount(), 6);
+  ASSERT_EQ(utils::GetStreamCnt(copied_sch.GetModule().GetExprs().front()),
+            utils::GetStreamCnt(replayed_sch.GetModule().GetExprs().front()));
+}
+
 }  // namespace ir
 }  // namespace cinn
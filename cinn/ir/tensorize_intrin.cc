@@ -0,0 +1,112 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/tensorize_intrin.h"
+
+#include "cinn/ir/intrinsic_ops.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace ir {
+
+bool TensorizeIntrin::MatchTypes(const MatmulBlockPattern& pattern) const {
+  Type a_type = pattern.a_load.As<ir::Load>()->tensor.as_tensor_ref()->type();
+  Type b_type = pattern.b_load.As<ir::Load>()->tensor.as_tensor_ref()->type();
+  Type c_type = pattern.store.As<ir::Store>()->tensor.as_tensor_ref()->type();
+  return types_.size() == 3U && a_type == types_[0] && b_type == types_[1] && c_type == types_[2];
+}
+
+Expr TensorizeIntrin::MakeCall(const MatmulBlockPattern& pattern) const {
+  auto address_of = [](const Expr& tensor, const std::vector<Expr>& indices) {
+    std::vector<Expr> copied_indices;
+    for (auto&& index : indices) copied_indices.emplace_back(optim::IRCopy(index));
+    return ir::intrinsics::GetAddr::Make(ir::Load::Make(tensor, copied_indices));
+  };
+  auto* c_store = pattern.store.As<ir::Store>();
+  auto* a_load  = pattern.a_load.As<ir::Load>();
+  auto* b_load  = pattern.b_load.As<ir::Load>();
+  // the tile is initialized instead of accumulated to C at the first tile of all the reductions, such as the K and
+  // the filter window of an implicit GEMM convolution
+  Expr is_first_tile = ir::EQ::Make(optim::IRCopy(a_load->indices.back()), Expr(0));
+  if (!pattern.reduce_iter_vars.empty()) {
+    is_first_tile = ir::EQ::Make(Expr(pattern.reduce_iter_vars[0]), Expr(0));
+    for (int i = 1; i < pattern.reduce_iter_vars.size(); ++i) {
+      is_first_tile = ir::And::Make(is_first_tile, ir::EQ::Make(Expr(pattern.reduce_iter_vars[i]), Expr(0)));
+    }
+  }
+  std::vector<Expr> intrin_args = {address_of(c_store->tensor, c_store->indices),
+                                   address_of(a_load->tensor, a_load->indices),
+                                   address_of(b_load->tensor, b_load->indices),
+                                   a_load->tensor.as_tensor_ref()->shape.back(),
+                                   b_load->tensor.as_tensor_ref()->shape.back(),
+                                   c_store->tensor.as_tensor_ref()->shape.back(),
+                                   is_first_tile};
+  return ir::Call::Make(Void(), extern_func_, intrin_args, {}, ir::CallType::Extern, ir::FunctionRef(), 0);
+}
+
+TensorizeIntrinRegistry* TensorizeIntrinRegistry::Global() {
+  static TensorizeIntrinRegistry x;
+  return &x;
+}
+
+const TensorizeIntrin* TensorizeIntrinRegistry::Get(const std::string& name) {
+  const TensorizeIntrin* intrin = Registry<TensorizeIntrin>::Find(name);
+  CHECK(intrin) << "Tensorize intrinsic [" << name << "] is not registered";
+  return intrin;
+}
+
+const TensorizeIntrin* TensorizeIntrinRegistry::Find(const MatmulBlockPattern& pattern,
+                                                     common::Target::Arch arch,
+                                                     const std::vector<int>& shape) {
+  for (auto* intrin : List()) {
+    if (intrin->arch() != arch || !intrin->MatchTypes(pattern)) continue;
+    if (!shape.empty() && std::vector<int>{intrin->m(), intrin->n(), intrin->k()} != shape) continue;
+    return intrin;
+  }
+  return nullptr;
+}
+
+// the tensor core intrinsics executed by a warp, see cinn_cuda_runtime_source.cuh
+CINN_REGISTER_TENSORIZE_INTRIN(wmma_m16n16k16_f16f32)
+    .SetTarget(common::Target::Arch::NVGPU)
+    .SetShape(16, 16, 16)
+    .SetTypes(common::Float16(), common::Float16(), common::Float(32))
+    .SetNumThreads(32)
+    .SetExternFunc("cinn_wmma_m16n16k16_f16f32");
+
+CINN_REGISTER_TENSORIZE_INTRIN(wmma_m16n16k16_f16f16)
+    .SetTarget(common::Target::Arch::NVGPU)
+    .SetShape(16, 16, 16)
+    .SetTypes(common::Float16(), common::Float16(), common::Float16())
+    .SetNumThreads(32)
+    .SetExternFunc("cinn_wmma_m16n16k16_f16f16");
+
+CINN_REGISTER_TENSORIZE_INTRIN(mma_m16n8k16_f16f32)
+    .SetTarget(common::Target::Arch::NVGPU)
+    .SetShape(16, 8, 16)
+    .SetTypes(common::Float16(), common::Float16(), common::Float(32))
+    .SetNumThreads(32)
+    .SetExternFunc("cinn_mma_m16n8k16_f16f32");
+
+// the int8 dot products summed by the VNNI instructions, see host_intrinsics.h
+CINN_REGISTER_TENSORIZE_INTRIN(vnni_m16n16k16_s8s8s32)
+    .SetTarget(common::Target::Arch::X86)
+    .SetShape(16, 16, 16)
+    .SetTypes(common::Int(8), common::Int(8), common::Int(32))
+    .SetNumThreads(1)
+    .SetExternFunc("cinn_host_vnni_m16n16k16_s8s8s32");
+
+}  // namespace ir
+}  // namespace cinn
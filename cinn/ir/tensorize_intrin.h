@@ -0,0 +1,116 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/ir/ir_schedule_util.h"
+#include "cinn/utils/registry.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * The descriptor of a hardware intrinsic which a matmul-like loop nest is replaced with by IRSchedule::Tensorize.
+ *
+ * The pattern of the intrinsic is the tile of matmul C[m, n] = (init ? 0 : C[m, n]) + A[m, k] * B[k, n] with the
+ * given extents and data types, where A, B and C are row major. The implementation is the extern function of the
+ * target, which is called by all the threads of the intrinsic cooperatively as:
+ * \code
+ * fn(&C[0, 0], &A[0, 0], &B[0, 0], lda, ldb, ldc, init)
+ * \endcode
+ */
+class TensorizeIntrin {
+ public:
+  TensorizeIntrin& SetTarget(common::Target::Arch arch) {
+    arch_ = arch;
+    return *this;
+  }
+  //! The extents of the M, N and K dimensions of the tile.
+  TensorizeIntrin& SetShape(int m, int n, int k) {
+    shape_ = {m, n, k};
+    return *this;
+  }
+  //! The data types of A, B and C.
+  TensorizeIntrin& SetTypes(const Type& a_type, const Type& b_type, const Type& c_type) {
+    types_ = {a_type, b_type, c_type};
+    return *this;
+  }
+  //! The number of the threads executing the intrinsic cooperatively, such as a warp for the tensor core.
+  TensorizeIntrin& SetNumThreads(int num_threads) {
+    num_threads_ = num_threads;
+    return *this;
+  }
+  //! The extern function implementing the intrinsic.
+  TensorizeIntrin& SetExternFunc(const std::string& extern_func) {
+    extern_func_ = extern_func;
+    return *this;
+  }
+
+  common::Target::Arch arch() const { return arch_; }
+  int m() const { return shape_[0]; }
+  int n() const { return shape_[1]; }
+  int k() const { return shape_[2]; }
+  int num_threads() const { return num_threads_; }
+  const std::string& extern_func() const { return extern_func_; }
+
+  //! Whether the data types of a matmul-like block are computed by the intrinsic.
+  bool MatchTypes(const MatmulBlockPattern& pattern) const;
+
+  //! Make the call of the implementation on the tile of a matmul-like block, whose origin is indexed by its accesses.
+  Expr MakeCall(const MatmulBlockPattern& pattern) const;
+
+  std::string name;
+
+ private:
+  common::Target::Arch arch_{common::Target::Arch::Unk};
+  std::vector<int> shape_{0, 0, 0};
+  std::vector<Type> types_;
+  int num_threads_{1};
+  std::string extern_func_;
+};
+
+class TensorizeIntrinRegistry : public Registry<TensorizeIntrin> {
+ public:
+  static TensorizeIntrinRegistry* Global();
+
+  const TensorizeIntrin* Get(const std::string& name);
+
+  /**
+   * Find the intrinsic of the target computing a matmul-like block.
+   * @param pattern The accesses of the block.
+   * @param arch The target architecture.
+   * @param shape The extents of the M, N and K dimensions of the tile if not empty.
+   * @return The first registered intrinsic matching them, or nullptr if not found.
+   */
+  const TensorizeIntrin* Find(const MatmulBlockPattern& pattern,
+                              common::Target::Arch arch,
+                              const std::vector<int>& shape = {});
+
+ private:
+  TensorizeIntrinRegistry() = default;
+  CINN_DISALLOW_COPY_AND_ASSIGN(TensorizeIntrinRegistry);
+};
+
+#define CINN_REGISTER_TENSORIZE_INTRIN(name)                              \
+  static ::cinn::ir::TensorizeIntrin& __make_TensorizeIntrin_##name##__ = \
+      ::cinn::ir::TensorizeIntrinRegistry::Global()->__REGISTER__(#name)
+
+}  // namespace ir
+}  // namespace cinn
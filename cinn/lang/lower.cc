@@ -230,7 +230,7 @@ ir::LoweredFunc Lower(const std::string& name,
           break;
         }
       }
-      if (target == common::DefaultNVGPUTarget()) {
+      if (target.is_gpu()) {
         res->device_api = ir::DeviceAPI::GPU;
       }
     }
@@ -283,7 +283,7 @@ std::vector<ir::LoweredFunc> LowerVec(const std::string& name,
         }
       }
 
-      if (target == common::DefaultNVGPUTarget()) {
+      if (target.is_gpu()) {
         res->device_api = ir::DeviceAPI::GPU;
       }
     }
@@ -21,6 +21,8 @@ namespace lang {
 
 using cinn::common::bfloat16;
 using cinn::common::float16;
+using cinn::common::float8_e4m3;
+using cinn::common::float8_e5m2;
 
 ir::Tensor CreatePlaceHolder(const std::vector<int> &shape, Type type, const std::string &name) {
   std::vector<Expr> expr_shape;
@@ -39,6 +41,10 @@ ir::Tensor CreatePlaceHolder(const std::vector<Expr> &shape, Type type, const st
     return Placeholder<bfloat16>(name, shape);
   } else if (type.is_float16()) {
     return Placeholder<float16>(name, shape);
+  } else if (type.is_float8_e4m3()) {
+    return Placeholder<float8_e4m3>(name, shape);
+  } else if (type.is_float8_e5m2()) {
+    return Placeholder<float8_e5m2>(name, shape);
   } else if (type.is_int(8)) {
     return Placeholder<int8_t>(name, shape);
   } else if (type.is_int(16)) {
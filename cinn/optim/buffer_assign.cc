@@ -14,11 +14,17 @@
 
 #include "cinn/optim/buffer_assign.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "cinn/common/union_find.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/lang/lower_impl.h"
 #include "cinn/optim/ir_replace.h"
+#include "cinn/runtime/intrinsic.h"
 
 namespace cinn {
 namespace optim {
@@ -152,5 +158,230 @@ std::map<std::string, ir::Tensor> InitialAssignBuffer(Expr* expr,
   return buffer_updated_tensor;
 }
 
+namespace {
+
+struct BufferAccess {
+  int64_t position;
+  //! The enclosing loops iterated in a thread, from the outermost one.
+  std::vector<const ir::For*> loops;
+  bool is_store;
+  //! The indices of the load or store, nullptr if the tensor is passed to a call.
+  std::vector<Expr>* indices;
+};
+
+//! Collect the accesses of the GPU temp buffers and the __syncthreads in the linear order of a function body.
+struct BufferAccessCollector : public ir::IRMutator<> {
+  void operator()(Expr* body) { ir::IRMutator<>::Visit(body, body); }
+
+  std::map<std::string, std::vector<BufferAccess>> accesses;
+  std::map<std::string, std::set<ir::_Tensor_*>> tensors;
+  std::map<const ir::For*, std::pair<int64_t, int64_t>> loop_ranges;
+  std::vector<int64_t> syncs;
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    // a GPU-bound loop is run once by each thread
+    bool iterated = !op->is_binded();
+    if (iterated) loops_.push_back(op);
+    int64_t begin = position_++;
+    ir::IRMutator<>::Visit(op, expr);
+    if (iterated) {
+      loops_.pop_back();
+      loop_ranges[op] = {begin, position_++};
+    }
+  }
+
+  void Visit(const ir::Store* op, Expr* expr) override {
+    auto* node = expr->As<ir::Store>();
+    ir::IRMutator<>::Visit(&node->value, &node->value);
+    for (auto& index : node->indices) ir::IRMutator<>::Visit(&index, &index);
+    Record(node->tensor, true, &node->indices);
+  }
+
+  void Visit(const ir::Load* op, Expr* expr) override {
+    auto* node = expr->As<ir::Load>();
+    for (auto& index : node->indices) ir::IRMutator<>::Visit(&index, &index);
+    Record(node->tensor, false, &node->indices);
+  }
+
+  void Visit(const ir::_Tensor_* op, Expr* expr) override { Record(*expr, false, nullptr); }
+
+  void Visit(const ir::Call* op, Expr* expr) override {
+    if (op->name == runtime::intrinsic::cuda_sync_threads) syncs.push_back(position_++);
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  void Record(const Expr& tensor, bool is_store, std::vector<Expr>* indices) {
+    auto* node = const_cast<ir::_Tensor_*>(tensor.as_tensor());
+    if (!node || !node->buffer.defined()) return;
+    auto memory_type = node->buffer->memory_type;
+    if (memory_type != ir::MemoryType::GPULocal && memory_type != ir::MemoryType::GPUShared) return;
+    tensors[node->buffer->name].insert(node);
+    accesses[node->buffer->name].push_back({position_++, loops_, is_store, indices});
+  }
+
+  int64_t position_{0};
+  std::vector<const ir::For*> loops_;
+};
+
+//! The number of the loops enclosing all the accesses.
+size_t CommonLoopDepth(const std::vector<BufferAccess>& accesses) {
+  size_t depth = accesses.front().loops.size();
+  for (auto& access : accesses) {
+    size_t i = 0;
+    while (i < depth && i < access.loops.size() && access.loops[i] == accesses.front().loops[i]) ++i;
+    depth = i;
+  }
+  return depth;
+}
+
+std::pair<int64_t, int64_t> LiveRange(const std::vector<BufferAccess>& accesses,
+                                      const std::map<const ir::For*, std::pair<int64_t, int64_t>>& loop_ranges) {
+  size_t depth = CommonLoopDepth(accesses);
+  int64_t begin = std::numeric_limits<int64_t>::max(), end = std::numeric_limits<int64_t>::min();
+  for (auto& access : accesses) {
+    auto range = access.loops.size() > depth ? loop_ranges.at(access.loops[depth])
+                                             : std::make_pair(access.position, access.position);
+    begin = std::min(begin, range.first);
+    end   = std::max(end, range.second);
+  }
+  // the buffer read before written might carry the values across the iterations of the enclosing loops
+  auto first = std::min_element(accesses.begin(), accesses.end(), [](const BufferAccess& a, const BufferAccess& b) {
+    return a.position < b.position;
+  });
+  if (!first->is_store && depth > 0) return loop_ranges.at(first->loops.front());
+  return {begin, end};
+}
+
+int64_t StaticNumElements(const ir::Buffer& buffer) {
+  int64_t num = 1;
+  for (auto& dim : buffer->shape) {
+    if (!dim.is_constant()) return -1;
+    num *= static_cast<int64_t>(dim.get_constant());
+  }
+  return num;
+}
+
+//! Fold the dimension of a local buffer indexed by the variable of an enclosing loop in all the accesses, each iteration
+//! only touches its own slice, so the slices of the different iterations can share the memory.
+void FoldLocalBuffer(const ir::Buffer& buffer,
+                     const std::vector<BufferAccess>& accesses,
+                     const std::set<ir::_Tensor_*>& tensors) {
+  if (buffer->memory_type != ir::MemoryType::GPULocal || tensors.size() != 1) return;
+  auto* tensor = *tensors.begin();
+  size_t rank  = tensor->shape.size();
+  for (auto& access : accesses) {
+    if (!access.indices || access.indices->size() != rank) return;
+  }
+
+  size_t depth = CommonLoopDepth(accesses);
+  for (size_t i = 0; i < depth; ++i) {
+    auto* loop = accesses.front().loops[i];
+    if (!loop->is_serial() && !loop->is_default() && loop->for_type() != ir::ForType::Unrolled) continue;
+    for (size_t dim = 0; dim < rank; ++dim) {
+      bool foldable = !tensor->shape[dim].is_constant() || tensor->shape[dim].get_constant() > 1;
+      for (auto& access : accesses) {
+        auto* var = (*access.indices)[dim].as_var();
+        foldable  = foldable && var && var->name == loop->loop_var->name;
+      }
+      if (!foldable) continue;
+
+      VLOG(3) << "Fold the dimension " << dim << " of buffer " << buffer->name << " by loop " << loop->loop_var->name;
+      for (auto& access : accesses) (*access.indices)[dim] = Expr(0);
+      tensor->shape[dim] = Expr(1);
+      buffer->shape      = tensor->shape;
+    }
+  }
+}
+
+void RewriteFunctionStorage(ir::_LoweredFunc_* func) {
+  BufferAccessCollector collector;
+  collector(&func->body);
+
+  // the buffer nodes in the body are the ones referred by the tensors
+  for (auto& buffer : func->temp_bufs) {
+    auto it = collector.tensors.find(buffer->name);
+    if (it != collector.tensors.end()) buffer = (*it->second.begin())->buffer;
+  }
+
+  struct Candidate {
+    ir::Buffer buffer;
+    int64_t size;
+    std::pair<int64_t, int64_t> range;
+  };
+  std::vector<Candidate> candidates;
+  for (auto& buffer : func->temp_bufs) {
+    auto it = collector.accesses.find(buffer->name);
+    if (it == collector.accesses.end()) continue;
+    FoldLocalBuffer(buffer, it->second, collector.tensors.at(buffer->name));
+    int64_t size = StaticNumElements(buffer);
+    if (size <= 0) continue;
+    candidates.push_back({buffer, size, LiveRange(it->second, collector.loop_ranges)});
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    return a.range.first < b.range.first;
+  });
+
+  struct Slot {
+    ir::Buffer buffer;
+    int64_t size;
+    int64_t free_after;
+  };
+  std::vector<Slot> slots;
+  std::set<std::string> reused;
+  for (auto& candidate : candidates) {
+    auto& buffer = candidate.buffer;
+    Slot* best   = nullptr;
+    for (auto& slot : slots) {
+      if (slot.buffer->memory_type != buffer->memory_type || slot.buffer->dtype != buffer->dtype) continue;
+      if (slot.free_after >= candidate.range.first) continue;
+      if (buffer->memory_type == ir::MemoryType::GPUShared &&
+          std::none_of(collector.syncs.begin(), collector.syncs.end(), [&](int64_t sync) {
+            return sync > slot.free_after && sync < candidate.range.first;
+          })) {
+        continue;
+      }
+      // prefer the smallest slot large enough, or the largest one to grow
+      auto better = [&](const Slot& a, const Slot& b) {
+        bool a_fit = a.size >= candidate.size, b_fit = b.size >= candidate.size;
+        if (a_fit != b_fit) return a_fit;
+        return a_fit ? a.size < b.size : a.size > b.size;
+      };
+      if (!best || better(slot, *best)) best = &slot;
+    }
+    if (!best) {
+      slots.push_back({buffer, candidate.size, candidate.range.second});
+      continue;
+    }
+
+    VLOG(3) << "Reuse buffer " << best->buffer->name << " for " << buffer->name;
+    if (candidate.size > best->size) {
+      best->size          = candidate.size;
+      best->buffer->shape = {Expr(static_cast<int32_t>(best->size))};
+    }
+    best->free_after = candidate.range.second;
+    for (auto* tensor : collector.tensors.at(buffer->name)) tensor->buffer = best->buffer;
+    reused.insert(buffer->name);
+  }
+
+  func->temp_bufs.erase(
+      std::remove_if(func->temp_bufs.begin(),
+                     func->temp_bufs.end(),
+                     [&](const ir::Buffer& buffer) { return reused.count(buffer->name); }),
+      func->temp_bufs.end());
+}
+
+struct StorageRewriteMutator : public ir::IRMutator<> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::_LoweredFunc_* op, Expr* expr) override {
+    RewriteFunctionStorage(expr->As<ir::_LoweredFunc_>());
+  }
+};
+
+}  // namespace
+
+void StorageRewrite(Expr* expr) { StorageRewriteMutator()(expr); }
+
 }  // namespace optim
 }  // namespace cinn
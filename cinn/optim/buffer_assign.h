@@ -35,5 +35,17 @@ std::map<std::string, ir::Tensor> InitialAssignBuffer(Expr* expr,
                                                       const common::Graph* comp_graph,
                                                       const std::set<std::string>& temp_tensor_names);
 
+/**
+ * Rewrite the GPU local and shared temp buffers of the lowered functions in \p expr to reduce the memory of a kernel.
+ *
+ * The live range of each temp buffer is computed on the linear order of the accesses, where an access in a loop not
+ * enclosing all the accesses of the buffer keeps the buffer alive over the whole loop. Then
+ * - a local buffer accessed by the iteration variable of an enclosing serial loop in the same dimension everywhere is
+ *   folded to the single slice of the current iteration,
+ * - the buffers of the same memory type and data type with disjoint live ranges share one allocation, the shared ones
+ *   are only reused across a __syncthreads.
+ */
+void StorageRewrite(Expr* expr);
+
 }  // namespace optim
 }  // namespace cinn
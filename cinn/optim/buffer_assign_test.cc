@@ -0,0 +1,93 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/buffer_assign.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+ir::Tensor MakeLocalTensor(const std::string& name) {
+  ir::Tensor tensor = lang::Compute(
+      {Expr(4), Expr(8)}, [](Var i, Var j) { return Expr(0.f); }, name);
+  tensor->WithBuffer("local", "_" + name + "_temp_buffer");
+  return tensor;
+}
+
+Expr MakeLoop(Var loop_var, int extent, Expr body) {
+  return ir::For::Make(loop_var,
+                       common::make_const(0),
+                       common::make_const(extent),
+                       ir::ForType::Serial,
+                       ir::DeviceAPI::CUDA,
+                       ir::Block::Make({body}));
+}
+
+// for (i, 0, 4)
+//   for (j, 0, 8)
+//     temp[i, j] = A[i, j]
+//   for (j, 0, 8)
+//     C[i, j] = temp[i, j]
+Expr MakeStage(ir::Tensor A, ir::Tensor C, ir::Tensor temp) {
+  Var i(temp->name + "_i");
+  Var j0(temp->name + "_j0");
+  Var j1(temp->name + "_j1");
+  Expr produce = MakeLoop(j0, 8, ir::Store::Make(temp, ir::Load::Make(A, {i, j0}), {Expr(i), Expr(j0)}));
+  Expr consume = MakeLoop(j1, 8, ir::Store::Make(C, ir::Load::Make(temp, {i, j1}), {Expr(i), Expr(j1)}));
+  return ir::For::Make(i,
+                       common::make_const(0),
+                       common::make_const(4),
+                       ir::ForType::Serial,
+                       ir::DeviceAPI::CUDA,
+                       ir::Block::Make({produce, consume}));
+}
+}  // namespace
+
+TEST(StorageRewrite, fold_and_reuse) {
+  Placeholder<float> A("A", std::vector<int>{{4, 8}});
+  Placeholder<float> C("C", std::vector<int>{{4, 8}});
+  ir::Tensor X = MakeLocalTensor("X");
+  ir::Tensor Y = MakeLocalTensor("Y");
+
+  auto func       = common::make_shared<ir::_LoweredFunc_>();
+  func->name      = "storage_rewrite";
+  func->body      = ir::Block::Make({MakeStage(A, C, X), MakeStage(A, C, Y)});
+  func->temp_bufs = {X->buffer, Y->buffer};
+  Expr expr(func);
+
+  StorageRewrite(&expr);
+  LOG(INFO) << "\n" << func->body;
+
+  // each iteration of i only touches its own row, so the rows are folded to one
+  ASSERT_EQ(X->shape.size(), 2U);
+  EXPECT_EQ(X->shape[0].as_int32(), 1);
+  EXPECT_EQ(X->buffer->shape[0].as_int32(), 1);
+  EXPECT_NE(utils::GetStreamCnt(func->body).find("X[0, X_j0] = A[X_i, X_j0]"), std::string::npos);
+
+  // Y is live after the last access of X, so they share the memory
+  ASSERT_EQ(func->temp_bufs.size(), 1U);
+  EXPECT_EQ(func->temp_bufs[0]->name, "_X_temp_buffer");
+  EXPECT_EQ(Y->buffer->name, "_X_temp_buffer");
+}
+
+}  // namespace optim
+}  // namespace cinn
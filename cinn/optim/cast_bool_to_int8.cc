@@ -39,7 +39,7 @@ struct Mutator : public ir::IRMutator<> {
 }  // namespace
 
 void CastBoolToInt8(Expr* e, Target target) {
-  if (target.arch == Target::Arch::X86) {
+  if (target.is_cpu()) {
     Mutator mutator;
     mutator.Visit(e, e);
   }
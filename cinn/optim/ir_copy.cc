@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/common/common.h"
@@ -34,15 +35,24 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
   // Use maps to unify all the copied tensors and buffers.
   std::map<std::string, ir::_Tensor_*> tensor_map;
   std::map<std::string, ir::_Buffer_*> buffer_map;
+  // Record the copy of each node visited if not null.
+  std::unordered_map<const ir::IrNode*, Expr>* copied_nodes{nullptr};
 
-  Expr Visit(const Expr* op) override { return IRVisitorBase::Visit(op); }
+  Expr Visit(const Expr* op) override {
+    auto copied = IRVisitorBase::Visit(op);
+    if (copied_nodes) {
+      (*copied_nodes)[op->ptr()] = copied;
+    }
+    return copied;
+  }
 
  protected:
   // The methods of ir nodes follows the order defined in node.h
 
-  Expr Visit(const ir::IntImm* op) override { return Expr(make_shared<IntImm>(op->type(), op->value)); }
-  Expr Visit(const ir::UIntImm* op) override { return Expr(make_shared<UIntImm>(op->type(), op->value)); }
-  Expr Visit(const ir::FloatImm* op) override { return Expr(make_shared<FloatImm>(op->type(), op->value)); }
+  // the interned constants are immutable, so they are shared by the copy
+  Expr Visit(const ir::IntImm* op) override { return Expr(ir::MakeIntImm(op->type(), op->value)); }
+  Expr Visit(const ir::UIntImm* op) override { return Expr(ir::MakeUIntImm(op->type(), op->value)); }
+  Expr Visit(const ir::FloatImm* op) override { return Expr(ir::MakeFloatImm(op->type(), op->value)); }
   Expr Visit(const ir::StringImm* op) override { return Expr(common::make_shared<StringImm>(op->value)); }
 
   Expr Visit(const ir::Cast* op) override {
@@ -461,6 +471,16 @@ std::vector<Expr> IRCopy(const std::vector<Expr>& x) {
 
 ir::ModuleExpr IRCopy(const ir::ModuleExpr& x) { return ir::ModuleExpr(IRCopy(x.GetExprs())); }
 
+std::vector<Expr> IRCopy(const std::vector<Expr>& x, std::unordered_map<const ir::IrNode*, Expr>* copied_nodes) {
+  std::vector<Expr> res;
+  for (auto& i : x) {
+    IRCopyVisitor visitor;
+    visitor.copied_nodes = copied_nodes;
+    res.emplace_back(visitor.Visit(&i));
+  }
+  return res;
+}
+
 ir::LoweredFunc IRCopy(const ir::LoweredFunc& x) {
   ir::Expr copy_func_expr          = IRCopy(static_cast<ir::Expr>(x));
   ir::_LoweredFunc_* copy_func_ptr = copy_func_expr.As<ir::_LoweredFunc_>();
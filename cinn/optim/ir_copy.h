@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -35,6 +36,10 @@ std::vector<Expr> IRCopy(const std::vector<Expr>& x);
 
 ir::ModuleExpr IRCopy(const ir::ModuleExpr& x);
 
+//! Copy the expressions and record the copy of each node of them, so the exprs referring to the nodes of the original
+//! can be mapped to the copy.
+std::vector<Expr> IRCopy(const std::vector<Expr>& x, std::unordered_map<const ir::IrNode*, Expr>* copied_nodes);
+
 ir::LoweredFunc IRCopy(const ir::LoweredFunc& x);
 
 std::vector<ir::LoweredFunc> IRCopy(const std::vector<ir::LoweredFunc>& x);
@@ -0,0 +1,224 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/local_common_subexpr_elimination.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::optim {
+
+namespace {
+
+//! Tell whether \p e is an integer arithmetic over the constants and the variables, the flags are set if it contains
+//! a variable or a division/modulo.
+bool IsIndexMath(const Expr& e, bool* has_var, bool* has_div) {
+  if (!e.type().is_int() || e.type().lanes() != 1) return false;
+  if (e.As<ir::IntImm>()) return true;
+  if (e.As<ir::_Var_>()) {
+    *has_var = true;
+    return true;
+  }
+  if (e.As<ir::Div>() || e.As<ir::Mod>()) {
+    *has_div = true;
+  } else if (!(e.As<ir::Add>() || e.As<ir::Sub>() || e.As<ir::Mul>() || e.As<ir::Min>() || e.As<ir::Max>())) {
+    return false;
+  }
+  for (auto& operand : e->operands) {
+    if (!IsIndexMath(operand, has_var, has_div)) return false;
+  }
+  return true;
+}
+
+//! The scalar loads of the tensors and the index arithmetic heavier than an add or a multiply are worth binding, the
+//! rest is left to the CSE of the backend compilers.
+bool IsCandidate(const Expr& e) {
+  if (e.type().lanes() != 1) return false;
+  if (auto* load = e.As<ir::Load>()) {
+    if (!load->is_addr_tensor()) return false;
+    for (auto& index : load->indices) {
+      if (index.type().lanes() != 1) return false;
+    }
+    return true;
+  }
+  bool has_var = false, has_div = false;
+  return IsIndexMath(e, &has_var, &has_div) && has_var && has_div;
+}
+
+//! Count the candidates evaluated unconditionally in a statement.
+struct CandidateCounter : public ir::IRMutator<> {
+  std::map<std::string, int> operator()(Expr* stmt) {
+    Visit(stmt, stmt);
+    return counts_;
+  }
+
+ private:
+  using ir::IRMutator<>::Visit;
+
+#define __(op__)                                       \
+  void Visit(const ir::op__* op, Expr* expr) override { \
+    Count(*expr);                                      \
+    ir::IRMutator<>::Visit(op, expr);                  \
+  }
+  NODETY_OP_FOR_EACH(__)
+  __(Load)
+#undef __
+
+  // only the condition of a select is always evaluated
+  void Visit(const ir::Select* op, Expr* expr) override {
+    auto* node = expr->As<ir::Select>();
+    Visit(&node->condition, &node->condition);
+  }
+
+  void Visit(const ir::_Tensor_* op, Expr* expr) override {}
+
+  void Count(const Expr& e) {
+    if (IsCandidate(e)) ++counts_[utils::GetStreamCnt(e)];
+  }
+
+  std::map<std::string, int> counts_;
+};
+
+//! Replace the maximal repeated candidates in a statement with the variables, and collect their bindings in the order
+//! of the dependencies.
+struct CandidateBinder : public ir::IRMutator<> {
+  CandidateBinder(const std::map<std::string, int>& counts, const std::string& prefix, std::set<std::string>* used_names)
+      : counts_(counts), prefix_(prefix), used_names_(used_names) {}
+
+  std::vector<Expr> operator()(Expr* stmt) {
+    Visit(stmt, stmt);
+    return lets_;
+  }
+
+ private:
+  using ir::IRMutator<>::Visit;
+
+#define __(op__) \
+  void Visit(const ir::op__* op, Expr* expr) override { Bind(op, expr); }
+  NODETY_OP_FOR_EACH(__)
+  __(Load)
+#undef __
+
+  void Visit(const ir::_Tensor_* op, Expr* expr) override {}
+
+  template <typename T>
+  void Bind(const T* op, Expr* expr) {
+    auto key   = utils::GetStreamCnt(*expr);
+    auto bound = bound_.find(key);
+    if (bound == bound_.end()) {
+      auto it = counts_.find(key);
+      // the subexpressions only repeated inside a bound one are computed once with it
+      if (it == counts_.end() || it->second < 2 || it->second <= enclosing_count_) {
+        ir::IRMutator<>::Visit(op, expr);
+        return;
+      }
+      int enclosing_count = enclosing_count_;
+      enclosing_count_    = it->second;
+      ir::IRMutator<>::Visit(op, expr);
+      enclosing_count_ = enclosing_count;
+
+      Var var(NewName(), expr->type());
+      lets_.push_back(ir::Let::Make(var, *expr));
+      bound = bound_.emplace(key, var).first;
+    }
+    *expr = Expr(bound->second);
+  }
+
+  std::string NewName() {
+    std::string name;
+    do {
+      name = prefix_ + std::to_string(name_id_++);
+    } while (used_names_->count(name));
+    used_names_->insert(name);
+    return name;
+  }
+
+  const std::map<std::string, int>& counts_;
+  std::string prefix_;
+  std::set<std::string>* used_names_;
+  int name_id_{0};
+  int enclosing_count_{0};
+  std::map<std::string, Var> bound_;
+  std::vector<Expr> lets_;
+};
+
+struct LocalCommonSubexprEliminationMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  void operator()(Expr* e) {
+    ir::CollectIRNodesWithoutTensor(*e, [&](const Expr* x) {
+      if (auto* var = x->As<ir::_Var_>()) {
+        used_names_.insert(var->name);
+      } else if (auto* tensor = x->As<ir::_Tensor_>()) {
+        used_names_.insert(tensor->name);
+        if (tensor->buffer.defined()) used_names_.insert(tensor->buffer->name);
+      }
+      return false;
+    });
+    Visit(e, e);
+  }
+
+ private:
+  void Visit(const ir::Store* op, Expr* expr) override {
+    if (!op->is_addr_tensor()) return;
+    auto counts = CandidateCounter()(expr);
+    bool repeated = false;
+    for (auto& item : counts) repeated |= item.second > 1;
+    if (!repeated) return;
+
+    CandidateBinder binder(counts, op->tensor.as_tensor()->name + "_cse", &used_names_);
+    // the nodes might be shared by the store and the loads, copy them before the replacement
+    *expr = IRCopy(*expr);
+    auto lets = binder(expr);
+    lets.push_back(*expr);
+    *expr = ir::Block::Make(lets);
+    bound_blocks_.insert(expr->ptr());
+  }
+
+  // splice the bindings into the enclosing block instead of nesting a new scope
+  void Visit(const ir::Block* op, Expr* expr) override {
+    auto* node = expr->As<ir::Block>();
+    std::vector<Expr> stmts;
+    for (auto& stmt : node->stmts) {
+      Visit(&stmt, &stmt);
+      auto* block = stmt.As<ir::Block>();
+      if (block && bound_blocks_.count(block)) {
+        stmts.insert(stmts.end(), block->stmts.begin(), block->stmts.end());
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+    node->stmts = std::move(stmts);
+  }
+
+  std::set<std::string> used_names_;
+  std::set<const ir::IrNode*> bound_blocks_;
+};
+
+}  // namespace
+
+void LocalCommonSubexprElimination(Expr* e) {
+  LocalCommonSubexprEliminationMutator mutator;
+  mutator(e);
+}
+
+}  // namespace cinn::optim
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn::optim {
+
+/**
+ * Bind the loads and the div/mod index arithmetic repeated in a store to the variables ahead of it.
+ *
+ * The inlined computations of a fused kernel repeat the same loads in one statement, e.g.
+ *
+ * \code
+ * C[i] = (exp(A[i]) / (1 + exp(A[i])))
+ * \endcode
+ *
+ * is transformed to
+ *
+ * \code
+ * float C_cse0 = A[i]
+ * C[i] = (exp(C_cse0) / (1 + exp(C_cse0)))
+ * \endcode
+ *
+ * so that each value is loaded once. Only the occurrences evaluated unconditionally are counted, the loads guarded by a
+ * select are never hoisted out of it.
+ */
+void LocalCommonSubexprElimination(Expr* e);
+
+}  // namespace cinn::optim
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/local_common_subexpr_elimination.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn::optim {
+
+TEST(LocalCommonSubexprElimination, repeated_load) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> C("C", std::vector<int>{{256}});
+  Var i("i");
+
+  // C[i] = A[(i / 4)] * A[(i / 4)] + A[i]
+  Expr index = ir::Div::Make(i, Expr(4));
+  Expr value = ir::Add::Make(
+      ir::Mul::Make(ir::Load::Make(ir::Tensor(A), {index}), ir::Load::Make(ir::Tensor(A), {index})),
+      ir::Load::Make(ir::Tensor(A), {Expr(i)}));
+  Expr body = ir::Block::Make({ir::Store::Make(ir::Tensor(C), value, {Expr(i)})});
+
+  LocalCommonSubexprElimination(&body);
+  LOG(INFO) << "\n" << body;
+
+  // the repeated load is bound once, and its index repeated only inside it is kept
+  auto& stmts = body.As<ir::Block>()->stmts;
+  ASSERT_EQ(stmts.size(), 2U);
+  auto* let = stmts[0].As<ir::Let>();
+  ASSERT_TRUE(let);
+  EXPECT_EQ(let->symbol.as_var()->name, "C_cse0");
+  EXPECT_EQ(utils::GetStreamCnt(let->body), "A[(i / 4)]");
+  EXPECT_EQ(utils::GetStreamCnt(stmts[1]), "C[i] = ((C_cse0 * C_cse0) + A[i])");
+}
+
+TEST(LocalCommonSubexprElimination, keep_guarded_load) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> C("C", std::vector<int>{{256}});
+  Var i("i");
+
+  // the loads out of the bound are only evaluated under the condition
+  Expr load  = ir::Load::Make(ir::Tensor(A), {ir::Sub::Make(i, Expr(1))});
+  Expr value = ir::Select::Make(ir::GT::Make(i, Expr(0)), ir::Add::Make(load, load), Expr(0.f));
+  Expr body  = ir::Block::Make({ir::Store::Make(ir::Tensor(C), value, {Expr(i)})});
+  auto origin = utils::GetStreamCnt(body);
+
+  LocalCommonSubexprElimination(&body);
+  EXPECT_EQ(utils::GetStreamCnt(body), origin);
+}
+
+}  // namespace cinn::optim
@@ -0,0 +1,210 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::optim {
+
+namespace {
+
+//! The loops whose iterations run one after another in a thread, so the values hoisted ahead of them are computed once.
+bool IsHoistableLoop(const ir::For* op) {
+  return op->is_serial() || op->is_default() || op->for_type() == ir::ForType::Unrolled;
+}
+
+//! The variables whose values might change between the iterations of the loop.
+std::set<std::string> CollectVariantVars(const ir::For* op) {
+  std::set<std::string> names{op->loop_var->name};
+  ir::CollectIRNodesWithoutTensor(op->body, [&](const Expr* x) {
+    if (auto* for_node = x->As<ir::For>()) {
+      names.insert(for_node->loop_var->name);
+    } else if (auto* poly_for = x->As<ir::PolyFor>()) {
+      names.insert(poly_for->iterator->name);
+    } else if (auto* let = x->As<ir::Let>()) {
+      names.insert(let->symbol.as_var()->name);
+    } else if (auto* store = x->As<ir::Store>()) {
+      if (store->tensor.as_var()) names.insert(store->tensor.as_var()->name);
+    }
+    return false;
+  });
+  return names;
+}
+
+struct InvariantInfo {
+  bool has_var{false};
+  bool has_div{false};
+};
+
+//! Tell whether \p e is a side-effect-free scalar expression that evaluates to the same value in all the iterations and
+//! never traps, the division and modulo are only allowed on the positive constant divisors.
+bool IsInvariant(const Expr& e, const std::set<std::string>& variant_vars, InvariantInfo* info) {
+  if (e.type().lanes() != 1) return false;
+  if (e.As<ir::IntImm>() || e.As<ir::UIntImm>()) return true;
+  if (auto* var = e.As<ir::_Var_>()) {
+    info->has_var = true;
+    return (var->type().is_int() || var->type().is_uint() || var->type().is_bool()) && !variant_vars.count(var->name);
+  }
+  if (auto* select = e.As<ir::Select>()) {
+    return IsInvariant(select->condition, variant_vars, info) && IsInvariant(select->true_value, variant_vars, info) &&
+           IsInvariant(select->false_value, variant_vars, info);
+  }
+  if (e.As<ir::Div>() || e.As<ir::Mod>()) {
+    auto* divisor = e->operands[1].As<ir::IntImm>();
+    if (!divisor || divisor->value <= 0) return false;
+    info->has_div = true;
+  } else if (!(e.As<ir::Add>() || e.As<ir::Sub>() || e.As<ir::Mul>() || e.As<ir::Min>() || e.As<ir::Max>() ||
+               e.As<ir::EQ>() || e.As<ir::NE>() || e.As<ir::LT>() || e.As<ir::LE>() || e.As<ir::GT>() ||
+               e.As<ir::GE>() || e.As<ir::And>() || e.As<ir::Or>() || e.As<ir::Not>())) {
+    return false;
+  }
+  for (auto& operand : e->operands) {
+    if (!IsInvariant(operand, variant_vars, info)) return false;
+  }
+  return true;
+}
+
+//! Replace the maximal invariant subexpressions in the body of a loop with the variables bound ahead of the loop.
+struct InvariantHoister : public ir::IRMutator<> {
+  InvariantHoister(const ir::For* loop, std::set<std::string>* used_names)
+      : variant_vars_(CollectVariantVars(loop)), prefix_(loop->loop_var->name + "_inv"), used_names_(used_names) {}
+
+  std::vector<Expr> operator()(Expr* body) {
+    Visit(body, body);
+    return lets_;
+  }
+
+ private:
+  using ir::IRMutator<>::Visit;
+
+  // a hoisted expression is rooted at an operator or a select
+#define __(op__)                                       \
+  void Visit(const ir::op__* op, Expr* expr) override { \
+    if (!Hoist(expr)) ir::IRMutator<>::Visit(op, expr); \
+  }
+  NODETY_OP_FOR_EACH(__)
+  __(Select)
+#undef __
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // the values hoisted out of a parallel or GPU-bound loop would be shared by all its threads
+    if (IsHoistableLoop(op)) ir::IRMutator<>::Visit(op, expr);
+  }
+
+  void Visit(const ir::_Tensor_* op, Expr* expr) override {}
+  void Visit(const ir::_Buffer_* op, Expr* expr) override {}
+
+  bool Hoist(Expr* op) {
+    InvariantInfo info;
+    if (!op->type().is_int() || !IsInvariant(*op, variant_vars_, &info) || !info.has_var || !info.has_div) {
+      return false;
+    }
+    auto key = utils::GetStreamCnt(*op);
+    auto it  = hoisted_.find(key);
+    if (it == hoisted_.end()) {
+      Var var(NewName(), op->type());
+      lets_.push_back(ir::Let::Make(var, *op));
+      it = hoisted_.emplace(key, var).first;
+    }
+    *op = Expr(it->second);
+    return true;
+  }
+
+  std::string NewName() {
+    std::string name;
+    do {
+      name = prefix_ + std::to_string(name_id_++);
+    } while (used_names_->count(name));
+    used_names_->insert(name);
+    return name;
+  }
+
+  std::set<std::string> variant_vars_;
+  std::string prefix_;
+  std::set<std::string>* used_names_;
+  int name_id_{0};
+  std::map<std::string, Var> hoisted_;
+  std::vector<Expr> lets_;
+};
+
+struct LoopInvariantCodeMotionMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  void operator()(Expr* e) {
+    ir::CollectIRNodesWithoutTensor(*e, [&](const Expr* x) {
+      if (auto* var = x->As<ir::_Var_>()) {
+        used_names_.insert(var->name);
+      } else if (auto* tensor = x->As<ir::_Tensor_>()) {
+        used_names_.insert(tensor->name);
+        if (tensor->buffer.defined()) used_names_.insert(tensor->buffer->name);
+      }
+      return false;
+    });
+    Visit(e, e);
+  }
+
+ private:
+  // the outer loops are processed first, so each value is hoisted as far as it can go
+  void Visit(const ir::For* op, Expr* expr) override {
+    auto* node = expr->As<ir::For>();
+    std::vector<Expr> lets;
+    if (IsHoistableLoop(node)) {
+      InvariantHoister hoister(node, &used_names_);
+      lets = hoister(&node->body);
+    }
+    ir::IRMutator<>::Visit(node, expr);
+    if (!lets.empty()) {
+      lets.push_back(*expr);
+      *expr = ir::Block::Make(lets);
+      hoisted_blocks_.insert(expr->ptr());
+    }
+  }
+
+  // splice the bindings into the enclosing block instead of nesting a new scope
+  void Visit(const ir::Block* op, Expr* expr) override {
+    auto* node = expr->As<ir::Block>();
+    std::vector<Expr> stmts;
+    for (auto& stmt : node->stmts) {
+      Visit(&stmt, &stmt);
+      auto* block = stmt.As<ir::Block>();
+      if (block && hoisted_blocks_.count(block)) {
+        stmts.insert(stmts.end(), block->stmts.begin(), block->stmts.end());
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+    node->stmts = std::move(stmts);
+  }
+
+  std::set<std::string> used_names_;
+  std::set<const ir::IrNode*> hoisted_blocks_;
+};
+
+}  // namespace
+
+void LoopInvariantCodeMotion(Expr* e) {
+  LoopInvariantCodeMotionMutator mutator;
+  mutator(e);
+}
+
+}  // namespace cinn::optim
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn::optim {
+
+/**
+ * Hoist the loop-invariant integer arithmetic containing division or modulo out of the serial loops.
+ *
+ * The index of the fused or split loops repeats the same div/mod of the outer loop variables in every iteration of the
+ * inner loops, e.g.
+ *
+ * \code
+ * for (i, 0, 256)
+ *   for (j, 0, 4)
+ *     B[((i / 8) * 32) + (((4 * i) + j) % 32)] = ...
+ * \endcode
+ *
+ * is transformed to
+ *
+ * \code
+ * for (i, 0, 256)
+ *   int32 j_inv0 = ((i / 8) * 32)
+ *   for (j, 0, 4)
+ *     B[j_inv0 + (((4 * i) + j) % 32)] = ...
+ * \endcode
+ *
+ * Only the side-effect-free expressions over the integer constants and the variables defined out of the loop are
+ * hoisted, and the parallel, vectorized or GPU-bound loops are kept untouched.
+ */
+void LoopInvariantCodeMotion(Expr* e);
+
+}  // namespace cinn::optim
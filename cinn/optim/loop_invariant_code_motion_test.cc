@@ -0,0 +1,84 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn::optim {
+
+namespace {
+Expr MakeLoop(Var loop_var, int extent, ir::ForType for_type, Expr body) {
+  return ir::For::Make(loop_var,
+                       common::make_const(0),
+                       common::make_const(extent),
+                       for_type,
+                       ir::DeviceAPI::Host,
+                       ir::Block::Make({body}));
+}
+}  // namespace
+
+TEST(LoopInvariantCodeMotion, hoist_div_mod) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> B("B", std::vector<int>{{1024}});
+  Var i("i");
+  Var j("j");
+
+  // B[((i / 8) * 32) + (((4 * i) + j) % 32)] = A[same]
+  Expr index = ir::Add::Make(ir::Mul::Make(ir::Div::Make(i, Expr(8)), Expr(32)),
+                             ir::Mod::Make(ir::Add::Make(ir::Mul::Make(Expr(4), i), j), Expr(32)));
+  Expr store = ir::Store::Make(ir::Tensor(B), ir::Load::Make(ir::Tensor(A), {index}), {index});
+  Expr inner = MakeLoop(j, 4, ir::ForType::Serial, store);
+  Expr outer = MakeLoop(i, 256, ir::ForType::Serial, inner);
+
+  LoopInvariantCodeMotion(&outer);
+  LOG(INFO) << "\n" << outer;
+
+  // the repeated invariant part is bound once ahead of the inner loop
+  auto& stmts = outer.As<ir::For>()->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(stmts.size(), 2U);
+  auto* let = stmts[0].As<ir::Let>();
+  ASSERT_TRUE(let);
+  EXPECT_EQ(let->symbol.as_var()->name, "j_inv0");
+  EXPECT_EQ(utils::GetStreamCnt(let->body), "((i / 8) * 32)");
+  ASSERT_TRUE(stmts[1].As<ir::For>());
+
+  auto out = utils::GetStreamCnt(stmts[1]);
+  EXPECT_EQ(out.find("(i / 8)"), std::string::npos);
+  EXPECT_NE(out.find("j_inv0"), std::string::npos);
+}
+
+TEST(LoopInvariantCodeMotion, keep_parallel_loop) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> B("B", std::vector<int>{{1024}});
+  Var i("i");
+  Var j("j");
+
+  Expr index = ir::Add::Make(ir::Mul::Make(ir::Div::Make(i, Expr(8)), Expr(32)), j);
+  Expr store = ir::Store::Make(ir::Tensor(B), ir::Load::Make(ir::Tensor(A), {index}), {index});
+  Expr inner = MakeLoop(j, 4, ir::ForType::Parallel, store);
+  Expr outer = MakeLoop(i, 256, ir::ForType::Serial, inner);
+  auto origin = utils::GetStreamCnt(outer);
+
+  LoopInvariantCodeMotion(&outer);
+  EXPECT_EQ(utils::GetStreamCnt(outer), origin);
+}
+
+}  // namespace cinn::optim
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/lower_block_reduce.h"
+
+#include <glog/logging.h>
+
+#include <cstring>
+#include <string>
+
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+const char* kBlockReducePrefix = "cinn_block_reduce_";
+const char* kInternalSuffix    = "_internal";
+
+struct BlockReduceLowerer : public ir::IRMutator<> {
+  explicit BlockReduceLowerer(int width) : width_(width) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::Call* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* call = expr->As<ir::Call>();
+    if (!call->is_extern_call() || !utils::Startswith(call->name, kBlockReducePrefix) ||
+        !utils::Endswith(call->name, kInternalSuffix) || call->read_args.size() != 1) {
+      return;
+    }
+    // cinn_block_reduce_{op}_{dtype}_internal -> cinn_warp_allreduce_{op}_{dtype}
+    std::string name        = call->name;
+    size_t prefix_size      = std::strlen(kBlockReducePrefix);
+    std::string reduce_type = name.substr(prefix_size, name.size() - prefix_size - std::strlen(kInternalSuffix));
+    *expr                   = ir::Call::Make(call->type(),
+                           "cinn_warp_allreduce_" + reduce_type,
+                           {call->read_args[0], Expr(width_)},
+                           {},
+                           ir::CallType::Extern,
+                           ir::FunctionRef(),
+                           0);
+    VLOG(4) << "Lower " << name << " to " << *expr;
+  }
+
+  int width_;
+};
+
+}  // namespace
+
+void LowerBlockReduce(Expr* lowered_func) {
+  auto* func = lowered_func->as_lowered_func();
+  CHECK(func) << "The input of LowerBlockReduce should be lowered_func!";
+  if (!func->cuda_axis_info.valid()) {
+    return;
+  }
+  int width = func->cuda_axis_info.block_dim(0);
+  // the rows reduced by the whole block still go through the shared memory between the warps
+  if (width > 32 || (width & (width - 1)) != 0) {
+    return;
+  }
+  BlockReduceLowerer lowerer(width);
+  lowerer(&func->body);
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,39 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Lower the block reductions of a CUDA kernel whose rows are reduced by a warp or a part of warp, that is, the
+ * blockDim.x is a power of 2 not more than 32, into the register-level reductions by __shfl_xor_sync.
+ *
+ * e.g.
+ *
+ * The expression in a kernel of blockDim.x = 16:
+ * A_tmp[i] = cinn_block_reduce_sum_fp32_internal(A_local[i])
+ *
+ * to
+ *
+ * A_tmp[i] = cinn_warp_allreduce_sum_fp32(A_local[i], 16)
+ *
+ * which neither allocates the shared memory nor synchronizes the threads. It requires the cuda axis info set.
+ */
+void LowerBlockReduce(Expr* lowered_func);
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/lower_block_reduce.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn::optim {
+
+namespace {
+// A_tmp[i] = cinn_block_reduce_sum_fp32_internal(A[i]) in a kernel of the block_dim threads
+Expr MakeBlockReduceFunc(int block_dim) {
+  Placeholder<float> A("A", std::vector<int>{{block_dim}});
+  Placeholder<float> B("B", std::vector<int>{{block_dim}});
+  Var i("i");
+  Expr value = ir::Call::Make(Float(32),
+                              "cinn_block_reduce_sum_fp32_internal",
+                              {ir::Load::Make(ir::Tensor(A), {Expr(i)})},
+                              {},
+                              ir::CallType::Extern,
+                              ir::FunctionRef(),
+                              0);
+  Expr store = ir::Store::Make(ir::Tensor(B), value, {Expr(i)});
+  Expr body  = ir::Block::Make({store});
+  auto func  = ir::_LoweredFunc_::Make("block_reduce", {}, body, {});
+  func->cuda_axis_info.set_block_dim(0, block_dim);
+  func->cuda_axis_info.set_valid(true);
+  return Expr(func);
+}
+}  // namespace
+
+TEST(LowerBlockReduce, warp) {
+  Expr func = MakeBlockReduceFunc(16);
+  LowerBlockReduce(&func);
+  auto out = utils::GetStreamCnt(func.as_lowered_func_ref()->body);
+  LOG(INFO) << "\n" << out;
+  EXPECT_NE(out.find("cinn_warp_allreduce_sum_fp32(A[i], 16)"), std::string::npos);
+  EXPECT_EQ(out.find("cinn_block_reduce"), std::string::npos);
+}
+
+TEST(LowerBlockReduce, keep_block) {
+  // the rows reduced by multiple warps or by the lanes not a power of 2 keep the block reduction
+  for (int block_dim : {128, 24}) {
+    Expr func = MakeBlockReduceFunc(block_dim);
+    LowerBlockReduce(&func);
+    auto out = utils::GetStreamCnt(func.as_lowered_func_ref()->body);
+    EXPECT_NE(out.find("cinn_block_reduce_sum_fp32_internal"), std::string::npos);
+  }
+}
+
+}  // namespace cinn::optim
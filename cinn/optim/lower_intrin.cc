@@ -26,7 +26,7 @@ namespace cinn {
 namespace optim {
 
 void LowerIntrin(Expr *e, Target target) {
-  if (target.arch == Target::Arch::X86) {
+  if (target.is_cpu()) {
     codegen::RegisterCpuIntrinRule();
   } else {
     return;
@@ -74,9 +74,9 @@ void LowerIntrin(Expr *e, Target target) {
         Expr ret = (*func_ptr)(Expr(node));
         if (!ret.same_as(*expr)) {
           ir::IRMutator<>::Visit(&ret, &ret);
+          *expr = ret;
+          return;
         }
-        *expr = ret;
-        return;
       }
       for (auto &expr : node->read_args) {
         ir::IRMutator<>::Visit(&expr, &expr);
@@ -14,11 +14,16 @@
 
 #include "cinn/optim/map_extern_call.h"
 
+#include <gflags/gflags.h>
+
+#include "cinn/backends/llvm/llvm_vector_math.h"
 #include "cinn/cinn.h"
 #include "cinn/hlir/op/op_util.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/runtime/cpu/host_intrinsics.h"
 
+DECLARE_string(cinn_nvgpu_math_precision);
+
 namespace cinn {
 namespace optim {
 
@@ -39,6 +44,10 @@ static const std::set<std::string> kExternInt32CallsGPU{{"left_shift",
                                                          "popc",
                                                          "mod"}};
 
+// The fp32 functions mapped to the fast intrinsics, such as __expf and tanh.approx, by the "approx" and "fast" math
+// precision, whose extern functions have the suffix "_fast".
+static const std::set<std::string> kFastMathCallsGPU = {"exp", "log", "sin", "cos", "tan", "tanh", "sigmoid", "pow"};
+
 static const std::set<std::string> kExternFp32CallsCPU = {
     "erf", "acos", "acosh", "asin", "asinh", "atan", "atanh", "remainder"};
 
@@ -54,7 +63,7 @@ void MapExternCall(Expr *e, Target target) {
       auto *node = expr->As<ir::Call>();
       CHECK(node);
       OptimizeConstantPow(node);
-      if (target.arch == Target::Arch::NVGPU) {
+      if (target.is_gpu()) {
         DealWithNvGpuintrinsics(node, expr);
       } else {
         DealWithCpuintrinsics(node, expr);
@@ -66,6 +75,10 @@ void MapExternCall(Expr *e, Target target) {
         CHECK_GE(node->read_args.size(), 1UL);
         CHECK(node->read_args.front().type().is_float())
             << "CPU extern call instrinsices only support float now! Please check.";
+        // expanded into the inline vector math by LowerIntrin
+        if (codegen::UseX86VectorMath(node->name, node->type())) {
+          return;
+        }
         if (node->read_args.front().type().is_float(32)) {
           auto out_type = node->type();
           *expr         = lang::CallExtern(node->name + "f", node->read_args);
@@ -88,10 +101,24 @@ void MapExternCall(Expr *e, Target target) {
         return;
       }
 
-      std::string extern_func = hlir::GetExternFuncName(common::DefaultNVGPUTarget(), dtype, name);
+      std::string func_name   = UseFastMath(node) ? name + "_fast" : name;
+      std::string extern_func = hlir::GetExternFuncName(common::DefaultNVGPUTarget(), dtype, func_name);
       *expr                   = lang::CallExtern(extern_func, node->read_args, node->attrs);
     }
 
+    // The "math_precision" attribute set by the op overrides FLAGS_cinn_nvgpu_math_precision.
+    bool UseFastMath(const ir::Call *node) {
+      if (!kFastMathCallsGPU.count(node->name) || !node->read_args.front().type().is_float(32)) {
+        return false;
+      }
+      auto it = node->attrs.find("math_precision");
+      const std::string &precision =
+          it != node->attrs.end() ? absl::get<std::string>(it->second) : FLAGS_cinn_nvgpu_math_precision;
+      CHECK(precision == "precise" || precision == "approx" || precision == "fast")
+          << "The math precision should be one of \"precise\", \"approx\" and \"fast\", but got " << precision;
+      return precision != "precise";
+    }
+
     // Replace pow(x, 0.5) to sqrt(x) and pow(x, -0.5) to rsqrt(x), which
     // can speed up a lot.
     //
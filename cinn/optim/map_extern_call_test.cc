@@ -0,0 +1,52 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/map_extern_call.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "cinn/cinn.h"
+#include "cinn/runtime/cuda/use_extern_funcs.h"
+
+DECLARE_string(cinn_nvgpu_math_precision);
+
+namespace cinn::optim {
+
+#ifdef CINN_WITH_CUDA
+std::string MapNvgpuCall(const std::string& name, const std::map<std::string, ir::attr_t>& attrs = {}) {
+  Var x("x", Float(32));
+  Expr e = ir::Call::Make(Float(32), name, {Expr(x)}, {}, ir::CallType::Extern, ir::FunctionRef(), 0, attrs);
+  MapExternCall(&e, common::DefaultNVGPUTarget());
+  return e.As<ir::Call>()->name;
+}
+
+TEST(MapExternCall, math_precision) {
+  ASSERT_EQ(MapNvgpuCall("exp"), "cinn_nvgpu_exp_fp32");
+
+  FLAGS_cinn_nvgpu_math_precision = "approx";
+  ASSERT_EQ(MapNvgpuCall("exp"), "cinn_nvgpu_exp_fast_fp32");
+  ASSERT_EQ(MapNvgpuCall("tanh"), "cinn_nvgpu_tanh_fast_fp32");
+  ASSERT_EQ(MapNvgpuCall("sqrt"), "cinn_nvgpu_sqrt_fp32");
+  ASSERT_EQ(MapNvgpuCall("exp", {{"math_precision", std::string("precise")}}), "cinn_nvgpu_exp_fp32");
+
+  FLAGS_cinn_nvgpu_math_precision = "precise";
+  ASSERT_EQ(MapNvgpuCall("log", {{"math_precision", std::string("approx")}}), "cinn_nvgpu_log_fast_fp32");
+}
+#endif
+
+}  // namespace cinn::optim
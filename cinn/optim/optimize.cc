@@ -16,6 +16,7 @@
 
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule_util.h"
+#include "cinn/optim/buffer_assign.h"
 #include "cinn/optim/call_arg_list_to_pod_value.h"
 #include "cinn/optim/cast_bool_to_int8.h"
 #include "cinn/optim/cast_simplify.h"
@@ -26,24 +27,33 @@
 #include "cinn/optim/insert_debug_log_callee.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
+#include "cinn/optim/local_common_subexpr_elimination.h"
+#include "cinn/optim/loop_invariant_code_motion.h"
+#include "cinn/optim/lower_block_reduce.h"
 #include "cinn/optim/lower_function_call_bind_vars.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/partition_loops.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
+#include "cinn/optim/stage_broadcast_operands.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/optim/transform_polyfor_to_for.h"
 #include "cinn/optim/unroll_loops.h"
 #include "cinn/optim/vectorize_loops.h"
+#include "cinn/utils/compile_stats.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_partition_loops);
+DECLARE_bool(cinn_stage_broadcast_operands);
 
 namespace cinn {
 namespace optim {
 
 Expr Optimize(Expr e, Target target, bool runtime_debug_info, bool remove_gpu_for_loops) {
   CHECK(e.defined());
+  utils::CompileStats::PhaseTimer stats_timer("optim::Optimize");
   auto copied = IRCopy(e);
 
   FoldCINNCallArguments(&copied);
@@ -51,7 +61,12 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info, bool remove_gpu_fo
   ReplaceConstParamToInteger(&copied);
   // Simplify already contains CastSimplify
   Simplify(&copied);
-  UnrollLoop(&copied);
+  // before unrolling and vectorizing, so the main loops are free of the guards
+  if (FLAGS_cinn_partition_loops) {
+    PartitionLoops(&copied);
+    VLOG(4) << "After Optimize PartitionLoops:" << copied;
+  }
+  UnrollLoop(&copied, target);
   VLOG(4) << "After Optimize UnrollLoop:" << copied;
 
   VectorizeLoops(&copied, target);
@@ -59,6 +74,8 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info, bool remove_gpu_fo
 #ifdef CINN_WITH_CUDA
   if (FLAGS_cinn_ir_schedule && copied.as_lowered_func()) {
     ir::SetCudaAxisInfo(&copied);
+    LowerBlockReduce(&copied);
+    VLOG(4) << "After Optimize LowerBlockReduce:" << copied;
   }
   if (remove_gpu_for_loops) {
     RemoveGpuForloopsAxis(&copied);
@@ -89,14 +106,26 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info, bool remove_gpu_fo
 }
 
 ir::Module Optimize(const ir::Module& module, const Target& target) {
+  utils::CompileStats::PhaseTimer stats_timer("optim::Optimize Module");
   auto copied = IRCopy(Expr(module));
   if (FLAGS_cinn_ir_schedule) {
-    UnrollLoop(&copied);
+    UnrollLoop(&copied, target);
     VectorizeLoops(&copied, Target());
   }
   VLOG(10) << "After VectorizeLoops:" << copied.as_module_ref();
   RemoveScheduleBlock(&copied);
   VLOG(10) << "After RemoveScheduleBlock:" << copied.as_module_ref();
+  LoopInvariantCodeMotion(&copied);
+  VLOG(10) << "After LoopInvariantCodeMotion:" << copied.as_module_ref();
+  LocalCommonSubexprElimination(&copied);
+  VLOG(10) << "After LocalCommonSubexprElimination:" << copied.as_module_ref();
+  // before StorageRewrite, so the shared memory of the staged operands can be reused
+  if (FLAGS_cinn_stage_broadcast_operands) {
+    StageBroadcastOperands(&copied);
+    VLOG(10) << "After StageBroadcastOperands:" << copied.as_module_ref();
+  }
+  StorageRewrite(&copied);
+  VLOG(10) << "After StorageRewrite:" << copied.as_module_ref();
   LowerFunctionCallBindVars(&copied);
   VLOG(10) << "After LowerFunctionCallBindVars:" << copied.as_module_ref();
   CallArgListToPodValue(&copied);
@@ -0,0 +1,295 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/partition_loops.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/ir_replace.h"
+#include "cinn/optim/ir_simplify.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// The range [min, max] of an integer expression
+struct Interval {
+  int64_t min;
+  int64_t max;
+};
+
+using VarRanges = std::unordered_map<std::string, Interval>;
+
+// Get the range of expr by the ranges of the variables, return false if it can't be bounded
+bool Bound(const Expr& expr, const VarRanges& ranges, Interval* result) {
+  if (auto* imm = expr.As<ir::IntImm>()) {
+    *result = {imm->value, imm->value};
+    return true;
+  }
+  if (auto* var = expr.As<ir::_Var_>()) {
+    auto it = ranges.find(var->name);
+    if (it == ranges.end()) return false;
+    *result = it->second;
+    return true;
+  }
+  if (auto* cast = expr.As<ir::Cast>()) {
+    return cast->type().is_int() && Bound(cast->v(), ranges, result);
+  }
+  auto bound_binary = [&](const Expr& a, const Expr& b, Interval* x, Interval* y) {
+    return Bound(a, ranges, x) && Bound(b, ranges, y);
+  };
+  Interval x, y;
+  if (auto* add = expr.As<ir::Add>()) {
+    if (!bound_binary(add->a(), add->b(), &x, &y)) return false;
+    *result = {x.min + y.min, x.max + y.max};
+    return true;
+  }
+  if (auto* sub = expr.As<ir::Sub>()) {
+    if (!bound_binary(sub->a(), sub->b(), &x, &y)) return false;
+    *result = {x.min - y.max, x.max - y.min};
+    return true;
+  }
+  if (auto* mul = expr.As<ir::Mul>()) {
+    if (!bound_binary(mul->a(), mul->b(), &x, &y)) return false;
+    std::vector<int64_t> corners = {x.min * y.min, x.min * y.max, x.max * y.min, x.max * y.max};
+    *result = {*std::min_element(corners.begin(), corners.end()), *std::max_element(corners.begin(), corners.end())};
+    return true;
+  }
+  // the division and the modulo are bounded for the non-negative dividends and the positive constant divisors only,
+  // where the truncation of C++ is the same as the floor
+  if (auto* div = expr.As<ir::Div>()) {
+    if (!bound_binary(div->a(), div->b(), &x, &y) || x.min < 0 || y.min != y.max || y.min <= 0) return false;
+    *result = {x.min / y.min, x.max / y.min};
+    return true;
+  }
+  if (auto* mod = expr.As<ir::Mod>()) {
+    if (!bound_binary(mod->a(), mod->b(), &x, &y) || x.min < 0 || y.min != y.max || y.min <= 0) return false;
+    *result = x.max < y.min ? x : Interval{0, y.min - 1};
+    return true;
+  }
+  if (auto* min = expr.As<ir::Min>()) {
+    if (!bound_binary(min->a(), min->b(), &x, &y)) return false;
+    *result = {std::min(x.min, y.min), std::min(x.max, y.max)};
+    return true;
+  }
+  if (auto* max = expr.As<ir::Max>()) {
+    if (!bound_binary(max->a(), max->b(), &x, &y)) return false;
+    *result = {std::max(x.min, y.min), std::max(x.max, y.max)};
+    return true;
+  }
+  return false;
+}
+
+bool ContainsVar(const Expr& expr, const std::string& var_name) {
+  return !ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+            return x->As<ir::_Var_>() && x->As<ir::_Var_>()->name == var_name;
+          }).empty();
+}
+
+// Whether expr never decreases when the variable increases and the others are fixed
+bool IsNonDecreasing(const Expr& expr, const std::string& var_name) {
+  if (!ContainsVar(expr, var_name)) return true;
+  if (expr.As<ir::_Var_>()) return true;
+  if (auto* cast = expr.As<ir::Cast>()) return IsNonDecreasing(cast->v(), var_name);
+  if (auto* add = expr.As<ir::Add>()) {
+    return IsNonDecreasing(add->a(), var_name) && IsNonDecreasing(add->b(), var_name);
+  }
+  if (auto* sub = expr.As<ir::Sub>()) {
+    return IsNonDecreasing(sub->a(), var_name) && !ContainsVar(sub->b(), var_name);
+  }
+  auto non_negative_const = [](const Expr& x) { return x.As<ir::IntImm>() && x.As<ir::IntImm>()->value >= 0; };
+  if (auto* mul = expr.As<ir::Mul>()) {
+    return (non_negative_const(mul->a()) && IsNonDecreasing(mul->b(), var_name)) ||
+           (non_negative_const(mul->b()) && IsNonDecreasing(mul->a(), var_name));
+  }
+  if (auto* div = expr.As<ir::Div>()) {
+    return div->b().As<ir::IntImm>() && div->b().As<ir::IntImm>()->value > 0 && IsNonDecreasing(div->a(), var_name);
+  }
+  if (auto* min = expr.As<ir::Min>()) {
+    return IsNonDecreasing(min->a(), var_name) && IsNonDecreasing(min->b(), var_name);
+  }
+  if (auto* max = expr.As<ir::Max>()) {
+    return IsNonDecreasing(max->a(), var_name) && IsNonDecreasing(max->b(), var_name);
+  }
+  return false;
+}
+
+bool IsConstRangeLoop(const ir::For* loop) {
+  return loop->min.As<ir::IntImm>() && loop->extent.As<ir::IntImm>() && loop->extent.As<ir::IntImm>()->value > 0;
+}
+
+// Find the guard reached from body through the loops and blocks of a single statement, and add the ranges of the
+// loops passed to ranges if given
+Expr* FindGuard(Expr* body, VarRanges* ranges) {
+  Expr* cur = body;
+  while (true) {
+    if (auto* block = cur->As<ir::Block>()) {
+      if (block->stmts.size() != 1) return nullptr;
+      cur = &block->stmts[0];
+    } else if (auto* loop = cur->As<ir::For>()) {
+      if (!IsConstRangeLoop(loop)) return nullptr;
+      if (ranges) {
+        int64_t min                     = loop->min.As<ir::IntImm>()->value;
+        (*ranges)[loop->loop_var->name] = {min, min + loop->extent.As<ir::IntImm>()->value - 1};
+      }
+      cur = &loop->body;
+    } else if (auto* guard = cur->As<ir::IfThenElse>()) {
+      return guard->false_case.defined() ? nullptr : cur;
+    } else {
+      return nullptr;
+    }
+  }
+}
+
+// The loop of var over [begin, begin + extent) made from loop, the single iteration is inlined
+Expr MakeLoopPiece(const ir::For* loop, int64_t begin, int64_t extent, bool drop_guard) {
+  Expr body = IRCopy(loop->body);
+  if (drop_guard) {
+    Expr* guard = FindGuard(&body, nullptr);
+    CHECK(guard) << "The guard to drop is not found in:\n" << body;
+    *guard = guard->As<ir::IfThenElse>()->true_case;
+  }
+  Type var_type = loop->loop_var->type();
+  if (extent == 1) {
+    IrReplace(&body, loop->loop_var, common::make_const(var_type, begin));
+    Simplify(&body);
+    return body;
+  }
+  if (begin != 0) {
+    IrReplace(&body, loop->loop_var, Expr(loop->loop_var) + common::make_const(var_type, begin));
+    Simplify(&body);
+  }
+  Expr piece = ir::For::Make(loop->loop_var,
+                             common::make_const(var_type, 0),
+                             common::make_const(var_type, extent),
+                             loop->for_type(),
+                             loop->device_api,
+                             body,
+                             loop->vectorize_info(),
+                             loop->bind_info());
+  // a vectorized loop not a multiple of the factor is left to the scalar code
+  auto* new_loop = piece.As<ir::For>();
+  if (new_loop->is_vectorized() && extent % std::max(loop->vectorize_info().factor, 1) != 0) {
+    new_loop->reset_vectorize_info();
+  }
+  return piece;
+}
+
+class LoopPartitioner : public ir::IRMutator<> {
+ public:
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    if (!IsConstRangeLoop(op)) {
+      ir::IRMutator<>::Visit(op, expr);
+      return;
+    }
+    // the pieces are visited again to partition them by the guards inside
+    if (!op->is_binded() && common::is_zero(op->min) && Partition(op, expr)) {
+      ir::IRMutator<>::Visit(expr, expr);
+      return;
+    }
+    int64_t min                     = op->min.As<ir::IntImm>()->value;
+    var_ranges_[op->loop_var->name] = {min, min + op->extent.As<ir::IntImm>()->value - 1};
+    ir::IRMutator<>::Visit(op, expr);
+    var_ranges_.erase(op->loop_var->name);
+  }
+
+  bool Partition(const ir::For* loop, Expr* expr) {
+    VarRanges ranges = var_ranges_;
+    Expr body        = loop->body;
+    Expr* guard      = FindGuard(&body, &ranges);
+    if (!guard) return false;
+    const Expr& cond = guard->As<ir::IfThenElse>()->condition;
+    Expr lhs, rhs;
+    int64_t rhs_offset = 0;
+    if (auto* lt = cond.As<ir::LT>()) {
+      lhs = lt->a();
+      rhs = lt->b();
+    } else if (auto* le = cond.As<ir::LE>()) {
+      // a <= b is a < b + 1 for the integers
+      lhs        = le->a();
+      rhs        = le->b();
+      rhs_offset = 1;
+    } else {
+      return false;
+    }
+    const std::string& var_name = loop->loop_var->name;
+    Interval rhs_range;
+    if (!lhs.type().is_int() || !IsNonDecreasing(lhs, var_name) || ContainsVar(rhs, var_name) ||
+        !Bound(rhs, ranges, &rhs_range)) {
+      return false;
+    }
+    rhs_range.min += rhs_offset;
+    rhs_range.max += rhs_offset;
+
+    // the first iteration where pred holds, pred must stay true after it as lhs is non-decreasing
+    int64_t extent = loop->extent.As<ir::IntImm>()->value;
+    bool bounded   = true;
+    auto first_of  = [&](auto&& pred) {
+      int64_t lo = 0, hi = extent;
+      while (lo < hi && bounded) {
+        int64_t mid      = lo + (hi - lo) / 2;
+        ranges[var_name] = {mid, mid};
+        Interval lhs_range;
+        if (!Bound(lhs, ranges, &lhs_range)) {
+          bounded = false;
+        } else if (pred(lhs_range)) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      return lo;
+    };
+    // the guard always holds before num_true and never holds since num_true + num_maybe
+    int64_t num_true  = first_of([&](const Interval& x) { return x.max >= rhs_range.min; });
+    int64_t end_maybe = first_of([&](const Interval& x) { return x.min >= rhs_range.max; });
+    if (!bounded || (num_true == 0 && end_maybe == extent)) {
+      return false;
+    }
+
+    VLOG(4) << "Partition the loop of " << var_name << " into [0, " << num_true << ") without the guard and ["
+            << num_true << ", " << end_maybe << ") with it, guard: " << cond;
+    std::vector<Expr> pieces;
+    if (num_true > 0) {
+      pieces.push_back(MakeLoopPiece(loop, 0, num_true, true));
+    }
+    if (end_maybe > num_true) {
+      pieces.push_back(MakeLoopPiece(loop, num_true, end_maybe - num_true, false));
+    }
+    *expr = ir::Block::Make(pieces);
+    return true;
+  }
+
+  // the ranges of the variables of the enclosing loops
+  VarRanges var_ranges_;
+};
+
+}  // namespace
+
+void PartitionLoops(Expr* expr) { LoopPartitioner()(expr); }
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,44 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Partition the loops guarded by a boundary condition, such as the one left by splitting a loop by a factor not
+ * dividing its extent, so that the guard is only checked by the iterations where it may fail.
+ *
+ * For example:
+ *   for (i, 0, 4)
+ *     for (j, 0, 32)
+ *       if (i * 32 + j < 100) A[i * 32 + j] = ...
+ * is partitioned into a main loop without the guard and a tail one, whose loop is shortened to the true iterations:
+ *   for (i, 0, 3)
+ *     for (j, 0, 32)
+ *       A[i * 32 + j] = ...
+ *   for (j, 0, 4)
+ *     A[96 + j] = ...
+ *
+ * The guard must be an `a < b` or `a <= b` condition without an else branch, reached from the loop through the
+ * loops and blocks of a single statement, with `a` non-decreasing in the loop variable and all the variables bounded
+ * by the constant ranges of their loops. The loops bound to the GPU threads or blocks are not partitioned, but the
+ * serial loops inside them are, with the bound variables ranging over their extents.
+ */
+void PartitionLoops(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/partition_loops.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/lower.h"
+
+namespace cinn {
+namespace optim {
+
+static Expr LowerSplitAdd(int extent, bool bind_outer) {
+  Expr N(extent);
+  Placeholder<float> A("A", {N});
+  Placeholder<float> B("B", {N});
+  Tensor C = Compute(
+      {N}, [&](Var i) { return A(i) + B(i); }, "C");
+  auto stages   = CreateStages({C});
+  auto func     = cinn::lang::LowerVec("test_partition_loops", stages, {A, B, C}, {}, {}, nullptr, Target(), true);
+  auto ast_expr = func[0]->body;
+
+  ir::IRSchedule ir_sch(ir::ModuleExpr({ast_expr}));
+  auto loops = ir_sch.Split(ir_sch.GetLoops("C")[0], {-1, 32});
+  if (bind_outer) {
+    ir_sch.Bind(loops[0], "blockIdx.x");
+  }
+  return ast_expr;
+}
+
+static std::vector<int> LoopExtents(const Expr& expr) {
+  std::vector<int> extents;
+  for (auto& loop : ir::CollectIRNodesWithoutTensor(expr, [](const Expr* x) { return x->As<ir::For>(); })) {
+    extents.push_back(loop.As<ir::For>()->extent.as_int32());
+  }
+  std::sort(extents.begin(), extents.end());
+  return extents;
+}
+
+static int NumGuards(const Expr& expr) {
+  return ir::CollectIRNodesWithoutTensor(expr, [](const Expr* x) { return x->As<ir::IfThenElse>(); }).size();
+}
+
+TEST(PartitionLoops, PeelTail) {
+  auto ast_expr = LowerSplitAdd(100, false);
+  ASSERT_EQ(NumGuards(ast_expr), 1);
+  ASSERT_EQ(LoopExtents(ast_expr), std::vector<int>({4, 32}));
+
+  // the outer loop is partitioned into 3 iterations without the guard and the last one, where the inner loop is
+  // shortened to the 4 valid iterations
+  PartitionLoops(&ast_expr);
+  VLOG(6) << "After PartitionLoops:\n" << ast_expr;
+  EXPECT_EQ(NumGuards(ast_expr), 0);
+  EXPECT_EQ(LoopExtents(ast_expr), std::vector<int>({3, 4, 32}));
+
+  // the loops without the guard are unchanged
+  auto divisible_expr = LowerSplitAdd(128, false);
+  PartitionLoops(&divisible_expr);
+  EXPECT_EQ(LoopExtents(divisible_expr), std::vector<int>({4, 32}));
+}
+
+TEST(PartitionLoops, KeepBoundLoop) {
+  auto ast_expr = LowerSplitAdd(100, true);
+  // the loop bound to blockIdx.x is kept, the inner loop is partitioned by the worst block, so only its first 4
+  // iterations are free of the guard
+  PartitionLoops(&ast_expr);
+  VLOG(6) << "After PartitionLoops:\n" << ast_expr;
+  EXPECT_EQ(NumGuards(ast_expr), 1);
+  EXPECT_EQ(LoopExtents(ast_expr), std::vector<int>({4, 4, 28}));
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,345 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/software_pipeline.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/common/cas.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/replace_var_with_expr.h"
+#include "cinn/runtime/intrinsic.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+bool IsSyncThreads(const Expr& stmt) {
+  return stmt.As<ir::Call>() && stmt.As<ir::Call>()->name == runtime::intrinsic::cuda_sync_threads;
+}
+
+bool IsSharedTensor(const Expr& tensor) {
+  return tensor.as_tensor() && tensor.as_tensor()->buffer.defined() &&
+         tensor.as_tensor()->buffer->memory_type == ir::MemoryType::GPUShared;
+}
+
+bool IsLocalTensor(const Expr& tensor) {
+  return tensor.as_tensor() && tensor.as_tensor()->buffer.defined() &&
+         tensor.as_tensor()->buffer->memory_type == ir::MemoryType::GPULocal;
+}
+
+// Return the number of stages annotated on the blocks in the statement, 0 if not annotated
+int GetPipelineStages(const Expr& stmt) {
+  int num_stages = 0;
+  ir::CollectIRNodesWithoutTensor(stmt, [&](const Expr* x) {
+    if (auto* block_realize = x->As<ir::ScheduleBlockRealize>()) {
+      auto& attrs = block_realize->schedule_block.As<ir::ScheduleBlock>()->attrs;
+      auto it     = attrs.find(ir::attr::software_pipeline_stages);
+      if (it != attrs.end()) {
+        num_stages = absl::get<int>(it->second);
+      }
+    }
+    return false;
+  });
+  return num_stages;
+}
+
+bool IsGlobalTensor(const Expr& tensor) {
+  return tensor.as_tensor() &&
+         (!tensor.as_tensor()->buffer.defined() || tensor.as_tensor()->buffer->memory_type == ir::MemoryType::Heap);
+}
+
+void RemovePipelineStages(Expr* stmt) {
+  struct Mutator : public ir::IRMutator<> {
+    void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+    void Visit(const ir::ScheduleBlock* op, Expr* expr) override {
+      expr->As<ir::ScheduleBlock>()->attrs.erase(ir::attr::software_pipeline_stages);
+      ir::IRMutator<>::Visit(op, expr);
+    }
+  };
+  Mutator()(stmt);
+}
+
+Expr MakeExternCall(const std::string& name, const std::vector<Expr>& args) {
+  return ir::Call::Make(Void(), name, args, {}, ir::CallType::Extern, ir::FunctionRef(), 0);
+}
+
+// Prepend the index of stage to the accesses of the pipelined shared and local buffers, and replace the stores copying
+// global memory to the shared buffers directly with cp.async if enabled
+struct StageAxisAdder : public ir::IRMutator<> {
+  StageAxisAdder(const std::unordered_map<std::string, std::vector<Expr>>& buffer_shapes,
+                 Expr shared_stage,
+                 Expr local_stage,
+                 bool cp_async)
+      : buffer_shapes_(buffer_shapes), shared_stage_(shared_stage), local_stage_(local_stage), cp_async_(cp_async) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  int num_cp_async() const { return num_cp_async_; }
+
+ private:
+  Expr StageOf(const Expr& tensor) const {
+    return optim::IRCopy(IsLocalTensor(tensor) ? local_stage_ : shared_stage_);
+  }
+
+  void Visit(const ir::Store* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* store = expr->As<ir::Store>();
+    if (!store->tensor.as_tensor() || !buffer_shapes_.count(store->tensor.as_tensor()->name)) {
+      return;
+    }
+    store->indices.insert(store->indices.begin(), StageOf(store->tensor));
+    auto* value = store->value.As<ir::Load>();
+    // cp.async copies 4, 8 or 16 bytes from global memory to shared memory
+    int num_bytes     = store->value.type().bytes();
+    bool can_cp_async = num_bytes == 4 || num_bytes == 8 || num_bytes == 16;
+    if (cp_async_ && can_cp_async && IsSharedTensor(store->tensor) && value && IsGlobalTensor(value->tensor) &&
+        store->value.type().lanes() == 1) {
+      Expr dst = ir::intrinsics::GetAddr::Make(ir::Load::Make(store->tensor, store->indices));
+      Expr src = ir::intrinsics::GetAddr::Make(store->value);
+      *expr    = MakeExternCall("cinn_cp_async_" + std::to_string(num_bytes), {dst, src});
+      ++num_cp_async_;
+    }
+  }
+
+  void Visit(const ir::Load* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* load = expr->As<ir::Load>();
+    if (load->tensor.as_tensor() && buffer_shapes_.count(load->tensor.as_tensor()->name)) {
+      load->indices.insert(load->indices.begin(), StageOf(load->tensor));
+    }
+  }
+
+  const std::unordered_map<std::string, std::vector<Expr>>& buffer_shapes_;
+  Expr shared_stage_;
+  Expr local_stage_;
+  bool cp_async_;
+  int num_cp_async_ = 0;
+};
+
+// Copy the stage (from + 1) of a local buffer to the stage from, the loops are unrolled so that the buffer stays in
+// registers
+Expr MakeLocalStageShift(const Expr& tensor, int from) {
+  std::vector<Expr> shape = tensor.as_tensor()->shape;
+  std::vector<Var> vars;
+  std::vector<Expr> dst_indices = {Expr(from)};
+  std::vector<Expr> src_indices = {Expr(from + 1)};
+  // the shape is expanded with the stage axis after all the loops are pipelined
+  for (int i = 0; i < shape.size(); ++i) {
+    vars.emplace_back(common::UniqName("pipeline_shift"));
+    dst_indices.push_back(vars.back());
+    src_indices.push_back(vars.back());
+  }
+  Expr body = ir::Store::Make(tensor, ir::Load::Make(tensor, src_indices), dst_indices);
+  for (int i = vars.size() - 1; i >= 0; --i) {
+    body = ir::For::Make(vars[i],
+                         Expr(0),
+                         shape[i],
+                         ir::ForType::Unrolled,
+                         ir::DeviceAPI::CUDA,
+                         ir::Block::Make({body}));
+  }
+  return body;
+}
+
+struct SoftwarePipelineMutator : public ir::IRMutator<> {
+  void operator()(Expr* expr) {
+    ir::IRMutator<>::Visit(expr, expr);
+    UpdateBufferShapes(expr);
+  }
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* for_node = expr->As<ir::For>();
+    auto* body     = for_node->body.As<ir::Block>();
+    if (!body) {
+      return;
+    }
+    // the pipelined loop loads the shared buffers at first and then computes on them
+    int last_producer = -1;
+    int num_stages    = 0;
+    for (int i = 0; i < body->stmts.size(); ++i) {
+      int stages = GetPipelineStages(body->stmts[i]);
+      if (stages > 0) {
+        last_producer = i;
+        num_stages    = stages;
+      }
+    }
+    if (last_producer == -1 || last_producer + 1 == body->stmts.size()) {
+      return;
+    }
+
+    std::vector<Expr> producers;
+    std::vector<Expr> consumers;
+    for (int i = 0; i < body->stmts.size(); ++i) {
+      const Expr& stmt = body->stmts[i];
+      if (i <= last_producer) {
+        if (!IsSyncThreads(stmt)) {
+          producers.push_back(stmt);
+        }
+      } else if (!consumers.empty() || !IsSyncThreads(stmt)) {
+        consumers.push_back(stmt);
+      }
+    }
+    bool can_pipeline = for_node->is_serial() && for_node->extent.is_constant() &&
+                        for_node->extent.as_int32() >= num_stages &&
+                        std::all_of(producers.begin(), producers.end(), [](const Expr& stmt) {
+                          return GetPipelineStages(stmt) > 0;
+                        });
+    if (!can_pipeline) {
+      VLOG(3) << "Can't pipeline the loop, the annotation is dropped:\n" << *expr;
+      RemovePipelineStages(expr);
+      return;
+    }
+
+    // collect the shared and local buffers to expand with the stage axis
+    std::unordered_map<std::string, std::vector<Expr>> buffer_shapes;
+    std::vector<Expr> local_tensors;
+    bool has_shared = false;
+    for (auto&& stmt : producers) {
+      ir::CollectIRNodesWithoutTensor(stmt, [&](const Expr* x) {
+        if (!x->As<ir::Store>()) return false;
+        const Expr& tensor = x->As<ir::Store>()->tensor;
+        if ((IsSharedTensor(tensor) || IsLocalTensor(tensor)) && !buffer_shapes.count(tensor.as_tensor()->name)) {
+          std::vector<Expr> shape = {Expr(num_stages)};
+          shape.insert(shape.end(), tensor.as_tensor()->shape.begin(), tensor.as_tensor()->shape.end());
+          buffer_shapes.emplace(tensor.as_tensor()->name, std::move(shape));
+          if (IsLocalTensor(tensor)) {
+            local_tensors.push_back(tensor);
+          } else {
+            has_shared = true;
+          }
+        }
+        return false;
+      });
+    }
+    // the local buffers are rotated by the unrolled copies, which require the constant shapes
+    bool constant_local_shapes = std::all_of(local_tensors.begin(), local_tensors.end(), [](const Expr& tensor) {
+      auto& shape = tensor.as_tensor()->shape;
+      return std::all_of(shape.begin(), shape.end(), [](const Expr& dim) { return dim.is_constant(); });
+    });
+    if (buffer_shapes.empty() || !constant_local_shapes) {
+      VLOG(3) << "Can't pipeline the buffers of the loop, the annotation is dropped:\n" << *expr;
+      RemovePipelineStages(expr);
+      return;
+    }
+
+    // the producers loading the data of the iteration
+    Var loop_var  = for_node->loop_var;
+    Expr extent   = for_node->extent;
+    bool cp_async = false;
+    // the shared buffers are indexed by the iteration modulo the stages, and the local ones by the constant stages:
+    // the stage i is loaded by the prologue, the last stage is loaded in the loop, and the stage 0 is computed on
+    auto stage_of = [&](Expr iteration, int local_stage) {
+      std::vector<Expr> stmts;
+      for (auto&& stmt : producers) {
+        Expr copied = optim::IRCopy(stmt);
+        optim::ReplaceVarWithExpr(&copied, loop_var, iteration);
+        StageAxisAdder adder(buffer_shapes,
+                             common::AutoSimplify(ir::Mod::Make(iteration, Expr(num_stages))),
+                             Expr(local_stage),
+                             true);
+        adder(&copied);
+        cp_async = cp_async || adder.num_cp_async() > 0;
+        RemovePipelineStages(&copied);
+        stmts.push_back(copied);
+      }
+      return stmts;
+    };
+    auto commit = [&](std::vector<Expr>* stmts) {
+      if (cp_async) {
+        stmts->push_back(MakeExternCall("cinn_cp_async_commit", {}));
+      }
+    };
+
+    std::vector<Expr> pipelined;
+    for (int i = 0; i < num_stages - 1; ++i) {
+      auto stmts = stage_of(Expr(i), i);
+      pipelined.insert(pipelined.end(), stmts.begin(), stmts.end());
+      commit(&pipelined);
+    }
+
+    Expr next_iteration = ir::Add::Make(loop_var, Expr(num_stages - 1));
+    Expr load_next      = ir::IfThenElse::Make(ir::LT::Make(next_iteration, extent),
+                                          ir::Block::Make(stage_of(next_iteration, num_stages - 1)));
+    std::vector<Expr> new_body;
+    if (cp_async) {
+      // the data of the current iteration is ready when at most (num_stages - 2) groups are pending
+      new_body.push_back(MakeExternCall("cinn_cp_async_wait", {Expr(num_stages - 2)}));
+    }
+    // the local buffers are private to each thread, only the shared ones need the barrier
+    if (has_shared) {
+      new_body.push_back(runtime::IntrinsicCall(Void(), runtime::intrinsic::cuda_sync_threads, {}));
+    }
+    new_body.push_back(load_next);
+    commit(&new_body);
+    StageAxisAdder adder(buffer_shapes, ir::Mod::Make(loop_var, Expr(num_stages)), Expr(0), false);
+    for (auto&& stmt : consumers) {
+      adder(&stmt);
+      new_body.push_back(stmt);
+    }
+    for (auto&& tensor : local_tensors) {
+      for (int stage = 0; stage + 1 < num_stages; ++stage) {
+        new_body.push_back(MakeLocalStageShift(tensor, stage));
+      }
+    }
+    for_node->body = ir::Block::Make(new_body);
+    pipelined.push_back(*expr);
+    VLOG(4) << "Pipeline the loop with " << num_stages << " stages, cp.async=" << cp_async << ":\n" << pipelined;
+    *expr = ir::Block::Make(pipelined);
+
+    for (auto&& item : buffer_shapes) {
+      buffer_shapes_.insert(item);
+    }
+  }
+
+  // update the shapes of all the accesses to the expanded shared and local buffers
+  void UpdateBufferShapes(Expr* expr) {
+    if (buffer_shapes_.empty()) {
+      return;
+    }
+    ir::CollectIRNodesWithoutTensor(*expr, [&](const Expr* x) {
+      Expr tensor;
+      if (x->As<ir::Store>()) {
+        tensor = x->As<ir::Store>()->tensor;
+      } else if (x->As<ir::Load>()) {
+        tensor = x->As<ir::Load>()->tensor;
+      }
+      if (tensor.defined() && tensor.as_tensor() && buffer_shapes_.count(tensor.as_tensor()->name)) {
+        auto* tensor_node          = tensor.as_tensor();
+        tensor_node->shape         = buffer_shapes_.at(tensor_node->name);
+        tensor_node->buffer->shape = tensor_node->shape;
+      }
+      return false;
+    });
+  }
+
+  std::unordered_map<std::string, std::vector<Expr>> buffer_shapes_;
+};
+
+}  // namespace
+
+void SoftwarePipeline(Expr* expr) { SoftwarePipelineMutator()(expr); }
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Pipeline the loops whose shared buffer loads are annotated by IRSchedule::SoftwarePipeline, it is applied after
+ * the shared buffers are resized in OptimizeExprGPU.
+ *
+ * For example, a loop with 2 stages:
+ * \code
+ * for (k, 0, 8)
+ *   A_shared[i] = A[k * 4 + i]
+ *   __syncthreads()
+ *   B[j] += A_shared[j]
+ * \endcode
+ *
+ * will be modified to
+ * \code
+ * A_shared[0, i] = A[i]
+ * for (k, 0, 8)
+ *   __syncthreads()
+ *   if (k + 1 < 8)
+ *     A_shared[(k + 1) % 2, i] = A[(k + 1) * 4 + i]
+ *   B[j] += A_shared[k % 2, j]
+ * \endcode
+ *
+ * The stores copying global memory to the shared buffers directly are replaced with cp.async calls.
+ *
+ * The local buffers are indexed by the constant stages instead, the loop loads the last stage and computes on the
+ * stage 0, and then shifts each stage s + 1 to s by unrolled copies, so the buffers can be kept in registers:
+ * \code
+ * A_local[0, i] = A_shared[i]
+ * for (k, 0, 8)
+ *   if (k + 1 < 8)
+ *     A_local[1, i] = A_shared[(k + 1) * 4 + i]
+ *   B[j] += A_local[0, j]
+ *   A_local[0, i] = A_local[1, i]
+ * \endcode
+ */
+void SoftwarePipeline(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
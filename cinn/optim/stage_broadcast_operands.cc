@@ -0,0 +1,351 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/stage_broadcast_operands.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::optim {
+
+namespace {
+
+// the most bytes of the operands staged in the shared memory of each block
+constexpr int kMaxStagedBytes = 4096;
+// the least times a block reads each element of an operand to stage it in the shared memory
+constexpr int kMinStagedReuse = 4;
+
+//! The number of the elements of a tensor in the shape, or -1 if the shape is not constant.
+int64_t NumElements(const std::vector<Expr>& shape) {
+  int64_t num = 1;
+  for (auto& dim : shape) {
+    if (!dim.is_constant()) return -1;
+    num *= static_cast<int64_t>(dim.get_constant());
+  }
+  return num;
+}
+
+bool IsSyncThreads(const Expr* x) {
+  return x->As<ir::Call>() && x->As<ir::Call>()->name == runtime::intrinsic::cuda_sync_threads;
+}
+
+//! The variables defined or changed in the body of the loop, including its own.
+std::set<std::string> CollectVariantVars(const ir::For* op) {
+  std::set<std::string> names{op->loop_var->name};
+  ir::CollectIRNodesWithoutTensor(op->body, [&](const Expr* x) {
+    if (auto* for_node = x->As<ir::For>()) {
+      names.insert(for_node->loop_var->name);
+    } else if (auto* let = x->As<ir::Let>()) {
+      names.insert(let->symbol.as_var()->name);
+    } else if (auto* store = x->As<ir::Store>()) {
+      if (store->tensor.as_var()) names.insert(store->tensor.as_var()->name);
+    }
+    return false;
+  });
+  return names;
+}
+
+//! Collect the loads of the read-only tensors run in every iteration of a loop with the same indices.
+struct InvariantLoadCollector : public ir::IRMutator<> {
+  InvariantLoadCollector(const std::set<std::string>& read_only, const std::set<std::string>& variant_vars)
+      : read_only_(read_only), variant_vars_(variant_vars) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  std::map<std::string, Expr> loads;
+
+ private:
+  void Visit(const ir::Load* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* tensor = op->tensor.As<ir::_Tensor_>();
+    if (!tensor || !read_only_.count(tensor->name)) return;
+    for (auto& index : op->indices) {
+      bool variant = !ir::CollectIRNodesWithoutTensor(index, [&](const Expr* x) {
+                        return x->as_var() && variant_vars_.count(x->as_var()->name);
+                      }).empty();
+      if (variant) return;
+    }
+    loads.emplace(utils::GetStreamCnt(*expr), *expr);
+  }
+
+  // the loads under a condition may be out of bounds when hoisted, so only the conditions are visited
+  void Visit(const ir::IfThenElse* op, Expr* expr) override {
+    auto* node = expr->As<ir::IfThenElse>();
+    ir::IRMutator<>::Visit(&node->condition, &node->condition);
+  }
+
+  void Visit(const ir::Select* op, Expr* expr) override {
+    auto* node = expr->As<ir::Select>();
+    ir::IRMutator<>::Visit(&node->condition, &node->condition);
+  }
+
+  // the loops that may run no iteration are skipped for the same reason
+  void Visit(const ir::For* op, Expr* expr) override {
+    if (op->extent.is_constant() && op->extent.get_constant() > 0) {
+      ir::IRMutator<>::Visit(op, expr);
+    }
+  }
+
+  const std::set<std::string>& read_only_;
+  const std::set<std::string>& variant_vars_;
+};
+
+//! Replace the loads kept in the registers with their variables.
+struct LoadReplacer : public ir::IRMutator<> {
+  explicit LoadReplacer(const std::map<std::string, Var>& load2var) : load2var_(load2var) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::Load* op, Expr* expr) override {
+    auto it = load2var_.find(utils::GetStreamCnt(*expr));
+    if (it != load2var_.end()) {
+      *expr = Expr(it->second);
+      return;
+    }
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  const std::map<std::string, Var>& load2var_;
+};
+
+//! Hoist the invariant loads of the read-only tensors out of the serial loops, the inner loops first.
+struct InvariantLoadHoister : public ir::IRMutator<> {
+  explicit InvariantLoadHoister(const std::set<std::string>& read_only) : read_only_(read_only) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::For>();
+    if (!node->is_serial() || !node->extent.is_constant() || node->extent.get_constant() <= 0) return;
+    if (!ir::CollectIRNodesWithoutTensor(node->body, IsSyncThreads, true).empty()) return;
+
+    std::set<std::string> variant_vars = CollectVariantVars(node);
+    InvariantLoadCollector collector(read_only_, variant_vars);
+    collector(&node->body);
+    if (collector.loads.empty()) return;
+
+    std::vector<Expr> stmts;
+    std::map<std::string, Var> load2var;
+    for (auto& item : collector.loads) {
+      auto* load = item.second.As<ir::Load>();
+      Var var(common::UniqName(load->tensor.as_tensor()->name + "_reg"), item.second.type());
+      stmts.push_back(ir::Let::Make(var, optim::IRCopy(item.second)));
+      load2var.emplace(item.first, var);
+    }
+    LoadReplacer replacer(load2var);
+    replacer(&node->body);
+    VLOG(4) << "Keep " << load2var.size() << " invariant loads of loop " << node->loop_var << " in registers";
+
+    stmts.push_back(*expr);
+    *expr = ir::Block::Make(stmts);
+  }
+
+  const std::set<std::string>& read_only_;
+};
+
+//! Replace the loads of the staged operands with those of their copies in the shared memory.
+struct StagedLoadReplacer : public ir::IRMutator<> {
+  explicit StagedLoadReplacer(const std::map<std::string, ir::Tensor>& staged) : staged_(staged) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::Load* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* load   = expr->As<ir::Load>();
+    auto* tensor = load->tensor.As<ir::_Tensor_>();
+    if (!tensor || !staged_.count(tensor->name)) return;
+    *expr = ir::Load::Make(staged_.at(tensor->name), {load->index()});
+  }
+
+  const std::map<std::string, ir::Tensor>& staged_;
+};
+
+class BroadcastOperandStager {
+ public:
+  explicit BroadcastOperandStager(ir::_LoweredFunc_* func) : func_(func) {}
+
+  void operator()() {
+    CollectTensors();
+    StageInShared();
+    InvariantLoadHoister hoister(read_only_);
+    hoister(&func_->body);
+  }
+
+ private:
+  // the read-only input tensors, and the number of the elements stored to the outputs
+  void CollectTensors() {
+    std::set<std::string> input_buffers, output_buffers;
+    for (auto& arg : func_->args) {
+      if (!arg.is_buffer()) continue;
+      (arg.is_input() ? input_buffers : output_buffers).insert(arg.buffer_arg()->name);
+    }
+    std::set<std::string> written;
+    ir::CollectIRNodesWithoutTensor(func_->body, [&](const Expr* x) {
+      if (auto* store = x->As<ir::Store>()) {
+        auto* tensor = store->tensor.As<ir::_Tensor_>();
+        if (!tensor) return false;
+        written.insert(tensor->name);
+        if (tensor->buffer.defined() && output_buffers.count(tensor->buffer->name)) {
+          output_elements_ = std::max(output_elements_, NumElements(tensor->shape));
+        }
+      } else if (auto* load = x->As<ir::Load>()) {
+        auto* tensor = load->tensor.As<ir::_Tensor_>();
+        if (tensor && tensor->buffer.defined() && input_buffers.count(tensor->buffer->name)) {
+          inputs_.emplace(tensor->name, load->tensor.as_tensor_ref());
+        }
+      }
+      return false;
+    });
+    for (auto it = inputs_.begin(); it != inputs_.end();) {
+      it = written.count(it->first) ? inputs_.erase(it) : std::next(it);
+    }
+    for (auto& item : inputs_) {
+      read_only_.insert(item.first);
+    }
+  }
+
+  // the body of the innermost GPU-bound loop wrapping the whole kernel, and the loops bound to the threads by offset
+  Expr* FindBlockBody(std::vector<const ir::For*>* thread_loops) {
+    Expr* body = &func_->body;
+    while (true) {
+      if (auto* block = body->As<ir::Block>()) {
+        if (block->stmts.size() != 1U) break;
+        body = &block->stmts.front();
+        continue;
+      }
+      auto* loop = body->As<ir::For>();
+      if (!loop || !loop->is_binded() || !loop->extent.is_constant() || !common::is_zero(loop->min)) break;
+      if (loop->is_gpu_thread_binded()) {
+        int offset = loop->bind_info().offset;
+        if (offset < 0 || offset > 2 || (*thread_loops)[offset]) return nullptr;
+        (*thread_loops)[offset] = loop;
+      }
+      body = &loop->body;
+    }
+    // all the threads of the block must reach the synchronization
+    int num_threads = 1;
+    for (auto* loop : *thread_loops) {
+      if (loop) num_threads *= loop->extent.as_int32();
+    }
+    const auto& axis_info = func_->cuda_axis_info;
+    if (num_threads != axis_info.block_dim(0) * axis_info.block_dim(1) * axis_info.block_dim(2)) return nullptr;
+    return body;
+  }
+
+  void StageInShared() {
+    std::vector<const ir::For*> thread_loops(3, nullptr);
+    Expr* block_body = FindBlockBody(&thread_loops);
+    if (!block_body || output_elements_ <= 0) return;
+
+    const auto& axis_info  = func_->cuda_axis_info;
+    int64_t num_blocks     = axis_info.grid_dim(0) * axis_info.grid_dim(1) * axis_info.grid_dim(2);
+    int num_threads        = axis_info.block_dim(0) * axis_info.block_dim(1) * axis_info.block_dim(2);
+    int64_t block_elements = output_elements_ / num_blocks;
+    // the linear id of a thread in the block, x first
+    Expr thread_id;
+    for (int offset = 2; offset >= 0; --offset) {
+      if (!thread_loops[offset]) continue;
+      Expr var(thread_loops[offset]->loop_var);
+      thread_id = thread_id.defined() ? thread_id * Expr(axis_info.block_dim(offset)) + var : var;
+    }
+    if (!thread_id.defined()) {
+      thread_id = Expr(0);
+    }
+
+    std::map<std::string, ir::Tensor> staged;
+    std::vector<Expr> stmts;
+    int64_t staged_bytes = 0;
+    for (auto& item : inputs_) {
+      const ir::Tensor& tensor = item.second;
+      int64_t num_elements     = NumElements(tensor->shape);
+      int64_t bytes            = num_elements * tensor->type().bytes();
+      if (num_elements <= 0 || staged_bytes + bytes > kMaxStagedBytes ||
+          block_elements < kMinStagedReuse * num_elements) {
+        continue;
+      }
+      staged_bytes += bytes;
+
+      ir::Tensor shared = ir::_Tensor_::Make(tensor->name + "_shared",
+                                             tensor->type(),
+                                             {Expr(static_cast<int32_t>(num_elements))},
+                                             {Expr(static_cast<int32_t>(num_elements))},
+                                             tensor->operation);
+      shared->WithBuffer("shared", "_" + shared->name + "_temp_buffer", tensor->type());
+      func_->temp_bufs.push_back(shared->buffer);
+      staged.emplace(tensor->name, shared);
+      read_only_.insert(shared->name);
+      VLOG(3) << "Stage the operand " << tensor->name << " of " << num_elements << " elements in the shared memory of "
+              << func_->name;
+
+      // the elements are copied by all the threads, each copies one in a round
+      int rounds = static_cast<int>((num_elements + num_threads - 1) / num_threads);
+      Var round_var(common::UniqName(shared->name + "_round"), Int(32));
+      Expr index = rounds > 1 ? Expr(round_var) * Expr(num_threads) + thread_id : thread_id;
+      Expr copy  = ir::Store::Make(shared, ir::Load::Make(tensor, {index}), {index});
+      if (num_elements % num_threads != 0) {
+        copy = ir::IfThenElse::Make(ir::LT::Make(index, Expr(static_cast<int32_t>(num_elements))), copy);
+      }
+      if (rounds > 1) {
+        copy = ir::For::Make(
+            round_var, Expr(0), Expr(rounds), ir::ForType::Serial, ir::DeviceAPI::CUDA, ir::Block::Make({copy}));
+      }
+      stmts.push_back(copy);
+    }
+    if (staged.empty()) return;
+
+    StagedLoadReplacer replacer(staged);
+    replacer(block_body);
+    stmts.push_back(runtime::IntrinsicCall(Void(), runtime::intrinsic::cuda_sync_threads, {}));
+    stmts.push_back(*block_body);
+    *block_body = ir::Block::Make(stmts);
+  }
+
+  ir::_LoweredFunc_* func_;
+  std::map<std::string, ir::Tensor> inputs_;
+  std::set<std::string> read_only_;
+  int64_t output_elements_{-1};
+};
+
+struct StageBroadcastOperandsMutator : public ir::IRMutator<> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::_LoweredFunc_* op, Expr* expr) override {
+    auto* func = expr->As<ir::_LoweredFunc_>();
+    if (!func->cuda_axis_info.valid()) return;
+    BroadcastOperandStager stager(func);
+    stager();
+  }
+};
+
+}  // namespace
+
+void StageBroadcastOperands(Expr* e) { StageBroadcastOperandsMutator()(e); }
+
+}  // namespace cinn::optim
@@ -0,0 +1,45 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn::optim {
+
+/**
+ * Stage the small operands broadcast to a CUDA kernel, such as a bias or a per-channel scale, so that they are not
+ * reloaded from the global memory by every thread.
+ *
+ * An input read by the block many times per element and not larger than a few KB is copied into the shared memory by
+ * all the threads of the block before the computation, e.g. in a kernel of 256 threads per block:
+ *
+ * \code
+ * C[idx] = A[idx] * B[((idx / 1024) % 64)]
+ * \endcode
+ *
+ * to
+ *
+ * \code
+ * if (threadIdx.x < 64) B_shared[threadIdx.x] = B[threadIdx.x]
+ * __syncthreads()
+ * C[idx] = A[idx] * B_shared[((idx / 1024) % 64)]
+ * \endcode
+ *
+ * Then the loads of the read-only operands the same in all the iterations of a serial loop are kept in the registers
+ * ahead of the loop. It requires the cuda axis info set, and the kernels whose body is not wrapped by the loops bound
+ * to all the threads of the block only get the register staging.
+ */
+void StageBroadcastOperands(Expr* e);
+
+}  // namespace cinn::optim
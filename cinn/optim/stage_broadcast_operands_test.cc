@@ -0,0 +1,121 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/stage_broadcast_operands.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::optim {
+
+namespace {
+// for (blockIdx.x, 0, 64)
+//   for (threadIdx.x, 0, 128)
+//     for (k, 0, 4)
+//       C[blockIdx.x * 512 + k * 128 + threadIdx.x] = A[blockIdx.x * 512 + k * 128 + threadIdx.x] * B[blockIdx.x % n]
+Expr MakeBroadcastFunc(int n) {
+  Placeholder<float> A("A", std::vector<int>{{64 * 512}});
+  Placeholder<float> B("B", std::vector<int>{{n}});
+  Placeholder<float> C("C", std::vector<int>{{64 * 512}});
+  Var block_x("blockIdx.x");
+  Var thread_x("threadIdx.x");
+  Var k("k");
+  Expr index = Expr(block_x) * Expr(512) + Expr(k) * Expr(128) + Expr(thread_x);
+  Expr value = ir::Load::Make(ir::Tensor(A), {index}) * ir::Load::Make(ir::Tensor(B), {Expr(block_x) % Expr(n)});
+  Expr body  = ir::For::Make(k,
+                             Expr(0),
+                             Expr(4),
+                             ir::ForType::Serial,
+                             ir::DeviceAPI::CUDA,
+                             ir::Block::Make({ir::Store::Make(ir::Tensor(C), value, {index})}));
+  body       = ir::For::Make(thread_x,
+                             Expr(0),
+                             Expr(128),
+                             ir::ForType::GPUThread,
+                             ir::DeviceAPI::GPU,
+                             ir::Block::Make({body}),
+                             ir::VectorizeInfo(),
+                             ir::BindInfo(ir::ForType::GPUThread, 0, ir::DeviceAPI::GPU));
+  body       = ir::For::Make(block_x,
+                             Expr(0),
+                             Expr(64),
+                             ir::ForType::GPUBlock,
+                             ir::DeviceAPI::GPU,
+                             ir::Block::Make({body}),
+                             ir::VectorizeInfo(),
+                             ir::BindInfo(ir::ForType::GPUBlock, 0, ir::DeviceAPI::GPU));
+  std::vector<ir::Argument> args = {ir::Argument(ir::Tensor(A)->buffer, ir::Argument::IO::kInput),
+                                    ir::Argument(ir::Tensor(B)->buffer, ir::Argument::IO::kInput),
+                                    ir::Argument(ir::Tensor(C)->buffer, ir::Argument::IO::kOutput)};
+
+  auto func = ir::_LoweredFunc_::Make("broadcast", args, ir::Block::Make({body}), {});
+  func->cuda_axis_info.set_grid_dim(0, 64);
+  func->cuda_axis_info.set_block_dim(0, 128);
+  func->cuda_axis_info.set_valid(true);
+  return Expr(func);
+}
+
+// the body of the loop over k
+std::string InnerLoopBody(const Expr& func) {
+  auto loops = ir::CollectIRNodes(func.as_lowered_func_ref()->body, [](const Expr* x) {
+    return x->As<ir::For>() && x->As<ir::For>()->loop_var->name == "k";
+  });
+  CHECK_EQ(loops.size(), 1U);
+  return utils::GetStreamCnt(loops.begin()->As<ir::For>()->body);
+}
+}  // namespace
+
+TEST(StageBroadcastOperands, shared) {
+  Expr func = MakeBroadcastFunc(8);
+  StageBroadcastOperands(&func);
+  auto out = utils::GetStreamCnt(func.as_lowered_func_ref()->body);
+  LOG(INFO) << "\n" << out;
+
+  // the 8 elements of B are read 512 times by each block, so they are copied into the shared memory once
+  auto& temp_bufs = func.as_lowered_func_ref()->temp_bufs;
+  ASSERT_EQ(temp_bufs.size(), 1U);
+  EXPECT_EQ(temp_bufs[0]->memory_type, ir::MemoryType::GPUShared);
+  EXPECT_EQ(temp_bufs[0]->shape[0].as_int32(), 8);
+  EXPECT_NE(out.find("B_shared[threadIdx.x] = B[threadIdx.x]"), std::string::npos);
+  EXPECT_NE(out.find(runtime::intrinsic::cuda_sync_threads), std::string::npos);
+
+  // and the element read by all the iterations of k is kept in a register
+  auto inner = InnerLoopBody(func);
+  EXPECT_EQ(inner.find("B_shared["), std::string::npos);
+  EXPECT_NE(inner.find("B_shared_reg"), std::string::npos);
+}
+
+TEST(StageBroadcastOperands, registers) {
+  // too large for the shared memory, only kept in a register
+  Expr func = MakeBroadcastFunc(4096);
+  StageBroadcastOperands(&func);
+  LOG(INFO) << "\n" << func.as_lowered_func_ref()->body;
+
+  EXPECT_TRUE(func.as_lowered_func_ref()->temp_bufs.empty());
+  auto inner = InnerLoopBody(func);
+  EXPECT_EQ(inner.find("B["), std::string::npos);
+  EXPECT_NE(inner.find("B_reg"), std::string::npos);
+  // the loads varying with k are left in the loop
+  EXPECT_NE(inner.find("A["), std::string::npos);
+}
+
+}  // namespace cinn::optim
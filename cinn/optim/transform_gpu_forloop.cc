@@ -29,6 +29,7 @@
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/replace_var_with_expr.h"
+#include "cinn/optim/software_pipeline.h"
 #include "cinn/poly/isl_utils.h"
 #include "cinn/poly/stage.h"
 #include "cinn/runtime/intrinsic.h"
@@ -657,6 +658,9 @@ void OptimizeExprGPU(Expr *expr) {
   ReplaceVarToZero replace_var_to_zero;
   replace_var_to_zero(expr);
 
+  // pipeline the shared buffers after they are resized
+  SoftwarePipeline(expr);
+
   VLOG(2) << "After Optimize Expr: \n" << *expr;
 }
 
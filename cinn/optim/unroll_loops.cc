@@ -14,21 +14,115 @@
 
 #include "cinn/optim/unroll_loops.h"
 
+#include <algorithm>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_replace.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace optim {
 
+UnrollEstimate EstimateUnroll(const ir::For* loop) {
+  UnrollEstimate estimate;
+  std::set<std::string> varying, invariant;
+  // the loop variable and the iteration variables of the schedule blocks bound to it
+  std::set<std::string> loop_vars = {loop->loop_var->name};
+  auto uses_loop_var = [&](const Expr& e) {
+    auto teller = [&](const Expr* x) { return x->as_var() && loop_vars.count(x->as_var()->name); };
+    return !ir::CollectIRNodes(e, std::move(teller), true).empty();
+  };
+  // the nodes are visited in pre-order, so the schedule blocks are bound before their bodies are visited
+  ir::CollectIRNodesWithoutTensor(loop->body, [&](const Expr* x) {
+    if (auto* realize = x->As<ir::ScheduleBlockRealize>()) {
+      auto* block = realize->schedule_block.As<ir::ScheduleBlock>();
+      for (size_t i = 0; i < realize->iter_values.size() && i < block->iter_vars.size(); ++i) {
+        if (uses_loop_var(realize->iter_values[i])) {
+          loop_vars.insert(block->iter_vars[i]->name);
+        }
+      }
+    }
+    switch (x->node_type()) {
+      // the leaves and the structures do not cost instructions by themselves
+      case ir::IrNodeTy::_Var_:
+      case ir::IrNodeTy::IntImm:
+      case ir::IrNodeTy::UIntImm:
+      case ir::IrNodeTy::FloatImm:
+      case ir::IrNodeTy::StringImm:
+      case ir::IrNodeTy::_Buffer_:
+      case ir::IrNodeTy::_Tensor_:
+      case ir::IrNodeTy::_BufferRange_:
+      case ir::IrNodeTy::Block:
+      case ir::IrNodeTy::ScheduleBlock:
+      case ir::IrNodeTy::ScheduleBlockRealize:
+        return false;
+      case ir::IrNodeTy::Load:
+      case ir::IrNodeTy::Let: {
+        // the same value loaded or bound twice is counted once, as the backend compilers reuse it
+        auto& values = uses_loop_var(*x) ? varying : invariant;
+        values.insert(utils::GetStreamCnt(*x));
+        break;
+      }
+      default:
+        break;
+    }
+    ++estimate.body_ops;
+    return false;
+  });
+  estimate.live_values      = varying.size();
+  estimate.invariant_values = invariant.size();
+  return estimate;
+}
+
+UnrollBudget UnrollBudget::FromTarget(const common::Target& target) {
+  switch (target.arch) {
+    // a thread holds at most 255 registers, and the occupancy falls long before, so half of them are for the values
+    case common::Target::Arch::NVGPU:
+    case common::Target::Arch::AMDGPU:
+      return UnrollBudget{2048, 128};
+    // most values of an iteration die within it, so a few times the vector registers are allowed to be live
+    case common::Target::Arch::X86:
+      return UnrollBudget{1024, 4 * (target.x86_vector_bits() == 512 ? 32 : 16)};
+    // AArch64 has 32 vector registers of NEON or SVE
+    case common::Target::Arch::ARM:
+      return UnrollBudget{1024, 4 * 32};
+    default:
+      return UnrollBudget{1024, 64};
+  }
+}
+
+int ChooseUnrollFactor(int extent, const UnrollEstimate& estimate, const UnrollBudget& budget, int max_factor) {
+  auto fits = [&](int factor) {
+    return factor * estimate.body_ops <= budget.max_body_ops &&
+           estimate.invariant_values + factor * estimate.live_values <= budget.max_live_values;
+  };
+  if (extent <= max_factor && (extent <= 1 || fits(extent))) {
+    return extent;
+  }
+  int factor = 1;
+  while (factor * 2 < extent && factor * 2 <= max_factor) {
+    factor *= 2;
+  }
+  for (; factor >= 2; factor /= 2) {
+    if (fits(factor)) return factor;
+  }
+  return 1;
+}
+
 namespace {
 
 struct UnrollMutator : public ir::IRMutator<Expr*> {
+  explicit UnrollMutator(const common::Target& target) : budget_(UnrollBudget::FromTarget(target)) {}
+
   void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
 
  private:
@@ -66,17 +160,26 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
     }
     int extent = op->extent.as_int32();
 
-    // predicate this for-loop can be unrolled by auto-unroll conditions
-    bool unrollable =
-        (op->is_serial() && extent >= 0 && not_unrolled_depth_ == 0 && extent * flat_step_ <= auto_max_step_);
-
-    // predicate this for-loop can be unrolled by the unrolled tag
-    unrollable = (unrollable || op->is_unrolled()) && extent <= max_unroll_extent_;
+    // the most iterations this for-loop can be unrolled by auto-unroll conditions
+    int max_factor = 0;
+    if (op->is_serial() && extent >= 0 && not_unrolled_depth_ == 0) {
+      max_factor = flat_step_ > 0 ? auto_max_step_ / flat_step_ : extent;
+    }
+    // or by the unrolled tag
+    if (op->is_unrolled() && extent <= max_unroll_extent_) {
+      max_factor = extent;
+    }
+    max_factor = std::min(max_factor, max_unroll_extent_);
 
-    if (unrollable) {
+    int factor = max_factor > 0 ? ChooseUnrollFactor(extent, EstimateUnroll(op), budget_, max_factor) : 1;
+    if (factor == extent) {
       Unroll(op, expr);
       flat_step_ *= extent;
     } else {
+      if (factor > 1) {
+        PartialUnroll(op, factor, expr);
+        flat_step_ *= factor;
+      }
       ++not_unrolled_depth_;
     }
   }
@@ -98,7 +201,39 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
     *expr = ir::Block::Make(body);
   }
 
+  //! Unroll a forloop by the factor, into a serial loop over the groups of iterations and the unrolled remainder.
+  void PartialUnroll(const ir::For* op, int factor, Expr* expr) {
+    auto* min = op->min.As<ir::IntImm>();
+    if (!min) return;
+    int extent    = op->extent.as_int32();
+    Type var_type = op->loop_var->type();
+
+    std::vector<Expr> group;
+    for (int i = 0; i < factor; i++) {
+      Expr index =
+          Expr(op->loop_var) * common::make_const(var_type, factor) + common::make_const(var_type, min->value + i);
+      group.push_back(optim::IRCopy(op->body));
+      optim::IrReplace(&group.back(), op->loop_var, index);
+    }
+    std::vector<Expr> stmts;
+    stmts.push_back(ir::For::Make(op->loop_var,
+                                  common::make_const(var_type, 0),
+                                  common::make_const(var_type, extent / factor),
+                                  ir::ForType::Serial,
+                                  op->device_api,
+                                  ir::Block::Make(group)));
+    for (int i = extent / factor * factor; i < extent; i++) {
+      stmts.push_back(optim::IRCopy(op->body));
+      optim::IrReplace(&stmts.back(), op->loop_var, common::make_const(var_type, min->value + i));
+    }
+    VLOG(5) << "Partially unroll loop " << op->loop_var << " of extent " << extent << " by factor " << factor;
+
+    *expr = ir::Block::Make(stmts);
+  }
+
  private:
+  UnrollBudget budget_;
+
   // max permitted steps to be automatically unrolled in total
   int auto_max_step_ = 0;
   // max permitted extent of a loop to be unrolled
@@ -112,7 +247,7 @@ struct UnrollMutator : public ir::IRMutator<Expr*> {
 
 }  // namespace
 
-void UnrollLoop(Expr* expr) { UnrollMutator()(expr); }
+void UnrollLoop(Expr* expr, const common::Target& target) { UnrollMutator(target)(expr); }
 
 }  // namespace optim
 }  // namespace cinn
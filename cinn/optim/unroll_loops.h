@@ -13,12 +13,52 @@
 // limitations under the License.
 
 #pragma once
+#include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
 
 namespace cinn {
 namespace optim {
 
-void UnrollLoop(Expr* expr);
+/**
+ * The size and the register pressure of one iteration of a loop, estimated to decide how far it can be unrolled.
+ * Unrolling a loop by u copies the body u times, so the unrolled code has about `u * body_ops` operations and keeps
+ * about `invariant_values + u * live_values` values in registers when the copies are scheduled together.
+ */
+struct UnrollEstimate {
+  // the statements and the arithmetic, memory and call operations of the body
+  int body_ops = 0;
+  // the distinct values loaded or bound by Let in the body that vary with the loop variable
+  int live_values = 0;
+  // the distinct values loaded or bound by Let in the body that are the same for all the iterations
+  int invariant_values = 0;
+};
+
+//! Estimate one iteration of the body of a loop.
+UnrollEstimate EstimateUnroll(const ir::For* loop);
+
+/**
+ * The limits of the unrolled code of a loop on a target, beyond which unrolling it spills registers or misses the
+ * instruction cache more than it saves in the loop overhead.
+ */
+struct UnrollBudget {
+  int max_body_ops;
+  int max_live_values;
+
+  static UnrollBudget FromTarget(const common::Target& target);
+};
+
+/**
+ * Choose how far to unroll a loop of the extent: the extent itself to unroll it fully, a power of two in [2, extent)
+ * to unroll it partially, or 1 not to unroll it. The factor is at most max_factor and fits the budget.
+ */
+int ChooseUnrollFactor(int extent, const UnrollEstimate& estimate, const UnrollBudget& budget, int max_factor);
+
+/**
+ * Unroll the loops tagged unrolled and the serial ones under a ScheduleBlock with the auto_unroll_max_step
+ * attribute, within the budget of the target. A loop too large to be unrolled fully is unrolled partially, into a
+ * loop over the groups of iterations followed by the unrolled remainder.
+ */
+void UnrollLoop(Expr* expr, const common::Target& target = common::UnkTarget());
 
 }  // namespace optim
 }  // namespace cinn
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/lang/lower.h"
 
@@ -50,14 +51,14 @@ TEST(UnrollLoops, unrolled_tag) {
 
   // extent of the loop exceed the max permitted value in the unroll_loops pass,
   // which currently set 50, so the loop can not be unrolled actually
-  loops[1].As<ir::For>()->extent.As<ir::IntImm>()->value = 51;
+  loops[1].As<ir::For>()->extent = Expr(51);
   ir_sch.Unroll(loops[1]);
   UnrollLoop(&ast_expr);
   loops = ir_sch.GetLoops("C");
   ASSERT_EQ(loops.size(), 2U);
 
   // unrolled correctly
-  loops[1].As<ir::For>()->extent.As<ir::IntImm>()->value = 4;
+  loops[1].As<ir::For>()->extent = Expr(4);
   UnrollLoop(&ast_expr);
   EXPECT_EQ(ir_sch.GetLoops("C").size(), 1);
 }
@@ -97,5 +98,50 @@ TEST(UnrollLoops, auto_unroll) {
   EXPECT_EQ(ir_sch.GetLoops("B").size(), 1);
 }
 
+TEST(UnrollLoops, choose_unroll_factor) {
+  UnrollEstimate estimate;
+  estimate.body_ops         = 10;
+  estimate.live_values      = 4;
+  estimate.invariant_values = 2;
+  UnrollBudget budget{100, 34};
+
+  // unrolled fully within the budget
+  EXPECT_EQ(ChooseUnrollFactor(8, estimate, budget, 50), 8);
+  // too many live values to unroll fully, so unrolled partially
+  EXPECT_EQ(ChooseUnrollFactor(9, estimate, budget, 50), 8);
+  EXPECT_EQ(ChooseUnrollFactor(32, estimate, budget, 50), 8);
+  // limited by the max factor
+  EXPECT_EQ(ChooseUnrollFactor(32, estimate, budget, 4), 4);
+  // even two iterations exceed the instruction budget
+  EXPECT_EQ(ChooseUnrollFactor(32, estimate, UnrollBudget{10, 34}, 50), 1);
+}
+
+TEST(UnrollLoops, partial_unroll) {
+  using namespace ir;
+
+  Expr N(37);
+  Placeholder<float> A("A", {N});
+  Tensor B = Compute(
+      {N}, [&](Var i) { return A(i) + Expr(1.f); }, "B");
+
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_partial_unroll", stages, {A, B}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  // the loop of 37 iterations exceeds the 16 steps permitted, so it is unrolled by 16 with a remainder of 5
+  auto* block_realize = ast_expr.As<ir::Block>()->stmts.front().As<ir::ScheduleBlockRealize>();
+  ASSERT_TRUE(block_realize != nullptr);
+  block_realize->schedule_block.As<ir::ScheduleBlock>()->attrs.emplace(ir::attr::auto_unroll_max_step, 16);
+  UnrollLoop(&ast_expr, target);
+
+  auto loops = ir::CollectIRNodes(ast_expr, [](const Expr* x) { return x->As<ir::For>(); });
+  ASSERT_EQ(loops.size(), 1U);
+  EXPECT_EQ(loops.begin()->As<ir::For>()->extent.as_int32(), 2);
+  EXPECT_TRUE(loops.begin()->As<ir::For>()->is_serial());
+  auto stores = ir::CollectIRNodes(ast_expr, [](const Expr* x) { return x->As<ir::Store>(); });
+  EXPECT_EQ(stores.size(), 16U + 5U);
+}
+
 }  // namespace optim
 }  // namespace cinn
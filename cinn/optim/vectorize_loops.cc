@@ -18,11 +18,13 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "cinn/backends/llvm/llvm_vector_math.h"
 #include "cinn/common/cas.h"
 #include "cinn/common/ir_util.h"
 #include "cinn/ir/collect_ir_nodes.h"
@@ -33,6 +35,7 @@
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/tensor_write_tell.h"
 #include "cinn/optim/unroll_loops.h"
+#include "cinn/runtime/intrinsic.h"
 #include "cinn/utils/functional.h"
 
 namespace cinn {
@@ -78,6 +81,8 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
   const absl::flat_hash_map<std::string, common::CasInterval> *var_intervals_;
   // save (tensor name) -> (bool flag) to indentify whether tensors can be vectorized or not
   std::unordered_map<std::string, bool> tensor2flag_;
+  // save (tensor name) -> (the last index of its first access) to check the other accesses of the tensor
+  std::unordered_map<std::string, Expr> tensor2last_index_;
 
   void Visit(const ir::Store *expr, const Expr *op) override {
     auto *node = op->As<ir::Store>();
@@ -134,6 +139,20 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
       }
     }
 
+    // the accesses of a tensor are vectorized separately, which share the alignment of the vector type only if they
+    // have the same last index, like the taps of a stencil on the channels-last layout
+    auto it = tensor2last_index_.find(tensor->name);
+    if (it == tensor2last_index_.end()) {
+      tensor2last_index_.emplace(tensor->name, indices.back());
+    } else {
+      auto diff = common::AutoSimplify(Expr(indices.back() - it->second));
+      if (!diff.As<IntImm>() || diff.as_int32() != 0) {
+        VLOG(5) << "Tensor:" << tensor->name << " is accessed by different last indices:" << indices.back() << ", "
+                << it->second;
+        return false;
+      }
+    }
+
     // check tensor accessed sequentially by comparing index one by one
     Expr first_idx = optim::IRCopy(indices.back());
     optim::IrReplace(&first_idx, Expr(iter_var_), Expr(0));
@@ -191,6 +210,68 @@ class CudaVectorizer : public IRMutator<Expr *> {
   // return all store statements collected through vectorizing
   std::vector<Expr> VectorizedTypeStoreExprs() { return vectorized_store_exprs_; }
 
+  // Compute the vectorized float16/bfloat16 body by a packed intrinsic instead of the element-wise unrolled
+  // statements, which runs two lanes in one instruction. It only supports the body of a single store whose value
+  // is a binary operation on two vectorized loads, return true and update the cast exprs if applied.
+  bool PackVectorizedCompute(const Expr &body) {
+    const Expr *stmt = &body;
+    while (stmt->As<ir::Block>() && stmt->As<ir::Block>()->stmts.size() == 1) {
+      stmt = &stmt->As<ir::Block>()->stmts.front();
+    }
+    auto *store = stmt->As<ir::Store>();
+    if (!store || factor_ % 2 != 0) {
+      return false;
+    }
+    Type scalar_type = store->tensor->type().ElementOf();
+    std::string suffix;
+    if (scalar_type.is_float16()) {
+      suffix = "fp16";
+    } else if (scalar_type.is_bfloat16()) {
+      suffix = "bf16";
+    } else {
+      return false;
+    }
+
+    std::string op_name;
+    Expr lhs, rhs;
+#define GET_PACKED_OP_NAME(op__, name__)        \
+  if (store->value.As<ir::op__>()) {            \
+    op_name = name__;                           \
+    lhs     = store->value.As<ir::op__>()->a(); \
+    rhs     = store->value.As<ir::op__>()->b(); \
+  }
+    GET_PACKED_OP_NAME(Add, "add");
+    GET_PACKED_OP_NAME(Sub, "sub");
+    GET_PACKED_OP_NAME(Mul, "mul");
+    GET_PACKED_OP_NAME(Max, "max");
+    GET_PACKED_OP_NAME(Min, "min");
+#undef GET_PACKED_OP_NAME
+    if (op_name.empty()) {
+      return false;
+    }
+
+    Var out_var, lhs_var, rhs_var;
+    if (!GetVectorizedVar(*stmt, &out_var) || !GetVectorizedVar(lhs, &lhs_var) || !GetVectorizedVar(rhs, &rhs_var)) {
+      return false;
+    }
+    // the stored vector is initialized by zero, so it can't be an operand at the same time
+    if (lhs_var->name == out_var->name || rhs_var->name == out_var->name) {
+      return false;
+    }
+
+    // replace the zero initialization of the stored vector with the result of the packed intrinsic
+    auto it = std::find_if(vectorized_cast_exprs_.begin(), vectorized_cast_exprs_.end(), [&](const Expr &e) {
+      return e.As<ir::Let>()->symbol.as_var()->name == out_var->name;
+    });
+    CHECK(it != vectorized_cast_exprs_.end());
+    vectorized_cast_exprs_.erase(it);
+    std::string fn_name = "cinn_nvgpu_" + op_name + "_" + suffix + "x" + std::to_string(factor_);
+    auto call = ir::Call::Make(out_var->type(), fn_name, {Expr(lhs_var), Expr(rhs_var)}, {}, ir::CallType::Extern);
+    vectorized_cast_exprs_.emplace_back(Let::Make(out_var, call));
+    VLOG(5) << "Append a packed vectorized expr:" << vectorized_cast_exprs_.back();
+    return true;
+  }
+
   void Visit(Expr *expr) {
     write_teller_.Collect(expr);
     vectorized_teller_.Collect(expr);
@@ -221,12 +302,13 @@ class CudaVectorizer : public IRMutator<Expr *> {
     auto *tensor = node->tensor.As<ir::_Tensor_>();
     VLOG(5) << "Vectorizing tensor:" << tensor->name;
 
-    // save the tensor and its corresponding vector name when it first appear
-    if (!tensor2vectorized_vars_.count(tensor->name)) {
+    // save the access of a tensor and its corresponding vector name when it first appear
+    std::string access_key = GetAccessKey(tensor->name, *indices);
+    if (!tensor2vectorized_vars_.count(access_key)) {
       AppendCast(node->tensor, *indices, is_store);
     }
 
-    auto vectorized_var = tensor2vectorized_vars_.at(tensor->name);
+    auto vectorized_var = tensor2vectorized_vars_.at(access_key);
     // substitue a new tensor with the vector name and dtype
     auto t       = vectorized_var->type().is_cpp_handle() ? node->tensor->type().PointerOf() : node->tensor->type();
     node->tensor = ir::Tensor(vectorized_var->name, t, {Expr(factor_)}, {Expr(factor_)}, tensor->operation);
@@ -234,6 +316,42 @@ class CudaVectorizer : public IRMutator<Expr *> {
     indices->assign({iter_var_});
   }
 
+  // the key of an access to a tensor is the address of its first lane, so the accesses of a tensor with different
+  // leading indices get their own vectors
+  std::string GetAccessKey(const std::string &tensor_name, const std::vector<Expr> &indices) {
+    std::vector<Expr> first_lane;
+    for (auto &index : indices) {
+      first_lane.emplace_back(optim::IRCopy(index));
+      optim::IrReplace(&first_lane.back(), iter_var_, Expr(int32_t(0)));
+    }
+    return tensor_name + "[" + utils::Join(first_lane, ",") + "]";
+  }
+
+  // get the local vector variable of a vectorized load/store, which accesses the lane of the loop var
+  bool GetVectorizedVar(const Expr &expr, Var *var) {
+    const ir::LoadStoreAddrMnger *node = nullptr;
+    const std::vector<Expr> *indices   = nullptr;
+    if (auto *load = expr.As<ir::Load>()) {
+      node    = load;
+      indices = &load->indices;
+    } else if (auto *store = expr.As<ir::Store>()) {
+      node    = store;
+      indices = &store->indices;
+    }
+    if (!node || !node->is_addr_tensor() || indices->size() != 1 || !indices->front().as_var() ||
+        indices->front().as_var()->name != iter_var_->name) {
+      return false;
+    }
+    auto *tensor = node->tensor.As<ir::_Tensor_>();
+    for (auto &&item : tensor2vectorized_vars_) {
+      if (item.second->name == tensor->name) {
+        *var = item.second;
+        return true;
+      }
+    }
+    return false;
+  }
+
   std::string GetVectorTypeName(Type type) {
     std::string name_prefix = common::customized_type::kcuda_builtin_vector_t;
 #define GET_CUDA_VECTOR_TYPE_NAME(pred_expr, scalar_name)       \
@@ -268,10 +386,19 @@ class CudaVectorizer : public IRMutator<Expr *> {
     vector_type.set_customized_type(GetVectorTypeName(scalar_type));
     vector_type.set_cpp_const(is_const);
 
-    // generate a local vector variable to be used in subsequent statements
+    // generate a local vector variable to be used in subsequent statements, the vectors of the other accesses to the
+    // same tensor are numbered by their order
+    int num_accesses = std::count_if(tensor2vectorized_vars_.begin(),
+                                     tensor2vectorized_vars_.end(),
+                                     [&](const std::pair<std::string, Var> &item) {
+                                       return item.first.compare(0, node->name.size() + 1, node->name + "[") == 0;
+                                     });
     std::string vectorized_name = "vectorized_" + node->name;
-    Var vectorized_var          = _Var_::Make(vectorized_name, vector_type);
-    tensor2vectorized_vars_.emplace(node->name, vectorized_var);
+    if (num_accesses > 0) {
+      vectorized_name += "_" + std::to_string(num_accesses);
+    }
+    Var vectorized_var = _Var_::Make(vectorized_name, vector_type);
+    tensor2vectorized_vars_.emplace(GetAccessKey(node->name, indices), vectorized_var);
 
     // generate a get_addr expr to get the address of the tensor
     Expr converted_tensor = Load::Make(tensor, indices);
@@ -647,7 +774,9 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
   void Visit(const Call *op, Expr *expr) override {
     auto it = op->attrs.find("vectorizable");
     if (it != op->attrs.end()) {
-      vectorizable_ = absl::get<bool>(it->second);
+      // the calls expanded into the inline vector math of x86 are vectorizable
+      vectorizable_ = absl::get<bool>(it->second) ||
+                      (!target.is_gpu() && codegen::UseX86VectorMath(op->name, op->type()));
     }
   }
 
@@ -675,7 +804,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       vectorizable_ = true;
       IRMutator<>::Visit(&node->body, &node->body);
 
-      if (target == common::DefaultNVGPUTarget()) {
+      if (target.is_gpu()) {
         if (!forloop->extent.As<IntImm>() || forloop->extent.as_int32() % forloop->vectorize_info().factor != 0) {
           vectorizable_ = false;
           VLOG(5) << "GPU vectorize only support extent is a multiple of factor";
@@ -689,6 +818,11 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
         return;
       }
 
+      if (!target.is_gpu() && VectorizeReduction(node, expr)) {
+        var_intervals.erase(loopvar_name);
+        return;
+      }
+
       const int factor  = forloop->vectorize_info().factor;
       auto _new_forloop = SplitForLoop(node, factor);
       if (!_new_forloop.defined()) {
@@ -718,16 +852,20 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       VLOG(2) << "Vectorizing " << new_forloop->loop_var << " extent " << extent;
       VLOG(2) << "before vectorize body:\n" << node->body;
 
-      if (target == common::DefaultNVGPUTarget()) {
+      if (target.is_gpu()) {
         CudaVectorizer cuda_vectorizer(new_forloop->loop_var, factor, &var_intervals);
         cuda_vectorizer.Visit(&new_forloop->body);
-        // unroll the new forloop to compute each element of the vector iteratively
-        auto copied_loop = optim::IRCopy(_new_forloop);
-        copied_loop.As<ir::For>()->set_unrolled();
-        optim::UnrollLoop(&copied_loop);
+        // compute all the elements of a float16/bfloat16 vector by a packed intrinsic if possible,
+        // otherwise unroll the new forloop to compute each element of the vector iteratively
+        std::vector<Expr> unroll_body;
+        if (!cuda_vectorizer.PackVectorizedCompute(new_forloop->body)) {
+          auto copied_loop = optim::IRCopy(_new_forloop);
+          copied_loop.As<ir::For>()->set_unrolled();
+          optim::UnrollLoop(&copied_loop, target);
+          unroll_body = copied_loop.As<ir::Block>()->stmts;
+        }
         // add cast exprs of vector type in the front of vectorized forloop,
         // and replace original compute statements with the correspond unrolled ones
-        auto unroll_body = copied_loop.As<ir::Block>()->stmts;
         auto cast_exprs  = cuda_vectorizer.VectorizedTypeCastExprs();
         auto store_exprs = cuda_vectorizer.VectorizedTypeStoreExprs();
         auto &body_stmts = new_forloop->body.As<ir::Block>()->stmts;
@@ -752,6 +890,153 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     var_intervals.erase(loopvar_name);
   }
 
+  //! Vectorize the reduction `C[i] = C[i] op f(k)` over the loop var k of \p forloop, where op is add, max or min. The
+  //! lanes are accumulated in a local vector, which is reduced horizontally at the loop exit, and the tail iterations
+  //! out of the multiple of the factor are computed serially.
+  //! @return false if the body of \p forloop is not such a reduction.
+  bool VectorizeReduction(For *forloop, Expr *expr) {
+    auto *extent_int = forloop->extent.As<IntImm>();
+    const int factor = forloop->vectorize_info().factor;
+    if (!extent_int || extent_int->value < factor) return false;
+
+    const Expr *stmt = &forloop->body;
+    while (stmt->As<Block>() && stmt->As<Block>()->stmts.size() == 1) {
+      stmt = &stmt->As<Block>()->stmts.front();
+    }
+    auto *store  = stmt->As<Store>();
+    auto *tensor = store ? store->tensor.As<_Tensor_>() : nullptr;
+    if (!tensor) return false;
+    // only the float vectors of the full AVX/AVX-512 registers are reduced by the horizontal intrinsics
+    Type type = store->value.type();
+    int bits  = type.bits() * factor;
+    if (type.lanes() != 1 || !(type.is_float(32) || type.is_float(64)) || (bits != 256 && bits != 512)) return false;
+
+    auto uses_var = [](const Expr &e, const Var &var) {
+      return !ir::CollectIRNodes(e, [&](const Expr *x) { return x->As<_Var_>() && x->As<_Var_>()->name == var->name; })
+                  .empty();
+    };
+    auto reads_tensor = [&](const Expr &e) {
+      return !ir::CollectIRNodes(e, [&](const Expr *x) {
+                return x->As<Load>() && x->As<Load>()->tensor.as_tensor() &&
+                       x->As<Load>()->tensor.as_tensor()->name == tensor->name;
+              }).empty();
+    };
+    for (auto &index : store->indices) {
+      if (uses_var(index, forloop->loop_var)) return false;
+    }
+
+    // match the operation whose one operand is loaded from the stored location
+    auto is_stored_location = [&](const Expr &e) {
+      auto *load = e.As<Load>();
+      if (!load || !load->tensor.as_tensor() || load->tensor.as_tensor()->name != tensor->name ||
+          load->indices.size() != store->indices.size()) {
+        return false;
+      }
+      for (int i = 0; i < load->indices.size(); ++i) {
+        if (!common::is_zero(common::AutoSimplify(load->indices[i] - store->indices[i]))) return false;
+      }
+      return true;
+    };
+    std::string reduce_name;
+    Expr a, b;
+    if (auto *add = store->value.As<Add>()) {
+      reduce_name = runtime::intrinsic::vector_reduce_add;
+      a           = add->a();
+      b           = add->b();
+    } else if (auto *max = store->value.As<Max>()) {
+      reduce_name = runtime::intrinsic::vector_reduce_max;
+      a           = max->a();
+      b           = max->b();
+    } else if (auto *min = store->value.As<Min>()) {
+      reduce_name = runtime::intrinsic::vector_reduce_min;
+      a           = min->a();
+      b           = min->b();
+    } else {
+      return false;
+    }
+    Expr operand;
+    if (is_stored_location(a)) {
+      operand = b;
+    } else if (is_stored_location(b)) {
+      operand = a;
+    } else {
+      return false;
+    }
+    if (reads_tensor(operand)) return false;
+
+    auto make_reduce = [&](Expr x, Expr y) -> Expr {
+      if (reduce_name == runtime::intrinsic::vector_reduce_add) return Add::Make(x, y);
+      if (reduce_name == runtime::intrinsic::vector_reduce_max) return Max::Make(x, y);
+      return Min::Make(x, y);
+    };
+    auto init_value = [&]() -> Expr {
+      if (reduce_name == runtime::intrinsic::vector_reduce_add) return make_const(type, 0);
+      bool is_max = reduce_name == runtime::intrinsic::vector_reduce_max;
+      if (type.is_float(32)) {
+        return make_const(type, is_max ? std::numeric_limits<float>::lowest() : std::numeric_limits<float>::max());
+      }
+      return make_const(type, is_max ? std::numeric_limits<double>::lowest() : std::numeric_limits<double>::max());
+    };
+    // the operand on the lanes from base
+    Var lane_var(Context::Global().NewName("vi"));
+    var_intervals.emplace(lane_var->name, common::CasInterval{0, factor - 1});
+    auto vectorize_operand = [&](Expr base) {
+      Expr vec = IRCopy(operand);
+      optim::IrReplace(&vec, forloop->loop_var, base + Expr(lane_var));
+      Vectorizer(lane_var, factor, var_intervals).Visit(&vec);
+      return Widen(vec, factor);
+    };
+
+    const int extent      = extent_int->value;
+    const int main_extent = extent / factor * factor;
+    VLOG(2) << "Vectorizing the reduction over " << forloop->loop_var << " extent " << extent << " by factor " << factor;
+
+    std::vector<Expr> stmts;
+    Expr vec_result;
+    if (main_extent == factor) {
+      vec_result = vectorize_operand(Expr(0));
+    } else {
+      Var acc_var(common::UniqName(tensor->name + "_vec_acc"), type.with_lanes(factor));
+      ir::Tensor acc(acc_var->name,
+                     type,
+                     {Expr(factor)},
+                     {Expr(factor)},
+                     PlaceholderOp::Make(acc_var->name, {Expr(factor)}, type));
+      Expr lanes = Ramp::Make(make_zero(), make_one(), factor);
+      Var outer_var(common::UniqName(forloop->loop_var->name + "_outer"));
+      Expr acc_update = Store::Make(
+          acc, make_reduce(Load::Make(acc, {lanes}), vectorize_operand(Expr(outer_var) * factor)), {lanes});
+
+      stmts.push_back(Let::Make(acc_var, Expr()));
+      stmts.push_back(Store::Make(acc, Broadcast::Make(init_value(), factor), {lanes}));
+      stmts.push_back(For::Make(outer_var,
+                                make_zero(),
+                                make_const(main_extent / factor),
+                                ForType::Serial,
+                                DeviceAPI::Host,
+                                Block::Make({acc_update})));
+      vec_result = Load::Make(acc, {lanes});
+    }
+    var_intervals.erase(lane_var->name);
+
+    // reduce the lanes horizontally into the stored location
+    Expr horizontal = Call::Make(type, reduce_name, {vec_result}, {}, CallType::Intrinsic);
+    stmts.push_back(Store::Make(
+        store->tensor, make_reduce(Load::Make(store->tensor, store->indices), horizontal), store->indices));
+
+    if (main_extent < extent) {
+      Var tail_var(common::UniqName(forloop->loop_var->name + "_tail"));
+      Expr tail_body = IRCopy(forloop->body);
+      optim::IrReplace(&tail_body, forloop->loop_var, tail_var);
+      stmts.push_back(For::Make(
+          tail_var, make_const(main_extent), make_const(extent), ForType::Serial, DeviceAPI::Host, tail_body));
+    }
+
+    *expr = Block::Make(stmts);
+    VLOG(2) << "after vectorize reduction:\n" << *expr;
+    return true;
+  }
+
   //! unroll the forloop if its' extent is min type by solving the condition extent
   //! @return The new forloop.
   bool UnrollCmpFor(For *outer_for, For *inner_for, Expr *expr) {
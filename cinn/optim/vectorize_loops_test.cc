@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
 #include <vector>
 
 #include "cinn/cinn.h"
@@ -232,6 +233,42 @@ TEST(Vectorize, single_for) {
   LOG(INFO) << "Forloop\n" << forloop;
 }
 
+TEST(Vectorize, reduction) {
+  Placeholder<float> A("A", std::vector<int>{{100}});
+  Placeholder<float> B("B", std::vector<int>{{100}});
+  Placeholder<float> C("C", std::vector<int>{{1}});
+
+  Var loop_var("k0");
+
+  // C[0] = C[0] + A[k0] * B[k0]
+  Expr body = Store::Make(ir::Tensor(C),
+                          ir::Add::Make(ir::Load::Make(ir::Tensor(C), {Expr(0)}),
+                                        ir::Mul::Make(ir::Load::Make(ir::Tensor(A), {Expr(loop_var)}),
+                                                      ir::Load::Make(ir::Tensor(B), {Expr(loop_var)}))),
+                          {Expr(0)});
+  body      = ir::Block::Make({body});
+
+  VectorizeInfo vectorize_info(0, 16);
+  Expr forloop = ir::For::Make(loop_var,
+                               common::make_const(0),
+                               common::make_const(100),
+                               ir::ForType::Vectorized,
+                               ir::DeviceAPI::UNK,
+                               body,
+                               vectorize_info);
+
+  VectorizeLoops(&forloop, common::DefaultHostTarget());
+  LOG(INFO) << "Forloop\n" << forloop;
+
+  auto out = GetStreamCnt(forloop);
+  // the lanes are accumulated in a local vector and reduced at the loop exit
+  EXPECT_NE(out.find("C_vec_acc"), std::string::npos);
+  EXPECT_NE(out.find("cinn_vector_reduce_add"), std::string::npos);
+  // the tail iterations of 96 ~ 100 are computed serially
+  EXPECT_NE(out.find("k0_tail"), std::string::npos);
+  EXPECT_NE(out.find("Ramp(0,1,16)"), std::string::npos);
+}
+
 TEST(Vectorize, cuda_vectorize) {
   Expr M(100);
   Expr N(500);
@@ -284,5 +321,25 @@ TEST(Vectorize, cuda_vectorize_with_constant) {
   auto func     = Lower("mul_const", stages, {A, C}, {}, {}, nullptr, target);
 }
 
+TEST(Vectorize, cuda_vectorize_packed_fp16) {
+  Expr M(100);
+  Expr N(512);
+  Placeholder<common::float16> A("A", {M, N});
+  Placeholder<common::float16> B("B", {M, N});
+
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  auto stages = CreateStages({C});
+  stages[C]->Vectorize(1, 8);
+  Target target = common::DefaultNVGPUTarget();
+  auto func     = Lower("add_fp16", stages, {A, B, C}, {}, {}, nullptr, target);
+
+  // the 8 lanes are computed by one packed call instead of the unrolled element-wise statements
+  auto func_str = GetStreamCnt(func);
+  ASSERT_NE(func_str.find("cinn_nvgpu_add_fp16x8(vectorized_A, vectorized_B)"), std::string::npos) << func_str;
+  ASSERT_EQ(func_str.find("vectorized_C[0] ="), std::string::npos) << func_str;
+}
+
 }  // namespace optim
 }  // namespace cinn
@@ -14,8 +14,12 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
+#include <isl/options.h>
 #include <llvm/Support/FormatVariadic.h>
 
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/common.h"
@@ -23,10 +27,51 @@
 #include "cinn/ir/ir_printer.h"
 #include "cinn/poly/domain_add_unit_loop_mutator.h"
 #include "cinn/poly/isl_utils.h"
+#include "cinn/utils/compile_stats.h"
+
+DECLARE_int64(cinn_isl_ast_max_operations);
 
 namespace cinn {
 namespace poly {
 
+namespace {
+
+struct AstCacheEntry {
+  isl::ast_node ast;
+  std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map;
+};
+
+//! The ASTs built in the isl context of the current thread, keyed by the printed schedule and the build settings, so
+//! the groups with identical domains and schedules only run the isl AST generation once.
+thread_local std::unordered_map<std::string, AstCacheEntry> ast_cache;
+constexpr size_t kMaxAstCacheSize = 1024;
+
+/**
+ * Build the AST of \p schedule within FLAGS_cinn_isl_ast_max_operations isl operations, return a null node when it
+ * goes over the budget.
+ */
+isl::ast_node BuildAstWithinBudget(const isl::ast_build& build, const isl::union_map& schedule) {
+  isl_ctx* ctx = build.ctx().get();
+  if (FLAGS_cinn_isl_ast_max_operations <= 0) {
+    return isl::manage(isl_ast_build_node_from_schedule_map(build.copy(), schedule.copy()));
+  }
+  int on_error = isl_options_get_on_error(ctx);
+  isl_options_set_on_error(ctx, ISL_ON_ERROR_CONTINUE);
+  isl_ctx_reset_operations(ctx);
+  isl_ctx_set_max_operations(ctx, FLAGS_cinn_isl_ast_max_operations);
+
+  isl_ast_node* node = isl_ast_build_node_from_schedule_map(build.copy(), schedule.copy());
+  bool over_budget   = !node && isl_ctx_last_error(ctx) == isl_error_quota;
+
+  isl_ctx_set_max_operations(ctx, 0);
+  isl_ctx_reset_error(ctx);
+  isl_options_set_on_error(ctx, on_error);
+  CHECK(node || over_budget) << "isl failed to build the AST of schedule " << schedule;
+  return isl::manage(node);
+}
+
+}  // namespace
+
 struct AstGen::Impl {
   Impl(const isl::set& context, const poly::ScheduleGroup& schedule_group)
       : context_(context), schedule_group_(schedule_group) {}
@@ -148,11 +193,12 @@ isl::ast_node AstGen::Build() {
   }
   auto schedule = isl_maps_to_union_map(maps);
 
+  utils::CompileStats::PhaseTimer stats_timer("poly::AstGen");
   // Build it.
   auto ast_build = isl::ast_build::from_context(impl_->context_);
 
   if (!impl_->build_options_.is_null())
-    ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.release()));
+    ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.copy()));
 
   // Set iterators names for readable code.
   auto iterator_names =
@@ -189,8 +235,32 @@ isl::ast_node AstGen::Build() {
   VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
   VLOG(4) << "schedule: " << schedule;
   VLOG(4) << "schedule_domain: " << schedule_domain;
-  isl::ast_node ast = ast_build.node_from_schedule_map(schedule_domain);
+
+  std::stringstream cache_key;
+  cache_key << impl_->context_ << ";" << schedule_domain << ";" << utils::Join(iterator_names, ",") << ";";
+  if (!impl_->build_options_.is_null()) cache_key << impl_->build_options_;
+  auto cached = ast_cache.find(cache_key.str());
+  if (cached != ast_cache.end()) {
+    VLOG(3) << "Reuse the cached isl AST";
+    impl_->transformed_indice_map_ = cached->second.transformed_indice_map;
+    return cached->second.ast;
+  }
+
+  isl::ast_node ast = BuildAstWithinBudget(ast_build, schedule_domain);
+  if (ast.is_null()) {
+    // drop the costly bound refinements, the loops might keep some redundant min/max bounds
+    LOG(WARNING) << "The isl AST generation goes over the budget of " << FLAGS_cinn_isl_ast_max_operations
+                 << " operations, rebuild it with the cheaper options";
+    impl_->transformed_indice_map_.clear();
+    isl_options_set_ast_build_detect_min_max(ctx().get(), 0);
+    isl_options_set_ast_build_exploit_nested_bounds(ctx().get(), 0);
+    ast = ast_build.node_from_schedule_map(schedule_domain);
+    impl_->InitIslAstConfig();
+  }
   VLOG(2) << "AST:\n" << isl_ast_node_to_C_str(ast.get());
+
+  if (ast_cache.size() >= kMaxAstCacheSize) ast_cache.clear();
+  ast_cache[cache_key.str()] = AstCacheEntry{ast, impl_->transformed_indice_map_};
   return ast;
 }
 
@@ -435,6 +505,13 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
 
       auto set_ops_ptype = [&](ir::Type type) {
         for (auto& op : ops) {
+          if (op.type() == type) continue;
+          // the interned constants are shared, so retype a private copy
+          if (auto* int_n = op.As<ir::IntImm>(); int_n && ir::IsInternedImm(int_n)) {
+            op = ir::Expr(new ir::IntImm(int_n->type(), int_n->value));
+          } else if (auto* uint_n = op.As<ir::UIntImm>(); uint_n && ir::IsInternedImm(uint_n)) {
+            op = ir::Expr(new ir::UIntImm(uint_n->type(), uint_n->value));
+          }
           op->set_type(type);
         }
       };
@@ -38,7 +38,14 @@ void BindExecutionEngine(py::module *m) {
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("num_compile_threads", &ExecutionOptions::num_compile_threads)
+      .def_readwrite("use_host_cpu", &ExecutionOptions::use_host_cpu)
+      .def_readwrite("loop_vectorize", &ExecutionOptions::loop_vectorize)
+      .def_readwrite("slp_vectorize", &ExecutionOptions::slp_vectorize)
+      .def_readwrite("loop_interleave", &ExecutionOptions::loop_interleave)
+      .def_readwrite("fast_math", &ExecutionOptions::fast_math)
+      .def_readwrite("inline_threshold", &ExecutionOptions::inline_threshold);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
@@ -56,7 +63,7 @@ void BindExecutionEngine(py::module *m) {
       .def(py::init(py::overload_cast<const ExecutionOptions &>(&ExecutionEngine::Create)),
            py::arg("options") = ExecutionOptions())
       .def("lookup", lookup)
-      .def("link", &ExecutionEngine::Link);
+      .def("link", [](ExecutionEngine &self, const ir::Module &module) { self.Link(module); });
 
   {
     auto lookup = [](Compiler &self, absl::string_view name) {
@@ -58,6 +58,7 @@ void BindTarget(py::module *m) {
 
   m->def("DefaultHostTarget", &common::DefaultHostTarget)
       .def("DefaultNVGPUTarget", &common::DefaultNVGPUTarget)
+      .def("DefaultAMDGPUTarget", &common::DefaultAMDGPUTarget)
       .def("DefaultTarget", &common::DefaultTarget);
 
   m->def("get_target", &cinn::runtime::CurrentTarget::GetCurrentTarget);
@@ -70,7 +71,8 @@ void BindTarget(py::module *m) {
   arch.value("Unk", Target::Arch::Unk)
       .value("X86", Target::Arch::X86)
       .value("ARM", Target::Arch::ARM)
-      .value("NVGPU", Target::Arch::NVGPU);
+      .value("NVGPU", Target::Arch::NVGPU)
+      .value("AMDGPU", Target::Arch::AMDGPU);
 
   py::enum_<Target::Bit> bit(target, "Bit");
   bit.value("Unk", Target::Bit::Unk).value("k32", Target::Bit::k32).value("k64", Target::Bit::k64);
@@ -96,6 +98,7 @@ void BindType(py::module *m) {
   DEFINE_TYPE_METHOD(is_float);
   DEFINE_TYPE_METHOD(is_float16);
   DEFINE_TYPE_METHOD(is_bfloat16);
+  DEFINE_TYPE_METHOD(is_float8);
   DEFINE_TYPE_METHOD(is_int);
   DEFINE_TYPE_METHOD(is_uint);
   DEFINE_TYPE_METHOD(is_string);
@@ -132,6 +135,8 @@ void BindType(py::module *m) {
   specific_type_t.value("None", Type::specific_type_t::None)
       .value("FP16", Type::specific_type_t::FP16)
       .value("BF16", Type::specific_type_t::BF16)
+      .value("E5M2", Type::specific_type_t::E5M2)
+      .value("E4M3", Type::specific_type_t::E4M3)
       .export_values();
 
   py::enum_<Type::cpp_type_t> cpp_type_t(type, "cpp_type_t");
@@ -147,6 +152,8 @@ void BindType(py::module *m) {
       .def("Float", &common::Float, py::arg("bits"), py::arg("lanes") = 1, py::arg("st") = Type::specific_type_t::None)
       .def("Float16", &common::Float16, py::arg("lanes") = 1)
       .def("BFloat16", &common::BFloat16, py::arg("lanes") = 1)
+      .def("Float8E4M3", &common::Float8E4M3, py::arg("lanes") = 1)
+      .def("Float8E5M2", &common::Float8E5M2, py::arg("lanes") = 1)
       .def("Bool", &common::Bool, py::arg("lanes") = 1)
       .def("String", &common::String);
 
@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dlpack/dlpack.h>
 #include <pybind11/functional.h>
 #include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 
+#include <limits>
+#include <memory>
+
 #include "cinn/common/cinn_value.h"
 #include "cinn/frontend/interpreter.h"
 #include "cinn/hlir/framework/graph_compiler.h"
@@ -34,6 +38,156 @@ namespace cinn::pybind {
 
 namespace py = pybind11;
 using namespace cinn::hlir::framework;  // NOLINT
+
+namespace {
+// The bool is stored in a byte, and the bfloat16 is viewed as uint16 by numpy.
+DLDataType ToDLDataType(const common::Type &type) {
+  DLDataType dtype;
+  dtype.lanes = 1;
+  dtype.bits  = type.is_bool() ? 8 : type.bits();
+  if (type.is_bool()) {
+    dtype.code = kDLBool;
+  } else if (type.is_bfloat16()) {
+    dtype.code = kDLBfloat;
+  } else if (type.is_float()) {
+    dtype.code = kDLFloat;
+  } else if (type.is_int()) {
+    dtype.code = kDLInt;
+  } else if (type.is_uint()) {
+    dtype.code = kDLUInt;
+  } else {
+    LOG(FATAL) << "The type " << type << " is not supported by DLPack";
+  }
+  return dtype;
+}
+
+common::Type FromDLDataType(const DLDataType &dtype) {
+  CHECK_EQ(dtype.lanes, 1) << "The vectorized DLPack tensor is not supported";
+  switch (dtype.code) {
+    case kDLBool:
+      return common::Bool();
+    case kDLBfloat:
+      CHECK_EQ(dtype.bits, 16) << "Only the bfloat16 is supported";
+      return common::BFloat16();
+    case kDLFloat:
+      return dtype.bits == 16 ? common::Float16() : common::Float(dtype.bits);
+    case kDLInt:
+      return common::Int(dtype.bits);
+    case kDLUInt:
+      return common::UInt(dtype.bits);
+    default:
+      LOG(FATAL) << "The DLPack type code " << static_cast<int>(dtype.code) << " is not supported";
+  }
+  return common::Type();
+}
+
+DLDevice ToDLDevice(const common::Target &target) {
+  if (target.arch == Target::Arch::NVGPU) {
+    int device_id = 0;
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaGetDevice(&device_id));
+#endif
+    return DLDevice{kDLCUDA, device_id};
+  }
+  return DLDevice{kDLCPU, 0};
+}
+
+common::Target FromDLDevice(const DLDevice &device) {
+  if (device.device_type == kDLCPU) {
+    return common::DefaultHostTarget();
+  }
+  CHECK(device.device_type == kDLCUDA || device.device_type == kDLCUDAHost)
+      << "The DLPack device type " << device.device_type << " is not supported";
+#ifdef CINN_WITH_CUDA
+  return device.device_type == kDLCUDA ? common::DefaultNVGPUTarget() : common::DefaultHostTarget();
+#else
+  LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+  return common::DefaultHostTarget();
+#endif
+}
+
+// The exported DLPack tensor shares the buffer of the tensor and keeps it alive until the consumer deletes it.
+struct DLPackContext {
+  std::shared_ptr<Buffer> buffer;
+  std::vector<int64_t> shape;
+  DLManagedTensor managed;
+};
+
+py::capsule ToDLPack(Tensor &tensor) {
+  auto buffer = tensor->get_buffer();
+  CHECK(buffer->data()->memory) << "The tensor should be allocated before exported to DLPack";
+  const auto &shape = tensor->shape().data();
+  auto *ctx         = new DLPackContext{buffer, std::vector<int64_t>(shape.begin(), shape.end()), {}};
+
+  auto &dl_tensor       = ctx->managed.dl_tensor;
+  dl_tensor.data        = buffer->data()->memory;
+  dl_tensor.device      = ToDLDevice(buffer->target());
+  dl_tensor.ndim        = ctx->shape.size();
+  dl_tensor.dtype       = ToDLDataType(tensor->type());
+  dl_tensor.shape       = ctx->shape.data();
+  dl_tensor.strides     = nullptr;
+  dl_tensor.byte_offset = 0;
+  ctx->managed.manager_ctx = ctx;
+  ctx->managed.deleter     = [](DLManagedTensor *self) { delete static_cast<DLPackContext *>(self->manager_ctx); };
+
+  // the consumer renames the capsule to "used_dltensor" and calls the deleter by itself
+  auto *capsule = PyCapsule_New(&ctx->managed, "dltensor", [](PyObject *capsule) {
+    if (PyCapsule_IsValid(capsule, "dltensor")) {
+      auto *managed = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+      managed->deleter(managed);
+    }
+  });
+  return py::reinterpret_steal<py::capsule>(capsule);
+}
+
+// Bind the memory of a DLPack capsule, or of an object supporting `__dlpack__` such as a numpy array or a PyTorch
+// tensor, to the tensor without copy. The memory is kept alive until the tensor doesn't point to it anymore.
+void BindDLPack(Tensor &tensor, const py::object &obj) {
+  py::object capsule = py::hasattr(obj, "__dlpack__") ? obj.attr("__dlpack__")() : obj;
+  CHECK(PyCapsule_IsValid(capsule.ptr(), "dltensor")) << "The object is neither a DLPack capsule nor consumed yet";
+  auto *managed = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule.ptr(), "dltensor"));
+  PyCapsule_SetName(capsule.ptr(), "used_dltensor");
+  std::shared_ptr<void> holder(managed, [](void *ptr) {
+    auto *self = static_cast<DLManagedTensor *>(ptr);
+    if (self->deleter) {
+      py::gil_scoped_acquire gil;
+      self->deleter(self);
+    }
+  });
+
+  const auto &dl_tensor = managed->dl_tensor;
+  shape_t shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides) {
+    int64_t stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      CHECK(shape[i] == 1 || dl_tensor.strides[i] == stride) << "Only the compact DLPack tensor can be shared";
+      stride *= shape[i];
+    }
+  }
+  auto type = FromDLDataType(dl_tensor.dtype);
+  if (tensor->shape().numel() > 0) {
+    CHECK_EQ(tensor->shape().numel(), std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>()))
+        << "The number of the elements of the DLPack tensor is not equal to the tensor";
+    CHECK(tensor->type() == type) << "The dtype of the DLPack tensor is " << type << ", but the tensor is "
+                                  << tensor->type();
+  } else {
+    tensor->Resize(Shape(shape));
+    tensor->set_type(type);
+  }
+  size_t nbytes = tensor->shape().numel() * type.bytes();
+  CHECK_LE(nbytes, std::numeric_limits<uint32_t>::max()) << "The DLPack tensor is too large";
+  tensor->get_buffer()->SetExternalMemory(static_cast<uint8_t *>(dl_tensor.data) + dl_tensor.byte_offset,
+                                          nbytes,
+                                          FromDLDevice(dl_tensor.device),
+                                          std::move(holder));
+}
+
+std::string GetNumpyTypeStr(const common::Type &type) {
+  std::string type_str = common::Type2Str(type);
+  return type_str == "bfloat16" ? "uint16" : type_str;
+}
+}  // namespace
+
 void BindFramework(pybind11::module *m) {
   py::class_<Operator>(*m, "Operator")
       .def("get_op_attrs", [](const std::string &key) { return Operator::GetAttrs<StrategyFunction>(key); })
@@ -136,61 +290,239 @@ void BindFramework(pybind11::module *m) {
              }
              return array;
            })
+      .def(
+          "bind_dlpack",
+          [](Scope &self, const std::string &name, const py::object &obj) {
+            auto *var = self.FindVar(name);
+            CHECK(var) << "The variable [" << name << "] is not found in scope";
+            BindDLPack(absl::get<Tensor>(*var), obj);
+          },
+          py::arg("name"),
+          py::arg("obj"))
       .def("var_names", &Scope::var_names);
 
+  py::class_<KernelCounters>(*m, "KernelCounters")
+      .def_readonly("kernel_name", &KernelCounters::kernel_name)
+      .def_readonly("duration_ms", &KernelCounters::duration_ms)
+      .def_readonly("dram_bytes", &KernelCounters::dram_bytes)
+      .def_readonly("achieved_occupancy", &KernelCounters::achieved_occupancy)
+      .def_readonly("sm_throughput", &KernelCounters::sm_throughput)
+      .def_readonly("l2_hit_rate", &KernelCounters::l2_hit_rate)
+      .def_readonly("warp_stalls", &KernelCounters::warp_stalls);
+
+  py::class_<InstructionProfile>(*m, "InstructionProfile")
+      .def_readonly("fn_names", &InstructionProfile::fn_names)
+      .def_readonly("launch_count", &InstructionProfile::launch_count)
+      .def_readonly("total_ms", &InstructionProfile::total_ms)
+      .def_readonly("ratio", &InstructionProfile::ratio)
+      .def_readonly("counters", &InstructionProfile::counters)
+      .def_readonly("kernel_counters", &InstructionProfile::kernel_counters)
+      .def("avg_ms", &InstructionProfile::avg_ms)
+      .def("has_counters", &InstructionProfile::has_counters);
+
+  py::class_<ProfileReport>(*m, "ProfileReport")
+      .def_readonly("instructions", &ProfileReport::instructions)
+      .def_readonly("num_runs", &ProfileReport::num_runs)
+      .def_readonly("total_ms", &ProfileReport::total_ms)
+      .def("to_string", &ProfileReport::ToString, py::arg("top_k") = 0)
+      .def("__str__", [](const ProfileReport &self) { return self.ToString(); });
+
+  py::class_<auto_schedule::KernelWork>(*m, "KernelWork")
+      .def_readonly("flops", &auto_schedule::KernelWork::flops)
+      .def_readonly("bytes_read", &auto_schedule::KernelWork::bytes_read)
+      .def_readonly("bytes_written", &auto_schedule::KernelWork::bytes_written)
+      .def("arithmetic_intensity", &auto_schedule::KernelWork::arithmetic_intensity);
+
+  py::class_<DevicePeak>(*m, "DevicePeak")
+      .def_readonly("gflops", &DevicePeak::gflops)
+      .def_readonly("gbytes_per_sec", &DevicePeak::gbytes_per_sec);
+
+  py::class_<KernelRoofline>(*m, "KernelRoofline")
+      .def_readonly("index", &KernelRoofline::index)
+      .def_readonly("fn_names", &KernelRoofline::fn_names)
+      .def_readonly("work", &KernelRoofline::work)
+      .def_readonly("total_ms", &KernelRoofline::total_ms)
+      .def_readonly("avg_ms", &KernelRoofline::avg_ms)
+      .def_readonly("achieved_gflops", &KernelRoofline::achieved_gflops)
+      .def_readonly("achieved_gbytes_per_sec", &KernelRoofline::achieved_gbytes_per_sec)
+      .def_readonly("memory_bound", &KernelRoofline::memory_bound)
+      .def_readonly("bound_ratio", &KernelRoofline::bound_ratio);
+
+  py::class_<RooflineReport>(*m, "RooflineReport")
+      .def_readonly("peak", &RooflineReport::peak)
+      .def_readonly("kernels", &RooflineReport::kernels)
+      .def("to_string", &RooflineReport::ToString, py::arg("top_k") = 0)
+      .def("__str__", [](const RooflineReport &self) { return self.ToString(); });
+
+  py::class_<WeightOffloadOptions>(*m, "WeightOffloadOptions")
+      .def(py::init<>())
+      .def_readwrite("params", &WeightOffloadOptions::params)
+      .def_readwrite("threshold_bytes", &WeightOffloadOptions::threshold_bytes)
+      .def_readwrite("device_buffer_bytes", &WeightOffloadOptions::device_buffer_bytes)
+      .def_readwrite("spill_dir", &WeightOffloadOptions::spill_dir);
+
+  py::class_<MemoryEstimate>(*m, "MemoryEstimate")
+      .def_readonly("total_bytes", &MemoryEstimate::total_bytes)
+      .def_readonly("persistent_bytes", &MemoryEstimate::persistent_bytes)
+      .def_readonly("peak_intermediate_bytes", &MemoryEstimate::peak_intermediate_bytes)
+      .def_readonly("peak_step", &MemoryEstimate::peak_step)
+      .def_readonly("arena_bytes", &MemoryEstimate::arena_bytes)
+      .def_readonly("peak_bytes", &MemoryEstimate::peak_bytes);
+
+  py::class_<MemoryStats::InstructionAllocs>(*m, "InstructionAllocs")
+      .def_readonly("num_allocs", &MemoryStats::InstructionAllocs::num_allocs)
+      .def_readonly("bytes", &MemoryStats::InstructionAllocs::bytes);
+
+  py::class_<MemoryStats>(*m, "MemoryStats")
+      .def_readonly("live_bytes", &MemoryStats::live_bytes)
+      .def_readonly("peak_bytes", &MemoryStats::peak_bytes)
+      .def_readonly("num_allocs", &MemoryStats::num_allocs)
+      .def_readonly("num_frees", &MemoryStats::num_frees)
+      .def_readonly("reserved_bytes", &MemoryStats::reserved_bytes)
+      .def_readonly("fragmentation", &MemoryStats::fragmentation)
+      .def_readonly("instruction_allocs", &MemoryStats::instruction_allocs)
+      .def("__str__", &MemoryStats::DebugString);
+
+  m->def("get_memory_stats",
+         [](const common::Target &target) { return MemoryManager::Global().GetStats(target.arch); })
+      .def("reset_peak_memory_stats",
+           [](const common::Target &target) { MemoryManager::Global().ResetPeakStats(target.arch); });
+
+  py::class_<Program>(*m, "RuntimeProgram")
+      .def(
+          "execute", [](Program &self) { self.Execute(); }, py::call_guard<py::gil_scoped_release>())
+      .def("get_memory_estimate", &Program::GetMemoryEstimate)
+      .def("enable_profiling",
+           &Program::EnableProfiling,
+           py::arg("enable")           = true,
+           py::arg("collect_counters") = false)
+      .def("is_profiling", &Program::IsProfiling)
+      .def("get_profile_report", &Program::GetProfileReport)
+      .def("get_roofline_report", &Program::GetRooflineReport)
+      .def("reset_profile", &Program::ResetProfile)
+      .def("enable_weight_offload", &Program::EnableWeightOffload, py::arg("options"))
+      .def("disable_weight_offload", &Program::DisableWeightOffload)
+      .def("create_execution_context",
+           &Program::CreateExecutionContext,
+           py::arg("input_names"),
+           py::keep_alive<0, 1>());
+
+  py::class_<ExecutionContext>(*m, "ExecutionContext")
+      .def(
+          "execute", [](ExecutionContext &self) { self.Execute(); }, py::call_guard<py::gil_scoped_release>())
+      .def("get_tensor", &ExecutionContext::GetTensor)
+      .def("is_private", &ExecutionContext::IsPrivate);
+
   py::class_<common::Shared<hlir::framework::_Tensor_>>(*m, "SharedTensor");
-  py::class_<Tensor, common::Shared<hlir::framework::_Tensor_>>(*m, "Tensor")
+  py::class_<Tensor, common::Shared<hlir::framework::_Tensor_>>(*m, "Tensor", py::buffer_protocol())
       .def(py::init<>())
       .def("shape", [](hlir::framework::Tensor &self) { return self->shape().data(); })
       .def("set_type", [](hlir::framework::Tensor &self, Type type) { self->set_type(type); })
-      .def("numpy",
-           [](hlir::framework::Tensor &self, const common::Target &target) {
-             std::string type_str = common::Type2Str(self->type());
-             if (type_str == "bfloat16") {
-               type_str = "uint16";
-             }
-             py::dtype dt(type_str);
-             py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
-             py::array array(std::move(dt), std::move(shape));
-             void *array_data = array.mutable_data();
-             if (target.arch == Target::Arch::X86) {
-               std::memcpy(array_data, self->data<void>(), self->shape().numel() * self->type().bytes());
-             } else if (target.arch == Target::Arch::NVGPU) {
+      .def_buffer([](hlir::framework::Tensor &self) {
+        CHECK(self->get_buffer()->target().arch != Target::Arch::NVGPU && self->buffer()->memory)
+            << "Only the allocated tensor on host can be viewed by the buffer protocol";
+        py::dtype dt(GetNumpyTypeStr(self->type()));
+        std::vector<ssize_t> shape(self->shape().data().begin(), self->shape().data().end());
+        std::vector<ssize_t> strides(shape.size(), dt.itemsize());
+        for (int i = static_cast<int>(shape.size()) - 2; i >= 0; --i) {
+          strides[i] = strides[i + 1] * shape[i + 1];
+        }
+        return py::buffer_info(self->buffer()->memory,
+                               dt.itemsize(),
+                               py::str(dt.attr("char")).cast<std::string>(),
+                               shape.size(),
+                               shape,
+                               strides);
+      })
+      .def(
+          "numpy",
+          [](hlir::framework::Tensor &self, const common::Target &target, bool copy) {
+            py::dtype dt(GetNumpyTypeStr(self->type()));
+            py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
+            if (!copy) {
+              // the array is a view of the tensor on host, which keeps the tensor alive
+              CHECK(target.arch == Target::Arch::X86) << "Only the tensor on host can be viewed by numpy without copy";
+              return py::array(std::move(dt), std::move(shape), self->data<void>(), py::cast(self));
+            }
+            py::array array(std::move(dt), std::move(shape));
+            void *array_data = array.mutable_data();
+            if (target.arch == Target::Arch::X86) {
+              std::memcpy(array_data, self->data<void>(), self->shape().numel() * self->type().bytes());
+            } else if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
-               CUDA_CALL(cudaMemcpy(array_data,
-                                    self->data<void>(),
-                                    self->shape().numel() * self->type().bytes(),
-                                    cudaMemcpyDeviceToHost));
+              CUDA_CALL(cudaMemcpy(array_data,
+                                   self->data<void>(),
+                                   self->shape().numel() * self->type().bytes(),
+                                   cudaMemcpyDeviceToHost));
 #else
-               LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
+              LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
 #endif
-             } else {
-               CINN_NOT_IMPLEMENTED
-             }
-             return array;
-           })
-      .def("from_numpy", [](hlir::framework::Tensor &self, py::array array, const common::Target &target) {
-        CHECK(array.dtype().is(py::dtype(common::Type2Str(self->type()))))
-            << "currently only support float32 data type as input";
-        hlir::framework::shape_t shape;
-        std::copy_n(array.shape(), array.ndim(), std::back_inserter(shape));
-        CHECK_EQ(std::accumulate(shape.begin(), shape.end(), 1, [](int32_t a, int32_t b) { return a * b; }),
-                 self->shape().numel());
-        auto *data = self->mutable_data(target, self->type());
-        if (target.arch == Target::Arch::X86) {
-          std::memcpy(data, array.data(), self->shape().numel() * self->type().bytes());
-        } else if (target.arch == Target::Arch::NVGPU) {
+            } else {
+              CINN_NOT_IMPLEMENTED
+            }
+            return array;
+          },
+          py::arg("target"),
+          py::arg("copy") = true)
+      .def(
+          "from_numpy",
+          [](hlir::framework::Tensor &self, py::array array, const common::Target &target, bool copy) {
+            CHECK(array.dtype().is(py::dtype(common::Type2Str(self->type()))))
+                << "currently only support float32 data type as input";
+            hlir::framework::shape_t shape;
+            std::copy_n(array.shape(), array.ndim(), std::back_inserter(shape));
+            CHECK_EQ(std::accumulate(shape.begin(), shape.end(), 1, [](int32_t a, int32_t b) { return a * b; }),
+                     self->shape().numel());
+            if (!copy) {
+              // the tensor points to the memory of the array on host, which is kept alive by the tensor
+              CHECK(target.arch == Target::Arch::X86) << "Only the tensor on host can share the memory of numpy";
+              CHECK(array.flags() & py::array::c_style) << "Only the C-contiguous array can be shared";
+              std::shared_ptr<void> holder(new py::array(array), [](void *ptr) {
+                py::gil_scoped_acquire gil;
+                delete static_cast<py::array *>(ptr);
+              });
+              self->get_buffer()->SetExternalMemory(static_cast<uint8_t *>(array.mutable_data()),
+                                                    self->shape().numel() * self->type().bytes(),
+                                                    target,
+                                                    std::move(holder));
+              return;
+            }
+            auto *data = self->mutable_data(target, self->type());
+            if (target.arch == Target::Arch::X86) {
+              std::memcpy(data, array.data(), self->shape().numel() * self->type().bytes());
+            } else if (target.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
-          CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
-                               reinterpret_cast<const void *>(array.data()),
-                               self->shape().numel() * self->type().bytes(),
-                               cudaMemcpyHostToDevice));
+              CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(data),
+                                   reinterpret_cast<const void *>(array.data()),
+                                   self->shape().numel() * self->type().bytes(),
+                                   cudaMemcpyHostToDevice));
 #else
-               LOG(FATAL) <<"To use CUDA backends, you need to set WITH_CUDA ON!";
+              LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
 #endif
-        } else {
-          CINN_NOT_IMPLEMENTED
-        }
-      });
+            } else {
+              CINN_NOT_IMPLEMENTED
+            }
+          },
+          py::arg("array"),
+          py::arg("target"),
+          py::arg("copy") = true)
+      .def(
+          "__dlpack__",
+          [](hlir::framework::Tensor &self, const py::object &stream) { return ToDLPack(self); },
+          py::arg("stream") = py::none())
+      .def("__dlpack_device__",
+           [](hlir::framework::Tensor &self) {
+             auto device = ToDLDevice(self->get_buffer()->target());
+             return py::make_tuple(static_cast<int>(device.device_type), device.device_id);
+           })
+      .def("bind_dlpack", &BindDLPack, py::arg("obj"))
+      .def_static(
+          "from_dlpack",
+          [](const py::object &obj) {
+            Tensor tensor;
+            BindDLPack(tensor, obj);
+            return tensor;
+          },
+          py::arg("obj"));
 }
 }  // namespace cinn::pybind
@@ -18,9 +18,11 @@
 #include <pybind11/pybind11.h>
 
 #include "cinn/common/common.h"
+#include "cinn/frontend/bucketed_computation.h"
 #include "cinn/frontend/computation.h"
 #include "cinn/frontend/decomposer/use_decomposer.h"
 #include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/dynamic_batcher.h"
 #include "cinn/frontend/interpreter.h"
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/optimize.h"
@@ -63,6 +65,26 @@ static const char *SnakeName(const char *name) {
   return buf;
 }
 
+// The future of a request submitted to the DynamicBatcher from python, which holds the arrays of the request until the
+// request is done, even if the future is dropped before.
+class BatchFuture {
+ public:
+  BatchFuture(std::future<void> future, std::vector<py::array> arrays)
+      : future_(std::move(future)), arrays_(std::move(arrays)) {}
+  ~BatchFuture() { Wait(); }
+
+  bool Ready() const { return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+  // wait without the GIL, which the batch may need to compile a bucket by the python program builder
+  void Wait() const {
+    py::gil_scoped_release release;
+    future_.wait();
+  }
+
+ private:
+  std::future<void> future_;
+  std::vector<py::array> arrays_;
+};
+
 #define EXPAND_CINN_SUPPORT_TYPE(EXPAND_MACRO) \
   EXPAND_MACRO(bool)                           \
   EXPAND_MACRO(int64_t)                        \
@@ -76,6 +98,7 @@ void BindFrontend(pybind11::module *m) {
       .def("__repr__", [](Variable &self) { return utils::GetStreamCnt(self); })
       .def("id", [](Variable &self) { return self->id; })
       .def("name", [](Variable &self) { return self->id; })
+      .def("set_id", &Variable::set_id, py::arg("id"))
       .def("shape", [](Variable &self) { return self->shape; })
       .def("type", [](Variable &self) { return common::Type2Str(self->type); })
       .def("set_type",
@@ -177,18 +200,24 @@ void BindFrontend(pybind11::module *m) {
               }
             }
 
-            auto graph = Optimize(&self, fetch_ids, target, passes);
+            // the optimizing and compiling touch no python object, so the other python threads can run meanwhile
+            // the graph compiler owns the code of the program, so it lives until the program is executed
+            std::unique_ptr<hlir::framework::GraphCompiler> gc;
+            std::unique_ptr<hlir::framework::Program> program;
+            {
+              py::gil_scoped_release release;
+              auto graph = Optimize(&self, fetch_ids, target, passes);
 
-            scope = hlir::framework::BuildScope(target, graph, scope);
-            hlir::framework::GraphCompiler gc(target, scope, graph);
+              scope = hlir::framework::BuildScope(target, graph, scope);
+              gc    = std::make_unique<hlir::framework::GraphCompiler>(target, scope, graph);
 
-            // Keep compile option same as paddle
-            hlir::framework::GraphCompiler::CompileOptions options;
-            options.with_instantiate_variables = true;
-            options.remove_unused_variables    = false;
-            auto gc_fetch_ids                  = fetch_ids;
-            const auto &result                 = gc.Build(options, std::move(gc_fetch_ids));
-            const auto &program                = result.runtime_program;
+              // Keep compile option same as paddle
+              hlir::framework::GraphCompiler::CompileOptions options;
+              options.with_instantiate_variables = true;
+              options.remove_unused_variables    = false;
+              auto gc_fetch_ids                  = fetch_ids;
+              program                            = gc->Build(options, std::move(gc_fetch_ids)).runtime_program;
+            }
 
             for (size_t i = 0; i < tensor_inputs.size(); i++) {
               auto in_tensor = scope->GetTensor(tensor_inputs[i]->id);
@@ -211,7 +240,10 @@ void BindFrontend(pybind11::module *m) {
                 CINN_NOT_IMPLEMENTED
               }
             }
-            program->Execute();
+            {
+              py::gil_scoped_release release;
+              program->Execute();
+            }
 
             std::vector<hlir::framework::Tensor> outputs;
             for (size_t i = 0; i < tensor_outputs.size(); i++) {
@@ -239,7 +271,8 @@ void BindFrontend(pybind11::module *m) {
               const std::vector<std::string> &passes = {}) {
              auto graph = Optimize(&self, fetch_ids, target, passes);
              return graph->fusion_groups.size();
-           })
+           },
+           py::call_guard<py::gil_scoped_release>())
 
       /**
        * @brief Test the performance of a single-op program
@@ -367,11 +400,15 @@ void BindFrontend(pybind11::module *m) {
            py::arg("model_dir"),
            py::arg("target"),
            py::arg("params_combined"),
-           py::arg("model_name") = "")
-      .def("run", &frontend::Interpreter::Run)
+           py::arg("model_name") = "",
+           py::call_guard<py::gil_scoped_release>())
+      .def("run", &frontend::Interpreter::Run, py::call_guard<py::gil_scoped_release>())
       .def("get_tensor", &frontend::Interpreter::GetTensor)
       .def("get_program", &frontend::Interpreter::GetProgram)
-      .def("get_scope", &frontend::Interpreter::GetScope);
+      .def("get_scope", &frontend::Interpreter::GetScope)
+      .def("get_runtime_program",
+           &frontend::Interpreter::GetRuntimeProgram,
+           py::return_value_policy::reference_internal);
 
   py::class_<NetBuilder, std::shared_ptr<NetBuilder>>(*m, "NetBuilder")
       .def(py::init<const std::string &>(), py::arg("name") = "")
@@ -465,7 +502,7 @@ void BindFrontend(pybind11::module *m) {
           py::arg("shape"),
           py::arg("id_hint"))
       .def("create_input", static_cast<Placeholder (NetBuilder::*)(const Variable &)>(&NetBuilder::CreateInput))
-      .def("build", &NetBuilder::Build, py::arg("in_reverse") = false)
+      .def("build", &NetBuilder::Build, py::arg("in_reverse") = false, py::call_guard<py::gil_scoped_release>())
       .def("name", &NetBuilder::name)
       .def("__str__", [](NetBuilder &self) { return self.name(); })
       .def("append_instruction", &NetBuilder::AppendInstruction, py::arg("instr"))
@@ -492,8 +529,45 @@ void BindFrontend(pybind11::module *m) {
       .def("reshape", &NetBuilder::Reshape, py::arg("x"), py::arg("shape"))
       .def("transpose", &NetBuilder::Transpose, py::arg("x"), py::arg("axis"))
       .def("top_k", &NetBuilder::TopK, py::arg("x"), py::arg("k"), py::arg("axis"), py::arg("largest"))
+      .def("all_reduce",
+           &NetBuilder::AllReduce,
+           py::arg("x"),
+           py::arg("reduce_type")     = "sum",
+           py::arg("ring_id")         = 0,
+           py::arg("use_calc_stream") = true)
+      .def("all_gather",
+           &NetBuilder::AllGather,
+           py::arg("x"),
+           py::arg("nranks"),
+           py::arg("ring_id")         = 0,
+           py::arg("use_calc_stream") = true)
+      .def("reduce_scatter",
+           &NetBuilder::ReduceScatter,
+           py::arg("x"),
+           py::arg("nranks"),
+           py::arg("reduce_type")     = "sum",
+           py::arg("ring_id")         = 0,
+           py::arg("use_calc_stream") = true)
       .def("sort", &NetBuilder::Sort, py::arg("operand"), py::arg("axis"), py::arg("is_ascend"))
       .def("argsort", &NetBuilder::ArgSort, py::arg("operand"), py::arg("axis"), py::arg("is_ascend"))
+      .def("cumsum",
+           &NetBuilder::Cumsum,
+           py::arg("x"),
+           py::arg("axis")      = -1,
+           py::arg("exclusive") = false,
+           py::arg("reverse")   = false)
+      .def("cumprod",
+           &NetBuilder::Cumprod,
+           py::arg("x"),
+           py::arg("axis")      = -1,
+           py::arg("exclusive") = false,
+           py::arg("reverse")   = false)
+      .def("cummax",
+           &NetBuilder::Cummax,
+           py::arg("x"),
+           py::arg("axis")      = -1,
+           py::arg("exclusive") = false,
+           py::arg("reverse")   = false)
       .def("slice",
            &NetBuilder::Slice,
            py::arg("x"),
@@ -504,7 +578,12 @@ void BindFrontend(pybind11::module *m) {
            py::arg("strides")       = std::vector<int>{},
            py::arg("decrease_axis") = std::vector<int>{})
       .def("reverse", &NetBuilder::Reverse, py::arg("x"), py::arg("axis"))
-      .def("resize", &NetBuilder::Resize, py::arg("x"), py::arg("out_shape"), py::arg("mode") = "bilinear")
+      .def("resize",
+           &NetBuilder::Resize,
+           py::arg("x"),
+           py::arg("out_shape"),
+           py::arg("mode")        = "bilinear",
+           py::arg("data_format") = "NCHW")
       .def("select", &NetBuilder::Select, py::arg("condition"), py::arg("true_value"), py::arg("false_value"))
       .def("split", &NetBuilder::Split, py::arg("x"), py::arg("num_or_sections"), py::arg("axis") = 0)
       .def("gather", &NetBuilder::Gather, py::arg("x"), py::arg("index"), py::arg("axis") = 0)
@@ -631,6 +710,51 @@ void BindFrontend(pybind11::module *m) {
            py::arg("save_variance"),
            py::arg("epsilon")     = 1e-5,
            py::arg("data_layout") = "NCHW")
+      .def("layer_norm",
+           &NetBuilder::LayerNorm,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("bias"),
+           py::arg("epsilon")         = 1e-5f,
+           py::arg("begin_norm_axis") = 1)
+      .def("layer_norm_grad",
+           &NetBuilder::LayerNormGrad,
+           py::arg("dy"),
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("mean"),
+           py::arg("variance"),
+           py::arg("epsilon")         = 1e-5f,
+           py::arg("begin_norm_axis") = 1)
+      .def("rms_norm",
+           &NetBuilder::RMSNorm,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("epsilon")         = 1e-6f,
+           py::arg("begin_norm_axis") = -1)
+      .def("rms_norm_grad",
+           &NetBuilder::RMSNormGrad,
+           py::arg("dy"),
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("inv_rms"),
+           py::arg("begin_norm_axis") = -1)
+      .def("kv_cache_append",
+           &NetBuilder::KVCacheAppend,
+           py::arg("key_cache"),
+           py::arg("value_cache"),
+           py::arg("block_tables"),
+           py::arg("context_lens"),
+           py::arg("key"),
+           py::arg("value"))
+      .def("paged_attention",
+           &NetBuilder::PagedAttention,
+           py::arg("query"),
+           py::arg("key_cache"),
+           py::arg("value_cache"),
+           py::arg("block_tables"),
+           py::arg("context_lens"),
+           py::arg("scale") = 0.0f)
       .def("scale",
            &NetBuilder::Scale,
            py::arg("x"),
@@ -643,11 +767,45 @@ void BindFrontend(pybind11::module *m) {
            py::arg("axes")        = std::vector<int>{-1},
            py::arg("mode")        = "fast",
            py::arg("data_format") = "AnyLayout")
+      .def("softmax_cross_entropy",
+           &NetBuilder::SoftmaxCrossEntropy,
+           py::arg("logits"),
+           py::arg("label"),
+           py::arg("ignore_index") = -100)
       .def("dropout_infer",
            &NetBuilder::DropoutInfer,
            py::arg("x"),
            py::arg("dropout_prob")           = 0.5f,
            py::arg("dropout_implementation") = "downgrade_in_infer")
+      .def("dropout",
+           &NetBuilder::Dropout,
+           py::arg("x"),
+           py::arg("dropout_prob")           = 0.5f,
+           py::arg("dropout_implementation") = "downgrade_in_infer",
+           py::arg("seed")                   = 0)
+      .def("quantize_linear",
+           &NetBuilder::QuantizeLinear,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("quant_axis") = -1,
+           py::arg("bit_length") = 8)
+      .def("dequantize_linear",
+           &NetBuilder::DequantizeLinear,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("quant_axis") = -1,
+           py::arg("bit_length") = 8)
+      .def("fp8_matmul",
+           &NetBuilder::Fp8Matmul,
+           py::arg("x"),
+           py::arg("y"),
+           py::arg("x_scale"),
+           py::arg("y_scale"),
+           py::arg("out_dtype") = "bfloat16",
+           py::arg("alpha")     = 1.0f)
+      .def("sparse_matmul", &NetBuilder::SparseMatmul, py::arg("x"), py::arg("w"), py::arg("alpha") = 1.0f)
+      .def("csr_spmm", &NetBuilder::CsrSpmm, py::arg("crows"), py::arg("cols"), py::arg("values"), py::arg("dense"))
+      .def("sddmm", &NetBuilder::Sddmm, py::arg("rows"), py::arg("cols"), py::arg("x"), py::arg("y"))
       .def("relu_grad", &NetBuilder::ReluGrad, py::arg("dout"), py::arg("x"))
       .def("sum", &NetBuilder::Sum, py::arg("inputs"))
       .def("matmul",
@@ -671,6 +829,8 @@ void BindFrontend(pybind11::module *m) {
            py::arg("output_shape")      = std::vector<int>{})
       .def("cast", &NetBuilder::Cast, py::arg("x"), py::arg("dtype"))
       .def("bitcast_convert", &NetBuilder::BitcastConvert, py::arg("x"), py::arg("dtype"))
+      .def("pack_mask", &NetBuilder::PackMask, py::arg("x"))
+      .def("unpack_mask", &NetBuilder::UnpackMask, py::arg("words"), py::arg("size"))
       .def("arange", &NetBuilder::Arange, py::arg("start"), py::arg("stop"), py::arg("step"), py::arg("dtype"))
       .def("gather_nd", &NetBuilder::GatherNd, py::arg("x"), py::arg("index"))
       .def("cbrt", &NetBuilder::Cbrt, py::arg("x"))
@@ -694,6 +854,13 @@ void BindFrontend(pybind11::module *m) {
            py::arg("diag_num")  = 0,
            py::arg("diag_step") = 0,
            py::arg("diag_val")  = 1.0f)
+      .def("philox_uniform",
+           &NetBuilder::PhiloxUniform,
+           py::arg("shape"),
+           py::arg("min")   = 0.0f,
+           py::arg("max")   = 1.0f,
+           py::arg("seed")  = 0,
+           py::arg("dtype") = "float32")
       .def("randint",
            &NetBuilder::RandInt,
            py::arg("shape"),
@@ -723,6 +890,7 @@ void BindFrontend(pybind11::module *m) {
   computation
       .def("default_compile_options", &CinnComputation::DefaultCompileOptions)
       // currently stream param is not exported to python, the default stream is used always
+      // the GIL is released while compiling and executing, which touch no python object
       .def_static(
           "build_and_compile",
           [](const common::Target &target, NetBuilder &builder, const CinnComputation::CompileOptions &options) {
@@ -730,7 +898,8 @@ void BindFrontend(pybind11::module *m) {
           },
           py::arg("target"),
           py::arg("builder"),
-          py::arg("options") = CinnComputation::DefaultCompileOptions())
+          py::arg("options") = CinnComputation::DefaultCompileOptions(),
+          py::call_guard<py::gil_scoped_release>())
       .def_static(
           "compile",
           [](const common::Target &target, Program &program, const CinnComputation::CompileOptions &options) {
@@ -738,7 +907,8 @@ void BindFrontend(pybind11::module *m) {
           },
           py::arg("target"),
           py::arg("program"),
-          py::arg("options") = CinnComputation::DefaultCompileOptions())
+          py::arg("options") = CinnComputation::DefaultCompileOptions(),
+          py::call_guard<py::gil_scoped_release>())
       .def_static(
           "compile_paddle_model",
           [](const common::Target &target,
@@ -755,10 +925,96 @@ void BindFrontend(pybind11::module *m) {
           py::arg("input_names"),
           py::arg("input_shapes"),
           py::arg("params_combined"),
-          py::arg("options") = CinnComputation::DefaultCompileOptions())
+          py::arg("options") = CinnComputation::DefaultCompileOptions(),
+          py::call_guard<py::gil_scoped_release>())
       .def("get_all_tensor_names", &CinnComputation::GetAllTensorNames)
-      .def("get_tensor", &CinnComputation::GetTensor)
-      .def("execute", [](CinnComputation &self) { self.Execute(); });
+      .def("get_memory_estimate", &CinnComputation::GetMemoryEstimate)
+      .def("get_tensor", py::overload_cast<const std::string &>(&CinnComputation::GetTensor))
+      .def("create_execution_context", &CinnComputation::CreateExecutionContext, py::keep_alive<0, 1>())
+      .def("execute", [](CinnComputation &self) { self.Execute(); }, py::call_guard<py::gil_scoped_release>());
+
+  auto bucketed_computation =
+      py::class_<BucketedComputation, std::shared_ptr<BucketedComputation>>(*m, "BucketedComputation");
+  py::class_<BucketedComputation::Config>(bucketed_computation, "Config")
+      .def(py::init<>())
+      .def_readwrite("min_size", &BucketedComputation::Config::min_size)
+      .def_readwrite("max_size", &BucketedComputation::Config::max_size)
+      .def_readwrite("dynamic_axes", &BucketedComputation::Config::dynamic_axes)
+      .def_readwrite("specialized_sizes", &BucketedComputation::Config::specialized_sizes)
+      .def_readwrite("compile_in_background", &BucketedComputation::Config::compile_in_background)
+      .def_readwrite("num_hot_sizes", &BucketedComputation::Config::num_hot_sizes)
+      .def_readwrite("hot_size_min_runs", &BucketedComputation::Config::hot_size_min_runs);
+
+  bucketed_computation
+      // the builder is a python function of the bucket size returning the Program, the GIL is acquired to call it, so
+      // it is released on destruction to join the background compilation
+      .def(py::init([](const common::Target &target,
+                       BucketedComputation::ProgramBuilder builder,
+                       const BucketedComputation::Config &config,
+                       const CinnComputation::CompileOptions &options) {
+             return std::shared_ptr<BucketedComputation>(
+                 new BucketedComputation(target, std::move(builder), config, options),
+                 [](BucketedComputation *computation) {
+                   py::gil_scoped_release release;
+                   delete computation;
+                 });
+           }),
+           py::arg("target"),
+           py::arg("builder"),
+           py::arg("config"),
+           py::arg("options") = CinnComputation::DefaultCompileOptions())
+      .def("buckets", &BucketedComputation::Buckets)
+      .def("find_bucket", &BucketedComputation::FindBucket, py::arg("size"))
+      .def("precompile", &BucketedComputation::Precompile, py::arg("size"), py::call_guard<py::gil_scoped_release>());
+
+  py::class_<BatchFuture, std::shared_ptr<BatchFuture>>(*m, "BatchFuture")
+      .def("ready", &BatchFuture::Ready)
+      .def("wait", &BatchFuture::Wait);
+
+  auto dynamic_batcher = py::class_<DynamicBatcher, std::shared_ptr<DynamicBatcher>>(*m, "DynamicBatcher");
+  py::class_<DynamicBatcher::Config>(dynamic_batcher, "Config")
+      .def(py::init<>())
+      .def_readwrite("max_batch_size", &DynamicBatcher::Config::max_batch_size)
+      .def_readwrite("max_delay_us", &DynamicBatcher::Config::max_delay_us)
+      .def_readwrite("output_axes", &DynamicBatcher::Config::output_axes);
+
+  dynamic_batcher
+      // the queued requests are drained on destruction without the GIL, as they may call the python program builder
+      .def(py::init([](std::shared_ptr<BucketedComputation> computation, const DynamicBatcher::Config &config) {
+             return std::shared_ptr<DynamicBatcher>(new DynamicBatcher(std::move(computation), config),
+                                                    [](DynamicBatcher *batcher) {
+                                                      py::gil_scoped_release release;
+                                                      delete batcher;
+                                                    });
+           }),
+           py::arg("computation"),
+           py::arg("config"))
+      // the inputs and the outputs are C-contiguous numpy arrays, the outputs are written once the future is ready
+      .def(
+          "submit",
+          [](DynamicBatcher &self,
+             const std::map<std::string, py::array> &inputs,
+             const std::map<std::string, py::array> &outputs,
+             int size) {
+            std::map<std::string, const void *> input_data;
+            std::map<std::string, void *> output_data;
+            std::vector<py::array> arrays;
+            for (auto &item : inputs) {
+              CHECK(item.second.flags() & py::array::c_style) << "The input " << item.first << " is not C-contiguous";
+              input_data[item.first] = item.second.data();
+              arrays.push_back(item.second);
+            }
+            for (auto &item : outputs) {
+              CHECK(item.second.flags() & py::array::c_style) << "The output " << item.first << " is not C-contiguous";
+              output_data[item.first] = const_cast<py::array &>(item.second).mutable_data();
+              arrays.push_back(item.second);
+            }
+            return std::make_shared<BatchFuture>(self.Submit(input_data, output_data, size), std::move(arrays));
+          },
+          py::arg("inputs"),
+          py::arg("outputs"),
+          py::arg("size") = 1)
+      .def("num_batches", &DynamicBatcher::NumBatches);
 
   py::class_<PaddleModelConvertor>(*m, "PaddleModelConvertor")
       .def(py::init<>())
@@ -23,6 +23,7 @@
 
 #include "cinn/pybind/bind.h"
 #include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/nccl_util.h"
 #include "cinn/runtime/flags.h"
 
 namespace py = pybind11;
@@ -269,6 +270,27 @@ void BindCinnRuntime(py::module *m) {
   m->def("set_cinn_cudnn_deterministic", &cinn::runtime::SetCinnCudnnDeterministic, py::arg("state") = true);
   m->def("seed", &cinn::runtime::RandomSeed::GetOrSet, py::arg("seed") = 0);
   m->def("clear_seed", &cinn::runtime::RandomSeed::Clear);
+
+#ifdef CINN_WITH_NCCL
+  using cinn::runtime::cuda::NcclCommContext;
+  m->def("gen_nccl_unique_id", []() { return py::bytes(NcclCommContext::GenUniqueId()); });
+  m->def(
+      "init_nccl_comm",
+      [](int ring_id, int nranks, int rank, const py::bytes &unique_id) {
+        NcclCommContext::Global().Init(ring_id, nranks, rank, unique_id);
+      },
+      py::arg("ring_id"),
+      py::arg("nranks"),
+      py::arg("rank"),
+      py::arg("unique_id"));
+  m->def(
+      "init_nccl_comm_all",
+      [](int ring_id, const std::vector<int> &device_ids) { NcclCommContext::Global().InitAll(ring_id, device_ids); },
+      py::arg("ring_id"),
+      py::arg("device_ids"));
+  m->def(
+      "destroy_nccl_comm", [](int ring_id) { NcclCommContext::Global().Destroy(ring_id); }, py::arg("ring_id"));
+#endif
 }
 }  // namespace
 
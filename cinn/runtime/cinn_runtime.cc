@@ -134,6 +134,8 @@ cinn_type_t cinn_uint64_t(int num_asterisks) { return cinn_type_t(cinn_type_uint
 
 cinn_type_t cinn_bfloat16_t(int num_asterisks) { return cinn_type_t(cinn_type_bfloat, 16, num_asterisks); }
 cinn_type_t cinn_float16_t(int num_asterisks) { return cinn_type_t(cinn_type_float, 16, num_asterisks); }
+cinn_type_t cinn_float8_e4m3_t(int num_asterisks) { return cinn_type_t(cinn_type_e4m3, 8, num_asterisks); }
+cinn_type_t cinn_float8_e5m2_t(int num_asterisks) { return cinn_type_t(cinn_type_e5m2, 8, num_asterisks); }
 cinn_type_t cinn_float32_t(int num_asterisks) { return cinn_type_t(cinn_type_float, 32, num_asterisks); }
 cinn_type_t cinn_float64_t(int num_asterisks) { return cinn_type_t(cinn_type_float, 64, num_asterisks); }
 
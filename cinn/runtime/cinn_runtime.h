@@ -54,13 +54,19 @@ typedef enum cinn_type_code_t {
   cinn_type_uint   = 1,   //! unsigned int
   cinn_type_float  = 2,   //! floating point
   cinn_type_handle = 3,   //! void*
-  cinn_type_bfloat = 4    //! bfloat16
+  cinn_type_bfloat = 4,   //! bfloat16
+  cinn_type_e4m3   = 5,   //! float8 with 4 exponent bits and 3 mantissa bits
+  cinn_type_e5m2   = 6    //! float8 with 5 exponent bits and 2 mantissa bits
 } cinn_type_code_t;
 
 #ifndef CINN_ATTRIBUTE_ALIGN
 #define CINN_ATTRIBUTE_ALIGN(n) __attribute__((aligned(n)))
 #endif
 
+//! The alignment in bytes of the memory of the buffers passed to the generated kernels, which the allocators, the
+//! memory plan and the concat slices all keep, so the kernels can assume it for the vectorized accesses.
+#define CINN_BUFFER_ALIGNMENT 16
+
 /**
  * A runtime tag for type in CINN system.
  */
@@ -109,6 +115,8 @@ extern cinn_type_t cinn_uint64_t(int num_asterisks = 0);
 
 extern cinn_type_t cinn_bfloat16_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float16_t(int num_asterisks = 0);
+extern cinn_type_t cinn_float8_e4m3_t(int num_asterisks = 0);
+extern cinn_type_t cinn_float8_e5m2_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float64_t(int num_asterisks = 0);
 // @}
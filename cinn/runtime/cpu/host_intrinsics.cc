@@ -14,13 +14,23 @@
 
 #include "cinn/runtime/cpu/host_intrinsics.h"
 
-#include <glog/logging.h>
 #include <math.h>
 
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// the deploy runtime takes the intrinsics only, their registration to the compiler is left out
+#ifndef CINN_DEPLOY_RUNTIME
+#include <glog/logging.h>
+
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
 #include "cinn/common/target.h"
 #include "cinn/runtime/custom_function.h"
+#endif
 
 #ifdef CINN_WITH_MKL_CBLAS
 #include "cinn/runtime/cpu/mkl_math.h"
@@ -46,25 +56,25 @@ void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out) {
     return -1;                                                                         \
   } while (0)
 
-inline int cinn_host_find_int(const cinn_buffer_t* buf, int size, int num) {
+int cinn_host_find_int(const cinn_buffer_t* buf, int size, int num) {
   __cinn_host_find_kernel(buf, size, num, int, 0, 1);
 }
 
-inline int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num) {
+int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num) {
   __cinn_host_find_kernel(buf, size, num, float, 0, 1);
 }
 
-inline int cinn_host_find_int_nd(const cinn_buffer_t* buf, int size, int num, int begin, int stride) {
+int cinn_host_find_int_nd(const cinn_buffer_t* buf, int size, int num, int begin, int stride) {
   __cinn_host_find_kernel(buf, size, num, int, begin, stride);
 }
 
-inline int cinn_host_find_float_nd(const cinn_buffer_t* buf, int size, float num, int begin, int stride) {
+int cinn_host_find_float_nd(const cinn_buffer_t* buf, int size, float num, int begin, int stride) {
   __cinn_host_find_kernel(buf, size, num, float, begin, stride);
 }
 
 #undef __cinn_host_find_kernel
 
-inline int cinn_host_next_smallest_int32(cinn_buffer_t* buf, int size, int num, int begin, int stride) {
+int cinn_host_next_smallest_int32(cinn_buffer_t* buf, int size, int num, int begin, int stride) {
   int id = -1;
   for (int i = begin; i < begin + size * stride; i += stride) {
     if (id == -1 || reinterpret_cast<int*>(buf->memory)[i] < reinterpret_cast<int*>(buf->memory)[id]) {
@@ -79,7 +89,7 @@ inline int cinn_host_next_smallest_int32(cinn_buffer_t* buf, int size, int num,
 }
 
 #define CINN_HOST_LT_NUM(TYPE_SUFFIX, TYPE)                                                           \
-  inline int cinn_host_lt_num_##TYPE_SUFFIX(                                                          \
+  int cinn_host_lt_num_##TYPE_SUFFIX(                                                                 \
       const cinn_buffer_t* buf, const int size, const TYPE num, const int offset, const int stride) { \
     int out = 0;                                                                                      \
     for (int i = (size - 1) * stride + offset; i >= offset; i -= stride) {                            \
@@ -96,7 +106,7 @@ CINN_HOST_LT_NUM(int64, int64_t)
 #undef CINN_HOST_LT_NUM
 
 #define CINN_HOST_GT_NUM(TYPE_SUFFIX, TYPE)                                                           \
-  inline int cinn_host_gt_num_##TYPE_SUFFIX(                                                          \
+  int cinn_host_gt_num_##TYPE_SUFFIX(                                                                 \
       const cinn_buffer_t* buf, const int size, const TYPE num, const int offset, const int stride) { \
     int out = 0;                                                                                      \
     for (int i = (size - 1) * stride + offset; i >= offset; i -= stride) {                            \
@@ -112,6 +122,53 @@ CINN_HOST_GT_NUM(int64, int64_t)
 
 #undef CINN_HOST_GT_NUM
 
+#define CINN_HOST_CSR_SPMM(TYPE_SUFFIX, TYPE)                              \
+  TYPE cinn_host_csr_spmm_##TYPE_SUFFIX(const cinn_buffer_t* crows,        \
+                                        const cinn_buffer_t* cols,         \
+                                        const cinn_buffer_t* values,       \
+                                        const cinn_buffer_t* dense,        \
+                                        const int row,                     \
+                                        const int col,                     \
+                                        const int n) {                     \
+    const int* crows_ptr  = reinterpret_cast<const int*>(crows->memory);   \
+    const int* cols_ptr   = reinterpret_cast<const int*>(cols->memory);    \
+    const TYPE* value_ptr = reinterpret_cast<const TYPE*>(values->memory); \
+    const TYPE* dense_ptr = reinterpret_cast<const TYPE*>(dense->memory);  \
+    TYPE res              = 0;                                             \
+    for (int p = crows_ptr[row]; p < crows_ptr[row + 1]; ++p) {            \
+      res += value_ptr[p] * dense_ptr[cols_ptr[p] * n + col];              \
+    }                                                                      \
+    return res;                                                            \
+  }
+
+CINN_HOST_CSR_SPMM(fp32, float)
+CINN_HOST_CSR_SPMM(fp64, double)
+
+#undef CINN_HOST_CSR_SPMM
+
+#define CINN_HOST_SDDMM(TYPE_SUFFIX, TYPE)                                  \
+  TYPE cinn_host_sddmm_##TYPE_SUFFIX(const cinn_buffer_t* rows,             \
+                                     const cinn_buffer_t* cols,             \
+                                     const cinn_buffer_t* x,                \
+                                     const cinn_buffer_t* y,                \
+                                     const int p,                           \
+                                     const int k) {                         \
+    const int row     = reinterpret_cast<const int*>(rows->memory)[p];      \
+    const int col     = reinterpret_cast<const int*>(cols->memory)[p];      \
+    const TYPE* x_row = reinterpret_cast<const TYPE*>(x->memory) + row * k; \
+    const TYPE* y_row = reinterpret_cast<const TYPE*>(y->memory) + col * k; \
+    TYPE res          = 0;                                                  \
+    for (int i = 0; i < k; ++i) {                                           \
+      res += x_row[i] * y_row[i];                                           \
+    }                                                                       \
+    return res;                                                             \
+  }
+
+CINN_HOST_SDDMM(fp32, float)
+CINN_HOST_SDDMM(fp64, double)
+
+#undef CINN_HOST_SDDMM
+
 int cinn_host_resize_bilinear(const cinn_buffer_t* buf,
                               const int c_size,
                               const int in_h,
@@ -215,50 +272,147 @@ int cinn_host_resize_bicubic(const cinn_buffer_t* buf,
 
 #define FN_FP32(func) cinn_host_##func##_fp32
 
-inline float FN_FP32(cbrt)(float x) { return cbrt(x); }
+float FN_FP32(cbrt)(float x) { return cbrt(x); }
 
-inline float FN_FP32(pow)(float x, float y) { return powf(x, y); }
+float FN_FP32(pow)(float x, float y) { return powf(x, y); }
 
 #undef FN_FP32
 
 #define FN_FP64(func) cinn_host_##func##_fp64
 
-inline double FN_FP64(cbrt)(double x) { return cbrt(x); }
+double FN_FP64(cbrt)(double x) { return cbrt(x); }
 
-inline double FN_FP64(pow)(double x, double y) { return pow(x, y); }
+double FN_FP64(pow)(double x, double y) { return pow(x, y); }
 
 #undef FN_FP64
 
 #define FN_INT32(func) cinn_host_##func##_int32
 
-inline int FN_INT32(pow)(int x, int y) {
+int FN_INT32(pow)(int x, int y) {
   if (x == 0 && y < 0) {
     return -1;
   }
   return pow(x, y);
 }
 
-inline int FN_INT32(clz)(int x) { return __builtin_clz(x); }
+int FN_INT32(clz)(int x) { return __builtin_clz(x); }
 
-inline int FN_INT32(popc)(int x) { return __builtin_popcount(x); }
+int FN_INT32(popc)(int x) { return __builtin_popcount(x); }
 
-inline int FN_INT32(logical_right_shift)(int x, int y) { return ((unsigned int)x >> y); }
+int FN_INT32(logical_right_shift)(int x, int y) { return ((unsigned int)x >> y); }
 
 #undef FN_INT32
 
 #define FN_INT64(func) cinn_host_##func##_int64
 
-inline int64_t FN_INT64(clz)(int64_t x) { return __builtin_clzll(x); }
+int64_t FN_INT64(clz)(int64_t x) { return __builtin_clzll(x); }
 
-inline int64_t FN_INT64(popc)(int64_t x) { return __builtin_popcountll(x); }
+int64_t FN_INT64(popc)(int64_t x) { return __builtin_popcountll(x); }
 
-inline int64_t FN_INT64(pow)(int64_t x, int64_t y) { return pow(x, y); }
+int64_t FN_INT64(pow)(int64_t x, int64_t y) { return pow(x, y); }
 
-inline int64_t FN_INT64(logical_right_shift)(int64_t x, int64_t y) { return ((uint64_t)x >> y); }
+int64_t FN_INT64(logical_right_shift)(int64_t x, int64_t y) { return ((uint64_t)x >> y); }
 
 #undef FN_INT64
+
+namespace {
+
+// the first two of the four 32-bit outputs of Philox4x32-10 with the key seed and the counter offset
+inline uint64_t PhiloxBits(int64_t seed, int64_t offset) {
+  uint32_t key[2] = {static_cast<uint32_t>(seed), static_cast<uint32_t>(static_cast<uint64_t>(seed) >> 32)};
+  uint32_t ctr[4] = {static_cast<uint32_t>(offset), static_cast<uint32_t>(static_cast<uint64_t>(offset) >> 32), 0U, 0U};
+  for (int i = 0; i < 10; ++i) {
+    uint64_t prod0 = static_cast<uint64_t>(0xD2511F53U) * ctr[0];
+    uint64_t prod1 = static_cast<uint64_t>(0xCD9E8D57U) * ctr[2];
+    ctr[0]         = static_cast<uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0];
+    ctr[1]         = static_cast<uint32_t>(prod1);
+    ctr[2]         = static_cast<uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1];
+    ctr[3]         = static_cast<uint32_t>(prod0);
+    key[0] += 0x9E3779B9U;
+    key[1] += 0xBB67AE85U;
+  }
+  return (static_cast<uint64_t>(ctr[0]) << 32) | ctr[1];
+}
+
+}  // namespace
+
+float cinn_host_philox_uniform_fp32(int64_t seed, int64_t offset) {
+  return (PhiloxBits(seed, offset) >> 40) * 5.9604644775390625e-08F;
+}
+
+double cinn_host_philox_uniform_fp64(int64_t seed, int64_t offset) {
+  return (PhiloxBits(seed, offset) >> 11) * 1.1102230246251565e-16;
+}
+
+namespace {
+
+constexpr int kVNNITile = 16;
+
+void VNNITileGeneric(int32_t* c, const int8_t* a, const int8_t* b, int lda, int ldb, int ldc, bool init) {
+  for (int i = 0; i < kVNNITile; ++i) {
+    for (int j = 0; j < kVNNITile; ++j) {
+      int32_t acc = init ? 0 : c[i * ldc + j];
+      for (int k = 0; k < kVNNITile; ++k) {
+        acc += static_cast<int32_t>(a[i * lda + k]) * static_cast<int32_t>(b[k * ldb + j]);
+      }
+      c[i * ldc + j] = acc;
+    }
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// vpdpbusd multiplies the unsigned bytes by the signed ones, so A is shifted by 128 into uint8, and the shift is
+// compensated by 128 times the sums of the columns of B
+__attribute__((target("avx512f,avx512vnni"))) void VNNITileAVX512(
+    int32_t* c, const int8_t* a, const int8_t* b, int lda, int ldb, int ldc, bool init) {
+  constexpr int kGroupK = 4;
+  // each vector holds the groups of 4 along K of the 16 columns
+  __m512i b_groups[kVNNITile / kGroupK];
+  __m512i compensation = _mm512_setzero_si512();
+  for (int g = 0; g < kVNNITile / kGroupK; ++g) {
+    alignas(64) int8_t packed[kVNNITile * kGroupK];
+    for (int j = 0; j < kVNNITile; ++j) {
+      for (int t = 0; t < kGroupK; ++t) packed[j * kGroupK + t] = b[(g * kGroupK + t) * ldb + j];
+    }
+    b_groups[g]  = _mm512_load_si512(packed);
+    compensation = _mm512_dpbusd_epi32(compensation, _mm512_set1_epi8(static_cast<char>(0x80)), b_groups[g]);
+  }
+  const __m512i shift = _mm512_set1_epi8(static_cast<char>(0x80));
+  for (int i = 0; i < kVNNITile; ++i) {
+    __m512i acc = init ? _mm512_setzero_si512() : _mm512_loadu_si512(c + i * ldc);
+    acc         = _mm512_sub_epi32(acc, compensation);
+    for (int g = 0; g < kVNNITile / kGroupK; ++g) {
+      int32_t group;
+      std::memcpy(&group, a + i * lda + g * kGroupK, sizeof(group));
+      __m512i a_group = _mm512_xor_si512(_mm512_set1_epi32(group), shift);
+      acc             = _mm512_dpbusd_epi32(acc, a_group, b_groups[g]);
+    }
+    _mm512_storeu_si512(c + i * ldc, acc);
+  }
+}
+#endif
+
+}  // namespace
+
+void cinn_host_vnni_m16n16k16_s8s8s32(
+    int32_t* c, const int8_t* a, const int8_t* b, int lda, int ldb, int ldc, bool init) {
+#if defined(__x86_64__) || defined(__i386__)
+#ifdef CINN_DEPLOY_RUNTIME
+  static const bool has_vnni = __builtin_cpu_supports("avx512vnni");
+#else
+  static const bool has_vnni =
+      cinn::common::DefaultHostTarget().x86_supports(cinn::common::Target::X86Feature::AVX512_VNNI);
+#endif
+  if (has_vnni) {
+    VNNITileAVX512(c, a, b, lda, ldb, ldc, init);
+    return;
+  }
+#endif
+  VNNITileGeneric(c, a, b, lda, ldb, ldc, init);
+}
 }  // extern "C"
 
+#ifndef CINN_DEPLOY_RUNTIME
 namespace cinn {
 namespace runtime {
 
@@ -285,14 +439,14 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
 #undef REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32
 
-#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP64(func__) \
+#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP64(func__)                    \
   REGISTER_EXTERN_FUNC_1_IN_1_OUT(func__, host_target, double, double);
 
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP64(cinn_host_cbrt_fp64);
 
 #undef REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP64
 
-#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32_INT(func__) \
+#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32_INT(func__)            \
   REGISTER_EXTERN_FUNC_1_IN_1_OUT(func__, host_target, float, int);
 
 #undef REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32_INT
@@ -303,21 +457,21 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_F
 
-#define REGISTER_EXTERN_FUNC_2_IN_1_FP32(func__) \
+#define REGISTER_EXTERN_FUNC_2_IN_1_FP32(func__)                                                \
   REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_##func__##_fp32, host_target, float, float, float);
 
   REGISTER_EXTERN_FUNC_2_IN_1_FP32(pow)
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_FP32
 
-#define REGISTER_EXTERN_FUNC_2_IN_1_FP64(func__) \
+#define REGISTER_EXTERN_FUNC_2_IN_1_FP64(func__)                                                   \
   REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_##func__##_fp64, host_target, double, double, double);
 
   REGISTER_EXTERN_FUNC_2_IN_1_FP64(pow)
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_FP64
 
-#define REGISTER_EXTERN_FUNC_2_IN_1_INT32(func__) \
+#define REGISTER_EXTERN_FUNC_2_IN_1_INT32(func__)                                          \
   REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_##func__##_int32, host_target, int, int, int);
 
   REGISTER_EXTERN_FUNC_2_IN_1_INT32(pow)
@@ -326,7 +480,7 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_INT32
 
-#define REGISTER_EXTERN_FUNC_2_IN_1_INT64(func__) \
+#define REGISTER_EXTERN_FUNC_2_IN_1_INT64(func__)                                                      \
   REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_##func__##_int64, host_target, int64_t, int64_t, int64_t);
 
   REGISTER_EXTERN_FUNC_2_IN_1_INT64(pow)
@@ -335,6 +489,21 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_INT64
 
+  REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_philox_uniform_fp32, host_target, int64_t, int64_t, float);
+
+  REGISTER_EXTERN_FUNC_2_IN_1_OUT(cinn_host_philox_uniform_fp64, host_target, int64_t, int64_t, double);
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_host_vnni_m16n16k16_s8s8s32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int32_t*>()  // c
+      .AddInputType<int8_t*>()   // a
+      .AddInputType<int8_t*>()   // b
+      .AddInputType<int>()       // lda
+      .AddInputType<int>()       // ldb
+      .AddInputType<int>()       // ldc
+      .AddInputType<bool>()      // init
+      .End();
+
   REGISTER_EXTERN_FUNC_1_IN_1_OUT(cinn_host_clz_int32, host_target, int, int);
 
   REGISTER_EXTERN_FUNC_1_IN_1_OUT(cinn_host_clz_int64, host_target, int64_t, int64_t);
@@ -418,6 +587,39 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
 #undef _REGISTER_CINN_HOST_GT_NUM
 
+#define _REGISTER_CINN_HOST_CSR_SPMM(TYPE_SUFFIX, TYPE)                      \
+  REGISTER_EXTERN_FUNC_HELPER(cinn_host_csr_spmm_##TYPE_SUFFIX, host_target) \
+      .SetRetType<TYPE>()                                                    \
+      .AddInputType<cinn_buffer_t*>()                                        \
+      .AddInputType<cinn_buffer_t*>()                                        \
+      .AddInputType<cinn_buffer_t*>()                                        \
+      .AddInputType<cinn_buffer_t*>()                                        \
+      .AddInputType<int>()                                                   \
+      .AddInputType<int>()                                                   \
+      .AddInputType<int>()                                                   \
+      .End();
+
+  _REGISTER_CINN_HOST_CSR_SPMM(fp32, float);
+  _REGISTER_CINN_HOST_CSR_SPMM(fp64, double);
+
+#undef _REGISTER_CINN_HOST_CSR_SPMM
+
+#define _REGISTER_CINN_HOST_SDDMM(TYPE_SUFFIX, TYPE)                      \
+  REGISTER_EXTERN_FUNC_HELPER(cinn_host_sddmm_##TYPE_SUFFIX, host_target) \
+      .SetRetType<TYPE>()                                                 \
+      .AddInputType<cinn_buffer_t*>()                                     \
+      .AddInputType<cinn_buffer_t*>()                                     \
+      .AddInputType<cinn_buffer_t*>()                                     \
+      .AddInputType<cinn_buffer_t*>()                                     \
+      .AddInputType<int>()                                                \
+      .AddInputType<int>()                                                \
+      .End();
+
+  _REGISTER_CINN_HOST_SDDMM(fp32, float);
+  _REGISTER_CINN_HOST_SDDMM(fp64, double);
+
+#undef _REGISTER_CINN_HOST_SDDMM
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_host_resize_bilinear, host_target)
       .SetRetType<int>()
       .AddInputType<cinn_buffer_t*>()
@@ -458,3 +660,4 @@ CINN_REGISTER_HELPER(host_intrinsics) {
 
   return true;
 }
+#endif  // CINN_DEPLOY_RUNTIME
@@ -25,16 +25,16 @@ extern "C" {
 void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out);
 //@}
 
-inline int cinn_host_find_int(const cinn_buffer_t* buf, int size, int num);
+int cinn_host_find_int(const cinn_buffer_t* buf, int size, int num);
 
-inline int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num);
+int cinn_host_find_float(const cinn_buffer_t* buf, int size, float num);
 
-inline int cinn_host_find_int_nd(const cinn_buffer_t* buf, int size, int num, int begin, int stride);
+int cinn_host_find_int_nd(const cinn_buffer_t* buf, int size, int num, int begin, int stride);
 
-inline int cinn_host_find_float_nd(const cinn_buffer_t* buf, int size, float num, int begin, int stride);
+int cinn_host_find_float_nd(const cinn_buffer_t* buf, int size, float num, int begin, int stride);
 
-#define CINN_HOST_LT_NUM(TYPE_SUFFIX, TYPE)  \
-  inline int cinn_host_lt_num_##TYPE_SUFFIX( \
+#define CINN_HOST_LT_NUM(TYPE_SUFFIX, TYPE) \
+  int cinn_host_lt_num_##TYPE_SUFFIX(       \
       const cinn_buffer_t* buf, const int size, const TYPE num, const int offset, const int stride);
 
 CINN_HOST_LT_NUM(fp32, float)
@@ -44,8 +44,8 @@ CINN_HOST_LT_NUM(int64, int64_t)
 
 #undef CINN_HOST_LT_NUM
 
-#define CINN_HOST_GT_NUM(TYPE_SUFFIX, TYPE)  \
-  inline int cinn_host_gt_num_##TYPE_SUFFIX( \
+#define CINN_HOST_GT_NUM(TYPE_SUFFIX, TYPE) \
+  int cinn_host_gt_num_##TYPE_SUFFIX(       \
       const cinn_buffer_t* buf, const int size, const TYPE num, const int offset, const int stride);
 
 CINN_HOST_GT_NUM(fp32, float)
@@ -55,6 +55,33 @@ CINN_HOST_GT_NUM(int64, int64_t)
 
 #undef CINN_HOST_GT_NUM
 
+#define CINN_HOST_CSR_SPMM(TYPE_SUFFIX, TYPE)                        \
+  TYPE cinn_host_csr_spmm_##TYPE_SUFFIX(const cinn_buffer_t* crows,  \
+                                        const cinn_buffer_t* cols,   \
+                                        const cinn_buffer_t* values, \
+                                        const cinn_buffer_t* dense,  \
+                                        const int row,               \
+                                        const int col,               \
+                                        const int n);
+
+CINN_HOST_CSR_SPMM(fp32, float)
+CINN_HOST_CSR_SPMM(fp64, double)
+
+#undef CINN_HOST_CSR_SPMM
+
+#define CINN_HOST_SDDMM(TYPE_SUFFIX, TYPE)                      \
+  TYPE cinn_host_sddmm_##TYPE_SUFFIX(const cinn_buffer_t* rows, \
+                                     const cinn_buffer_t* cols, \
+                                     const cinn_buffer_t* x,    \
+                                     const cinn_buffer_t* y,    \
+                                     const int p,               \
+                                     const int k);
+
+CINN_HOST_SDDMM(fp32, float)
+CINN_HOST_SDDMM(fp64, double)
+
+#undef CINN_HOST_SDDMM
+
 int cinn_host_resize_bilinear(const cinn_buffer_t* buf,
                               const int c_size,
                               const int in_h,
@@ -79,39 +106,52 @@ int cinn_host_resize_bicubic(const cinn_buffer_t* buf,
 
 #define FN_INT32(func) cinn_host_##func##_int32
 
-inline int FN_INT32(pow)(int x, int y);
+int FN_INT32(pow)(int x, int y);
 
-inline int FN_INT32(clz)(int x);
+int FN_INT32(clz)(int x);
 
-inline int FN_INT32(popc)(int x);
+int FN_INT32(popc)(int x);
 
-inline int FN_INT32(logical_right_shift)(int x, int y);
+int FN_INT32(logical_right_shift)(int x, int y);
 
 #undef FN_INT32
 
 #define FN_INT64(func) cinn_host_##func##_int64
 
-inline int64_t FN_INT64(clz)(int64_t x);
+int64_t FN_INT64(clz)(int64_t x);
 
-inline int64_t FN_INT64(popc)(int64_t x);
+int64_t FN_INT64(popc)(int64_t x);
 
-inline int64_t FN_INT64(pow)(int64_t x, int64_t y);
+int64_t FN_INT64(pow)(int64_t x, int64_t y);
 
-inline int64_t FN_INT64(logical_right_shift)(int64_t x, int64_t y);
+int64_t FN_INT64(logical_right_shift)(int64_t x, int64_t y);
 
 #undef FN_INT64
 
 #define FN_FP32(func) cinn_host_##func##_fp32
 
-inline float FN_FP32(cbrt)(float x);
+float FN_FP32(cbrt)(float x);
 
 #undef FN_FP32
 
 #define FN_FP64(func) cinn_host_##func##_fp64
 
-inline double FN_FP64(cbrt)(double x);
+double FN_FP64(cbrt)(double x);
 
 #undef FN_FP64
+
+//! The same Philox4x32-10 random numbers in [0, 1) as the NVGPU intrinsics, by the seed and the offset of the element.
+float cinn_host_philox_uniform_fp32(int64_t seed, int64_t offset);
+
+double cinn_host_philox_uniform_fp64(int64_t seed, int64_t offset);
+
+/**
+ * \brief Compute a 16x16 tile of C with the 16x16 tile of A and 16x16 tile of B: C = (init ? 0 : C) + A * B, where A,
+ * B and C are row major with the leading dimensions lda, ldb and ldc. The groups of 4 along K are summed by the VNNI
+ * instruction vpdpbusd if the CPU supports it. It is the intrinsic vnni_m16n16k16_s8s8s32 of IRSchedule::Tensorize.
+ */
+void cinn_host_vnni_m16n16k16_s8s8s32(
+    int32_t* c, const int8_t* a, const int8_t* b, int lda, int ldb, int ldc, bool init);
 }
 
 namespace cinn {
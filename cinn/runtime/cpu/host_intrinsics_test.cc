@@ -203,6 +203,45 @@ TEST(cinn_host_gt_num_fp32, basic) {
   }
 }
 
+TEST(cinn_host_philox_uniform_fp32, basic) {
+  Expr N(64);
+  auto y = Compute(
+      {N},
+      [&](Expr i) {
+        return CallExtern("cinn_host_philox_uniform_fp32", {Expr(int64_t(0)), ir::Cast::Make(Int(64), i)});
+      },
+      "y");
+
+  auto stages = CreateStages({y});
+
+  auto jit = backends::SimpleJIT::Create();
+
+  ir::Module::Builder builder("module1", common::DefaultHostTarget());
+
+  auto fn = Lower("fn", stages, {y});
+  LOG(INFO) << "fn:\n" << fn;
+
+  builder.AddFunction(fn);
+
+  jit->Link(builder.Build());
+
+  auto fn_ptr = jit->Lookup("fn");
+  auto fnp    = reinterpret_cast<lower_func_ptr_t>(fn_ptr);
+  ASSERT_TRUE(fnp);
+
+  auto* out_buf = common::BufferBuilder(Float(32), {N.as_int32()}).set_zero().Build();
+  auto args     = common::ArgsBuilder().Add(out_buf).Build();
+  fnp(args.data(), args.size());
+
+  auto* out_buf_data = reinterpret_cast<float*>(out_buf->memory);
+  // the first output of Philox4x32-10 with the zero key and counter is 0x6627e8d5
+  ASSERT_FLOAT_EQ(out_buf_data[0], 0x6627e8 / 16777216.0F);
+  for (int i = 0; i < 64; i++) {
+    ASSERT_GE(out_buf_data[i], 0.0F);
+    ASSERT_LT(out_buf_data[i], 1.0F);
+  }
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
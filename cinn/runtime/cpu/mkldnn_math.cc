@@ -14,6 +14,12 @@
 
 #include "cinn/runtime/cpu/mkldnn_math.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/backends/extern_func_jit_register.h"
@@ -24,11 +30,119 @@ using mkldnn::memory;
 using tag = memory::format_tag;
 using dt  = memory::data_type;
 
+namespace {
+
+mkldnn::engine& GetEngine() {
+  static mkldnn::engine engine(mkldnn::engine::kind::cpu, 0);
+  return engine;
+}
+
+// The primitives can be executed by several threads at the same time, but a stream should be used by one thread.
+mkldnn::stream& GetStream() {
+  thread_local mkldnn::stream stream(GetEngine());
+  return stream;
+}
+
+// The process-wide cache of the objects created by the given keys, such as the primitives and the reordered weights.
+template <typename T>
+class MkldnnCache {
+ public:
+  static MkldnnCache& Global() {
+    static MkldnnCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<T> GetOrCreate(const std::string& key, const std::function<T()>& create) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      return it->second;
+    }
+    auto res = std::make_shared<T>(create());
+    cache_.emplace(key, res);
+    return res;
+  }
+
+ private:
+  MkldnnCache() = default;
+
+  std::mutex mtx_;
+  std::unordered_map<std::string, std::shared_ptr<T>> cache_;
+};
+
+template <typename... Args>
+std::string MakeKey(const Args&... args) {
+  std::stringstream ss;
+  ((ss << args << "_"), ...);
+  return ss.str();
+}
+
+template <typename Primitive>
+struct CachedPrimitive {
+  typename Primitive::primitive_desc pd;
+  Primitive prim;
+};
+
+dt GetSrcType(int data_type) {
+  switch (data_type) {
+    case cinn_mkldnn_f32:
+      return dt::f32;
+    case cinn_mkldnn_bf16:
+      return dt::bf16;
+    case cinn_mkldnn_u8s8:
+      return dt::u8;
+    case cinn_mkldnn_s8s8:
+      return dt::s8;
+    default:
+      LOG(FATAL) << "unsupported mkldnn data type: " << data_type;
+  }
+  return dt::undef;
+}
+
+dt GetWeightsType(int data_type) { return data_type == cinn_mkldnn_u8s8 ? dt::s8 : GetSrcType(data_type); }
+
+dt GetDstType(int data_type) {
+  if (data_type == cinn_mkldnn_u8s8) {
+    return dt::f32;
+  } else if (data_type == cinn_mkldnn_s8s8) {
+    return dt::s32;
+  }
+  return GetSrcType(data_type);
+}
+
+mkldnn::primitive_attr MakeAttr(int post_op, float scale) {
+  mkldnn::primitive_attr attr;
+  if (scale != 1.f) {
+    attr.set_output_scales(0, {scale});
+  }
+  algorithm alg;
+  switch (post_op) {
+    case cinn_mkldnn_post_op_none:
+      return attr;
+    case cinn_mkldnn_post_op_relu:
+      alg = algorithm::eltwise_relu;
+      break;
+    case cinn_mkldnn_post_op_sigmoid:
+      alg = algorithm::eltwise_logistic;
+      break;
+    case cinn_mkldnn_post_op_tanh:
+      alg = algorithm::eltwise_tanh;
+      break;
+    default:
+      LOG(FATAL) << "unsupported mkldnn post op: " << post_op;
+  }
+  mkldnn::post_ops ops;
+  ops.append_eltwise(1.f, alg, 0.f, 0.f);
+  attr.set_post_ops(ops);
+  return attr;
+}
+
+void Reorder(memory& src, memory& dst) { mkldnn::reorder(src, dst).execute(GetStream(), src, dst); }
+
+}  // namespace
+
 void cinn_cpu_mkldnn_softmax_fp32(
     int batch, int channel, int h, int w, int axis, cinn_buffer_t* inputs, cinn_buffer_t* out) {
-  auto engine = mkldnn::engine(mkldnn::engine::kind::cpu, 0);
-  mkldnn::stream engine_stream(engine);
-
   memory::dims src_dims = {batch, channel};
   if (h != 1) src_dims.push_back(h);
   if (w != 1) src_dims.push_back(w);
@@ -49,15 +163,20 @@ void cinn_cpu_mkldnn_softmax_fp32(
       break;
   }
 
-  auto src_md       = memory::desc(src_dims, dt::f32, format_tag);
-  auto src_mem      = memory(src_md, engine, reinterpret_cast<float*>(inputs->memory));
-  auto dst_mem      = memory(src_md, engine, reinterpret_cast<float*>(out->memory));
-  auto softmax_d    = mkldnn::softmax_forward::desc(mkldnn::prop_kind::forward_inference, src_md, axis);
-  auto softmax_pd   = mkldnn::softmax_forward::primitive_desc(softmax_d, engine);
-  auto softmax_prim = mkldnn::softmax_forward(softmax_pd);
+  auto& engine = GetEngine();
+  auto& stream = GetStream();
+  auto src_md  = memory::desc(src_dims, dt::f32, format_tag);
+  auto softmax = MkldnnCache<CachedPrimitive<mkldnn::softmax_forward>>::Global().GetOrCreate(
+      MakeKey("softmax", batch, channel, h, w, axis), [&]() -> CachedPrimitive<mkldnn::softmax_forward> {
+        auto softmax_d  = mkldnn::softmax_forward::desc(mkldnn::prop_kind::forward_inference, src_md, axis);
+        auto softmax_pd = mkldnn::softmax_forward::primitive_desc(softmax_d, engine);
+        return {softmax_pd, mkldnn::softmax_forward(softmax_pd)};
+      });
+  auto src_mem = memory(src_md, engine, reinterpret_cast<float*>(inputs->memory));
+  auto dst_mem = memory(src_md, engine, reinterpret_cast<float*>(out->memory));
 
-  softmax_prim.execute(engine_stream, {{DNNL_ARG_SRC, src_mem}, {DNNL_ARG_DST, dst_mem}});
-  engine_stream.wait();
+  softmax->prim.execute(stream, {{DNNL_ARG_SRC, src_mem}, {DNNL_ARG_DST, dst_mem}});
+  stream.wait();
 }
 
 void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
@@ -77,8 +196,59 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       cinn_buffer_t* inputs,
                                       cinn_buffer_t* weights,
                                       cinn_buffer_t* out) {
-  auto cpu_engine = mkldnn::engine(mkldnn::engine::kind::cpu, 0);
-  mkldnn::stream cpu_stream(cpu_engine);
+  cinn_cpu_mkldnn_conv2d(cinn_mkldnn_f32,
+                         cinn_mkldnn_nchw,
+                         cinn_mkldnn_post_op_none,
+                         1.f,
+                         false,
+                         batch_size,
+                         c_in,
+                         input_h,
+                         input_w,
+                         c_out,
+                         group,
+                         filter_h,
+                         filter_w,
+                         pad_h,
+                         pad_w,
+                         stride_h,
+                         stride_w,
+                         dilation_h,
+                         dilation_w,
+                         inputs,
+                         weights,
+                         out);
+}
+
+void cinn_cpu_mkldnn_conv2d(int data_type,
+                            int layout,
+                            int post_op,
+                            float scale,
+                            bool constant_weights,
+                            int batch_size,
+                            int c_in,
+                            int input_h,
+                            int input_w,
+                            int c_out,
+                            int group,
+                            int filter_h,
+                            int filter_w,
+                            int pad_h,
+                            int pad_w,
+                            int stride_h,
+                            int stride_w,
+                            int dilation_h,
+                            int dilation_w,
+                            cinn_buffer_t* inputs,
+                            cinn_buffer_t* weights,
+                            cinn_buffer_t* out) {
+  CHECK(layout == cinn_mkldnn_nchw || layout == cinn_mkldnn_nChw16c) << "unsupported mkldnn layout: " << layout;
+  if (layout == cinn_mkldnn_nChw16c) {
+    CHECK(c_in % 16 == 0 && c_out % 16 == 0) << "the channels of the nChw16c layout should be multiples of 16, but got "
+                                             << c_in << " and " << c_out;
+  }
+  auto& engine = GetEngine();
+  auto& stream = GetStream();
 
   memory::dims conv_src_tz     = {batch_size, c_in, input_h, input_w};
   memory::dims conv_weights_tz = {c_out, c_in, filter_h, filter_w};
@@ -91,49 +261,112 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
   memory::dims conv_strides   = {stride_h, stride_w};
   memory::dims conv_paddings  = {pad_h, pad_w};
   memory::dims conv_dilations = {dilation_h - 1, dilation_w - 1};
+  auto user_tag               = layout == cinn_mkldnn_nChw16c ? tag::nChw16c : tag::nchw;
 
-  auto conv_user_src_memory =
-      memory({{conv_src_tz}, dt::f32, tag::nchw}, cpu_engine, reinterpret_cast<float*>(inputs->memory));
-  auto conv_user_weights_memory = memory({{conv_weights_tz}, dt::f32, group > 1 ? tag::goihw : tag::oihw},
-                                         cpu_engine,
-                                         reinterpret_cast<float*>(weights->memory));
-  auto conv_user_dst_memory =
-      memory({{conv_dst_tz}, dt::f32, tag::nchw}, cpu_engine, reinterpret_cast<float*>(out->memory));
-
-  auto conv_src_md     = memory::desc({conv_src_tz}, dt::f32, tag::any);
-  auto conv_weights_md = memory::desc({conv_weights_tz}, dt::f32, tag::any);
-  auto conv_dst_md     = memory::desc({conv_dst_tz}, dt::f32, tag::nchw);
-
-  auto conv_desc = mkldnn::convolution_forward::desc(mkldnn::prop_kind::forward_inference,
-                                                     mkldnn::algorithm::convolution_direct,
-                                                     conv_src_md,
-                                                     conv_weights_md,
-                                                     conv_dst_md,
-                                                     conv_strides,
-                                                     conv_dilations,
-                                                     conv_paddings,
-                                                     conv_paddings);
-
-  auto conv_prim_desc = mkldnn::convolution_forward::primitive_desc(conv_desc, cpu_engine);
-
-  auto conv_src_memory     = conv_user_src_memory;
-  auto conv_weights_memory = conv_user_weights_memory;
-  auto conv_dst_memory     = conv_user_dst_memory;
-  if (conv_prim_desc.dst_desc() != conv_user_dst_memory.get_desc()) {
-    conv_dst_memory = memory(conv_prim_desc.dst_desc(), cpu_engine);
+  auto key  = MakeKey("conv2d",
+                     data_type,
+                     layout,
+                     post_op,
+                     scale,
+                     batch_size,
+                     c_in,
+                     input_h,
+                     input_w,
+                     c_out,
+                     group,
+                     filter_h,
+                     filter_w,
+                     pad_h,
+                     pad_w,
+                     stride_h,
+                     stride_w,
+                     dilation_h,
+                     dilation_w);
+  auto conv = MkldnnCache<CachedPrimitive<mkldnn::convolution_forward>>::Global().GetOrCreate(
+      key, [&]() -> CachedPrimitive<mkldnn::convolution_forward> {
+        // the primitive chooses the blocked layouts of the plain source and the weights, while the blocked source and
+        // destination given by the caller are used directly
+        auto conv_src_md = memory::desc(
+            {conv_src_tz}, GetSrcType(data_type), layout == cinn_mkldnn_nChw16c ? tag::nChw16c : tag::any);
+        auto conv_weights_md = memory::desc({conv_weights_tz}, GetWeightsType(data_type), tag::any);
+        auto conv_dst_md     = memory::desc({conv_dst_tz}, GetDstType(data_type), user_tag);
+        auto conv_desc       = mkldnn::convolution_forward::desc(mkldnn::prop_kind::forward_inference,
+                                                           mkldnn::algorithm::convolution_direct,
+                                                           conv_src_md,
+                                                           conv_weights_md,
+                                                           conv_dst_md,
+                                                           conv_strides,
+                                                           conv_dilations,
+                                                           conv_paddings,
+                                                           conv_paddings);
+        auto conv_prim_desc =
+            mkldnn::convolution_forward::primitive_desc(conv_desc, MakeAttr(post_op, scale), engine);
+        return {conv_prim_desc, mkldnn::convolution_forward(conv_prim_desc)};
+      });
+
+  auto conv_user_src_memory = memory({{conv_src_tz}, GetSrcType(data_type), user_tag}, engine, inputs->memory);
+  auto conv_user_weights_memory =
+      memory({{conv_weights_tz}, GetWeightsType(data_type), group > 1 ? tag::goihw : tag::oihw}, engine, weights->memory);
+  auto conv_dst_memory = memory(conv->pd.dst_desc(), engine, out->memory);
+
+  auto conv_src_memory = conv_user_src_memory;
+  if (conv->pd.src_desc() != conv_user_src_memory.get_desc()) {
+    conv_src_memory = memory(conv->pd.src_desc(), engine);
+    Reorder(conv_user_src_memory, conv_src_memory);
   }
-  auto conv = mkldnn::convolution_forward(conv_prim_desc);
-  conv.execute(cpu_stream,
-               {{MKLDNN_ARG_SRC, conv_src_memory},
-                {MKLDNN_ARG_WEIGHTS, conv_weights_memory},
-                {MKLDNN_ARG_DST, conv_dst_memory}});
-  if (conv_prim_desc.dst_desc() != conv_user_dst_memory.get_desc()) {
-    mkldnn::reorder(conv_dst_memory, conv_user_dst_memory).execute(cpu_stream, conv_dst_memory, conv_user_dst_memory);
-  } else {
-    conv_user_dst_memory = conv_dst_memory;
+  auto conv_weights_memory = conv_user_weights_memory;
+  if (conv->pd.weights_desc() != conv_user_weights_memory.get_desc()) {
+    if (constant_weights) {
+      conv_weights_memory = *MkldnnCache<memory>::Global().GetOrCreate(
+          MakeKey(key, static_cast<void*>(weights->memory)), [&]() -> memory {
+            auto reordered = memory(conv->pd.weights_desc(), engine);
+            Reorder(conv_user_weights_memory, reordered);
+            return reordered;
+          });
+    } else {
+      conv_weights_memory = memory(conv->pd.weights_desc(), engine);
+      Reorder(conv_user_weights_memory, conv_weights_memory);
+    }
   }
 
-  cpu_stream.wait();
+  conv->prim.execute(stream,
+                     {{MKLDNN_ARG_SRC, conv_src_memory},
+                      {MKLDNN_ARG_WEIGHTS, conv_weights_memory},
+                      {MKLDNN_ARG_DST, conv_dst_memory}});
+  stream.wait();
+}
+
+void cinn_cpu_mkldnn_matmul(int data_type,
+                            int post_op,
+                            float alpha,
+                            int M,
+                            int N,
+                            int K,
+                            bool ta,
+                            bool tb,
+                            cinn_buffer_t* A,
+                            cinn_buffer_t* B,
+                            cinn_buffer_t* C) {
+  auto& engine = GetEngine();
+  auto& stream = GetStream();
+
+  // the transposed matrices are described by their strides instead of being copied
+  auto a_md = memory::desc({M, K}, GetSrcType(data_type), ta ? memory::dims{1, M} : memory::dims{K, 1});
+  auto b_md = memory::desc({K, N}, GetWeightsType(data_type), tb ? memory::dims{1, K} : memory::dims{N, 1});
+  auto c_md = memory::desc({M, N}, GetDstType(data_type), tag::ab);
+
+  auto matmul = MkldnnCache<CachedPrimitive<mkldnn::matmul>>::Global().GetOrCreate(
+      MakeKey("matmul", data_type, post_op, alpha, M, N, K, ta, tb), [&]() -> CachedPrimitive<mkldnn::matmul> {
+        auto matmul_desc = mkldnn::matmul::desc(a_md, b_md, c_md);
+        auto matmul_pd   = mkldnn::matmul::primitive_desc(matmul_desc, MakeAttr(post_op, alpha), engine);
+        return {matmul_pd, mkldnn::matmul(matmul_pd)};
+      });
+
+  auto a_mem = memory(a_md, engine, A->memory);
+  auto b_mem = memory(b_md, engine, B->memory);
+  auto c_mem = memory(c_md, engine, C->memory);
+  matmul->prim.execute(stream, {{MKLDNN_ARG_SRC, a_mem}, {MKLDNN_ARG_WEIGHTS, b_mem}, {MKLDNN_ARG_DST, c_mem}});
+  stream.wait();
 }
 
 CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
@@ -141,31 +374,55 @@ CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
   using backends::FunctionProto;
   auto host_target = common::DefaultHostTarget();
 
-  FunctionProto::shape_inference_t inference_shape_conv2d_nchw = [](const std::vector<Expr>& args, int offset) {
-    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
-    auto N         = common::AutoSimplify(args[0]);
-    int input_h    = common::AutoSimplify(args[2]).as_int32();
-    int input_w    = common::AutoSimplify(args[3]).as_int32();
-    auto c_out     = common::AutoSimplify(args[4]);
-    int filter_h   = common::AutoSimplify(args[6]).as_int32();
-    int filter_w   = common::AutoSimplify(args[7]).as_int32();
-    int pad_h      = common::AutoSimplify(args[8]).as_int32();
-    int pad_w      = common::AutoSimplify(args[9]).as_int32();
-    int stride_h   = common::AutoSimplify(args[10]).as_int32();
-    int stride_w   = common::AutoSimplify(args[11]).as_int32();
-    int dilation_h = common::AutoSimplify(args[12]).as_int32();
-    int dilation_w = common::AutoSimplify(args[13]).as_int32();
+  // the output shape of the convolution whose arguments from batch_size to dilation_w begin at args[begin]
+  auto conv2d_out_shape = [](const std::vector<Expr>& args, int begin, int layout) {
+    auto N         = common::AutoSimplify(args[begin]);
+    int input_h    = common::AutoSimplify(args[begin + 2]).as_int32();
+    int input_w    = common::AutoSimplify(args[begin + 3]).as_int32();
+    int c_out      = common::AutoSimplify(args[begin + 4]).as_int32();
+    int filter_h   = common::AutoSimplify(args[begin + 6]).as_int32();
+    int filter_w   = common::AutoSimplify(args[begin + 7]).as_int32();
+    int pad_h      = common::AutoSimplify(args[begin + 8]).as_int32();
+    int pad_w      = common::AutoSimplify(args[begin + 9]).as_int32();
+    int stride_h   = common::AutoSimplify(args[begin + 10]).as_int32();
+    int stride_w   = common::AutoSimplify(args[begin + 11]).as_int32();
+    int dilation_h = common::AutoSimplify(args[begin + 12]).as_int32();
+    int dilation_w = common::AutoSimplify(args[begin + 13]).as_int32();
     int out_h      = (input_h - ((filter_h - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
     int out_w      = (input_w - ((filter_w - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
 
     std::vector<Expr> shape;
     shape.push_back(N);
-    shape.push_back(c_out);
-    shape.push_back(Expr(out_h));
-    shape.push_back(Expr(out_w));
+    if (layout == cinn_mkldnn_nChw16c) {
+      shape.push_back(Expr(c_out / 16));
+      shape.push_back(Expr(out_h));
+      shape.push_back(Expr(out_w));
+      shape.push_back(Expr(16));
+    } else {
+      shape.push_back(Expr(c_out));
+      shape.push_back(Expr(out_h));
+      shape.push_back(Expr(out_w));
+    }
     return shape;
   };
 
+  FunctionProto::shape_inference_t inference_shape_conv2d_nchw = [=](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
+    return conv2d_out_shape(args, 0, cinn_mkldnn_nchw);
+  };
+
+  FunctionProto::shape_inference_t inference_shape_conv2d = [=](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(args.size(), 21UL) << "Wrong number of arguments passed in";
+    return conv2d_out_shape(args, 5, common::AutoSimplify(args[1]).as_int32());
+  };
+
+  FunctionProto::shape_inference_t inference_shape_matmul = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(args.size(), 10UL) << "Wrong number of arguments passed in";
+    auto M = common::AutoSimplify(args[3]);
+    auto N = common::AutoSimplify(args[4]);
+    return std::vector<Expr>{M, N};
+  };
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_conv2d_nchw_fp32, host_target)
       .SetRetType<void>()
       .AddInputType<int>()              // batch_size
@@ -188,6 +445,49 @@ CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
       .SetShapeInference(inference_shape_conv2d_nchw)
       .End();
 
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_conv2d, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // data_type
+      .AddInputType<int>()              // layout
+      .AddInputType<int>()              // post_op
+      .AddInputType<float>()            // scale
+      .AddInputType<bool>()             // constant_weights
+      .AddInputType<int>()              // batch_size
+      .AddInputType<int>()              // c_in
+      .AddInputType<int>()              // input_h
+      .AddInputType<int>()              // input_w
+      .AddInputType<int>()              // c_out
+      .AddInputType<int>()              // group
+      .AddInputType<int>()              // filter_h
+      .AddInputType<int>()              // filter_w
+      .AddInputType<int>()              // pad_h
+      .AddInputType<int>()              // pad_w
+      .AddInputType<int>()              // stride_h
+      .AddInputType<int>()              // stride_w
+      .AddInputType<int>()              // dilation_h
+      .AddInputType<int>()              // dilation_w
+      .AddInputType<cinn_buffer_t*>()   // inputs
+      .AddInputType<cinn_buffer_t*>()   // weights
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(inference_shape_conv2d)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_matmul, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // data_type
+      .AddInputType<int>()              // post_op
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_matmul)
+      .End();
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_softmax_fp32, host_target)
       .SetRetType<void>()
       .AddInputType<int>()              // batch_size
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+//! \file This file defines the C APIs of the oneDNN(MKLDNN) primitives. The engine is shared by the process and each
+//! thread has its own stream, the primitives are created once for each shape, layout and data type and reused by the
+//! later calls.
 #include "cinn/runtime/cinn_runtime.h"
 
 #ifdef CINN_WITH_MKLDNN
@@ -21,6 +24,29 @@
 
 // define some C APIs
 extern "C" {
+
+//! The data types of the oneDNN primitives.
+typedef enum cinn_mkldnn_data_type_t {
+  cinn_mkldnn_f32  = 0,  // float32 inputs and output
+  cinn_mkldnn_bf16 = 1,  // bfloat16 inputs and output
+  cinn_mkldnn_u8s8 = 2,  // uint8 source, int8 weights and float32 output scaled by the scale argument
+  cinn_mkldnn_s8s8 = 3,  // int8 source and weights, and the int32 accumulation as output
+} cinn_mkldnn_data_type_t;
+
+//! The layouts of the source and destination of the convolution.
+typedef enum cinn_mkldnn_layout_t {
+  cinn_mkldnn_nchw    = 0,  // [N, C, H, W]
+  cinn_mkldnn_nChw16c = 1,  // [N, C/16, H, W, 16], the channels are blocked by 16
+} cinn_mkldnn_layout_t;
+
+//! The elementwise operations fused into the output of the primitives.
+typedef enum cinn_mkldnn_post_op_t {
+  cinn_mkldnn_post_op_none    = 0,
+  cinn_mkldnn_post_op_relu    = 1,
+  cinn_mkldnn_post_op_sigmoid = 2,
+  cinn_mkldnn_post_op_tanh    = 3,
+} cinn_mkldnn_post_op_t;
+
 void cinn_cpu_mkldnn_softmax_fp32(
     int batch, int channel, int h, int w, int axis, cinn_buffer_t* inputs, cinn_buffer_t* out);
 
@@ -42,4 +68,60 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       cinn_buffer_t* weights,
                                       cinn_buffer_t* out);
 
+/**
+ * \brief The convolution of the given data type and layout, with an elementwise post-op fused into its output.
+ * @param data_type The data type, see cinn_mkldnn_data_type_t
+ * @param layout The layout of the inputs and out, see cinn_mkldnn_layout_t, the weights are always [C_out, C_in/group,
+ * filter_h, filter_w]
+ * @param post_op The fused elementwise operation, see cinn_mkldnn_post_op_t
+ * @param scale The scaling factor of the output, which dequantizes the int32 result of the u8s8 convolution
+ * @param constant_weights Whether the weights are constant, they are reordered into the layout preferred by the
+ * primitive by the first call and reused by the later ones, so the weights must not change in their buffer
+ */
+void cinn_cpu_mkldnn_conv2d(int data_type,
+                            int layout,
+                            int post_op,
+                            float scale,
+                            bool constant_weights,
+                            int batch_size,
+                            int c_in,
+                            int input_h,
+                            int input_w,
+                            int c_out,
+                            int group,
+                            int filter_h,
+                            int filter_w,
+                            int pad_h,
+                            int pad_w,
+                            int stride_h,
+                            int stride_w,
+                            int dilation_h,
+                            int dilation_w,
+                            cinn_buffer_t* inputs,
+                            cinn_buffer_t* weights,
+                            cinn_buffer_t* out);
+
+/**
+ * \brief The matmul C = alpha * op(A) * op(B) of the given data type, with an elementwise post-op fused into C.
+ * @param data_type The data type, see cinn_mkldnn_data_type_t
+ * @param post_op The fused elementwise operation, see cinn_mkldnn_post_op_t
+ * @param alpha The scaling factor of the product of A and B
+ * @param M Number of the rows of C
+ * @param N the number of the columns in both B and C
+ * @param K the number of columns of op(A)
+ * @param ta whether to transpose A
+ * @param tb whether to transpose B
+ */
+void cinn_cpu_mkldnn_matmul(int data_type,
+                            int post_op,
+                            float alpha,
+                            int M,
+                            int N,
+                            int K,
+                            bool ta,
+                            bool tb,
+                            cinn_buffer_t* A,
+                            cinn_buffer_t* B,
+                            cinn_buffer_t* C);
+
 }  // extern "C"
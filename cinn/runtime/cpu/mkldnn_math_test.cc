@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/execution_engine.h"
@@ -23,6 +27,7 @@
 #include "cinn/common/target.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/runtime/cpu/host_intrinsics.h"
+#include "cinn/runtime/cpu/mkldnn_math.h"
 #include "cinn/runtime/cpu/use_extern_funcs.h"
 
 namespace cinn {
@@ -118,6 +123,132 @@ TEST(cinn_cpu_mkldnn_conv2d_nchw_fp32, test) {
   cinn_buffer_free(nullptr, C_buf);
 }
 
+// The naive NCHW convolution without padding and dilation as the reference.
+std::vector<float> NaiveConv2d(const std::vector<float> &input,
+                               const std::vector<float> &weights,
+                               int n,
+                               int c_in,
+                               int i_h,
+                               int i_w,
+                               int c_out,
+                               int k,
+                               int stride) {
+  int o_h = (i_h - k) / stride + 1;
+  int o_w = (i_w - k) / stride + 1;
+  std::vector<float> out(n * c_out * o_h * o_w, 0.f);
+  for (int b = 0; b < n; ++b) {
+    for (int oc = 0; oc < c_out; ++oc) {
+      for (int oh = 0; oh < o_h; ++oh) {
+        for (int ow = 0; ow < o_w; ++ow) {
+          float sum = 0.f;
+          for (int ic = 0; ic < c_in; ++ic) {
+            for (int kh = 0; kh < k; ++kh) {
+              for (int kw = 0; kw < k; ++kw) {
+                sum += input[((b * c_in + ic) * i_h + oh * stride + kh) * i_w + ow * stride + kw] *
+                       weights[((oc * c_in + ic) * k + kh) * k + kw];
+              }
+            }
+          }
+          out[((b * c_out + oc) * o_h + oh) * o_w + ow] = sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+// The blocked nChw16c layout and the relu post-op, the constant weights are reordered by the first run only.
+TEST(cinn_cpu_mkldnn_conv2d, nChw16c_relu) {
+  const int n = 2, c_in = 32, i_h = 15, i_w = 17, c_out = 48, k = 3, stride = 2;
+  const int o_h = (i_h - k) / stride + 1, o_w = (i_w - k) / stride + 1;
+  auto *input   = CreateBuffer({n, c_in, i_h, i_w});
+  auto *weights = CreateBuffer({c_out, c_in, k, k});
+  std::vector<float> input_data(reinterpret_cast<float *>(input->memory),
+                                reinterpret_cast<float *>(input->memory) + n * c_in * i_h * i_w);
+  std::vector<float> weights_data(reinterpret_cast<float *>(weights->memory),
+                                  reinterpret_cast<float *>(weights->memory) + c_out * c_in * k * k);
+  auto expect = NaiveConv2d(input_data, weights_data, n, c_in, i_h, i_w, c_out, k, stride);
+
+  // nchw -> nChw16c
+  auto *blocked_input = CreateBuffer({n, c_in / 16, i_h, i_w, 16}, false);
+  auto *blocked_src   = reinterpret_cast<float *>(blocked_input->memory);
+  for (int b = 0; b < n; ++b) {
+    for (int c = 0; c < c_in; ++c) {
+      for (int hw = 0; hw < i_h * i_w; ++hw) {
+        blocked_src[((b * c_in / 16 + c / 16) * i_h * i_w + hw) * 16 + c % 16] =
+            input_data[(b * c_in + c) * i_h * i_w + hw];
+      }
+    }
+  }
+  auto *out = CreateBuffer({n, c_out / 16, o_h, o_w, 16}, false);
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    cinn_cpu_mkldnn_conv2d(cinn_mkldnn_f32,
+                           cinn_mkldnn_nChw16c,
+                           cinn_mkldnn_post_op_relu,
+                           1.f,
+                           true,
+                           n,
+                           c_in,
+                           i_h,
+                           i_w,
+                           c_out,
+                           1,
+                           k,
+                           k,
+                           0,
+                           0,
+                           stride,
+                           stride,
+                           1,
+                           1,
+                           blocked_input,
+                           weights,
+                           out);
+    auto *dst = reinterpret_cast<float *>(out->memory);
+    for (int b = 0; b < n; ++b) {
+      for (int c = 0; c < c_out; ++c) {
+        for (int hw = 0; hw < o_h * o_w; ++hw) {
+          float value = dst[((b * c_out / 16 + c / 16) * o_h * o_w + hw) * 16 + c % 16];
+          ASSERT_NEAR(value, std::max(expect[(b * c_out + c) * o_h * o_w + hw], 0.f), 1e-3);
+        }
+      }
+    }
+  }
+
+  cinn_buffer_free(nullptr, input);
+  cinn_buffer_free(nullptr, weights);
+  cinn_buffer_free(nullptr, blocked_input);
+  cinn_buffer_free(nullptr, out);
+}
+
+TEST(cinn_cpu_mkldnn_matmul, trans_post_op) {
+  const int M = 33, N = 47, K = 65;
+  const float alpha = 0.5f;
+  for (bool ta : {false, true}) {
+    for (bool tb : {false, true}) {
+      auto *A = CreateBuffer({M, K});
+      auto *B = CreateBuffer({K, N});
+      auto *C = CreateBuffer({M, N}, false);
+      cinn_cpu_mkldnn_matmul(cinn_mkldnn_f32, cinn_mkldnn_post_op_tanh, alpha, M, N, K, ta, tb, A, B, C);
+      auto *a = reinterpret_cast<float *>(A->memory);
+      auto *b = reinterpret_cast<float *>(B->memory);
+      auto *c = reinterpret_cast<float *>(C->memory);
+      for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+          float expect = 0.f;
+          for (int p = 0; p < K; ++p) {
+            expect += (ta ? a[p * M + i] : a[i * K + p]) * (tb ? b[j * K + p] : b[p * N + j]);
+          }
+          ASSERT_NEAR(c[i * N + j], std::tanh(alpha * expect), 1e-4) << "ta: " << ta << ", tb: " << tb;
+        }
+      }
+      cinn_buffer_free(nullptr, A);
+      cinn_buffer_free(nullptr, B);
+      cinn_buffer_free(nullptr, C);
+    }
+  }
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
@@ -0,0 +1,548 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/packed_gemm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/common/cas.h"
+#include "cinn/common/target.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace {
+
+using cinn::common::Target;
+
+inline int RoundUp(int x, int base) { return (x + base - 1) / base * base; }
+
+// The depth of a block of the packed panels, the panels of A and B in a block stay in L1 and L2.
+constexpr int kBlockK = 256;
+// The number of micro-kernel rows and columns in a tile of C processed by a task.
+constexpr int kTileRowPanels = 8;
+constexpr int kTileColPanels = 8;
+// The largest micro-kernel, for the buffer of the edge tiles.
+constexpr int kMaxMR = 12;
+constexpr int kMaxNR = 32;
+
+//! Run \p fn(i0, m_len, j0, n_len) for each mc x nc tile of the M x N output on the threads of the parallel backend.
+void ParallelTiles(int M, int N, int mc, int nc, const std::function<void(int, int, int, int)>& fn) {
+  int row_tiles = (M + mc - 1) / mc;
+  int col_tiles = (N + nc - 1) / nc;
+  int num_tiles = row_tiles * col_tiles;
+  std::function<void(int, int)> task = [&](int task_id, int num_task) {
+    for (int t = task_id; t < num_tiles; t += num_task) {
+      int i0 = t / col_tiles * mc;
+      int j0 = t % col_tiles * nc;
+      fn(i0, std::min(mc, M - i0), j0, std::min(nc, N - j0));
+    }
+  };
+  FCINNParallelLambda lambda = [](int task_id, int num_task, void* datas) {
+    (*reinterpret_cast<std::function<void(int, int)>*>(datas))(task_id, num_task);
+    return 0;
+  };
+  int num_task = std::min(num_tiles, max_concurrency());
+  if (num_task <= 1) {
+    task(0, 1);
+  } else {
+    cinn_backend_parallel_launch(lambda, &task, num_task);
+  }
+}
+
+/**
+ * The packed panels of the constant B, keyed by the buffer and the packing parameters. The weights keep their buffers
+ * during the lifetime of a Program, so they are packed by the first call only.
+ */
+template <typename PackedT>
+class PackedBCache {
+ public:
+  using Key = std::tuple<const void*, int, int, bool, int, int>;
+
+  std::shared_ptr<const PackedT> Get(const Key& key, const std::function<std::shared_ptr<const PackedT>()>& pack) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) return it->second;
+    auto res    = pack();
+    cache_[key] = res;
+    return res;
+  }
+
+  static PackedBCache& Global() {
+    static PackedBCache cache;
+    return cache;
+  }
+
+ private:
+  std::mutex mtx_;
+  std::map<Key, std::shared_ptr<const PackedT>> cache_;
+};
+
+template <typename PackedT>
+std::shared_ptr<const PackedT> GetPackedB(bool constant_b,
+                                          const typename PackedBCache<PackedT>::Key& key,
+                                          const std::function<std::shared_ptr<const PackedT>()>& pack) {
+  return constant_b ? PackedBCache<PackedT>::Global().Get(key, pack) : pack();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// fp32
+////////////////////////////////////////////////////////////////////////////////
+
+// c[MR x NR] (+)= a[kc x MR] * b[kc x NR], the panels are stored k by k.
+using MicroKernelFp32 = void (*)(int kc, const float* a, const float* b, float* c, int ldc, bool accumulate);
+
+struct KernelFp32 {
+  int mr;
+  int nr;
+  MicroKernelFp32 fn;
+};
+
+template <int MR, int NR>
+void MicroKernelGenericFp32(int kc, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  float acc[MR][NR] = {};
+  for (int k = 0; k < kc; ++k) {
+    for (int i = 0; i < MR; ++i) {
+      for (int j = 0; j < NR; ++j) {
+        acc[i][j] += a[k * MR + i] * b[k * NR + j];
+      }
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    for (int j = 0; j < NR; ++j) {
+      c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+    }
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <int MR, int NR>
+__attribute__((target("avx2,fma"))) void MicroKernelAVX2Fp32(
+    int kc, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  constexpr int NV = NR / 8;
+  __m256 acc[MR][NV];
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) acc[i][v] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m256 bv[NV];
+    for (int v = 0; v < NV; ++v) bv[v] = _mm256_loadu_ps(b + k * NR + v * 8);
+    for (int i = 0; i < MR; ++i) {
+      __m256 av = _mm256_broadcast_ss(a + k * MR + i);
+      for (int v = 0; v < NV; ++v) acc[i][v] = _mm256_fmadd_ps(av, bv[v], acc[i][v]);
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) {
+      float* dst = c + i * ldc + v * 8;
+      _mm256_storeu_ps(dst, accumulate ? _mm256_add_ps(_mm256_loadu_ps(dst), acc[i][v]) : acc[i][v]);
+    }
+  }
+}
+
+template <int MR, int NR>
+__attribute__((target("avx512f"))) void MicroKernelAVX512Fp32(
+    int kc, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  constexpr int NV = NR / 16;
+  __m512 acc[MR][NV];
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) acc[i][v] = _mm512_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m512 bv[NV];
+    for (int v = 0; v < NV; ++v) bv[v] = _mm512_loadu_ps(b + k * NR + v * 16);
+    for (int i = 0; i < MR; ++i) {
+      __m512 av = _mm512_set1_ps(a[k * MR + i]);
+      for (int v = 0; v < NV; ++v) acc[i][v] = _mm512_fmadd_ps(av, bv[v], acc[i][v]);
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) {
+      float* dst = c + i * ldc + v * 16;
+      _mm512_storeu_ps(dst, accumulate ? _mm512_add_ps(_mm512_loadu_ps(dst), acc[i][v]) : acc[i][v]);
+    }
+  }
+}
+#endif
+
+// 12 x 32 on AVX-512 and 6 x 16 on AVX2 keep the accumulators, a row of B and a broadcast of A in the vector registers.
+const KernelFp32& SelectKernelFp32() {
+  static const KernelFp32 kernel = []() -> KernelFp32 {
+#if defined(__x86_64__) || defined(__i386__)
+    const auto& target = cinn::common::DefaultHostTarget();
+    if (target.x86_supports(Target::X86Feature::AVX512F)) return {12, 32, MicroKernelAVX512Fp32<12, 32>};
+    if (target.x86_supports(Target::X86Feature::AVX2) && target.x86_supports(Target::X86Feature::FMA)) {
+      return {6, 16, MicroKernelAVX2Fp32<6, 16>};
+    }
+#endif
+    return {4, 16, MicroKernelGenericFp32<4, 16>};
+  }();
+  return kernel;
+}
+
+// The panels of nr columns of op(B), each one is K x nr and the columns out of N are zero.
+std::shared_ptr<const std::vector<float>> PackBFp32(const float* B, int K, int N, bool tb, int ldb, int nr) {
+  int num_panels = (N + nr - 1) / nr;
+  auto res       = std::make_shared<std::vector<float>>(static_cast<size_t>(num_panels) * K * nr, 0.f);
+  float* dst     = res->data();
+  for (int p = 0; p < num_panels; ++p) {
+    for (int k = 0; k < K; ++k) {
+      for (int jj = 0; jj < nr; ++jj) {
+        int j = p * nr + jj;
+        if (j < N) dst[jj] = tb ? B[static_cast<size_t>(j) * ldb + k] : B[static_cast<size_t>(k) * ldb + j];
+      }
+      dst += nr;
+    }
+  }
+  return res;
+}
+
+// The panels of mr rows of the block alpha * op(A)[i0:i0+m_len, p0:p0+k_len], the rows out of M are zero.
+void PackAFp32(
+    const float* A, int lda, bool ta, float alpha, int M, int i0, int m_len, int p0, int k_len, int mr, float* dst) {
+  for (int ir = 0; ir < m_len; ir += mr) {
+    for (int k = p0; k < p0 + k_len; ++k) {
+      for (int ii = 0; ii < mr; ++ii) {
+        int i   = i0 + ir + ii;
+        dst[ii] = i < M ? alpha * (ta ? A[static_cast<size_t>(k) * lda + i] : A[static_cast<size_t>(i) * lda + k]) : 0.f;
+      }
+      dst += mr;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// int8
+////////////////////////////////////////////////////////////////////////////////
+
+// The groups of 4 along K are multiplied and summed into an int32 lane, like the VNNI instruction vpdpbusd.
+constexpr int kGroupK = 4;
+
+// c[MR x NR] (+)= a[kc4 x MR x 4] (uint8) * b[kc4 x NR x 4] (int8)
+using MicroKernelInt8 = void (*)(int kc4, const uint8_t* a, const int8_t* b, int32_t* c, int ldc, bool accumulate);
+
+struct KernelInt8 {
+  int mr;
+  int nr;
+  MicroKernelInt8 fn;
+};
+
+struct PackedBInt8 {
+  std::vector<int8_t> data;
+  // the sums of the columns of B, to compensate the shift of the signed A
+  std::vector<int32_t> col_sums;
+};
+
+template <int MR, int NR>
+void MicroKernelGenericInt8(int kc4, const uint8_t* a, const int8_t* b, int32_t* c, int ldc, bool accumulate) {
+  int32_t acc[MR][NR] = {};
+  for (int k = 0; k < kc4; ++k) {
+    for (int i = 0; i < MR; ++i) {
+      const uint8_t* ai = a + (k * MR + i) * kGroupK;
+      for (int j = 0; j < NR; ++j) {
+        const int8_t* bj = b + (k * NR + j) * kGroupK;
+        for (int t = 0; t < kGroupK; ++t) acc[i][j] += static_cast<int32_t>(ai[t]) * bj[t];
+      }
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    for (int j = 0; j < NR; ++j) {
+      c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+    }
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <int MR, int NR>
+__attribute__((target("avx512f,avx512vnni"))) void MicroKernelVNNIInt8(
+    int kc4, const uint8_t* a, const int8_t* b, int32_t* c, int ldc, bool accumulate) {
+  constexpr int NV = NR / 16;
+  __m512i acc[MR][NV];
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) acc[i][v] = _mm512_setzero_si512();
+  }
+  for (int k = 0; k < kc4; ++k) {
+    __m512i bv[NV];
+    for (int v = 0; v < NV; ++v) bv[v] = _mm512_loadu_si512(b + (k * NR + v * 16) * kGroupK);
+    for (int i = 0; i < MR; ++i) {
+      int32_t group;
+      std::memcpy(&group, a + (k * MR + i) * kGroupK, sizeof(group));
+      __m512i av = _mm512_set1_epi32(group);
+      for (int v = 0; v < NV; ++v) acc[i][v] = _mm512_dpbusd_epi32(acc[i][v], av, bv[v]);
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    for (int v = 0; v < NV; ++v) {
+      int32_t* dst = c + i * ldc + v * 16;
+      __m512i res  = accumulate ? _mm512_add_epi32(_mm512_loadu_si512(dst), acc[i][v]) : acc[i][v];
+      _mm512_storeu_si512(dst, res);
+    }
+  }
+}
+#endif
+
+const KernelInt8& SelectKernelInt8() {
+  static const KernelInt8 kernel = []() -> KernelInt8 {
+#if defined(__x86_64__) || defined(__i386__)
+    const auto& target = cinn::common::DefaultHostTarget();
+    if (target.x86_supports(Target::X86Feature::AVX512_VNNI)) return {8, 32, MicroKernelVNNIInt8<8, 32>};
+#endif
+    return {4, 16, MicroKernelGenericInt8<4, 16>};
+  }();
+  return kernel;
+}
+
+// The panels of nr columns of op(B), each one is ceil(K / 4) x nr x 4, the padding is zero.
+std::shared_ptr<const PackedBInt8> PackBInt8(const int8_t* B, int K, int N, bool tb, int ldb, int nr) {
+  int num_panels = (N + nr - 1) / nr;
+  int k_groups   = RoundUp(K, kGroupK) / kGroupK;
+  auto res       = std::make_shared<PackedBInt8>();
+  res->data.assign(static_cast<size_t>(num_panels) * k_groups * nr * kGroupK, 0);
+  res->col_sums.assign(N, 0);
+  int8_t* dst = res->data.data();
+  for (int p = 0; p < num_panels; ++p) {
+    for (int kg = 0; kg < k_groups; ++kg) {
+      for (int jj = 0; jj < nr; ++jj) {
+        int j = p * nr + jj;
+        for (int t = 0; t < kGroupK; ++t) {
+          int k = kg * kGroupK + t;
+          if (j >= N || k >= K) continue;
+          int8_t val = tb ? B[static_cast<size_t>(j) * ldb + k] : B[static_cast<size_t>(k) * ldb + j];
+          dst[jj * kGroupK + t] = val;
+          res->col_sums[j] += val;
+        }
+      }
+      dst += nr * kGroupK;
+    }
+  }
+  return res;
+}
+
+// The panels of mr rows of the block A[i0:i0+m_len, p0:p0+k_len] as uint8, the signed A is shifted by 128.
+void PackAInt8(
+    const uint8_t* A, int lda, bool a_signed, int M, int i0, int m_len, int p0, int k_len, int mr, uint8_t* dst) {
+  int k_groups = RoundUp(k_len, kGroupK) / kGroupK;
+  for (int ir = 0; ir < m_len; ir += mr) {
+    for (int kg = 0; kg < k_groups; ++kg) {
+      for (int ii = 0; ii < mr; ++ii) {
+        int i = i0 + ir + ii;
+        for (int t = 0; t < kGroupK; ++t) {
+          int k = p0 + kg * kGroupK + t;
+          if (i >= M || k >= p0 + k_len) {
+            dst[ii * kGroupK + t] = 0;
+          } else {
+            uint8_t val           = A[static_cast<size_t>(i) * lda + k];
+            dst[ii * kGroupK + t] = a_signed ? val ^ 0x80 : val;
+          }
+        }
+      }
+      dst += mr * kGroupK;
+    }
+  }
+}
+
+}  // namespace
+
+void cinn_cpu_packed_gemm_fp32(float alpha,
+                               int M,
+                               int N,
+                               int K,
+                               bool ta,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               bool constant_b,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C) {
+  const float* a_data = reinterpret_cast<const float*>(A->memory);
+  const float* b_data = reinterpret_cast<const float*>(B->memory);
+  float* c_data       = reinterpret_cast<float*>(C->memory);
+  if (K == 0) {
+    for (int i = 0; i < M; ++i) std::fill(c_data + static_cast<size_t>(i) * ldc, c_data + i * ldc + N, 0.f);
+    return;
+  }
+
+  const auto& kernel = SelectKernelFp32();
+  const int mr = kernel.mr, nr = kernel.nr;
+  auto packed_b = GetPackedB<std::vector<float>>(
+      constant_b, {b_data, K, N, tb, ldb, nr}, [&] { return PackBFp32(b_data, K, N, tb, ldb, nr); });
+  const float* panels = packed_b->data();
+
+  ParallelTiles(M, N, mr * kTileRowPanels, nr * kTileColPanels, [&](int i0, int m_len, int j0, int n_len) {
+    std::vector<float> packed_a(static_cast<size_t>(RoundUp(m_len, mr)) * std::min(kBlockK, K));
+    float edge[kMaxMR * kMaxNR];
+    for (int p0 = 0; p0 < K; p0 += kBlockK) {
+      int k_len = std::min(kBlockK, K - p0);
+      PackAFp32(a_data, lda, ta, alpha, M, i0, m_len, p0, k_len, mr, packed_a.data());
+      for (int jr = 0; jr < n_len; jr += nr) {
+        int j                = j0 + jr;
+        int n_valid          = std::min(nr, N - j);
+        const float* b_panel = panels + static_cast<size_t>(j / nr) * K * nr + static_cast<size_t>(p0) * nr;
+        for (int ir = 0; ir < m_len; ir += mr) {
+          int i                = i0 + ir;
+          int m_valid          = std::min(mr, M - i);
+          const float* a_panel = packed_a.data() + static_cast<size_t>(ir) * k_len;
+          float* c_tile        = c_data + static_cast<size_t>(i) * ldc + j;
+          if (m_valid == mr && n_valid == nr) {
+            kernel.fn(k_len, a_panel, b_panel, c_tile, ldc, p0 > 0);
+            continue;
+          }
+          kernel.fn(k_len, a_panel, b_panel, edge, nr, false);
+          for (int ii = 0; ii < m_valid; ++ii) {
+            for (int jj = 0; jj < n_valid; ++jj) {
+              float& dst = c_tile[ii * ldc + jj];
+              dst        = p0 > 0 ? dst + edge[ii * nr + jj] : edge[ii * nr + jj];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void cinn_cpu_packed_gemm_int8(int M,
+                               int N,
+                               int K,
+                               bool a_signed,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               bool constant_b,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C) {
+  const uint8_t* a_data = reinterpret_cast<const uint8_t*>(A->memory);
+  const int8_t* b_data  = reinterpret_cast<const int8_t*>(B->memory);
+  int32_t* c_data       = reinterpret_cast<int32_t*>(C->memory);
+  if (K == 0) {
+    for (int i = 0; i < M; ++i) std::fill(c_data + static_cast<size_t>(i) * ldc, c_data + i * ldc + N, 0);
+    return;
+  }
+
+  const auto& kernel = SelectKernelInt8();
+  const int mr = kernel.mr, nr = kernel.nr;
+  auto packed_b = GetPackedB<PackedBInt8>(
+      constant_b, {b_data, K, N, tb, ldb, nr}, [&] { return PackBInt8(b_data, K, N, tb, ldb, nr); });
+  const int8_t* panels = packed_b->data.data();
+  const int k_padded   = RoundUp(K, kGroupK);
+
+  ParallelTiles(M, N, mr * kTileRowPanels, nr * kTileColPanels, [&](int i0, int m_len, int j0, int n_len) {
+    std::vector<uint8_t> packed_a(static_cast<size_t>(RoundUp(m_len, mr)) * std::min(kBlockK, k_padded));
+    int32_t edge[kMaxMR * kMaxNR];
+    // kBlockK is a multiple of 4, so only the last block has a partial group
+    for (int p0 = 0; p0 < K; p0 += kBlockK) {
+      int k_len    = std::min(kBlockK, K - p0);
+      int k_groups = RoundUp(k_len, kGroupK) / kGroupK;
+      PackAInt8(a_data, lda, a_signed, M, i0, m_len, p0, k_len, mr, packed_a.data());
+      for (int jr = 0; jr < n_len; jr += nr) {
+        int j                 = j0 + jr;
+        int n_valid           = std::min(nr, N - j);
+        const int8_t* b_panel = panels + static_cast<size_t>(j / nr) * k_padded * nr + static_cast<size_t>(p0) * nr;
+        for (int ir = 0; ir < m_len; ir += mr) {
+          int i                  = i0 + ir;
+          int m_valid            = std::min(mr, M - i);
+          const uint8_t* a_panel = packed_a.data() + static_cast<size_t>(ir) * k_groups * kGroupK;
+          int32_t* c_tile        = c_data + static_cast<size_t>(i) * ldc + j;
+          if (m_valid == mr && n_valid == nr) {
+            kernel.fn(k_groups, a_panel, b_panel, c_tile, ldc, p0 > 0);
+            continue;
+          }
+          kernel.fn(k_groups, a_panel, b_panel, edge, nr, false);
+          for (int ii = 0; ii < m_valid; ++ii) {
+            for (int jj = 0; jj < n_valid; ++jj) {
+              int32_t& dst = c_tile[ii * ldc + jj];
+              dst          = p0 > 0 ? dst + edge[ii * nr + jj] : edge[ii * nr + jj];
+            }
+          }
+        }
+      }
+    }
+    if (a_signed) {
+      // (A + 128) * B - 128 * sum(B)
+      for (int i = i0; i < i0 + m_len; ++i) {
+        for (int j = j0; j < j0 + n_len; ++j) {
+          c_data[static_cast<size_t>(i) * ldc + j] -= 128 * packed_b->col_sums[j];
+        }
+      }
+    }
+  });
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_packed_gemm) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_gemm = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 12UL) << "Wrong number of arguments passed in";
+    return std::vector<Expr>{common::AutoSimplify(args[1]), common::AutoSimplify(args[2])};
+  };
+
+  FunctionProto::shape_inference_t inference_shape_gemm_int8 = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 11UL) << "Wrong number of arguments passed in";
+    return std::vector<Expr>{common::AutoSimplify(args[0]), common::AutoSimplify(args[1])};
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_packed_gemm_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<bool>()             // constant_b
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_packed_gemm_int8, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // a_signed
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<bool>()             // constant_b
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm_int8)
+      .End();
+
+  return true;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file defines the C APIs of the packed GEMM. The matrices are packed into panels, which are multiplied by
+//! a register-blocked micro-kernel chosen by the features of the host CPU, and the output tiles are split to the
+//! threads of the parallel backend.
+#include "cinn/runtime/cinn_runtime.h"
+
+// define some C APIs
+extern "C" {
+
+/**
+ * \brief Do GEMM on buffer A and B and write result to buffer C, that is C = alpha * op(A) * op(B).
+ * @param alpha The scaling factor of the product of A and B
+ * @param M Number of the rows of C
+ * @param N the number of the columns in both B and C
+ * @param K the number of columns of op(A)
+ * @param ta whether to transpose A
+ * @param tb whether to transpose B
+ * @param lda The size of the first dimension of A
+ * @param ldb The size of the first dimension of B
+ * @param ldc The size of the first dimension of C
+ * @param constant_b whether B is a constant weight, its packed panels are made by the first call and reused by the
+ * later ones, so B must not change in its buffer
+ * @param A The matrix A
+ * @param B The matrix B
+ * @param C The output matrix
+ */
+void cinn_cpu_packed_gemm_fp32(float alpha,
+                               int M,
+                               int N,
+                               int K,
+                               bool ta,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               bool constant_b,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C);
+
+/**
+ * \brief Do GEMM on the 8-bit integer buffer A and B and write the int32 result to buffer C, the products are computed
+ * by the VNNI instructions if the CPU supports them.
+ * @param M Number of the rows of A and C
+ * @param N the number of the columns in both B and C
+ * @param K the number of columns of A
+ * @param a_signed whether A is int8, otherwise uint8, B is always int8
+ * @param tb whether to transpose B
+ * @param lda The size of the first dimension of A
+ * @param ldb The size of the first dimension of B
+ * @param ldc The size of the first dimension of C
+ * @param constant_b whether B is a constant weight, see cinn_cpu_packed_gemm_fp32
+ * @param A The matrix A
+ * @param B The matrix B
+ * @param C The output matrix
+ */
+void cinn_cpu_packed_gemm_int8(int M,
+                               int N,
+                               int K,
+                               bool a_signed,
+                               bool tb,
+                               int lda,
+                               int ldb,
+                               int ldc,
+                               bool constant_b,
+                               cinn_buffer_t* A,
+                               cinn_buffer_t* B,
+                               cinn_buffer_t* C);
+}  // extern "C"
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/packed_gemm.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+template <typename T>
+cinn_buffer_t WrapBuffer(std::vector<T>* data) {
+  cinn_buffer_t buffer;
+  buffer.memory = reinterpret_cast<uint8_t*>(data->data());
+  return buffer;
+}
+
+// The shapes are not multiples of the micro-kernels, and K spans several blocks.
+TEST(PackedGemm, fp32) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (bool ta : {false, true}) {
+    for (bool tb : {false, true}) {
+      const int M = 37, N = 53, K = 300;
+      const float alpha = 0.5f;
+      std::vector<float> A(M * K), B(K * N), C(M * N);
+      for (auto& v : A) v = dist(rng);
+      for (auto& v : B) v = dist(rng);
+      int lda = ta ? M : K;
+      int ldb = tb ? K : N;
+      auto a  = WrapBuffer(&A);
+      auto b  = WrapBuffer(&B);
+      auto c  = WrapBuffer(&C);
+      cinn_cpu_packed_gemm_fp32(alpha, M, N, K, ta, tb, lda, ldb, N, /*constant_b=*/false, &a, &b, &c);
+      for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+          float expect = 0.f;
+          for (int k = 0; k < K; ++k) {
+            expect += (ta ? A[k * lda + i] : A[i * lda + k]) * (tb ? B[j * ldb + k] : B[k * ldb + j]);
+          }
+          ASSERT_NEAR(C[i * N + j], alpha * expect, 1e-3) << "ta: " << ta << ", tb: " << tb;
+        }
+      }
+    }
+  }
+}
+
+TEST(PackedGemm, int8) {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  for (bool a_signed : {false, true}) {
+    for (bool constant_b : {false, true}) {
+      const int M = 19, N = 45, K = 263;
+      std::vector<uint8_t> A(M * K);
+      std::vector<int8_t> B(K * N);
+      std::vector<int32_t> C(M * N);
+      for (auto& v : A) v = static_cast<uint8_t>(dist(rng));
+      for (auto& v : B) v = static_cast<int8_t>(dist(rng));
+      auto a = WrapBuffer(&A);
+      auto b = WrapBuffer(&B);
+      auto c = WrapBuffer(&C);
+      // run twice to reuse the cached panels of the constant B
+      for (int repeat = 0; repeat < 2; ++repeat) {
+        cinn_cpu_packed_gemm_int8(M, N, K, a_signed, /*tb=*/false, K, N, N, constant_b, &a, &b, &c);
+        for (int i = 0; i < M; ++i) {
+          for (int j = 0; j < N; ++j) {
+            int32_t expect = 0;
+            for (int k = 0; k < K; ++k) {
+              int32_t av = a_signed ? static_cast<int8_t>(A[i * K + k]) : A[i * K + k];
+              expect += av * B[k * N + j];
+            }
+            ASSERT_EQ(C[i * N + j], expect) << "a_signed: " << a_signed;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -15,6 +15,7 @@
 #include "cinn/runtime/cpu/thread_backend.h"
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #ifdef CINN_USE_OPENMP
@@ -24,8 +25,35 @@
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/thread_pool.h"
 #include "cinn/runtime/intrinsic.h"
 
+namespace {
+
+// The thread pool is used if CINN_THREAD_BACKEND=pool, or OpenMP is not available.
+bool UseThreadPool() {
+#ifdef CINN_USE_OPENMP
+  static bool use_thread_pool = [] {
+    const char* val = getenv("CINN_THREAD_BACKEND");
+    return val != nullptr && strcmp(val, "pool") == 0;
+  }();
+  return use_thread_pool;
+#else
+  return true;
+#endif  // CINN_USE_OPENMP
+}
+
+// The workers are pinned to the cores unless CINN_THREAD_AFFINITY=0.
+cinn::runtime::cpu::ThreadPool& GlobalThreadPool() {
+  static cinn::runtime::cpu::ThreadPool pool(max_concurrency() - 1, [] {
+    const char* val = getenv("CINN_THREAD_AFFINITY");
+    return val == nullptr || strcmp(val, "0") != 0;
+  }());
+  return pool;
+}
+
+}  // namespace
+
 int max_concurrency() {
   int max_concurrency = 1;
   const char* val     = getenv("CINN_NUM_THREADS");
@@ -45,7 +73,14 @@ int max_concurrency() {
 
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
   int num_workers = max_concurrency();
+  // the thread budget of the running Program
+  int budget = cinn::runtime::cpu::ThreadPool::GetThreadBudget();
+  if (budget > 0) num_workers = std::min(num_workers, budget);
   if (num_task == 0) num_task = num_workers;
+  if (UseThreadPool()) {
+    GlobalThreadPool().ParallelFor(num_task, [&](int task_id) { (*flambda)(task_id, num_task, datas); });
+    return 0;
+  }
 #ifdef CINN_USE_OPENMP
   omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
@@ -53,8 +88,6 @@ int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int n
     int thread_num = omp_get_thread_num();
     (*flambda)(thread_num, num_task, datas);
   }
-#else
-  LOG(FATAL) << "CINN host parallel launch need OpenMP! Please check.";
 #endif  // CINN_USE_OPENMP
   return 0;
 }
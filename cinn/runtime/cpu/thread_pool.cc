@@ -0,0 +1,293 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/thread_pool.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+thread_local int g_thread_budget = 0;
+
+// the number of idle loops a worker spins before sleeping
+constexpr int kSpinCount = 1024;
+
+// Parse the cpu list of linux, such as "0-3,8,10-11".
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    auto pos  = range.find('-');
+    int begin = std::atoi(range.substr(0, pos).c_str());
+    int end   = pos == std::string::npos ? begin : std::atoi(range.substr(pos + 1).c_str());
+    for (int cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// The NUMA node of each cpu, the cpus not found belong to node 0.
+std::map<int, int> GetCpuNodes() {
+  std::map<int, int> cpu2node;
+#ifdef __linux__
+  const std::string node_dir = "/sys/devices/system/node";
+  DIR* dir                   = opendir(node_dir.c_str());
+  if (dir == nullptr) return cpu2node;
+  while (auto* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(c); })) {
+      continue;
+    }
+    int node = std::atoi(name.c_str() + 4);
+    std::ifstream ifs(node_dir + "/" + name + "/cpulist");
+    std::string list;
+    if (ifs >> list) {
+      for (int cpu : ParseCpuList(list)) {
+        cpu2node[cpu] = node;
+      }
+    }
+  }
+  closedir(dir);
+#endif
+  return cpu2node;
+}
+
+// The cpus the process is allowed to run on.
+std::vector<int> GetAllowedCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    for (int cpu = 0; cpu < std::max<int>(std::thread::hardware_concurrency(), 1); ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+int GetCurrentCpu() {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+}  // namespace
+
+int ThreadPool::GetThreadBudget() { return g_thread_budget; }
+
+void ThreadPool::SetThreadBudget(int budget) { g_thread_budget = std::max(budget, 0); }
+
+ThreadPool::ThreadPool(int num_threads, bool pin_threads) {
+  auto cpu2node = GetCpuNodes();
+  auto cpus     = GetAllowedCpus();
+  auto node_of  = [&cpu2node](int cpu) {
+    auto it = cpu2node.find(cpu);
+    return it == cpu2node.end() ? 0 : it->second;
+  };
+  // the cores on the same NUMA node are adjacent, so the workers of a node are contiguous
+  std::stable_sort(cpus.begin(), cpus.end(), [&](int a, int b) { return node_of(a) < node_of(b); });
+
+  int num_nodes = 1;
+  for (auto& item : cpu2node) {
+    num_nodes = std::max(num_nodes, item.second + 1);
+  }
+  if (!cpu2node.empty()) {
+    node_of_cpu_.assign(cpu2node.rbegin()->first + 1, 0);
+    for (auto& item : cpu2node) {
+      node_of_cpu_[item.first] = item.second;
+    }
+  }
+  workers_by_node_.resize(num_nodes);
+  for (int i = 0; i < num_threads; ++i) {
+    auto worker  = std::make_unique<Worker>();
+    worker->cpu  = cpus[i % cpus.size()];
+    worker->node = node_of(worker->cpu);
+    workers_by_node_[worker->node].push_back(i);
+    all_workers_.push_back(i);
+    workers_.emplace_back(std::move(worker));
+  }
+  // the callers and thieves visit the workers on the same node first, then the others
+  num_local_workers_.resize(num_nodes);
+  for (int node = 0; node < num_nodes; ++node) {
+    num_local_workers_[node] = workers_by_node_[node].size();
+    for (int i : all_workers_) {
+      if (workers_[i]->node != node) workers_by_node_[node].push_back(i);
+    }
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    for (int victim : workers_by_node_[workers_[i]->node]) {
+      if (victim != i) workers_[i]->victims.push_back(victim);
+    }
+  }
+
+  for (int i = 0; i < num_threads; ++i) {
+    workers_[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+#ifdef __linux__
+    if (pin_threads) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(workers_[i]->cpu, &set);
+      pthread_setaffinity_np(workers_[i]->thread.native_handle(), sizeof(set), &set);
+    }
+#endif
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void ThreadPool::ParallelFor(int num_tasks, const TaskFunc& fn) {
+  if (num_tasks <= 0) return;
+  if (num_tasks == 1 || workers_.empty()) {
+    for (int task_id = 0; task_id < num_tasks; ++task_id) {
+      fn(task_id);
+    }
+    return;
+  }
+
+  Job job;
+  job.fn        = &fn;
+  job.remaining = num_tasks;
+
+  // dispatch the tasks except the first one to the workers on the NUMA node of the calling thread first, the start
+  // is rotated among them so that the concurrent callers don't queue on the same workers. A launch occupying all the
+  // workers gives the task i to the worker i - 1 instead, so the same range of a parallel loop always runs on the same
+  // NUMA node, where the pages of its buffers are placed by the first touch.
+  const std::vector<int>* candidates = &all_workers_;
+  int num_local                      = all_workers_.size();
+  int cpu                            = GetCurrentCpu();
+  if (num_tasks <= static_cast<int>(workers_.size()) && cpu >= 0 && cpu < node_of_cpu_.size()) {
+    candidates = &workers_by_node_[node_of_cpu_[cpu]];
+    num_local  = num_local_workers_[node_of_cpu_[cpu]];
+  }
+  unsigned start = num_tasks > static_cast<int>(workers_.size()) ? 0 : next_worker_.fetch_add(num_tasks - 1);
+  for (int task_id = 1; task_id < num_tasks; ++task_id) {
+    int k = task_id - 1;
+    int index = k < num_local ? candidates->at((start + k) % num_local) : candidates->at(k % candidates->size());
+    Push(index, Task{&job, task_id});
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    num_pending_ += num_tasks - 1;
+  }
+  sleep_cv_.notify_all();
+
+  // the calling thread runs the first task, then helps the workers until all the tasks are taken
+  RunTask(Task{&job, 0});
+  Task task;
+  while (job.remaining > 0 && Steal(all_workers_, &task)) {
+    RunTask(task);
+  }
+  std::unique_lock<std::mutex> lock(job.mtx);
+  job.cv.wait(lock, [&job] { return job.remaining == 0; });
+}
+
+void ThreadPool::WorkerLoop(int index) {
+  auto* worker = workers_[index].get();
+  int idle     = 0;
+  while (!stop_) {
+    Task task;
+    if (Pop(index, &task) || Steal(worker->victims, &task)) {
+      RunTask(task);
+      idle = 0;
+      continue;
+    }
+    if (++idle < kSpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mtx_);
+    sleep_cv_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+    idle = 0;
+  }
+}
+
+void ThreadPool::Push(int index, const Task& task) {
+  std::lock_guard<std::mutex> lock(workers_[index]->mtx);
+  workers_[index]->tasks.push_back(task);
+}
+
+bool ThreadPool::Pop(int index, Task* task) {
+  auto* worker = workers_[index].get();
+  std::lock_guard<std::mutex> lock(worker->mtx);
+  if (worker->tasks.empty()) return false;
+  *task = worker->tasks.front();
+  worker->tasks.pop_front();
+  --num_pending_;
+  return true;
+}
+
+bool ThreadPool::Steal(const std::vector<int>& victims, Task* task) {
+  for (int victim : victims) {
+    auto* worker = workers_[victim].get();
+    std::lock_guard<std::mutex> lock(worker->mtx);
+    if (worker->tasks.empty()) continue;
+    *task = worker->tasks.back();
+    worker->tasks.pop_back();
+    --num_pending_;
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::RunTask(const Task& task) {
+  (*task.job->fn)(task.task_id);
+  // decrease under the lock, so the job is not destroyed by the waiting caller before notifying
+  std::lock_guard<std::mutex> lock(task.job->mtx);
+  if (--task.job->remaining == 0) {
+    task.job->cv.notify_all();
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
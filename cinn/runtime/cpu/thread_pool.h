@@ -0,0 +1,121 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+/**
+ * A persistent work-stealing thread pool serving the parallel loops of the host kernels.
+ *
+ * Each worker owns a task queue, it pops tasks from the front of its own queue and steals from the back of the
+ * others, the workers on the same NUMA node are visited first. The workers are optionally pinned to the cores
+ * allowed for the process, which are ordered by their NUMA nodes, and the tasks of a ParallelFor are dispatched to
+ * the workers on the NUMA node of the calling thread first.
+ *
+ * Unlike a fresh OpenMP region for every parallel loop, all the Programs in a process share the fixed number of
+ * workers, so running several models concurrently doesn't oversubscribe the cores.
+ */
+class ThreadPool {
+ public:
+  using TaskFunc = std::function<void(int task_id)>;
+
+  /**
+   * @param num_threads The number of worker threads, the thread calling ParallelFor runs tasks too.
+   * @param pin_threads Whether to bind each worker to a core.
+   */
+  explicit ThreadPool(int num_threads, bool pin_threads = false);
+  ~ThreadPool();
+
+  //! Run \p fn for each task id in [0, num_tasks) and wait for all of them.
+  void ParallelFor(int num_tasks, const TaskFunc& fn);
+
+  int num_threads() const { return workers_.size(); }
+
+  //! The maximum number of tasks a parallel loop launched by the current thread is split into, 0 means unlimited.
+  static int GetThreadBudget();
+  static void SetThreadBudget(int budget);
+
+ private:
+  struct Job {
+    const TaskFunc* fn{nullptr};
+    std::atomic<int> remaining{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+  };
+
+  struct Task {
+    Job* job{nullptr};
+    int task_id{0};
+  };
+
+  struct Worker {
+    std::thread thread;
+    std::mutex mtx;
+    std::deque<Task> tasks;
+    int cpu{-1};
+    int node{0};
+    // the workers to steal from, ordered by the distance
+    std::vector<int> victims;
+  };
+
+  void WorkerLoop(int index);
+  void Push(int index, const Task& task);
+  bool Pop(int index, Task* task);
+  bool Steal(const std::vector<int>& victims, Task* task);
+  void RunTask(const Task& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // the workers visited by the calling threads on each NUMA node, the ones on the same node come first
+  std::vector<std::vector<int>> workers_by_node_;
+  std::vector<int> num_local_workers_;
+  std::vector<int> node_of_cpu_;
+  std::vector<int> all_workers_;
+
+  std::atomic<int> num_pending_{0};
+  std::atomic<unsigned> next_worker_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex sleep_mtx_;
+  std::condition_variable sleep_cv_;
+};
+
+/**
+ * Limit the parallelism of the host kernels launched by the current thread during the life time of this object,
+ * which is used to give each Program a thread budget.
+ */
+class ScopedThreadBudget {
+ public:
+  explicit ScopedThreadBudget(int budget) : prev_budget_(ThreadPool::GetThreadBudget()) {
+    if (budget > 0) ThreadPool::SetThreadBudget(budget);
+  }
+  ~ScopedThreadBudget() { ThreadPool::SetThreadBudget(prev_budget_); }
+
+ private:
+  int prev_budget_;
+};
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
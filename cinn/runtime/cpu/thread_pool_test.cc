@@ -0,0 +1,70 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPool pool(3);
+  ASSERT_EQ(pool.num_threads(), 3);
+  for (int num_tasks : {0, 1, 4, 16}) {
+    std::vector<std::atomic<int>> counters(num_tasks);
+    pool.ParallelFor(num_tasks, [&](int task_id) { counters[task_id]++; });
+    // every task runs exactly once
+    for (auto& counter : counters) {
+      ASSERT_EQ(counter.load(), 1);
+    }
+  }
+}
+
+TEST(ThreadPool, ConcurrentCallers) {
+  ThreadPool pool(2, true);
+  std::atomic<int> sum{0};
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i) {
+    callers.emplace_back([&] {
+      for (int iter = 0; iter < 100; ++iter) {
+        pool.ParallelFor(8, [&](int task_id) { sum += task_id; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  ASSERT_EQ(sum.load(), 4 * 100 * 28);
+}
+
+TEST(ThreadPool, ThreadBudget) {
+  ASSERT_EQ(ThreadPool::GetThreadBudget(), 0);
+  {
+    ScopedThreadBudget budget(2);
+    ASSERT_EQ(ThreadPool::GetThreadBudget(), 2);
+    // the budget is kept per thread
+    std::thread([] { ASSERT_EQ(ThreadPool::GetThreadBudget(), 0); }).join();
+  }
+  ASSERT_EQ(ThreadPool::GetThreadBudget(), 0);
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,230 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kArgReduceThreads       = 256;
+constexpr int kArgReduceWarpMaxSize   = 1024;
+constexpr int kArgReduceColumnThreads = 8;
+
+// The x is viewed as [outer, reduce, inner] and reduced along the middle axis, each thread keeps the best value with
+// its index and the pairs are merged through the warp shuffles and the shared memory. The equal values keep the
+// smallest index, so the results are the same as the argmax and the argmin. The float16 and the bfloat16 are
+// compared in float.
+const char* kArgReduceSource = R"(
+#if IS_MAX
+#define BETTER(a, b) ((a) > (b))
+#else
+#define BETTER(a, b) ((a) < (b))
+#endif
+
+__device__ __forceinline__ void cinn_arg_merge(CTYPE& best, int& best_index, CTYPE value, int index) {
+  if (index < 0) return;
+  if (best_index < 0 || BETTER(value, best) || (value == best && index < best_index)) {
+    best       = value;
+    best_index = index;
+  }
+}
+
+// The rows along the last axis: ROW_THREADS threads reduce a row and a block holds ROWS_PER_BLOCK rows.
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_arg_reduce_rows_kernel(const DTYPE* __restrict__ x,
+                            int rows,
+                            int reduce,
+                            DTYPE* __restrict__ value_out,
+                            int* __restrict__ index_out) {
+  const int row      = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  const DTYPE* x_row = x + static_cast<long long>(row < rows ? row : 0) * reduce;
+  CTYPE best = CTYPE();
+  int best_index = -1;
+  if (row < rows) {
+    for (int i = threadIdx.x; i < reduce; i += ROW_THREADS) {
+      cinn_arg_merge(best, best_index, static_cast<CTYPE>(x_row[i]), i);
+    }
+  }
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    CTYPE value = __shfl_down_sync(0xffffffff, best, offset);
+    int index   = __shfl_down_sync(0xffffffff, best_index, offset);
+    cinn_arg_merge(best, best_index, value, index);
+  }
+#if ROW_THREADS > 32
+  __shared__ CTYPE s_value[ROWS_PER_BLOCK][ROW_THREADS / 32];
+  __shared__ int s_index[ROWS_PER_BLOCK][ROW_THREADS / 32];
+  if ((threadIdx.x & 31) == 0) {
+    s_value[threadIdx.y][threadIdx.x >> 5] = best;
+    s_index[threadIdx.y][threadIdx.x >> 5] = best_index;
+  }
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    for (int w = 1; w < ROW_THREADS / 32; ++w) {
+      cinn_arg_merge(best, best_index, s_value[threadIdx.y][w], s_index[threadIdx.y][w]);
+    }
+  }
+#endif
+  if (threadIdx.x == 0 && row < rows) {
+    value_out[row] = static_cast<DTYPE>(best);
+    index_out[row] = best_index;
+  }
+}
+
+// The inner axis is not reduced: 32 adjacent columns of the inner share a block, so the loads are coalesced, and
+// the COLUMN_THREADS threads of a column split the reduce axis.
+extern "C" __global__ void __launch_bounds__(32 * COLUMN_THREADS)
+cinn_arg_reduce_columns_kernel(const DTYPE* __restrict__ x,
+                               int outer,
+                               int reduce,
+                               int inner,
+                               DTYPE* __restrict__ value_out,
+                               int* __restrict__ index_out) {
+  __shared__ CTYPE s_value[COLUMN_THREADS][33];
+  __shared__ int s_index[COLUMN_THREADS][33];
+  const long long col = blockIdx.x * 32LL + threadIdx.x;
+  const bool active   = col < static_cast<long long>(outer) * inner;
+  const DTYPE* x_col  = x + (active ? (col / inner * reduce) * inner + col % inner : 0);
+  CTYPE best = CTYPE();
+  int best_index = -1;
+  if (active) {
+    for (int i = threadIdx.y; i < reduce; i += COLUMN_THREADS) {
+      cinn_arg_merge(best, best_index, static_cast<CTYPE>(x_col[static_cast<long long>(i) * inner]), i);
+    }
+  }
+  s_value[threadIdx.y][threadIdx.x] = best;
+  s_index[threadIdx.y][threadIdx.x] = best_index;
+  __syncthreads();
+  if (threadIdx.y == 0 && active) {
+    for (int t = 1; t < COLUMN_THREADS; ++t) {
+      cinn_arg_merge(best, best_index, s_value[t][threadIdx.x], s_index[t][threadIdx.x]);
+    }
+    value_out[col] = static_cast<DTYPE>(best);
+    index_out[col] = best_index;
+  }
+}
+)";
+
+// Return the names of the stored and the compared types.
+std::pair<std::string, std::string> GetArgReduceTypes(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return {"float", "float"};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 64) {
+    return {"double", "double"};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return {"float16", "float"};
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return {"bfloat16", "float"};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return {"int", "int"};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return {"long long", "long long"};
+  }
+  LOG(FATAL) << "The arg_reduce only supports float32, float64, float16, bfloat16, int32 and int64, but got the type "
+             << "code " << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return {};
+}
+
+// The kernels are compiled by NVRTC once for each dtype, direction and number of the threads of a row.
+CUDAModule* GetArgReduceModule(const cinn_type_t& type, bool is_max, int row_threads) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto types = GetArgReduceTypes(type);
+  auto key   = types.first + (is_max ? "_max_" : "_min_") + std::to_string(row_threads);
+  auto it    = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + types.first + "\n";
+  source += "#define CTYPE " + types.second + "\n";
+  source += std::string("#define IS_MAX ") + (is_max ? "1" : "0") + "\n";
+  source += "#define ROW_THREADS " + std::to_string(row_threads) + "\n";
+  source += "#define ROWS_PER_BLOCK " + std::to_string(kArgReduceThreads / row_threads) + "\n";
+  source += "#define COLUMN_THREADS " + std::to_string(kArgReduceColumnThreads) + "\n";
+  source += kArgReduceSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the arg_reduce kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+}  // namespace
+
+void cinn_call_arg_reduce_nvgpu(
+    void* v_args, int num_args, int outer, int reduce, int inner, bool is_max, void* stream) {
+  CHECK_EQ(num_args, 3) << "The arg_reduce takes the x and outputs the value and the index.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "arg_reduce: outer=" << outer << ", reduce=" << reduce << ", inner=" << inner << ", is_max=" << is_max;
+  if (outer == 0 || reduce == 0 || inner == 0) {
+    return;
+  }
+
+  void* x_ptr     = x->memory;
+  void* value_ptr = args[1].operator cinn_buffer_t*()->memory;
+  void* index_ptr = args[2].operator cinn_buffer_t*()->memory;
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  if (inner == 1) {
+    // the short rows are reduced by a warp each, the long rows by a block each
+    int row_threads     = reduce <= kArgReduceWarpMaxSize ? 32 : kArgReduceThreads;
+    int rows_per_block  = kArgReduceThreads / row_threads;
+    auto* module        = GetArgReduceModule(x->type, is_max, row_threads);
+    void* kernel_args[] = {&x_ptr, &outer, &reduce, &value_ptr, &index_ptr};
+    module->LaunchKernel(device_id,
+                         "cinn_arg_reduce_rows_kernel",
+                         dim3((outer + rows_per_block - 1) / rows_per_block),
+                         dim3(row_threads, rows_per_block),
+                         kernel_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    return;
+  }
+  auto* module        = GetArgReduceModule(x->type, is_max, 32);
+  long long columns   = static_cast<long long>(outer) * inner;
+  void* kernel_args[] = {&x_ptr, &outer, &reduce, &inner, &value_ptr, &index_ptr};
+  module->LaunchKernel(device_id,
+                       "cinn_arg_reduce_columns_kernel",
+                       dim3(static_cast<unsigned int>((columns + 31) / 32)),
+                       dim3(32, kArgReduceColumnThreads),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,423 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kBatchNormThreads       = 256;
+constexpr int kBatchNormColumnRows    = 8;
+constexpr int kBatchNormChunkElements = 4096;
+constexpr int kBatchNormChunkRows     = 128;
+constexpr int kBatchNormMaxChunks     = 64;
+
+// The x is viewed as [outer, channels, inner], which is [N, C, H * W] for NCHW and [N * H * W, C, 1] for NHWC. The
+// statistics of each channel are reduced in two stages: the blocks reduce the chunks of the channel into the partial
+// buffer, then the partial statistics of the chunks are merged in order, so the results are deterministic. The
+// forward reduces the mean and the variance by the single-pass Welford algorithm, the backward reduces the sum of dy
+// and the sum of dy * (x - mean). The finalize stage turns the statistics into the per-channel coefficients, so the
+// normalization, the affine transform and the gradient of x are all computed by one elementwise pass.
+const char* kBatchNormSource = R"(
+struct BNStats {
+  float a;
+  float b;
+  float n;
+};
+
+#if BACKWARD
+__device__ __forceinline__ void cinn_bn_update(BNStats& s, const DTYPE* x, const DTYPE* dy, const float* mean,
+                                               long long idx, int c) {
+  float g = static_cast<float>(dy[idx]);
+  s.a += g;
+  s.b += g * (static_cast<float>(x[idx]) - mean[c]);
+}
+
+__device__ __forceinline__ void cinn_bn_merge(BNStats& s, const BNStats& o) {
+  s.a += o.a;
+  s.b += o.b;
+}
+#else
+__device__ __forceinline__ void cinn_bn_update(BNStats& s, const DTYPE* x, const DTYPE* dy, const float* mean,
+                                               long long idx, int c) {
+  float value = static_cast<float>(x[idx]);
+  s.n += 1.0f;
+  float delta = value - s.a;
+  s.a += delta / s.n;
+  s.b += delta * (value - s.a);
+}
+
+__device__ __forceinline__ void cinn_bn_merge(BNStats& s, const BNStats& o) {
+  float n = s.n + o.n;
+  if (n == 0.0f) return;
+  float delta = o.a - s.a;
+  float ratio = o.n / n;
+  s.a += delta * ratio;
+  s.b += o.b + delta * delta * s.n * ratio;
+  s.n = n;
+}
+#endif
+
+// The channels-first layout: a block reduces a chunk of one channel, whose elements are contiguous along the inner.
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_batch_norm_reduce_kernel(const DTYPE* __restrict__ x,
+                              const DTYPE* __restrict__ dy,
+                              const float* __restrict__ mean,
+                              int channels,
+                              int inner,
+                              long long elements,
+                              long long elements_per_chunk,
+                              BNStats* __restrict__ partial) {
+  const int c         = blockIdx.x;
+  const long long end = min(elements, (blockIdx.y + 1) * elements_per_chunk);
+  BNStats s = {0.0f, 0.0f, 0.0f};
+  for (long long j = blockIdx.y * elements_per_chunk + threadIdx.x; j < end; j += THREADS) {
+    cinn_bn_update(s, x, dy, mean, (j / inner * channels + c) * inner + j % inner, c);
+  }
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    BNStats o = {__shfl_down_sync(0xffffffff, s.a, offset),
+                 __shfl_down_sync(0xffffffff, s.b, offset),
+                 __shfl_down_sync(0xffffffff, s.n, offset)};
+    cinn_bn_merge(s, o);
+  }
+  __shared__ BNStats s_warp[THREADS / 32];
+  if ((threadIdx.x & 31) == 0) {
+    s_warp[threadIdx.x >> 5] = s;
+  }
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    for (int w = 1; w < THREADS / 32; ++w) {
+      cinn_bn_merge(s, s_warp[w]);
+    }
+    partial[static_cast<long long>(blockIdx.y) * channels + c] = s;
+  }
+}
+
+// The channels-last layout: a block reduces a chunk of rows for 32 adjacent channels, so the loads are coalesced.
+extern "C" __global__ void __launch_bounds__(32 * COLUMN_ROWS)
+cinn_batch_norm_reduce_columns_kernel(const DTYPE* __restrict__ x,
+                                      const DTYPE* __restrict__ dy,
+                                      const float* __restrict__ mean,
+                                      int channels,
+                                      long long rows,
+                                      long long rows_per_chunk,
+                                      BNStats* __restrict__ partial) {
+  __shared__ BNStats s_rows[COLUMN_ROWS][33];
+  const int c         = blockIdx.x * 32 + threadIdx.x;
+  const long long end = min(rows, (blockIdx.y + 1) * rows_per_chunk);
+  BNStats s = {0.0f, 0.0f, 0.0f};
+  if (c < channels) {
+    for (long long row = blockIdx.y * rows_per_chunk + threadIdx.y; row < end; row += COLUMN_ROWS) {
+      cinn_bn_update(s, x, dy, mean, row * channels + c, c);
+    }
+  }
+  s_rows[threadIdx.y][threadIdx.x] = s;
+  __syncthreads();
+  if (threadIdx.y == 0 && c < channels) {
+    for (int r = 1; r < COLUMN_ROWS; ++r) {
+      cinn_bn_merge(s, s_rows[r][threadIdx.x]);
+    }
+    partial[static_cast<long long>(blockIdx.y) * channels + c] = s;
+  }
+}
+
+// The forward writes the saved and the moving statistics with y = x * a + b, where a = scale * inv_std and
+// b = bias - mean * a. The backward writes the dscale and the dbias with dx = dy * a + x * b + d, where
+// a = scale * inv_std, b = -a * inv_std^2 * sum(dy * (x - mean)) / M and d = -a * sum(dy) / M - b * mean.
+extern "C" __global__ void cinn_batch_norm_finalize_kernel(const BNStats* __restrict__ partial,
+                                                           int num_chunks,
+                                                           int channels,
+                                                           float elements,
+                                                           float epsilon,
+                                                           float momentum,
+                                                           const float* __restrict__ scale,
+                                                           const float* __restrict__ bias,
+                                                           const float* __restrict__ in_mean,
+                                                           const float* __restrict__ in_variance,
+                                                           float* __restrict__ out0,
+                                                           float* __restrict__ out1,
+                                                           float* __restrict__ out_mean,
+                                                           float* __restrict__ out_variance,
+                                                           float* __restrict__ coef) {
+  const int c = blockIdx.x * blockDim.x + threadIdx.x;
+  if (c >= channels) return;
+  BNStats s = partial[c];
+  for (int k = 1; k < num_chunks; ++k) {
+    cinn_bn_merge(s, partial[static_cast<long long>(k) * channels + c]);
+  }
+#if BACKWARD
+  const float inv_std = rsqrtf(in_variance[c] + epsilon);
+  const float a       = scale[c] * inv_std;
+  const float b       = -a * inv_std * inv_std * s.b / elements;
+  out0[c] = s.b * inv_std;
+  out1[c] = s.a;
+  coef[c] = a;
+  coef[channels + c]     = b;
+  coef[2 * channels + c] = -a * s.a / elements - b * in_mean[c];
+#else
+  const float variance = fmaxf(s.b / elements, 0.0f);
+  const float a        = scale[c] * rsqrtf(variance + epsilon);
+  out0[c] = s.a;
+  out1[c] = variance;
+  out_mean[c]     = in_mean[c] * momentum + (1.0f - momentum) * s.a;
+  out_variance[c] = in_variance[c] * momentum + (1.0f - momentum) * variance;
+  coef[c] = a;
+  coef[channels + c] = bias[c] - s.a * a;
+#endif
+}
+
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_batch_norm_apply_kernel(const DTYPE* __restrict__ x,
+                             const DTYPE* __restrict__ dy,
+                             const float* __restrict__ coef,
+                             int channels,
+                             int inner,
+                             long long total,
+                             DTYPE* __restrict__ out) {
+  for (long long idx = blockIdx.x * static_cast<long long>(THREADS) + threadIdx.x; idx < total;
+       idx += static_cast<long long>(gridDim.x) * THREADS) {
+    const int c       = (idx / inner) % channels;
+    const float value = static_cast<float>(x[idx]);
+#if BACKWARD
+    out[idx] = static_cast<DTYPE>(static_cast<float>(dy[idx]) * coef[c] + value * coef[channels + c] +
+                                  coef[2 * channels + c]);
+#else
+    out[idx] = static_cast<DTYPE>(value * coef[c] + coef[channels + c]);
+#endif
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  }
+  LOG(FATAL) << "The batch_norm kernels only support float32, float16 and bfloat16, but got the type code "
+             << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+// The kernels are compiled by NVRTC once for each dtype and direction.
+CUDAModule* GetBatchNormModule(const cinn_type_t& type, bool backward) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto dtype = GetDTypeName(type);
+  auto key   = dtype + (backward ? "_backward" : "_forward");
+  auto it    = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define THREADS " + std::to_string(kBatchNormThreads) + "\n";
+  source += "#define COLUMN_ROWS " + std::to_string(kBatchNormColumnRows) + "\n";
+  source += std::string("#define BACKWARD ") + (backward ? "1" : "0") + "\n";
+  source += kBatchNormSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the batch_norm kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+// Launch the three stages of the batch_norm or its gradient. The finalize arguments are the scale, the bias, the
+// mean, the variance and the four per-channel outputs, the unused ones of the backward are null.
+void LaunchBatchNorm(const cinn_type_t& type,
+                     bool backward,
+                     void* x,
+                     void* dy,
+                     void* out,
+                     int channels,
+                     int outer,
+                     int inner,
+                     float epsilon,
+                     float momentum,
+                     void* finalize_params[8],
+                     void* stream) {
+  long long elements = static_cast<long long>(outer) * inner;
+  long long total    = elements * channels;
+  long long chunk    = inner > 1 ? kBatchNormChunkElements : kBatchNormChunkRows;
+  int num_chunks     = static_cast<int>(std::min<long long>((elements + chunk - 1) / chunk, kBatchNormMaxChunks));
+  long long per_chunk = (elements + num_chunks - 1) / num_chunks;
+
+  auto cuda_stream = static_cast<cudaStream_t>(stream);
+  auto cu_stream   = static_cast<CUstream>(stream);
+  void* partial;
+  void* coef;
+  CUDA_CALL(cudaMallocAsync(&partial, sizeof(float) * 3 * num_chunks * channels, cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&coef, sizeof(float) * 3 * channels, cuda_stream));
+
+  auto* module = GetBatchNormModule(type, backward);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  // the mean of the backward is the saved mean passed to the finalize stage
+  void* mean = backward ? finalize_params[2] : nullptr;
+  if (inner > 1) {
+    void* reduce_args[] = {&x, &dy, &mean, &channels, &inner, &elements, &per_chunk, &partial};
+    module->LaunchKernel(device_id,
+                         "cinn_batch_norm_reduce_kernel",
+                         dim3(channels, num_chunks),
+                         dim3(kBatchNormThreads),
+                         reduce_args,
+                         0,
+                         cu_stream);
+  } else {
+    void* reduce_args[] = {&x, &dy, &mean, &channels, &elements, &per_chunk, &partial};
+    module->LaunchKernel(device_id,
+                         "cinn_batch_norm_reduce_columns_kernel",
+                         dim3((channels + 31) / 32, num_chunks),
+                         dim3(32, kBatchNormColumnRows),
+                         reduce_args,
+                         0,
+                         cu_stream);
+  }
+
+  float elements_f      = static_cast<float>(elements);
+  void* finalize_args[] = {&partial,
+                           &num_chunks,
+                           &channels,
+                           &elements_f,
+                           &epsilon,
+                           &momentum,
+                           &finalize_params[0],
+                           &finalize_params[1],
+                           &finalize_params[2],
+                           &finalize_params[3],
+                           &finalize_params[4],
+                           &finalize_params[5],
+                           &finalize_params[6],
+                           &finalize_params[7],
+                           &coef};
+  module->LaunchKernel(device_id,
+                       "cinn_batch_norm_finalize_kernel",
+                       dim3((channels + kBatchNormThreads - 1) / kBatchNormThreads),
+                       dim3(kBatchNormThreads),
+                       finalize_args,
+                       0,
+                       cu_stream);
+
+  int num_blocks = static_cast<int>(
+      std::min<long long>((total + kBatchNormThreads - 1) / kBatchNormThreads, std::numeric_limits<int>::max()));
+  void* apply_args[] = {&x, &dy, &coef, &channels, &inner, &total, &out};
+  module->LaunchKernel(device_id,
+                       "cinn_batch_norm_apply_kernel",
+                       dim3(num_blocks),
+                       dim3(kBatchNormThreads),
+                       apply_args,
+                       0,
+                       cu_stream);
+
+  CUDA_CALL(cudaFreeAsync(partial, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(coef, cuda_stream));
+}
+
+}  // namespace
+
+void cinn_call_batch_norm_train_nvgpu(
+    void* v_args, int num_args, int channels, int outer, int inner, float epsilon, float momentum, void* stream) {
+  CHECK_EQ(num_args, 10) << "The batch_norm_train takes the x, the scale, the bias, the moving_mean, the "
+                            "moving_variance and outputs the y, the saved_mean, the saved_variance, the "
+                            "new_moving_mean and the new_moving_variance.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "batch_norm_train: channels=" << channels << ", outer=" << outer << ", inner=" << inner
+          << ", epsilon=" << epsilon << ", momentum=" << momentum;
+  if (channels == 0 || outer == 0 || inner == 0) {
+    return;
+  }
+
+  void* finalize_params[8];
+  for (int i = 0; i < 4; ++i) {
+    finalize_params[i] = args[1 + i].operator cinn_buffer_t*()->memory;
+  }
+  for (int i = 0; i < 4; ++i) {
+    finalize_params[4 + i] = args[6 + i].operator cinn_buffer_t*()->memory;
+  }
+  LaunchBatchNorm(x->type,
+                  false,
+                  x->memory,
+                  nullptr,
+                  args[5].operator cinn_buffer_t*()->memory,
+                  channels,
+                  outer,
+                  inner,
+                  epsilon,
+                  momentum,
+                  finalize_params,
+                  stream);
+}
+
+void cinn_call_batch_norm_grad_nvgpu(
+    void* v_args, int num_args, int channels, int outer, int inner, float epsilon, void* stream) {
+  CHECK_EQ(num_args, 8) << "The batch_norm_grad takes the dy, the x, the scale, the saved_mean, the saved_variance "
+                           "and outputs the dx, the dscale and the dbias.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[1].operator cinn_buffer_t*();
+  VLOG(4) << "batch_norm_grad: channels=" << channels << ", outer=" << outer << ", inner=" << inner
+          << ", epsilon=" << epsilon;
+  if (channels == 0 || outer == 0 || inner == 0) {
+    return;
+  }
+
+  void* finalize_params[8] = {args[2].operator cinn_buffer_t*()->memory,
+                              nullptr,
+                              args[3].operator cinn_buffer_t*()->memory,
+                              args[4].operator cinn_buffer_t*()->memory,
+                              args[6].operator cinn_buffer_t*()->memory,
+                              args[7].operator cinn_buffer_t*()->memory,
+                              nullptr,
+                              nullptr};
+  LaunchBatchNorm(x->type,
+                  true,
+                  x->memory,
+                  args[0].operator cinn_buffer_t*()->memory,
+                  args[5].operator cinn_buffer_t*()->memory,
+                  channels,
+                  outer,
+                  inner,
+                  epsilon,
+                  0.0f,
+                  finalize_params,
+                  stream);
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
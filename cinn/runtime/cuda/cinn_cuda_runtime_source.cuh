@@ -2,6 +2,55 @@
  * \file This file contains all the intrinsics available to be used in CUDA code generated by CodeGen.
  */
 
+#ifdef CINN_WITH_CUDA
+// declared here instead of the generated source, so that the precompiled header of NVRTC covers them
+using cinn::common::bfloat16;
+using cinn::common::bfloat162;
+using cinn::common::bfloat164;
+using cinn::common::bfloat168;
+using cinn::common::float16;
+using cinn::common::half4;
+using cinn::common::half8;
+using cinn::common::float8;
+#endif
+
+#ifdef __CUDA_FP8_TYPES_EXIST__
+// the fp8 storage types, which are converted from and to float with the saturation to the max finite value
+typedef __nv_fp8_e4m3 float8_e4m3;
+typedef __nv_fp8_e5m2 float8_e5m2;
+#endif
+
+// the runtime functions are inline when the kernels include this source, and get the external linkage when it is
+// compiled into the device library linked with the kernels, see FLAGS_cinn_nvrtc_link_runtime_library
+#ifndef CINN_NVGPU_INLINE
+#define CINN_NVGPU_INLINE inline
+#endif
+
+// the lanes of a warp and the shuffles among them. The source is also compiled by hipRTC for the AMD GPUs, whose warp
+// is a wavefront of 64 lanes and whose shuffles are among the active lanes without a mask.
+#ifdef __HIP_PLATFORM_AMD__
+#define CINN_WARP_SIZE 64
+typedef unsigned long long cinn_lane_mask_t;
+#define CINN_ACTIVE_MASK() __ballot(1)
+#define CINN_POPC(mask) __popcll(mask)
+#define CINN_SHFL(mask, var, src_lane, width) __shfl(var, src_lane, width)
+#define CINN_SHFL_UP(mask, var, delta) __shfl_up(var, delta)
+#define CINN_SHFL_DOWN(mask, var, delta, width) __shfl_down(var, delta, width)
+#define CINN_SHFL_XOR(mask, var, lane_mask, width) __shfl_xor(var, lane_mask, width)
+#define CINN_EXIT_THREAD() __builtin_amdgcn_endpgm()
+#else
+#define CINN_WARP_SIZE 32
+typedef unsigned int cinn_lane_mask_t;
+#define CINN_ACTIVE_MASK() __activemask()
+#define CINN_POPC(mask) __popc(mask)
+#define CINN_SHFL(mask, var, src_lane, width) __shfl_sync(mask, var, src_lane, width)
+#define CINN_SHFL_UP(mask, var, delta) __shfl_up_sync(mask, var, delta)
+#define CINN_SHFL_DOWN(mask, var, delta, width) __shfl_down_sync(mask, var, delta, width)
+#define CINN_SHFL_XOR(mask, var, lane_mask, width) __shfl_xor_sync(mask, var, lane_mask, width)
+#define CINN_EXIT_THREAD() asm volatile("exit;")
+#endif
+#define CINN_FULL_LANE_MASK (~static_cast<cinn_lane_mask_t>(0))
+
 extern "C" {
 
 #define CINN_INT32_MAX 2147483647
@@ -10,122 +59,140 @@ extern "C" {
 // *************************************************************** //
 // bool unary and binary operator
 #define FN_BOOL(func) cinn_nvgpu_##func##_bool
-__device__ inline bool FN_BOOL(bitwise_and)(bool a, bool b) { return a & b; }
-__device__ inline bool FN_BOOL(bitwise_or)(bool a, bool b) { return a | b; }
-__device__ inline bool FN_BOOL(bitwise_xor)(bool a, bool b) { return a ^ b; }
-__device__ inline bool FN_BOOL(bitwise_not)(bool a) { return !a; }
+__device__ CINN_NVGPU_INLINE bool FN_BOOL(bitwise_and)(bool a, bool b) { return a & b; }
+__device__ CINN_NVGPU_INLINE bool FN_BOOL(bitwise_or)(bool a, bool b) { return a | b; }
+__device__ CINN_NVGPU_INLINE bool FN_BOOL(bitwise_xor)(bool a, bool b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE bool FN_BOOL(bitwise_not)(bool a) { return !a; }
 
 // *************************************************************** //
 // uint8 unary and binary operator
 #define FN_UINT8(func) cinn_nvgpu_##func##_uint8
-__device__ inline uint8_t FN_UINT8(bitwise_and)(uint8_t a, uint8_t b) { return a & b; }
-__device__ inline uint8_t FN_UINT8(bitwise_or)(uint8_t a, uint8_t b) { return a | b; }
-__device__ inline uint8_t FN_UINT8(bitwise_xor)(uint8_t a, uint8_t b) { return a ^ b; }
-__device__ inline uint8_t FN_UINT8(bitwise_not)(uint8_t a) { return ~a; }
-__device__ inline uint8_t FN_UINT8(logical_right_shift)(uint8_t a, uint8_t b) { return ((uint8_t)a >> b); }
+__device__ CINN_NVGPU_INLINE uint8_t FN_UINT8(bitwise_and)(uint8_t a, uint8_t b) { return a & b; }
+__device__ CINN_NVGPU_INLINE uint8_t FN_UINT8(bitwise_or)(uint8_t a, uint8_t b) { return a | b; }
+__device__ CINN_NVGPU_INLINE uint8_t FN_UINT8(bitwise_xor)(uint8_t a, uint8_t b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE uint8_t FN_UINT8(bitwise_not)(uint8_t a) { return ~a; }
+__device__ CINN_NVGPU_INLINE uint8_t FN_UINT8(logical_right_shift)(uint8_t a, uint8_t b) { return ((uint8_t)a >> b); }
 
 // *************************************************************** //
 // int8 unary and binary operator
 #define FN_INT8(func) cinn_nvgpu_##func##_int8
-__device__ inline int8_t FN_INT8(bitwise_and)(int8_t a, int8_t b) { return a & b; }
-__device__ inline int8_t FN_INT8(bitwise_or)(int8_t a, int8_t b) { return a | b; }
-__device__ inline int8_t FN_INT8(bitwise_xor)(int8_t a, int8_t b) { return a ^ b; }
-__device__ inline int8_t FN_INT8(bitwise_not)(int8_t a) { return ~a; }
-__device__ inline int8_t FN_INT8(logical_right_shift)(int8_t a, int8_t b) { return ((uint8_t)a >> b); }
+__device__ CINN_NVGPU_INLINE int8_t FN_INT8(bitwise_and)(int8_t a, int8_t b) { return a & b; }
+__device__ CINN_NVGPU_INLINE int8_t FN_INT8(bitwise_or)(int8_t a, int8_t b) { return a | b; }
+__device__ CINN_NVGPU_INLINE int8_t FN_INT8(bitwise_xor)(int8_t a, int8_t b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE int8_t FN_INT8(bitwise_not)(int8_t a) { return ~a; }
+__device__ CINN_NVGPU_INLINE int8_t FN_INT8(logical_right_shift)(int8_t a, int8_t b) { return ((uint8_t)a >> b); }
 
 // *************************************************************** //
 // int16 unary and binary operator
 #define FN_INT16(func) cinn_nvgpu_##func##_int16
-__device__ inline int16_t FN_INT16(bitwise_and)(int16_t a, int16_t b) { return a & b; }
-__device__ inline int16_t FN_INT16(bitwise_or)(int16_t a, int16_t b) { return a | b; }
-__device__ inline int16_t FN_INT16(bitwise_xor)(int16_t a, int16_t b) { return a ^ b; }
-__device__ inline int16_t FN_INT16(bitwise_not)(int16_t a) { return ~a; }
-__device__ inline int16_t FN_INT16(logical_right_shift)(int16_t a, int16_t b) { return ((uint16_t)a >> b); }
+__device__ CINN_NVGPU_INLINE int16_t FN_INT16(bitwise_and)(int16_t a, int16_t b) { return a & b; }
+__device__ CINN_NVGPU_INLINE int16_t FN_INT16(bitwise_or)(int16_t a, int16_t b) { return a | b; }
+__device__ CINN_NVGPU_INLINE int16_t FN_INT16(bitwise_xor)(int16_t a, int16_t b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE int16_t FN_INT16(bitwise_not)(int16_t a) { return ~a; }
+__device__ CINN_NVGPU_INLINE int16_t FN_INT16(logical_right_shift)(int16_t a, int16_t b) { return ((uint16_t)a >> b); }
 
 // *************************************************************** //
 // float32 unary and binary operator
 #define FN_FP32(func) cinn_nvgpu_##func##_fp32
 // NOTE Due to function override, we don't need to use type (such as '_fp32') as the suffix of function's name.
-__device__ inline float FN_FP32(sin)(float x) { return sin(x); }
-__device__ inline float FN_FP32(cos)(float x) { return cos(x); }
-__device__ inline float FN_FP32(tan)(float x) { return tan(x); }
-__device__ inline float FN_FP32(sinh)(float x) { return sinh(x); }
-__device__ inline float FN_FP32(cosh)(float x) { return cosh(x); }
-__device__ inline float FN_FP32(tanh)(float x) { return tanh(x); }
-
-__device__ inline float FN_FP32(asin)(float x) { return asin(x); }
-__device__ inline float FN_FP32(acos)(float x) { return acos(x); }
-__device__ inline float FN_FP32(atan)(float x) { return atan(x); }
-__device__ inline float FN_FP32(asinh)(float x) { return asinh(x); }
-__device__ inline float FN_FP32(acosh)(float x) { return acosh(x); }
-__device__ inline float FN_FP32(atanh)(float x) { return atanh(x); }
-
-__device__ inline float FN_FP32(ceil)(float x) { return ceil(x); }
-__device__ inline float FN_FP32(round)(float x) { return round(x); }
-__device__ inline float FN_FP32(trunc)(float x) { return trunc(x); }
-__device__ inline float FN_FP32(abs)(float x) { return abs(x); }
-__device__ inline float FN_FP32(floor)(float x) { return floor(x); }
-__device__ inline float FN_FP32(log)(float x) { return log(x); }
-__device__ inline float FN_FP32(log2)(float x) { return log2(x); }
-__device__ inline float FN_FP32(log10)(float x) { return log10(x); }
-__device__ inline float FN_FP32(exp)(float x) { return exp(x); }
-__device__ inline float FN_FP32(erf)(float x) { return erf(x); }
-__device__ inline float FN_FP32(sigmoid)(float x) { return 1.0f / (1.0f + exp(-x)); }
-__device__ inline float FN_FP32(sqrt)(float x) { return sqrt(x); }
-__device__ inline float FN_FP32(rsqrt)(float x) { return rsqrt(x); }
-__device__ inline float FN_FP32(cbrt)(float x) { return cbrt(x); }
-
-__device__ inline bool FN_FP32(isfinite)(float x) { return isfinite(x); }
-__device__ inline bool FN_FP32(isinf)(float x) { return isinf(x); }
-__device__ inline bool FN_FP32(isnan)(float x) { return isnan(x); }
-
-__device__ inline float FN_FP32(pow)(float a, float b) { return powf(a, b); }
-
-__device__ inline float FN_FP32(mod)(float a, float b) {
+__device__ CINN_NVGPU_INLINE float FN_FP32(sin)(float x) { return sin(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(cos)(float x) { return cos(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(tan)(float x) { return tan(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(sinh)(float x) { return sinh(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(cosh)(float x) { return cosh(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(tanh)(float x) { return tanh(x); }
+
+__device__ CINN_NVGPU_INLINE float FN_FP32(asin)(float x) { return asin(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(acos)(float x) { return acos(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(atan)(float x) { return atan(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(asinh)(float x) { return asinh(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(acosh)(float x) { return acosh(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(atanh)(float x) { return atanh(x); }
+
+__device__ CINN_NVGPU_INLINE float FN_FP32(ceil)(float x) { return ceil(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(round)(float x) { return round(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(trunc)(float x) { return trunc(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(abs)(float x) { return abs(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(floor)(float x) { return floor(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(log)(float x) { return log(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(log2)(float x) { return log2(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(log10)(float x) { return log10(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(exp)(float x) { return exp(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(erf)(float x) { return erf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(sigmoid)(float x) { return 1.0f / (1.0f + exp(-x)); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(sqrt)(float x) { return sqrt(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(rsqrt)(float x) { return rsqrt(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(cbrt)(float x) { return cbrt(x); }
+
+__device__ CINN_NVGPU_INLINE bool FN_FP32(isfinite)(float x) { return isfinite(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP32(isinf)(float x) { return isinf(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP32(isnan)(float x) { return isnan(x); }
+
+__device__ CINN_NVGPU_INLINE float FN_FP32(pow)(float a, float b) { return powf(a, b); }
+
+__device__ CINN_NVGPU_INLINE float FN_FP32(mod)(float a, float b) {
   float res = fmodf(a, b);
   if ((res != 0.0f) && ((res < 0.0f) != (b < 0.0f))) res += b;
   return res;
 }
 
+// the fast intrinsics selected by the "approx" and "fast" math precision
+__device__ CINN_NVGPU_INLINE float FN_FP32(exp_fast)(float x) { return __expf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(log_fast)(float x) { return __logf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(sin_fast)(float x) { return __sinf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(cos_fast)(float x) { return __cosf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(tan_fast)(float x) { return __tanf(x); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(tanh_fast)(float x) {
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 750
+  float y;
+  asm("tanh.approx.f32 %0, %1;" : "=f"(y) : "f"(x));
+  return y;
+#else
+  return 1.0f - 2.0f / (__expf(2.0f * x) + 1.0f);
+#endif
+}
+__device__ CINN_NVGPU_INLINE float FN_FP32(sigmoid_fast)(float x) { return __fdividef(1.0f, 1.0f + __expf(-x)); }
+__device__ CINN_NVGPU_INLINE float FN_FP32(pow_fast)(float a, float b) { return __powf(a, b); }
+
 // *************************************************************** //
 // float64 unary and binary operator
 #define FN_FP64(func) cinn_nvgpu_##func##_fp64
 
-__device__ inline double FN_FP64(sin)(double x) { return sin(x); }
-__device__ inline double FN_FP64(cos)(double x) { return cos(x); }
-__device__ inline double FN_FP64(tan)(double x) { return tan(x); }
-__device__ inline double FN_FP64(sinh)(double x) { return sinh(x); }
-__device__ inline double FN_FP64(cosh)(double x) { return cosh(x); }
-__device__ inline double FN_FP64(tanh)(double x) { return tanh(x); }
-
-__device__ inline double FN_FP64(asin)(double x) { return asin(x); }
-__device__ inline double FN_FP64(acos)(double x) { return acos(x); }
-__device__ inline double FN_FP64(atan)(double x) { return atan(x); }
-__device__ inline double FN_FP64(asinh)(double x) { return asinh(x); }
-__device__ inline double FN_FP64(acosh)(double x) { return acosh(x); }
-__device__ inline double FN_FP64(atanh)(double x) { return atanh(x); }
-
-__device__ inline double FN_FP64(ceil)(double x) { return ceil(x); }
-__device__ inline double FN_FP64(round)(double x) { return round(x); }
-__device__ inline double FN_FP64(trunc)(double x) { return trunc(x); }
-__device__ inline double FN_FP64(abs)(double x) { return abs(x); }
-__device__ inline double FN_FP64(floor)(double x) { return floor(x); }
-__device__ inline double FN_FP64(log)(double x) { return log(x); }
-__device__ inline double FN_FP64(log2)(double x) { return log2(x); }
-__device__ inline double FN_FP64(log10)(double x) { return log10(x); }
-__device__ inline double FN_FP64(exp)(double x) { return exp(x); }
-__device__ inline double FN_FP64(erf)(double x) { return erf(x); }
-__device__ inline double FN_FP64(sigmoid)(double x) { return 1.0 / (1.0 + exp(-x)); }
-__device__ inline double FN_FP64(sqrt)(double x) { return sqrt(x); }
-__device__ inline double FN_FP64(rsqrt)(double x) { return rsqrt(x); }
-__device__ inline double FN_FP64(cbrt)(double x) { return cbrt(x); }
-
-__device__ inline bool FN_FP64(isfinite)(double x) { return isfinite(x); }
-__device__ inline bool FN_FP64(isinf)(double x) { return isinf(x); }
-__device__ inline bool FN_FP64(isnan)(double x) { return isnan(x); }
-
-__device__ inline double FN_FP64(pow)(double a, double b) { return pow(a, b); }
-__device__ inline double FN_FP64(mod)(double a, double b) {
+__device__ CINN_NVGPU_INLINE double FN_FP64(sin)(double x) { return sin(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(cos)(double x) { return cos(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(tan)(double x) { return tan(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(sinh)(double x) { return sinh(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(cosh)(double x) { return cosh(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(tanh)(double x) { return tanh(x); }
+
+__device__ CINN_NVGPU_INLINE double FN_FP64(asin)(double x) { return asin(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(acos)(double x) { return acos(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(atan)(double x) { return atan(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(asinh)(double x) { return asinh(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(acosh)(double x) { return acosh(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(atanh)(double x) { return atanh(x); }
+
+__device__ CINN_NVGPU_INLINE double FN_FP64(ceil)(double x) { return ceil(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(round)(double x) { return round(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(trunc)(double x) { return trunc(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(abs)(double x) { return abs(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(floor)(double x) { return floor(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(log)(double x) { return log(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(log2)(double x) { return log2(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(log10)(double x) { return log10(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(exp)(double x) { return exp(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(erf)(double x) { return erf(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(sigmoid)(double x) { return 1.0 / (1.0 + exp(-x)); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(sqrt)(double x) { return sqrt(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(rsqrt)(double x) { return rsqrt(x); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(cbrt)(double x) { return cbrt(x); }
+
+__device__ CINN_NVGPU_INLINE bool FN_FP64(isfinite)(double x) { return isfinite(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP64(isinf)(double x) { return isinf(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP64(isnan)(double x) { return isnan(x); }
+
+__device__ CINN_NVGPU_INLINE double FN_FP64(pow)(double a, double b) { return pow(a, b); }
+__device__ CINN_NVGPU_INLINE double FN_FP64(mod)(double a, double b) {
   double res = fmod(a, b);
   if ((res != 0.0) && ((res < 0.0) != (b < 0.0))) res += b;
   return res;
@@ -135,7 +202,7 @@ __device__ inline double FN_FP64(mod)(double a, double b) {
 // int32 unary and binary operator
 #define FN_INT32(func) cinn_nvgpu_##func##_int32
 
-__device__ inline int FN_INT32(pow)(int a, int b) {
+__device__ CINN_NVGPU_INLINE int FN_INT32(pow)(int a, int b) {
   if (a == 0 && b < 0) {
     return -1;
   }
@@ -143,21 +210,21 @@ __device__ inline int FN_INT32(pow)(int a, int b) {
   return __float2int_rn(res);
 }
 
-__device__ inline int FN_INT32(left_shift)(int a, int b) { return a << b; }
-__device__ inline int FN_INT32(right_shift)(int a, int b) { return a >> b; }
-__device__ inline int FN_INT32(bitwise_and)(int a, int b) { return a & b; }
-__device__ inline int FN_INT32(bitwise_or)(int a, int b) { return a | b; }
-__device__ inline int FN_INT32(bitwise_xor)(int a, int b) { return a ^ b; }
-__device__ inline int FN_INT32(bitwise_not)(int a) { return ~a; }
-__device__ inline int FN_INT32(clz)(int a) { return __clz(a); }
-__device__ inline int FN_INT32(popc)(int a) { return __popc(a); }
-__device__ inline int FN_INT32(logical_right_shift)(int a, int b) { return ((unsigned int)a >> b); }
-__device__ inline int FN_INT32(trunc)(int a) { return a; }
-
-__device__ inline int FN_INT32(max)(int a, int b) { return max(a, b); }
-__device__ inline int FN_INT32(min)(int a, int b) { return min(a, b); }
-
-__device__ inline int FN_INT32(mod)(int a, int b) {
+__device__ CINN_NVGPU_INLINE int FN_INT32(left_shift)(int a, int b) { return a << b; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(right_shift)(int a, int b) { return a >> b; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(bitwise_and)(int a, int b) { return a & b; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(bitwise_or)(int a, int b) { return a | b; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(bitwise_xor)(int a, int b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(bitwise_not)(int a) { return ~a; }
+__device__ CINN_NVGPU_INLINE int FN_INT32(clz)(int a) { return __clz(a); }
+__device__ CINN_NVGPU_INLINE int FN_INT32(popc)(int a) { return __popc(a); }
+__device__ CINN_NVGPU_INLINE int FN_INT32(logical_right_shift)(int a, int b) { return ((unsigned int)a >> b); }
+__device__ CINN_NVGPU_INLINE int FN_INT32(trunc)(int a) { return a; }
+
+__device__ CINN_NVGPU_INLINE int FN_INT32(max)(int a, int b) { return max(a, b); }
+__device__ CINN_NVGPU_INLINE int FN_INT32(min)(int a, int b) { return min(a, b); }
+
+__device__ CINN_NVGPU_INLINE int FN_INT32(mod)(int a, int b) {
   int res = a % b;
   if ((res != 0) && ((b ^ res) < 0)) res += b;
   return res;
@@ -168,21 +235,21 @@ __device__ inline int FN_INT32(mod)(int a, int b) {
 // int64 unary and binary operator
 #define FN_INT64(func) cinn_nvgpu_##func##_int64
 
-__device__ inline long long int FN_INT64(bitwise_and)(long long int a, long long int b) { return a & b; }
-__device__ inline long long int FN_INT64(bitwise_or)(long long int a, long long int b) { return a | b; }
-__device__ inline long long int FN_INT64(bitwise_xor)(long long int a, long long int b) { return a ^ b; }
-__device__ inline long long int FN_INT64(bitwise_not)(long long int a) { return ~a; }
-__device__ inline long long int FN_INT64(clz)(long long int a) { return __clzll(a); }
-__device__ inline long long int FN_INT64(popc)(long long int a) { return __popcll(a); }
-__device__ inline long long int FN_INT64(logical_right_shift)(long long int a, long long int b) { return ((unsigned long long int)a >> b); }
-__device__ inline long long int FN_INT64(trunc)(long long int a) { return a; }
-__device__ inline long long int FN_INT64(mod)(long long int a, long long int b) {
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(bitwise_and)(long long int a, long long int b) { return a & b; }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(bitwise_or)(long long int a, long long int b) { return a | b; }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(bitwise_xor)(long long int a, long long int b) { return a ^ b; }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(bitwise_not)(long long int a) { return ~a; }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(clz)(long long int a) { return __clzll(a); }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(popc)(long long int a) { return __popcll(a); }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(logical_right_shift)(long long int a, long long int b) { return ((unsigned long long int)a >> b); }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(trunc)(long long int a) { return a; }
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(mod)(long long int a, long long int b) {
   long long int res = a % b;
   if ((res != 0) && ((b ^ res) < 0)) res += b;
   return res;
 }
 
-__device__ inline long long int FN_INT64(pow)(long long int a, long long int b) {
+__device__ CINN_NVGPU_INLINE long long int FN_INT64(pow)(long long int a, long long int b) {
   double res = pow(__ll2double_rd(a), __ll2double_rd(b));
   return __double2ll_rn(res);
 }
@@ -193,28 +260,28 @@ __device__ inline long long int FN_INT64(pow)(long long int a, long long int b)
 
 #define FN_BF16(func) cinn_nvgpu_##func##_bf16
 
-__device__ inline bfloat16 FN_BF16(ceil)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(ceil)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hceil(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(ceil)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(floor)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(floor)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hfloor(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(floor)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(round)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(round)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hrint(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(round)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(trunc)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(trunc)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(htrunc(x.to_nv_bfloat16()));
 #else
@@ -222,14 +289,14 @@ __device__ inline bfloat16 FN_BF16(trunc)(bfloat16 x) {
 #endif
 }
 
-__device__ inline bfloat16 FN_BF16(sin)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(sin)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hsin(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(sin)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(cos)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(cos)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hcos(x.to_nv_bfloat16()));
 #else
@@ -237,28 +304,28 @@ __device__ inline bfloat16 FN_BF16(cos)(bfloat16 x) {
 #endif
 }
 
-__device__ inline bfloat16 FN_BF16(exp)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(exp)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hexp(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(exp)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(log)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(log)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hlog(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(log)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(log2)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(log2)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hlog2(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(log2)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(log10)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(log10)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hlog10(x.to_nv_bfloat16()));
 #else
@@ -266,14 +333,14 @@ __device__ inline bfloat16 FN_BF16(log10)(bfloat16 x) {
 #endif
 }
 
-__device__ inline bfloat16 FN_BF16(sqrt)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(sqrt)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hsqrt(x.to_nv_bfloat16()));
 #else
   return bfloat16(FN_FP32(sqrt)(static_cast<float>(x)));
 #endif
 }
-__device__ inline bfloat16 FN_BF16(rsqrt)(bfloat16 x) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(rsqrt)(bfloat16 x) {
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
   return bfloat16(hrsqrt(x.to_nv_bfloat16()));
 #else
@@ -281,33 +348,33 @@ __device__ inline bfloat16 FN_BF16(rsqrt)(bfloat16 x) {
 #endif
 }
 
-__device__ inline bfloat16 FN_BF16(cbrt)(bfloat16 x) { return bfloat16(FN_FP32(cbrt)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(cbrt)(bfloat16 x) { return bfloat16(FN_FP32(cbrt)(static_cast<float>(x))); }
 
-__device__ inline bfloat16 FN_BF16(abs)(bfloat16 x) { return cinn::common::abs(x); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(abs)(bfloat16 x) { return cinn::common::abs(x); }
 
-__device__ inline bool FN_BF16(isnan)(bfloat16 x) { return cinn::common::isnan(x); }
-__device__ inline bool FN_BF16(isinf)(bfloat16 x) { return cinn::common::isinf(x); }
-__device__ inline bool FN_BF16(isfinite)(bfloat16 x) { return cinn::common::isfinite(x); }
+__device__ CINN_NVGPU_INLINE bool FN_BF16(isnan)(bfloat16 x) { return cinn::common::isnan(x); }
+__device__ CINN_NVGPU_INLINE bool FN_BF16(isinf)(bfloat16 x) { return cinn::common::isinf(x); }
+__device__ CINN_NVGPU_INLINE bool FN_BF16(isfinite)(bfloat16 x) { return cinn::common::isfinite(x); }
 
-__device__ inline bfloat16 FN_BF16(erf)(bfloat16 x) { return bfloat16(FN_FP32(erf)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(erf)(bfloat16 x) { return bfloat16(FN_FP32(erf)(static_cast<float>(x))); }
 
-__device__ inline bfloat16 FN_BF16(tan)(bfloat16 x) { return bfloat16(FN_FP32(tan)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(sinh)(bfloat16 x) { return bfloat16(FN_FP32(sinh)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(cosh)(bfloat16 x) { return bfloat16(FN_FP32(cosh)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(tanh)(bfloat16 x) { return bfloat16(FN_FP32(tanh)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(asin)(bfloat16 x) { return bfloat16(FN_FP32(asin)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(acos)(bfloat16 x) { return bfloat16(FN_FP32(acos)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(atan)(bfloat16 x) { return bfloat16(FN_FP32(atan)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(asinh)(bfloat16 x) { return bfloat16(FN_FP32(asinh)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(acosh)(bfloat16 x) { return bfloat16(FN_FP32(acosh)(static_cast<float>(x))); }
-__device__ inline bfloat16 FN_BF16(atanh)(bfloat16 x) { return bfloat16(FN_FP32(atanh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(tan)(bfloat16 x) { return bfloat16(FN_FP32(tan)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(sinh)(bfloat16 x) { return bfloat16(FN_FP32(sinh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(cosh)(bfloat16 x) { return bfloat16(FN_FP32(cosh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(tanh)(bfloat16 x) { return bfloat16(FN_FP32(tanh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(asin)(bfloat16 x) { return bfloat16(FN_FP32(asin)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(acos)(bfloat16 x) { return bfloat16(FN_FP32(acos)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(atan)(bfloat16 x) { return bfloat16(FN_FP32(atan)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(asinh)(bfloat16 x) { return bfloat16(FN_FP32(asinh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(acosh)(bfloat16 x) { return bfloat16(FN_FP32(acosh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(atanh)(bfloat16 x) { return bfloat16(FN_FP32(atanh)(static_cast<float>(x))); }
 
-__device__ inline bfloat16 FN_BF16(sigmoid)(bfloat16 x) { return bfloat16(FN_FP32(sigmoid)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(sigmoid)(bfloat16 x) { return bfloat16(FN_FP32(sigmoid)(static_cast<float>(x))); }
 
-__device__ inline bfloat16 FN_BF16(mod)(bfloat16 a, bfloat16 b) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(mod)(bfloat16 a, bfloat16 b) {
   return bfloat16(FN_FP32(mod)(static_cast<float>(a), static_cast<float>(b)));
 }
-__device__ inline bfloat16 FN_BF16(pow)(bfloat16 a, bfloat16 b) {
+__device__ CINN_NVGPU_INLINE bfloat16 FN_BF16(pow)(bfloat16 a, bfloat16 b) {
   return bfloat16(FN_FP32(pow)(static_cast<float>(a), static_cast<float>(b)));
 }
 
@@ -319,49 +386,49 @@ __device__ inline bfloat16 FN_BF16(pow)(bfloat16 a, bfloat16 b) {
 
 #define FN_FP16(func) cinn_nvgpu_##func##_fp16
 
-__device__ inline float16 FN_FP16(ceil)(float16 x) { return float16(hceil(x.to_half())); }
-__device__ inline float16 FN_FP16(floor)(float16 x) { return float16(hfloor(x.to_half())); }
-__device__ inline float16 FN_FP16(round)(float16 x) { return float16(FN_FP32(round)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(trunc)(float16 x) { return float16(htrunc(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(ceil)(float16 x) { return float16(hceil(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(floor)(float16 x) { return float16(hfloor(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(round)(float16 x) { return float16(FN_FP32(round)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(trunc)(float16 x) { return float16(htrunc(x.to_half())); }
 
-__device__ inline float16 FN_FP16(sin)(float16 x) { return float16(hsin(x.to_half())); }
-__device__ inline float16 FN_FP16(cos)(float16 x) { return float16(hcos(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(sin)(float16 x) { return float16(hsin(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(cos)(float16 x) { return float16(hcos(x.to_half())); }
 
-__device__ inline float16 FN_FP16(exp)(float16 x) { return float16(hexp(x.to_half())); }
-__device__ inline float16 FN_FP16(log)(float16 x) { return float16(hlog(x.to_half())); }
-__device__ inline float16 FN_FP16(log2)(float16 x) { return float16(hlog2(x.to_half())); }
-__device__ inline float16 FN_FP16(log10)(float16 x) { return float16(hlog10(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(exp)(float16 x) { return float16(hexp(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(log)(float16 x) { return float16(hlog(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(log2)(float16 x) { return float16(hlog2(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(log10)(float16 x) { return float16(hlog10(x.to_half())); }
 
-__device__ inline float16 FN_FP16(sqrt)(float16 x) { return float16(hsqrt(x.to_half())); }
-__device__ inline float16 FN_FP16(rsqrt)(float16 x) { return float16(hrsqrt(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(sqrt)(float16 x) { return float16(hsqrt(x.to_half())); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(rsqrt)(float16 x) { return float16(hrsqrt(x.to_half())); }
 
-__device__ inline float16 FN_FP16(cbrt)(float16 x) { return float16(FN_FP32(cbrt)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(cbrt)(float16 x) { return float16(FN_FP32(cbrt)(static_cast<float>(x))); }
 
-__device__ inline float16 FN_FP16(abs)(float16 x) { return cinn::common::abs(x); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(abs)(float16 x) { return cinn::common::abs(x); }
 
-__device__ inline bool FN_FP16(isnan)(float16 x) { return cinn::common::isnan(x); }
-__device__ inline bool FN_FP16(isinf)(float16 x) { return cinn::common::isinf(x); }
-__device__ inline bool FN_FP16(isfinite)(float16 x) { return cinn::common::isfinite(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP16(isnan)(float16 x) { return cinn::common::isnan(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP16(isinf)(float16 x) { return cinn::common::isinf(x); }
+__device__ CINN_NVGPU_INLINE bool FN_FP16(isfinite)(float16 x) { return cinn::common::isfinite(x); }
 
-__device__ inline float16 FN_FP16(erf)(float16 x) { return float16(FN_FP32(erf)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(erf)(float16 x) { return float16(FN_FP32(erf)(static_cast<float>(x))); }
 
-__device__ inline float16 FN_FP16(tan)(float16 x) { return float16(FN_FP32(tan)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(sinh)(float16 x) { return float16(FN_FP32(sinh)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(cosh)(float16 x) { return float16(FN_FP32(cosh)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(tanh)(float16 x) { return float16(FN_FP32(tanh)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(asin)(float16 x) { return float16(FN_FP32(asin)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(acos)(float16 x) { return float16(FN_FP32(acos)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(atan)(float16 x) { return float16(FN_FP32(atan)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(asinh)(float16 x) { return float16(FN_FP32(asinh)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(acosh)(float16 x) { return float16(FN_FP32(acosh)(static_cast<float>(x))); }
-__device__ inline float16 FN_FP16(atanh)(float16 x) { return float16(FN_FP32(atanh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(tan)(float16 x) { return float16(FN_FP32(tan)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(sinh)(float16 x) { return float16(FN_FP32(sinh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(cosh)(float16 x) { return float16(FN_FP32(cosh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(tanh)(float16 x) { return float16(FN_FP32(tanh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(asin)(float16 x) { return float16(FN_FP32(asin)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(acos)(float16 x) { return float16(FN_FP32(acos)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(atan)(float16 x) { return float16(FN_FP32(atan)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(asinh)(float16 x) { return float16(FN_FP32(asinh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(acosh)(float16 x) { return float16(FN_FP32(acosh)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(atanh)(float16 x) { return float16(FN_FP32(atanh)(static_cast<float>(x))); }
 
-__device__ inline float16 FN_FP16(sigmoid)(float16 x) { return float16(FN_FP32(sigmoid)(static_cast<float>(x))); }
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(sigmoid)(float16 x) { return float16(FN_FP32(sigmoid)(static_cast<float>(x))); }
 
-__device__ inline float16 FN_FP16(mod)(float16 a, float16 b) {
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(mod)(float16 a, float16 b) {
   return float16(FN_FP32(mod)(static_cast<float>(a), static_cast<float>(b)));
 }
-__device__ inline float16 FN_FP16(pow)(float16 a, float16 b) {
+__device__ CINN_NVGPU_INLINE float16 FN_FP16(pow)(float16 a, float16 b) {
   return float16(FN_FP32(pow)(static_cast<float>(a), static_cast<float>(b)));
 }
 
@@ -375,10 +442,10 @@ __device__ inline float16 FN_FP16(pow)(float16 a, float16 b) {
   MARCO(max_int32, CINN_INT32_MIN, int, ##__VA_ARGS__) \
   MARCO(min_int32, CINN_INT32_MAX, int, ##__VA_ARGS__)
 
-__device__ inline int cinn_sum_int32(const int left, const int right) { return left + right; }
-__device__ inline int cinn_prod_int32(const int left, const int right) { return left * right; }
-__device__ inline int cinn_max_int32(const int left, const int right) { return max(left, right); }
-__device__ inline int cinn_min_int32(const int left, const int right) { return min(left, right); }
+__device__ CINN_NVGPU_INLINE int cinn_sum_int32(const int left, const int right) { return left + right; }
+__device__ CINN_NVGPU_INLINE int cinn_prod_int32(const int left, const int right) { return left * right; }
+__device__ CINN_NVGPU_INLINE int cinn_max_int32(const int left, const int right) { return max(left, right); }
+__device__ CINN_NVGPU_INLINE int cinn_min_int32(const int left, const int right) { return min(left, right); }
 
 #define EXPAND_REDUCE_INT64_MARCO(MARCO, ...)                          \
   MARCO(sum_int64, 0, long long int, ##__VA_ARGS__)                    \
@@ -386,16 +453,16 @@ __device__ inline int cinn_min_int32(const int left, const int right) { return m
   MARCO(max_int64, -9223372036854775808, long long int, ##__VA_ARGS__) \
   MARCO(min_int64, 9223372036854775807, long long int, ##__VA_ARGS__)
 
-__device__ inline long long int cinn_sum_int64(const long long int left, const long long int right) {
+__device__ CINN_NVGPU_INLINE long long int cinn_sum_int64(const long long int left, const long long int right) {
   return left + right;
 }
-__device__ inline long long int cinn_prod_int64(const long long int left, const long long int right) {
+__device__ CINN_NVGPU_INLINE long long int cinn_prod_int64(const long long int left, const long long int right) {
   return left * right;
 }
-__device__ inline long long int cinn_max_int64(const long long int left, const long long int right) {
+__device__ CINN_NVGPU_INLINE long long int cinn_max_int64(const long long int left, const long long int right) {
   return max(left, right);
 }
-__device__ inline long long int cinn_min_int64(const long long int left, const long long int right) {
+__device__ CINN_NVGPU_INLINE long long int cinn_min_int64(const long long int left, const long long int right) {
   return min(left, right);
 }
 
@@ -405,10 +472,10 @@ __device__ inline long long int cinn_min_int64(const long long int left, const l
   MACRO(max_fp32, -3.40282e+38f, float, ##__VA_ARGS__) \
   MACRO(min_fp32, 3.40282e+38f, float, ##__VA_ARGS__)
 
-__device__ inline float cinn_sum_fp32(const float left, const float right) { return left + right; }
-__device__ inline float cinn_prod_fp32(const float left, const float right) { return left * right; }
-__device__ inline float cinn_max_fp32(const float left, const float right) { return max(left, right); }
-__device__ inline float cinn_min_fp32(const float left, const float right) { return min(left, right); }
+__device__ CINN_NVGPU_INLINE float cinn_sum_fp32(const float left, const float right) { return left + right; }
+__device__ CINN_NVGPU_INLINE float cinn_prod_fp32(const float left, const float right) { return left * right; }
+__device__ CINN_NVGPU_INLINE float cinn_max_fp32(const float left, const float right) { return max(left, right); }
+__device__ CINN_NVGPU_INLINE float cinn_min_fp32(const float left, const float right) { return min(left, right); }
 
 #ifdef CINN_CUDA_BF16
 
@@ -418,10 +485,10 @@ __device__ inline float cinn_min_fp32(const float left, const float right) { ret
   MACRO(max_bf16, cinn::common::raw_uint16_to_bfloat16(0xfbff), bfloat16, ##__VA_ARGS__) \
   MACRO(min_bf16, cinn::common::raw_uint16_to_bfloat16(0x7bff), bfloat16, ##__VA_ARGS__)
 
-__device__ inline bfloat16 cinn_sum_bf16(const bfloat16 left, const bfloat16 right) { return left + right; }
-__device__ inline bfloat16 cinn_prod_bf16(const bfloat16 left, const bfloat16 right) { return left * right; }
-__device__ inline bfloat16 cinn_max_bf16(const bfloat16 left, const bfloat16 right) { return max(left, right); }
-__device__ inline bfloat16 cinn_min_bf16(const bfloat16 left, const bfloat16 right) { return min(left, right); }
+__device__ CINN_NVGPU_INLINE bfloat16 cinn_sum_bf16(const bfloat16 left, const bfloat16 right) { return left + right; }
+__device__ CINN_NVGPU_INLINE bfloat16 cinn_prod_bf16(const bfloat16 left, const bfloat16 right) { return left * right; }
+__device__ CINN_NVGPU_INLINE bfloat16 cinn_max_bf16(const bfloat16 left, const bfloat16 right) { return max(left, right); }
+__device__ CINN_NVGPU_INLINE bfloat16 cinn_min_bf16(const bfloat16 left, const bfloat16 right) { return min(left, right); }
 #endif
 
 #ifdef CINN_CUDA_FP16
@@ -432,10 +499,10 @@ __device__ inline bfloat16 cinn_min_bf16(const bfloat16 left, const bfloat16 rig
   MACRO(max_fp16, cinn::common::raw_uint16_to_float16(0xfbff), float16, ##__VA_ARGS__) \
   MACRO(min_fp16, cinn::common::raw_uint16_to_float16(0x7bff), float16, ##__VA_ARGS__)
 
-__device__ inline float16 cinn_sum_fp16(const float16 left, const float16 right) { return left + right; }
-__device__ inline float16 cinn_prod_fp16(const float16 left, const float16 right) { return left * right; }
-__device__ inline float16 cinn_max_fp16(const float16 left, const float16 right) { return max(left, right); }
-__device__ inline float16 cinn_min_fp16(const float16 left, const float16 right) { return min(left, right); }
+__device__ CINN_NVGPU_INLINE float16 cinn_sum_fp16(const float16 left, const float16 right) { return left + right; }
+__device__ CINN_NVGPU_INLINE float16 cinn_prod_fp16(const float16 left, const float16 right) { return left * right; }
+__device__ CINN_NVGPU_INLINE float16 cinn_max_fp16(const float16 left, const float16 right) { return max(left, right); }
+__device__ CINN_NVGPU_INLINE float16 cinn_min_fp16(const float16 left, const float16 right) { return min(left, right); }
 #endif
 
 #define EXPAND_REDUCE_FP64_MACRO(MACRO, ...)            \
@@ -444,43 +511,39 @@ __device__ inline float16 cinn_min_fp16(const float16 left, const float16 right)
   MACRO(max_fp64, -1.79769e+308, double, ##__VA_ARGS__) \
   MACRO(min_fp64, 1.79769e+308, double, ##__VA_ARGS__)
 
-__device__ inline double cinn_sum_fp64(const double left, const double right) { return left + right; }
-__device__ inline double cinn_prod_fp64(const double left, const double right) { return left * right; }
-__device__ inline double cinn_max_fp64(const double left, const double right) { return max(left, right); }
-__device__ inline double cinn_min_fp64(const double left, const double right) { return min(left, right); }
+__device__ CINN_NVGPU_INLINE double cinn_sum_fp64(const double left, const double right) { return left + right; }
+__device__ CINN_NVGPU_INLINE double cinn_prod_fp64(const double left, const double right) { return left * right; }
+__device__ CINN_NVGPU_INLINE double cinn_max_fp64(const double left, const double right) { return max(left, right); }
+__device__ CINN_NVGPU_INLINE double cinn_min_fp64(const double left, const double right) { return min(left, right); }
 
 #define EXPAND_REDUCE_BOOL_MACRO(MACRO, ...) \
   MACRO(all, true, bool, ##__VA_ARGS__)      \
   MACRO(any, false, bool, ##__VA_ARGS__)
 
-__device__ inline bool cinn_all(const bool left, const bool right) { return left && right; }
-__device__ inline bool cinn_any(const bool left, const bool right) { return left || right; }
-
-#define CINN_SHUFFLE_FUNCTION(offset, op, init)           \
-  shfl_res = __shfl_down_sync(mask, tmp_val, offset, 32); \
-  tmp_val  = op((threadIdx.x & 0x1f) + offset < lane ? shfl_res : init, tmp_val);
-
-#define CINN_WARP_SHUFFLE_INTERNAL_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                \
-  __device__ inline DTYPE cinn_warp_shuffle_##REDUCE_TYPE##_internal(const DTYPE value) { \
-    DTYPE tmp_val     = value, shfl_res;                                                  \
-    unsigned int mask = __activemask();                                                   \
-    unsigned int lane = __popc(mask);                                                     \
-    if (lane < 32) {                                                                      \
-      CINN_SHUFFLE_FUNCTION(16, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))               \
-      CINN_SHUFFLE_FUNCTION(8, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))                \
-      CINN_SHUFFLE_FUNCTION(4, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))                \
-      CINN_SHUFFLE_FUNCTION(2, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))                \
-      CINN_SHUFFLE_FUNCTION(1, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))                \
-      tmp_val = __shfl_sync(mask, tmp_val, 0, 32);                                        \
-      return tmp_val;                                                                     \
-    } else {                                                                              \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, __shfl_down_sync(mask, tmp_val, 16, 32));     \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, __shfl_down_sync(mask, tmp_val, 8, 32));      \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, __shfl_down_sync(mask, tmp_val, 4, 32));      \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, __shfl_down_sync(mask, tmp_val, 2, 32));      \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, __shfl_down_sync(mask, tmp_val, 1, 32));      \
-      return tmp_val;                                                                     \
-    }                                                                                     \
+__device__ CINN_NVGPU_INLINE bool cinn_all(const bool left, const bool right) { return left && right; }
+__device__ CINN_NVGPU_INLINE bool cinn_any(const bool left, const bool right) { return left || right; }
+
+#define CINN_SHUFFLE_FUNCTION(offset, op, init)                     \
+  shfl_res = CINN_SHFL_DOWN(mask, tmp_val, offset, CINN_WARP_SIZE); \
+  tmp_val  = op((threadIdx.x & (CINN_WARP_SIZE - 1)) + offset < lane ? shfl_res : init, tmp_val);
+
+#define CINN_WARP_SHUFFLE_INTERNAL_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                             \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_warp_shuffle_##REDUCE_TYPE##_internal(const DTYPE value) {   \
+    DTYPE tmp_val         = value, shfl_res;                                                           \
+    cinn_lane_mask_t mask = CINN_ACTIVE_MASK();                                                        \
+    unsigned int lane     = CINN_POPC(mask);                                                           \
+    if (lane < CINN_WARP_SIZE) {                                                                       \
+      for (int offset = CINN_WARP_SIZE / 2; offset > 0; offset /= 2) {                                 \
+        CINN_SHUFFLE_FUNCTION(offset, cinn_##REDUCE_TYPE, (DTYPE)(INITIAL_VALUE))                      \
+      }                                                                                                \
+      tmp_val = CINN_SHFL(mask, tmp_val, 0, CINN_WARP_SIZE);                                           \
+      return tmp_val;                                                                                  \
+    } else {                                                                                           \
+      for (int offset = CINN_WARP_SIZE / 2; offset > 0; offset /= 2) {                                 \
+        tmp_val = cinn_##REDUCE_TYPE(tmp_val, CINN_SHFL_DOWN(mask, tmp_val, offset, CINN_WARP_SIZE));  \
+      }                                                                                                \
+      return tmp_val;                                                                                  \
+    }                                                                                                  \
   }
 
 EXPAND_REDUCE_INT32_MARCO(CINN_WARP_SHUFFLE_INTERNAL_IMPL)
@@ -499,13 +562,89 @@ EXPAND_REDUCE_FP16_MACRO(CINN_WARP_SHUFFLE_INTERNAL_IMPL)
 
 #undef CINN_WARP_SHUFFLE_INTERNAL_IMPL
 
-#define CINN_WARP_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                     \
-  __device__ inline DTYPE cinn_warp_reduce_##REDUCE_TYPE(const DTYPE *buf, int offset, int extend) { \
-    DTYPE tmp_val = (DTYPE)(INITIAL_VALUE);                                                          \
-    for (int i = threadIdx.x; i < extend; i += 32) {                                                 \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, buf[offset + i]);                                        \
-    }                                                                                                \
-    return cinn_warp_shuffle_##REDUCE_TYPE##_internal(tmp_val);                                      \
+// reduce the values of a row by the lanes of width threads in registers, the width should be a power of 2 not more
+// than CINN_WARP_SIZE, and every lane gets the result by the butterfly of xor shuffles without shared memory
+#define CINN_WARP_ALLREDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                          \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_warp_allreduce_##REDUCE_TYPE(const DTYPE value, const int width) { \
+    DTYPE tmp_val         = value;                                                                           \
+    cinn_lane_mask_t mask = CINN_ACTIVE_MASK();                                                              \
+    for (int offset = width / 2; offset > 0; offset /= 2) {                                                  \
+      tmp_val = cinn_##REDUCE_TYPE(tmp_val, CINN_SHFL_XOR(mask, tmp_val, offset, width));                    \
+    }                                                                                                        \
+    return tmp_val;                                                                                          \
+  }
+
+EXPAND_REDUCE_INT32_MARCO(CINN_WARP_ALLREDUCE_IMPL)
+EXPAND_REDUCE_INT64_MARCO(CINN_WARP_ALLREDUCE_IMPL)
+EXPAND_REDUCE_FP32_MACRO(CINN_WARP_ALLREDUCE_IMPL)
+EXPAND_REDUCE_FP64_MACRO(CINN_WARP_ALLREDUCE_IMPL)
+EXPAND_REDUCE_BOOL_MACRO(CINN_WARP_ALLREDUCE_IMPL)
+
+#ifdef CINN_CUDA_BF16
+EXPAND_REDUCE_BF16_MACRO(CINN_WARP_ALLREDUCE_IMPL)
+#endif
+
+#ifdef CINN_CUDA_FP16
+EXPAND_REDUCE_FP16_MACRO(CINN_WARP_ALLREDUCE_IMPL)
+#endif
+
+#undef CINN_WARP_ALLREDUCE_IMPL
+
+// the partial reduction of buf[offset, offset + extend) by the thread tid of the stride threads
+#define CINN_PARTIAL_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)     \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_partial_reduce_##REDUCE_TYPE( \
+      const DTYPE *buf, int offset, int extend, int tid, int stride) {  \
+    DTYPE tmp_val = (DTYPE)(INITIAL_VALUE);                             \
+    for (int i = tid; i < extend; i += stride) {                        \
+      tmp_val = cinn_##REDUCE_TYPE(tmp_val, buf[offset + i]);           \
+    }                                                                   \
+    return tmp_val;                                                     \
+  }
+
+// the float rows aligned to 16 bytes are loaded by float4 along the reduce axis, and the tail is loaded one by one
+#define CINN_VECTORIZED_PARTIAL_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE) \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_partial_reduce_##REDUCE_TYPE(        \
+      const DTYPE *buf, int offset, int extend, int tid, int stride) {         \
+    DTYPE tmp_val    = (DTYPE)(INITIAL_VALUE);                                 \
+    const DTYPE *row = buf + offset;                                           \
+    int i            = tid;                                                    \
+    if ((reinterpret_cast<size_t>(row) & 15) == 0) {                           \
+      const float4 *vec_row = reinterpret_cast<const float4 *>(row);           \
+      for (; i < extend / 4; i += stride) {                                    \
+        float4 vec = vec_row[i];                                               \
+        tmp_val    = cinn_##REDUCE_TYPE(                                       \
+            cinn_##REDUCE_TYPE(tmp_val, vec.x),                                \
+            cinn_##REDUCE_TYPE(vec.y, cinn_##REDUCE_TYPE(vec.z, vec.w)));      \
+      }                                                                        \
+      i = extend / 4 * 4 + tid;                                                \
+    }                                                                          \
+    for (; i < extend; i += stride) {                                          \
+      tmp_val = cinn_##REDUCE_TYPE(tmp_val, row[i]);                           \
+    }                                                                          \
+    return tmp_val;                                                            \
+  }
+
+EXPAND_REDUCE_INT32_MARCO(CINN_PARTIAL_REDUCE_IMPL)
+EXPAND_REDUCE_INT64_MARCO(CINN_PARTIAL_REDUCE_IMPL)
+EXPAND_REDUCE_FP32_MACRO(CINN_VECTORIZED_PARTIAL_REDUCE_IMPL)
+EXPAND_REDUCE_FP64_MACRO(CINN_PARTIAL_REDUCE_IMPL)
+EXPAND_REDUCE_BOOL_MACRO(CINN_PARTIAL_REDUCE_IMPL)
+
+#ifdef CINN_CUDA_BF16
+EXPAND_REDUCE_BF16_MACRO(CINN_PARTIAL_REDUCE_IMPL)
+#endif
+
+#ifdef CINN_CUDA_FP16
+EXPAND_REDUCE_FP16_MACRO(CINN_PARTIAL_REDUCE_IMPL)
+#endif
+
+#undef CINN_PARTIAL_REDUCE_IMPL
+#undef CINN_VECTORIZED_PARTIAL_REDUCE_IMPL
+
+#define CINN_WARP_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                                \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_warp_reduce_##REDUCE_TYPE(const DTYPE *buf, int offset, int extend) { \
+    DTYPE tmp_val = cinn_partial_reduce_##REDUCE_TYPE(buf, offset, extend, threadIdx.x, CINN_WARP_SIZE);        \
+    return cinn_warp_shuffle_##REDUCE_TYPE##_internal(tmp_val);                                                 \
   }
 
 EXPAND_REDUCE_INT32_MARCO(CINN_WARP_REDUCE_IMPL)
@@ -524,22 +663,22 @@ EXPAND_REDUCE_FP16_MACRO(CINN_WARP_REDUCE_IMPL)
 
 #undef CINN_WARP_REDUCE_IMPL
 
-__device__ inline float cinn_warp_reduce_avg_fp32(const float *buf, int offset, int extend) {
+__device__ CINN_NVGPU_INLINE float cinn_warp_reduce_avg_fp32(const float *buf, int offset, int extend) {
   return cinn_warp_reduce_sum_fp32(buf, offset, extend) / extend;
 }
 
 #define CINN_BLOCK_REDUCE_INTERNAL_IMPL(TYPE, value, init_value, cinn_warp_shuffle_internal) \
-  int warp_id = threadIdx.x / 32;                                                            \
-  __shared__ TYPE tmp[32];                                                                   \
+  int warp_id = threadIdx.x / CINN_WARP_SIZE;                                                \
+  __shared__ TYPE tmp[CINN_WARP_SIZE];                                                       \
   if (warp_id == 0) {                                                                        \
     tmp[threadIdx.x] = init_value;                                                           \
   }                                                                                          \
   TYPE tmp_val = cinn_warp_shuffle_internal(value);                                          \
-  if (blockDim.x <= 32) {                                                                    \
+  if (blockDim.x <= CINN_WARP_SIZE) {                                                        \
     return tmp_val;                                                                          \
   }                                                                                          \
   __syncthreads();                                                                           \
-  if (threadIdx.x % 32 == 0) {                                                               \
+  if (threadIdx.x % CINN_WARP_SIZE == 0) {                                                   \
     tmp[warp_id] = tmp_val;                                                                  \
   }                                                                                          \
   __syncthreads();                                                                           \
@@ -553,8 +692,21 @@ __device__ inline float cinn_warp_reduce_avg_fp32(const float *buf, int offset,
   __syncthreads();                                                                           \
   return tmp[0];
 
+// a block of multiple rows binds the rows to threadIdx.y, if a row is reduced by a part of warp(blockDim.x <
+// CINN_WARP_SIZE), only the lanes of the same row are shuffled, blockDim.x should be a power of 2 in this case.
+#define CINN_SUB_WARP_REDUCE_IMPL(TYPE, value, reduce_func)                             \
+  if (blockDim.x < CINN_WARP_SIZE && blockDim.y > 1) {                                  \
+    TYPE tmp_val          = value;                                                      \
+    cinn_lane_mask_t mask = CINN_ACTIVE_MASK();                                         \
+    for (int offset = blockDim.x / 2; offset > 0; offset /= 2) {                        \
+      tmp_val = reduce_func(tmp_val, CINN_SHFL_XOR(mask, tmp_val, offset, blockDim.x)); \
+    }                                                                                   \
+    return tmp_val;                                                                     \
+  }
+
 #define CINN_BLOCK_REDUCE_INTERNAL_MACRO(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                            \
-  __device__ inline DTYPE cinn_block_reduce_##REDUCE_TYPE##_internal(const DTYPE value) {                              \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_block_reduce_##REDUCE_TYPE##_internal(const DTYPE value) {                   \
+    CINN_SUB_WARP_REDUCE_IMPL(DTYPE, value, cinn_##REDUCE_TYPE)                                                        \
     CINN_BLOCK_REDUCE_INTERNAL_IMPL(DTYPE, value, (DTYPE)(INITIAL_VALUE), cinn_warp_shuffle_##REDUCE_TYPE##_internal); \
   }
 
@@ -572,16 +724,14 @@ EXPAND_REDUCE_BF16_MACRO(CINN_BLOCK_REDUCE_INTERNAL_MACRO)
 EXPAND_REDUCE_FP16_MACRO(CINN_BLOCK_REDUCE_INTERNAL_MACRO)
 #endif
 
+#undef CINN_SUB_WARP_REDUCE_IMPL
 #undef CINN_BLOCK_REDUCE_INTERNAL_IMPL
 #undef CINN_BLOCK_REDUCE_INTERNAL_MACRO
 
-#define CINN_BLOCK_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                     \
-  __device__ inline DTYPE cinn_block_reduce_##REDUCE_TYPE(const DTYPE *buf, int offset, int extend) { \
-    DTYPE tmp_val = (DTYPE)(INITIAL_VALUE);                                                           \
-    for (int i = threadIdx.x; i < extend; i += blockDim.x) {                                          \
-      tmp_val = cinn_##REDUCE_TYPE(tmp_val, buf[offset + i]);                                         \
-    }                                                                                                 \
-    return cinn_block_reduce_##REDUCE_TYPE##_internal(tmp_val);                                       \
+#define CINN_BLOCK_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                                \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_block_reduce_##REDUCE_TYPE(const DTYPE *buf, int offset, int extend) { \
+    DTYPE tmp_val = cinn_partial_reduce_##REDUCE_TYPE(buf, offset, extend, threadIdx.x, blockDim.x);             \
+    return cinn_block_reduce_##REDUCE_TYPE##_internal(tmp_val);                                                  \
   }
 
 EXPAND_REDUCE_INT32_MARCO(CINN_BLOCK_REDUCE_IMPL)
@@ -600,6 +750,100 @@ EXPAND_REDUCE_FP16_MACRO(CINN_BLOCK_REDUCE_IMPL)
 
 #undef CINN_BLOCK_REDUCE_IMPL
 
+// The partial results of the blocks of a grid reduction are written into the workspace, and the last block done,
+// counted by the semaphore, reduces them in the order of blockIdx, so the result is the same between the runs of the
+// same grid. atomicInc wraps the semaphore to 0 after the last block, so it is ready for the next launch. The kernels
+// of a module run in order on one stream, so the grid reductions of them share the workspace and the semaphore.
+#define CINN_GRID_REDUCE_MAX_BLOCKS 1024
+
+__device__ double cinn_grid_reduce_workspace[CINN_GRID_REDUCE_MAX_BLOCKS];
+__device__ unsigned int cinn_grid_reduce_semaphore = 0;
+
+#define CINN_GRID_REDUCE_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                                \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_grid_reduce_##REDUCE_TYPE(const DTYPE *buf, int offset, int extend) { \
+    DTYPE *workspace = reinterpret_cast<DTYPE *>(cinn_grid_reduce_workspace);                                   \
+    DTYPE tmp_val    = cinn_partial_reduce_##REDUCE_TYPE(                                                       \
+        buf, offset, extend, blockIdx.x * blockDim.x + threadIdx.x, gridDim.x * blockDim.x);                    \
+    tmp_val = cinn_block_reduce_##REDUCE_TYPE##_internal(tmp_val);                                              \
+    __shared__ bool is_last_block;                                                                              \
+    if (threadIdx.x == 0) {                                                                                     \
+      workspace[blockIdx.x] = tmp_val;                                                                          \
+      __threadfence();                                                                                          \
+      is_last_block = atomicInc(&cinn_grid_reduce_semaphore, gridDim.x - 1) == gridDim.x - 1;                   \
+    }                                                                                                           \
+    __syncthreads();                                                                                            \
+    if (!is_last_block) {                                                                                       \
+      CINN_EXIT_THREAD();                                                                                       \
+    }                                                                                                           \
+    tmp_val = cinn_partial_reduce_##REDUCE_TYPE(workspace, 0, gridDim.x, threadIdx.x, blockDim.x);              \
+    return cinn_block_reduce_##REDUCE_TYPE##_internal(tmp_val);                                                 \
+  }
+
+EXPAND_REDUCE_INT32_MARCO(CINN_GRID_REDUCE_IMPL)
+EXPAND_REDUCE_INT64_MARCO(CINN_GRID_REDUCE_IMPL)
+EXPAND_REDUCE_FP32_MACRO(CINN_GRID_REDUCE_IMPL)
+EXPAND_REDUCE_FP64_MACRO(CINN_GRID_REDUCE_IMPL)
+EXPAND_REDUCE_BOOL_MACRO(CINN_GRID_REDUCE_IMPL)
+
+#ifdef CINN_CUDA_BF16
+EXPAND_REDUCE_BF16_MACRO(CINN_GRID_REDUCE_IMPL)
+#endif
+
+#ifdef CINN_CUDA_FP16
+EXPAND_REDUCE_FP16_MACRO(CINN_GRID_REDUCE_IMPL)
+#endif
+
+#undef CINN_GRID_REDUCE_IMPL
+
+// The inclusive or exclusive scan of the values of the threads of a block in the order of threadIdx.x, so the k-th
+// thread gets the result of the values of the threads [0, k] or [0, k). It is the building block of the cumulative
+// ops in the fused kernels and of the tiles of the decoupled look-back scan. blockDim.x should be a multiple of
+// CINN_WARP_SIZE with blockDim.y == 1, and all the threads of the block should call it.
+#define CINN_BLOCK_SCAN_IMPL(REDUCE_TYPE, INITIAL_VALUE, DTYPE)                                               \
+  __device__ CINN_NVGPU_INLINE DTYPE cinn_block_scan_##REDUCE_TYPE(const DTYPE value, const bool exclusive) { \
+    __shared__ DTYPE warp_totals[CINN_WARP_SIZE];                                                             \
+    const int lane      = threadIdx.x & (CINN_WARP_SIZE - 1);                                                 \
+    const int warp_id   = threadIdx.x / CINN_WARP_SIZE;                                                       \
+    const int num_warps = blockDim.x / CINN_WARP_SIZE;                                                        \
+    DTYPE inclusive     = value;                                                                              \
+    for (int offset = 1; offset < CINN_WARP_SIZE; offset <<= 1) {                                             \
+      DTYPE other = CINN_SHFL_UP(CINN_FULL_LANE_MASK, inclusive, offset);                                     \
+      if (lane >= offset) inclusive = cinn_##REDUCE_TYPE(other, inclusive);                                   \
+    }                                                                                                         \
+    DTYPE lane_prefix = CINN_SHFL_UP(CINN_FULL_LANE_MASK, inclusive, 1);                                      \
+    if (lane == 0) lane_prefix = (DTYPE)(INITIAL_VALUE);                                                      \
+    if (lane == CINN_WARP_SIZE - 1) warp_totals[warp_id] = inclusive;                                         \
+    __syncthreads();                                                                                          \
+    if (warp_id == 0) {                                                                                       \
+      DTYPE total = lane < num_warps ? warp_totals[lane] : (DTYPE)(INITIAL_VALUE);                            \
+      for (int offset = 1; offset < CINN_WARP_SIZE; offset <<= 1) {                                           \
+        DTYPE other = CINN_SHFL_UP(CINN_FULL_LANE_MASK, total, offset);                                       \
+        if (lane >= offset) total = cinn_##REDUCE_TYPE(other, total);                                         \
+      }                                                                                                       \
+      warp_totals[lane] = total;                                                                              \
+    }                                                                                                         \
+    __syncthreads();                                                                                          \
+    DTYPE result = exclusive ? lane_prefix : inclusive;                                                       \
+    if (warp_id > 0) result = cinn_##REDUCE_TYPE(warp_totals[warp_id - 1], result);                           \
+    __syncthreads();                                                                                          \
+    return result;                                                                                            \
+  }
+
+EXPAND_REDUCE_INT32_MARCO(CINN_BLOCK_SCAN_IMPL)
+EXPAND_REDUCE_INT64_MARCO(CINN_BLOCK_SCAN_IMPL)
+EXPAND_REDUCE_FP32_MACRO(CINN_BLOCK_SCAN_IMPL)
+EXPAND_REDUCE_FP64_MACRO(CINN_BLOCK_SCAN_IMPL)
+
+#ifdef CINN_CUDA_BF16
+EXPAND_REDUCE_BF16_MACRO(CINN_BLOCK_SCAN_IMPL)
+#endif
+
+#ifdef CINN_CUDA_FP16
+EXPAND_REDUCE_FP16_MACRO(CINN_BLOCK_SCAN_IMPL)
+#endif
+
+#undef CINN_BLOCK_SCAN_IMPL
+
 #undef EXPAND_REDUCE_INT32_MARCO
 #undef EXPAND_REDUCE_INT64_MARCO
 #undef EXPAND_REDUCE_FP32_MACRO
@@ -624,25 +868,25 @@ EXPAND_REDUCE_FP16_MACRO(CINN_BLOCK_REDUCE_IMPL)
     return -1;                                                           \
   } while (0)
 
-__device__ inline int cinn_cuda_find_int(const int *buf, int size, int num) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_int(const int *buf, int size, int num) {
   __cinn_cuda_find_kernel(buf, size, num, 0, 1);
 }
 
-__device__ inline int cinn_cuda_find_float(const float *buf, int size, float num) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_float(const float *buf, int size, float num) {
   __cinn_cuda_find_kernel(buf, size, num, 0, 1);
 }
 
-__device__ inline int cinn_cuda_find_int_nd(const int *buf, int size, int num, int begin, int stride) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_int_nd(const int *buf, int size, int num, int begin, int stride) {
   __cinn_cuda_find_kernel(buf, size, num, begin, stride);
 }
 
-__device__ inline int cinn_cuda_find_float_nd(const float *buf, int size, float num, int begin, int stride) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_float_nd(const float *buf, int size, float num, int begin, int stride) {
   __cinn_cuda_find_kernel(buf, size, num, begin, stride);
 }
 
 #undef __cinn_cuda_find_kernel
 
-__device__ inline int cinn_nvgpu_next_smallest_int32(int *buf, int size, int num, int begin, int stride) {
+__device__ CINN_NVGPU_INLINE int cinn_nvgpu_next_smallest_int32(int *buf, int size, int num, int begin, int stride) {
   int id = -1;
   for (int i = begin; i < begin + size * stride; i += stride) {
     if (id == -1 || buf[i] < buf[id]) {
@@ -664,18 +908,18 @@ __device__ inline int cinn_nvgpu_next_smallest_int32(int *buf, int size, int num
     return -1;                                              \
   } while (0)
 
-__device__ inline int cinn_cuda_find_int_from(const int *buf, int size, int num, int begin) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_int_from(const int *buf, int size, int num, int begin) {
   __cinn_cuda_find_from_kernel(buf, size, num, begin);
 }
 
-__device__ inline int cinn_cuda_find_float_from(const float *buf, int size, float num, int begin) {
+__device__ CINN_NVGPU_INLINE int cinn_cuda_find_float_from(const float *buf, int size, float num, int begin) {
   __cinn_cuda_find_from_kernel(buf, size, num, begin);
 }
 
 #undef __cinn_cuda_find_from_kernel
 
 #define CINN_NVGPU_LT_NUM(TYPE_SUFFIX, TYPE)                                                  \
-  __device__ inline int cinn_nvgpu_lt_num_##TYPE_SUFFIX(                                      \
+  __device__ CINN_NVGPU_INLINE int cinn_nvgpu_lt_num_##TYPE_SUFFIX(                           \
       const TYPE *buf, const int size, const TYPE num, const int offset, const int stride) { \
     int out = 0;                                                                             \
     for (int i = (size - 1) * stride + offset; i >= offset; i -= stride) {                   \
@@ -695,7 +939,7 @@ CINN_NVGPU_LT_NUM(fp16, float16)
 #undef CINN_NVGPU_LT_NUM
 
 #define CINN_NVGPU_GT_NUM(TYPE_SUFFIX, TYPE)                                                 \
-  __device__ inline int cinn_nvgpu_gt_num_##TYPE_SUFFIX(                                     \
+  __device__ CINN_NVGPU_INLINE int cinn_nvgpu_gt_num_##TYPE_SUFFIX(                          \
       const TYPE *buf, const int size, const TYPE num, const int offset, const int stride) { \
     int out = 0;                                                                             \
     for (int i = (size - 1) * stride + offset; i >= offset; i -= stride) {                   \
@@ -714,23 +958,23 @@ CINN_NVGPU_GT_NUM(fp16, float16)
 
 #undef CINN_NVGPU_GT_NUM
 
-#define CINN_NVGPU_INDEX_ADD(TYPE_SUFFIX, TYPE)                               \
-  __device__ inline TYPE cinn_nvgpu_index_add_##TYPE_SUFFIX(const TYPE x,     \
-                                            const int axis_indice,            \
-                                            const TYPE *__restrict__ y,       \
-                                            const int offset,                 \
-                                            const int stride,                 \
-                                            const int *__restrict__ index,    \
-                                            const int index_size) {           \
-    TYPE res = x;                                                             \
-    int idx  = -1;                                                            \
-    do {                                                                      \
-      idx = cinn_cuda_find_int_from(index, index_size, axis_indice, idx + 1); \
-      if (idx >= 0) {                                                         \
-        res += y[offset + idx * stride];                                      \
-      }                                                                       \
-    } while (idx != -1);                                                      \
-    return res;                                                               \
+#define CINN_NVGPU_INDEX_ADD(TYPE_SUFFIX, TYPE)                                      \
+  __device__ CINN_NVGPU_INLINE TYPE cinn_nvgpu_index_add_##TYPE_SUFFIX(const TYPE x, \
+                                            const int axis_indice,                   \
+                                            const TYPE *__restrict__ y,              \
+                                            const int offset,                        \
+                                            const int stride,                        \
+                                            const int *__restrict__ index,           \
+                                            const int index_size) {                  \
+    TYPE res = x;                                                                    \
+    int idx  = -1;                                                                   \
+    do {                                                                             \
+      idx = cinn_cuda_find_int_from(index, index_size, axis_indice, idx + 1);        \
+      if (idx >= 0) {                                                                \
+        res += y[offset + idx * stride];                                             \
+      }                                                                              \
+    } while (idx != -1);                                                             \
+    return res;                                                                      \
   }
 
 CINN_NVGPU_INDEX_ADD(bool, bool)
@@ -745,6 +989,53 @@ CINN_NVGPU_INDEX_ADD(fp16, float16)
 
 #undef CINN_CUDA_INDEX_ADD
 
+// *************************************************************** //
+// sparse matrix multiplications, the row-split SpMM of a CSR matrix computes an element of the output by a thread,
+// so the threads of the consecutive columns read the same non-zeros and the coalesced rows of the dense matrix.
+#define CINN_NVGPU_CSR_SPMM(TYPE_SUFFIX, TYPE, ACC_TYPE)                                             \
+  __device__ CINN_NVGPU_INLINE TYPE cinn_nvgpu_csr_spmm_##TYPE_SUFFIX(const int *__restrict__ crows, \
+                                                           const int *__restrict__ cols,             \
+                                                           const TYPE *__restrict__ values,          \
+                                                           const TYPE *__restrict__ dense,           \
+                                                           const int row,                            \
+                                                           const int col,                            \
+                                                           const int n) {                            \
+    ACC_TYPE res = static_cast<ACC_TYPE>(0);                                                         \
+    for (int p = crows[row]; p < crows[row + 1]; ++p) {                                              \
+      res += static_cast<ACC_TYPE>(values[p]) * static_cast<ACC_TYPE>(dense[cols[p] * n + col]);     \
+    }                                                                                                \
+    return static_cast<TYPE>(res);                                                                   \
+  }
+
+// the SDDMM of a COO pattern computes the dot product of the row of x and the row of y for a non-zero by a thread
+#define CINN_NVGPU_SDDMM(TYPE_SUFFIX, TYPE, ACC_TYPE)                                            \
+  __device__ CINN_NVGPU_INLINE TYPE cinn_nvgpu_sddmm_##TYPE_SUFFIX(const int *__restrict__ rows, \
+                                                        const int *__restrict__ cols,            \
+                                                        const TYPE *__restrict__ x,              \
+                                                        const TYPE *__restrict__ y,              \
+                                                        const int p,                             \
+                                                        const int k) {                           \
+    const TYPE *x_row = x + rows[p] * k;                                                         \
+    const TYPE *y_row = y + cols[p] * k;                                                         \
+    ACC_TYPE res      = static_cast<ACC_TYPE>(0);                                                \
+    for (int i = 0; i < k; ++i) {                                                                \
+      res += static_cast<ACC_TYPE>(x_row[i]) * static_cast<ACC_TYPE>(y_row[i]);                  \
+    }                                                                                            \
+    return static_cast<TYPE>(res);                                                               \
+  }
+
+CINN_NVGPU_CSR_SPMM(fp32, float, float)
+CINN_NVGPU_CSR_SPMM(fp64, double, double)
+CINN_NVGPU_SDDMM(fp32, float, float)
+CINN_NVGPU_SDDMM(fp64, double, double)
+#ifdef CINN_CUDA_FP16
+CINN_NVGPU_CSR_SPMM(fp16, float16, float)
+CINN_NVGPU_SDDMM(fp16, float16, float)
+#endif
+
+#undef CINN_NVGPU_SDDMM
+#undef CINN_NVGPU_CSR_SPMM
+
 __device__ int cinn_cuda_resize_bilinear(const int *buf,
                                          const int c_size,
                                          const int in_h,
@@ -842,10 +1133,284 @@ __device__ int cinn_cuda_resize_bicubic(const int *buf,
   return value;
 }
 
+// *************************************************************** //
+// asynchronous copy from global memory to shared memory, used by the pipelined shared buffers.
+// The copies issued between two cinn_cp_async_commit make a group, and cinn_cp_async_wait(n) waits until
+// at most n groups are pending. The architectures before sm80 copy synchronously.
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
+#define CINN_CP_ASYNC(BYTES, TYPE)                                                                     \
+  __device__ CINN_NVGPU_INLINE void cinn_cp_async_##BYTES(void *dst, const void *src) {                \
+    unsigned int dst_addr = static_cast<unsigned int>(__cvta_generic_to_shared(dst));                  \
+    asm volatile("cp.async.ca.shared.global [%0], [%1], %2;\n" ::"r"(dst_addr), "l"(src), "n"(BYTES)); \
+  }
+
+__device__ CINN_NVGPU_INLINE void cinn_cp_async_commit() { asm volatile("cp.async.commit_group;\n" ::); }
+
+__device__ CINN_NVGPU_INLINE void cinn_cp_async_wait(int n) {
+  // the number of groups must be an immediate, waiting for fewer pending groups than n is always safe
+  if (n <= 0) {
+    asm volatile("cp.async.wait_group 0;\n" ::);
+  } else if (n == 1) {
+    asm volatile("cp.async.wait_group 1;\n" ::);
+  } else {
+    asm volatile("cp.async.wait_group 2;\n" ::);
+  }
+}
+#else
+#define CINN_CP_ASYNC(BYTES, TYPE)                                                      \
+  __device__ CINN_NVGPU_INLINE void cinn_cp_async_##BYTES(void *dst, const void *src) { \
+    *reinterpret_cast<TYPE *>(dst) = *reinterpret_cast<const TYPE *>(src);              \
+  }
+
+__device__ CINN_NVGPU_INLINE void cinn_cp_async_commit() {}
+
+__device__ CINN_NVGPU_INLINE void cinn_cp_async_wait(int n) {}
+#endif
+
+CINN_CP_ASYNC(4, int)
+CINN_CP_ASYNC(8, int2)
+CINN_CP_ASYNC(16, int4)
+
+#undef CINN_CP_ASYNC
+
+// *************************************************************** //
+// packed float16/bfloat16 vector operator, used by the vectorized elementwise kernels.
+// Two lanes are computed by one half2/__nv_bfloat162 instruction on the architectures supporting it,
+// and the others compute the lanes one by one.
+#define CINN_PACKED_PAIRWISE(PAIR_T, PACKED_FN)                            \
+  const PAIR_T *pa = reinterpret_cast<const PAIR_T *>(&a);                 \
+  const PAIR_T *pb = reinterpret_cast<const PAIR_T *>(&b);                 \
+  PAIR_T *pr       = reinterpret_cast<PAIR_T *>(&res);                     \
+  _Pragma("unroll") for (int i = 0; i < sizeof(res) / sizeof(PAIR_T); ++i) \
+      pr[i] = PACKED_FN(pa[i], pb[i]);
+
+#define CINN_PACKED_LANEWISE(SCALAR_T, SCALAR_FN)                            \
+  const SCALAR_T *pa = reinterpret_cast<const SCALAR_T *>(&a);               \
+  const SCALAR_T *pb = reinterpret_cast<const SCALAR_T *>(&b);               \
+  SCALAR_T *pr       = reinterpret_cast<SCALAR_T *>(&res);                   \
+  _Pragma("unroll") for (int i = 0; i < sizeof(res) / sizeof(SCALAR_T); ++i) \
+      pr[i] = SCALAR_FN(pa[i], pb[i]);
+
+#define CINN_SCALAR_ADD(x, y) ((x) + (y))
+#define CINN_SCALAR_SUB(x, y) ((x) - (y))
+#define CINN_SCALAR_MUL(x, y) ((x) * (y))
+#define CINN_SCALAR_MAX(x, y) ((x) > (y) ? (x) : (y))
+#define CINN_SCALAR_MIN(x, y) ((x) < (y) ? (x) : (y))
+
+#define CINN_PACKED_BINARY(FUNC, SUFFIX, VEC_T, LANES, BODY)                                                \
+  __device__ CINN_NVGPU_INLINE VEC_T cinn_nvgpu_##FUNC##_##SUFFIX##x##LANES(const VEC_T a, const VEC_T b) { \
+    VEC_T res;                                                                                              \
+    BODY                                                                                                    \
+    return res;                                                                                             \
+  }
+
+#ifdef CINN_CUDA_FP16
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 530
+#define CINN_PACKED_FP16_ARITH(PACKED_FN, SCALAR_FN) CINN_PACKED_PAIRWISE(__half2, PACKED_FN)
+#else
+#define CINN_PACKED_FP16_ARITH(PACKED_FN, SCALAR_FN) CINN_PACKED_LANEWISE(float16, SCALAR_FN)
+#endif
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
+#define CINN_PACKED_FP16_CMP(PACKED_FN, SCALAR_FN) CINN_PACKED_PAIRWISE(__half2, PACKED_FN)
+#else
+#define CINN_PACKED_FP16_CMP(PACKED_FN, SCALAR_FN) CINN_PACKED_LANEWISE(float16, SCALAR_FN)
+#endif
+
+#define CINN_PACKED_FP16(VEC_T, LANES)                                                           \
+  CINN_PACKED_BINARY(add, fp16, VEC_T, LANES, CINN_PACKED_FP16_ARITH(__hadd2, CINN_SCALAR_ADD)) \
+  CINN_PACKED_BINARY(sub, fp16, VEC_T, LANES, CINN_PACKED_FP16_ARITH(__hsub2, CINN_SCALAR_SUB)) \
+  CINN_PACKED_BINARY(mul, fp16, VEC_T, LANES, CINN_PACKED_FP16_ARITH(__hmul2, CINN_SCALAR_MUL)) \
+  CINN_PACKED_BINARY(max, fp16, VEC_T, LANES, CINN_PACKED_FP16_CMP(__hmax2, CINN_SCALAR_MAX))   \
+  CINN_PACKED_BINARY(min, fp16, VEC_T, LANES, CINN_PACKED_FP16_CMP(__hmin2, CINN_SCALAR_MIN))
+
+CINN_PACKED_FP16(half2, 2)
+CINN_PACKED_FP16(half4, 4)
+CINN_PACKED_FP16(half8, 8)
+
+#undef CINN_PACKED_FP16
+#undef CINN_PACKED_FP16_CMP
+#undef CINN_PACKED_FP16_ARITH
+#endif
+
+#ifdef CINN_CUDA_BF16
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
+#define CINN_PACKED_BF16_OP(PACKED_FN, SCALAR_FN) CINN_PACKED_PAIRWISE(__nv_bfloat162, PACKED_FN)
+#else
+#define CINN_PACKED_BF16_OP(PACKED_FN, SCALAR_FN) CINN_PACKED_LANEWISE(bfloat16, SCALAR_FN)
+#endif
+
+#define CINN_PACKED_BF16(VEC_T, LANES)                                                        \
+  CINN_PACKED_BINARY(add, bf16, VEC_T, LANES, CINN_PACKED_BF16_OP(__hadd2, CINN_SCALAR_ADD)) \
+  CINN_PACKED_BINARY(sub, bf16, VEC_T, LANES, CINN_PACKED_BF16_OP(__hsub2, CINN_SCALAR_SUB)) \
+  CINN_PACKED_BINARY(mul, bf16, VEC_T, LANES, CINN_PACKED_BF16_OP(__hmul2, CINN_SCALAR_MUL)) \
+  CINN_PACKED_BINARY(max, bf16, VEC_T, LANES, CINN_PACKED_BF16_OP(__hmax2, CINN_SCALAR_MAX)) \
+  CINN_PACKED_BINARY(min, bf16, VEC_T, LANES, CINN_PACKED_BF16_OP(__hmin2, CINN_SCALAR_MIN))
+
+CINN_PACKED_BF16(bfloat162, 2)
+CINN_PACKED_BF16(bfloat164, 4)
+CINN_PACKED_BF16(bfloat168, 8)
+
+#undef CINN_PACKED_BF16
+#undef CINN_PACKED_BF16_OP
+#endif
+
+#undef CINN_PACKED_BINARY
+#undef CINN_SCALAR_MIN
+#undef CINN_SCALAR_MAX
+#undef CINN_SCALAR_MUL
+#undef CINN_SCALAR_SUB
+#undef CINN_SCALAR_ADD
+#undef CINN_PACKED_LANEWISE
+#undef CINN_PACKED_PAIRWISE
+
+// *************************************************************** //
+// counter-based random number generation with Philox4x32-10, the random numbers of an element only depend on the
+// seed and the offset of the element, so that they are generated inline by the fused kernels, in any thread mapping.
+__device__ CINN_NVGPU_INLINE uint4 cinn_nvgpu_philox4x32_10(uint2 key, uint4 counter) {
+#pragma unroll
+  for (int i = 0; i < 10; ++i) {
+    unsigned int hi0 = __umulhi(0xD2511F53U, counter.x);
+    unsigned int lo0 = 0xD2511F53U * counter.x;
+    unsigned int hi1 = __umulhi(0xCD9E8D57U, counter.z);
+    unsigned int lo1 = 0xCD9E8D57U * counter.z;
+    counter          = make_uint4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+    key.x += 0x9E3779B9U;
+    key.y += 0xBB67AE85U;
+  }
+  return counter;
+}
+
+__device__ CINN_NVGPU_INLINE uint4 cinn_nvgpu_philox_bits(const int64_t seed, const int64_t offset) {
+  uint2 key     = make_uint2(static_cast<unsigned int>(seed), static_cast<unsigned int>(seed >> 32));
+  uint4 counter = make_uint4(static_cast<unsigned int>(offset), static_cast<unsigned int>(offset >> 32), 0U, 0U);
+  return cinn_nvgpu_philox4x32_10(key, counter);
+}
+
+// uniformly distributed in [0, 1)
+__device__ CINN_NVGPU_INLINE float FN_FP32(philox_uniform)(const int64_t seed, const int64_t offset) {
+  return (cinn_nvgpu_philox_bits(seed, offset).x >> 8) * 5.9604644775390625e-08F;
+}
+
+__device__ CINN_NVGPU_INLINE double FN_FP64(philox_uniform)(const int64_t seed, const int64_t offset) {
+  uint4 bits = cinn_nvgpu_philox_bits(seed, offset);
+  return (((static_cast<unsigned long long>(bits.x) << 32) | bits.y) >> 11) * 1.1102230246251565e-16;
+}
+
+// *************************************************************** //
+// tensor core intrinsics, each of them is executed by all the threads of a warp cooperatively,
+// and computes a 16x16 tile of C with the 16x16 tile of A and 16x16 tile of B: C = (init ? 0 : C) + A * B,
+// where A, B and C are row major with the leading dimensions lda, ldb and ldc.
+#ifdef CINN_CUDA_FP16
+#define CINN_WMMA_ACC_TYPE_float float
+#define CINN_WMMA_ACC_TYPE_float16 half
+#define CINN_WMMA_ACC_TYPE(TYPE) CINN_WMMA_ACC_TYPE_##TYPE
+
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 700
+#define CINN_WMMA_M16N16K16_BODY(TYPE)                                                        \
+  using namespace nvcuda;                                                                     \
+  using AccType = CINN_WMMA_ACC_TYPE(TYPE);                                                   \
+  wmma::fragment<wmma::matrix_a, 16, 16, 16, half, wmma::row_major> a_frag;                   \
+  wmma::fragment<wmma::matrix_b, 16, 16, 16, half, wmma::row_major> b_frag;                   \
+  wmma::fragment<wmma::accumulator, 16, 16, 16, AccType> c_frag;                              \
+  if (init) {                                                                                 \
+    wmma::fill_fragment(c_frag, static_cast<AccType>(0.0F));                                  \
+  } else {                                                                                    \
+    wmma::load_matrix_sync(c_frag, reinterpret_cast<AccType *>(c), ldc, wmma::mem_row_major); \
+  }                                                                                           \
+  wmma::load_matrix_sync(a_frag, reinterpret_cast<const half *>(a), lda);                     \
+  wmma::load_matrix_sync(b_frag, reinterpret_cast<const half *>(b), ldb);                     \
+  wmma::mma_sync(c_frag, a_frag, b_frag, c_frag);                                             \
+  wmma::store_matrix_sync(reinterpret_cast<AccType *>(c), c_frag, ldc, wmma::mem_row_major);
+#else
+// the architectures without tensor core compute the elements of the tile by the lanes of the warp in turn
+#define CINN_WMMA_M16N16K16_BODY(TYPE)                                                    \
+  for (int idx = threadIdx.x % 32; idx < 256; idx += 32) {                                \
+    int row   = idx / 16;                                                                 \
+    int col   = idx % 16;                                                                 \
+    float acc = init ? 0.0F : static_cast<float>(c[row * ldc + col]);                     \
+    for (int k = 0; k < 16; ++k) {                                                        \
+      acc += static_cast<float>(a[row * lda + k]) * static_cast<float>(b[k * ldb + col]); \
+    }                                                                                     \
+    c[row * ldc + col] = static_cast<TYPE>(acc);                                          \
+  }
+#endif
+
+#define CINN_WMMA_M16N16K16(TYPE_SUFFIX, TYPE)                                             \
+  __device__ CINN_NVGPU_INLINE void cinn_wmma_m16n16k16_##TYPE_SUFFIX(                     \
+      TYPE *c, const float16 *a, const float16 *b, int lda, int ldb, int ldc, bool init) { \
+    CINN_WMMA_M16N16K16_BODY(TYPE)                                                         \
+  }
+
+CINN_WMMA_M16N16K16(f16f32, float)
+CINN_WMMA_M16N16K16(f16f16, float16)
+
+// computes a 16x8 tile of C with the 16x16 tile of A and 16x8 tile of B by mma.sync, each lane holds the elements of
+// the fragments in the layouts of mma.m16n8k16 in the PTX ISA, where the lanes of a group of 4 share a row of A and C
+__device__ CINN_NVGPU_INLINE void cinn_mma_m16n8k16_f16f32(
+    float *c, const float16 *a, const float16 *b, int lda, int ldb, int ldc, bool init) {
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800
+  const unsigned short *a_bits = reinterpret_cast<const unsigned short *>(a);
+  const unsigned short *b_bits = reinterpret_cast<const unsigned short *>(b);
+  auto pack                    = [](unsigned short lo, unsigned short hi) {
+    return static_cast<unsigned int>(lo) | (static_cast<unsigned int>(hi) << 16);
+  };
+  int lane  = threadIdx.x % 32;
+  int group = lane / 4;
+  int col   = lane % 4 * 2;
+  unsigned int a_frag[4], b_frag[2];
+  for (int i = 0; i < 4; ++i) {
+    const unsigned short *row = a_bits + (group + i % 2 * 8) * lda + col + i / 2 * 8;
+    a_frag[i]                 = pack(row[0], row[1]);
+  }
+  for (int i = 0; i < 2; ++i) {
+    const unsigned short *row = b_bits + (col + i * 8) * ldb + group;
+    b_frag[i]                 = pack(row[0], row[ldb]);
+  }
+  float acc[4];
+  for (int i = 0; i < 4; ++i) {
+    acc[i] = init ? 0.0F : c[(group + i / 2 * 8) * ldc + col + i % 2];
+  }
+  asm volatile(
+      "mma.sync.aligned.m16n8k16.row.col.f32.f16.f16.f32 {%0, %1, %2, %3}, {%4, %5, %6, %7}, {%8, %9}, "
+      "{%0, %1, %2, %3};\n"
+      : "+f"(acc[0]), "+f"(acc[1]), "+f"(acc[2]), "+f"(acc[3])
+      : "r"(a_frag[0]), "r"(a_frag[1]), "r"(a_frag[2]), "r"(a_frag[3]), "r"(b_frag[0]), "r"(b_frag[1]));
+  for (int i = 0; i < 4; ++i) {
+    c[(group + i / 2 * 8) * ldc + col + i % 2] = acc[i];
+  }
+#else
+  for (int idx = threadIdx.x % 32; idx < 128; idx += 32) {
+    int row   = idx / 8;
+    int col   = idx % 8;
+    float acc = init ? 0.0F : c[row * ldc + col];
+    for (int k = 0; k < 16; ++k) {
+      acc += static_cast<float>(a[row * lda + k]) * static_cast<float>(b[k * ldb + col]);
+    }
+    c[row * ldc + col] = acc;
+  }
+#endif
+}
+
+#undef CINN_WMMA_M16N16K16
+#undef CINN_WMMA_M16N16K16_BODY
+#undef CINN_WMMA_ACC_TYPE
+#undef CINN_WMMA_ACC_TYPE_float
+#undef CINN_WMMA_ACC_TYPE_float16
+#endif
+
 // *************************************************************** //
 // end of macro undef
 #undef CINN_INT32_MAX
 #undef CINN_INT32_MIN
+#undef CINN_FULL_LANE_MASK
+#undef CINN_EXIT_THREAD
+#undef CINN_SHFL_XOR
+#undef CINN_SHFL_DOWN
+#undef CINN_SHFL_UP
+#undef CINN_SHFL
+#undef CINN_POPC
+#undef CINN_ACTIVE_MASK
+#undef CINN_WARP_SIZE
 #undef FN_BOOL
 #undef FN_UINT8
 #undef FN_INT8
@@ -854,6 +1419,7 @@ __device__ int cinn_cuda_resize_bicubic(const int *buf,
 #undef FN_FP64
 #undef FN_INT32
 #undef FN_INT64
+#undef CINN_NVGPU_INLINE
 
 #ifdef CINN_CUDA_BF16
 #undef FN_BF16
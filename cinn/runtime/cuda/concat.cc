@@ -0,0 +1,195 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kSegmentBlockSize   = 256;
+constexpr int kSegmentMaxBlocks   = 1024;
+constexpr int kSegmentVecBytes    = 16;
+constexpr int kSegmentMaxPerTable = 64;
+
+// The table of the segments is passed by value in the kernel parameters, which is read from the constant bank, so no
+// device memory is allocated for it. Each segment copies the rows of the length from the source to the destination
+// with the vectorized loads and stores, the strides and the lengths are counted in the vectors, and the blocks of
+// the y dimension of the grid copy the different segments.
+const char* kSegmentCopySource = R"(
+struct __align__(VEC_BYTES) cinn_segment_vec_t {
+  unsigned char v[VEC_BYTES];
+};
+
+struct cinn_segment_t {
+  const cinn_segment_vec_t* src;
+  cinn_segment_vec_t* dst;
+  long long src_stride;
+  long long dst_stride;
+  long long length;
+};
+
+struct cinn_segment_table_t {
+  cinn_segment_t segments[MAX_SEGMENTS];
+};
+
+extern "C" __global__ void cinn_segment_copy_kernel(const cinn_segment_table_t table, long long rows) {
+  const cinn_segment_t seg = table.segments[blockIdx.y];
+  const long long total    = rows * seg.length;
+  const long long stride   = static_cast<long long>(gridDim.x) * blockDim.x;
+  for (long long i = static_cast<long long>(blockIdx.x) * blockDim.x + threadIdx.x; i < total; i += stride) {
+    const long long row = i / seg.length;
+    const long long col = i - row * seg.length;
+    seg.dst[row * seg.dst_stride + col] = seg.src[row * seg.src_stride + col];
+  }
+}
+)";
+
+// The same layout as cinn_segment_t of the kernel source.
+struct Segment {
+  const void* src;
+  void* dst;
+  long long src_stride;
+  long long dst_stride;
+  long long length;
+};
+
+struct SegmentTable {
+  Segment segments[kSegmentMaxPerTable];
+};
+
+// The kernel only moves the bytes, so it is compiled by NVRTC once for each vector width.
+CUDAModule* GetSegmentCopyModule(int vec_bytes) {
+  static std::mutex mtx;
+  static std::unordered_map<int, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it = modules.find(vec_bytes);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define VEC_BYTES " + std::to_string(vec_bytes) + "\n";
+  source += "#define MAX_SEGMENTS " + std::to_string(kSegmentMaxPerTable) + "\n";
+  source += kSegmentCopySource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the segment copy kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(vec_bytes, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+// Copy the segments, each of `rows` rows of `row_bytes` bytes, whose strides are given in bytes. The vector is the
+// widest one up to 16 bytes dividing the rows and the strides, and aligning all the pointers.
+void CopySegments(const std::vector<Segment>& segments, long long rows, long long row_bytes, cudaStream_t stream) {
+  if (segments.empty() || rows == 0 || row_bytes == 0) {
+    return;
+  }
+  int vec_bytes = kSegmentVecBytes;
+  auto aligned  = [&vec_bytes](long long value) { return value % vec_bytes == 0; };
+  while (vec_bytes > 1) {
+    bool fit = aligned(row_bytes);
+    for (auto& seg : segments) {
+      fit = fit && aligned(reinterpret_cast<long long>(seg.src)) && aligned(reinterpret_cast<long long>(seg.dst)) &&
+            aligned(seg.src_stride) && aligned(seg.dst_stride);
+    }
+    if (fit) break;
+    vec_bytes >>= 1;
+  }
+  auto* module = GetSegmentCopyModule(vec_bytes);
+
+  long long length   = row_bytes / vec_bytes;
+  long long num_vecs = rows * length;
+  dim3 grid(std::max<long long>(
+      std::min<long long>((num_vecs + kSegmentBlockSize - 1) / kSegmentBlockSize, kSegmentMaxBlocks), 1));
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  for (size_t begin = 0; begin < segments.size(); begin += kSegmentMaxPerTable) {
+    size_t end = std::min(segments.size(), begin + kSegmentMaxPerTable);
+    SegmentTable table;
+    for (size_t i = begin; i < end; ++i) {
+      table.segments[i - begin]            = segments[i];
+      table.segments[i - begin].src_stride = segments[i].src_stride / vec_bytes;
+      table.segments[i - begin].dst_stride = segments[i].dst_stride / vec_bytes;
+      table.segments[i - begin].length     = length;
+    }
+    grid.y              = end - begin;
+    void* kernel_args[] = {&table, &rows};
+    module->LaunchKernel(device_id,
+                         "cinn_segment_copy_kernel",
+                         grid,
+                         dim3(kSegmentBlockSize),
+                         kernel_args,
+                         0,
+                         static_cast<CUstream>(stream));
+  }
+}
+
+}  // namespace
+
+void cinn_call_concat_nvgpu(void* v_args, int num_args, int outer, int inner, void* stream) {
+  CHECK_GE(num_args, 2) << "The concat takes the inputs and the output.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  int num_inputs         = num_args - 1;
+  cinn_buffer_t* out     = args[num_inputs].operator cinn_buffer_t*();
+  VLOG(4) << "concat: num_inputs=" << num_inputs << ", outer=" << outer << ", inner=" << inner;
+
+  long long row_bytes = static_cast<long long>(inner) * out->type.bytes();
+  std::vector<Segment> segments;
+  for (int i = 0; i < num_inputs; ++i) {
+    cinn_buffer_t* input = args[i].operator cinn_buffer_t*();
+    segments.push_back({input->memory, out->memory + i * row_bytes, row_bytes, num_inputs * row_bytes, 0});
+  }
+  CopySegments(segments, outer, row_bytes, static_cast<cudaStream_t>(stream));
+}
+
+void cinn_call_split_nvgpu(void* v_args, int num_args, int outer, int inner, void* stream) {
+  CHECK_GE(num_args, 2) << "The split takes the input and the outputs.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  int num_outputs        = num_args - 1;
+  cinn_buffer_t* input   = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "split: num_outputs=" << num_outputs << ", outer=" << outer << ", inner=" << inner;
+
+  long long row_bytes = static_cast<long long>(inner) * input->type.bytes();
+  std::vector<Segment> segments;
+  for (int i = 0; i < num_outputs; ++i) {
+    cinn_buffer_t* out = args[i + 1].operator cinn_buffer_t*();
+    segments.push_back({input->memory + i * row_bytes, out->memory, num_outputs * row_bytes, row_bytes, 0});
+  }
+  CopySegments(segments, outer, row_bytes, static_cast<cudaStream_t>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
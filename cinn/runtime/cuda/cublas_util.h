@@ -70,6 +70,28 @@ inline cublasStatus_t cublasGemm(cudaDataType_t dtype,
                        reinterpret_cast<double *>(C),
                        ldc);
   } else if (dtype == CUDA_R_16F) {
+#if CUDA_VERSION >= 11000
+    // the half gemm accumulates in float, the half accumulation of cublasHgemm loses the precision of long K
+    return cublasGemmEx(handle,
+                        transa,
+                        transb,
+                        m,
+                        n,
+                        k,
+                        &alpha,
+                        A,
+                        CUDA_R_16F,
+                        lda,
+                        B,
+                        CUDA_R_16F,
+                        ldb,
+                        &beta,
+                        C,
+                        CUDA_R_16F,
+                        ldc,
+                        CUBLAS_COMPUTE_32F,
+                        CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
     common::float16 alpha_fp16{alpha};
     common::float16 beta_fp16{beta};
     return cublasHgemm(handle,
@@ -86,6 +108,7 @@ inline cublasStatus_t cublasGemm(cudaDataType_t dtype,
                        reinterpret_cast<const __half *>(&beta_fp16),
                        reinterpret_cast<__half *>(C),
                        ldc);
+#endif
   } else if (dtype == CUDA_R_16BF) {
 #if CUDA_VERSION >= 11000
     return cublasGemmEx(handle,
@@ -109,6 +132,33 @@ inline cublasStatus_t cublasGemm(cudaDataType_t dtype,
                         CUBLAS_GEMM_DEFAULT_TENSOR_OP);
 #else
     LOG(FATAL) << "cublasGemmEx with bfloat16 is not supported on cuda <= 11";
+#endif
+  } else if (dtype == CUDA_R_8I) {
+#if CUDA_VERSION >= 11000
+    // the int8 gemm accumulates into int32 by the integer tensor cores
+    const int alpha_int32 = static_cast<int>(alpha);
+    const int beta_int32  = static_cast<int>(beta);
+    return cublasGemmEx(handle,
+                        transa,
+                        transb,
+                        m,
+                        n,
+                        k,
+                        &alpha_int32,
+                        A,
+                        CUDA_R_8I,
+                        lda,
+                        B,
+                        CUDA_R_8I,
+                        ldb,
+                        &beta_int32,
+                        C,
+                        CUDA_R_32I,
+                        ldc,
+                        CUBLAS_COMPUTE_32I,
+                        CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
+    LOG(FATAL) << "cublasGemmEx with int8 is not supported on cuda <= 11";
 #endif
   }
   LOG(FATAL) << "Unsupported cublasGemm precision.";
@@ -174,6 +224,31 @@ inline cublasStatus_t cublasGemmStridedBatched(cudaDataType_t dtype,
                                      strideC,
                                      batchCount);
   } else if (dtype == CUDA_R_16F) {
+#if CUDA_VERSION >= 11000
+    return cublasGemmStridedBatchedEx(handle,
+                                      transa,
+                                      transb,
+                                      m,
+                                      n,
+                                      k,
+                                      &alpha,
+                                      A,
+                                      CUDA_R_16F,
+                                      lda,
+                                      strideA,
+                                      B,
+                                      CUDA_R_16F,
+                                      ldb,
+                                      strideB,
+                                      &beta,
+                                      C,
+                                      CUDA_R_16F,
+                                      ldc,
+                                      strideC,
+                                      batchCount,
+                                      CUBLAS_COMPUTE_32F,
+                                      CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
     common::float16 alpha_fp16{alpha};
     common::float16 beta_fp16{beta};
     return cublasHgemmStridedBatched(handle,
@@ -194,6 +269,7 @@ inline cublasStatus_t cublasGemmStridedBatched(cudaDataType_t dtype,
                                      ldc,
                                      strideC,
                                      batchCount);
+#endif
   } else if (dtype == CUDA_R_16BF) {
 #if CUDA_VERSION >= 11000
     return cublasGemmStridedBatchedEx(handle,
@@ -221,6 +297,36 @@ inline cublasStatus_t cublasGemmStridedBatched(cudaDataType_t dtype,
                                       CUBLAS_GEMM_DEFAULT_TENSOR_OP);
 #else
     LOG(FATAL) << "cublasGemmStridedBatched with bfloat16 is not supported on cuda <= 11";
+#endif
+  } else if (dtype == CUDA_R_8I) {
+#if CUDA_VERSION >= 11000
+    const int alpha_int32 = static_cast<int>(alpha);
+    const int beta_int32  = static_cast<int>(beta);
+    return cublasGemmStridedBatchedEx(handle,
+                                      transa,
+                                      transb,
+                                      m,
+                                      n,
+                                      k,
+                                      &alpha_int32,
+                                      A,
+                                      CUDA_R_8I,
+                                      lda,
+                                      strideA,
+                                      B,
+                                      CUDA_R_8I,
+                                      ldb,
+                                      strideB,
+                                      &beta_int32,
+                                      C,
+                                      CUDA_R_32I,
+                                      ldc,
+                                      strideC,
+                                      batchCount,
+                                      CUBLAS_COMPUTE_32I,
+                                      CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
+    LOG(FATAL) << "cublasGemmStridedBatched with int8 is not supported on cuda <= 11";
 #endif
   }
   LOG(FATAL) << "Unsupported cublasGemmStridedBatched precision.";
@@ -277,6 +383,28 @@ inline cublasStatus_t cublasGemmBatched(cudaDataType_t dtype,
                               ldc,
                               batchCount);
   } else if (dtype == CUDA_R_16F) {
+#if CUDA_VERSION >= 11000
+    return cublasGemmBatchedEx(handle,
+                               transa,
+                               transb,
+                               m,
+                               n,
+                               k,
+                               &alpha,
+                               A,
+                               CUDA_R_16F,
+                               lda,
+                               B,
+                               CUDA_R_16F,
+                               ldb,
+                               &beta,
+                               C,
+                               CUDA_R_16F,
+                               ldc,
+                               batchCount,
+                               CUBLAS_COMPUTE_32F,
+                               CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
     __half alpha_fp16{alpha};
     __half beta_fp16{beta};
     return cublasHgemmBatched(handle,
@@ -294,6 +422,7 @@ inline cublasStatus_t cublasGemmBatched(cudaDataType_t dtype,
                               reinterpret_cast<__half **>(C),
                               ldc,
                               batchCount);
+#endif
   } else if (dtype == CUDA_R_16BF) {
 #if CUDA_VERSION >= 11000
     return cublasGemmBatchedEx(handle,
@@ -16,8 +16,11 @@
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
 #include "cinn/common/cas.h"
-#include "cinn/runtime/cuda/cuda_util.h"
 #include "cinn/runtime/custom_function.h"
+#ifdef CINN_WITH_CUDA
+#include "cinn/runtime/cuda/cuda_util.h"
+#include "cinn/runtime/cuda/nccl_util.h"
+#endif
 
 CINN_REGISTER_HELPER(cuda_intrinsics) {
   auto target = cinn::common::DefaultNVGPUTarget();
@@ -128,6 +131,13 @@ CINN_REGISTER_HELPER(cuda_intrinsics) {
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(tanh);
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(cbrt);
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(sigmoid);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(exp_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(log_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(sin_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(cos_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(tan_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(tanh_fast);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT(sigmoid_fast);
 
 #undef REGISTER_EXTERN_FUNC_1_IN_1_OUT_FLOAT
 
@@ -145,6 +155,7 @@ CINN_REGISTER_HELPER(cuda_intrinsics) {
 
   REGISTER_EXTERN_FUNC_2_IN_1_FLOAT(pow)
   REGISTER_EXTERN_FUNC_2_IN_1_FLOAT(mod)
+  REGISTER_EXTERN_FUNC_2_IN_1_FLOAT(pow_fast)
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_FLOAT
 
@@ -247,6 +258,9 @@ CINN_REGISTER_HELPER(cuda_intrinsics) {
 
 #undef REGISTER_EXTERN_FUNC_2_IN_1_INT64
 
+  REGISTER_EXTERN_SOURCE_FUNC_2_IN_1_OUT(cinn_nvgpu_philox_uniform_fp32, target, int64_t, int64_t, float);
+  REGISTER_EXTERN_SOURCE_FUNC_2_IN_1_OUT(cinn_nvgpu_philox_uniform_fp64, target, int64_t, int64_t, double);
+
   FunctionProto::shape_inference_t inference_shape_globalpool = [](const std::vector<cinn::ir::Expr> &args,
                                                                    int offset) {
     auto t = args[0].as_tensor();
@@ -370,6 +384,39 @@ CINN_REGISTER_HELPER(cuda_intrinsics) {
 
 #undef _REGISTER_CINN_NVGPU_INDEX_ADD
 
+#define _REGISTER_CINN_NVGPU_CSR_SPMM(TYPE_SUFFIX, TYPE)                        \
+  REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_nvgpu_csr_spmm_##TYPE_SUFFIX, target) \
+      .SetRetType<TYPE>()                                                       \
+      .AddInputType<cinn_buffer_t *>()                                          \
+      .AddInputType<cinn_buffer_t *>()                                          \
+      .AddInputType<cinn_buffer_t *>()                                          \
+      .AddInputType<cinn_buffer_t *>()                                          \
+      .AddInputType<int>()                                                      \
+      .AddInputType<int>()                                                      \
+      .AddInputType<int>()                                                      \
+      .End();
+
+  _REGISTER_CINN_NVGPU_CSR_SPMM(fp32, float);
+  _REGISTER_CINN_NVGPU_CSR_SPMM(fp64, double);
+
+#undef _REGISTER_CINN_NVGPU_CSR_SPMM
+
+#define _REGISTER_CINN_NVGPU_SDDMM(TYPE_SUFFIX, TYPE)                        \
+  REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_nvgpu_sddmm_##TYPE_SUFFIX, target) \
+      .SetRetType<TYPE>()                                                    \
+      .AddInputType<cinn_buffer_t *>()                                       \
+      .AddInputType<cinn_buffer_t *>()                                       \
+      .AddInputType<cinn_buffer_t *>()                                       \
+      .AddInputType<cinn_buffer_t *>()                                       \
+      .AddInputType<int>()                                                   \
+      .AddInputType<int>()                                                   \
+      .End();
+
+  _REGISTER_CINN_NVGPU_SDDMM(fp32, float);
+  _REGISTER_CINN_NVGPU_SDDMM(fp64, double);
+
+#undef _REGISTER_CINN_NVGPU_SDDMM
+
   REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_cuda_resize_bilinear, target)
       .SetRetType<int>()
       .AddInputType<cinn_buffer_t *>()
@@ -401,6 +448,7 @@ CINN_REGISTER_HELPER(cuda_intrinsics) {
   return true;
 }
 
+#ifdef CINN_WITH_CUDA
 CINN_REGISTER_HELPER(cinn_cuda_host_api) {
   using cinn::runtime::cuda::cinn_call_cuda_kernel;
   REGISTER_EXTERN_FUNC_HELPER(cinn_call_cuda_kernel, cinn::common::DefaultHostTarget())
@@ -414,6 +462,23 @@ CINN_REGISTER_HELPER(cinn_cuda_host_api) {
       .AddInputType<int>()     // block_x
       .AddInputType<int>()     // block_y
       .AddInputType<int>()     // block_z
+      .AddInputType<int>()     // shared_mem_bytes
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cuda_cooperative_kernel;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cuda_cooperative_kernel, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // kernel_fn
+      .AddInputType<void *>()  // args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // grid_x
+      .AddInputType<int>()     // grid_y
+      .AddInputType<int>()     // grid_z
+      .AddInputType<int>()     // block_x
+      .AddInputType<int>()     // block_y
+      .AddInputType<int>()     // block_z
+      .AddInputType<int>()     // shared_mem_bytes
       .AddInputType<void *>()  // stream
       .End();
 
@@ -445,6 +510,7 @@ CINN_REGISTER_HELPER(cinn_cuda_host_api) {
       .AddInputType<int>()     // opside
       .AddInputType<bool>()    // trans_a
       .AddInputType<bool>()    // trans_b
+      .AddInputType<bool>()    // trans_o
       .AddInputType<float>()   // alpha
       .AddInputType<float>()   // beta
       .AddInputType<int>()     // a1
@@ -458,6 +524,59 @@ CINN_REGISTER_HELPER(cinn_cuda_host_api) {
       .AddInputType<void *>()  // stream
       .End();
 
+  using cinn::runtime::cuda::cinn_call_cublaslt_matmul;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cublaslt_matmul, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<bool>()    // trans_a
+      .AddInputType<bool>()    // trans_b
+      .AddInputType<float>()   // alpha
+      .AddInputType<int>()     // m
+      .AddInputType<int>()     // n
+      .AddInputType<int>()     // k
+      .AddInputType<int>()     // epilogue
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cublaslt_fp8_matmul;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cublaslt_fp8_matmul, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<float>()   // alpha
+      .AddInputType<int>()     // m
+      .AddInputType<int>()     // n
+      .AddInputType<int>()     // k
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cusparse_spmm;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cusparse_spmm, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // m
+      .AddInputType<int>()     // n
+      .AddInputType<int>()     // k
+      .AddInputType<int>()     // nnz
+      .AddInputType<void *>()  // stream
+      .End();
+
+#ifdef CINN_WITH_CUSPARSELT
+  using cinn::runtime::cuda::cinn_call_cusparselt_matmul;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cusparselt_matmul, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<float>()   // alpha
+      .AddInputType<int>()     // m
+      .AddInputType<int>()     // n
+      .AddInputType<int>()     // k
+      .AddInputType<void *>()  // stream
+      .End();
+#endif
+
   using cinn::runtime::cuda::cinn_call_cuda_memset;
   REGISTER_EXTERN_FUNC_HELPER(cinn_call_cuda_memset, cinn::common::DefaultHostTarget())
       .SetRetType<void>()
@@ -534,6 +653,325 @@ CINN_REGISTER_HELPER(cinn_cuda_host_api) {
       .AddInputType<void *>()  // stream
       .End();
 
+  using cinn::runtime::cuda::cinn_call_flash_attention_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_flash_attention_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // batch_size
+      .AddInputType<int>()     // num_heads
+      .AddInputType<int>()     // seq_q
+      .AddInputType<int>()     // seq_k
+      .AddInputType<int>()     // head_dim
+      .AddInputType<int>()     // value_dim
+      .AddInputType<int>()     // mask_batch_stride
+      .AddInputType<int>()     // mask_head_stride
+      .AddInputType<int>()     // mask_row_stride
+      .AddInputType<float>()   // scale
+      .AddInputType<bool>()    // causal
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_sort_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_sort_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // is_ascend
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_argsort_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_argsort_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // is_ascend
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_top_k_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_top_k_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<int>()     // k
+      .AddInputType<bool>()    // largest
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cumsum_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cumsum_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // exclusive
+      .AddInputType<bool>()    // reverse
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cumprod_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cumprod_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // exclusive
+      .AddInputType<bool>()    // reverse
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_cummax_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_cummax_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // axis_size
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // exclusive
+      .AddInputType<bool>()    // reverse
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_lookup_table_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_lookup_table_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()   // v_args
+      .AddInputType<int>()      // num_args
+      .AddInputType<int>()      // num_ids
+      .AddInputType<int>()      // num_rows
+      .AddInputType<int>()      // dim
+      .AddInputType<int64_t>()  // padding_idx
+      .AddInputType<void *>()   // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_scatter_add_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_scatter_add_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // num_rows
+      .AddInputType<int>()     // num_index
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // deterministic
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_concat_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_concat_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // inner
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_split_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_split_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // inner
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_layer_norm_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_layer_norm_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<float>()   // epsilon
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_layer_norm_grad_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_layer_norm_grad_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<float>()   // epsilon
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_rms_norm_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_rms_norm_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<float>()   // epsilon
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_rms_norm_grad_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_rms_norm_grad_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_batch_norm_train_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_batch_norm_train_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // channels
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // inner
+      .AddInputType<float>()   // epsilon
+      .AddInputType<float>()   // momentum
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_batch_norm_grad_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_batch_norm_grad_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // channels
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // inner
+      .AddInputType<float>()   // epsilon
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_arg_reduce_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_arg_reduce_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // outer
+      .AddInputType<int>()     // reduce
+      .AddInputType<int>()     // inner
+      .AddInputType<bool>()    // is_max
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_kv_cache_append_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_kv_cache_append_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // batch_size
+      .AddInputType<int>()     // num_kv_heads
+      .AddInputType<int>()     // head_dim
+      .AddInputType<int>()     // block_size
+      .AddInputType<int>()     // max_blocks_per_seq
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_paged_attention_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_paged_attention_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // batch_size
+      .AddInputType<int>()     // num_heads
+      .AddInputType<int>()     // num_kv_heads
+      .AddInputType<int>()     // head_dim
+      .AddInputType<int>()     // block_size
+      .AddInputType<int>()     // max_blocks_per_seq
+      .AddInputType<float>()   // scale
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_fused_softmax_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_fused_softmax_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<float>()   // scale
+      .AddInputType<bool>()    // log_softmax
+      .AddInputType<int>()     // mask_dim1
+      .AddInputType<int>()     // mask_dim2
+      .AddInputType<int>()     // mask_stride0
+      .AddInputType<int>()     // mask_stride1
+      .AddInputType<int>()     // mask_stride2
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_softmax_cross_entropy_nvgpu;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_softmax_cross_entropy_nvgpu, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // rows
+      .AddInputType<int>()     // cols
+      .AddInputType<int>()     // ignore_index
+      .AddInputType<void *>()  // stream
+      .End();
+
+#ifdef CINN_WITH_NCCL
+  using cinn::runtime::cuda::cinn_call_nccl_all_reduce;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_nccl_all_reduce, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // count
+      .AddInputType<int>()     // type_code
+      .AddInputType<int>()     // type_bits
+      .AddInputType<int>()     // reduce_type
+      .AddInputType<int>()     // ring_id
+      .AddInputType<bool>()    // use_calc_stream
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_nccl_all_gather;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_nccl_all_gather, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // count
+      .AddInputType<int>()     // type_code
+      .AddInputType<int>()     // type_bits
+      .AddInputType<int>()     // ring_id
+      .AddInputType<bool>()    // use_calc_stream
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::cuda::cinn_call_nccl_reduce_scatter;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_nccl_reduce_scatter, cinn::common::DefaultNVGPUTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // count
+      .AddInputType<int>()     // type_code
+      .AddInputType<int>()     // type_bits
+      .AddInputType<int>()     // reduce_type
+      .AddInputType<int>()     // ring_id
+      .AddInputType<bool>()    // use_calc_stream
+      .AddInputType<void *>()  // stream
+      .End();
+#endif
+
   // TODO(thisjiang): change msg type from 'int' to 'std::string' when custom call support 'std::string' type
   using cinn::runtime::cuda::cinn_assert_true_nvgpu;
   REGISTER_EXTERN_FUNC_HELPER(cinn_assert_true_nvgpu, cinn::common::DefaultNVGPUTarget())
@@ -731,3 +1169,4 @@ CINN_REGISTER_HELPER(cinn_cuda_host_api) {
 
   return true;
 }
+#endif  // CINN_WITH_CUDA
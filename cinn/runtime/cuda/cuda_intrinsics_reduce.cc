@@ -18,8 +18,10 @@
 #include "cinn/common/bfloat16.h"
 #include "cinn/common/cas.h"
 #include "cinn/common/float16.h"
-#include "cinn/runtime/cuda/cuda_util.h"
 #include "cinn/runtime/custom_function.h"
+#ifdef CINN_WITH_CUDA
+#include "cinn/runtime/cuda/cuda_util.h"
+#endif
 
 using cinn::common::bfloat16;
 using cinn::common::float16;
@@ -93,6 +95,23 @@ CINN_REGISTER_HELPER(cuda_intrinsics_reduce) {
       .AddInputType<int>()
       .End();
 
+#define REGISTER_WARP_ALLREDUCE_FUNC_IMPL(REDUCE_TYPE, DTYPE)                   \
+  REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_warp_allreduce_##REDUCE_TYPE, target) \
+      .SetRetType<DTYPE>()                                                      \
+      .AddInputType<DTYPE>()                                                    \
+      .AddInputType<int>()                                                      \
+      .End();
+
+  EXPAND_REDUCE_INT32_REGISTER_MARCO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_INT64_REGISTER_MARCO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_BF16_REGISTER_MACRO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP16_REGISTER_MACRO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP32_REGISTER_MACRO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP64_REGISTER_MACRO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_BOOL_REGISTER_MACRO(REGISTER_WARP_ALLREDUCE_FUNC_IMPL)
+
+#undef REGISTER_WARP_ALLREDUCE_FUNC_IMPL
+
 #define REGISTER_BLOCK_REDUCE_INTERNAL_FUNC_IMPL(REDUCE_TYPE, DTYPE)                     \
   REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_block_reduce_##REDUCE_TYPE##_internal, target) \
       .SetRetType<DTYPE>()                                                               \
@@ -127,6 +146,40 @@ CINN_REGISTER_HELPER(cuda_intrinsics_reduce) {
 
 #undef REGISTER_BLOCK_REDUCE_FUNC_IMPL
 
+#define REGISTER_GRID_REDUCE_FUNC_IMPL(REDUCE_TYPE, DTYPE)                   \
+  REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_grid_reduce_##REDUCE_TYPE, target) \
+      .SetRetType<DTYPE>()                                                   \
+      .AddInputType<cinn_buffer_t *>()                                       \
+      .AddInputType<int>()                                                   \
+      .AddInputType<int>()                                                   \
+      .End();
+
+  EXPAND_REDUCE_INT32_REGISTER_MARCO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_INT64_REGISTER_MARCO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_BF16_REGISTER_MACRO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP16_REGISTER_MACRO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP32_REGISTER_MACRO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_FP64_REGISTER_MACRO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+  EXPAND_REDUCE_BOOL_REGISTER_MACRO(REGISTER_GRID_REDUCE_FUNC_IMPL)
+
+#undef REGISTER_GRID_REDUCE_FUNC_IMPL
+
+#define REGISTER_BLOCK_SCAN_FUNC_IMPL(REDUCE_TYPE, DTYPE)                   \
+  REGISTER_FACKED_EXTERN_FUNC_HELPER(cinn_block_scan_##REDUCE_TYPE, target) \
+      .SetRetType<DTYPE>()                                                  \
+      .AddInputType<DTYPE>()                                                \
+      .AddInputType<bool>()                                                 \
+      .End();
+
+  EXPAND_REDUCE_INT32_REGISTER_MARCO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+  EXPAND_REDUCE_INT64_REGISTER_MARCO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+  EXPAND_REDUCE_BF16_REGISTER_MACRO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+  EXPAND_REDUCE_FP16_REGISTER_MACRO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+  EXPAND_REDUCE_FP32_REGISTER_MACRO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+  EXPAND_REDUCE_FP64_REGISTER_MACRO(REGISTER_BLOCK_SCAN_FUNC_IMPL)
+
+#undef REGISTER_BLOCK_SCAN_FUNC_IMPL
+
 #define REGISTER_BLOCK_SHUFLLE_FUNC_IMPL(REDUCE_TYPE, DTYPE)              \
   REGISTER_FACKED_EXTERN_FUNC_HELPER(block_shuffle_##REDUCE_TYPE, target) \
       .SetRetType<DTYPE>()                                                \
@@ -19,19 +19,74 @@
 #include <glog/logging.h>
 #include <glog/raw_logging.h>
 
-#include <mutex>  // NOLINT
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>         // NOLINT
+#include <shared_mutex>  // NOLINT
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/backends/cuda_util.h"
 #include "cinn/runtime/cuda/cuda_util.h"
-#include "cinn/runtime/flags.h"
 #include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace runtime {
 namespace cuda {
 
+namespace {
+struct FunctionInfo {
+  CUDAModule* module;
+  std::string name;
+  int device_id;
+  // the functions of the same kernel on the other devices
+  std::array<CUfunction, kCUDAMaxCards> per_card{};
+};
+
+// the functions got from the living modules, to remap the kernels compiled on one device to the others
+struct FunctionRegistry {
+  std::shared_mutex mutex;
+  std::unordered_map<CUfunction, FunctionInfo> functions;
+};
+
+FunctionRegistry& GetFunctionRegistry() {
+  static FunctionRegistry registry;
+  return registry;
+}
+
+std::atomic<bool> cross_device_launch_enabled{false};
+
+// the modules shared in the process, keyed by the hash of their data
+struct ModuleCache {
+  std::mutex mutex;
+  std::unordered_multimap<size_t, std::weak_ptr<CUDAModule>> modules;
+};
+
+ModuleCache& GetModuleCache() {
+  static ModuleCache cache;
+  return cache;
+}
+
+// Raise the limit of the dynamic shared memory of the kernel from the default 48 KB to the max shared memory per block
+// the device opts in, which is up to 227 KB on sm90, so that the kernels of the large shared memory tiles can launch.
+void SetMaxDynamicSharedMemory(CUfunction func, int device_id) {
+  CUdevice device;
+  CUDA_DRIVER_CALL(cuDeviceGet(&device, device_id));
+  int max_optin_bytes = 0;
+  CUDA_DRIVER_CALL(
+      cuDeviceGetAttribute(&max_optin_bytes, CU_DEVICE_ATTRIBUTE_MAX_SHARED_MEMORY_PER_BLOCK_OPTIN, device));
+  int static_bytes = 0;
+  CUDA_DRIVER_CALL(cuFuncGetAttribute(&static_bytes, CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, func));
+  if (max_optin_bytes > static_bytes) {
+    CUDA_DRIVER_CALL(
+        cuFuncSetAttribute(func, CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES, max_optin_bytes - static_bytes));
+  }
+}
+}  // namespace
+
 CUDAModule::CUDAModule(const std::string& data, Kind kind) : data_(data), kind_(kind) {
   CHECK(!data.empty());
 
@@ -47,6 +102,28 @@ CUDAModule::CUDAModule(const std::string& data, Kind kind) : data_(data), kind_(
   cuDevicePrimaryCtxRetain(&context_, device_);
 }
 
+std::shared_ptr<CUDAModule> CUDAModule::GetShared(const std::string& data, Kind kind) {
+  size_t hash = std::hash<std::string>()(data);
+  auto& cache = GetModuleCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto range = cache.modules.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto module = it->second.lock();
+    if (!module) {
+      it = cache.modules.erase(it);
+      continue;
+    }
+    if (module->kind_ == kind && module->data_ == data) {
+      VLOG(3) << "Share the CUDA module of " << data.size() << " bytes loaded before";
+      return module;
+    }
+    ++it;
+  }
+  auto module = std::make_shared<CUDAModule>(data, kind);
+  cache.modules.emplace(hash, module);
+  return module;
+}
+
 void CUDAModule::LaunchKernel(int device_id,
                               const std::string& func_name,
                               dim3 gridDim,
@@ -107,27 +184,83 @@ CUfunction CUDAModule::GetFunction(int device_id, const std::string& func_name)
     jit_options[4]  = CU_JIT_GENERATE_LINE_INFO;
     jit_opt_vals[4] = reinterpret_cast<void*>(value);
 
-    if (runtime::CanUseNvccCompiler()) {
-      CUDA_DRIVER_CALL(cuModuleLoad(&module_per_card_[device_id], data_.c_str()));
-    } else {
-      CUDA_DRIVER_CALL(cuModuleLoadDataEx(
-          &module_per_card_[device_id], data_.c_str(), jit_num_options, jit_options.data(), jit_opt_vals.data()));
-    }
+    CUDA_DRIVER_CALL(cuModuleLoadDataEx(
+        &module_per_card_[device_id], data_.c_str(), jit_num_options, jit_options.data(), jit_opt_vals.data()));
   }
 
   CUfunction func;
   CUDA_DRIVER_CALL(cuModuleGetFunction(&func, module_per_card_[device_id], func_name.c_str()));
+  auto& registry = GetFunctionRegistry();
+  {
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    if (registry.functions.count(func)) return func;
+  }
+  SetMaxDynamicSharedMemory(func, device_id);
+  std::unique_lock<std::shared_mutex> lock(registry.mutex);
+  registry.functions.emplace(func, FunctionInfo{this, func_name, device_id});
   return func;
 }
 
+CUfunction CUDAModule::GetFunctionOnCurrentDevice(CUfunction function) {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  auto& registry = GetFunctionRegistry();
+  CUDAModule* module;
+  std::string name;
+  {
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    auto it = registry.functions.find(function);
+    if (it == registry.functions.end() || it->second.device_id == device_id) return function;
+    if (it->second.per_card[device_id]) return it->second.per_card[device_id];
+    module = it->second.module;
+    name   = it->second.name;
+  }
+
+  // load the same cubin on the current device, which is done once for all the kernels of the module
+  CUfunction remapped = module->GetFunction(device_id, name);
+  std::unique_lock<std::shared_mutex> lock(registry.mutex);
+  auto it = registry.functions.find(function);
+  if (it != registry.functions.end()) {
+    it->second.per_card[device_id] = remapped;
+  }
+  return remapped;
+}
+
+CUDAModule::KernelResource CUDAModule::GetKernelResource(CUfunction function) {
+  KernelResource resource;
+  CUDA_DRIVER_CALL(cuFuncGetAttribute(&resource.num_regs, CU_FUNC_ATTRIBUTE_NUM_REGS, function));
+  CUDA_DRIVER_CALL(cuFuncGetAttribute(&resource.local_bytes, CU_FUNC_ATTRIBUTE_LOCAL_SIZE_BYTES, function));
+  CUDA_DRIVER_CALL(cuFuncGetAttribute(&resource.static_shared_bytes, CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, function));
+  CUDA_DRIVER_CALL(
+      cuFuncGetAttribute(&resource.max_threads_per_block, CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, function));
+  return resource;
+}
+
+double CUDAModule::GetOccupancy(CUfunction function, int block_threads, int dynamic_shared_bytes) {
+  if (block_threads <= 0 || block_threads > GetKernelResource(function).max_threads_per_block) {
+    return 0.0;
+  }
+  int num_blocks = 0;
+  CUDA_DRIVER_CALL(
+      cuOccupancyMaxActiveBlocksPerMultiprocessor(&num_blocks, function, block_threads, dynamic_shared_bytes));
+  CUdevice device;
+  CUDA_DRIVER_CALL(cuCtxGetDevice(&device));
+  int max_threads_per_sm = 0;
+  CUDA_DRIVER_CALL(
+      cuDeviceGetAttribute(&max_threads_per_sm, CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_MULTIPROCESSOR, device));
+  constexpr int kWarpSize = 32;
+  int block_warps         = (block_threads + kWarpSize - 1) / kWarpSize;
+  return static_cast<double>(num_blocks * block_warps) / (max_threads_per_sm / kWarpSize);
+}
+
+void CUDAModule::EnableCrossDeviceLaunch() { cross_device_launch_enabled = true; }
+
+bool CUDAModule::CrossDeviceLaunchEnabled() { return cross_device_launch_enabled.load(std::memory_order_relaxed); }
+
 CUdeviceptr CUDAModule::GetGlobal(int device_id, const std::string& name, size_t nbytes) {
   if (!module_per_card_[device_id]) {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (runtime::CanUseNvccCompiler()) {
-      CUDA_DRIVER_CALL(cuModuleLoad(&module_per_card_[device_id], data_.c_str()));
-    } else {
-      CUDA_DRIVER_CALL(cuModuleLoadData(&module_per_card_[device_id], data_.c_str()));
-    }
+    CUDA_DRIVER_CALL(cuModuleLoadData(&module_per_card_[device_id], data_.c_str()));
   }
 
   size_t _nbytes;
@@ -137,6 +270,13 @@ CUdeviceptr CUDAModule::GetGlobal(int device_id, const std::string& name, size_t
 }
 
 CUDAModule::~CUDAModule() {
+  {
+    auto& registry = GetFunctionRegistry();
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    for (auto it = registry.functions.begin(); it != registry.functions.end();) {
+      it = it->second.module == this ? registry.functions.erase(it) : std::next(it);
+    }
+  }
   for (int i = 0; i < module_per_card_.size(); i++) {
     auto* module = module_per_card_[i];
     if (module) {
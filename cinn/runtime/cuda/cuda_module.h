@@ -18,6 +18,7 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <vector>
@@ -42,6 +43,12 @@ class CUDAModule {
 
   CUDAModule(const std::string& data, Kind kind);
 
+  /**
+   * Get the module of \p data shared in the process, the identical cubins or ptx compiled by the programs of the same
+   * kernels, such as the shape buckets and the replicas, are loaded once. The module is unloaded with the last owner.
+   */
+  static std::shared_ptr<CUDAModule> GetShared(const std::string& data, Kind kind);
+
   void LaunchKernel(int device_id,
                     const std::string& func_name,
                     dim3 gridDim,
@@ -56,6 +63,35 @@ class CUDAModule {
   //! Get a global variable.
   CUdeviceptr GetGlobal(int device_id, const std::string& name, size_t nbytes);
 
+  /**
+   * Get the function on the current device of the same kernel as \p function, which is got by GetFunction on another
+   * device, the module is loaded on the current device lazily. It lets a compiled program, whose kernels are bound on
+   * the device compiling it, run on the other devices. Return \p function itself if it is not got from a CUDAModule.
+   */
+  static CUfunction GetFunctionOnCurrentDevice(CUfunction function);
+
+  //! The resource usage of a kernel reported by the driver after loading.
+  struct KernelResource {
+    int num_regs{0};
+    //! the local memory of each thread, which holds the spilled registers and the local arrays not in registers
+    int local_bytes{0};
+    int static_shared_bytes{0};
+    int max_threads_per_block{0};
+  };
+  static KernelResource GetKernelResource(CUfunction function);
+
+  /**
+   * Get the ratio of the active warps on a multiprocessor of the current device to its max, when \p function launches
+   * with \p block_threads threads and \p dynamic_shared_bytes of dynamic shared memory per block. Return 0 if the
+   * block can't launch at all, such as it takes more registers or shared memory than a multiprocessor has.
+   */
+  static double GetOccupancy(CUfunction function, int block_threads, int dynamic_shared_bytes);
+
+  //! Let cinn_call_cuda_kernel launch the kernels on the current device, which is enabled by the first replica of a
+  //! program on another device, so that the single-device programs pay nothing for the remapping.
+  static void EnableCrossDeviceLaunch();
+  static bool CrossDeviceLaunchEnabled();
+
   ~CUDAModule();
 
  private:
@@ -50,6 +50,37 @@ void saxpy(float a, float *x, float *y, float *out, size_t n)
   ASSERT_TRUE(func);
 }
 
+TEST(CUDAModule, shared) {
+  backends::nvrtc::Compiler compiler;
+
+  std::string source_code = R"ROC(
+extern "C" __global__
+void scale(float a, float *x, size_t n)
+{
+  size_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid < n) {
+    x[tid] *= a;
+  }
+}
+)ROC";
+
+  auto ptx = compiler(source_code);
+  CHECK(!ptx.empty());
+  auto kind = compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX;
+
+  // the identical code is loaded once, and so are its functions
+  auto module_a = CUDAModule::GetShared(ptx, kind);
+  auto module_b = CUDAModule::GetShared(ptx, kind);
+  ASSERT_EQ(module_a, module_b);
+  EXPECT_EQ(module_a->GetFunction(0, "scale"), module_b->GetFunction(0, "scale"));
+
+  // the module is loaded again after all the owners release it
+  module_a.reset();
+  module_b.reset();
+  auto module_c = CUDAModule::GetShared(ptx, kind);
+  ASSERT_TRUE(module_c->GetFunction(0, "scale"));
+}
+
 TEST(CUDAModule, float16) {
   using common::float16;
   using namespace runtime::cuda::util;
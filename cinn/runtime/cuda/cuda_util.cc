@@ -15,54 +15,81 @@
 #include "cinn/runtime/cuda/cuda_util.h"
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/types/optional.h>
+#include <cublasLt.h>
 #include <cublas_v2.h>
 #include <cuda_runtime.h>
 #include <curand.h>
 #include <cusolverDn.h>
 #include <glog/logging.h>
-#include <thrust/device_vector.h>
-#include <thrust/host_vector.h>
 
 #include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #ifdef CINN_WITH_CUDNN
 #include <cudnn.h>
 #endif
+#ifdef CINN_WITH_CUSPARSELT
+#include <cusparseLt.h>
+#endif
 
 #include "cinn/backends/cuda_util.h"
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/common/target.h"
+#include "cinn/hlir/framework/memory.h"
 #include "cinn/runtime/cuda/cublas_util.h"
+#include "cinn/runtime/cuda/cuda_module.h"
 #include "cinn/runtime/custom_function.h"
 #include "cinn/runtime/flags.h"
 #include "cinn/utils/profiler.h"
 #include "cinn/utils/timer.h"
 
+DECLARE_bool(cinn_cudnn_exhaustive_search);
+DECLARE_string(cinn_cudnn_algo_cache_path);
+DECLARE_int64(cinn_cudnn_workspace_limit_bytes);
+
 namespace cinn {
 namespace runtime {
 namespace cuda {
 
+// The library handles are created per (device, stream) and bound to the stream once at creation, so the library calls
+// issued on different streams, even from different threads, never rebind or share a handle and its workspace.
+template <typename HandleT>
+HandleT &GetStreamHandle(void *stream) {
+  static std::mutex mtx;
+  static absl::flat_hash_map<std::pair<int, void *>, std::unique_ptr<HandleT>> handles;
+  int device_id = 0;
+  CUDA_CALL(cudaGetDevice(&device_id));
+
+  std::lock_guard<std::mutex> lock(mtx);
+  auto &handle = handles[std::make_pair(device_id, stream)];
+  if (!handle) {
+    VLOG(4) << "Create the library handle for device " << device_id << " and stream " << stream;
+    handle.reset(new HandleT(device_id, static_cast<cudaStream_t>(stream)));
+  }
+  return *handle;
+}
+
 class CublasHandle {
  public:
   CublasHandle(const CublasHandle &) = delete;
   CublasHandle &operator=(const CublasHandle &) = delete;
-  ~CublasHandle() {
-    CUBLAS_CALL(cublasDestroy(cuhandle));
-    CUDA_CALL(cudaStreamDestroy(custream));
-  }
-  static CublasHandle &GetInstance() {
-    static CublasHandle instance;
-    return instance;
-  }
+  ~CublasHandle() { CUBLAS_CALL(cublasDestroy(cuhandle)); }
+  static CublasHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CublasHandle>(stream); }
   cudaStream_t GetCuStream() { return custream; }
   cublasHandle_t &GetCublasHandle() { return cuhandle; }
 
  private:
-  CublasHandle() {
-    CUDA_CALL(cudaStreamCreate(&custream));
+  friend CublasHandle &GetStreamHandle<CublasHandle>(void *stream);
+  CublasHandle(int device_id, cudaStream_t stream) : custream(stream) {
     CUBLAS_CALL(cublasCreate(&cuhandle));
+    CUBLAS_CALL(cublasSetStream(cuhandle, custream));
     cudaMemPool_t mem_pool;
-    CUDA_CALL(cudaDeviceGetMemPool(&mem_pool, 0));
+    CUDA_CALL(cudaDeviceGetMemPool(&mem_pool, device_id));
 
     uint64_t threshold = UINT32_MAX;
     CUDA_CALL(cudaMemPoolSetAttribute(mem_pool, cudaMemPoolAttrReleaseThreshold, &threshold));
@@ -75,48 +102,146 @@ class CublasHandle {
   cublasHandle_t cuhandle;
 };
 
-void cinn_call_cuda_kernel(void *kernel_fn,
-                           void *v_args,
-                           int num_args,
-                           int grid_x,
-                           int grid_y,
-                           int grid_z,
-                           int block_x,
-                           int block_y,
-                           int block_z,
-                           void *stream) {
-  VLOG(3) << "cinn_call_cuda_kernel, grid_dim={" << grid_x << ", " << grid_y << ", " << grid_z << "}, block_dim={"
-          << block_x << ", " << block_y << ", " << block_z << "}, num_args=" << num_args << ", stream=" << stream;
-
-  std::vector<void *> kernel_args;
-  {
-    cinn::utils::RecordEvent record_run("prepare_args", cinn::utils::EventType::kInstruction);
-    kernel_args.reserve(num_args);
-    cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
-    for (int idx = 0; idx < num_args; ++idx) {
-      if (args[idx].type_code() == ::cinn_type_code<cinn_buffer_t *>()) {
-        kernel_args.emplace_back(&((cinn_buffer_t *)(args[idx]))->memory);
-      } else {
-        kernel_args.emplace_back(args[idx].data_addr());
-      }
+namespace {
+// the numerator and the denominator of the scale of the grid along x, see SetLaunchGridScale
+thread_local int launch_grid_scale_num = 0;
+thread_local int launch_grid_scale_den = 0;
+
+// the prebuilt argument pointers of the kernel launched next, see SetKernelLaunchArgs
+thread_local KernelLaunchArgs *current_launch_args = nullptr;
+
+// the argument pointers of the kernels without the prebuilt ones are built on the stack up to this number
+constexpr int kMaxStackLaunchArgs = 64;
+
+void FillKernelLaunchArgs(void *v_args, int num_args, void **kernel_args) {
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  for (int idx = 0; idx < num_args; ++idx) {
+    if (args[idx].type_code() == ::cinn_type_code<cinn_buffer_t *>()) {
+      kernel_args[idx] = &((cinn_buffer_t *)(args[idx]))->memory;
+    } else {
+      kernel_args[idx] = args[idx].data_addr();
     }
   }
+}
+}  // namespace
+
+void BuildKernelLaunchArgs(void *v_args, int num_args, KernelLaunchArgs *launch_args) {
+  launch_args->v_args = v_args;
+  launch_args->ptrs.resize(num_args);
+  FillKernelLaunchArgs(v_args, num_args, launch_args->ptrs.data());
+}
 
-  {
-    cinn::utils::RecordEvent record_run("cuLaunchKernel", cinn::utils::EventType::kInstruction);
-    CUDA_DRIVER_CALL(cuLaunchKernel(static_cast<CUfunction>(kernel_fn),
+void SetKernelLaunchArgs(KernelLaunchArgs *launch_args) { current_launch_args = launch_args; }
+
+void SetLaunchGridScale(int num, int den) {
+  CHECK(den == 0 || (num > 0 && num <= den)) << "Invalid scale of the launch grid: " << num << "/" << den;
+  launch_grid_scale_num = num;
+  launch_grid_scale_den = den;
+}
+
+namespace {
+void LaunchCudaKernel(bool cooperative,
+                      void *kernel_fn,
+                      void *v_args,
+                      int num_args,
+                      int grid_x,
+                      int grid_y,
+                      int grid_z,
+                      int block_x,
+                      int block_y,
+                      int block_z,
+                      int shared_mem_bytes,
+                      void *stream) {
+  // the blocks of a cooperative kernel are all needed to pass its grid-wide barriers, so its grid is never scaled
+  if (!cooperative && launch_grid_scale_den > 0 && grid_y == 1 && grid_z == 1) {
+    grid_x = (static_cast<int64_t>(grid_x) * launch_grid_scale_num + launch_grid_scale_den - 1) / launch_grid_scale_den;
+  }
+  VLOG(3) << (cooperative ? "cinn_call_cuda_cooperative_kernel" : "cinn_call_cuda_kernel") << ", grid_dim={" << grid_x
+          << ", " << grid_y << ", " << grid_z << "}, block_dim={" << block_x << ", " << block_y << ", " << block_z
+          << "}, shared_mem_bytes=" << shared_mem_bytes << ", num_args=" << num_args << ", stream=" << stream;
+
+  // the launch allocates nothing: the argument pointers are prebuilt by the instruction, or built on the stack
+  void **kernel_args = nullptr;
+  void *stack_args[kMaxStackLaunchArgs];
+  std::vector<void *> heap_args;
+  if (current_launch_args != nullptr && current_launch_args->v_args == v_args &&
+      current_launch_args->ptrs.size() == num_args) {
+    kernel_args = current_launch_args->ptrs.data();
+  } else if (num_args <= kMaxStackLaunchArgs) {
+    FillKernelLaunchArgs(v_args, num_args, stack_args);
+    kernel_args = stack_args;
+  } else {
+    heap_args.resize(num_args);
+    FillKernelLaunchArgs(v_args, num_args, heap_args.data());
+    kernel_args = heap_args.data();
+  }
+
+  auto function = static_cast<CUfunction>(kernel_fn);
+  if (CUDAModule::CrossDeviceLaunchEnabled()) {
+    // the kernel may be bound on the device compiling the program, which runs on another device as a replica
+    function = CUDAModule::GetFunctionOnCurrentDevice(function);
+  }
+  absl::optional<cinn::utils::RecordEvent> record_launch;
+  if (cinn::utils::RecordEvent::IsEnabled()) {
+    record_launch.emplace(cooperative ? "cuLaunchCooperativeKernel" : "cuLaunchKernel",
+                          cinn::utils::EventType::kInstruction);
+  }
+  if (cooperative) {
+    CUDA_DRIVER_CALL(cuLaunchCooperativeKernel(function,
+                                               grid_x,
+                                               grid_y,
+                                               grid_z,
+                                               block_x,
+                                               block_y,
+                                               block_z,
+                                               shared_mem_bytes,
+                                               static_cast<CUstream>(stream),
+                                               kernel_args))
+  } else {
+    CUDA_DRIVER_CALL(cuLaunchKernel(function,
                                     grid_x,
                                     grid_y,
                                     grid_z,
                                     block_x,
                                     block_y,
                                     block_z,
-                                    0,  // share memory
+                                    shared_mem_bytes,
                                     static_cast<CUstream>(stream),
-                                    kernel_args.data(),
+                                    kernel_args,
                                     nullptr))
   }
 }
+}  // namespace
+
+void cinn_call_cuda_kernel(void *kernel_fn,
+                           void *v_args,
+                           int num_args,
+                           int grid_x,
+                           int grid_y,
+                           int grid_z,
+                           int block_x,
+                           int block_y,
+                           int block_z,
+                           int shared_mem_bytes,
+                           void *stream) {
+  LaunchCudaKernel(
+      false, kernel_fn, v_args, num_args, grid_x, grid_y, grid_z, block_x, block_y, block_z, shared_mem_bytes, stream);
+}
+
+void cinn_call_cuda_cooperative_kernel(void *kernel_fn,
+                                       void *v_args,
+                                       int num_args,
+                                       int grid_x,
+                                       int grid_y,
+                                       int grid_z,
+                                       int block_x,
+                                       int block_y,
+                                       int block_z,
+                                       int shared_mem_bytes,
+                                       void *stream) {
+  LaunchCudaKernel(
+      true, kernel_fn, v_args, num_args, grid_x, grid_y, grid_z, block_x, block_y, block_z, shared_mem_bytes, stream);
+}
 
 void cinn_call_cublas(void *v_args,
                       int num_args,
@@ -136,10 +261,9 @@ void cinn_call_cublas(void *v_args,
                       void *stream) {
   cinn::utils::RecordEvent record_run("cinn_call_cublas", cinn::utils::EventType::kInstruction);
   CHECK_EQ(num_args, 3);
-  cublasHandle_t &cuhandle = CublasHandle::GetInstance().GetCublasHandle();
+  cublasHandle_t &cuhandle = CublasHandle::GetInstance(stream).GetCublasHandle();
   cinn_pod_value_t *args   = static_cast<cinn_pod_value_t *>(v_args);
   cudaStream_t custream    = static_cast<cudaStream_t>(stream);
-  CUBLAS_CALL(cublasSetStream(cuhandle, custream));
   VLOG(3) << "a1 ~ a4: " << a1 << " " << a2 << " " << a3 << " " << a4;
   VLOG(3) << "b1 ~ b4: " << b1 << " " << b2 << " " << b3 << " " << b4;
   VLOG(3) << "trans_a: " << trans_a << ", trans_b: " << trans_b << ", trans_o: " << trans_o;
@@ -167,6 +291,7 @@ void cinn_call_cublas(void *v_args,
   auto type_code   = args[0].operator cinn_buffer_t *()->type.code;
   bool is_float    = type_code == cinn_type_float;
   bool is_bfloat16 = type_code == cinn_type_bfloat;
+  bool is_int      = type_code == cinn_type_int;
   int bytes        = args[0].operator cinn_buffer_t *()->type.bits / CHAR_BIT;
   if (is_float && bytes == sizeof(common::float16)) {
     cuda_dtype = CUDA_R_16F;
@@ -176,6 +301,10 @@ void cinn_call_cublas(void *v_args,
     cuda_dtype = CUDA_R_64F;
   } else if (is_bfloat16) {
     cuda_dtype = CUDA_R_16BF;
+  } else if (is_int && bytes == sizeof(int8_t)) {
+    // the int8 matmul outputs the int32 accumulation, whose element size differs from the inputs
+    CHECK(a1 * b1 == 1 && (a2 == b2 || a2 == 1 || b2 == 1)) << "The int8 cublas matmul doesn't support this batch!";
+    cuda_dtype = CUDA_R_8I;
   } else {
     LOG(FATAL) << "unsupported cublas data type: " << static_cast<int>(type_code) << ", bytes = " << bytes;
   }
@@ -269,7 +398,7 @@ void cinn_call_cublas(void *v_args,
       // (N, 1) * (1, L) , (1, L) * (N, 1)
 
       void **ptr_arr        = nullptr;
-      cudaStream_t g_stream = CublasHandle::GetInstance().GetCuStream();
+      cudaStream_t g_stream = CublasHandle::GetInstance(stream).GetCuStream();
       CUDA_CALL(cudaMallocAsync(&ptr_arr, sizeof(void *) * 3 * std::max(l1, r1) * std::max(l2, r2), g_stream));
 
       std::vector<void *> ptr(3 * std::max(l1, r1) * std::max(l2, r2));
@@ -326,12 +455,16 @@ void cinn_call_batched_cublas(void *v_args,
                               int b3,
                               int b4,
                               void *stream) {
-  // A * [B, C, D, ...] or [B, C, D, ...] * A
-  CHECK_EQ((num_args - 1) % 2, 0);
-  cublasHandle_t &cuhandle = CublasHandle::GetInstance().GetCublasHandle();
+  // A * [B, C, D, ...] or [B, C, D, ...] * A, or [A0, A1, ...] * [B0, B1, ...] if opside is 2
+  bool grouped = opside == 2;
+  if (grouped) {
+    CHECK_EQ(num_args % 3, 0);
+  } else {
+    CHECK_EQ((num_args - 1) % 2, 0);
+  }
+  cublasHandle_t &cuhandle = CublasHandle::GetInstance(stream).GetCublasHandle();
   cinn_pod_value_t *args   = static_cast<cinn_pod_value_t *>(v_args);
   cudaStream_t custream    = static_cast<cudaStream_t>(stream);
-  CUBLAS_CALL(cublasSetStream(cuhandle, custream));
 
   cudaDataType_t cuda_dtype;
   auto type_code   = args[0].operator cinn_buffer_t *()->type.code;
@@ -379,23 +512,23 @@ void cinn_call_batched_cublas(void *v_args,
   int stride_l = l2 == 1 ? 0 : l3 * l4;
   int stride_r = r2 == 1 ? 0 : r3 * r4;
 
-  int num_gemm = ((num_args - 1) / 2);
+  int num_gemm = grouped ? (num_args / 3) : ((num_args - 1) / 2);
   std::vector<void *> ptr(3 * std::max(l1, r1) * std::max(l2, r2) * num_gemm);
   void **ptr_a = ptr.data();
   void **ptr_b = ptr.data() + std::max(l1, r1) * std::max(l2, r2) * num_gemm;
   void **ptr_c = ptr.data() + std::max(l1, r1) * std::max(l2, r2) * num_gemm * 2;
 
   void **ptr_arr        = nullptr;
-  cudaStream_t g_stream = CublasHandle::GetInstance().GetCuStream();
+  cudaStream_t g_stream = CublasHandle::GetInstance(stream).GetCuStream();
   CUDA_CALL(cudaMallocAsync(&ptr_arr, sizeof(void *) * ptr.size(), g_stream));
 
   for (int g = 0, index = 0; g < num_gemm; ++g) {
-    void *A = args[0].operator cinn_buffer_t *()->memory;
-    void *B = args[1 + g].operator cinn_buffer_t *()->memory;
-    void *C = args[1 + num_gemm + g].operator cinn_buffer_t *()->memory;
+    void *A = grouped ? args[g].operator cinn_buffer_t *()->memory : args[0].operator cinn_buffer_t *()->memory;
+    void *B = args[(grouped ? num_gemm : 1) + g].operator cinn_buffer_t *()->memory;
+    void *C = args[(grouped ? 2 * num_gemm : 1 + num_gemm) + g].operator cinn_buffer_t *()->memory;
 
     // if opside is 1, exhange A,B.
-    if (opside) {
+    if (opside == 1) {
       auto tmp = A;
       A        = B;
       B        = tmp;
@@ -436,6 +569,579 @@ void cinn_call_batched_cublas(void *v_args,
   CUDA_CALL(cudaFreeAsync(ptr_arr, custream));
 }
 
+class CublasLtHandle {
+ public:
+  CublasLtHandle(const CublasLtHandle &) = delete;
+  CublasLtHandle &operator=(const CublasLtHandle &) = delete;
+  ~CublasLtHandle() {
+    CUBLAS_CALL(cublasLtDestroy(cuhandle_));
+    if (workspace_) {
+      CUDA_CALL(cudaFree(workspace_));
+    }
+  }
+  static CublasLtHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CublasLtHandle>(stream); }
+  cublasLtHandle_t &GetCublasLtHandle() { return cuhandle_; }
+  // the heuristic only chooses the algorithms fitting in this workspace, so it has a fixed size
+  static constexpr size_t kWorkSpaceSize = 4 * 1024 * 1024;
+  void *GetWorkSpace() {
+    if (!workspace_) {
+      CUDA_CALL(cudaMalloc(&workspace_, kWorkSpaceSize));
+    }
+    return workspace_;
+  }
+  // the algorithm chosen by the heuristic of each gemm setting, the heuristic is only queried the first time and the
+  // result is shared by the handles of all the streams
+  static bool GetAlgo(const std::string &key, cublasLtMatmulHeuristicResult_t *algo) {
+    std::lock_guard<std::mutex> lock(AlgoMutex());
+    auto it = AlgoMap().find(key);
+    if (it == AlgoMap().end()) {
+      return false;
+    }
+    *algo = it->second;
+    return true;
+  }
+  static void InsertAlgo(const std::string &key, const cublasLtMatmulHeuristicResult_t &algo) {
+    std::lock_guard<std::mutex> lock(AlgoMutex());
+    AlgoMap()[key] = algo;
+  }
+
+ private:
+  friend CublasLtHandle &GetStreamHandle<CublasLtHandle>(void *stream);
+  CublasLtHandle(int device_id, cudaStream_t stream) { CUBLAS_CALL(cublasLtCreate(&cuhandle_)); }
+  static absl::flat_hash_map<std::string, cublasLtMatmulHeuristicResult_t> &AlgoMap() {
+    static absl::flat_hash_map<std::string, cublasLtMatmulHeuristicResult_t> algo_map;
+    return algo_map;
+  }
+  static std::mutex &AlgoMutex() {
+    static std::mutex mtx;
+    return mtx;
+  }
+  cublasLtHandle_t cuhandle_;
+  void *workspace_{nullptr};
+};
+
+void cinn_call_cublaslt_matmul(void *v_args,
+                               int num_args,
+                               bool trans_a,
+                               bool trans_b,
+                               float alpha,
+                               int m,
+                               int n,
+                               int k,
+                               int epilogue,
+                               void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_cublaslt_matmul", cinn::utils::EventType::kInstruction);
+  bool has_residual = epilogue == 3 || epilogue == 4;
+  CHECK_EQ(num_args, has_residual ? 5 : 4)
+      << "The cinn_call_cublaslt_matmul only accept inputs A, B, bias, an optional residual and a output";
+  VLOG(3) << "m: " << m << ", n: " << n << ", k: " << k << ", trans_a: " << trans_a << ", trans_b: " << trans_b
+          << ", epilogue: " << epilogue;
+
+  auto &lt_handle        = CublasLtHandle::GetInstance(stream);
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  cudaStream_t custream  = static_cast<cudaStream_t>(stream);
+
+  void *A    = args[0].operator cinn_buffer_t *()->memory;
+  void *B    = args[1].operator cinn_buffer_t *()->memory;
+  void *bias = args[2].operator cinn_buffer_t *()->memory;
+  void *C    = args[num_args - 1].operator cinn_buffer_t *()->memory;
+  // the residual is accumulated as the C matrix of cublasLt, and the result is written to D
+  void *R = has_residual ? args[3].operator cinn_buffer_t *()->memory : C;
+
+  cudaDataType_t cuda_dtype;
+  auto type_code   = args[0].operator cinn_buffer_t *()->type.code;
+  bool is_float    = type_code == cinn_type_float;
+  bool is_bfloat16 = type_code == cinn_type_bfloat;
+  int bytes        = args[0].operator cinn_buffer_t *()->type.bits / CHAR_BIT;
+  if (is_float && bytes == sizeof(common::float16)) {
+    cuda_dtype = CUDA_R_16F;
+  } else if (is_float && bytes == sizeof(float)) {
+    cuda_dtype = CUDA_R_32F;
+  } else if (is_bfloat16) {
+    cuda_dtype = CUDA_R_16BF;
+  } else {
+    LOG(FATAL) << "unsupported cublasLt data type: " << static_cast<int>(type_code) << ", bytes = " << bytes;
+  }
+
+  cublasLtEpilogue_t lt_epilogue;
+  if (epilogue == 0) {
+    lt_epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+  } else if (epilogue == 1 || epilogue == 3) {
+    lt_epilogue = CUBLASLT_EPILOGUE_BIAS;
+  } else if (epilogue == 2 || epilogue == 4) {
+    lt_epilogue = CUBLASLT_EPILOGUE_RELU_BIAS;
+  } else {
+    LOG(FATAL) << "unsupported cublasLt epilogue: " << epilogue;
+  }
+
+  // As cublasLt is column-major, compute C^T[n, m] = op(B)^T * op(A)^T instead, a row of C is a column of C^T, so the
+  // bias of shape [n] is broadcast along the columns as cublasLt requires.
+  cublasOperation_t trans_op_l = trans_b ? CUBLAS_OP_T : CUBLAS_OP_N;
+  cublasOperation_t trans_op_r = trans_a ? CUBLAS_OP_T : CUBLAS_OP_N;
+
+  cublasLtMatmulDesc_t op_desc;
+  CUBLAS_CALL(cublasLtMatmulDescCreate(&op_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  CUBLAS_CALL(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSA, &trans_op_l, sizeof(trans_op_l)));
+  CUBLAS_CALL(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSB, &trans_op_r, sizeof(trans_op_r)));
+  CUBLAS_CALL(
+      cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE, &lt_epilogue, sizeof(lt_epilogue)));
+  if (lt_epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
+    CUBLAS_CALL(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias, sizeof(bias)));
+  }
+
+  cublasLtMatrixLayout_t l_desc, r_desc, c_desc;
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&l_desc,
+                                         cuda_dtype,
+                                         trans_op_l == CUBLAS_OP_N ? n : k,
+                                         trans_op_l == CUBLAS_OP_N ? k : n,
+                                         trans_op_l == CUBLAS_OP_N ? n : k));
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&r_desc,
+                                         cuda_dtype,
+                                         trans_op_r == CUBLAS_OP_N ? k : m,
+                                         trans_op_r == CUBLAS_OP_N ? m : k,
+                                         trans_op_r == CUBLAS_OP_N ? k : m));
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&c_desc, cuda_dtype, n, m, n));
+
+  std::string hash_key = "dtype_" + std::to_string(static_cast<int>(cuda_dtype)) + "_m_" + std::to_string(m) +
+                         "_n_" + std::to_string(n) + "_k_" + std::to_string(k) + "_trans_a_" +
+                         std::to_string(trans_a) + "_trans_b_" + std::to_string(trans_b) + "_epilogue_" +
+                         std::to_string(epilogue);
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  if (!CublasLtHandle::GetAlgo(hash_key, &heuristic_result)) {
+    cublasLtMatmulPreference_t preference;
+    size_t workspace_size = CublasLtHandle::kWorkSpaceSize;
+    CUBLAS_CALL(cublasLtMatmulPreferenceCreate(&preference));
+    CUBLAS_CALL(cublasLtMatmulPreferenceSetAttribute(
+        preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size, sizeof(workspace_size)));
+
+    int returned_algo_count = 0;
+    CUBLAS_CALL(cublasLtMatmulAlgoGetHeuristic(lt_handle.GetCublasLtHandle(),
+                                               op_desc,
+                                               l_desc,
+                                               r_desc,
+                                               c_desc,
+                                               c_desc,
+                                               preference,
+                                               1,
+                                               &heuristic_result,
+                                               &returned_algo_count));
+    CUBLAS_CALL(cublasLtMatmulPreferenceDestroy(preference));
+    CHECK_GT(returned_algo_count, 0) << "cublasLt finds no algorithm for " << hash_key;
+    CublasLtHandle::InsertAlgo(hash_key, heuristic_result);
+  }
+
+  // the epilogue of cublasLt computes D = act(alpha * A * B + beta * C + bias)
+  float beta = has_residual ? 1.0f : 0.0f;
+  CUBLAS_CALL(cublasLtMatmul(lt_handle.GetCublasLtHandle(),
+                             op_desc,
+                             &alpha,
+                             B,
+                             l_desc,
+                             A,
+                             r_desc,
+                             &beta,
+                             R,
+                             c_desc,
+                             C,
+                             c_desc,
+                             &heuristic_result.algo,
+                             lt_handle.GetWorkSpace(),
+                             CublasLtHandle::kWorkSpaceSize,
+                             custream));
+
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(c_desc));
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(r_desc));
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(l_desc));
+  CUBLAS_CALL(cublasLtMatmulDescDestroy(op_desc));
+}
+
+void cinn_call_cublaslt_fp8_matmul(void *v_args, int num_args, float alpha, int m, int n, int k, void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_cublaslt_fp8_matmul", cinn::utils::EventType::kInstruction);
+  CHECK_EQ(num_args, 5) << "The cinn_call_cublaslt_fp8_matmul only accept inputs A, B, scale_a, scale_b and a output";
+  VLOG(3) << "fp8 matmul m: " << m << ", n: " << n << ", k: " << k << ", alpha: " << alpha;
+#if CUDA_VERSION >= 11080
+  // the fp8 tensor cores require the leading dimensions of both inputs aligned to 16 bytes
+  CHECK(k % 16 == 0 && n % 16 == 0) << "The K and N of the fp8 matmul should be multiples of 16, but here k = " << k
+                                    << ", n = " << n;
+  auto &lt_handle        = CublasLtHandle::GetInstance(stream);
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  cudaStream_t custream  = static_cast<cudaStream_t>(stream);
+
+  void *A       = args[0].operator cinn_buffer_t *()->memory;
+  void *B       = args[1].operator cinn_buffer_t *()->memory;
+  void *scale_a = args[2].operator cinn_buffer_t *()->memory;
+  void *scale_b = args[3].operator cinn_buffer_t *()->memory;
+  void *C       = args[4].operator cinn_buffer_t *()->memory;
+
+  auto to_fp8_dtype = [](const cinn_type_t &type) {
+    if (type.code == cinn_type_e4m3) {
+      return CUDA_R_8F_E4M3;
+    }
+    CHECK(type.code == cinn_type_e5m2) << "unsupported cublasLt fp8 data type: " << static_cast<int>(type.code);
+    return CUDA_R_8F_E5M2;
+  };
+  cudaDataType_t a_dtype = to_fp8_dtype(args[0].operator cinn_buffer_t *()->type);
+  cudaDataType_t b_dtype = to_fp8_dtype(args[1].operator cinn_buffer_t *()->type);
+  CHECK(a_dtype == CUDA_R_8F_E4M3 || b_dtype == CUDA_R_8F_E4M3) << "cublasLt has no fp8 matmul of two E5M2 inputs";
+
+  cudaDataType_t c_dtype;
+  auto c_type = args[4].operator cinn_buffer_t *()->type;
+  if (c_type.code == cinn_type_bfloat) {
+    c_dtype = CUDA_R_16BF;
+  } else if (c_type.code == cinn_type_float && c_type.bits == 16) {
+    c_dtype = CUDA_R_16F;
+  } else if (c_type.code == cinn_type_float && c_type.bits == 32) {
+    c_dtype = CUDA_R_32F;
+  } else {
+    LOG(FATAL) << "unsupported cublasLt fp8 matmul output type: " << static_cast<int>(c_type.code)
+               << ", bits = " << c_type.bits;
+  }
+
+  // As cublasLt is column-major, compute C^T[n, m] = B[n, k] * A^T[k, m] instead. The fp8 gemm only supports the "TN"
+  // layout, so B is stored as [n, k] and transposed while A is not. The scales dequantize the fp8 inputs, they are
+  // applied to the float32 accumulation together with alpha.
+  cublasOperation_t trans_op_l = CUBLAS_OP_T;
+  cublasOperation_t trans_op_r = CUBLAS_OP_N;
+
+  cublasLtMatmulDesc_t op_desc;
+  CUBLAS_CALL(cublasLtMatmulDescCreate(&op_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  CUBLAS_CALL(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSA, &trans_op_l, sizeof(trans_op_l)));
+  CUBLAS_CALL(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSB, &trans_op_r, sizeof(trans_op_r)));
+  CUBLAS_CALL(
+      cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &scale_b, sizeof(scale_b)));
+  CUBLAS_CALL(
+      cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &scale_a, sizeof(scale_a)));
+
+  cublasLtMatrixLayout_t l_desc, r_desc, c_desc;
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&l_desc, b_dtype, k, n, k));
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&r_desc, a_dtype, k, m, k));
+  CUBLAS_CALL(cublasLtMatrixLayoutCreate(&c_desc, c_dtype, n, m, n));
+
+  std::string hash_key = "fp8_a_" + std::to_string(static_cast<int>(a_dtype)) + "_b_" +
+                         std::to_string(static_cast<int>(b_dtype)) + "_c_" + std::to_string(static_cast<int>(c_dtype)) +
+                         "_m_" + std::to_string(m) + "_n_" + std::to_string(n) + "_k_" + std::to_string(k);
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  if (!CublasLtHandle::GetAlgo(hash_key, &heuristic_result)) {
+    cublasLtMatmulPreference_t preference;
+    size_t workspace_size = CublasLtHandle::kWorkSpaceSize;
+    CUBLAS_CALL(cublasLtMatmulPreferenceCreate(&preference));
+    CUBLAS_CALL(cublasLtMatmulPreferenceSetAttribute(
+        preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size, sizeof(workspace_size)));
+
+    int returned_algo_count = 0;
+    CUBLAS_CALL(cublasLtMatmulAlgoGetHeuristic(lt_handle.GetCublasLtHandle(),
+                                               op_desc,
+                                               l_desc,
+                                               r_desc,
+                                               c_desc,
+                                               c_desc,
+                                               preference,
+                                               1,
+                                               &heuristic_result,
+                                               &returned_algo_count));
+    CUBLAS_CALL(cublasLtMatmulPreferenceDestroy(preference));
+    CHECK_GT(returned_algo_count, 0) << "cublasLt finds no algorithm for " << hash_key
+                                     << ", the fp8 matmul requires the GPU of compute capability 8.9 or later";
+    CublasLtHandle::InsertAlgo(hash_key, heuristic_result);
+  }
+
+  float beta = 0.0f;
+  CUBLAS_CALL(cublasLtMatmul(lt_handle.GetCublasLtHandle(),
+                             op_desc,
+                             &alpha,
+                             B,
+                             l_desc,
+                             A,
+                             r_desc,
+                             &beta,
+                             C,
+                             c_desc,
+                             C,
+                             c_desc,
+                             &heuristic_result.algo,
+                             lt_handle.GetWorkSpace(),
+                             CublasLtHandle::kWorkSpaceSize,
+                             custream));
+
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(c_desc));
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(r_desc));
+  CUBLAS_CALL(cublasLtMatrixLayoutDestroy(l_desc));
+  CUBLAS_CALL(cublasLtMatmulDescDestroy(op_desc));
+#else
+  LOG(FATAL) << "The fp8 matmul requires CUDA 11.8 or later, but CINN is compiled with CUDA " << CUDA_VERSION;
+#endif
+}
+
+#ifdef CINN_WITH_CUSPARSELT
+#define CUSPARSELT_CALL(func)                                                \
+  {                                                                          \
+    auto status = func;                                                      \
+    if (status != CUSPARSE_STATUS_SUCCESS) {                                 \
+      LOG(FATAL) << "CUSPARSELT Error : " << cusparseGetErrorString(status); \
+    }                                                                        \
+  }
+
+// The cuSPARSELt handle of each stream, which keeps the plans of the sparse matmuls together with their compressed
+// weights. The plan is keyed by the address of the weight, as the weights of the sparse_matmul are constant.
+class CusparseLtHandle {
+ public:
+  // The plan of a sparse matmul, whose weight is compressed if it follows the 2:4 sparsity, otherwise the matmul is
+  // computed by the dense gemm.
+  struct Plan {
+    cusparseLtMatDescriptor_t w_desc, x_desc, out_desc;
+    cusparseLtMatmulDescriptor_t matmul_desc;
+    cusparseLtMatmulAlgSelection_t alg_sel;
+    cusparseLtMatmulPlan_t plan;
+    bool is_sparse{false};
+    void *compressed{nullptr};
+    void *workspace{nullptr};
+  };
+
+  CusparseLtHandle(const CusparseLtHandle &) = delete;
+  CusparseLtHandle &operator=(const CusparseLtHandle &) = delete;
+  ~CusparseLtHandle() {
+    for (auto &item : plans_) {
+      auto &plan = item.second;
+      if (plan.compressed) {
+        CUDA_CALL(cudaFree(plan.compressed));
+      }
+      if (plan.workspace) {
+        CUDA_CALL(cudaFree(plan.workspace));
+      }
+      CUSPARSELT_CALL(cusparseLtMatmulPlanDestroy(&plan.plan));
+      CUSPARSELT_CALL(cusparseLtMatDescriptorDestroy(&plan.w_desc));
+      CUSPARSELT_CALL(cusparseLtMatDescriptorDestroy(&plan.x_desc));
+      CUSPARSELT_CALL(cusparseLtMatDescriptorDestroy(&plan.out_desc));
+    }
+    CUSPARSELT_CALL(cusparseLtDestroy(&handle_));
+  }
+  static CusparseLtHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CusparseLtHandle>(stream); }
+
+  // Get the plan of the matmul, the weight is checked and compressed the first time it's seen, which synchronizes the
+  // stream, so the first run should not be captured by the CUDA Graph.
+  Plan &GetPlan(const void *w, cudaDataType_t dtype, int m, int n, int k) {
+    std::string key = std::to_string(reinterpret_cast<uintptr_t>(w)) + "_" + std::to_string(static_cast<int>(dtype)) +
+                      "_m_" + std::to_string(m) + "_n_" + std::to_string(n) + "_k_" + std::to_string(k);
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+      return it->second;
+    }
+    auto &plan = plans_[key];
+    // As cuSPARSELt is column-major, compute out^T[n, m] = w[n, k] * x^T[k, m] instead, so the weight is the
+    // structured operand. The [n, k] weight is stored as the column-major w^T, and transposed by the matmul.
+    constexpr unsigned kAlignment = 16;
+    CUSPARSELT_CALL(cusparseLtStructuredDescriptorInit(
+        &handle_, &plan.w_desc, k, n, k, kAlignment, dtype, CUSPARSE_ORDER_COL, CUSPARSELT_SPARSITY_50_PERCENT));
+    CUSPARSELT_CALL(
+        cusparseLtDenseDescriptorInit(&handle_, &plan.x_desc, k, m, k, kAlignment, dtype, CUSPARSE_ORDER_COL));
+    CUSPARSELT_CALL(
+        cusparseLtDenseDescriptorInit(&handle_, &plan.out_desc, n, m, n, kAlignment, dtype, CUSPARSE_ORDER_COL));
+    CUSPARSELT_CALL(cusparseLtMatmulDescriptorInit(&handle_,
+                                                   &plan.matmul_desc,
+                                                   CUSPARSE_OPERATION_TRANSPOSE,
+                                                   CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                                   &plan.w_desc,
+                                                   &plan.x_desc,
+                                                   &plan.out_desc,
+                                                   &plan.out_desc,
+                                                   CUSPARSE_COMPUTE_32F));
+    CUSPARSELT_CALL(
+        cusparseLtMatmulAlgSelectionInit(&handle_, &plan.alg_sel, &plan.matmul_desc, CUSPARSELT_MATMUL_ALG_DEFAULT));
+    CUSPARSELT_CALL(cusparseLtMatmulPlanInit(&handle_, &plan.plan, &plan.matmul_desc, &plan.alg_sel));
+
+    int *d_invalid = nullptr;
+    int invalid    = 0;
+    CUDA_CALL(cudaMalloc(&d_invalid, sizeof(int)));
+    CUSPARSELT_CALL(cusparseLtSpMMAPruneCheck(&handle_, &plan.matmul_desc, w, d_invalid, stream_));
+    CUDA_CALL(cudaMemcpyAsync(&invalid, d_invalid, sizeof(int), cudaMemcpyDeviceToHost, stream_));
+    CUDA_CALL(cudaStreamSynchronize(stream_));
+    CUDA_CALL(cudaFree(d_invalid));
+    plan.is_sparse = !invalid;
+    if (!plan.is_sparse) {
+      LOG(WARNING) << "The weight of the sparse matmul " << key << " is not 2:4 sparse, which falls back to cublas";
+      return plan;
+    }
+
+    size_t compressed_size = 0, compress_buffer_size = 0, workspace_size = 0;
+    void *compress_buffer  = nullptr;
+    CUSPARSELT_CALL(cusparseLtSpMMACompressedSize(&handle_, &plan.plan, &compressed_size, &compress_buffer_size));
+    CUDA_CALL(cudaMalloc(&plan.compressed, compressed_size));
+    if (compress_buffer_size) {
+      CUDA_CALL(cudaMalloc(&compress_buffer, compress_buffer_size));
+    }
+    CUSPARSELT_CALL(cusparseLtSpMMACompress(&handle_, &plan.plan, w, plan.compressed, compress_buffer, stream_));
+    CUDA_CALL(cudaStreamSynchronize(stream_));
+    if (compress_buffer) {
+      CUDA_CALL(cudaFree(compress_buffer));
+    }
+    CUSPARSELT_CALL(cusparseLtMatmulGetWorkspace(&handle_, &plan.plan, &workspace_size));
+    if (workspace_size) {
+      CUDA_CALL(cudaMalloc(&plan.workspace, workspace_size));
+    }
+    VLOG(3) << "Compress the 2:4 sparse weight of " << key << " into " << compressed_size << " bytes";
+    return plan;
+  }
+
+  cusparseLtHandle_t *GetHandle() { return &handle_; }
+
+ private:
+  friend CusparseLtHandle &GetStreamHandle<CusparseLtHandle>(void *stream);
+  CusparseLtHandle(int device_id, cudaStream_t stream) : stream_(stream) { CUSPARSELT_CALL(cusparseLtInit(&handle_)); }
+  cudaStream_t stream_;
+  cusparseLtHandle_t handle_;
+  std::unordered_map<std::string, Plan> plans_;
+};
+
+void cinn_call_cusparselt_matmul(void *v_args, int num_args, float alpha, int m, int n, int k, void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_cusparselt_matmul", cinn::utils::EventType::kInstruction);
+  CHECK_EQ(num_args, 3) << "The cinn_call_cusparselt_matmul only accept inputs X, W and a output";
+  VLOG(3) << "sparse matmul m: " << m << ", n: " << n << ", k: " << k << ", alpha: " << alpha;
+  CHECK(m % 16 == 0 && n % 16 == 0 && k % 16 == 0)
+      << "The m, n and k of the sparse matmul should be multiples of 16, but here " << m << ", " << n << ", " << k;
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  cudaStream_t custream  = static_cast<cudaStream_t>(stream);
+
+  void *X = args[0].operator cinn_buffer_t *()->memory;
+  void *W = args[1].operator cinn_buffer_t *()->memory;
+  void *C = args[2].operator cinn_buffer_t *()->memory;
+
+  cudaDataType_t cuda_dtype;
+  auto type = args[0].operator cinn_buffer_t *()->type;
+  if (type.code == cinn_type_bfloat) {
+    cuda_dtype = CUDA_R_16BF;
+  } else if (type.code == cinn_type_float && type.bits == 16) {
+    cuda_dtype = CUDA_R_16F;
+  } else {
+    LOG(FATAL) << "unsupported cuSPARSELt data type: " << static_cast<int>(type.code) << ", bits = " << type.bits;
+  }
+
+  auto &lt_handle = CusparseLtHandle::GetInstance(stream);
+  auto &plan      = lt_handle.GetPlan(W, cuda_dtype, m, n, k);
+  float beta      = 0.0f;
+  if (!plan.is_sparse) {
+    // out^T[n, m] = w[n, k] * x^T[k, m] by the dense gemm
+    cublasHandle_t &cuhandle = CublasHandle::GetInstance(stream).GetCublasHandle();
+    CUBLAS_CALL(cublasGemm(cuda_dtype, cuhandle, CUBLAS_OP_T, CUBLAS_OP_N, n, m, k, alpha, W, k, X, k, beta, C, n));
+    return;
+  }
+  CUSPARSELT_CALL(cusparseLtMatmul(
+      lt_handle.GetHandle(), &plan.plan, &alpha, plan.compressed, X, &beta, C, C, plan.workspace, &custream, 1));
+}
+#endif  // CINN_WITH_CUSPARSELT
+
+class CusparseHandle {
+ public:
+  CusparseHandle(const CusparseHandle &) = delete;
+  CusparseHandle &operator=(const CusparseHandle &) = delete;
+  ~CusparseHandle() {
+    if (workspace_) {
+      CUDA_CALL(cudaFree(workspace_));
+    }
+    CUSPARSE_CALL(cusparseDestroy(handle_));
+  }
+  static CusparseHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CusparseHandle>(stream); }
+  cusparseHandle_t &GetHandle() { return handle_; }
+
+  // The workspace grows to the max size ever required, and is shared by the calls ordered on the stream.
+  void *GetWorkspace(size_t size) {
+    if (size > workspace_size_) {
+      if (workspace_) {
+        CUDA_CALL(cudaFree(workspace_));
+      }
+      CUDA_CALL(cudaMalloc(&workspace_, size));
+      workspace_size_ = size;
+    }
+    return workspace_;
+  }
+
+ private:
+  friend CusparseHandle &GetStreamHandle<CusparseHandle>(void *stream);
+  CusparseHandle(int device_id, cudaStream_t stream) {
+    CUSPARSE_CALL(cusparseCreate(&handle_));
+    CUSPARSE_CALL(cusparseSetStream(handle_, stream));
+  }
+  cusparseHandle_t handle_;
+  void *workspace_{nullptr};
+  size_t workspace_size_{0};
+};
+
+void cinn_call_cusparse_spmm(void *v_args, int num_args, int m, int n, int k, int nnz, void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_cusparse_spmm", cinn::utils::EventType::kInstruction);
+  CHECK_EQ(num_args, 5) << "The cinn_call_cusparse_spmm only accept inputs crows, cols, values, dense and a output";
+  VLOG(3) << "csr spmm m: " << m << ", n: " << n << ", k: " << k << ", nnz: " << nnz;
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  void *crows            = args[0].operator cinn_buffer_t *()->memory;
+  void *cols             = args[1].operator cinn_buffer_t *()->memory;
+  void *values           = args[2].operator cinn_buffer_t *()->memory;
+  void *dense            = args[3].operator cinn_buffer_t *()->memory;
+  void *out              = args[4].operator cinn_buffer_t *()->memory;
+
+  cudaDataType_t data_type, compute_type = CUDA_R_32F;
+  auto type = args[2].operator cinn_buffer_t *()->type;
+  if (type.code == cinn_type_bfloat) {
+    data_type = CUDA_R_16BF;
+  } else if (type.code == cinn_type_float && type.bits == 16) {
+    data_type = CUDA_R_16F;
+  } else if (type.code == cinn_type_float && type.bits == 32) {
+    data_type = CUDA_R_32F;
+  } else if (type.code == cinn_type_float && type.bits == 64) {
+    data_type = compute_type = CUDA_R_64F;
+  } else {
+    LOG(FATAL) << "unsupported cuSPARSE data type: " << static_cast<int>(type.code) << ", bits = " << type.bits;
+  }
+  // the scalars are of the compute type
+  float alpha_fp32 = 1.0f, beta_fp32 = 0.0f;
+  double alpha_fp64 = 1.0, beta_fp64 = 0.0;
+  const void *alpha = compute_type == CUDA_R_64F ? static_cast<const void *>(&alpha_fp64) : &alpha_fp32;
+  const void *beta  = compute_type == CUDA_R_64F ? static_cast<const void *>(&beta_fp64) : &beta_fp32;
+
+  auto &sp_handle         = CusparseHandle::GetInstance(stream);
+  cusparseHandle_t handle = sp_handle.GetHandle();
+  cusparseSpMatDescr_t sparse_desc;
+  cusparseDnMatDescr_t dense_desc, out_desc;
+  CUSPARSE_CALL(cusparseCreateCsr(&sparse_desc,
+                                  m,
+                                  k,
+                                  nnz,
+                                  crows,
+                                  cols,
+                                  values,
+                                  CUSPARSE_INDEX_32I,
+                                  CUSPARSE_INDEX_32I,
+                                  CUSPARSE_INDEX_BASE_ZERO,
+                                  data_type));
+  CUSPARSE_CALL(cusparseCreateDnMat(&dense_desc, k, n, n, dense, data_type, CUSPARSE_ORDER_ROW));
+  CUSPARSE_CALL(cusparseCreateDnMat(&out_desc, m, n, n, out, data_type, CUSPARSE_ORDER_ROW));
+
+  size_t workspace_size = 0;
+  CUSPARSE_CALL(cusparseSpMM_bufferSize(handle,
+                                        CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                        CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                        alpha,
+                                        sparse_desc,
+                                        dense_desc,
+                                        beta,
+                                        out_desc,
+                                        compute_type,
+                                        CUSPARSE_SPMM_ALG_DEFAULT,
+                                        &workspace_size));
+  CUSPARSE_CALL(cusparseSpMM(handle,
+                             CUSPARSE_OPERATION_NON_TRANSPOSE,
+                             CUSPARSE_OPERATION_NON_TRANSPOSE,
+                             alpha,
+                             sparse_desc,
+                             dense_desc,
+                             beta,
+                             out_desc,
+                             compute_type,
+                             CUSPARSE_SPMM_ALG_DEFAULT,
+                             sp_handle.GetWorkspace(workspace_size)));
+
+  CUSPARSE_CALL(cusparseDestroyDnMat(out_desc));
+  CUSPARSE_CALL(cusparseDestroyDnMat(dense_desc));
+  CUSPARSE_CALL(cusparseDestroySpMat(sparse_desc));
+}
+
 void cinn_call_cuda_memset(void *v_args, int num_args, int value, size_t count, void *stream) {
   CHECK_EQ(num_args, 1) << "The cinn_call_cuda_memset only accept a output";
   VLOG(4) << "call cinn_call_cuda_memset with value=" << value << ", count=" << count;
@@ -469,34 +1175,43 @@ class CudnnHandle {
   ~CudnnHandle() {
     CUDNN_CALL(cudnnDestroy(cuhandle_));
     if (workspace_) {
-      CUDA_CALL(cudaFree(workspace_));
+      GetDeviceMemory()->free(workspace_);
     }
   }
-  static CudnnHandle &GetInstance() {
-    static CudnnHandle instance;
-    return instance;
-  }
+  static CudnnHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CudnnHandle>(stream); }
   cudnnHandle_t &GetCudnnHandle() { return cuhandle_; }
+  // the workspace belongs to the handle of a stream, so the convolutions running on different streams don't overwrite
+  // each other
   void *GetWorkSpace(size_t size) {
-    if (size_ >= size) {
-      return workspace_;
-    } else {
+    if (workspace_size_ < size) {
       if (workspace_) {
-        CUDA_CALL(cudaFree(workspace_));
+        GetDeviceMemory()->free(workspace_);
       }
-      size_ = size;
-      CUDA_CALL(cudaMalloc(&workspace_, size_));
-      return workspace_;
+      workspace_size_ = size;
+      workspace_      = GetDeviceMemory()->malloc(workspace_size_);
     }
+    return workspace_;
+  }
+  // The workspace is served by the memory manager of the device, which is the pooled allocator when
+  // FLAGS_cinn_use_cuda_caching_allocator is set, so growing the workspace doesn't synchronize the device by cudaFree.
+  static hlir::framework::MemoryInterface *GetDeviceMemory() {
+    return hlir::framework::MemoryManager::Global().RetrieveSafely(common::Target::Arch::NVGPU);
   }
 
  private:
-  CudnnHandle() : workspace_(nullptr), size_(0) { CUDNN_CALL(cudnnCreate(&cuhandle_)); }
+  friend CudnnHandle &GetStreamHandle<CudnnHandle>(void *stream);
+  CudnnHandle(int device_id, cudaStream_t stream) {
+    CUDNN_CALL(cudnnCreate(&cuhandle_));
+    CUDNN_CALL(cudnnSetStream(cuhandle_, stream));
+  }
   cudnnHandle_t cuhandle_;
-  void *workspace_;
-  size_t size_;
+  void *workspace_{nullptr};
+  size_t workspace_size_{0};
 };
 
+// The selected algorithms are persisted to FLAGS_cinn_cudnn_algo_cache_path if it is set, one record per line as
+// "<device signature>\t<key>\t<algo>". Only the records of the same GPU model and cuDNN version are loaded, so a cache
+// file can be shared among machines.
 class ConvAlgoMap {
  public:
   ConvAlgoMap(const ConvAlgoMap &) = delete;
@@ -505,14 +1220,202 @@ class ConvAlgoMap {
     static ConvAlgoMap instance;
     return instance;
   }
-  void InsertAlgo(const std::string &key, const int algo) { algo_map_[key] = algo; }
+  void InsertAlgo(const std::string &key, const int algo) {
+    algo_map_[key] = algo;
+    if (!FLAGS_cinn_cudnn_algo_cache_path.empty()) {
+      std::ofstream cache_file(FLAGS_cinn_cudnn_algo_cache_path, std::ios::app);
+      if (cache_file) {
+        cache_file << device_signature_ << '\t' << key << '\t' << algo << '\n';
+      } else {
+        LOG(WARNING) << "Failed to save the cudnn algorithm to " << FLAGS_cinn_cudnn_algo_cache_path;
+      }
+    }
+  }
   int GetAlgo(const std::string &key) { return algo_map_.count(key) ? algo_map_[key] : -1; }
 
  private:
-  ConvAlgoMap() {}
+  ConvAlgoMap() {
+    int device_id = 0;
+    cudaDeviceProp prop;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    CUDA_CALL(cudaGetDeviceProperties(&prop, device_id));
+    device_signature_ = std::string(prop.name) + ", cudnn=" + std::to_string(cudnnGetVersion());
+    if (!FLAGS_cinn_cudnn_algo_cache_path.empty()) {
+      Load(FLAGS_cinn_cudnn_algo_cache_path);
+    }
+  }
+
+  void Load(const std::string &path) {
+    std::ifstream cache_file(path);
+    std::string line;
+    while (std::getline(cache_file, line)) {
+      auto key_pos  = line.find('\t');
+      auto algo_pos = line.rfind('\t');
+      if (key_pos == std::string::npos || key_pos == algo_pos || line.substr(0, key_pos) != device_signature_) {
+        continue;
+      }
+      algo_map_[line.substr(key_pos + 1, algo_pos - key_pos - 1)] = std::stoi(line.substr(algo_pos + 1));
+    }
+    VLOG(3) << "Load " << algo_map_.size() << " cudnn algorithms of [" << device_signature_ << "] from " << path;
+  }
+
+  std::string device_signature_;
   absl::flat_hash_map<std::string, int> algo_map_;
 };
 
+// Choose the fastest algorithm whose workspace fits in FLAGS_cinn_cudnn_workspace_limit_bytes
+template <typename AlgoPerfT>
+decltype(AlgoPerfT::algo) ChooseConvAlgo(const AlgoPerfT *algo_perfs, int count, const std::string &hash_key) {
+  for (int idx = 0; idx < count; ++idx) {
+    if (algo_perfs[idx].status == CUDNN_STATUS_SUCCESS &&
+        algo_perfs[idx].memory <= static_cast<size_t>(FLAGS_cinn_cudnn_workspace_limit_bytes)) {
+      VLOG(4) << "Choose algorithm " << algo_perfs[idx].algo << " with time " << algo_perfs[idx].time
+              << "ms and workspace " << algo_perfs[idx].memory << " bytes for " << hash_key;
+      return algo_perfs[idx].algo;
+    }
+  }
+  LOG(FATAL) << "No cudnn algorithm fits in the workspace limit " << FLAGS_cinn_cudnn_workspace_limit_bytes
+             << " bytes for " << hash_key;
+  return algo_perfs[0].algo;
+}
+
+// If FLAGS_cinn_cudnn_exhaustive_search is set, all the algorithms are benchmarked by cudnnFind*AlgorithmEx on the
+// real buffers, the output is overwritten during the search, so it is only used when the output is not accumulated.
+cudnnConvolutionFwdAlgo_t GetConvForwardAlgo(const std::string &hash_key,
+                                             cudnnHandle_t handle,
+                                             cudnnTensorDescriptor_t x_desc,
+                                             const void *x,
+                                             cudnnFilterDescriptor_t w_desc,
+                                             const void *w,
+                                             cudnnConvolutionDescriptor_t conv_desc,
+                                             cudnnTensorDescriptor_t y_desc,
+                                             void *y,
+                                             bool can_overwrite_output) {
+  auto &conv_algo_map = ConvAlgoMap::GetInstance();
+  int algo_int        = conv_algo_map.GetAlgo(hash_key);
+  if (algo_int >= 0) {
+    return cudnnConvolutionFwdAlgo_t(algo_int);
+  }
+
+  int count = 0;
+  cudnnConvolutionFwdAlgoPerf_t algo_perfs[CUDNN_CONVOLUTION_FWD_ALGO_COUNT];
+  if (FLAGS_cinn_cudnn_exhaustive_search && can_overwrite_output) {
+    size_t workspace_size = FLAGS_cinn_cudnn_workspace_limit_bytes;
+    void *workspace_data  = CudnnHandle::GetDeviceMemory()->malloc(workspace_size);
+    CUDNN_CALL(cudnnFindConvolutionForwardAlgorithmEx(handle,
+                                                      x_desc,
+                                                      x,
+                                                      w_desc,
+                                                      w,
+                                                      conv_desc,
+                                                      y_desc,
+                                                      y,
+                                                      CUDNN_CONVOLUTION_FWD_ALGO_COUNT,
+                                                      &count,
+                                                      algo_perfs,
+                                                      workspace_data,
+                                                      workspace_size));
+    CudnnHandle::GetDeviceMemory()->free(workspace_data);
+  } else {
+    CUDNN_CALL(cudnnFindConvolutionForwardAlgorithm(
+        handle, x_desc, w_desc, conv_desc, y_desc, CUDNN_CONVOLUTION_FWD_ALGO_COUNT, &count, algo_perfs));
+  }
+
+  auto algo = ChooseConvAlgo(algo_perfs, count, hash_key);
+  conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo));
+  return algo;
+}
+
+cudnnConvolutionBwdDataAlgo_t GetConvBackwardDataAlgo(const std::string &hash_key,
+                                                      cudnnHandle_t handle,
+                                                      cudnnFilterDescriptor_t w_desc,
+                                                      const void *w,
+                                                      cudnnTensorDescriptor_t dy_desc,
+                                                      const void *dy,
+                                                      cudnnConvolutionDescriptor_t conv_desc,
+                                                      cudnnTensorDescriptor_t dx_desc,
+                                                      void *dx,
+                                                      bool can_overwrite_output) {
+  auto &conv_algo_map = ConvAlgoMap::GetInstance();
+  int algo_int        = conv_algo_map.GetAlgo(hash_key);
+  if (algo_int >= 0) {
+    return cudnnConvolutionBwdDataAlgo_t(algo_int);
+  }
+
+  int count = 0;
+  cudnnConvolutionBwdDataAlgoPerf_t algo_perfs[CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT];
+  if (FLAGS_cinn_cudnn_exhaustive_search && can_overwrite_output) {
+    size_t workspace_size = FLAGS_cinn_cudnn_workspace_limit_bytes;
+    void *workspace_data  = CudnnHandle::GetDeviceMemory()->malloc(workspace_size);
+    CUDNN_CALL(cudnnFindConvolutionBackwardDataAlgorithmEx(handle,
+                                                           w_desc,
+                                                           w,
+                                                           dy_desc,
+                                                           dy,
+                                                           conv_desc,
+                                                           dx_desc,
+                                                           dx,
+                                                           CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT,
+                                                           &count,
+                                                           algo_perfs,
+                                                           workspace_data,
+                                                           workspace_size));
+    CudnnHandle::GetDeviceMemory()->free(workspace_data);
+  } else {
+    CUDNN_CALL(cudnnFindConvolutionBackwardDataAlgorithm(
+        handle, w_desc, dy_desc, conv_desc, dx_desc, CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT, &count, algo_perfs));
+  }
+
+  auto algo = ChooseConvAlgo(algo_perfs, count, hash_key);
+  conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo));
+  return algo;
+}
+
+cudnnConvolutionBwdFilterAlgo_t GetConvBackwardFilterAlgo(const std::string &hash_key,
+                                                          cudnnHandle_t handle,
+                                                          cudnnTensorDescriptor_t x_desc,
+                                                          const void *x,
+                                                          cudnnTensorDescriptor_t dy_desc,
+                                                          const void *dy,
+                                                          cudnnConvolutionDescriptor_t conv_desc,
+                                                          cudnnFilterDescriptor_t dw_desc,
+                                                          void *dw,
+                                                          bool can_overwrite_output) {
+  auto &conv_algo_map = ConvAlgoMap::GetInstance();
+  int algo_int        = conv_algo_map.GetAlgo(hash_key);
+  if (algo_int >= 0) {
+    return cudnnConvolutionBwdFilterAlgo_t(algo_int);
+  }
+
+  int count = 0;
+  cudnnConvolutionBwdFilterAlgoPerf_t algo_perfs[CUDNN_CONVOLUTION_BWD_FILTER_ALGO_COUNT];
+  if (FLAGS_cinn_cudnn_exhaustive_search && can_overwrite_output) {
+    size_t workspace_size = FLAGS_cinn_cudnn_workspace_limit_bytes;
+    void *workspace_data  = CudnnHandle::GetDeviceMemory()->malloc(workspace_size);
+    CUDNN_CALL(cudnnFindConvolutionBackwardFilterAlgorithmEx(handle,
+                                                             x_desc,
+                                                             x,
+                                                             dy_desc,
+                                                             dy,
+                                                             conv_desc,
+                                                             dw_desc,
+                                                             dw,
+                                                             CUDNN_CONVOLUTION_BWD_FILTER_ALGO_COUNT,
+                                                             &count,
+                                                             algo_perfs,
+                                                             workspace_data,
+                                                             workspace_size));
+    CudnnHandle::GetDeviceMemory()->free(workspace_data);
+  } else {
+    CUDNN_CALL(cudnnFindConvolutionBackwardFilterAlgorithm(
+        handle, x_desc, dy_desc, conv_desc, dw_desc, CUDNN_CONVOLUTION_BWD_FILTER_ALGO_COUNT, &count, algo_perfs));
+  }
+
+  auto algo = ChooseConvAlgo(algo_perfs, count, hash_key);
+  conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo));
+  return algo;
+}
+
 cudnnDataType_t convert_to_cudnn_dtype(void *v_args, int num_args) {
   CHECK_GT(num_args, 0) << "the number of arguments must larger than zero";
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
@@ -626,8 +1529,7 @@ void cinn_call_cudnn_conv2d_forward(void *v_args,
                                     int output_w,
                                     void *stream) {
   CHECK_EQ(num_args, 3);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
   void *_x               = args[0].operator cinn_buffer_t *()->memory;
   void *_w               = args[1].operator cinn_buffer_t *()->memory;
@@ -662,7 +1564,6 @@ void cinn_call_cudnn_conv2d_forward(void *v_args,
   CUDNN_CALL(cudnnCreateTensorDescriptor(&y_desc));
   CUDNN_CALL(cudnnSetTensor4dDescriptor(y_desc, tensor_format, data_type, output_n, output_c, output_h, output_w));
 
-  auto &conv_algo_map  = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d forward, layout=" + debug_cudnn_tensor_format(tensor_format) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -671,18 +1572,8 @@ void cinn_call_cudnn_conv2d_forward(void *v_args,
                          std::to_string(output_n) + "," + std::to_string(output_c) + "," + std::to_string(output_h) +
                          "," + std::to_string(output_w) + "}";
   VLOG(4) << hash_key;
-  cudnnConvolutionFwdAlgo_t algo;
-  int algo_int = conv_algo_map.GetAlgo(hash_key);
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionFwdAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionFwdAlgoPerf_t algo_perf;
-    CUDNN_CALL(cudnnFindConvolutionForwardAlgorithm(handle, x_desc, w_desc, conv_desc, y_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionFwdAlgo_t algo =
+      GetConvForwardAlgo(hash_key, handle, x_desc, _x, w_desc, _w, conv_desc, y_desc, _y, beta == 0.0f);
 
   if (GetCinnCudnnDeterministic()) {
     algo = static_cast<cudnnConvolutionFwdAlgo_t>(1);
@@ -691,7 +1582,7 @@ void cinn_call_cudnn_conv2d_forward(void *v_args,
   size_t workspace_size = 0;
   CUDNN_CALL(cudnnGetConvolutionForwardWorkspaceSize(handle, x_desc, w_desc, conv_desc, y_desc, algo, &workspace_size));
 
-  void *workspace_data = CudnnHandle::GetInstance().GetWorkSpace(workspace_size);
+  void *workspace_data = CudnnHandle::GetInstance(stream).GetWorkSpace(workspace_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     const double alpha_fp64 = static_cast<double>(alpha);
     const double beta_fp64  = static_cast<double>(beta);
@@ -745,8 +1636,7 @@ void cinn_call_cudnn_conv2d_backward_data(void *v_args,
                                           int output_w,
                                           void *stream) {
   CHECK_EQ(num_args, 3);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
   void *_w               = args[0].operator cinn_buffer_t *()->memory;
   void *_dy              = args[1].operator cinn_buffer_t *()->memory;
@@ -781,7 +1671,6 @@ void cinn_call_cudnn_conv2d_backward_data(void *v_args,
   CUDNN_CALL(cudnnCreateTensorDescriptor(&y_desc));
   CUDNN_CALL(cudnnSetTensor4dDescriptor(y_desc, tensor_format, data_type, output_n, output_c, output_h, output_w));
 
-  auto &conv_algo_map  = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d backward data, layout=" + debug_cudnn_tensor_format(tensor_format) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -792,19 +1681,8 @@ void cinn_call_cudnn_conv2d_backward_data(void *v_args,
 
   VLOG(4) << hash_key;
 
-  int algo_int = conv_algo_map.GetAlgo(hash_key);
-  cudnnConvolutionBwdDataAlgo_t algo;
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionBwdDataAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionBwdDataAlgoPerf_t algo_perf;
-    CUDNN_CALL(
-        cudnnFindConvolutionBackwardDataAlgorithm(handle, w_desc, y_desc, conv_desc, x_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionBwdDataAlgo_t algo =
+      GetConvBackwardDataAlgo(hash_key, handle, w_desc, _w, y_desc, _dy, conv_desc, x_desc, _dx, beta == 0.0f);
 
   if (GetCinnCudnnDeterministic()) {
     algo = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
@@ -814,7 +1692,7 @@ void cinn_call_cudnn_conv2d_backward_data(void *v_args,
   CUDNN_CALL(
       cudnnGetConvolutionBackwardDataWorkspaceSize(handle, w_desc, y_desc, conv_desc, x_desc, algo, &workspace_size));
 
-  void *workspace_data = CudnnHandle::GetInstance().GetWorkSpace(workspace_size);
+  void *workspace_data = CudnnHandle::GetInstance(stream).GetWorkSpace(workspace_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     const double alpha_fp64 = static_cast<double>(alpha);
     const double beta_fp64  = static_cast<double>(beta);
@@ -868,8 +1746,7 @@ void cinn_call_cudnn_conv2d_backward_filter(void *v_args,
                                             int output_w,
                                             void *stream) {
   CHECK_EQ(num_args, 3);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
 
   void *_x  = args[0].operator cinn_buffer_t *()->memory;
@@ -905,7 +1782,6 @@ void cinn_call_cudnn_conv2d_backward_filter(void *v_args,
   CUDNN_CALL(cudnnCreateTensorDescriptor(&y_desc));
   CUDNN_CALL(cudnnSetTensor4dDescriptor(y_desc, tensor_format, data_type, output_n, output_c, output_h, output_w));
 
-  auto &algo_map       = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d backward filter, layout=" + debug_cudnn_tensor_format(tensor_format) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -916,19 +1792,8 @@ void cinn_call_cudnn_conv2d_backward_filter(void *v_args,
 
   VLOG(4) << hash_key;
 
-  int algo_int = algo_map.GetAlgo(hash_key);
-  cudnnConvolutionBwdFilterAlgo_t algo;
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionBwdFilterAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionBwdFilterAlgoPerf_t algo_perf;
-    CUDNN_CALL(
-        cudnnFindConvolutionBackwardFilterAlgorithm(handle, x_desc, y_desc, conv_desc, w_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionBwdFilterAlgo_t algo =
+      GetConvBackwardFilterAlgo(hash_key, handle, x_desc, _x, y_desc, _dy, conv_desc, w_desc, _dw, beta == 0.0f);
 
   if (GetCinnCudnnDeterministic()) {
     algo = CUDNN_CONVOLUTION_BWD_FILTER_ALGO_1;
@@ -938,7 +1803,7 @@ void cinn_call_cudnn_conv2d_backward_filter(void *v_args,
   CUDNN_CALL(
       cudnnGetConvolutionBackwardFilterWorkspaceSize(handle, x_desc, y_desc, conv_desc, w_desc, algo, &workspace_size));
 
-  void *workspace_data = CudnnHandle::GetInstance().GetWorkSpace(workspace_size);
+  void *workspace_data = CudnnHandle::GetInstance(stream).GetWorkSpace(workspace_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     const double alpha_fp64 = static_cast<double>(alpha);
     const double beta_fp64  = static_cast<double>(beta);
@@ -988,8 +1853,7 @@ void cinn_call_cudnn_pool2d_forward(void *v_args,
                                     int output_w,
                                     void *stream) {
   CHECK_EQ(num_args, 2);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
 
   void *_x = args[0].operator cinn_buffer_t *()->memory;
@@ -1062,8 +1926,7 @@ void cinn_call_cudnn_pool2d_backward(void *v_args,
                                      int output_w,
                                      void *stream) {
   CHECK_EQ(num_args, 4);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
 
   void *_x  = args[0].operator cinn_buffer_t *()->memory;
@@ -1134,8 +1997,7 @@ void cinn_call_cudnn_softmax_forward(void *v_args,
                                      int output_w,
                                      void *stream) {
   CHECK_EQ(num_args, 2);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
 
   void *_x = args[0].operator cinn_buffer_t *()->memory;
@@ -1182,8 +2044,7 @@ void cinn_call_cudnn_softmax_backward(void *v_args,
                                       int output_w,
                                       void *stream) {
   CHECK_EQ(num_args, 3);
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
 
   void *_y  = args[0].operator cinn_buffer_t *()->memory;
@@ -1334,14 +2195,15 @@ class CusolverHandle {
   CusolverHandle(const CusolverHandle &) = delete;
   CusolverHandle &operator=(const CusolverHandle &) = delete;
   ~CusolverHandle() { CUSOLVER_CALL(cusolverDnDestroy(handle_)); }
-  static CusolverHandle &GetInstance() {
-    static CusolverHandle instance;
-    return instance;
-  }
+  static CusolverHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<CusolverHandle>(stream); }
   cusolverDnHandle_t &GetHandle() { return handle_; }
 
  private:
-  CusolverHandle() { CUSOLVER_CALL(cusolverDnCreate(&handle_)); }
+  friend CusolverHandle &GetStreamHandle<CusolverHandle>(void *stream);
+  CusolverHandle(int device_id, cudaStream_t stream) {
+    CUSOLVER_CALL(cusolverDnCreate(&handle_));
+    CUSOLVER_CALL(cusolverDnSetStream(handle_, stream));
+  }
   cusolverDnHandle_t handle_;
 };
 
@@ -1364,38 +2226,44 @@ void cinn_call_cholesky_nvgpu(void *v_args, int num_args, int batch_size, int m,
   void *x_ptr   = reinterpret_cast<void *>(x->memory);
   void *out_ptr = reinterpret_cast<void *>(out->memory);
   CUDA_CALL(cudaMemcpyAsync(out_ptr, x_ptr, numel * bytes, cudaMemcpyDeviceToDevice, cuda_stream));
-  // Generate pointer array
-  thrust::host_vector<void *> host_out_ptr(batch_size, nullptr);
+  // The whole batch is factorized by one potrfBatched call. The pointer array and the return value of each matrix are
+  // allocated from the stream ordered memory pool, so the call doesn't synchronize the device for the allocations.
+  std::vector<void *> host_out_ptr(batch_size, nullptr);
   for (int i = 0; i < batch_size; ++i) {
-    host_out_ptr[i] = reinterpret_cast<char *>(out_ptr) + i * m * m * bytes;
+    host_out_ptr[i] = reinterpret_cast<char *>(out_ptr) + static_cast<size_t>(i) * m * m * bytes;
   }
-  thrust::device_vector<void *> dev_out_ptr(host_out_ptr.begin(), host_out_ptr.end());
-  // Store the return value of each matrix
-  thrust::host_vector<int> host_info(batch_size, 0);
-  thrust::device_vector<int> dev_info(host_info.begin(), host_info.end());
+  void **dev_out_ptr = nullptr;
+  int *dev_info      = nullptr;
+  CUDA_CALL(cudaMallocAsync(&dev_out_ptr, sizeof(void *) * batch_size, cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&dev_info, sizeof(int) * batch_size, cuda_stream));
+  CUDA_CALL(cudaMemcpyAsync(
+      dev_out_ptr, host_out_ptr.data(), sizeof(void *) * batch_size, cudaMemcpyHostToDevice, cuda_stream));
 
-  cusolverDnHandle_t handler = CusolverHandle::GetInstance().GetHandle();
-  CUSOLVER_CALL(cusolverDnSetStream(handler, cuda_stream));
+  cusolverDnHandle_t handler = CusolverHandle::GetInstance(stream).GetHandle();
   if (bits == 32) {
     CUSOLVER_CALL(cusolverDnSpotrfBatched(handler,
                                           uplo,
                                           m,
-                                          reinterpret_cast<float **>(dev_out_ptr.data().get()),
+                                          reinterpret_cast<float **>(dev_out_ptr),
                                           m,
-                                          thrust::raw_pointer_cast(dev_info.data()),
+                                          dev_info,
                                           batch_size));
   } else if (bits == 64) {
     CUSOLVER_CALL(cusolverDnDpotrfBatched(handler,
                                           uplo,
                                           m,
-                                          reinterpret_cast<double **>(dev_out_ptr.data().get()),
+                                          reinterpret_cast<double **>(dev_out_ptr),
                                           m,
-                                          thrust::raw_pointer_cast(dev_info.data()),
+                                          dev_info,
                                           batch_size));
   }
 
-  // Check result
-  thrust::copy(dev_info.begin(), dev_info.end(), host_info.begin());
+  // Check result, which is the only synchronization of the call
+  std::vector<int> host_info(batch_size, 0);
+  CUDA_CALL(cudaMemcpyAsync(host_info.data(), dev_info, sizeof(int) * batch_size, cudaMemcpyDeviceToHost, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(dev_out_ptr, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(dev_info, cuda_stream));
+  CUDA_CALL(cudaStreamSynchronize(cuda_stream));
   for (int i = 0; i < host_info.size(); i++) {
     CHECK_EQ(host_info[i], 0) << "Cholesky decomposition fail, please check the " << i + 1 << "th input matrix.";
   }
@@ -1411,9 +2279,8 @@ void cinn_call_triangular_solve_nvgpu(void *v_args,
                                       bool transpose_a,
                                       bool unit_diagonal,
                                       void *stream) {
-  cublasHandle_t &handle = CublasHandle::GetInstance().GetCublasHandle();
+  cublasHandle_t &handle = CublasHandle::GetInstance(stream).GetCublasHandle();
   cudaStream_t custream  = static_cast<cudaStream_t>(stream);
-  CUBLAS_CALL(cublasSetStream(handle, custream));
 
   int b_rows               = left_side ? k : m;
   int b_cols               = left_side ? m : k;
@@ -1454,17 +2321,22 @@ void cinn_call_triangular_solve_nvgpu(void *v_args,
   size_t numel = input2->num_elements();
   CUDA_CALL(cudaMemcpyAsync(x_ptr, b_ptr, numel * bytes, cudaMemcpyDeviceToDevice, custream));
 
-  std::vector<void *> a_array(batch_size, nullptr);
-  std::vector<void *> x_array(batch_size, nullptr);
+  // The pointer arrays of the batch are uploaded in one copy into the stream ordered memory pool, and freed in the
+  // stream order after the trsmBatched, so neither the allocation nor the release blocks the host.
+  std::vector<void *> ptr_array(2 * batch_size, nullptr);
   for (int i = 0; i < batch_size; ++i) {
-    a_array[i] = reinterpret_cast<char *>(a_ptr) + i * m * m * bytes;
-    x_array[i] = reinterpret_cast<char *>(x_ptr) + i * m * k * bytes;
+    ptr_array[i]              = reinterpret_cast<char *>(a_ptr) + static_cast<size_t>(i) * m * m * bytes;
+    ptr_array[batch_size + i] = reinterpret_cast<char *>(x_ptr) + static_cast<size_t>(i) * m * k * bytes;
   }
-  thrust::device_vector<void *> dev_a_array(a_array.begin(), a_array.end());
-  thrust::device_vector<void *> dev_x_array(x_array.begin(), x_array.end());
+  void **dev_ptr_array = nullptr;
+  CUDA_CALL(cudaMallocAsync(&dev_ptr_array, sizeof(void *) * ptr_array.size(), custream));
+  CUDA_CALL(cudaMemcpyAsync(
+      dev_ptr_array, ptr_array.data(), sizeof(void *) * ptr_array.size(), cudaMemcpyHostToDevice, custream));
+  void **dev_a_array = dev_ptr_array;
+  void **dev_x_array = dev_ptr_array + batch_size;
 
   if (bits == 32) {
-    std::vector<float> alpha(batch_size, 1.0f);
+    const float alpha = 1.0f;
     CUBLAS_CALL(cublasStrsmBatched(handle,
                                    side,
                                    uplo,
@@ -1472,14 +2344,14 @@ void cinn_call_triangular_solve_nvgpu(void *v_args,
                                    diag,
                                    b_rows,
                                    b_cols,
-                                   alpha.data(),
-                                   reinterpret_cast<float **>(dev_a_array.data().get()),
+                                   &alpha,
+                                   reinterpret_cast<float **>(dev_a_array),
                                    lda,
-                                   reinterpret_cast<float **>(dev_x_array.data().get()),
+                                   reinterpret_cast<float **>(dev_x_array),
                                    ldb,
                                    batch_size));
   } else if (bits == 64) {
-    std::vector<double> alpha(batch_size, 1.0);
+    const double alpha = 1.0;
     CUBLAS_CALL(cublasDtrsmBatched(handle,
                                    side,
                                    uplo,
@@ -1487,13 +2359,14 @@ void cinn_call_triangular_solve_nvgpu(void *v_args,
                                    diag,
                                    b_rows,
                                    b_cols,
-                                   alpha.data(),
-                                   reinterpret_cast<double **>(dev_a_array.data().get()),
+                                   &alpha,
+                                   reinterpret_cast<double **>(dev_a_array),
                                    lda,
-                                   reinterpret_cast<double **>(dev_x_array.data().get()),
+                                   reinterpret_cast<double **>(dev_x_array),
                                    ldb,
                                    batch_size));
   }
+  CUDA_CALL(cudaFreeAsync(dev_ptr_array, custream));
 }
 
 void cinn_assert_true_nvgpu(void *v_args, int num_args, int msg, bool only_warning, void *stream) {
@@ -1505,10 +2378,9 @@ void cinn_gpu_cublas_mul(const std::vector<int> &attrs,
                          cinn_buffer_t *input2,
                          cinn_buffer_t *output,
                          cudaStream_t stream) {
-  cublasHandle_t &handle = CublasHandle::GetInstance().GetCublasHandle();
+  cublasHandle_t &handle = CublasHandle::GetInstance(stream).GetCublasHandle();
   CHECK_EQ(input1->type.code, cinn_type_code_t::cinn_type_float);
   cudaStream_t custream = static_cast<cudaStream_t>(stream);
-  CUBLAS_CALL(cublasSetStream(handle, custream));
   float *x_data   = reinterpret_cast<float *>(input1->memory);
   float *y_data   = reinterpret_cast<float *>(input2->memory);
   float *out_data = reinterpret_cast<float *>(output->memory);
@@ -1531,9 +2403,8 @@ void cinn_gpu_cublas_gemm(const std::vector<int> &attrs,
                           cinn_buffer_t *bias,
                           cinn_buffer_t *output,
                           cudaStream_t stream) {
-  cublasHandle_t &handle = CublasHandle::GetInstance().GetCublasHandle();
+  cublasHandle_t &handle = CublasHandle::GetInstance(stream).GetCublasHandle();
   cudaStream_t custream  = static_cast<cudaStream_t>(stream);
-  CUBLAS_CALL(cublasSetStream(handle, custream));
 
   CHECK_EQ(lhs->type.code, cinn_type_code_t::cinn_type_float);
   const float *lhs_data  = reinterpret_cast<const float *>(lhs->memory);
@@ -1827,8 +2698,7 @@ void cinn_gpu_cudnn_conv2d(const absl::flat_hash_map<std::string, int> &attr,
   GetAttrValue(attr, output_h, -1);
   GetAttrValue(attr, output_w, -1);
 
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   void *_x = x->memory;
   void *_w = w->memory;
   void *_y = y->memory;
@@ -1863,7 +2733,6 @@ void cinn_gpu_cudnn_conv2d(const absl::flat_hash_map<std::string, int> &attr,
   CUDNN_CALL(
       cudnnSetTensor4dDescriptor(y_desc, cudnn_tensor_format, data_type, output_n, output_c, output_h, output_w));
 
-  auto &conv_algo_map  = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d forward, layout=" + debug_cudnn_tensor_format(CUDNN_TENSOR_NCHW) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -1872,18 +2741,8 @@ void cinn_gpu_cudnn_conv2d(const absl::flat_hash_map<std::string, int> &attr,
                          std::to_string(output_n) + "," + std::to_string(output_c) + "," + std::to_string(output_h) +
                          "," + std::to_string(output_w) + "}";
 
-  cudnnConvolutionFwdAlgo_t algo;
-  int algo_int = conv_algo_map.GetAlgo(hash_key);
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionFwdAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionFwdAlgoPerf_t algo_perf;
-    CUDNN_CALL(cudnnFindConvolutionForwardAlgorithm(handle, x_desc, w_desc, conv_desc, y_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionFwdAlgo_t algo =
+      GetConvForwardAlgo(hash_key, handle, x_desc, _x, w_desc, _w, conv_desc, y_desc, _y, true);
 
   if (GetCinnCudnnDeterministic()) {
     algo = static_cast<cudnnConvolutionFwdAlgo_t>(1);
@@ -1892,7 +2751,7 @@ void cinn_gpu_cudnn_conv2d(const absl::flat_hash_map<std::string, int> &attr,
   size_t ws_size = 0;
   CUDNN_CALL(cudnnGetConvolutionForwardWorkspaceSize(handle, x_desc, w_desc, conv_desc, y_desc, algo, &ws_size));
 
-  void *ws_data = CudnnHandle::GetInstance().GetWorkSpace(ws_size);
+  void *ws_data = CudnnHandle::GetInstance(stream).GetWorkSpace(ws_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     double alpha[] = {1.f}, beta[] = {0.f};
     CUDNN_CALL(cudnnConvolutionForward(
@@ -1934,8 +2793,7 @@ void cinn_gpu_cudnn_conv2d_backward_data(const absl::flat_hash_map<std::string,
   GetAttrValue(attr, output_h, -1);
   GetAttrValue(attr, output_w, -1);
 
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   void *_w  = w->memory;
   void *_dy = dy->memory;
   void *_dx = dx->memory;
@@ -1969,7 +2827,6 @@ void cinn_gpu_cudnn_conv2d_backward_data(const absl::flat_hash_map<std::string,
   CUDNN_CALL(cudnnCreateTensorDescriptor(&y_desc));
   CUDNN_CALL(cudnnSetTensor4dDescriptor(y_desc, CUDNN_TENSOR_NCHW, data_type, output_n, output_c, output_h, output_w));
 
-  auto &conv_algo_map  = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d backward data, layout=" + debug_cudnn_tensor_format(CUDNN_TENSOR_NCHW) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -1978,20 +2835,8 @@ void cinn_gpu_cudnn_conv2d_backward_data(const absl::flat_hash_map<std::string,
                          std::to_string(output_n) + "," + std::to_string(output_c) + "," + std::to_string(output_h) +
                          "," + std::to_string(output_w) + "}";
 
-  int algo_int = conv_algo_map.GetAlgo(hash_key);
-  cudnnConvolutionBwdDataAlgo_t algo;
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionBwdDataAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionBwdDataAlgoPerf_t algo_perf;
-
-    CUDNN_CALL(
-        cudnnFindConvolutionBackwardDataAlgorithm(handle, w_desc, y_desc, conv_desc, x_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    conv_algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionBwdDataAlgo_t algo =
+      GetConvBackwardDataAlgo(hash_key, handle, w_desc, _w, y_desc, _dy, conv_desc, x_desc, _dx, true);
 
   if (GetCinnCudnnDeterministic()) {
     algo = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
@@ -2000,7 +2845,7 @@ void cinn_gpu_cudnn_conv2d_backward_data(const absl::flat_hash_map<std::string,
   size_t ws_size = 0;
   CUDNN_CALL(cudnnGetConvolutionBackwardDataWorkspaceSize(handle, w_desc, y_desc, conv_desc, x_desc, algo, &ws_size));
 
-  void *ws_data = CudnnHandle::GetInstance().GetWorkSpace(ws_size);
+  void *ws_data = CudnnHandle::GetInstance(stream).GetWorkSpace(ws_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     double alpha[] = {1.0f}, beta[] = {0.0f};
     CUDNN_CALL(cudnnConvolutionBackwardData(
@@ -2042,8 +2887,7 @@ void cinn_gpu_cudnn_conv2d_backward_filter(const absl::flat_hash_map<std::string
   GetAttrValue(attr, output_h, -1);
   GetAttrValue(attr, output_w, -1);
 
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
 
   void *_x  = x->memory;
   void *_dy = dy->memory;
@@ -2078,7 +2922,6 @@ void cinn_gpu_cudnn_conv2d_backward_filter(const absl::flat_hash_map<std::string
   CUDNN_CALL(cudnnCreateTensorDescriptor(&y_desc));
   CUDNN_CALL(cudnnSetTensor4dDescriptor(y_desc, CUDNN_TENSOR_NCHW, data_type, output_n, output_c, output_h, output_w));
 
-  auto &algo_map       = ConvAlgoMap::GetInstance();
   std::string hash_key = "conv2d backward filter, layout=" + debug_cudnn_tensor_format(CUDNN_TENSOR_NCHW) +
                          ", dtype=" + debug_cudnn_tensor_dtype(data_type) + ", input_nchw={" + std::to_string(input_n) +
                          "," + std::to_string(input_c) + "," + std::to_string(input_h) + "," + std::to_string(input_w) +
@@ -2087,19 +2930,8 @@ void cinn_gpu_cudnn_conv2d_backward_filter(const absl::flat_hash_map<std::string
                          std::to_string(output_n) + "," + std::to_string(output_c) + "," + std::to_string(output_h) +
                          "," + std::to_string(output_w) + "}";
 
-  int algo_int = algo_map.GetAlgo(hash_key);
-  cudnnConvolutionBwdFilterAlgo_t algo;
-  if (algo_int >= 0) {
-    algo = cudnnConvolutionBwdFilterAlgo_t(algo_int);
-  } else {
-    int count = 0;
-    cudnnConvolutionBwdFilterAlgoPerf_t algo_perf;
-    CUDNN_CALL(
-        cudnnFindConvolutionBackwardFilterAlgorithm(handle, x_desc, y_desc, conv_desc, w_desc, 1, &count, &algo_perf));
-
-    algo = algo_perf.algo;
-    algo_map.InsertAlgo(hash_key, static_cast<int>(algo_perf.algo));
-  }
+  cudnnConvolutionBwdFilterAlgo_t algo =
+      GetConvBackwardFilterAlgo(hash_key, handle, x_desc, _x, y_desc, _dy, conv_desc, w_desc, _dw, true);
 
   if (GetCinnCudnnDeterministic()) {
     algo = CUDNN_CONVOLUTION_BWD_FILTER_ALGO_1;
@@ -2108,7 +2940,7 @@ void cinn_gpu_cudnn_conv2d_backward_filter(const absl::flat_hash_map<std::string
   size_t ws_size = 0;
   CUDNN_CALL(cudnnGetConvolutionBackwardFilterWorkspaceSize(handle, x_desc, y_desc, conv_desc, w_desc, algo, &ws_size));
 
-  void *ws_data = CudnnHandle::GetInstance().GetWorkSpace(ws_size);
+  void *ws_data = CudnnHandle::GetInstance(stream).GetWorkSpace(ws_size);
   if (data_type == CUDNN_DATA_DOUBLE) {
     double alpha[] = {1.0}, beta[] = {0.0};
     CUDNN_CALL(cudnnConvolutionBackwardFilter(
@@ -2130,8 +2962,7 @@ void cinn_gpu_cudnn_pool2d(const std::vector<int> &attrs,
                            cinn_buffer_t *input,
                            cinn_buffer_t *output,
                            cudaStream_t stream) {
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   CHECK_EQ(attrs.size(), 17);
   // Here the input paddings are pad_top, pad_bottom, pad_left, pad_right.
   // Since pad_top==pad_bottom and pad_left==pad_rifht, we only take pad_top and pad_left.
@@ -2227,8 +3058,7 @@ void cinn_gpu_cudnn_softmax(const std::vector<int> &attrs,
 
   auto data_type = convert_to_cudnn_dtype(input);
 
-  cudnnHandle_t &handle = CudnnHandle::GetInstance().GetCudnnHandle();
-  CUDNN_CALL(cudnnSetStream(handle, static_cast<cudaStream_t>(stream)));
+  cudnnHandle_t &handle = CudnnHandle::GetInstance(stream).GetCudnnHandle();
   void *in_data  = input->memory;
   void *out_data = output->memory;
 
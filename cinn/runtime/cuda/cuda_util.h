@@ -63,14 +63,228 @@ void cinn_call_triangular_solve_nvgpu(void* v_args,
                                       bool unit_diagonal,
                                       void* stream = nullptr);
 
+void cinn_call_flash_attention_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_heads,
+                                     int seq_q,
+                                     int seq_k,
+                                     int head_dim,
+                                     int value_dim,
+                                     int mask_batch_stride,
+                                     int mask_head_stride,
+                                     int mask_row_stride,
+                                     float scale,
+                                     bool causal,
+                                     void* stream = nullptr);
+
+void cinn_call_sort_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool is_ascend, void* stream = nullptr);
+
+void cinn_call_argsort_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool is_ascend, void* stream = nullptr);
+
+void cinn_call_top_k_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, int k, bool largest, void* stream = nullptr);
+
+/**
+ * Sort each of the outer * inner segments of the axis_size elements of x stably, and write the first out_axis
+ * elements of the sorted segments to the non-null outputs: the values, the int32 or int64 indices on the axis, and the
+ * int32 ranks of the input elements.
+ */
+void SortSegments(const cinn_buffer_t* x,
+                  int outer,
+                  int axis_size,
+                  int inner,
+                  int out_axis,
+                  bool descending,
+                  void* values,
+                  void* index32,
+                  void* index64,
+                  void* ranks,
+                  cudaStream_t stream);
+
+/**
+ * The cumulative sum, product and max of each of the outer * inner segments of the axis_size elements of the input,
+ * scanned from the last element if reverse, and excluding the element itself if exclusive. The long segments are
+ * scanned by the single-pass decoupled look-back kernel, which reads and writes each element once.
+ */
+void cinn_call_cumsum_nvgpu(void* v_args,
+                            int num_args,
+                            int outer,
+                            int axis_size,
+                            int inner,
+                            bool exclusive,
+                            bool reverse,
+                            void* stream = nullptr);
+
+void cinn_call_cumprod_nvgpu(void* v_args,
+                             int num_args,
+                             int outer,
+                             int axis_size,
+                             int inner,
+                             bool exclusive,
+                             bool reverse,
+                             void* stream = nullptr);
+
+void cinn_call_cummax_nvgpu(void* v_args,
+                            int num_args,
+                            int outer,
+                            int axis_size,
+                            int inner,
+                            bool exclusive,
+                            bool reverse,
+                            void* stream = nullptr);
+
+void cinn_call_lookup_table_nvgpu(
+    void* v_args, int num_args, int num_ids, int num_rows, int dim, int64_t padding_idx, void* stream = nullptr);
+
+/**
+ * Add the updates into the rows of the input by the index on the axis. The updates of each row are summed in the
+ * order of the index if deterministic, otherwise they are added by the atomics for the float32, float64 and int32.
+ */
+void cinn_call_scatter_add_nvgpu(void* v_args,
+                                 int num_args,
+                                 int outer,
+                                 int num_rows,
+                                 int num_index,
+                                 int inner,
+                                 bool deterministic,
+                                 void* stream = nullptr);
+
+/**
+ * Concat the operands of the same shape, each of them is viewed as [outer, inner] and copied into the columns
+ * [i * inner, (i + 1) * inner) of the output viewed as [outer, num_operands * inner]. The split is the reverse.
+ */
+void cinn_call_concat_nvgpu(void* v_args, int num_args, int outer, int inner, void* stream = nullptr);
+
+void cinn_call_split_nvgpu(void* v_args, int num_args, int outer, int inner, void* stream = nullptr);
+
+void cinn_call_layer_norm_nvgpu(
+    void* v_args, int num_args, int rows, int cols, float epsilon, void* stream = nullptr);
+
+void cinn_call_layer_norm_grad_nvgpu(
+    void* v_args, int num_args, int rows, int cols, float epsilon, void* stream = nullptr);
+
+void cinn_call_rms_norm_nvgpu(void* v_args, int num_args, int rows, int cols, float epsilon, void* stream = nullptr);
+
+void cinn_call_rms_norm_grad_nvgpu(void* v_args, int num_args, int rows, int cols, void* stream = nullptr);
+
+/**
+ * The batch_norm of the training and its gradient, the x is viewed as [outer, channels, inner], which is
+ * [N, C, H * W] for NCHW and [N * H * W, C, 1] for NHWC, and the statistics of each channel are reduced over the
+ * outer and the inner.
+ */
+void cinn_call_batch_norm_train_nvgpu(void* v_args,
+                                      int num_args,
+                                      int channels,
+                                      int outer,
+                                      int inner,
+                                      float epsilon,
+                                      float momentum,
+                                      void* stream = nullptr);
+
+void cinn_call_batch_norm_grad_nvgpu(
+    void* v_args, int num_args, int channels, int outer, int inner, float epsilon, void* stream = nullptr);
+
+/**
+ * Reduce the x viewed as [outer, reduce, inner] along the middle axis, and output the max or the min value with its
+ * first index in one pass.
+ */
+void cinn_call_arg_reduce_nvgpu(
+    void* v_args, int num_args, int outer, int reduce, int inner, bool is_max, void* stream = nullptr);
+
+/**
+ * Write the key and the value of the new token of each sequence into the paged caches of the shape [num_blocks,
+ * num_kv_heads, block_size, head_dim] in place at its context length, and output the context lengths plus one.
+ */
+void cinn_call_kv_cache_append_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_kv_heads,
+                                     int head_dim,
+                                     int block_size,
+                                     int max_blocks_per_seq,
+                                     void* stream = nullptr);
+
+/**
+ * Compute the decode attention of the single query token of each sequence over its paged key and value caches, the
+ * context is split into the partitions of 512 tokens whose outputs are merged by their max logits.
+ */
+void cinn_call_paged_attention_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_heads,
+                                     int num_kv_heads,
+                                     int head_dim,
+                                     int block_size,
+                                     int max_blocks_per_seq,
+                                     float scale,
+                                     void* stream = nullptr);
+
+void cinn_call_fused_softmax_nvgpu(void* v_args,
+                                   int num_args,
+                                   int rows,
+                                   int cols,
+                                   float scale,
+                                   bool log_softmax,
+                                   int mask_dim1,
+                                   int mask_dim2,
+                                   int mask_stride0,
+                                   int mask_stride1,
+                                   int mask_stride2,
+                                   void* stream = nullptr);
+
+void cinn_call_softmax_cross_entropy_nvgpu(
+    void* v_args, int num_args, int rows, int cols, int ignore_index, void* stream = nullptr);
+
 void cinn_call_cuda_memset(void* v_args, int num_args, int value, size_t count, void* stream = nullptr);
 void cinn_call_cuda_memcpy(void* v_args, int num_args, size_t count, void* stream = nullptr);
 
+//! The maximum number of the partial results of cinn_compute_tensor_stats_nvgpu.
+constexpr int kTensorStatsMaxBlocks = 128;
+
+/**
+ * Compute the statistics of the elements of a device buffer without copying it: the minimum, the maximum and the sum
+ * of the finite values, the number of NaNs and of Infs. Each block of the kernel writes its partial results, 5 doubles
+ * in the order above, into the device memory \p partial of kTensorStatsMaxBlocks * 5 doubles, which are reduced by the
+ * caller after copied back.
+ * @return The number of the blocks written, 0 if the type is not supported or the buffer is empty.
+ */
+int cinn_compute_tensor_stats_nvgpu(const cinn_buffer_t* buffer, double* partial, void* stream);
+
+/**
+ * Scale the grid along x of the kernels launched by cinn_call_cuda_kernel in the calling thread by num / den, rounded
+ * up, which launches only the leading blocks of the kernels whose blocks cover a batch-major output in order, such as
+ * running the rows of the actual batch of a kernel compiled for a larger one. Only the kernels of 1D grids are scaled,
+ * and the scale is cleared by setting den to 0.
+ */
+void SetLaunchGridScale(int num, int den);
+
+/**
+ * The argument pointers of cuLaunchKernel built from the pod arguments \p v_args: a buffer is passed by the address of
+ * its cinn_buffer_t::memory slot and a scalar by the address of its value, so the pointers stay valid as long as the
+ * pod arguments and their buffers, and are reused by all the launches on them.
+ */
+struct KernelLaunchArgs {
+  void* v_args{nullptr};
+  std::vector<void*> ptrs;
+};
+
+void BuildKernelLaunchArgs(void* v_args, int num_args, KernelLaunchArgs* launch_args);
+
+/**
+ * Let cinn_call_cuda_kernel in the calling thread launch the kernel on the pod arguments of \p launch_args with its
+ * prebuilt pointers, instead of building them on every launch. It is cleared by setting nullptr.
+ */
+void SetKernelLaunchArgs(KernelLaunchArgs* launch_args);
+
 /**
  * Call a CUDA compiled kernel.
  *
  * @param kernel_fn the compiled PTX kernel.
  * @param args an array of cinn_pod_value_ts(consists of scalars and buffers).
+ * @param shared_mem_bytes the bytes of the dynamic shared memory of the kernel.
  */
 void cinn_call_cuda_kernel(void* kernel_fn,
                            void* v_args,
@@ -81,8 +295,25 @@ void cinn_call_cuda_kernel(void* kernel_fn,
                            int block_x,
                            int block_y,
                            int block_z,
+                           int shared_mem_bytes,
                            void* stream);
 
+/**
+ * Call a CUDA compiled kernel by the cooperative launch, whose blocks are all resident on the device at the same time,
+ * so that they can synchronize by the grid-wide barriers. The arguments are the same as cinn_call_cuda_kernel.
+ */
+void cinn_call_cuda_cooperative_kernel(void* kernel_fn,
+                                       void* v_args,
+                                       int num_args,
+                                       int grid_x,
+                                       int grid_y,
+                                       int grid_z,
+                                       int block_x,
+                                       int block_y,
+                                       int block_z,
+                                       int shared_mem_bytes,
+                                       void* stream);
+
 void cinn_call_cublas(void* v_args,
                       int num_args,
                       bool trans_a,
@@ -100,6 +331,11 @@ void cinn_call_cublas(void* v_args,
                       int b4,
                       void* stream);
 
+/**
+ * Run a group of gemms with the same shape by one cublasGemmBatched call. The opside selects the layout of the args:
+ * 0 means A * [B0, B1, ...], 1 means [B0, B1, ...] * A, and 2 means [A0, A1, ...] * [B0, B1, ...] for the independent
+ * gemms, the outputs follow the inputs.
+ */
 void cinn_call_batched_cublas(void* v_args,
                               int num_args,
                               int opside,
@@ -118,6 +354,45 @@ void cinn_call_batched_cublas(void* v_args,
                               int b4,
                               void* stream);
 
+/**
+ * Compute C = alpha * op(A) * op(B) + bias by cublasLtMatmul, where A is [m, k], B is [k, n], C is [m, n] and bias is
+ * [n]. The epilogue selects what is fused after the gemm: 0 means none(the bias is ignored), 1 means adding the bias,
+ * 2 means adding the bias and then applying relu, 3 and 4 are 1 and 2 with a residual R of shape [m, n] added before
+ * the relu, which is given between the bias and C in the arguments.
+ */
+void cinn_call_cublaslt_matmul(void* v_args,
+                               int num_args,
+                               bool trans_a,
+                               bool trans_b,
+                               float alpha,
+                               int m,
+                               int n,
+                               int k,
+                               int epilogue,
+                               void* stream);
+
+/**
+ * Compute C = alpha * (scale_a * A) * (scale_b * B)^T by cublasLtMatmul on the fp8 tensor cores, where A is [m, k] and
+ * B is [n, k] of float8_e4m3 or float8_e5m2, scale_a and scale_b are float32 [1] and C is [m, n] of bfloat16, float16
+ * or float32. It requires CUDA 11.8 and a GPU of compute capability 8.9 or later.
+ */
+void cinn_call_cublaslt_fp8_matmul(void* v_args, int num_args, float alpha, int m, int n, int k, void* stream);
+
+/**
+ * Compute out = A * B by cuSPARSE, where A is the CSR matrix [m, k] given by the int32 crows of [m + 1], the int32 cols
+ * and the values of [nnz], B is the row-major dense [k, n] and out is [m, n].
+ */
+void cinn_call_cusparse_spmm(void* v_args, int num_args, int m, int n, int k, int nnz, void* stream);
+
+#ifdef CINN_WITH_CUSPARSELT
+/**
+ * Compute C = alpha * X * W^T by cuSPARSELt on the sparse tensor cores, where X is [m, k], W is the constant [n, k]
+ * weight of 2:4 sparsity along k and C is [m, n], all of float16 or bfloat16. The weight is checked and compressed on
+ * its first run, and the matmul of the weight not 2:4 sparse is computed by the dense cublas gemm.
+ */
+void cinn_call_cusparselt_matmul(void* v_args, int num_args, float alpha, int m, int n, int k, void* stream);
+#endif
+
 #ifdef CINN_WITH_CUDNN
 void cinn_gpu_cudnn_conv2d(const absl::flat_hash_map<std::string, int>& attr,
                            cinn_buffer_t* x,
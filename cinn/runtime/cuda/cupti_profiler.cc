@@ -0,0 +1,360 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cuda/cupti_profiler.h"
+
+#include <cuda.h>
+#include <cupti_profiler_target.h>
+#include <cupti_target.h>
+#include <glog/logging.h>
+#include <nvperf_cuda_host.h>
+#include <nvperf_host.h>
+#include <nvperf_target.h>
+
+#include <mutex>
+
+#include "cinn/backends/cuda_util.h"
+#include "cinn/utils/string.h"
+
+#define CUPTI_CALL(func)                                                 \
+  {                                                                      \
+    auto status = func;                                                  \
+    if (status != CUPTI_SUCCESS) {                                       \
+      const char* msg;                                                   \
+      cuptiGetResultString(status, &msg);                                \
+      LOG(FATAL) << "CUPTI Error: " #func " failed with error: " << msg; \
+    }                                                                    \
+  }
+
+#define NVPW_CALL(func)                                                    \
+  {                                                                        \
+    auto status = func;                                                    \
+    if (status != NVPA_STATUS_SUCCESS) {                                   \
+      LOG(FATAL) << "NVPW Error: " #func " failed with error: " << status; \
+    }                                                                      \
+  }
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+void InitializeProfiler() {
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    CUpti_Profiler_Initialize_Params init_params = {CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerInitialize(&init_params));
+    NVPW_InitializeHost_Params host_params = {NVPW_InitializeHost_Params_STRUCT_SIZE};
+    NVPW_CALL(NVPW_InitializeHost(&host_params));
+  });
+}
+
+// destroy the metrics context of NVPW on the scope exit
+struct MetricsContext {
+  explicit MetricsContext(const std::string& chip_name) {
+    NVPW_CUDA_MetricsContext_Create_Params params = {NVPW_CUDA_MetricsContext_Create_Params_STRUCT_SIZE};
+    params.pChipName = chip_name.c_str();
+    NVPW_CALL(NVPW_CUDA_MetricsContext_Create(&params));
+    ctx = params.pMetricsContext;
+  }
+  ~MetricsContext() {
+    NVPW_MetricsContext_Destroy_Params params = {NVPW_MetricsContext_Destroy_Params_STRUCT_SIZE};
+    params.pMetricsContext = ctx;
+    NVPW_MetricsContext_Destroy(&params);
+  }
+  NVPA_MetricsContext* ctx;
+};
+
+// the raw counters which the metrics are evaluated from
+std::vector<std::string> GetRawMetricNames(const std::string& chip_name, const std::vector<std::string>& metric_names) {
+  MetricsContext context(chip_name);
+  std::vector<std::string> raw_names;
+  for (auto& name : metric_names) {
+    NVPW_MetricsContext_GetMetricProperties_Begin_Params begin_params = {
+        NVPW_MetricsContext_GetMetricProperties_Begin_Params_STRUCT_SIZE};
+    begin_params.pMetricsContext = context.ctx;
+    begin_params.pMetricName     = name.c_str();
+    NVPW_CALL(NVPW_MetricsContext_GetMetricProperties_Begin(&begin_params));
+    for (const char** dep = begin_params.ppRawMetricDependencies; *dep; ++dep) {
+      raw_names.emplace_back(*dep);
+    }
+    NVPW_MetricsContext_GetMetricProperties_End_Params end_params = {
+        NVPW_MetricsContext_GetMetricProperties_End_Params_STRUCT_SIZE};
+    end_params.pMetricsContext = context.ctx;
+    NVPW_CALL(NVPW_MetricsContext_GetMetricProperties_End(&end_params));
+  }
+  return raw_names;
+}
+
+std::vector<NVPA_RawMetricRequest> GetRawMetricRequests(const std::vector<std::string>& raw_names) {
+  std::vector<NVPA_RawMetricRequest> requests;
+  for (auto& name : raw_names) {
+    NVPA_RawMetricRequest request = {NVPA_RAW_METRIC_REQUEST_STRUCT_SIZE};
+    request.pMetricName           = name.c_str();
+    request.isolated              = true;
+    request.keepInstances         = true;
+    requests.push_back(request);
+  }
+  return requests;
+}
+
+std::vector<uint8_t> GetCounterAvailabilityImage() {
+  CUcontext ctx;
+  CUDA_DRIVER_CALL(cuCtxGetCurrent(&ctx));
+  CUpti_Profiler_GetCounterAvailability_Params params = {CUpti_Profiler_GetCounterAvailability_Params_STRUCT_SIZE};
+  params.ctx = ctx;
+  CUPTI_CALL(cuptiProfilerGetCounterAvailability(&params));
+  std::vector<uint8_t> image(params.counterAvailabilityImageSize);
+  params.pCounterAvailabilityImage = image.data();
+  CUPTI_CALL(cuptiProfilerGetCounterAvailability(&params));
+  return image;
+}
+
+std::vector<uint8_t> CreateConfigImage(const std::string& chip_name,
+                                       const std::vector<NVPA_RawMetricRequest>& requests) {
+  NVPW_CUDA_RawMetricsConfig_Create_Params create_params = {NVPW_CUDA_RawMetricsConfig_Create_Params_STRUCT_SIZE};
+  create_params.activityKind = NVPA_ACTIVITY_KIND_PROFILER;
+  create_params.pChipName    = chip_name.c_str();
+  NVPW_CALL(NVPW_CUDA_RawMetricsConfig_Create(&create_params));
+  NVPA_RawMetricsConfig* config = create_params.pRawMetricsConfig;
+
+  // skip the counters which are not available on the device
+  auto availability = GetCounterAvailabilityImage();
+  NVPW_RawMetricsConfig_SetCounterAvailability_Params availability_params = {
+      NVPW_RawMetricsConfig_SetCounterAvailability_Params_STRUCT_SIZE};
+  availability_params.pRawMetricsConfig         = config;
+  availability_params.pCounterAvailabilityImage = availability.data();
+  NVPW_CALL(NVPW_RawMetricsConfig_SetCounterAvailability(&availability_params));
+
+  NVPW_RawMetricsConfig_BeginPassGroup_Params begin_params = {NVPW_RawMetricsConfig_BeginPassGroup_Params_STRUCT_SIZE};
+  begin_params.pRawMetricsConfig = config;
+  NVPW_CALL(NVPW_RawMetricsConfig_BeginPassGroup(&begin_params));
+  NVPW_RawMetricsConfig_AddMetrics_Params add_params = {NVPW_RawMetricsConfig_AddMetrics_Params_STRUCT_SIZE};
+  add_params.pRawMetricsConfig  = config;
+  add_params.pRawMetricRequests = requests.data();
+  add_params.numMetricRequests  = requests.size();
+  NVPW_CALL(NVPW_RawMetricsConfig_AddMetrics(&add_params));
+  NVPW_RawMetricsConfig_EndPassGroup_Params end_params = {NVPW_RawMetricsConfig_EndPassGroup_Params_STRUCT_SIZE};
+  end_params.pRawMetricsConfig = config;
+  NVPW_CALL(NVPW_RawMetricsConfig_EndPassGroup(&end_params));
+
+  NVPW_RawMetricsConfig_GenerateConfigImage_Params generate_params = {
+      NVPW_RawMetricsConfig_GenerateConfigImage_Params_STRUCT_SIZE};
+  generate_params.pRawMetricsConfig = config;
+  NVPW_CALL(NVPW_RawMetricsConfig_GenerateConfigImage(&generate_params));
+  NVPW_RawMetricsConfig_GetConfigImage_Params get_params = {NVPW_RawMetricsConfig_GetConfigImage_Params_STRUCT_SIZE};
+  get_params.pRawMetricsConfig = config;
+  get_params.bytesAllocated    = 0;
+  get_params.pBuffer           = nullptr;
+  NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&get_params));
+  std::vector<uint8_t> image(get_params.bytesCopied);
+  get_params.bytesAllocated = image.size();
+  get_params.pBuffer        = image.data();
+  NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&get_params));
+
+  NVPW_RawMetricsConfig_Destroy_Params destroy_params = {NVPW_RawMetricsConfig_Destroy_Params_STRUCT_SIZE};
+  destroy_params.pRawMetricsConfig = config;
+  NVPW_CALL(NVPW_RawMetricsConfig_Destroy(&destroy_params));
+  return image;
+}
+
+std::vector<uint8_t> CreateCounterDataPrefix(const std::string& chip_name,
+                                             const std::vector<NVPA_RawMetricRequest>& requests) {
+  NVPW_CounterDataBuilder_Create_Params create_params = {NVPW_CounterDataBuilder_Create_Params_STRUCT_SIZE};
+  create_params.pChipName = chip_name.c_str();
+  NVPW_CALL(NVPW_CounterDataBuilder_Create(&create_params));
+  NVPA_CounterDataBuilder* builder = create_params.pCounterDataBuilder;
+
+  NVPW_CounterDataBuilder_AddMetrics_Params add_params = {NVPW_CounterDataBuilder_AddMetrics_Params_STRUCT_SIZE};
+  add_params.pCounterDataBuilder = builder;
+  add_params.pRawMetricRequests  = requests.data();
+  add_params.numMetricRequests   = requests.size();
+  NVPW_CALL(NVPW_CounterDataBuilder_AddMetrics(&add_params));
+
+  NVPW_CounterDataBuilder_GetCounterDataPrefix_Params get_params = {
+      NVPW_CounterDataBuilder_GetCounterDataPrefix_Params_STRUCT_SIZE};
+  get_params.pCounterDataBuilder = builder;
+  get_params.bytesAllocated      = 0;
+  get_params.pBuffer             = nullptr;
+  NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&get_params));
+  std::vector<uint8_t> prefix(get_params.bytesCopied);
+  get_params.bytesAllocated = prefix.size();
+  get_params.pBuffer        = prefix.data();
+  NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&get_params));
+
+  NVPW_CounterDataBuilder_Destroy_Params destroy_params = {NVPW_CounterDataBuilder_Destroy_Params_STRUCT_SIZE};
+  destroy_params.pCounterDataBuilder = builder;
+  NVPW_CALL(NVPW_CounterDataBuilder_Destroy(&destroy_params));
+  return prefix;
+}
+
+}  // namespace
+
+CuptiRangeProfiler::CuptiRangeProfiler(const std::vector<std::string>& metric_names, int max_kernels)
+    : metric_names_(metric_names), max_kernels_(max_kernels) {
+  CHECK(!metric_names_.empty()) << "No metric is given to the CUPTI profiler";
+  CHECK_GT(max_kernels_, 0);
+  InitializeProfiler();
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  // make sure the primary context is created, which the counter availability is queried on
+  CUDA_CALL(cudaFree(nullptr));
+  CUpti_Device_GetChipName_Params chip_params = {CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+  chip_params.deviceIndex = device_id;
+  CUPTI_CALL(cuptiDeviceGetChipName(&chip_params));
+  chip_name_ = chip_params.pChipName;
+
+  // the requests refer to the raw names, which must outlive them
+  auto raw_names       = GetRawMetricNames(chip_name_, metric_names_);
+  auto requests        = GetRawMetricRequests(raw_names);
+  config_image_        = CreateConfigImage(chip_name_, requests);
+  counter_data_prefix_ = CreateCounterDataPrefix(chip_name_, requests);
+  VLOG(3) << "CUPTI profiler on chip " << chip_name_ << " collects " << raw_names.size() << " raw counters for "
+          << metric_names_.size() << " metrics";
+}
+
+CuptiRangeProfiler::~CuptiRangeProfiler() {
+  if (in_session_) {
+    LOG(WARNING) << "The CUPTI profiler is destroyed in a session, the counters are dropped";
+    End();
+  }
+}
+
+void CuptiRangeProfiler::InitCounterDataImage() {
+  CUpti_Profiler_CounterDataImageOptions options;
+  options.pCounterDataPrefix    = counter_data_prefix_.data();
+  options.counterDataPrefixSize = counter_data_prefix_.size();
+  options.maxNumRanges          = max_kernels_;
+  options.maxNumRangeTreeNodes  = max_kernels_;
+  options.maxRangeNameLength    = 256;
+
+  CUpti_Profiler_CounterDataImage_CalculateSize_Params size_params = {
+      CUpti_Profiler_CounterDataImage_CalculateSize_Params_STRUCT_SIZE};
+  size_params.pOptions                      = &options;
+  size_params.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+  CUPTI_CALL(cuptiProfilerCounterDataImageCalculateSize(&size_params));
+
+  counter_data_image_.assign(size_params.counterDataImageSize, 0);
+  CUpti_Profiler_CounterDataImage_Initialize_Params init_params = {
+      CUpti_Profiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+  init_params.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+  init_params.pOptions                      = &options;
+  init_params.counterDataImageSize          = counter_data_image_.size();
+  init_params.pCounterDataImage             = counter_data_image_.data();
+  CUPTI_CALL(cuptiProfilerCounterDataImageInitialize(&init_params));
+
+  CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params scratch_size_params = {
+      CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params_STRUCT_SIZE};
+  scratch_size_params.counterDataImageSize = counter_data_image_.size();
+  scratch_size_params.pCounterDataImage    = counter_data_image_.data();
+  CUPTI_CALL(cuptiProfilerCounterDataImageCalculateScratchBufferSize(&scratch_size_params));
+
+  counter_data_scratch_.assign(scratch_size_params.counterDataScratchBufferSize, 0);
+  CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params scratch_params = {
+      CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params_STRUCT_SIZE};
+  scratch_params.counterDataImageSize         = counter_data_image_.size();
+  scratch_params.pCounterDataImage            = counter_data_image_.data();
+  scratch_params.counterDataScratchBufferSize = counter_data_scratch_.size();
+  scratch_params.pCounterDataScratchBuffer    = counter_data_scratch_.data();
+  CUPTI_CALL(cuptiProfilerCounterDataImageInitializeScratchBuffer(&scratch_params));
+}
+
+void CuptiRangeProfiler::Begin() {
+  CHECK(!in_session_) << "The CUPTI profiler is already in a session";
+  // the counter data of the last session is dropped
+  InitCounterDataImage();
+
+  CUpti_Profiler_BeginSession_Params session_params = {CUpti_Profiler_BeginSession_Params_STRUCT_SIZE};
+  session_params.ctx                          = nullptr;
+  session_params.counterDataImageSize         = counter_data_image_.size();
+  session_params.pCounterDataImage            = counter_data_image_.data();
+  session_params.counterDataScratchBufferSize = counter_data_scratch_.size();
+  session_params.pCounterDataScratchBuffer    = counter_data_scratch_.data();
+  // every kernel is a range, and is replayed in place until all its counters are collected
+  session_params.range              = CUPTI_AutoRange;
+  session_params.replayMode         = CUPTI_KernelReplay;
+  session_params.maxRangesPerPass   = max_kernels_;
+  session_params.maxLaunchesPerPass = max_kernels_;
+  CUPTI_CALL(cuptiProfilerBeginSession(&session_params));
+
+  CUpti_Profiler_SetConfig_Params config_params = {CUpti_Profiler_SetConfig_Params_STRUCT_SIZE};
+  config_params.pConfig    = config_image_.data();
+  config_params.configSize = config_image_.size();
+  config_params.passIndex  = 0;
+  CUPTI_CALL(cuptiProfilerSetConfig(&config_params));
+
+  CUpti_Profiler_EnableProfiling_Params enable_params = {CUpti_Profiler_EnableProfiling_Params_STRUCT_SIZE};
+  CUPTI_CALL(cuptiProfilerEnableProfiling(&enable_params));
+  in_session_ = true;
+}
+
+std::vector<KernelMetrics> CuptiRangeProfiler::End() {
+  CHECK(in_session_) << "The CUPTI profiler is not in a session, please call Begin first";
+  in_session_ = false;
+  CUpti_Profiler_DisableProfiling_Params disable_params = {CUpti_Profiler_DisableProfiling_Params_STRUCT_SIZE};
+  CUPTI_CALL(cuptiProfilerDisableProfiling(&disable_params));
+  CUpti_Profiler_FlushCounterData_Params flush_params = {CUpti_Profiler_FlushCounterData_Params_STRUCT_SIZE};
+  CUPTI_CALL(cuptiProfilerFlushCounterData(&flush_params));
+  CUpti_Profiler_UnsetConfig_Params unset_params = {CUpti_Profiler_UnsetConfig_Params_STRUCT_SIZE};
+  CUPTI_CALL(cuptiProfilerUnsetConfig(&unset_params));
+  CUpti_Profiler_EndSession_Params end_params = {CUpti_Profiler_EndSession_Params_STRUCT_SIZE};
+  CUPTI_CALL(cuptiProfilerEndSession(&end_params));
+
+  MetricsContext context(chip_name_);
+  NVPW_CounterData_GetNumRanges_Params ranges_params = {NVPW_CounterData_GetNumRanges_Params_STRUCT_SIZE};
+  ranges_params.pCounterDataImage = counter_data_image_.data();
+  NVPW_CALL(NVPW_CounterData_GetNumRanges(&ranges_params));
+
+  std::vector<const char*> metric_names;
+  for (auto& name : metric_names_) {
+    metric_names.push_back(name.c_str());
+  }
+  std::vector<KernelMetrics> results;
+  for (size_t range = 0; range < ranges_params.numRanges; ++range) {
+    NVPW_Profiler_CounterData_GetRangeDescriptions_Params desc_params = {
+        NVPW_Profiler_CounterData_GetRangeDescriptions_Params_STRUCT_SIZE};
+    desc_params.pCounterDataImage = counter_data_image_.data();
+    desc_params.rangeIndex        = range;
+    NVPW_CALL(NVPW_Profiler_CounterData_GetRangeDescriptions(&desc_params));
+    std::vector<const char*> descriptions(desc_params.numDescriptions);
+    desc_params.ppDescriptions = descriptions.data();
+    NVPW_CALL(NVPW_Profiler_CounterData_GetRangeDescriptions(&desc_params));
+
+    KernelMetrics metrics;
+    metrics.kernel_name = utils::Join(std::vector<std::string>(descriptions.begin(), descriptions.end()), "/");
+    metrics.values.resize(metric_names.size());
+
+    NVPW_MetricsContext_SetCounterData_Params counter_params = {NVPW_MetricsContext_SetCounterData_Params_STRUCT_SIZE};
+    counter_params.pMetricsContext   = context.ctx;
+    counter_params.pCounterDataImage = counter_data_image_.data();
+    counter_params.isolated          = true;
+    counter_params.rangeIndex        = range;
+    NVPW_CALL(NVPW_MetricsContext_SetCounterData(&counter_params));
+    NVPW_MetricsContext_EvaluateToGpuValues_Params eval_params = {
+        NVPW_MetricsContext_EvaluateToGpuValues_Params_STRUCT_SIZE};
+    eval_params.pMetricsContext = context.ctx;
+    eval_params.numMetrics      = metric_names.size();
+    eval_params.ppMetricNames   = metric_names.data();
+    eval_params.pMetricValues   = metrics.values.data();
+    NVPW_CALL(NVPW_MetricsContext_EvaluateToGpuValues(&eval_params));
+    results.emplace_back(std::move(metrics));
+  }
+  return results;
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+struct KernelMetrics {
+  // the name of the kernel given by CUPTI
+  std::string kernel_name;
+  // in the order of the metric names of the profiler
+  std::vector<double> values;
+};
+
+/**
+ * CuptiRangeProfiler collects the hardware counters of the kernels launched between Begin and End in the current CUDA
+ * context by the CUPTI range profiling. Each kernel is a range, which is replayed by CUPTI until all the counters of
+ * the metrics are collected, and the memory touched by the kernel is restored between the replays.
+ *
+ * The kernels launched beyond \p max_kernels in a session are not collected.
+ */
+class CuptiRangeProfiler {
+ public:
+  CuptiRangeProfiler(const std::vector<std::string>& metric_names, int max_kernels = 64);
+  ~CuptiRangeProfiler();
+
+  void Begin();
+  //! Wait for the kernels and evaluate the metrics of each one in the order of launching.
+  std::vector<KernelMetrics> End();
+
+  const std::vector<std::string>& metric_names() const { return metric_names_; }
+
+ private:
+  void InitCounterDataImage();
+
+  std::vector<std::string> metric_names_;
+  int max_kernels_;
+  std::string chip_name_;
+  std::vector<uint8_t> config_image_;
+  std::vector<uint8_t> counter_data_prefix_;
+  std::vector<uint8_t> counter_data_image_;
+  std::vector<uint8_t> counter_data_scratch_;
+  bool in_session_{false};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CuptiRangeProfiler);
+};
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
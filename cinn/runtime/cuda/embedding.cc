@@ -0,0 +1,381 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kEmbeddingBlockSize = 256;
+constexpr int kEmbeddingMaxBlocks = 65535;
+constexpr int kEmbeddingVecBytes  = 16;
+
+// the number of the consecutive updates added by a thread of the atomic scatter_add
+constexpr int kScatterAddAtomicChunk = 32;
+
+// Each warp copies whole rows with the VEC-wide vectorized loads and stores.
+const char* kEmbeddingCommonSource = R"(
+struct __align__(VEC * sizeof(DTYPE)) cinn_embedding_vec_t {
+  DTYPE v[VEC];
+};
+
+#define WARP_ID (threadIdx.x >> 5)
+#define LANE_ID (threadIdx.x & 31)
+#define NUM_WARPS (static_cast<long long>(gridDim.x) * (blockDim.x >> 5))
+)";
+
+// The rows of the ids equal to the padding index or out of the table are filled with zero.
+const char* kLookupTableSource = R"(
+extern "C" __global__ void cinn_lookup_table_kernel(const DTYPE* __restrict__ table,
+                                                    const IDX_T* __restrict__ ids,
+                                                    long long num_ids,
+                                                    int num_rows,
+                                                    int dim,
+                                                    long long padding_idx,
+                                                    DTYPE* __restrict__ out) {
+  const int num_vecs = dim / VEC;
+  for (long long row = blockIdx.x * (blockDim.x >> 5) + WARP_ID; row < num_ids; row += NUM_WARPS) {
+    long long id = static_cast<long long>(ids[row]);
+    cinn_embedding_vec_t* dst = reinterpret_cast<cinn_embedding_vec_t*>(out + row * dim);
+    if (id == padding_idx || id < 0 || id >= num_rows) {
+      cinn_embedding_vec_t zero;
+      for (int v = 0; v < VEC; ++v) zero.v[v] = static_cast<DTYPE>(0.0f);
+      for (int i = LANE_ID; i < num_vecs; i += 32) dst[i] = zero;
+    } else {
+      const cinn_embedding_vec_t* src = reinterpret_cast<const cinn_embedding_vec_t*>(table + id * dim);
+      for (int i = LANE_ID; i < num_vecs; i += 32) dst[i] = src[i];
+    }
+  }
+}
+)";
+
+// The index is sorted stably beforehand, so each warp finds the updates of its output row by the binary search and
+// sums them in the order of the index, without atomics and with the deterministic results.
+const char* kScatterAddSource = R"(
+__device__ __forceinline__ int cinn_lower_bound(const int* sorted, int size, int value) {
+  int low = 0, high = size;
+  while (low < high) {
+    int mid = (low + high) >> 1;
+    if (sorted[mid] < value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+extern "C" __global__ void cinn_scatter_add_kernel(const DTYPE* __restrict__ input,
+                                                   const DTYPE* __restrict__ updates,
+                                                   const int* __restrict__ sorted_index,
+                                                   const int* __restrict__ positions,
+                                                   int outer,
+                                                   int num_rows,
+                                                   int num_index,
+                                                   int inner,
+                                                   DTYPE* __restrict__ out) {
+  const int num_vecs = inner / VEC;
+  const long long total_rows = static_cast<long long>(outer) * num_rows;
+  for (long long row = blockIdx.x * (blockDim.x >> 5) + WARP_ID; row < total_rows; row += NUM_WARPS) {
+    const int o     = row / num_rows;
+    const int j     = row % num_rows;
+    const int start = cinn_lower_bound(sorted_index, num_index, j);
+    const int end   = cinn_lower_bound(sorted_index, num_index, j + 1);
+    const cinn_embedding_vec_t* src = reinterpret_cast<const cinn_embedding_vec_t*>(input + row * inner);
+    cinn_embedding_vec_t* dst = reinterpret_cast<cinn_embedding_vec_t*>(out + row * inner);
+    for (int i = LANE_ID; i < num_vecs; i += 32) {
+      cinn_embedding_vec_t value = src[i];
+      ACC_T acc[VEC];
+      for (int v = 0; v < VEC; ++v) acc[v] = static_cast<ACC_T>(value.v[v]);
+      for (int p = start; p < end; ++p) {
+        long long update_row = static_cast<long long>(o) * num_index + positions[p];
+        cinn_embedding_vec_t update = reinterpret_cast<const cinn_embedding_vec_t*>(updates + update_row * inner)[i];
+        for (int v = 0; v < VEC; ++v) acc[v] += static_cast<ACC_T>(update.v[v]);
+      }
+      for (int v = 0; v < VEC; ++v) value.v[v] = static_cast<DTYPE>(acc[v]);
+      dst[i] = value;
+    }
+  }
+}
+)";
+
+// Each thread adds a column of a chunk of the consecutive updates, and accumulates the updates of the same index in
+// registers, so a run of the same index, such as the sorted edges of a graph, takes one atomic instead of one for
+// each update. The results depend on the order of the atomics, so they are not deterministic for the floats.
+const char* kScatterAddAtomicSource = R"(
+extern "C" __global__ void cinn_scatter_add_atomic_kernel(const DTYPE* __restrict__ updates,
+                                                          const int* __restrict__ index,
+                                                          int outer,
+                                                          int num_rows,
+                                                          int num_index,
+                                                          int inner,
+                                                          DTYPE* __restrict__ out) {
+  const long long num_chunks = (num_index + CHUNK - 1) / CHUNK;
+  const long long total      = static_cast<long long>(outer) * num_chunks * inner;
+  const long long stride     = static_cast<long long>(gridDim.x) * blockDim.x;
+  for (long long i = static_cast<long long>(blockIdx.x) * blockDim.x + threadIdx.x; i < total; i += stride) {
+    const int col         = i % inner;
+    const long long chunk = i / inner;
+    const int o           = chunk / num_chunks;
+    const int begin       = (chunk % num_chunks) * CHUNK;
+    const int end         = min(begin + CHUNK, num_index);
+    int row   = -1;
+    ACC_T acc = 0;
+    for (int p = begin; p < end; ++p) {
+      const int j = index[p];
+      if (j < 0 || j >= num_rows) continue;
+      if (j != row) {
+        if (row >= 0) atomicAdd(out + (static_cast<long long>(o) * num_rows + row) * inner + col, acc);
+        row = j;
+        acc = 0;
+      }
+      acc += updates[(static_cast<long long>(o) * num_index + p) * inner + col];
+    }
+    if (row >= 0) atomicAdd(out + (static_cast<long long>(o) * num_rows + row) * inner + col, acc);
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 64) {
+    return "double";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return "int";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return "long long";
+  }
+  LOG(FATAL) << "The embedding kernels don't support the type code " << type.code << " with "
+             << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+// The widest vector up to 16 bytes dividing the row, the rows are aligned since the buffers are.
+int GetVectorSize(const cinn_type_t& type, int row_size) {
+  int vec = std::max(kEmbeddingVecBytes / std::max<int>(type.bytes(), 1), 1);
+  while (vec > 1 && row_size % vec != 0) {
+    vec >>= 1;
+  }
+  return vec;
+}
+
+// The kernels are compiled by NVRTC once for each dtype and vector size.
+CUDAModule* GetEmbeddingModule(const std::string& kernel,
+                               const cinn_type_t& type,
+                               const std::string& index_dtype,
+                               int vec) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto dtype = GetDTypeName(type);
+  auto key   = kernel + "_" + dtype + "_" + index_dtype + "_" + std::to_string(vec);
+  auto it    = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  bool is_half       = type.bits == 16;
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define ACC_T " + (is_half ? std::string("float") : dtype) + "\n";
+  source += "#define IDX_T " + index_dtype + "\n";
+  source += "#define VEC " + std::to_string(vec) + "\n";
+  source += "#define CHUNK " + std::to_string(kScatterAddAtomicChunk) + "\n";
+  source += kEmbeddingCommonSource;
+  if (kernel == "lookup_table") {
+    source += kLookupTableSource;
+  } else if (kernel == "scatter_add") {
+    source += kScatterAddSource;
+  } else {
+    source += kScatterAddAtomicSource;
+  }
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the " << kernel << " kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+dim3 GetWarpPerRowGrid(long long num_rows) {
+  long long warps_per_block = kEmbeddingBlockSize / 32;
+  return dim3(std::max<long long>(std::min<long long>((num_rows + warps_per_block - 1) / warps_per_block,
+                                                      kEmbeddingMaxBlocks),
+                                  1));
+}
+
+// The atomicAdd of the generated code supports these types on all the supported archs.
+bool SupportsAtomicAdd(const cinn_type_t& type) {
+  return (type.code == cinn_type_code_t::cinn_type_float && (type.bits == 32 || type.bits == 64)) ||
+         (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32);
+}
+
+void ScatterAddByAtomics(cinn_buffer_t* input,
+                         cinn_buffer_t* updates,
+                         cinn_buffer_t* index,
+                         cinn_buffer_t* out,
+                         int outer,
+                         int num_rows,
+                         int num_index,
+                         int inner,
+                         cudaStream_t stream) {
+  if (out->memory != input->memory) {
+    size_t nbytes = static_cast<size_t>(outer) * num_rows * inner * input->type.bytes();
+    CUDA_CALL(cudaMemcpyAsync(out->memory, input->memory, nbytes, cudaMemcpyDeviceToDevice, stream));
+  }
+  if (num_index == 0) {
+    return;
+  }
+  auto* module = GetEmbeddingModule("scatter_add_atomic", input->type, "int", 1);
+
+  void* updates_ptr   = updates->memory;
+  void* index_ptr     = index->memory;
+  void* out_ptr       = out->memory;
+  void* kernel_args[] = {&updates_ptr, &index_ptr, &outer, &num_rows, &num_index, &inner, &out_ptr};
+
+  long long num_chunks = (num_index + kScatterAddAtomicChunk - 1) / kScatterAddAtomicChunk;
+  long long total      = static_cast<long long>(outer) * num_chunks * inner;
+  dim3 grid(std::max<long long>(
+      std::min<long long>((total + kEmbeddingBlockSize - 1) / kEmbeddingBlockSize, kEmbeddingMaxBlocks), 1));
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_scatter_add_atomic_kernel",
+                       grid,
+                       dim3(kEmbeddingBlockSize),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+}  // namespace
+
+void cinn_call_lookup_table_nvgpu(
+    void* v_args, int num_args, int num_ids, int num_rows, int dim, int64_t padding_idx, void* stream) {
+  CHECK_EQ(num_args, 3) << "The lookup_table takes the table, the ids and the output.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* table   = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* ids     = args[1].operator cinn_buffer_t*();
+  cinn_buffer_t* out     = args[2].operator cinn_buffer_t*();
+  VLOG(4) << "lookup_table: num_ids=" << num_ids << ", num_rows=" << num_rows << ", dim=" << dim
+          << ", padding_idx=" << padding_idx;
+  if (num_ids == 0 || dim == 0) {
+    return;
+  }
+  CHECK(ids->type.code == cinn_type_code_t::cinn_type_int && (ids->type.bits == 32 || ids->type.bits == 64))
+      << "The ids of lookup_table should be int32 or int64";
+
+  int vec      = GetVectorSize(table->type, dim);
+  auto* module = GetEmbeddingModule("lookup_table", table->type, ids->type.bits == 64 ? "long long" : "int", vec);
+
+  void* table_ptr     = table->memory;
+  void* ids_ptr       = ids->memory;
+  void* out_ptr       = out->memory;
+  long long ids_num   = num_ids;
+  long long padding   = padding_idx;
+  void* kernel_args[] = {&table_ptr, &ids_ptr, &ids_num, &num_rows, &dim, &padding, &out_ptr};
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_lookup_table_kernel",
+                       GetWarpPerRowGrid(num_ids),
+                       dim3(kEmbeddingBlockSize),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+void cinn_call_scatter_add_nvgpu(void* v_args,
+                                 int num_args,
+                                 int outer,
+                                 int num_rows,
+                                 int num_index,
+                                 int inner,
+                                 bool deterministic,
+                                 void* stream) {
+  CHECK_EQ(num_args, 4) << "The scatter_add takes the input, the updates, the index and the output.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* input   = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* updates = args[1].operator cinn_buffer_t*();
+  cinn_buffer_t* index   = args[2].operator cinn_buffer_t*();
+  cinn_buffer_t* out     = args[3].operator cinn_buffer_t*();
+  VLOG(4) << "scatter_add: outer=" << outer << ", num_rows=" << num_rows << ", num_index=" << num_index
+          << ", inner=" << inner << ", deterministic=" << deterministic;
+  if (outer == 0 || num_rows == 0 || inner == 0) {
+    return;
+  }
+  CHECK(index->type.code == cinn_type_code_t::cinn_type_int && index->type.bits == 32)
+      << "The index of scatter_add should be int32";
+
+  auto cuda_stream = static_cast<cudaStream_t>(stream);
+  if (!deterministic && SupportsAtomicAdd(input->type)) {
+    ScatterAddByAtomics(input, updates, index, out, outer, num_rows, num_index, inner, cuda_stream);
+    return;
+  }
+  void* sorted_index;
+  void* positions;
+  CUDA_CALL(cudaMallocAsync(&sorted_index, std::max(num_index, 1) * sizeof(int), cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&positions, std::max(num_index, 1) * sizeof(int), cuda_stream));
+  SortSegments(index, 1, num_index, 1, num_index, false, sorted_index, positions, nullptr, nullptr, cuda_stream);
+
+  int vec      = GetVectorSize(input->type, inner);
+  auto* module = GetEmbeddingModule("scatter_add", input->type, "int", vec);
+
+  void* input_ptr     = input->memory;
+  void* updates_ptr   = updates->memory;
+  void* out_ptr       = out->memory;
+  void* kernel_args[] = {
+      &input_ptr, &updates_ptr, &sorted_index, &positions, &outer, &num_rows, &num_index, &inner, &out_ptr};
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_scatter_add_kernel",
+                       GetWarpPerRowGrid(static_cast<long long>(outer) * num_rows),
+                       dim3(kEmbeddingBlockSize),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+
+  CUDA_CALL(cudaFreeAsync(sorted_index, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(positions, cuda_stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,261 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kFlashAttentionBlockM     = 64;
+constexpr int kFlashAttentionBlockN     = 32;
+constexpr int kFlashAttentionMaxHeadDim = 128;
+
+// Each thread owns a query row and keeps its output in registers, the keys and the values are staged through the
+// shared memory tile by tile, and the softmax is computed online, so the S x S scores are never materialized. The
+// tiles of the largest head size take 32KB of the static shared memory.
+const char* kFlashAttentionSource = R"(
+#define NEG_INF __int_as_float(0xff800000)
+
+extern "C" __global__ void __launch_bounds__(BLOCK_M) cinn_flash_attention_kernel(const DTYPE* __restrict__ q,
+                                                                                  const DTYPE* __restrict__ k,
+                                                                                  const DTYPE* __restrict__ v,
+                                                                                  const DTYPE* __restrict__ mask,
+                                                                                  DTYPE* __restrict__ out,
+                                                                                  int num_heads,
+                                                                                  int seq_q,
+                                                                                  int seq_k,
+                                                                                  int mask_batch_stride,
+                                                                                  int mask_head_stride,
+                                                                                  int mask_row_stride,
+                                                                                  float scale,
+                                                                                  int causal) {
+  __shared__ float k_tile[BLOCK_N][HEAD_DIM];
+  __shared__ float v_tile[BLOCK_N][VALUE_DIM];
+
+  const int batch_head = blockIdx.y;
+  const int row        = blockIdx.x * BLOCK_M + threadIdx.x;
+  const bool valid     = row < seq_q;
+  const DTYPE* k_ptr   = k + static_cast<long long>(batch_head) * seq_k * HEAD_DIM;
+  const DTYPE* v_ptr   = v + static_cast<long long>(batch_head) * seq_k * VALUE_DIM;
+  const DTYPE* m_ptr   = nullptr;
+  if (mask) {
+    m_ptr = mask + static_cast<long long>(batch_head / num_heads) * mask_batch_stride +
+            static_cast<long long>(batch_head % num_heads) * mask_head_stride +
+            static_cast<long long>(row) * mask_row_stride;
+  }
+
+  float q_reg[HEAD_DIM];
+  float acc[VALUE_DIM];
+#pragma unroll
+  for (int d = 0; d < HEAD_DIM; ++d) {
+    q_reg[d] = valid ? static_cast<float>(q[(static_cast<long long>(batch_head) * seq_q + row) * HEAD_DIM + d]) * scale
+                     : 0.f;
+  }
+#pragma unroll
+  for (int d = 0; d < VALUE_DIM; ++d) {
+    acc[d] = 0.f;
+  }
+  float row_max = NEG_INF;
+  float row_sum = 0.f;
+
+  // the causal mask is aligned to the last key, the rows of the block see no key after block_end
+  const int key_end   = causal ? min(seq_k, row + seq_k - seq_q + 1) : seq_k;
+  const int block_end = causal ? min(seq_k, min(seq_q, (blockIdx.x + 1) * BLOCK_M) + seq_k - seq_q) : seq_k;
+  for (int start = 0; start < block_end; start += BLOCK_N) {
+    __syncthreads();
+    for (int idx = threadIdx.x; idx < BLOCK_N * HEAD_DIM; idx += BLOCK_M) {
+      int n        = idx / HEAD_DIM;
+      int d        = idx % HEAD_DIM;
+      k_tile[n][d] = start + n < seq_k ? static_cast<float>(k_ptr[(start + n) * HEAD_DIM + d]) : 0.f;
+    }
+    for (int idx = threadIdx.x; idx < BLOCK_N * VALUE_DIM; idx += BLOCK_M) {
+      int n        = idx / VALUE_DIM;
+      int d        = idx % VALUE_DIM;
+      v_tile[n][d] = start + n < seq_k ? static_cast<float>(v_ptr[(start + n) * VALUE_DIM + d]) : 0.f;
+    }
+    __syncthreads();
+
+    float scores[BLOCK_N];
+    float tile_max = NEG_INF;
+#pragma unroll
+    for (int n = 0; n < BLOCK_N; ++n) {
+      int key = start + n;
+      float s = NEG_INF;
+      if (valid && key < key_end) {
+        s = 0.f;
+#pragma unroll
+        for (int d = 0; d < HEAD_DIM; ++d) {
+          s += q_reg[d] * k_tile[n][d];
+        }
+        if (m_ptr) {
+          s += static_cast<float>(m_ptr[key]);
+        }
+      }
+      scores[n] = s;
+      tile_max  = fmaxf(tile_max, s);
+    }
+    float new_max = fmaxf(row_max, tile_max);
+    if (new_max == NEG_INF) {
+      continue;
+    }
+
+    float correction = expf(row_max - new_max);
+    row_sum *= correction;
+#pragma unroll
+    for (int d = 0; d < VALUE_DIM; ++d) {
+      acc[d] *= correction;
+    }
+#pragma unroll
+    for (int n = 0; n < BLOCK_N; ++n) {
+      float p = expf(scores[n] - new_max);
+      row_sum += p;
+#pragma unroll
+      for (int d = 0; d < VALUE_DIM; ++d) {
+        acc[d] += p * v_tile[n][d];
+      }
+    }
+    row_max = new_max;
+  }
+
+  if (valid) {
+    float inv_sum = row_sum > 0.f ? 1.f / row_sum : 0.f;
+    DTYPE* o_ptr  = out + (static_cast<long long>(batch_head) * seq_q + row) * VALUE_DIM;
+#pragma unroll
+    for (int d = 0; d < VALUE_DIM; ++d) {
+      o_ptr[d] = static_cast<DTYPE>(acc[d] * inv_sum);
+    }
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  }
+  LOG(FATAL) << "The flash attention only supports float32, float16 and bfloat16, but got type code " << type.code
+             << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+// The kernels are compiled by NVRTC once for each dtype and head size.
+CUDAModule* GetFlashAttentionModule(const std::string& dtype, int head_dim, int value_dim) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto key = dtype + "_" + std::to_string(head_dim) + "_" + std::to_string(value_dim);
+  auto it  = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define HEAD_DIM " + std::to_string(head_dim) + "\n";
+  source += "#define VALUE_DIM " + std::to_string(value_dim) + "\n";
+  source += "#define BLOCK_M " + std::to_string(kFlashAttentionBlockM) + "\n";
+  source += "#define BLOCK_N " + std::to_string(kFlashAttentionBlockN) + "\n";
+  source += kFlashAttentionSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the flash attention kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+}  // namespace
+
+void cinn_call_flash_attention_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_heads,
+                                     int seq_q,
+                                     int seq_k,
+                                     int head_dim,
+                                     int value_dim,
+                                     int mask_batch_stride,
+                                     int mask_head_stride,
+                                     int mask_row_stride,
+                                     float scale,
+                                     bool causal,
+                                     void* stream) {
+  CHECK(num_args == 4 || num_args == 5) << "The flash attention takes q, k, v, an optional mask and the output.";
+  CHECK_LE(head_dim, kFlashAttentionMaxHeadDim) << "The head size of the flash attention is too large";
+  CHECK_LE(value_dim, kFlashAttentionMaxHeadDim) << "The head size of the flash attention is too large";
+
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* q       = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* k       = args[1].operator cinn_buffer_t*();
+  cinn_buffer_t* v       = args[2].operator cinn_buffer_t*();
+  cinn_buffer_t* mask    = num_args == 5 ? args[3].operator cinn_buffer_t*() : nullptr;
+  cinn_buffer_t* out     = args[num_args - 1].operator cinn_buffer_t*();
+
+  VLOG(4) << "flash attention: batch_size=" << batch_size << ", num_heads=" << num_heads << ", seq_q=" << seq_q
+          << ", seq_k=" << seq_k << ", head_dim=" << head_dim << ", value_dim=" << value_dim
+          << ", with_mask=" << (mask != nullptr) << ", scale=" << scale << ", causal=" << causal;
+
+  auto* module = GetFlashAttentionModule(GetDTypeName(q->type), head_dim, value_dim);
+
+  void* q_ptr    = q->memory;
+  void* k_ptr    = k->memory;
+  void* v_ptr    = v->memory;
+  void* mask_ptr = mask ? mask->memory : nullptr;
+  void* out_ptr  = out->memory;
+  int is_causal  = causal;
+  void* kernel_args[] = {&q_ptr,
+                         &k_ptr,
+                         &v_ptr,
+                         &mask_ptr,
+                         &out_ptr,
+                         &num_heads,
+                         &seq_q,
+                         &seq_k,
+                         &mask_batch_stride,
+                         &mask_head_stride,
+                         &mask_row_stride,
+                         &scale,
+                         &is_causal};
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  dim3 grid((seq_q + kFlashAttentionBlockM - 1) / kFlashAttentionBlockM, batch_size * num_heads);
+  dim3 block(kFlashAttentionBlockM);
+  module->LaunchKernel(
+      device_id, "cinn_flash_attention_kernel", grid, block, kernel_args, 0, static_cast<CUstream>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,323 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef CINN_WITH_NCCL
+#include "cinn/runtime/cuda/nccl_util.h"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include "cinn/backends/cuda_util.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+NcclCommContext& NcclCommContext::Global() {
+  static NcclCommContext context;
+  return context;
+}
+
+void NcclCommContext::InitAll(int ring_id, const std::vector<int>& device_ids) {
+  CHECK(!device_ids.empty()) << "No device to create the communicators of ring " << ring_id;
+  std::vector<ncclComm_t> comms(device_ids.size());
+  NCCL_CALL(ncclCommInitAll(comms.data(), device_ids.size(), device_ids.data()));
+
+  int origin_device;
+  CUDA_CALL(cudaGetDevice(&origin_device));
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < device_ids.size(); ++i) {
+    auto key = std::make_pair(ring_id, device_ids[i]);
+    CHECK(!comms_.count(key)) << "The communicator of ring " << ring_id << " on device " << device_ids[i]
+                              << " is already created";
+    CUDA_CALL(cudaSetDevice(device_ids[i]));
+    Comm comm;
+    comm.comm = comms[i];
+    CUDA_CALL(cudaStreamCreateWithFlags(&comm.stream, cudaStreamNonBlocking));
+    comms_.emplace(key, comm);
+  }
+  CUDA_CALL(cudaSetDevice(origin_device));
+  VLOG(3) << "Create the communicators of ring " << ring_id << " on " << device_ids.size() << " devices";
+}
+
+void NcclCommContext::Init(int ring_id, int nranks, int rank, const std::string& unique_id) {
+  CHECK_EQ(unique_id.size(), sizeof(ncclUniqueId)) << "Invalid NCCL unique id";
+  CHECK(rank >= 0 && rank < nranks) << "Invalid rank " << rank << " of " << nranks << " ranks";
+  ncclUniqueId id;
+  std::copy(unique_id.begin(), unique_id.end(), id.internal);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+
+  Comm comm;
+  NCCL_CALL(ncclCommInitRank(&comm.comm, nranks, id, rank));
+  CUDA_CALL(cudaStreamCreateWithFlags(&comm.stream, cudaStreamNonBlocking));
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto key = std::make_pair(ring_id, device_id);
+  CHECK(!comms_.count(key)) << "The communicator of ring " << ring_id << " on device " << device_id
+                            << " is already created";
+  comms_.emplace(key, comm);
+  VLOG(3) << "Create the communicator of ring " << ring_id << " for rank " << rank << " of " << nranks;
+}
+
+std::string NcclCommContext::GenUniqueId() {
+  ncclUniqueId id;
+  NCCL_CALL(ncclGetUniqueId(&id));
+  return std::string(id.internal, sizeof(id.internal));
+}
+
+ncclComm_t NcclCommContext::Get(int ring_id) {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = comms_.find(std::make_pair(ring_id, device_id));
+  CHECK(it != comms_.end()) << "The communicator of ring " << ring_id << " on device " << device_id
+                            << " is not created, please create it by NcclCommContext::Init or InitAll first";
+  return it->second.comm;
+}
+
+cudaStream_t NcclCommContext::GetCommStream(int ring_id) {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = comms_.find(std::make_pair(ring_id, device_id));
+  CHECK(it != comms_.end()) << "The communicator of ring " << ring_id << " on device " << device_id
+                            << " is not created";
+  return it->second.stream;
+}
+
+void NcclCommContext::Destroy(int ring_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = comms_.begin(); it != comms_.end();) {
+    if (it->first.first != ring_id) {
+      ++it;
+      continue;
+    }
+    NCCL_CALL(ncclCommDestroy(it->second.comm));
+    CUDA_CALL(cudaStreamDestroy(it->second.stream));
+    it = comms_.erase(it);
+  }
+}
+
+NcclCommContext::~NcclCommContext() {
+  // the driver may be deinitialized on exiting, so the errors are ignored
+  for (auto& item : comms_) {
+    ncclCommDestroy(item.second.comm);
+    cudaStreamDestroy(item.second.stream);
+  }
+}
+
+namespace {
+
+ncclDataType_t ToNcclDataType(int type_code, int type_bits) {
+  switch (type_code) {
+    case cinn_type_float:
+      if (type_bits == 16) return ncclFloat16;
+      if (type_bits == 32) return ncclFloat32;
+      if (type_bits == 64) return ncclFloat64;
+      break;
+#if NCCL_VERSION_CODE >= 21000
+    case cinn_type_bfloat:
+      if (type_bits == 16) return ncclBfloat16;
+      break;
+#endif
+    case cinn_type_int:
+      if (type_bits == 8) return ncclInt8;
+      if (type_bits == 32) return ncclInt32;
+      if (type_bits == 64) return ncclInt64;
+      break;
+    case cinn_type_uint:
+      if (type_bits == 8) return ncclUint8;
+      if (type_bits == 32) return ncclUint32;
+      if (type_bits == 64) return ncclUint64;
+      break;
+    default:
+      break;
+  }
+  LOG(FATAL) << "The collective ops don't support the dtype of code " << type_code << " and " << type_bits << " bits";
+  return ncclFloat32;
+}
+
+ncclRedOp_t ToNcclRedOp(int reduce_type) {
+  switch (static_cast<CollectiveReduceType>(reduce_type)) {
+    case CollectiveReduceType::kSum:
+      return ncclSum;
+    case CollectiveReduceType::kProd:
+      return ncclProd;
+    case CollectiveReduceType::kMax:
+      return ncclMax;
+    case CollectiveReduceType::kMin:
+      return ncclMin;
+#if NCCL_VERSION_CODE >= 21000
+    case CollectiveReduceType::kAvg:
+      return ncclAvg;
+#endif
+    default:
+      LOG(FATAL) << "Unsupported reduce type " << reduce_type << " of the collective ops";
+  }
+  return ncclSum;
+}
+
+// The events of the collective ops running off the compute stream, by the buffers they read and write. An event is
+// removed once an instruction touching one of its buffers waits for it.
+class PendingCollectives {
+ public:
+  static PendingCollectives& Global() {
+    static PendingCollectives pending;
+    return pending;
+  }
+
+  void Add(const std::vector<void*>& memories, cudaStream_t comm_stream) {
+    cudaEvent_t event;
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    CUDA_CALL(cudaEventRecord(event, comm_stream));
+    std::shared_ptr<CUevent_st> shared_event(event, [](cudaEvent_t event) { cudaEventDestroy(event); });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (void* memory : memories) {
+      events_[memory] = shared_event;
+    }
+    num_pending_ = events_.size();
+  }
+
+  void Wait(const std::vector<std::vector<cinn_pod_value_t>>& args, cudaStream_t stream) {
+    if (num_pending_.load(std::memory_order_relaxed) == 0) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& func_args : args) {
+      for (auto& arg : func_args) {
+        if (arg.type_code() != ::cinn_type_code<cinn_buffer_t*>()) continue;
+        auto* buffer = static_cast<cinn_buffer_t*>(arg);
+        auto it      = events_.find(buffer->memory);
+        if (it == events_.end()) continue;
+        CUDA_CALL(cudaStreamWaitEvent(stream, it->second.get(), 0));
+        events_.erase(it);
+      }
+    }
+    num_pending_ = events_.size();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<void*, std::shared_ptr<CUevent_st>> events_;
+  std::atomic<int> num_pending_{0};
+};
+
+// Get the stream to run a collective op on, which waits for the work issued to the compute stream before it.
+cudaStream_t PrepareCollectiveStream(int ring_id, bool use_calc_stream, void* stream) {
+  auto calc_stream = static_cast<cudaStream_t>(stream);
+  if (use_calc_stream) return calc_stream;
+  auto comm_stream = NcclCommContext::Global().GetCommStream(ring_id);
+  cudaEvent_t ready;
+  CUDA_CALL(cudaEventCreateWithFlags(&ready, cudaEventDisableTiming));
+  CUDA_CALL(cudaEventRecord(ready, calc_stream));
+  CUDA_CALL(cudaStreamWaitEvent(comm_stream, ready, 0));
+  CUDA_CALL(cudaEventDestroy(ready));
+  return comm_stream;
+}
+
+void FinishCollective(void* input, void* output, bool use_calc_stream, cudaStream_t comm_stream) {
+  if (use_calc_stream) return;
+  // the input must not be overwritten either before the communication finishes
+  PendingCollectives::Global().Add({input, output}, comm_stream);
+}
+
+void* GetBufferMemory(cinn_pod_value_t* args, int index) {
+  return static_cast<cinn_buffer_t*>(args[index])->memory;
+}
+
+}  // namespace
+
+void cinn_call_nccl_all_reduce(void* v_args,
+                               int num_args,
+                               int count,
+                               int type_code,
+                               int type_bits,
+                               int reduce_type,
+                               int ring_id,
+                               bool use_calc_stream,
+                               void* stream) {
+  CHECK_EQ(num_args, 2) << "The all_reduce takes an input and an output";
+  cinn::utils::RecordEvent record_run("cinn_call_nccl_all_reduce", cinn::utils::EventType::kInstruction);
+  auto* args       = static_cast<cinn_pod_value_t*>(v_args);
+  void* input      = GetBufferMemory(args, 0);
+  void* output     = GetBufferMemory(args, 1);
+  auto comm_stream = PrepareCollectiveStream(ring_id, use_calc_stream, stream);
+  NCCL_CALL(ncclAllReduce(input,
+                          output,
+                          count,
+                          ToNcclDataType(type_code, type_bits),
+                          ToNcclRedOp(reduce_type),
+                          NcclCommContext::Global().Get(ring_id),
+                          comm_stream));
+  FinishCollective(input, output, use_calc_stream, comm_stream);
+}
+
+void cinn_call_nccl_all_gather(void* v_args,
+                               int num_args,
+                               int count,
+                               int type_code,
+                               int type_bits,
+                               int ring_id,
+                               bool use_calc_stream,
+                               void* stream) {
+  CHECK_EQ(num_args, 2) << "The all_gather takes an input and an output";
+  cinn::utils::RecordEvent record_run("cinn_call_nccl_all_gather", cinn::utils::EventType::kInstruction);
+  auto* args       = static_cast<cinn_pod_value_t*>(v_args);
+  void* input      = GetBufferMemory(args, 0);
+  void* output     = GetBufferMemory(args, 1);
+  auto comm_stream = PrepareCollectiveStream(ring_id, use_calc_stream, stream);
+  NCCL_CALL(ncclAllGather(input,
+                          output,
+                          count,
+                          ToNcclDataType(type_code, type_bits),
+                          NcclCommContext::Global().Get(ring_id),
+                          comm_stream));
+  FinishCollective(input, output, use_calc_stream, comm_stream);
+}
+
+void cinn_call_nccl_reduce_scatter(void* v_args,
+                                   int num_args,
+                                   int count,
+                                   int type_code,
+                                   int type_bits,
+                                   int reduce_type,
+                                   int ring_id,
+                                   bool use_calc_stream,
+                                   void* stream) {
+  CHECK_EQ(num_args, 2) << "The reduce_scatter takes an input and an output";
+  cinn::utils::RecordEvent record_run("cinn_call_nccl_reduce_scatter", cinn::utils::EventType::kInstruction);
+  auto* args       = static_cast<cinn_pod_value_t*>(v_args);
+  void* input      = GetBufferMemory(args, 0);
+  void* output     = GetBufferMemory(args, 1);
+  auto comm_stream = PrepareCollectiveStream(ring_id, use_calc_stream, stream);
+  NCCL_CALL(ncclReduceScatter(input,
+                              output,
+                              count,
+                              ToNcclDataType(type_code, type_bits),
+                              ToNcclRedOp(reduce_type),
+                              NcclCommContext::Global().Get(ring_id),
+                              comm_stream));
+  FinishCollective(input, output, use_calc_stream, comm_stream);
+}
+
+void WaitCollectiveResults(const std::vector<std::vector<cinn_pod_value_t>>& args, void* stream) {
+  PendingCollectives::Global().Wait(args, static_cast<cudaStream_t>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
+
+#endif  // CINN_WITH_NCCL
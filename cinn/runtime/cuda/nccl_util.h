@@ -0,0 +1,137 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef CINN_WITH_NCCL
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+#include <nccl.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+#define NCCL_CALL(func)                                                                    \
+  {                                                                                        \
+    auto status = func;                                                                    \
+    if (status != ncclSuccess) {                                                           \
+      LOG(FATAL) << "NCCL Error : " << ncclGetErrorString(status) << " in call " << #func; \
+    }                                                                                      \
+  }
+
+/**
+ * The NCCL communicators of the collective ops, each ring has one communicator on every device it spans in this
+ * process, and the collective ops of a ring use the communicator of the current device. The communicators must be
+ * created before the programs with the collective ops run.
+ */
+class NcclCommContext {
+ public:
+  static NcclCommContext& Global();
+
+  /**
+   * Create the communicators of \p ring_id on the devices of this process, the rank i is on the device
+   * \p device_ids[i], such as for the replicas of a program created by ProgramReplicas.
+   */
+  void InitAll(int ring_id, const std::vector<int>& device_ids);
+
+  /**
+   * Create the communicator of \p ring_id on the current device for the rank \p rank of \p nranks processes.
+   * @param unique_id The id got by GenUniqueId on one of the ranks and shared with the others.
+   */
+  void Init(int ring_id, int nranks, int rank, const std::string& unique_id);
+
+  static std::string GenUniqueId();
+
+  //! Get the communicator of \p ring_id on the current device.
+  ncclComm_t Get(int ring_id);
+
+  //! Get the stream to run the collective ops of \p ring_id off the compute stream on the current device.
+  cudaStream_t GetCommStream(int ring_id);
+
+  //! Destroy the communicators of \p ring_id on all the devices.
+  void Destroy(int ring_id);
+
+  ~NcclCommContext();
+
+ private:
+  NcclCommContext() = default;
+
+  struct Comm {
+    ncclComm_t comm{};
+    cudaStream_t stream{};
+  };
+  // the communicators by the ring and the device
+  std::map<std::pair<int, int>, Comm> comms_;
+  std::mutex mutex_;
+};
+
+//! The reduction of the all_reduce and reduce_scatter ops, the same order as ncclRedOp_t.
+enum class CollectiveReduceType : int { kSum = 0, kProd = 1, kMax = 2, kMin = 3, kAvg = 4 };
+
+/**
+ * The collective ops called by the custom_call. The first argument is the input and the second is the output, the
+ * count is the number of elements of the input for all_reduce and all_gather, and of the output for reduce_scatter.
+ * The op runs on \p stream when \p use_calc_stream is true, otherwise on the communication stream of the ring, after
+ * the work issued to \p stream before it, and the instructions reading the result wait for it, so that the compute
+ * instructions independent of the result overlap with the communication.
+ */
+void cinn_call_nccl_all_reduce(void* v_args,
+                               int num_args,
+                               int count,
+                               int type_code,
+                               int type_bits,
+                               int reduce_type,
+                               int ring_id,
+                               bool use_calc_stream,
+                               void* stream = nullptr);
+
+void cinn_call_nccl_all_gather(void* v_args,
+                               int num_args,
+                               int count,
+                               int type_code,
+                               int type_bits,
+                               int ring_id,
+                               bool use_calc_stream,
+                               void* stream = nullptr);
+
+void cinn_call_nccl_reduce_scatter(void* v_args,
+                                   int num_args,
+                                   int count,
+                                   int type_code,
+                                   int type_bits,
+                                   int reduce_type,
+                                   int ring_id,
+                                   bool use_calc_stream,
+                                   void* stream = nullptr);
+
+/**
+ * Make \p stream wait for the collective ops running off the compute stream which write the buffers of \p args, it
+ * is called by the instructions before running, and costs nothing if no such op is in flight.
+ */
+void WaitCollectiveResults(const std::vector<std::vector<cinn_pod_value_t>>& args, void* stream);
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
+
+#endif  // CINN_WITH_NCCL
@@ -0,0 +1,582 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kNormWarpRowMaxCols     = 1024;
+constexpr int kNormItemsPerThread     = 16;
+constexpr int kNormMaxItems           = 32;
+constexpr int kNormMaxRowThreads      = 1024;
+constexpr int kNormRowsPerWarpBlock   = 4;
+constexpr int kNormParamGradRows      = 8;
+constexpr int kNormParamGradChunkRows = 128;
+constexpr int kNormParamGradMaxChunks = 64;
+
+// Each row is normalized by ROW_THREADS threads of the block and a block holds ROWS_PER_BLOCK rows. A thread keeps
+// ITEMS elements of its row in registers, so the input is read only once, the rows too long for the registers
+// (ITEMS is 0) are read from the global memory again instead. The statistics are accumulated in float.
+const char* kNormCommonSource = R"(
+#define NUM_WARPS (ROW_THREADS / 32)
+
+__device__ __forceinline__ void cinn_welford_merge(float& mean, float& m2, float& count, float b_mean, float b_m2,
+                                                   float b_count) {
+  float n = count + b_count;
+  if (n == 0.0f) return;
+  float delta = b_mean - mean;
+  float ratio = b_count / n;
+  mean += delta * ratio;
+  m2 += b_m2 + delta * delta * count * ratio;
+  count = n;
+}
+
+__device__ __forceinline__ void cinn_welford_update(float& mean, float& m2, float& count, float value) {
+  count += 1.0f;
+  float delta = value - mean;
+  mean += delta / count;
+  m2 += delta * (value - mean);
+}
+
+// Merge the Welford states of all the threads of a row, every thread gets the same result.
+__device__ __forceinline__ void cinn_row_welford(float& mean, float& m2, float& count) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    float b_mean  = __shfl_xor_sync(0xffffffff, mean, offset);
+    float b_m2    = __shfl_xor_sync(0xffffffff, m2, offset);
+    float b_count = __shfl_xor_sync(0xffffffff, count, offset);
+    cinn_welford_merge(mean, m2, count, b_mean, b_m2, b_count);
+  }
+  mean  = __shfl_sync(0xffffffff, mean, 0);
+  m2    = __shfl_sync(0xffffffff, m2, 0);
+  count = __shfl_sync(0xffffffff, count, 0);
+#if NUM_WARPS > 1
+  __shared__ float s_mean[ROWS_PER_BLOCK][NUM_WARPS];
+  __shared__ float s_m2[ROWS_PER_BLOCK][NUM_WARPS];
+  __shared__ float s_count[ROWS_PER_BLOCK][NUM_WARPS];
+  if ((threadIdx.x & 31) == 0) {
+    s_mean[threadIdx.y][threadIdx.x >> 5]  = mean;
+    s_m2[threadIdx.y][threadIdx.x >> 5]    = m2;
+    s_count[threadIdx.y][threadIdx.x >> 5] = count;
+  }
+  __syncthreads();
+  mean  = s_mean[threadIdx.y][0];
+  m2    = s_m2[threadIdx.y][0];
+  count = s_count[threadIdx.y][0];
+  for (int w = 1; w < NUM_WARPS; ++w) {
+    cinn_welford_merge(mean, m2, count, s_mean[threadIdx.y][w], s_m2[threadIdx.y][w], s_count[threadIdx.y][w]);
+  }
+#endif
+}
+
+// Sum two values over all the threads of a row, every thread gets the same result.
+__device__ __forceinline__ void cinn_row_sum2(float& a, float& b) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    a += __shfl_xor_sync(0xffffffff, a, offset);
+    b += __shfl_xor_sync(0xffffffff, b, offset);
+  }
+  a = __shfl_sync(0xffffffff, a, 0);
+  b = __shfl_sync(0xffffffff, b, 0);
+#if NUM_WARPS > 1
+  __shared__ float s_a[ROWS_PER_BLOCK][NUM_WARPS];
+  __shared__ float s_b[ROWS_PER_BLOCK][NUM_WARPS];
+  if ((threadIdx.x & 31) == 0) {
+    s_a[threadIdx.y][threadIdx.x >> 5] = a;
+    s_b[threadIdx.y][threadIdx.x >> 5] = b;
+  }
+  __syncthreads();
+  a = 0.0f;
+  b = 0.0f;
+  for (int w = 0; w < NUM_WARPS; ++w) {
+    a += s_a[threadIdx.y][w];
+    b += s_b[threadIdx.y][w];
+  }
+#endif
+}
+
+#if ITEMS > 0
+#define FOR_EACH_COL(i, col)  \
+  _Pragma("unroll")           \
+  for (int i = 0, col = threadIdx.x; i < ITEMS; ++i, col += ROW_THREADS) if (col < cols)
+#define LOAD_ROW(buf, src) FOR_EACH_COL(i, col) buf[i] = static_cast<float>(src[col]);
+#define ROW_VALUE(buf, src) buf[i]
+#else
+#define FOR_EACH_COL(i, col) for (int i = 0, col = threadIdx.x; col < cols; ++i, col += ROW_THREADS)
+#define LOAD_ROW(buf, src)
+#define ROW_VALUE(buf, src) static_cast<float>(src[col])
+#define ITEMS_BUF 1
+#endif
+
+#ifndef ITEMS_BUF
+#define ITEMS_BUF ITEMS
+#endif
+)";
+
+// The mean and the variance are computed by the single-pass Welford algorithm.
+const char* kLayerNormSource = R"(
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_layer_norm_kernel(const DTYPE* __restrict__ x,
+                       const float* __restrict__ scale,
+                       const float* __restrict__ bias,
+                       int rows,
+                       int cols,
+                       float epsilon,
+                       DTYPE* __restrict__ y,
+                       float* __restrict__ mean_out,
+                       float* __restrict__ variance_out) {
+  const int row = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  // the threads of the out of range rows still take part in the block reduction
+  const bool active = row < rows;
+  const DTYPE* x_row = x + static_cast<long long>(active ? row : 0) * cols;
+  float xs[ITEMS_BUF];
+  LOAD_ROW(xs, x_row)
+
+  float mean = 0.0f, m2 = 0.0f, count = 0.0f;
+  FOR_EACH_COL(i, col) { cinn_welford_update(mean, m2, count, ROW_VALUE(xs, x_row)); }
+  cinn_row_welford(mean, m2, count);
+  if (!active) return;
+
+  const float variance = fmaxf(m2 / cols, 0.0f);
+  const float inv_std  = rsqrtf(variance + epsilon);
+  DTYPE* y_row = y + static_cast<long long>(row) * cols;
+  FOR_EACH_COL(i, col) {
+    y_row[col] = static_cast<DTYPE>((ROW_VALUE(xs, x_row) - mean) * inv_std * scale[col] + bias[col]);
+  }
+  if (threadIdx.x == 0) {
+    mean_out[row]     = mean;
+    variance_out[row] = variance;
+  }
+}
+
+// dx = inv_std * (g - mean(g) - x_hat * mean(g * x_hat)), where g = dy * scale and x_hat = (x - mean) * inv_std.
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_layer_norm_grad_kernel(const DTYPE* __restrict__ x,
+                            const float* __restrict__ scale,
+                            const float* __restrict__ mean,
+                            const float* __restrict__ variance,
+                            const DTYPE* __restrict__ dy,
+                            int rows,
+                            int cols,
+                            float epsilon,
+                            DTYPE* __restrict__ dx) {
+  const int row = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  const bool active = row < rows;
+  const long long offset = static_cast<long long>(active ? row : 0) * cols;
+  const DTYPE* x_row  = x + offset;
+  const DTYPE* dy_row = dy + offset;
+  const float row_mean = mean[active ? row : 0];
+  const float inv_std  = rsqrtf(variance[active ? row : 0] + epsilon);
+  float xs[ITEMS_BUF], dys[ITEMS_BUF];
+  LOAD_ROW(xs, x_row)
+  LOAD_ROW(dys, dy_row)
+
+  float sum_g = 0.0f, sum_g_x_hat = 0.0f;
+  FOR_EACH_COL(i, col) {
+    float g = ROW_VALUE(dys, dy_row) * scale[col];
+    sum_g += g;
+    sum_g_x_hat += g * (ROW_VALUE(xs, x_row) - row_mean) * inv_std;
+  }
+  cinn_row_sum2(sum_g, sum_g_x_hat);
+  if (!active) return;
+
+  const float mean_g       = sum_g / cols;
+  const float mean_g_x_hat = sum_g_x_hat / cols;
+  DTYPE* dx_row = dx + offset;
+  FOR_EACH_COL(i, col) {
+    float g     = ROW_VALUE(dys, dy_row) * scale[col];
+    float x_hat = (ROW_VALUE(xs, x_row) - row_mean) * inv_std;
+    dx_row[col] = static_cast<DTYPE>(inv_std * (g - mean_g - x_hat * mean_g_x_hat));
+  }
+}
+)";
+
+// The root mean square has no mean to subtract, so the sum of squares is enough.
+const char* kRMSNormSource = R"(
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_rms_norm_kernel(const DTYPE* __restrict__ x,
+                     const float* __restrict__ scale,
+                     int rows,
+                     int cols,
+                     float epsilon,
+                     DTYPE* __restrict__ y,
+                     float* __restrict__ inv_rms_out) {
+  const int row = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  const bool active = row < rows;
+  const DTYPE* x_row = x + static_cast<long long>(active ? row : 0) * cols;
+  float xs[ITEMS_BUF];
+  LOAD_ROW(xs, x_row)
+
+  float sum_square = 0.0f, unused = 0.0f;
+  FOR_EACH_COL(i, col) {
+    float value = ROW_VALUE(xs, x_row);
+    sum_square += value * value;
+  }
+  cinn_row_sum2(sum_square, unused);
+  if (!active) return;
+
+  const float inv_rms = rsqrtf(sum_square / cols + epsilon);
+  DTYPE* y_row = y + static_cast<long long>(row) * cols;
+  FOR_EACH_COL(i, col) { y_row[col] = static_cast<DTYPE>(ROW_VALUE(xs, x_row) * inv_rms * scale[col]); }
+  if (threadIdx.x == 0) {
+    inv_rms_out[row] = inv_rms;
+  }
+}
+
+// dx = inv_rms * (g - x_hat * mean(g * x_hat)), where g = dy * scale and x_hat = x * inv_rms.
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_rms_norm_grad_kernel(const DTYPE* __restrict__ x,
+                          const float* __restrict__ scale,
+                          const float* __restrict__ inv_rms,
+                          const DTYPE* __restrict__ dy,
+                          int rows,
+                          int cols,
+                          DTYPE* __restrict__ dx) {
+  const int row = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  const bool active = row < rows;
+  const long long offset = static_cast<long long>(active ? row : 0) * cols;
+  const DTYPE* x_row  = x + offset;
+  const DTYPE* dy_row = dy + offset;
+  const float row_inv_rms = inv_rms[active ? row : 0];
+  float xs[ITEMS_BUF], dys[ITEMS_BUF];
+  LOAD_ROW(xs, x_row)
+  LOAD_ROW(dys, dy_row)
+
+  float sum_g_x_hat = 0.0f, unused = 0.0f;
+  FOR_EACH_COL(i, col) { sum_g_x_hat += ROW_VALUE(dys, dy_row) * scale[col] * ROW_VALUE(xs, x_row) * row_inv_rms; }
+  cinn_row_sum2(sum_g_x_hat, unused);
+  if (!active) return;
+
+  const float mean_g_x_hat = sum_g_x_hat / cols;
+  DTYPE* dx_row = dx + offset;
+  FOR_EACH_COL(i, col) {
+    float g     = ROW_VALUE(dys, dy_row) * scale[col];
+    float x_hat = ROW_VALUE(xs, x_row) * row_inv_rms;
+    dx_row[col] = static_cast<DTYPE>(row_inv_rms * (g - x_hat * mean_g_x_hat));
+  }
+}
+)";
+
+// The gradients of the scale and the bias are reduced over the rows in two stages: each block sums 32 columns of a
+// chunk of rows into the partial buffers, then the partial sums of the chunks are added up in order, so the results
+// are deterministic. The bias gradient is skipped when it is null, as RMSNorm has no bias.
+const char* kNormParamGradSource = R"(
+extern "C" __global__ void cinn_norm_param_grad_kernel(const DTYPE* __restrict__ x,
+                                                       const float* __restrict__ mean,
+                                                       const float* __restrict__ inv_std,
+                                                       const DTYPE* __restrict__ dy,
+                                                       int rows,
+                                                       int cols,
+                                                       float epsilon,
+                                                       int rows_per_chunk,
+                                                       float* __restrict__ partial_dscale,
+                                                       float* __restrict__ partial_dbias) {
+  __shared__ float s_dscale[PARAM_GRAD_ROWS][33];
+  __shared__ float s_dbias[PARAM_GRAD_ROWS][33];
+  const int col       = blockIdx.x * 32 + threadIdx.x;
+  const int row_begin = blockIdx.y * rows_per_chunk;
+  const int row_end   = min(rows, row_begin + rows_per_chunk);
+  float sum_dscale = 0.0f, sum_dbias = 0.0f;
+  if (col < cols) {
+    for (int row = row_begin + threadIdx.y; row < row_end; row += PARAM_GRAD_ROWS) {
+      long long idx = static_cast<long long>(row) * cols + col;
+      float g       = static_cast<float>(dy[idx]);
+      // the layer_norm passes the variance and the rms_norm passes the inverse root mean square
+      float row_inv = mean ? rsqrtf(inv_std[row] + epsilon) : inv_std[row];
+      float x_hat   = (static_cast<float>(x[idx]) - (mean ? mean[row] : 0.0f)) * row_inv;
+      sum_dscale += g * x_hat;
+      sum_dbias += g;
+    }
+  }
+  s_dscale[threadIdx.y][threadIdx.x] = sum_dscale;
+  s_dbias[threadIdx.y][threadIdx.x]  = sum_dbias;
+  __syncthreads();
+  if (threadIdx.y == 0 && col < cols) {
+    for (int r = 1; r < PARAM_GRAD_ROWS; ++r) {
+      sum_dscale += s_dscale[r][threadIdx.x];
+      sum_dbias += s_dbias[r][threadIdx.x];
+    }
+    partial_dscale[static_cast<long long>(blockIdx.y) * cols + col] = sum_dscale;
+    partial_dbias[static_cast<long long>(blockIdx.y) * cols + col]  = sum_dbias;
+  }
+}
+
+extern "C" __global__ void cinn_norm_param_grad_reduce_kernel(const float* __restrict__ partial_dscale,
+                                                              const float* __restrict__ partial_dbias,
+                                                              int num_chunks,
+                                                              int cols,
+                                                              float* __restrict__ dscale,
+                                                              float* __restrict__ dbias) {
+  const int col = blockIdx.x * blockDim.x + threadIdx.x;
+  if (col >= cols) return;
+  float sum_dscale = 0.0f, sum_dbias = 0.0f;
+  for (int c = 0; c < num_chunks; ++c) {
+    sum_dscale += partial_dscale[static_cast<long long>(c) * cols + col];
+    sum_dbias += partial_dbias[static_cast<long long>(c) * cols + col];
+  }
+  dscale[col] = sum_dscale;
+  if (dbias) dbias[col] = sum_dbias;
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  }
+  LOG(FATAL) << "The norm kernels only support float32, float16 and bfloat16, but got the type code " << type.code
+             << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+int NextPowerOfTwo(int value) {
+  int result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+struct NormConfig {
+  int row_threads;
+  int rows_per_block;
+  int items;
+};
+
+// The short rows are normalized by a warp each and several rows share a block, the long rows are split among the
+// threads of a block so that each thread keeps at most kNormMaxItems elements in registers.
+NormConfig GetNormConfig(int cols) {
+  if (cols <= kNormWarpRowMaxCols) {
+    return {32, kNormRowsPerWarpBlock, NextPowerOfTwo((cols + 31) / 32)};
+  }
+  int row_threads =
+      std::min(NextPowerOfTwo((cols + kNormItemsPerThread - 1) / kNormItemsPerThread), kNormMaxRowThreads);
+  int items       = NextPowerOfTwo((cols + row_threads - 1) / row_threads);
+  return {row_threads, 1, items > kNormMaxItems ? 0 : items};
+}
+
+// The kernels are compiled by NVRTC once for each dtype and configuration.
+CUDAModule* GetNormModule(const std::string& kernel, const cinn_type_t& type, const NormConfig& config) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto dtype = GetDTypeName(type);
+  auto key   = kernel + "_" + dtype + "_" + std::to_string(config.row_threads) + "_" +
+             std::to_string(config.rows_per_block) + "_" + std::to_string(config.items);
+  auto it = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define ROW_THREADS " + std::to_string(config.row_threads) + "\n";
+  source += "#define ROWS_PER_BLOCK " + std::to_string(config.rows_per_block) + "\n";
+  source += "#define ITEMS " + std::to_string(config.items) + "\n";
+  source += "#define PARAM_GRAD_ROWS " + std::to_string(kNormParamGradRows) + "\n";
+  source += kNormCommonSource;
+  if (kernel == "layer_norm") {
+    source += kLayerNormSource;
+  } else if (kernel == "rms_norm") {
+    source += kRMSNormSource;
+  } else {
+    source += kNormParamGradSource;
+  }
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the " << kernel << " kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+void LaunchRowKernel(const std::string& kernel,
+                     const std::string& func_name,
+                     const cinn_type_t& type,
+                     int rows,
+                     int cols,
+                     void** kernel_args,
+                     void* stream) {
+  auto config  = GetNormConfig(cols);
+  auto* module = GetNormModule(kernel, type, config);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       func_name,
+                       dim3((rows + config.rows_per_block - 1) / config.rows_per_block),
+                       dim3(config.row_threads, config.rows_per_block),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+// The x, the mean, the variance or the inverse root mean square and the dy are taken from the row kernel arguments.
+void LaunchParamGradKernel(const cinn_type_t& type,
+                           void* x,
+                           void* mean,
+                           void* inv_std,
+                           void* dy,
+                           int rows,
+                           int cols,
+                           float epsilon,
+                           void* dscale,
+                           void* dbias,
+                           void* stream) {
+  int num_chunks = (rows + kNormParamGradChunkRows - 1) / kNormParamGradChunkRows;
+  num_chunks     = std::min(std::max(num_chunks, 1), kNormParamGradMaxChunks);
+  int rows_per_chunk = (rows + num_chunks - 1) / num_chunks;
+
+  auto cuda_stream = static_cast<cudaStream_t>(stream);
+  void* partial_dscale;
+  void* partial_dbias;
+  CUDA_CALL(cudaMallocAsync(&partial_dscale, sizeof(float) * num_chunks * cols, cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&partial_dbias, sizeof(float) * num_chunks * cols, cuda_stream));
+
+  auto* module = GetNormModule("param_grad", type, {32, 1, 0});
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  void* chunk_args[] = {
+      &x, &mean, &inv_std, &dy, &rows, &cols, &epsilon, &rows_per_chunk, &partial_dscale, &partial_dbias};
+  module->LaunchKernel(device_id,
+                       "cinn_norm_param_grad_kernel",
+                       dim3((cols + 31) / 32, num_chunks),
+                       dim3(32, kNormParamGradRows),
+                       chunk_args,
+                       0,
+                       static_cast<CUstream>(stream));
+  void* reduce_args[] = {&partial_dscale, &partial_dbias, &num_chunks, &cols, &dscale, &dbias};
+  module->LaunchKernel(device_id,
+                       "cinn_norm_param_grad_reduce_kernel",
+                       dim3((cols + 255) / 256),
+                       dim3(256),
+                       reduce_args,
+                       0,
+                       static_cast<CUstream>(stream));
+
+  CUDA_CALL(cudaFreeAsync(partial_dscale, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(partial_dbias, cuda_stream));
+}
+
+}  // namespace
+
+void cinn_call_layer_norm_nvgpu(void* v_args, int num_args, int rows, int cols, float epsilon, void* stream) {
+  CHECK_EQ(num_args, 6) << "The layer_norm takes the x, the scale, the bias and outputs the y, the mean and the "
+                           "variance.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "layer_norm: rows=" << rows << ", cols=" << cols << ", epsilon=" << epsilon;
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  void* x_ptr         = x->memory;
+  void* scale_ptr     = args[1].operator cinn_buffer_t*()->memory;
+  void* bias_ptr      = args[2].operator cinn_buffer_t*()->memory;
+  void* y_ptr         = args[3].operator cinn_buffer_t*()->memory;
+  void* mean_ptr      = args[4].operator cinn_buffer_t*()->memory;
+  void* variance_ptr  = args[5].operator cinn_buffer_t*()->memory;
+  void* kernel_args[] = {&x_ptr, &scale_ptr, &bias_ptr, &rows, &cols, &epsilon, &y_ptr, &mean_ptr, &variance_ptr};
+  LaunchRowKernel("layer_norm", "cinn_layer_norm_kernel", x->type, rows, cols, kernel_args, stream);
+}
+
+void cinn_call_layer_norm_grad_nvgpu(void* v_args, int num_args, int rows, int cols, float epsilon, void* stream) {
+  CHECK_EQ(num_args, 8) << "The layer_norm_grad takes the x, the scale, the mean, the variance, the dy and outputs "
+                           "the dx, the dscale and the dbias.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "layer_norm_grad: rows=" << rows << ", cols=" << cols << ", epsilon=" << epsilon;
+  if (cols == 0) {
+    return;
+  }
+
+  void* x_ptr        = x->memory;
+  void* scale_ptr    = args[1].operator cinn_buffer_t*()->memory;
+  void* mean_ptr     = args[2].operator cinn_buffer_t*()->memory;
+  void* variance_ptr = args[3].operator cinn_buffer_t*()->memory;
+  void* dy_ptr       = args[4].operator cinn_buffer_t*()->memory;
+  void* dx_ptr       = args[5].operator cinn_buffer_t*()->memory;
+  void* dscale_ptr   = args[6].operator cinn_buffer_t*()->memory;
+  void* dbias_ptr    = args[7].operator cinn_buffer_t*()->memory;
+  if (rows > 0) {
+    void* kernel_args[] = {
+        &x_ptr, &scale_ptr, &mean_ptr, &variance_ptr, &dy_ptr, &rows, &cols, &epsilon, &dx_ptr};
+    LaunchRowKernel("layer_norm", "cinn_layer_norm_grad_kernel", x->type, rows, cols, kernel_args, stream);
+  }
+  LaunchParamGradKernel(
+      x->type, x_ptr, mean_ptr, variance_ptr, dy_ptr, rows, cols, epsilon, dscale_ptr, dbias_ptr, stream);
+}
+
+void cinn_call_rms_norm_nvgpu(void* v_args, int num_args, int rows, int cols, float epsilon, void* stream) {
+  CHECK_EQ(num_args, 4) << "The rms_norm takes the x, the scale and outputs the y and the inverse root mean square.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "rms_norm: rows=" << rows << ", cols=" << cols << ", epsilon=" << epsilon;
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  void* x_ptr         = x->memory;
+  void* scale_ptr     = args[1].operator cinn_buffer_t*()->memory;
+  void* y_ptr         = args[2].operator cinn_buffer_t*()->memory;
+  void* inv_rms_ptr   = args[3].operator cinn_buffer_t*()->memory;
+  void* kernel_args[] = {&x_ptr, &scale_ptr, &rows, &cols, &epsilon, &y_ptr, &inv_rms_ptr};
+  LaunchRowKernel("rms_norm", "cinn_rms_norm_kernel", x->type, rows, cols, kernel_args, stream);
+}
+
+void cinn_call_rms_norm_grad_nvgpu(void* v_args, int num_args, int rows, int cols, void* stream) {
+  CHECK_EQ(num_args, 6) << "The rms_norm_grad takes the x, the scale, the inverse root mean square, the dy and "
+                           "outputs the dx and the dscale.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "rms_norm_grad: rows=" << rows << ", cols=" << cols;
+  if (cols == 0) {
+    return;
+  }
+
+  void* x_ptr       = x->memory;
+  void* scale_ptr   = args[1].operator cinn_buffer_t*()->memory;
+  void* inv_rms_ptr = args[2].operator cinn_buffer_t*()->memory;
+  void* dy_ptr      = args[3].operator cinn_buffer_t*()->memory;
+  void* dx_ptr      = args[4].operator cinn_buffer_t*()->memory;
+  void* dscale_ptr  = args[5].operator cinn_buffer_t*()->memory;
+  if (rows > 0) {
+    void* kernel_args[] = {&x_ptr, &scale_ptr, &inv_rms_ptr, &dy_ptr, &rows, &cols, &dx_ptr};
+    LaunchRowKernel("rms_norm", "cinn_rms_norm_grad_kernel", x->type, rows, cols, kernel_args, stream);
+  }
+  LaunchParamGradKernel(x->type, x_ptr, nullptr, inv_rms_ptr, dy_ptr, rows, cols, 0.0f, dscale_ptr, nullptr, stream);
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
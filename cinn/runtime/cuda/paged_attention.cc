@@ -0,0 +1,393 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kPagedAttentionThreads       = 128;
+constexpr int kPagedAttentionPartitionSize = 512;
+constexpr int kPagedAttentionMaxHeadDim    = 256;
+
+// The caches are [num_blocks, num_kv_heads, block_size, head_dim], and the token t of a sequence is kept at the row
+// t % block_size of its block block_table[t / block_size], so the caches are preallocated once and the new tokens
+// are written in place without copying the tokens before them.
+const char* kPagedAttentionSource = R"(
+#define NUM_WARPS (THREADS / 32)
+
+__device__ __forceinline__ long long cinn_paged_offset(const int* block_table, int kv_head, int num_kv_heads,
+                                                       int block_size, int t) {
+  long long block = block_table[t / block_size];
+  return ((block * num_kv_heads + kv_head) * block_size + t % block_size) * HEAD_DIM;
+}
+
+__device__ __forceinline__ float cinn_paged_block_max(float value, float* s_reduce) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    value = fmaxf(value, __shfl_xor_sync(0xffffffff, value, offset));
+  }
+  if ((threadIdx.x & 31) == 0) s_reduce[threadIdx.x >> 5] = value;
+  __syncthreads();
+  value = s_reduce[0];
+  for (int w = 1; w < NUM_WARPS; ++w) value = fmaxf(value, s_reduce[w]);
+  __syncthreads();
+  return value;
+}
+
+__device__ __forceinline__ float cinn_paged_block_sum(float value, float* s_reduce) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    value += __shfl_xor_sync(0xffffffff, value, offset);
+  }
+  if ((threadIdx.x & 31) == 0) s_reduce[threadIdx.x >> 5] = value;
+  __syncthreads();
+  value = 0.0f;
+  for (int w = 0; w < NUM_WARPS; ++w) value += s_reduce[w];
+  __syncthreads();
+  return value;
+}
+
+// Write the key and the value of the new token of each sequence at its context length, a block for each kv head of
+// a sequence. The sequences whose block tables are full are left unchanged.
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_kv_cache_append_kernel(DTYPE* __restrict__ key_cache,
+                            DTYPE* __restrict__ value_cache,
+                            const int* __restrict__ block_tables,
+                            const int* __restrict__ context_lens,
+                            const DTYPE* __restrict__ key,
+                            const DTYPE* __restrict__ value,
+                            int block_size,
+                            int max_blocks_per_seq,
+                            int* __restrict__ new_context_lens) {
+  const int kv_head      = blockIdx.x;
+  const int num_kv_heads = gridDim.x;
+  const int b            = blockIdx.y;
+  const int pos          = context_lens[b];
+  const bool full        = pos < 0 || pos >= max_blocks_per_seq * block_size;
+  if (kv_head == 0 && threadIdx.x == 0) {
+    new_context_lens[b] = full ? pos : pos + 1;
+  }
+  if (full) return;
+  const long long dst =
+      cinn_paged_offset(block_tables + static_cast<long long>(b) * max_blocks_per_seq, kv_head, num_kv_heads,
+                        block_size, pos);
+  const long long src = (static_cast<long long>(b) * num_kv_heads + kv_head) * HEAD_DIM;
+  for (int d = threadIdx.x; d < HEAD_DIM; d += THREADS) {
+    key_cache[dst + d]   = key[src + d];
+    value_cache[dst + d] = value[src + d];
+  }
+}
+
+// The decode attention of the single query token is split along the context into the partitions of PARTITION_SIZE
+// tokens, so the long contexts still fill the device. A block computes a partition of a head of a sequence: a warp
+// computes the logit of a token at a time, then the unnormalized output of the partition is written with its max
+// logit and its sum of exponents.
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_paged_attention_partition_kernel(const DTYPE* __restrict__ query,
+                                      const DTYPE* __restrict__ key_cache,
+                                      const DTYPE* __restrict__ value_cache,
+                                      const int* __restrict__ block_tables,
+                                      const int* __restrict__ context_lens,
+                                      int num_kv_heads,
+                                      int block_size,
+                                      int max_blocks_per_seq,
+                                      float scale,
+                                      float* __restrict__ partial_max,
+                                      float* __restrict__ partial_sum,
+                                      float* __restrict__ partial_out) {
+  __shared__ float s_query[HEAD_DIM];
+  __shared__ float s_logits[PARTITION_SIZE];
+  __shared__ float s_reduce[NUM_WARPS];
+  const int h           = blockIdx.x;
+  const int num_heads   = gridDim.x;
+  const int b           = blockIdx.y;
+  const int context_len = context_lens[b];
+  const int begin       = blockIdx.z * PARTITION_SIZE;
+  if (begin >= context_len) return;
+  const int end     = min(context_len, begin + PARTITION_SIZE);
+  const int kv_head = h / (num_heads / num_kv_heads);
+  const int* block_table = block_tables + static_cast<long long>(b) * max_blocks_per_seq;
+
+  const long long q_offset = (static_cast<long long>(b) * num_heads + h) * HEAD_DIM;
+  for (int d = threadIdx.x; d < HEAD_DIM; d += THREADS) {
+    s_query[d] = static_cast<float>(query[q_offset + d]) * scale;
+  }
+  __syncthreads();
+
+  const int warp = threadIdx.x >> 5;
+  const int lane = threadIdx.x & 31;
+  for (int t = begin + warp; t < end; t += NUM_WARPS) {
+    const DTYPE* k = key_cache + cinn_paged_offset(block_table, kv_head, num_kv_heads, block_size, t);
+    float dot      = 0.0f;
+    for (int d = lane; d < HEAD_DIM; d += 32) {
+      dot += s_query[d] * static_cast<float>(k[d]);
+    }
+    for (int offset = 16; offset > 0; offset >>= 1) {
+      dot += __shfl_xor_sync(0xffffffff, dot, offset);
+    }
+    if (lane == 0) s_logits[t - begin] = dot;
+  }
+  __syncthreads();
+
+  float max_logit = -INFINITY;
+  for (int i = threadIdx.x; i < end - begin; i += THREADS) {
+    max_logit = fmaxf(max_logit, s_logits[i]);
+  }
+  max_logit = cinn_paged_block_max(max_logit, s_reduce);
+  float sum = 0.0f;
+  for (int i = threadIdx.x; i < end - begin; i += THREADS) {
+    float e     = __expf(s_logits[i] - max_logit);
+    s_logits[i] = e;
+    sum += e;
+  }
+  // the block reduction also synchronizes the exponents written above
+  sum = cinn_paged_block_sum(sum, s_reduce);
+
+  const long long partial = (static_cast<long long>(b) * num_heads + h) * gridDim.z + blockIdx.z;
+  for (int d = threadIdx.x; d < HEAD_DIM; d += THREADS) {
+    float acc = 0.0f;
+    for (int t = begin; t < end; ++t) {
+      long long offset = cinn_paged_offset(block_table, kv_head, num_kv_heads, block_size, t);
+      acc += s_logits[t - begin] * static_cast<float>(value_cache[offset + d]);
+    }
+    partial_out[partial * HEAD_DIM + d] = acc;
+  }
+  if (threadIdx.x == 0) {
+    partial_max[partial] = max_logit;
+    partial_sum[partial] = sum;
+  }
+}
+
+// Rescale the partitions of a head of a sequence by their max logits and normalize the output, the sequences of
+// empty contexts output zeros.
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_paged_attention_combine_kernel(const float* __restrict__ partial_max,
+                                    const float* __restrict__ partial_sum,
+                                    const float* __restrict__ partial_out,
+                                    const int* __restrict__ context_lens,
+                                    int max_partitions,
+                                    DTYPE* __restrict__ out) {
+  const int h              = blockIdx.x;
+  const int num_heads      = gridDim.x;
+  const int b              = blockIdx.y;
+  const int num_partitions = min(max_partitions, (max(context_lens[b], 0) + PARTITION_SIZE - 1) / PARTITION_SIZE);
+  const long long base     = (static_cast<long long>(b) * num_heads + h) * max_partitions;
+
+  float max_logit = -INFINITY;
+  for (int p = 0; p < num_partitions; ++p) {
+    max_logit = fmaxf(max_logit, partial_max[base + p]);
+  }
+  float total = 0.0f;
+  for (int p = 0; p < num_partitions; ++p) {
+    total += partial_sum[base + p] * __expf(partial_max[base + p] - max_logit);
+  }
+  const float inv_total = total > 0.0f ? 1.0f / total : 0.0f;
+  const long long out_offset = (static_cast<long long>(b) * num_heads + h) * HEAD_DIM;
+  for (int d = threadIdx.x; d < HEAD_DIM; d += THREADS) {
+    float acc = 0.0f;
+    for (int p = 0; p < num_partitions; ++p) {
+      acc += partial_out[(base + p) * HEAD_DIM + d] * __expf(partial_max[base + p] - max_logit);
+    }
+    out[out_offset + d] = static_cast<DTYPE>(acc * inv_total);
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  }
+  LOG(FATAL) << "The paged attention only supports float32, float16 and bfloat16, but got the type code "
+             << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+// The kernels are compiled by NVRTC once for each dtype and head size.
+CUDAModule* GetPagedAttentionModule(const cinn_type_t& type, int head_dim) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto dtype = GetDTypeName(type);
+  auto key   = dtype + "_" + std::to_string(head_dim);
+  auto it    = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define HEAD_DIM " + std::to_string(head_dim) + "\n";
+  source += "#define THREADS " + std::to_string(kPagedAttentionThreads) + "\n";
+  source += "#define PARTITION_SIZE " + std::to_string(kPagedAttentionPartitionSize) + "\n";
+  source += kPagedAttentionSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the paged attention kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+}  // namespace
+
+void cinn_call_kv_cache_append_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_kv_heads,
+                                     int head_dim,
+                                     int block_size,
+                                     int max_blocks_per_seq,
+                                     void* stream) {
+  CHECK_EQ(num_args, 7) << "The kv_cache_append takes the key_cache, the value_cache, the block_tables, the "
+                           "context_lens, the key, the value and outputs the new context_lens.";
+  CHECK_LE(head_dim, kPagedAttentionMaxHeadDim) << "The head size of the paged attention is too large";
+  cinn_pod_value_t* args   = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* key_cache = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "kv_cache_append: batch_size=" << batch_size << ", num_kv_heads=" << num_kv_heads
+          << ", head_dim=" << head_dim << ", block_size=" << block_size
+          << ", max_blocks_per_seq=" << max_blocks_per_seq;
+  if (batch_size == 0) {
+    return;
+  }
+
+  // the caches are updated in place, only the context lengths are output
+  void* key_cache_ptr    = key_cache->memory;
+  void* value_cache_ptr  = args[1].operator cinn_buffer_t*()->memory;
+  void* block_tables_ptr = args[2].operator cinn_buffer_t*()->memory;
+  void* context_lens_ptr = args[3].operator cinn_buffer_t*()->memory;
+  void* key_ptr          = args[4].operator cinn_buffer_t*()->memory;
+  void* value_ptr        = args[5].operator cinn_buffer_t*()->memory;
+  void* new_context_lens = args[6].operator cinn_buffer_t*()->memory;
+  void* kernel_args[]    = {&key_cache_ptr,
+                         &value_cache_ptr,
+                         &block_tables_ptr,
+                         &context_lens_ptr,
+                         &key_ptr,
+                         &value_ptr,
+                         &block_size,
+                         &max_blocks_per_seq,
+                         &new_context_lens};
+  auto* module = GetPagedAttentionModule(key_cache->type, head_dim);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_kv_cache_append_kernel",
+                       dim3(num_kv_heads, batch_size),
+                       dim3(kPagedAttentionThreads),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+void cinn_call_paged_attention_nvgpu(void* v_args,
+                                     int num_args,
+                                     int batch_size,
+                                     int num_heads,
+                                     int num_kv_heads,
+                                     int head_dim,
+                                     int block_size,
+                                     int max_blocks_per_seq,
+                                     float scale,
+                                     void* stream) {
+  CHECK_EQ(num_args, 6) << "The paged_attention takes the query, the key_cache, the value_cache, the block_tables, "
+                           "the context_lens and outputs the attention of the query.";
+  CHECK_LE(head_dim, kPagedAttentionMaxHeadDim) << "The head size of the paged attention is too large";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* query   = args[0].operator cinn_buffer_t*();
+  VLOG(4) << "paged_attention: batch_size=" << batch_size << ", num_heads=" << num_heads
+          << ", num_kv_heads=" << num_kv_heads << ", head_dim=" << head_dim << ", block_size=" << block_size
+          << ", max_blocks_per_seq=" << max_blocks_per_seq << ", scale=" << scale;
+  if (batch_size == 0 || num_heads == 0) {
+    return;
+  }
+
+  void* query_ptr        = query->memory;
+  void* key_cache_ptr    = args[1].operator cinn_buffer_t*()->memory;
+  void* value_cache_ptr  = args[2].operator cinn_buffer_t*()->memory;
+  void* block_tables_ptr = args[3].operator cinn_buffer_t*()->memory;
+  void* context_lens_ptr = args[4].operator cinn_buffer_t*()->memory;
+  void* out_ptr          = args[5].operator cinn_buffer_t*()->memory;
+
+  // the partitions beyond the context length of a sequence exit at once
+  int max_partitions =
+      std::max((max_blocks_per_seq * block_size + kPagedAttentionPartitionSize - 1) / kPagedAttentionPartitionSize, 1);
+  size_t num_partials = static_cast<size_t>(batch_size) * num_heads * max_partitions;
+  auto cuda_stream    = static_cast<cudaStream_t>(stream);
+  void* partial_max;
+  void* partial_sum;
+  void* partial_out;
+  CUDA_CALL(cudaMallocAsync(&partial_max, sizeof(float) * num_partials, cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&partial_sum, sizeof(float) * num_partials, cuda_stream));
+  CUDA_CALL(cudaMallocAsync(&partial_out, sizeof(float) * num_partials * head_dim, cuda_stream));
+
+  auto* module = GetPagedAttentionModule(query->type, head_dim);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  void* partition_args[] = {&query_ptr,
+                            &key_cache_ptr,
+                            &value_cache_ptr,
+                            &block_tables_ptr,
+                            &context_lens_ptr,
+                            &num_kv_heads,
+                            &block_size,
+                            &max_blocks_per_seq,
+                            &scale,
+                            &partial_max,
+                            &partial_sum,
+                            &partial_out};
+  module->LaunchKernel(device_id,
+                       "cinn_paged_attention_partition_kernel",
+                       dim3(num_heads, batch_size, max_partitions),
+                       dim3(kPagedAttentionThreads),
+                       partition_args,
+                       0,
+                       static_cast<CUstream>(stream));
+  void* combine_args[] = {&partial_max, &partial_sum, &partial_out, &context_lens_ptr, &max_partitions, &out_ptr};
+  module->LaunchKernel(device_id,
+                       "cinn_paged_attention_combine_kernel",
+                       dim3(num_heads, batch_size),
+                       dim3(kPagedAttentionThreads),
+                       combine_args,
+                       0,
+                       static_cast<CUstream>(stream));
+
+  CUDA_CALL(cudaFreeAsync(partial_max, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(partial_sum, cuda_stream));
+  CUDA_CALL(cudaFreeAsync(partial_out, cuda_stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,354 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+// A tile of kScanBlockSize * kScanItemsPerThread elements of a segment is scanned by a block. The segments no longer
+// than kSerialScanMaxSize, and the many segments strided by the inner dimensions, are scanned by a thread each.
+constexpr int kScanBlockSize         = 256;
+constexpr int kScanItemsPerThread    = 8;
+constexpr int kScanTileSize          = kScanBlockSize * kScanItemsPerThread;
+constexpr int kSerialScanBlockSize   = 256;
+constexpr int kSerialScanMaxSize     = 16;
+constexpr int kSerialScanMinSegments = 16384;
+
+const char* kScanSource = R"(
+#define STATUS_INVALID 0
+#define STATUS_AGGREGATE 1
+#define STATUS_PREFIX 2
+// the shared memory of a tile is padded by an element every 32 ones, so that the threads reading their ITEMS
+// consecutive elements don't conflict on the banks
+#define PADDED(i) ((i) + (i) / 32)
+
+// Every thread scans a segment serially, and the consecutive threads take the consecutive segments of the inner
+// dimensions, so the accesses are coalesced when the inner size is large.
+extern "C" __global__ void cinn_serial_scan_kernel(const DTYPE* __restrict__ x,
+                                                   int num_segments,
+                                                   int axis_size,
+                                                   int inner,
+                                                   int exclusive,
+                                                   int reverse,
+                                                   DTYPE* out) {
+  const int seg = blockIdx.x * blockDim.x + threadIdx.x;
+  if (seg >= num_segments) return;
+  const long long base = static_cast<long long>(seg / inner) * axis_size * inner + seg % inner;
+  ACC_T acc            = IDENTITY;
+  for (int i = 0; i < axis_size; ++i) {
+    long long offset = base + static_cast<long long>(reverse ? axis_size - 1 - i : i) * inner;
+    ACC_T value      = static_cast<ACC_T>(x[offset]);
+    if (exclusive) {
+      out[offset] = static_cast<DTYPE>(acc);
+      acc         = SCAN_OP(acc, value);
+    } else {
+      acc         = SCAN_OP(acc, value);
+      out[offset] = static_cast<DTYPE>(acc);
+    }
+  }
+}
+
+// The single-pass scan with the decoupled look-back of Merrill and Garland. Every block scans a tile of a segment and
+// publishes the aggregate of the tile, then the first warp looks back on the status of the preceding tiles of the
+// segment, 32 tiles at a time, until it meets a tile whose inclusive prefix is published. So the input is read and
+// the output is written only once, and a tile never waits for all of the preceding tiles to be done.
+extern "C" __global__ void __launch_bounds__(BLOCK) cinn_look_back_scan_kernel(const DTYPE* __restrict__ x,
+                                                                               int axis_size,
+                                                                               int inner,
+                                                                               int num_tiles,
+                                                                               int exclusive,
+                                                                               int reverse,
+                                                                               DTYPE* out,
+                                                                               unsigned int* tile_counter,
+                                                                               volatile int* status,
+                                                                               volatile ACC_T* aggregates,
+                                                                               volatile ACC_T* prefixes) {
+  __shared__ ACC_T items[PADDED(TILE)];
+  __shared__ int tile_id;
+  __shared__ ACC_T tile_aggregate;
+  __shared__ ACC_T tile_prefix;
+  // the tiles are numbered in the order the blocks start rather than by blockIdx, so the preceding tiles of a tile
+  // are always running or done, and the look-back never waits for a block that is not resident
+  if (threadIdx.x == 0) tile_id = atomicAdd(tile_counter, 1);
+  __syncthreads();
+  const int seg        = tile_id / num_tiles;
+  const int tile       = tile_id % num_tiles;
+  const int tile_start = tile * TILE;
+  const long long base = static_cast<long long>(seg / inner) * axis_size * inner + seg % inner;
+
+  for (int i = threadIdx.x; i < TILE; i += BLOCK) {
+    int pos          = tile_start + i;
+    int idx          = reverse ? axis_size - 1 - pos : pos;
+    items[PADDED(i)] =
+        pos < axis_size ? static_cast<ACC_T>(x[base + static_cast<long long>(idx) * inner]) : IDENTITY;
+  }
+  __syncthreads();
+
+  // every thread scans its ITEMS consecutive elements in the registers, then the block scans the thread totals
+  ACC_T local[ITEMS];
+  ACC_T thread_total = IDENTITY;
+#pragma unroll
+  for (int k = 0; k < ITEMS; ++k) {
+    ACC_T value  = items[PADDED(threadIdx.x * ITEMS + k)];
+    local[k]     = exclusive ? thread_total : SCAN_OP(thread_total, value);
+    thread_total = SCAN_OP(thread_total, value);
+  }
+  ACC_T thread_prefix = BLOCK_SCAN(thread_total, true);
+  if (threadIdx.x == BLOCK - 1) tile_aggregate = SCAN_OP(thread_prefix, thread_total);
+  __syncthreads();
+
+  if (threadIdx.x < 32) {
+    const int lane                 = threadIdx.x;
+    const long long status_base    = static_cast<long long>(seg) * num_tiles;
+    volatile int* seg_status       = status + status_base;
+    volatile ACC_T* seg_aggregates = aggregates + status_base;
+    volatile ACC_T* seg_prefixes   = prefixes + status_base;
+    const ACC_T aggregate          = tile_aggregate;
+    ACC_T prefix                   = IDENTITY;
+    if (tile > 0) {
+      if (lane == 0) {
+        seg_aggregates[tile] = aggregate;
+        __threadfence();
+        seg_status[tile] = STATUS_AGGREGATE;
+      }
+      // the lane k inspects the (k + 1)-th preceding tile of the window
+      for (int pred = tile - 1 - lane;; pred -= 32) {
+        int flag    = STATUS_PREFIX;
+        ACC_T value = IDENTITY;
+        if (pred >= 0) {
+          do {
+            flag = seg_status[pred];
+          } while (flag == STATUS_INVALID);
+          __threadfence();
+          value = flag == STATUS_PREFIX ? seg_prefixes[pred] : seg_aggregates[pred];
+        }
+        // the nearest tile with the inclusive prefix closes the window, the tiles before it are counted by it
+        const unsigned int closed = __ballot_sync(0xffffffff, flag == STATUS_PREFIX);
+        if (closed && lane > __ffs(closed) - 1) value = IDENTITY;
+        for (int offset = 16; offset > 0; offset >>= 1) {
+          value = SCAN_OP(value, __shfl_xor_sync(0xffffffff, value, offset));
+        }
+        prefix = SCAN_OP(value, prefix);
+        if (closed) break;
+      }
+    }
+    if (lane == 0) {
+      seg_prefixes[tile] = SCAN_OP(prefix, aggregate);
+      __threadfence();
+      seg_status[tile] = STATUS_PREFIX;
+      tile_prefix      = prefix;
+    }
+  }
+  __syncthreads();
+
+  const ACC_T prefix = SCAN_OP(tile_prefix, thread_prefix);
+#pragma unroll
+  for (int k = 0; k < ITEMS; ++k) {
+    items[PADDED(threadIdx.x * ITEMS + k)] = SCAN_OP(prefix, local[k]);
+  }
+  __syncthreads();
+  for (int i = threadIdx.x; i < TILE; i += BLOCK) {
+    int pos = tile_start + i;
+    if (pos < axis_size) {
+      int idx = reverse ? axis_size - 1 - pos : pos;
+      out[base + static_cast<long long>(idx) * inner] = static_cast<DTYPE>(items[PADDED(i)]);
+    }
+  }
+}
+)";
+
+// The float16 and bfloat16 are accumulated in float, the same as the reduce ops.
+struct ScanDataType {
+  std::string dtype;
+  std::string acc_type;
+  std::string suffix;
+  int acc_bytes;
+};
+
+ScanDataType GetScanDataType(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return {"float", "float", "fp32", 4};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 64) {
+    return {"double", "double", "fp64", 8};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return {"float16", "float", "fp32", 4};
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return {"bfloat16", "float", "fp32", 4};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return {"int", "int", "int32", 4};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return {"long long int", "long long int", "int64", 8};
+  }
+  LOG(FATAL) << "The scan only supports float32, float64, float16, bfloat16, int32 and int64, but got type code "
+             << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return {};
+}
+
+// The identities are the initial values of the reduce ops of cinn_cuda_runtime_source.cuh.
+std::string GetScanIdentity(const std::string& scan_op, const ScanDataType& data_type) {
+  if (scan_op == "sum") {
+    return "0";
+  } else if (scan_op == "prod") {
+    return "1";
+  }
+  CHECK_EQ(scan_op, "max") << "The scan only supports sum, prod and max";
+  if (data_type.suffix == "fp32") {
+    return "-3.40282e+38f";
+  } else if (data_type.suffix == "fp64") {
+    return "-1.79769e+308";
+  } else if (data_type.suffix == "int32") {
+    return "(-2147483647 - 1)";
+  }
+  return "(-9223372036854775807LL - 1)";
+}
+
+// The kernels are compiled by NVRTC once for each scan op and each dtype.
+CUDAModule* GetScanModule(const std::string& scan_op, const ScanDataType& data_type) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto key = scan_op + "_" + data_type.dtype;
+  auto it  = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + data_type.dtype + "\n";
+  source += "#define ACC_T " + data_type.acc_type + "\n";
+  source += "#define SCAN_OP cinn_" + scan_op + "_" + data_type.suffix + "\n";
+  source += "#define BLOCK_SCAN cinn_block_scan_" + scan_op + "_" + data_type.suffix + "\n";
+  source += "#define IDENTITY (" + data_type.acc_type + ")(" + GetScanIdentity(scan_op, data_type) + ")\n";
+  source += "#define BLOCK " + std::to_string(kScanBlockSize) + "\n";
+  source += "#define ITEMS " + std::to_string(kScanItemsPerThread) + "\n";
+  source += "#define TILE " + std::to_string(kScanTileSize) + "\n";
+  source += kScanSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the scan kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+void ScanSegments(const std::string& scan_op,
+                  void* v_args,
+                  int num_args,
+                  int outer,
+                  int axis_size,
+                  int inner,
+                  bool exclusive,
+                  bool reverse,
+                  cudaStream_t stream) {
+  CHECK_EQ(num_args, 2) << "The cum" << scan_op << " takes the input and the output.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* out     = args[1].operator cinn_buffer_t*();
+  VLOG(4) << "cum" << scan_op << ": outer=" << outer << ", axis_size=" << axis_size << ", inner=" << inner
+          << ", exclusive=" << exclusive << ", reverse=" << reverse;
+  int num_segments = outer * inner;
+  if (num_segments == 0 || axis_size == 0) {
+    return;
+  }
+  auto data_type   = GetScanDataType(x->type);
+  auto* module     = GetScanModule(scan_op, data_type);
+  void* x_ptr      = x->memory;
+  void* out_ptr    = out->memory;
+  int is_exclusive = exclusive;
+  int is_reverse   = reverse;
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+
+  if (axis_size <= kSerialScanMaxSize || (inner > 1 && num_segments >= kSerialScanMinSegments)) {
+    void* kernel_args[] = {&x_ptr, &num_segments, &axis_size, &inner, &is_exclusive, &is_reverse, &out_ptr};
+    module->LaunchKernel(device_id,
+                         "cinn_serial_scan_kernel",
+                         dim3((num_segments + kSerialScanBlockSize - 1) / kSerialScanBlockSize),
+                         dim3(kSerialScanBlockSize),
+                         kernel_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    return;
+  }
+
+  int num_tiles = (axis_size + kScanTileSize - 1) / kScanTileSize;
+  CHECK_LE(static_cast<int64_t>(num_segments) * num_tiles, std::numeric_limits<int>::max())
+      << "Too many tiles for the scan";
+  size_t num_status = static_cast<size_t>(num_segments) * num_tiles;
+  // the tile counter is followed by the status of the tiles, both are cleared before the launch
+  void* counter;
+  void* values;
+  CUDA_CALL(cudaMallocAsync(&counter, (num_status + 1) * sizeof(int), stream));
+  CUDA_CALL(cudaMemsetAsync(counter, 0, (num_status + 1) * sizeof(int), stream));
+  CUDA_CALL(cudaMallocAsync(&values, 2 * num_status * data_type.acc_bytes, stream));
+  void* status        = static_cast<int*>(counter) + 1;
+  void* aggregates    = values;
+  void* prefixes      = static_cast<char*>(values) + num_status * data_type.acc_bytes;
+  void* kernel_args[] = {
+      &x_ptr, &axis_size, &inner, &num_tiles, &is_exclusive, &is_reverse, &out_ptr, &counter, &status, &aggregates,
+      &prefixes};
+  module->LaunchKernel(device_id,
+                       "cinn_look_back_scan_kernel",
+                       dim3(num_segments * num_tiles),
+                       dim3(kScanBlockSize),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+  CUDA_CALL(cudaFreeAsync(counter, stream));
+  CUDA_CALL(cudaFreeAsync(values, stream));
+}
+
+}  // namespace
+
+void cinn_call_cumsum_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool exclusive, bool reverse, void* stream) {
+  ScanSegments(
+      "sum", v_args, num_args, outer, axis_size, inner, exclusive, reverse, static_cast<cudaStream_t>(stream));
+}
+
+void cinn_call_cumprod_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool exclusive, bool reverse, void* stream) {
+  ScanSegments(
+      "prod", v_args, num_args, outer, axis_size, inner, exclusive, reverse, static_cast<cudaStream_t>(stream));
+}
+
+void cinn_call_cummax_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool exclusive, bool reverse, void* stream) {
+  ScanSegments(
+      "max", v_args, num_args, outer, axis_size, inner, exclusive, reverse, static_cast<cudaStream_t>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
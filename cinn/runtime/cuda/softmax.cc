@@ -0,0 +1,358 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kSoftmaxWarpRowMaxCols   = 1024;
+constexpr int kSoftmaxItemsPerThread   = 16;
+constexpr int kSoftmaxMaxItems         = 32;
+constexpr int kSoftmaxMaxRowThreads    = 1024;
+constexpr int kSoftmaxRowsPerWarpBlock = 4;
+
+// Each row is computed by ROW_THREADS threads of the block and a block holds ROWS_PER_BLOCK rows. The maximum and the
+// sum of the exponents are accumulated online in one pass, the sum is rescaled whenever a larger maximum is found. A
+// thread keeps ITEMS values of its row in registers, so the input is read only once, the rows too long for the
+// registers (ITEMS is 0) are read from the global memory again instead.
+//
+// The value of a column is `x * scale + mask`, where the mask row of the leading index is found by the strides of
+// the up to 3 leading dimensions. A packed mask (PACKED_MASK is 1) holds a bit of each column in 32-bit words instead,
+// the column of a set bit is kept and the others are masked out by -inf. The output is the softmax, or the log_softmax
+// if log_softmax is true. When the label is given, the loss of the cross entropy `-log_softmax[label]` is written too,
+// the loss of ignore_index is 0.
+const char* kSoftmaxSource = R"(
+#define NUM_WARPS (ROW_THREADS / 32)
+#define CINN_NEG_INF __int_as_float(0xff800000)
+
+__device__ __forceinline__ void cinn_softmax_merge(float& max_value, float& sum, float b_max_value, float b_sum) {
+  float new_max = fmaxf(max_value, b_max_value);
+  if (new_max == CINN_NEG_INF) return;
+  sum       = sum * expf(max_value - new_max) + b_sum * expf(b_max_value - new_max);
+  max_value = new_max;
+}
+
+// Merge the online softmax states of all the threads of a row, every thread gets the same result.
+__device__ __forceinline__ void cinn_row_softmax_state(float& max_value, float& sum) {
+  for (int offset = 16; offset > 0; offset >>= 1) {
+    float b_max_value = __shfl_xor_sync(0xffffffff, max_value, offset);
+    float b_sum       = __shfl_xor_sync(0xffffffff, sum, offset);
+    cinn_softmax_merge(max_value, sum, b_max_value, b_sum);
+  }
+#if NUM_WARPS > 1
+  __shared__ float s_max[ROWS_PER_BLOCK][NUM_WARPS];
+  __shared__ float s_sum[ROWS_PER_BLOCK][NUM_WARPS];
+  if ((threadIdx.x & 31) == 0) {
+    s_max[threadIdx.y][threadIdx.x >> 5] = max_value;
+    s_sum[threadIdx.y][threadIdx.x >> 5] = sum;
+  }
+  __syncthreads();
+  max_value = s_max[threadIdx.y][0];
+  sum       = s_sum[threadIdx.y][0];
+  for (int w = 1; w < NUM_WARPS; ++w) {
+    cinn_softmax_merge(max_value, sum, s_max[threadIdx.y][w], s_sum[threadIdx.y][w]);
+  }
+#endif
+}
+
+#if PACKED_MASK
+#define MASK_VALUE(col) (((mask_row[(col) >> 5] >> ((col) & 31)) & 1) ? 0.0f : CINN_NEG_INF)
+#else
+#define MASK_VALUE(col) static_cast<float>(mask_row[col])
+#endif
+#define SOFTMAX_VALUE(col) (static_cast<float>(x_row[col]) * scale + (mask_row ? MASK_VALUE(col) : 0.0f))
+
+#if ITEMS > 0
+#define FOR_EACH_COL(i, col)  \
+  _Pragma("unroll")           \
+  for (int i = 0, col = threadIdx.x; i < ITEMS; ++i, col += ROW_THREADS) if (col < cols)
+#define LOAD_ROW(buf) FOR_EACH_COL(i, col) buf[i] = SOFTMAX_VALUE(col);
+#define ROW_VALUE(buf) buf[i]
+#define ITEMS_BUF ITEMS
+#else
+#define FOR_EACH_COL(i, col) for (int i = 0, col = threadIdx.x; col < cols; ++i, col += ROW_THREADS)
+#define LOAD_ROW(buf)
+#define ROW_VALUE(buf) SOFTMAX_VALUE(col)
+#define ITEMS_BUF 1
+#endif
+
+extern "C" __global__ void __launch_bounds__(ROW_THREADS * ROWS_PER_BLOCK)
+cinn_fused_softmax_kernel(const DTYPE* __restrict__ x,
+                          const MASK_DTYPE* __restrict__ mask,
+                          const LABEL_DTYPE* __restrict__ label,
+                          int rows,
+                          int cols,
+                          float scale,
+                          int mask_dim1,
+                          int mask_dim2,
+                          int mask_stride0,
+                          int mask_stride1,
+                          int mask_stride2,
+                          bool log_softmax,
+                          int ignore_index,
+                          DTYPE* __restrict__ y,
+                          DTYPE* __restrict__ loss) {
+  const int row = blockIdx.x * ROWS_PER_BLOCK + threadIdx.y;
+  // the threads of the out of range rows still take part in the block reduction
+  const bool active  = row < rows;
+  const int safe_row = active ? row : 0;
+  const DTYPE* x_row = x + static_cast<long long>(safe_row) * cols;
+  const MASK_DTYPE* mask_row = nullptr;
+  if (mask) {
+    const int i2 = safe_row % mask_dim2;
+    const int i1 = (safe_row / mask_dim2) % mask_dim1;
+    const int i0 = safe_row / mask_dim2 / mask_dim1;
+    mask_row = mask + static_cast<long long>(i0) * mask_stride0 + static_cast<long long>(i1) * mask_stride1 +
+               static_cast<long long>(i2) * mask_stride2;
+  }
+  float values[ITEMS_BUF];
+  LOAD_ROW(values)
+
+  float max_value = CINN_NEG_INF, sum = 0.0f;
+  FOR_EACH_COL(i, col) { cinn_softmax_merge(max_value, sum, ROW_VALUE(values), 1.0f); }
+  cinn_row_softmax_state(max_value, sum);
+  if (!active) return;
+
+  const float log_sum = logf(sum);
+  const float inv_sum = 1.0f / sum;
+  DTYPE* y_row = y + static_cast<long long>(row) * cols;
+  FOR_EACH_COL(i, col) {
+    float shifted = ROW_VALUE(values) - max_value;
+    y_row[col]    = static_cast<DTYPE>(log_softmax ? shifted - log_sum : expf(shifted) * inv_sum);
+  }
+  if (label && threadIdx.x == 0) {
+    const long long index = static_cast<long long>(label[row]);
+    float row_loss        = 0.0f;
+    if (index != ignore_index && index >= 0 && index < cols) {
+      row_loss = log_sum + max_value - SOFTMAX_VALUE(index);
+    }
+    loss[row] = static_cast<DTYPE>(row_loss);
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  }
+  LOG(FATAL) << "The softmax kernels only support float32, float16 and bfloat16, but got the type code " << type.code
+             << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+std::string GetLabelDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return "int";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return "long long";
+  }
+  LOG(FATAL) << "The label of the softmax cross entropy only supports int32 and int64, but got the type code "
+             << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return "";
+}
+
+int NextPowerOfTwo(int value) {
+  int result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+struct SoftmaxConfig {
+  int row_threads;
+  int rows_per_block;
+  int items;
+};
+
+// The short rows are computed by a warp each and several rows share a block, the long rows are split among the
+// threads of a block so that each thread keeps at most kSoftmaxMaxItems values in registers.
+SoftmaxConfig GetSoftmaxConfig(int cols) {
+  if (cols <= kSoftmaxWarpRowMaxCols) {
+    return {32, kSoftmaxRowsPerWarpBlock, NextPowerOfTwo((cols + 31) / 32)};
+  }
+  int row_threads =
+      std::min(NextPowerOfTwo((cols + kSoftmaxItemsPerThread - 1) / kSoftmaxItemsPerThread), kSoftmaxMaxRowThreads);
+  int items = NextPowerOfTwo((cols + row_threads - 1) / row_threads);
+  return {row_threads, 1, items > kSoftmaxMaxItems ? 0 : items};
+}
+
+// The kernel is compiled by NVRTC once for each dtype, mask layout and configuration.
+CUDAModule* GetSoftmaxModule(const std::string& dtype,
+                             const std::string& label_dtype,
+                             bool packed_mask,
+                             const SoftmaxConfig& config) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto key = dtype + "_" + label_dtype + "_" + std::to_string(packed_mask) + "_" + std::to_string(config.row_threads) +
+             "_" + std::to_string(config.rows_per_block) + "_" + std::to_string(config.items);
+  auto it = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define LABEL_DTYPE " + label_dtype + "\n";
+  source += "#define MASK_DTYPE " + (packed_mask ? std::string("int") : dtype) + "\n";
+  source += "#define PACKED_MASK " + std::to_string(packed_mask) + "\n";
+  source += "#define ROW_THREADS " + std::to_string(config.row_threads) + "\n";
+  source += "#define ROWS_PER_BLOCK " + std::to_string(config.rows_per_block) + "\n";
+  source += "#define ITEMS " + std::to_string(config.items) + "\n";
+  source += kSoftmaxSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the softmax kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+void LaunchSoftmaxKernel(const std::string& dtype,
+                         const std::string& label_dtype,
+                         bool packed_mask,
+                         int rows,
+                         int cols,
+                         void** kernel_args,
+                         void* stream) {
+  auto config  = GetSoftmaxConfig(cols);
+  auto* module = GetSoftmaxModule(dtype, label_dtype, packed_mask, config);
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_fused_softmax_kernel",
+                       dim3((rows + config.rows_per_block - 1) / config.rows_per_block),
+                       dim3(config.row_threads, config.rows_per_block),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+}  // namespace
+
+void cinn_call_fused_softmax_nvgpu(void* v_args,
+                                   int num_args,
+                                   int rows,
+                                   int cols,
+                                   float scale,
+                                   bool log_softmax,
+                                   int mask_dim1,
+                                   int mask_dim2,
+                                   int mask_stride0,
+                                   int mask_stride1,
+                                   int mask_stride2,
+                                   void* stream) {
+  CHECK(num_args == 2 || num_args == 3) << "The fused_softmax takes the x, an optional mask and outputs the y.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  // a mask of int32 words is the bit-packed bool mask of pack_mask
+  bool packed_mask = num_args == 3 && args[1].operator cinn_buffer_t*()->type.code == cinn_type_code_t::cinn_type_int;
+  VLOG(4) << "fused_softmax: rows=" << rows << ", cols=" << cols << ", scale=" << scale
+          << ", log_softmax=" << log_softmax << ", has_mask=" << (num_args == 3)
+          << ", packed_mask=" << packed_mask;
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  void* x_ptr         = x->memory;
+  void* mask_ptr      = num_args == 3 ? args[1].operator cinn_buffer_t*()->memory : nullptr;
+  void* label_ptr     = nullptr;
+  void* y_ptr         = args[num_args - 1].operator cinn_buffer_t*()->memory;
+  void* loss_ptr      = nullptr;
+  int ignore_index    = -1;
+  void* kernel_args[] = {&x_ptr,
+                         &mask_ptr,
+                         &label_ptr,
+                         &rows,
+                         &cols,
+                         &scale,
+                         &mask_dim1,
+                         &mask_dim2,
+                         &mask_stride0,
+                         &mask_stride1,
+                         &mask_stride2,
+                         &log_softmax,
+                         &ignore_index,
+                         &y_ptr,
+                         &loss_ptr};
+  LaunchSoftmaxKernel(GetDTypeName(x->type), "long long", packed_mask, rows, cols, kernel_args, stream);
+}
+
+void cinn_call_softmax_cross_entropy_nvgpu(
+    void* v_args, int num_args, int rows, int cols, int ignore_index, void* stream) {
+  CHECK_EQ(num_args, 4) << "The softmax_cross_entropy takes the logits, the label and outputs the softmax and the "
+                           "loss.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* logits  = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* label   = args[1].operator cinn_buffer_t*();
+  VLOG(4) << "softmax_cross_entropy: rows=" << rows << ", cols=" << cols << ", ignore_index=" << ignore_index;
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  void* x_ptr         = logits->memory;
+  void* mask_ptr      = nullptr;
+  void* label_ptr     = label->memory;
+  void* y_ptr         = args[2].operator cinn_buffer_t*()->memory;
+  void* loss_ptr      = args[3].operator cinn_buffer_t*()->memory;
+  float scale         = 1.0f;
+  int mask_dim        = 1;
+  int mask_stride     = 0;
+  bool log_softmax    = false;
+  void* kernel_args[] = {&x_ptr,
+                         &mask_ptr,
+                         &label_ptr,
+                         &rows,
+                         &cols,
+                         &scale,
+                         &mask_dim,
+                         &mask_dim,
+                         &mask_stride,
+                         &mask_stride,
+                         &mask_stride,
+                         &log_softmax,
+                         &ignore_index,
+                         &y_ptr,
+                         &loss_ptr};
+  LaunchSoftmaxKernel(
+      GetDTypeName(logits->type), GetLabelDTypeName(label->type), false, rows, cols, kernel_args, stream);
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
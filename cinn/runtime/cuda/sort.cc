@@ -0,0 +1,628 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+// The segments no longer than kBlockSortMaxSize are sorted in the shared memory by one block, the longer ones are
+// sorted by the device-wide radix sort.
+constexpr int kBlockSortMaxSize   = 2048;
+constexpr int kBlockSortBlockSize = 1024;
+constexpr int kRadixTileSize      = 512;
+constexpr int kRadixBits          = 8;
+constexpr int kRadixScanBlockSize = 1024;
+constexpr int kTopKBlockSize      = 256;
+constexpr int kTopKMaxFastK       = 32;
+
+// The keys are mapped to unsigned bits ordered the same as the keys, and the bits are inverted for the descending
+// order. The ties are always broken by the smaller index first, so all the kernels are stable.
+const char* kSortCommonSource = R"(
+__device__ __forceinline__ BITS_T cinn_sort_key_bits(DTYPE value, int descending) {
+  KEY_T key = static_cast<KEY_T>(value);
+  BITS_T bits = *reinterpret_cast<BITS_T*>(&key);
+  const BITS_T sign = static_cast<BITS_T>(1) << (NUM_BITS - 1);
+#if IS_FLOAT
+  bits = (bits & sign) ? ~bits : (bits | sign);
+#else
+  bits = bits ^ sign;
+#endif
+  return descending ? ~bits : bits;
+}
+
+// Write the rank-th element of the sorted segment, whose index is the position on the axis of the input.
+__device__ __forceinline__ void cinn_sort_write(const DTYPE* x,
+                                                int seg,
+                                                int rank,
+                                                int index,
+                                                int axis_size,
+                                                int inner,
+                                                int out_axis,
+                                                DTYPE* values,
+                                                int* index32,
+                                                long long* index64,
+                                                int* ranks) {
+  long long in_offset  = (static_cast<long long>(seg / inner) * axis_size + index) * inner + seg % inner;
+  long long out_offset = (static_cast<long long>(seg / inner) * out_axis + rank) * inner + seg % inner;
+  if (values) values[out_offset] = x[in_offset];
+  if (index32) index32[out_offset] = index;
+  if (index64) index64[out_offset] = index;
+  if (ranks) ranks[in_offset] = rank;
+}
+
+// The exclusive prefix sum over the block, whose size must be a multiple of the warp size.
+__device__ int cinn_block_exclusive_scan(int value, int* total) {
+  __shared__ int warp_sums[32];
+  const int lane = threadIdx.x & 31;
+  const int warp = threadIdx.x >> 5;
+  const int num_warps = blockDim.x >> 5;
+  int inclusive = value;
+  for (int offset = 1; offset < 32; offset <<= 1) {
+    int other = __shfl_up_sync(0xffffffff, inclusive, offset);
+    if (lane >= offset) inclusive += other;
+  }
+  if (lane == 31) warp_sums[warp] = inclusive;
+  __syncthreads();
+  if (warp == 0) {
+    int sum = lane < num_warps ? warp_sums[lane] : 0;
+    for (int offset = 1; offset < 32; offset <<= 1) {
+      int other = __shfl_up_sync(0xffffffff, sum, offset);
+      if (lane >= offset) sum += other;
+    }
+    warp_sums[lane] = sum;
+  }
+  __syncthreads();
+  int result = (warp > 0 ? warp_sums[warp - 1] : 0) + inclusive - value;
+  *total = warp_sums[num_warps - 1];
+  __syncthreads();
+  return result;
+}
+)";
+
+// Each block sorts one segment padded to SORT_SIZE elements by the bitonic sort in the shared memory.
+const char* kBlockSortSource = R"(
+extern "C" __global__ void __launch_bounds__(BLOCK) cinn_block_sort_kernel(const DTYPE* __restrict__ x,
+                                                                           int axis_size,
+                                                                           int inner,
+                                                                           int out_axis,
+                                                                           int descending,
+                                                                           DTYPE* values,
+                                                                           int* index32,
+                                                                           long long* index64,
+                                                                           int* ranks) {
+  __shared__ BITS_T keys[SORT_SIZE];
+  __shared__ int index[SORT_SIZE];
+  const int seg = blockIdx.x;
+  const long long base = static_cast<long long>(seg / inner) * axis_size * inner + seg % inner;
+  for (int i = threadIdx.x; i < SORT_SIZE; i += blockDim.x) {
+    keys[i]  = i < axis_size ? cinn_sort_key_bits(x[base + static_cast<long long>(i) * inner], descending)
+                             : ~static_cast<BITS_T>(0);
+    index[i] = i;
+  }
+  for (int size = 2; size <= SORT_SIZE; size <<= 1) {
+    for (int stride = size >> 1; stride > 0; stride >>= 1) {
+      __syncthreads();
+      for (int t = threadIdx.x; t < SORT_SIZE / 2; t += blockDim.x) {
+        int a = 2 * t - (t & (stride - 1));
+        int b = a + stride;
+        bool greater = keys[a] > keys[b] || (keys[a] == keys[b] && index[a] > index[b]);
+        if (greater == ((a & size) == 0)) {
+          BITS_T key = keys[a];
+          keys[a]    = keys[b];
+          keys[b]    = key;
+          int idx    = index[a];
+          index[a]   = index[b];
+          index[b]   = idx;
+        }
+      }
+    }
+  }
+  __syncthreads();
+  for (int i = threadIdx.x; i < out_axis; i += blockDim.x) {
+    cinn_sort_write(x, seg, i, index[i], axis_size, inner, out_axis, values, index32, index64, ranks);
+  }
+}
+)";
+
+// The least significant digit radix sort over all the segments at once. Each pass computes the digit histogram of
+// each tile, scans the histograms of each segment in the digit-major order to get the offset of each digit of each
+// tile, and scatters the tiles stably sorted in the shared memory by the 1-bit splits.
+const char* kRadixSortSource = R"(
+#define RADIX (1 << RADIX_BITS)
+
+extern "C" __global__ void cinn_radix_init_kernel(
+    const DTYPE* __restrict__ x, int axis_size, int inner, int descending, BITS_T* keys, int* index) {
+  const int seg = blockIdx.y;
+  const int i   = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < axis_size) {
+    long long offset = (static_cast<long long>(seg / inner) * axis_size + i) * inner + seg % inner;
+    keys[static_cast<long long>(seg) * axis_size + i]  = cinn_sort_key_bits(x[offset], descending);
+    index[static_cast<long long>(seg) * axis_size + i] = i;
+  }
+}
+
+extern "C" __global__ void cinn_radix_histogram_kernel(
+    const BITS_T* __restrict__ keys, int axis_size, int num_tiles, int shift, int* counts) {
+  __shared__ int hist[RADIX];
+  for (int d = threadIdx.x; d < RADIX; d += blockDim.x) hist[d] = 0;
+  __syncthreads();
+  const int seg = blockIdx.y;
+  const int i   = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < axis_size) {
+    atomicAdd(&hist[(keys[static_cast<long long>(seg) * axis_size + i] >> shift) & (RADIX - 1)], 1);
+  }
+  __syncthreads();
+  for (int d = threadIdx.x; d < RADIX; d += blockDim.x) {
+    counts[(static_cast<long long>(seg) * RADIX + d) * num_tiles + blockIdx.x] = hist[d];
+  }
+}
+
+extern "C" __global__ void cinn_radix_scan_kernel(int* counts, int num_tiles) {
+  const int total = RADIX * num_tiles;
+  int* seg_counts = counts + static_cast<long long>(blockIdx.x) * total;
+  int carry       = 0;
+  for (int start = 0; start < total; start += blockDim.x) {
+    int i     = start + threadIdx.x;
+    int value = i < total ? seg_counts[i] : 0;
+    int chunk_total;
+    int prefix = cinn_block_exclusive_scan(value, &chunk_total);
+    if (i < total) seg_counts[i] = carry + prefix;
+    carry += chunk_total;
+  }
+}
+
+extern "C" __global__ void __launch_bounds__(TILE) cinn_radix_scatter_kernel(const BITS_T* __restrict__ keys_in,
+                                                                             const int* __restrict__ index_in,
+                                                                             int axis_size,
+                                                                             int num_tiles,
+                                                                             int shift,
+                                                                             const int* __restrict__ offsets,
+                                                                             BITS_T* keys_out,
+                                                                             int* index_out) {
+  __shared__ BITS_T s_keys[TILE];
+  __shared__ int s_index[TILE];
+  __shared__ int s_digit[TILE];
+  __shared__ int s_start[RADIX];
+  const int seg            = blockIdx.y;
+  const long long seg_base = static_cast<long long>(seg) * axis_size;
+  const int i              = blockIdx.x * TILE + threadIdx.x;
+
+  BITS_T key = 0;
+  int idx    = 0;
+  // the padding out of the segment takes the extra digit to be sorted to the end of the tile
+  int digit = RADIX;
+  if (i < axis_size) {
+    key   = keys_in[seg_base + i];
+    idx   = index_in[seg_base + i];
+    digit = (key >> shift) & (RADIX - 1);
+  }
+  for (int bit = 0; bit <= RADIX_BITS; ++bit) {
+    int flag = (digit >> bit) & 1;
+    int num_zeros;
+    int zeros_before = cinn_block_exclusive_scan(1 - flag, &num_zeros);
+    int pos          = flag ? num_zeros + threadIdx.x - zeros_before : zeros_before;
+    s_keys[pos]      = key;
+    s_index[pos]     = idx;
+    s_digit[pos]     = digit;
+    __syncthreads();
+    key   = s_keys[threadIdx.x];
+    idx   = s_index[threadIdx.x];
+    digit = s_digit[threadIdx.x];
+    __syncthreads();
+  }
+
+  if (digit < RADIX && (threadIdx.x == 0 || s_digit[threadIdx.x - 1] != digit)) {
+    s_start[digit] = threadIdx.x;
+  }
+  __syncthreads();
+  if (digit < RADIX) {
+    int pos = offsets[(static_cast<long long>(seg) * RADIX + digit) * num_tiles + blockIdx.x] + threadIdx.x -
+              s_start[digit];
+    keys_out[seg_base + pos]  = key;
+    index_out[seg_base + pos] = idx;
+  }
+}
+
+extern "C" __global__ void cinn_radix_write_kernel(const DTYPE* __restrict__ x,
+                                                   const int* __restrict__ index,
+                                                   int axis_size,
+                                                   int inner,
+                                                   int out_axis,
+                                                   DTYPE* values,
+                                                   int* index32,
+                                                   long long* index64,
+                                                   int* ranks) {
+  const int seg = blockIdx.y;
+  const int i   = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < out_axis) {
+    cinn_sort_write(x,
+                    seg,
+                    i,
+                    index[static_cast<long long>(seg) * axis_size + i],
+                    axis_size,
+                    inner,
+                    out_axis,
+                    values,
+                    index32,
+                    index64,
+                    ranks);
+  }
+}
+)";
+
+// Each block selects the top TOP_K of one segment: every thread keeps the sorted top TOP_K of its strided elements
+// in the registers, then the block picks the best head of all the threads for TOP_K rounds.
+const char* kTopKSource = R"(
+__device__ __forceinline__ bool cinn_top_k_better(BITS_T key, int idx, BITS_T other_key, int other_idx) {
+  return key < other_key || (key == other_key && idx < other_idx);
+}
+
+extern "C" __global__ void __launch_bounds__(BLOCK) cinn_top_k_kernel(
+    const DTYPE* __restrict__ x, int axis_size, int inner, int largest, DTYPE* values, long long* index64) {
+  __shared__ BITS_T warp_keys[32];
+  __shared__ int warp_index[32];
+  __shared__ int winner;
+  const int seg        = blockIdx.x;
+  const int lane       = threadIdx.x & 31;
+  const int warp       = threadIdx.x >> 5;
+  const int num_warps  = blockDim.x >> 5;
+  const long long base = static_cast<long long>(seg / inner) * axis_size * inner + seg % inner;
+
+  BITS_T top_keys[TOP_K];
+  int top_index[TOP_K];
+  int count = 0;
+  for (int i = threadIdx.x; i < axis_size; i += blockDim.x) {
+    BITS_T key = cinn_sort_key_bits(x[base + static_cast<long long>(i) * inner], largest);
+    // the later index never wins a tie with the kept ones
+    if (count < TOP_K || key < top_keys[TOP_K - 1]) {
+      int pos = count < TOP_K ? count++ : TOP_K - 1;
+      while (pos > 0 && key < top_keys[pos - 1]) {
+        top_keys[pos]  = top_keys[pos - 1];
+        top_index[pos] = top_index[pos - 1];
+        --pos;
+      }
+      top_keys[pos]  = key;
+      top_index[pos] = i;
+    }
+  }
+
+  int head = 0;
+  for (int rank = 0; rank < TOP_K; ++rank) {
+    BITS_T key = head < count ? top_keys[head] : ~static_cast<BITS_T>(0);
+    int idx    = head < count ? top_index[head] : 0x7fffffff;
+    for (int offset = 16; offset > 0; offset >>= 1) {
+      BITS_T other_key = __shfl_down_sync(0xffffffff, key, offset);
+      int other_idx    = __shfl_down_sync(0xffffffff, idx, offset);
+      if (cinn_top_k_better(other_key, other_idx, key, idx)) {
+        key = other_key;
+        idx = other_idx;
+      }
+    }
+    if (lane == 0) {
+      warp_keys[warp]  = key;
+      warp_index[warp] = idx;
+    }
+    __syncthreads();
+    if (warp == 0) {
+      key = lane < num_warps ? warp_keys[lane] : ~static_cast<BITS_T>(0);
+      idx = lane < num_warps ? warp_index[lane] : 0x7fffffff;
+      for (int offset = 16; offset > 0; offset >>= 1) {
+        BITS_T other_key = __shfl_down_sync(0xffffffff, key, offset);
+        int other_idx    = __shfl_down_sync(0xffffffff, idx, offset);
+        if (cinn_top_k_better(other_key, other_idx, key, idx)) {
+          key = other_key;
+          idx = other_idx;
+        }
+      }
+      if (lane == 0) winner = idx;
+    }
+    __syncthreads();
+    const int best = winner;
+    if (head < count && top_index[head] == best) {
+      ++head;
+    }
+    if (threadIdx.x == 0) {
+      long long out_offset = (static_cast<long long>(seg / inner) * TOP_K + rank) * inner + seg % inner;
+      values[out_offset]   = x[base + static_cast<long long>(best) * inner];
+      index64[out_offset]  = best;
+    }
+    __syncthreads();
+  }
+}
+)";
+
+struct SortKeyType {
+  std::string dtype;
+  std::string key_type;
+  int num_bits;
+  bool is_float;
+};
+
+SortKeyType GetSortKeyType(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return {"float", "float", 32, true};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 64) {
+    return {"double", "double", 64, true};
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return {"float16", "float", 32, true};
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return {"bfloat16", "float", 32, true};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return {"int", "int", 32, false};
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return {"long long", "long long", 64, false};
+  }
+  LOG(FATAL) << "The sort only supports float32, float64, float16, bfloat16, int32 and int64, but got type code "
+             << type.code << " with " << static_cast<int>(type.bits) << " bits";
+  return {};
+}
+
+// The kernels are compiled by NVRTC once for each dtype and each sort size or k.
+CUDAModule* GetSortModule(const SortKeyType& key_type, const std::string& kernel, int param) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto key = key_type.dtype + "_" + kernel + "_" + std::to_string(param);
+  auto it  = modules.find(key);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + key_type.dtype + "\n";
+  source += "#define KEY_T " + key_type.key_type + "\n";
+  source += "#define BITS_T " + std::string(key_type.num_bits == 64 ? "unsigned long long" : "unsigned int") + "\n";
+  source += "#define NUM_BITS " + std::to_string(key_type.num_bits) + "\n";
+  source += "#define IS_FLOAT " + std::to_string(static_cast<int>(key_type.is_float)) + "\n";
+  source += kSortCommonSource;
+  if (kernel == "block_sort") {
+    source += "#define BLOCK " + std::to_string(kBlockSortBlockSize) + "\n";
+    source += "#define SORT_SIZE " + std::to_string(param) + "\n";
+    source += kBlockSortSource;
+  } else if (kernel == "radix_sort") {
+    source += "#define TILE " + std::to_string(kRadixTileSize) + "\n";
+    source += "#define RADIX_BITS " + std::to_string(kRadixBits) + "\n";
+    source += kRadixSortSource;
+  } else {
+    CHECK_EQ(kernel, "top_k");
+    source += "#define BLOCK " + std::to_string(kTopKBlockSize) + "\n";
+    source += "#define TOP_K " + std::to_string(param) + "\n";
+    source += kTopKSource;
+  }
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the " << kernel << " kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(key, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+}  // namespace
+
+void SortSegments(const cinn_buffer_t* x,
+                  int outer,
+                  int axis_size,
+                  int inner,
+                  int out_axis,
+                  bool descending,
+                  void* values,
+                  void* index32,
+                  void* index64,
+                  void* ranks,
+                  cudaStream_t stream) {
+  int num_segments = outer * inner;
+  if (num_segments == 0 || axis_size == 0) {
+    return;
+  }
+  auto key_type  = GetSortKeyType(x->type);
+  void* x_ptr    = x->memory;
+  int is_descend = descending;
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+
+  if (axis_size <= kBlockSortMaxSize) {
+    int sort_size = 2;
+    while (sort_size < axis_size) {
+      sort_size <<= 1;
+    }
+    auto* module = GetSortModule(key_type, "block_sort", sort_size);
+    void* kernel_args[] = {
+        &x_ptr, &axis_size, &inner, &out_axis, &is_descend, &values, &index32, &index64, &ranks};
+    module->LaunchKernel(device_id,
+                         "cinn_block_sort_kernel",
+                         dim3(num_segments),
+                         dim3(kBlockSortBlockSize),
+                         kernel_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    return;
+  }
+
+  CHECK_LE(num_segments, 65535) << "Too many segments for the radix sort";
+  auto* module     = GetSortModule(key_type, "radix_sort", 0);
+  int num_tiles    = (axis_size + kRadixTileSize - 1) / kRadixTileSize;
+  size_t num_elems = static_cast<size_t>(num_segments) * axis_size;
+  size_t key_bytes = key_type.num_bits / 8;
+  void* keys[2];
+  void* index[2];
+  void* counts;
+  for (int i = 0; i < 2; ++i) {
+    CUDA_CALL(cudaMallocAsync(&keys[i], num_elems * key_bytes, stream));
+    CUDA_CALL(cudaMallocAsync(&index[i], num_elems * sizeof(int), stream));
+  }
+  CUDA_CALL(cudaMallocAsync(&counts, static_cast<size_t>(num_segments) * (1 << kRadixBits) * num_tiles * sizeof(int),
+                            stream));
+
+  dim3 grid(num_tiles, num_segments);
+  void* init_args[] = {&x_ptr, &axis_size, &inner, &is_descend, &keys[0], &index[0]};
+  module->LaunchKernel(
+      device_id, "cinn_radix_init_kernel", grid, dim3(kRadixTileSize), init_args, 0, static_cast<CUstream>(stream));
+  int cur = 0;
+  for (int shift = 0; shift < key_type.num_bits; shift += kRadixBits) {
+    void* histogram_args[] = {&keys[cur], &axis_size, &num_tiles, &shift, &counts};
+    module->LaunchKernel(device_id,
+                         "cinn_radix_histogram_kernel",
+                         grid,
+                         dim3(kRadixTileSize),
+                         histogram_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    void* scan_args[] = {&counts, &num_tiles};
+    module->LaunchKernel(device_id,
+                         "cinn_radix_scan_kernel",
+                         dim3(num_segments),
+                         dim3(kRadixScanBlockSize),
+                         scan_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    void* scatter_args[] = {
+        &keys[cur], &index[cur], &axis_size, &num_tiles, &shift, &counts, &keys[1 - cur], &index[1 - cur]};
+    module->LaunchKernel(device_id,
+                         "cinn_radix_scatter_kernel",
+                         grid,
+                         dim3(kRadixTileSize),
+                         scatter_args,
+                         0,
+                         static_cast<CUstream>(stream));
+    cur = 1 - cur;
+  }
+  void* write_args[] = {&x_ptr, &index[cur], &axis_size, &inner, &out_axis, &values, &index32, &index64, &ranks};
+  module->LaunchKernel(device_id,
+                       "cinn_radix_write_kernel",
+                       dim3((out_axis + kRadixTileSize - 1) / kRadixTileSize, num_segments),
+                       dim3(kRadixTileSize),
+                       write_args,
+                       0,
+                       static_cast<CUstream>(stream));
+
+  for (int i = 0; i < 2; ++i) {
+    CUDA_CALL(cudaFreeAsync(keys[i], stream));
+    CUDA_CALL(cudaFreeAsync(index[i], stream));
+  }
+  CUDA_CALL(cudaFreeAsync(counts, stream));
+}
+
+void cinn_call_sort_nvgpu(void* v_args, int num_args, int outer, int axis_size, int inner, bool is_ascend, void* stream) {
+  CHECK_EQ(num_args, 2) << "The sort takes the input and the sorted output.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* out     = args[1].operator cinn_buffer_t*();
+  VLOG(4) << "sort: outer=" << outer << ", axis_size=" << axis_size << ", inner=" << inner
+          << ", is_ascend=" << is_ascend;
+  SortSegments(x,
+               outer,
+               axis_size,
+               inner,
+               axis_size,
+               !is_ascend,
+               out->memory,
+               nullptr,
+               nullptr,
+               nullptr,
+               static_cast<cudaStream_t>(stream));
+}
+
+void cinn_call_argsort_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, bool is_ascend, void* stream) {
+  CHECK_EQ(num_args, 3) << "The argsort takes the input, the sorted indices and the ranks of the input.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* indices = args[1].operator cinn_buffer_t*();
+  cinn_buffer_t* ranks   = args[2].operator cinn_buffer_t*();
+  VLOG(4) << "argsort: outer=" << outer << ", axis_size=" << axis_size << ", inner=" << inner
+          << ", is_ascend=" << is_ascend;
+  SortSegments(x,
+               outer,
+               axis_size,
+               inner,
+               axis_size,
+               !is_ascend,
+               nullptr,
+               indices->memory,
+               nullptr,
+               ranks->memory,
+               static_cast<cudaStream_t>(stream));
+}
+
+void cinn_call_top_k_nvgpu(
+    void* v_args, int num_args, int outer, int axis_size, int inner, int k, bool largest, void* stream) {
+  CHECK_EQ(num_args, 3) << "The top_k takes the input, the values and the indices.";
+  CHECK_GT(k, 0) << "The k of top_k must be greater than 0.";
+  CHECK_LE(k, axis_size) << "The k of top_k can't be greater than the size of the axis.";
+  cinn_pod_value_t* args = static_cast<cinn_pod_value_t*>(v_args);
+  cinn_buffer_t* x       = args[0].operator cinn_buffer_t*();
+  cinn_buffer_t* values  = args[1].operator cinn_buffer_t*();
+  cinn_buffer_t* indices = args[2].operator cinn_buffer_t*();
+  VLOG(4) << "top_k: outer=" << outer << ", axis_size=" << axis_size << ", inner=" << inner << ", k=" << k
+          << ", largest=" << largest;
+
+  // the large k selects the head of the sorted segments
+  if (k > kTopKMaxFastK) {
+    SortSegments(x,
+                 outer,
+                 axis_size,
+                 inner,
+                 k,
+                 largest,
+                 values->memory,
+                 nullptr,
+                 indices->memory,
+                 nullptr,
+                 static_cast<cudaStream_t>(stream));
+    return;
+  }
+
+  int num_segments = outer * inner;
+  if (num_segments == 0) {
+    return;
+  }
+  auto* module        = GetSortModule(GetSortKeyType(x->type), "top_k", k);
+  void* x_ptr         = x->memory;
+  void* values_ptr    = values->memory;
+  void* indices_ptr   = indices->memory;
+  int is_largest      = largest;
+  void* kernel_args[] = {&x_ptr, &axis_size, &inner, &is_largest, &values_ptr, &indices_ptr};
+
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  module->LaunchKernel(device_id,
+                       "cinn_top_k_kernel",
+                       dim3(num_segments),
+                       dim3(kTopKBlockSize),
+                       kernel_args,
+                       0,
+                       static_cast<CUstream>(stream));
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
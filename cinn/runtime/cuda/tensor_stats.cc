@@ -0,0 +1,180 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/nvrtc/nvrtc_util.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_module.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace cuda {
+
+namespace {
+
+constexpr int kTensorStatsThreads = 256;
+
+// Each block accumulates the elements of the grid-stride loop and writes its partial statistics: the minimum, the
+// maximum and the sum of the finite values, the number of NaNs and of Infs.
+const char* kTensorStatsSource = R"(
+extern "C" __global__ void __launch_bounds__(THREADS)
+cinn_tensor_stats_kernel(const DTYPE* __restrict__ x, long long numel, double* __restrict__ partial) {
+  __shared__ double s_min[THREADS];
+  __shared__ double s_max[THREADS];
+  __shared__ double s_sum[THREADS];
+  __shared__ double s_nan[THREADS];
+  __shared__ double s_inf[THREADS];
+
+  double min_value = __longlong_as_double(0x7ff0000000000000LL);
+  double max_value = -min_value;
+  double sum = 0.0, nan_count = 0.0, inf_count = 0.0;
+  for (long long i = blockIdx.x * (long long)THREADS + threadIdx.x; i < numel; i += (long long)gridDim.x * THREADS) {
+    double value = TO_DOUBLE(x[i]);
+    if (isnan(value)) {
+      nan_count += 1.0;
+    } else if (isinf(value)) {
+      inf_count += 1.0;
+    } else {
+      min_value = fmin(min_value, value);
+      max_value = fmax(max_value, value);
+      sum += value;
+    }
+  }
+  s_min[threadIdx.x] = min_value;
+  s_max[threadIdx.x] = max_value;
+  s_sum[threadIdx.x] = sum;
+  s_nan[threadIdx.x] = nan_count;
+  s_inf[threadIdx.x] = inf_count;
+  __syncthreads();
+  for (int offset = THREADS / 2; offset > 0; offset >>= 1) {
+    if (threadIdx.x < offset) {
+      s_min[threadIdx.x] = fmin(s_min[threadIdx.x], s_min[threadIdx.x + offset]);
+      s_max[threadIdx.x] = fmax(s_max[threadIdx.x], s_max[threadIdx.x + offset]);
+      s_sum[threadIdx.x] += s_sum[threadIdx.x + offset];
+      s_nan[threadIdx.x] += s_nan[threadIdx.x + offset];
+      s_inf[threadIdx.x] += s_inf[threadIdx.x + offset];
+    }
+    __syncthreads();
+  }
+  if (threadIdx.x == 0) {
+    double* out = partial + blockIdx.x * 5;
+    out[0]      = s_min[0];
+    out[1]      = s_max[0];
+    out[2]      = s_sum[0];
+    out[3]      = s_nan[0];
+    out[4]      = s_inf[0];
+  }
+}
+)";
+
+std::string GetDTypeName(const cinn_type_t& type) {
+  if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 32) {
+    return "float";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 64) {
+    return "double";
+  } else if (type.code == cinn_type_code_t::cinn_type_float && type.bits == 16) {
+    return "float16";
+  } else if (type.code == cinn_type_code_t::cinn_type_bfloat && type.bits == 16) {
+    return "bfloat16";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 8) {
+    return "signed char";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 16) {
+    return "short";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 32) {
+    return "int";
+  } else if (type.code == cinn_type_code_t::cinn_type_int && type.bits == 64) {
+    return "long long";
+  } else if (type.code == cinn_type_code_t::cinn_type_uint && type.bits == 1) {
+    return "bool";
+  } else if (type.code == cinn_type_code_t::cinn_type_uint && type.bits == 8) {
+    return "unsigned char";
+  } else if (type.code == cinn_type_code_t::cinn_type_uint && type.bits == 16) {
+    return "unsigned short";
+  } else if (type.code == cinn_type_code_t::cinn_type_uint && type.bits == 32) {
+    return "unsigned int";
+  } else if (type.code == cinn_type_code_t::cinn_type_uint && type.bits == 64) {
+    return "unsigned long long";
+  }
+  return "";
+}
+
+CUDAModule* GetTensorStatsModule(const std::string& dtype) {
+  static std::mutex mtx;
+  static std::unordered_map<std::string, std::unique_ptr<CUDAModule>> modules;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it = modules.find(dtype);
+  if (it != modules.end()) {
+    return it->second.get();
+  }
+
+  // the half types are converted through float
+  bool is_half       = dtype == "float16" || dtype == "bfloat16";
+  std::string source = backends::CodeGenCUDA_Dev::GetSourceHeader();
+  source += "#define DTYPE " + dtype + "\n";
+  source += "#define THREADS " + std::to_string(kTensorStatsThreads) + "\n";
+  source += is_half ? "#define TO_DOUBLE(v) static_cast<double>(static_cast<float>(v))\n"
+                    : "#define TO_DOUBLE(v) static_cast<double>(v)\n";
+  source += kTensorStatsSource;
+
+  backends::nvrtc::Compiler compiler;
+  auto code = compiler(source);
+  CHECK(!code.empty()) << "Compile the tensor statistics kernel failed from source code:\n" << source;
+  auto* module =
+      new CUDAModule(code, compiler.compile_to_cubin() ? CUDAModule::Kind::CUBIN : CUDAModule::Kind::PTX);
+  modules.emplace(dtype, std::unique_ptr<CUDAModule>(module));
+  return module;
+}
+
+}  // namespace
+
+int cinn_compute_tensor_stats_nvgpu(const cinn_buffer_t* buffer, double* partial, void* stream) {
+  auto dtype = GetDTypeName(buffer->type);
+  if (dtype.empty()) {
+    VLOG(4) << "The tensor statistics don't support the type code " << buffer->type.code << " with "
+            << static_cast<int>(buffer->type.bits) << " bits";
+    return 0;
+  }
+  long long numel = buffer->num_elements();
+  if (numel == 0 || buffer->memory == nullptr) {
+    return 0;
+  }
+  int num_blocks = static_cast<int>(
+      std::min<long long>((numel + kTensorStatsThreads - 1) / kTensorStatsThreads, kTensorStatsMaxBlocks));
+  void* x_ptr         = buffer->memory;
+  void* kernel_args[] = {&x_ptr, &numel, &partial};
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  GetTensorStatsModule(dtype)->LaunchKernel(device_id,
+                                            "cinn_tensor_stats_kernel",
+                                            dim3(num_blocks),
+                                            dim3(kTensorStatsThreads),
+                                            kernel_args,
+                                            0,
+                                            static_cast<CUstream>(stream));
+  return num_blocks;
+}
+
+}  // namespace cuda
+}  // namespace runtime
+}  // namespace cinn
@@ -15,10 +15,14 @@
 #pragma once
 #include "cinn/backends/extern_func_jit_register.h"
 
-#ifdef CINN_WITH_CUDA
-CINN_USE_REGISTER(cinn_cuda_host_api)
+#if defined(CINN_WITH_CUDA) || defined(CINN_WITH_ROCM)
+// the device functions of the runtime source, which the HIP codegen shares
 CINN_USE_REGISTER(cuda_intrinsics)
 CINN_USE_REGISTER(cuda_intrinsics_reduce)
+#endif
+
+#ifdef CINN_WITH_CUDA
+CINN_USE_REGISTER(cinn_cuda_host_api)
 CINN_USE_REGISTER(cuda_intrinsics_bfloat16)
 CINN_USE_REGISTER(cuda_intrinsics_float16)
 #endif
@@ -0,0 +1,404 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/deploy_runtime.h"
+
+#include <dlfcn.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef CINN_WITH_CUDA
+#include <cuda.h>
+#include <cuda_runtime.h>
+#endif
+
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/program_artifact.pb.h"
+
+namespace {
+
+using cinn::common::Target;
+using cinn::hlir::framework::proto::ProgramArtifact;
+
+// keep it the same as kProgramArtifactVersion of the compiler
+constexpr int kProgramArtifactVersion = 1;
+// the alignment of the memory of the host variables, the same as the arena of the compiler
+constexpr size_t kHostAlignment = 1024;
+
+thread_local std::string last_error;
+
+typedef void (*host_func_t)(void*, int);
+typedef void (*device_func_t)(void*, int, void*);
+
+struct DeployInstruction {
+  std::string function_name;
+  std::vector<void*> fns;
+  std::vector<std::vector<cinn_pod_value_t>> args;
+  bool pre_run = false;
+};
+
+bool Fail(const std::string& message) {
+  last_error = message;
+  return false;
+}
+
+// the dtypes are the names given by common::Type2Str
+bool ParseType(const std::string& dtype, cinn_type_t* type) {
+  static const std::unordered_map<std::string, cinn_type_t> types = {
+      {"bool", cinn_bool_t()},
+      {"int8", cinn_int8_t()},
+      {"int16", cinn_int16_t()},
+      {"int32", cinn_int32_t()},
+      {"int64", cinn_int64_t()},
+      {"uint8", cinn_uint8_t()},
+      {"uint16", cinn_uint16_t()},
+      {"uint32", cinn_uint32_t()},
+      {"uint64", cinn_uint64_t()},
+      {"bfloat16", cinn_bfloat16_t()},
+      {"float16", cinn_float16_t()},
+      {"float8_e4m3fn", cinn_float8_e4m3_t()},
+      {"float8_e5m2", cinn_float8_e5m2_t()},
+      {"float32", cinn_float32_t()},
+      {"float64", cinn_float64_t()},
+  };
+  auto it = types.find(dtype);
+  if (it == types.end()) return false;
+  *type = it->second;
+  return true;
+}
+
+#ifdef CINN_WITH_CUDA
+void LaunchKernel(bool cooperative,
+                  void* kernel_fn,
+                  void* v_args,
+                  int num_args,
+                  int grid_x,
+                  int grid_y,
+                  int grid_z,
+                  int block_x,
+                  int block_y,
+                  int block_z,
+                  int shared_mem_bytes,
+                  void* stream) {
+  // the buffers are passed by their memory, and the scalars by their values
+  auto* args = static_cast<cinn_pod_value_t*>(v_args);
+  std::vector<void*> kernel_args(num_args);
+  for (int idx = 0; idx < num_args; ++idx) {
+    if (args[idx].type_code() == ::cinn_type_code<cinn_buffer_t*>()) {
+      kernel_args[idx] = &(static_cast<cinn_buffer_t*>(args[idx]))->memory;
+    } else {
+      kernel_args[idx] = args[idx].data_addr();
+    }
+  }
+  auto function = static_cast<CUfunction>(kernel_fn);
+  CUresult result;
+  if (cooperative) {
+    result = cuLaunchCooperativeKernel(function,
+                                       grid_x,
+                                       grid_y,
+                                       grid_z,
+                                       block_x,
+                                       block_y,
+                                       block_z,
+                                       shared_mem_bytes,
+                                       static_cast<CUstream>(stream),
+                                       kernel_args.data());
+  } else {
+    result = cuLaunchKernel(function,
+                            grid_x,
+                            grid_y,
+                            grid_z,
+                            block_x,
+                            block_y,
+                            block_z,
+                            shared_mem_bytes,
+                            static_cast<CUstream>(stream),
+                            kernel_args.data(),
+                            nullptr);
+  }
+  if (result != CUDA_SUCCESS) {
+    const char* message = nullptr;
+    cuGetErrorString(result, &message);
+    fprintf(stderr, "Failed to launch the kernel: %s\n", message ? message : "unknown error");
+    abort();
+  }
+}
+#endif
+
+}  // namespace
+
+struct cinn_deploy_program {
+  bool on_gpu   = false;
+  void* library = nullptr;
+  std::unordered_map<std::string, std::unique_ptr<cinn_buffer_t>> buffers;
+  std::vector<void*> allocations;
+  std::vector<DeployInstruction> instrs;
+  bool pre_run_done = false;
+#ifdef CINN_WITH_CUDA
+  std::vector<CUmodule> modules;
+#endif
+
+  ~cinn_deploy_program() {
+    for (void* memory : allocations) {
+#ifdef CINN_WITH_CUDA
+      if (on_gpu) {
+        cudaFree(memory);
+        continue;
+      }
+#endif
+      free(memory);
+    }
+#ifdef CINN_WITH_CUDA
+    for (CUmodule module : modules) {
+      cuModuleUnload(module);
+    }
+#endif
+    if (library) {
+      dlclose(library);
+    }
+  }
+
+  void* Allocate(size_t bytes) {
+    void* memory = nullptr;
+#ifdef CINN_WITH_CUDA
+    if (on_gpu) {
+      if (cudaMalloc(&memory, bytes) != cudaSuccess) return nullptr;
+      allocations.push_back(memory);
+      return memory;
+    }
+#endif
+    if (posix_memalign(&memory, kHostAlignment, bytes) != 0) return nullptr;
+    allocations.push_back(memory);
+    return memory;
+  }
+
+  bool LoadVariables(const ProgramArtifact& artifact) {
+    void* arena = nullptr;
+    if (artifact.memory_plan().arena_bytes() > 0) {
+      arena = Allocate(artifact.memory_plan().arena_bytes());
+      if (!arena) return Fail("Failed to allocate the arena of the memory plan");
+    }
+    auto& offsets = artifact.memory_plan().offsets();
+    auto& sizes   = artifact.memory_plan().sizes();
+    for (auto& var_desc : artifact.variables()) {
+      auto buffer = std::make_unique<cinn_buffer_t>();
+      if (!on_gpu) {
+        buffer->device = cinn_x86_device;
+      }
+      if (var_desc.shape_size() >= CINN_BUFFER_MAX_DIMS) {
+        return Fail("The variable [" + var_desc.name() + "] has too many dimensions");
+      }
+      std::vector<cinn_dimension_t> dims(var_desc.shape().begin(), var_desc.shape().end());
+      buffer->resize(dims.data(), dims.size());
+      bool known_type = !var_desc.dtype().empty() && ParseType(var_desc.dtype(), &buffer->type);
+      if (!var_desc.dtype().empty() && !known_type) {
+        return Fail("The dtype " + var_desc.dtype() + " of the variable [" + var_desc.name() + "] is not supported");
+      }
+      auto offset = offsets.find(var_desc.name());
+      if (offset != offsets.end()) {
+        // the planned variables share the arena
+        buffer->memory      = static_cast<uint8_t*>(arena) + offset->second;
+        buffer->memory_size = sizes.at(var_desc.name());
+      } else if (known_type) {
+        uint64_t bytes      = buffer->num_elements() * buffer->type.bytes();
+        buffer->memory      = static_cast<uint8_t*>(Allocate(bytes > 0 ? bytes : 1));
+        buffer->memory_size = bytes;
+        if (!buffer->memory) return Fail("Failed to allocate the variable [" + var_desc.name() + "]");
+      }
+      buffers[var_desc.name()] = std::move(buffer);
+    }
+    return true;
+  }
+
+  bool LoadModules(const ProgramArtifact& artifact) {
+    for (auto& module_desc : artifact.modules()) {
+      if (module_desc.device_code().empty()) continue;
+#ifdef CINN_WITH_CUDA
+      // the cubin or PTX is loaded on the current device, whose primary context is created by the runtime API first,
+      // and its kernels are given to the pointers the host functions launch them by
+      cudaFree(nullptr);
+      CUmodule module;
+      if (cuModuleLoadData(&module, module_desc.device_code().data()) != CUDA_SUCCESS) {
+        return Fail("Failed to load the device code of the program");
+      }
+      modules.push_back(module);
+      for (auto& kernel_name : module_desc.kernel_names()) {
+        CUfunction function;
+        if (cuModuleGetFunction(&function, module, kernel_name.c_str()) != CUDA_SUCCESS) {
+          return Fail("Can't find the kernel [" + kernel_name + "] in the device code");
+        }
+        auto* kernel_ptr = static_cast<void**>(dlsym(library, (kernel_name + "_ptr_").c_str()));
+        if (!kernel_ptr) return Fail("Can't find the pointer of the kernel [" + kernel_name + "] in the library");
+        *kernel_ptr = function;
+      }
+#else
+      return Fail("The program holds the device code, which needs the deploy runtime compiled with CUDA");
+#endif
+    }
+    return true;
+  }
+
+  bool LoadInstructions(const ProgramArtifact& artifact) {
+    for (auto& desc : artifact.instructions()) {
+      if (desc.function_name() == "no_run") continue;
+      if (desc.library_call()) {
+        return Fail("The instruction " + desc.function_name() + " calls a library directly, which is not supported");
+      }
+      if (desc.fn_names_size() != desc.in_args_size() || desc.fn_names_size() != desc.out_args_size()) {
+        return Fail("The arguments of the instruction " + desc.function_name() + " don't match its functions");
+      }
+      DeployInstruction instr;
+      instr.function_name = desc.function_name();
+      instr.pre_run       = desc.pre_run();
+      for (int idx = 0; idx < desc.fn_names_size(); ++idx) {
+        void* fn = dlsym(library, desc.fn_names(idx).c_str());
+        if (!fn) return Fail("Can't find the function [" + desc.fn_names(idx) + "] in the library");
+        instr.fns.push_back(fn);
+        std::vector<cinn_pod_value_t> args;
+        for (auto* arg_names : {&desc.in_args(idx), &desc.out_args(idx)}) {
+          for (auto& name : arg_names->names()) {
+            auto it = buffers.find(name);
+            if (it == buffers.end()) return Fail("The argument [" + name + "] is not a variable of the program");
+            args.emplace_back(it->second.get());
+          }
+        }
+        instr.args.push_back(std::move(args));
+      }
+      instrs.push_back(std::move(instr));
+    }
+    return true;
+  }
+
+  void RunInstruction(DeployInstruction* instr, void* stream) {
+    for (int idx = 0; idx < instr->fns.size(); ++idx) {
+      auto& args = instr->args[idx];
+      if (on_gpu) {
+        reinterpret_cast<device_func_t>(instr->fns[idx])(args.data(), args.size(), stream);
+      } else {
+        reinterpret_cast<host_func_t>(instr->fns[idx])(args.data(), args.size());
+      }
+    }
+  }
+};
+
+extern "C" {
+
+cinn_deploy_program_t* cinn_deploy_load(const char* artifact_path, const char* library_path) {
+  std::ifstream ifs(artifact_path, std::ios::in | std::ios::binary);
+  if (!ifs.is_open()) {
+    Fail(std::string("Failed to open the program artifact [") + artifact_path + "]");
+    return nullptr;
+  }
+  std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ProgramArtifact artifact;
+  if (!artifact.ParseFromString(data)) {
+    Fail("Failed to parse the program artifact");
+    return nullptr;
+  }
+  if (artifact.version() != kProgramArtifactVersion) {
+    Fail("The version of the program artifact is not supported");
+    return nullptr;
+  }
+  auto arch = static_cast<Target::Arch>(artifact.target_arch());
+  if (arch != Target::Arch::X86 && arch != Target::Arch::ARM && arch != Target::Arch::NVGPU) {
+    Fail("The target of the program artifact is not supported");
+    return nullptr;
+  }
+
+  auto program    = std::make_unique<cinn_deploy_program_t>();
+  program->on_gpu = arch == Target::Arch::NVGPU;
+  // the undefined symbols of the host functions are the intrinsics of this runtime, which are bound on loading so
+  // that a missing one fails here rather than on running
+  program->library = dlopen(library_path, RTLD_NOW | RTLD_LOCAL);
+  if (!program->library) {
+    Fail(std::string("Failed to load the library of the program: ") + dlerror());
+    return nullptr;
+  }
+  if (!program->LoadVariables(artifact) || !program->LoadModules(artifact) || !program->LoadInstructions(artifact)) {
+    return nullptr;
+  }
+  return program.release();
+}
+
+cinn_buffer_t* cinn_deploy_get_buffer(cinn_deploy_program_t* program, const char* name) {
+  auto it = program->buffers.find(name);
+  return it == program->buffers.end() ? nullptr : it->second.get();
+}
+
+int cinn_deploy_run(cinn_deploy_program_t* program, void* stream) {
+  if (!program->pre_run_done) {
+    for (auto& instr : program->instrs) {
+      if (instr.pre_run) program->RunInstruction(&instr, stream);
+    }
+    program->pre_run_done = true;
+  }
+  for (auto& instr : program->instrs) {
+    if (!instr.pre_run) program->RunInstruction(&instr, stream);
+  }
+#ifdef CINN_WITH_CUDA
+  if (program->on_gpu) {
+    cudaError_t error = stream ? cudaStreamSynchronize(static_cast<cudaStream_t>(stream)) : cudaDeviceSynchronize();
+    if (error != cudaSuccess) {
+      Fail(std::string("Failed to run the program: ") + cudaGetErrorString(error));
+      return -1;
+    }
+  }
+#endif
+  return 0;
+}
+
+void cinn_deploy_free(cinn_deploy_program_t* program) { delete program; }
+
+const char* cinn_deploy_last_error() { return last_error.c_str(); }
+
+#ifdef CINN_WITH_CUDA
+// the kernel launches called by the host functions of the GPU programs, the same as the ones of cinn::runtime::cuda
+void cinn_call_cuda_kernel(void* kernel_fn,
+                           void* v_args,
+                           int num_args,
+                           int grid_x,
+                           int grid_y,
+                           int grid_z,
+                           int block_x,
+                           int block_y,
+                           int block_z,
+                           int shared_mem_bytes,
+                           void* stream) {
+  LaunchKernel(
+      false, kernel_fn, v_args, num_args, grid_x, grid_y, grid_z, block_x, block_y, block_z, shared_mem_bytes, stream);
+}
+
+void cinn_call_cuda_cooperative_kernel(void* kernel_fn,
+                                       void* v_args,
+                                       int num_args,
+                                       int grid_x,
+                                       int grid_y,
+                                       int grid_z,
+                                       int block_x,
+                                       int block_y,
+                                       int block_z,
+                                       int shared_mem_bytes,
+                                       void* stream) {
+  LaunchKernel(
+      true, kernel_fn, v_args, num_args, grid_x, grid_y, grid_z, block_x, block_y, block_z, shared_mem_bytes, stream);
+}
+#endif
+
+}  // extern "C"
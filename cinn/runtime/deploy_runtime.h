@@ -0,0 +1,53 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+/**
+ * \file The deploy runtime runs the programs exported by CINN without linking the compiler: the artifact saved by
+ * Program::Save gives the variables, the instructions and the device code, and the shared library linked by
+ * Program::ExportLibrary gives the host functions. It holds the buffers, the thread pool, the kernel launch and the
+ * host intrinsics only, and depends on none of LLVM, isl and glog.
+ *
+ * The values of the variables are not in the artifact, so the parameters and the inputs are written into the
+ * buffers of their variables before running, in the device memory for the programs compiled for the GPU.
+ */
+#include "cinn/runtime/cinn_runtime.h"
+
+extern "C" {
+
+typedef struct cinn_deploy_program cinn_deploy_program_t;
+
+/**
+ * Load the program from the artifact and the library of its host functions.
+ * @return The program, or NULL on failure, whose reason is given by cinn_deploy_last_error.
+ */
+cinn_deploy_program_t* cinn_deploy_load(const char* artifact_path, const char* library_path);
+
+//! The buffer of the variable \p name, to feed the inputs and fetch the outputs, or NULL if there is no such variable.
+cinn_buffer_t* cinn_deploy_get_buffer(cinn_deploy_program_t* program, const char* name);
+
+/**
+ * Run the instructions of the program, the ones only depending on the parameters are run once on the first run.
+ * @param stream The stream to launch the kernels on, which is ignored by the programs compiled for the host.
+ * @return 0 on success, otherwise the reason is given by cinn_deploy_last_error.
+ */
+int cinn_deploy_run(cinn_deploy_program_t* program, void* stream);
+
+//! Release the buffers, the device code and the library of the program.
+void cinn_deploy_free(cinn_deploy_program_t* program);
+
+//! The message of the last failure on the calling thread.
+const char* cinn_deploy_last_error();
+
+}  // extern "C"
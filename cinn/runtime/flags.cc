@@ -33,6 +33,7 @@ DEFINE_bool(cinn_cudnn_deterministic,
 #endif
 
 using ::GFLAGS_NAMESPACE::BoolFromEnv;
+using ::GFLAGS_NAMESPACE::DoubleFromEnv;
 using ::GFLAGS_NAMESPACE::Int32FromEnv;
 using ::GFLAGS_NAMESPACE::Int64FromEnv;
 using ::GFLAGS_NAMESPACE::StringFromEnv;
@@ -50,6 +51,35 @@ DEFINE_int32(cinn_parallel_compile_thread,
              Int32FromEnv("FLAGS_cinn_parallel_compile_thread", -1),
              "How much thread the parallel compile used.");
 
+DEFINE_int32(cinn_task_pool_threads,
+             Int32FromEnv("FLAGS_cinn_task_pool_threads", -1),
+             "The number of threads of the task pool shared by the parallel compile and tuning, -1 means the hardware "
+             "concurrency.");
+
+DEFINE_int32(cinn_parallel_jit_thread,
+             Int32FromEnv("FLAGS_cinn_parallel_jit_thread", -1),
+             "How much thread the codegen and jit stage of the parallel compile used, -1 means the hardware "
+             "concurrency.");
+
+DEFINE_bool(cinn_deduplicate_fusion_groups,
+            BoolFromEnv("FLAGS_cinn_deduplicate_fusion_groups", true),
+            "Whether to compile the structurally equal fusion groups once and share the function among them.");
+
+DEFINE_int32(cinn_parallel_compile_max_modules,
+             Int32FromEnv("FLAGS_cinn_parallel_compile_max_modules", 0),
+             "The max number of modules emitted by the parallel compile, all the kernels of a module are compiled as "
+             "one translation unit, which amortizes the parse of the runtime source by NVRTC. 0 means no limit.");
+
+DEFINE_bool(cinn_stitch_small_kernels,
+            BoolFromEnv("FLAGS_cinn_stitch_small_kernels", false),
+            "Whether to stitch the consecutive small CUDA kernels, whose grids fit on the device at once, into one "
+            "cooperative kernel with the grid-wide barriers between them, which saves the launches of the small models.");
+
+DEFINE_int32(cinn_lazy_compile_prefetch_thread,
+             Int32FromEnv("FLAGS_cinn_lazy_compile_prefetch_thread", 0),
+             "How much background thread compiles the upcoming instructions of a lazily compiled program in advance, "
+             "0 means they are only compiled on the first run.");
+
 DEFINE_bool(cinn_use_op_fusion, BoolFromEnv("FLAGS_cinn_use_op_fusion", true), "Whether to use op fusion pass.");
 
 DEFINE_bool(cinn_use_common_subexpression_elimination,
@@ -64,10 +94,61 @@ DEFINE_bool(cinn_use_custom_call,
             BoolFromEnv("FLAGS_cinn_use_custom_call", true),
             "Whether to use custom_call for ops with external_api registered");
 
+DEFINE_bool(cinn_custom_call_autotune,
+            BoolFromEnv("FLAGS_cinn_custom_call_autotune", false),
+            "Whether to time custom_call against the generated kernel of each op on the device and use the faster");
+
+DEFINE_string(cinn_custom_call_selection_file,
+              StringFromEnv("FLAGS_cinn_custom_call_selection_file", ""),
+              "The file to keep the choices of cinn_custom_call_autotune across runs, empty means not kept");
+
+DEFINE_bool(cinn_cuda_thread_coarsening,
+            BoolFromEnv("FLAGS_cinn_cuda_thread_coarsening", false),
+            "Whether schedule the large elementwise kernels on CUDA as grid-stride loops of vectorized accesses.");
+
+DEFINE_bool(cinn_stage_broadcast_operands,
+            BoolFromEnv("FLAGS_cinn_stage_broadcast_operands", false),
+            "Whether stage the small operands broadcast to a CUDA kernel in the shared memory or the registers.");
+
+DEFINE_string(cinn_amp_dtype,
+              StringFromEnv("FLAGS_cinn_amp_dtype", ""),
+              "The low precision of the automatic mixed precision, float16 or bfloat16, empty means not used");
+
+DEFINE_string(cinn_amp_allow_ops,
+              StringFromEnv("FLAGS_cinn_amp_allow_ops", ""),
+              "The ops always computed in the low precision by the automatic mixed precision, separated by ;");
+
+DEFINE_string(cinn_amp_deny_ops,
+              StringFromEnv("FLAGS_cinn_amp_deny_ops", ""),
+              "The ops always computed in float32 by the automatic mixed precision, separated by ;");
+
+DEFINE_bool(cinn_partition_loops,
+            BoolFromEnv("FLAGS_cinn_partition_loops", true),
+            "Whether partition the loops guarded by a boundary condition into a guard-free main loop and a tail.");
+
 DEFINE_bool(cinn_use_fill_constant_folding,
             BoolFromEnv("FLAGS_cinn_use_fill_constant_folding", false),
             "Whether use the FillConstantFolding pass.");
 
+DEFINE_bool(cinn_use_nvgpu_channels_last,
+            BoolFromEnv("FLAGS_cinn_use_nvgpu_channels_last", false),
+            "Whether alter the conv2d regions to the NHWC layout on NVGPU in the AlterLayout pass.");
+
+DEFINE_bool(cinn_use_fused_attention,
+            BoolFromEnv("FLAGS_cinn_use_fused_attention", false),
+            "Whether rewrite the attention pattern into the fused_attention op computed by the flash attention kernel.");
+
+DEFINE_bool(cinn_use_fp8_matmul,
+            BoolFromEnv("FLAGS_cinn_use_fp8_matmul", false),
+            "Whether rewrite the float matmul into the fp8_matmul with the per-tensor dynamic scaling, which requires "
+            "CUDA 11.8 and a GPU of compute capability 8.9 or later.");
+
+DEFINE_bool(cinn_use_sparse_matmul,
+            BoolFromEnv("FLAGS_cinn_use_sparse_matmul", false),
+            "Whether rewrite the matmul of the constant float16 or bfloat16 weight into the sparse_matmul computed by "
+            "cuSPARSELt, whose weight is checked for the 2:4 sparsity and compressed once on its first run, which "
+            "requires the weight prerun and a GPU of compute capability 8.0 or later.");
+
 DEFINE_string(cinn_check_fusion_accuracy_pass,
               StringFromEnv("FLAGS_cinn_check_fusion_accuracy_pass", ""),
               "Check the correct of fusion kernels, if the results not satisfied 'allclose(rtol=1e-05f, atol=1e-08f)', "
@@ -77,16 +158,71 @@ DEFINE_bool(cinn_use_cuda_vectorize,
             BoolFromEnv("FLAGS_cinn_use_cuda_vectorize", false),
             "Whether use cuda vectroize on schedule config");
 
+DEFINE_bool(cinn_use_multi_rows_reduce,
+            BoolFromEnv("FLAGS_cinn_use_multi_rows_reduce", false),
+            "Whether put multiple rows into one block when each row of reduce is computed by a warp or a part "
+            "of warp.");
+
+DEFINE_int32(cinn_grid_reduce_threshold,
+             Int32FromEnv("FLAGS_cinn_grid_reduce_threshold", 1 << 24),
+             "The min number of elements of a reduction over all the elements to be computed by the grid reduction "
+             "in a single kernel on NVGPU, a non-positive value disables the grid reduction.");
+
 DEFINE_bool(cinn_ir_schedule,
             BoolFromEnv("FLAGS_cinn_ir_schedule", true),
             "Whether use reconstructed schedule primitives.");
 
+DEFINE_bool(cinn_use_ir_arena,
+            BoolFromEnv("FLAGS_cinn_use_ir_arena", true),
+            "Whether to allocate the IR nodes of a compilation in an arena released as a whole.");
+
 DEFINE_bool(use_reduce_split_pass, BoolFromEnv("FLAGS_use_reduce_split_pass", false), "Whether use reduce split pass.");
 
+DEFINE_double(cinn_reduce_split_min_occupancy,
+              DoubleFromEnv("FLAGS_cinn_reduce_split_min_occupancy", 0.25),
+              "The reductions whose estimated occupancy of the device is below it are split into two by the reduce "
+              "split pass, which is applied on NVGPU automatically if it is > 0.");
+
 DEFINE_bool(cinn_use_dense_merge_pass,
             BoolFromEnv("FLAGS_cinn_use_dense_merge_pass", false),
             "Whether use dense merge pass.");
 
+DEFINE_bool(cinn_use_transpose_sinking,
+            BoolFromEnv("FLAGS_cinn_use_transpose_sinking", true),
+            "Whether to sink the transposes until they cancel each other or are folded into the matmul.");
+
+DEFINE_bool(cinn_use_weight_prerun,
+            BoolFromEnv("FLAGS_cinn_use_weight_prerun", false),
+            "Whether to fold the batch_norm into the conv2d and run the ops only depending on the constant parameters "
+            "once before the first run.");
+
+DEFINE_bool(cinn_use_grouped_gemm,
+            BoolFromEnv("FLAGS_cinn_use_grouped_gemm", false),
+            "Whether to apply the DotMerger pass and merge the small independent gemms of the same shape into one "
+            "batched cublas call on NVGPU.");
+
+DEFINE_bool(cinn_use_multi_tensor_update_pass,
+            BoolFromEnv("FLAGS_cinn_use_multi_tensor_update_pass", false),
+            "Whether to pack the same element-wise op over many parameters, like an optimizer update, into one op.");
+
+DEFINE_bool(cinn_use_cublaslt,
+            BoolFromEnv("FLAGS_cinn_use_cublaslt", false),
+            "Whether fuse the bias add, residual add and relu after matmul into the epilogue of cublasLt.");
+
+DEFINE_bool(cinn_use_conv_implicit_gemm,
+            BoolFromEnv("FLAGS_cinn_use_conv_implicit_gemm", true),
+            "Whether to lower the float16 NHWC conv2d not translated to the custom_call as an implicit GEMM computed "
+            "by Tensor Cores, which fuses the bias add, residual add and relu after it.");
+
+DEFINE_bool(cinn_use_tiled_depthwise_conv,
+            BoolFromEnv("FLAGS_cinn_use_tiled_depthwise_conv", true),
+            "Whether to lower the NCHW depthwise conv2d with a 3x3 or 5x5 filter and a stride of 1 or 2 not translated "
+            "to the custom_call by register tiles, which fuses the bias add and relu/relu6 after it.");
+
+DEFINE_bool(cinn_use_packed_gemm,
+            BoolFromEnv("FLAGS_cinn_use_packed_gemm", true),
+            "Whether to compute the 2-D x86 matmul by the packed GEMM of the runtime, fp32 one is only used without MKL.");
+
 DEFINE_bool(nvrtc_compile_to_cubin,
             BoolFromEnv("FLAGS_nvrtc_compile_to_cubin", false),
             "Whether nvrtc compile cuda source into cubin instead of ptx (only works after cuda-11.1).");
@@ -95,7 +231,149 @@ DEFINE_bool(cinn_compile_with_nvrtc,
             BoolFromEnv("FLAGS_cinn_compile_with_nvrtc", true),
             "Whether nvrtc compile cuda source with nvrtc(default nvcc).");
 
+DEFINE_bool(cinn_nvrtc_use_pch,
+            BoolFromEnv("FLAGS_cinn_nvrtc_use_pch", false),
+            "Whether to let nvrtc precompile the runtime headers shared by all the generated sources (only works "
+            "after cuda-12.1).");
+
+DEFINE_string(cinn_nvgpu_math_precision,
+              StringFromEnv("FLAGS_cinn_nvgpu_math_precision", "precise"),
+              "The precision of the fp32 math on NVGPU, \"precise\" for the CUDA math functions, \"approx\" to map "
+              "exp, log, sin, cos, tan, tanh, sigmoid and pow to the fast intrinsics, such as __expf and tanh.approx, "
+              "or \"fast\" to also compile with --use_fast_math, which flushes the denormals to zero and approximates "
+              "the division and sqrt. The \"math_precision\" attribute of an op overrides the mapping of its calls.");
+
+DEFINE_string(cinn_nvrtc_cache_dir,
+              StringFromEnv("FLAGS_cinn_nvrtc_cache_dir", ""),
+              "If not empty, the PTX/CUBIN compiled by nvrtc or nvcc are cached in this directory and reused across "
+              "processes.");
+
+DEFINE_int64(cinn_nvrtc_cache_max_bytes,
+             Int64FromEnv("FLAGS_cinn_nvrtc_cache_max_bytes", 1073741824L),
+             "The limit of the total size in bytes of the nvrtc disk cache, 0 means unlimited.");
+
+DEFINE_bool(cinn_nvrtc_link_runtime_library,
+            BoolFromEnv("FLAGS_cinn_nvrtc_link_runtime_library", false),
+            "Whether to compile the CUDA runtime source once per arch into a device library, and link the generated "
+            "kernels with it by nvJitLink instead of parsing the whole runtime source in every NVRTC compilation, "
+            "which requires CUDA 12.0 or later.");
+
+DEFINE_int32(cinn_nvcc_max_jobs,
+             Int32FromEnv("FLAGS_cinn_nvcc_max_jobs", 0),
+             "The maximum number of the nvcc processes compiling at the same time when compiling with nvcc, 0 means "
+             "the number of the cores.");
+
+DEFINE_string(cinn_nvcc_ptxas_options,
+              StringFromEnv("FLAGS_cinn_nvcc_ptxas_options", ""),
+              "The comma-separated options passed to ptxas through -Xptxas when compiling with nvcc, such as "
+              "\"-O3,--allow-expensive-optimizations=true\".");
+
+DEFINE_string(cinn_llvm_object_cache_dir,
+              StringFromEnv("FLAGS_cinn_llvm_object_cache_dir", ""),
+              "If not empty, the objects compiled by the LLVM ExecutionEngine are cached in this directory and reused "
+              "across processes.");
+
+DEFINE_string(cinn_export_cc,
+              StringFromEnv("FLAGS_cinn_export_cc", "cc"),
+              "The compiler driver linking the host code of a program into the shared library run by the deploy "
+              "runtime.");
+
+DEFINE_string(cinn_tuning_pack_file,
+              StringFromEnv("FLAGS_cinn_tuning_pack_file", ""),
+              "If not empty, the fusion groups are lowered with the schedules tuned in this TuningPack file, and the "
+              "groups not found in it with the default schedules.");
+
+DEFINE_int64(cinn_llvm_object_cache_max_bytes,
+             Int64FromEnv("FLAGS_cinn_llvm_object_cache_max_bytes", 1073741824L),
+             "The limit of the total size in bytes of the LLVM object disk cache, 0 means unlimited.");
+
+DEFINE_string(cinn_x86_vector_math,
+              StringFromEnv("FLAGS_cinn_x86_vector_math", "precise"),
+              "The accuracy of the fp32 exp, log, tanh and erf expanded into the inline vector math on x86, "
+              "\"precise\" within 1.5 ULP where erf is computed by libm, \"fast\" within 6 ULP, or \"none\" to "
+              "compute all of them by libm.");
+
+DEFINE_int64(cinn_computation_cache_capacity,
+             Int64FromEnv("FLAGS_cinn_computation_cache_capacity", 64),
+             "The number of the compiled computations cached in memory by the hash of the program and the compile "
+             "options, so that compiling the same program again skips the passes and the compilation, 0 disables it.");
+
+DEFINE_string(cinn_computation_cache_dir,
+              StringFromEnv("FLAGS_cinn_computation_cache_dir", ""),
+              "If not empty, the compiled computations are cached in this directory as the program artifacts too, and "
+              "reused across processes.");
+
+DEFINE_int64(cinn_computation_cache_max_bytes,
+             Int64FromEnv("FLAGS_cinn_computation_cache_max_bytes", 4294967296L),
+             "The limit of the total size in bytes of the computation disk cache, 0 means unlimited.");
+
+DEFINE_bool(cinn_use_cuda_caching_allocator,
+            BoolFromEnv("FLAGS_cinn_use_cuda_caching_allocator", true),
+            "Whether to cache the released device memory for reuse instead of returning it by cudaFree.");
+
+DEFINE_int64(cinn_cuda_allocator_max_bytes,
+             Int64FromEnv("FLAGS_cinn_cuda_allocator_max_bytes", 0L),
+             "The cap of device memory in bytes held by the caching allocator, 0 means unlimited.");
+
+DEFINE_bool(cinn_cudnn_exhaustive_search,
+            BoolFromEnv("FLAGS_cinn_cudnn_exhaustive_search", false),
+            "Whether benchmark all the cudnn convolution algorithms on the real buffers by cudnnFind*AlgorithmEx.");
+
+DEFINE_string(cinn_cudnn_algo_cache_path,
+              StringFromEnv("FLAGS_cinn_cudnn_algo_cache_path", ""),
+              "The file to persist the chosen cudnn convolution algorithms, empty means only caching them in memory.");
+
+DEFINE_int64(cinn_cudnn_workspace_limit_bytes,
+             Int64FromEnv("FLAGS_cinn_cudnn_workspace_limit_bytes", 512L * 1024 * 1024),
+             "The max workspace in bytes of the cudnn convolution algorithm to choose.");
+
+DEFINE_bool(cinn_use_cuda_graph,
+            BoolFromEnv("FLAGS_cinn_use_cuda_graph", false),
+            "Whether to capture the instructions of a Program into a CUDA Graph and replay it on Execute.");
+
+DEFINE_bool(cinn_use_dag_executor,
+            BoolFromEnv("FLAGS_cinn_use_dag_executor", false),
+            "Whether to run the independent instructions of a Program concurrently according to their dependencies.");
+
+DEFINE_int32(cinn_dag_executor_num_workers,
+             Int32FromEnv("FLAGS_cinn_dag_executor_num_workers", 4),
+             "The number of CUDA streams on NVGPU or threads on X86 used by the dag executor.");
+
+DEFINE_int64(cinn_isl_ast_max_operations,
+             Int64FromEnv("FLAGS_cinn_isl_ast_max_operations", 50000000L),
+             "The budget of isl operations to generate the AST of a polyhedral schedule group, the AST is rebuilt with "
+             "the cheaper isl options when it goes over, 0 means unlimited.");
+
+DEFINE_int32(cinn_program_thread_budget,
+             Int32FromEnv("FLAGS_cinn_program_thread_budget", 0),
+             "The maximum number of threads the host kernels of a Program are split into, 0 means unlimited.");
+
+DEFINE_int32(cinn_load_params_num_threads,
+             Int32FromEnv("FLAGS_cinn_load_params_num_threads", 8),
+             "The number of threads copying the parameters of a Paddle model from the memory-mapped files into the "
+             "tensors, 0 means reading the parameters through the file streams one by one.");
+
+DEFINE_bool(cinn_share_weights,
+            BoolFromEnv("FLAGS_cinn_share_weights", true),
+            "Whether the parameters loaded from the Paddle models share the device memory with the identical ones "
+            "loaded before in the process, such as the variants of one model for different batch sizes.");
+
 // FLAGS for performance analysis and accuracy debug
+DEFINE_string(cinn_trace_file,
+              StringFromEnv("FLAGS_cinn_trace_file", ""),
+              "If not empty, the spans of RecordEvent are collected and written to this file in the Chrome trace-event "
+              "JSON format at exit, which can be viewed in chrome://tracing or Perfetto.");
+
+DEFINE_double(cinn_roofline_peak_gflops,
+              DoubleFromEnv("FLAGS_cinn_roofline_peak_gflops", 0.0),
+              "The peak FP32 GFLOPS of the device in the roofline report, 0 means querying the GPU or estimating it "
+              "from the cores, the vector width and the frequency of the host CPU.");
+
+DEFINE_double(cinn_roofline_peak_gbps,
+              DoubleFromEnv("FLAGS_cinn_roofline_peak_gbps", 0.0),
+              "The peak memory bandwidth in GB/s of the device in the roofline report, 0 means querying the GPU, the "
+              "bandwidth of the host CPU can't be detected and has to be given by it.");
+
 DEFINE_bool(cinn_sync_run,
             BoolFromEnv("FLAGS_cinn_sync_run", false),
             "Whether sync all devices after each instruction run, which is used for debug.");
@@ -108,6 +386,17 @@ DEFINE_int64(cinn_self_check_accuracy_num,
              Int64FromEnv("FLAGS_cinn_self_check_accuracy_num", 0L),
              "Set self-check accuracy print numel, which is used for debug.");
 
+DEFINE_int64(cinn_self_check_accuracy_sample_runs,
+             Int64FromEnv("FLAGS_cinn_self_check_accuracy_sample_runs", 0L),
+             "If > 0, the self-check of accuracy runs in the sampling mode, which is cheap enough for production: every "
+             "Nth run of each instruction is checked, only the statistics of the outputs are computed on device and they "
+             "are logged asynchronously.");
+
+DEFINE_double(cinn_self_check_accuracy_sample_ratio,
+              DoubleFromEnv("FLAGS_cinn_self_check_accuracy_sample_ratio", 1.0),
+              "The probability of checking a sampled run of an instruction in the sampling mode of the self-check, "
+              "which checks a random subset of the instructions.");
+
 DEFINE_string(cinn_fusion_groups_graphviz_dir,
               StringFromEnv("FLAGS_cinn_fusion_groups_graphviz_dir", ""),
               "Specify the directory path of dot file of graph, which is used for debug.");
@@ -127,10 +416,105 @@ DEFINE_bool(auto_schedule_use_cost_model,
             "Whether to use cost model in auto schedule, this is an on-developing flag and it will be removed when "
             "cost model is stable.");
 
+DEFINE_int32(auto_schedule_pipeline_stages,
+             Int32FromEnv("FLAGS_auto_schedule_pipeline_stages", 2),
+             "The number of stages to pipeline the shared memory loads with the computation in auto schedule, 2 for "
+             "double buffering, and less than 2 to disable the pipelining.");
+
+DEFINE_bool(auto_schedule_reject_spilling,
+            BoolFromEnv("FLAGS_auto_schedule_reject_spilling", true),
+            "Whether to reject the candidates in auto schedule whose kernels spill the registers into the local memory "
+            "or can't launch at all before running them, which are also fed back to the cost model as the slowest.");
+
+DEFINE_bool(auto_schedule_use_bandit_sampler,
+            BoolFromEnv("FLAGS_auto_schedule_use_bandit_sampler", false),
+            "Whether to sample the sketch rules and the blocks in auto schedule by the rewards learned from the "
+            "measured candidates, the rewards are saved in the database so that the later tuning sessions start from "
+            "them.");
+
+DEFINE_bool(auto_schedule_static_prune,
+            BoolFromEnv("FLAGS_auto_schedule_static_prune", true),
+            "Whether to drop the candidates in auto schedule whose kernels statically exceed the shared memory, the "
+            "threads per block or the vector width of the device, or are misaligned to vectorize, before predicting "
+            "their costs.");
+
+DEFINE_double(auto_schedule_min_coalescing_ratio,
+              DoubleFromEnv("FLAGS_auto_schedule_min_coalescing_ratio", 0.0),
+              "The candidates in auto schedule whose ratio of the coalesced global accesses is below it are dropped "
+              "by the static pruning, 0 to keep all of them.");
+
 DEFINE_bool(enhance_vertical_fusion_with_recompute,
             BoolFromEnv("FLAGS_enhance_vertical_fusion_with_recompute", true),
             "Whether to enhance check logic on vertical fusion with recompute");
 
+DEFINE_int64(cinn_recompute_memory_budget_mb,
+             Int64FromEnv("FLAGS_cinn_recompute_memory_budget_mb", 0),
+             "The budget in MB of the intermediate variables held at the same time, the cheap elementwise variables "
+             "kept alive for the backward are recomputed before their late uses until the estimated peak memory fits "
+             "the budget, and 0 to disable the recompute.");
+
+DEFINE_int64(cinn_swap_memory_budget_mb,
+             Int64FromEnv("FLAGS_cinn_swap_memory_budget_mb", 0),
+             "The budget in MB of the intermediate variables held at the same time on NVGPU, the long-lived variables, "
+             "such as the activations kept for the backward, are swapped out to the pinned host memory during the gaps "
+             "between their uses which hide the copies until the estimated peak memory fits the budget, and 0 to "
+             "disable the swap.");
+
+DEFINE_double(cinn_swap_host_gbps,
+              DoubleFromEnv("FLAGS_cinn_swap_host_gbps", 12.0),
+              "The bandwidth in GB/s of the copies between the pinned host memory and the device, which estimates the "
+              "time of the swaps.");
+
+DEFINE_bool(cinn_use_inplace_variables,
+            BoolFromEnv("FLAGS_cinn_use_inplace_variables", true),
+            "Whether to share the buffers of the variables in place when the variables are instantiated at compile "
+            "time, the reshape-like instructions are skipped and the elementwise outputs overwrite their dead inputs.");
+
+DEFINE_bool(cinn_assume_aligned_buffers,
+            BoolFromEnv("FLAGS_cinn_assume_aligned_buffers", true),
+            "Whether the generated kernels assume the memory of their buffer arguments is aligned to "
+            "CINN_BUFFER_ALIGNMENT bytes, the external memory shared with the tensors, such as a numpy array or a "
+            "DLPack tensor, is checked to be aligned then.");
+
+DEFINE_bool(cinn_use_concat_slices,
+            BoolFromEnv("FLAGS_cinn_use_concat_slices", true),
+            "Whether to plan the inputs of a concat on its outermost axis at the slices of its output with the static "
+            "memory plan, so the producers write into the output directly and the concat is skipped.");
+
+DEFINE_int32(cinn_concat_custom_call_min_inputs,
+             Int32FromEnv("FLAGS_cinn_concat_custom_call_min_inputs", 8),
+             "The concat and split with at least this number of operands of the same shape are computed by the "
+             "vectorized copies over a table of the operand pointers on NVGPU, 0 means never.");
+
+DEFINE_int32(cinn_csr_spmm_custom_call_min_nnz,
+             Int32FromEnv("FLAGS_cinn_csr_spmm_custom_call_min_nnz", 0),
+             "The csr_spmm with at least this number of non-zeros is computed by cuSPARSE on NVGPU instead of the "
+             "row-split kernel fused with its elementwise epilogue, 0 means never.");
+
+DEFINE_int32(cinn_gather_rows_min_index,
+             Int32FromEnv("FLAGS_cinn_gather_rows_min_index", 1024),
+             "The gather on the outermost axis by at least this number of indices is computed as the lookup_table, "
+             "whose warps copy the whole rows with the vectorized loads on NVGPU, 0 means never.");
+
+DEFINE_bool(cinn_scatter_add_deterministic,
+            BoolFromEnv("FLAGS_cinn_scatter_add_deterministic", true),
+            "Whether to sum the updates of the scatter_add in the order of the sorted index, otherwise they are added "
+            "by the atomics aggregated over the runs of the same index, which is faster but not deterministic.");
+
+DEFINE_bool(cinn_fuse_independent_groups,
+            BoolFromEnv("FLAGS_cinn_fuse_independent_groups", true),
+            "Whether to fuse the groups of the same size sharing no data into one kernel to save the launches.");
+
+DEFINE_int32(cinn_partition_pass_min_nodes,
+             Int32FromEnv("FLAGS_cinn_partition_pass_min_nodes", 10000),
+             "The partitionable graph passes run on the weakly connected components of the graphs with at least this "
+             "number of nodes in parallel, 0 means never.");
+
+DEFINE_bool(cinn_fusion_cost_model,
+            BoolFromEnv("FLAGS_cinn_fusion_cost_model", false),
+            "Whether to fuse the groups allowed by the fusion rules only if the estimated cost of the fused kernels is "
+            "lower, and select the consumer of the max gain to fuse.");
+
 DEFINE_bool(verbose_function_register,
             BoolFromEnv("FLAGS_verbose_function_register", false),
             "Whether to verbose function regist log. This will only work if CINN build with flag -DWITH_DEBUG=ON.");
@@ -195,6 +579,14 @@ bool CanUseNvccCompiler() {
   return (access(nvcc_dir.c_str(), 0) == -1 ? false : true) && (!FLAGS_cinn_compile_with_nvrtc);
 }
 
+bool CanLinkNvgpuRuntimeLibrary() {
+#ifdef CINN_WITH_NVJITLINK
+  return FLAGS_cinn_nvrtc_link_runtime_library && !CanUseNvccCompiler();
+#else
+  return false;
+#endif
+}
+
 bool IsCompiledWithCUDA() {
 #if !defined(CINN_WITH_CUDA)
   return false;
@@ -29,6 +29,10 @@ bool GetCinnCudnnDeterministic();
 
 bool CanUseNvccCompiler();
 
+// Whether the generated CUDA kernels are linked with the precompiled runtime device library instead of including the
+// runtime source.
+bool CanLinkNvgpuRuntimeLibrary();
+
 class RandomSeed {
  public:
   static unsigned long long GetOrSet(unsigned long long seed = 0);
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/backends/function_prototype.h"
+#include "cinn/runtime/hip/hip_util.h"
+
+CINN_REGISTER_HELPER(cinn_hip_host_api) {
+  using cinn::runtime::hip::cinn_call_hip_kernel;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_hip_kernel, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // kernel_fn
+      .AddInputType<void *>()  // args
+      .AddInputType<int>()     // num_args
+      .AddInputType<int>()     // grid_x
+      .AddInputType<int>()     // grid_y
+      .AddInputType<int>()     // grid_z
+      .AddInputType<int>()     // block_x
+      .AddInputType<int>()     // block_y
+      .AddInputType<int>()     // block_z
+      .AddInputType<int>()     // shared_mem_bytes
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::hip::cinn_call_rocblas;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_rocblas, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<bool>()    // trans_a
+      .AddInputType<bool>()    // trans_b
+      .AddInputType<bool>()    // trans_o
+      .AddInputType<float>()   // alpha
+      .AddInputType<float>()   // beta
+      .AddInputType<int>()     // a1
+      .AddInputType<int>()     // a2
+      .AddInputType<int>()     // a3
+      .AddInputType<int>()     // a4
+      .AddInputType<int>()     // b1
+      .AddInputType<int>()     // b2
+      .AddInputType<int>()     // b3
+      .AddInputType<int>()     // b4
+      .AddInputType<void *>()  // stream
+      .End();
+
+  using cinn::runtime::hip::cinn_call_miopen_conv2d_forward;
+  REGISTER_EXTERN_FUNC_HELPER(cinn_call_miopen_conv2d_forward, cinn::common::DefaultHostTarget())
+      .SetRetType<void>()
+      .AddInputType<void *>()  // v_args
+      .AddInputType<int>()     // num_args
+      .AddInputType<float>()   // alpha
+      .AddInputType<float>()   // beta
+      .AddInputType<int>()     // input_n
+      .AddInputType<int>()     // input_c
+      .AddInputType<int>()     // input_h
+      .AddInputType<int>()     // input_w
+      .AddInputType<int>()     // filter_n
+      .AddInputType<int>()     // filter_c
+      .AddInputType<int>()     // filter_h
+      .AddInputType<int>()     // filter_w
+      .AddInputType<int>()     // pad_h
+      .AddInputType<int>()     // pad_w
+      .AddInputType<int>()     // stride_h
+      .AddInputType<int>()     // stride_w
+      .AddInputType<int>()     // dilation_h
+      .AddInputType<int>()     // dilation_w
+      .AddInputType<int>()     // groups
+      .AddInputType<int>()     // output_n
+      .AddInputType<int>()     // output_c
+      .AddInputType<int>()     // output_h
+      .AddInputType<int>()     // output_w
+      .AddInputType<void *>()  // stream
+      .End();
+
+  return true;
+}
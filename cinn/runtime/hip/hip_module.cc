@@ -0,0 +1,103 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/hip/hip_module.h"
+
+#include <glog/logging.h>
+#include <hip/hip_runtime.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace runtime {
+namespace hip {
+
+namespace {
+// the modules shared in the process, keyed by the hash of their data
+struct ModuleCache {
+  std::mutex mutex;
+  std::unordered_multimap<size_t, std::weak_ptr<HIPModule>> modules;
+};
+
+ModuleCache& GetModuleCache() {
+  static ModuleCache cache;
+  return cache;
+}
+}  // namespace
+
+HIPModule::HIPModule(const std::string& data) : data_(data) {
+  CHECK(!data.empty());
+  int num_devices = 0;
+  HIP_CALL(hipGetDeviceCount(&num_devices));
+  CHECK_GT(num_devices, 0) << "No available devices";
+}
+
+std::shared_ptr<HIPModule> HIPModule::GetShared(const std::string& data) {
+  size_t hash = std::hash<std::string>()(data);
+  auto& cache = GetModuleCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto range = cache.modules.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto module = it->second.lock();
+    if (!module) {
+      it = cache.modules.erase(it);
+      continue;
+    }
+    if (module->data_ == data) {
+      VLOG(3) << "Share the HIP module of " << data.size() << " bytes loaded before";
+      return module;
+    }
+    ++it;
+  }
+  auto module = std::make_shared<HIPModule>(data);
+  cache.modules.emplace(hash, module);
+  return module;
+}
+
+hipFunction_t HIPModule::GetFunction(int device_id, const std::string& func_name) {
+  VLOG(5) << "GetFuncion : " << func_name << " with device_id : " << device_id;
+  CHECK_LT(device_id, kHIPMaxCards);
+  cinn::utils::RecordEvent record_run("hipModuleGetFunction", cinn::utils::EventType::kOrdinary);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!module_per_card_[device_id]) {
+      HIP_CALL(hipSetDevice(device_id));
+      HIP_CALL(hipModuleLoadData(&module_per_card_[device_id], data_.data()));
+    }
+  }
+
+  hipFunction_t func;
+  HIP_CALL(hipModuleGetFunction(&func, module_per_card_[device_id], func_name.c_str()));
+  return func;
+}
+
+HIPModule::~HIPModule() {
+  for (int i = 0; i < module_per_card_.size(); i++) {
+    auto* module = module_per_card_[i];
+    if (module) {
+      HIP_CALL(hipSetDevice(i));
+      HIP_CALL(hipModuleUnload(module));
+    }
+  }
+}
+
+}  // namespace hip
+}  // namespace runtime
+}  // namespace cinn
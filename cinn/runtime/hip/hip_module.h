@@ -0,0 +1,59 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef CINN_WITH_ROCM
+
+#include <hip/hip_runtime.h>
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "cinn/runtime/hip/hip_util.h"
+
+namespace cinn {
+namespace runtime {
+namespace hip {
+
+/**
+ * The HIP module of a code object compiled by hipRTC, helps to fetch the kernels on the AMD GPUs, which loads the
+ * code object on each card lazily as CUDAModule does.
+ */
+class HIPModule {
+ public:
+  explicit HIPModule(const std::string& data);
+
+  //! Get the module of \p data shared in the process, the identical code objects are loaded once.
+  static std::shared_ptr<HIPModule> GetShared(const std::string& data);
+
+  //! Get a function.
+  hipFunction_t GetFunction(int device_id, const std::string& func_name);
+
+  ~HIPModule();
+
+ private:
+  //! The code object.
+  std::string data_;
+  //! To make parallel, we prepare one module for each card.
+  std::vector<hipModule_t> module_per_card_{kHIPMaxCards, nullptr};
+  std::mutex mutex_;
+};
+
+}  // namespace hip
+}  // namespace runtime
+}  // namespace cinn
+
+#endif  // CINN_WITH_ROCM
@@ -0,0 +1,452 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/hip/hip_util.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/float16.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace runtime {
+namespace hip {
+
+// The library handles are created per (device, stream) and bound to the stream once at creation, as the CUDA ones.
+template <typename HandleT>
+HandleT &GetStreamHandle(void *stream) {
+  static std::mutex mtx;
+  static absl::flat_hash_map<std::pair<int, void *>, std::unique_ptr<HandleT>> handles;
+  int device_id = 0;
+  HIP_CALL(hipGetDevice(&device_id));
+
+  std::lock_guard<std::mutex> lock(mtx);
+  auto &handle = handles[std::make_pair(device_id, stream)];
+  if (!handle) {
+    VLOG(4) << "Create the library handle for device " << device_id << " and stream " << stream;
+    handle.reset(new HandleT(static_cast<hipStream_t>(stream)));
+  }
+  return *handle;
+}
+
+class RocblasHandle {
+ public:
+  RocblasHandle(const RocblasHandle &) = delete;
+  RocblasHandle &operator=(const RocblasHandle &) = delete;
+  ~RocblasHandle() { ROCBLAS_CALL(rocblas_destroy_handle(handle_)); }
+  static RocblasHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<RocblasHandle>(stream); }
+  rocblas_handle &GetRocblasHandle() { return handle_; }
+
+ private:
+  friend RocblasHandle &GetStreamHandle<RocblasHandle>(void *stream);
+  explicit RocblasHandle(hipStream_t stream) {
+    ROCBLAS_CALL(rocblas_create_handle(&handle_));
+    ROCBLAS_CALL(rocblas_set_stream(handle_, stream));
+  }
+  rocblas_handle handle_;
+};
+
+class MIOpenHandle {
+ public:
+  MIOpenHandle(const MIOpenHandle &) = delete;
+  MIOpenHandle &operator=(const MIOpenHandle &) = delete;
+  ~MIOpenHandle() {
+    if (workspace_ != nullptr) {
+      HIP_CALL(hipFree(workspace_));
+    }
+    MIOPEN_CALL(miopenDestroy(handle_));
+  }
+  static MIOpenHandle &GetInstance(void *stream = nullptr) { return GetStreamHandle<MIOpenHandle>(stream); }
+  miopenHandle_t &GetMIOpenHandle() { return handle_; }
+
+  // the workspace only grows, and is reused by the calls on the same stream
+  void *GetWorkSpace(size_t size) {
+    if (size_ < size) {
+      if (workspace_ != nullptr) {
+        HIP_CALL(hipFree(workspace_));
+      }
+      HIP_CALL(hipMalloc(&workspace_, size));
+      size_ = size;
+    }
+    return workspace_;
+  }
+
+ private:
+  friend MIOpenHandle &GetStreamHandle<MIOpenHandle>(void *stream);
+  explicit MIOpenHandle(hipStream_t stream) { MIOPEN_CALL(miopenCreateWithStream(&handle_, stream)); }
+  miopenHandle_t handle_;
+  void *workspace_{nullptr};
+  size_t size_{0};
+};
+
+void cinn_call_hip_kernel(void *kernel_fn,
+                          void *v_args,
+                          int num_args,
+                          int grid_x,
+                          int grid_y,
+                          int grid_z,
+                          int block_x,
+                          int block_y,
+                          int block_z,
+                          int shared_mem_bytes,
+                          void *stream) {
+  VLOG(3) << "cinn_call_hip_kernel, grid_dim={" << grid_x << ", " << grid_y << ", " << grid_z << "}, block_dim={"
+          << block_x << ", " << block_y << ", " << block_z << "}, shared_mem_bytes=" << shared_mem_bytes
+          << ", num_args=" << num_args << ", stream=" << stream;
+
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  std::vector<void *> kernel_args(num_args);
+  for (int idx = 0; idx < num_args; ++idx) {
+    if (args[idx].type_code() == ::cinn_type_code<cinn_buffer_t *>()) {
+      kernel_args[idx] = &((cinn_buffer_t *)(args[idx]))->memory;
+    } else {
+      kernel_args[idx] = args[idx].data_addr();
+    }
+  }
+
+  cinn::utils::RecordEvent record_run("hipModuleLaunchKernel", cinn::utils::EventType::kInstruction);
+  HIP_CALL(hipModuleLaunchKernel(static_cast<hipFunction_t>(kernel_fn),
+                                 grid_x,
+                                 grid_y,
+                                 grid_z,
+                                 block_x,
+                                 block_y,
+                                 block_z,
+                                 shared_mem_bytes,
+                                 static_cast<hipStream_t>(stream),
+                                 kernel_args.data(),
+                                 nullptr));
+}
+
+namespace {
+// rocBLAS reads alpha and beta in the compute type, which is fp32 for the fp16 and fp32 matmuls
+struct RocblasGemmType {
+  rocblas_datatype data_type;
+  rocblas_datatype compute_type;
+};
+
+RocblasGemmType GetRocblasGemmType(cinn_buffer_t *buffer) {
+  int bytes = buffer->type.bits / CHAR_BIT;
+  CHECK_EQ(buffer->type.code, cinn_type_float) << "The rocBLAS matmul only supports the float types!";
+  if (bytes == sizeof(common::float16)) {
+    return {rocblas_datatype_f16_r, rocblas_datatype_f32_r};
+  } else if (bytes == sizeof(float)) {
+    return {rocblas_datatype_f32_r, rocblas_datatype_f32_r};
+  } else if (bytes == sizeof(double)) {
+    return {rocblas_datatype_f64_r, rocblas_datatype_f64_r};
+  }
+  LOG(FATAL) << "unsupported rocblas data type bytes = " << bytes;
+  return {};
+}
+
+void RocblasGemm(rocblas_handle handle,
+                 const RocblasGemmType &type,
+                 rocblas_operation trans_l,
+                 rocblas_operation trans_r,
+                 int m,
+                 int n,
+                 int k,
+                 float alpha,
+                 const void *lhs,
+                 int ldl,
+                 int64_t stride_l,
+                 const void *rhs,
+                 int ldr,
+                 int64_t stride_r,
+                 float beta,
+                 void *C,
+                 int ldc,
+                 int64_t stride_c,
+                 int batch) {
+  double alpha_fp64  = alpha;
+  double beta_fp64   = beta;
+  bool is_fp64       = type.compute_type == rocblas_datatype_f64_r;
+  const void *alpha_ = is_fp64 ? static_cast<const void *>(&alpha_fp64) : static_cast<const void *>(&alpha);
+  const void *beta_  = is_fp64 ? static_cast<const void *>(&beta_fp64) : static_cast<const void *>(&beta);
+  if (batch == 1) {
+    ROCBLAS_CALL(rocblas_gemm_ex(handle,
+                                 trans_l,
+                                 trans_r,
+                                 m,
+                                 n,
+                                 k,
+                                 alpha_,
+                                 lhs,
+                                 type.data_type,
+                                 ldl,
+                                 rhs,
+                                 type.data_type,
+                                 ldr,
+                                 beta_,
+                                 C,
+                                 type.data_type,
+                                 ldc,
+                                 C,
+                                 type.data_type,
+                                 ldc,
+                                 type.compute_type,
+                                 rocblas_gemm_algo_standard,
+                                 0,
+                                 0));
+  } else {
+    ROCBLAS_CALL(rocblas_gemm_strided_batched_ex(handle,
+                                                 trans_l,
+                                                 trans_r,
+                                                 m,
+                                                 n,
+                                                 k,
+                                                 alpha_,
+                                                 lhs,
+                                                 type.data_type,
+                                                 ldl,
+                                                 stride_l,
+                                                 rhs,
+                                                 type.data_type,
+                                                 ldr,
+                                                 stride_r,
+                                                 beta_,
+                                                 C,
+                                                 type.data_type,
+                                                 ldc,
+                                                 stride_c,
+                                                 C,
+                                                 type.data_type,
+                                                 ldc,
+                                                 stride_c,
+                                                 batch,
+                                                 type.compute_type,
+                                                 rocblas_gemm_algo_standard,
+                                                 0,
+                                                 0));
+  }
+}
+}  // namespace
+
+void cinn_call_rocblas(void *v_args,
+                       int num_args,
+                       bool trans_a,
+                       bool trans_b,
+                       bool trans_o,
+                       float alpha,
+                       float beta,
+                       int a1,
+                       int a2,
+                       int a3,
+                       int a4,
+                       int b1,
+                       int b2,
+                       int b3,
+                       int b4,
+                       void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_rocblas", cinn::utils::EventType::kInstruction);
+  CHECK_EQ(num_args, 3);
+  rocblas_handle &handle = RocblasHandle::GetInstance(stream).GetRocblasHandle();
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  VLOG(3) << "a1 ~ a4: " << a1 << " " << a2 << " " << a3 << " " << a4;
+  VLOG(3) << "b1 ~ b4: " << b1 << " " << b2 << " " << b3 << " " << b4;
+  VLOG(3) << "trans_a: " << trans_a << ", trans_b: " << trans_b << ", trans_o: " << trans_o;
+
+  void *A   = args[0].operator cinn_buffer_t *()->memory;
+  void *B   = args[1].operator cinn_buffer_t *()->memory;
+  void *C   = args[2].operator cinn_buffer_t *()->memory;
+  auto type = GetRocblasGemmType(args[0].operator cinn_buffer_t *());
+  int bytes = args[0].operator cinn_buffer_t *()->type.bits / CHAR_BIT;
+
+  // the same column major mapping as cinn_call_cublas
+  int m = trans_o ? (trans_a ? a4 : a3) : (trans_b ? b3 : b4);
+  int n = trans_o ? (trans_b ? b3 : b4) : (trans_a ? a4 : a3);
+  int k = trans_a ? a3 : a4;
+
+  rocblas_operation trans_op_l = trans_o ? (trans_a ? rocblas_operation_none : rocblas_operation_transpose)
+                                         : (trans_b ? rocblas_operation_transpose : rocblas_operation_none);
+  rocblas_operation trans_op_r = trans_o ? (trans_b ? rocblas_operation_none : rocblas_operation_transpose)
+                                         : (trans_a ? rocblas_operation_transpose : rocblas_operation_none);
+  int ldl = trans_op_l == rocblas_operation_none ? m : k;
+  int ldr = trans_op_r == rocblas_operation_none ? k : n;
+  int ldc = m;
+
+  void *lhs = trans_o ? A : B;
+  void *rhs = trans_o ? B : A;
+
+  int l1 = trans_o ? a1 : b1, l2 = trans_o ? a2 : b2, l3 = trans_o ? a3 : b3, l4 = trans_o ? a4 : b4;
+  int r1 = trans_o ? b1 : a1, r2 = trans_o ? b2 : a2, r3 = trans_o ? b3 : a3, r4 = trans_o ? b4 : a4;
+  if ((l1 == r1 && l2 == r2) || (l1 == 1 && l2 == 1) || (r1 == 1 && r2 == 1)) {
+    // (N, L) * (N, L) , (N, L) * (1, 1) , (1, 1) * (N, L)
+    int64_t stride_l = (l1 == 1 && l2 == 1) ? 0 : l3 * l4;
+    int64_t stride_r = (r1 == 1 && r2 == 1) ? 0 : r3 * r4;
+    int batch        = std::max(l1, r1) * std::max(l2, r2);
+    VLOG(3) << "call rocblas gemm for stride_l = " << stride_l << ", stride_r = " << stride_r << ", batch = " << batch;
+    RocblasGemm(handle,
+                type,
+                trans_op_l,
+                trans_op_r,
+                m,
+                n,
+                k,
+                alpha,
+                lhs,
+                ldl,
+                stride_l,
+                rhs,
+                ldr,
+                stride_r,
+                beta,
+                C,
+                ldc,
+                m * n,
+                batch);
+  } else {
+    // (N, L) * (N, 1) and the like, a strided batched gemm along L for each N
+    CHECK(l1 == r1 || l1 == 1 || r1 == 1) << "The rocBLAS matmul doesn't support this batch!";
+    int batch_n = std::max(l1, r1);
+    int batch_l = std::max(l2, r2);
+    for (int i = 0; i < batch_n; ++i) {
+      auto *lhs_i = static_cast<char *>(lhs) + (l1 == 1 ? 0 : i) * l2 * l3 * l4 * bytes;
+      auto *rhs_i = static_cast<char *>(rhs) + (r1 == 1 ? 0 : i) * r2 * r3 * r4 * bytes;
+      auto *C_i   = static_cast<char *>(C) + i * batch_l * m * n * bytes;
+      RocblasGemm(handle,
+                  type,
+                  trans_op_l,
+                  trans_op_r,
+                  m,
+                  n,
+                  k,
+                  alpha,
+                  lhs_i,
+                  ldl,
+                  l2 == 1 ? 0 : l3 * l4,
+                  rhs_i,
+                  ldr,
+                  r2 == 1 ? 0 : r3 * r4,
+                  beta,
+                  C_i,
+                  ldc,
+                  m * n,
+                  batch_l);
+    }
+  }
+}
+
+void cinn_call_miopen_conv2d_forward(void *v_args,
+                                     int num_args,
+                                     float alpha,
+                                     float beta,
+                                     int input_n,
+                                     int input_c,
+                                     int input_h,
+                                     int input_w,
+                                     int filter_n,
+                                     int filter_c,
+                                     int filter_h,
+                                     int filter_w,
+                                     int pad_h,
+                                     int pad_w,
+                                     int stride_h,
+                                     int stride_w,
+                                     int dilation_h,
+                                     int dilation_w,
+                                     int groups,
+                                     int output_n,
+                                     int output_c,
+                                     int output_h,
+                                     int output_w,
+                                     void *stream) {
+  cinn::utils::RecordEvent record_run("cinn_call_miopen_conv2d_forward", cinn::utils::EventType::kInstruction);
+  CHECK_EQ(num_args, 3);
+  auto &miopen_handle    = MIOpenHandle::GetInstance(stream);
+  miopenHandle_t &handle = miopen_handle.GetMIOpenHandle();
+  cinn_pod_value_t *args = static_cast<cinn_pod_value_t *>(v_args);
+  void *_x               = args[0].operator cinn_buffer_t *()->memory;
+  void *_w               = args[1].operator cinn_buffer_t *()->memory;
+  void *_y               = args[2].operator cinn_buffer_t *()->memory;
+
+  int bytes = args[0].operator cinn_buffer_t *()->type.bits / CHAR_BIT;
+  CHECK(bytes == sizeof(float) || bytes == sizeof(common::float16)) << "MIOpen conv2d only supports fp32 and fp16!";
+  miopenDataType_t data_type = bytes == sizeof(float) ? miopenFloat : miopenHalf;
+
+  miopenTensorDescriptor_t x_desc, w_desc, y_desc;
+  MIOPEN_CALL(miopenCreateTensorDescriptor(&x_desc));
+  MIOPEN_CALL(miopenSet4dTensorDescriptor(x_desc, data_type, input_n, input_c, input_h, input_w));
+  MIOPEN_CALL(miopenCreateTensorDescriptor(&w_desc));
+  MIOPEN_CALL(miopenSet4dTensorDescriptor(w_desc, data_type, filter_n, filter_c, filter_h, filter_w));
+  MIOPEN_CALL(miopenCreateTensorDescriptor(&y_desc));
+  MIOPEN_CALL(miopenSet4dTensorDescriptor(y_desc, data_type, output_n, output_c, output_h, output_w));
+
+  miopenConvolutionDescriptor_t conv_desc;
+  MIOPEN_CALL(miopenCreateConvolutionDescriptor(&conv_desc));
+  MIOPEN_CALL(miopenInitConvolutionDescriptor(
+      conv_desc, miopenConvolution, pad_h, pad_w, stride_h, stride_w, dilation_h, dilation_w));
+  MIOPEN_CALL(miopenSetConvolutionGroupCount(conv_desc, groups));
+
+  size_t workspace_size = 0;
+  MIOPEN_CALL(miopenConvolutionForwardGetWorkSpaceSize(handle, w_desc, x_desc, conv_desc, y_desc, &workspace_size));
+  void *workspace = workspace_size > 0 ? miopen_handle.GetWorkSpace(workspace_size) : nullptr;
+
+  // the algorithm of a shape is found once, the search of MIOpen runs the candidates on the device
+  static std::mutex mtx;
+  static absl::flat_hash_map<std::string, miopenConvFwdAlgorithm_t> algo_cache;
+  std::string key = "conv2d fwd " + std::to_string(bytes) + ", " + std::to_string(input_n) + "x" +
+                    std::to_string(input_c) + "x" + std::to_string(input_h) + "x" + std::to_string(input_w) + ", " +
+                    std::to_string(filter_n) + "x" + std::to_string(filter_c) + "x" + std::to_string(filter_h) + "x" +
+                    std::to_string(filter_w) + ", " + std::to_string(pad_h) + "," + std::to_string(pad_w) + "," +
+                    std::to_string(stride_h) + "," + std::to_string(stride_w) + "," + std::to_string(dilation_h) + "," +
+                    std::to_string(dilation_w) + "," + std::to_string(groups);
+  miopenConvFwdAlgorithm_t algo;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = algo_cache.find(key);
+    if (it != algo_cache.end()) {
+      algo = it->second;
+    } else {
+      int returned_algo_count = 0;
+      miopenConvAlgoPerf_t perf;
+      MIOPEN_CALL(miopenFindConvolutionForwardAlgorithm(handle,
+                                                        x_desc,
+                                                        _x,
+                                                        w_desc,
+                                                        _w,
+                                                        conv_desc,
+                                                        y_desc,
+                                                        _y,
+                                                        1,
+                                                        &returned_algo_count,
+                                                        &perf,
+                                                        workspace,
+                                                        workspace_size,
+                                                        false));
+      CHECK_GT(returned_algo_count, 0) << "MIOpen finds no algorithm of " << key;
+      algo = perf.fwd_algo;
+      algo_cache.emplace(key, algo);
+    }
+  }
+
+  MIOPEN_CALL(miopenConvolutionForward(
+      handle, &alpha, x_desc, _x, w_desc, _w, conv_desc, algo, &beta, y_desc, _y, workspace, workspace_size));
+
+  MIOPEN_CALL(miopenDestroyTensorDescriptor(x_desc));
+  MIOPEN_CALL(miopenDestroyTensorDescriptor(w_desc));
+  MIOPEN_CALL(miopenDestroyTensorDescriptor(y_desc));
+  MIOPEN_CALL(miopenDestroyConvolutionDescriptor(conv_desc));
+}
+
+}  // namespace hip
+}  // namespace runtime
+}  // namespace cinn
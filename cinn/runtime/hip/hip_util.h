@@ -0,0 +1,130 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef CINN_WITH_ROCM
+
+#include <glog/logging.h>
+#include <hip/hip_runtime.h>
+#include <hip/hiprtc.h>
+#include <miopen/miopen.h>
+#include <rocblas/rocblas.h>
+
+#include "cinn/runtime/cinn_runtime.h"
+
+#define HIP_CALL(func)                                           \
+  {                                                              \
+    auto status = func;                                          \
+    if (status != hipSuccess) {                                  \
+      LOG(FATAL) << "HIP Error : " << hipGetErrorString(status); \
+    }                                                            \
+  }
+
+#define HIPRTC_CALL(func)                                              \
+  {                                                                    \
+    auto status = func;                                                \
+    if (status != HIPRTC_SUCCESS) {                                    \
+      LOG(FATAL) << "hipRTC Error : " << hiprtcGetErrorString(status); \
+    }                                                                  \
+  }
+
+#define ROCBLAS_CALL(func)                                                  \
+  {                                                                         \
+    auto status = func;                                                     \
+    if (status != rocblas_status_success) {                                 \
+      LOG(FATAL) << "rocBLAS Error : " << rocblas_status_to_string(status); \
+    }                                                                       \
+  }
+
+#define MIOPEN_CALL(func)                                              \
+  {                                                                    \
+    auto status = func;                                                \
+    if (status != miopenStatusSuccess) {                               \
+      LOG(FATAL) << "MIOpen Error : " << miopenGetErrorString(status); \
+    }                                                                  \
+  }
+
+namespace cinn {
+namespace runtime {
+namespace hip {
+
+const int kHIPMaxCards{8};
+
+/**
+ * Call a HIP compiled kernel, the counterpart of cinn_call_cuda_kernel on the AMD GPUs.
+ *
+ * @param kernel_fn the hipFunction_t of the kernel.
+ * @param args an array of cinn_pod_value_ts(consists of scalars and buffers).
+ */
+void cinn_call_hip_kernel(void *kernel_fn,
+                          void *v_args,
+                          int num_args,
+                          int grid_x,
+                          int grid_y,
+                          int grid_z,
+                          int block_x,
+                          int block_y,
+                          int block_z,
+                          int shared_mem_bytes,
+                          void *stream);
+
+//! The matmul by rocBLAS, whose arguments are the same as cinn_call_cublas.
+void cinn_call_rocblas(void *v_args,
+                       int num_args,
+                       bool trans_a,
+                       bool trans_b,
+                       bool trans_o,
+                       float alpha,
+                       float beta,
+                       int a1,
+                       int a2,
+                       int a3,
+                       int a4,
+                       int b1,
+                       int b2,
+                       int b3,
+                       int b4,
+                       void *stream);
+
+//! The forward conv2d of the NCHW tensors by MIOpen.
+void cinn_call_miopen_conv2d_forward(void *v_args,
+                                     int num_args,
+                                     float alpha,
+                                     float beta,
+                                     int input_n,
+                                     int input_c,
+                                     int input_h,
+                                     int input_w,
+                                     int filter_n,
+                                     int filter_c,
+                                     int filter_h,
+                                     int filter_w,
+                                     int pad_h,
+                                     int pad_w,
+                                     int stride_h,
+                                     int stride_w,
+                                     int dilation_h,
+                                     int dilation_w,
+                                     int groups,
+                                     int output_n,
+                                     int output_c,
+                                     int output_h,
+                                     int output_w,
+                                     void *stream);
+
+}  // namespace hip
+}  // namespace runtime
+}  // namespace cinn
+
+#endif  // CINN_WITH_ROCM
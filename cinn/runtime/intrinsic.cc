@@ -43,6 +43,8 @@ cinn_type_t ToRuntimeType(Type type) {
 
   SET_TYPE_CASE_ITEM(BF16, cinn_bfloat16_t)
   SET_TYPE_CASE_ITEM(F16, cinn_float16_t)
+  SET_TYPE_CASE_ITEM(F8E4M3, cinn_float8_e4m3_t)
+  SET_TYPE_CASE_ITEM(F8E5M2, cinn_float8_e5m2_t)
   SET_TYPE_CASE_ITEM(F32, cinn_float32_t)
   SET_TYPE_CASE_ITEM(F64, cinn_float64_t)
 
@@ -100,6 +100,13 @@ static const char* print_debug_args_repr = "cinn_print_debug_args";
 
 static const char* call_cuda_kernel = "cinn_call_cuda_kernel";
 
+static const char* call_cuda_cooperative_kernel = "cinn_call_cuda_cooperative_kernel";
+
+static const char* call_hip_kernel = "cinn_call_hip_kernel";
+
+//! The grid-wide barrier in the cooperative kernels.
+static const char* cuda_grid_sync = "cinn_grid_sync";
+
 static const char* pod_values_to_array_repr = "pod_values_to_array";
 
 static const char* get_address_repr = "get_address";
@@ -115,6 +122,13 @@ static const char* cuda_sync_threads = "__syncthreads";
 
 static const char* parallel_launch = "cinn_backend_parallel_launch";
 
+//! Reduce all the lanes of a vector into a scalar, which are emitted by the vectorized reduction loops.
+// @{
+static const char* vector_reduce_add = "cinn_vector_reduce_add";
+static const char* vector_reduce_max = "cinn_vector_reduce_max";
+static const char* vector_reduce_min = "cinn_vector_reduce_min";
+// @}
+
 }  // namespace intrinsic
 
 /**
@@ -16,11 +16,14 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <thread>
 #include <vector>
 
+#include "cinn/runtime/cpu/thread_pool.h"
 #include "cinn_runtime.h"
 
 extern "C" {
@@ -146,7 +149,22 @@ cinn_pod_value_t *get_pod_value(void *ctx, const char *tname) {
 typedef int (*FCINNParallelLambda)(int task_id, int num_task, void *datas);
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void *datas, int num_task) {
   int num_workers = max_num_workers;
+  int budget      = cinn::runtime::cpu::ThreadPool::GetThreadBudget();
+  if (budget > 0) num_workers = std::min(num_workers, budget);
   if (num_task == 0) num_task = num_workers;
+  // use the persistent thread pool instead of OpenMP if CINN_THREAD_BACKEND=pool
+  static bool use_thread_pool = [] {
+    const char *val = getenv("CINN_THREAD_BACKEND");
+    return val != nullptr && strcmp(val, "pool") == 0;
+  }();
+  if (use_thread_pool) {
+    static cinn::runtime::cpu::ThreadPool pool(max_num_workers - 1, [] {
+      const char *val = getenv("CINN_THREAD_AFFINITY");
+      return val == nullptr || strcmp(val, "0") != 0;
+    }());
+    pool.ParallelFor(num_task, [&](int task_id) { (*flambda)(task_id, num_task, datas); });
+    return 0;
+  }
   omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
   {
@@ -15,6 +15,9 @@
 #pragma once
 
 #include "cinn/runtime/cpu/use_extern_funcs.h"
-#ifdef CINN_WITH_CUDA
+#if defined(CINN_WITH_CUDA) || defined(CINN_WITH_ROCM)
 #include "cinn/runtime/cuda/use_extern_funcs.h"
 #endif
+#ifdef CINN_WITH_ROCM
+#include "cinn/runtime/hip/use_extern_funcs.h"
+#endif
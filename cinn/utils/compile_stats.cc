@@ -0,0 +1,190 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/compile_stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace cinn {
+namespace utils {
+
+namespace {
+thread_local CompileStats* active_stats = nullptr;
+
+CompileStats& PendingStats() {
+  thread_local CompileStats pending;
+  return pending;
+}
+}  // namespace
+
+CompileStats::CompileStats(const CompileStats& other) { Merge(other); }
+
+CompileStats& CompileStats::operator=(const CompileStats& other) {
+  if (this != &other) {
+    Clear();
+    Merge(other);
+  }
+  return *this;
+}
+
+void CompileStats::AddPhase(const std::string& name, double ms, int64_t ir_size) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& phase = phases_[name];
+  phase.count += 1;
+  phase.total_ms += ms;
+  if (ir_size >= 0) {
+    phase.ir_size = ir_size;
+  }
+}
+
+void CompileStats::AddGroup(const GroupStats& stats) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  groups_.push_back(stats);
+}
+
+void CompileStats::AddModule(const ModuleStats& stats) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  modules_.push_back(stats);
+}
+
+void CompileStats::AddKernel(const KernelStats& stats) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  kernels_.push_back(stats);
+}
+
+void CompileStats::Merge(const CompileStats& other) {
+  auto phases  = other.Phases();
+  auto groups  = other.Groups();
+  auto modules = other.Modules();
+  auto kernels = other.Kernels();
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (auto& item : phases) {
+    auto& phase = phases_[item.first];
+    phase.count += item.second.count;
+    phase.total_ms += item.second.total_ms;
+    if (item.second.ir_size >= 0) {
+      phase.ir_size = item.second.ir_size;
+    }
+  }
+  groups_.insert(groups_.end(), groups.begin(), groups.end());
+  modules_.insert(modules_.end(), modules.begin(), modules.end());
+  kernels_.insert(kernels_.end(), kernels.begin(), kernels.end());
+}
+
+void CompileStats::Clear() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  phases_.clear();
+  groups_.clear();
+  modules_.clear();
+  kernels_.clear();
+}
+
+std::map<std::string, CompileStats::PhaseStats> CompileStats::Phases() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return phases_;
+}
+
+std::vector<CompileStats::GroupStats> CompileStats::Groups() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return groups_;
+}
+
+std::vector<CompileStats::ModuleStats> CompileStats::Modules() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return modules_;
+}
+
+std::vector<CompileStats::KernelStats> CompileStats::Kernels() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return kernels_;
+}
+
+std::string CompileStats::Summary() const {
+  auto phases  = Phases();
+  auto groups  = Groups();
+  auto modules = Modules();
+  auto kernels = Kernels();
+  std::stable_sort(groups.begin(), groups.end(), [](const GroupStats& a, const GroupStats& b) {
+    return a.lowering_ms > b.lowering_ms;
+  });
+  std::stable_sort(kernels.begin(), kernels.end(), [](const KernelStats& a, const KernelStats& b) {
+    return a.occupancy < b.occupancy;
+  });
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "Compile phases:\n";
+  for (auto& item : phases) {
+    ss << "  " << std::left << std::setw(48) << item.first << " count: " << std::setw(6) << item.second.count
+       << " total: " << item.second.total_ms << " ms";
+    if (item.second.ir_size >= 0) {
+      ss << ", IR size: " << item.second.ir_size;
+    }
+    ss << "\n";
+  }
+
+  double lowering_ms = 0.0;
+  ss << "Fusion groups:\n";
+  for (auto& group : groups) {
+    lowering_ms += group.lowering_ms;
+    ss << "  " << std::left << std::setw(48) << group.fn_name << " nodes: " << std::setw(6) << group.num_nodes
+       << " lowering: " << group.lowering_ms << " ms, IR size: " << group.ir_size << "\n";
+  }
+
+  double codegen_ms = 0.0;
+  ss << "Modules:\n";
+  for (auto& module : modules) {
+    codegen_ms += module.codegen_ms + module.device_compile_ms + module.jit_ms;
+    ss << "  functions: " << std::setw(6) << module.fn_names.size() << " codegen: " << module.codegen_ms
+       << " ms, device compile: " << module.device_compile_ms << " ms, jit: " << module.jit_ms
+       << " ms, source: " << module.source_bytes << " bytes, device code: " << module.device_code_bytes
+       << " bytes, object: " << module.object_bytes << " bytes\n";
+  }
+  if (!kernels.empty()) {
+    ss << "Kernels:\n";
+    for (auto& kernel : kernels) {
+      ss << "  " << std::left << std::setw(48) << kernel.kernel_name << " threads: " << std::setw(6)
+         << kernel.block_threads << " registers: " << kernel.num_regs << ", local: " << kernel.local_bytes
+         << " bytes, shared: " << kernel.shared_bytes << " bytes, occupancy: " << kernel.occupancy << "\n";
+    }
+  }
+  ss << "Total lowering: " << lowering_ms << " ms, total codegen and compile: " << codegen_ms << " ms\n";
+  return ss.str();
+}
+
+CompileStats* CompileStats::Active() { return active_stats; }
+
+void CompileStats::RecordPhase(const std::string& name, double ms, int64_t ir_size) {
+  auto* stats = active_stats ? active_stats : &PendingStats();
+  stats->AddPhase(name, ms, ir_size);
+}
+
+void CompileStats::TakePending(CompileStats* stats) {
+  auto& pending = PendingStats();
+  stats->Merge(pending);
+  pending.Clear();
+}
+
+CompileStats::ScopedActive::ScopedActive(CompileStats* stats) : prev_(active_stats) { active_stats = stats; }
+
+CompileStats::ScopedActive::~ScopedActive() { active_stats = prev_; }
+
+CompileStats::PhaseTimer::PhaseTimer(const std::string& name) : name_(name) { timer_.Start(); }
+
+CompileStats::PhaseTimer::~PhaseTimer() { RecordPhase(name_, timer_.Stop(), ir_size_); }
+
+}  // namespace utils
+}  // namespace cinn
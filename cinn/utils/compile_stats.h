@@ -0,0 +1,135 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace utils {
+
+/**
+ * CompileStats records where the compile time goes: the time and the IR size of each phase, such as the program
+ * passes, the graph passes and the code generation, the lowering of each fusion group and the code generation of
+ * each compiled module.
+ *
+ * The phases are recorded by RecordPhase into the stats activated on the current thread by ScopedActive. Those
+ * recorded when no stats is active, such as the passes run before GraphCompiler::Build, are kept as the pending
+ * stats of the thread, and taken by the next compile on the thread.
+ */
+class CompileStats {
+ public:
+  struct PhaseStats {
+    int count{0};
+    double total_ms{0.0};
+    // the size of the IR after the last run of the phase, such as the number of instructions or nodes, -1 if unknown
+    int64_t ir_size{-1};
+  };
+
+  struct GroupStats {
+    std::string fn_name;
+    int num_nodes{0};
+    double lowering_ms{0.0};
+    // the number of the distinct IR nodes of the lowered function
+    int64_t ir_size{0};
+  };
+
+  struct ModuleStats {
+    std::vector<std::string> fn_names;
+    double codegen_ms{0.0};
+    // the time of NVRTC, which is 0 for the host modules
+    double device_compile_ms{0.0};
+    double jit_ms{0.0};
+    size_t source_bytes{0};
+    size_t device_code_bytes{0};
+    size_t object_bytes{0};
+  };
+
+  // the resource usage of a CUDA kernel reported by the driver after loading
+  struct KernelStats {
+    std::string kernel_name;
+    int block_threads{0};
+    int num_regs{0};
+    // the local memory of each thread, which holds the spilled registers and the local arrays not in registers
+    int local_bytes{0};
+    // the static and the dynamic shared memory of each block
+    int shared_bytes{0};
+    // the ratio of the active warps on a multiprocessor to its max, 0 if the block can't launch at all
+    double occupancy{0.0};
+  };
+
+  CompileStats() = default;
+  CompileStats(const CompileStats& other);
+  CompileStats& operator=(const CompileStats& other);
+
+  void AddPhase(const std::string& name, double ms, int64_t ir_size = -1);
+  void AddGroup(const GroupStats& stats);
+  void AddModule(const ModuleStats& stats);
+  void AddKernel(const KernelStats& stats);
+  void Merge(const CompileStats& other);
+  void Clear();
+
+  std::map<std::string, PhaseStats> Phases() const;
+  std::vector<GroupStats> Groups() const;
+  std::vector<ModuleStats> Modules() const;
+  std::vector<KernelStats> Kernels() const;
+
+  //! A readable report, the groups are sorted by the lowering time and the kernels by the occupancy.
+  std::string Summary() const;
+
+  //! The stats activated on the current thread, nullptr if none.
+  static CompileStats* Active();
+  //! Record a phase into the active stats of the current thread, or the pending stats of the thread if none.
+  static void RecordPhase(const std::string& name, double ms, int64_t ir_size = -1);
+  //! Move the pending stats of the current thread into \p stats.
+  static void TakePending(CompileStats* stats);
+
+  // Activate the stats on the current thread in the scope.
+  class ScopedActive {
+   public:
+    explicit ScopedActive(CompileStats* stats);
+    ~ScopedActive();
+
+   private:
+    CompileStats* prev_;
+  };
+
+  // Record the time from construction to destruction as a phase.
+  class PhaseTimer {
+   public:
+    explicit PhaseTimer(const std::string& name);
+    ~PhaseTimer();
+    void SetIRSize(int64_t ir_size) { ir_size_ = ir_size; }
+
+   private:
+    std::string name_;
+    int64_t ir_size_{-1};
+    Timer timer_;
+  };
+
+ private:
+  mutable std::mutex mtx_;
+  std::map<std::string, PhaseStats> phases_;
+  std::vector<GroupStats> groups_;
+  std::vector<ModuleStats> modules_;
+  std::vector<KernelStats> kernels_;
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/compile_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace cinn {
+namespace utils {
+
+TEST(CompileStats, RecordPhase) {
+  CompileStats stats;
+  {
+    CompileStats::ScopedActive active(&stats);
+    CompileStats::RecordPhase("GraphPass OpFusionPass", 2.0, 10);
+    CompileStats::RecordPhase("GraphPass OpFusionPass", 3.0, 8);
+    { CompileStats::PhaseTimer timer("CodeGen"); }
+  }
+  auto phases = stats.Phases();
+  ASSERT_EQ(phases.size(), 2UL);
+  ASSERT_EQ(phases["GraphPass OpFusionPass"].count, 2);
+  ASSERT_DOUBLE_EQ(phases["GraphPass OpFusionPass"].total_ms, 5.0);
+  ASSERT_EQ(phases["GraphPass OpFusionPass"].ir_size, 8);
+  ASSERT_EQ(phases["CodeGen"].count, 1);
+  ASSERT_EQ(phases["CodeGen"].ir_size, -1);
+}
+
+TEST(CompileStats, TakePending) {
+  // the phases recorded without the active stats are taken by the next compile on the same thread
+  CompileStats::RecordPhase("ProgramPass Decomposer", 1.0, 5);
+  std::thread other([]() { CompileStats::RecordPhase("ProgramPass RemoveIdentity", 1.0); });
+  other.join();
+
+  CompileStats stats;
+  CompileStats::TakePending(&stats);
+  auto phases = stats.Phases();
+  ASSERT_EQ(phases.size(), 1UL);
+  ASSERT_EQ(phases["ProgramPass Decomposer"].ir_size, 5);
+
+  CompileStats next;
+  CompileStats::TakePending(&next);
+  ASSERT_TRUE(next.Phases().empty());
+}
+
+TEST(CompileStats, Summary) {
+  CompileStats stats;
+  stats.AddGroup({"fn_small", 1, 1.0, 10});
+  stats.AddGroup({"fn_large", 5, 9.0, 100});
+  CompileStats::ModuleStats module;
+  module.fn_names   = {"fn_small", "fn_large"};
+  module.codegen_ms = 2.0;
+  stats.AddModule(module);
+  stats.AddKernel({"fn_small_kernel", 256, 32, 0, 0, 1.0});
+  stats.AddKernel({"fn_large_kernel", 1024, 128, 64, 49152, 0.5});
+
+  CompileStats copied = stats;
+  ASSERT_EQ(copied.Groups().size(), 2UL);
+  ASSERT_EQ(copied.Kernels().size(), 2UL);
+  auto summary = copied.Summary();
+  // the slowest group and the kernel of the lowest occupancy go first
+  ASSERT_LT(summary.find("fn_large"), summary.find("fn_small"));
+  ASSERT_LT(summary.find("fn_large_kernel"), summary.find("fn_small_kernel"));
+  ASSERT_NE(summary.find("Total lowering: 10.000 ms"), std::string::npos);
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -14,6 +14,7 @@
 
 #include "cinn/utils/multi_threading.h"
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include <future>
@@ -23,6 +24,8 @@
 
 #include "cinn/utils/string.h"
 
+DECLARE_int32(cinn_task_pool_threads);
+
 namespace cinn {
 namespace utils {
 
@@ -40,9 +43,103 @@ int SequenceDispatcher::Next() const {
   return idx;
 }
 
+QueueDispatcher::QueueDispatcher(size_t capacity) : capacity_(capacity) {
+  CHECK_GT(capacity, 0) << "capacity should be greater than 0";
+}
+
+void QueueDispatcher::Push(int index) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  CHECK(!closed_) << "Can't push a job into a closed dispatcher";
+  not_full_.wait(lock, [this]() { return jobs_.size() < capacity_; });
+  jobs_.push_back(index);
+  not_empty_.notify_one();
+}
+
+void QueueDispatcher::Close() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  closed_ = true;
+  not_empty_.notify_all();
+}
+
+int QueueDispatcher::Next() const {
+  std::unique_lock<std::mutex> lock(mtx_);
+  not_empty_.wait(lock, [this]() { return closed_ || !jobs_.empty(); });
+  if (jobs_.empty()) {
+    return -1;
+  }
+  int index = jobs_.front();
+  jobs_.pop_front();
+  not_full_.notify_one();
+  return index;
+}
+
+TaskPool& TaskPool::Global() {
+  // never destroyed, so the tasks still running at the exit don't race with the static destructors
+  static TaskPool* pool = new TaskPool(
+      FLAGS_cinn_task_pool_threads > 0 ? FLAGS_cinn_task_pool_threads : std::thread::hardware_concurrency());
+  return *pool;
+}
+
+TaskPool::TaskPool(int num_threads) {
+  CHECK_GT(num_threads, 0) << "num_threads should be greater than 0";
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopped_ = true;
+    not_empty_.notify_all();
+  }
+  for (auto&& worker : workers_) {
+    worker.join();
+  }
+}
+
+void TaskPool::Enqueue(std::function<void()> task) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  CHECK(!stopped_) << "Can't submit a task to a stopped pool";
+  tasks_.emplace_back(std::move(task));
+  not_empty_.notify_one();
+}
+
+bool TaskPool::RunPendingTask() {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (tasks_.empty()) {
+      return false;
+    }
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+  }
+  task();
+  return true;
+}
+
+void TaskPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      not_empty_.wait(lock, [this]() { return stopped_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
 void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_threads) {
-  if (num_threads == -1 || num_threads > std::thread::hardware_concurrency()) {
-    num_threads = std::thread::hardware_concurrency();
+  auto& pool = TaskPool::Global();
+  if (num_threads == -1 || num_threads > pool.num_threads()) {
+    num_threads = pool.num_threads();
   }
   CHECK_GT(num_threads, 0) << "num_threads should be greater than 0";
 
@@ -58,16 +155,13 @@ void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_
   };
 
   std::vector<std::future<int>> futures;
-  std::vector<std::thread> threads;
-  // The first thread runs inplace, and other `num_threads - 1` threads launched
-  // with std::future to run asynchronously
+  // The first thread runs inplace, and other `num_threads - 1` tasks are submitted
+  // to the global pool to run asynchronously, a task started after all the jobs are
+  // dispatched returns at once
   if (num_threads > 1) {
     futures.reserve(num_threads - 1);
-    threads.reserve(num_threads - 1);
     for (int tid = 1; tid < num_threads; ++tid) {
-      std::packaged_task<int(int)> task(worker);
-      futures.emplace_back(task.get_future());
-      threads.emplace_back(std::move(task), tid);
+      futures.emplace_back(pool.Submit([&worker, tid]() { return worker(tid); }));
     }
   }
 
@@ -78,18 +172,13 @@ void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_
     VLOG(4) << "Thread-0  process " << counter << " tasks.";
 
     for (auto&& future : futures) {
-      counter = future.get();
+      counter = pool.Wait(&future);
       ++tid;
       VLOG(4) << "Thread-" << tid << " process " << counter << " tasks.";
     }
   } catch (const std::exception& e) {
     LOG(FATAL) << "parallel_run incurs error: " << e.what();
   }
-
-  // join threads
-  for (auto&& thread : threads) {
-    thread.join();
-  }
 }
 
 }  // namespace utils
@@ -14,7 +14,17 @@
 
 #pragma once
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cinn {
 namespace utils {
@@ -50,11 +60,85 @@ class SequenceDispatcher : public JobDispatcher {
   mutable std::atomic<int> index_;
 };
 
+// This dispatcher pops the jobs pushed by producers in the FIFO order,
+// `Next` blocks until a job is pushed or the dispatcher is closed.
+// The number of pending jobs is bounded by `capacity`, `Push` blocks when it is full,
+// which holds back the producers running faster than the consumers.
+class QueueDispatcher : public JobDispatcher {
+ public:
+  explicit QueueDispatcher(size_t capacity);
+
+  void Push(int index);
+
+  // no more jobs will be pushed, `Next` returns -1 after the pending jobs are popped
+  void Close();
+
+  int Next() const override;
+
+ private:
+  size_t capacity_;
+  bool closed_{false};
+  mutable std::deque<int> jobs_;
+  mutable std::mutex mtx_;
+  mutable std::condition_variable not_empty_;
+  mutable std::condition_variable not_full_;
+};
+
+// A pool of threads running the submitted tasks in the FIFO order. The global pool is shared by all the compile-time
+// and tuning parallelism, so that no thread is created per call and the overlapped compile and tune don't
+// oversubscribe the cores. A thread waiting for a future by `Wait` runs the pending tasks meanwhile, so a task
+// submitting and waiting nested tasks, such as a task calling `parallel_run`, never deadlocks the pool.
+class TaskPool {
+ public:
+  // the pool of FLAGS_cinn_task_pool_threads threads, created on the first use
+  static TaskPool& Global();
+
+  explicit TaskPool(int num_threads);
+  ~TaskPool();
+
+  int num_threads() const { return workers_.size(); }
+
+  template <typename Fn>
+  std::future<std::invoke_result_t<Fn>> Submit(Fn&& fn) {
+    using ResultType = std::invoke_result_t<Fn>;
+    auto task        = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Fn>(fn));
+    auto future      = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  // wait the future to get its result, the pending tasks are run in the calling thread meanwhile
+  template <typename T>
+  T Wait(std::future<T>* future) {
+    while (future->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      if (!RunPendingTask()) {
+        future->wait_for(std::chrono::microseconds(100));
+      }
+    }
+    return future->get();
+  }
+
+  // pop a pending task and run it in the calling thread, returns false if no task is pending
+  bool RunPendingTask();
+
+ private:
+  void Enqueue(std::function<void()> task);
+
+  void WorkerLoop();
+
+  bool stopped_{false};
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mtx_;
+  std::condition_variable not_empty_;
+  std::vector<std::thread> workers_;
+};
+
 /**
  * \brief A general function to run a batch of jobs in parallel
  * \param fn A instance of WorkerFuncType, which defines how to complete a specified job
  * \param dispatcher A instance of JobDispatcher, which pops index of the next job
- * \param num_threads The number of threads used to run jobs, -1 means utilizing the maximum limit of hardware
+ * \param num_threads The number of threads used to run jobs, -1 means utilizing all the threads of the global task pool
+ * The calling thread runs jobs as one of the threads, and the others are the tasks submitted to the global task pool.
  */
 void parallel_run(const WorkerFuncType& fn, JobDispatcher&& dispatcher, int num_threads = -1);
 
@@ -17,7 +17,10 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <future>
 #include <memory>
+#include <thread>
 #include <vector>
 
 namespace cinn {
@@ -31,6 +34,34 @@ TEST(JobDispatcher, SequenceDispatcher) {
   ASSERT_EQ(-1, dispatcher->Next());
 }
 
+TEST(JobDispatcher, QueueDispatcher) {
+  QueueDispatcher dispatcher(2);
+  dispatcher.Push(3);
+  dispatcher.Push(1);
+  ASSERT_EQ(3, dispatcher.Next());
+  ASSERT_EQ(1, dispatcher.Next());
+  dispatcher.Close();
+  // check reach the end after closed
+  ASSERT_EQ(-1, dispatcher.Next());
+}
+
+TEST(parallel_run, QueueDispatcher) {
+  std::vector<int> results(100, -1);
+  QueueDispatcher dispatcher(4);
+  // the producer is blocked when 4 jobs are pending, until the consumers pop them
+  std::thread producer([&dispatcher]() {
+    for (int i = 0; i < 100; ++i) {
+      dispatcher.Push(i);
+    }
+    dispatcher.Close();
+  });
+  parallel_run([&results](int index) { results[index] = index; }, std::move(dispatcher), 3);
+  producer.join();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(results[i], i);
+  }
+}
+
 TEST(parallel_run, Basic) {
   std::vector<int> results(100, -1);
   auto woker_fn = [&results](int index) {
@@ -55,5 +86,30 @@ TEST(parallel_run, Basic) {
   }
 }
 
+TEST(TaskPool, SubmitAndWait) {
+  TaskPool pool(2);
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.emplace_back(pool.Submit([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(pool.Wait(&futures[i]), i * i);
+  }
+}
+
+TEST(parallel_run, Nested) {
+  // every job runs a nested parallel_run, the waiting threads run the pending tasks, so none of them is starved
+  std::vector<std::atomic<int>> sums(16);
+  parallel_run(
+      [&sums](int outer) {
+        parallel_run([&sums, outer](int inner) { sums[outer] += inner; }, SequenceDispatcher(0, 100), -1);
+      },
+      SequenceDispatcher(0, 16),
+      -1);
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_EQ(sums[i].load(), 4950);
+  }
+}
+
 }  // namespace utils
 }  // namespace cinn
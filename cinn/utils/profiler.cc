@@ -27,6 +27,8 @@
 #endif
 #include <chrono>
 
+#include "cinn/utils/trace.h"
+
 DECLARE_int32(cinn_profiler_state);
 
 namespace cinn {
@@ -56,6 +58,13 @@ void ProfilerHelper::UpdateState() {
 }
 
 RecordEvent::RecordEvent(const std::string& name, EventType type) {
+  if (TraceCollector::IsEnable()) {
+    trace_call_back_ = [start_us = TraceCollector::GetInstance().NowUs(), name, type]() {
+      auto& collector = TraceCollector::GetInstance();
+      collector.Record(name, type, start_us, collector.NowUs());
+    };
+  }
+
   if (!ProfilerHelper::IsEnable()) return;
 
   if (ProfilerHelper::IsEnableCPU()) {
@@ -71,11 +80,19 @@ RecordEvent::RecordEvent(const std::string& name, EventType type) {
   }
 }
 
+bool RecordEvent::IsEnabled() { return TraceCollector::IsEnable() || ProfilerHelper::IsEnable(); }
+
 void RecordEvent::End() {
+  if (trace_call_back_ != nullptr) {
+    trace_call_back_();
+    trace_call_back_ = nullptr;
+  }
+
   if (!ProfilerHelper::IsEnable()) return;
 
   if (ProfilerHelper::IsEnableCPU() && call_back_ != nullptr) {
     call_back_();
+    call_back_ = nullptr;
   }
 
   if (ProfilerHelper::IsEnableCUDA()) {
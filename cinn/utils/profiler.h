@@ -68,10 +68,15 @@ class RecordEvent {
 
   void End();
 
+  //! Whether the events are recorded, so the hot paths can skip constructing them when both profiler and trace are off.
+  static bool IsEnabled();
+
   ~RecordEvent() { End(); }
 
  private:
   CallBack call_back_;
+  // record the span to TraceCollector
+  CallBack trace_call_back_;
 };
 
 void SynchronizeAllDevice();
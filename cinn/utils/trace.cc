@@ -0,0 +1,145 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/trace.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+DECLARE_string(cinn_trace_file);
+
+namespace cinn {
+namespace utils {
+
+namespace {
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Escape the string to be a JSON string literal.
+std::string JsonEscape(const std::string& str) {
+  std::stringstream ss;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      case '\n':
+        ss << "\\n";
+        break;
+      case '\t':
+        ss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          ss << c;
+        }
+    }
+  }
+  return ss.str();
+}
+
+}  // namespace
+
+TraceCollector& TraceCollector::GetInstance() {
+  static TraceCollector instance;
+  return instance;
+}
+
+bool TraceCollector::IsEnable() { return !FLAGS_cinn_trace_file.empty(); }
+
+TraceCollector::TraceCollector() : start_ns_(SteadyNowNs()) {}
+
+TraceCollector::~TraceCollector() {
+  if (!IsEnable() || events_.empty()) return;
+  if (Dump(FLAGS_cinn_trace_file)) {
+    LOG(INFO) << "Write " << events_.size() << " trace events to " << FLAGS_cinn_trace_file;
+  }
+}
+
+double TraceCollector::NowUs() const { return (SteadyNowNs() - start_ns_) / 1000.; }
+
+int TraceCollector::CurrentThreadIndex() {
+  thread_local int thread_index = -1;
+  if (thread_index < 0) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    thread_index = num_threads_++;
+  }
+  return thread_index;
+}
+
+void TraceCollector::Record(const std::string& name, EventType type, double start_us, double end_us) {
+  int tid = CurrentThreadIndex();
+  std::lock_guard<std::mutex> lock(mtx_);
+  events_.push_back({name, type, tid, start_us, end_us - start_us});
+}
+
+std::vector<TraceEvent> TraceCollector::Events() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return events_;
+}
+
+void TraceCollector::Clear() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  events_.clear();
+}
+
+std::string TraceCollector::ToJson() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  int pid = getpid();
+  // name the threads, the thread 0 is the one records the first event, usually the main thread
+  for (int tid = 0; tid < num_threads_; ++tid) {
+    ss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"args\":{\"name\":\"cinn thread " << tid << "\"}},\n";
+  }
+  for (int i = 0; i < events_.size(); ++i) {
+    auto& event = events_[i];
+    std::stringstream type;
+    type << event.type;
+    ss << "{\"name\":\"" << JsonEscape(event.name) << "\",\"cat\":\"" << type.str() << "\",\"ph\":\"X\",\"pid\":" << pid
+       << ",\"tid\":" << event.tid << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}"
+       << (i + 1 < events_.size() ? ",\n" : "\n");
+  }
+  ss << "]}\n";
+  return ss.str();
+}
+
+bool TraceCollector::Dump(const std::string& path) const {
+  std::ofstream ofs(path);
+  if (!ofs.is_open()) {
+    LOG(WARNING) << "Failed to open the trace file: " << path;
+    return false;
+  }
+  ofs << ToJson();
+  return true;
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/utils/event.h"
+
+namespace cinn {
+namespace utils {
+
+struct TraceEvent {
+  std::string name;
+  EventType type;
+  // the index of the thread which records the event
+  int tid;
+  // the start time relative to the creation of the collector and the duration, in microseconds
+  double start_us;
+  double duration_us;
+};
+
+/**
+ * TraceCollector gathers the spans of RecordEvent from all the threads and exports them in the Chrome trace-event
+ * JSON format, which can be opened by chrome://tracing or Perfetto.
+ *
+ * It is enabled by FLAGS_cinn_trace_file, and the trace is written to the file when the process exits, or on Dump.
+ */
+class TraceCollector {
+ public:
+  static TraceCollector& GetInstance();
+
+  //! Whether the spans should be collected.
+  static bool IsEnable();
+
+  //! The timestamp of now in microseconds relative to the creation of the collector.
+  double NowUs() const;
+
+  void Record(const std::string& name, EventType type, double start_us, double end_us);
+
+  //! The index of the calling thread, the threads are numbered in the order they record the first event.
+  int CurrentThreadIndex();
+
+  std::vector<TraceEvent> Events() const;
+  void Clear();
+
+  //! The events in the Chrome trace-event JSON format.
+  std::string ToJson() const;
+
+  //! Write the JSON to \p path, return false if the file can't be opened.
+  bool Dump(const std::string& path) const;
+
+ private:
+  TraceCollector();
+  ~TraceCollector();
+
+  int64_t start_ns_;
+  mutable std::mutex mtx_;
+  std::vector<TraceEvent> events_;
+  int num_threads_{0};
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/trace.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "cinn/utils/profiler.h"
+
+DECLARE_string(cinn_trace_file);
+
+namespace cinn {
+namespace utils {
+
+TEST(TraceCollector, NestedEvents) {
+  FLAGS_cinn_trace_file = "./trace_test.json";
+  auto& collector       = TraceCollector::GetInstance();
+  collector.Clear();
+  {
+    RecordEvent record_outer("outer", EventType::kCompile);
+    RecordEvent record_inner("inner", EventType::kCodeGen);
+  }
+  auto events = collector.Events();
+  ASSERT_EQ(events.size(), 2UL);
+  // the inner span ends first and is contained by the outer one
+  ASSERT_EQ(events[0].name, "inner");
+  ASSERT_EQ(events[1].name, "outer");
+  ASSERT_EQ(events[0].type, EventType::kCodeGen);
+  ASSERT_EQ(events[0].tid, events[1].tid);
+  ASSERT_GE(events[0].start_us, events[1].start_us);
+  ASSERT_LE(events[0].start_us + events[0].duration_us, events[1].start_us + events[1].duration_us);
+
+  collector.Clear();
+  FLAGS_cinn_trace_file = "";
+}
+
+TEST(TraceCollector, ThreadsAndJson) {
+  FLAGS_cinn_trace_file = "./trace_test.json";
+  auto& collector       = TraceCollector::GetInstance();
+  collector.Clear();
+  int main_tid = collector.CurrentThreadIndex();
+  std::thread worker([]() { RecordEvent record_worker("worker \"span\"", EventType::kInstruction); });
+  worker.join();
+  { RecordEvent record_main("main"); }
+
+  auto events = collector.Events();
+  ASSERT_EQ(events.size(), 2UL);
+  ASSERT_NE(events[0].tid, main_tid);
+  ASSERT_EQ(events[1].tid, main_tid);
+
+  std::string json = collector.ToJson();
+  ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+  ASSERT_NE(json.find("\"thread_name\""), std::string::npos);
+  ASSERT_NE(json.find("worker \\\"span\\\""), std::string::npos);
+  ASSERT_NE(json.find("\"cat\":\"Instruction\""), std::string::npos);
+  ASSERT_TRUE(collector.Dump(FLAGS_cinn_trace_file));
+
+  collector.Clear();
+  FLAGS_cinn_trace_file = "";
+}
+
+TEST(TraceCollector, Disabled) {
+  FLAGS_cinn_trace_file = "";
+  auto& collector       = TraceCollector::GetInstance();
+  collector.Clear();
+  { RecordEvent record_event("ignored"); }
+  ASSERT_TRUE(collector.Events().empty());
+}
+
+}  // namespace utils
+}  // namespace cinn
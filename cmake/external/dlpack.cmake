@@ -0,0 +1,23 @@
+include(ExternalProject)
+
+set(DLPACK_SOURCE_PATH ${THIRD_PARTY_PATH}/install/dlpack)
+
+ExternalProject_Add(
+  external_dlpack
+  ${EXTERNAL_PROJECT_LOG_ARGS}
+  GIT_REPOSITORY "https://github.com/dmlc/dlpack.git"
+  GIT_TAG v0.8
+  PREFIX ${THIRD_PARTY_PATH}/dlpack
+  SOURCE_DIR ${DLPACK_SOURCE_PATH}
+  CONFIGURE_COMMAND ""
+  PATCH_COMMAND ""
+  BUILD_COMMAND ""
+  UPDATE_COMMAND ""
+  INSTALL_COMMAND ""
+)
+
+include_directories(${DLPACK_SOURCE_PATH}/include)
+
+add_library(extern_dlpack INTERFACE)
+add_dependencies(extern_dlpack external_dlpack)
+set(dlpack_deps extern_dlpack)
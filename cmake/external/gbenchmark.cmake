@@ -0,0 +1,61 @@
+# Copyright (c) 2023 CINN Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+IF(WITH_TESTING)
+    INCLUDE(ExternalProject)
+
+    SET(GBENCHMARK_SOURCES_DIR ${THIRD_PARTY_PATH}/gbenchmark)
+    SET(GBENCHMARK_INSTALL_DIR ${THIRD_PARTY_PATH}/install/gbenchmark)
+    SET(GBENCHMARK_INCLUDE_DIR "${GBENCHMARK_INSTALL_DIR}/include" CACHE PATH "google benchmark include directory." FORCE)
+    SET(GBENCHMARK_LIBRARIES "${GBENCHMARK_INSTALL_DIR}/lib/libbenchmark.a" CACHE FILEPATH "google benchmark libraries." FORCE)
+
+    INCLUDE_DIRECTORIES(${GBENCHMARK_INCLUDE_DIR})
+
+    SET(OPTIONAL_ARGS "-DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}"
+        "-DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}"
+        "-DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}"
+        "-DCMAKE_CXX_FLAGS_RELEASE=${CMAKE_CXX_FLAGS_RELEASE}"
+        "-DCMAKE_CXX_FLAGS_DEBUG=${CMAKE_CXX_FLAGS_DEBUG}"
+        "-DCMAKE_C_FLAGS=${CMAKE_C_FLAGS}"
+        "-DCMAKE_C_FLAGS_DEBUG=${CMAKE_C_FLAGS_DEBUG}"
+        "-DCMAKE_C_FLAGS_RELEASE=${CMAKE_C_FLAGS_RELEASE}")
+
+    ExternalProject_Add(
+        extern_gbenchmark
+        ${EXTERNAL_PROJECT_LOG_ARGS}
+        GIT_REPOSITORY  "https://github.com/google/benchmark.git"
+        GIT_TAG         "v1.7.1"
+        PREFIX          ${GBENCHMARK_SOURCES_DIR}
+        UPDATE_COMMAND  ""
+        CMAKE_ARGS      ${OPTIONAL_ARGS}
+                        -DCMAKE_INSTALL_PREFIX=${GBENCHMARK_INSTALL_DIR}
+                        -DCMAKE_INSTALL_LIBDIR=${GBENCHMARK_INSTALL_DIR}/lib
+                        -DCMAKE_POSITION_INDEPENDENT_CODE=ON
+                        -DBENCHMARK_ENABLE_TESTING=OFF
+                        -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+                        -DBENCHMARK_ENABLE_WERROR=OFF
+                        -DCMAKE_BUILD_TYPE=Release
+                        ${EXTERNAL_OPTIONAL_ARGS}
+        CMAKE_CACHE_ARGS -DCMAKE_INSTALL_PREFIX:PATH=${GBENCHMARK_INSTALL_DIR}
+                         -DCMAKE_INSTALL_LIBDIR:PATH=${GBENCHMARK_INSTALL_DIR}/lib
+                         -DCMAKE_POSITION_INDEPENDENT_CODE:BOOL=ON
+                         -DCMAKE_BUILD_TYPE:STRING=Release
+        BUILD_BYPRODUCTS ${GBENCHMARK_LIBRARIES}
+    )
+
+    ADD_LIBRARY(gbenchmark STATIC IMPORTED GLOBAL)
+    SET_PROPERTY(TARGET gbenchmark PROPERTY IMPORTED_LOCATION ${GBENCHMARK_LIBRARIES})
+    ADD_DEPENDENCIES(gbenchmark extern_gbenchmark)
+
+ENDIF()
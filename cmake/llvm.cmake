@@ -28,7 +28,7 @@ message(STATUS "Using LLVMConfig.cmake in: ${LLVM_DIR}")
 cmake -G Ninja ../llvm \
   -DLLVM_ENABLE_PROJECTS=mlir \
   -DLLVM_BUILD_EXAMPLES=OFF \
-  -DLLVM_TARGETS_TO_BUILD="X86" \
+  -DLLVM_TARGETS_TO_BUILD="X86;AArch64" \
   -DCMAKE_BUILD_TYPE=Release \
   -DLLVM_ENABLE_ASSERTIONS=ON \
   -DLLVM_ENABLE_ZLIB=OFF \
@@ -39,7 +39,7 @@ cmake -G Ninja ../llvm \
 add_definitions(${LLVM_DEFINITIONS})
 
 llvm_map_components_to_libnames(llvm_libs Support Core irreader
-        X86 executionengine orcjit mcjit all codegen)
+        native executionengine orcjit mcjit all codegen)
 
 message(STATUS "LLVM libs: ${llvm_libs}")
 
@@ -16,3 +16,13 @@ mark_as_advanced(CUDA_NVRTC_LIB)
 if(NOT LIBNVRTC_FOUND)
   message(FATAL_ERROR "Cuda NVRTC Library not found: Specify the LIBNVRTC_LIBRARY_DIR where libnvrtc is located")
 endif()
+
+# nvJitLink links the generated kernels with the precompiled CUDA runtime device library, which is shipped since CUDA 12.0
+find_library(CUDA_NVJITLINK_LIB libnvJitLink nvJitLink HINTS "${CUDA_TOOLKIT_ROOT_DIR}/lib64" "${LIBNVRTC_LIBRARY_DIR}" "${CUDA_TOOLKIT_ROOT_DIR}/lib/x64" /usr/lib64 /usr/local/cuda/lib64)
+mark_as_advanced(CUDA_NVJITLINK_LIB)
+
+if(CUDA_NVJITLINK_LIB)
+  message(STATUS "found nvJitLink: ${CUDA_NVJITLINK_LIB}")
+  add_definitions(-DCINN_WITH_NVJITLINK)
+  list(APPEND CUDA_NVRTC_LIB ${CUDA_NVJITLINK_LIB})
+endif()
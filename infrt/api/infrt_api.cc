@@ -6,6 +6,11 @@
 #include <mlir/Dialect/StandardOps/IR/Ops.h>
 #include <mlir/Parser.h>
 
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "infrt/common/global.h"
@@ -156,21 +161,69 @@ std::shared_ptr<CinnRtPredictor> CreateCinnRtPredictor(const CinnRtConfig& confi
   return x;
 }
 
-struct CinnRtPredictor::Impl {
+/**
+ * The program loaded for a predictor, which is shared by the predictors loading the same model if the program cache is
+ * used.
+ */
+struct LoadedProgram {
+  // declared before the executor, which refers to the functions of the module
   mlir::OwningModuleRef module_ref;
+  std::unique_ptr<KernelRegistry> registry;
   std::unique_ptr<PredictExecutor> executor;
 };
 
-CinnRtPredictor::CinnRtPredictor() : impl_(new Impl) {}
-CinnRtPredictor::~CinnRtPredictor() {}
+/**
+ * The cache of the loaded programs, keyed by the hash of the MLIR content, the model dir and the shared libraries.
+ */
+class ProgramCache {
+ public:
+  static ProgramCache& Global() {
+    static ProgramCache x;
+    return x;
+  }
 
-void CinnRtPredictor::Run() { impl_->executor->Run(); }
+  std::shared_ptr<LoadedProgram> Find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = programs_.find(key);
+    return it == programs_.end() ? nullptr : it->second;
+  }
 
-int CinnRtPredictor::Init(const CinnRtConfig& config) {
+  void Insert(const std::string& key, const std::shared_ptr<LoadedProgram>& program) {
+    std::lock_guard<std::mutex> lock(mu_);
+    programs_.emplace(key, program);
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return programs_.size();
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mu_);
+    programs_.clear();
+  }
+
+ private:
+  std::mutex mu_;
+  absl::flat_hash_map<std::string, std::shared_ptr<LoadedProgram>> programs_;
+};
+
+static std::string ProgramCacheKey(const CinnRtConfig& config, const std::string& mlir_source) {
+  std::string key = std::to_string(std::hash<std::string>()(mlir_source)) + ":" +
+                    std::to_string(mlir_source.size()) + ":" + config.model_dir();
+  for (auto& lib_path : config.shared_libs()) {
+    key += ":" + lib_path;
+  }
+  return key;
+}
+
+static std::shared_ptr<LoadedProgram> LoadProgram(const CinnRtConfig& config, const std::string& mlir_source) {
+  auto program               = std::make_shared<LoadedProgram>();
   mlir::MLIRContext* context = infrt::Global::getMLIRContext();
-  auto module_ref            = dialect::LoadMlirFile(config.mlir_path(), context);
+  program->module_ref        = dialect::LoadMlirSource(context, mlir_source);
 
-  KernelRegistry* registry = new KernelRegistry();
+  program->registry.reset(new KernelRegistry());
+  KernelRegistry* registry = program->registry.get();
 
   kernel::RegisterBasicKernels(registry);
   kernel::RegisterTestKernels(registry);
@@ -178,15 +231,13 @@ int CinnRtPredictor::Init(const CinnRtConfig& config) {
   kernel::RegisterTensorKernels(registry);
   kernel::RegisterControlFlowKernels(registry);
 
-  impl_->module_ref = std::move(module_ref);
-
   // load extra shared library
   for (const std::string& lib_path : config.shared_libs()) {
     std::string err;
     llvm::sys::DynamicLibrary dynLib = llvm::sys::DynamicLibrary::getPermanentLibrary(lib_path.c_str(), &err);
     if (!dynLib.isValid()) {
       llvm::errs() << "Load shared library failed. Error: " << err << "\n";
-      return 1;
+      return nullptr;
     }
     if (auto reg_sym = dynLib.SearchForAddressOfSymbol("RegisterKernels")) {
       auto reg_func = reinterpret_cast<void (*)(KernelRegistry*)>(reg_sym);
@@ -200,16 +251,55 @@ int CinnRtPredictor::Init(const CinnRtConfig& config) {
   TensorMap* tensor_map = LoadParams(config.model_dir());
 
   // Create PredictExecutor
-  impl_->executor.reset(new PredictExecutor(impl_->module_ref.get(), registry, tensor_map));
+  program->executor.reset(new PredictExecutor(program->module_ref.get(), registry, tensor_map));
+  return program;
+}
+
+struct CinnRtPredictor::Impl {
+  std::shared_ptr<LoadedProgram> program;
+};
+
+CinnRtPredictor::CinnRtPredictor() : impl_(new Impl) {}
+CinnRtPredictor::~CinnRtPredictor() {}
+
+void CinnRtPredictor::Run() { impl_->program->executor->Run(); }
+
+int CinnRtPredictor::Init(const CinnRtConfig& config) {
+  std::ifstream file(config.mlir_path());
+  if (!file) {
+    llvm::errs() << "Read mlir file failed: " << config.mlir_path() << "\n";
+    return 1;
+  }
+  std::string mlir_source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  std::string key;
+  if (config.use_program_cache()) {
+    key            = ProgramCacheKey(config, mlir_source);
+    impl_->program = ProgramCache::Global().Find(key);
+    if (impl_->program) {
+      VLOG(3) << "Reuse the cached program of " << config.mlir_path();
+      return 0;
+    }
+  }
+
+  impl_->program = LoadProgram(config, mlir_source);
+  if (!impl_->program) return 1;
+  if (config.use_program_cache()) {
+    ProgramCache::Global().Insert(key, impl_->program);
+  }
   return 0;
 }
 
-int CinnRtPredictor::GetInputNum() { return impl_->executor->GetInputNum(); }
+size_t GetCinnRtProgramCacheSize() { return ProgramCache::Global().size(); }
+
+void ClearCinnRtProgramCache() { ProgramCache::Global().Clear(); }
+
+int CinnRtPredictor::GetInputNum() { return impl_->program->executor->GetInputNum(); }
 
-DenseHostTensor* CinnRtPredictor::GetInput(int i) { return impl_->executor->GetInput(i); }
+DenseHostTensor* CinnRtPredictor::GetInput(int i) { return impl_->program->executor->GetInput(i); }
 
-int CinnRtPredictor::GetOutputNum() { return impl_->executor->GetOutputNum(); }
+int CinnRtPredictor::GetOutputNum() { return impl_->program->executor->GetOutputNum(); }
 
-DenseHostTensor* CinnRtPredictor::GetOutput(int i) { return impl_->executor->GetOutput(i); }
+DenseHostTensor* CinnRtPredictor::GetOutput(int i) { return impl_->program->executor->GetOutput(i); }
 
 }  // namespace infrt
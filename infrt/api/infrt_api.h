@@ -10,6 +10,7 @@ class CinnRtConfig {
   std::string model_dir_;
   std::string mlir_path_;
   std::vector<std::string> shared_libs_;
+  bool use_program_cache_{false};
 
  public:
   CinnRtConfig() = default;
@@ -22,6 +23,14 @@ class CinnRtConfig {
   void set_shared_libs(const std::vector<std::string>& shared_libs) { shared_libs_ = shared_libs; };
   const std::vector<std::string>& shared_libs() const { return shared_libs_; }
 
+  /**
+   * Share the program loaded by the predictors with the same MLIR content, model dir and shared libraries, so that the
+   * repeated loads skip parsing, translating and loading the params. NOTE the predictors sharing a program share the
+   * input and output tensors too, so they should not run concurrently.
+   */
+  void set_use_program_cache(bool use_program_cache) { use_program_cache_ = use_program_cache; }
+  bool use_program_cache() const { return use_program_cache_; }
+
   virtual ~CinnRtConfig() = default;
 };
 
@@ -43,4 +52,9 @@ class CinnRtPredictor {
 
 std::shared_ptr<CinnRtPredictor> CreateCinnRtPredictor(const CinnRtConfig& config);
 
+//! Get the number of the programs in the cache used by CinnRtConfig::set_use_program_cache.
+size_t GetCinnRtProgramCacheSize();
+//! Drop the programs in the cache, the ones used by the predictors alive are released with the predictors.
+void ClearCinnRtProgramCache();
+
 }  // namespace infrt
@@ -53,4 +53,24 @@ TEST(CinnRtPredictor, predictor) {
   }
 }
 
+TEST(CinnRtPredictor, program_cache) {
+  CinnRtConfig config;
+  config.set_shared_libs({"../../paddle/libexternal_kernels.so"});
+  config.set_model_dir("../../paddle/paddle_1.8_fc_model");
+  config.set_mlir_path("../../../infrt/dialect/mlir_tests/tensor_map.mlir");
+  config.set_use_program_cache(true);
+  ClearCinnRtProgramCache();
+
+  auto predictor0 = CreateCinnRtPredictor(config);
+  auto predictor1 = CreateCinnRtPredictor(config);
+  ASSERT_EQ(GetCinnRtProgramCacheSize(), 1UL);
+  // the second load reuses the program, including the inputs
+  ASSERT_EQ(predictor0->GetInput(0), predictor1->GetInput(0));
+
+  config.set_use_program_cache(false);
+  auto predictor2 = CreateCinnRtPredictor(config);
+  ASSERT_NE(predictor0->GetInput(0), predictor2->GetInput(0));
+  ClearCinnRtProgramCache();
+}
+
 }  // namespace infrt
@@ -3,6 +3,7 @@
 #include <glog/logging.h>
 
 #include <memory>
+#include <utility>
 
 #include "infrt/common/macros.h"
 #include "infrt/common/memory.h"
@@ -201,6 +202,7 @@ extern struct cinn_device_interface_t* cinn_x86_device_interface();
 struct Buffer final {
   Buffer() = default;
   explicit Buffer(const infrt::common::Target& target) { SetTarget(target); }
+  ~Buffer() { Free(); }
 
   //! Resize the memory hold by this buffer *exactlly* to \p size.
   void Resize(uint32_t size);
@@ -223,10 +225,27 @@ struct Buffer final {
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
+  /**
+   * Share the external \p memory of \p size bytes instead of the memory owned, which is kept alive by \p holder, such
+   * as a file mapped, and never freed by this buffer.
+   */
+  void ShareExternal(void* memory, uint32_t size, std::shared_ptr<void> holder) {
+    Free();
+    data_.memory     = reinterpret_cast<uint8_t*>(memory);
+    size_            = size;
+    external_holder_ = std::move(holder);
+  }
+
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
-    memory_mng_cache_->free(data_.memory);
+    if (external_holder_) {
+      external_holder_.reset();
+    } else {
+      memory_mng_cache_->free(data_.memory);
+    }
+    data_.memory = nullptr;
+    size_        = 0;
   }
 
  private:
@@ -251,6 +270,11 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Keep the external memory shared alive.
+  std::shared_ptr<void> external_holder_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(Buffer);
 };
 
 }  // namespace infrt
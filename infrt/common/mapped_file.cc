@@ -0,0 +1,34 @@
+#include "infrt/common/mapped_file.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infrt {
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VLOG(3) << "Failed to open " << path;
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // the mapping is kept after closing the file
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    VLOG(3) << "Failed to map " << path;
+    return nullptr;
+  }
+  return std::shared_ptr<MappedFile>(new MappedFile(static_cast<char*>(data), st.st_size));
+}
+
+MappedFile::~MappedFile() { ::munmap(data_, size_); }
+
+}  // namespace infrt
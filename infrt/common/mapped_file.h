@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "infrt/common/macros.h"
+
+namespace infrt {
+
+/**
+ * MappedFile maps a whole file into memory, so that the data can be viewed without copying, and the processes or the
+ * models mapping the same file share the pages in the page cache.
+ *
+ * The mapping is private and writable: the pages are shared until written, then the written pages are copied to the
+ * process, and the file is never changed.
+ */
+class MappedFile {
+ public:
+  //! Map the file at \p path, nullptr if it fails to open or map the file.
+  static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+  ~MappedFile();
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(char* data, size_t size) : data_(data), size_(size) {}
+
+  char* data_{};
+  size_t size_{};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+}  // namespace infrt
@@ -1,23 +1,146 @@
 #include "infrt/common/memory.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
 namespace infrt {
 
 using infrt::common::Target;
 
 namespace {
 
+// The header placed in the kAlignment bytes before the memory returned, to find the block on freeing.
+struct BlockHeader {
+  void* base;
+  int size_class;
+};
+
+inline size_t SizeOfClass(int size_class) { return HostMemoryPool::kAlignment << size_class; }
+
+inline void* DataOfBlock(void* block) { return static_cast<char*>(block) + HostMemoryPool::kAlignment; }
+
+inline BlockHeader* HeaderOfData(void* data) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(data) - HostMemoryPool::kAlignment);
+}
+
 class X86MemoryMng : public MemoryInterface {
  public:
-  void* malloc(size_t nbytes) override { return ::malloc(nbytes); }
+  void* malloc(size_t nbytes) override { return HostMemoryPool::Global().Allocate(nbytes); }
   void free(void* data) override {
     if (!data) return;
-    ::free(data);
+    HostMemoryPool::Global().Free(data);
+  }
+  void* aligned_alloc(size_t alignment, size_t nbytes) override {
+    return HostMemoryPool::Global().Allocate(nbytes, alignment);
   }
-  void* aligned_alloc(size_t alignment, size_t nbytes) override { return ::aligned_alloc(alignment, nbytes); }
 };
 
 }  // namespace
 
+struct HostMemoryThreadCache {
+  std::vector<void*> blocks[HostMemoryPool::kNumSizeClasses];
+
+  ~HostMemoryThreadCache() {
+    for (int size_class = 0; size_class < HostMemoryPool::kNumSizeClasses; size_class++) {
+      for (void* block : blocks[size_class]) {
+        HostMemoryPool::Global().ReleaseBlock(size_class, block);
+      }
+    }
+  }
+};
+
+namespace {
+thread_local HostMemoryThreadCache thread_cache;
+}  // namespace
+
+HostMemoryPool& HostMemoryPool::Global() {
+  // never destroyed, so that the thread caches can be released on exiting
+  static auto* x = new HostMemoryPool;
+  return *x;
+}
+
+int HostMemoryPool::SizeClassOf(size_t nbytes) {
+  for (int size_class = 0; size_class < kNumSizeClasses; size_class++) {
+    if (nbytes <= SizeOfClass(size_class)) return size_class;
+  }
+  return -1;
+}
+
+void* HostMemoryPool::Allocate(size_t nbytes, size_t alignment) {
+  CHECK_EQ(alignment & (alignment - 1), 0UL) << "The alignment " << alignment << " is not a power of two";
+  int size_class = SizeClassOf(nbytes);
+  if (size_class >= 0 && alignment <= kAlignment) {
+    auto& cached = thread_cache.blocks[size_class];
+    void* block  = nullptr;
+    if (!cached.empty()) {
+      block = cached.back();
+      cached.pop_back();
+    } else {
+      block = AllocateBlock(size_class);
+    }
+    return DataOfBlock(block);
+  }
+
+  // too large or over aligned, allocated from the system directly
+  alignment  = std::max(alignment, kAlignment);
+  void* base = ::malloc(nbytes + alignment + kAlignment);
+  CHECK(base) << "Failed to allocate " << nbytes << " bytes on host";
+  ++num_system_allocs_;
+  auto address = reinterpret_cast<uintptr_t>(base) + kAlignment;
+  void* data   = reinterpret_cast<void*>((address + alignment - 1) & ~(alignment - 1));
+
+  *HeaderOfData(data) = BlockHeader{base, -1};
+  return data;
+}
+
+void HostMemoryPool::Free(void* data) {
+  if (!data) return;
+  auto* header = HeaderOfData(data);
+  if (header->size_class < 0) {
+    ::free(header->base);
+    return;
+  }
+  auto& cached = thread_cache.blocks[header->size_class];
+  if (cached.size() < kMaxThreadCachedBlocks) {
+    cached.push_back(header->base);
+  } else {
+    ReleaseBlock(header->size_class, header->base);
+  }
+}
+
+void* HostMemoryPool::AllocateBlock(int size_class) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto& blocks = free_blocks_[size_class];
+    if (!blocks.empty()) {
+      void* block = blocks.back();
+      blocks.pop_back();
+      return block;
+    }
+  }
+  void* block = ::aligned_alloc(kAlignment, SizeOfClass(size_class) + kAlignment);
+  CHECK(block) << "Failed to allocate " << SizeOfClass(size_class) << " bytes on host";
+  ++num_system_allocs_;
+  *static_cast<BlockHeader*>(block) = BlockHeader{block, size_class};
+  return block;
+}
+
+void HostMemoryPool::ReleaseBlock(int size_class, void* block) {
+  std::lock_guard<std::mutex> lock(mu_);
+  free_blocks_[size_class].push_back(block);
+}
+
+void HostMemoryPool::Trim() {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (auto& blocks : free_blocks_) {
+    for (void* block : blocks) {
+      ::free(block);
+    }
+    blocks.clear();
+  }
+}
+
 MemoryManager::MemoryManager() {
   Register(Target::Arch::Unk, new X86MemoryMng);
   Register(Target::Arch::X86, new X86MemoryMng);
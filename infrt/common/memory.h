@@ -3,7 +3,10 @@
 #include <absl/container/flat_hash_map.h>
 #include <glog/logging.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "infrt/common/macros.h"
 #include "infrt/common/target.h"
@@ -18,6 +21,50 @@ class MemoryInterface {
   virtual ~MemoryInterface() {}
 };
 
+/**
+ * HostMemoryPool caches the host memory freed for reuse, so that the tensors created by running a program repeatedly
+ * take no allocation from the system.
+ *
+ * The sizes are rounded up to the size classes of powers of two from 64 bytes to 64 MB, and the memory is 64-byte
+ * aligned for SIMD. The blocks freed are cached by the thread freeing them first, up to kMaxThreadCachedBlocks for each
+ * size class, and then by the pool shared by all the threads. The larger sizes are allocated from the system directly.
+ */
+class HostMemoryPool {
+ public:
+  static constexpr size_t kAlignment             = 64;
+  static constexpr int kNumSizeClasses           = 21;
+  static constexpr size_t kMaxThreadCachedBlocks = 8;
+
+  static HostMemoryPool& Global();
+
+  //! Allocate \p nbytes aligned to \p alignment, which is kAlignment at least.
+  void* Allocate(size_t nbytes, size_t alignment = kAlignment);
+  void Free(void* data);
+
+  //! Return the blocks cached by the shared pool to the system.
+  void Trim();
+
+  //! The number of blocks allocated from the system, which don't grow on reusing the memory.
+  size_t num_system_allocs() const { return num_system_allocs_; }
+
+  //! Get the size class of \p nbytes, -1 if it is too large to be cached.
+  static int SizeClassOf(size_t nbytes);
+
+ private:
+  friend struct HostMemoryThreadCache;
+
+  HostMemoryPool() = default;
+
+  void* AllocateBlock(int size_class);
+  void ReleaseBlock(int size_class, void* block);
+
+  std::mutex mu_;
+  std::vector<void*> free_blocks_[kNumSizeClasses];
+  std::atomic<size_t> num_system_allocs_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(HostMemoryPool);
+};
+
 /**
  * MemoryManager holds a map of MemoryInterface for each articture.
  */
@@ -0,0 +1,136 @@
+#include "infrt/host_context/async_executor.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <set>
+#include <utility>
+
+#include "infrt/host_context/kernel_frame.h"
+#include "infrt/host_context/mlir_function_executable.h"
+#include "infrt/host_context/op_executable.h"
+
+namespace infrt::host_context {
+
+struct AsyncExecutor::ExecutionState {
+  WorkStealingThreadPool* pool{};
+  std::unique_ptr<std::atomic<int>[]> num_pending;
+  std::atomic<int> num_remaining{};
+  std::shared_ptr<AsyncValue> done;
+};
+
+namespace {
+
+bool HasSideEffect(OpExecutable* op) {
+  auto& frame = op->frame();
+  if (frame.GetNumResults() == 0) return true;
+  for (int i = 0; i < frame.GetNumAttributes(); i++) {
+    if (frame.GetAttributeAt(i)->holds<MlirFunctionExecutable*>()) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+AsyncExecutor::AsyncExecutor(std::vector<OpExecutable*> ops) : ops_(std::move(ops)), nodes_(ops_.size()) {
+  std::vector<std::set<int>> predecessors(ops_.size());
+  auto add_dependency = [&](int from, int to) {
+    if (from >= 0 && from != to) predecessors[to].insert(from);
+  };
+
+  // the last op writing each value, and the ops reading it since then
+  absl::flat_hash_map<Value*, int> last_writer;
+  absl::flat_hash_map<Value*, std::vector<int>> readers;
+  int last_side_effect = -1;
+  for (int op_id = 0; op_id < ops_.size(); op_id++) {
+    auto& frame      = ops_[op_id]->frame();
+    bool side_effect = HasSideEffect(ops_[op_id]);
+
+    std::vector<Value*> writes(frame.GetResults().begin(), frame.GetResults().end());
+    if (frame.GetNumResults() == 0) {
+      writes.assign(frame.GetArguments().begin(), frame.GetArguments().end());
+    }
+    for (Value* value : frame.GetArguments()) {
+      auto it = last_writer.find(value);
+      add_dependency(it == last_writer.end() ? -1 : it->second, op_id);
+    }
+    for (Value* value : writes) {
+      auto it = last_writer.find(value);
+      add_dependency(it == last_writer.end() ? -1 : it->second, op_id);
+      for (int reader : readers[value]) {
+        add_dependency(reader, op_id);
+      }
+    }
+    if (side_effect) {
+      add_dependency(last_side_effect, op_id);
+      last_side_effect = op_id;
+    }
+
+    for (Value* value : frame.GetArguments()) {
+      readers[value].push_back(op_id);
+    }
+    for (Value* value : writes) {
+      last_writer[value] = op_id;
+      readers[value].clear();
+    }
+  }
+
+  for (int op_id = 0; op_id < ops_.size(); op_id++) {
+    nodes_[op_id].num_predecessors = predecessors[op_id].size();
+    for (int from : predecessors[op_id]) {
+      nodes_[from].successors.push_back(op_id);
+    }
+    if (predecessors[op_id].empty()) {
+      roots_.push_back(op_id);
+    }
+  }
+  VLOG(3) << "Built an AsyncExecutor of " << ops_.size() << " ops with " << roots_.size() << " roots";
+}
+
+std::shared_ptr<AsyncValue> AsyncExecutor::Execute(WorkStealingThreadPool* pool) const {
+  CHECK(pool);
+  auto state  = std::make_shared<ExecutionState>();
+  state->pool = pool;
+  state->done = std::make_shared<AsyncValue>();
+  if (ops_.empty()) {
+    state->done->SetAvailable();
+    return state->done;
+  }
+
+  state->num_pending.reset(new std::atomic<int>[ops_.size()]);
+  for (int op_id = 0; op_id < ops_.size(); op_id++) {
+    state->num_pending[op_id] = nodes_[op_id].num_predecessors;
+  }
+  state->num_remaining = ops_.size();
+
+  auto done = state->done;
+  for (int op_id : roots_) {
+    pool->Schedule([this, op_id, state] { RunOp(op_id, state); });
+  }
+  return done;
+}
+
+void AsyncExecutor::RunOp(int op_id, const std::shared_ptr<ExecutionState>& state) const {
+  // run one of the ready successors on the same thread, and schedule the others
+  while (op_id >= 0) {
+    VLOG(3) << "running op " << op_id << " " << ops_[op_id]->name();
+    ops_[op_id]->Execute();
+
+    int next_op_id = -1;
+    for (int successor : nodes_[op_id].successors) {
+      if (--state->num_pending[successor] > 0) continue;
+      if (next_op_id < 0) {
+        next_op_id = successor;
+      } else {
+        state->pool->Schedule([this, successor, state] { RunOp(successor, state); });
+      }
+    }
+    if (--state->num_remaining == 0) {
+      state->done->SetAvailable();
+    }
+    op_id = next_op_id;
+  }
+}
+
+}  // namespace infrt::host_context
@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "infrt/host_context/async_value.h"
+#include "infrt/host_context/thread_pool.h"
+
+namespace infrt::host_context {
+
+class OpExecutable;
+
+/**
+ * AsyncExecutor runs a sequence of ops as a dataflow graph, the ops independent of each other run concurrently in a
+ * thread pool.
+ *
+ * The dependencies are analyzed once on creating by the Values in the frames: an op depends on the last op writing
+ * its arguments, and on the ops reading or writing its results since the last write. An op without results, such as
+ * the print kernels and the kernels filling their arguments in place, is taken as writing its arguments, and the ops
+ * with side effects, which have no results or call an MlirFunctionExecutable, run in the program order. On executing,
+ * each op counts its unfinished predecessors, and is scheduled once the count reaches zero.
+ *
+ * NOTE the Values aliasing the same data, such as the tensors sharing a buffer, are not tracked.
+ */
+class AsyncExecutor {
+ public:
+  explicit AsyncExecutor(std::vector<OpExecutable*> ops);
+
+  /**
+   * Execute all the ops in \p pool, and return a value available once all of them are finished. Only one execution
+   * should be in flight at a time, since the ops share the Values.
+   */
+  std::shared_ptr<AsyncValue> Execute(WorkStealingThreadPool* pool) const;
+
+  //! Get the indices of the ops depending on the \p op_id-th op directly.
+  const std::vector<int>& successors(int op_id) const { return nodes_[op_id].successors; }
+
+ private:
+  struct Node {
+    std::vector<int> successors;
+    int num_predecessors{};
+  };
+  struct ExecutionState;
+
+  void RunOp(int op_id, const std::shared_ptr<ExecutionState>& state) const;
+
+  std::vector<OpExecutable*> ops_;
+  std::vector<Node> nodes_;
+  // the ops without predecessors
+  std::vector<int> roots_;
+};
+
+}  // namespace infrt::host_context
@@ -0,0 +1,113 @@
+#include "infrt/host_context/async_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "infrt/host_context/core_runtime.h"
+#include "infrt/host_context/kernel_registry.h"
+#include "infrt/host_context/kernel_utils.h"
+#include "infrt/host_context/op_executable.h"
+#include "infrt/host_context/symbol_table.h"
+
+namespace infrt {
+namespace host_context {
+
+int add(int a, int b) { return a + b; }
+int sub(int a, int b) { return a - b; }
+
+std::atomic<int> num_arrived{0};
+// Wait for another kernel to arrive, which returns -1 if they are not run concurrently.
+int rendezvous(int a) {
+  ++num_arrived;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (num_arrived < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  return num_arrived >= 2 ? a : -1;
+}
+
+TEST(AsyncExecutor, diamond) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.subi32", CINN_KERNEL(sub));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  // c = a + b, d = c + a, e = c - b, f = d - e
+  auto add_op = [&](const char* op_name, const char* x, const char* y, std::string out) {
+    auto* op = builder.NewOpExecutable(op_name);
+    op->AppendArgument(x);
+    op->AppendArgument(y);
+    op->SetResults({out});
+  };
+  add_op("cinn.test.addi32", "a", "b", "c");
+  add_op("cinn.test.addi32", "c", "a", "d");
+  add_op("cinn.test.subi32", "c", "b", "e");
+  add_op("cinn.test.subi32", "d", "e", "f");
+
+  WorkStealingThreadPool pool(4);
+  for (int i = 0; i < 10; i++) {
+    builder.ExecuteAsync(&pool)->Await();
+    ASSERT_EQ(table->GetValue("f")->get<int>(), 3);
+  }
+}
+
+TEST(AsyncExecutor, dependencies) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  std::vector<OpExecutable*> ops;
+  auto add_op = [&](const char* x, const char* y, std::string out) {
+    auto* op = builder.NewOpExecutable("cinn.test.addi32");
+    op->AppendArgument(x);
+    op->AppendArgument(y);
+    op->SetResults({out});
+    ops.push_back(op);
+  };
+  add_op("a", "b", "c");  // 0
+  add_op("a", "a", "d");  // 1
+  add_op("c", "d", "e");  // 2, reads the results of 0 and 1
+  add_op("b", "b", "c");  // 3, writes c after 2 reads it
+
+  AsyncExecutor executor(ops);
+  ASSERT_EQ(executor.successors(0), std::vector<int>({2, 3}));
+  ASSERT_EQ(executor.successors(1), std::vector<int>({2}));
+  ASSERT_EQ(executor.successors(2), std::vector<int>({3}));
+  ASSERT_TRUE(executor.successors(3).empty());
+}
+
+TEST(AsyncExecutor, concurrent) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.rendezvous", CINN_KERNEL(rendezvous));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+  for (auto* name : {"a", "b"}) {
+    auto* op = builder.NewOpExecutable("cinn.test.rendezvous");
+    op->AppendArgument(name);
+    op->SetResults({std::string(name) + "_out"});
+  }
+
+  WorkStealingThreadPool::InitGlobal(2);
+  builder.Execute();
+  WorkStealingThreadPool::InitGlobal(0);
+
+  ASSERT_EQ(table->GetValue("a_out")->get<int>(), 1);
+  ASSERT_EQ(table->GetValue("b_out")->get<int>(), 2);
+}
+
+}  // namespace host_context
+}  // namespace infrt
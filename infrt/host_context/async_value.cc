@@ -0,0 +1,44 @@
+#include "infrt/host_context/async_value.h"
+
+#include <glog/logging.h>
+
+#include <utility>
+
+namespace infrt::host_context {
+
+bool AsyncValue::IsAvailable() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return available_;
+}
+
+void AsyncValue::SetAvailable() {
+  std::vector<std::function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    CHECK(!available_) << "The AsyncValue is set available twice";
+    available_ = true;
+    waiters.swap(waiters_);
+  }
+  cv_.notify_all();
+  for (auto& waiter : waiters) {
+    waiter();
+  }
+}
+
+void AsyncValue::AndThen(std::function<void()> waiter) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!available_) {
+      waiters_.push_back(std::move(waiter));
+      return;
+    }
+  }
+  waiter();
+}
+
+void AsyncValue::Await() const {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this] { return available_; });
+}
+
+}  // namespace infrt::host_context
@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace infrt::host_context {
+
+/**
+ * AsyncValue is a future of some work running in the background, such as an asynchronous execution of a CoreRuntime.
+ * It is unavailable on creating, and becomes available once the work is done, then all the waiters registered by
+ * AndThen are called on the thread which makes it available.
+ */
+class AsyncValue {
+ public:
+  bool IsAvailable() const;
+
+  //! Mark the value available and run the waiters, should be called only once.
+  void SetAvailable();
+
+  //! Run \p waiter once the value is available, immediately on the calling thread if it is available already.
+  void AndThen(std::function<void()> waiter);
+
+  //! Block the calling thread until the value is available.
+  void Await() const;
+
+ private:
+  mutable std::mutex mu_;
+  mutable std::condition_variable cv_;
+  bool available_{};
+  std::vector<std::function<void()>> waiters_;
+};
+
+}  // namespace infrt::host_context
@@ -3,8 +3,10 @@
 #include <absl/container/flat_hash_map.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "infrt/host_context/async_executor.h"
 #include "infrt/host_context/kernel_registry.h"
 #include "infrt/host_context/op_executable.h"
 #include "infrt/host_context/symbol_table.h"
@@ -14,7 +16,10 @@ namespace infrt::host_context {
 struct CoreRuntime::Impl {
   KernelRegistry* kernel_registry{};
   SymbolTable symbol_table;
+  ValueArena value_arena;
   std::vector<OpExecutableBuilder> op_executables;
+  //! Built in the first asynchronous execution.
+  std::unique_ptr<AsyncExecutor> async_executor;
 
   mutable std::vector<ValueRef> results;
 };
@@ -24,7 +29,12 @@ SymbolTable* CoreRuntime::symbol_table() { return &impl_->symbol_table; }
 CoreRuntime::CoreRuntime(CoreRuntime::Impl* impl) : impl_(impl) { CHECK(impl); }
 
 void CoreRuntime::Execute() {
-  // std::cout << "CoreRuntime::Execute" << std::endl;
+  auto* pool = WorkStealingThreadPool::Global();
+  if (pool && !pool->IsWorkerThread() && impl_->op_executables.size() > 1) {
+    ExecuteAsync(pool)->Await();
+    return;
+  }
+
   int op_offset = 0;
   for (auto& op : impl_->op_executables) {
     VLOG(3) << "running op " << op_offset++ << " " << op.name();
@@ -32,6 +42,17 @@ void CoreRuntime::Execute() {
   }
 }
 
+std::shared_ptr<AsyncValue> CoreRuntime::ExecuteAsync(WorkStealingThreadPool* pool) {
+  if (!impl_->async_executor) {
+    std::vector<OpExecutable*> ops;
+    for (auto& op : impl_->op_executables) {
+      ops.push_back(&op);
+    }
+    impl_->async_executor.reset(new AsyncExecutor(std::move(ops)));
+  }
+  return impl_->async_executor->Execute(pool);
+}
+
 KernelRegistry* CoreRuntime::kernel_registry() const { return impl_->kernel_registry; }
 
 size_t CoreRuntime::num_ops() const { return impl_->op_executables.size(); }
@@ -42,6 +63,7 @@ CoreRuntimeBuilder::CoreRuntimeBuilder(KernelRegistry* kernel_registry) : CoreRu
 
 OpExecutableBuilder* CoreRuntimeBuilder::NewOpExecutable(absl::string_view op_name) {
   CHECK(impl_.get());
+  CHECK(!impl_->async_executor) << "Can't add ops after the asynchronous execution";
   impl_->op_executables.emplace_back(op_name, symbol_table(), impl_->kernel_registry);
   return &impl_->op_executables.back();
 }
@@ -52,6 +74,8 @@ void CoreRuntimeBuilder::FeedInArgs(llvm::ArrayRef<std::pair<std::string, ValueR
   }
 }
 
+ValueArena* CoreRuntimeBuilder::value_arena() { return &impl_->value_arena; }
+
 void CoreRuntimeBuilder::SetKernelRegistry(KernelRegistry* x) {
   CHECK(x);
   impl_->kernel_registry = x;
@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 
+#include "infrt/host_context/async_value.h"
 #include "infrt/host_context/value.h"
 
 namespace infrt::host_context {
@@ -14,6 +15,7 @@ class KernelRegistry;
 class OpExecutable;
 class OpExecutableBuilder;
 class SymbolTable;
+class WorkStealingThreadPool;
 
 /**
  * CoreRuntime encapsulate the execution for a sequence of ops.
@@ -22,9 +24,19 @@ class SymbolTable;
  */
 class CoreRuntime : public std::enable_shared_from_this<CoreRuntime> {
  public:
-  //! Execute a program.
+  /**
+   * Execute a program. The ops run concurrently in the global WorkStealingThreadPool if it is created, otherwise in
+   * order on the calling thread. The nested executions, such as the function calls inside a kernel running in the
+   * pool, run in order.
+   */
   void Execute();
 
+  /**
+   * Execute a program as a dataflow graph in \p pool, and return a value available once all the ops are finished.
+   * The dependencies of the ops are analyzed in the first execution, so the program should not be changed after that.
+   */
+  std::shared_ptr<AsyncValue> ExecuteAsync(WorkStealingThreadPool* pool);
+
   //! Return the number of ops.
   size_t num_ops() const;
 
@@ -63,6 +75,9 @@ class CoreRuntimeBuilder : public CoreRuntime {
 
   llvm::ArrayRef<absl::string_view> attr_names() const;
 
+  //! The arena of the Values owned by the program, such as the attributes.
+  ValueArena* value_arena();
+
   OpExecutableBuilder* NewOpExecutable(absl::string_view op_name);
 };
 
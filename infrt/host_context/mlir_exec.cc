@@ -8,6 +8,7 @@
 #include "infrt/host_context/core_runtime.h"
 #include "infrt/host_context/kernel_registry.h"
 #include "infrt/host_context/mlir_to_runtime_translate.h"
+#include "infrt/host_context/thread_pool.h"
 #include "infrt/kernel/basic_kernels.h"
 #include "infrt/kernel/control_flow_kernels.h"
 #include "infrt/kernel/tensor_kernels.h"
@@ -25,7 +26,12 @@ int main(int argc, char** argv) {
   using namespace llvm;   // NOLINT
   using namespace infrt;  // NOLINT
   cl::opt<std::string> input_file("i", cl::desc("Specify input filename"), cl::value_desc("input file name"));
+  cl::opt<int> num_threads("num_threads",
+                           cl::desc("Specify the number of threads to run the independent kernels concurrently, "
+                                    "the kernels run in order if not positive"),
+                           cl::init(0));
   cl::ParseCommandLineOptions(argc, argv);
+  host_context::WorkStealingThreadPool::InitGlobal(num_threads);
 
   mlir::MLIRContext* context = infrt::Global::getMLIRContext();
   auto module                = dialect::LoadMlirFile(input_file.c_str(), context);
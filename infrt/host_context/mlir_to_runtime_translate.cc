@@ -237,31 +237,32 @@ bool MlirToRuntimeTranslator::EmitGeneralOp(mlir::Operation* op) {
   }
 #endif
 
-  // process attributes
-  auto attrs = op->getAttrs();
+  // process attributes, which are owned by the runtime
+  auto* arena = impl_->runtime->value_arena();
+  auto attrs  = op->getAttrs();
 
   for (int i = 0; i < attrs.size(); i++) {
     auto& attr = attrs[i];
     if (auto v = EmitAttribute<int32_t>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(*v));
+      impl_->cur_op->AppendAttribute(arena->New(*v));
     } else if (auto v = EmitAttribute<int64_t>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(*v));
+      impl_->cur_op->AppendAttribute(arena->New(*v));
     } else if (auto v = EmitAttribute<float>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(*v));
+      impl_->cur_op->AppendAttribute(arena->New(*v));
     } else if (auto v = EmitAttribute<double>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(*v));
+      impl_->cur_op->AppendAttribute(arena->New(*v));
     } else if (auto v = EmitAttribute<std::string>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else if (auto v = EmitAttribute<std::vector<int16_t>>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else if (auto v = EmitAttribute<std::vector<int32_t>>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else if (auto v = EmitAttribute<std::vector<int64_t>>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else if (auto v = EmitAttribute<std::vector<float>>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else if (auto v = EmitAttribute<std::vector<double>>(&attr.second)) {
-      impl_->cur_op->AppendAttribute(new Value(std::move(*v)));
+      impl_->cur_op->AppendAttribute(arena->New(std::move(*v)));
     } else {
       LOG(FATAL) << "Not supported attribute type";
     }
@@ -287,7 +288,7 @@ bool MlirToRuntimeTranslator::EmitGeneralOp(mlir::Operation* op) {
 
     auto func_type = mlir::FunctionType::get(inputs, results, region.getContext());
     auto* function = impl_->cur_op->CreateFunctionExecutable(&region, func_type, &impl_->func_defs);
-    impl_->cur_op->AppendAttribute(new Value(function));
+    impl_->cur_op->AppendAttribute(arena->New(function));
   }
 
   return true;
@@ -393,7 +394,7 @@ bool MlirToRuntimeTranslator::EmitCallOp(mlir::Operation* op, function_defs_t* f
     auto it = table.find(callee_name.getValue().str());
     CHECK(it != table.end()) << "can't find function [" << callee_name.getValue().str() << "]";
     auto* function = impl_->cur_op->CreateFunctionExecutable(it->second, &impl_->func_defs);
-    impl_->cur_op->AppendAttribute(new Value(function));
+    impl_->cur_op->AppendAttribute(impl_->runtime->value_arena()->New(function));
   }
 
   VLOG(3) << "Emit call " << callee_name.getValue().str() << " " << impl_->cur_op->frame();
@@ -0,0 +1,98 @@
+#include "infrt/host_context/thread_pool.h"
+
+#include <glog/logging.h>
+
+#include <utility>
+
+namespace infrt::host_context {
+
+namespace {
+// the pool and the index of the worker running on the current thread
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local int current_worker                          = -1;
+
+std::unique_ptr<WorkStealingThreadPool> global_pool;
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; i++) {
+    queues_.emplace_back(new TaskQueue);
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkStealingThreadPool::Schedule(Task task) {
+  if (IsWorkerThread()) {
+    auto& queue = *queues_[current_worker];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    queue.tasks.push_front(std::move(task));
+  } else {
+    auto& queue = *queues_[next_queue_++ % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++num_pending_;
+  }
+  cv_.notify_one();
+}
+
+bool WorkStealingThreadPool::IsWorkerThread() const { return current_pool == this; }
+
+bool WorkStealingThreadPool::PopTask(int worker_id, Task* task) {
+  int num_queues = queues_.size();
+  for (int i = 0; i < num_queues; i++) {
+    auto& queue = *queues_[(worker_id + i) % num_queues];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    if (queue.tasks.empty()) continue;
+    // pop the latest task of its own queue, and steal the oldest one of the others
+    if (i == 0) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    --num_pending_;
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(int worker_id) {
+  current_pool   = this;
+  current_worker = worker_id;
+  while (true) {
+    Task task;
+    if (PopTask(worker_id, &task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+    if (stop_ && num_pending_ == 0) return;
+  }
+}
+
+void WorkStealingThreadPool::InitGlobal(int num_threads) {
+  global_pool.reset(num_threads > 0 ? new WorkStealingThreadPool(num_threads) : nullptr);
+}
+
+WorkStealingThreadPool* WorkStealingThreadPool::Global() { return global_pool.get(); }
+
+}  // namespace infrt::host_context
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infrt::host_context {
+
+/**
+ * A work-stealing thread pool to run the host kernels. Each worker has its own task queue: the tasks scheduled by a
+ * worker are pushed to the front of its queue and popped from the front, so that the successors of a kernel run on the
+ * same worker while the data is hot, and an idle worker steals the tasks from the back of the other queues. The tasks
+ * scheduled by other threads are distributed to the queues in turn.
+ */
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingThreadPool(int num_threads);
+  ~WorkStealingThreadPool();
+
+  void Schedule(Task task);
+
+  int num_threads() const { return workers_.size(); }
+
+  //! Tell whether the calling thread is a worker of this pool.
+  bool IsWorkerThread() const;
+
+  /**
+   * Create the global pool used by CoreRuntime::Execute to run the independent ops concurrently. The ops are run in
+   * order on the calling thread if the global pool is not created or \p num_threads is not positive.
+   */
+  static void InitGlobal(int num_threads);
+  //! Get the global pool, nullptr if not created.
+  static WorkStealingThreadPool* Global();
+
+ private:
+  struct TaskQueue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(int worker_id);
+  bool PopTask(int worker_id, Task* task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<unsigned> next_queue_{0};
+  std::atomic<int> num_pending_{0};
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_{};
+};
+
+}  // namespace infrt::host_context
@@ -2,6 +2,7 @@
 #include <glog/logging.h>
 #include <llvm/ADT/SmallVector.h>
 
+#include <deque>
 #include <string>
 #include <utility>
 #include <vector>
@@ -73,6 +74,12 @@ class Value : public infrt::common::Object {
     return data.get<T>();
   }
 
+  //! Tell whether the data is of type T, unlike Object::is_type which checks the type of the Object.
+  template <typename T>
+  bool holds() const {
+    return data.is<T>();
+  }
+
   template <typename T>
   void set(T&& v) {
     data = std::move(v);
@@ -138,5 +145,24 @@ class ValueRef : infrt::common::Shared<Value> {
   inline bool IsValid() { return p_; }
 };
 
+/**
+ * ValueArena allocates the Values living as long as a program, such as the attributes of the ops, in blocks, so that
+ * the Values of a program are close in memory and freed together with the program.
+ * NOTE the Values allocated should not be held by ValueRef, which deletes the Value once not referenced.
+ */
+class ValueArena {
+ public:
+  template <typename... Args>
+  Value* New(Args&&... args) {
+    return &values_.emplace_back(std::forward<Args>(args)...);
+  }
+
+  size_t size() const { return values_.size(); }
+
+ private:
+  // a deque never moves the elements on growing
+  std::deque<Value> values_;
+};
+
 }  // namespace host_context
 }  // namespace infrt
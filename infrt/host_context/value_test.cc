@@ -16,5 +16,29 @@ TEST(ValueRef, test) {
   ASSERT_EQ(z.get<bool>(), true);
 }
 
+TEST(Value, set) {
+  Value x(std::vector<float>{1.f, 2.f});
+  // the same type is assigned in place
+  x.set(std::vector<float>{3.f, 4.f, 5.f});
+  ASSERT_TRUE(x.holds<std::vector<float>>());
+  ASSERT_EQ(x.get<std::vector<float>>().size(), 3UL);
+  ASSERT_EQ(x.get<std::vector<float>>()[1], 4.f);
+
+  x.set(1);
+  ASSERT_TRUE(x.holds<int32_t>());
+  ASSERT_EQ(x.get<int32_t>(), 1);
+}
+
+TEST(ValueArena, test) {
+  ValueArena arena;
+  Value* first = arena.New(1);
+  for (int i = 0; i < 1000; i++) {
+    arena.New(static_cast<float>(i));
+  }
+  ASSERT_EQ(arena.size(), 1001UL);
+  // the Values are not moved on growing
+  ASSERT_EQ(first->get<int32_t>(), 1);
+}
+
 }  // namespace host_context
 }  // namespace infrt
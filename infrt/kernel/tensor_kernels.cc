@@ -34,12 +34,14 @@ void FillTensorWithConstant(DenseHostTensor *tensor, Attribute<T> v) {
 
 TensorMap LoadParams(const std::string &path) { return *(infrt::tensor::LoadParams(path)); }
 
-DenseHostTensor GetParam(TensorMap map, Attribute<std::string> nameAttr) {
+DenseHostTensor GetParam(const TensorMap &map, Attribute<std::string> nameAttr) {
   auto &name = nameAttr.get();
-  return *(map[name]);
+  auto it     = map.find(name);
+  CHECK(it != map.end()) << "No param called " << name;
+  return *(it->second);
 }
 
-DenseHostTensor ShallowCopyTensor(DenseHostTensor v) { return v; }
+DenseHostTensor ShallowCopyTensor(const DenseHostTensor &v) { return v; }
 
 /// ===== Kernel end ====
 
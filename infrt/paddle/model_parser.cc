@@ -1,5 +1,6 @@
 #include "infrt/paddle/model_parser.h"
 
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -113,6 +114,41 @@ void LoadLoDTensor(std::istream &is, infrt::paddle::_Variable *var, const infrt:
   TensorFromStream(is, tensor.operator->(), target);
 }
 
+bool ParseLoDTensor(const char *data, size_t size, LoDTensorData *tensor) {
+  size_t offset = 0;
+  auto read     = [&](void *dst, size_t nbytes) {
+    if (offset + nbytes > size) return false;
+    std::memcpy(dst, data + offset, nbytes);
+    offset += nbytes;
+    return true;
+  };
+
+  uint32_t version{};
+  uint64_t lod_level{};
+  if (!read(&version, sizeof(version)) || !read(&lod_level, sizeof(lod_level))) return false;
+  // skip the LoD information
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t lod_size{};
+    if (!read(&lod_size, sizeof(lod_size)) || offset + lod_size > size) return false;
+    offset += lod_size;
+  }
+
+  int32_t desc_size{};
+  if (!read(&version, sizeof(version)) || version != 0U || !read(&desc_size, sizeof(desc_size))) return false;
+  if (desc_size < 0 || offset + desc_size > size || !tensor->desc.ParseFromArray(data + offset, desc_size)) {
+    return false;
+  }
+  offset += desc_size;
+
+  size_t numel = 1;
+  for (auto dim : tensor->desc.dims()) {
+    numel *= dim;
+  }
+  tensor->offset = offset;
+  tensor->size   = numel * SizeOfType(tensor->desc.data_type());
+  return offset + tensor->size <= size;
+}
+
 void ReadBinaryFile(const std::string &filename, std::string *contents) {
   std::ifstream fin(filename, std::ios::in | std::ios::binary);
   CHECK(fin.is_open()) << "Cannot open file: " << filename;
@@ -32,4 +32,16 @@ void TensorFromStream(std::istream& is,
                       const infrt::common::Target& target = infrt::common::DefaultHostTarget());
 void ReadBinaryFile(const std::string& filename, std::string* contents);
 
+// The description and the position of the data of a serialized LoDTensor.
+struct LoDTensorData {
+  framework_proto::VarType::TensorDesc desc;
+  // the offset of the data from the beginning of the serialized LoDTensor
+  size_t offset{};
+  size_t size{};
+};
+
+// Parse the LoDTensor serialized in \p data of \p size bytes without reading the tensor data, so that the data can
+// be viewed in place. Return false if the serialized LoDTensor is invalid or truncated.
+bool ParseLoDTensor(const char* data, size_t size, LoDTensorData* tensor);
+
 }  // namespace infrt::paddle
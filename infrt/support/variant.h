@@ -75,6 +75,14 @@ class Variant {
 
   template <typename T, std::enable_if_t<!IsVariant<T>, int> = 0>
   Variant& operator=(T&& t) {
+    using Type = std::decay_t<T>;
+    // assign in place if the type is not changed, which is the common case of the results reused by each execution
+    if constexpr (std::is_assignable<Type&, T&&>::value) {
+      if (is<Type>()) {
+        get<Type>() = std::forward<T>(t);
+        return *this;
+      }
+    }
     destroy();
     fillValue(std::forward<T>(t));
 
@@ -136,15 +144,16 @@ class Variant {
     static_assert(has_type, "Invalid Type used for Variant");
   }
 
-  void destroy() {
-    visit(
-        [](auto& t) {
-          using T = std::decay_t<decltype(t)>;
-          t.~T();
-        },
-        *this);
+  template <typename T>
+  static void DestroyAt(void* p) {
+    static_cast<T*>(p)->~T();
   }
 
+  // the destructors indexed by index_, which avoids visiting the types one by one
+  static constexpr void (*kDestroyers[])(void*) = {&DestroyAt<Ts>...};
+
+  void destroy() { kDestroyers[index_](&storage_); }
+
   template <typename T>
   void fillValue(T&& t) {
     using Type = std::decay_t<T>;
@@ -2,6 +2,8 @@
 
 #include <llvm/Support/raw_os_ostream.h>
 
+#include <utility>
+
 #include "infrt/common/buffer.h"
 
 namespace infrt::tensor {
@@ -12,6 +14,13 @@ DenseHostTensor::DenseHostTensor(const TensorShape& shape, DType dtype) : HostTe
   buffer_->ResizeLazy(dtype.GetHostSize() * shape.GetNumElements());
 }
 
+DenseHostTensor::DenseHostTensor(const TensorShape& shape, DType dtype, void* data, std::shared_ptr<void> holder)
+    : HostTensor(TensorMetadata{dtype, shape}) {
+  CHECK(metadata().IsValid()) << "Tensor construct get invalid metadata";
+  buffer_.reset(new infrt::Buffer(infrt::common::DefaultHostTarget()));
+  buffer_->ShareExternal(data, dtype.GetHostSize() * shape.GetNumElements(), std::move(holder));
+}
+
 const TensorShape& DenseHostTensor::shape() const { return metadata().shape; }
 
 void DenseHostTensor::Init(const std::vector<int64_t>& shape, DType dtype) {
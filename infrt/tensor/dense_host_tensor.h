@@ -51,6 +51,8 @@ class DenseHostTensor : public HostTensor {
  public:
   DenseHostTensor() = default;
   DenseHostTensor(const TensorShape& shape, DType dtype);
+  //! Create a tensor viewing the external \p data without copying, which is kept alive by \p holder.
+  DenseHostTensor(const TensorShape& shape, DType dtype, void* data, std::shared_ptr<void> holder);
 
   void Init(const std::vector<int64_t>& shape, DType dtype);
   const TensorShape& shape() const;
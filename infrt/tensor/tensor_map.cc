@@ -2,7 +2,10 @@
 
 #include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
+#include "infrt/common/mapped_file.h"
 #include "infrt/common/string.h"
 #include "infrt/paddle/model_parser.h"
 
@@ -29,6 +32,42 @@ infrt::DType CinnType2DType_(Type type) {
   return infrt::DType(infrt::DType::Kind::Unk);
 }
 
+// Get the DType of the data viewed in place, Unk if the type is not supported.
+static infrt::DType ProtoType2DType_(::paddle::framework::proto::VarType::Type type) {
+  using Type = ::paddle::framework::proto::VarType::Type;
+  switch (static_cast<int>(type)) {
+    case Type::VarType_Type_FP32:
+      return GetDType<float>();
+    case Type::VarType_Type_INT8:
+      return GetDType<int8_t>();
+    case Type::VarType_Type_INT16:
+      return GetDType<int16_t>();
+    case Type::VarType_Type_INT32:
+      return GetDType<int32_t>();
+    case Type::VarType_Type_INT64:
+      return GetDType<int64_t>();
+    default:
+      return infrt::DType(infrt::DType::Kind::Unk);
+  }
+}
+
+// Create a tensor viewing the param in the file mapped, nullptr if the data is not aligned to its type in the file or
+// the type is not supported, then the param should be copied.
+static DenseHostTensor *MapParam(const std::string &param_path) {
+  auto file = infrt::MappedFile::Open(param_path);
+  infrt::paddle::LoDTensorData tensor_data;
+  if (!file || !infrt::paddle::ParseLoDTensor(file->data(), file->size(), &tensor_data)) return nullptr;
+
+  auto dtype = ProtoType2DType_(tensor_data.desc.data_type());
+  // the file is mapped at a page, so the data is aligned if the offset is
+  if (!dtype.IsValid() || tensor_data.offset % dtype.GetHostSize() != 0) return nullptr;
+
+  std::vector<int64_t> shape(tensor_data.desc.dims().begin(), tensor_data.desc.dims().end());
+  auto shape_array = llvm::ArrayRef<int64_t>(shape.data(), shape.size());
+  void *data       = file->data() + tensor_data.offset;
+  return new DenseHostTensor(TensorShape(shape_array), dtype, data, std::move(file));
+}
+
 TensorMap *LoadParams(const std::string &path) {
   std::cout << "loading params from: " << path << std::endl;
   TensorMap *map = new TensorMap();
@@ -44,9 +83,15 @@ TensorMap *LoadParams(const std::string &path) {
   for (auto &var : main_block.vars()) {
     if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
     std::string param_path = path + "/" + var.name();
-    std::ifstream param_file(param_path, std::ios::binary);
     switch (var.type().type()) {
       case ::paddle::framework::proto::VarType_Type_LOD_TENSOR: {
+        // view the data in the file mapped, so that the models loading the same params share the pages, and fall
+        // back to copying if the data can't be viewed
+        if (auto *dht = MapParam(param_path)) {
+          (*map)[var.name()] = dht;
+          break;
+        }
+        std::ifstream param_file(param_path, std::ios::binary);
         auto var_name = infrt::cinn::TransValidVarName(var.name());
         // std::cout << "var name: " << var.name() << " " << var_name << std::endl;
         auto *_var = scope.Var<infrt::paddle::Tensor>(var_name);
@@ -126,5 +126,48 @@ class TestCompilePaddleModel(unittest.TestCase):
         self.assertTrue(np.allclose(res_cinn, res_paddle, atol=1e-5))
 
 
+class TestDynamicBatcher(unittest.TestCase):
+    def setUp(self):
+        if enable_gpu == "ON":
+            self.target = DefaultNVGPUTarget()
+        else:
+            self.target = DefaultHostTarget()
+
+    def test_coalesce_requests(self):
+        def build(bucket):
+            builder = NetBuilder("batched_relu")
+            x = builder.create_input(Float(32), (bucket, 8), "x")
+            y = builder.relu(x)
+            y.set_id("y")
+            return builder.build()
+
+        bucket_config = BucketedComputation.Config()
+        bucket_config.min_size = 1
+        bucket_config.max_size = 16
+        bucket_config.dynamic_axes = {"x": 0}
+        computation = BucketedComputation(self.target, build, bucket_config)
+
+        config = DynamicBatcher.Config()
+        config.max_batch_size = 16
+        config.max_delay_us = 200000
+        config.output_axes = {"y": 0}
+        batcher = DynamicBatcher(computation, config)
+
+        xs = [
+            np.random.uniform(-1, 1, [size, 8]).astype("float32")
+            for size in (1, 3, 4)
+        ]
+        ys = [np.zeros_like(x) for x in xs]
+        futures = [
+            batcher.submit({"x": x}, {"y": y}, x.shape[0])
+            for x, y in zip(xs, ys)
+        ]
+        for future in futures:
+            future.wait()
+        for x, y in zip(xs, ys):
+            self.assertTrue(np.allclose(y, np.maximum(x, 0)))
+        self.assertEqual(batcher.num_batches(), 1)
+
+
 if __name__ == "__main__":
     unittest.main()
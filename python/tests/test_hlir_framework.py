@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from cinn.common import *
 from cinn.framework import *
 import unittest
 import numpy as np
@@ -29,6 +30,23 @@ class TensorTest(unittest.TestCase):
 
         self.assertTrue(np.allclose(tensor.numpy(), data))
 
+    def test_zero_copy(self):
+        target = DefaultHostTarget()
+        data = np.random.random([10, 5]).astype("float32")
+        tensor = Tensor.from_dlpack(data)
+        self.assertEqual(tensor.shape(), [10, 5])
+
+        # the tensor, the array and the view share the same memory
+        view = np.asarray(tensor)
+        data[2, 3] = 7.0
+        self.assertEqual(view[2, 3], 7.0)
+        self.assertEqual(tensor.numpy(target, copy=False)[2, 3], 7.0)
+        self.assertTrue(np.allclose(tensor.numpy(target), data))
+
+        exported = np.from_dlpack(tensor)
+        exported[0, 0] = -1.0
+        self.assertEqual(data[0, 0], -1.0)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,216 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmark/compile_benchmark.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/utils/compile_stats.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+#include "tests/benchmark/model_benchmark.h"
+
+namespace cinn {
+namespace tests {
+
+using frontend::NetBuilder;
+using frontend::Variable;
+
+namespace {
+
+// the models of the model benchmark in the corpus, which are compiled for float32 with their default batch sizes
+const std::vector<std::string> kModelGraphs = {"bert_layer", "mlp", "resnet50", "bert_base"};
+
+// the bytes of a field in kB of /proc/self/status, such as VmRSS, 0 if not found
+int64_t ReadProcStatusBytes(const std::string& field) {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (utils::Startswith(line, field + ":")) {
+      std::stringstream ss(line.substr(field.size() + 1));
+      int64_t kb = 0;
+      ss >> kb;
+      return kb * 1024;
+    }
+  }
+  return 0;
+}
+
+// reset the high-water mark of the resident memory to the current one, which is supported since Linux 4.0
+void ResetPeakRss() {
+  std::ofstream ofs("/proc/self/clear_refs");
+  ofs << "5";
+  if (!ofs.good()) {
+    LOG_FIRST_N(WARNING, 1) << "Failed to reset the peak RSS, the peak of the whole process is reported instead";
+  }
+}
+
+// the lower case name of the architecture, such as x86 and nvgpu as the model benchmark names them
+std::string TargetName(const common::Target& target) {
+  auto name = target.arch_str();
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  return name;
+}
+
+proto::CompileBenchmarkResult CompileOnce(const std::string& graph_name, const common::Target& target) {
+  NetBuilder builder(graph_name);
+  auto outputs = BuildCompileBenchmarkGraph(graph_name, &builder);
+  std::unordered_set<std::string> fetch_ids;
+  for (auto& output : outputs) {
+    fetch_ids.insert(output->id);
+  }
+  // drop the phases recorded on this thread before, the ones of the passes are taken by GraphCompiler::Build
+  utils::CompileStats pending;
+  utils::CompileStats::TakePending(&pending);
+
+  proto::CompileBenchmarkResult result;
+  result.set_graph(graph_name);
+  result.set_target(TargetName(target));
+  ResetPeakRss();
+  result.set_base_rss_bytes(ReadProcStatusBytes("VmRSS"));
+  utils::Timer timer;
+  timer.Start();
+  auto program = builder.Build();
+  result.set_num_ops(program.size());
+  auto graph = frontend::Optimize(&program, fetch_ids, target);
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler compiler(target, scope, graph);
+  hlir::framework::GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  auto compiled                      = compiler.Build(options, std::move(fetch_ids));
+  result.set_total_ms(timer.Stop());
+  result.set_peak_rss_bytes(ReadProcStatusBytes("VmHWM"));
+  result.set_num_fusion_groups(graph->fusion_groups.size());
+
+  auto& stats = *compiled.stats;
+  for (auto& item : stats.Phases()) {
+    (*result.mutable_phase_ms())[item.first] = item.second.total_ms;
+    if (utils::Startswith(item.first, "ProgramPass ")) {
+      result.set_frontend_passes_ms(result.frontend_passes_ms() + item.second.total_ms);
+    } else if (utils::Startswith(item.first, "GraphPass ")) {
+      result.set_hlir_passes_ms(result.hlir_passes_ms() + item.second.total_ms);
+    } else if (utils::Startswith(item.first, "optim::Optimize")) {
+      result.set_optim_ms(result.optim_ms() + item.second.total_ms);
+    }
+  }
+  for (auto& group : stats.Groups()) {
+    result.set_lowering_ms(result.lowering_ms() + group.lowering_ms);
+    result.set_num_ir_nodes(result.num_ir_nodes() + group.ir_size);
+  }
+  for (auto& module : stats.Modules()) {
+    result.set_codegen_ms(result.codegen_ms() + module.codegen_ms);
+    result.set_device_compile_ms(result.device_compile_ms() + module.device_compile_ms);
+    result.set_jit_ms(result.jit_ms() + module.jit_ms);
+  }
+  return result;
+}
+
+std::string ResultKey(const proto::CompileBenchmarkResult& result) { return result.graph() + "/" + result.target(); }
+
+}  // namespace
+
+const std::vector<std::string>& CompileBenchmarkGraphs() {
+  static const std::vector<std::string> graphs = [] {
+    std::vector<std::string> names = {"elementwise_add", "reduce_sum", "softmax", "layer_norm", "matmul_bias_gelu"};
+    names.insert(names.end(), kModelGraphs.begin(), kModelGraphs.end());
+    return names;
+  }();
+  return graphs;
+}
+
+std::vector<Variable> BuildCompileBenchmarkGraph(const std::string& graph, NetBuilder* builder) {
+  auto type = common::F32();
+  if (graph == "elementwise_add") {
+    auto x = builder->CreateInput(type, {1024, 1024}, "x");
+    auto y = builder->CreateInput(type, {1024, 1024}, "y");
+    return {builder->Add(x, y)};
+  } else if (graph == "reduce_sum") {
+    auto x = builder->CreateInput(type, {1024, 1024}, "x");
+    return {builder->ReduceSum(x, {1})};
+  } else if (graph == "softmax") {
+    auto x = builder->CreateInput(type, {128, 1024}, "x");
+    return {builder->Softmax(x, {-1})};
+  } else if (graph == "layer_norm") {
+    auto x     = builder->CreateInput(type, {512, 768}, "x");
+    auto scale = builder->CreateInput(type, {768}, "scale");
+    auto bias  = builder->CreateInput(type, {768}, "bias");
+    return {builder->LayerNorm(x, scale, bias, 1e-5f, 1)[0]};
+  } else if (graph == "matmul_bias_gelu") {
+    auto x      = builder->CreateInput(type, {512, 768}, "x");
+    auto weight = builder->CreateInput(type, {768, 3072}, "weight");
+    auto bias   = builder->CreateInput(type, {3072}, "bias");
+    return {builder->Gelu(builder->Add(builder->Matmul(x, weight), bias))};
+  } else if (std::find(kModelGraphs.begin(), kModelGraphs.end(), graph) != kModelGraphs.end()) {
+    return BuildBenchmarkModel(graph, "float32", DefaultBenchmarkBatchSize(graph), builder);
+  }
+  LOG(FATAL) << "Unknown graph " << graph << " of the compile benchmark, which should be one of "
+             << utils::Join(CompileBenchmarkGraphs(), ", ");
+  return {};
+}
+
+proto::CompileBenchmarkResult RunCompileBenchmark(const std::string& graph, const common::Target& target, int repeat) {
+  CHECK_GT(repeat, 0) << "The benchmark should compile at least once";
+  std::vector<proto::CompileBenchmarkResult> results;
+  for (int i = 0; i < repeat; ++i) {
+    results.emplace_back(CompileOnce(graph, target));
+  }
+  std::sort(results.begin(), results.end(), [](auto& a, auto& b) { return a.total_ms() < b.total_ms(); });
+  return results[(results.size() - 1) / 2];
+}
+
+std::vector<std::string> CompareCompileBenchmarkReports(const proto::CompileBenchmarkReport& report,
+                                                        const proto::CompileBenchmarkReport& baseline,
+                                                        double tolerance) {
+  std::map<std::string, const proto::CompileBenchmarkResult*> baseline_results;
+  for (auto& result : baseline.results()) {
+    baseline_results[ResultKey(result)] = &result;
+  }
+
+  std::vector<std::string> regressions;
+  auto check = [&](const std::string& key, const std::string& metric, double value, double base) {
+    if (base > 0 && value > base * (1.0 + tolerance)) {
+      std::stringstream ss;
+      ss << key << ": " << metric << " " << value << " vs baseline " << base;
+      regressions.push_back(ss.str());
+    }
+  };
+  for (auto& result : report.results()) {
+    auto key = ResultKey(result);
+    auto it  = baseline_results.find(key);
+    if (it == baseline_results.end()) {
+      LOG(INFO) << "No baseline of " << key;
+      continue;
+    }
+    auto& base = *it->second;
+    check(key, "total_ms", result.total_ms(), base.total_ms());
+    check(key,
+          "peak_rss_bytes",
+          static_cast<double>(result.peak_rss_bytes()),
+          static_cast<double>(base.peak_rss_bytes()));
+  }
+  return regressions;
+}
+
+}  // namespace tests
+}  // namespace cinn
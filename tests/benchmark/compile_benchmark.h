@@ -0,0 +1,49 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "tests/benchmark/compile_benchmark.pb.h"
+
+namespace cinn {
+namespace tests {
+
+//! The graphs of the compile benchmark corpus, from single operators through transformer blocks to whole models.
+const std::vector<std::string>& CompileBenchmarkGraphs();
+
+//! Build the graph of the corpus named \p graph into \p builder, and return its outputs.
+std::vector<frontend::Variable> BuildCompileBenchmarkGraph(const std::string& graph, frontend::NetBuilder* builder);
+
+/**
+ * Compile the graph \p repeat times by the program passes, the graph passes and GraphCompiler as the computations do,
+ * and return the breakdown of the compilation of the median total time. The compiled programs are not cached.
+ */
+proto::CompileBenchmarkResult RunCompileBenchmark(const std::string& graph, const common::Target& target, int repeat);
+
+/**
+ * Compare the results with the ones of the same graph and target in \p baseline, and return the regressions: the total
+ * time or the peak memory worse than the baseline by more than \p tolerance, a fraction of the baseline. The results
+ * missing in the baseline are skipped.
+ */
+std::vector<std::string> CompareCompileBenchmarkReports(const proto::CompileBenchmarkReport& report,
+                                                        const proto::CompileBenchmarkReport& baseline,
+                                                        double tolerance);
+
+}  // namespace tests
+}  // namespace cinn
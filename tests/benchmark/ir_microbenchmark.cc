@@ -0,0 +1,206 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks of the compiler components that dominate compilation and auto-tuning time. Each case builds a
+// representative input once and only times the component itself, so the numbers can be compared across commits
+// with google benchmark's `compare.py` or the `--benchmark_out` JSON.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/auto_schedule/cost_model/feature_extractor.h"
+#include "cinn/cinn.h"
+#include "cinn/common/cas.h"
+#include "cinn/common/context.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/poly/ast_gen.h"
+#include "cinn/poly/schedule.h"
+
+namespace cinn {
+namespace tests {
+
+namespace {
+
+// B = A * 2, C = B + 1 over a 2-D domain of `size` x `size`, lowered with A, C as arguments.
+std::vector<ir::LoweredFunc> LowerElementwiseChain(int size, const common::Target& target) {
+  Expr M(size), N(size);
+  Placeholder<float> A("A", {M, N});
+  ir::Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * Expr(2.f); }, "B");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return B(i, j) + Expr(1.f); }, "C");
+  return lang::LowerVec("elementwise_chain", CreateStages({A, B, C}), {A, C}, {}, {}, nullptr, target, true);
+}
+
+// C = A x B with a reduction over K.
+std::vector<ir::LoweredFunc> LowerMatmul(int m, int n, int k, const common::Target& target) {
+  Expr M(m), N(n), K(k);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var r(K.as_int32(), "reduce_k");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, r) * B(r, j), {r}); }, "C");
+  return lang::LowerVec("matmul", CreateStages({C}), {A, B, C}, {}, {}, nullptr, target, true);
+}
+
+ir::ModuleExpr CopyModuleExpr(const std::vector<ir::LoweredFunc>& funcs) {
+  std::vector<Expr> exprs;
+  for (auto& func : funcs) {
+    exprs.emplace_back(optim::IRCopy(func->body));
+  }
+  return ir::ModuleExpr(exprs);
+}
+
+// The schedule shared by the schedule primitive and replay benchmarks: inline B's loops into C, then tile and fuse.
+void ApplyElementwiseSchedule(ir::IRSchedule* sch) {
+  auto block_b = sch->GetBlock("B");
+  auto loops_c = sch->GetLoops("C");
+  sch->ComputeAt(block_b, loops_c[1]);
+  auto splited = sch->Split(sch->GetLoops("C")[0], {-1, 32});
+  sch->Fuse({splited[1], sch->GetLoops("C")[2]});
+}
+
+}  // namespace
+
+static void BM_CasSimplify(benchmark::State& state) {
+  Var x = ir::_Var_::Make("x", Int(32));
+  Var y = ir::_Var_::Make("y", Int(32));
+  Var z = ir::_Var_::Make("z", Int(32));
+  common::cas_intervals_t var_intervals;
+  var_intervals.emplace("x", common::CasInterval(0, 127));
+  var_intervals.emplace("y", common::CasInterval(0, 31));
+  var_intervals.emplace("z", common::CasInterval(0, 7));
+  // A typical index expression produced by splitting and fusing loops.
+  Expr index = ((Expr(x) * 32 + y) / 32 * 256 + (Expr(x) * 32 + y) % 32 * 8 + z) % 4096 +
+               Expr(32768) * (((Expr(32) * x) + y) / 32);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(common::CasSimplify(index, var_intervals));
+  }
+}
+BENCHMARK(BM_CasSimplify);
+
+static void BM_IRCopy(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  auto funcs = LowerMatmul(state.range(0), state.range(0), state.range(0), common::DefaultHostTarget());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optim::IRCopy(funcs));
+  }
+}
+BENCHMARK(BM_IRCopy)->Arg(32)->Arg(256);
+
+static void BM_IRScheduleSplit(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  auto funcs = LowerElementwiseChain(256, common::DefaultHostTarget());
+  for (auto _ : state) {
+    state.PauseTiming();
+    ir::IRSchedule sch(CopyModuleExpr(funcs));
+    auto loops = sch.GetLoops("B");
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(sch.Split(loops[0], {-1, 32}));
+  }
+}
+BENCHMARK(BM_IRScheduleSplit);
+
+static void BM_IRScheduleFuse(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  auto funcs = LowerElementwiseChain(256, common::DefaultHostTarget());
+  for (auto _ : state) {
+    state.PauseTiming();
+    ir::IRSchedule sch(CopyModuleExpr(funcs));
+    auto loops = sch.GetLoops("B");
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(sch.Fuse(loops));
+  }
+}
+BENCHMARK(BM_IRScheduleFuse);
+
+static void BM_IRScheduleComputeAt(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  auto funcs = LowerElementwiseChain(256, common::DefaultHostTarget());
+  for (auto _ : state) {
+    state.PauseTiming();
+    ir::IRSchedule sch(CopyModuleExpr(funcs));
+    auto block_b = sch.GetBlock("B");
+    auto loops_c = sch.GetLoops("C");
+    state.ResumeTiming();
+    sch.ComputeAt(block_b, loops_c[1]);
+  }
+}
+BENCHMARK(BM_IRScheduleComputeAt);
+
+static void BM_ScheduleDescReplay(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  auto funcs = LowerElementwiseChain(256, common::DefaultHostTarget());
+  ir::IRSchedule traced(CopyModuleExpr(funcs));
+  ApplyElementwiseSchedule(&traced);
+  ir::ScheduleDesc trace = traced.GetTraceDesc();
+  for (auto _ : state) {
+    state.PauseTiming();
+    ir::IRSchedule sch(CopyModuleExpr(funcs));
+    state.ResumeTiming();
+    trace.Replay(&sch);
+  }
+}
+BENCHMARK(BM_ScheduleDescReplay);
+
+static void BM_FeatureExtractor(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  common::Target target = common::DefaultHostTarget();
+  auto funcs            = LowerMatmul(256, 256, 256, target);
+  ir::IRSchedule sch(CopyModuleExpr(funcs));
+  auto loops = sch.GetLoops("C");
+  sch.Split(loops[0], {-1, 32});
+  ir::ModuleExpr mod_expr = sch.GetModule();
+  auto_schedule::FeatureExtractor extractor;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(extractor.Extract(mod_expr, target));
+  }
+}
+BENCHMARK(BM_FeatureExtractor);
+
+static void BM_PolyAstGen(benchmark::State& state) {
+  Context::Global().ResetNameId();
+  std::vector<Expr> shape = {Expr(64), Expr(32), Expr(16), Expr(8)};
+  Placeholder<float> A("A", shape);
+  ir::Tensor B = Compute(
+      shape, [&](const std::vector<Expr>& indice) { return lang::Relu(A(indice), 0); }, "relu");
+  poly::StageMap stage_map = CreateStages({B});
+  std::vector<poly::Stage*> stages{stage_map[B]};
+  std::unique_ptr<poly::Schedule> schedule =
+      poly::CreateSchedule(stages, poly::ScheduleKind::Poly, std::vector<std::pair<std::string, std::string>>());
+  CHECK(!schedule->groups.empty());
+  auto& group = schedule->groups.front();
+  for (auto _ : state) {
+    isl::set context(Context::isl_ctx(), "{:}");
+    poly::AstGen gen(context, stages, group);
+    isl::ast_node ast = gen.Build();
+    Expr expr;
+    poly::IslAstNodeToCinnExpr(ast, gen.domain().as_set(), &expr);
+    benchmark::DoNotOptimize(expr);
+  }
+}
+BENCHMARK(BM_PolyAstGen);
+
+}  // namespace tests
+}  // namespace cinn
+
+BENCHMARK_MAIN();
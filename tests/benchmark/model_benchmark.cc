@@ -0,0 +1,341 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmark/model_benchmark.h"
+
+#include <glog/logging.h>
+#include <google/protobuf/util/json_util.h>
+
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+#include "cinn/common/float16.h"
+#include "cinn/frontend/computation.h"
+#include "cinn/hlir/framework/memory.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+using frontend::NetBuilder;
+using frontend::Variable;
+
+namespace {
+
+// the rows of the embedding table of the mlp, the sparse indices are filled below it
+constexpr int kEmbeddingRows = 100000;
+
+Variable CreateParam(NetBuilder* builder,
+                     const common::Type& type,
+                     const std::vector<int>& shape,
+                     const std::string& prefix) {
+  return builder->CreateInput(type, shape, common::UniqName(prefix));
+}
+
+Variable ConvBN(NetBuilder* builder,
+                const common::Type& type,
+                const Variable& x,
+                int out_channels,
+                int kernel,
+                int stride,
+                bool relu) {
+  int in_channels = x->shape[1];
+  auto weight     = CreateParam(builder, type, {out_channels, in_channels, kernel, kernel}, "conv_weight");
+  auto out        = builder->Conv2d(x, weight, {stride, stride}, {kernel / 2, kernel / 2});
+  auto scale      = CreateParam(builder, type, {out_channels}, "bn_scale");
+  auto bias       = CreateParam(builder, type, {out_channels}, "bn_bias");
+  auto mean       = CreateParam(builder, type, {out_channels}, "bn_mean");
+  auto variance   = CreateParam(builder, type, {out_channels}, "bn_variance");
+  out             = builder->BatchNorm(out, scale, bias, mean, variance, 1e-5f, 0.9f, "NCHW", true)[0];
+  return relu ? builder->Relu(out) : out;
+}
+
+Variable Dense(NetBuilder* builder, const common::Type& type, const Variable& x, int out_features) {
+  int in_features = x->shape.back();
+  auto weight     = CreateParam(builder, type, {in_features, out_features}, "fc_weight");
+  auto bias       = CreateParam(builder, type, {out_features}, "fc_bias");
+  return builder->Add(builder->Matmul(x, weight), bias);
+}
+
+std::vector<Variable> BuildResNet50(NetBuilder* builder, const common::Type& type, int batch_size) {
+  auto x = builder->CreateInput(type, {batch_size, 3, 224, 224}, "image");
+  x      = ConvBN(builder, type, x, 64, 7, 2, true);
+  x      = builder->Pool2d(x, "max", {3, 3}, {2, 2}, {1, 1});
+  // the bottleneck blocks of the 4 stages: the number of blocks, the channels of the middle convs and the stride
+  for (auto& stage : std::vector<std::tuple<int, int, int>>{{3, 64, 1}, {4, 128, 2}, {6, 256, 2}, {3, 512, 2}}) {
+    int num_blocks = std::get<0>(stage), channels = std::get<1>(stage);
+    for (int i = 0; i < num_blocks; ++i) {
+      int stride    = i == 0 ? std::get<2>(stage) : 1;
+      auto shortcut = i == 0 ? ConvBN(builder, type, x, channels * 4, 1, stride, false) : x;
+      auto out      = ConvBN(builder, type, x, channels, 1, 1, true);
+      out           = ConvBN(builder, type, out, channels, 3, stride, true);
+      out           = ConvBN(builder, type, out, channels * 4, 1, 1, false);
+      x             = builder->Relu(builder->Add(out, shortcut));
+    }
+  }
+  x = builder->Pool2d(x, "avg", {7, 7}, {1, 1}, {0, 0}, false, true, true);
+  x = builder->Reshape(x, {batch_size, 2048});
+  return {Dense(builder, type, x, 1000)};
+}
+
+std::vector<Variable> BuildBertBase(NetBuilder* builder, const common::Type& type, int batch_size, int layers) {
+  const int seq_len = 128, hidden = 768, heads = 12, head_dim = hidden / heads, ffn = 3072;
+  const int tokens = batch_size * seq_len;
+  auto x           = builder->CreateInput(type, {tokens, hidden}, "embeddings");
+  auto layer_norm  = [&](const Variable& v) {
+    auto scale = CreateParam(builder, type, {hidden}, "ln_scale");
+    auto bias  = CreateParam(builder, type, {hidden}, "ln_bias");
+    return builder->LayerNorm(v, scale, bias, 1e-12f, 1)[0];
+  };
+  // [tokens, hidden] -> [batch, heads, seq, head_dim]
+  auto split_heads = [&](const Variable& v) {
+    return builder->Transpose(builder->Reshape(v, {batch_size, seq_len, heads, head_dim}), {0, 2, 1, 3});
+  };
+  for (int i = 0; i < layers; ++i) {
+    auto q      = split_heads(Dense(builder, type, x, hidden));
+    auto k      = split_heads(Dense(builder, type, x, hidden));
+    auto v      = split_heads(Dense(builder, type, x, hidden));
+    auto scores = builder->Matmul(q, k, false, true, 1.0f / std::sqrt(static_cast<float>(head_dim)));
+    auto probs  = builder->Softmax(scores, {-1});
+    auto ctx    = builder->Transpose(builder->Matmul(probs, v), {0, 2, 1, 3});
+    ctx         = builder->Reshape(ctx, {tokens, hidden});
+    x           = layer_norm(builder->Add(Dense(builder, type, ctx, hidden), x));
+    auto inter  = builder->Gelu(Dense(builder, type, x, ffn));
+    x           = layer_norm(builder->Add(Dense(builder, type, inter, hidden), x));
+  }
+  return {x};
+}
+
+std::vector<Variable> BuildMLP(NetBuilder* builder, const common::Type& type, int batch_size) {
+  const int dense_features = 13, sparse_features = 26, embedding_dim = 16;
+  auto dense  = builder->CreateInput(type, {batch_size, dense_features}, "dense_features");
+  auto sparse = builder->CreateInput(common::Int(32), {batch_size * sparse_features}, "sparse_indices");
+  auto table  = CreateParam(builder, type, {kEmbeddingRows, embedding_dim}, "embedding_table");
+
+  auto bottom = dense;
+  for (int features : {512, 256, embedding_dim}) {
+    bottom = builder->Relu(Dense(builder, type, bottom, features));
+  }
+  auto embeddings = builder->Reshape(builder->Gather(table, sparse, 0), {batch_size, sparse_features * embedding_dim});
+  auto top        = builder->Concat({bottom, embeddings}, 1);
+  for (int features : {512, 256}) {
+    top = builder->Relu(Dense(builder, type, top, features));
+  }
+  return {builder->Sigmoid(Dense(builder, type, top, 1))};
+}
+
+// Fill the inputs with small positive values, such as the variances of the batch norms, and the indices below the
+// rows of the embedding table.
+void FillRandomInputs(frontend::CinnComputation* computation) {
+  std::mt19937 engine(2023);
+  std::uniform_real_distribution<float> dist(0.01f, 0.1f);
+  for (auto& tensor : computation->GetInputTensors()) {
+    size_t numel = tensor->shape().numel();
+    auto type    = tensor->type();
+    if (type.is_float(32)) {
+      std::vector<float> data(numel);
+      std::generate(data.begin(), data.end(), [&]() { return dist(engine); });
+      computation->SetTensorData(tensor, data.data(), numel * sizeof(float));
+    } else if (type.is_float16()) {
+      std::vector<common::float16> data(numel);
+      std::generate(data.begin(), data.end(), [&]() { return common::float16(dist(engine)); });
+      computation->SetTensorData(tensor, data.data(), numel * sizeof(common::float16));
+    } else if (type.is_int(32)) {
+      std::vector<int> data(numel);
+      std::uniform_int_distribution<int> index_dist(0, kEmbeddingRows - 1);
+      std::generate(data.begin(), data.end(), [&]() { return index_dist(engine); });
+      computation->SetTensorData(tensor, data.data(), numel * sizeof(int));
+    } else {
+      LOG(FATAL) << "The benchmark doesn't support the input type " << type;
+    }
+  }
+}
+
+void SyncDevice(const common::Target& target) {
+#ifdef CINN_WITH_CUDA
+  if (target == common::DefaultNVGPUTarget()) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+}
+
+std::string TargetName(const common::Target& target) {
+  return target.arch == common::Target::Arch::NVGPU ? "nvgpu" : "x86";
+}
+
+// the nearest-rank percentile of the sorted samples
+double Percentile(const std::vector<double>& sorted, double percent) {
+  size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size()));
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+std::string ResultKey(const proto::ModelBenchmarkResult& result) {
+  std::stringstream ss;
+  ss << result.model() << "/" << result.dtype() << "/" << result.target() << "/batch" << result.batch_size();
+  return ss.str();
+}
+
+}  // namespace
+
+std::vector<Variable> BuildBenchmarkModel(const std::string& model,
+                                          const std::string& dtype,
+                                          int batch_size,
+                                          NetBuilder* builder) {
+  auto type = common::Str2Type(dtype);
+  CHECK(type.is_float(32) || type.is_float16()) << "The benchmark models only support float32 and float16";
+  if (model == "resnet50") {
+    return BuildResNet50(builder, type, batch_size);
+  } else if (model == "bert_base") {
+    return BuildBertBase(builder, type, batch_size, 12);
+  } else if (model == "bert_layer") {
+    return BuildBertBase(builder, type, batch_size, 1);
+  } else if (model == "mlp") {
+    return BuildMLP(builder, type, batch_size);
+  }
+  LOG(FATAL) << "Unknown benchmark model " << model << ", which should be resnet50, bert_base, bert_layer or mlp";
+  return {};
+}
+
+int DefaultBenchmarkBatchSize(const std::string& model) { return model == "mlp" ? 256 : 1; }
+
+proto::ModelBenchmarkResult RunModelBenchmark(const std::string& model,
+                                              const std::string& dtype,
+                                              const common::Target& target,
+                                              int batch_size,
+                                              int warmup,
+                                              int repeat) {
+  CHECK_GT(repeat, 0) << "The benchmark should run at least once";
+  auto& memory_manager = hlir::framework::MemoryManager::Global();
+  memory_manager.ResetPeakStats(target.arch);
+
+  NetBuilder builder(model + "_" + dtype);
+  auto outputs = BuildBenchmarkModel(model, dtype, batch_size, &builder);
+  utils::Timer timer;
+  timer.Start();
+  auto computation = frontend::CinnComputation::BuildAndCompile(
+      target, builder, frontend::CinnComputation::DefaultCompileOptions(), outputs);
+  SyncDevice(target);
+  double compile_ms = timer.Stop();
+
+  FillRandomInputs(computation.get());
+  for (int i = 0; i < warmup; ++i) {
+    computation->Execute();
+  }
+  SyncDevice(target);
+
+  std::vector<double> latencies;
+  for (int i = 0; i < repeat; ++i) {
+    timer.Start();
+    computation->Execute();
+    SyncDevice(target);
+    latencies.push_back(timer.Stop());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  double mean_ms = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+
+  proto::ModelBenchmarkResult result;
+  result.set_model(model);
+  result.set_dtype(dtype);
+  result.set_target(TargetName(target));
+  result.set_batch_size(batch_size);
+  result.set_compile_ms(compile_ms);
+  result.set_latency_mean_ms(mean_ms);
+  result.set_latency_p50_ms(Percentile(latencies, 50));
+  result.set_latency_p99_ms(Percentile(latencies, 99));
+  result.set_throughput(mean_ms > 0 ? batch_size * 1000.0 / mean_ms : 0.0);
+  result.set_peak_memory_bytes(memory_manager.GetStats(target.arch).peak_bytes);
+  result.set_estimated_peak_memory_bytes(computation->GetMemoryEstimate().peak_bytes);
+  return result;
+}
+
+void SaveBenchmarkReport(const proto::ModelBenchmarkReport& report, const std::string& path) {
+  SaveJsonReport(report, path);
+}
+
+proto::ModelBenchmarkReport LoadBenchmarkReport(const std::string& path) {
+  proto::ModelBenchmarkReport report;
+  LoadJsonReport(path, &report);
+  return report;
+}
+
+void SaveJsonReport(const google::protobuf::Message& report, const std::string& path) {
+  google::protobuf::util::JsonPrintOptions options;
+  options.add_whitespace                = true;
+  options.always_print_primitive_fields = true;
+  options.preserve_proto_field_names    = true;
+  std::string json;
+  auto status = google::protobuf::util::MessageToJsonString(report, &json, options);
+  CHECK(status.ok()) << "Failed to convert the benchmark report to json: " << status.ToString();
+  std::ofstream ofs(path);
+  CHECK(ofs.good()) << "Failed to open " << path;
+  ofs << json;
+}
+
+void LoadJsonReport(const std::string& path, google::protobuf::Message* report) {
+  std::ifstream ifs(path);
+  CHECK(ifs.good()) << "Failed to open the benchmark report " << path;
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  auto status = google::protobuf::util::JsonStringToMessage(ss.str(), report);
+  CHECK(status.ok()) << "Failed to parse the benchmark report " << path << ": " << status.ToString();
+}
+
+std::vector<std::string> CompareBenchmarkReports(const proto::ModelBenchmarkReport& report,
+                                                 const proto::ModelBenchmarkReport& baseline,
+                                                 double tolerance) {
+  std::map<std::string, const proto::ModelBenchmarkResult*> baseline_results;
+  for (auto& result : baseline.results()) {
+    baseline_results[ResultKey(result)] = &result;
+  }
+
+  std::vector<std::string> regressions;
+  auto check = [&](const std::string& key, const std::string& metric, double value, double base, bool higher_better) {
+    bool regressed = higher_better ? value < base * (1.0 - tolerance) : value > base * (1.0 + tolerance);
+    if (base > 0 && regressed) {
+      std::stringstream ss;
+      ss << key << ": " << metric << " " << value << " vs baseline " << base;
+      regressions.push_back(ss.str());
+    }
+  };
+  for (auto& result : report.results()) {
+    auto key = ResultKey(result);
+    auto it  = baseline_results.find(key);
+    if (it == baseline_results.end()) {
+      LOG(INFO) << "No baseline of " << key;
+      continue;
+    }
+    auto& base = *it->second;
+    check(key, "latency_p50_ms", result.latency_p50_ms(), base.latency_p50_ms(), false);
+    check(key, "throughput", result.throughput(), base.throughput(), true);
+    check(key,
+          "peak_memory_bytes",
+          static_cast<double>(result.peak_memory_bytes()),
+          static_cast<double>(base.peak_memory_bytes()),
+          false);
+  }
+  return regressions;
+}
+
+}  // namespace tests
+}  // namespace cinn
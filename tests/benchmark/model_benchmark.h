@@ -0,0 +1,71 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "tests/benchmark/model_benchmark.pb.h"
+
+namespace cinn {
+namespace tests {
+
+/**
+ * Build the representative model named \p model into \p builder, and return its outputs. The parameters are the
+ * inputs of the program as well, so that they are filled with random values like the data.
+ * @param model One of "resnet50", "bert_base", "bert_layer" and "mlp", where the bert_layer is a single transformer
+ * block of the bert_base, and the mlp is a DLRM-like recommender: the embeddings of the sparse features looked up from
+ * a shared table are concatenated with the bottom MLP of the dense features.
+ * @param dtype The dtype of the data and the parameters, "float32" or "float16".
+ */
+std::vector<frontend::Variable> BuildBenchmarkModel(const std::string& model,
+                                                    const std::string& dtype,
+                                                    int batch_size,
+                                                    frontend::NetBuilder* builder);
+
+//! The batch size used by the benchmark of \p model when not specified.
+int DefaultBenchmarkBatchSize(const std::string& model);
+
+/**
+ * Compile the model and run it \p repeat times after \p warmup runs, each run is synchronized with the device, so the
+ * latency is the time of a whole run. The peak memory is measured from the start of the compilation.
+ */
+proto::ModelBenchmarkResult RunModelBenchmark(const std::string& model,
+                                              const std::string& dtype,
+                                              const common::Target& target,
+                                              int batch_size,
+                                              int warmup,
+                                              int repeat);
+
+void SaveBenchmarkReport(const proto::ModelBenchmarkReport& report, const std::string& path);
+proto::ModelBenchmarkReport LoadBenchmarkReport(const std::string& path);
+
+//! Save a report of any benchmark in the JSON format, which keeps the field names of the proto, and parse it back.
+void SaveJsonReport(const google::protobuf::Message& report, const std::string& path);
+void LoadJsonReport(const std::string& path, google::protobuf::Message* report);
+
+/**
+ * Compare the results with the ones of the same model, dtype, target and batch size in \p baseline, and return the
+ * regressions: the p50 latency, the throughput or the peak memory worse than the baseline by more than \p tolerance,
+ * a fraction of the baseline. The results missing in the baseline are skipped.
+ */
+std::vector<std::string> CompareBenchmarkReports(const proto::ModelBenchmarkReport& report,
+                                                 const proto::ModelBenchmarkReport& baseline,
+                                                 double tolerance);
+
+}  // namespace tests
+}  // namespace cinn
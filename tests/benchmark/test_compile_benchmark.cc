@@ -0,0 +1,98 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/utils/string.h"
+#include "tests/benchmark/compile_benchmark.h"
+#include "tests/benchmark/model_benchmark.h"
+
+DEFINE_string(compile_benchmark_graphs,
+              "elementwise_add,softmax,layer_norm,matmul_bias_gelu,bert_layer",
+              "The graphs to compile separated by comma, all the graphs of the corpus if \"all\".");
+DEFINE_int32(compile_benchmark_repeat, 1, "The compilations of each graph, the one of the median time is reported.");
+DEFINE_string(compile_benchmark_commit, "", "The commit recorded in the report.");
+DEFINE_string(compile_benchmark_output, "", "The path of the json report, which is only logged if empty.");
+DEFINE_string(compile_benchmark_baseline, "", "The path of the json report to compare with, no comparison if empty.");
+DEFINE_double(compile_benchmark_tolerance, 0.2, "The fraction of the baseline allowed to regress.");
+
+namespace cinn {
+namespace tests {
+
+// Benchmark the compile time of the graphs of the corpus on the default target, such as
+//   test_compile_benchmark --compile_benchmark_graphs=all --compile_benchmark_commit=$(git rev-parse HEAD)
+//                          --compile_benchmark_output=compile_report.json
+// and check the regressions against a report saved before by --compile_benchmark_baseline.
+TEST(CompileBenchmark, run) {
+  auto graphs = FLAGS_compile_benchmark_graphs == "all" ? CompileBenchmarkGraphs()
+                                                        : utils::Split(FLAGS_compile_benchmark_graphs, ",");
+  auto target = common::DefaultTarget();
+  // initialize the compiler and the device before timing, such as the LLVM targets and the CUDA context
+  RunCompileBenchmark("elementwise_add", target, 1);
+
+  proto::CompileBenchmarkReport report;
+  report.set_commit(FLAGS_compile_benchmark_commit);
+  for (auto& graph : graphs) {
+    auto result = RunCompileBenchmark(graph, target, FLAGS_compile_benchmark_repeat);
+    LOG(INFO) << result.DebugString();
+    ASSERT_GT(result.num_ops(), 0);
+    ASSERT_GT(result.num_fusion_groups(), 0);
+    *report.add_results() = result;
+  }
+  if (!FLAGS_compile_benchmark_output.empty()) {
+    SaveJsonReport(report, FLAGS_compile_benchmark_output);
+  }
+
+  if (!FLAGS_compile_benchmark_baseline.empty()) {
+    proto::CompileBenchmarkReport baseline;
+    LoadJsonReport(FLAGS_compile_benchmark_baseline, &baseline);
+    auto regressions = CompareCompileBenchmarkReports(report, baseline, FLAGS_compile_benchmark_tolerance);
+    for (auto& regression : regressions) {
+      LOG(ERROR) << "Compile time regression against " << baseline.commit() << ": " << regression;
+    }
+    ASSERT_TRUE(regressions.empty()) << regressions.size() << " regressions against "
+                                     << FLAGS_compile_benchmark_baseline;
+  }
+}
+
+TEST(CompileBenchmark, compare) {
+  proto::CompileBenchmarkReport baseline, report;
+  auto* base = baseline.add_results();
+  base->set_graph("softmax");
+  base->set_target("x86");
+  base->set_total_ms(100.0);
+  base->set_peak_rss_bytes(1000);
+
+  // within the tolerance
+  auto* result = report.add_results();
+  *result      = *base;
+  result->set_total_ms(110.0);
+  ASSERT_TRUE(CompareCompileBenchmarkReports(report, baseline, 0.2).empty());
+
+  // slower and larger
+  result->set_total_ms(150.0);
+  result->set_peak_rss_bytes(2000);
+  ASSERT_EQ(CompareCompileBenchmarkReports(report, baseline, 0.2).size(), 2UL);
+
+  // no baseline of another target
+  result->set_target("nvgpu");
+  ASSERT_TRUE(CompareCompileBenchmarkReports(report, baseline, 0.2).empty());
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -47,5 +47,35 @@ TEST(test_elementwise_add, default_int32) {
   add_tester.Compare<int>();
 }
 
+// Compare the LLVM pipeline tuned for the host CPU with the generic one, see the kernel run time in the log.
+TEST(test_elementwise_add, host_cpu_pipeline_fp32) {
+  int M = 1024;
+  int N = 1024;
+  std::vector<std::vector<int>> input_shapes{{M, N}, {M, N}};
+  std::string op_name = "elementwise_add";
+  hlir::framework::NodeAttr attrs;
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32)};
+
+  backends::ExecutionOptions generic_options;
+  generic_options.use_host_cpu    = false;
+  generic_options.loop_vectorize  = false;
+  generic_options.slp_vectorize   = false;
+  generic_options.loop_interleave = false;
+  ElementwiseAddTester generic_tester(op_name, input_shapes);
+  generic_tester.SetExecutionOptions(generic_options);
+  auto generic_inputs = generic_tester.CreateInputTensors<float>();
+  generic_tester.TestOp("elementwise_add_generic_cpu_fp32", generic_inputs, attrs, input_types, output_types);
+  generic_tester.Compare<float>();
+
+  backends::ExecutionOptions host_options;
+  host_options.fast_math = true;
+  ElementwiseAddTester host_tester(op_name, input_shapes);
+  host_tester.SetExecutionOptions(host_options);
+  auto host_inputs = host_tester.CreateInputTensors<float>();
+  host_tester.TestOp("elementwise_add_host_cpu_fp32", host_inputs, attrs, input_types, output_types);
+  host_tester.Compare<float>();
+}
+
 }  // namespace tests
 }  // namespace cinn
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/utils/string.h"
+#include "tests/benchmark/model_benchmark.h"
+
+DEFINE_string(benchmark_models,
+              "mlp",
+              "The models to benchmark separated by comma, from resnet50, bert_base, bert_layer and mlp.");
+DEFINE_string(benchmark_dtypes, "float32", "The dtypes to benchmark separated by comma, from float32 and float16.");
+DEFINE_string(benchmark_targets,
+              "",
+              "The targets to benchmark separated by comma, from x86 and nvgpu, the default target if empty.");
+DEFINE_int32(benchmark_batch_size, 0, "The batch size of all the models, the default one of each model if 0.");
+DEFINE_int32(benchmark_warmup, 3, "The number of the runs before timing.");
+DEFINE_int32(benchmark_repeat, 20, "The number of the timed runs.");
+DEFINE_string(benchmark_output, "", "The path of the json report, which is only logged if empty.");
+DEFINE_string(benchmark_baseline, "", "The path of the json report to compare with, no comparison if empty.");
+DEFINE_double(benchmark_tolerance, 0.1, "The fraction of the baseline allowed to regress.");
+
+namespace cinn {
+namespace tests {
+
+// Benchmark the representative models end to end, such as
+//   test_model_benchmark --benchmark_models=resnet50,bert_base,mlp --benchmark_dtypes=float32,float16
+//                        --benchmark_output=report.json
+// and check the regressions against a report saved before by --benchmark_baseline.
+TEST(ModelBenchmark, run) {
+  std::vector<common::Target> targets;
+  for (auto& name : utils::Split(FLAGS_benchmark_targets, ",")) {
+    if (name == "x86") {
+      targets.push_back(common::DefaultHostTarget());
+    } else if (name == "nvgpu") {
+#ifdef CINN_WITH_CUDA
+      targets.push_back(common::DefaultNVGPUTarget());
+#else
+      LOG(WARNING) << "Skip the nvgpu target, which is not compiled with CUDA";
+#endif
+    } else if (!name.empty()) {
+      LOG(FATAL) << "Unknown benchmark target " << name;
+    }
+  }
+  if (FLAGS_benchmark_targets.empty()) {
+    targets.push_back(common::DefaultTarget());
+  }
+
+  proto::ModelBenchmarkReport report;
+  for (auto& target : targets) {
+    for (auto& model : utils::Split(FLAGS_benchmark_models, ",")) {
+      for (auto& dtype : utils::Split(FLAGS_benchmark_dtypes, ",")) {
+        int batch_size = FLAGS_benchmark_batch_size > 0 ? FLAGS_benchmark_batch_size : DefaultBenchmarkBatchSize(model);
+        auto result =
+            RunModelBenchmark(model, dtype, target, batch_size, FLAGS_benchmark_warmup, FLAGS_benchmark_repeat);
+        LOG(INFO) << result.DebugString();
+        *report.add_results() = result;
+      }
+    }
+  }
+  if (!FLAGS_benchmark_output.empty()) {
+    SaveBenchmarkReport(report, FLAGS_benchmark_output);
+  }
+
+  if (!FLAGS_benchmark_baseline.empty()) {
+    auto baseline    = LoadBenchmarkReport(FLAGS_benchmark_baseline);
+    auto regressions = CompareBenchmarkReports(report, baseline, FLAGS_benchmark_tolerance);
+    for (auto& regression : regressions) {
+      LOG(ERROR) << "Performance regression: " << regression;
+    }
+    ASSERT_TRUE(regressions.empty()) << regressions.size() << " regressions against " << FLAGS_benchmark_baseline;
+  }
+}
+
+TEST(ModelBenchmark, compare) {
+  proto::ModelBenchmarkReport baseline, report;
+  auto* base = baseline.add_results();
+  base->set_model("mlp");
+  base->set_dtype("float32");
+  base->set_target("x86");
+  base->set_batch_size(256);
+  base->set_latency_p50_ms(1.0);
+  base->set_throughput(256000.0);
+  base->set_peak_memory_bytes(1000);
+
+  // within the tolerance
+  auto* result = report.add_results();
+  *result      = *base;
+  result->set_latency_p50_ms(1.05);
+  ASSERT_TRUE(CompareBenchmarkReports(report, baseline, 0.1).empty());
+
+  // slower and larger
+  result->set_latency_p50_ms(1.2);
+  result->set_peak_memory_bytes(2000);
+  ASSERT_EQ(CompareBenchmarkReports(report, baseline, 0.1).size(), 2UL);
+
+  // no baseline of another batch size
+  result->set_batch_size(128);
+  ASSERT_TRUE(CompareBenchmarkReports(report, baseline, 0.1).empty());
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/runtime/cuda/cuda_util.h"
+
+namespace cinn {
+namespace tests {
+
+namespace {
+
+// Return the average time in ms of the launches on the default stream after a warm up launch.
+float TimeKernel(const std::function<void()>& launch, int repeat) {
+  launch();
+  cudaEvent_t start, end;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&end));
+  CUDA_CALL(cudaEventRecord(start));
+  for (int i = 0; i < repeat; ++i) {
+    launch();
+  }
+  CUDA_CALL(cudaEventRecord(end));
+  CUDA_CALL(cudaEventSynchronize(end));
+  float elapsed_ms = 0.f;
+  CUDA_CALL(cudaEventElapsedTime(&elapsed_ms, start, end));
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(end));
+  return elapsed_ms / repeat;
+}
+
+cinn_buffer_t MakeDeviceBuffer(size_t numel) {
+  cinn_buffer_t buffer;
+  buffer.type = cinn_float32_t();
+  CUDA_CALL(cudaMalloc(&buffer.memory, numel * sizeof(float)));
+  return buffer;
+}
+
+}  // namespace
+
+// Compare the online softmax kernel with the cuDNN softmax along the last axis, see the kernel time in the log.
+TEST(test_softmax, online_vs_cudnn_fp32) {
+  const int repeat = 20;
+  std::mt19937 engine(123);
+  std::uniform_real_distribution<float> dist(-10.f, 10.f);
+  for (auto& shape : std::vector<std::pair<int, int>>{{8192, 128}, {4096, 1024}, {1024, 4096}, {128, 32000}}) {
+    int rows = shape.first, cols = shape.second;
+    std::vector<float> x(rows * cols);
+    for (auto& value : x) {
+      value = dist(engine);
+    }
+    auto x_buf      = MakeDeviceBuffer(x.size());
+    auto online_buf = MakeDeviceBuffer(x.size());
+    auto cudnn_buf  = MakeDeviceBuffer(x.size());
+    CUDA_CALL(cudaMemcpy(x_buf.memory, x.data(), x.size() * sizeof(float), cudaMemcpyHostToDevice));
+
+    cinn_pod_value_t args[] = {cinn_pod_value_t(&x_buf), cinn_pod_value_t(&online_buf)};
+    float online_ms         = TimeKernel(
+        [&] {
+          runtime::cuda::cinn_call_fused_softmax_nvgpu(args, 2, rows, cols, 1.0f, false, 1, 1, 0, 0, 0, nullptr);
+        },
+        repeat);
+    float cudnn_ms = TimeKernel(
+        [&] { runtime::cuda::cinn_gpu_cudnn_softmax({rows, cols, -1}, &x_buf, &cudnn_buf, nullptr); }, repeat);
+    LOG(INFO) << "softmax of [" << rows << ", " << cols << "]: online kernel " << online_ms << " ms, cudnn "
+              << cudnn_ms << " ms";
+
+    std::vector<float> online_out(x.size()), cudnn_out(x.size());
+    CUDA_CALL(cudaMemcpy(online_out.data(), online_buf.memory, x.size() * sizeof(float), cudaMemcpyDeviceToHost));
+    CUDA_CALL(cudaMemcpy(cudnn_out.data(), cudnn_buf.memory, x.size() * sizeof(float), cudaMemcpyDeviceToHost));
+    for (size_t i = 0; i < x.size(); ++i) {
+      ASSERT_NEAR(online_out[i], cudnn_out[i], 1e-5 * std::max(1.f, std::abs(cudnn_out[i]))) << " i is " << i;
+    }
+
+    CUDA_CALL(cudaFree(x_buf.memory));
+    CUDA_CALL(cudaFree(online_buf.memory));
+    CUDA_CALL(cudaFree(cudnn_buf.memory));
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -30,7 +30,7 @@ namespace cinn {
 namespace tests {
 using ir::Tensor;
 std::unique_ptr<backends::ExecutionEngine> OpBenchmarkTester::CreateExecutionEngine(const cinn::ir::Module& module) {
-  auto engine = backends::ExecutionEngine::Create({});
+  auto engine = backends::ExecutionEngine::Create(execution_options_);
   engine->Link<backends::CodeGenX86>(module);
   return engine;
 }
@@ -58,6 +58,9 @@ class OpBenchmarkTester {
 
   virtual std::unique_ptr<backends::ExecutionEngine> CreateExecutionEngine(const cinn::ir::Module &module);
 
+  //! Set the options of the engine which JIT compiles the op, to compare the LLVM optimization pipelines.
+  void SetExecutionOptions(const backends::ExecutionOptions &options) { execution_options_ = options; }
+
   std::vector<cinn_pod_value_t> &GetAllArgs() { return all_args_; }
   int GetOutDims() { return out_dims_; }
 
@@ -90,6 +93,7 @@ class OpBenchmarkTester {
   std::vector<Type> out_types_;
   std::vector<cinn_pod_value_t> all_args_;
   int out_dims_;
+  backends::ExecutionOptions execution_options_;
 };
 
 }  // namespace tests